@@ -16,12 +16,17 @@ namespace fs = std::experimental::filesystem;
 #include <fstream>
 #include <stdexcept>
 
+#include <fb303/ServiceData.h>
 #include <fbzmq/zmq/Zmq.h>
 #include <folly/FileUtil.h>
 #include <folly/Format.h>
 #include <folly/IPAddress.h>
 #include <folly/Memory.h>
 #include <folly/Optional.h>
+#include <folly/String.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+#include <folly/futures/Future.h>
 #include <folly/gen/Base.h>
 #include <folly/gen/String.h>
 #include <folly/init/Init.h>
@@ -30,6 +35,7 @@ namespace fs = std::experimental::filesystem;
 #include <re2/re2.h>
 #include <re2/set.h>
 #include <sodium.h>
+#include <thrift/lib/cpp/concurrency/ThreadManager.h>
 #include <thrift/lib/cpp2/async/HeaderClientChannel.h>
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 #include <thrift/lib/cpp2/server/ThriftServer.h>
@@ -38,6 +44,7 @@ namespace fs = std::experimental::filesystem;
 #include <openr/common/BuildInfo.h>
 #include <openr/common/Constants.h>
 #include <openr/common/Flags.h>
+#include <openr/common/ThreadScheduling.h>
 #include <openr/common/Util.h>
 #include <openr/config-store/PersistentStore.h>
 #include <openr/config/Config.h>
@@ -63,15 +70,74 @@ namespace fs = std::experimental::filesystem;
 
 using namespace openr;
 
+using apache::thrift::concurrency::PriorityThreadManager;
 using apache::thrift::concurrency::ThreadManager;
 using openr::messaging::ReplicateQueue;
 
+namespace fb303 = facebook::fb303;
+
 namespace {
 //
 // Local constants
 //
 
 const std::string inet6Path = "/proc/net/if_inet6";
+
+// Number of threads constructing modules in parallel on startup
+const size_t kNumStartupThreads{8};
+
+// Time of process start, modules log their time-to-ready since then
+std::chrono::steady_clock::time_point startupTime;
+
+int64_t
+getMsSinceStartup() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now() - startupTime)
+      .count();
+}
+
+/**
+ * Reload config from file and apply changes modules can apply live. Running
+ * config is replaced by the applied one, hence changes requiring restart are
+ * reported on every reload until restart.
+ */
+void
+reloadConfig(
+    std::shared_ptr<const Config>& runningConfig,
+    KvStore* kvStore,
+    Decision* decision,
+    LinkMonitor* linkMonitor,
+    Spark* spark) {
+  std::unique_ptr<Config> reloaded;
+  try {
+    reloaded = std::make_unique<Config>(FLAGS_config);
+  } catch (const std::exception& ex) {
+    LOG(ERROR) << "[Config] Failed to reload config from " << FLAGS_config
+               << ", keep running config. Error: " << folly::exceptionStr(ex);
+    fb303::fbData->addStatValue("config.reload_failures", 1, fb303::COUNT);
+    return;
+  }
+
+  auto update = Config::diff(runningConfig, *reloaded);
+  if (not update.restartRequiredFields.empty()) {
+    LOG(WARNING) << "[Config] Changes of fields ["
+                 << folly::join(", ", update.restartRequiredFields)
+                 << "] take effect on restart only";
+  }
+  if (update.hasLiveChanges()) {
+    folly::collectAll(
+        kvStore->processConfigUpdate(update),
+        decision->processConfigUpdate(update),
+        linkMonitor->processConfigUpdate(update),
+        spark->processConfigUpdate(update))
+        .get();
+    runningConfig = update.config;
+    LOG(INFO) << "[Config] Applied reloaded config";
+  } else {
+    LOG(INFO) << "[Config] Nothing to apply from reloaded config";
+  }
+  fb303::fbData->addStatValue("config.reloads", 1, fb303::COUNT);
+}
 } // namespace
 
 // jemalloc parameters - http://jemalloc.net/jemalloc.3.html
@@ -129,6 +195,24 @@ waitForFibService(const folly::EventBase& mainEvb, int port) {
   LOG(INFO) << "FibService up. Waited for " << waitMs << " ms.";
 }
 
+/**
+ * Construct module with `make` on `executor`, in parallel to modules it
+ * doesn't depend on. Module is then started with startEventBase().
+ */
+template <typename F>
+auto
+constructAsync(folly::Executor* executor, std::string name, F&& make) {
+  return folly::via(
+      executor,
+      [name = std::move(name), make = std::forward<F>(make)]() mutable {
+        const auto startMs = getMsSinceStartup();
+        auto module = make();
+        LOG(INFO) << "Constructed " << name << " in "
+                  << getMsSinceStartup() - startMs << " ms";
+        return module;
+      });
+}
+
 /**
  * Start an EventBase in a thread, maintain order of thread creation and
  * returns raw pointer of Derived class.
@@ -139,6 +223,7 @@ startEventBase(
     std::vector<std::thread>& allThreads,
     std::vector<std::unique_ptr<OpenrEventBase>>& orderedEvbs,
     Watchdog* watchdog,
+    const Config& config,
     const std::string& name,
     std::unique_ptr<T> evbT) {
   CHECK(evbT);
@@ -147,14 +232,23 @@ startEventBase(
       reinterpret_cast<OpenrEventBase*>(evbT.release()));
   evb->setEvbName(name);
 
-  // Start a thread
-  allThreads.emplace_back(std::thread([evb = evb.get(), name]() noexcept {
-    LOG(INFO) << "Starting " << name << " thread ...";
-    folly::setThreadName(fmt::format("openr-{}", name));
-    evb->run();
-    LOG(INFO) << name << " thread got stopped.";
-  }));
+  // Start a thread, placed and scheduled as configured for the module
+  auto threadScheduling = config.getThreadSchedulingConfig(name);
+  allThreads.emplace_back(std::thread(
+      [evb = evb.get(), name, threadScheduling]() noexcept {
+        LOG(INFO) << "Starting " << name << " thread ...";
+        folly::setThreadName(fmt::format("openr-{}", name));
+        if (threadScheduling.has_value()) {
+          ThreadScheduling::apply(name, *threadScheduling);
+        }
+        // account memory of every module separately
+        evb->bindDedicatedArena();
+        evb->run();
+        LOG(INFO) << name << " thread got stopped.";
+      }));
   evb->waitUntilRunning();
+  LOG(INFO) << name << " is ready, " << getMsSinceStartup()
+            << " ms since startup";
 
   // Add to watchdog
   if (watchdog) {
@@ -177,11 +271,13 @@ main(int argc, char** argv) {
 
   // Initialize all params
   folly::init(&argc, &argv);
+  startupTime = std::chrono::steady_clock::now();
 
   // Register the signals to handle before anything else. This guarantees that
   // any threads created below will inherit the signal mask
   folly::EventBase mainEvb;
   EventBaseStopSignalHandler handler(&mainEvb);
+  ReloadSignalHandler reloadHandler(&mainEvb);
 
   // Initialize syslog
   // We log all messages upto INFO level.
@@ -231,7 +327,7 @@ main(int argc, char** argv) {
   // Queue for inter-module communication
   ReplicateQueue<DecisionRouteUpdate> routeUpdatesQueue;
   ReplicateQueue<KvStoreSyncEvent> kvStoreSyncEventsQueue;
-  ReplicateQueue<InterfaceDatabase> interfaceUpdatesQueue;
+  ReplicateQueue<InterfaceUpdate> interfaceUpdatesQueue;
   ReplicateQueue<NeighborEvents> neighborUpdatesQueue;
   ReplicateQueue<PrefixEvent> prefixUpdatesQueue;
   ReplicateQueue<Publication> kvStoreUpdatesQueue;
@@ -243,7 +339,7 @@ main(int argc, char** argv) {
   ReplicateQueue<LogSample> logSampleQueue;
 
   // Create the readers in the first place to make sure they can receive every
-  // messages from the writer(s)
+  // messages from the writer(s), as modules are constructed in parallel
   auto decisionStaticRouteUpdatesQueueReader =
       staticRouteUpdatesQueue.getReader("decision");
   auto fibStaticRouteUpdatesQueueReader =
@@ -260,6 +356,20 @@ main(int argc, char** argv) {
       kvStoreUpdatesQueue.getReader("decision");
   auto PrefixManagerKvStoreUpdatesReader =
       kvStoreUpdatesQueue.getReader("prefixManager");
+  auto monitorLogSampleQueueReader = logSampleQueue.getReader("monitor");
+  auto kvStorePeerUpdatesQueueReader = peerUpdatesQueue.getReader("kvStore");
+  auto kvStoreKvRequestQueueReader = kvRequestQueue.getReader("kvStore");
+  auto sparkInterfaceUpdatesQueueReader =
+      interfaceUpdatesQueue.getReader("spark");
+  auto prefixManagerPrefixUpdatesQueueReader =
+      prefixUpdatesQueue.getReader("prefixManager");
+  // If FIB-ACK feature is enabled, Fib publishes routes to PrefixManager
+  // after programming has completed; Otherwise, Decision publishes routes to
+  // PrefixManager.
+  auto routeUpdatesQueueReader =
+      (config->getConfig().get_enable_fib_ack()
+           ? fibRouteUpdatesQueue.getReader("routeUpdates")
+           : routeUpdatesQueue.getReader("routeUpdates"));
 
   // structures to organize our modules
   std::vector<std::thread> allThreads;
@@ -272,6 +382,7 @@ main(int argc, char** argv) {
         allThreads,
         orderedEvbs,
         nullptr /* watchdog won't monitor itself */,
+        *config,
         "watchdog",
         std::make_unique<Watchdog>(config));
   }
@@ -285,22 +396,129 @@ main(int argc, char** argv) {
   });
   mainEvb.waitUntilRunning();
 
-  if (config->isFibServiceWaitingEnabled() and
-      (not config->isNetlinkFibHandlerEnabled())) {
-    waitForFibService(mainEvb, *config->getConfig().fib_port_ref());
+  // Construct modules on startup threads, in parallel to each other, e.g.
+  // netlink socket init, PersistentStore load and KvStore warm start. Only
+  // data dependencies serialize construction. Modules are still started in
+  // the order below, once constructed.
+  folly::CPUThreadPoolExecutor startupExecutor(
+      kNumStartupThreads,
+      std::make_shared<folly::NamedThreadFactory>("openr-startup"));
+
+  // Create Netlink Protocol object along with its EventBase
+  // NOTE: Start EventBase only after NetlinkProtocolSocket has been constructed
+  auto nlFuture = constructAsync(&startupExecutor, "netlink", [&]() {
+    auto nlOpenrEvb = std::make_unique<OpenrEventBase>();
+    const size_t numRouteSockets =
+        *config->getConfig().enable_kernel_nexthop_objects_ref()
+        ? 0
+        : std::max(0, *config->getConfig().netlink_route_sockets_ref());
+    auto nlSock = std::make_unique<openr::fbnl::NetlinkProtocolSocket>(
+        nlOpenrEvb->getEvb(),
+        netlinkEventsQueue,
+        false /* enableIPv6RouteReplaceSemantics */,
+        numRouteSockets);
+    return std::make_pair(std::move(nlOpenrEvb), std::move(nlSock));
+  });
+  auto configStoreFuture =
+      constructAsync(&startupExecutor, "config_store", [&]() {
+        return std::make_unique<PersistentStore>(config);
+      });
+  auto monitorFuture = constructAsync(&startupExecutor, "monitor", [&]() {
+    return std::make_unique<openr::Monitor>(
+        config,
+        Constants::kEventLogCategory.toString(),
+        std::move(monitorLogSampleQueueReader));
+  });
+  auto kvStoreFuture = constructAsync(&startupExecutor, "kvstore", [&]() {
+    return std::make_unique<KvStore>(
+        context,
+        kvStoreUpdatesQueue,
+        kvStoreSyncEventsQueue,
+        std::move(kvStorePeerUpdatesQueueReader),
+        std::move(kvStoreKvRequestQueueReader),
+        logSampleQueue,
+        KvStoreGlobalCmdUrl{fmt::format(
+            "tcp://{}:{}",
+            *config->getConfig().listen_addr_ref(),
+            Constants::kKvStoreRepPort)},
+        config);
+  });
+  auto sparkFuture = constructAsync(&startupExecutor, "spark", [&]() {
+    return std::make_unique<Spark>(
+        std::move(sparkInterfaceUpdatesQueueReader),
+        neighborUpdatesQueue,
+        std::make_shared<IoProvider>(),
+        config);
+  });
+  auto decisionFuture = constructAsync(&startupExecutor, "decision", [&]() {
+    return std::make_unique<Decision>(
+        config,
+        std::move(decisionKvStoreUpdatesQueueReader),
+        std::move(decisionStaticRouteUpdatesQueueReader),
+        routeUpdatesQueue);
+  });
+  // Fib alone needs FibService up, hence only Fib waits for it
+  auto fibFuture = constructAsync(&startupExecutor, "fib", [&]() {
+    if (config->isFibServiceWaitingEnabled() and
+        (not config->isNetlinkFibHandlerEnabled())) {
+      waitForFibService(mainEvb, *config->getConfig().fib_port_ref());
+    }
+    return std::make_unique<Fib>(
+        config,
+        std::move(fibDecisionRouteUpdatesQueueReader),
+        std::move(fibStaticRouteUpdatesQueueReader),
+        fibRouteUpdatesQueue,
+        logSampleQueue);
+  });
+
+  // Setup the SSL policy of OpenrCtrl thrift server meanwhile
+  std::shared_ptr<wangle::SSLContextConfig> sslContext;
+  // Acceptable SSL peer names
+  std::unordered_set<std::string> acceptableNamesSet; // empty set by default
+
+  // OpenrCtrl thrift server
+  auto thriftCtrlServer = std::make_unique<apache::thrift::ThriftServer>();
+  // Set the port and interface for OpenrCtrl thrift server
+  thriftCtrlServer->setPort(
+      config->getThriftServerConfig().get_openr_ctrl_port());
+
+  if (config->isSecureThriftServerEnabled()) {
+    sslContext = std::make_shared<wangle::SSLContextConfig>();
+    sslContext->setCertificate(
+        config->getSSLCertPath(), config->getSSLKeyPath(), "");
+    sslContext->clientCAFile = config->getSSLCaPath();
+    sslContext->sessionContext = Constants::kOpenrCtrlSessionContext.toString();
+    sslContext->setNextProtocols(
+        **apache::thrift::ThriftServer::defaultNextProtocols());
+    sslContext->clientVerification = config->getSSLContextVerifyType();
+    sslContext->eccCurveName = config->getSSLEccCurve();
+
+    // Get the acceptable peer name set
+    std::vector<std::string> acceptableNames;
+    folly::split(",", config->getSSLAcceptablePeers(), acceptableNames, true);
+    acceptableNamesSet.insert(acceptableNames.begin(), acceptableNames.end());
+
+    // Start OpenrCtrl thrift server
+    setupThriftServerTls(
+        *thriftCtrlServer,
+        config->getSSLThriftPolicy(),
+        config->getSSLSeedPath(),
+        sslContext);
   }
 
   std::shared_ptr<ThreadManager> thriftThreadMgr{nullptr};
   std::unique_ptr<apache::thrift::ThriftServer> netlinkFibServer{nullptr};
   std::unique_ptr<std::thread> netlinkFibServerThread{nullptr};
 
-  // Create Netlink Protocol object in a new thread
-  // NOTE: Start EventBase only after NetlinkProtocolSocket has been constructed
-  auto nlOpenrEvb = std::make_unique<OpenrEventBase>();
-  auto nlSock = std::make_unique<openr::fbnl::NetlinkProtocolSocket>(
-      nlOpenrEvb->getEvb(), netlinkEventsQueue);
+  auto nl = std::move(nlFuture).get();
+  auto nlSock = std::move(nl.second);
   startEventBase(
-      allThreads, orderedEvbs, watchdog, "netlink", std::move(nlOpenrEvb));
+      allThreads,
+      orderedEvbs,
+      watchdog,
+      *config,
+      "netlink",
+      std::move(nl.first));
 
   // Start NetlinkFibHandler if specified
   if (config->isNetlinkFibHandlerEnabled()) {
@@ -318,10 +536,16 @@ main(int argc, char** argv) {
     netlinkFibServer->setCpp2WorkerThreadName("FibTWorker");
     netlinkFibServer->setPort(*config->getConfig().fib_port_ref());
 
-    netlinkFibServerThread =
-        std::make_unique<std::thread>([&netlinkFibServer, &nlSock]() {
+    const bool enableNexthopObjects =
+        *config->getConfig().enable_kernel_nexthop_objects_ref();
+    netlinkFibServerThread = std::make_unique<std::thread>(
+        [&netlinkFibServer,
+         &nlSock,
+         enableNexthopObjects,
+         q = netlinkEventsQueue.getReader("netlinkFibHandler")]() mutable {
           folly::setThreadName("openr-fibService");
-          auto fibHandler = std::make_shared<NetlinkFibHandler>(nlSock.get());
+          auto fibHandler = std::make_shared<NetlinkFibHandler>(
+              nlSock.get(), enableNexthopObjects, std::move(q));
           netlinkFibServer->setInterface(std::move(fibHandler));
 
           LOG(INFO) << "Starting NetlinkFib server...";
@@ -336,157 +560,122 @@ main(int argc, char** argv) {
       allThreads,
       orderedEvbs,
       watchdog,
+      *config,
       "config_store",
-      std::make_unique<PersistentStore>(config));
+      std::move(configStoreFuture).get());
 
   // Start monitor Module
   auto monitor = startEventBase(
       allThreads,
       orderedEvbs,
       watchdog,
+      *config,
       "monitor",
-      std::make_unique<openr::Monitor>(
-          config,
-          Constants::kEventLogCategory.toString(),
-          logSampleQueue.getReader("monitor")));
+      std::move(monitorFuture).get());
 
   // Start KVStore
   auto kvStore = startEventBase(
       allThreads,
       orderedEvbs,
       watchdog,
+      *config,
       "kvstore",
-      std::make_unique<KvStore>(
-          context,
-          kvStoreUpdatesQueue,
-          kvStoreSyncEventsQueue,
-          peerUpdatesQueue.getReader("kvStore"),
-          kvRequestQueue.getReader("kvStore"),
-          logSampleQueue,
-          KvStoreGlobalCmdUrl{fmt::format(
-              "tcp://{}:{}",
-              *config->getConfig().listen_addr_ref(),
-              Constants::kKvStoreRepPort)},
-          config));
+      std::move(kvStoreFuture).get());
   watchdog->addQueue(kvStoreSyncEventsQueue, "kvStoreSyncEventsQueue");
   watchdog->addQueue(kvStoreUpdatesQueue, "kvStoreUpdatesQueue");
   watchdog->addQueue(logSampleQueue, "logSampleQueue");
 
-  // If FIB-ACK feature is enabled, Fib publishes routes to PrefixManager
-  // after programming has completed; Otherwise, Decision publishes routes to
-  // PrefixManager.
-  auto routeUpdatesQueueReader =
-      (config->getConfig().get_enable_fib_ack()
-           ? fibRouteUpdatesQueue.getReader("routeUpdates")
-           : routeUpdatesQueue.getReader("routeUpdates"));
+  // Construct modules depending on running KvStore, config-store and netlink
+  auto prefixManagerFuture =
+      constructAsync(&startupExecutor, "prefix_manager", [&]() {
+        return std::make_unique<PrefixManager>(
+            staticRouteUpdatesQueue,
+            kvRequestQueue,
+            PrefixManagerKvStoreUpdatesReader,
+            std::move(prefixManagerPrefixUpdatesQueueReader),
+            std::move(routeUpdatesQueueReader),
+            config,
+            kvStore);
+      });
+  // Prefix Allocator to automatically allocate prefixes for nodes
+  std::optional<folly::Future<std::unique_ptr<PrefixAllocator>>>
+      prefixAllocatorFuture;
+  if (config->isPrefixAllocationEnabled()) {
+    prefixAllocatorFuture =
+        constructAsync(&startupExecutor, "prefix_allocator", [&]() {
+          return std::make_unique<PrefixAllocator>(
+              AreaId{*config->getAreaIds().begin()},
+              config,
+              nlSock.get(),
+              kvStore,
+              configStore,
+              prefixUpdatesQueue,
+              logSampleQueue,
+              kvRequestQueue,
+              Constants::kPrefixAllocatorSyncInterval);
+        });
+  }
+  auto linkMonitorFuture =
+      constructAsync(&startupExecutor, "link_monitor", [&]() {
+        return std::make_unique<LinkMonitor>(
+            config,
+            nlSock.get(),
+            kvStore,
+            configStore,
+            interfaceUpdatesQueue,
+            prefixUpdatesQueue,
+            peerUpdatesQueue,
+            logSampleQueue,
+            kvRequestQueue,
+            std::move(linkMonitorNeighborUpdatesQueueReader),
+            std::move(linkMonitorKvStoreSyncEventsQueueReader),
+            std::move(linkMonitorNetlinkEventsQueueReader),
+            FLAGS_override_drain_state);
+      });
+
   auto prefixManager = startEventBase(
       allThreads,
       orderedEvbs,
       watchdog,
+      *config,
       "prefix_manager",
-      std::make_unique<PrefixManager>(
-          staticRouteUpdatesQueue,
-          kvRequestQueue,
-          PrefixManagerKvStoreUpdatesReader,
-          prefixUpdatesQueue.getReader("prefixManager"),
-          std::move(routeUpdatesQueueReader),
-          config,
-          kvStore));
+      std::move(prefixManagerFuture).get());
   watchdog->addQueue(kvRequestQueue, "kvRequestQueue");
   watchdog->addQueue(staticRouteUpdatesQueue, "staticRouteUpdatesQueue");
 
-  // Prefix Allocator to automatically allocate prefixes for nodes
-  if (config->isPrefixAllocationEnabled()) {
+  if (prefixAllocatorFuture.has_value()) {
     startEventBase(
         allThreads,
         orderedEvbs,
         watchdog,
+        *config,
         "prefix_allocator",
-        std::make_unique<PrefixAllocator>(
-            AreaId{*config->getAreaIds().begin()},
-            config,
-            nlSock.get(),
-            kvStore,
-            configStore,
-            prefixUpdatesQueue,
-            logSampleQueue,
-            kvRequestQueue,
-            Constants::kPrefixAllocatorSyncInterval));
+        std::move(*prefixAllocatorFuture).get());
   }
   watchdog->addQueue(prefixUpdatesQueue, "prefixUpdatesQueue");
   watchdog->addQueue(netlinkEventsQueue, "netlinkEventsQueue");
 
-  // Create Spark instance for neighbor discovery
+  // Start Spark instance for neighbor discovery
   auto spark = startEventBase(
       allThreads,
       orderedEvbs,
       watchdog,
+      *config,
       "spark",
-      std::make_unique<Spark>(
-          interfaceUpdatesQueue.getReader("spark"),
-          neighborUpdatesQueue,
-          std::make_shared<IoProvider>(),
-          config));
+      std::move(sparkFuture).get());
   watchdog->addQueue(neighborUpdatesQueue, "neighborUpdatesQueue");
 
-  // Create link monitor instance.
+  // Start link monitor instance.
   auto linkMonitor = startEventBase(
       allThreads,
       orderedEvbs,
       watchdog,
+      *config,
       "link_monitor",
-      std::make_unique<LinkMonitor>(
-          config,
-          nlSock.get(),
-          kvStore,
-          configStore,
-          interfaceUpdatesQueue,
-          prefixUpdatesQueue,
-          peerUpdatesQueue,
-          logSampleQueue,
-          kvRequestQueue,
-          std::move(linkMonitorNeighborUpdatesQueueReader),
-          std::move(linkMonitorKvStoreSyncEventsQueueReader),
-          std::move(linkMonitorNetlinkEventsQueueReader),
-          FLAGS_override_drain_state));
+      std::move(linkMonitorFuture).get());
   watchdog->addQueue(interfaceUpdatesQueue, "interfaceUpdatesQueue");
   watchdog->addQueue(peerUpdatesQueue, "peerUpdatesQueue");
 
-  // Setup the SSL policy
-  std::shared_ptr<wangle::SSLContextConfig> sslContext;
-  // Acceptable SSL peer names
-  std::unordered_set<std::string> acceptableNamesSet; // empty set by default
-
-  // OpenrCtrl thrift server
-  auto thriftCtrlServer = std::make_unique<apache::thrift::ThriftServer>();
-  // Set the port and interface for OpenrCtrl thrift server
-  thriftCtrlServer->setPort(
-      config->getThriftServerConfig().get_openr_ctrl_port());
-
-  if (config->isSecureThriftServerEnabled()) {
-    sslContext = std::make_shared<wangle::SSLContextConfig>();
-    sslContext->setCertificate(
-        config->getSSLCertPath(), config->getSSLKeyPath(), "");
-    sslContext->clientCAFile = config->getSSLCaPath();
-    sslContext->sessionContext = Constants::kOpenrCtrlSessionContext.toString();
-    sslContext->setNextProtocols(
-        **apache::thrift::ThriftServer::defaultNextProtocols());
-    sslContext->clientVerification = config->getSSLContextVerifyType();
-    sslContext->eccCurveName = config->getSSLEccCurve();
-
-    // Get the acceptable peer name set
-    std::vector<std::string> acceptableNames;
-    folly::split(",", config->getSSLAcceptablePeers(), acceptableNames, true);
-    acceptableNamesSet.insert(acceptableNames.begin(), acceptableNames.end());
-
-    // Start OpenrCtrl thrift server
-    setupThriftServerTls(
-        *thriftCtrlServer,
-        config->getSSLThriftPolicy(),
-        config->getSSLSeedPath(),
-        sslContext);
-  }
-
   // Create bgp speaker module
   auto pluginArgs = PluginArgs{
       prefixUpdatesQueue,
@@ -515,12 +704,9 @@ main(int argc, char** argv) {
       allThreads,
       orderedEvbs,
       watchdog,
+      *config,
       "decision",
-      std::make_unique<Decision>(
-          config,
-          std::move(decisionKvStoreUpdatesQueueReader),
-          std::move(decisionStaticRouteUpdatesQueueReader),
-          routeUpdatesQueue));
+      std::move(decisionFuture).get());
   watchdog->addQueue(routeUpdatesQueue, "routeUpdatesQueue");
 
   // Define and start Fib Module
@@ -528,15 +714,14 @@ main(int argc, char** argv) {
       allThreads,
       orderedEvbs,
       watchdog,
+      *config,
       "fib",
-      std::make_unique<Fib>(
-          config,
-          std::move(fibDecisionRouteUpdatesQueueReader),
-          std::move(fibStaticRouteUpdatesQueueReader),
-          fibRouteUpdatesQueue,
-          logSampleQueue));
+      std::move(fibFuture).get());
   watchdog->addQueue(fibRouteUpdatesQueue, "fibRouteUpdatesQueue");
 
+  // All modules are constructed, release startup threads
+  startupExecutor.join();
+
   // Create Open/R control handler
   // NOTE: Start EventBase only after OpenrCtrlHandler has been constructed
   auto ctrlOpenrEvb = std::make_unique<OpenrEventBase>();
@@ -554,16 +739,43 @@ main(int argc, char** argv) {
       spark,
       config);
   startEventBase(
-      allThreads, orderedEvbs, watchdog, "ctrl_evb", std::move(ctrlOpenrEvb));
+      allThreads,
+      orderedEvbs,
+      watchdog,
+      *config,
+      "ctrl_evb",
+      std::move(ctrlOpenrEvb));
 
   CHECK(ctrlHandler);
   thriftCtrlServer->setInterface(ctrlHandler);
   thriftCtrlServer->setNumIOWorkerThreads(1);
-  // Intentionally kept this as (1). If you're changing to higher number please
-  // address thread safety for private member variables in OpenrCtrlHandler
-  thriftCtrlServer->setNumCPUWorkerThreads(1);
+  // Serve KvStore peer-sync and flooding RPCs (annotated as HIGH priority in
+  // OpenrCtrl.thrift) off a dedicated pool, so that heavy operator dumps and
+  // streaming subscriptions can't delay full-sync with peers.
+  // NOTE: OpenrCtrlHandler state accessed by RPCs must stay thread safe
+  const auto& thriftServerConfig = config->getThriftServerConfig();
+  const size_t numPeerSyncThreads =
+      *thriftServerConfig.num_peer_sync_threads_ref();
+  const size_t numCtrlThreads = *thriftServerConfig.num_ctrl_threads_ref();
+  const std::array<size_t, apache::thrift::concurrency::N_PRIORITIES>
+      numThreadsPerPriority = {
+          numPeerSyncThreads /* HIGH_IMPORTANT */,
+          numPeerSyncThreads /* HIGH */,
+          numCtrlThreads /* IMPORTANT */,
+          numCtrlThreads /* NORMAL */,
+          1 /* BEST_EFFORT */};
+  auto ctrlThreadMgr =
+      PriorityThreadManager::newPriorityThreadManager(numThreadsPerPriority);
+  ctrlThreadMgr->setNamePrefix("CtrlCpuPool");
+  ctrlThreadMgr->start();
+  thriftCtrlServer->setThreadManager(ctrlThreadMgr);
   // Enable TOS reflection on the server socket
   thriftCtrlServer->setTosReflect(true);
+  // Compression is requested by clients per connection, e.g. subscribers of
+  // KvStore and Fib streams. Don't spend CPU on small responses and deltas.
+  if (auto minCompressBytes = thriftServerConfig.min_compress_bytes_ref()) {
+    thriftCtrlServer->setMinCompressBytes(*minCompressBytes);
+  }
 
   // serve
   std::thread thriftCtrlServerThread([&thriftCtrlServer]() noexcept {
@@ -580,6 +792,18 @@ main(int argc, char** argv) {
     }
     std::this_thread::yield();
   }
+  LOG(INFO) << "ThriftCtrlServer is ready, " << getMsSinceStartup()
+            << " ms since startup";
+
+  // Reload config on SIGHUP, e.g. to tune it without restart
+  reloadHandler.setCallback(
+      [runningConfig = std::shared_ptr<const Config>(config),
+       kvStore,
+       decision,
+       linkMonitor,
+       spark]() mutable {
+        reloadConfig(runningConfig, kvStore, decision, linkMonitor, spark);
+      });
 
   // Wait for main eventbase to stop
   mainEvbThread.join();
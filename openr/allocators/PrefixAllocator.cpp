@@ -7,6 +7,7 @@
 
 #include <folly/Format.h>
 #include <folly/futures/Promise.h>
+#include <folly/hash/Hash.h>
 
 #include <openr/allocators/PrefixAllocator.h>
 #include <openr/common/Constants.h>
@@ -36,6 +37,9 @@ PrefixAllocator::PrefixAllocator(
       syncInterval_(syncInterval),
       enableKvRequestQueue_(
           config->getConfig().get_enable_kvstore_request_queue()),
+      enableFastAllocation_(config->getPrefixAllocationConfig()
+                                .enable_fast_allocation_ref()
+                                .value_or(false)),
       setLoopbackAddress_(
           *config->getPrefixAllocationConfig().set_loopback_addr_ref()),
       overrideGlobalAddress_(
@@ -461,8 +465,12 @@ PrefixAllocator::getInitPrefixIndex() {
 
   // Generate a new random prefix index
   if (allocParams_.has_value()) {
-    uint32_t hashPrefixIndex =
-        hasher(myNodeName_) % getPrefixCount(*allocParams_);
+    // std::hash is not guaranteed to be stable across builds, FNV is. Keeps
+    // initial index of a node the same, i.e. probing deterministic
+    const uint64_t hash = enableFastAllocation_
+        ? folly::hash::fnv64(myNodeName_)
+        : hasher(myNodeName_);
+    uint32_t hashPrefixIndex = hash % getPrefixCount(*allocParams_);
     LOG(INFO) << "Generate new initial prefix index: " << hashPrefixIndex;
     return hashPrefixIndex;
   }
@@ -539,7 +547,8 @@ PrefixAllocator::startAllocation(
       [this](uint32_t allocIndex) noexcept -> bool {
         return checkE2eAllocIndex(allocIndex);
       },
-      Constants::kRangeAllocTtl);
+      Constants::kRangeAllocTtl,
+      enableFastAllocation_ /* linearProbing */);
 
   // start range allocation
   LOG(INFO) << "Starting prefix allocation with seed prefix: "
@@ -160,6 +160,10 @@ class PrefixAllocator : public OpenrEventBase {
   // config knob for enabling key-val request queue for range allocator
   const bool enableKvRequestQueue_;
 
+  // config knob for hashing node name stably to initial prefix index and
+  // linear probing on collision
+  const bool enableFastAllocation_{false};
+
   //
   // Non-const private variables
   //
@@ -48,7 +48,8 @@ RangeAllocator<T>::RangeAllocator(
     const std::chrono::milliseconds maxBackoffDur /* = 2s */,
     const bool overrideOwner /* = true */,
     const std::function<bool(T)> checkValueInUseCb,
-    const std::chrono::milliseconds rangeAllocTtl)
+    const std::chrono::milliseconds rangeAllocTtl,
+    const bool linearProbing)
     : nodeName_(nodeName),
       keyPrefix_(keyPrefix),
       kvStoreClient_(kvStoreClient),
@@ -60,6 +61,7 @@ RangeAllocator<T>::RangeAllocator(
       kvRequestQueue_(kvRequestQueue),
       checkValueInUseCb_(std::move(checkValueInUseCb)),
       rangeAllocTtl_(rangeAllocTtl),
+      linearProbing_(linearProbing),
       area_(area) {
   timeout_ = folly::AsyncTimeout::make(
       *eventBase_->getEvb(), [this]() mutable noexcept {
@@ -82,6 +84,9 @@ RangeAllocator<T>::~RangeAllocator() {
     }
 
     // Unsubscribe from KvStoreClientInternal if we have been to
+    if (hasStarted_) {
+      kvStoreClient_->unsubscribeKeyPrefix(area_, keyPrefix_);
+    }
     if (myValue_) {
       const auto myKey = createKey(*myValue_);
       kvStoreClient_->unsubscribeKey(area_, myKey);
@@ -96,6 +101,105 @@ RangeAllocator<T>::createKey(const T val) const noexcept {
   return folly::sformat("{}{}", keyPrefix_, val);
 }
 
+template <typename T>
+uint64_t
+RangeAllocator<T>::getOffset(const T val) const noexcept {
+  return static_cast<uint64_t>(
+      static_cast<int64_t>(val) - static_cast<int64_t>(allocRange_.first));
+}
+
+template <typename T>
+void
+RangeAllocator<T>::updateClaimedValues(
+    const KvStoreClientInternal::KeyValUpdates& keyVals) noexcept {
+  for (const auto& [key, thriftVal] : keyVals) {
+    std::optional<T> val;
+    bool claimed{false};
+    if (thriftVal.has_value()) {
+      if (not thriftVal->value_ref().has_value() or
+          thriftVal->value_ref()->size() != sizeof(T)) {
+        continue;
+      }
+      val = details::binaryToPrimitive<T>(thriftVal->value_ref().value());
+      // same as ownership check of tryAllocate()
+      const auto& owner = *thriftVal->originatorId_ref();
+      claimed = owner != nodeName_ and
+          not(overrideOwner_ and nodeName_ > owner) and
+          not(not overrideOwner_ and
+              *thriftVal->ttl_ref() == Constants::kTtlInfinity);
+    } else {
+      // expired key, value is encoded in the key
+      auto maybeVal = folly::tryTo<T>(
+          folly::StringPiece(key).subpiece(keyPrefix_.size()));
+      if (maybeVal.hasValue()) {
+        val = *maybeVal;
+      }
+    }
+    if (not val.has_value() or *val < allocRange_.first or
+        *val > allocRange_.second) {
+      continue;
+    }
+
+    const auto offset = getOffset(*val);
+    const uint64_t bit = uint64_t{1} << (offset % 64);
+    if (claimed) {
+      claimedWords_[offset / 64] |= bit;
+      continue;
+    }
+    auto it = claimedWords_.find(offset / 64);
+    if (it != claimedWords_.end()) {
+      it->second &= ~bit;
+      if (it->second == 0) {
+        claimedWords_.erase(it);
+      }
+    }
+  }
+}
+
+template <typename T>
+bool
+RangeAllocator<T>::isClaimed(const T val) const noexcept {
+  if (val < allocRange_.first or val > allocRange_.second) {
+    return false;
+  }
+  const auto offset = getOffset(val);
+  const auto it = claimedWords_.find(offset / 64);
+  return it != claimedWords_.end() and
+      (it->second & (uint64_t{1} << (offset % 64)));
+}
+
+template <typename T>
+std::optional<T>
+RangeAllocator<T>::findFreeValue(const T seedVal) const noexcept {
+  const uint64_t size = getOffset(allocRange_.second) + 1;
+  uint64_t offset = getOffset(seedVal);
+  uint64_t visited = 0;
+  while (visited < size) {
+    const auto it = claimedWords_.find(offset / 64);
+    const uint64_t freeBits =
+        ~(it == claimedWords_.end() ? 0 : it->second) >> (offset % 64);
+    // skip claimed values, up to end of word if rest of it is claimed
+    const uint64_t skip =
+        freeBits ? __builtin_ctzll(freeBits) : 64 - offset % 64;
+    if (skip) {
+      const auto next = std::min(offset + skip, size);
+      visited += next - offset;
+      offset = next == size ? 0 : next;
+      continue;
+    }
+
+    const auto val = static_cast<T>(
+        static_cast<int64_t>(allocRange_.first) +
+        static_cast<int64_t>(offset));
+    if (not checkValueInUseCb_ or not checkValueInUseCb_(val)) {
+      return val;
+    }
+    ++visited;
+    offset = offset + 1 == size ? 0 : offset + 1;
+  }
+  return std::nullopt;
+}
+
 template <typename T>
 void
 RangeAllocator<T>::startAllocator(
@@ -126,6 +230,32 @@ RangeAllocator<T>::startAllocator(
   }
   allocRangeSize_ = allocRange_.second - allocRange_.first + 1;
 
+  // Track values claimed in KvStore, seeded with the current ones
+  kvStoreClient_->subscribeKeyPrefix(
+      area_,
+      keyPrefix_,
+      [this](const KvStoreClientInternal::KeyValUpdates& keyVals) noexcept {
+        updateClaimedValues(keyVals);
+      });
+  const auto maybeKeyMap = kvStoreClient_->dumpAllWithPrefix(area_, keyPrefix_);
+  if (maybeKeyMap.has_value()) {
+    KvStoreClientInternal::KeyValUpdates keyVals;
+    for (const auto& [key, thriftVal] : *maybeKeyMap) {
+      keyVals.emplace(key, thriftVal);
+    }
+    updateClaimedValues(keyVals);
+  }
+
+  // Don't even try initial value if others claimed it already
+  if (isClaimed(initValue)) {
+    const auto maybeFreeValue = findFreeValue(initValue);
+    if (maybeFreeValue.has_value()) {
+      VLOG(2) << "RangeAllocator: Initial value " << initValue
+              << " is claimed, starting with " << *maybeFreeValue;
+      initValue = *maybeFreeValue;
+    }
+  }
+
   // Subscribe to changes in KvStore
   VLOG(2) << "RangeAllocator: Created. Scheduling first tryAllocate. "
           << "Node: " << nodeName_ << ", Prefix: " << keyPrefix_;
@@ -266,40 +396,25 @@ RangeAllocator<T>::scheduleAllocate(const T seedVal) noexcept {
   // Apply exponential backoff
   backoff_.reportError();
 
-  // Use random value selection logic based on seedVal
-  std::mt19937_64 gen(seedVal + folly::Random::rand64());
-  std::uniform_int_distribution<T> dist(allocRange_.first, allocRange_.second);
-  auto newVal = dist(gen);
-
-  const auto maybeKeyMap = kvStoreClient_->dumpAllWithPrefix(area_, keyPrefix_);
-  CHECK(maybeKeyMap.has_value())
-      << "Failed to dump keys with prefix: " << keyPrefix_
-      << " from kvstore in area: " << area_.t;
-  const auto valOwners =
-      folly::gen::from(*maybeKeyMap) |
-      folly::gen::map([](std::pair<std::string, thrift::Value> const& kv) {
-        return std::make_pair(
-            details::binaryToPrimitive<T>(kv.second.value_ref().value()),
-            *kv.second.originatorId_ref());
-      }) |
-      folly::gen::as<
-          std::unordered_map<T /* value */, std::string /* owner */>>();
-
-  // look for a value I can own
-  T i;
-  for (i = 0; i < allocRangeSize_; ++i) {
-    const auto it = valOwners.find(newVal);
-    // not owned yet or owned by higher originator if override is allowed
-    if (it == valOwners.end() or (overrideOwner_ and nodeName_ >= it->second)) {
-      if (!checkValueInUseCb_ or !checkValueInUseCb_(newVal)) {
-        // found
-        break;
-      }
-    }
-    // try next
-    newVal = (newVal < allocRange_.second) ? (newVal + 1) : allocRange_.first;
+  T newVal;
+  if (linearProbing_) {
+    // probe values following seedVal
+    newVal = (seedVal >= allocRange_.first and seedVal < allocRange_.second)
+        ? seedVal + 1
+        : allocRange_.first;
+  } else {
+    // Use random value selection logic based on seedVal
+    std::mt19937_64 gen(seedVal + folly::Random::rand64());
+    std::uniform_int_distribution<T> dist(
+        allocRange_.first, allocRange_.second);
+    newVal = dist(gen);
   }
-  if (i == allocRangeSize_) {
+
+  // look for a value I can own, i.e. not claimed by others in KvStore
+  const auto maybeFreeValue = findFreeValue(newVal);
+  if (maybeFreeValue.has_value()) {
+    newVal = *maybeFreeValue;
+  } else {
     LOG(ERROR) << "All values are owned by higher originatorIds";
   }
 
@@ -11,7 +11,9 @@
 #include <random>
 #include <string>
 
+#include <folly/Conv.h>
 #include <folly/Format.h>
+#include <folly/container/F14Map.h>
 #include <folly/Optional.h>
 #include <folly/Random.h>
 #include <folly/gen/Base.h>
@@ -39,12 +41,18 @@ class RangeAllocator {
    * - Try electing it via KvStore. Higher originatorId wins.
    * - If we fail we should try again with another random number
    * - To ease up re-tries we use ExponentialBackoff
+   * - To avoid collisions in the first place, values claimed in KvStore by
+   *   others are tracked in a bitmap built from subscription to keyPrefix,
+   *   and only free values are picked
    *
    * callback: tells you of new allocated value.
    * overrideOwner:  allow a higher originator ID to grab a key from an existing
    * owner with a lower ID knowingly. In some applications like Terragraph, we
    * don't want this to occur so existing allocated values are not stolen by
    * higher priority allocator instances joining later
+   * linearProbing: on collision, claim the next free value after the lost one
+   * instead of a random one, i.e. allocation is deterministic given the
+   * initial value
    */
   RangeAllocator(
       AreaId const& area,
@@ -60,7 +68,8 @@ class RangeAllocator {
       const bool overrideOwner = true,
       const std::function<bool(T)> checkValueInUseCb = nullptr,
       const std::chrono::milliseconds rangeAllocTtl =
-          Constants::kRangeAllocTtl);
+          Constants::kRangeAllocTtl,
+      const bool linearProbing = false);
 
   /**
    * user must call this to start allocation
@@ -109,7 +118,7 @@ class RangeAllocator {
 
   /**
    * Schedule allocation of a new value. A new random value will be chosen
-   * based on the seed value.
+   * based on the seed value, or the one following it with linear probing.
    */
   void scheduleAllocate(const T seedVal) noexcept;
 
@@ -123,6 +132,26 @@ class RangeAllocator {
    */
   std::string createKey(const T val) const noexcept;
 
+  /**
+   * Update bitmap of claimed values as per key-vals with keyPrefix received
+   * from KvStore. Expired keys have std::nullopt value.
+   */
+  void updateClaimedValues(
+      const KvStoreClientInternal::KeyValUpdates& keyVals) noexcept;
+
+  // check if value is claimed in KvStore by others, i.e. I can't own it
+  bool isClaimed(const T val) const noexcept;
+
+  /**
+   * Find first value, cyclically from seedVal on, which is neither claimed
+   * in KvStore by others nor in use as per checkValueInUseCb. Return
+   * std::nullopt if whole range is taken.
+   */
+  std::optional<T> findFreeValue(const T seedVal) const noexcept;
+
+  // offset of value from start of range, i.e. its index in bitmap
+  uint64_t getOffset(const T val) const noexcept;
+
   //
   // Immutable state
   //
@@ -166,6 +195,11 @@ class RangeAllocator {
   // Currently requested value
   std::optional<T> myRequestedValue_;
 
+  // Values within range claimed in KvStore by others, i.e. by originators I
+  // can't override. Sparse bitmap of 64-value words keyed by word index,
+  // words without any claimed value are dropped
+  folly::F14FastMap<uint64_t, uint64_t> claimedWords_;
+
   // Exponential backoff to avoid frequent allocation retries
   ExponentialBackoff<std::chrono::milliseconds> backoff_;
 
@@ -185,6 +219,9 @@ class RangeAllocator {
   // KvStore TTL for value
   const std::chrono::milliseconds rangeAllocTtl_;
 
+  // probe next free value on collision instead of a random one
+  const bool linearProbing_{false};
+
   // area ID
   const AreaId area_{};
 };
@@ -114,7 +114,8 @@ class RangeAllocatorFixture : public ::testing::TestWithParam<bool> {
       const std::optional<std::vector<T>> maybeInitVals,
       std::function<void(int /* client id */, std::optional<T>)> callback,
       const std::chrono::milliseconds rangeAllocTtl =
-          Constants::kRangeAllocTtl) {
+          Constants::kRangeAllocTtl,
+      const bool linearProbing = false) {
     // sanity check
     if (maybeInitVals) {
       CHECK_EQ(clients.size(), maybeInitVals->size());
@@ -137,7 +138,8 @@ class RangeAllocatorFixture : public ::testing::TestWithParam<bool> {
           100ms /* max backoff */,
           overrideOwner /* override allowed */,
           nullptr,
-          rangeAllocTtl);
+          rangeAllocTtl,
+          linearProbing);
       // start allocator
       allocator->startAllocator(
           allocRange,
@@ -283,6 +285,122 @@ TEST_P(RangeAllocatorFixture, NoSeed) {
   }
 }
 
+/**
+ * Run allocators with seeds claimed in KvStore by a higher originator. Ensure
+ * allocators pick only free values, i.e. never the claimed ones.
+ */
+TEST_P(RangeAllocatorFixture, ClaimedValues) {
+  const uint32_t start = 61;
+  const uint32_t numClaimed = 50;
+  const uint32_t end = start + numClaimed + kNumClients - 1;
+
+  // claim first `numClaimed` values of range in every store
+  std::vector<std::pair<std::string, thrift::Value>> claimedKeyVals;
+  for (uint32_t val = start; val < start + numClaimed; ++val) {
+    claimedKeyVals.emplace_back(
+        folly::sformat("value:{}", val),
+        createThriftValue(
+            1,
+            "zzz",
+            details::primitiveToBinary(val),
+            Constants::kRangeAllocTtl.count(),
+            0,
+            0));
+  }
+  for (auto& store : stores) {
+    ASSERT_TRUE(store->setKeys(kTestingAreaName, claimedKeyVals));
+  }
+
+  folly::Baton waitBaton;
+  bool isPost{false};
+  std::map<int /* client id */, uint32_t /* allocated value */> allocation;
+  auto allocators = createAllocators<uint32_t>(
+      {start, end},
+      std::vector<uint32_t>(kNumClients, start) /* all seeds are claimed */,
+      [&](int clientId, std::optional<uint32_t> newVal) {
+        if (newVal) {
+          ASSERT_GE(newVal.value(), start + numClaimed);
+          ASSERT_LE(newVal.value(), end);
+          allocation[clientId] = newVal.value();
+        } else {
+          allocation.erase(clientId);
+        }
+
+        if (allocation.size() != kNumClients) {
+          return;
+        }
+        const auto allocatedVals = from(allocation) |
+            map([](std::pair<int, uint32_t> const& kv) { return kv.second; }) |
+            as<std::set<uint32_t>>();
+        if (allocatedVals.size() == kNumClients and not isPost) {
+          LOG(INFO) << "We got everything, stopping OpenrEventBase.";
+          isPost = true;
+          waitBaton.post();
+        }
+      });
+
+  // Start the event loop and wait until it is finished execution.
+  evbThread = std::thread([&]() { evb.run(); });
+  evb.waitUntilRunning();
+
+  // Synchronization primitive
+  waitBaton.wait();
+
+  for (auto& allocator : allocators) {
+    allocator.reset();
+  }
+}
+
+/**
+ * Run allocators with linear probing, all with the same seed. Ensure each of
+ * them probes its way to a unique value of the range, exactly large enough.
+ */
+TEST_P(RangeAllocatorFixture, LinearProbing) {
+  const uint32_t start = 61;
+  const uint32_t end = start + kNumClients - 1;
+
+  folly::Baton waitBaton;
+  bool isPost{false};
+  std::map<int /* client id */, uint32_t /* allocated value */> allocation;
+  auto allocators = createAllocators<uint32_t>(
+      {start, end},
+      std::vector<uint32_t>(kNumClients, start),
+      [&](int clientId, std::optional<uint32_t> newVal) {
+        if (newVal) {
+          ASSERT_GE(newVal.value(), start);
+          ASSERT_LE(newVal.value(), end);
+          allocation[clientId] = newVal.value();
+        } else {
+          allocation.erase(clientId);
+        }
+
+        if (allocation.size() != kNumClients) {
+          return;
+        }
+        const auto allocatedVals = from(allocation) |
+            map([](std::pair<int, uint32_t> const& kv) { return kv.second; }) |
+            as<std::set<uint32_t>>();
+        if (allocatedVals.size() == kNumClients and not isPost) {
+          LOG(INFO) << "We got everything, stopping OpenrEventBase.";
+          isPost = true;
+          waitBaton.post();
+        }
+      },
+      Constants::kRangeAllocTtl,
+      true /* linearProbing */);
+
+  // Start the event loop and wait until it is finished execution.
+  evbThread = std::thread([&]() { evb.run(); });
+  evb.waitUntilRunning();
+
+  // Synchronization primitive
+  waitBaton.wait();
+
+  for (auto& allocator : allocators) {
+    allocator.reset();
+  }
+}
+
 /**
  * Run allocators with no seed but the range doesn't have enough allocation
  * space. In this case allocators with higher IDs will succeed and other
@@ -53,6 +53,15 @@ class AsyncDebounce final : private folly::AsyncTimeout {
     CHECK(isScheduled());
   }
 
+  /**
+   * Change backoff range, e.g. on config reload. Takes effect from the next
+   * debounce on, i.e. scheduled callback is kept as is.
+   */
+  void
+  setBackoff(Duration minBackOff, Duration maxBackOff) {
+    backoff_ = ExponentialBackoff<Duration>(minBackOff, maxBackOff);
+  }
+
  private:
   void
   timeoutExpired() noexcept override {
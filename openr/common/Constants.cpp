@@ -29,6 +29,7 @@ constexpr int Constants::kHighWaterMark;
 constexpr int Constants::kIpTos;
 constexpr int Constants::kKeepAliveCnt;
 constexpr int Constants::kKeepAliveEnable;
+constexpr int Constants::kKvStoreValueCompressionLevel;
 constexpr int32_t Constants::kDefaultPathPreference;
 constexpr int32_t Constants::kDefaultSourcePreference;
 constexpr int32_t Constants::kFibAgentPort;
@@ -37,19 +38,38 @@ constexpr int32_t Constants::kOpenrCtrlPort;
 constexpr int32_t Constants::kSparkMcastPort;
 constexpr int32_t Constants::kOpenrSupportedVersion;
 constexpr int32_t Constants::kOpenrVersion;
+constexpr int32_t Constants::kOpenrCompactPrefixKeyVersion;
+constexpr int32_t Constants::kOpenrPrefixDbBucketKeyVersion;
 constexpr int64_t Constants::kDefaultAdjWeight;
 constexpr int64_t Constants::kTtlInfinity;
+constexpr int32_t Constants::kValueHashVersionLegacy;
+constexpr int32_t Constants::kValueHashVersionV2;
+constexpr size_t Constants::kKvStoreChangeLogSize;
+constexpr size_t Constants::kKvStoreFullSyncChunkMaxBytes;
+constexpr size_t Constants::kCtrlStreamChunkSize;
+constexpr size_t Constants::kCtrlResponseCacheSize;
+constexpr size_t Constants::kHotPathTraceSize;
+constexpr size_t Constants::kKvStoreMerkleNumBuckets;
+constexpr size_t Constants::kKvStoreTtlWheelNumLevels;
+constexpr size_t Constants::kKvStoreTtlWheelSlotsPerLevel;
+constexpr size_t Constants::kKvStoreValueCompressionMinBytes;
+constexpr size_t Constants::kKvStoreValueMaxDecompressedBytes;
 constexpr size_t Constants::kMaxFullSyncPendingCountThreshold;
 constexpr size_t Constants::kNumTimeSeries;
 constexpr std::chrono::milliseconds Constants::kAdjacencyThrottleTimeout;
 constexpr std::chrono::milliseconds Constants::kFibInitialBackoff;
 constexpr std::chrono::milliseconds Constants::kFibMaxBackoff;
 constexpr std::chrono::milliseconds Constants::kFloodPendingPublication;
+constexpr std::chrono::milliseconds Constants::kFloodPendingTtlUpdates;
 constexpr std::chrono::milliseconds Constants::kInitialBackoff;
 constexpr std::chrono::milliseconds Constants::kKeepAliveCheckInterval;
 constexpr std::chrono::milliseconds Constants::kKvStoreDbTtl;
 constexpr std::chrono::milliseconds Constants::kKvStoreClearThrottleTimeout;
+constexpr std::chrono::milliseconds Constants::kKvStoreSnapshotInterval;
 constexpr std::chrono::milliseconds Constants::kKvStoreSyncThrottleTimeout;
+constexpr std::chrono::milliseconds Constants::kPrefixAreaSyncThrottleTimeout;
+constexpr std::chrono::seconds Constants::kPrefixKvStoreAuditInterval;
+constexpr std::chrono::milliseconds Constants::kKvStoreTtlWheelTick;
 constexpr std::chrono::milliseconds Constants::kLinkImmediateTimeout;
 constexpr std::chrono::milliseconds Constants::kLinkThrottleTimeout;
 constexpr std::chrono::milliseconds Constants::kLongPollReqHoldTime;
@@ -57,6 +77,10 @@ constexpr std::chrono::milliseconds Constants::kMaxBackoff;
 constexpr std::chrono::milliseconds Constants::kMaxTtlUpdateInterval;
 constexpr std::chrono::milliseconds Constants::kPersistentStoreInitialBackoff;
 constexpr std::chrono::milliseconds Constants::kPersistentStoreMaxBackoff;
+constexpr size_t Constants::kPersistentStoreCompactionMinBytes;
+constexpr size_t Constants::kPersistentStoreCompactionRatio;
+constexpr std::chrono::milliseconds
+    Constants::kPersistentStoreGroupCommitWindow;
 constexpr std::chrono::milliseconds Constants::kPlatformConnTimeout;
 constexpr std::chrono::milliseconds Constants::kPlatformIntfProcTimeout;
 constexpr std::chrono::milliseconds Constants::kPlatformRoutesProcTimeout;
@@ -73,11 +97,24 @@ constexpr std::chrono::milliseconds Constants::kTtlInfInterval;
 constexpr std::chrono::milliseconds Constants::kTtlThreshold;
 constexpr std::chrono::seconds Constants::kConvergenceMaxDuration;
 constexpr std::chrono::seconds Constants::kCounterSubmitInterval;
+constexpr uint32_t Constants::kEvbLoopSampleRate;
+constexpr std::chrono::microseconds Constants::kEvbLoopBusyTimeBucketWidth;
+constexpr std::chrono::microseconds Constants::kEvbLoopBusyTimeMax;
+constexpr int64_t Constants::kEvbQueueDepthBucketWidth;
+constexpr int64_t Constants::kEvbQueueDepthMax;
+constexpr int Constants::kCpuProfileFrequencyHz;
+constexpr size_t Constants::kCpuProfileMaxSamples;
+constexpr size_t Constants::kCpuProfileMaxDepth;
+constexpr std::chrono::seconds Constants::kCpuProfileMaxDuration;
+constexpr std::chrono::seconds Constants::kCpuProfileOnStallDuration;
+constexpr folly::StringPiece Constants::kCpuProfilePathPrefix;
 constexpr std::chrono::seconds Constants::kKeepAliveIntvl;
 constexpr std::chrono::seconds Constants::kKeepAliveTime;
 constexpr std::chrono::seconds Constants::kFloodTopoDumpInterval;
 constexpr std::chrono::seconds Constants::kMemoryThresholdTime;
 constexpr std::chrono::seconds Constants::kNetlinkSyncThrottleInterval;
+constexpr std::chrono::seconds Constants::kInterfaceFullSyncInterval;
+constexpr std::chrono::milliseconds Constants::kNetlinkEventsLostCheckInterval;
 constexpr std::chrono::seconds Constants::kPlatformSyncInterval;
 constexpr std::chrono::seconds Constants::kPlatformThriftIdleTimeout;
 constexpr std::chrono::seconds Constants::kStoreSyncInterval;
@@ -59,6 +59,37 @@ class Constants {
   // default interval to publish to monitor
   static constexpr std::chrono::seconds kCounterSubmitInterval{5};
 
+  // CPU profiler sampling frequency
+  static constexpr int kCpuProfileFrequencyHz{100};
+
+  // Max number of stack samples kept by CPU profiler per profile
+  static constexpr size_t kCpuProfileMaxSamples{16384};
+
+  // Max depth of a stack sampled by CPU profiler
+  static constexpr size_t kCpuProfileMaxDepth{64};
+
+  // Upper limit on duration of a requested CPU profile
+  static constexpr std::chrono::seconds kCpuProfileMaxDuration{300};
+
+  // Duration of the CPU profile taken by watchdog on thread stall
+  static constexpr std::chrono::seconds kCpuProfileOnStallDuration{10};
+
+  // Path prefix of written CPU profiles, followed by `.<pid>.<ts>.prof`
+  static constexpr folly::StringPiece kCpuProfilePathPrefix{"/tmp/openr.cpu"};
+
+  // Eventbase loop telemetry is sampled once every this many loops
+  static constexpr uint32_t kEvbLoopSampleRate{8};
+
+  // bucket width of eventbase loop busy time histograms, ranging over
+  // [0, kEvbLoopBusyTimeMax]
+  static constexpr std::chrono::microseconds kEvbLoopBusyTimeBucketWidth{1000};
+  static constexpr std::chrono::microseconds kEvbLoopBusyTimeMax{100000};
+
+  // bucket width of eventbase notification queue depth histograms, ranging
+  // over [0, kEvbQueueDepthMax]
+  static constexpr int64_t kEvbQueueDepthBucketWidth{10};
+  static constexpr int64_t kEvbQueueDepthMax{500};
+
   // event log category
   static constexpr folly::StringPiece kEventLogCategory{"perfpipe_aquaman"};
 
@@ -74,6 +105,13 @@ class Constants {
   static constexpr std::chrono::milliseconds kPersistentStoreInitialBackoff{
       100};
   static constexpr std::chrono::milliseconds kPersistentStoreMaxBackoff{5000};
+  // Record log on disk is compacted once it is larger than min size and
+  // `ratio` times the size of live records
+  static constexpr size_t kPersistentStoreCompactionMinBytes{1 << 20};
+  static constexpr size_t kPersistentStoreCompactionRatio{4};
+  // Writes within the window are grouped into a single write and sync
+  static constexpr std::chrono::milliseconds kPersistentStoreGroupCommitWindow{
+      10};
 
   //
   // KvStore specific
@@ -92,6 +130,42 @@ class Constants {
   // kMaxBackoff to send the next sync request
   static constexpr size_t kMaxFullSyncPendingCountThreshold{32};
 
+  // Number of leaf buckets of KvStore merkle tree used for anti-entropy
+  // during full-sync. MUST be power of 2 and same across all nodes.
+  static constexpr size_t kKvStoreMerkleNumBuckets{1024};
+
+  // Soft limit of key and value bytes carried by a single chunk of streaming
+  // full-sync response
+  static constexpr size_t kKvStoreFullSyncChunkMaxBytes{1024 * 1024};
+
+  // Maximum number of routes carried by a single chunk of streaming ctrl
+  // dump APIs, e.g. getRouteDbStream
+  static constexpr size_t kCtrlStreamChunkSize{1000};
+
+  // Maximum number of argument sets cached per ctrl read API, see
+  // OpenrCtrlHandler::getCachedResponse
+  static constexpr size_t kCtrlResponseCacheSize{16};
+
+  // Number of latest spans kept in-process by HotPathTrace
+  static constexpr size_t kHotPathTraceSize{4096};
+
+  // Number of latest value updates kept in KvStore change-log for
+  // incremental sync with reconnecting peers
+  static constexpr size_t kKvStoreChangeLogSize{4096};
+
+  // zstd level, minimum size of values to compress and upper bound of
+  // decompressed size for dictionary compression of KvStore values
+  static constexpr int kKvStoreValueCompressionLevel{3};
+  static constexpr size_t kKvStoreValueCompressionMinBytes{64};
+  static constexpr size_t kKvStoreValueMaxDecompressedBytes{64 * 1024 * 1024};
+
+  // Tick, slots per level and number of levels of hierarchical timing wheel
+  // for KvStore TTL countdown. 4 levels of 256 slots with 1ms tick cover
+  // 2^32 ms, i.e. any finite int32 TTL.
+  static constexpr std::chrono::milliseconds kKvStoreTtlWheelTick{1};
+  static constexpr size_t kKvStoreTtlWheelSlotsPerLevel{256};
+  static constexpr size_t kKvStoreTtlWheelNumLevels{4};
+
   //
   // PrefixAllocator specific
   //
@@ -172,9 +246,22 @@ class Constants {
   static constexpr std::chrono::seconds kPlatformThriftIdleTimeout{
       Constants::kPlatformSyncInterval * 3};
 
+  // Window over which neighbor changes are coalesced into one notification to
+  // each neighbor listener of NetlinkFibHandler
+  static constexpr std::chrono::milliseconds kNeighborChangesThrottleTimeout{
+      100};
+
   // Duration for throttling full sync of network state from kernel via netlink
   static constexpr std::chrono::seconds kNetlinkSyncThrottleInterval{3};
 
+  // Interfaces are tracked with netlink events. Full sync with netlink dump is
+  // performed when events are lost, or at this long safety interval
+  static constexpr std::chrono::seconds kInterfaceFullSyncInterval{1800};
+
+  // Interval to check if netlink events are lost
+  static constexpr std::chrono::milliseconds kNetlinkEventsLostCheckInterval{
+      1000};
+
   // PrefixAllocator address programming retry interval 100 ms
   static constexpr std::chrono::milliseconds kPrefixAllocatorRetryInterval{100};
 
@@ -191,12 +278,25 @@ class Constants {
   // the time we hold on to announce to KvStore
   static constexpr std::chrono::milliseconds kKvStoreSyncThrottleTimeout{100};
 
+  // the time per-area shard of PrefixManager holds on to batch key updates
+  static constexpr std::chrono::milliseconds kPrefixAreaSyncThrottleTimeout{10};
+
+  // PrefixManager syncs only changed prefixes with KvStore. All prefixes are
+  // reconciled at this interval as an audit.
+  static constexpr std::chrono::seconds kPrefixKvStoreAuditInterval{600};
+
   // Kvstore timer for flooding pending publication
   static constexpr std::chrono::milliseconds kFloodPendingPublication{100};
 
+  // Kvstore timer for flooding coalesced TTL refreshes to thrift peers
+  static constexpr std::chrono::milliseconds kFloodPendingTtlUpdates{100};
+
   // KvStore database TTLs
   static constexpr std::chrono::milliseconds kKvStoreDbTtl{5min};
 
+  // Interval of writing KvStore snapshot to disk for warm start
+  static constexpr std::chrono::milliseconds kKvStoreSnapshotInterval{30s};
+
   // RangeAllocator keys TTLs
   static constexpr std::chrono::milliseconds kRangeAllocTtl{5min};
 
@@ -227,6 +327,10 @@ class Constants {
   // ms version
   static constexpr std::chrono::milliseconds kTtlInfInterval{kTtlInfinity};
 
+  // versions of hash generated for key-vals, see generateHash()
+  static constexpr int32_t kValueHashVersionLegacy{1};
+  static constexpr int32_t kValueHashVersionV2{2};
+
   // adjacencies can have weights for weighted ecmp
   static constexpr int64_t kDefaultAdjWeight{1};
 
@@ -234,6 +338,11 @@ class Constants {
   static constexpr uint16_t kPerfBufferSize{10};
   static constexpr std::chrono::seconds kConvergenceMaxDuration{3s};
 
+  // bucket width of convergence histograms, ranging over
+  // [0, kConvergenceMaxDuration]
+  static constexpr std::chrono::milliseconds kConvergenceHistogramBucketWidth{
+      10};
+
   // hold time for longPoll requests in openrCtrl thrift server
   static constexpr std::chrono::milliseconds kLongPollReqHoldTime{20000};
 
@@ -274,7 +383,13 @@ class Constants {
   //
 
   // Current OpenR version
-  static constexpr int32_t kOpenrVersion{20200825};
+  static constexpr int32_t kOpenrVersion{20211101};
+
+  // Lowest OpenR version parsing compact format of prefix keys
+  static constexpr int32_t kOpenrCompactPrefixKeyVersion{20211015};
+
+  // Lowest OpenR version parsing bucket keys of prefix database
+  static constexpr int32_t kOpenrPrefixDbBucketKeyVersion{20211101};
 
   // Lowest Supported OpenR version
   static constexpr int32_t kOpenrSupportedVersion{20200604};
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <openr/common/HotPathTrace.h>
+
+#include <folly/Indestructible.h>
+#include <folly/Synchronized.h>
+#include <folly/tracing/StaticTracepoint.h>
+
+#include <openr/common/Constants.h>
+
+namespace openr {
+
+namespace {
+
+struct Span {
+  const char* name{nullptr};
+  std::string area;
+  int64_t startUnixTsUs{0};
+  int64_t durationUs{0};
+  int64_t count{0};
+};
+
+// fixed size ring, overwriting the oldest span once full
+struct SpanRing {
+  std::vector<Span> spans;
+  // position of the oldest span once ring is full
+  size_t next{0};
+};
+
+folly::Synchronized<SpanRing>&
+getSpanRing() {
+  static folly::Indestructible<folly::Synchronized<SpanRing>> ring;
+  return *ring;
+}
+
+} // namespace
+
+void
+HotPathTrace::record(
+    const char* name,
+    std::string const& area,
+    Clock::time_point start,
+    Clock::time_point end,
+    int64_t count) {
+  using namespace std::chrono;
+  // translate steady clock into wall clock for correlation across hosts
+  const auto startUnixTsUs =
+      duration_cast<microseconds>(
+          (system_clock::now() - (Clock::now() - start)).time_since_epoch())
+          .count();
+  const auto durationUs = duration_cast<microseconds>(end - start).count();
+
+  FOLLY_SDT(
+      openr, span, name, area.c_str(), startUnixTsUs, durationUs, count);
+
+  Span span{name, area, startUnixTsUs, durationUs, count};
+  auto ring = getSpanRing().wlock();
+  if (ring->spans.size() < Constants::kHotPathTraceSize) {
+    ring->spans.emplace_back(std::move(span));
+    return;
+  }
+  ring->spans[ring->next] = std::move(span);
+  ring->next = (ring->next + 1) % ring->spans.size();
+}
+
+std::vector<thrift::TraceSpan>
+HotPathTrace::getSpans() {
+  std::vector<thrift::TraceSpan> spans;
+  auto ring = getSpanRing().rlock();
+  spans.reserve(ring->spans.size());
+  for (size_t i = 0; i < ring->spans.size(); ++i) {
+    auto const& span = ring->spans[(ring->next + i) % ring->spans.size()];
+    auto& tSpan = spans.emplace_back();
+    tSpan.name_ref() = span.name;
+    tSpan.area_ref() = span.area;
+    tSpan.startUnixTsUs_ref() = span.startUnixTsUs;
+    tSpan.durationUs_ref() = span.durationUs;
+    tSpan.count_ref() = span.count;
+  }
+  return spans;
+}
+
+void
+HotPathTrace::clear() {
+  auto ring = getSpanRing().wlock();
+  ring->spans.clear();
+  ring->next = 0;
+}
+
+} // namespace openr
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <openr/if/gen-cpp2/Types_types.h>
+
+namespace openr {
+
+/**
+ * Process wide trace of spans at hot-path points of route convergence, from
+ * KvStore receive to FIB programmed. Unlike PerfEvents, which are attached to
+ * some updates only, every run of a traced point is recorded, so convergence
+ * latency can be broken down by correlating spans in time.
+ *
+ * Spans are kept in a bounded in-process ring buffer, exported by the
+ * `getTraceSpans` ctrl API, and fired as USDT probe `openr:span` with
+ * arguments (name, area, start unix ts us, duration us, count), e.g.
+ *
+ *   bpftrace -e 'usdt:/usr/sbin/openr:openr:span {
+ *     printf("%s %s %lld\n", str(arg0), str(arg1), arg3); }'
+ *
+ * Points are traced per batch, never per key or route, hence recording is
+ * cheap enough to stay always on. Thread-safe.
+ */
+class HotPathTrace {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  // record span of [start, end). `name` MUST be a string literal
+  static void record(
+      const char* name,
+      std::string const& area,
+      Clock::time_point start,
+      Clock::time_point end,
+      int64_t count = 1);
+
+  // latest spans in order of completion, oldest first
+  static std::vector<thrift::TraceSpan> getSpans();
+
+  // drop all recorded spans
+  static void clear();
+};
+
+/**
+ * Records a span of its own lifetime with HotPathTrace
+ */
+class ScopedTraceSpan {
+ public:
+  explicit ScopedTraceSpan(
+      const char* name, std::string area = "", int64_t count = 1)
+      : name_(name),
+        area_(std::move(area)),
+        count_(count),
+        start_(HotPathTrace::Clock::now()) {}
+
+  ~ScopedTraceSpan() {
+    HotPathTrace::record(
+        name_, area_, start_, HotPathTrace::Clock::now(), count_);
+  }
+
+  ScopedTraceSpan(ScopedTraceSpan const&) = delete;
+  ScopedTraceSpan& operator=(ScopedTraceSpan const&) = delete;
+
+  // set number of items processed, if only known by the end of span
+  void
+  setCount(int64_t count) {
+    count_ = count;
+  }
+
+ private:
+  const char* name_{nullptr};
+  const std::string area_;
+  int64_t count_{1};
+  const HotPathTrace::Clock::time_point start_;
+};
+
+} // namespace openr
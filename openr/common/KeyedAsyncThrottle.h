@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include <folly/Function.h>
+#include <folly/io/async/AsyncTimeout.h>
+#include <folly/io/async/EventBase.h>
+
+namespace openr {
+
+/**
+ * Keyed version of AsyncThrottle. Instead of a bare signal, every event marks
+ * a key (e.g. prefix, interface, KvStore key) as dirty. Dirty keys accumulate
+ * until the throttle fires, and are handed to the callback as one batch, so
+ * that only the affected keys need to be processed.
+ *
+ *  KeyedAsyncThrottle<folly::CIDRNetwork> syncPrefixes(
+ *      evb, 100ms, [this](auto&& prefixes) noexcept {
+ *        for (auto const& prefix : prefixes) { syncPrefix(prefix); }
+ *      });
+ *
+ *  syncPrefixes(prefix); // on every change of prefix
+ *
+ * Optionally, `keyMinInterval` limits how often each key is handed to the
+ * callback. A key marked again within `keyMinInterval` since it last fired is
+ * held back, and is included in the first batch after its interval elapsed.
+ * Other keys aren't delayed by it.
+ *
+ * Like AsyncThrottle, it must be used from the thread of its event base.
+ */
+template <typename Key, typename Hash = std::hash<Key>>
+class KeyedAsyncThrottle final : private folly::AsyncTimeout {
+ public:
+  using KeySet = std::unordered_set<Key, Hash>;
+  using BatchCallback = folly::Function<void(KeySet&&) noexcept>;
+
+  KeyedAsyncThrottle(
+      folly::EventBase* eventBase,
+      std::chrono::milliseconds timeout,
+      BatchCallback callback,
+      std::chrono::milliseconds keyMinInterval = std::chrono::milliseconds(0))
+      : AsyncTimeout(eventBase),
+        timeout_(timeout),
+        keyMinInterval_(keyMinInterval),
+        callback_(std::move(callback)) {
+    CHECK(callback_);
+  }
+
+  ~KeyedAsyncThrottle() override = default;
+
+  /**
+   * Mark `key` as dirty. Callback is scheduled if it isn't already.
+   */
+  void
+  operator()(Key key) noexcept {
+    if (keyMinInterval_ <= std::chrono::milliseconds(0)) {
+      pendingKeys_.emplace(std::move(key));
+      if (not isScheduled()) {
+        scheduleAt(Clock::now() + timeout_);
+      }
+      return;
+    }
+
+    // Fire no earlier than end of min interval of key
+    const auto now = Clock::now();
+    auto fireTime = now + timeout_;
+    auto it = lastFiredTimes_.find(key);
+    if (it != lastFiredTimes_.end()) {
+      fireTime = std::max(fireTime, it->second + keyMinInterval_);
+    }
+    pendingKeys_.emplace(std::move(key));
+    scheduleAt(fireTime);
+  }
+
+  /**
+   * Number of dirty keys waiting for the callback
+   */
+  size_t
+  numPendingKeys() const {
+    return pendingKeys_.size();
+  }
+
+  bool
+  isPending(Key const& key) const {
+    return pendingKeys_.count(key) != 0;
+  }
+
+  /**
+   * Tells you if this is currently active ?
+   */
+  bool
+  isActive() const {
+    return isScheduled();
+  }
+
+  /**
+   * Cancel scheduled callback and drop dirty keys
+   */
+  void
+  cancel() {
+    cancelTimeout();
+    pendingKeys_.clear();
+  }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  // Schedule callback at `fireTime`, unless it's already scheduled earlier
+  void
+  scheduleAt(Clock::time_point fireTime) noexcept {
+    if (isScheduled() and scheduledTime_ <= fireTime) {
+      return;
+    }
+
+    // Special case to handle immediate timeouts
+    const auto now = Clock::now();
+    if (fireTime <= now) {
+      cancelTimeout();
+      timeoutExpired();
+      return;
+    }
+
+    scheduledTime_ = fireTime;
+    scheduleTimeout(
+        std::chrono::ceil<std::chrono::milliseconds>(fireTime - now));
+  }
+
+  void
+  timeoutExpired() noexcept override {
+    if (keyMinInterval_ <= std::chrono::milliseconds(0)) {
+      callback_(std::exchange(pendingKeys_, {}));
+      return;
+    }
+
+    // Hold back keys fired within min interval, and forget about the ones
+    // whose interval has elapsed
+    const auto now = Clock::now();
+    std::optional<Clock::time_point> nextDueTime;
+    KeySet keys;
+    for (auto it = pendingKeys_.begin(); it != pendingKeys_.end();) {
+      auto firedIt = lastFiredTimes_.find(*it);
+      if (firedIt != lastFiredTimes_.end() and
+          firedIt->second + keyMinInterval_ > now) {
+        const auto dueTime = firedIt->second + keyMinInterval_;
+        nextDueTime = std::min(nextDueTime.value_or(dueTime), dueTime);
+        ++it;
+        continue;
+      }
+      keys.emplace(std::move(pendingKeys_.extract(it++).value()));
+    }
+    for (auto it = lastFiredTimes_.begin(); it != lastFiredTimes_.end();) {
+      if (it->second + keyMinInterval_ <= now) {
+        it = lastFiredTimes_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    for (auto const& key : keys) {
+      lastFiredTimes_[key] = now;
+    }
+
+    if (not keys.empty()) {
+      callback_(std::move(keys));
+    }
+
+    // Schedule held back keys
+    if (nextDueTime.has_value()) {
+      scheduleAt(std::max(now + timeout_, *nextDueTime));
+    }
+  }
+
+  const std::chrono::milliseconds timeout_{0};
+  const std::chrono::milliseconds keyMinInterval_{0};
+  BatchCallback callback_{nullptr};
+
+  // Keys marked dirty since last callback
+  KeySet pendingKeys_;
+
+  // Keys handed to callback within last `keyMinInterval_`, and when
+  std::unordered_map<Key, Clock::time_point, Hash> lastFiredTimes_;
+
+  // Time scheduled callback fires at
+  Clock::time_point scheduledTime_;
+};
+
+} // namespace openr
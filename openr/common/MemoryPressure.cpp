@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <openr/common/MemoryPressure.h>
+
+#include <atomic>
+#include <map>
+#include <vector>
+
+#include <fb303/ServiceData.h>
+#include <folly/Indestructible.h>
+#include <folly/Synchronized.h>
+#include <glog/logging.h>
+
+namespace fb303 = facebook::fb303;
+
+namespace openr {
+
+namespace {
+
+struct ShedderEntry {
+  std::string name;
+  folly::Executor* executor{nullptr};
+  std::function<void()> shed;
+};
+
+struct ShedderRegistry {
+  uint64_t nextId{1};
+  std::map<uint64_t, ShedderEntry> shedders;
+};
+
+folly::Synchronized<ShedderRegistry>&
+getRegistry() {
+  static folly::Indestructible<folly::Synchronized<ShedderRegistry>> registry;
+  return *registry;
+}
+
+std::atomic<bool> underPressure{false};
+
+// Run shedder `id` if still registered. Registry stays read-locked while
+// shedder runs, hence it can't be unregistered, i.e. destroyed, meanwhile.
+void
+runShedder(uint64_t id) {
+  auto registry = getRegistry().rlock();
+  auto it = registry->shedders.find(id);
+  if (it == registry->shedders.end()) {
+    return;
+  }
+  VLOG(1) << "[Mem Pressure] Shedding memory of " << it->second.name;
+  it->second.shed();
+}
+
+} // namespace
+
+MemoryPressure::Shedder::~Shedder() {
+  getRegistry().wlock()->shedders.erase(id_);
+}
+
+std::unique_ptr<MemoryPressure::Shedder>
+MemoryPressure::addShedder(
+    std::string name, folly::Executor* executor, std::function<void()> shed) {
+  auto registry = getRegistry().wlock();
+  const auto id = registry->nextId++;
+  registry->shedders.emplace(
+      id, ShedderEntry{std::move(name), executor, std::move(shed)});
+  return std::make_unique<Shedder>(id);
+}
+
+void
+MemoryPressure::setUnderPressure(bool pressure) {
+  if (underPressure.exchange(pressure) != pressure) {
+    LOG(WARNING) << "[Mem Pressure] "
+                 << (pressure ? "Entering" : "Leaving") << " memory pressure";
+  }
+  fb303::fbData->setCounter("memory_pressure", pressure ? 1 : 0);
+}
+
+bool
+MemoryPressure::isUnderPressure() {
+  return underPressure.load();
+}
+
+void
+MemoryPressure::shed() {
+  std::vector<uint64_t> inlineShedders;
+  {
+    // executors outlive registration of their shedders
+    auto registry = getRegistry().rlock();
+    for (auto const& [id, entry] : registry->shedders) {
+      if (entry.executor) {
+        entry.executor->add([id = id]() { runShedder(id); });
+      } else {
+        inlineShedders.emplace_back(id);
+      }
+    }
+  }
+  for (auto id : inlineShedders) {
+    runShedder(id);
+  }
+}
+
+} // namespace openr
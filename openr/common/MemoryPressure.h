@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <folly/Executor.h>
+
+namespace openr {
+
+/**
+ * Process wide memory pressure state, set by Watchdog once memory usage goes
+ * above its soft limit, ahead of crashing on the hard limit.
+ *
+ * Modules register shedders dropping optional memory, e.g. memoization and
+ * caches, which are run on every `shed()` while under pressure. Modules may
+ * also check `isUnderPressure()` to refuse optional work. Thread-safe.
+ */
+class MemoryPressure {
+ public:
+  /**
+   * Registration of a shedder, unregistered on destruction. Once destroyed,
+   * shedder is guaranteed not to run anymore, hence hold it as a member
+   * declared after anything the shedder touches.
+   */
+  class Shedder {
+   public:
+    explicit Shedder(uint64_t id) : id_(id) {}
+    ~Shedder();
+
+    Shedder(Shedder const&) = delete;
+    Shedder& operator=(Shedder const&) = delete;
+
+   private:
+    const uint64_t id_{0};
+  };
+
+  // Register `shed` to be run on `executor`, or inline on the calling thread
+  // of `shed()` if nullptr
+  static std::unique_ptr<Shedder> addShedder(
+      std::string name, folly::Executor* executor, std::function<void()> shed);
+
+  static void setUnderPressure(bool underPressure);
+
+  static bool isUnderPressure();
+
+  // Run all registered shedders
+  static void shed();
+};
+
+} // namespace openr
@@ -19,8 +19,10 @@
 #include <openr/if/gen-cpp2/Network_types.h>
 #include <openr/if/gen-cpp2/OpenrCtrl_types.h>
 #include <openr/if/gen-cpp2/Types_types.h>
+#include <optional>
 #include <type_traits>
 #include <unordered_set>
+#include <vector>
 
 namespace std {
 
@@ -121,6 +123,27 @@ toIPAddress(const thrift::BinaryAddress& addr) {
       addr.addr_ref()->size()));
 }
 
+/**
+ * Non-throwing conversion from raw address bytes. Neither parses nor formats
+ * strings, hence allocation free. Returns std::nullopt for length other than
+ * 4 or 16 bytes.
+ */
+inline std::optional<folly::IPAddress>
+tryToIPAddress(folly::ByteRange bytes) noexcept {
+  auto maybeAddr = folly::IPAddress::tryFromBinary(bytes);
+  if (maybeAddr.hasError()) {
+    return std::nullopt;
+  }
+  return maybeAddr.value();
+}
+
+inline std::optional<folly::IPAddress>
+tryToIPAddress(const thrift::BinaryAddress& addr) noexcept {
+  return tryToIPAddress(folly::ByteRange(
+      reinterpret_cast<const unsigned char*>(addr.addr_ref()->data()),
+      addr.addr_ref()->size()));
+}
+
 // construct thrift::IpPrefix
 inline thrift::IpPrefix
 createIpPrefix(
@@ -215,19 +238,80 @@ toString(const thrift::MplsRoute& route) {
   return folly::join("\n", lines);
 }
 
+/**
+ * Non-throwing conversion of thrift::IpPrefix, masking address straight from
+ * its bytes. Returns std::nullopt for invalid address or prefix length.
+ */
+inline std::optional<folly::CIDRNetwork>
+tryToIPNetwork(const thrift::IpPrefix& prefix, bool applyMask = true) noexcept {
+  auto addr = tryToIPAddress(*prefix.prefixAddress_ref());
+  const auto prefixLength = *prefix.prefixLength_ref();
+  if (not addr.has_value() or prefixLength < 0 or
+      static_cast<size_t>(prefixLength) > addr->bitCount()) {
+    return std::nullopt;
+  }
+  return folly::CIDRNetwork(
+      applyMask ? addr->mask(prefixLength) : *addr, prefixLength);
+}
+
 inline folly::CIDRNetwork
 toIPNetwork(const thrift::IpPrefix& prefix, bool applyMask = true) {
-  folly::CIDRNetwork network;
-  try {
-    network = folly::IPAddress::createNetwork(
-        toIPAddress(*prefix.prefixAddress_ref()).str(),
-        *prefix.prefixLength_ref(),
-        applyMask);
-  } catch (const folly::IPAddressFormatException& e) {
+  auto network = tryToIPNetwork(prefix, applyMask);
+  if (not network.has_value()) {
+    auto addr = tryToIPAddress(*prefix.prefixAddress_ref());
     throw thrift::OpenrError(fmt::format(
-        "Invalid IPAddress: {}, exception: {}", toString(prefix), e.what()));
+        "Invalid IpPrefix: {}/{}",
+        addr.has_value() ? addr->str() : "<invalid address>",
+        *prefix.prefixLength_ref()));
+  }
+  return *network;
+}
+
+/**
+ * Bulk conversions of prefixes, e.g. of routes in a FIB update. Result is
+ * sized once. Invalid prefixes are skipped instead of throwing, and counted
+ * into `numInvalid` if given.
+ */
+inline std::vector<folly::CIDRNetwork>
+toIPNetworks(
+    const std::vector<thrift::IpPrefix>& prefixes,
+    size_t* numInvalid = nullptr) {
+  std::vector<folly::CIDRNetwork> networks;
+  networks.reserve(prefixes.size());
+  for (auto const& prefix : prefixes) {
+    if (auto network = tryToIPNetwork(prefix)) {
+      networks.emplace_back(*network);
+    } else if (numInvalid) {
+      ++(*numInvalid);
+    }
+  }
+  return networks;
+}
+
+inline std::vector<folly::CIDRNetwork>
+toIPNetworks(
+    const std::vector<thrift::UnicastRoute>& routes,
+    size_t* numInvalid = nullptr) {
+  std::vector<folly::CIDRNetwork> networks;
+  networks.reserve(routes.size());
+  for (auto const& route : routes) {
+    if (auto network = tryToIPNetwork(*route.dest_ref())) {
+      networks.emplace_back(*network);
+    } else if (numInvalid) {
+      ++(*numInvalid);
+    }
+  }
+  return networks;
+}
+
+inline std::vector<thrift::IpPrefix>
+toIpPrefixes(const std::vector<folly::CIDRNetwork>& networks) {
+  std::vector<thrift::IpPrefix> prefixes;
+  prefixes.reserve(networks.size());
+  for (auto const& network : networks) {
+    prefixes.emplace_back(toIpPrefix(network));
   }
-  return network;
+  return prefixes;
 }
 
 /**
@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <type_traits>
+
 #include <folly/io/SocketOptionMap.h>
 #include <folly/io/async/AsyncSSLSocket.h>
 #include <folly/io/async/AsyncSocket.h>
@@ -58,6 +60,10 @@ getSocketOptionMap(std::optional<int> maybeIpTos) {
  * apache::thrift::RocketClientChannel => This is new channel. It supports
  * streaming APIs. Use this if you need stream APIs.
  *
+ * `enableCompression` asks server to zstd compress responses, including
+ * stream chunks, of this connection. It's enabled by default for
+ * HeaderClientChannel only. Enable it for streaming subscribers over WAN,
+ * e.g. of the full KvStore, where bandwidth matters more than CPU.
  */
 template <typename ClientChannel = apache::thrift::HeaderClientChannel>
 static std::unique_ptr<thrift::OpenrCtrlCppAsyncClient>
@@ -69,7 +75,9 @@ getOpenrCtrlPlainTextClient(
     std::chrono::milliseconds processingTimeout =
         Constants::kServiceProcTimeout,
     const folly::SocketAddress& bindAddr = folly::AsyncSocket::anyAddress(),
-    std::optional<int> maybeIpTos = std::nullopt) {
+    std::optional<int> maybeIpTos = std::nullopt,
+    bool enableCompression =
+        std::is_same_v<ClientChannel, apache::thrift::HeaderClientChannel>) {
   // NOTE: It is possible to have caching for socket. We're not doing it as
   // we expect clients to be persistent/sticky.
   std::unique_ptr<thrift::OpenrCtrlCppAsyncClient> client{nullptr};
@@ -92,9 +100,9 @@ getOpenrCtrlPlainTextClient(
     auto channel = ClientChannel::newChannel(std::move(transport));
     channel->setTimeout(processingTimeout.count());
 
-    // Enable compression for efficient transport when available. This will
+    // Enable compression for efficient transport when asked for. This will
     // incur CPU cost but it is insignificant for usual queries.
-    if (typeid(ClientChannel) == typeid(apache::thrift::HeaderClientChannel)) {
+    if (enableCompression) {
       detail::setCompressionTransform(channel.get());
     }
 
@@ -5,8 +5,13 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <fb303/ServiceData.h>
 #include <folly/fibers/FiberManagerMap.h>
+#include <openr/common/Constants.h>
 #include <openr/common/OpenrEventBase.h>
+#include <openr/common/Util.h>
+
+namespace fb303 = facebook::fb303;
 
 namespace openr {
 
@@ -44,6 +49,27 @@ EventBaseStopSignalHandler::signalReceived(int signal) noexcept {
   LOG(INFO) << "Openr event-base stopped";
 }
 
+ReloadSignalHandler::ReloadSignalHandler(folly::EventBase* evb)
+    : folly::AsyncSignalHandler(evb) {
+  registerSignalHandler(SIGHUP);
+}
+
+void
+ReloadSignalHandler::setCallback(folly::Function<void()> callback) {
+  getEventBase()->runImmediatelyOrRunInEventBaseThreadAndWait(
+      [this, &callback]() { callback_ = std::move(callback); });
+}
+
+void
+ReloadSignalHandler::signalReceived(int signal) noexcept {
+  if (not callback_) {
+    LOG(INFO) << "Caught signal: " << signal << ". Nothing to reload yet.";
+    return;
+  }
+  LOG(INFO) << "Caught signal: " << signal << ". Reloading...";
+  callback_();
+}
+
 OpenrEventBase::ZmqEventHandler::ZmqEventHandler(
     folly::EventBase* evb,
     int fd,
@@ -131,6 +157,78 @@ OpenrEventBase::OpenrEventBase()
     timeout_->scheduleTimeout(std::chrono::seconds(1));
   });
   timeout_->scheduleTimeout(0);
+
+  evb_.setObserver(std::make_shared<LoopObserver>(this));
+}
+
+uint32_t
+OpenrEventBase::LoopObserver::getSampleRate() const {
+  return Constants::kEvbLoopSampleRate;
+}
+
+void
+OpenrEventBase::LoopObserver::loopSample(int64_t busyTime, int64_t idleTime) {
+  if (busyTimeKey_.empty()) {
+    const auto& name = parent_->evbName_;
+    busyTimeKey_ = fmt::format("evb.loop_busy_time_us.{}", name);
+    busyPctKey_ = fmt::format("evb.loop_busy_pct.{}", name);
+    queueDepthKey_ = fmt::format("evb.queue_depth.{}", name);
+    fb303::fbData->addHistogram(
+        busyTimeKey_,
+        Constants::kEvbLoopBusyTimeBucketWidth.count(),
+        0,
+        Constants::kEvbLoopBusyTimeMax.count());
+    fb303::fbData->addHistogram(busyPctKey_, 5, 0, 100);
+    fb303::fbData->addHistogram(
+        queueDepthKey_,
+        Constants::kEvbQueueDepthBucketWidth,
+        0,
+        Constants::kEvbQueueDepthMax);
+    for (auto const& key : {busyTimeKey_, busyPctKey_, queueDepthKey_}) {
+      fb303::fbData->exportHistogramPercentile(key, 50, 90, 99);
+    }
+  }
+
+  // busy and idle time of the sampled loop in us
+  fb303::fbData->addHistogramValue(busyTimeKey_, busyTime);
+  if (busyTime + idleTime > 0) {
+    fb303::fbData->addHistogramValue(
+        busyPctKey_, busyTime * 100 / (busyTime + idleTime));
+  }
+  fb303::fbData->addHistogramValue(
+      queueDepthKey_, parent_->evb_.getNotificationQueueSize());
+}
+
+folly::EventBase::Func
+OpenrEventBase::timeCallback(
+    const char* type, folly::EventBase::Func callback) {
+  return [this, type, callback = std::move(callback)]() mutable noexcept {
+    const auto start = std::chrono::steady_clock::now();
+    callback();
+    logIfSlowCallback(type, start);
+  };
+}
+
+void
+OpenrEventBase::logIfSlowCallback(
+    const char* type, std::chrono::steady_clock::time_point start) noexcept {
+  const std::chrono::milliseconds threshold(slowCallbackThresholdMs_.load());
+  if (threshold.count() == 0) {
+    return;
+  }
+  const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+  if (duration < threshold) {
+    return;
+  }
+  fb303::fbData->addStatValue(
+      fmt::format("evb.slow_callbacks.{}", evbName_), 1, fb303::COUNT);
+  LOG(WARNING) << fmt::format(
+      "[{}] Slow {} ran for {}ms, threshold {}ms",
+      evbName_,
+      type,
+      duration.count(),
+      threshold.count());
 }
 
 OpenrEventBase::~OpenrEventBase() {}
@@ -140,11 +238,25 @@ OpenrEventBase::run() {
   evb_.loopForever();
 }
 
+void
+OpenrEventBase::bindDedicatedArena() {
+  CHECK(not isRunning()) << "Arena must be bound before running eventbase";
+  if (auto arenaIndex = memory::bindThreadToNewArena()) {
+    LOG(INFO) << "Bound eventbase " << evbName_ << " to arena " << *arenaIndex;
+    arenaIndex_.store(*arenaIndex);
+  }
+}
+
 void
 OpenrEventBase::stop() {
   for (auto& future : fiberTaskFutures_) {
     future.wait();
   }
+#if FOLLY_HAS_COROUTINES
+  for (auto& future : coroTaskFutures_) {
+    future.wait();
+  }
+#endif
   evb_.terminateLoopSoon();
 }
 
@@ -169,14 +281,15 @@ void
 OpenrEventBase::scheduleTimeout(
     std::chrono::milliseconds timeout, folly::EventBase::Func callback) {
   evb_.scheduleAt(
-      std::move(callback), timeout + std::chrono::steady_clock::now());
+      timeCallback("timeout", std::move(callback)),
+      timeout + std::chrono::steady_clock::now());
 }
 
 void
 OpenrEventBase::scheduleTimeoutAt(
     std::chrono::steady_clock::time_point scheduleTime,
     folly::EventBase::Func callback) {
-  evb_.scheduleAt(std::move(callback), scheduleTime);
+  evb_.scheduleAt(timeCallback("timeout", std::move(callback)), scheduleTime);
 }
 
 void
@@ -192,7 +305,11 @@ OpenrEventBase::addSocketFd(int socketFd, int events, SocketCallback callback) {
           socketFd,
           reinterpret_cast<uintptr_t>(nullptr),
           events,
-          std::move(callback)));
+          [this, callback = std::move(callback)](int revents) mutable noexcept {
+            const auto start = std::chrono::steady_clock::now();
+            callback(revents);
+            logIfSlowCallback("socket callback", start);
+          }));
 }
 
 void
@@ -206,7 +323,15 @@ OpenrEventBase::addSocket(
       std::piecewise_construct,
       std::forward_as_tuple(socketFd),
       std::forward_as_tuple(
-          &evb_, socketFd, socketPtr, events, std::move(callback)));
+          &evb_,
+          socketFd,
+          socketPtr,
+          events,
+          [this, callback = std::move(callback)](int revents) mutable noexcept {
+            const auto start = std::chrono::steady_clock::now();
+            callback(revents);
+            logIfSlowCallback("socket callback", start);
+          }));
 }
 
 void
@@ -8,12 +8,17 @@
 #pragma once
 
 #include <csignal>
+#include <optional>
 
 #include <fbzmq/async/ZmqEventLoop.h>
 #include <fbzmq/zmq/Socket.h>
+#include <folly/Function.h>
 #include <folly/fibers/FiberManager.h>
 #include <folly/io/async/AsyncSignalHandler.h>
 #include <folly/io/async/EventHandler.h>
+#if FOLLY_HAS_COROUTINES
+#include <folly/experimental/coro/Task.h>
+#endif
 
 namespace openr {
 
@@ -27,6 +32,25 @@ class EventBaseStopSignalHandler : public folly::AsyncSignalHandler {
   void signalReceived(int signum) noexcept override;
 };
 
+/**
+ * Invoke callback on SIGHUP, e.g. to reload config. Callback runs in the
+ * thread of event-base. SIGHUP is ignored until callback is set, instead of
+ * terminating the process as by default.
+ */
+class ReloadSignalHandler : public folly::AsyncSignalHandler {
+ public:
+  explicit ReloadSignalHandler(folly::EventBase* evb);
+
+  // Thread safe
+  void setCallback(folly::Function<void()> callback);
+
+ protected:
+  void signalReceived(int signum) noexcept override;
+
+ private:
+  folly::Function<void()> callback_{nullptr};
+};
+
 class OpenrEventBase {
  public:
   OpenrEventBase();
@@ -62,12 +86,33 @@ class OpenrEventBase {
     return fiberManager_.addTaskFuture(std::move(func));
   }
 
+#if FOLLY_HAS_COROUTINES
+  /**
+   * Add a coroutine task, e.g. queue-consumer loop reading with `getCoro()`.
+   * Unlike fiber task it doesn't hold a fiber stack nor a thread while
+   * waiting. Task runs on `executor`, defaulting to this event-base. Pass a
+   * strand of SharedExecutor to run it off this thread, in which case it must
+   * not touch state owned by this event-base. All tasks will be awaited in
+   * `stop()`.
+   */
+  void
+  addCoroTask(
+      folly::coro::Task<void>&& task,
+      folly::Executor::KeepAlive<> executor = {}) {
+    if (not executor) {
+      executor = folly::getKeepAliveToken(evb_);
+    }
+    coroTaskFutures_.emplace_back(
+        std::move(task).scheduleOn(std::move(executor)).start());
+  }
+#endif
+
   /**
    * EventBase API aliases
    */
   void
   runInEventBaseThread(folly::EventBase::Func callback) {
-    evb_.runInEventBaseThread(std::move(callback));
+    evb_.runInEventBaseThread(timeCallback("callback", std::move(callback)));
   }
 
   /**
@@ -129,7 +174,71 @@ class OpenrEventBase {
     evbName_ = name;
   }
 
+  /**
+   * Loop telemetry APIs
+   *
+   * Every `Constants::kEvbLoopSampleRate` loops, busy time, busy percentage
+   * and notification queue depth of the loop are added to histograms
+   * `evb.loop_busy_time_us.<name>`, `evb.loop_busy_pct.<name>` and
+   * `evb.queue_depth.<name>`.
+   */
+
+  // Log callbacks scheduled via this eventbase, i.e. `runInEventBaseThread`,
+  // timeouts and socket callbacks, which run for `threshold` or longer and
+  // count them in `evb.slow_callbacks.<name>`. Zero (default) disables
+  void
+  setSlowCallbackThreshold(std::chrono::milliseconds threshold) noexcept {
+    slowCallbackThresholdMs_.store(threshold.count());
+  }
+
+  /**
+   * Memory accounting APIs
+   */
+
+  // Bind calling thread to a dedicated jemalloc arena, so that memory
+  // allocated by this eventbase can be accounted separately. MUST be called
+  // from the thread running this eventbase, before `run()`.
+  void bindDedicatedArena();
+
+  // Index of dedicated jemalloc arena, std::nullopt if not bound to any
+  std::optional<unsigned>
+  getArenaIndex() const {
+    const auto arenaIndex = arenaIndex_.load();
+    if (arenaIndex < 0) {
+      return std::nullopt;
+    }
+    return static_cast<unsigned>(arenaIndex);
+  }
+
  private:
+  /**
+   * Samples eventbase loops for loop telemetry histograms
+   */
+  class LoopObserver : public folly::EventBaseObserver {
+   public:
+    explicit LoopObserver(OpenrEventBase* parent) : parent_(parent) {}
+
+    uint32_t getSampleRate() const override;
+
+    void loopSample(int64_t busyTime, int64_t idleTime) override;
+
+   private:
+    OpenrEventBase* const parent_{nullptr};
+
+    // Histogram keys, registered on first sample once eventbase is named
+    std::string busyTimeKey_;
+    std::string busyPctKey_;
+    std::string queueDepthKey_;
+  };
+
+  // Wrap callback to log it if running longer than slow callback threshold
+  folly::EventBase::Func timeCallback(
+      const char* type, folly::EventBase::Func callback);
+
+  void logIfSlowCallback(
+      const char* type,
+      std::chrono::steady_clock::time_point start) noexcept;
+
   /**
    * Event handler class for sockets and fds
    */
@@ -167,6 +276,9 @@ class OpenrEventBase {
   // FiberManager driven by evb_, for scheduling fiber tasks
   folly::fibers::FiberManager& fiberManager_;
   std::vector<folly::Future<folly::Unit>> fiberTaskFutures_;
+#if FOLLY_HAS_COROUTINES
+  std::vector<folly::SemiFuture<folly::Unit>> coroTaskFutures_;
+#endif
 
   // Data structure to hold fd and their handlers
   std::unordered_map<int /* fd */, ZmqEventHandler> fdHandlers_;
@@ -177,6 +289,12 @@ class OpenrEventBase {
 
   // Unique name to identify eventbase
   std::string evbName_;
+
+  // Index of dedicated jemalloc arena, -1 if not bound to any
+  std::atomic<int64_t> arenaIndex_{-1};
+
+  // Threshold in ms to log slow callbacks, 0 if disabled
+  std::atomic<int64_t> slowCallbackThresholdMs_{0};
 };
 
 } // namespace openr
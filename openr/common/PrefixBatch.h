@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <limits>
+#include <unordered_set>
+#include <vector>
+
+#include <folly/IPAddress.h>
+#include <glog/logging.h>
+
+#include <openr/if/gen-cpp2/Network_types.h>
+#include <openr/if/gen-cpp2/Types_types.h>
+
+namespace openr {
+
+/**
+ * Columnar batch of routes for bulk injection by in-process plugins, e.g.
+ * full table of a co-located BGP speaker, instead of a thrift::PrefixEntry
+ * per route.
+ *
+ * Routes are kept as contiguous columns of networks and indices. Attributes
+ * (type, forwarding type/algorithm, metrics, tags, ...) and next-hops to
+ * program are shared by many routes of a full table, hence stored once and
+ * referred to by index:
+ *
+ *  PrefixBatch batch;
+ *  batch.reserve(numRoutes);
+ *  auto attrs = batch.addAttributes(bgpAttributes);
+ *  auto nexthops = batch.addNextHopGroup({nh1, nh2});
+ *  for (auto const& network : networks) {
+ *    batch.addRoute(network, attrs, nexthops);
+ *  }
+ *
+ * Batch is carried by PrefixEvent as shared pointer to const, hence handing
+ * it through the replicate queue copies no route.
+ */
+class PrefixBatch {
+ public:
+  using NextHopSet = std::unordered_set<thrift::NextHopThrift>;
+
+  // next-hop group index of routes not to be programmed
+  static constexpr uint32_t kNoNextHops{std::numeric_limits<uint32_t>::max()};
+
+  /**
+   * Add attributes shared by routes and return their index. `prefix` of
+   * `attributes` is ignored, it's set per route.
+   */
+  uint32_t
+  addAttributes(thrift::PrefixEntry attributes) {
+    attributes_.emplace_back(std::move(attributes));
+    return attributes_.size() - 1;
+  }
+
+  /**
+   * Add next-hops to program for routes and return their index. Empty set
+   * programs a NULL route.
+   */
+  uint32_t
+  addNextHopGroup(NextHopSet nexthops) {
+    nextHopGroups_.emplace_back(std::move(nexthops));
+    return nextHopGroups_.size() - 1;
+  }
+
+  void
+  addRoute(
+      folly::CIDRNetwork const& network,
+      uint32_t attributesIndex,
+      uint32_t nextHopGroupIndex = kNoNextHops) {
+    CHECK_LT(attributesIndex, attributes_.size());
+    CHECK(
+        nextHopGroupIndex == kNoNextHops or
+        nextHopGroupIndex < nextHopGroups_.size());
+    networks_.emplace_back(network);
+    attributeIndices_.emplace_back(attributesIndex);
+    nextHopGroupIndices_.emplace_back(nextHopGroupIndex);
+  }
+
+  void
+  reserve(size_t numRoutes) {
+    networks_.reserve(numRoutes);
+    attributeIndices_.reserve(numRoutes);
+    nextHopGroupIndices_.reserve(numRoutes);
+  }
+
+  size_t
+  size() const {
+    return networks_.size();
+  }
+
+  bool
+  empty() const {
+    return networks_.empty();
+  }
+
+  folly::CIDRNetwork const&
+  getNetwork(size_t i) const {
+    return networks_.at(i);
+  }
+
+  thrift::PrefixEntry const&
+  getAttributes(size_t i) const {
+    return attributes_.at(attributeIndices_.at(i));
+  }
+
+  // next-hops to program for route, nullptr if it isn't programmed
+  NextHopSet const*
+  getNextHops(size_t i) const {
+    const auto index = nextHopGroupIndices_.at(i);
+    return index == kNoNextHops ? nullptr : &nextHopGroups_.at(index);
+  }
+
+ private:
+  // shared by routes
+  std::vector<thrift::PrefixEntry> attributes_;
+  std::vector<NextHopSet> nextHopGroups_;
+
+  // per route
+  std::vector<folly::CIDRNetwork> networks_;
+  std::vector<uint32_t> attributeIndices_;
+  std::vector<uint32_t> nextHopGroupIndices_;
+};
+
+} // namespace openr
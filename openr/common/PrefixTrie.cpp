@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <array>
+
+#include <openr/common/PrefixTrie.h>
+
+namespace openr {
+
+namespace {
+
+// leading `len` bits of an address, v4 addresses take the upper 32 bits
+struct Bits {
+  uint64_t hi{0};
+  uint64_t lo{0};
+  uint8_t len{0};
+
+  bool
+  bit(uint8_t idx) const {
+    return idx < 64 ? (hi >> (63 - idx)) & 1 : (lo >> (127 - idx)) & 1;
+  }
+
+  bool
+  operator==(Bits const& other) const {
+    return hi == other.hi and lo == other.lo and len == other.len;
+  }
+};
+
+Bits
+truncate(Bits bits, uint8_t len) {
+  if (len == 0) {
+    bits.hi = 0;
+    bits.lo = 0;
+  } else if (len < 64) {
+    bits.hi &= ~0ULL << (64 - len);
+    bits.lo = 0;
+  } else if (len < 128) {
+    bits.lo &= ~0ULL << (128 - len);
+  }
+  bits.len = len;
+  return bits;
+}
+
+Bits
+toBits(folly::CIDRNetwork const& prefix) {
+  Bits bits;
+  auto const& addr = prefix.first;
+  if (addr.isV4()) {
+    bits.hi = static_cast<uint64_t>(addr.asV4().toLongHBO()) << 32;
+  } else {
+    auto const bytes = addr.asV6().toByteArray();
+    for (size_t i = 0; i < 8; ++i) {
+      bits.hi = (bits.hi << 8) | bytes[i];
+      bits.lo = (bits.lo << 8) | bytes[i + 8];
+    }
+  }
+  return truncate(
+      bits,
+      static_cast<uint8_t>(
+          std::min<size_t>(prefix.second, addr.bitCount())));
+}
+
+// length of common leading bits, capped by both lengths
+uint8_t
+commonPrefixLen(Bits const& a, Bits const& b) {
+  const auto hiDiff = a.hi ^ b.hi;
+  const auto loDiff = a.lo ^ b.lo;
+  uint8_t len = 128;
+  if (hiDiff) {
+    len = __builtin_clzll(hiDiff);
+  } else if (loDiff) {
+    len = 64 + __builtin_clzll(loDiff);
+  }
+  return std::min({len, a.len, b.len});
+}
+
+} // namespace
+
+struct PrefixTrie::Node {
+  explicit Node(Bits bits) : bits(bits) {}
+
+  Node(Node const& other) : bits(other.bits), prefix(other.prefix) {
+    for (size_t i = 0; i < children.size(); ++i) {
+      if (other.children[i]) {
+        children[i] = std::make_unique<Node>(*other.children[i]);
+      }
+    }
+  }
+
+  size_t
+  numChildren() const {
+    return (children[0] ? 1 : 0) + (children[1] ? 1 : 0);
+  }
+
+  // key bits shared by all prefixes below this node
+  Bits bits;
+  // set if the prefix of this node is in the trie, not only a branch point
+  std::optional<folly::CIDRNetwork> prefix;
+  std::array<std::unique_ptr<Node>, 2> children;
+};
+
+PrefixTrie::PrefixTrie() = default;
+PrefixTrie::~PrefixTrie() = default;
+PrefixTrie::PrefixTrie(PrefixTrie&&) noexcept = default;
+PrefixTrie& PrefixTrie::operator=(PrefixTrie&&) noexcept = default;
+
+PrefixTrie::PrefixTrie(PrefixTrie const& other) : size_(other.size_) {
+  if (other.v4Root_) {
+    v4Root_ = std::make_unique<Node>(*other.v4Root_);
+  }
+  if (other.v6Root_) {
+    v6Root_ = std::make_unique<Node>(*other.v6Root_);
+  }
+}
+
+PrefixTrie&
+PrefixTrie::operator=(PrefixTrie const& other) {
+  if (this != &other) {
+    *this = PrefixTrie(other);
+  }
+  return *this;
+}
+
+std::unique_ptr<PrefixTrie::Node>&
+PrefixTrie::getRoot(folly::IPAddress const& addr) {
+  return addr.isV4() ? v4Root_ : v6Root_;
+}
+
+PrefixTrie::Node const*
+PrefixTrie::getRoot(folly::IPAddress const& addr) const {
+  return addr.isV4() ? v4Root_.get() : v6Root_.get();
+}
+
+bool
+PrefixTrie::insert(folly::CIDRNetwork const& prefix) {
+  const auto bits = toBits(prefix);
+  auto* link = &getRoot(prefix.first);
+  while (true) {
+    auto* node = link->get();
+    if (not node) {
+      *link = std::make_unique<Node>(bits);
+      (*link)->prefix = prefix;
+      ++size_;
+      return true;
+    }
+
+    const auto len = commonPrefixLen(node->bits, bits);
+    if (len < node->bits.len) {
+      // diverges within this node, branch out at the common bits
+      auto branch = std::make_unique<Node>(truncate(bits, len));
+      const auto nodeBit = node->bits.bit(len);
+      branch->children[nodeBit] = std::move(*link);
+      if (len == bits.len) {
+        branch->prefix = prefix;
+      } else {
+        auto leaf = std::make_unique<Node>(bits);
+        leaf->prefix = prefix;
+        branch->children[not nodeBit] = std::move(leaf);
+      }
+      *link = std::move(branch);
+      ++size_;
+      return true;
+    }
+
+    if (node->bits.len == bits.len) {
+      if (node->prefix) {
+        return false;
+      }
+      node->prefix = prefix;
+      ++size_;
+      return true;
+    }
+    link = &node->children[bits.bit(node->bits.len)];
+  }
+}
+
+bool
+PrefixTrie::erase(folly::CIDRNetwork const& prefix) {
+  const auto bits = toBits(prefix);
+  std::unique_ptr<Node>* parentLink{nullptr};
+  auto* link = &getRoot(prefix.first);
+  while (*link and (*link)->bits.len < bits.len and
+         commonPrefixLen((*link)->bits, bits) == (*link)->bits.len) {
+    parentLink = link;
+    link = &(*link)->children[bits.bit((*link)->bits.len)];
+  }
+  if (not *link or not((*link)->bits == bits) or not(*link)->prefix) {
+    return false;
+  }
+
+  (*link)->prefix.reset();
+  --size_;
+
+  // drop branch points left behind with less than two children. Only the
+  // erased node and its parent may become one.
+  auto compact = [](std::unique_ptr<Node>& nodeLink) {
+    auto& node = *nodeLink;
+    if (node.prefix or node.numChildren() > 1) {
+      return;
+    }
+    auto child = std::move(node.children[0] ? node.children[0]
+                                            : node.children[1]);
+    nodeLink = std::move(child);
+  };
+  compact(*link);
+  if (parentLink) {
+    compact(*parentLink);
+  }
+  return true;
+}
+
+bool
+PrefixTrie::contains(folly::CIDRNetwork const& prefix) const {
+  const auto bits = toBits(prefix);
+  auto const* node = getRoot(prefix.first);
+  while (node and node->bits.len < bits.len and
+         commonPrefixLen(node->bits, bits) == node->bits.len) {
+    node = node->children[bits.bit(node->bits.len)].get();
+  }
+  return node and node->bits == bits and node->prefix.has_value();
+}
+
+void
+PrefixTrie::clear() {
+  v4Root_.reset();
+  v6Root_.reset();
+  size_ = 0;
+}
+
+std::optional<folly::CIDRNetwork>
+PrefixTrie::longestPrefixMatch(folly::CIDRNetwork const& prefix) const {
+  const auto bits = toBits(prefix);
+  std::optional<folly::CIDRNetwork> match;
+  auto const* node = getRoot(prefix.first);
+  while (node and commonPrefixLen(node->bits, bits) == node->bits.len) {
+    if (node->prefix) {
+      match = node->prefix;
+    }
+    if (node->bits.len == bits.len) {
+      break;
+    }
+    node = node->children[bits.bit(node->bits.len)].get();
+  }
+  return match;
+}
+
+std::vector<folly::CIDRNetwork>
+PrefixTrie::getSuperPrefixes(folly::CIDRNetwork const& prefix) const {
+  const auto bits = toBits(prefix);
+  std::vector<folly::CIDRNetwork> superPrefixes;
+  auto const* node = getRoot(prefix.first);
+  while (node and commonPrefixLen(node->bits, bits) == node->bits.len) {
+    if (node->prefix) {
+      superPrefixes.emplace_back(*node->prefix);
+    }
+    if (node->bits.len == bits.len) {
+      break;
+    }
+    node = node->children[bits.bit(node->bits.len)].get();
+  }
+  return superPrefixes;
+}
+
+std::vector<folly::CIDRNetwork>
+PrefixTrie::getSubPrefixes(folly::CIDRNetwork const& prefix) const {
+  const auto bits = toBits(prefix);
+  auto const* node = getRoot(prefix.first);
+  // first node at or below prefix length
+  while (node and node->bits.len < bits.len and
+         commonPrefixLen(node->bits, bits) == node->bits.len) {
+    node = node->children[bits.bit(node->bits.len)].get();
+  }
+
+  std::vector<folly::CIDRNetwork> subPrefixes;
+  if (not node or commonPrefixLen(node->bits, bits) < bits.len) {
+    return subPrefixes;
+  }
+  std::vector<Node const*> stack{node};
+  while (not stack.empty()) {
+    auto const* curr = stack.back();
+    stack.pop_back();
+    if (curr->prefix) {
+      subPrefixes.emplace_back(*curr->prefix);
+    }
+    for (auto const& child : curr->children) {
+      if (child) {
+        stack.emplace_back(child.get());
+      }
+    }
+  }
+  return subPrefixes;
+}
+
+} // namespace openr
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <folly/IPAddress.h>
+
+namespace openr {
+
+/**
+ * Set of IP prefixes kept in a path-compressed binary trie, one per address
+ * family. Meant to be maintained alongside a hash map of routes keyed by
+ * prefix to answer longest prefix match and sub-prefix (range) queries in
+ * O(prefix-length) instead of scanning every route.
+ *
+ * Prefixes are expected in canonical form, i.e. host bits of the address
+ * cleared, as done for all routes in Open/R.
+ */
+class PrefixTrie {
+ public:
+  PrefixTrie();
+  ~PrefixTrie();
+
+  PrefixTrie(PrefixTrie&&) noexcept;
+  PrefixTrie& operator=(PrefixTrie&&) noexcept;
+
+  PrefixTrie(PrefixTrie const& other);
+  PrefixTrie& operator=(PrefixTrie const& other);
+
+  // return true if prefix was not in the trie
+  bool insert(folly::CIDRNetwork const& prefix);
+
+  // return true if prefix was in the trie
+  bool erase(folly::CIDRNetwork const& prefix);
+
+  bool contains(folly::CIDRNetwork const& prefix) const;
+
+  void clear();
+
+  size_t
+  size() const {
+    return size_;
+  }
+
+  bool
+  empty() const {
+    return size_ == 0;
+  }
+
+  /**
+   * Longest prefix in the trie covering `prefix`, i.e. of the same family,
+   * length not above and matching on its own length. Addresses are looked up
+   * as host prefixes, e.g. 10.0.0.1/32.
+   */
+  std::optional<folly::CIDRNetwork> longestPrefixMatch(
+      folly::CIDRNetwork const& prefix) const;
+
+  /**
+   * All prefixes in the trie covering `prefix`, including itself, from the
+   * shortest to the longest one
+   */
+  std::vector<folly::CIDRNetwork> getSuperPrefixes(
+      folly::CIDRNetwork const& prefix) const;
+
+  /**
+   * All prefixes in the trie covered by `prefix`, including itself
+   */
+  std::vector<folly::CIDRNetwork> getSubPrefixes(
+      folly::CIDRNetwork const& prefix) const;
+
+ private:
+  struct Node;
+
+  std::unique_ptr<Node>& getRoot(folly::IPAddress const& addr);
+  Node const* getRoot(folly::IPAddress const& addr) const;
+
+  std::unique_ptr<Node> v4Root_;
+  std::unique_ptr<Node> v6Root_;
+  size_t size_{0};
+};
+
+} // namespace openr
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <openr/common/SharedExecutor.h>
+
+#include <algorithm>
+#include <thread>
+
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+#include <folly/futures/Future.h>
+
+namespace openr {
+
+folly::CPUThreadPoolExecutor&
+SharedExecutor::get() {
+  // Leaked on purpose, modules may still hold strands at static destruction
+  static auto* executor = new folly::CPUThreadPoolExecutor(
+      std::make_pair(
+          std::max(1u, std::thread::hardware_concurrency()) /* max */,
+          1 /* min */),
+      std::make_shared<folly::NamedThreadFactory>("OpenrShared"));
+  return *executor;
+}
+
+SharedExecutor::Strand
+SharedExecutor::makeStrand() {
+  return folly::SerialExecutor::create(folly::getKeepAliveToken(get()));
+}
+
+void
+SharedExecutor::drain(Strand const& strand) {
+  folly::via(strand.copy(), []() {}).wait();
+}
+
+} // namespace openr
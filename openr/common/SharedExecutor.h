@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/SerialExecutor.h>
+
+namespace openr {
+
+/**
+ * Process wide CPU thread pool shared by modules for work off their
+ * event-base thread, instead of every module keeping dedicated threads which
+ * are idle most of the time. Pool grows up to one thread per core on demand
+ * and shrinks back once idle.
+ *
+ * Modules get serialization of their work, as on a dedicated thread, from a
+ * strand: tasks added to it run one at a time, in the order they are added,
+ * on any thread of the pool. Thread-safe.
+ */
+class SharedExecutor {
+ public:
+  using Strand = folly::Executor::KeepAlive<folly::SerialExecutor>;
+
+  // Shared pool, created on first use and never destroyed
+  static folly::CPUThreadPoolExecutor& get();
+
+  // New strand on the shared pool
+  static Strand makeStrand();
+
+  // Block until tasks added to `strand` so far have run
+  static void drain(Strand const& strand);
+};
+
+} // namespace openr
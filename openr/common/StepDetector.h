@@ -7,11 +7,13 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 #include <functional>
+#include <optional>
 #include <stdexcept>
+#include <vector>
 
-#include <folly/stats/BucketedTimeSeries.h>
 #include <openr/config/Config.h>
 #include <openr/if/gen-cpp2/OpenrConfig_types.h>
 
@@ -34,6 +36,11 @@ namespace openr {
  * to catch this case.
  * Notes: we assume the underlying time series is stable for longer than slow
  * sliding window between steps.
+ *
+ * Both windows are kept in one ring of per-sample-period buckets, as the fast
+ * window is the most recent part of the slow one. Sum and count of each window
+ * are maintained as buckets enter and leave it, hence adding a value and
+ * getting averages take constant time for regularly sampled time series.
  */
 template <typename ValueType, typename TimeType>
 class StepDetector {
@@ -50,24 +57,24 @@ class StepDetector {
         loThreshold_(*stepConfig.lower_threshold_ref()),
         hiThreshold_(*stepConfig.upper_threshold_ref()),
         absThreshold_(*stepConfig.ads_threshold_ref()),
-        fastSlideWindow_(fastWndSize_, samplePeriod * fastWndSize_),
-        slowSlideWindow_(slowWndSize_, samplePeriod * slowWndSize_),
+        samplePeriod_(samplePeriod),
+        buckets_(slowWndSize_),
         stepCb_(std::move(stepCb)) {
     CHECK_LT(loThreshold_, hiThreshold_);
     CHECK_LT(fastWndSize_, slowWndSize_);
+    CHECK_GT(samplePeriod_.count(), 0);
   }
 
   // add the value 'val' at time 'now' to both fast and slow sliding window
   bool
   addValue(TimeType now, const ValueType& val) {
-    bool fastSuccess = fastSlideWindow_.addValue(now, val);
-    bool slowSuccess = slowSlideWindow_.addValue(now, val);
+    const bool success = addToWindows(now, val);
 
-    auto fastAvg = fastSlideWindow_.avg();
-    auto slowAvg = slowSlideWindow_.avg();
+    const double fastAvg = fast_.avg();
+    const double slowAvg = slow_.avg();
 
     // init last average if not initialized and we gather enough samples
-    if (!lastAvgInit_ && slowSlideWindow_.count() >= slowWndSize_ / 2) {
+    if (!lastAvgInit_ && slow_.count >= slowWndSize_ / 2) {
       lastAvg_ = slowAvg;
       lastAvgInit_ = true;
     }
@@ -92,7 +99,7 @@ class StepDetector {
         stepCb_(fastAvg);
         lastAvg_ = fastAvg;
         lastAvgInit_ = true;
-        return fastSuccess && slowSuccess;
+        return success;
       }
     } else {
       if (diff >= hiThreshold_) {
@@ -112,10 +119,80 @@ class StepDetector {
       lastAvg_ = slowAvg;
     }
 
-    return fastSuccess && slowSuccess;
+    return success;
   }
 
  private:
+  // sum and count of values in a bucket or a window
+  struct Sum {
+    ValueType sum{0};
+    uint64_t count{0};
+
+    void
+    add(const Sum& other) {
+      sum += other.sum;
+      count += other.count;
+    }
+
+    void
+    remove(const Sum& other) {
+      sum -= other.sum;
+      count -= other.count;
+      if (count == 0) {
+        sum = 0; // don't carry rounding errors of floating point sums
+      }
+    }
+
+    double
+    avg() const {
+      return count ? sum / static_cast<double>(count) : 0;
+    }
+  };
+
+  Sum&
+  getBucket(uint64_t bucketIdx) {
+    return buckets_[bucketIdx % slowWndSize_];
+  }
+
+  // Add value to bucket of sample period of 'now', after sliding windows up
+  // to it. Returns false if 'now' is older than slow window.
+  bool
+  addToWindows(TimeType now, const ValueType& val) {
+    const uint64_t bucketIdx = now.count() / samplePeriod_.count();
+    if (not latestBucketIdx_.has_value()) {
+      latestBucketIdx_ = bucketIdx;
+    } else if (bucketIdx > *latestBucketIdx_) {
+      if (bucketIdx - *latestBucketIdx_ >= slowWndSize_) {
+        // every bucket slides out of windows
+        std::fill(buckets_.begin(), buckets_.end(), Sum{});
+        fast_ = Sum{};
+        slow_ = Sum{};
+      } else {
+        for (auto idx = *latestBucketIdx_ + 1; idx <= bucketIdx; ++idx) {
+          // oldest bucket of fast window slides out of it, and the one of
+          // slow window shares its slot with the new bucket
+          if (idx >= fastWndSize_) {
+            fast_.remove(getBucket(idx - fastWndSize_));
+          }
+          auto& bucket = getBucket(idx);
+          slow_.remove(bucket);
+          bucket = Sum{};
+        }
+      }
+      latestBucketIdx_ = bucketIdx;
+    } else if (*latestBucketIdx_ - bucketIdx >= slowWndSize_) {
+      return false;
+    }
+
+    const Sum sample{val, 1};
+    getBucket(bucketIdx).add(sample);
+    slow_.add(sample);
+    if (*latestBucketIdx_ - bucketIdx < fastWndSize_) {
+      fast_.add(sample);
+    }
+    return true;
+  }
+
   // StepDetector is non-copyable
   StepDetector(StepDetector const&) = delete;
   StepDetector& operator=(StepDetector const&) = delete;
@@ -135,13 +212,19 @@ class StepDetector {
   // absolute step threshold to detect gradual change
   const ValueType absThreshold_{0};
 
-  // fast sliding window
-  folly::BucketedTimeSeries<ValueType, folly::LegacyStatsClock<TimeType>>
-      fastSlideWindow_;
+  // interval time series is sampled, i.e. width of a bucket
+  const TimeType samplePeriod_{0};
 
-  // slow sliding window size
-  folly::BucketedTimeSeries<ValueType, folly::LegacyStatsClock<TimeType>>
-      slowSlideWindow_;
+  // ring of buckets of slow window, indexed by sample period of their values.
+  // Fast window is made of its most recent `fastWndSize_` buckets.
+  std::vector<Sum> buckets_;
+
+  // index of most recent bucket, unset until first value
+  std::optional<uint64_t> latestBucketIdx_;
+
+  // running sum of fast and slow window
+  Sum fast_;
+  Sum slow_;
 
   // callback when step is detected
   const std::function<void(const ValueType&)> stepCb_{nullptr};
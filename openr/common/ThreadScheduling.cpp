@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <openr/common/ThreadScheduling.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include <fb303/ServiceData.h>
+#include <fmt/format.h>
+#include <folly/Conv.h>
+#include <folly/FileUtil.h>
+#include <folly/String.h>
+#include <glog/logging.h>
+
+namespace fb303 = facebook::fb303;
+
+namespace openr {
+
+bool
+ThreadScheduling::apply(
+    std::string const& name, thrift::ThreadSchedulingConfig const& config) {
+  bool success{true};
+  auto fail = [&](std::string const& error) {
+    LOG(ERROR) << "[Thread Scheduling] Failed to " << error << " of " << name
+               << " thread";
+    fb303::fbData->addStatValue("thread_scheduling.failures", 1, fb303::COUNT);
+    success = false;
+  };
+
+  std::vector<int> cpus(config.cpus_ref()->begin(), config.cpus_ref()->end());
+  if (auto node = config.numa_node_ref()) {
+    auto nodeCpus = getNumaNodeCpus(*node);
+    if (not nodeCpus.has_value()) {
+      fail(fmt::format("read CPUs of NUMA node {}", *node));
+    } else if (cpus.empty()) {
+      cpus = std::move(*nodeCpus);
+    } else {
+      cpus.erase(
+          std::remove_if(
+              cpus.begin(),
+              cpus.end(),
+              [&nodeCpus](int cpu) {
+                return std::find(nodeCpus->begin(), nodeCpus->end(), cpu) ==
+                    nodeCpus->end();
+              }),
+          cpus.end());
+      if (cpus.empty()) {
+        fail(fmt::format("pick configured CPUs on NUMA node {}", *node));
+      }
+    }
+  }
+
+  if (not cpus.empty()) {
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (auto cpu : cpus) {
+      if (cpu >= 0 and cpu < CPU_SETSIZE) {
+        CPU_SET(cpu, &cpuSet);
+      }
+    }
+    const auto ret =
+        pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+    if (ret != 0) {
+      fail(fmt::format(
+          "set CPU affinity to [{}] ({})",
+          folly::join(",", cpus),
+          folly::errnoStr(ret)));
+    }
+  }
+
+  if (auto priority = config.fifo_priority_ref()) {
+    sched_param param{};
+    param.sched_priority = *priority;
+    const auto ret = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (ret != 0) {
+      fail(fmt::format(
+          "set SCHED_FIFO priority {} ({})", *priority, folly::errnoStr(ret)));
+    }
+  } else if (auto nice = config.nice_ref()) {
+    // nice value is per thread on Linux, set by thread id
+    if (setpriority(PRIO_PROCESS, syscall(SYS_gettid), *nice) != 0) {
+      fail(fmt::format("set nice {} ({})", *nice, folly::errnoStr(errno)));
+    }
+  }
+
+  if (success) {
+    LOG(INFO) << "[Thread Scheduling] Applied to " << name << " thread, CPUs: ["
+              << folly::join(",", cpus) << "]";
+  }
+  return success;
+}
+
+std::optional<std::vector<int>>
+ThreadScheduling::getNumaNodeCpus(int node) {
+  std::string cpuList;
+  if (not folly::readFile(
+          fmt::format("/sys/devices/system/node/node{}/cpulist", node).c_str(),
+          cpuList)) {
+    return std::nullopt;
+  }
+  return parseCpuList(folly::rtrimWhitespace(cpuList).str());
+}
+
+std::optional<std::vector<int>>
+ThreadScheduling::parseCpuList(std::string const& str) {
+  std::vector<int> cpus;
+  if (str.empty()) {
+    return cpus;
+  }
+  std::vector<folly::StringPiece> ranges;
+  folly::split(',', str, ranges);
+  for (auto const& range : ranges) {
+    folly::StringPiece first, last;
+    if (not folly::split('-', range, first, last)) {
+      first = last = range;
+    }
+    auto begin = folly::tryTo<int>(first);
+    auto end = folly::tryTo<int>(last);
+    if (begin.hasError() or end.hasError() or *begin < 0 or *begin > *end) {
+      return std::nullopt;
+    }
+    for (int cpu = *begin; cpu <= *end; ++cpu) {
+      cpus.emplace_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+} // namespace openr
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <openr/if/gen-cpp2/OpenrConfig_types.h>
+
+namespace openr {
+
+/**
+ * CPU placement and scheduling of module threads as per
+ * `thrift::ThreadSchedulingConfig`, i.e. CPU affinity, NUMA node, nice value
+ * or SCHED_FIFO priority.
+ */
+class ThreadScheduling {
+ public:
+  // Apply config to the calling thread. Every setting is attempted even if
+  // an earlier one fails. Failures are logged along with `name` of the thread
+  // and reported by returning false.
+  static bool apply(
+      std::string const& name, thrift::ThreadSchedulingConfig const& config);
+
+  // CPUs of NUMA node as listed by sysfs, std::nullopt if unknown
+  static std::optional<std::vector<int>> getNumaNodeCpus(int node);
+
+  // Parse CPU list of kernel format, e.g. "0-3,8,10-11". std::nullopt if
+  // malformed
+  static std::optional<std::vector<int>> parseCpuList(std::string const& str);
+};
+
+} // namespace openr
@@ -5,6 +5,12 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstring>
+#include <string_view>
+
 #include <fmt/core.h>
 #include <openr/common/Types.h>
 
@@ -12,43 +18,356 @@
 
 namespace openr {
 
-RegexSet::RegexSet(std::vector<std::string> const& keyPrefixList) {
-  if (keyPrefixList.empty()) {
+namespace {
+
+// Fields of prefix key string, see PrefixKey::getPrefixRE2{,V2}() and
+// PrefixKey::getPrefixKeyCompact()
+struct PrefixKeyFields {
+  folly::StringPiece node;
+  // empty for v2 and compact format
+  folly::StringPiece area;
+  folly::CIDRNetwork network;
+  bool isCompact{false};
+};
+
+// Leading character of encoded prefix in compact format of prefix key
+constexpr char kCompactPrefixMarker{'~'};
+
+constexpr folly::StringPiece kBase64UrlChars{
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"};
+
+// base64url encoding (RFC 4648) without padding
+std::string
+base64UrlEncode(folly::ByteRange bytes) {
+  std::string out;
+  out.reserve((bytes.size() * 4 + 2) / 3);
+  uint32_t acc{0};
+  int bits{0};
+  for (auto byte : bytes) {
+    acc = (acc << 8) | byte;
+    bits += 8;
+    while (bits >= 6) {
+      bits -= 6;
+      out.push_back(kBase64UrlChars[(acc >> bits) & 0x3f]);
+    }
+  }
+  if (bits > 0) {
+    out.push_back(kBase64UrlChars[(acc << (6 - bits)) & 0x3f]);
+  }
+  return out;
+}
+
+// Decode base64url string without padding. Only canonical encoding, i.e. with
+// zero trailing bits, is accepted so that every prefix has a single key.
+std::optional<std::string>
+base64UrlDecode(folly::StringPiece str) {
+  std::string out;
+  out.reserve(str.size() * 3 / 4);
+  uint32_t acc{0};
+  int bits{0};
+  for (char c : str) {
+    const auto pos = kBase64UrlChars.find(c);
+    if (pos == folly::StringPiece::npos) {
+      return std::nullopt;
+    }
+    acc = (acc << 6) | pos;
+    bits += 6;
+    if (bits >= 8) {
+      bits -= 8;
+      out.push_back(static_cast<char>((acc >> bits) & 0xff));
+    }
+  }
+  if (bits >= 6 or (acc & ((1u << bits) - 1))) {
+    return std::nullopt;
+  }
+  return out;
+}
+
+// Encode network as [family, plen, bytes covered by plen]
+std::string
+encodeCompactPrefix(folly::CIDRNetwork const& network) {
+  const auto masked = network.first.mask(network.second);
+  std::string payload;
+  payload.push_back(masked.isV4() ? 4 : 6);
+  payload.push_back(static_cast<char>(network.second));
+  payload.append(
+      reinterpret_cast<const char*>(masked.bytes()), (network.second + 7) / 8);
+  return base64UrlEncode(folly::StringPiece(payload));
+}
+
+std::optional<folly::CIDRNetwork>
+decodeCompactPrefix(folly::StringPiece encoded) {
+  auto payload = base64UrlDecode(encoded);
+  if (not payload or payload->size() < 2) {
+    return std::nullopt;
+  }
+  const uint8_t family = (*payload)[0];
+  const uint8_t plen = (*payload)[1];
+  if (family != 4 and family != 6) {
+    return std::nullopt;
+  }
+  const size_t addrLen = family == 4 ? 4 : 16;
+  if (plen > addrLen * 8 or payload->size() != 2 + (plen + 7) / 8) {
+    return std::nullopt;
+  }
+  // Bits beyond prefix length must be zero
+  if (plen % 8 and (payload->back() & (0xff >> (plen % 8)))) {
+    return std::nullopt;
+  }
+
+  std::array<uint8_t, 16> addr{};
+  std::copy(payload->begin() + 2, payload->end(), addr.begin());
+  const folly::ByteRange addrBytes(addr.data(), addrLen);
+  if (family == 4) {
+    return folly::CIDRNetwork(
+        folly::IPAddressV4::fromBinary(addrBytes), plen);
+  }
+  return folly::CIDRNetwork(folly::IPAddressV6::fromBinary(addrBytes), plen);
+}
+
+// [a-zA-Z0-9._-], allowed in node and area names
+bool
+isPrefixKeyNameChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) or c == '.' or
+      c == '-' or c == '_';
+}
+
+// [a-fA-F0-9.:], allowed in IP address
+bool
+isPrefixKeyAddrChar(char c) {
+  return std::isxdigit(static_cast<unsigned char>(c)) or c == '.' or
+      c == ':';
+}
+
+// Parse prefix key string of either format in single pass, without regex.
+// Returns std::nullopt unless key matches the format's regex and IP network
+// is valid, which leaves handling of malformed keys to the regex.
+std::optional<PrefixKeyFields>
+parsePrefixKeyFields(folly::StringPiece key) {
+  if (not key.removePrefix(Constants::kPrefixDbMarker)) {
+    return std::nullopt;
+  }
+  auto readName = [&key]() {
+    size_t len{0};
+    while (len < key.size() and isPrefixKeyNameChar(key[len])) {
+      ++len;
+    }
+    auto name = key.subpiece(0, len);
+    key.advance(len);
+    return name;
+  };
+
+  PrefixKeyFields fields;
+  fields.node = readName();
+  if (fields.node.empty() or not key.removePrefix(':')) {
+    return std::nullopt;
+  }
+  if (key.removePrefix(kCompactPrefixMarker)) {
+    auto network = decodeCompactPrefix(key);
+    if (not network) {
+      return std::nullopt;
+    }
+    fields.network = std::move(network).value();
+    fields.isCompact = true;
+    return fields;
+  }
+  if (not key.startsWith('[')) {
+    fields.area = readName();
+    if (fields.area.empty() or not key.removePrefix(':')) {
+      return std::nullopt;
+    }
+  }
+  if (not key.removePrefix('[') or not key.removeSuffix(']')) {
+    return std::nullopt;
+  }
+
+  // <addr>/<plen> remains
+  const auto slash = key.find('/');
+  if (slash == folly::StringPiece::npos or slash == 0 or
+      not std::all_of(
+          key.begin(), key.begin() + slash, isPrefixKeyAddrChar)) {
+    return std::nullopt;
+  }
+  const auto plen = key.subpiece(slash + 1);
+  if (plen.empty() or plen.size() > 3 or
+      not std::all_of(plen.begin(), plen.end(), [](char c) {
+        return std::isdigit(static_cast<unsigned char>(c));
+      })) {
+    return std::nullopt;
+  }
+  auto network = folly::IPAddress::tryCreateNetwork(key);
+  if (network.hasError()) {
+    return std::nullopt;
+  }
+  fields.network = std::move(network).value();
+  return fields;
+}
+
+// Literal matched by `pattern` and whether it is matched as prefix (else as
+// whole key), if pattern has no regex meta-character other than a leading
+// `^`, a trailing `$` or `.*`, and escaped punctuation. Literal is lowered
+// if not `caseSensitive`, and restricted to ASCII then.
+std::optional<std::pair<std::string, bool>>
+parseLiteralPattern(
+    std::string_view pattern, bool anchorEnd, bool caseSensitive) {
+  if (not pattern.empty() and pattern.front() == '^') {
+    pattern.remove_prefix(1);
+  }
+  bool isPrefix = not anchorEnd;
+  if (not pattern.empty() and pattern.back() == '$') {
+    pattern.remove_suffix(1);
+    isPrefix = false;
+  }
+  if (pattern.size() >= 2 and pattern.substr(pattern.size() - 2) == ".*") {
+    // `.*$` doesn't match newline, which only end anchored sets account for
+    if (not isPrefix and not anchorEnd) {
+      return std::nullopt;
+    }
+    pattern.remove_suffix(2);
+    isPrefix = true;
+  }
+
+  // an escaped trailing token, e.g. `\$`, leaves a dangling backslash here
+  std::string literal;
+  literal.reserve(pattern.size());
+  for (size_t i = 0; i < pattern.size(); ++i) {
+    unsigned char c = pattern[i];
+    if (c == '\\') {
+      if (++i == pattern.size()) {
+        return std::nullopt;
+      }
+      c = pattern[i];
+      if (not std::ispunct(c) or c == '_') {
+        return std::nullopt;
+      }
+    } else if (RegexSet::isMetaChar(c)) {
+      return std::nullopt;
+    }
+    if (not caseSensitive) {
+      if (c >= 0x80) {
+        return std::nullopt;
+      }
+      c = std::tolower(c);
+    }
+    literal.push_back(c);
+  }
+  return std::make_pair(std::move(literal), isPrefix);
+}
+
+} // namespace
+
+RegexSet::RegexSet(
+    std::vector<std::string> const& regexOrPrefixList,
+    bool anchorEnd,
+    bool caseSensitive)
+    : anchorEnd_(anchorEnd), caseSensitive_(caseSensitive) {
+  std::vector<std::string> regexList;
+  for (auto const& pattern : regexOrPrefixList) {
+    auto literal = parseLiteralPattern(pattern, anchorEnd, caseSensitive);
+    if (not literal.has_value()) {
+      regexList.emplace_back(pattern);
+    } else if (literal->second) {
+      literalPrefixes_.emplace_back(std::move(literal->first));
+    } else {
+      literalKeys_.emplace(std::move(literal->first));
+    }
+  }
+
+  // Sort and drop prefixes covered by a shorter one. Afterwards, the ONLY
+  // candidate prefix of a key is its predecessor in lexicographic order.
+  std::sort(literalPrefixes_.begin(), literalPrefixes_.end());
+  std::vector<std::string> prunedPrefixes;
+  for (auto& prefix : literalPrefixes_) {
+    if (not prunedPrefixes.empty()) {
+      auto const& shorter = prunedPrefixes.back();
+      if (prefix.compare(0, shorter.size(), shorter) == 0) {
+        continue;
+      }
+    }
+    prunedPrefixes.emplace_back(std::move(prefix));
+  }
+  literalPrefixes_ = std::move(prunedPrefixes);
+
+  if (regexList.empty()) {
     return;
   }
   re2::RE2::Options re2Options;
-  re2Options.set_case_sensitive(true);
-  regexSet_ =
-      std::make_unique<re2::RE2::Set>(re2Options, re2::RE2::ANCHOR_START);
+  re2Options.set_case_sensitive(caseSensitive);
+  regexSet_ = std::make_unique<re2::RE2::Set>(
+      re2Options, anchorEnd ? re2::RE2::ANCHOR_BOTH : re2::RE2::ANCHOR_START);
   std::string re2AddError{};
 
-  for (auto const& keyPrefix : keyPrefixList) {
-    if (regexSet_->Add(keyPrefix, &re2AddError) < 0) {
-      LOG(FATAL) << "Failed to add prefixes to RE2 set: '" << keyPrefix << "', "
-                 << "error: '" << re2AddError << "'";
-      return;
+  for (auto const& regex : regexList) {
+    if (regexSet_->Add(regex, &re2AddError) < 0) {
+      throw std::invalid_argument(fmt::format(
+          "Failed to add regex: {}. Error: {}", regex, re2AddError));
     }
   }
   if (!regexSet_->Compile()) {
-    LOG(FATAL) << "Failed to compile re2 set";
+    throw std::invalid_argument("Failed to compile RE2 set");
   }
 }
 
+bool
+RegexSet::isMetaChar(char c) {
+  return std::strchr("\\^$.|?*+()[]{}", c) != nullptr and c != '\0';
+}
+
+bool
+RegexSet::isLiteralPrefix(std::string const& pattern) {
+  return std::none_of(pattern.begin(), pattern.end(), isMetaChar);
+}
+
+bool
+RegexSet::matchLiteral(std::string const& key) const {
+  if (literalKeys_.count(key)) {
+    return true;
+  }
+  // with end anchor, prefixes stem from `.*` which doesn't match newline
+  if (literalPrefixes_.empty() or
+      (anchorEnd_ and key.find('\n') != std::string::npos)) {
+    return false;
+  }
+  auto it =
+      std::upper_bound(literalPrefixes_.begin(), literalPrefixes_.end(), key);
+  if (it != literalPrefixes_.begin()) {
+    --it;
+    if (key.compare(0, it->size(), *it) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool
 RegexSet::match(std::string const& key) const {
-  CHECK(regexSet_);
-  std::vector<int> matches;
-  return regexSet_->Match(key, &matches);
+  if (caseSensitive_) {
+    if (matchLiteral(key)) {
+      return true;
+    }
+  } else if (not literalKeys_.empty() or not literalPrefixes_.empty()) {
+    std::string lowerKey(key);
+    std::transform(
+        lowerKey.begin(), lowerKey.end(), lowerKey.begin(), [](char c) {
+          return static_cast<unsigned char>(c) < 0x80 ? std::tolower(c) : c;
+        });
+    if (matchLiteral(lowerKey)) {
+      return true;
+    }
+  }
+  return regexSet_ and regexSet_->Match(key, nullptr);
 }
 
 PrefixKey::PrefixKey(
     std::string const& node,
     folly::CIDRNetwork const& prefix,
     const std::string& area,
-    bool isPrefixKeyV2)
+    bool isPrefixKeyV2,
+    bool isPrefixKeyCompact)
     : nodeAndArea_(node, area),
       prefix_(prefix),
       isPrefixKeyV2_(isPrefixKeyV2),
+      isPrefixKeyCompact_(isPrefixKeyCompact),
       prefixKeyString_(fmt::format(
           "{}{}:{}:[{}/{}]",
           Constants::kPrefixDbMarker.toString(),
@@ -63,8 +382,28 @@ PrefixKey::PrefixKey(
           prefix_.first.str(),
           prefix_.second)) {}
 
+std::string
+PrefixKey::getPrefixKeyCompact() const {
+  return fmt::format(
+      "{}{}:{}{}",
+      Constants::kPrefixDbMarker.toString(),
+      nodeAndArea_.first,
+      kCompactPrefixMarker,
+      encodeCompactPrefix(prefix_));
+}
+
+bool
+PrefixKey::isPrefixKeyCompactStr(const std::string& key) {
+  auto fields = parsePrefixKeyFields(key);
+  return fields.has_value() and fields->isCompact;
+}
+
 bool
 PrefixKey::isPrefixKeyV2Str(const std::string& key) {
+  if (auto fields = parsePrefixKeyFields(key)) {
+    return fields->area.empty() and not fields->isCompact;
+  }
+
   int64_t plen{0};
   std::string node{};
   std::string ipStr{};
@@ -79,6 +418,17 @@ PrefixKey::isPrefixKeyV2Str(const std::string& key) {
 
 folly::Expected<PrefixKey, std::string>
 PrefixKey::fromStr(const std::string& key, const std::string& areaIn) {
+  // fast path for well-formed keys
+  if (auto fields = parsePrefixKeyFields(key)) {
+    const bool isV2 = fields->area.empty() and not fields->isCompact;
+    return PrefixKey(
+        fields->node.str(),
+        fields->network,
+        fields->area.empty() ? areaIn : fields->area.str(), /* v2/compact */
+        isV2,
+        fields->isCompact);
+  }
+
   bool isV2PrefixKey{false};
   int plen{0};
   std::string area{};
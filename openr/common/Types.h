@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -17,11 +19,13 @@
 #include <fmt/core.h>
 #include <folly/Expected.h>
 #include <folly/IPAddress.h>
+#include <folly/container/F14Set.h>
 #include <re2/re2.h>
 #include <re2/set.h>
 
 #include <openr/common/Constants.h>
 #include <openr/common/NetworkUtil.h>
+#include <openr/common/PrefixBatch.h>
 #include <openr/if/gen-cpp2/Network_types.h>
 #include <openr/if/gen-cpp2/Types_constants.h>
 #include <openr/if/gen-cpp2/Types_types.h>
@@ -218,6 +222,12 @@ struct PrefixEvent {
    */
   std::vector<PrefixEntry> prefixEntries{};
 
+  /**
+   * Bulk routes to advertise or withdraw, e.g. full table of an in-process
+   * plugin. Shared as const, hence not copied by the replicate queue.
+   */
+  std::shared_ptr<const PrefixBatch> prefixBatch{nullptr};
+
   /**
    * Destination areas to inject prefixes to
    * ATTN: empty list = inject to all configured areas
@@ -424,8 +434,68 @@ class ClearKeyValueRequest {
   bool setValue{false};
 };
 
-using KeyValueRequest = std::
-    variant<SetKeyValueRequest, PersistKeyValueRequest, ClearKeyValueRequest>;
+/**
+ * Batch of persist and unset requests for keys of one area. Consumer processes
+ * the whole batch in one go, which amortizes the per-request overhead for bulk
+ * updates, e.g. advertisement of large number of prefixes.
+ */
+class BatchKeyValueRequest {
+ public:
+  explicit BatchKeyValueRequest(const AreaId& area) : area(area) {}
+
+  inline AreaId
+  getArea() const {
+    return area;
+  }
+
+  // Same semantics as PersistKeyValueRequest
+  void
+  persistKey(std::string key, std::string value) {
+    persistKeyVals.emplace_back(std::move(key), std::move(value));
+  }
+
+  // Same semantics as ClearKeyValueRequest with `setValue` flag set
+  void
+  unsetKey(std::string key, std::string value) {
+    CHECK(not value.empty()) << "Must specify value to unset key " << key;
+    unsetKeyVals.emplace_back(std::move(key), std::move(value));
+  }
+
+  inline const std::vector<std::pair<std::string, std::string>>&
+  getPersistKeyVals() const {
+    return persistKeyVals;
+  }
+
+  inline const std::vector<std::pair<std::string, std::string>>&
+  getUnsetKeyVals() const {
+    return unsetKeyVals;
+  }
+
+  inline size_t
+  size() const {
+    return persistKeyVals.size() + unsetKeyVals.size();
+  }
+
+ private:
+  /**
+   * Area identifier.
+   */
+  AreaId area;
+  /**
+   * Key-values to persist in the consumer.
+   */
+  std::vector<std::pair<std::string, std::string>> persistKeyVals;
+  /**
+   * Keys to clear from the consumer, and the new values to set to them.
+   */
+  std::vector<std::pair<std::string, std::string>> unsetKeyVals;
+};
+
+using KeyValueRequest = std::variant<
+    SetKeyValueRequest,
+    PersistKeyValueRequest,
+    ClearKeyValueRequest,
+    BatchKeyValueRequest>;
 /**
  * Structure to represent interface information from the system, including
  * link status/addresses/etc.
@@ -511,6 +581,58 @@ struct InterfaceInfo {
  */
 using InterfaceDatabase = std::vector<InterfaceInfo>;
 
+/**
+ * Interface update from LinkMonitor to Spark. Full snapshot is sent on startup
+ * and resync only, otherwise just the interfaces changed since last update, so
+ * that a single flap neither copies nor re-diffs all interfaces.
+ */
+struct InterfaceUpdate {
+  /**
+   * `interfaces` is full snapshot, i.e. any interface not in it is removed
+   */
+  bool isFullSync{true};
+
+  /**
+   * All interfaces if full sync, otherwise added or changed ones
+   */
+  InterfaceDatabase interfaces{};
+
+  /**
+   * Removed interfaces, if not full sync
+   */
+  std::vector<std::string> removedIfNames{};
+
+  InterfaceUpdate() = default;
+
+  /* implicit */ InterfaceUpdate(InterfaceDatabase ifDb)
+      : interfaces(std::move(ifDb)) {}
+
+  /**
+   * Apply update onto full snapshot `ifDb`
+   */
+  void
+  applyTo(InterfaceDatabase& ifDb) const {
+    if (isFullSync) {
+      ifDb = interfaces;
+      return;
+    }
+    std::unordered_set<std::string> changedIfNames(
+        removedIfNames.begin(), removedIfNames.end());
+    for (auto const& info : interfaces) {
+      changedIfNames.emplace(info.ifName);
+    }
+    ifDb.erase(
+        std::remove_if(
+            ifDb.begin(),
+            ifDb.end(),
+            [&](auto const& info) {
+              return changedIfNames.count(info.ifName) != 0;
+            }),
+        ifDb.end());
+    ifDb.insert(ifDb.end(), interfaces.begin(), interfaces.end());
+  }
+};
+
 /**
  * Structure defining KvStore peer sync event, published to subscribers.
  * LinkMonitor subscribes this event for signal adjancency UP event propagation
@@ -534,37 +656,104 @@ struct KvStoreSyncEvent {
  * NOTE: kvStoreSynced{true} is published once only in OpenR initialization
  * process. kvStoreSynced and tPublication are exclusive, aka, only one of them
  * should be set in the struct. Defined explicit constructor to realize that.
+ * Same goes for kvStoreWarmStarted, see `warmStarted()`.
+ *
+ * NOTE: thrift publication is immutable and shared by reference among all
+ * readers of the replicate queue. Replicating `Publication` to N readers costs
+ * N pointer copies instead of N deep copies of (possibly huge) key-vals.
  */
 struct Publication {
   // Boolean flag indicating whether KvStoreDb is synced with all peers among
   // all areas.
   bool kvStoreSynced{false};
 
-  // Thrift format KvStore publication.
-  thrift::Publication tPublication;
+  // Boolean flag indicating whether KvStoreDb is seeded from warm start
+  // snapshot among all areas. Published at most once, ahead of kvStoreSynced.
+  bool kvStoreWarmStarted{false};
 
-  explicit Publication(bool kvStoreSynced) : kvStoreSynced(kvStoreSynced) {}
+  // Thrift format KvStore publication. Never null.
+  std::shared_ptr<const thrift::Publication> tPublication;
 
-  explicit Publication(const thrift::Publication& tPub) : tPublication(tPub) {}
+  explicit Publication(bool kvStoreSynced)
+      : kvStoreSynced(kvStoreSynced),
+        tPublication(std::make_shared<const thrift::Publication>()) {}
+
+  explicit Publication(thrift::Publication tPub)
+      : tPublication(
+            std::make_shared<const thrift::Publication>(std::move(tPub))) {}
+
+  explicit Publication(std::shared_ptr<const thrift::Publication> tPub)
+      : tPublication(std::move(tPub)) {}
+
+  static Publication
+  warmStarted() {
+    Publication pub(false /*kvStoreSynced*/);
+    pub.kvStoreWarmStarted = true;
+    return pub;
+  }
 };
 
 /**
  * Provides match capability on list of regexes. Will default to prefix match
  * if regex is normal string.
+ *
+ * Patterns are analyzed on construction. Literal ones, optionally with a
+ * leading `^`, a trailing `$` or `.*` and escaped punctuation, e.g. `po1$` or
+ * `eth.*`, are answered from a hash set of whole keys or a sorted prefix index
+ * with a single binary search. Only the remaining patterns are compiled into
+ * RE2 set. Case-insensitive literals are folded as ASCII.
  */
 class RegexSet {
  public:
   /**
-   * Create regex set from list of regexes
+   * Create regex set from list of regexes, anchored at the start of keys and
+   * also at their end if `anchorEnd`. Throws std::invalid_argument on
+   * malformed regex. Empty set matches nothing.
    */
-  explicit RegexSet(std::vector<std::string> const& regexOrPrefixList);
+  explicit RegexSet(
+      std::vector<std::string> const& regexOrPrefixList,
+      bool anchorEnd = false,
+      bool caseSensitive = true);
 
   /**
    * Match key with regex set
    */
   bool match(std::string const& key) const;
 
+  /**
+   * True if every pattern is a literal prefix. Matching keys then lie within
+   * the key ranges of `getLiteralPrefixes()`.
+   */
+  bool
+  isLiteralOnly() const {
+    return regexSet_ == nullptr and literalKeys_.empty();
+  }
+
+  /**
+   * Sorted list of literal prefixes, none being a prefix of another one
+   */
+  std::vector<std::string> const&
+  getLiteralPrefixes() const {
+    return literalPrefixes_;
+  }
+
+  /**
+   * Check if pattern has no regex meta-character and matches as plain prefix
+   */
+  static bool isLiteralPrefix(std::string const& pattern);
+
+  /**
+   * Check if character is a regex meta-character
+   */
+  static bool isMetaChar(char c);
+
  private:
+  bool matchLiteral(std::string const& key) const;
+
+  const bool anchorEnd_{false};
+  const bool caseSensitive_{true};
+  folly::F14FastSet<std::string> literalKeys_;
+  std::vector<std::string> literalPrefixes_;
   std::unique_ptr<re2::RE2::Set> regexSet_;
 };
 
@@ -581,11 +770,15 @@ class PrefixKey {
       std::string const& node,
       folly::CIDRNetwork const& prefix,
       const std::string& area,
-      bool isPrefixKeyV2 = false);
+      bool isPrefixKeyV2 = false,
+      bool isPrefixKeyCompact = false);
 
   // Util function to check string is with v1 or v2 format of prefix key
   static bool isPrefixKeyV2Str(const std::string& key);
 
+  // Util function to check string is with compact format of prefix key
+  static bool isPrefixKeyCompactStr(const std::string& key);
+
   // construct PrefixKey object from a give key string
   static folly::Expected<PrefixKey, std::string> fromStr(
       const std::string& key,
@@ -649,12 +842,30 @@ class PrefixKey {
     return prefixKeyStringV2_;
   }
 
+  /*
+   * Compact format of prefix key, without area as v2 format:
+   *
+   *  prefix:<node>:~<base64url(family, plen, prefix bytes)>
+   *
+   * Only the bytes covered by prefix length are encoded, which shrinks key of
+   * e.g. IPv6 /64 prefix to 15 bytes after node name, from 26 for v2 format.
+   * Keys are parsed without regex. Understood since
+   * `Constants::kOpenrCompactPrefixKeyVersion`.
+   */
+  std::string getPrefixKeyCompact() const;
+
   // return v2 format flag
   inline bool
   isPrefixKeyV2() const {
     return isPrefixKeyV2_;
   }
 
+  // return compact format flag
+  inline bool
+  isPrefixKeyCompact() const {
+    return isPrefixKeyCompact_;
+  }
+
   bool
   operator==(openr::PrefixKey const& other) const {
     return prefix_ == other.prefix_ && nodeAndArea_ == other.nodeAndArea_;
@@ -670,6 +881,9 @@ class PrefixKey {
   // flag to indicate v2 format
   const bool isPrefixKeyV2_;
 
+  // flag to indicate compact format
+  const bool isPrefixKeyCompact_;
+
   // raw key string from KvStore
   std::string const prefixKeyString_;
   std::string const prefixKeyStringV2_;
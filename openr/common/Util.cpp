@@ -7,7 +7,12 @@
 
 #include <openr/common/Util.h>
 
+#include <atomic>
+
 #include <fmt/core.h>
+#include <folly/hash/SpookyHashV2.h>
+#include <folly/memory/Malloc.h>
+#include <folly/small_vector.h>
 #include <ifaddrs.h>
 #include <net/if.h>
 #include <netinet/in.h>
@@ -272,10 +277,47 @@ getDurationBetweenPerfEvents(
   return std::chrono::milliseconds(second - first);
 }
 
+namespace {
+
+std::atomic<int32_t> valueHashVersion{Constants::kValueHashVersionLegacy};
+
+} // namespace
+
+void
+setValueHashVersion(int32_t hashVersion) {
+  CHECK(
+      hashVersion == Constants::kValueHashVersionLegacy or
+      hashVersion == Constants::kValueHashVersionV2)
+      << "Unsupported value hash version " << hashVersion;
+  valueHashVersion.store(hashVersion);
+}
+
+int32_t
+getValueHashVersion() {
+  return valueHashVersion.load();
+}
+
 template <class T>
 int64_t
 generateHashImpl(
     const int64_t version, const std::string& originatorId, const T& value) {
+  if (valueHashVersion.load(std::memory_order_relaxed) ==
+      Constants::kValueHashVersionV2) {
+    // single pass over value bytes, chained through version and originator.
+    // Top byte carries hash version to tell apart from legacy hashes
+    uint64_t seed = folly::hash::SpookyHashV2::Hash64(
+        &version, sizeof(version), Constants::kValueHashVersionV2);
+    seed = folly::hash::SpookyHashV2::Hash64(
+        originatorId.data(), originatorId.size(), seed);
+    if (value.has_value()) {
+      seed = folly::hash::SpookyHashV2::Hash64(
+          value.value().data(), value.value().size(), seed);
+    }
+    return static_cast<int64_t>(
+        (seed >> 8) |
+        (static_cast<uint64_t>(Constants::kValueHashVersionV2) << 56));
+  }
+
   size_t seed = 0;
   boost::hash_combine(seed, version);
   boost::hash_combine(seed, originatorId);
@@ -779,7 +821,9 @@ createPrefixKeyValue(
   return {
       isPrefixKeyV2 ? key.getPrefixKeyV2() : key.getPrefixKey(),
       createThriftValue(
-          version, nodeName, writeThriftObjStr(std::move(db), serializer))};
+          version,
+          nodeName,
+          writeThriftObjStrBuffered(std::move(db), serializer))};
 }
 
 std::pair<std::string, thrift::Value>
@@ -905,9 +949,7 @@ createMplsRoute(int32_t topLabel, std::vector<thrift::NextHopThrift> nextHops) {
 }
 
 std::vector<thrift::UnicastRoute>
-createUnicastRoutesFromMap(
-    const std::unordered_map<folly::CIDRNetwork, RibUnicastEntry>&
-        unicastRoutes) {
+createUnicastRoutesFromMap(const RibUnicastEntries& unicastRoutes) {
   std::vector<thrift::UnicastRoute> newRoutes;
   for (auto const& [_, route] : unicastRoutes) {
     newRoutes.emplace_back(route.toThrift());
@@ -916,8 +958,7 @@ createUnicastRoutesFromMap(
 }
 
 std::vector<thrift::MplsRoute>
-createMplsRoutesFromMap(
-    const std::unordered_map<int32_t, RibMplsEntry>& mplsRoutes) {
+createMplsRoutesFromMap(const RibMplsEntries& mplsRoutes) {
   std::vector<thrift::MplsRoute> newRoutes;
   for (auto const& [_, route] : mplsRoutes) {
     newRoutes.emplace_back(route.toThrift());
@@ -935,6 +976,79 @@ getNodeNameFromKey(const std::string& key) {
   return split[1];
 }
 
+std::string
+getAdjacencyKey(
+    const std::string& nodeName,
+    const std::string& otherNodeName,
+    const std::string& ifName) {
+  return fmt::format(
+      "{}{}{}{}{}{}",
+      Constants::kAdjDbMarker.toString(),
+      nodeName,
+      Constants::kPrefixNameSeparator.toString(),
+      otherNodeName,
+      Constants::kPrefixNameSeparator.toString(),
+      ifName);
+}
+
+bool
+isAdjacencyKey(const std::string& key) {
+  return key.find(Constants::kAdjDbMarker.toString()) == 0 and
+      key.find(
+          Constants::kPrefixNameSeparator.toString(),
+          Constants::kAdjDbMarker.size()) != std::string::npos;
+}
+
+namespace {
+// follows node name in bucket key, not allowed in node names
+constexpr char kPrefixDbBucketMarker{'#'};
+} // namespace
+
+std::string
+getPrefixDbBucketKey(const std::string& nodeName, uint32_t bucket) {
+  return fmt::format(
+      "{}{}{}{}{}",
+      Constants::kPrefixDbMarker.toString(),
+      nodeName,
+      Constants::kPrefixNameSeparator.toString(),
+      kPrefixDbBucketMarker,
+      bucket);
+}
+
+std::optional<uint32_t>
+getPrefixDbBucketFromKey(const std::string& key) {
+  if (key.find(Constants::kPrefixDbMarker.toString()) != 0) {
+    return std::nullopt;
+  }
+  const auto pos = key.find(
+      fmt::format(
+          "{}{}",
+          Constants::kPrefixNameSeparator.toString(),
+          kPrefixDbBucketMarker),
+      Constants::kPrefixDbMarker.size());
+  if (pos == std::string::npos) {
+    return std::nullopt;
+  }
+  auto bucket = folly::tryTo<uint32_t>(
+      folly::StringPiece(key).subpiece(
+          pos + Constants::kPrefixNameSeparator.size() + 1));
+  return bucket.hasValue() ? std::make_optional(*bucket) : std::nullopt;
+}
+
+bool
+isPrefixDbBucketKey(const std::string& key) {
+  return getPrefixDbBucketFromKey(key).has_value();
+}
+
+uint32_t
+getPrefixDbBucket(const folly::CIDRNetwork& prefix, uint32_t numBuckets) {
+  CHECK_GT(numBuckets, 0);
+  // deterministic, so prefix stays in its bucket across restarts
+  return folly::hash::SpookyHashV2::Hash32(
+             prefix.first.bytes(), prefix.first.byteCount(), prefix.second) %
+      numBuckets;
+}
+
 NodeAndArea
 selectBestNodeArea(
     const std::set<NodeAndArea>& allNodeAreas,
@@ -971,71 +1085,11 @@ selectBestNodeArea(
 
 namespace {
 
-std::set<NodeAndArea>
-selectShortestDistance(
-    const PrefixEntries& prefixEntries,
-    const std::set<NodeAndArea>& nodeAreaSet) {
-  std::set<NodeAndArea> ret;
-  int32_t shortestDist = std::numeric_limits<int32_t>::max();
-  for (const auto& nodeArea : nodeAreaSet) {
-    if (prefixEntries.count(nodeArea) == 0) {
-      continue;
-    }
-    int32_t dist = prefixEntries.at(nodeArea)->get_metrics().get_distance();
-    if (dist > shortestDist) {
-      continue;
-    }
-    if (dist < shortestDist) {
-      shortestDist = dist;
-      ret.clear();
-    }
-    ret.emplace(nodeArea);
-  }
-  return ret;
-}
-
-std::set<NodeAndArea>
-selectShortestDistance2(
-    const PrefixEntries& prefixEntries, std::set<NodeAndArea>& nodeAreaSet) {
-  // Get results with shortest distance.
-  std::set<NodeAndArea> shortestSet =
-      selectShortestDistance(prefixEntries, nodeAreaSet);
-  // Remove NodeAndArea with shortest distance.
-  for (const auto& nodeArea : shortestSet) {
-    nodeAreaSet.erase(nodeArea);
-  }
-  // Get results with second shortest distance.
-  std::set<NodeAndArea> secShortestSet =
-      selectShortestDistance(prefixEntries, nodeAreaSet);
-
-  std::set<NodeAndArea> ret;
-  std::merge(
-      shortestSet.begin(),
-      shortestSet.end(),
-      secShortestSet.begin(),
-      secShortestSet.end(),
-      std::inserter(ret, ret.begin()));
-  return ret;
-}
-
-std::set<NodeAndArea>
-selectShortestDistancePerArea(
-    const PrefixEntries& prefixEntries,
-    const std::set<NodeAndArea>& nodeAreaSet) {
-  // Split nodeAreaSet based on area.
-  std::unordered_map<std::string /*area*/, std::set<NodeAndArea>> areaMap;
-  for (const auto& nodeArea : nodeAreaSet) {
-    areaMap[nodeArea.second].emplace(nodeArea);
-  }
-  std::set<NodeAndArea> ret;
-  // Get shortest distance result in each area.
-  for (const auto& [_, setInArea] : areaMap) {
-    auto shortestRet = selectShortestDistance(prefixEntries, setInArea);
-    for (const auto& nodeArea : shortestRet) {
-      ret.insert(nodeArea);
-    }
-  }
-  return ret;
+// <path_preference, source_preference> of entry, both prefer-higher
+std::tuple<int32_t, int32_t>
+getPreference(thrift::PrefixEntry const& entry) {
+  auto const& metrics = entry.get_metrics();
+  return {metrics.get_path_preference(), metrics.get_source_preference()};
 }
 
 } // namespace
@@ -1044,44 +1098,93 @@ std::set<NodeAndArea>
 selectRoutes(
     const PrefixEntries& prefixEntries,
     thrift::RouteSelectionAlgorithm algorithm) {
+  // Routes are selected in linear passes without intermediate containers,
+  // only the selected ones are inserted into the result. Prefixes advertised
+  // by thousands of nodes (e.g. anycast VIPs) share few distinct entries,
+  // hence few distinct metrics are compared.
+
   // First, select prefixEntries with best <path_preference, source_preference>
   // tuples. This is a must-have regardless of route selection algorithms.
-  // Leverage tuple for ease of comparision.
-  std::tuple<int32_t, int32_t> bestMetricsTuple{
+  std::tuple<int32_t, int32_t> bestPreference{
       std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::min()};
-  std::set<NodeAndArea> nodeAreaSet;
-  for (auto& [key, metricsWrapper] : prefixEntries) {
-    auto& metrics = metricsWrapper->get_metrics();
-    std::tuple<int32_t, int32_t> metricsTuple{
-        metrics.get_path_preference(), /* prefer-higher */
-        metrics.get_source_preference() /* prefer-higher */};
-
-    if (metricsTuple < bestMetricsTuple) {
-      continue;
-    }
-    if (metricsTuple > bestMetricsTuple) {
-      // Clear set and update best metric if this is a new best metric
-      bestMetricsTuple = metricsTuple;
-      nodeAreaSet.clear();
-    }
-    nodeAreaSet.emplace(key);
+  for (auto const& [_, entry] : prefixEntries) {
+    bestPreference = std::max(bestPreference, getPreference(*entry));
   }
+  auto isPreferred = [&bestPreference](auto const& entry) {
+    return getPreference(*entry) == bestPreference;
+  };
+  auto getDistance = [](auto const& entry) {
+    return entry->get_metrics().get_distance();
+  };
 
   // Second, select routes based on selection algorithm.
+  std::set<NodeAndArea> ret;
   switch (algorithm) {
   case thrift::RouteSelectionAlgorithm::SHORTEST_DISTANCE:
-    return selectShortestDistance(prefixEntries, nodeAreaSet);
-  case thrift::RouteSelectionAlgorithm::K_SHORTEST_DISTANCE_2:
-    return selectShortestDistance2(prefixEntries, nodeAreaSet);
-  case thrift::RouteSelectionAlgorithm::PER_AREA_SHORTEST_DISTANCE:
-    return selectShortestDistancePerArea(prefixEntries, nodeAreaSet);
+  case thrift::RouteSelectionAlgorithm::K_SHORTEST_DISTANCE_2: {
+    // shortest and second shortest distinct distances
+    int32_t shortestDist = std::numeric_limits<int32_t>::max();
+    int32_t secShortestDist = std::numeric_limits<int32_t>::max();
+    for (auto const& [_, entry] : prefixEntries) {
+      if (not isPreferred(entry)) {
+        continue;
+      }
+      const auto dist = getDistance(entry);
+      if (dist < shortestDist) {
+        secShortestDist = shortestDist;
+        shortestDist = dist;
+      } else if (dist > shortestDist and dist < secShortestDist) {
+        secShortestDist = dist;
+      }
+    }
+    const auto maxDist =
+        algorithm == thrift::RouteSelectionAlgorithm::SHORTEST_DISTANCE
+        ? shortestDist
+        : secShortestDist;
+    for (auto const& [nodeArea, entry] : prefixEntries) {
+      if (isPreferred(entry) and getDistance(entry) <= maxDist) {
+        ret.emplace(nodeArea);
+      }
+    }
+    return ret;
+  }
+  case thrift::RouteSelectionAlgorithm::PER_AREA_SHORTEST_DISTANCE: {
+    // shortest distance in each area, areas are few hence searched linearly
+    folly::small_vector<std::pair<std::string const*, int32_t>, 4>
+        areaShortestDists;
+    auto findArea = [&areaShortestDists](std::string const& area) {
+      return std::find_if(
+          areaShortestDists.begin(),
+          areaShortestDists.end(),
+          [&area](auto const& areaDist) { return *areaDist.first == area; });
+    };
+    for (auto const& [nodeArea, entry] : prefixEntries) {
+      if (not isPreferred(entry)) {
+        continue;
+      }
+      const auto dist = getDistance(entry);
+      auto it = findArea(nodeArea.second);
+      if (it == areaShortestDists.end()) {
+        areaShortestDists.emplace_back(&nodeArea.second, dist);
+      } else {
+        it->second = std::min(it->second, dist);
+      }
+    }
+    for (auto const& [nodeArea, entry] : prefixEntries) {
+      if (isPreferred(entry) and
+          getDistance(entry) <= findArea(nodeArea.second)->second) {
+        ret.emplace(nodeArea);
+      }
+    }
+    return ret;
+  }
   default:
     LOG(INFO) << "Unsupported route selection algorithm "
               << apache::thrift::util::enumNameSafe(algorithm);
     break;
   }
 
-  return std::set<NodeAndArea>();
+  return ret;
 }
 
 namespace MetricVectorUtils {
@@ -1281,5 +1384,60 @@ getThreadBytesImpl(bool isAllocated) {
   return bytes;
 }
 
+std::optional<unsigned>
+bindThreadToNewArena() {
+  if (not folly::usingJEMalloc()) {
+    return std::nullopt;
+  }
+  try {
+    unsigned arenaIndex{0};
+    folly::mallctlRead("arenas.create", &arenaIndex);
+    folly::mallctlWrite("thread.arena", arenaIndex);
+    return arenaIndex;
+  } catch (const std::exception& ex) {
+    LOG(ERROR) << "Failed to bind thread to a new arena: " << ex.what();
+  }
+  return std::nullopt;
+}
+
+void
+refreshMallocStats() {
+  if (not folly::usingJEMalloc()) {
+    return;
+  }
+  try {
+    folly::mallctlWrite<uint64_t>("epoch", 1);
+  } catch (const std::exception& ex) {
+    LOG(ERROR) << "Failed to refresh malloc stats: " << ex.what();
+  }
+}
+
+std::optional<ArenaStats>
+getArenaStats(unsigned arenaIndex) {
+  if (not folly::usingJEMalloc()) {
+    return std::nullopt;
+  }
+  try {
+    size_t smallBytes{0};
+    size_t largeBytes{0};
+    ArenaStats stats;
+    folly::mallctlRead(
+        fmt::format("stats.arenas.{}.small.allocated", arenaIndex).c_str(),
+        &smallBytes);
+    folly::mallctlRead(
+        fmt::format("stats.arenas.{}.large.allocated", arenaIndex).c_str(),
+        &largeBytes);
+    folly::mallctlRead(
+        fmt::format("stats.arenas.{}.resident", arenaIndex).c_str(),
+        &stats.residentBytes);
+    stats.allocatedBytes = smallBytes + largeBytes;
+    return stats;
+  } catch (const std::exception& ex) {
+    LOG(ERROR) << "Failed to read stats of arena " << arenaIndex << ": "
+               << ex.what();
+  }
+  return std::nullopt;
+}
+
 } // namespace memory
 } // namespace openr
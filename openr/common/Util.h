@@ -10,6 +10,7 @@
 #include <boost/functional/hash.hpp>
 #include <folly/FileUtil.h>
 #include <folly/IPAddress.h>
+#include <folly/io/IOBufQueue.h>
 #include <folly/memory/MallctlHelper.h>
 #include <glog/logging.h>
 #include <thrift/lib/cpp2/protocol/Serializer.h>
@@ -146,6 +147,14 @@ getDurationBetweenPerfEvents(
     const std::string& firstName,
     const std::string& secondName) noexcept;
 
+/**
+ * Process wide version of hash generated for key-vals, one of
+ * `Constants::kValueHashVersion*`. Legacy hash by default; all nodes of the
+ * network must run the same version as hashes are compared across nodes.
+ */
+void setValueHashVersion(int32_t hashVersion);
+int32_t getValueHashVersion();
+
 /**
  * Generate hash for each keyval pair
  * as a abstract of version number, originator and values
@@ -222,6 +231,24 @@ writeThriftObjStr(ThriftType const& obj, Serializer& serializer) {
   return result;
 }
 
+/**
+ * Same as writeThriftObjStr(), but serializes into a thread-local queue whose
+ * largest buffer is kept across calls, then copies out into a string
+ * allocated once at its final size. Saves buffer allocations and growth
+ * copies on hot encode paths of large objects, e.g. AdjacencyDatabase.
+ */
+template <typename ThriftType, typename Serializer>
+std::string
+writeThriftObjStrBuffered(ThriftType const& obj, Serializer& serializer) {
+  thread_local folly::IOBufQueue queue{folly::IOBufQueue::cacheChainLength()};
+  serializer.serialize(obj, &queue);
+  std::string result;
+  result.reserve(queue.chainLength());
+  queue.appendToString(result);
+  queue.clearAndTryReuseLargestBuffer();
+  return result;
+}
+
 template <typename ThriftType, typename Serializer>
 ThriftType
 readThriftObj(folly::IOBuf& buf, Serializer& serializer) {
@@ -417,13 +444,43 @@ thrift::MplsRoute createMplsRoute(
     int32_t topLabel, std::vector<thrift::NextHopThrift> nextHops);
 
 std::vector<thrift::UnicastRoute> createUnicastRoutesFromMap(
-    const std::unordered_map<folly::CIDRNetwork, RibUnicastEntry>&
-        unicastRoutes);
+    const RibUnicastEntries& unicastRoutes);
 std::vector<thrift::MplsRoute> createMplsRoutesFromMap(
-    const std::unordered_map<int32_t, RibMplsEntry>& mplsRoutes);
+    const RibMplsEntries& mplsRoutes);
 
 std::string getNodeNameFromKey(const std::string& key);
 
+/**
+ * Key of a single adjacency, "adj:<node>:<otherNode>:<ifName>". Used instead
+ * of "adj:<node>" when node advertises one key per adjacency, each carrying
+ * AdjacencyDatabase with node attributes and exactly one adjacency.
+ */
+std::string getAdjacencyKey(
+    const std::string& nodeName,
+    const std::string& otherNodeName,
+    const std::string& ifName);
+
+// Check if "adj:" key carries a single adjacency rather than whole database
+bool isAdjacencyKey(const std::string& key);
+
+/**
+ * Key of one bucket of node's prefix database, "prefix:<node>:#<bucket>".
+ * Used instead of one "prefix:" key per prefix when node packs its prefixes
+ * into a few keys, each carrying PrefixDatabase with all prefixes hashed into
+ * the bucket.
+ */
+std::string getPrefixDbBucketKey(const std::string& nodeName, uint32_t bucket);
+
+// Bucket of "prefix:" key packing many prefixes, std::nullopt for other keys
+std::optional<uint32_t> getPrefixDbBucketFromKey(const std::string& key);
+
+// Check if "prefix:" key packs a bucket of prefixes rather than one prefix
+bool isPrefixDbBucketKey(const std::string& key);
+
+// Bucket of prefix database `prefix` is packed into, by hash of the prefix
+uint32_t getPrefixDbBucket(
+    const folly::CIDRNetwork& prefix, uint32_t numBuckets);
+
 /**
  * Implements Open/R best route selection based on `thrift::PrefixMetrics`. The
  * metrics are compared and keys representing the best metric are returned. It
@@ -498,6 +555,25 @@ namespace memory {
 
 uint64_t getThreadBytesImpl(bool isAllocated);
 
+// Bytes held by a jemalloc arena
+struct ArenaStats {
+  // bytes allocated by application
+  size_t allocatedBytes{0};
+  // bytes of physically resident data pages mapped by the arena
+  size_t residentBytes{0};
+};
+
+// Create a new jemalloc arena and bind calling thread to it, so that its
+// allocations can be told apart from the ones of other threads. Return
+// index of the arena, or std::nullopt if not running with jemalloc.
+std::optional<unsigned> bindThreadToNewArena();
+
+// Refresh jemalloc stats, which are otherwise cached. MUST be called before
+// reading up to date stats with getArenaStats().
+void refreshMallocStats();
+
+std::optional<ArenaStats> getArenaStats(unsigned arenaIndex);
+
 } // namespace memory
 
 } // namespace openr
@@ -513,33 +589,30 @@ std::set<Key>
 selectBestPrefixMetrics(
     std::unordered_map<Key, MetricsWrapper> const& prefixes) {
   // Leveraging tuple for ease of comparision
-  std::tuple<int32_t, int32_t, int32_t> bestMetricsTuple{
-      std::numeric_limits<int32_t>::min(),
-      std::numeric_limits<int32_t>::min(),
-      std::numeric_limits<int32_t>::min()};
-  std::set<Key> bestKeys;
-  for (auto& [key, metricsWrapper] : prefixes) {
+  auto getMetricsTuple = [](MetricsWrapper const& metricsWrapper) {
     auto& metrics = metricsWrapper.metrics_ref().value();
-    std::tuple<int32_t, int32_t, int32_t> metricsTuple{
+    return std::tuple<int32_t, int32_t, int32_t>{
         metrics.path_preference_ref().value(), /* prefer-higher */
         metrics.source_preference_ref().value(), /* prefer-higher */
         metrics.distance_ref().value() * -1 /* prefer-lower */};
+  };
 
-    // Skip if this is less than best metrics we've seen so far
-    if (metricsTuple < bestMetricsTuple) {
-      continue;
-    }
+  // Find best metrics first, so that only best keys are inserted
+  std::tuple<int32_t, int32_t, int32_t> bestMetricsTuple{
+      std::numeric_limits<int32_t>::min(),
+      std::numeric_limits<int32_t>::min(),
+      std::numeric_limits<int32_t>::min()};
+  for (auto const& [_, metricsWrapper] : prefixes) {
+    bestMetricsTuple =
+        std::max(bestMetricsTuple, getMetricsTuple(metricsWrapper));
+  }
 
-    // Clear set and update best metric if this is a new best metric
-    if (metricsTuple > bestMetricsTuple) {
-      bestMetricsTuple = metricsTuple;
-      bestKeys.clear();
+  std::set<Key> bestKeys;
+  for (auto const& [key, metricsWrapper] : prefixes) {
+    if (getMetricsTuple(metricsWrapper) == bestMetricsTuple) {
+      bestKeys.emplace(key);
     }
-
-    // Current metrics is either best or same as best metrics we've seen so far
-    bestKeys.emplace(key);
   }
-
   return bestKeys;
 }
 } // namespace openr
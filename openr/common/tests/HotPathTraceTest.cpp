@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <openr/common/Constants.h>
+#include <openr/common/HotPathTrace.h>
+
+using namespace openr;
+
+TEST(HotPathTraceTest, RecordSpans) {
+  HotPathTrace::clear();
+  const auto start = HotPathTrace::Clock::now();
+  HotPathTrace::record(
+      "test.span", "area1", start, start + std::chrono::milliseconds(5), 10);
+  {
+    ScopedTraceSpan span("test.scoped");
+    span.setCount(3);
+  }
+
+  auto spans = HotPathTrace::getSpans();
+  ASSERT_EQ(2, spans.size());
+  EXPECT_EQ("test.span", *spans.at(0).name_ref());
+  EXPECT_EQ("area1", *spans.at(0).area_ref());
+  EXPECT_EQ(5000, *spans.at(0).durationUs_ref());
+  EXPECT_EQ(10, *spans.at(0).count_ref());
+  EXPECT_LT(0, *spans.at(0).startUnixTsUs_ref());
+  EXPECT_EQ("test.scoped", *spans.at(1).name_ref());
+  EXPECT_EQ("", *spans.at(1).area_ref());
+  EXPECT_EQ(3, *spans.at(1).count_ref());
+
+  HotPathTrace::clear();
+  EXPECT_TRUE(HotPathTrace::getSpans().empty());
+}
+
+TEST(HotPathTraceTest, RingOverwritesOldest) {
+  HotPathTrace::clear();
+  const auto start = HotPathTrace::Clock::now();
+  const size_t numSpans = Constants::kHotPathTraceSize + 10;
+  for (size_t i = 0; i < numSpans; ++i) {
+    HotPathTrace::record("test.span", "", start, start, i);
+  }
+
+  auto spans = HotPathTrace::getSpans();
+  ASSERT_EQ(Constants::kHotPathTraceSize, spans.size());
+  // oldest first
+  for (size_t i = 0; i < spans.size(); ++i) {
+    EXPECT_EQ(static_cast<int64_t>(i + 10), *spans.at(i).count_ref());
+  }
+}
+
+int
+main(int argc, char** argv) {
+  // Basic initialization
+  testing::InitGoogleTest(&argc, argv);
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  // Run the tests
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <folly/io/async/EventBase.h>
+#include <openr/common/KeyedAsyncThrottle.h>
+
+namespace chrono = std::chrono;
+
+namespace openr {
+
+using KeySet = std::unordered_set<std::string>;
+
+/**
+ * Keys marked before throttle fires are handed to callback in one batch
+ */
+TEST(KeyedAsyncThrottleTest, BatchKeys) {
+  folly::EventBase evb;
+  std::vector<KeySet> batches;
+  KeyedAsyncThrottle<std::string> throttledFn(
+      &evb, chrono::milliseconds(10), [&](KeySet&& keys) noexcept {
+        batches.emplace_back(std::move(keys));
+      });
+
+  evb.runInEventBaseThread([&]() {
+    for (int i = 0; i < 10; ++i) {
+      throttledFn("key1");
+      throttledFn("key2");
+    }
+    EXPECT_TRUE(throttledFn.isActive());
+    EXPECT_EQ(2, throttledFn.numPendingKeys());
+    EXPECT_TRUE(throttledFn.isPending("key1"));
+  });
+
+  folly::AsyncTimeout::schedule(chrono::milliseconds(50), evb, [&]() noexcept {
+    ASSERT_EQ(1, batches.size());
+    EXPECT_EQ(KeySet({"key1", "key2"}), batches.at(0));
+    EXPECT_FALSE(throttledFn.isActive());
+    EXPECT_EQ(0, throttledFn.numPendingKeys());
+
+    // Cancelled keys are dropped
+    throttledFn("key3");
+    throttledFn.cancel();
+    EXPECT_FALSE(throttledFn.isActive());
+    EXPECT_EQ(0, throttledFn.numPendingKeys());
+  });
+
+  folly::AsyncTimeout::schedule(
+      chrono::milliseconds(100), evb, [&]() noexcept {
+        EXPECT_EQ(1, batches.size());
+        evb.terminateLoopSoon();
+      });
+
+  evb.loop();
+}
+
+/**
+ * Key marked within its min interval is held back, without delaying others
+ */
+TEST(KeyedAsyncThrottleTest, KeyMinInterval) {
+  folly::EventBase evb;
+  std::vector<std::pair<chrono::steady_clock::time_point, KeySet>> batches;
+  KeyedAsyncThrottle<std::string> throttledFn(
+      &evb,
+      chrono::milliseconds(0),
+      [&](KeySet&& keys) noexcept {
+        batches.emplace_back(chrono::steady_clock::now(), std::move(keys));
+      },
+      chrono::milliseconds(200) /* keyMinInterval */);
+
+  evb.runInEventBaseThread([&]() {
+    // Immediate timeout fires right away
+    throttledFn("key1");
+    ASSERT_EQ(1, batches.size());
+    EXPECT_EQ(KeySet({"key1"}), batches.back().second);
+
+    // key1 is held back, key2 is not
+    throttledFn("key1");
+    EXPECT_EQ(1, batches.size());
+    EXPECT_TRUE(throttledFn.isActive());
+    throttledFn("key2");
+    ASSERT_EQ(2, batches.size());
+    EXPECT_EQ(KeySet({"key2"}), batches.back().second);
+    EXPECT_TRUE(throttledFn.isPending("key1"));
+    EXPECT_TRUE(throttledFn.isActive());
+  });
+
+  folly::AsyncTimeout::schedule(
+      chrono::milliseconds(500), evb, [&]() noexcept {
+        // key1 is fired once its interval elapsed
+        ASSERT_EQ(3, batches.size());
+        EXPECT_EQ(KeySet({"key1"}), batches.back().second);
+        EXPECT_GE(
+            batches.back().first - batches.front().first,
+            chrono::milliseconds(200));
+        EXPECT_FALSE(throttledFn.isActive());
+        evb.terminateLoopSoon();
+      });
+
+  evb.loop();
+}
+
+} // namespace openr
+
+int
+main(int argc, char* argv[]) {
+  testing::InitGoogleTest(&argc, argv);
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+  google::InstallFailureSignalHandler();
+
+  return RUN_ALL_TESTS();
+}
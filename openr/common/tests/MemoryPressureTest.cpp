@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <folly/synchronization/Baton.h>
+
+#include <openr/common/MemoryPressure.h>
+#include <openr/common/OpenrEventBase.h>
+
+using namespace openr;
+
+TEST(MemoryPressureTest, PressureState) {
+  EXPECT_FALSE(MemoryPressure::isUnderPressure());
+  MemoryPressure::setUnderPressure(true);
+  EXPECT_TRUE(MemoryPressure::isUnderPressure());
+  MemoryPressure::setUnderPressure(false);
+  EXPECT_FALSE(MemoryPressure::isUnderPressure());
+}
+
+TEST(MemoryPressureTest, ShedInline) {
+  int numSheds{0};
+  auto shedder = MemoryPressure::addShedder(
+      "test", nullptr /* executor */, [&numSheds]() { ++numSheds; });
+
+  MemoryPressure::shed();
+  MemoryPressure::shed();
+  EXPECT_EQ(2, numSheds);
+
+  // never run once unregistered
+  shedder.reset();
+  MemoryPressure::shed();
+  EXPECT_EQ(2, numSheds);
+}
+
+TEST(MemoryPressureTest, ShedOnExecutor) {
+  OpenrEventBase evb;
+  std::thread evbThread([&]() { evb.run(); });
+  evb.waitUntilRunning();
+
+  folly::Baton shedBaton;
+  std::thread::id shedThreadId;
+  auto shedder =
+      MemoryPressure::addShedder("test", evb.getEvb(), [&]() noexcept {
+        shedThreadId = std::this_thread::get_id();
+        shedBaton.post();
+      });
+
+  MemoryPressure::shed();
+  shedBaton.wait();
+  EXPECT_EQ(evbThread.get_id(), shedThreadId);
+
+  shedder.reset();
+  evb.stop();
+  evb.waitUntilStopped();
+  evbThread.join();
+}
+
+int
+main(int argc, char** argv) {
+  // Basic initialization
+  testing::InitGoogleTest(&argc, argv);
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  // Run the tests
+  return RUN_ALL_TESTS();
+}
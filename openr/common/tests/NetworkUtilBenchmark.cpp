@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/Format.h>
+#include <folly/init/Init.h>
+
+#include <openr/common/NetworkUtil.h>
+
+namespace {
+
+// Number of prefixes converted per iteration
+const uint32_t kNumPrefixes = 1000;
+
+/**
+ * Distinct v6 or v4 prefixes, as received in route updates
+ */
+std::vector<openr::thrift::IpPrefix>
+getPrefixes(bool isV4) {
+  std::vector<openr::thrift::IpPrefix> prefixes;
+  prefixes.reserve(kNumPrefixes);
+  for (uint32_t i = 0; i < kNumPrefixes; ++i) {
+    prefixes.emplace_back(openr::toIpPrefix(
+        isV4 ? folly::sformat("10.{}.{}.0/24", i / 256, i % 256)
+             : folly::sformat("fc00:{:x}::/64", i)));
+  }
+  return prefixes;
+}
+
+} // namespace
+
+namespace openr {
+
+/**
+ * Baseline of BM_ToIPNetwork, i.e. formatting address and parsing it back
+ * into a network, as toIPNetwork() used to
+ */
+static void
+BM_ToIPNetworkViaString(uint32_t iters, bool isV4) {
+  auto suspender = folly::BenchmarkSuspender();
+  const auto prefixes = getPrefixes(isV4);
+  suspender.dismiss(); // Start measuring benchmark time
+
+  for (uint32_t i = 0; i < iters; ++i) {
+    for (auto const& prefix : prefixes) {
+      auto network = folly::IPAddress::createNetwork(
+          toIPAddress(*prefix.prefixAddress_ref()).str(),
+          *prefix.prefixLength_ref());
+      folly::doNotOptimizeAway(network);
+    }
+  }
+}
+
+/**
+ * Benchmark for toIPNetwork() of one prefix at a time
+ */
+static void
+BM_ToIPNetwork(uint32_t iters, bool isV4) {
+  auto suspender = folly::BenchmarkSuspender();
+  const auto prefixes = getPrefixes(isV4);
+  suspender.dismiss(); // Start measuring benchmark time
+
+  for (uint32_t i = 0; i < iters; ++i) {
+    for (auto const& prefix : prefixes) {
+      auto network = toIPNetwork(prefix);
+      folly::doNotOptimizeAway(network);
+    }
+  }
+}
+
+/**
+ * Benchmark for toIPNetworks() of all prefixes at once
+ */
+static void
+BM_ToIPNetworks(uint32_t iters, bool isV4) {
+  auto suspender = folly::BenchmarkSuspender();
+  const auto prefixes = getPrefixes(isV4);
+  suspender.dismiss(); // Start measuring benchmark time
+
+  for (uint32_t i = 0; i < iters; ++i) {
+    auto networks = toIPNetworks(prefixes);
+    folly::doNotOptimizeAway(networks);
+  }
+}
+
+// The parameter is whether prefixes are v4
+BENCHMARK_NAMED_PARAM(BM_ToIPNetworkViaString, v6, false);
+BENCHMARK_RELATIVE_NAMED_PARAM(BM_ToIPNetwork, v6, false);
+BENCHMARK_RELATIVE_NAMED_PARAM(BM_ToIPNetworks, v6, false);
+BENCHMARK_NAMED_PARAM(BM_ToIPNetworkViaString, v4, true);
+BENCHMARK_RELATIVE_NAMED_PARAM(BM_ToIPNetwork, v4, true);
+BENCHMARK_RELATIVE_NAMED_PARAM(BM_ToIPNetworks, v4, true);
+
+} // namespace openr
+
+int
+main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
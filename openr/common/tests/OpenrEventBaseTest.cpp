@@ -7,12 +7,14 @@
 
 #include <sys/eventfd.h>
 
+#include <fb303/ServiceData.h>
 #include <folly/futures/Promise.h>
 #include <folly/init/Init.h>
 #include <folly/synchronization/Baton.h>
 #include <gtest/gtest.h>
 
 #include <openr/common/OpenrEventBase.h>
+#include <openr/common/SharedExecutor.h>
 
 using namespace openr;
 
@@ -69,6 +71,36 @@ TEST(OpenrEventBaseTest, FiberTest) {
   EXPECT_TRUE(f.hasValue());
 }
 
+#if FOLLY_HAS_COROUTINES
+TEST(OpenrEventBaseTest, CoroTest) {
+  OpenrEventBase evb;
+  std::thread evbThread([&]() { evb.run(); });
+  evb.waitUntilRunning();
+
+  // task runs in event-base thread by default
+  std::atomic<bool> inEvbThread{false};
+  evb.addCoroTask([&]() -> folly::coro::Task<void> {
+    inEvbThread = evb.getEvb()->isInEventBaseThread();
+    co_return;
+  }());
+
+  // and off it on a strand of shared executor
+  std::atomic<bool> onStrand{false};
+  evb.addCoroTask(
+      [&]() -> folly::coro::Task<void> {
+        onStrand = not evb.getEvb()->isInEventBaseThread();
+        co_return;
+      }(),
+      SharedExecutor::makeStrand());
+
+  // tasks are awaited in stop()
+  evb.stop();
+  evbThread.join();
+  EXPECT_TRUE(inEvbThread);
+  EXPECT_TRUE(onStrand);
+}
+#endif
+
 TEST(OpenrEventBaseTest, RunnableApi) {
   OpenrEventBase evb;
 
@@ -154,6 +186,36 @@ TEST_F(OpenrEventBaseTestFixture, TimeoutTest) {
   EXPECT_LE(std::chrono::milliseconds(200), elapsedMs);
 }
 
+TEST(OpenrEventBaseTest, SlowCallbackTest) {
+  OpenrEventBase evb;
+  evb.setEvbName("slow_test");
+  evb.setSlowCallbackThreshold(std::chrono::milliseconds(50));
+  std::thread evbThread([&]() { evb.run(); });
+  evb.waitUntilRunning();
+
+  folly::Baton waitBaton;
+  // fast callback
+  evb.runInEventBaseThread([]() noexcept {});
+  // slow callbacks
+  evb.runInEventBaseThread([]() noexcept {
+    /* sleep override */
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  });
+  evb.scheduleTimeout(std::chrono::milliseconds(10), [&]() noexcept {
+    /* sleep override */
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    waitBaton.post();
+  });
+  waitBaton.wait();
+
+  evb.stop();
+  evb.waitUntilStopped();
+  evbThread.join();
+
+  auto counters = facebook::fb303::fbData->getCounters();
+  EXPECT_EQ(2, counters.at("evb.slow_callbacks.slow_test.count"));
+}
+
 TEST_F(OpenrEventBaseTestFixture, ZmqSocketPollTest) {
   const auto msg = fbzmq::Message::from(std::string("test message")).value();
   const size_t expectedMsgs{16};
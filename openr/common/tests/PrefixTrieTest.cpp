@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <set>
+
+#include <folly/Random.h>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <openr/common/PrefixTrie.h>
+
+using namespace openr;
+
+namespace {
+
+folly::CIDRNetwork
+toNetwork(std::string const& prefixStr) {
+  return folly::IPAddress::createNetwork(prefixStr, -1, true);
+}
+
+// reference longest prefix match, linear scan over all prefixes
+std::optional<folly::CIDRNetwork>
+scanLongestPrefixMatch(
+    folly::CIDRNetwork const& input,
+    std::set<folly::CIDRNetwork> const& prefixes) {
+  std::optional<folly::CIDRNetwork> match;
+  for (auto const& prefix : prefixes) {
+    if (prefix.first.family() == input.first.family() and
+        prefix.second <= input.second and
+        input.first.mask(prefix.second) == prefix.first and
+        (not match or match->second < prefix.second)) {
+      match = prefix;
+    }
+  }
+  return match;
+}
+
+} // namespace
+
+TEST(PrefixTrieTest, InsertEraseTest) {
+  PrefixTrie trie;
+  EXPECT_TRUE(trie.empty());
+
+  EXPECT_TRUE(trie.insert(toNetwork("10.0.0.0/8")));
+  EXPECT_TRUE(trie.insert(toNetwork("10.1.0.0/16")));
+  EXPECT_TRUE(trie.insert(toNetwork("10.2.0.0/16")));
+  EXPECT_FALSE(trie.insert(toNetwork("10.1.0.0/16")));
+  EXPECT_EQ(3, trie.size());
+
+  // branch point 10.0.0.0/14 of 10.1/16 and 10.2/16 is not a prefix
+  EXPECT_FALSE(trie.contains(toNetwork("10.0.0.0/14")));
+  EXPECT_FALSE(trie.erase(toNetwork("10.0.0.0/14")));
+  EXPECT_TRUE(trie.contains(toNetwork("10.1.0.0/16")));
+
+  EXPECT_TRUE(trie.erase(toNetwork("10.1.0.0/16")));
+  EXPECT_FALSE(trie.erase(toNetwork("10.1.0.0/16")));
+  EXPECT_FALSE(trie.contains(toNetwork("10.1.0.0/16")));
+  EXPECT_TRUE(trie.contains(toNetwork("10.2.0.0/16")));
+  EXPECT_EQ(2, trie.size());
+
+  trie.clear();
+  EXPECT_TRUE(trie.empty());
+  EXPECT_FALSE(trie.contains(toNetwork("10.0.0.0/8")));
+}
+
+TEST(PrefixTrieTest, LongestPrefixMatchTest) {
+  PrefixTrie trie;
+  trie.insert(toNetwork("::/0"));
+  trie.insert(toNetwork("192.168.0.0/16"));
+  trie.insert(toNetwork("192.168.0.0/20"));
+  trie.insert(toNetwork("192.168.0.0/24"));
+  trie.insert(toNetwork("192.168.20.16/28"));
+  trie.insert(toNetwork("fc00::/64"));
+
+  // address families don't match each other
+  EXPECT_EQ(toNetwork("::/0"), trie.longestPrefixMatch(toNetwork("::/0")));
+  EXPECT_EQ(std::nullopt, trie.longestPrefixMatch(toNetwork("0.0.0.0/0")));
+  EXPECT_EQ(std::nullopt, trie.longestPrefixMatch(toNetwork("10.0.0.1")));
+  EXPECT_EQ(toNetwork("::/0"), trie.longestPrefixMatch(toNetwork("fc00:1::1")));
+  EXPECT_EQ(
+      toNetwork("fc00::/64"), trie.longestPrefixMatch(toNetwork("fc00::1")));
+
+  EXPECT_EQ(
+      toNetwork("192.168.20.16/28"),
+      trie.longestPrefixMatch(toNetwork("192.168.20.19")));
+  EXPECT_EQ(
+      toNetwork("192.168.20.16/28"),
+      trie.longestPrefixMatch(toNetwork("192.168.20.16/28")));
+  EXPECT_EQ(
+      toNetwork("192.168.0.0/24"),
+      trie.longestPrefixMatch(toNetwork("192.168.0.0")));
+  EXPECT_EQ(
+      std::nullopt, trie.longestPrefixMatch(toNetwork("192.168.0.0/14")));
+  EXPECT_EQ(
+      toNetwork("192.168.0.0/16"),
+      trie.longestPrefixMatch(toNetwork("192.168.0.0/18")));
+  EXPECT_EQ(
+      toNetwork("192.168.0.0/20"),
+      trie.longestPrefixMatch(toNetwork("192.168.0.0/22")));
+
+  // falls back to covering prefix once more specific one is erased
+  trie.erase(toNetwork("192.168.0.0/24"));
+  EXPECT_EQ(
+      toNetwork("192.168.0.0/20"),
+      trie.longestPrefixMatch(toNetwork("192.168.0.0")));
+}
+
+TEST(PrefixTrieTest, SubPrefixesTest) {
+  PrefixTrie trie;
+  trie.insert(toNetwork("10.0.0.0/8"));
+  trie.insert(toNetwork("10.1.0.0/16"));
+  trie.insert(toNetwork("10.1.1.0/24"));
+  trie.insert(toNetwork("10.2.0.0/16"));
+  trie.insert(toNetwork("fc00::/64"));
+
+  EXPECT_THAT(
+      trie.getSubPrefixes(toNetwork("10.1.0.0/16")),
+      testing::UnorderedElementsAre(
+          toNetwork("10.1.0.0/16"), toNetwork("10.1.1.0/24")));
+  // covering branch point of 10.1/16 and 10.2/16
+  EXPECT_THAT(
+      trie.getSubPrefixes(toNetwork("10.0.0.0/14")),
+      testing::UnorderedElementsAre(
+          toNetwork("10.1.0.0/16"),
+          toNetwork("10.1.1.0/24"),
+          toNetwork("10.2.0.0/16")));
+  EXPECT_EQ(4, trie.getSubPrefixes(toNetwork("0.0.0.0/0")).size());
+  EXPECT_TRUE(trie.getSubPrefixes(toNetwork("10.3.0.0/16")).empty());
+  EXPECT_TRUE(trie.getSubPrefixes(toNetwork("11.0.0.0/8")).empty());
+}
+
+TEST(PrefixTrieTest, SuperPrefixesTest) {
+  PrefixTrie trie;
+  trie.insert(toNetwork("10.0.0.0/8"));
+  trie.insert(toNetwork("10.1.0.0/16"));
+  trie.insert(toNetwork("10.1.1.0/24"));
+  trie.insert(toNetwork("10.2.0.0/16"));
+  trie.insert(toNetwork("fc00::/64"));
+
+  // ordered from shortest to longest
+  EXPECT_THAT(
+      trie.getSuperPrefixes(toNetwork("10.1.1.1")),
+      testing::ElementsAre(
+          toNetwork("10.0.0.0/8"),
+          toNetwork("10.1.0.0/16"),
+          toNetwork("10.1.1.0/24")));
+  EXPECT_THAT(
+      trie.getSuperPrefixes(toNetwork("10.1.0.0/16")),
+      testing::ElementsAre(toNetwork("10.0.0.0/8"), toNetwork("10.1.0.0/16")));
+  // more specific prefixes don't cover
+  EXPECT_THAT(
+      trie.getSuperPrefixes(toNetwork("10.0.0.0/14")),
+      testing::ElementsAre(toNetwork("10.0.0.0/8")));
+  EXPECT_TRUE(trie.getSuperPrefixes(toNetwork("11.0.0.0/8")).empty());
+}
+
+// compare against linear scan under random inserts/erases
+TEST(PrefixTrieTest, RandomizedTest) {
+  PrefixTrie trie;
+  std::set<folly::CIDRNetwork> prefixes;
+  auto randomPrefix = []() {
+    // few distinct bits to have lots of overlapping prefixes
+    auto addr = folly::IPAddressV4::fromLongHBO(
+        folly::Random::rand32() & 0xff0f00f0);
+    auto len = folly::Random::rand32(33);
+    return folly::CIDRNetwork(folly::IPAddress(addr.mask(len)), len);
+  };
+
+  for (int i = 0; i < 10000; ++i) {
+    const auto prefix = randomPrefix();
+    if (folly::Random::oneIn(3)) {
+      EXPECT_EQ(prefixes.erase(prefix) == 1, trie.erase(prefix));
+    } else {
+      EXPECT_EQ(prefixes.insert(prefix).second, trie.insert(prefix));
+    }
+    ASSERT_EQ(prefixes.size(), trie.size());
+
+    const auto input = randomPrefix();
+    ASSERT_EQ(
+        scanLongestPrefixMatch(input, prefixes),
+        trie.longestPrefixMatch(input));
+  }
+
+  // copy is independent of the original
+  PrefixTrie copy(trie);
+  trie.clear();
+  EXPECT_EQ(prefixes.size(), copy.size());
+  for (auto const& prefix : prefixes) {
+    EXPECT_TRUE(copy.contains(prefix));
+  }
+}
+
+int
+main(int argc, char** argv) {
+  // Basic initialization
+  testing::InitGoogleTest(&argc, argv);
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  // Run the tests
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <openr/common/SharedExecutor.h>
+
+using namespace openr;
+
+/**
+ * Tasks of a strand run one at a time and in order, while strands run
+ * concurrently with each other
+ */
+TEST(SharedExecutorTest, StrandSerialization) {
+  const int kNumStrands = 4;
+  const int kNumTasks = 1000;
+
+  std::vector<SharedExecutor::Strand> strands;
+  std::vector<std::vector<int>> executed(kNumStrands);
+  std::vector<std::atomic<int>> running(kNumStrands);
+  std::atomic<bool> overlapped{false};
+  for (int i = 0; i < kNumStrands; ++i) {
+    strands.emplace_back(SharedExecutor::makeStrand());
+  }
+
+  for (int task = 0; task < kNumTasks; ++task) {
+    for (int i = 0; i < kNumStrands; ++i) {
+      strands[i]->add([&, i, task]() {
+        if (running[i]++ != 0) {
+          overlapped = true;
+        }
+        executed[i].emplace_back(task);
+        running[i]--;
+      });
+    }
+  }
+
+  for (int i = 0; i < kNumStrands; ++i) {
+    SharedExecutor::drain(strands[i]);
+    ASSERT_EQ(kNumTasks, static_cast<int>(executed[i].size()));
+    for (int task = 0; task < kNumTasks; ++task) {
+      EXPECT_EQ(task, executed[i][task]);
+    }
+  }
+  EXPECT_FALSE(overlapped);
+}
+
+/**
+ * Draining strand waits for task in progress
+ */
+TEST(SharedExecutorTest, Drain) {
+  auto strand = SharedExecutor::makeStrand();
+  std::atomic<bool> done{false};
+  strand->add([&done]() {
+    /* sleep override */
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    done = true;
+  });
+  SharedExecutor::drain(strand);
+  EXPECT_TRUE(done);
+}
+
+int
+main(int argc, char* argv[]) {
+  // Parse command line flags
+  testing::InitGoogleTest(&argc, argv);
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+  google::InstallFailureSignalHandler();
+
+  // Run the tests
+  return RUN_ALL_TESTS();
+}
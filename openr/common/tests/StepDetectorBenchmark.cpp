@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <chrono>
+
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+#include <folly/stats/BucketedTimeSeries.h>
+
+#include <openr/common/StepDetector.h>
+
+namespace {
+
+// Number of RTT samples added per iteration
+const uint32_t kNumSamples = 1000;
+
+// Sampling period of RTT, i.e. Spark heartbeat interval
+const std::chrono::milliseconds kSamplePeriod{20};
+
+/**
+ * RTT samples in microseconds around a stable mean, one per sample period
+ */
+std::vector<int64_t>
+getRttSamples() {
+  std::vector<int64_t> samples;
+  samples.reserve(kNumSamples);
+  for (uint32_t i = 0; i < kNumSamples; ++i) {
+    samples.emplace_back(1000 + folly::Random::rand32(100));
+  }
+  return samples;
+}
+
+} // namespace
+
+namespace openr {
+
+/**
+ * Benchmark for StepDetector::addValue() with default config, as used by
+ * Spark for RTT of every neighbor
+ */
+static void
+BM_StepDetectorAddValue(uint32_t iters) {
+  auto suspender = folly::BenchmarkSuspender();
+  const auto samples = getRttSamples();
+  suspender.dismiss(); // Start measuring benchmark time
+
+  for (uint32_t i = 0; i < iters; ++i) {
+    StepDetector<int64_t, std::chrono::milliseconds> stepDetector(
+        thrift::StepDetectorConfig(), kSamplePeriod, [](const int64_t&) {});
+    std::chrono::milliseconds now{0};
+    for (auto const& sample : samples) {
+      stepDetector.addValue(now, sample);
+      now += kSamplePeriod;
+    }
+  }
+}
+
+/**
+ * Baseline of BM_StepDetectorAddValue, i.e. adding the same samples to fast
+ * and slow folly::BucketedTimeSeries windows and getting their averages, as
+ * StepDetector used to
+ */
+static void
+BM_StepDetectorAddValueBucketedTimeSeries(uint32_t iters) {
+  auto suspender = folly::BenchmarkSuspender();
+  const auto samples = getRttSamples();
+  const thrift::StepDetectorConfig config;
+  const auto fastWndSize = *config.fast_window_size_ref();
+  const auto slowWndSize = *config.slow_window_size_ref();
+  using TimeSeries = folly::BucketedTimeSeries<
+      int64_t,
+      folly::LegacyStatsClock<std::chrono::milliseconds>>;
+  suspender.dismiss(); // Start measuring benchmark time
+
+  for (uint32_t i = 0; i < iters; ++i) {
+    TimeSeries fastWindow(fastWndSize, kSamplePeriod * fastWndSize);
+    TimeSeries slowWindow(slowWndSize, kSamplePeriod * slowWndSize);
+    std::chrono::milliseconds now{0};
+    for (auto const& sample : samples) {
+      fastWindow.addValue(now, sample);
+      slowWindow.addValue(now, sample);
+      folly::doNotOptimizeAway(fastWindow.avg());
+      folly::doNotOptimizeAway(slowWindow.avg());
+      now += kSamplePeriod;
+    }
+  }
+}
+
+BENCHMARK(BM_StepDetectorAddValueBucketedTimeSeries);
+BENCHMARK_RELATIVE(BM_StepDetectorAddValue);
+
+} // namespace openr
+
+int
+main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
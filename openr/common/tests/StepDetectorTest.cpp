@@ -178,6 +178,35 @@ TEST(StepDetectorTest, SlowBoiling) {
   }
 }
 
+// values older than slow window are rejected, and windows slide by time of
+// values even if samples are missing
+TEST(StepDetectorTest, SlidingWindows) {
+  std::vector<double> steps;
+  openr::StepDetector<double, std::chrono::seconds> stepDetector(
+      getTestConfig(),
+      std::chrono::seconds(1) /* sampling period */,
+      [&](const double& avg) { steps.emplace_back(avg); });
+
+  uint32_t timeStamp = 100;
+  for (int i = 0; i < 50; ++i) {
+    EXPECT_TRUE(stepDetector.addValue(std::chrono::seconds(timeStamp++), 100));
+  }
+  EXPECT_FALSE(stepDetector.addValue(
+      std::chrono::seconds(timeStamp - SLOW_WINDOW_SIZE - 1), 100));
+  EXPECT_TRUE(stepDetector.addValue(
+      std::chrono::seconds(timeStamp - SLOW_WINDOW_SIZE + 1), 100));
+  EXPECT_TRUE(steps.empty());
+
+  // after silence longer than slow window, only new values are averaged
+  // and differ from the last reported average by more than abs threshold
+  timeStamp += 2 * SLOW_WINDOW_SIZE;
+  for (int i = 0; i < 50; ++i) {
+    EXPECT_TRUE(stepDetector.addValue(std::chrono::seconds(timeStamp++), 200));
+  }
+  ASSERT_EQ(1, steps.size());
+  EXPECT_EQ(200, steps.back());
+}
+
 int
 main(int argc, char* argv[]) {
   // Parse command line flags
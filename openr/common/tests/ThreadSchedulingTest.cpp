@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <sched.h>
+
+#include <thread>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <openr/common/ThreadScheduling.h>
+
+using namespace openr;
+
+TEST(ThreadSchedulingTest, ParseCpuList) {
+  EXPECT_EQ(std::vector<int>{}, ThreadScheduling::parseCpuList(""));
+  EXPECT_EQ(std::vector<int>{3}, ThreadScheduling::parseCpuList("3"));
+  EXPECT_EQ(
+      std::vector<int>({0, 1, 2, 3, 8, 10, 11}),
+      ThreadScheduling::parseCpuList("0-3,8,10-11"));
+
+  EXPECT_FALSE(ThreadScheduling::parseCpuList("3-1").has_value());
+  EXPECT_FALSE(ThreadScheduling::parseCpuList("a").has_value());
+  EXPECT_FALSE(ThreadScheduling::parseCpuList("1,,2").has_value());
+  EXPECT_FALSE(ThreadScheduling::parseCpuList("-1").has_value());
+}
+
+/**
+ * Pin a thread to one of the CPUs it may currently run on
+ */
+TEST(ThreadSchedulingTest, ApplyAffinity) {
+  std::thread([]() {
+    cpu_set_t allowed;
+    ASSERT_EQ(0, sched_getaffinity(0, sizeof(allowed), &allowed));
+    int cpu = 0;
+    while (not CPU_ISSET(cpu, &allowed)) {
+      ++cpu;
+    }
+
+    thrift::ThreadSchedulingConfig config;
+    config.cpus_ref() = {cpu};
+    EXPECT_TRUE(ThreadScheduling::apply("test", config));
+
+    cpu_set_t pinned;
+    ASSERT_EQ(0, sched_getaffinity(0, sizeof(pinned), &pinned));
+    EXPECT_EQ(1, CPU_COUNT(&pinned));
+    EXPECT_TRUE(CPU_ISSET(cpu, &pinned));
+  }).join();
+}
+
+/**
+ * Failed settings are reported, e.g. CPU of a NUMA node which doesn't exist
+ */
+TEST(ThreadSchedulingTest, ApplyFailure) {
+  std::thread([]() {
+    thrift::ThreadSchedulingConfig config;
+    config.numa_node_ref() = 100000;
+    EXPECT_FALSE(ThreadScheduling::apply("test", config));
+  }).join();
+}
+
+int
+main(int argc, char* argv[]) {
+  // Parse command line flags
+  testing::InitGoogleTest(&argc, argv);
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+  google::InstallFailureSignalHandler();
+
+  // Run the tests
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/Format.h>
+#include <folly/init/Init.h>
+
+#include <openr/common/Types.h>
+
+namespace {
+
+// Number of prefix keys parsed per iteration
+const uint32_t kNumKeys = 1000;
+
+/**
+ * Prefix keys of v1 or v2 format, of distinct v6 prefixes
+ */
+std::vector<std::string>
+getPrefixKeys(bool isPrefixKeyV2) {
+  std::vector<std::string> keys;
+  keys.reserve(kNumKeys);
+  for (uint32_t i = 0; i < kNumKeys; ++i) {
+    const auto prefix =
+        folly::IPAddress::createNetwork(folly::sformat("fc00:{:x}::/64", i));
+    openr::PrefixKey prefixKey(
+        folly::sformat("node-{}", i), prefix, "area-1", isPrefixKeyV2);
+    keys.emplace_back(
+        isPrefixKeyV2 ? prefixKey.getPrefixKeyV2() : prefixKey.getPrefixKey());
+  }
+  return keys;
+}
+
+// Typical area config patterns, i.e. interface names and prefixes
+const std::vector<std::string> kIfacePatterns{
+    "po1", "po2", "po3", "po4", "eth0$", "fboss.*", "^lo.*", "vlan.*"};
+
+/**
+ * Interface names, half of which match `kIfacePatterns`
+ */
+std::vector<std::string>
+getIfaceNames() {
+  std::vector<std::string> names;
+  names.reserve(kNumKeys);
+  for (uint32_t i = 0; i < kNumKeys; ++i) {
+    names.emplace_back(
+        i % 2 ? folly::sformat("fboss{}", i) : folly::sformat("Ethernet{}", i));
+  }
+  return names;
+}
+
+} // namespace
+
+namespace openr {
+
+/**
+ * Benchmark for PrefixKey::fromStr() on well-formed keys
+ */
+static void
+BM_PrefixKeyFromStr(uint32_t iters, bool isPrefixKeyV2) {
+  auto suspender = folly::BenchmarkSuspender();
+  const auto keys = getPrefixKeys(isPrefixKeyV2);
+  suspender.dismiss(); // Start measuring benchmark time
+
+  for (uint32_t i = 0; i < iters; ++i) {
+    for (auto const& key : keys) {
+      auto prefixKey = PrefixKey::fromStr(key, "area-1");
+      folly::doNotOptimizeAway(prefixKey);
+    }
+  }
+}
+
+/**
+ * Baseline of BM_PrefixKeyFromStr, i.e. parsing the same keys with regex
+ */
+static void
+BM_PrefixKeyFromStrRegex(uint32_t iters, bool isPrefixKeyV2) {
+  auto suspender = folly::BenchmarkSuspender();
+  const auto keys = getPrefixKeys(isPrefixKeyV2);
+  suspender.dismiss(); // Start measuring benchmark time
+
+  for (uint32_t i = 0; i < iters; ++i) {
+    for (auto const& key : keys) {
+      int plen{0};
+      std::string node, area, ipStr;
+      bool matched = RE2::FullMatch(
+          key, PrefixKey::getPrefixRE2(), &node, &area, &ipStr, &plen);
+      if (not matched) {
+        matched = RE2::FullMatch(
+            key, PrefixKey::getPrefixRE2V2(), &node, &ipStr, &plen);
+      }
+      CHECK(matched);
+      auto network =
+          folly::IPAddress::createNetwork(folly::sformat("{}/{}", ipStr, plen));
+      folly::doNotOptimizeAway(network);
+    }
+  }
+}
+
+/**
+ * Benchmark for RegexSet::match() on area config patterns, served without RE2
+ */
+static void
+BM_RegexSetMatch(uint32_t iters) {
+  auto suspender = folly::BenchmarkSuspender();
+  const auto names = getIfaceNames();
+  const RegexSet regexSet(
+      kIfacePatterns, true /* anchorEnd */, false /* caseSensitive */);
+  suspender.dismiss(); // Start measuring benchmark time
+
+  for (uint32_t i = 0; i < iters; ++i) {
+    for (auto const& name : names) {
+      folly::doNotOptimizeAway(regexSet.match(name));
+    }
+  }
+}
+
+/**
+ * Baseline of BM_RegexSetMatch, i.e. matching the same names with RE2 set
+ */
+static void
+BM_RegexSetMatchRE2(uint32_t iters) {
+  auto suspender = folly::BenchmarkSuspender();
+  const auto names = getIfaceNames();
+  re2::RE2::Options options;
+  options.set_case_sensitive(false);
+  re2::RE2::Set re2Set(options, re2::RE2::ANCHOR_BOTH);
+  for (auto const& pattern : kIfacePatterns) {
+    CHECK_LE(0, re2Set.Add(pattern, nullptr));
+  }
+  CHECK(re2Set.Compile());
+  suspender.dismiss(); // Start measuring benchmark time
+
+  for (uint32_t i = 0; i < iters; ++i) {
+    for (auto const& name : names) {
+      folly::doNotOptimizeAway(re2Set.Match(name, nullptr));
+    }
+  }
+}
+
+BENCHMARK(BM_RegexSetMatchRE2);
+BENCHMARK_RELATIVE(BM_RegexSetMatch);
+
+// The parameter is whether keys are of v2 format
+BENCHMARK_NAMED_PARAM(BM_PrefixKeyFromStrRegex, v1, false);
+BENCHMARK_RELATIVE_NAMED_PARAM(BM_PrefixKeyFromStr, v1, false);
+BENCHMARK_NAMED_PARAM(BM_PrefixKeyFromStrRegex, v2, true);
+BENCHMARK_RELATIVE_NAMED_PARAM(BM_PrefixKeyFromStr, v2, true);
+
+} // namespace openr
+
+int
+main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -6,6 +6,7 @@
  */
 
 #include <glog/logging.h>
+#include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 #include <openr/common/Types.h>
@@ -118,6 +119,214 @@ TEST(TypesTest, fromStrTest) {
   }
 }
 
+//
+// Keys parsed without regex must match the outcome of regex of its format
+//
+TEST(TypesTest, fromStrMatchesRegexTest) {
+  const std::string area{"area"};
+  const std::vector<std::string> keys = {
+      "prefix:node-1:area_1:[10.0.0.0/8]",
+      "prefix:node.1:[fc00::/64]",
+      "prefix:node:[10.1.2.3/8]", // host bits
+      "prefix:node:[10.0.0.0/008]",
+      "prefix:node:[::ffff:10.0.0.1/128]",
+      "prefix:node:[10.0.0.0/33]", // prefix length out of range
+      "prefix:node:[10.0.0.0/1234]",
+      "prefix:node:[10.0.0.0/]",
+      "prefix:node:[/8]",
+      "prefix:node:[10.0.0.0]",
+      "prefix:node:[10.0.0.0/8",
+      "prefix:node:[10.0.0.0/8]:",
+      "prefix:node:area:[10.0.0.0/8]x",
+      "prefix:node:[10.0.0.0/8]]",
+      "prefix:node:[10.0.0.0/8/8]",
+      "prefix:node:[g::/64]",
+      "prefix:node:[1.1.]",
+      "prefix::[10.0.0.0/8]",
+      "prefix:node::[10.0.0.0/8]",
+      "prefix:node:area:area:[10.0.0.0/8]",
+      "prefix:no de:[10.0.0.0/8]",
+      "prefix:node",
+      "prefix:",
+      "adj:node:[10.0.0.0/8]",
+      "",
+  };
+
+  for (auto const& key : keys) {
+    SCOPED_TRACE(key);
+    std::string node, keyArea, ipStr;
+    int plen{0};
+    bool isV2{false};
+    bool matched = RE2::FullMatch(
+        key, PrefixKey::getPrefixRE2(), &node, &keyArea, &ipStr, &plen);
+    if (not matched) {
+      isV2 = matched = RE2::FullMatch(
+          key, PrefixKey::getPrefixRE2V2(), &node, &ipStr, &plen);
+    }
+    // format is told by regex only, regardless of IP network
+    EXPECT_EQ(isV2, PrefixKey::isPrefixKeyV2Str(key));
+    auto network = folly::IPAddress::tryCreateNetwork(
+        fmt::format("{}/{}", ipStr, plen));
+    matched &= network.hasValue();
+
+    auto maybePrefixKey = PrefixKey::fromStr(key, area);
+    ASSERT_EQ(matched, maybePrefixKey.hasValue());
+    if (not matched) {
+      continue;
+    }
+    EXPECT_EQ(node, maybePrefixKey->getNodeName());
+    EXPECT_EQ(isV2 ? area : keyArea, maybePrefixKey->getPrefixArea());
+    EXPECT_EQ(network.value(), maybePrefixKey->getCIDRNetwork());
+  }
+}
+
+//
+// Compact format of prefix key encodes prefix bytes, and rejects any
+// non-canonical encoding
+//
+TEST(TypesTest, compactPrefixKeyTest) {
+  const std::string area{"area"};
+
+  // [family, plen, prefix bytes] in base64url
+  EXPECT_EQ(
+      "prefix:node-1:~BAgK",
+      PrefixKey("node-1", folly::IPAddress::createNetwork("10.0.0.0/8"), area)
+          .getPrefixKeyCompact());
+  EXPECT_EQ(
+      "prefix:node-1:~BkD8AAAAAAAAAA",
+      PrefixKey("node-1", folly::IPAddress::createNetwork("fc00::/64"), area)
+          .getPrefixKeyCompact());
+
+  for (auto const& prefix :
+       {"0.0.0.0/0",
+        "10.0.0.0/8",
+        "10.1.2.0/23",
+        "1.1.1.1/32",
+        "::/0",
+        "fc00::/7",
+        "fc00:1:2:3::/64",
+        "fc00::1/128"}) {
+    SCOPED_TRACE(prefix);
+    const auto network = folly::IPAddress::createNetwork(prefix);
+    const auto key = PrefixKey("node-1", network, area).getPrefixKeyCompact();
+    EXPECT_TRUE(PrefixKey::isPrefixKeyCompactStr(key));
+    EXPECT_FALSE(PrefixKey::isPrefixKeyV2Str(key));
+
+    auto maybePrefixKey = PrefixKey::fromStr(key, area);
+    ASSERT_TRUE(maybePrefixKey.hasValue());
+    EXPECT_EQ("node-1", maybePrefixKey->getNodeName());
+    EXPECT_EQ(area, maybePrefixKey->getPrefixArea());
+    EXPECT_EQ(network, maybePrefixKey->getCIDRNetwork());
+    EXPECT_TRUE(maybePrefixKey->isPrefixKeyCompact());
+    EXPECT_FALSE(maybePrefixKey->isPrefixKeyV2());
+    EXPECT_EQ(key, maybePrefixKey->getPrefixKeyCompact());
+  }
+
+  // v1 and v2 format keys are not compact
+  EXPECT_FALSE(PrefixKey::isPrefixKeyCompactStr("prefix:node:[10.0.0.0/8]"));
+  EXPECT_FALSE(
+      PrefixKey::isPrefixKeyCompactStr("prefix:node:area:[10.0.0.0/8]"));
+
+  for (auto const& key : {
+           "prefix:node:~", // empty
+           "prefix:node:~BAB", // non-zero trailing bits
+           "prefix:node:~BCE", // prefix length out of range
+           "prefix:node:~BAcL", // host bits set
+           "prefix:node:~BQgK", // unknown family
+           "prefix:node:~BAgKAA", // extra bytes
+           "prefix:node:~BAg", // missing bytes
+           "prefix:node:~BAgK=", // padding
+           "prefix:node:~BAg+", // non base64url character
+           "prefix::~BAgK", // empty node
+       }) {
+    SCOPED_TRACE(key);
+    EXPECT_FALSE(PrefixKey::isPrefixKeyCompactStr(key));
+    EXPECT_TRUE(PrefixKey::fromStr(key, area).hasError());
+  }
+}
+
+/**
+ * Verify RegexSet, serving literal patterns without RE2, matches the same keys
+ * as RE2 set of all patterns, with or without end anchor and case folding
+ */
+TEST(TypesTest, RegexSetMatchesRE2Test) {
+  const std::vector<std::string> patterns{
+      "po1",
+      "^eth.*",
+      "lo$",
+      "fsw\\.001.*$",
+      "ssw-[0-9]+",
+      "^$",
+      "node\\$",
+      "Te.*1",
+  };
+  const std::vector<std::string> keys{
+      "", "po1", "po10", "PO1", "eth", "eth0", "ETH0", "xeth0", "lo", "lo0",
+      "fsw.001", "fsw.001.c01", "fswx001", "FSW.001", "fsw.001\nx", "ssw-12",
+      "ssw-", "node$", "node", "te1", "Test1", "te12",
+  };
+
+  for (bool anchorEnd : {false, true}) {
+    for (bool caseSensitive : {false, true}) {
+      RegexSet regexSet(patterns, anchorEnd, caseSensitive);
+
+      re2::RE2::Options options;
+      options.set_case_sensitive(caseSensitive);
+      re2::RE2::Set re2Set(
+          options,
+          anchorEnd ? re2::RE2::ANCHOR_BOTH : re2::RE2::ANCHOR_START);
+      for (auto const& pattern : patterns) {
+        ASSERT_LE(0, re2Set.Add(pattern, nullptr));
+      }
+      ASSERT_TRUE(re2Set.Compile());
+
+      for (auto const& key : keys) {
+        SCOPED_TRACE(fmt::format(
+            "key: {}, anchorEnd: {}, caseSensitive: {}",
+            key,
+            anchorEnd,
+            caseSensitive));
+        EXPECT_EQ(re2Set.Match(key, nullptr), regexSet.match(key));
+      }
+    }
+  }
+
+  // literal prefixes with anchor and wildcard still allow key ranges
+  RegexSet prefixSet(std::vector<std::string>{"^adj:", "prefix:.*"});
+  EXPECT_TRUE(prefixSet.isLiteralOnly());
+  EXPECT_EQ(
+      std::vector<std::string>({"adj:", "prefix:"}),
+      prefixSet.getLiteralPrefixes());
+  EXPECT_FALSE(RegexSet(std::vector<std::string>{"adj:$"}).isLiteralOnly());
+
+  // empty set matches nothing, malformed regex throws
+  EXPECT_FALSE(RegexSet(std::vector<std::string>{}).match("po1"));
+  EXPECT_THROW(
+      RegexSet(std::vector<std::string>{"[0-9]++"}), std::invalid_argument);
+  EXPECT_THROW(
+      RegexSet(std::vector<std::string>{"boom\\"}), std::invalid_argument);
+}
+
+TEST(TypesTest, InterfaceUpdateApplyTest) {
+  const InterfaceInfo eth0("eth0", true, 1, {});
+  const InterfaceInfo eth1("eth1", true, 2, {});
+  const InterfaceInfo eth1Down("eth1", false, 2, {});
+  const InterfaceInfo eth2("eth2", true, 3, {});
+
+  // Full snapshot replaces existing interfaces
+  InterfaceDatabase ifDb{eth2};
+  InterfaceUpdate(InterfaceDatabase{eth0, eth1}).applyTo(ifDb);
+  EXPECT_THAT(ifDb, testing::UnorderedElementsAre(eth0, eth1));
+
+  // Changes only touch changed and removed interfaces
+  InterfaceUpdate update;
+  update.isFullSync = false;
+  update.interfaces = {eth1Down, eth2};
+  update.removedIfNames = {"eth0"};
+  update.applyTo(ifDb);
+  EXPECT_THAT(ifDb, testing::UnorderedElementsAre(eth1Down, eth2));
+}
+
 int
 main(int argc, char* argv[]) {
   // Parse command line flags
@@ -7,6 +7,7 @@
 
 #include <stdlib.h>
 #include <memory>
+#include <thread>
 #include <utility>
 
 #include <folly/Random.h>
@@ -200,6 +201,46 @@ TEST(UtilTest, NetworkUtilTest) {
     EXPECT_THROW(toIPNetwork(v6Prefix), thrift::OpenrError);
   }
 
+  //
+  // Test for: tryToIPNetwork(), toIPNetworks()
+  //
+  {
+    // Mask applied unless asked not to
+    const auto v6Prefix = createIpPrefix(
+        toBinaryAddress(folly::IPAddress("2620::1:1")), 112);
+    EXPECT_EQ(
+        folly::IPAddress::createNetwork("2620::1:0/112"),
+        tryToIPNetwork(v6Prefix));
+    EXPECT_EQ(
+        folly::IPAddress::createNetwork("2620::1:1/112", -1, false),
+        tryToIPNetwork(v6Prefix, false));
+    EXPECT_EQ(
+        folly::IPAddress::createNetwork("10.1.1.0/24"),
+        tryToIPNetwork(toIpPrefix("10.1.1.0/24")));
+
+    // Invalid prefix length or address bytes
+    auto invalidLen = createIpPrefix(
+        toBinaryAddress(folly::IPAddress("10.1.1.1")), 33);
+    thrift::BinaryAddress invalidAddr;
+    invalidAddr.addr_ref() = "abc";
+    EXPECT_FALSE(tryToIPNetwork(invalidLen).has_value());
+    EXPECT_FALSE(tryToIPNetwork(createIpPrefix(invalidAddr, 8)).has_value());
+    EXPECT_FALSE(tryToIPAddress(invalidAddr).has_value());
+    EXPECT_THROW(
+        toIPNetwork(createIpPrefix(invalidAddr, 8)), thrift::OpenrError);
+
+    // Bulk conversion skips invalid prefixes
+    size_t numInvalid{0};
+    auto networks = toIPNetworks(
+        std::vector<thrift::IpPrefix>{v6Prefix, invalidLen}, &numInvalid);
+    EXPECT_EQ(1, numInvalid);
+    ASSERT_EQ(1, networks.size());
+    EXPECT_EQ(v6Prefix.get_prefixLength(), networks.front().second);
+    EXPECT_EQ(
+        std::vector<thrift::IpPrefix>{toIpPrefix("2620::1:0/112")},
+        toIpPrefixes(networks));
+  }
+
   //
   // Test for: createIpPrefix()
   //
@@ -374,6 +415,29 @@ TEST(UtilTest, GetNodeNameFromKeyTest) {
   }
 }
 
+TEST(UtilTest, PrefixDbBucketKeyTest) {
+  const auto key = getPrefixDbBucketKey("node.1", 12);
+  EXPECT_EQ("prefix:node.1:#12", key);
+  EXPECT_EQ("node.1", getNodeNameFromKey(key));
+  EXPECT_EQ(12, getPrefixDbBucketFromKey(key).value_or(0));
+  EXPECT_TRUE(isPrefixDbBucketKey(key));
+
+  // prefix keys of all formats
+  const PrefixKey prefixKey(
+      "node.1", folly::IPAddress::createNetwork("10.0.0.0/8"), "area");
+  EXPECT_FALSE(isPrefixDbBucketKey(prefixKey.getPrefixKey()));
+  EXPECT_FALSE(isPrefixDbBucketKey(prefixKey.getPrefixKeyV2()));
+  EXPECT_FALSE(isPrefixDbBucketKey(prefixKey.getPrefixKeyCompact()));
+  EXPECT_FALSE(isPrefixDbBucketKey("prefix:node.1:#"));
+  EXPECT_FALSE(isPrefixDbBucketKey("adj:node.1:#1"));
+
+  // bucket is in range and same for same prefix
+  const auto prefix = folly::IPAddress::createNetwork("fc00::/64");
+  EXPECT_LT(getPrefixDbBucket(prefix, 8), 8u);
+  EXPECT_EQ(getPrefixDbBucket(prefix, 8), getPrefixDbBucket(prefix, 8));
+  EXPECT_EQ(0, getPrefixDbBucket(prefix, 1));
+}
+
 // test getNthPrefix()
 TEST(UtilTest, getNthPrefix) {
   // v6 allocation parameters
@@ -1158,6 +1222,47 @@ TEST(UtilTest, SelectRoutesPerAreaShortestDistance) {
   }
 }
 
+/**
+ * Anycast prefix advertised by many nodes sharing few distinct entries,
+ * across two areas
+ */
+TEST(UtilTest, SelectRoutesAnycast) {
+  const auto preferred = createPrefixEntryPtr(200, 10, 2);
+  const auto nearest = createPrefixEntryPtr(200, 10, 1);
+  const auto farthest = createPrefixEntryPtr(200, 10, 3);
+  const auto nonPreferred = createPrefixEntryPtr(100, 10, 0);
+  PrefixEntries prefixes;
+  for (int i = 0; i < 1000; ++i) {
+    prefixes.emplace(
+        NodeAndArea{fmt::format("node{}", i), "area1"},
+        i % 2 ? preferred : nonPreferred);
+    prefixes.emplace(
+        NodeAndArea{fmt::format("node{}", i), "area2"},
+        i % 10 ? farthest : preferred);
+  }
+  prefixes[{"node1", "area1"}] = nearest;
+
+  const auto ret = selectRoutes(
+      prefixes, thrift::RouteSelectionAlgorithm::SHORTEST_DISTANCE);
+  EXPECT_EQ(1, ret.size());
+  EXPECT_EQ(1, ret.count({"node1", "area1"}));
+
+  // nearest and all advertising preferred entry
+  const auto ksp2Ret = selectRoutes(
+      prefixes, thrift::RouteSelectionAlgorithm::K_SHORTEST_DISTANCE_2);
+  EXPECT_EQ(1 + 499 + 100, ksp2Ret.size());
+  EXPECT_EQ(1, ksp2Ret.count({"node1", "area1"}));
+  EXPECT_EQ(1, ksp2Ret.count({"node0", "area2"}));
+  EXPECT_EQ(0, ksp2Ret.count({"node1", "area2"}));
+
+  // nearest in area1, all advertising preferred entry in area2
+  const auto perAreaRet = selectRoutes(
+      prefixes, thrift::RouteSelectionAlgorithm::PER_AREA_SHORTEST_DISTANCE);
+  EXPECT_EQ(1 + 100, perAreaRet.size());
+  EXPECT_EQ(1, perAreaRet.count({"node1", "area1"}));
+  EXPECT_EQ(1, perAreaRet.count({"node10", "area2"}));
+}
+
 TEST(UtilTest, SelectBestNodeAreaTest) {
   // Topology
   // Area A: node1-node2
@@ -1318,6 +1423,76 @@ TEST(UtilTest, ThriftValueConstruction) {
   EXPECT_EQ(thriftVal.hash_ref().value(), hash);
 }
 
+/**
+ * Verify buffered serialization matches plain one across calls of growing and
+ * shrinking sizes, i.e. reused buffer never leaks previous content
+ */
+TEST(UtilTest, WriteThriftObjStrBuffered) {
+  apache::thrift::CompactSerializer serializer;
+  for (auto numAdjs : {1, 1000, 10, 0, 100}) {
+    thrift::AdjacencyDatabase adjDb;
+    adjDb.thisNodeName_ref() = "node1";
+    for (int i = 0; i < numAdjs; ++i) {
+      thrift::Adjacency adj;
+      adj.otherNodeName_ref() = fmt::format("node{}", i);
+      adj.ifName_ref() = fmt::format("iface{}", i);
+      adjDb.adjacencies_ref()->emplace_back(std::move(adj));
+    }
+    EXPECT_EQ(
+        writeThriftObjStr(adjDb, serializer),
+        writeThriftObjStrBuffered(adjDb, serializer));
+  }
+}
+
+/**
+ * Verify v2 value hash is deterministic, covers every field and is told apart
+ * from legacy hash by its top byte
+ */
+TEST(UtilTest, ValueHashV2) {
+  const std::optional<std::string> value{"test data"};
+  const auto legacyHash = generateHash(1, "node1", value);
+
+  setValueHashVersion(Constants::kValueHashVersionV2);
+  const auto hash = generateHash(1, "node1", value);
+  EXPECT_EQ(hash, generateHash(1, "node1", value));
+  EXPECT_NE(hash, legacyHash);
+  EXPECT_EQ(
+      Constants::kValueHashVersionV2, static_cast<uint64_t>(hash) >> 56);
+
+  EXPECT_NE(hash, generateHash(2, "node1", value));
+  EXPECT_NE(hash, generateHash(1, "node2", value));
+  EXPECT_NE(hash, generateHash(1, "node1", std::string("test date")));
+  EXPECT_NE(hash, generateHash(1, "node1", std::nullopt));
+
+  setValueHashVersion(Constants::kValueHashVersionLegacy);
+  EXPECT_EQ(legacyHash, generateHash(1, "node1", value));
+}
+
+/**
+ * Verify allocations of a thread bound to dedicated arena are accounted to it
+ */
+TEST(UtilTest, DedicatedArena) {
+  std::thread([]() {
+    auto arenaIndex = memory::bindThreadToNewArena();
+    if (not arenaIndex.has_value()) {
+      LOG(INFO) << "Not running with jemalloc, skipping";
+      return;
+    }
+
+    memory::refreshMallocStats();
+    auto before = memory::getArenaStats(*arenaIndex);
+    ASSERT_TRUE(before.has_value());
+
+    // large enough to skip thread cache
+    const size_t numBytes = 16 * 1024 * 1024;
+    auto buf = std::make_unique<char[]>(numBytes);
+    memory::refreshMallocStats();
+    auto after = memory::getArenaStats(*arenaIndex);
+    ASSERT_TRUE(after.has_value());
+    EXPECT_LE(before->allocatedBytes + numBytes, after->allocatedBytes);
+  }).join();
+}
+
 int
 main(int argc, char* argv[]) {
   // Parse command line flags
@@ -9,6 +9,7 @@
 
 #include <chrono>
 
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
 #include <folly/FileUtil.h>
 #include <folly/io/IOBuf.h>
 
@@ -17,12 +18,6 @@
 
 using std::exception;
 
-namespace {
-
-static const long kDbFlushRatio = 10000;
-
-} // anonymous namespace
-
 namespace openr {
 
 PersistentStore::PersistentStore(
@@ -38,16 +33,12 @@ PersistentStore::PersistentStore(
             Constants::kPersistentStoreInitialBackoff,
             Constants::kPersistentStoreMaxBackoff);
 
-    saveDbTimer_ = folly::AsyncTimeout::make(*getEvb(), [this]() noexcept {
-      if (savePersistentObjectToDisk()) {
-        saveDbTimerBackoff_->reportSuccess();
-      } else {
-        // Report error and schedule next-try
-        saveDbTimerBackoff_->reportError();
-        saveDbTimer_->scheduleTimeout(
-            saveDbTimerBackoff_->getTimeRemainingUntilRetry());
-      }
-    });
+    saveDbTimer_ = folly::AsyncTimeout::make(
+        *getEvb(), [this]() noexcept { groupCommit(); });
+
+    // Writes are performed in order on a single I/O thread
+    ioExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+        1, std::make_shared<folly::NamedThreadFactory>("PersistentStoreIo"));
   }
 
   // Load initial database. On failure we will just report error and continue
@@ -59,7 +50,27 @@ PersistentStore::PersistentStore(
 }
 
 PersistentStore::~PersistentStore() {
-  saveDatabaseToDisk();
+  // Wait for in-flight write. Rewrite whole database if it has failed.
+  if (ioExecutor_) {
+    ioExecutor_->join();
+    auto failedCallbacks = std::move(*failedCallbacks_.wlock());
+    if (not failedCallbacks.empty()) {
+      logSizeBytes_ = 0;
+      for (auto& callback : failedCallbacks) {
+        pendingCallbacks_.emplace_back(std::move(callback));
+      }
+    }
+  }
+
+  // Flush pending records. Database is written as a whole if log doesn't
+  // exist yet, or in dryrun mode where nothing has been written before.
+  if (dryrun_) {
+    saveDatabaseToDisk();
+  }
+  if (logSizeBytes_ == 0 or not pObjects_.empty() or
+      not pendingCallbacks_.empty()) {
+    savePersistentObjectToDisk();
+  }
 }
 
 folly::SemiFuture<folly::Unit>
@@ -73,11 +84,16 @@ PersistentStore::store(std::string key, std::string value) {
     SYSLOG(INFO) << "Store key: " << key << ", value: " << value
                  << " to config-store";
     // Override previous value if any
+    auto it = findValue(key);
+    if (it != database_.end()) {
+      liveSizeBytes_ -= getRecordSize(key, it->second);
+    }
+    liveSizeBytes_ += getRecordSize(key, value);
     database_.insert_or_assign(key, value);
     auto pObject = toPersistentObject(ActionType::ADD, key, value);
     pObjects_.emplace_back(std::move(pObject));
-    maybeSaveObjectToDisk();
-    p.setValue();
+    // Respond once record is durable
+    maybeSaveObjectToDisk([p = std::move(p)]() mutable { p.setValue(); });
   });
   return sf;
 }
@@ -89,11 +105,15 @@ PersistentStore::erase(std::string key) {
   runInEventBaseThread(
       [this, p = std::move(p), key = std::move(key)]() mutable noexcept {
         SYSLOG(INFO) << "Erase key: " << key << " from config-store";
-        if (database_.erase(key) > 0) {
+        auto it = findValue(key);
+        if (it != database_.end()) {
+          liveSizeBytes_ -= getRecordSize(key, it->second);
+          database_.erase(it);
           auto pObject = toPersistentObject(ActionType::DEL, key, "");
           pObjects_.emplace_back(std::move(pObject));
-          maybeSaveObjectToDisk();
-          p.setValue(true);
+          // Respond once record is durable
+          maybeSaveObjectToDisk(
+              [p = std::move(p)]() mutable { p.setValue(true); });
         } else {
           LOG(WARNING) << "Key: " << key << " doesn't exist";
           p.setValue(false);
@@ -108,7 +128,7 @@ PersistentStore::load(std::string key) {
   auto sf = p.getSemiFuture();
   runInEventBaseThread(
       [this, p = std::move(p), key = std::move(key)]() mutable {
-        auto it = database_.find(key);
+        auto it = findValue(key);
         if (it != database_.end()) {
           p.setValue(it->second);
         } else {
@@ -118,105 +138,232 @@ PersistentStore::load(std::string key) {
   return sf;
 }
 
+std::unordered_map<std::string, std::string>::iterator
+PersistentStore::findValue(const std::string& key) noexcept {
+  auto it = database_.find(key);
+  if (it != database_.end()) {
+    return it;
+  }
+  // Decode value from store file on first access
+  auto mappedIt = mappedDatabase_.find(key);
+  if (mappedIt == mappedDatabase_.end()) {
+    return database_.end();
+  }
+  it = database_.emplace(key, mappedIt->second.str()).first;
+  mappedDatabase_.erase(mappedIt);
+  return it;
+}
+
 void
-PersistentStore::maybeSaveObjectToDisk() noexcept {
+PersistentStore::maybeSaveObjectToDisk(
+    folly::Function<void()> onDurable) noexcept {
+  pendingCallbacks_.emplace_back(std::move(onDurable));
   if (not saveDbTimerBackoff_) {
     // This is primarily used for unit testing to save DB immediately
     // Block the response till file is saved
     savePersistentObjectToDisk();
   } else if (not saveDbTimer_->isScheduled()) {
+    // Group writes within the window into one commit
+    saveDbTimer_->scheduleTimeout(Constants::kPersistentStoreGroupCommitWindow);
+  }
+}
+
+void
+PersistentStore::groupCommit() noexcept {
+  // Previous commit is in-flight. New writes are grouped into next commit.
+  if (writeInFlight_) {
+    saveDbTimer_->scheduleTimeout(Constants::kPersistentStoreGroupCommitWindow);
+    return;
+  }
+
+  // Retry failed commit. Log may be partially written, hence rewrite whole
+  // database.
+  auto failedCallbacks = std::move(*failedCallbacks_.wlock());
+  if (not failedCallbacks.empty()) {
+    saveDbTimerBackoff_->reportError();
+    logSizeBytes_ = 0;
+    for (auto& callback : pendingCallbacks_) {
+      failedCallbacks.emplace_back(std::move(callback));
+    }
+    pendingCallbacks_ = std::move(failedCallbacks);
+  } else {
+    saveDbTimerBackoff_->reportSuccess();
+  }
+
+  if (pendingCallbacks_.empty() and pObjects_.empty()) {
+    return;
+  }
+  if (not saveDbTimerBackoff_->canTryNow()) {
+    saveDbTimer_->scheduleTimeout(
+        saveDbTimerBackoff_->getTimeRemainingUntilRetry());
+    return;
+  }
+
+  auto batch = prepareWriteBatch();
+  if (batch.hasError()) {
+    LOG(ERROR) << "Failed to prepare write of PersistentObjects. Error: "
+               << batch.error();
+    saveDbTimerBackoff_->reportError();
     saveDbTimer_->scheduleTimeout(
         saveDbTimerBackoff_->getTimeRemainingUntilRetry());
+    return;
   }
+
+  // Write and sync on I/O thread. Writers are responded from there once
+  // their records are durable.
+  writeInFlight_ = true;
+  ioExecutor_->add([this, batch = std::move(batch).value()]() mutable {
+    if (not commitWriteBatch(batch)) {
+      auto failedCallbacks = failedCallbacks_.wlock();
+      for (auto& callback : batch.callbacks) {
+        failedCallbacks->emplace_back(std::move(callback));
+      }
+    }
+    writeInFlight_ = false;
+  });
+  // Check result of the commit
+  saveDbTimer_->scheduleTimeout(Constants::kPersistentStoreGroupCommitWindow);
 }
 
 bool
 PersistentStore::savePersistentObjectToDisk() noexcept {
-  if (not dryrun_) {
-    // Write PersistentObject to ioBuf
-    std::vector<PersistentObject> newObjects;
-    newObjects = std::move(pObjects_);
-
-    auto queue = folly::IOBufQueue(folly::IOBufQueue::cacheChainLength());
-
-    for (auto& pObject : newObjects) {
-      auto buf = encodePersistentObject(pObject);
-      if (buf.hasError()) {
-        LOG(ERROR) << "Failed to encode PersistentObject to ioBuf. Error: "
-                   << buf.error();
-        return false;
-      }
-      queue.append(std::move(**buf));
+  auto batch = prepareWriteBatch();
+  if (batch.hasError()) {
+    LOG(ERROR) << "Failed to prepare write of PersistentObjects. Error: "
+               << batch.error();
+    return false;
+  }
+  if (not commitWriteBatch(*batch)) {
+    // Log may be partially written, rewrite whole database next time
+    logSizeBytes_ = 0;
+    for (auto& callback : batch->callbacks) {
+      pendingCallbacks_.emplace_back(std::move(callback));
     }
+    return false;
+  }
+  return true;
+}
+
+folly::Expected<PersistentStore::WriteBatch, std::string>
+PersistentStore::prepareWriteBatch() noexcept {
+  WriteBatch batch;
+  if (dryrun_) {
+    pObjects_.clear();
+    batch.callbacks = std::move(pendingCallbacks_);
+    pendingCallbacks_.clear();
+    return batch;
+  }
 
-    // Append IoBuf to disk
-    auto ioBuf = queue.move();
-    auto success = writeIoBufToDisk(ioBuf, WriteType::APPEND);
+  // Write PersistentObject to ioBuf
+  auto queue = folly::IOBufQueue(folly::IOBufQueue::cacheChainLength());
+  for (auto& pObject : pObjects_) {
+    auto buf = encodePersistentObject(pObject);
+    if (buf.hasError()) {
+      return folly::makeUnexpected(buf.error());
+    }
+    queue.append(std::move(**buf));
+  }
+  batch.ioBuf = queue.move();
+  batch.writeType = WriteType::APPEND;
+  const auto appendSizeBytes =
+      batch.ioBuf ? batch.ioBuf->computeChainDataLength() : 0;
+
+  // Write database as a whole if log doesn't exist yet, or compact the log
+  // once it is mostly made of overridden records
+  const auto logSizeBytes = logSizeBytes_ + appendSizeBytes;
+  if (logSizeBytes_ == 0 or
+      (logSizeBytes > Constants::kPersistentStoreCompactionMinBytes and
+       logSizeBytes >
+           liveSizeBytes_ * Constants::kPersistentStoreCompactionRatio)) {
+    auto ioBuf = encodeDatabase();
+    if (ioBuf.hasError()) {
+      return folly::makeUnexpected(ioBuf.error());
+    }
+    if (logSizeBytes_ != 0) {
+      LOG(INFO) << "Compacting database on disk from " << logSizeBytes
+                << " to " << liveSizeBytes_ << " bytes";
+    }
+    batch.ioBuf = std::move(ioBuf).value();
+    batch.writeType = WriteType::WRITE;
+    logSizeBytes_ = liveSizeBytes_;
+  } else {
+    logSizeBytes_ = logSizeBytes;
+  }
+
+  pObjects_.clear();
+  batch.callbacks = std::move(pendingCallbacks_);
+  pendingCallbacks_.clear();
+  return batch;
+}
+
+bool
+PersistentStore::commitWriteBatch(WriteBatch& batch) noexcept {
+  if (batch.ioBuf) {
+    auto success = writeIoBufToDisk(batch.ioBuf, batch.writeType);
     if (success.hasError()) {
       LOG(ERROR) << "Failed to write PersistentObject to file '"
                  << storageFilePath_ << "'. Error: " << success.error();
       return false;
     }
-
-    numOfNewWritesToDisk_++;
-
-    // Write the whole database to disk periodically
-    if (numOfNewWritesToDisk_ >= kDbFlushRatio) {
-      numOfNewWritesToDisk_ = 0;
-      const auto startTs = std::chrono::steady_clock::now();
-      if (not saveDatabaseToDisk()) {
-        return false;
-      }
-      LOG(INFO) << "Updated database on disk. Took "
-                << std::chrono::duration_cast<std::chrono::milliseconds>(
-                       std::chrono::steady_clock::now() - startTs)
-                       .count()
-                << "ms";
-    }
   } else {
     VLOG(1) << "Skipping writing to disk in dryrun mode";
   }
   numOfWritesToDisk_++;
 
+  // Records are durable
+  for (auto& callback : batch.callbacks) {
+    callback();
+  }
+  batch.callbacks.clear();
   return true;
 }
 
+folly::Expected<std::unique_ptr<folly::IOBuf>, std::string>
+PersistentStore::encodeDatabase() noexcept {
+  // Append kTlvFormatMarker to queue
+  auto queue = folly::IOBufQueue(folly::IOBufQueue::cacheChainLength());
+  queue.append(kTlvFormatMarker.data(), kTlvFormatMarker.size());
+
+  // Encode database_ and append to queue
+  for (auto& keyPair : database_) {
+    PersistentObject pObject;
+    pObject =
+        toPersistentObject(ActionType::ADD, keyPair.first, keyPair.second);
+
+    auto buf = encodePersistentObject(pObject);
+    if (buf.hasError()) {
+      return folly::makeUnexpected(buf.error());
+    }
+    queue.append(std::move(*buf));
+  }
+  // Values not accessed since startup are copied from mapped file
+  for (auto const& [key, value] : mappedDatabase_) {
+    auto buf = encodePersistentObject(
+        toPersistentObject(ActionType::ADD, key, value.str()));
+    if (buf.hasError()) {
+      return folly::makeUnexpected(buf.error());
+    }
+    queue.append(std::move(*buf));
+  }
+  return queue.move();
+}
+
 bool
 PersistentStore::saveDatabaseToDisk() noexcept {
-  std::unique_ptr<folly::IOBuf> ioBuf;
-  // If database is empty, write 'kTlvFormatMarker' to disk and return
-  if (database_.empty()) {
-    ioBuf = folly::IOBuf::copyBuffer(
-        kTlvFormatMarker.data(), kTlvFormatMarker.size());
-  } else {
-    // Append kTlvFormatMarker to queue
-    auto queue = folly::IOBufQueue(folly::IOBufQueue::cacheChainLength());
-    queue.append(kTlvFormatMarker.data(), kTlvFormatMarker.size());
-
-    // Encode database_ and append to queue
-    for (auto& keyPair : database_) {
-      PersistentObject pObject;
-      pObject =
-          toPersistentObject(ActionType::ADD, keyPair.first, keyPair.second);
-
-      auto buf = encodePersistentObject(pObject);
-      if (buf.hasError()) {
-        LOG(ERROR) << "Failed to encode PersistentObject to ioBuf. Error:  "
-                   << buf.error();
-        return false;
-      }
-      queue.append(std::move(*buf));
-    }
-    // Write queue to disk
-    ioBuf = queue.move();
+  auto ioBuf = encodeDatabase();
+  if (ioBuf.hasError()) {
+    LOG(ERROR) << "Failed to encode PersistentObject to ioBuf. Error:  "
+               << ioBuf.error();
+    return false;
   }
 
-  auto success = writeIoBufToDisk(ioBuf, WriteType::WRITE);
+  auto success = writeIoBufToDisk(*ioBuf, WriteType::WRITE);
   if (success.hasError()) {
     LOG(ERROR) << "Failed to write database to file '" << storageFilePath_
                << "'. Error: " << success.error();
     return false;
   }
+  logSizeBytes_ = liveSizeBytes_;
   return true;
 }
 
@@ -229,16 +376,18 @@ PersistentStore::loadDatabaseFromDisk() noexcept {
     return true;
   }
 
-  // Read data from file
-  std::string fileData{""};
-  if (not folly::readFile(storageFilePath_.c_str(), fileData)) {
-    LOG(ERROR) << "Failed to read file contents from '" << storageFilePath_
-               << "'. Error (" << errno << "): " << folly::errnoStr(errno);
+  // Map file instead of reading it. Mapping stays valid after file gets
+  // replaced on compaction, hence it is kept for lifetime of the store.
+  try {
+    mapping_ = std::make_unique<folly::MemoryMapping>(storageFilePath_.c_str());
+  } catch (std::exception const& e) {
+    LOG(ERROR) << "Failed to map file '" << storageFilePath_
+               << "'. Error: " << folly::exceptionStr(e);
     return false;
   }
 
   // Create IoBuf and cursor for loading data from disk (TlvFormat)
-  auto ioBuf = folly::IOBuf::wrapBuffer(fileData.c_str(), fileData.size());
+  auto ioBuf = folly::IOBuf::wrapBuffer(mapping_->range());
   auto tlvSuccess = loadDatabaseTlvFormat(ioBuf);
   if (tlvSuccess.hasError()) {
     LOG(ERROR) << "Failed to read Tlv-format file contents from '"
@@ -251,39 +400,41 @@ PersistentStore::loadDatabaseFromDisk() noexcept {
 folly::Expected<folly::Unit, std::string>
 PersistentStore::loadDatabaseTlvFormat(
     const std::unique_ptr<folly::IOBuf>& ioBuf) noexcept {
-  // Parse ioBuf to persistentObject and then to `database_`
+  // Index records of ioBuf into `mappedDatabase_`. Values are not decoded
+  // but referenced, hence ioBuf must be a single buffer outliving them.
   folly::io::Cursor cursor(ioBuf.get());
-  std::unordered_map<std::string, std::string> newDatabase;
-  // Read 'kTlvFormatMarker'
+  std::unordered_map<std::string, folly::StringPiece> newDatabase;
   try {
+    // Read 'kTlvFormatMarker'
     cursor.readFixedString(kTlvFormatMarker.size());
+
+    // Iteratively read records, same format as decodePersistentObject()
+    while (not cursor.isAtEnd()) {
+      const auto type = ActionType(cursor.readBE<uint8_t>());
+      auto key = cursor.readFixedString(cursor.readBE<uint32_t>());
+      const auto length = cursor.readBE<uint32_t>();
+      folly::StringPiece value(
+          reinterpret_cast<const char*>(cursor.data()), length);
+      cursor.skip(length);
+
+      // Add/Delete record to/from 'newDatabase'
+      if (type == ActionType::ADD) {
+        newDatabase.insert_or_assign(std::move(key), value);
+      } else if (type == ActionType::DEL) {
+        newDatabase.erase(key);
+      }
+    }
   } catch (std::out_of_range& e) {
     return folly::makeUnexpected<std::string>(
         folly::exceptionStr(e).toStdString());
   }
-  // Iteratively read persistentObject from disk
-  while (true) {
-    // Read and decode into persistentObject
-    auto optionalObject = decodePersistentObject(cursor);
-    if (optionalObject.hasError()) {
-      return folly::makeUnexpected(optionalObject.error());
-    }
-
-    // Read finish
-    if (not optionalObject->has_value()) {
-      break;
-    }
-    auto pObject = std::move(optionalObject->value());
-
-    // Add/Delete persistentObject to/from 'newDatabase'
-    if (pObject.type == ActionType::ADD) {
-      newDatabase.insert_or_assign(
-          pObject.key, pObject.data.has_value() ? pObject.data.value() : "");
-    } else if (pObject.type == ActionType::DEL) {
-      newDatabase.erase(pObject.key);
-    }
+  database_.clear();
+  mappedDatabase_ = std::move(newDatabase);
+  liveSizeBytes_ = kTlvFormatMarker.size();
+  for (auto const& [key, value] : mappedDatabase_) {
+    liveSizeBytes_ += getRecordSize(key, value);
   }
-  database_ = std::move(newDatabase);
+  logSizeBytes_ = ioBuf->computeChainDataLength();
   return folly::Unit();
 }
 
@@ -297,20 +448,29 @@ PersistentStore::writeIoBufToDisk(
     fileData = ioBuf->moveToFbString().toStdString();
 
     if (writeType == WriteType::WRITE) {
-      // Write over
+      // Write over (synced). File gets replaced, hence reopen log on next
+      // append.
       folly::writeFileAtomic(storageFilePath_.c_str(), fileData, 0666);
+      logFile_.closeNoThrow();
+      numOfCompactions_++;
     } else {
-      // Append to file
-      folly::writeFile(
-          fileData,
-          storageFilePath_.c_str(),
-          O_WRONLY | O_APPEND | O_CREAT,
-          0666);
+      // Append to file and sync
+      if (not logFile_) {
+        logFile_ = folly::File(
+            storageFilePath_.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0666);
+      }
+      if (folly::writeFull(logFile_.fd(), fileData.data(), fileData.size()) <
+              0 or
+          folly::fdatasyncNoInt(logFile_.fd()) != 0) {
+        logFile_.closeNoThrow();
+        return folly::makeUnexpected<std::string>(folly::errnoStr(errno));
+      }
     }
   } catch (std::exception const& e) {
     return folly::makeUnexpected<std::string>(
         folly::exceptionStr(e).toStdString());
   }
+  numOfBytesWrittenToDisk_ += fileData.size();
   return folly::Unit();
 }
 
@@ -376,6 +536,14 @@ PersistentStore::decodePersistentObject(folly::io::Cursor& cursor) noexcept {
   }
 }
 
+size_t
+PersistentStore::getRecordSize(
+    folly::StringPiece key, folly::StringPiece value) noexcept {
+  // Same as encodePersistentObject()
+  return sizeof(uint8_t) + sizeof(uint32_t) + key.size() + sizeof(uint32_t) +
+      value.size();
+}
+
 // Create a PersistentObject and assign value to it.
 PersistentObject
 PersistentStore::toPersistentObject(
@@ -17,7 +17,11 @@ namespace fs = std::experimental::filesystem;
 #endif
 #include <string>
 
+#include <folly/File.h>
+#include <folly/Synchronized.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/futures/Future.h>
+#include <folly/system/MemoryMapping.h>
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 
 #include <openr/common/Constants.h>
@@ -51,6 +55,16 @@ struct PersistentObject {
  *
  * `storageFilePath`: Describe the path of file in file system where data will
  * be stored/retrieved from (in binary format).
+ *
+ * File is an append-only log of PersistentObject records. Every store/erase
+ * appends a record, and the log is compacted by rewriting live records once
+ * it has grown `kPersistentStoreCompactionRatio` times larger than them.
+ * On startup the log is memory-mapped and only indexed. Values are decoded
+ * on first access.
+ *
+ * Writes within `kPersistentStoreGroupCommitWindow` are grouped into a single
+ * write and sync on a dedicated I/O thread. Futures returned by store/erase
+ * are fulfilled only once the record is durable on disk.
  */
 class PersistentStore : public OpenrEventBase {
  public:
@@ -67,6 +81,16 @@ class PersistentStore : public OpenrEventBase {
     return numOfWritesToDisk_;
   }
 
+  uint64_t
+  getNumOfCompactions() const {
+    return numOfCompactions_;
+  }
+
+  uint64_t
+  getNumOfBytesWrittenToDisk() const {
+    return numOfBytesWrittenToDisk_;
+  }
+
   /**
    * Encode/Decode a PersistentObject, this can be private method, but for unit
    * test, we make it public
@@ -127,12 +151,36 @@ class PersistentStore : public OpenrEventBase {
   folly::Expected<folly::Unit, std::string> loadDatabaseTlvFormat(
       const std::unique_ptr<folly::IOBuf>& ioBuf) noexcept;
 
-  // Wrapper function to save persistent object to disk immediately or later
-  void maybeSaveObjectToDisk() noexcept;
+  // Records and callbacks of writers to be written to disk at once
+  struct WriteBatch {
+    // Unset in dryrun mode
+    std::unique_ptr<folly::IOBuf> ioBuf;
+    WriteType writeType{WriteType::APPEND};
+    std::vector<folly::Function<void()>> callbacks;
+  };
+
+  // Wrapper function to save persistent object to disk immediately or later.
+  // `onDurable` is invoked once the object is written and synced to disk.
+  void maybeSaveObjectToDisk(folly::Function<void()> onDurable) noexcept;
+
+  // Timer callback. Hands pending objects over to I/O thread as one batch.
+  void groupCommit() noexcept;
 
-  // Function to save Persistent Object to local disk.
+  // Function to save Persistent Object to local disk synchronously.
   bool savePersistentObjectToDisk() noexcept;
 
+  // Take pending objects and callbacks. Encodes either the appended records
+  // or, if log doesn't exist yet or has to be compacted, whole database.
+  folly::Expected<WriteBatch, std::string> prepareWriteBatch() noexcept;
+
+  // Write batch to disk and invoke its callbacks on success. Doesn't access
+  // `database_`, hence can be run off the event base.
+  bool commitWriteBatch(WriteBatch& batch) noexcept;
+
+  // Encode `database_` as a whole, including format marker
+  folly::Expected<std::unique_ptr<folly::IOBuf>, std::string>
+  encodeDatabase() noexcept;
+
   // Write IoBuf ro local disk
   folly::Expected<folly::Unit, std::string> writeIoBufToDisk(
       const std::unique_ptr<folly::IOBuf>& ioBuf, WriteType writeType) noexcept;
@@ -141,11 +189,46 @@ class PersistentStore : public OpenrEventBase {
   PersistentObject toPersistentObject(
       const ActionType type, const std::string& key, const std::string& data);
 
+  // Size of encoded ADD record of key-value
+  static size_t getRecordSize(
+      folly::StringPiece key, folly::StringPiece value) noexcept;
+
+  // Find key in `database_`, decoding its value from `mappedDatabase_` if
+  // not accessed yet. Returns `database_.end()` if key doesn't exist.
+  std::unordered_map<std::string, std::string>::iterator findValue(
+      const std::string& key) noexcept;
+
   // Keeps track of number of writes of Database to disk
   std::atomic<std::uint64_t> numOfWritesToDisk_{0};
 
-  // Keeps track of number of writes of PersistentObject to disk
-  std::atomic<std::uint64_t> numOfNewWritesToDisk_{0};
+  // Keeps track of number of compactions of record log on disk
+  std::atomic<std::uint64_t> numOfCompactions_{0};
+
+  // Keeps track of bytes written to disk
+  std::atomic<std::uint64_t> numOfBytesWrittenToDisk_{0};
+
+  // Size of record log on disk, including batches handed over to I/O thread.
+  // Zero if not written yet.
+  size_t logSizeBytes_{0};
+
+  // Size of `database_` once written as a whole
+  size_t liveSizeBytes_{kTlvFormatMarker.size()};
+
+  // Record log opened for appending. Reopened after compaction, as file gets
+  // replaced. Accessed only from I/O thread if any.
+  folly::File logFile_;
+
+  // Single thread performing disk writes and syncs in periodic mode
+  std::unique_ptr<folly::CPUThreadPoolExecutor> ioExecutor_;
+
+  // Batch is being written by I/O thread
+  std::atomic<bool> writeInFlight_{false};
+
+  // Callbacks of objects pending to be written
+  std::vector<folly::Function<void()>> pendingCallbacks_;
+
+  // Callbacks of batches failed on I/O thread, to be retried on event base
+  folly::Synchronized<std::vector<folly::Function<void()>>> failedCallbacks_;
 
   // Location on disk where data will be synced up. A file will be created
   // if doesn't exists.
@@ -163,6 +246,13 @@ class PersistentStore : public OpenrEventBase {
   // layer (disk) in a file.
   std::unordered_map<std::string, std::string> database_;
 
+  // Store file mapped on startup, backing values of `mappedDatabase_`
+  std::unique_ptr<folly::MemoryMapping> mapping_;
+
+  // Values loaded from disk and not accessed yet. A key is present in either
+  // `database_` or here.
+  std::unordered_map<std::string, folly::StringPiece> mappedDatabase_;
+
   // Serializer for encoding/decoding of thrift objects
   apache::thrift::CompactSerializer serializer_;
 
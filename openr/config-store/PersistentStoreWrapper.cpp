@@ -10,13 +10,15 @@
 
 namespace openr {
 
-PersistentStoreWrapper::PersistentStoreWrapper(const unsigned long tid)
+PersistentStoreWrapper::PersistentStoreWrapper(
+    const unsigned long tid, bool periodicallySaveToDisk)
     : filePath(folly::sformat("/tmp/openr_persistent_store_test_{}", tid)) {
   VLOG(1) << "PersistentStoreWrapper: Creating PersistentStore.";
   auto tConfig = getBasicOpenrConfig();
   tConfig.persistent_config_store_path_ref() = filePath;
   auto config = std::make_shared<Config>(tConfig);
-  store_ = std::make_unique<PersistentStore>(config);
+  store_ = std::make_unique<PersistentStore>(
+      config, false /* dryrun */, periodicallySaveToDisk);
 }
 
 void
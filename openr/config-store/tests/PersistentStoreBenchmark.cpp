@@ -5,11 +5,28 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <cstdio>
+
 #include <folly/Benchmark.h>
 #include <folly/Random.h>
 #include <folly/init/Init.h>
 #include <openr/config-store/PersistentStoreWrapper.h>
 
+/*
+ * Like BENCHMARK_PARAM(), but allows a custom name to be specified for each
+ * parameter, and reports counters.
+ */
+#define BENCHMARK_COUNTERS_NAME_PARAM(name, counters, param_name, ...) \
+  BENCHMARK_IMPL_COUNTERS(                                             \
+      FB_CONCATENATE(name, FB_CONCATENATE(_, param_name)),             \
+      FOLLY_PP_STRINGIZE(name) "(" FOLLY_PP_STRINGIZE(param_name) ")", \
+      counters,                                                        \
+      iters,                                                           \
+      unsigned,                                                        \
+      iters) {                                                         \
+    name(counters, iters, ##__VA_ARGS__);                              \
+  }
+
 namespace {
 // kIterations <= n: change this to 10 singce n starts from 10,
 // n is in BENCHMARK_PARAM(BM_PersistentStoreWrite, n)
@@ -32,20 +49,20 @@ constructRandomVector(uint32_t entryInStore) {
 }
 
 /**
- * Write keys with random values to store
+ * Write keys with random values to store. Waits for all writes at once, as
+ * writes are grouped into commits to disk.
  */
 static void
 writeKeyValueToStore(
     const std::vector<std::string>& stringKeys,
     PersistentStoreWrapper& store,
     const uint32_t skipStep) {
+  std::vector<folly::SemiFuture<folly::Unit>> futures;
   for (size_t index = 0; index < stringKeys.size(); index += skipStep) {
-    store
-        ->store(
-            stringKeys[index],
-            folly::sformat("val-{}", folly::Random::rand32()))
-        .get();
+    futures.emplace_back(store->store(
+        stringKeys[index], folly::sformat("val-{}", folly::Random::rand32())));
   }
+  folly::collectAll(std::move(futures)).get();
 }
 
 /**
@@ -54,9 +71,11 @@ writeKeyValueToStore(
 static void
 eraseKeyFromStore(
     const std::vector<std::string>& stringKeys, PersistentStoreWrapper& store) {
+  std::vector<folly::SemiFuture<bool>> futures;
   for (auto stringKey : stringKeys) {
-    store->erase(stringKey).get();
+    futures.emplace_back(store->erase(stringKey));
   }
+  folly::collectAll(std::move(futures)).get();
 }
 
 /**
@@ -92,37 +111,83 @@ BM_PersistentStoreWrite(uint32_t iters, size_t numOfStringKeys) {
 }
 
 /**
- * Benchmark for loading keys from store
- * 1. Generate random keys
- * 2. Write keys to store
- * 3. Load keys from store
- * 4. Erase keys
+ * Benchmark for writing keys to store, with every store written to disk
+ * before it returns. Cost of a store shouldn't depend on number of keys in
+ * store, as it appends a single record to the log on disk.
+ * 1. Write keys to store
+ * 2. Overwrite keys in store, one key per iteration
+ * 3. Report bytes written to disk per store and number of compactions
  */
 void
-BM_PersistentStoreLoad(uint32_t iters, size_t numOfStringKeys) {
+BM_PersistentStoreWriteSync(
+    folly::UserCounters& counters, uint32_t iters, size_t numOfStringKeys) {
   auto suspender = folly::BenchmarkSuspender();
   const auto tid = std::hash<std::thread::id>()(std::this_thread::get_id());
-  // Create new storeWrapper and perform some operations on it
-  auto store = std::make_unique<PersistentStoreWrapper>(tid);
-  store->run();
 
-  // Generate keys
+  // Create storeWrapper writing every store to disk synchronously
+  auto store = std::make_unique<PersistentStoreWrapper>(tid + 2, false);
+  store->run();
   auto stringKeys = constructRandomVector(numOfStringKeys);
   writeKeyValueToStore(stringKeys, *store, 1);
+
+  const auto bytesBefore = (*store)->getNumOfBytesWrittenToDisk();
+  const auto compactionsBefore = (*store)->getNumOfCompactions();
+  suspender.dismiss(); // Start measuring benchmark time
+
+  for (uint32_t i = 0; i < iters; i++) {
+    (*store)
+        ->store(
+            stringKeys[i % stringKeys.size()],
+            folly::sformat("val-{}", folly::Random::rand32()))
+        .get();
+  }
+
+  suspender.rehire(); // Stop measuring time again
+  counters["bytes_per_store"] =
+      ((*store)->getNumOfBytesWrittenToDisk() - bytesBefore) / iters;
+  counters["compactions"] = (*store)->getNumOfCompactions() - compactionsBefore;
+  eraseKeyFromStore(stringKeys, *store);
+}
+
+/**
+ * Benchmark for loading keys from store on startup
+ * 1. Generate random keys
+ * 2. Write keys to store file
+ * 3. Create store from file and load keys from it
+ */
+void
+BM_PersistentStoreLoad(uint32_t iters, size_t numOfStringKeys) {
+  auto suspender = folly::BenchmarkSuspender();
+  const auto tid = std::hash<std::thread::id>()(std::this_thread::get_id());
+  // Create store file with given number of keys
+  auto stringKeys = constructRandomVector(numOfStringKeys);
+  {
+    auto store = std::make_unique<PersistentStoreWrapper>(tid + 3);
+    store->run();
+    writeKeyValueToStore(stringKeys, *store, 1);
+  }
   auto iterations =
       (stringKeys.size() / kIterations == 0) ? stringKeys.size() : kIterations;
 
   suspender.dismiss(); // Start measuring benchmark time
   for (uint32_t i = 0; i < iters; i++) {
+    // Load store file on creation
+    auto store = std::make_unique<PersistentStoreWrapper>(tid + 3);
+    store->run();
+
     // Load value by key from store
     for (size_t index = 0; index < stringKeys.size();
          index += stringKeys.size() / iterations) {
-      (*store)->load(stringKeys[index]);
+      (*store)->load(stringKeys[index]).get();
     }
+
+    suspender.rehire(); // Don't measure stopping the store
+    store.reset();
+    suspender.dismiss();
   }
   suspender.rehire(); // Stop measuring time again
-  // Erase the keys and stop store before exiting
-  eraseKeyFromStore(stringKeys, *store);
+  std::remove(folly::sformat("/tmp/openr_persistent_store_test_{}", tid + 3)
+                  .c_str());
 }
 
 /**
@@ -163,10 +228,18 @@ BENCHMARK_PARAM(BM_PersistentStoreWrite, 100);
 BENCHMARK_PARAM(BM_PersistentStoreWrite, 1000);
 BENCHMARK_PARAM(BM_PersistentStoreWrite, 10000);
 
+BENCHMARK_COUNTERS_NAME_PARAM(BM_PersistentStoreWriteSync, counters, 10, 10);
+BENCHMARK_COUNTERS_NAME_PARAM(BM_PersistentStoreWriteSync, counters, 100, 100);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_PersistentStoreWriteSync, counters, 1000, 1000);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_PersistentStoreWriteSync, counters, 10000, 10000);
+
 BENCHMARK_PARAM(BM_PersistentStoreLoad, 10);
 BENCHMARK_PARAM(BM_PersistentStoreLoad, 100);
 BENCHMARK_PARAM(BM_PersistentStoreLoad, 1000);
 BENCHMARK_PARAM(BM_PersistentStoreLoad, 10000);
+BENCHMARK_PARAM(BM_PersistentStoreLoad, 100000);
 
 BENCHMARK_PARAM(BM_PersistentStoreCreateDestroy, 10);
 BENCHMARK_PARAM(BM_PersistentStoreCreateDestroy, 100);
@@ -5,6 +5,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <cstdio>
 #include <thread>
 #include <utility>
 
@@ -215,6 +216,136 @@ TEST(PersistentStoreTest, BulkStoreLoad) {
   }
 }
 
+TEST(PersistentStoreTest, AppendAndCompact) {
+  const auto tid = std::hash<std::thread::id>()(std::this_thread::get_id());
+  const auto filePath =
+      folly::sformat("/tmp/openr_persistent_store_test_{}", tid + 1);
+  std::remove(filePath.c_str());
+
+  StoreDatabase database;
+  {
+    PersistentStoreWrapper store(tid + 1, false /* periodicallySaveToDisk */);
+    store.run();
+
+    // Log doesn't exist, database is written as a whole
+    store->store("key1", "val1").get();
+    database["key1"] = "val1";
+    EXPECT_EQ(1, store->getNumOfCompactions());
+
+    // Single record is appended
+    const auto bytesWritten = store->getNumOfBytesWrittenToDisk();
+    store->store("key2", "val2").get();
+    database["key2"] = "val2";
+    EXPECT_EQ(bytesWritten + 17, store->getNumOfBytesWrittenToDisk());
+    store->erase("key1").get();
+    database.erase("key1");
+    EXPECT_EQ(bytesWritten + 17 + 13, store->getNumOfBytesWrittenToDisk());
+    EXPECT_EQ(1, store->getNumOfCompactions());
+
+    // Log gets compacted once it has grown beyond 1MB of mostly overridden
+    // records, i.e. on 11th store of 100KB value
+    for (int i = 0; i < 20; ++i) {
+      const std::string largeVal(100 * 1024, 'a' + i);
+      store->store("large", largeVal).get();
+      database["large"] = largeVal;
+    }
+    EXPECT_EQ(2, store->getNumOfCompactions());
+    EXPECT_EQ(database, loadDatabaseFromDisk(filePath));
+  }
+
+  // Log is reloaded
+  {
+    PersistentStoreWrapper store(tid + 1, false /* periodicallySaveToDisk */);
+    store.run();
+    auto responseLoadLarge = store->load("large").get();
+    EXPECT_TRUE(responseLoadLarge);
+    EXPECT_EQ(database["large"], *responseLoadLarge);
+    EXPECT_EQ(0, store->getNumOfCompactions());
+  }
+  EXPECT_EQ(database, loadDatabaseFromDisk(filePath));
+}
+
+/**
+ * Verify store loaded from disk, with values decoded on first access
+ * - Values not accessed yet can be loaded, overridden and erased
+ * - Values not accessed yet are kept on compaction
+ */
+TEST(PersistentStoreTest, LazyLoad) {
+  const auto tid = std::hash<std::thread::id>()(std::this_thread::get_id());
+  const auto filePath =
+      folly::sformat("/tmp/openr_persistent_store_test_{}", tid + 3);
+  std::remove(filePath.c_str());
+
+  StoreDatabase database;
+  {
+    PersistentStoreWrapper store(tid + 3, false /* periodicallySaveToDisk */);
+    store.run();
+    for (int i = 0; i < 10; ++i) {
+      const auto key = folly::sformat("key{}", i);
+      const auto val = folly::sformat("val{}", i);
+      store->store(key, val).get();
+      database[key] = val;
+    }
+    store->erase("key9").get();
+    database.erase("key9");
+  }
+
+  {
+    PersistentStoreWrapper store(tid + 3, false /* periodicallySaveToDisk */);
+    store.run();
+    EXPECT_EQ("val0", store->load("key0").get());
+    EXPECT_EQ(std::nullopt, store->load("key9").get());
+    store->store("key1", "val1-new").get();
+    database["key1"] = "val1-new";
+    EXPECT_TRUE(store->erase("key2").get());
+    database.erase("key2");
+    EXPECT_EQ(database, loadDatabaseFromDisk(filePath));
+
+    // Compact the log, on 5th override of large value, while most values
+    // are not accessed yet
+    for (int i = 0; i < 5; ++i) {
+      const std::string largeVal(1 << 20, 'a' + i);
+      store->store("large", largeVal).get();
+      database["large"] = largeVal;
+    }
+    EXPECT_EQ(1, store->getNumOfCompactions());
+    EXPECT_EQ(database, loadDatabaseFromDisk(filePath));
+    EXPECT_EQ("val3", store->load("key3").get());
+  }
+  EXPECT_EQ(database, loadDatabaseFromDisk(filePath));
+}
+
+/**
+ * Verify group commit in periodic mode
+ * - Concurrent writes are grouped into fewer writes to disk
+ * - Futures are fulfilled only once records are on disk
+ */
+TEST(PersistentStoreTest, GroupCommit) {
+  const auto tid = std::hash<std::thread::id>()(std::this_thread::get_id());
+  const auto filePath =
+      folly::sformat("/tmp/openr_persistent_store_test_{}", tid + 2);
+  std::remove(filePath.c_str());
+
+  PersistentStoreWrapper store(tid + 2);
+  store.run();
+
+  StoreDatabase database;
+  std::vector<folly::SemiFuture<folly::Unit>> futures;
+  for (int i = 0; i < 100; ++i) {
+    const auto key = folly::sformat("key{}", i);
+    const auto val = folly::sformat("val{}", i);
+    futures.emplace_back(store->store(key, val));
+    database[key] = val;
+  }
+  folly::collectAll(std::move(futures)).get();
+  EXPECT_EQ(database, loadDatabaseFromDisk(filePath));
+  EXPECT_GT(100, store->getNumOfDbWritesToDisk());
+
+  EXPECT_TRUE(store->erase("key0").get());
+  database.erase("key0");
+  EXPECT_EQ(database, loadDatabaseFromDisk(filePath));
+}
+
 } // namespace openr
 
 int
@@ -7,11 +7,15 @@
 
 #include <fb303/ServiceData.h>
 #include <folly/FileUtil.h>
+#include <folly/json.h>
 #include <glog/logging.h>
 #include <openr/if/gen-cpp2/Types_constants.h>
 #include <thrift/lib/cpp/util/EnumUtils.h>
 #include <thrift/lib/cpp2/protocol/Serializer.h>
+#include <sched.h>
+#include <set>
 #include <stdexcept>
+#include <unordered_set>
 
 #include <openr/common/Constants.h>
 #include <openr/config/Config.h>
@@ -25,29 +29,12 @@ using openr::thrift::PrefixForwardingType;
 
 namespace openr {
 
-std::shared_ptr<re2::RE2::Set>
+std::shared_ptr<RegexSet>
 AreaConfiguration::compileRegexSet(std::vector<std::string> const& strings) {
-  re2::RE2::Options regexOpts;
-  std::string regexErr;
-  regexOpts.set_case_sensitive(false);
-
-  auto reSet =
-      std::make_shared<re2::RE2::Set>(regexOpts, re2::RE2::ANCHOR_BOTH);
-
-  if (strings.empty()) {
-    // make this regex set unmatchable
-    std::string const unmatchable = "a^";
-    CHECK_NE(-1, reSet->Add(unmatchable, &regexErr)) << fmt::format(
-        "Failed to add regex: {}. Error: {}", unmatchable, regexErr);
-  }
-  for (const auto& str : strings) {
-    if (reSet->Add(str, &regexErr) == -1) {
-      throw std::invalid_argument(
-          fmt::format("Failed to add regex: {}. Error: {}", str, regexErr));
-    }
-  }
-  CHECK(reSet->Compile()) << "Regex compilation failed";
-  return reSet;
+  // empty set is unmatchable. Literal names and prefixes, e.g. `po1` or
+  // `fsw.*`, are matched without going through RE2
+  return std::make_shared<RegexSet>(
+      strings, true /* anchorEnd */, false /* caseSensitive */);
 }
 
 Config::Config(const std::string& configFile) {
@@ -83,6 +70,85 @@ Config::getRunningConfig() const {
   return contents;
 }
 
+ConfigUpdate
+Config::diff(
+    std::shared_ptr<const Config> const& running, Config const& reloaded) {
+  ConfigUpdate update;
+  auto effective = running->getConfig();
+  auto const& next = reloaded.getConfig();
+
+  // area regexes, as long as nothing else of area changes
+  for (auto& area : *effective.areas_ref()) {
+    auto it = std::find_if(
+        next.areas_ref()->begin(),
+        next.areas_ref()->end(),
+        [&area](thrift::AreaConfig const& nextArea) {
+          return *nextArea.area_id_ref() == *area.area_id_ref();
+        });
+    if (it == next.areas_ref()->end() or *it == area) {
+      continue;
+    }
+    auto withNextRegexes = area;
+    withNextRegexes.neighbor_regexes_ref() = *it->neighbor_regexes_ref();
+    withNextRegexes.include_interface_regexes_ref() =
+        *it->include_interface_regexes_ref();
+    withNextRegexes.exclude_interface_regexes_ref() =
+        *it->exclude_interface_regexes_ref();
+    withNextRegexes.redistribute_interface_regexes_ref() =
+        *it->redistribute_interface_regexes_ref();
+    if (withNextRegexes == *it) {
+      area = std::move(withNextRegexes);
+      update.areasWithChangedRegexes.emplace(*area.area_id_ref());
+    }
+  }
+
+  // decision debounce
+  auto& decisionConfig = *effective.decision_config_ref();
+  auto const& nextDecisionConfig = *next.decision_config_ref();
+  if (*decisionConfig.debounce_min_ms_ref() !=
+          *nextDecisionConfig.debounce_min_ms_ref() or
+      *decisionConfig.debounce_max_ms_ref() !=
+          *nextDecisionConfig.debounce_max_ms_ref()) {
+    decisionConfig.debounce_min_ms_ref() =
+        *nextDecisionConfig.debounce_min_ms_ref();
+    decisionConfig.debounce_max_ms_ref() =
+        *nextDecisionConfig.debounce_max_ms_ref();
+    update.decisionDebounceChanged = true;
+  }
+
+  // kvstore flood rate
+  auto& kvStoreConfig = *effective.kvstore_config_ref();
+  auto const& nextFloodRate = next.kvstore_config_ref()->flood_rate_ref();
+  if (not(kvStoreConfig.flood_rate_ref().to_optional() ==
+          nextFloodRate.to_optional())) {
+    kvStoreConfig.flood_rate_ref().from_optional(nextFloodRate.to_optional());
+    update.kvStoreFloodRateChanged = true;
+  }
+
+  update.config = std::make_shared<Config>(effective);
+
+  // what is left is compared field by field to tell which ones need restart
+  if (not(effective == next)) {
+    auto jsonSerializer = apache::thrift::SimpleJSONSerializer();
+    auto const effectiveJson =
+        folly::parseJson(jsonSerializer.serialize<std::string>(effective));
+    auto const nextJson =
+        folly::parseJson(jsonSerializer.serialize<std::string>(next));
+    std::set<std::string> fields;
+    for (auto const& json : {effectiveJson, nextJson}) {
+      for (auto const& key : json.keys()) {
+        fields.emplace(key.asString());
+      }
+    }
+    for (auto const& field : fields) {
+      if (effectiveJson.getDefault(field) != nextJson.getDefault(field)) {
+        update.restartRequiredFields.emplace_back(field);
+      }
+    }
+  }
+  return update;
+}
+
 PrefixAllocationParams
 Config::createPrefixAllocationParams(
     const std::string& seedPfxStr, uint8_t allocationPfxLen) {
@@ -268,9 +334,21 @@ Config::checkKvStoreConfig() {
     }
   }
 
+  if (kvStoreConf.flood_window_size_ref().value_or(0) < 0) {
+    throw std::out_of_range("kvstore flood_window_size should be >= 0");
+  }
+
   if (kvStoreConf.key_ttl_ms_ref() == Constants::kTtlInfinity) {
     throw std::out_of_range("kvstore key_ttl_ms should be a finite number");
   }
+
+  if (const auto& hashVersion = kvStoreConf.value_hash_version_ref()) {
+    if (*hashVersion != Constants::kValueHashVersionLegacy and
+        *hashVersion != Constants::kValueHashVersionV2) {
+      throw std::out_of_range(fmt::format(
+          "kvstore value_hash_version {} is not supported", *hashVersion));
+    }
+  }
 }
 
 void
@@ -284,6 +362,29 @@ Config::checkDecisionConfig() {
   }
 }
 
+void
+Config::checkFibConfig() {
+  std::unordered_set<std::string> classNames;
+  for (auto const& priorityClass : *config_.fib_priority_classes_ref()) {
+    auto const& name = *priorityClass.name_ref();
+    if (name.empty()) {
+      throw std::invalid_argument("fib priority class name can't be empty");
+    }
+    if (not classNames.emplace(name).second) {
+      throw std::invalid_argument(
+          fmt::format("duplicate fib priority class name {}", name));
+    }
+    for (auto const& prefix : *priorityClass.prefixes_ref()) {
+      try {
+        folly::IPAddress::createNetwork(prefix);
+      } catch (std::exception const&) {
+        throw std::invalid_argument(fmt::format(
+            "invalid prefix {} in fib priority class {}", prefix, name));
+      }
+    }
+  }
+}
+
 void
 Config::checkSparkConfig() {
   auto& sparkConfig = *config_.spark_config_ref();
@@ -393,6 +494,47 @@ Config::checkMonitorConfig() {
   }
 }
 
+void
+Config::checkThreadSchedulingConfig() {
+  for (auto const& [name, sched] : *config_.thread_scheduling_ref()) {
+    for (auto cpu : *sched.cpus_ref()) {
+      if (cpu < 0 or cpu >= CPU_SETSIZE) {
+        throw std::out_of_range(fmt::format(
+            "thread_scheduling of {}: cpu {} should be in [0, {})",
+            name,
+            cpu,
+            CPU_SETSIZE));
+      }
+    }
+    if (sched.numa_node_ref() and *sched.numa_node_ref() < 0) {
+      throw std::out_of_range(fmt::format(
+          "thread_scheduling of {}: numa_node ({}) should be >= 0",
+          name,
+          *sched.numa_node_ref()));
+    }
+    if (sched.nice_ref() and
+        (*sched.nice_ref() < -20 or *sched.nice_ref() > 19)) {
+      throw std::out_of_range(fmt::format(
+          "thread_scheduling of {}: nice ({}) should be in [-20, 19]",
+          name,
+          *sched.nice_ref()));
+    }
+    if (sched.fifo_priority_ref()) {
+      if (sched.nice_ref()) {
+        throw std::invalid_argument(fmt::format(
+            "thread_scheduling of {}: nice and fifo_priority are exclusive",
+            name));
+      }
+      if (*sched.fifo_priority_ref() < 1 or *sched.fifo_priority_ref() > 99) {
+        throw std::out_of_range(fmt::format(
+            "thread_scheduling of {}: fifo_priority ({}) should be in [1, 99]",
+            name,
+            *sched.fifo_priority_ref()));
+      }
+    }
+  }
+}
+
 void
 Config::checkLinkMonitorConfig() {
   auto& lmConf = *config_.link_monitor_config_ref();
@@ -416,6 +558,28 @@ Config::checkLinkMonitorConfig() {
         *lmConf.linkflap_initial_backoff_ms_ref(),
         *lmConf.linkflap_max_backoff_ms_ref()));
   }
+
+  // adjacency dampening validation
+  if (auto dampConf = lmConf.adjacency_dampening_config_ref()) {
+    if (*dampConf->half_life_s_ref() <= 0 or
+        *dampConf->metric_quantum_ref() <= 0) {
+      throw std::out_of_range(fmt::format(
+          "half_life_s ({}) and metric_quantum ({}) should be > 0",
+          *dampConf->half_life_s_ref(),
+          *dampConf->metric_quantum_ref()));
+    }
+    if (*dampConf->reuse_threshold_ref() <= 0 or
+        *dampConf->reuse_threshold_ref() >=
+            *dampConf->suppress_threshold_ref() or
+        *dampConf->suppress_threshold_ref() >= *dampConf->max_penalty_ref()) {
+      throw std::out_of_range(fmt::format(
+          "Expect 0 < reuse_threshold ({}) < suppress_threshold ({}) "
+          "< max_penalty ({})",
+          *dampConf->reuse_threshold_ref(),
+          *dampConf->suppress_threshold_ref(),
+          *dampConf->max_penalty_ref()));
+    }
+  }
 }
 
 void
@@ -623,6 +787,20 @@ void
 Config::checkThriftServerConfig() {
   const auto& thriftServerConfig = getThriftServerConfig();
 
+  if (*thriftServerConfig.num_ctrl_threads_ref() < 1 or
+      *thriftServerConfig.num_peer_sync_threads_ref() < 1) {
+    throw std::invalid_argument(
+        "num_ctrl_threads and num_peer_sync_threads must be at least 1");
+  }
+
+  if (thriftServerConfig.min_compress_bytes_ref().value_or(0) < 0) {
+    throw std::invalid_argument("min_compress_bytes must be non-negative");
+  }
+
+  if (not isSecureThriftServerEnabled()) {
+    return;
+  }
+
   // Checking the fields needed when we enable the secure thrift server
   const auto& caPath = thriftServerConfig.x509_ca_path_ref();
   const auto& certPath = thriftServerConfig.x509_cert_path_ref();
@@ -684,24 +862,58 @@ Config::populateInternalDb() {
     throw std::invalid_argument(
         "enable_watchdog = true, but watchdog_config is empty");
   }
+  if (isWatchdogEnabled()) {
+    const auto& watchdogConf = *config_.watchdog_config_ref();
+    if (auto stallS = watchdogConf.cpu_profile_stall_s_ref()) {
+      if (*stallS <= 0 or *stallS >= *watchdogConf.thread_timeout_s_ref()) {
+        throw std::invalid_argument(fmt::format(
+            "cpu_profile_stall_s ({}) must be in (0, thread_timeout_s)",
+            *stallS));
+      }
+    }
+    if (auto softMemoryMB = watchdogConf.soft_memory_mb_ref()) {
+      if (*softMemoryMB <= 0 or
+          *softMemoryMB >= *watchdogConf.max_memory_mb_ref()) {
+        throw std::invalid_argument(fmt::format(
+            "soft_memory_mb ({}) must be in (0, max_memory_mb)",
+            *softMemoryMB));
+      }
+    }
+    if (auto thresholdMs = watchdogConf.slow_callback_threshold_ms_ref()) {
+      if (*thresholdMs <= 0) {
+        throw std::invalid_argument(fmt::format(
+            "slow_callback_threshold_ms ({}) must be > 0", *thresholdMs));
+      }
+    }
+  }
 
   // Check Route Deletion Parameter
   if (*config_.route_delete_delay_ms_ref() < 0) {
     throw std::invalid_argument("Route delete duration must be >= 0ms");
   }
 
+  if (*config_.prefix_db_buckets_ref() < 0) {
+    throw std::invalid_argument("prefix_db_buckets must be >= 0");
+  }
+
   // validate KvStore config (e.g. ttl/flood-rate/etc.)
   checkKvStoreConfig();
 
   // validate Decision config (e.g. debounce)
   checkDecisionConfig();
 
+  // validate Fib config
+  checkFibConfig();
+
   // validate Spark config
   checkSparkConfig();
 
   // validate Monitor config (e.g. event log)
   checkMonitorConfig();
 
+  // validate scheduling config of module threads
+  checkThreadSchedulingConfig();
+
   // validate Link Monitor config (e.g. backoff)
   checkLinkMonitorConfig();
 
@@ -725,9 +937,7 @@ Config::populateInternalDb() {
   checkBgpPeeringConfig();
 
   // validate thrift server config
-  if (isSecureThriftServerEnabled()) {
-    checkThriftServerConfig();
-  }
+  checkThriftServerConfig();
 
   //
   // Set an implicit value for eor_time_s (Decision Hold time) if not specified
@@ -17,6 +17,7 @@ namespace fs = std::experimental::filesystem;
 #include <folly/IPAddress.h>
 #include <folly/io/async/SSLContext.h>
 #include <openr/common/MplsUtil.h>
+#include <openr/common/Types.h>
 #include <openr/if/gen-cpp2/OpenrConfig_types.h>
 #include <re2/re2.h>
 #include <re2/set.h>
@@ -79,18 +80,18 @@ class AreaConfiguration {
 
   bool
   shouldDiscoverOnIface(std::string const& iface) const {
-    return !interfaceExcludeRegexSet_->Match(iface, nullptr) &&
-        interfaceIncludeRegexSet_->Match(iface, nullptr);
+    return !interfaceExcludeRegexSet_->match(iface) &&
+        interfaceIncludeRegexSet_->match(iface);
   }
 
   bool
   shouldPeerWithNeighbor(std::string const& neighbor) const {
-    return neighborRegexSet_->Match(neighbor, nullptr);
+    return neighborRegexSet_->match(neighbor);
   }
 
   bool
   shouldRedistributeIface(std::string const& iface) const {
-    return interfaceRedistRegexSet_->Match(iface, nullptr);
+    return interfaceRedistRegexSet_->match(iface);
   }
 
   std::optional<std::string>
@@ -111,14 +112,46 @@ class AreaConfiguration {
 
   std::optional<std::string> importPolicyName_{std::nullopt};
 
-  // given a list of strings we will convert is to a compiled RE2::Set
-  static std::shared_ptr<re2::RE2::Set> compileRegexSet(
+  // given a list of strings we will convert is to a compiled RegexSet
+  static std::shared_ptr<RegexSet> compileRegexSet(
       std::vector<std::string> const& strings);
 
-  std::shared_ptr<re2::RE2::Set> neighborRegexSet_, interfaceIncludeRegexSet_,
+  std::shared_ptr<RegexSet> neighborRegexSet_, interfaceIncludeRegexSet_,
       interfaceExcludeRegexSet_, interfaceRedistRegexSet_;
 };
 
+class Config;
+
+/**
+ * Difference between running config and config reloaded from file, see
+ * Config::diff(). Modules subscribe to the fields they can apply live, every
+ * other change takes effect on next restart only.
+ */
+struct ConfigUpdate {
+  // Running config along with the changes which are applied live. Changes
+  // listed in `restartRequiredFields` are left out of it, hence modules can
+  // swap their config for it.
+  std::shared_ptr<const Config> config{nullptr};
+
+  // Areas with changed neighbor or interface regexes
+  std::unordered_set<std::string> areasWithChangedRegexes;
+
+  // `decision_config.debounce_min_ms` or `debounce_max_ms` changed
+  bool decisionDebounceChanged{false};
+
+  // `kvstore_config.flood_rate` changed
+  bool kvStoreFloodRateChanged{false};
+
+  // Top level config fields changed in a way which can't be applied live
+  std::vector<std::string> restartRequiredFields;
+
+  bool
+  hasLiveChanges() const {
+    return (not areasWithChangedRegexes.empty()) or decisionDebounceChanged or
+        kvStoreFloodRateChanged;
+  }
+};
+
 class Config {
  public:
   explicit Config(const std::string& configFile);
@@ -126,6 +159,12 @@ class Config {
     populateInternalDb();
   }
 
+  // Compute update from `running` config to `reloaded` one, i.e. changes
+  // modules can apply without restart and the ones requiring restart. Set of
+  // areas is fixed, regexes of existing areas may change.
+  static ConfigUpdate diff(
+      std::shared_ptr<const Config> const& running, Config const& reloaded);
+
   static PrefixAllocationParams createPrefixAllocationParams(
       const std::string& seedPfxStr, uint8_t allocationPfxLen);
 
@@ -566,6 +605,17 @@ class Config {
     }
   }
 
+  // scheduling config of module thread `name`, if any
+  std::optional<thrift::ThreadSchedulingConfig>
+  getThreadSchedulingConfig(std::string const& name) const {
+    auto const& threadScheduling = *config_.thread_scheduling_ref();
+    auto it = threadScheduling.find(name);
+    if (it == threadScheduling.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
  private:
   void populateInternalDb();
 
@@ -581,6 +631,9 @@ class Config {
   // validate Monitor config
   void checkMonitorConfig();
 
+  // validate scheduling config of module threads
+  void checkThreadSchedulingConfig();
+
   // validate Link Monitor config
   void checkLinkMonitorConfig();
 
@@ -599,6 +652,9 @@ class Config {
   // validate thrift server config
   void checkThriftServerConfig();
 
+  // validate Fib config (e.g. priority classes)
+  void checkFibConfig();
+
   // thrift config
   thrift::OpenrConfig config_;
   // prefix allocation
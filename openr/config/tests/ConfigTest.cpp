@@ -498,6 +498,26 @@ TEST(ConfigTest, PopulateInternalDb) {
     EXPECT_TRUE(Config(conf).isRibPolicyEnabled());
   }
 
+  // fib
+
+  // fib priority class with invalid prefix
+  {
+    auto confInvalid = getBasicOpenrConfig();
+    thrift::FibPriorityClass priorityClass;
+    priorityClass.name_ref() = "loopback";
+    priorityClass.prefixes_ref() = {"fc00::/abc"};
+    confInvalid.fib_priority_classes_ref() = {priorityClass};
+    EXPECT_THROW((Config(confInvalid)), std::invalid_argument);
+  }
+  // fib priority classes with duplicate name
+  {
+    auto confInvalid = getBasicOpenrConfig();
+    thrift::FibPriorityClass priorityClass;
+    priorityClass.name_ref() = "loopback";
+    confInvalid.fib_priority_classes_ref() = {priorityClass, priorityClass};
+    EXPECT_THROW((Config(confInvalid)), std::invalid_argument);
+  }
+
   // kvstore
 
   // flood_msg_per_sec <= 0
@@ -656,6 +676,24 @@ TEST(ConfigTest, PopulateInternalDb) {
         300000;
     EXPECT_THROW(auto c = Config(confInvalidLm), std::out_of_range);
   }
+  // adjacency dampening reuse_threshold >= suppress_threshold
+  {
+    auto confInvalidLm = getBasicOpenrConfig();
+    thrift::AdjacencyDampeningConfig dampConf;
+    dampConf.reuse_threshold_ref() = 3000;
+    confInvalidLm.link_monitor_config_ref()->adjacency_dampening_config_ref() =
+        dampConf;
+    EXPECT_THROW(auto c = Config(confInvalidLm), std::out_of_range);
+  }
+  // adjacency dampening half_life_s <= 0
+  {
+    auto confInvalidLm = getBasicOpenrConfig();
+    thrift::AdjacencyDampeningConfig dampConf;
+    dampConf.half_life_s_ref() = 0;
+    confInvalidLm.link_monitor_config_ref()->adjacency_dampening_config_ref() =
+        dampConf;
+    EXPECT_THROW(auto c = Config(confInvalidLm), std::out_of_range);
+  }
 
   // prefix allocation
 
@@ -758,6 +796,25 @@ TEST(ConfigTest, PopulateInternalDb) {
     confInvalid.enable_watchdog_ref() = true;
     EXPECT_THROW((Config(confInvalid)), std::invalid_argument);
   }
+  // CPU profiling on stall not ahead of thread timeout
+  {
+    auto confInvalid = getBasicOpenrConfig();
+    confInvalid.enable_watchdog_ref() = true;
+    thrift::WatchdogConfig watchdogConf;
+    watchdogConf.cpu_profile_stall_s_ref() =
+        *watchdogConf.thread_timeout_s_ref();
+    confInvalid.watchdog_config_ref() = watchdogConf;
+    EXPECT_THROW((Config(confInvalid)), std::invalid_argument);
+  }
+  // soft memory limit not below hard limit
+  {
+    auto confInvalid = getBasicOpenrConfig();
+    confInvalid.enable_watchdog_ref() = true;
+    thrift::WatchdogConfig watchdogConf;
+    watchdogConf.soft_memory_mb_ref() = *watchdogConf.max_memory_mb_ref();
+    confInvalid.watchdog_config_ref() = watchdogConf;
+    EXPECT_THROW((Config(confInvalid)), std::invalid_argument);
+  }
 
   // vip service
   {
@@ -800,6 +857,16 @@ TEST(ConfigTest, PopulateInternalDb) {
     EXPECT_NO_THROW((Config(conf)));
   }
 
+  // prefix database buckets
+  {
+    auto conf = getBasicOpenrConfig();
+    conf.prefix_db_buckets_ref() = -1;
+    EXPECT_THROW((Config(conf)), std::invalid_argument);
+
+    conf.prefix_db_buckets_ref() = 16;
+    EXPECT_NO_THROW((Config(conf)));
+  }
+
   // Validate SR Policy configuration
   {
     auto conf = getBasicOpenrConfig();
@@ -1053,4 +1120,101 @@ TEST(ConfigTest, EorTime) {
   }
 }
 
+TEST(ConfigTest, ThriftServerThreadsConfig) {
+  // default
+  {
+    auto config = Config(getBasicOpenrConfig());
+    EXPECT_EQ(1, *config.getThriftServerConfig().num_ctrl_threads_ref());
+    EXPECT_EQ(1, *config.getThriftServerConfig().num_peer_sync_threads_ref());
+  }
+
+  // invalid number of threads
+  {
+    auto tConfig = getBasicOpenrConfig();
+    tConfig.thrift_server_ref()->num_ctrl_threads_ref() = 0;
+    EXPECT_THROW((Config(tConfig)), std::invalid_argument);
+  }
+  {
+    auto tConfig = getBasicOpenrConfig();
+    tConfig.thrift_server_ref()->num_peer_sync_threads_ref() = 0;
+    EXPECT_THROW((Config(tConfig)), std::invalid_argument);
+  }
+
+  // invalid min_compress_bytes
+  {
+    auto tConfig = getBasicOpenrConfig();
+    tConfig.thrift_server_ref()->min_compress_bytes_ref() = -1;
+    EXPECT_THROW((Config(tConfig)), std::invalid_argument);
+  }
+}
+
+TEST(ConfigTest, Diff) {
+  auto tConfig = getBasicOpenrConfig(
+      "node-1",
+      "domain",
+      {createAreaConfig("area1", {"fsw.*"}, {"po.*"}),
+       createAreaConfig("area2", {"rsw.*"}, {"eth.*"})});
+  auto running = std::make_shared<const Config>(tConfig);
+
+  // same config, nothing to do
+  {
+    auto update = Config::diff(running, Config(tConfig));
+    EXPECT_FALSE(update.hasLiveChanges());
+    EXPECT_TRUE(update.restartRequiredFields.empty());
+    EXPECT_EQ(running->getConfig(), update.config->getConfig());
+  }
+
+  // changes applied live
+  {
+    auto reloaded = tConfig;
+    reloaded.areas_ref()->at(1).neighbor_regexes_ref() = {"ssw.*"};
+    reloaded.decision_config_ref()->debounce_max_ms_ref() = 1000;
+    thrift::KvstoreFloodRate floodRate;
+    floodRate.flood_msg_per_sec_ref() = 100;
+    floodRate.flood_msg_burst_size_ref() = 10;
+    reloaded.kvstore_config_ref()->flood_rate_ref() = floodRate;
+
+    auto update = Config::diff(running, Config(reloaded));
+    EXPECT_TRUE(update.hasLiveChanges());
+    EXPECT_EQ(
+        std::unordered_set<std::string>({"area2"}),
+        update.areasWithChangedRegexes);
+    EXPECT_TRUE(update.decisionDebounceChanged);
+    EXPECT_TRUE(update.kvStoreFloodRateChanged);
+    EXPECT_TRUE(update.restartRequiredFields.empty());
+    EXPECT_EQ(Config(reloaded).getConfig(), update.config->getConfig());
+    EXPECT_TRUE(
+        update.config->getAreas().at("area2").shouldPeerWithNeighbor("ssw1"));
+  }
+
+  // changes requiring restart are left out of applied config, e.g. new area
+  {
+    auto reloaded = tConfig;
+    reloaded.enable_v4_ref() = not *tConfig.enable_v4_ref();
+    reloaded.areas_ref()->emplace_back(
+        createAreaConfig("area3", {"ssw.*"}, {".*"}));
+    reloaded.areas_ref()->at(0).neighbor_regexes_ref() = {"ssw.*"};
+    reloaded.decision_config_ref()->debounce_min_ms_ref() = 20;
+
+    auto update = Config::diff(running, Config(reloaded));
+    EXPECT_EQ(
+        std::unordered_set<std::string>({"area1"}),
+        update.areasWithChangedRegexes);
+    EXPECT_EQ(2, update.config->getAreas().size());
+    EXPECT_TRUE(update.decisionDebounceChanged);
+    EXPECT_FALSE(update.kvStoreFloodRateChanged);
+    EXPECT_EQ(
+        std::vector<std::string>({"areas", "enable_v4"}),
+        update.restartRequiredFields);
+    EXPECT_EQ(
+        *running->getConfig().enable_v4_ref(),
+        *update.config->getConfig().enable_v4_ref());
+    EXPECT_EQ(
+        20,
+        *update.config->getConfig()
+             .decision_config_ref()
+             ->debounce_min_ms_ref());
+  }
+}
+
 } // namespace openr
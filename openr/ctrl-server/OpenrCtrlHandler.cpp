@@ -19,9 +19,11 @@ namespace fs = std::experimental::filesystem;
 #include <folly/io/async/SSLContext.h>
 #include <folly/io/async/ssl/OpenSSLUtils.h>
 #include <re2/re2.h>
+#include <thrift/lib/cpp2/protocol/CompactProtocol.h>
 #include <thrift/lib/cpp2/server/ThriftServer.h>
 
 #include <openr/common/Constants.h>
+#include <openr/common/HotPathTrace.h>
 #include <openr/common/Util.h>
 #include <openr/config-store/PersistentStore.h>
 #include <openr/decision/Decision.h>
@@ -35,6 +37,45 @@ namespace fb303 = facebook::fb303;
 
 namespace openr {
 
+namespace {
+
+// Invoke `f(begin, end)` for consecutive ranges of at most
+// `kCtrlStreamChunkSize` items
+template <typename Items, typename F>
+void
+forEachChunk(Items const& items, F&& f) {
+  for (size_t i = 0; i < items.size(); i += Constants::kCtrlStreamChunkSize) {
+    const auto end =
+        std::min(items.size(), i + Constants::kCtrlStreamChunkSize);
+    f(items.begin() + i, items.begin() + end);
+  }
+}
+
+// Record uncompressed size of initial snapshot of stream subscription. Compared
+// with bytes sent on the wire, it tells how much compression, negotiated per
+// connection, saves on snapshots.
+template <typename T>
+void
+recordSnapshotBytes(const std::string& api, T const& snapshot) {
+  apache::thrift::CompactProtocolWriter writer;
+  fb303::fbData->addStatValue(
+      fmt::format("ctrl.{}.snapshot_bytes", api),
+      snapshot.serializedSize(&writer),
+      fb303::SUM);
+}
+
+// Refuse new subscriptions under memory pressure, as each one starts with a
+// full snapshot backlog
+void
+throwIfUnderMemoryPressure(const std::string& api) {
+  if (MemoryPressure::isUnderPressure()) {
+    throw thrift::OpenrError(
+        fmt::format("{} refused under memory pressure", api));
+  }
+}
+
+} // namespace
+
 OpenrCtrlHandler::OpenrCtrlHandler(
     const std::string& nodeName,
     const std::unordered_set<std::string>& acceptablePeerCommonNames,
@@ -79,15 +120,13 @@ OpenrCtrlHandler::OpenrCtrlHandler(
             }
 
             kvStorePublishers_.withWLock([&](auto& kvStorePublishers_) {
-              for (auto& [_, publisher] : kvStorePublishers_) {
-                publisher->publish(maybePub.value().tPublication);
-              }
+              kvStorePublishers_.publish(*maybePub.value().tPublication);
             });
 
             bool isAdjChanged = false;
             // check if any of KeyVal has 'adj' update
             for (auto& [key, val] :
-                 maybePub.value().tPublication.get_keyVals()) {
+                 maybePub.value().tPublication->get_keyVals()) {
               // check if we have any value update.
               // Ttl refreshing won't update any value.
               if (!val.value_ref().has_value()) {
@@ -102,45 +141,35 @@ OpenrCtrlHandler::OpenrCtrlHandler(
               }
             }
 
-            if (isAdjChanged) {
-              // thrift::Publication contains "adj:*" key change.
-              // Clean ALL pending promises
-              longPollReqs_.withWLock([&](auto& longPollReqs) {
-                for (auto& kv :
-                     longPollReqs[maybePub->tPublication.get_area()]) {
-                  auto& p = kv.second.first;
+            const auto& area = maybePub->tPublication->get_area();
+            const auto now = getUnixTimeStampMs();
+            longPollReqs_.withWLock([&](auto& longPollReqs) {
+              auto& pendingLongPolls = longPollReqs[area];
+              auto& reqs = pendingLongPolls.reqs;
+              if (isAdjChanged) {
+                // thrift::Publication contains "adj:*" key change.
+                // Resolve ALL pending promises of the area
+                ++pendingLongPolls.adjGeneration;
+                for (auto& [p, _] : reqs) {
                   p.setValue(true);
                 }
-                longPollReqs.clear();
-              });
-            } else {
-              longPollReqs_.withWLock([&](auto& longPollReqs) {
-                auto now = getUnixTimeStampMs();
-                std::vector<int64_t> reqsToClean;
-                for (auto& kv :
-                     longPollReqs[maybePub->tPublication.get_area()]) {
-                  auto& clientId = kv.first;
-                  auto& req = kv.second;
-
-                  auto& p = req.first;
-                  auto& timeStamp = req.second;
-                  if (now - timeStamp >=
-                      Constants::kLongPollReqHoldTime.count()) {
-                    LOG(INFO) << "Elapsed time: " << now - timeStamp
-                              << " is over hold limit: "
-                              << Constants::kLongPollReqHoldTime.count();
-                    reqsToClean.emplace_back(clientId);
-                    p.setValue(false);
-                  }
-                }
+                reqs.clear();
+                return;
+              }
 
-                // cleanup expired requests since no ADJ change observed
-                for (auto& clientId : reqsToClean) {
-                  longPollReqs[maybePub->tPublication.get_area()].erase(
-                      clientId);
-                }
-              });
-            }
+              // cleanup expired requests since no ADJ change observed.
+              // Requests are ordered by arrival, hence stop at first one
+              // still within hold time.
+              while (not reqs.empty() and
+                     now - reqs.front().second >=
+                         Constants::kLongPollReqHoldTime.count()) {
+                LOG(INFO) << "Elapsed time: " << now - reqs.front().second
+                          << " is over hold limit: "
+                          << Constants::kLongPollReqHoldTime.count();
+                reqs.front().first.setValue(false);
+                reqs.pop_front();
+              }
+            });
           }
           LOG(INFO) << "KvStore updates processing fiber stopped";
         });
@@ -162,35 +191,38 @@ OpenrCtrlHandler::OpenrCtrlHandler(
               break;
             }
 
-            // Publish the update to all active streams
-            fibPublishers_.withWLock([&maybeUpdate](auto& fibPublishers) {
-              if (fibPublishers.size()) {
-                const auto fibUpdate = maybeUpdate.value().toThrift();
-                for (auto& fibPublisher : fibPublishers) {
-                  fibPublisher.second.next(fibUpdate);
-                }
-              }
-            });
-
-            // Publish the detailed update to all active streams
-            fibDetailPublishers_.withWLock([&maybeUpdate](auto& fibPublishers) {
-              if (fibPublishers.size()) {
-                const auto fibUpdateDetail =
-                    maybeUpdate.value().toThriftDetail();
-                for (auto& fibPublisher : fibPublishers) {
-                  fibPublisher.second.next(fibUpdateDetail);
-                }
-              }
-            });
+            // Convert the update once per stream type, outside of the
+            // publisher locks, and share it across all active streams.
+            // Subscriber lookups are cheap, conversions of a big update are
+            // not, so skip the ones nobody is listening to.
+            const auto& update = maybeUpdate.value();
+            if (not fibPublishers_.rlock()->empty()) {
+              publishToAll(fibPublishers_, update.toThrift());
+            }
+            if (not fibDetailPublishers_.rlock()->empty()) {
+              publishToAll(fibDetailPublishers_, update.toThriftDetail());
+            }
           }
           LOG(INFO) << "Fib updates processing fiber stopped";
         });
 
     workers_.push_back(std::move(taskFutureFib));
   }
+
+  dumpStrand_ = SharedExecutor::makeStrand();
+
+  // caches are synchronized, hence dropped right on the shedding thread
+  memoryShedder_ =
+      MemoryPressure::addShedder("ctrl", nullptr /* executor */, [this]() {
+        routeDbCache_.wlock()->clear();
+        areaSummaryCache_.wlock()->clear();
+        neighborsCache_.wlock()->clear();
+      });
 }
 
 OpenrCtrlHandler::~OpenrCtrlHandler() {
+  // Finish streams of dump API's in progress
+  SharedExecutor::drain(dumpStrand_);
   closeKvStorePublishers();
   closeFibPublishers();
 
@@ -211,12 +243,7 @@ OpenrCtrlHandler::~OpenrCtrlHandler() {
 // SYNCHRONIZED block
 void
 OpenrCtrlHandler::closeKvStorePublishers() {
-  std::vector<std::unique_ptr<KvStorePublisher>> publishers;
-  kvStorePublishers_.withWLock([&](auto& kvStorePublishers_) {
-    for (auto& [_, publisher] : kvStorePublishers_) {
-      publishers.emplace_back(std::move(publisher));
-    }
-  });
+  auto publishers = kvStorePublishers_.wlock()->releaseAll();
   LOG(INFO) << "Terminating " << publishers.size()
             << " active KvStore snoop stream(s).";
   for (auto& publisher : publishers) {
@@ -292,6 +319,31 @@ OpenrCtrlHandler::getEventLogs(std::vector<::std::string>& _return) {
   }
 }
 
+folly::SemiFuture<std::unique_ptr<std::string>>
+OpenrCtrlHandler::semifuture_dumpCpuProfile(
+    int64_t durationMs, std::unique_ptr<std::string> threadName) {
+  CHECK(monitor_);
+  const std::chrono::milliseconds duration(durationMs);
+  if (duration <= std::chrono::milliseconds(0) or
+      duration > Constants::kCpuProfileMaxDuration) {
+    throw thrift::OpenrError(fmt::format(
+        "CPU profile duration must be in (0, {}] ms",
+        std::chrono::milliseconds(Constants::kCpuProfileMaxDuration).count()));
+  }
+  std::optional<std::string> maybeThreadName;
+  if (not threadName->empty()) {
+    maybeThreadName = *threadName;
+  }
+  return monitor_->dumpCpuProfile(duration, maybeThreadName)
+      .deferValue([](std::string&& path) {
+        return std::make_unique<std::string>(std::move(path));
+      })
+      .deferError(
+          [](folly::exception_wrapper&& ew) -> std::unique_ptr<std::string> {
+            throw thrift::OpenrError(ew.what().toStdString());
+          });
+}
+
 void
 OpenrCtrlHandler::getCounters(std::map<std::string, int64_t>& _return) {
   BaseService::getCounters(_return);
@@ -358,6 +410,11 @@ OpenrCtrlHandler::getBuildInfo(thrift::BuildInfo& _buildInfo) {
   _buildInfo = getBuildInfoThrift();
 }
 
+void
+OpenrCtrlHandler::getTraceSpans(std::vector<thrift::TraceSpan>& _spans) {
+  _spans = HotPathTrace::getSpans();
+}
+
 // validate config
 void
 OpenrCtrlHandler::dryrunConfig(
@@ -506,7 +563,10 @@ OpenrCtrlHandler::semifuture_getAdvertisedRoutesWithOriginationPolicy(
 folly::SemiFuture<std::unique_ptr<thrift::RouteDatabase>>
 OpenrCtrlHandler::semifuture_getRouteDb() {
   CHECK(fib_);
-  return fib_->getRouteDb();
+  return getCachedResponse(
+      routeDbCache_, "", fib_->getRouteDbGeneration(), [this]() {
+        return fib_->getRouteDb();
+      });
 }
 
 folly::SemiFuture<std::unique_ptr<thrift::RouteDatabaseDetail>>
@@ -515,6 +575,58 @@ OpenrCtrlHandler::semifuture_getRouteDetailDb() {
   return fib_->getRouteDetailDb();
 }
 
+apache::thrift::ServerStream<thrift::RouteDatabase>
+OpenrCtrlHandler::getRouteDbStream() {
+  CHECK(fib_);
+  return streamSnapshot<thrift::RouteDatabase>(
+      fib_->getRouteDbSnapshot(),
+      [nodeName = nodeName_](
+          Fib::RouteDbSnapshot const& snapshot, auto&& publish) {
+        forEachChunk(snapshot.unicastRoutes, [&](auto begin, auto end) {
+          thrift::RouteDatabase chunk;
+          chunk.thisNodeName_ref() = nodeName;
+          for (auto it = begin; it != end; ++it) {
+            chunk.unicastRoutes_ref()->emplace_back(it->toThrift());
+          }
+          publish(std::move(chunk));
+        });
+        forEachChunk(snapshot.mplsRoutes, [&](auto begin, auto end) {
+          thrift::RouteDatabase chunk;
+          chunk.thisNodeName_ref() = nodeName;
+          for (auto it = begin; it != end; ++it) {
+            chunk.mplsRoutes_ref()->emplace_back(it->toThrift());
+          }
+          publish(std::move(chunk));
+        });
+      });
+}
+
+apache::thrift::ServerStream<thrift::RouteDatabaseDetail>
+OpenrCtrlHandler::getRouteDetailDbStream() {
+  CHECK(fib_);
+  return streamSnapshot<thrift::RouteDatabaseDetail>(
+      fib_->getRouteDbSnapshot(),
+      [nodeName = nodeName_](
+          Fib::RouteDbSnapshot const& snapshot, auto&& publish) {
+        forEachChunk(snapshot.unicastRoutes, [&](auto begin, auto end) {
+          thrift::RouteDatabaseDetail chunk;
+          chunk.thisNodeName_ref() = nodeName;
+          for (auto it = begin; it != end; ++it) {
+            chunk.unicastRoutes_ref()->emplace_back(it->toThriftDetail());
+          }
+          publish(std::move(chunk));
+        });
+        forEachChunk(snapshot.mplsRoutes, [&](auto begin, auto end) {
+          thrift::RouteDatabaseDetail chunk;
+          chunk.thisNodeName_ref() = nodeName;
+          for (auto it = begin; it != end; ++it) {
+            chunk.mplsRoutes_ref()->emplace_back(it->toThriftDetail());
+          }
+          publish(std::move(chunk));
+        });
+      });
+}
+
 folly::SemiFuture<std::unique_ptr<std::vector<thrift::UnicastRoute>>>
 OpenrCtrlHandler::semifuture_getUnicastRoutesFiltered(
     std::unique_ptr<std::vector<std::string>> prefixes) {
@@ -554,7 +666,10 @@ OpenrCtrlHandler::semifuture_floodRestartingMsg() {
 folly::SemiFuture<std::unique_ptr<std::vector<thrift::SparkNeighbor>>>
 OpenrCtrlHandler::semifuture_getNeighbors() {
   CHECK(spark_);
-  return spark_->getNeighbors();
+  return getCachedResponse(
+      neighborsCache_, "", spark_->getNeighborsGeneration(), [this]() {
+        return spark_->getNeighbors();
+      });
 }
 
 //
@@ -583,6 +698,27 @@ OpenrCtrlHandler::semifuture_getReceivedRoutesFiltered(
   return decision_->getReceivedRoutesFiltered(std::move(*filter));
 }
 
+apache::thrift::ServerStream<std::vector<thrift::ReceivedRouteDetail>>
+OpenrCtrlHandler::getReceivedRoutesStream(
+    std::unique_ptr<thrift::ReceivedRouteFilter> filter) {
+  CHECK(decision_);
+  return streamSnapshot<std::vector<thrift::ReceivedRouteDetail>>(
+      decision_->getReceivedRoutesSnapshot(*filter),
+      [filter = std::move(*filter)](
+          std::vector<Decision::ReceivedRouteSnapshot> const& snapshot,
+          auto&& publish) {
+        forEachChunk(snapshot, [&](auto begin, auto end) {
+          std::vector<thrift::ReceivedRouteDetail> chunk;
+          for (auto it = begin; it != end; ++it) {
+            Decision::addReceivedRoute(chunk, filter, *it);
+          }
+          if (not chunk.empty()) {
+            publish(std::move(chunk));
+          }
+        });
+      });
+}
+
 folly::SemiFuture<std::unique_ptr<thrift::RouteDatabase>>
 OpenrCtrlHandler::semifuture_getRouteDbComputed(
     std::unique_ptr<std::string> nodeName) {
@@ -590,6 +726,13 @@ OpenrCtrlHandler::semifuture_getRouteDbComputed(
   return decision_->getDecisionRouteDb(*nodeName);
 }
 
+folly::SemiFuture<std::unique_ptr<thrift::RouteDatabaseDelta>>
+OpenrCtrlHandler::semifuture_getRouteDbSimulated(
+    std::unique_ptr<thrift::RouteSimulationRequest> request) {
+  CHECK(decision_);
+  return decision_->getRouteDbSimulated(std::move(*request));
+}
+
 folly::SemiFuture<std::unique_ptr<thrift::AdjDbs>>
 OpenrCtrlHandler::semifuture_getDecisionAdjacencyDbs() {
   auto filter = std::make_unique<thrift::AdjacenciesFilter>();
@@ -635,6 +778,41 @@ OpenrCtrlHandler::semifuture_getDecisionPrefixDbs() {
       });
 }
 
+apache::thrift::ServerStream<thrift::PrefixDbs>
+OpenrCtrlHandler::getDecisionPrefixDbsStream() {
+  CHECK(decision_);
+  thrift::ReceivedRouteFilter filter;
+  filter.areaName_ref() = *getSingleAreaOrThrow("getDecisionPrefixDbsStream");
+  return streamSnapshot<thrift::PrefixDbs>(
+      decision_->getReceivedRoutesSnapshot(filter),
+      [filter](
+          std::vector<Decision::ReceivedRouteSnapshot> const& snapshot,
+          auto&& publish) {
+        forEachChunk(snapshot, [&](auto begin, auto end) {
+          std::vector<thrift::ReceivedRouteDetail> routes;
+          for (auto it = begin; it != end; ++it) {
+            Decision::addReceivedRoute(routes, filter, *it);
+          }
+          if (routes.empty()) {
+            return;
+          }
+          // Same as getDecisionPrefixDbs() for routes of the chunk
+          thrift::PrefixDbs chunk;
+          for (auto const& routeDetail : routes) {
+            for (auto const& route : routeDetail.get_routes()) {
+              chunk[route.get_key().get_node()]
+                  .prefixEntries_ref()
+                  ->push_back(route.get_route());
+            }
+          }
+          for (auto& [name, db] : chunk) {
+            db.thisNodeName_ref() = name;
+          }
+          publish(std::move(chunk));
+        });
+      });
+}
+
 //
 // KvStore APIs
 //
@@ -692,6 +870,13 @@ OpenrCtrlHandler::semifuture_getKvStoreHashFilteredArea(
   return kvStore_->dumpKvStoreHashes(std::move(*area), std::move(*filter));
 }
 
+folly::SemiFuture<std::unique_ptr<thrift::KvStoreMerkleDigests>>
+OpenrCtrlHandler::semifuture_getKvStoreMerkleDigestsArea(
+    std::unique_ptr<std::string> area) {
+  CHECK(kvStore_);
+  return kvStore_->getKvStoreMerkleDigests(std::move(*area));
+}
+
 folly::SemiFuture<folly::Unit>
 OpenrCtrlHandler::semifuture_setKvStoreKeyVals(
     std::unique_ptr<thrift::KeySetParams> setParams,
@@ -700,6 +885,42 @@ OpenrCtrlHandler::semifuture_setKvStoreKeyVals(
   return kvStore_->setKvStoreKeyVals(std::move(*area), std::move(*setParams));
 }
 
+apache::thrift::ServerStream<thrift::Publication>
+OpenrCtrlHandler::getKvStoreKeyValsFilteredAreaStream(
+    std::unique_ptr<thrift::KeyDumpParams> filter,
+    std::unique_ptr<std::string> area) {
+  CHECK(kvStore_);
+  using Publisher = apache::thrift::ServerStreamPublisher<thrift::Publication>;
+  auto streamAndPublisher =
+      apache::thrift::ServerStream<thrift::Publication>::createPublisher();
+  // ATTN: std::function requires copyable callbacks
+  auto publisher =
+      std::make_shared<Publisher>(std::move(streamAndPublisher.second));
+  kvStore_->streamKvStoreKeyVals(
+      std::move(*filter),
+      std::move(*area),
+      [publisher](thrift::Publication&& chunk) {
+        publisher->next(std::move(chunk));
+      },
+      [publisher](folly::exception_wrapper ew) {
+        if (ew) {
+          std::move(*publisher).complete(std::move(ew));
+        } else {
+          std::move(*publisher).complete();
+        }
+      });
+  return std::move(streamAndPublisher.first);
+}
+
+folly::SemiFuture<folly::Unit>
+OpenrCtrlHandler::semifuture_setKvStoreTtlUpdates(
+    std::unique_ptr<thrift::KvStoreTtlUpdates> ttlUpdates,
+    std::unique_ptr<std::string> area) {
+  CHECK(kvStore_);
+  return kvStore_->setKvStoreTtlUpdates(
+      std::move(*area), std::move(*ttlUpdates));
+}
+
 folly::SemiFuture<bool>
 OpenrCtrlHandler::semifuture_longPollKvStoreAdj(
     std::unique_ptr<thrift::KeyVals> snapshot) {
@@ -715,7 +936,11 @@ OpenrCtrlHandler::semifuture_longPollKvStoreAdjArea(
   auto sf = p.getSemiFuture();
 
   auto timeStamp = getUnixTimeStampMs();
-  auto requestId = pendingRequestId_++;
+  // adj generation before checking snapshot against KvStore. Any change
+  // afterwards may or may not be reflected in the check.
+  const auto adjGeneration = longPollReqs_.withWLock([&](auto& longPollReqs) {
+    return longPollReqs[*area].adjGeneration;
+  });
 
   thrift::KeyDumpParams params;
 
@@ -758,10 +983,15 @@ OpenrCtrlHandler::semifuture_longPollKvStoreAdjArea(
     // Client provided data is consistent with KvStore.
     // Store req for future processing when there is publication
     // from KvStore.
-    VLOG(3) << "No adj change detected. Store req as pending request";
-    longPollReqs_.withWLock([&](auto& longPollReq) {
-      longPollReq[*area].emplace(
-          requestId, std::make_pair(std::move(p), timeStamp));
+    longPollReqs_.withWLock([&](auto& longPollReqs) {
+      auto& pendingLongPolls = longPollReqs[*area];
+      if (pendingLongPolls.adjGeneration != adjGeneration) {
+        VLOG(3) << "AdjKey changed while checking snapshot. Notify immediately";
+        p.setValue(true);
+        return;
+      }
+      VLOG(3) << "No adj change detected. Store req as pending request";
+      pendingLongPolls.reqs.emplace_back(std::move(p), timeStamp);
     });
   }
   return sf;
@@ -809,7 +1039,14 @@ folly::SemiFuture<std::unique_ptr<::std::vector<thrift::KvStoreAreaSummary>>>
 OpenrCtrlHandler::semifuture_getKvStoreAreaSummary(
     std::unique_ptr<std::set<std::string>> selectAreas) {
   CHECK(kvStore_);
-  return kvStore_->getKvStoreAreaSummaryInternal(std::move(*selectAreas));
+  auto key = folly::join(",", *selectAreas);
+  return getCachedResponse(
+      areaSummaryCache_,
+      std::move(key),
+      kvStore_->getKvStoreAreaSummaryGeneration(),
+      [this, &selectAreas]() {
+        return kvStore_->getKvStoreAreaSummaryInternal(std::move(*selectAreas));
+      });
 }
 
 apache::thrift::ServerStream<thrift::Publication>
@@ -836,12 +1073,11 @@ OpenrCtrlHandler::subscribeKvStoreFilter(
           });
 
   kvStorePublishers_.withWLock([&](auto& kvStorePublishers_) {
-    assert(kvStorePublishers_.count(clientToken) == 0);
     LOG(INFO) << "KvStore snoop stream-" << clientToken
               << " started for areas: " << folly::join(", ", *selectAreas);
     auto kvStorePublisher = std::make_unique<KvStorePublisher>(
         *selectAreas, std::move(*filter), std::move(streamAndPublisher.second));
-    kvStorePublishers_.emplace(clientToken, std::move(kvStorePublisher));
+    kvStorePublishers_.add(clientToken, std::move(kvStorePublisher));
     fb303::fbData->setCounter("subscribers.kvstore", kvStorePublishers_.size());
   });
   return std::move(streamAndPublisher.first);
@@ -882,6 +1118,7 @@ folly::SemiFuture<apache::thrift::ResponseAndServerStream<
 OpenrCtrlHandler::semifuture_subscribeAndGetAreaKvStores(
     std::unique_ptr<thrift::KeyDumpParams> dumpParams,
     std::unique_ptr<std::set<std::string>> selectAreas) {
+  throwIfUnderMemoryPressure("subscribeAndGetAreaKvStores");
   auto dumpParamsCopy = std::make_unique<thrift::KeyDumpParams>(*dumpParams);
   auto selectAreasCopy = std::make_unique<std::set<std::string>>(*selectAreas);
   return kvStore_
@@ -894,6 +1131,7 @@ OpenrCtrlHandler::semifuture_subscribeAndGetAreaKvStores(
         for (auto& pub : *pubs.value()) {
           // Set the publication timestamp
           pub.timestamp_ms_ref() = getUnixTimeStampMs();
+          recordSnapshotBytes("subscribeAndGetAreaKvStores", pub);
         }
         return apache::thrift::ResponseAndServerStream<
             std::vector<thrift::Publication>,
@@ -935,11 +1173,13 @@ folly::SemiFuture<apache::thrift::ResponseAndServerStream<
     thrift::RouteDatabase,
     thrift::RouteDatabaseDelta>>
 OpenrCtrlHandler::semifuture_subscribeAndGetFib() {
+  throwIfUnderMemoryPressure("subscribeAndGetFib");
   auto stream = subscribeFib();
   return semifuture_getRouteDb().defer(
       [stream = std::move(stream)](
           folly::Try<std::unique_ptr<thrift::RouteDatabase>>&& db) mutable {
         db.throwUnlessValue();
+        recordSnapshotBytes("subscribeAndGetFib", *db.value());
         return apache::thrift::ResponseAndServerStream<
             thrift::RouteDatabase,
             thrift::RouteDatabaseDelta>{
@@ -982,12 +1222,14 @@ folly::SemiFuture<apache::thrift::ResponseAndServerStream<
     thrift::RouteDatabaseDetail,
     thrift::RouteDatabaseDeltaDetail>>
 OpenrCtrlHandler::semifuture_subscribeAndGetFibDetail() {
+  throwIfUnderMemoryPressure("subscribeAndGetFibDetail");
   auto stream = subscribeFibDetail();
   return semifuture_getRouteDetailDb().defer(
       [stream = std::move(stream)](
           folly::Try<std::unique_ptr<thrift::RouteDatabaseDetail>>&&
               db) mutable {
         db.throwIfFailed();
+        recordSnapshotBytes("subscribeAndGetFibDetail", *db.value());
         return apache::thrift::ResponseAndServerStream<
             thrift::RouteDatabaseDetail,
             thrift::RouteDatabaseDeltaDetail>{
@@ -1091,6 +1333,12 @@ OpenrCtrlHandler::semifuture_getLinkMonitorAdjacenciesFiltered(
   return linkMonitor_->semifuture_getAdjacencies(std::move(*filter));
 }
 
+folly::SemiFuture<std::unique_ptr<std::vector<thrift::AdjacencyDampeningState>>>
+OpenrCtrlHandler::semifuture_getAdjacencyDampeningState() {
+  CHECK(linkMonitor_);
+  return linkMonitor_->semifuture_getAdjacencyDampeningState();
+}
+
 //
 // ConfigStore API
 //
@@ -7,7 +7,14 @@
 
 #pragma once
 
+#include <deque>
+
 #include <fb303/BaseService.h>
+#include <fb303/ServiceData.h>
+#include <folly/container/EvictingCacheMap.h>
+#include <openr/common/Constants.h>
+#include <openr/common/MemoryPressure.h>
+#include <openr/common/SharedExecutor.h>
 #include <openr/common/Types.h>
 #include <openr/config-store/PersistentStore.h>
 #include <openr/config/Config.h>
@@ -79,6 +86,9 @@ class OpenrCtrlHandler final : public thrift::OpenrCtrlCppSvIf,
 
   void getEventLogs(std::vector<::std::string>& _return) override;
 
+  folly::SemiFuture<std::unique_ptr<std::string>> semifuture_dumpCpuProfile(
+      int64_t durationMs, std::unique_ptr<std::string> threadName) override;
+
   //
   // PrefixManager APIs
   //
@@ -192,6 +202,10 @@ class OpenrCtrlHandler final : public thrift::OpenrCtrlCppSvIf,
   folly::SemiFuture<std::unique_ptr<thrift::RouteDatabase>>
   semifuture_getRouteDbComputed(std::unique_ptr<std::string> nodeName) override;
 
+  folly::SemiFuture<std::unique_ptr<thrift::RouteDatabaseDelta>>
+  semifuture_getRouteDbSimulated(
+      std::unique_ptr<thrift::RouteSimulationRequest> request) override;
+
   //
   // KvStore APIs
   //
@@ -223,10 +237,23 @@ class OpenrCtrlHandler final : public thrift::OpenrCtrlCppSvIf,
       std::unique_ptr<thrift::KeyDumpParams> filter,
       std::unique_ptr<std::string> area) override;
 
+  folly::SemiFuture<std::unique_ptr<thrift::KvStoreMerkleDigests>>
+  semifuture_getKvStoreMerkleDigestsArea(
+      std::unique_ptr<std::string> area) override;
+
   folly::SemiFuture<folly::Unit> semifuture_setKvStoreKeyVals(
       std::unique_ptr<thrift::KeySetParams> setParams,
       std::unique_ptr<std::string> area) override;
 
+  apache::thrift::ServerStream<thrift::Publication>
+  getKvStoreKeyValsFilteredAreaStream(
+      std::unique_ptr<thrift::KeyDumpParams> filter,
+      std::unique_ptr<std::string> area) override;
+
+  folly::SemiFuture<folly::Unit> semifuture_setKvStoreTtlUpdates(
+      std::unique_ptr<thrift::KvStoreTtlUpdates> ttlUpdates,
+      std::unique_ptr<std::string> area) override;
+
   folly::SemiFuture<folly::Unit> semifuture_processKvStoreDualMessage(
       std::unique_ptr<thrift::DualMessages> messages,
       std::unique_ptr<std::string> area) override;
@@ -260,6 +287,21 @@ class OpenrCtrlHandler final : public thrift::OpenrCtrlCppSvIf,
   apache::thrift::ServerStream<thrift::RouteDatabaseDeltaDetail>
   subscribeFibDetail();
 
+  // Chunked dump API's. Chunks are built on `dumpStrand_` off a snapshot
+  // of the module state.
+  apache::thrift::ServerStream<thrift::RouteDatabase> getRouteDbStream()
+      override;
+
+  apache::thrift::ServerStream<thrift::RouteDatabaseDetail>
+  getRouteDetailDbStream() override;
+
+  apache::thrift::ServerStream<std::vector<thrift::ReceivedRouteDetail>>
+  getReceivedRoutesStream(
+      std::unique_ptr<thrift::ReceivedRouteFilter> filter) override;
+
+  apache::thrift::ServerStream<thrift::PrefixDbs> getDecisionPrefixDbsStream()
+      override;
+
   folly::SemiFuture<apache::thrift::ResponseAndServerStream<
       thrift::Publication,
       thrift::Publication>>
@@ -332,10 +374,16 @@ class OpenrCtrlHandler final : public thrift::OpenrCtrlCppSvIf,
   semifuture_getLinkMonitorAdjacenciesFiltered(
       std::unique_ptr<thrift::AdjacenciesFilter> filter) override;
 
+  folly::SemiFuture<
+      std::unique_ptr<std::vector<thrift::AdjacencyDampeningState>>>
+  semifuture_getAdjacencyDampeningState() override;
+
   // Explicitly override blocking API call as no ASYNC needed
   void getOpenrVersion(thrift::OpenrVersions& openrVersion) override;
   void getBuildInfo(thrift::BuildInfo& buildInfo) override;
 
+  void getTraceSpans(std::vector<thrift::TraceSpan>& spans) override;
+
   //
   // PersistentStore APIs
   //
@@ -373,7 +421,11 @@ class OpenrCtrlHandler final : public thrift::OpenrCtrlCppSvIf,
 
   inline size_t
   getNumPendingLongPollReqs() {
-    return longPollReqs_->size();
+    size_t numReqs{0};
+    for (auto const& [_, pendingLongPolls] : *longPollReqs_.rlock()) {
+      numReqs += pendingLongPolls.reqs.size();
+    }
+    return numReqs;
   }
 
   inline size_t
@@ -403,6 +455,108 @@ class OpenrCtrlHandler final : public thrift::OpenrCtrlCppSvIf,
   void closeKvStorePublishers();
   void closeFibPublishers();
 
+  // Response of a read API along with generation of the module state it is
+  // built from
+  template <typename Response>
+  struct CachedResponse {
+    int64_t generation{0};
+    std::shared_ptr<const Response> response;
+  };
+
+  // Cached responses of a read API, keyed by its arguments
+  template <typename Response>
+  using ResponseCache = folly::Synchronized<
+      folly::EvictingCacheMap<std::string, CachedResponse<Response>>>;
+
+  // Return copy of cached response for `key` if module state is still at
+  // `generation`. Otherwise build response with `build()` and cache it.
+  // Generation is read before building, hence a response racing with a
+  // change of the module state is never served past the change.
+  template <typename Response, typename Build>
+  folly::SemiFuture<std::unique_ptr<Response>>
+  getCachedResponse(
+      ResponseCache<Response>& cache,
+      std::string key,
+      int64_t generation,
+      Build&& build) {
+    std::shared_ptr<const Response> cached;
+    {
+      auto lockedCache = cache.rlock();
+      auto it = lockedCache->findWithoutPromotion(key);
+      if (it != lockedCache->end() and it->second.generation == generation) {
+        cached = it->second.response;
+      }
+    }
+    if (cached) {
+      facebook::fb303::fbData->addStatValue(
+          "ctrl.response_cache.hits", 1, facebook::fb303::SUM);
+      return folly::makeSemiFuture(std::make_unique<Response>(*cached));
+    }
+    facebook::fb303::fbData->addStatValue(
+        "ctrl.response_cache.misses", 1, facebook::fb303::SUM);
+    return build().deferValue(
+        [&cache, key = std::move(key), generation](
+            std::unique_ptr<Response>&& response) {
+          cache.wlock()->set(
+              key,
+              CachedResponse<Response>{
+                  generation, std::make_shared<const Response>(*response)});
+          return std::move(response);
+        });
+  }
+
+  // Stream chunks produced by `makeChunks(snapshot, publish)` once snapshot
+  // is ready. Chunks are built on `dumpStrand_`, hence never on the thread
+  // of the module the snapshot is taken from. Stream fails right away under
+  // memory pressure.
+  template <typename Chunk, typename Snapshot, typename MakeChunks>
+  apache::thrift::ServerStream<Chunk>
+  streamSnapshot(
+      folly::SemiFuture<std::unique_ptr<Snapshot>> snapshot,
+      MakeChunks makeChunks) {
+    auto streamAndPublisher =
+        apache::thrift::ServerStream<Chunk>::createPublisher();
+    if (MemoryPressure::isUnderPressure()) {
+      // don't build up chunk backlogs while shedding memory
+      std::move(streamAndPublisher.second)
+          .complete(folly::make_exception_wrapper<thrift::OpenrError>(
+              "Stream refused under memory pressure"));
+      return std::move(streamAndPublisher.first);
+    }
+    std::move(snapshot)
+        .via(dumpStrand_.copy())
+        .thenTry([publisher = std::move(streamAndPublisher.second),
+                  makeChunks = std::move(makeChunks)](
+                     folly::Try<std::unique_ptr<Snapshot>>&& snapshot) mutable {
+          if (snapshot.hasException()) {
+            std::move(publisher).complete(std::move(snapshot.exception()));
+            return;
+          }
+          makeChunks(**snapshot, [&publisher](Chunk&& chunk) {
+            publisher.next(std::move(chunk));
+          });
+          std::move(publisher).complete();
+        });
+    return std::move(streamAndPublisher.first);
+  }
+
+  // Publish one converted update to every stream in `publishers`. All but
+  // the last stream get a copy of the shared update, the last one takes it.
+  template <typename Publishers, typename Update>
+  static void
+  publishToAll(folly::Synchronized<Publishers>& publishers, Update&& update) {
+    publishers.withWLock([&update](auto& lockedPublishers) {
+      size_t remaining = lockedPublishers.size();
+      for (auto& [_, publisher] : lockedPublishers) {
+        if (--remaining) {
+          publisher.next(std::as_const(update));
+        } else {
+          publisher.next(std::forward<Update>(update));
+        }
+      }
+    });
+  }
+
   const std::string nodeName_;
   const std::unordered_set<std::string> acceptablePeerCommonNames_;
 
@@ -421,9 +575,7 @@ class OpenrCtrlHandler final : public thrift::OpenrCtrlCppSvIf,
   std::atomic<int64_t> publisherToken_{0};
 
   // Active kvstore snoop publishers
-  folly::Synchronized<
-      std::unordered_map<int64_t, std::unique_ptr<KvStorePublisher>>>
-      kvStorePublishers_;
+  folly::Synchronized<KvStorePublisherDispatcher> kvStorePublishers_;
 
   // Active Fib streaming publishers
   folly::Synchronized<std::unordered_map<
@@ -437,15 +589,47 @@ class OpenrCtrlHandler final : public thrift::OpenrCtrlCppSvIf,
       apache::thrift::ServerStreamPublisher<thrift::RouteDatabaseDeltaDetail>>>
       fibDetailPublishers_;
 
-  // pending longPoll requests from clients, which consists of
-  // 1). promise; 2). timestamp when req received on server
-  std::atomic<int64_t> pendingRequestId_{0};
-  folly::Synchronized<std::unordered_map<
-      std::string /* area */,
-      std::unordered_map<int64_t, std::pair<folly::Promise<bool>, int64_t>>>>
+  // pending longPoll requests from clients of an area
+  struct PendingLongPolls {
+    // bumped on every "adj:" key change in the area. Request is resolved
+    // right away if generation moved on while it was checked against KvStore.
+    int64_t adjGeneration{0};
+
+    // requests in order of arrival, hence in order of expiry, which consist
+    // of 1). promise; 2). timestamp when req received on server
+    std::deque<std::pair<folly::Promise<bool>, int64_t>> reqs;
+  };
+
+  // pending longPoll requests indexed by area. Publication resolves or
+  // expires requests of its area without scanning the rest.
+  folly::Synchronized<
+      std::unordered_map<std::string /* area */, PendingLongPolls>>
       longPollReqs_;
 
   // fiber task future hold for kvStore update, fib update reader's
   std::vector<folly::Future<folly::Unit>> workers_;
+
+  // Strand building chunks of streaming dump API's
+  SharedExecutor::Strand dumpStrand_;
+
+  // Responses of read API's polled by monitoring, see getCachedResponse()
+  ResponseCache<thrift::RouteDatabase> routeDbCache_{
+      folly::EvictingCacheMap<
+          std::string,
+          CachedResponse<thrift::RouteDatabase>>(
+          Constants::kCtrlResponseCacheSize)};
+  ResponseCache<std::vector<thrift::KvStoreAreaSummary>> areaSummaryCache_{
+      folly::EvictingCacheMap<
+          std::string,
+          CachedResponse<std::vector<thrift::KvStoreAreaSummary>>>(
+          Constants::kCtrlResponseCacheSize)};
+  ResponseCache<std::vector<thrift::SparkNeighbor>> neighborsCache_{
+      folly::EvictingCacheMap<
+          std::string,
+          CachedResponse<std::vector<thrift::SparkNeighbor>>>(
+          Constants::kCtrlResponseCacheSize)};
+
+  // drops cached responses under memory pressure
+  std::unique_ptr<MemoryPressure::Shedder> memoryShedder_;
 }; // class OpenrCtrlHandler
 } // namespace openr
@@ -9,6 +9,7 @@
 #include <thread>
 
 #include <folly/init/Init.h>
+#include <folly/synchronization/Baton.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -232,7 +233,7 @@ class OpenrCtrlFixture : public ::testing::Test {
 
  private:
   messaging::ReplicateQueue<DecisionRouteUpdate> routeUpdatesQueue_;
-  messaging::ReplicateQueue<InterfaceDatabase> interfaceUpdatesQueue_;
+  messaging::ReplicateQueue<InterfaceUpdate> interfaceUpdatesQueue_;
   messaging::ReplicateQueue<PeerEvent> peerUpdatesQueue_;
   messaging::ReplicateQueue<NeighborEvents> neighborUpdatesQueue_;
   messaging::ReplicateQueue<PrefixEvent> prefixUpdatesQueue_;
@@ -334,6 +335,14 @@ TEST_F(OpenrCtrlFixture, RouteApis) {
     EXPECT_EQ(0, db.mplsRoutes_ref()->size());
   }
 
+  {
+    // Repeated poll is served from cache as long as routes are unchanged
+    thrift::RouteDatabase db1, db2;
+    client_->sync_getRouteDb(db1);
+    client_->sync_getRouteDb(db2);
+    EXPECT_EQ(db1, db2);
+  }
+
   {
     thrift::RouteDatabase db;
     client_->sync_getRouteDbComputed(db, nodeName_);
@@ -376,6 +385,40 @@ TEST_F(OpenrCtrlFixture, RouteApis) {
   }
 }
 
+TEST_F(OpenrCtrlFixture, DumpStreamApis) {
+  auto handler = openrThriftServerWrapper_->getOpenrCtrlHandler();
+
+  // Consume stream till completion and return number of chunks
+  auto countChunks = [](auto&& stream) {
+    folly::Baton<> baton;
+    size_t numChunks{0};
+    auto subscription =
+        std::move(stream).toClientStreamUnsafeDoNotUse().subscribeExTry(
+            folly::getEventBase(), [&](auto&& t) {
+              if (t.hasValue()) {
+                ++numChunks;
+                return;
+              }
+              EXPECT_FALSE(t.hasException());
+              baton.post();
+            });
+    baton.wait();
+    std::move(subscription).detach();
+    return numChunks;
+  };
+
+  // Empty dumps complete without any chunk
+  EXPECT_EQ(0, countChunks(handler->getRouteDbStream()));
+  EXPECT_EQ(0, countChunks(handler->getRouteDetailDbStream()));
+  EXPECT_EQ(
+      0,
+      countChunks(handler->getReceivedRoutesStream(
+          std::make_unique<thrift::ReceivedRouteFilter>())));
+
+  // Multiple areas are configured
+  EXPECT_THROW(handler->getDecisionPrefixDbsStream(), thrift::OpenrError);
+}
+
 TEST_F(OpenrCtrlFixture, PerfApis) {
   thrift::PerfDatabase db;
   client_->sync_getPerfDb(db);
@@ -16,13 +16,16 @@
 #include <folly/Memory.h>
 #include <folly/Optional.h>
 #include <folly/String.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
 #include <folly/futures/Future.h>
 #ifndef NO_FOLLY_EXCEPTION_TRACER
 #include <folly/experimental/exception_tracer/ExceptionTracer.h>
 #endif
 
 #include <openr/common/Constants.h>
+#include <openr/common/HotPathTrace.h>
 #include <openr/common/NetworkUtil.h>
+#include <openr/common/SharedExecutor.h>
 #include <openr/common/Util.h>
 #include <openr/decision/Decision.h>
 #include <openr/decision/PrefixState.h>
@@ -40,10 +43,11 @@ DecisionPendingUpdates::applyLinkStateChange(
     LinkState::LinkStateChange const& change,
     apache::thrift::optional_field_ref<thrift::PerfEvents const&> perfEvents) {
   needsFullRebuild_ |=
-      (change.topologyChanged || change.nodeLabelChanged ||
+      (change.nodeLabelChanged ||
        // we only need a full rebuild if link attributes change locally
        // this would be a nexthop or link label change
        (change.linkAttributesChanged && nodeName == myNodeName_));
+  topologyChanged_ |= change.topologyChanged;
   addUpdate(perfEvents);
 }
 
@@ -58,8 +62,11 @@ DecisionPendingUpdates::applyPrefixStateChange(
 void
 DecisionPendingUpdates::reset() {
   count_ = 0;
+  firstUpdateTime_ = std::nullopt;
   perfEvents_ = std::nullopt;
   needsFullRebuild_ = false;
+  topologyChanged_ = false;
+  urgent_ = false;
   updatedPrefixes_.clear();
 }
 
@@ -79,7 +86,9 @@ DecisionPendingUpdates::moveOutEvents() {
 void
 DecisionPendingUpdates::addUpdate(
     apache::thrift::optional_field_ref<thrift::PerfEvents const&> perfEvents) {
-  ++count_;
+  if (count_++ == 0) {
+    firstUpdateTime_ = std::chrono::steady_clock::now();
+  }
 
   // Update local copy of perf evens if it is newer than the one to be added
   // We do debounce (batch updates) for recomputing routes and in order to
@@ -97,6 +106,113 @@ DecisionPendingUpdates::addUpdate(
 }
 } // namespace detail
 
+namespace {
+
+// Last prefix database of expired prefix `key` as carried by `pub`, marked as
+// withdrawn. std::nullopt if the publication has no value of the key.
+std::optional<thrift::PrefixDatabase>
+getExpiredPrefixDb(
+    thrift::Publication const& pub,
+    std::string const& key,
+    apache::thrift::CompactSerializer& serializer) {
+  auto expiredKeyVals = pub.expiredKeyVals_ref();
+  if (not expiredKeyVals or
+      key.find(Constants::kPrefixDbMarker.toString()) != 0) {
+    return std::nullopt;
+  }
+  auto it = expiredKeyVals->find(key);
+  if (it == expiredKeyVals->end() or not it->second.value_ref().has_value()) {
+    return std::nullopt;
+  }
+  try {
+    auto prefixDb = readThriftObjStr<thrift::PrefixDatabase>(
+        *it->second.value_ref(), serializer);
+    prefixDb.deletePrefix_ref() = true;
+    prefixDb.perfEvents_ref().reset();
+    return prefixDb;
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Failed to deserialize expired value of key " << key
+               << ". Exception: " << folly::exceptionStr(e);
+    return std::nullopt;
+  }
+}
+
+std::unique_ptr<SpfSolver>
+createSpfSolver(std::shared_ptr<const Config> const& config) {
+  return std::make_unique<SpfSolver>(
+      config,
+      config->getNodeName(),
+      config->isV4Enabled(),
+      config->isSegmentRoutingEnabled(),
+      config->isAdjacencyLabelsEnabled(),
+      config->isBgpRouteProgrammingEnabled(),
+      config->isBestRouteSelectionEnabled(),
+      config->isV4OverV6NexthopEnabled(),
+      config->getSegmentRoutingPolicyConfig(),
+      config->getAreaPolicies());
+}
+
+// adjacency databases of every node, per area
+using AreaAdjacencyDbs = std::unordered_map<
+    std::string /* area */,
+    std::vector<thrift::AdjacencyDatabase>>;
+
+// Build routes of `myNodeName` on link states rebuilt from `areaAdjDbs` with
+// hypothetical changes of `request` applied, if any
+DecisionRouteDb
+buildSimulatedRouteDb(
+    SpfSolver& spfSolver,
+    std::string const& myNodeName,
+    AreaAdjacencyDbs const& areaAdjDbs,
+    PrefixState const& prefixState,
+    thrift::RouteSimulationRequest const* request) {
+  std::unordered_map<std::string, LinkState> areaLinkStates;
+  for (auto const& [area, adjDbs] : areaAdjDbs) {
+    auto& linkState = areaLinkStates.emplace(area, area).first->second;
+    for (auto const& adjDb : adjDbs) {
+      auto const& nodeName = *adjDb.thisNodeName_ref();
+      if (not request) {
+        linkState.updateAdjacencyDatabase(adjDb);
+        continue;
+      }
+      if (request->downNodes_ref()->count(nodeName)) {
+        continue;
+      }
+      auto simulatedAdjDb = adjDb;
+      if (request->drainNodes_ref()->count(nodeName)) {
+        simulatedAdjDb.isOverloaded_ref() = true;
+      }
+      linkState.updateAdjacencyDatabase(simulatedAdjDb);
+    }
+  }
+  auto maybeRouteDb =
+      spfSolver.buildRouteDb(myNodeName, areaLinkStates, prefixState);
+  return maybeRouteDb.has_value() ? std::move(maybeRouteDb).value()
+                                  : DecisionRouteDb{};
+}
+
+} // namespace
+
+struct Decision::RouteComputationState {
+  AreaAdjacencyDbs areaAdjDbs;
+  PrefixState prefixState;
+  StaticUnicastRoutes staticUnicastRoutes;
+  StaticMplsRoutes staticMplsRoutes;
+
+  // routes computed on this snapshot, per node
+  folly::Synchronized<std::unordered_map<
+      std::string /* nodeName */,
+      std::shared_ptr<const thrift::RouteDatabase>>>
+      routeDbs;
+
+  std::shared_ptr<const thrift::RouteDatabase>
+  getRouteDb(std::string const& nodeName) const {
+    auto lockedRouteDbs = routeDbs.rlock();
+    auto it = lockedRouteDbs->find(nodeName);
+    return it != lockedRouteDbs->end() ? it->second : nullptr;
+  }
+};
+
 //
 // Decision class implementation
 //
@@ -111,6 +227,14 @@ Decision::Decision(
     : config_(config),
       routeUpdatesQueue_(routeUpdatesQueue),
       myNodeName_(*config->getConfig().node_name_ref()),
+      enableUrgentLocalAdjDown_(
+          *config->getConfig()
+               .decision_config_ref()
+               ->enable_urgent_local_adj_down_ref()),
+      spfMemoizationBudgetBytes_(
+          *config->getConfig()
+               .decision_config_ref()
+               ->spf_memoization_budget_bytes_ref()),
       pendingUpdates_(*config->getConfig().node_name_ref()),
       rebuildRoutesDebounced_(
           getEvb(),
@@ -121,17 +245,8 @@ Decision::Decision(
                                          .decision_config_ref()
                                          ->debounce_max_ms_ref()),
           [this]() noexcept { rebuildRoutes("DECISION_DEBOUNCE"); }) {
-  spfSolver_ = std::make_unique<SpfSolver>(
-      config,
-      config->getNodeName(),
-      config->isV4Enabled(),
-      config->isSegmentRoutingEnabled(),
-      config->isAdjacencyLabelsEnabled(),
-      config->isBgpRouteProgrammingEnabled(),
-      config->isBestRouteSelectionEnabled(),
-      config->isV4OverV6NexthopEnabled(),
-      config->getSegmentRoutingPolicyConfig(),
-      config->getAreaPolicies());
+  spfSolver_ = createSpfSolver(config);
+  simulationStrand_ = SharedExecutor::makeStrand();
 
   // TODO: Remove coldStartTimer_ and eor_time_s_ref from config after OpenR
   // initialization procedure.
@@ -155,46 +270,80 @@ Decision::Decision(
   });
   counterUpdateTimer_->scheduleTimeout(Constants::kCounterSubmitInterval);
 
-  // Add reader to process publication from KvStore
-  addFiberTask([q = std::move(kvStoreUpdatesQueue), this]() mutable noexcept {
-    LOG(INFO) << "Starting KvStore updates processing fiber";
-    while (true) {
-      auto maybePub = q.get(); // perform read
-      VLOG(2) << "Received KvStore update";
-      if (maybePub.hasError()) {
-        LOG(INFO) << "Terminating KvStore updates processing fiber";
-        break;
+  // Memoization is rebuilt on demand by next route computation
+  memoryShedder_ =
+      MemoryPressure::addShedder("decision", getEvb(), [this]() noexcept {
+        for (auto& [_, linkState] : areaLinkStates_) {
+          linkState.clearMemoization();
+        }
+      });
+
+  if (*config->getConfig()
+           .decision_config_ref()
+           ->enable_pipelined_ingest_ref()) {
+    // Read and deserialize publications from KvStore off the Decision thread
+#if FOLLY_HAS_COROUTINES
+    addCoroTask(
+        ingestKvStoreUpdates(std::move(kvStoreUpdatesQueue)),
+        SharedExecutor::makeStrand());
+#else
+    ingestExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+        1, std::make_shared<folly::NamedThreadFactory>("DecisionIngest"));
+    ingestExecutor_->add([q = std::move(kvStoreUpdatesQueue), this]() mutable {
+      LOG(INFO) << "Starting KvStore updates ingest thread";
+      apache::thrift::CompactSerializer serializer;
+      while (true) {
+        auto maybePub = q.get(); // perform read
+        VLOG(2) << "Received KvStore update";
+        if (maybePub.hasError()) {
+          LOG(INFO) << "Terminating KvStore updates ingest thread";
+          break;
+        }
+        ingestKvStoreUpdate(maybePub.value(), serializer);
       }
-      try {
-        auto& pub = maybePub.value();
-        // kvStoreSynced and tPublication are exclusive with each other.
-        if (pub.kvStoreSynced) {
-          // In OpenR initialization procedure, receiving kvStoreSynced signal
-          // indicates Decision has received all KvStore publications, and is
-          // ready to start initial RIB computation.
-          LOG(INFO) << "[Initialization] KVSOTORE_SYNCED signal is received";
-          initialKvStoreSynced_ = true;
-          pendingUpdates_.setNeedsFullRebuild();
-        } else {
-          processPublication(std::move(pub.tPublication));
+    });
+#endif
+  } else {
+    // Add reader to process publication from KvStore
+    addFiberTask([q = std::move(kvStoreUpdatesQueue), this]() mutable noexcept {
+      LOG(INFO) << "Starting KvStore updates processing fiber";
+      while (true) {
+        auto maybePub = q.get(); // perform read
+        VLOG(2) << "Received KvStore update";
+        if (maybePub.hasError()) {
+          LOG(INFO) << "Terminating KvStore updates processing fiber";
+          break;
         }
-      } catch (const std::exception& e) {
+        try {
+          auto& pub = maybePub.value();
+          // kvStoreSynced and tPublication are exclusive with each other.
+          if (pub.kvStoreSynced) {
+            // In OpenR initialization procedure, receiving kvStoreSynced signal
+            // indicates Decision has received all KvStore publications, and is
+            // ready to start initial RIB computation.
+            LOG(INFO) << "[Initialization] KVSOTORE_SYNCED signal is received";
+            initialKvStoreSynced_ = true;
+            pendingUpdates_.setNeedsFullRebuild();
+          } else if (pub.kvStoreWarmStarted) {
+            processKvStoreWarmStarted();
+          } else {
+            processPublication(*pub.tPublication);
+          }
+        } catch (const std::exception& e) {
 #ifndef NO_FOLLY_EXCEPTION_TRACER
-        // collect stack strace then fail the process
-        for (auto& exInfo : folly::exception_tracer::getCurrentExceptions()) {
-          LOG(ERROR) << exInfo;
-        }
+          // collect stack strace then fail the process
+          for (auto& exInfo : folly::exception_tracer::getCurrentExceptions()) {
+            LOG(ERROR) << exInfo;
+          }
 #endif
-        // FATAL to produce core dump
-        LOG(FATAL) << "Exception occured in Decision::processPublication - "
-                   << folly::exceptionStr(e);
-      }
-      // compute routes with exponential backoff timer if needed
-      if (pendingUpdates_.needsRouteUpdate()) {
-        rebuildRoutesDebounced_();
+          // FATAL to produce core dump
+          LOG(FATAL) << "Exception occured in Decision::processPublication - "
+                     << folly::exceptionStr(e);
+        }
+        scheduleRebuildRoutes();
       }
-    }
-  });
+    });
+  }
 
   // Add reader to process static routes publication from prefix-manager
   addFiberTask(
@@ -221,28 +370,151 @@ Decision::Decision(
   // Initialize some stat keys
   fb303::fbData->addStatExportType(
       "decision.rib_policy_processing.time_ms", fb303::AVG);
+  fb303::fbData->addStatExportType(
+      "decision.route_db_snapshot_copies", fb303::COUNT);
+  fb303::fbData->addStatExportType(
+      "decision.computed_route_db_cache_hits", fb303::COUNT);
 }
 
 folly::SemiFuture<std::unique_ptr<thrift::RouteDatabase>>
 Decision::getDecisionRouteDb(std::string nodeName) {
-  folly::Promise<std::unique_ptr<thrift::RouteDatabase>> p;
-  auto sf = p.getSemiFuture();
-  runInEventBaseThread([p = std::move(p), nodeName, this]() mutable {
-    thrift::RouteDatabase routeDb;
+  if (nodeName.empty() or nodeName == myNodeName_) {
+    // serialize own routes without waiting for Decision thread
+    auto routeDb = std::make_unique<thrift::RouteDatabase>(
+        getDecisionRouteDbSnapshot()->toThrift());
+    *routeDb->thisNodeName_ref() = myNodeName_;
+    return folly::makeSemiFuture(std::move(routeDb));
+  }
 
-    if (nodeName.empty()) {
-      nodeName = myNodeName_;
+  auto [p, sf] =
+      folly::makePromiseContract<std::unique_ptr<thrift::RouteDatabase>>();
+  runInEventBaseThread([this,
+                        p = std::move(p),
+                        nodeName = std::move(nodeName)]() mutable noexcept {
+    applyPendingKeyVals();
+    if (pendingUpdates_.needsRouteUpdate()) {
+      routeComputationState_.reset();
     }
-    auto maybeRouteDb =
-        spfSolver_->buildRouteDb(nodeName, areaLinkStates_, prefixState_);
-    if (maybeRouteDb.has_value()) {
-      routeDb = maybeRouteDb->toThrift();
+    if (not routeComputationState_) {
+      routeComputationState_ = makeRouteComputationState();
+    }
+    if (auto routeDb = routeComputationState_->getRouteDb(nodeName)) {
+      fb303::fbData->addStatValue(
+          "decision.computed_route_db_cache_hits", 1, fb303::COUNT);
+      p.setValue(std::make_unique<thrift::RouteDatabase>(*routeDb));
+      return;
     }
 
-    *routeDb.thisNodeName_ref() = nodeName;
-    p.setValue(std::make_unique<thrift::RouteDatabase>(std::move(routeDb)));
+    // Built off the Decision thread, hence live route computation doesn't
+    // wait on audits of other nodes' routes. Requests queued for the same
+    // node are served by the first one computed.
+    simulationStrand_->add([config = config_,
+                              state = routeComputationState_,
+                              nodeName = std::move(nodeName),
+                              p = std::move(p)]() mutable {
+      auto routeDb = state->getRouteDb(nodeName);
+      if (not routeDb) {
+        auto spfSolver = createSpfSolver(config);
+        spfSolver->updateStaticUnicastRoutes(state->staticUnicastRoutes, {});
+        spfSolver->updateStaticMplsRoutes(state->staticMplsRoutes, {});
+        auto computed = std::make_shared<thrift::RouteDatabase>(
+            buildSimulatedRouteDb(
+                *spfSolver,
+                nodeName,
+                state->areaAdjDbs,
+                state->prefixState,
+                nullptr)
+                .toThrift());
+        *computed->thisNodeName_ref() = nodeName;
+        state->routeDbs.wlock()->emplace(nodeName, computed);
+        routeDb = std::move(computed);
+      }
+      p.setValue(std::make_unique<thrift::RouteDatabase>(*routeDb));
+    });
   });
-  return sf;
+  return std::move(sf);
+}
+
+std::shared_ptr<Decision::RouteComputationState>
+Decision::makeRouteComputationState() const {
+  // Prefix entries are immutable hence shared with the copy. Link state is
+  // rebuilt from adjacency databases, as links are mutated in place.
+  auto state = std::make_shared<RouteComputationState>();
+  for (auto const& [area, linkState] : areaLinkStates_) {
+    auto& adjDbs = state->areaAdjDbs[area];
+    for (auto const& [_, adjDb] : linkState.getAdjacencyDatabases()) {
+      adjDbs.emplace_back(adjDb);
+    }
+  }
+  state->prefixState = prefixState_;
+  state->staticUnicastRoutes = spfSolver_->getStaticUnicastRoutes();
+  state->staticMplsRoutes = spfSolver_->getStaticMplsRoutes();
+  return state;
+}
+
+std::shared_ptr<const DecisionRouteDb>
+Decision::getDecisionRouteDbSnapshot() const {
+  return *routeDbSnapshot_.rlock();
+}
+
+folly::SemiFuture<std::unique_ptr<thrift::RouteDatabaseDelta>>
+Decision::getRouteDbSimulated(thrift::RouteSimulationRequest request) {
+  auto [p, sf] =
+      folly::makePromiseContract<std::unique_ptr<thrift::RouteDatabaseDelta>>();
+  runInEventBaseThread([this,
+                        p = std::move(p),
+                        request = std::move(request)]() mutable noexcept {
+    applyPendingKeyVals();
+    for (auto const* nodes :
+         {&*request.drainNodes_ref(), &*request.downNodes_ref()}) {
+      for (auto const& node : *nodes) {
+        bool nodeExist{false};
+        for (auto const& [_, linkState] : areaLinkStates_) {
+          nodeExist |= linkState.hasNode(node);
+        }
+        if (not nodeExist) {
+          thrift::OpenrError error;
+          error.message_ref() = fmt::format("Unknown node {}", node);
+          p.setException(error);
+          return;
+        }
+      }
+    }
+
+    // Snapshot state, prefix entries are immutable hence shared with the
+    // copy. Link state is rebuilt from adjacency databases on simulation
+    // thread as links are mutated in place.
+    AreaAdjacencyDbs areaAdjDbs;
+    for (auto const& [area, linkState] : areaLinkStates_) {
+      auto& adjDbs = areaAdjDbs[area];
+      for (auto const& [_, adjDb] : linkState.getAdjacencyDatabases()) {
+        adjDbs.emplace_back(adjDb);
+      }
+    }
+    simulationStrand_->add([config = config_,
+                              myNodeName = myNodeName_,
+                              areaAdjDbs = std::move(areaAdjDbs),
+                              prefixState = prefixState_,
+                              staticUnicastRoutes =
+                                  spfSolver_->getStaticUnicastRoutes(),
+                              staticMplsRoutes =
+                                  spfSolver_->getStaticMplsRoutes(),
+                              request = std::move(request),
+                              p = std::move(p)]() mutable {
+      // reachability differs once nodes are drained or down
+      prefixState.resetReachableNodes();
+      auto spfSolver = createSpfSolver(config);
+      spfSolver->updateStaticUnicastRoutes(staticUnicastRoutes, {});
+      spfSolver->updateStaticMplsRoutes(staticMplsRoutes, {});
+      auto routeDb = buildSimulatedRouteDb(
+          *spfSolver, myNodeName, areaAdjDbs, prefixState, nullptr);
+      auto delta = routeDb.calculateUpdate(buildSimulatedRouteDb(
+          *spfSolver, myNodeName, areaAdjDbs, prefixState, &request));
+      p.setValue(
+          std::make_unique<thrift::RouteDatabaseDelta>(delta.toThrift()));
+    });
+  });
+  return std::move(sf);
 }
 
 folly::SemiFuture<std::unique_ptr<std::vector<thrift::AdjacencyDatabase>>>
@@ -251,6 +523,7 @@ Decision::getDecisionAdjacenciesFiltered(thrift::AdjacenciesFilter filter) {
   auto sf = p.getSemiFuture();
   runInEventBaseThread(
       [p = std::move(p), filter = std::move(filter), this]() mutable {
+        applyPendingKeyVals();
         auto res = std::make_unique<std::vector<thrift::AdjacencyDatabase>>();
         for (auto const& [area, linkState] : areaLinkStates_) {
           if (filter.get_selectAreas().empty() ||
@@ -272,6 +545,7 @@ Decision::getReceivedRoutesFiltered(thrift::ReceivedRouteFilter filter) {
   runInEventBaseThread(
       [this, p = std::move(p), filter = std::move(filter)]() mutable noexcept {
         try {
+          applyPendingKeyVals();
           // Get route details
           auto routes = prefixState_.getReceivedRoutesFiltered(filter);
 
@@ -305,6 +579,82 @@ Decision::getReceivedRoutesFiltered(thrift::ReceivedRouteFilter filter) {
   return std::move(sf);
 }
 
+folly::SemiFuture<std::unique_ptr<std::vector<Decision::ReceivedRouteSnapshot>>>
+Decision::getReceivedRoutesSnapshot(thrift::ReceivedRouteFilter filter) {
+  auto [p, sf] = folly::makePromiseContract<
+      std::unique_ptr<std::vector<ReceivedRouteSnapshot>>>();
+  runInEventBaseThread(
+      [this, p = std::move(p), filter = std::move(filter)]() mutable noexcept {
+        try {
+          applyPendingKeyVals();
+          auto snapshot =
+              std::make_unique<std::vector<ReceivedRouteSnapshot>>();
+          auto const& bestRoutesCache = spfSolver_->getBestRoutesCache();
+          auto addPrefix = [&](folly::CIDRNetwork const& prefix,
+                               PrefixEntries const& prefixEntries) {
+            if (prefixEntries.empty()) {
+              return;
+            }
+            auto& route = snapshot->emplace_back();
+            route.prefix = prefix;
+            route.prefixEntries = prefixEntries;
+            auto bestRoutesIt = bestRoutesCache.find(prefix);
+            if (bestRoutesIt != bestRoutesCache.end()) {
+              route.allNodeAreas = bestRoutesIt->second.allNodeAreas;
+              route.bestNodeArea = bestRoutesIt->second.bestNodeArea;
+            }
+          };
+
+          auto const& prefixes = prefixState_.prefixes();
+          if (filter.prefixes_ref()) {
+            for (auto const& prefix : filter.prefixes_ref().value()) {
+              auto it = prefixes.find(toIPNetwork(prefix));
+              if (it != prefixes.end()) {
+                addPrefix(it->first, it->second);
+              }
+            }
+          } else {
+            snapshot->reserve(prefixes.size());
+            for (auto const& [prefix, prefixEntries] : prefixes) {
+              addPrefix(prefix, prefixEntries);
+            }
+          }
+          p.setValue(std::move(snapshot));
+        } catch (const thrift::OpenrError& e) {
+          p.setException(e);
+        }
+      });
+  return std::move(sf);
+}
+
+void
+Decision::addReceivedRoute(
+    std::vector<thrift::ReceivedRouteDetail>& routes,
+    thrift::ReceivedRouteFilter const& filter,
+    ReceivedRouteSnapshot const& snapshot) {
+  const auto numRoutes = routes.size();
+  PrefixState::filterAndAddReceivedRoute(
+      routes,
+      filter.nodeName_ref(),
+      filter.areaName_ref(),
+      snapshot.prefix,
+      snapshot.prefixEntries);
+  if (routes.size() == numRoutes or not snapshot.bestNodeArea) {
+    return;
+  }
+
+  // Add best path result
+  auto& route = routes.back();
+  for (auto const& [node, area] : snapshot.allNodeAreas) {
+    route.bestKeys_ref()->emplace_back();
+    auto& key = route.bestKeys_ref()->back();
+    key.node_ref() = node;
+    key.area_ref() = area;
+  }
+  route.bestKey_ref()->node_ref() = snapshot.bestNodeArea->first;
+  route.bestKey_ref()->area_ref() = snapshot.bestNodeArea->second;
+}
+
 folly::SemiFuture<folly::Unit>
 Decision::clearRibPolicy() {
   auto [p, sf] = folly::makePromiseContract<folly::Unit>();
@@ -332,6 +682,28 @@ Decision::clearRibPolicy() {
   return std::move(sf);
 }
 
+folly::SemiFuture<folly::Unit>
+Decision::processConfigUpdate(ConfigUpdate update) {
+  auto [p, sf] = folly::makePromiseContract<folly::Unit>();
+  runInEventBaseThread(
+      [this, p = std::move(p), update = std::move(update)]() mutable {
+        if (update.decisionDebounceChanged) {
+          auto const& decisionConfig =
+              *update.config->getConfig().decision_config_ref();
+          const std::chrono::milliseconds minBackoff{
+              *decisionConfig.debounce_min_ms_ref()};
+          const std::chrono::milliseconds maxBackoff{
+              *decisionConfig.debounce_max_ms_ref()};
+          rebuildRoutesDebounced_.setBackoff(minBackoff, maxBackoff);
+          LOG(INFO) << "[Config] Set debounce of route computation to "
+                    << minBackoff.count() << "ms - " << maxBackoff.count()
+                    << "ms";
+        }
+        p.setValue();
+      });
+  return std::move(sf);
+}
+
 folly::SemiFuture<folly::Unit>
 Decision::setRibPolicy(thrift::RibPolicy const& ribPolicyThrift) {
   auto [p, sf] = folly::makePromiseContract<folly::Unit>();
@@ -401,14 +773,13 @@ Decision::getRibPolicy() {
 }
 
 void
-Decision::processPublication(thrift::Publication&& thriftPub) {
+Decision::processPublication(thrift::Publication const& thriftPub) {
   CHECK(not thriftPub.area_ref()->empty());
   auto const& area = *thriftPub.area_ref();
 
   if (!areaLinkStates_.count(area)) {
     areaLinkStates_.emplace(area, area);
   }
-  auto& areaLinkState = areaLinkStates_.at(area);
 
   // Nothing to process if no adj/prefix db changes
   if (thriftPub.keyVals_ref()->empty() and
@@ -416,98 +787,492 @@ Decision::processPublication(thrift::Publication&& thriftPub) {
     return;
   }
 
-  // LSDB addition/update
+  // local links up before this publication, to tell loss of local adjacency
+  // from background churn
+  std::optional<LinkState::LinkSet> localUpLinks;
+  if (enableUrgentLocalAdjDown_) {
+    localUpLinks = getLocalUpLinks(area);
+  }
+
+  // LSDB addition/update. Only the newest value of a key is deserialized
+  // once routes are rebuilt.
+  auto& pendingKeyVals = pendingKeyVals_[area];
   for (const auto& [key, rawVal] : *thriftPub.keyVals_ref()) {
     if (not rawVal.value_ref().has_value()) {
       // skip TTL update
       DCHECK(*rawVal.ttlVersion_ref() > 0);
       continue;
     }
+    if (key.find(Constants::kAdjDbMarker.toString()) != 0 and
+        key.find(Constants::kPrefixDbMarker.toString()) != 0) {
+      continue;
+    }
+    if (localUpLinks and isLocalAdjKey(key)) {
+      // own adjacencies are applied right away to classify the update
+      pendingKeyVals.erase(key);
+      applyKeyVal(area, key, *rawVal.value_ref());
+      continue;
+    }
+    auto [it, inserted] = pendingKeyVals.emplace(key, *rawVal.value_ref());
+    if (not inserted) {
+      it->second = *rawVal.value_ref();
+      fb303::fbData->addStatValue(
+          "decision.superseded_key_vals", 1, fb303::COUNT);
+    }
+  }
+
+  // LSDB deletion
+  for (const auto& key : *thriftPub.expiredKeys_ref()) {
+    // deletion supersedes pending value of the key
+    pendingKeyVals.erase(key);
+    if (auto prefixDb = getExpiredPrefixDb(thriftPub, key, serializer_)) {
+      applyPrefixDb(area, key, std::move(*prefixDb));
+    } else {
+      applyExpiredKey(area, key);
+    }
+  }
+
+  if (pendingKeyVals.empty()) {
+    pendingKeyVals_.erase(area);
+  }
+
+  if (localUpLinks) {
+    auto const upLinks = getLocalUpLinks(area);
+    for (auto const& link : *localUpLinks) {
+      if (not upLinks.count(link)) {
+        pendingUpdates_.setUrgent();
+        break;
+      }
+    }
+  }
+}
 
+LinkState::LinkSet
+Decision::getLocalUpLinks(std::string const& area) const {
+  LinkState::LinkSet upLinks;
+  for (auto const& link :
+       areaLinkStates_.at(area).linksFromNode(myNodeName_)) {
+    if (link->isUp()) {
+      upLinks.insert(link);
+    }
+  }
+  return upLinks;
+}
+
+void
+Decision::applyPendingKeyVals() {
+  for (auto& [area, keyVals] : pendingKeyVals_) {
+    for (auto const& [key, value] : keyVals) {
+      applyKeyVal(area, key, value);
+    }
+  }
+  pendingKeyVals_.clear();
+}
+
+void
+Decision::applyKeyVal(
+    std::string const& area, std::string const& key, std::string const& value) {
+  try {
+    if (key.find(Constants::kAdjDbMarker.toString()) == 0) {
+      // adjacencyDb: update keys starting with "adj:"
+      applyAdjacencyDb(
+          area,
+          key,
+          readThriftObjStr<thrift::AdjacencyDatabase>(value, serializer_));
+    } else if (key.find(Constants::kPrefixDbMarker.toString()) == 0) {
+      // prefixDb: update keys starting with "prefix:"
+      applyPrefixDb(
+          area,
+          key,
+          readThriftObjStr<thrift::PrefixDatabase>(value, serializer_));
+    }
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Failed to deserialize info for key " << key
+               << ". Exception: " << folly::exceptionStr(e);
+  }
+}
+
+void
+Decision::applyAdjacencyDb(
+    std::string const& area,
+    std::string const& key,
+    thrift::AdjacencyDatabase&& adjacencyDb) {
+  if (isAdjacencyKey(key)) {
+    applyAdjacencyKey(area, key, std::move(adjacencyDb));
+    return;
+  }
+
+  auto areaIt = adjacencyKeys_.find(area);
+  if (areaIt != adjacencyKeys_.end() and
+      areaIt->second.count(adjacencyDb.get_thisNodeName())) {
+    VLOG(2) << "Ignoring " << key << ". Node advertises per adjacency keys";
+    return;
+  }
+  updateAdjacencyDatabase(area, std::move(adjacencyDb));
+}
+
+void
+Decision::updateAdjacencyDatabase(
+    std::string const& area, thrift::AdjacencyDatabase&& adjacencyDb) {
+  auto& nodeName = adjacencyDb.get_thisNodeName();
+  LinkStateMetric holdUpTtl = 0, holdDownTtl = 0;
+  adjacencyDb.area_ref() = area;
+
+  fb303::fbData->addStatValue("decision.adj_db_update", 1, fb303::COUNT);
+  pendingUpdates_.applyLinkStateChange(
+      nodeName,
+      areaLinkStates_.at(area).updateAdjacencyDatabase(
+          adjacencyDb, holdUpTtl, holdDownTtl),
+      adjacencyDb.perfEvents_ref());
+}
+
+void
+Decision::applyPrefixDb(
+    std::string const& area,
+    std::string const& key,
+    thrift::PrefixDatabase&& prefixDb) {
+  if (isPrefixDbBucketKey(key)) {
+    applyPrefixDbBucket(area, key, std::move(prefixDb));
+    return;
+  }
+
+  if (1 != prefixDb.get_prefixEntries().size()) {
+    LOG(ERROR) << "Expecting exactly one entry per prefix key";
+    fb303::fbData->addStatValue("decision.error", 1, fb303::COUNT);
+    return;
+  }
+  auto const& entry = prefixDb.get_prefixEntries().front();
+  auto const& areaStack = entry.get_area_stack();
+  // Ignore self redistributed route reflection
+  // These routes are programmed by Decision,
+  // re-origintaed by me to areas that do not have the best prefix entry
+  if (prefixDb.get_thisNodeName() == myNodeName_ && areaStack.size() > 0 &&
+      areaLinkStates_.count(areaStack.back())) {
+    VLOG(2) << "Ignore self redistributed route reflection for prefix: " << key
+            << " area_stack: " << folly::join(",", areaStack);
+    return;
+  }
+
+  // construct new prefix key with local publication area id
+  const bool isPrefixKeyCompact = PrefixKey::isPrefixKeyCompactStr(key);
+  PrefixKey prefixKey(
+      prefixDb.get_thisNodeName(),
+      toIPNetwork(entry.get_prefix()),
+      area,
+      not isPrefixKeyCompact and PrefixKey::isPrefixKeyV2Str(key),
+      isPrefixKeyCompact);
+
+  fb303::fbData->addStatValue("decision.prefix_db_update", 1, fb303::COUNT);
+  pendingUpdates_.applyPrefixStateChange(
+      prefixDb.get_deletePrefix() ? prefixState_.deletePrefix(prefixKey)
+                                  : prefixState_.updatePrefix(prefixKey, entry),
+      prefixDb.perfEvents_ref());
+}
+
+void
+Decision::applyExpiredKey(std::string const& area, std::string const& key) {
+  // Decoded from the key, as the publication has no value to act on. See
+  // getExpiredPrefixDb() for expired prefix keys with values.
+  if (isAdjacencyKey(key)) {
+    applyAdjacencyKey(area, key, std::nullopt);
+  } else if (key.find(Constants::kAdjDbMarker.toString()) == 0) {
+    // adjacencyDb: delete keys starting with "adj:"
+    std::string nodeName = getNodeNameFromKey(key);
+    auto areaIt = adjacencyKeys_.find(area);
+    if (areaIt != adjacencyKeys_.end() and areaIt->second.count(nodeName)) {
+      return; // node advertises per adjacency keys
+    }
+    pendingUpdates_.applyLinkStateChange(
+        nodeName,
+        areaLinkStates_.at(area).deleteAdjacencyDatabase(nodeName),
+        thrift::PrefixDatabase().perfEvents_ref()); // Empty perf events
+  } else if (isPrefixDbBucketKey(key)) {
+    applyPrefixDbBucket(area, key, std::nullopt);
+  } else if (key.find(Constants::kPrefixDbMarker.toString()) == 0) {
+    // prefixDb: delete keys starting with "prefix:"
+    auto maybePrefixKey = PrefixKey::fromStr(key, area);
+    if (maybePrefixKey.hasError()) {
+      // this is bad format of key.
+      LOG(ERROR) << fmt::format(
+          "Unable to parse prefix key: {} with error: {}",
+          key,
+          maybePrefixKey.error());
+      return;
+    }
+    pendingUpdates_.applyPrefixStateChange(
+        prefixState_.deletePrefix(maybePrefixKey.value()),
+        thrift::PrefixDatabase().perfEvents_ref()); // Empty perf events
+  }
+}
+
+void
+Decision::applyPrefixDbBucket(
+    std::string const& area,
+    std::string const& key,
+    std::optional<thrift::PrefixDatabase> prefixDb) {
+  auto const nodeName = prefixDb.has_value() ? prefixDb->get_thisNodeName()
+                                             : getNodeNameFromKey(key);
+  auto& areaBuckets = prefixDbBuckets_[area];
+  auto& oldPrefixes = areaBuckets[key];
+
+  std::unordered_set<folly::CIDRNetwork> changed;
+  std::unordered_set<folly::CIDRNetwork> newPrefixes;
+  if (prefixDb.has_value() and not prefixDb->get_deletePrefix()) {
+    for (auto const& entry : prefixDb->get_prefixEntries()) {
+      auto const& areaStack = entry.get_area_stack();
+      // Ignore self redistributed route reflection, as for prefix keys
+      if (nodeName == myNodeName_ && areaStack.size() > 0 &&
+          areaLinkStates_.count(areaStack.back())) {
+        continue;
+      }
+      auto const prefix = toIPNetwork(entry.get_prefix());
+      newPrefixes.emplace(prefix);
+      changed.merge(prefixState_.updatePrefix(
+          PrefixKey(nodeName, prefix, area), entry, true /* isBucketKey */));
+    }
+  }
+  for (auto const& prefix : oldPrefixes) {
+    if (not newPrefixes.count(prefix)) {
+      changed.merge(prefixState_.deletePrefix(
+          PrefixKey(nodeName, prefix, area), true /* isBucketKey */));
+    }
+  }
+  if (newPrefixes.empty()) {
+    areaBuckets.erase(key);
+  } else {
+    oldPrefixes = std::move(newPrefixes);
+  }
+
+  fb303::fbData->addStatValue(
+      "decision.prefix_db_bucket_update", 1, fb303::COUNT);
+  if (prefixDb.has_value()) {
+    pendingUpdates_.applyPrefixStateChange(
+        std::move(changed), prefixDb->perfEvents_ref());
+  } else {
+    pendingUpdates_.applyPrefixStateChange(
+        std::move(changed),
+        thrift::PrefixDatabase().perfEvents_ref()); // Empty perf events
+  }
+}
+
+void
+Decision::applyAdjacencyKey(
+    std::string const& area,
+    std::string const& key,
+    std::optional<thrift::AdjacencyDatabase> adjacencyDb) {
+  auto const nodeName = getNodeNameFromKey(key);
+  auto& nodeKeys = adjacencyKeys_[area][nodeName];
+
+  // withdrawn adjacency is advertised without adjacencies till it expires
+  if (adjacencyDb.has_value() and
+      not adjacencyDb->get_adjacencies().empty()) {
+    nodeKeys[key] = *adjacencyDb;
+  } else {
+    nodeKeys.erase(key);
+  }
+
+  fb303::fbData->addStatValue("decision.adj_key_update", 1, fb303::COUNT);
+  if (nodeKeys.empty()) {
+    adjacencyKeys_.at(area).erase(nodeName);
+    pendingUpdates_.applyLinkStateChange(
+        nodeName,
+        areaLinkStates_.at(area).deleteAdjacencyDatabase(nodeName),
+        thrift::PrefixDatabase().perfEvents_ref()); // Empty perf events
+    return;
+  }
+
+  // node attributes and perf events are taken from the latest database
+  auto nodeDb = adjacencyDb.has_value() ? std::move(*adjacencyDb)
+                                        : nodeKeys.begin()->second;
+  nodeDb.adjacencies_ref()->clear();
+  for (auto const& [_, db] : nodeKeys) {
+    nodeDb.adjacencies_ref()->emplace_back(db.get_adjacencies().front());
+  }
+  updateAdjacencyDatabase(area, std::move(nodeDb));
+}
+
+bool
+Decision::isLocalAdjKey(std::string const& key) const {
+  auto const localAdjKey =
+      fmt::format("{}{}", Constants::kAdjDbMarker.toString(), myNodeName_);
+  return key == localAdjKey or
+      (isAdjacencyKey(key) and getNodeNameFromKey(key) == myNodeName_);
+}
+
+void
+Decision::ingestKvStoreUpdate(
+    Publication const& pub, apache::thrift::CompactSerializer& serializer) {
+  if (pub.kvStoreSynced) {
+    LOG(INFO) << "[Initialization] KVSOTORE_SYNCED signal is received";
+    auto updates = ingested_.wlock();
+    updates->kvStoreSynced = true;
+    scheduleIngestedUpdates(*updates);
+  } else if (pub.kvStoreWarmStarted) {
+    auto updates = ingested_.wlock();
+    updates->kvStoreWarmStarted = true;
+    scheduleIngestedUpdates(*updates);
+  } else {
+    ingestPublication(*pub.tPublication, serializer);
+  }
+}
+
+#if FOLLY_HAS_COROUTINES
+folly::coro::Task<void>
+Decision::ingestKvStoreUpdates(
+    messaging::RQueue<Publication> kvStoreUpdatesQueue) {
+  LOG(INFO) << "Starting KvStore updates ingest coroutine";
+  apache::thrift::CompactSerializer serializer;
+  while (true) {
+    auto maybePub = co_await kvStoreUpdatesQueue.getCoro(); // perform read
+    VLOG(2) << "Received KvStore update";
+    if (maybePub.hasError()) {
+      LOG(INFO) << "Terminating KvStore updates ingest coroutine";
+      break;
+    }
+    ingestKvStoreUpdate(maybePub.value(), serializer);
+  }
+}
+#endif
+
+void
+Decision::ingestPublication(
+    thrift::Publication const& thriftPub,
+    apache::thrift::CompactSerializer& serializer) {
+  CHECK(not thriftPub.area_ref()->empty());
+  auto const& area = *thriftPub.area_ref();
+
+  // deserialize before taking the lock, Decision thread is never blocked on
+  // parsing
+  std::vector<std::pair<std::string, IngestedKeyVal>> keyVals;
+  for (const auto& [key, rawVal] : *thriftPub.keyVals_ref()) {
+    if (not rawVal.value_ref().has_value()) {
+      // skip TTL update
+      DCHECK(*rawVal.ttlVersion_ref() > 0);
+      continue;
+    }
     try {
       if (key.find(Constants::kAdjDbMarker.toString()) == 0) {
-        // adjacencyDb: update keys starting with "adj:"
-        auto adjacencyDb = readThriftObjStr<thrift::AdjacencyDatabase>(
-            rawVal.value_ref().value(), serializer_);
-        auto& nodeName = adjacencyDb.get_thisNodeName();
-        LinkStateMetric holdUpTtl = 0, holdDownTtl = 0;
-        adjacencyDb.area_ref() = area;
-
-        fb303::fbData->addStatValue("decision.adj_db_update", 1, fb303::COUNT);
-        pendingUpdates_.applyLinkStateChange(
-            nodeName,
-            areaLinkState.updateAdjacencyDatabase(
-                adjacencyDb, holdUpTtl, holdDownTtl),
-            adjacencyDb.perfEvents_ref());
+        keyVals.emplace_back(
+            key,
+            readThriftObjStr<thrift::AdjacencyDatabase>(
+                *rawVal.value_ref(), serializer));
       } else if (key.find(Constants::kPrefixDbMarker.toString()) == 0) {
-        // prefixDb: update keys starting with "prefix:"
-        auto prefixDb = readThriftObjStr<thrift::PrefixDatabase>(
-            rawVal.value_ref().value(), serializer_);
-        if (1 != prefixDb.get_prefixEntries().size()) {
-          LOG(ERROR) << "Expecting exactly one entry per prefix key";
-          fb303::fbData->addStatValue("decision.error", 1, fb303::COUNT);
-          continue;
-        }
-        auto const& entry = prefixDb.get_prefixEntries().front();
-        auto const& areaStack = entry.get_area_stack();
-        // Ignore self redistributed route reflection
-        // These routes are programmed by Decision,
-        // re-origintaed by me to areas that do not have the best prefix entry
-        if (prefixDb.get_thisNodeName() == myNodeName_ &&
-            areaStack.size() > 0 && areaLinkStates_.count(areaStack.back())) {
-          VLOG(2) << "Ignore self redistributed route reflection for prefix: "
-                  << key << " area_stack: " << folly::join(",", areaStack);
-          continue;
-        }
-
-        // construct new prefix key with local publication area id
-        PrefixKey prefixKey(
-            prefixDb.get_thisNodeName(),
-            toIPNetwork(entry.get_prefix()),
-            area,
-            PrefixKey::isPrefixKeyV2Str(key));
-
-        fb303::fbData->addStatValue(
-            "decision.prefix_db_update", 1, fb303::COUNT);
-        pendingUpdates_.applyPrefixStateChange(
-            prefixDb.get_deletePrefix()
-                ? prefixState_.deletePrefix(prefixKey)
-                : prefixState_.updatePrefix(prefixKey, entry),
-            prefixDb.perfEvents_ref());
+        keyVals.emplace_back(
+            key,
+            readThriftObjStr<thrift::PrefixDatabase>(
+                *rawVal.value_ref(), serializer));
       }
     } catch (const std::exception& e) {
       LOG(ERROR) << "Failed to deserialize info for key " << key
                  << ". Exception: " << folly::exceptionStr(e);
     }
   }
-
-  // LSDB deletion
-  // TODO: avoid decoding from string by injecting data-structures
-  // instead of raw strings into `expiredKeys` collection
   for (const auto& key : *thriftPub.expiredKeys_ref()) {
-    std::string nodeName = getNodeNameFromKey(key);
+    if (auto prefixDb = getExpiredPrefixDb(thriftPub, key, serializer)) {
+      keyVals.emplace_back(key, std::move(*prefixDb));
+    } else {
+      keyVals.emplace_back(key, std::monostate{});
+    }
+  }
 
-    if (key.find(Constants::kAdjDbMarker.toString()) == 0) {
-      // adjacencyDb: delete keys starting with "adj:"
-      pendingUpdates_.applyLinkStateChange(
-          nodeName,
-          areaLinkState.deleteAdjacencyDatabase(nodeName),
-          thrift::PrefixDatabase().perfEvents_ref()); // Empty perf events
-    } else if (key.find(Constants::kPrefixDbMarker.toString()) == 0) {
-      // prefixDb: delete keys starting with "prefix:"
-      auto maybePrefixKey = PrefixKey::fromStr(key, area);
-      if (maybePrefixKey.hasError()) {
-        // this is bad format of key.
-        LOG(ERROR) << fmt::format(
-            "Unable to parse prefix key: {} with error: {}",
-            key,
-            maybePrefixKey.error());
-        continue;
+  auto updates = ingested_.wlock();
+  auto& areaKeyVals = updates->keyVals[area];
+  for (auto& [key, keyVal] : keyVals) {
+    auto [it, inserted] = areaKeyVals.emplace(key, std::move(keyVal));
+    if (not inserted) {
+      it->second = std::move(keyVal);
+      fb303::fbData->addStatValue(
+          "decision.superseded_key_vals", 1, fb303::COUNT);
+    }
+  }
+  scheduleIngestedUpdates(*updates);
+}
+
+void
+Decision::scheduleIngestedUpdates(IngestedUpdates& updates) {
+  if (updates.scheduled) {
+    // updates are merged into the pending processIngestedUpdates()
+    return;
+  }
+  updates.scheduled = true;
+  runInEventBaseThread([this]() noexcept { processIngestedUpdates(); });
+}
+
+void
+Decision::processIngestedUpdates() {
+  IngestedUpdates updates;
+  {
+    auto ingested = ingested_.wlock();
+    std::swap(updates, *ingested);
+  }
+
+  for (auto& [area, keyVals] : updates.keyVals) {
+    if (!areaLinkStates_.count(area)) {
+      areaLinkStates_.emplace(area, area);
+    }
+
+    // local links up before these updates, to tell loss of local adjacency
+    // from background churn
+    std::optional<LinkState::LinkSet> localUpLinks;
+    if (enableUrgentLocalAdjDown_ and
+        std::any_of(keyVals.begin(), keyVals.end(), [this](auto const& kv) {
+          return isLocalAdjKey(kv.first);
+        })) {
+      localUpLinks = getLocalUpLinks(area);
+    }
+
+    for (auto& [key, keyVal] : keyVals) {
+      if (auto* adjDb = std::get_if<thrift::AdjacencyDatabase>(&keyVal)) {
+        applyAdjacencyDb(area, key, std::move(*adjDb));
+      } else if (auto* pfxDb = std::get_if<thrift::PrefixDatabase>(&keyVal)) {
+        applyPrefixDb(area, key, std::move(*pfxDb));
+      } else {
+        applyExpiredKey(area, key);
       }
-      pendingUpdates_.applyPrefixStateChange(
-          prefixState_.deletePrefix(maybePrefixKey.value()),
-          thrift::PrefixDatabase().perfEvents_ref()); // Empty perf events
     }
+
+    if (localUpLinks) {
+      auto const upLinks = getLocalUpLinks(area);
+      for (auto const& link : *localUpLinks) {
+        if (not upLinks.count(link)) {
+          pendingUpdates_.setUrgent();
+          break;
+        }
+      }
+    }
+  }
+
+  if (updates.kvStoreWarmStarted) {
+    processKvStoreWarmStarted();
+  }
+  if (updates.kvStoreSynced) {
+    initialKvStoreSynced_ = true;
+    pendingUpdates_.setNeedsFullRebuild();
+  }
+  scheduleRebuildRoutes();
+}
+
+void
+Decision::processKvStoreWarmStarted() {
+  // Seeded state is as of last run. Routes programmed before restart are
+  // mostly retained, and full-sync with peers reconciles the rest.
+  LOG(INFO) << "[Warm Start] KvStore is seeded from snapshot, computing routes";
+  initialKvStoreWarmStarted_ = true;
+  coldStartTimer_->cancelTimeout();
+  pendingUpdates_.setNeedsFullRebuild();
+}
+
+void
+Decision::scheduleRebuildRoutes() {
+  if (pendingUpdates_.urgent()) {
+    // loss of local adjacency is not delayed by debounce
+    fb303::fbData->addStatValue(
+        "decision.urgent_route_rebuilds", 1, fb303::COUNT);
+    rebuildRoutes("DECISION_URGENT");
+  }
+  // compute routes with exponential backoff timer if needed
+  if (pendingUpdates_.needsRouteUpdate() or not pendingKeyVals_.empty()) {
+    rebuildRoutesDebounced_();
   }
 }
 
@@ -549,17 +1314,35 @@ Decision::rebuildRoutes(std::string const& event) {
   // If OpenR initialization procedure is enable, donot trigger initial route
   // computation until KvStoreSynced_ signal is received.
   // Otherwise, wait for coldStartTimer_ before initial route computation.
+  // Either is skipped on warm start from KvStore snapshot.
   if (config_->getConfig().get_enable_initialization_process()) {
-    if (not initialKvStoreSynced_) {
+    if (not initialKvStoreSynced_ and not initialKvStoreWarmStarted_) {
       return;
     }
   } else if (coldStartTimer_->isScheduled()) {
     return;
   }
 
+  applyPendingKeyVals();
+  if (not pendingUpdates_.needsRouteUpdate()) {
+    // buffered key-vals didn't change link/prefix state
+    return;
+  }
+  // routes computed for other nodes are stale
+  routeComputationState_.reset();
+
   pendingUpdates_.addEvent(event);
   VLOG(1) << "Decision: processing " << pendingUpdates_.getCount()
           << " accumulated updates. " << event;
+  if (const auto& firstUpdateTime = pendingUpdates_.getFirstUpdateTime()) {
+    HotPathTrace::record(
+        "decision.debounce",
+        "",
+        *firstUpdateTime,
+        std::chrono::steady_clock::now(),
+        pendingUpdates_.getCount());
+  }
+  ScopedTraceSpan traceSpan("decision.rebuild_routes");
   if (pendingUpdates_.perfEvents()) {
     if (auto expectedDuration = getDurationBetweenPerfEvents(
             *pendingUpdates_.perfEvents(),
@@ -570,27 +1353,94 @@ Decision::rebuildRoutes(std::string const& event) {
     }
   }
 
+  // originators reachable only change along with topology, keep reachable
+  // prefix entries of `prefixState_` in sync before computing routes
+  if (pendingUpdates_.topologyChanged() or
+      pendingUpdates_.needsFullRebuild()) {
+    PrefixState::AreaNodes areaReachableNodes;
+    for (auto const& [area, linkState] : areaLinkStates_) {
+      auto& reachableNodes = areaReachableNodes[area];
+      for (auto const& [node, _] : linkState.getSpfResult(myNodeName_)) {
+        reachableNodes.emplace(node);
+      }
+    }
+    prefixState_.updateReachableNodes(
+        myNodeName_, std::move(areaReachableNodes));
+  }
+
+  // prefixes whose routes may have changed by topology change
+  std::optional<std::unordered_set<folly::CIDRNetwork>> topologyPrefixes;
+  if (pendingUpdates_.topologyChanged() and
+      not pendingUpdates_.needsFullRebuild()) {
+    topologyPrefixes = spfSolver_->getPrefixesAffectedByTopology(
+        myNodeName_, areaLinkStates_, prefixState_);
+  }
+
   DecisionRouteUpdate update;
-  if (pendingUpdates_.needsFullRebuild()) {
+  if (pendingUpdates_.needsFullRebuild() or
+      (pendingUpdates_.topologyChanged() and not topologyPrefixes)) {
     // if only static routes gets updated, we still need to update routes
     // because there maybe routes depended on static routes.
-    auto maybeRouteDb =
-        spfSolver_->buildRouteDb(myNodeName_, areaLinkStates_, prefixState_);
-    LOG_IF(WARNING, !maybeRouteDb)
-        << "SEVERE: full route rebuild resulted in no routes";
-    auto db = maybeRouteDb.has_value() ? std::move(maybeRouteDb).value()
-                                       : DecisionRouteDb{};
-    if (ribPolicy_) {
+    // Static routes stay in `routeDb_` and are merged as overlay, unless RIB
+    // policy has to be applied to them as well.
+    if (not ribPolicy_) {
+      // delta to `routeDb_` is built along with routes
+      auto maybeUpdate = spfSolver_->buildRouteDbDelta(
+          myNodeName_, areaLinkStates_, prefixState_, *routeDb_);
+      LOG_IF(WARNING, !maybeUpdate)
+          << "SEVERE: full route rebuild resulted in no routes";
+      update = maybeUpdate.has_value()
+          ? std::move(maybeUpdate).value()
+          : routeDb_->calculateUpdate(DecisionRouteDb{});
+    } else {
+      auto maybeRouteDb = spfSolver_->buildRouteDb(
+          myNodeName_, areaLinkStates_, prefixState_, true);
+      LOG_IF(WARNING, !maybeRouteDb)
+          << "SEVERE: full route rebuild resulted in no routes";
+      auto db = maybeRouteDb.has_value() ? std::move(maybeRouteDb).value()
+                                         : DecisionRouteDb{};
       auto start = std::chrono::steady_clock::now();
       ribPolicy_->applyPolicy(db.unicastRoutes);
       updateCounters(
           "decision.rib_policy_processing.time_ms",
           start,
           std::chrono::steady_clock::now());
+      // update `DecisionRouteDb` cache and return delta as `update`
+      update = routeDb_->calculateUpdate(std::move(db));
     }
-    // update `DecisionRouteDb` cache and return delta as `update`
-    update = routeDb_.calculateUpdate(std::move(db));
+    spfSolver_->updateRoutedTopology(myNodeName_, areaLinkStates_);
   } else {
+    if (pendingUpdates_.topologyChanged()) {
+      spfSolver_->invalidateBestRoutesCache(areaLinkStates_, prefixState_);
+    }
+    if (topologyPrefixes) {
+      // MPLS routes follow shortest paths towards every node
+      DecisionRouteDb mplsDb;
+      spfSolver_->buildMplsRoutes(
+          myNodeName_, areaLinkStates_, mplsDb, false /* withStaticRoutes */);
+      update = routeDb_->calculateMplsUpdate(
+          std::move(mplsDb.mplsRoutes), &spfSolver_->getStaticMplsRoutes());
+
+      // rebuild routes of affected prefixes, skipping unchanged ones
+      for (auto const& prefix : *topologyPrefixes) {
+        if (pendingUpdates_.updatedPrefixes().count(prefix)) {
+          continue;
+        }
+        auto maybeRibEntry = spfSolver_->createRouteForPrefixOrGetStaticRoute(
+            myNodeName_, areaLinkStates_, prefixState_, prefix);
+        auto routeIt = routeDb_->unicastRoutes.find(prefix);
+        if (maybeRibEntry) {
+          if (routeIt == routeDb_->unicastRoutes.end() or
+              routeIt->second != *maybeRibEntry) {
+            update.addRouteToUpdate(std::move(maybeRibEntry).value());
+          }
+        } else if (routeIt != routeDb_->unicastRoutes.end()) {
+          update.unicastRoutesToDelete.emplace_back(prefix);
+        }
+      }
+      spfSolver_->updateRoutedTopology(myNodeName_, areaLinkStates_);
+    }
+
     // process prefixes update from `prefixState_`
     for (auto const& prefix : pendingUpdates_.updatedPrefixes()) {
       if (auto maybeRibEntry = spfSolver_->createRouteForPrefixOrGetStaticRoute(
@@ -614,15 +1464,38 @@ Decision::rebuildRoutes(std::string const& event) {
     }
   }
 
-  routeDb_.update(update);
+  updateRouteDb(update);
+  trimSpfMemoization();
   pendingUpdates_.addEvent("ROUTE_UPDATE");
   update.perfEvents = pendingUpdates_.moveOutEvents();
   pendingUpdates_.reset();
+  traceSpan.setCount(update.size());
 
   // send `DecisionRouteUpdate` to Fib/PrefixMgr
   routeUpdatesQueue_.push(std::move(update));
 }
 
+void
+Decision::updateRouteDb(DecisionRouteUpdate const& update) {
+  // readers only take new references to the snapshot under the lock
+  auto snapshot = routeDbSnapshot_.wlock();
+  if (routeDb_.use_count() > 2) {
+    // held by readers besides routeDb_ and the snapshot itself
+    routeDb_ = std::make_shared<DecisionRouteDb>(*routeDb_);
+    fb303::fbData->addStatValue(
+        "decision.route_db_snapshot_copies", 1, fb303::COUNT);
+  }
+  routeDb_->update(update);
+  *snapshot = routeDb_;
+}
+
+void
+Decision::trimSpfMemoization() {
+  for (auto& [_, linkState] : areaLinkStates_) {
+    linkState.trimMemoization(spfMemoizationBudgetBytes_);
+  }
+}
+
 void
 Decision::updateCounters(
     std::string key,
@@ -679,6 +1552,18 @@ Decision::updateGlobalCounters() const {
       "decision.num_nodes", std::max(nodeSet.size(), static_cast<size_t>(1ul)));
   fb303::fbData->setCounter(
       "decision.num_prefixes", prefixState_.prefixes().size());
+  size_t spfMemoizationBytes{0};
+  for (auto const& [_, linkState] : areaLinkStates_) {
+    spfMemoizationBytes += linkState.getMemoizationBytes();
+  }
+  fb303::fbData->setCounter(
+      "decision.spf_memoization.bytes", spfMemoizationBytes);
+  const auto prefixStateBytes = prefixState_.getMemoryUsage();
+  fb303::fbData->setCounter("decision.prefix_state.bytes", prefixStateBytes);
+  fb303::fbData->setCounter(
+      "decision.prefix_state.bytes_per_prefix",
+      prefixStateBytes /
+          std::max(prefixState_.prefixes().size(), static_cast<size_t>(1ul)));
 }
 
 } // namespace openr
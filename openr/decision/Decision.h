@@ -8,13 +8,19 @@
 #pragma once
 
 #include <chrono>
+#include <map>
+#include <optional>
+#include <set>
 #include <string>
 #include <unordered_map>
+#include <variant>
 
 #include <folly/Format.h>
 #include <folly/IPAddress.h>
 #include <folly/Memory.h>
 #include <folly/String.h>
+#include <folly/Synchronized.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/futures/Future.h>
 #include <folly/io/async/AsyncTimeout.h>
 #include <thrift/lib/cpp2/Thrift.h>
@@ -22,8 +28,10 @@
 
 #include <openr/common/AsyncDebounce.h>
 #include <openr/common/AsyncThrottle.h>
+#include <openr/common/MemoryPressure.h>
 #include <openr/common/MplsUtil.h>
 #include <openr/common/OpenrEventBase.h>
+#include <openr/common/SharedExecutor.h>
 #include <openr/common/Types.h>
 #include <openr/common/Util.h>
 #include <openr/config/Config.h>
@@ -63,9 +71,28 @@ class DecisionPendingUpdates {
     return needsFullRebuild_;
   }
 
+  // set if topology changed, routes of prefixes advertised by nodes whose
+  // shortest paths changed need to be rebuilt
+  bool
+  topologyChanged() const {
+    return topologyChanged_;
+  }
+
+  // set if routes need to be rebuilt without waiting for debounce, e.g. on
+  // loss of local adjacency
+  void
+  setUrgent() {
+    urgent_ = true;
+  }
+
+  bool
+  urgent() const {
+    return urgent_;
+  }
+
   bool
   needsRouteUpdate() const {
-    return needsFullRebuild() || !updatedPrefixes_.empty();
+    return needsFullRebuild() || topologyChanged() || !updatedPrefixes_.empty();
   }
 
   std::unordered_set<folly::CIDRNetwork> const&
@@ -98,6 +125,12 @@ class DecisionPendingUpdates {
     return count_;
   }
 
+  // time of the first update in this batch, i.e. start of debounce
+  std::optional<std::chrono::steady_clock::time_point> const&
+  getFirstUpdateTime() const {
+    return firstUpdateTime_;
+  }
+
  private:
   void addUpdate(
       apache::thrift::optional_field_ref<thrift::PerfEvents const&> perfEvents);
@@ -105,12 +138,21 @@ class DecisionPendingUpdates {
   // tracks how many updates are part of this batch
   uint32_t count_{0};
 
+  // time of the first update in this batch
+  std::optional<std::chrono::steady_clock::time_point> firstUpdateTime_;
+
   // oldest perfEvents list in the batch
   std::optional<thrift::PerfEvents> perfEvents_;
 
   // set if we need to rebuild all routes
   bool needsFullRebuild_{false};
 
+  // set if any link or node changed in graph
+  bool topologyChanged_{false};
+
+  // set if batch must not be delayed by debounce
+  bool urgent_{false};
+
   // track prefixes that have changed in this batch
   std::unordered_set<folly::CIDRNetwork> updatedPrefixes_;
 
@@ -149,11 +191,29 @@ class Decision : public OpenrEventBase {
 
   /*
    * Retrieve routeDb from specified node.
-   * If empty nodename specified, will return routeDb of its own
+   * If empty nodename specified, will return routeDb of its own. Own routeDb
+   * is serialized from the latest snapshot on the calling thread, routeDb of
+   * other nodes is computed off the Decision thread on a snapshot of link and
+   * prefix state, and cached until that state changes.
    */
   folly::SemiFuture<std::unique_ptr<thrift::RouteDatabase>> getDecisionRouteDb(
       std::string nodeName);
 
+  /*
+   * Immutable snapshot of own routeDb as of the latest route update sent out.
+   * Safe to call from any thread, snapshot is never modified once retrieved.
+   */
+  std::shared_ptr<const DecisionRouteDb> getDecisionRouteDbSnapshot() const;
+
+  /*
+   * Delta of own routes if hypothetical changes of `request` were applied to
+   * the topology. Link and prefix state are snapshotted on the Decision
+   * thread, routes are built off it with a separate SpfSolver, hence live
+   * route computation is unaffected.
+   */
+  folly::SemiFuture<std::unique_ptr<thrift::RouteDatabaseDelta>>
+  getRouteDbSimulated(thrift::RouteSimulationRequest request);
+
   /*
    * Retrieve AdjacencyDatabase for all nodes in all areas
    */
@@ -166,6 +226,35 @@ class Decision : public OpenrEventBase {
   folly::SemiFuture<std::unique_ptr<std::vector<thrift::ReceivedRouteDetail>>>
   getReceivedRoutesFiltered(thrift::ReceivedRouteFilter filter);
 
+  /*
+   * Received routes of a prefix along with best route selection, as of the
+   * snapshot. Prefix entries are immutable and shared with Decision, hence
+   * snapshot is cheap to take and can be converted off the Decision thread.
+   */
+  struct ReceivedRouteSnapshot {
+    folly::CIDRNetwork prefix;
+    PrefixEntries prefixEntries;
+    // Selected `<Node, Area>` and the best of them, empty if not selected
+    std::set<NodeAndArea> allNodeAreas;
+    std::optional<NodeAndArea> bestNodeArea;
+  };
+
+  /*
+   * Snapshot of received routes of prefixes in `filter`, or of all prefixes.
+   * Node and area filters are applied on conversion.
+   */
+  folly::SemiFuture<std::unique_ptr<std::vector<ReceivedRouteSnapshot>>>
+  getReceivedRoutesSnapshot(thrift::ReceivedRouteFilter filter);
+
+  /*
+   * Append received route of snapshot to `routes`, honoring node and area
+   * filter. Same as getReceivedRoutesFiltered() for a single prefix.
+   */
+  static void addReceivedRoute(
+      std::vector<thrift::ReceivedRouteDetail>& routes,
+      thrift::ReceivedRouteFilter const& filter,
+      ReceivedRouteSnapshot const& snapshot);
+
   /*
    * Set new or replace existing RibPolicy. This will trigger the new policy
    * run against computed routes and delta will be published.
@@ -185,6 +274,12 @@ class Decision : public OpenrEventBase {
    */
   folly::SemiFuture<folly::Unit> clearRibPolicy();
 
+  /*
+   * Apply config reloaded from file, see `ConfigUpdate`. Debounce of route
+   * computation is applied live.
+   */
+  folly::SemiFuture<folly::Unit> processConfigUpdate(ConfigUpdate update);
+
   // periodically called by counterUpdateTimer_, exposed publicly for testing
   void updateGlobalCounters() const;
 
@@ -197,8 +292,99 @@ class Decision : public OpenrEventBase {
   Decision(Decision const&) = delete;
   Decision& operator=(Decision const&) = delete;
 
-  // Process thrift publication from KvStore
-  void processPublication(thrift::Publication&& thriftPub);
+  // Process thrift publication from KvStore. Values of adj/prefix keys are
+  // buffered as is and deserialized lazily by applyPendingKeyVals().
+  void processPublication(thrift::Publication const& thriftPub);
+
+  // Deserialize and apply the newest buffered value of every adj/prefix key
+  // to link/prefix state. MUST be called before reading either state.
+  void applyPendingKeyVals();
+
+  // Deserialize and apply value of adj/prefix key to link/prefix state
+  void applyKeyVal(
+      std::string const& area,
+      std::string const& key,
+      std::string const& value);
+
+  // Apply deserialized adj/prefix db of key to link/prefix state
+  void applyAdjacencyDb(
+      std::string const& area,
+      std::string const& key,
+      thrift::AdjacencyDatabase&& adjacencyDb);
+  void applyPrefixDb(
+      std::string const& area,
+      std::string const& key,
+      thrift::PrefixDatabase&& prefixDb);
+
+  // Remove adj/prefix db of expired key from link/prefix state
+  void applyExpiredKey(std::string const& area, std::string const& key);
+
+  // Update AdjacencyDatabase of node in link state
+  void updateAdjacencyDatabase(
+      std::string const& area, thrift::AdjacencyDatabase&& adjacencyDb);
+
+  // Apply update (or expiry if not set) of a per adjacency key. Adjacencies of
+  // all keys of the node are merged into AdjacencyDatabase of the node.
+  void applyAdjacencyKey(
+      std::string const& area,
+      std::string const& key,
+      std::optional<thrift::AdjacencyDatabase> adjacencyDb);
+
+  // Apply update (or expiry if not set) of a bucket key of prefix database.
+  // Prefixes dropped from the bucket since its last update are withdrawn.
+  void applyPrefixDbBucket(
+      std::string const& area,
+      std::string const& key,
+      std::optional<thrift::PrefixDatabase> prefixDb);
+
+  // Check if key is adjacency key of this node, in either format
+  bool isLocalAdjKey(std::string const& key) const;
+
+  /*
+   * Pipelined ingest (enable_pipelined_ingest). Publications are read and
+   * deserialized off the Decision thread, by a coroutine on a strand of
+   * SharedExecutor if coroutines are supported and on ingestExecutor_
+   * otherwise, and merged into ingested_, newest value
+   * per key. processIngestedUpdates() applies them on the Decision thread,
+   * i.e. never while routes are being computed.
+   */
+  using IngestedKeyVal = std::variant<
+      std::monostate /* expired */,
+      thrift::AdjacencyDatabase,
+      thrift::PrefixDatabase>;
+
+  struct IngestedUpdates {
+    std::unordered_map<
+        std::string /* area */,
+        std::unordered_map<std::string /* key */, IngestedKeyVal>>
+        keyVals;
+    bool kvStoreSynced{false};
+    bool kvStoreWarmStarted{false};
+    // processIngestedUpdates() is queued on the Decision thread
+    bool scheduled{false};
+  };
+
+  void ingestKvStoreUpdate(
+      Publication const& pub, apache::thrift::CompactSerializer& serializer);
+#if FOLLY_HAS_COROUTINES
+  folly::coro::Task<void> ingestKvStoreUpdates(
+      messaging::RQueue<Publication> kvStoreUpdatesQueue);
+#endif
+  void ingestPublication(
+      thrift::Publication const& thriftPub,
+      apache::thrift::CompactSerializer& serializer);
+  void scheduleIngestedUpdates(IngestedUpdates& updates);
+  void processIngestedUpdates();
+
+  // rebuild routes right away if urgent, debounced otherwise
+  void scheduleRebuildRoutes();
+
+  // KvStore is seeded from warm start snapshot, stop holding initial route
+  // computation
+  void processKvStoreWarmStarted();
+
+  // links of this node in area which are up
+  LinkState::LinkSet getLocalUpLinks(std::string const& area) const;
 
   // Process publication from PrefixManager
   void processStaticRoutesUpdate(DecisionRouteUpdate&& routeUpdate);
@@ -226,8 +412,25 @@ class Decision : public OpenrEventBase {
   std::optional<thrift::PrefixDatabase> updateNodePrefixDatabase(
       const std::string& key, const thrift::PrefixDatabase& prefixDb);
 
+  // apply update to routeDb_ and publish it as routeDbSnapshot_. routeDb_ is
+  // updated in place unless some reader still holds the previous snapshot,
+  // in which case the update is applied to a copy (copy-on-write).
+  void updateRouteDb(DecisionRouteUpdate const& update);
+
+  // bound memoized shortest paths of every area once routes are computed
+  void trimSpfMemoization();
+
+  // snapshot link and prefix state to compute routes of other nodes on
+  struct RouteComputationState;
+  std::shared_ptr<RouteComputationState> makeRouteComputationState() const;
+
   // cached routeDb
-  DecisionRouteDb routeDb_;
+  std::shared_ptr<DecisionRouteDb> routeDb_{
+      std::make_shared<DecisionRouteDb>()};
+
+  // routeDb_ published for readers from other threads
+  folly::Synchronized<std::shared_ptr<const DecisionRouteDb>> routeDbSnapshot_{
+      routeDb_};
 
   // Queue to publish route changes
   messaging::ReplicateQueue<DecisionRouteUpdate>& routeUpdatesQueue_;
@@ -242,12 +445,47 @@ class Decision : public OpenrEventBase {
   // the pointer to the SPF path calculator
   std::unique_ptr<SpfSolver> spfSolver_;
 
+  // runs route simulations and computations of other nodes' routes, one at a
+  // time
+  SharedExecutor::Strand simulationStrand_;
+
+  // Snapshot of state routes of other nodes are computed on, along with the
+  // routes computed so far. Taken on first request, dropped once link or
+  // prefix state changes.
+  std::shared_ptr<RouteComputationState> routeComputationState_;
+
   // per area link states
   std::unordered_map<std::string, LinkState> areaLinkStates_;
 
   // global prefix state
   PrefixState prefixState_;
 
+  // newest raw value of adj/prefix keys updated since last
+  // applyPendingKeyVals(), per area
+  std::unordered_map<
+      std::string /* area */,
+      std::unordered_map<std::string /* key */, std::string /* value */>>
+      pendingKeyVals_;
+
+  // Databases of the per adjacency keys ("adj:<node>:<otherNode>:<ifName>")
+  // of nodes advertising one key per adjacency. Whole database updates of
+  // such nodes (e.g. stale "adj:<node>" key) are ignored.
+  std::unordered_map<
+      std::string /* area */,
+      std::unordered_map<
+          std::string /* node name */,
+          std::map<std::string /* key */, thrift::AdjacencyDatabase>>>
+      adjacencyKeys_;
+
+  // Prefixes carried by bucket keys of prefix database
+  // ("prefix:<node>:#<bucket>"), to tell prefixes dropped from a bucket
+  std::unordered_map<
+      std::string /* area */,
+      std::unordered_map<
+          std::string /* key */,
+          std::unordered_set<folly::CIDRNetwork>>>
+      prefixDbBuckets_;
+
   apache::thrift::CompactSerializer serializer_;
 
   // base interval to submit to monitor with (jitter will be added)
@@ -262,6 +500,12 @@ class Decision : public OpenrEventBase {
   // this node's name and the key markers
   const std::string myNodeName_;
 
+  // rebuild routes right away on loss of local adjacency
+  const bool enableUrgentLocalAdjDown_{false};
+
+  // memory budget of memoized shortest paths per area, 0 if unbounded
+  const size_t spfMemoizationBudgetBytes_{0};
+
   // store rebuildRoutes to-do status and perf events
   detail::DecisionPendingUpdates pendingUpdates_;
 
@@ -274,6 +518,21 @@ class Decision : public OpenrEventBase {
   // Boolean flag indicating whether KvStore synced signal is received in OpenR
   // initialization procedure.
   bool initialKvStoreSynced_{false};
+
+  // Boolean flag indicating whether KvStore is seeded from warm start
+  // snapshot. Initial route computation doesn't wait for KvStore sync then.
+  bool initialKvStoreWarmStarted_{false};
+
+  // deserialized updates handed over from ingest
+  folly::Synchronized<IngestedUpdates> ingested_;
+
+  // reads and deserializes KvStore publications if pipelined ingest is
+  // enabled without coroutine support. Declared last to be joined before
+  // other members are destroyed.
+  std::unique_ptr<folly::CPUThreadPoolExecutor> ingestExecutor_;
+
+  // drops SPF memoization under memory pressure
+  std::unique_ptr<MemoryPressure::Shedder> memoryShedder_;
 };
 
 } // namespace openr
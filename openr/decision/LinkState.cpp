@@ -7,10 +7,14 @@
 
 #include <algorithm>
 #include <functional>
+#include <numeric>
+#include <queue>
 #include <utility>
 
 #include <fb303/ServiceData.h>
 #include <folly/Format.h>
+#include <folly/futures/Future.h>
+#include <openr/common/HotPathTrace.h>
 #include <openr/common/NetworkUtil.h>
 #include <openr/decision/LinkState.h>
 
@@ -50,6 +54,73 @@ std::hash<openr::LinkState::LinkSet>::operator()(
 
 namespace openr {
 
+namespace {
+// dests per task of prefetchKthPaths(), amortizing scratch state of pruned SPF
+const size_t kKthPathsBatchSize{16};
+
+// per node overhead of std::unordered_map/set, i.e. next and hash
+const size_t kHashNodeOverhead{2 * sizeof(void*)};
+
+size_t
+getStringBytes(std::string const& str) {
+  return sizeof(std::string) + str.capacity();
+}
+
+// estimated heap bytes of memoized SpfResult
+size_t
+getMemoizedBytes(LinkState::SpfResult const& result) {
+  size_t bytes = result.bucket_count() * sizeof(void*);
+  for (auto const& [node, nodeResult] : result) {
+    bytes += kHashNodeOverhead + getStringBytes(node) +
+        sizeof(LinkState::NodeSpfResult) +
+        nodeResult.nextHops().bucket_count() * sizeof(void*);
+    for (auto const& pathLink : nodeResult.pathLinks()) {
+      bytes += sizeof(pathLink.link) + getStringBytes(pathLink.prevNode);
+    }
+    for (auto const& nextHop : nodeResult.nextHops()) {
+      bytes += kHashNodeOverhead + getStringBytes(nextHop);
+    }
+  }
+  return bytes;
+}
+
+// insert link into links ordered by LinkPtrLess, false if already present
+bool
+insertOrderedLink(
+    LinkState::LinkVector& links, std::shared_ptr<Link> const& link) {
+  auto it = std::lower_bound(
+      links.begin(), links.end(), link, LinkState::LinkPtrLess{});
+  if (it != links.end() and **it == *link) {
+    return false;
+  }
+  links.insert(it, link);
+  return true;
+}
+
+// erase link from links ordered by LinkPtrLess, false if not present
+bool
+eraseOrderedLink(
+    LinkState::LinkVector& links, std::shared_ptr<Link> const& link) {
+  auto it = std::lower_bound(
+      links.begin(), links.end(), link, LinkState::LinkPtrLess{});
+  if (it == links.end() or not(**it == *link)) {
+    return false;
+  }
+  links.erase(it);
+  return true;
+}
+
+// estimated heap bytes of memoized paths
+size_t
+getMemoizedBytes(std::vector<LinkState::Path> const& paths) {
+  size_t bytes = paths.capacity() * sizeof(LinkState::Path);
+  for (auto const& path : paths) {
+    bytes += path.capacity() * sizeof(std::shared_ptr<Link>);
+  }
+  return bytes;
+}
+} // namespace
+
 template <class T>
 HoldableValue<T>::HoldableValue(T val) : val_(val) {}
 
@@ -375,7 +446,8 @@ Link::directionalToString(const std::string& fromNode) const {
       getIfaceFromNode(getOtherNodeName(fromNode)));
 }
 
-LinkState::LinkState(const std::string& area) : area_(area) {}
+LinkState::LinkState(const std::string& area, bool enableIncrementalSpf)
+    : area_(area), enableIncrementalSpf_(enableIncrementalSpf) {}
 
 size_t
 LinkState::LinkPtrHash::operator()(const std::shared_ptr<Link>& l) const {
@@ -419,17 +491,20 @@ LinkState::traceOnePath(
 
 void
 LinkState::addLink(std::shared_ptr<Link> link) {
-  CHECK(linkMap_[link->firstNodeName()].insert(link).second);
-  CHECK(linkMap_[link->secondNodeName()].insert(link).second);
+  CHECK(insertOrderedLink(linkMap_[link->firstNodeName()], link));
+  CHECK(insertOrderedLink(linkMap_[link->secondNodeName()], link));
   CHECK(allLinks_.insert(link).second);
+  csrGraph_.reset();
 }
 
 // throws std::out_of_range if links are not present
 void
 LinkState::removeLink(std::shared_ptr<Link> link) {
-  CHECK(linkMap_.at(link->firstNodeName()).erase(link));
-  CHECK(linkMap_.at(link->secondNodeName()).erase(link));
+  CHECK(eraseOrderedLink(linkMap_.at(link->firstNodeName()), link));
+  CHECK(eraseOrderedLink(linkMap_.at(link->secondNodeName()), link));
   CHECK(allLinks_.erase(link));
+  heldLinks_.erase(link);
+  csrGraph_.reset();
 }
 
 void
@@ -443,37 +518,113 @@ LinkState::removeNode(const std::string& nodeName) {
   // erase ptrs to these links from other nodes
   for (auto const& link : search->second) {
     try {
-      CHECK(linkMap_.at(link->getOtherNodeName(nodeName)).erase(link));
+      CHECK(eraseOrderedLink(
+          linkMap_.at(link->getOtherNodeName(nodeName)), link));
       CHECK(allLinks_.erase(link));
+      heldLinks_.erase(link);
     } catch (std::out_of_range const& e) {
       LOG(FATAL) << "std::out_of_range for " << nodeName;
     }
   }
   linkMap_.erase(search);
   nodeOverloads_.erase(nodeName);
+  heldNodes_.erase(nodeName);
+  csrGraph_.reset();
+}
+
+void
+LinkState::invalidateMemoization(std::optional<LinkSet> const& changedLinks) {
+  // link metric or state has changed
+  csrGraph_.reset();
+  kthPathResults_.clear();
+  memoizationBytes_ = 0;
+  if (not enableIncrementalSpf_ or not changedLinks.has_value()) {
+    spfResults_.clear();
+    spfChangedLinks_.clear();
+    return;
+  }
+  for (auto const& [key, memoized] : spfResults_) {
+    spfChangedLinks_[key].insert(changedLinks->begin(), changedLinks->end());
+    memoizationBytes_ += memoized.bytes;
+  }
+}
+
+template <typename T>
+void
+LinkState::touchMemoized(Memoized<T> const& memoized) const {
+  auto epoch = memoized.epoch.value.load(std::memory_order_relaxed);
+  if (epoch != memoizationEpoch_ and
+      memoized.epoch.value.compare_exchange_strong(
+          epoch, memoizationEpoch_, std::memory_order_relaxed)) {
+    memoizationHits_.value.fetch_add(1, std::memory_order_relaxed);
+  }
 }
 
-const LinkState::LinkSet&
+void
+LinkState::trimMemoization(size_t budgetBytes) {
+  size_t numEvictions{0};
+  if (budgetBytes and memoizationBytes_ > budgetBytes) {
+    // evict least recently used first, merging both structures by epoch
+    auto epochOf = [](auto const& it) {
+      return it->second.epoch.value.load(std::memory_order_relaxed);
+    };
+    auto byEpoch = [&epochOf](auto const& lhs, auto const& rhs) {
+      return epochOf(lhs) < epochOf(rhs);
+    };
+    std::vector<decltype(spfResults_)::iterator> spfIters;
+    spfIters.reserve(spfResults_.size());
+    for (auto it = spfResults_.begin(); it != spfResults_.end(); ++it) {
+      spfIters.emplace_back(it);
+    }
+    std::sort(spfIters.begin(), spfIters.end(), byEpoch);
+    std::vector<decltype(kthPathResults_)::iterator> kthIters;
+    kthIters.reserve(kthPathResults_.size());
+    for (auto it = kthPathResults_.begin(); it != kthPathResults_.end();
+         ++it) {
+      kthIters.emplace_back(it);
+    }
+    std::sort(kthIters.begin(), kthIters.end(), byEpoch);
+
+    size_t i = 0, j = 0;
+    while (memoizationBytes_ > budgetBytes and
+           (i < spfIters.size() or j < kthIters.size())) {
+      const bool evictSpf = j == kthIters.size() or
+          (i < spfIters.size() and
+           epochOf(spfIters.at(i)) <= epochOf(kthIters.at(j)));
+      if (evictSpf) {
+        auto it = spfIters.at(i++);
+        memoizationBytes_ -= it->second.bytes;
+        spfChangedLinks_.erase(it->first);
+        spfResults_.erase(it);
+      } else {
+        auto it = kthIters.at(j++);
+        memoizationBytes_ -= it->second.bytes;
+        kthPathResults_.erase(it);
+      }
+      ++numEvictions;
+    }
+  }
+  ++memoizationEpoch_;
+
+  fb303::fbData->addStatValue(
+      "decision.spf_memoization.hits",
+      memoizationHits_.value.exchange(0),
+      fb303::COUNT);
+  fb303::fbData->addStatValue(
+      "decision.spf_memoization.misses", memoizationMisses_, fb303::COUNT);
+  memoizationMisses_ = 0;
+  fb303::fbData->addStatValue(
+      "decision.spf_memoization.evictions", numEvictions, fb303::COUNT);
+}
+
+const LinkState::LinkVector&
 LinkState::linksFromNode(const std::string& nodeName) const {
-  static const LinkState::LinkSet defaultEmptySet;
+  static const LinkState::LinkVector defaultEmptyLinks;
   auto search = linkMap_.find(nodeName);
   if (search != linkMap_.end()) {
     return search->second;
   }
-  return defaultEmptySet;
-}
-
-std::vector<std::shared_ptr<Link>>
-LinkState::orderedLinksFromNode(const std::string& nodeName) const {
-  std::vector<std::shared_ptr<Link>> links;
-  if (linkMap_.count(nodeName)) {
-    links.insert(
-        links.begin(),
-        linkMap_.at(nodeName).begin(),
-        linkMap_.at(nodeName).end());
-    std::sort(links.begin(), links.end(), LinkPtrLess{});
-  }
-  return links;
+  return defaultEmptyLinks;
 }
 
 bool
@@ -483,44 +634,62 @@ LinkState::updateNodeOverloaded(
     LinkStateMetric holdUpTtl,
     LinkStateMetric holdDownTtl) {
   if (nodeOverloads_.count(nodeName)) {
-    return nodeOverloads_.at(nodeName).updateValue(
-        isOverloaded, holdUpTtl, holdDownTtl);
+    auto& overload = nodeOverloads_.at(nodeName);
+    const bool changed =
+        overload.updateValue(isOverloaded, holdUpTtl, holdDownTtl);
+    if (overload.hasHold()) {
+      heldNodes_.insert(nodeName);
+    }
+    if (changed) {
+      csrGraph_.reset();
+    }
+    return changed;
   }
   nodeOverloads_.emplace(nodeName, HoldableValue<bool>{isOverloaded});
+  csrGraph_.reset();
   // don't indicate LinkState changed if this is a new node
   return false;
 }
 
 bool
 LinkState::isNodeOverloaded(const std::string& nodeName) const {
-  return nodeOverloads_.count(nodeName) && nodeOverloads_.at(nodeName).value();
+  auto it = nodeOverloads_.find(nodeName);
+  return it != nodeOverloads_.end() && it->second.value();
 }
 
 LinkState::LinkStateChange
 LinkState::decrementHolds() {
   LinkStateChange change;
-  for (auto& link : allLinks_) {
-    change.topologyChanged |= link->decrementHolds();
+  LinkSet changedLinks;
+  bool nodeChanged{false};
+  for (auto it = heldLinks_.begin(); it != heldLinks_.end();) {
+    if ((*it)->decrementHolds()) {
+      changedLinks.insert(*it);
+    }
+    it = (*it)->hasHolds() ? std::next(it) : heldLinks_.erase(it);
   }
-  for (auto& kv : nodeOverloads_) {
-    change.topologyChanged |= kv.second.decrementTtl();
+  for (auto it = heldNodes_.begin(); it != heldNodes_.end();) {
+    auto& overload = nodeOverloads_.at(*it);
+    nodeChanged |= overload.decrementTtl();
+    it = overload.hasHold() ? std::next(it) : heldNodes_.erase(it);
   }
+  change.topologyChanged = nodeChanged or not changedLinks.empty();
   if (change.topologyChanged) {
-    spfResults_.clear();
-    kthPathResults_.clear();
+    invalidateMemoization(
+        nodeChanged ? std::nullopt : std::make_optional(changedLinks));
   }
   return change;
 }
 
 bool
 LinkState::hasHolds() const {
-  for (auto& link : allLinks_) {
+  for (auto const& link : heldLinks_) {
     if (link->hasHolds()) {
       return true;
     }
   }
-  for (auto& kv : nodeOverloads_) {
-    if (kv.second.hasHold()) {
+  for (auto const& nodeName : heldNodes_) {
+    if (nodeOverloads_.at(nodeName).hasHold()) {
       return true;
     }
   }
@@ -591,15 +760,19 @@ LinkState::updateAdjacencyDatabase(
   // for comparing old and new state, we order the links based on the tuple
   // <nodeName1, iface1, nodeName2, iface2>, this allows us to easily discern
   // topology changes in the single loop below
-  auto oldLinks = orderedLinksFromNode(nodeName);
+  // copied, as links of node are updated while iterating
+  auto oldLinks = linksFromNode(nodeName);
   auto newLinks = getOrderedLinkSet(newAdjacencyDb);
 
   // fill these sets with the appropriate links
   std::unordered_set<Link> linksUp;
   std::unordered_set<Link> linksDown;
+  // links altering the topology, i.e. up/down or metric change
+  LinkSet changedLinks;
 
-  change.topologyChanged |= updateNodeOverloaded(
+  const bool nodeChanged = updateNodeOverloaded(
       nodeName, *newAdjacencyDb.isOverloaded_ref(), holdUpTtl, holdDownTtl);
+  change.topologyChanged |= nodeChanged;
 
   change.nodeLabelChanged =
       *priorAdjacencyDb.nodeLabel_ref() != *newAdjacencyDb.nodeLabel_ref();
@@ -612,7 +785,13 @@ LinkState::updateAdjacencyDatabase(
       // newIter is pointing at a Link not currently present, record this as a
       // link to add and advance newIter
       (*newIter)->setHoldUpTtl(holdUpTtl);
-      change.topologyChanged |= (*newIter)->isUp();
+      if ((*newIter)->hasHolds()) {
+        heldLinks_.insert(*newIter);
+      }
+      if ((*newIter)->isUp()) {
+        change.topologyChanged = true;
+        changedLinks.insert(*newIter);
+      }
       // even if we are holding a change, we apply the change to our link state
       // and check for holds when running spf. this ensures we don't add the
       // same hold twice
@@ -627,7 +806,10 @@ LinkState::updateAdjacencyDatabase(
       // as a link to remove and advance oldIter.
       // If this link was previously overloaded or had a hold up, this does not
       // change the topology.
-      change.topologyChanged |= (*oldIter)->isUp();
+      if ((*oldIter)->isUp()) {
+        change.topologyChanged = true;
+        changedLinks.insert(*oldIter);
+      }
       removeLink(*oldIter);
       VLOG(1) << "[LINK DOWN] " << (*oldIter)->toString();
       ++oldIter;
@@ -647,11 +829,14 @@ LinkState::updateAdjacencyDatabase(
           newLink.directionalToString(nodeName),
           oldLink.getMetricFromNode(nodeName),
           newLink.getMetricFromNode(nodeName));
-      change.topologyChanged |= oldLink.setMetricFromNode(
-          nodeName,
-          newLink.getMetricFromNode(nodeName),
-          holdUpTtl,
-          holdDownTtl);
+      if (oldLink.setMetricFromNode(
+              nodeName,
+              newLink.getMetricFromNode(nodeName),
+              holdUpTtl,
+              holdDownTtl)) {
+        change.topologyChanged = true;
+        changedLinks.insert(*oldIter);
+      }
     }
 
     if (newLink.getOverloadFromNode(nodeName) !=
@@ -661,11 +846,14 @@ LinkState::updateAdjacencyDatabase(
           newLink.directionalToString(nodeName),
           oldLink.getOverloadFromNode(nodeName),
           newLink.getOverloadFromNode(nodeName));
-      change.topologyChanged |= oldLink.setOverloadFromNode(
-          nodeName,
-          newLink.getOverloadFromNode(nodeName),
-          holdUpTtl,
-          holdDownTtl);
+      if (oldLink.setOverloadFromNode(
+              nodeName,
+              newLink.getOverloadFromNode(nodeName),
+              holdUpTtl,
+              holdDownTtl)) {
+        change.topologyChanged = true;
+        changedLinks.insert(*oldIter);
+      }
     }
 
     // Check if adjacency label has changed
@@ -707,12 +895,15 @@ LinkState::updateAdjacencyDatabase(
       change.linkAttributesChanged |= true;
       oldLink.setNhV6FromNode(nodeName, newLink.getNhV6FromNode(nodeName));
     }
+    if (oldLink.hasHolds()) {
+      heldLinks_.insert(*oldIter);
+    }
     ++newIter;
     ++oldIter;
   }
   if (change.topologyChanged) {
-    spfResults_.clear();
-    kthPathResults_.clear();
+    invalidateMemoization(
+        nodeChanged ? std::nullopt : std::make_optional(changedLinks));
   }
   return change;
 }
@@ -726,8 +917,7 @@ LinkState::deleteAdjacencyDatabase(const std::string& nodeName) {
   if (search != adjacencyDatabases_.end()) {
     removeNode(nodeName);
     adjacencyDatabases_.erase(search);
-    spfResults_.clear();
-    kthPathResults_.clear();
+    invalidateMemoization(std::nullopt);
     change.topologyChanged = true;
   } else {
     LOG(WARNING) << "Trying to delete adjacency db for non-existing node "
@@ -756,28 +946,270 @@ LinkState::getKthPaths(
   std::tuple<std::string, std::string, size_t> key(src, dest, k);
   auto entryIter = kthPathResults_.find(key);
   if (kthPathResults_.end() == entryIter) {
-    LinkSet linksToIgnore;
     for (size_t i = 1; i < k; ++i) {
-      for (auto const& path : getKthPaths(src, dest, i)) {
-        for (auto const& link : path) {
-          linksToIgnore.insert(link);
+      getKthPaths(src, dest, i);
+    }
+    KthPathsState state;
+    return memoizeKthPaths(
+        std::move(key), computeKthPaths(src, dest, k, state));
+  }
+  touchMemoized(entryIter->second);
+  return entryIter->second.value;
+}
+
+std::vector<LinkState::Path> const&
+LinkState::memoizeKthPaths(
+    std::tuple<std::string, std::string, size_t> key,
+    std::vector<LinkState::Path> paths) const {
+  ++memoizationMisses_;
+  const auto bytes = getMemoizedBytes(paths) +
+      getStringBytes(std::get<0>(key)) + getStringBytes(std::get<1>(key));
+  memoizationBytes_ += bytes;
+  return kthPathResults_
+      .emplace(
+          std::piecewise_construct,
+          std::forward_as_tuple(std::move(key)),
+          std::forward_as_tuple(std::move(paths), bytes, memoizationEpoch_))
+      .first->second.value;
+}
+
+std::vector<LinkState::Path>
+LinkState::computeKthPaths(
+    const std::string& src,
+    const std::string& dest,
+    size_t k,
+    KthPathsState& state) const {
+  LinkSet linksToIgnore;
+  for (size_t i = 1; i < k; ++i) {
+    for (auto const& path : kthPathResults_.at({src, dest, i}).value) {
+      for (auto const& link : path) {
+        linksToIgnore.insert(link);
+      }
+    }
+  }
+  if (not linksToIgnore.empty()) {
+    return tracePrunedPaths(src, dest, linksToIgnore, state);
+  }
+
+  std::vector<LinkState::Path> paths;
+  auto const& res = getSpfResult(src, true);
+  if (res.count(dest)) {
+    LinkSet visitedLinks;
+    auto path = traceOnePath(src, dest, res, visitedLinks);
+    while (path && !path->empty()) {
+      paths.push_back(std::move(*path));
+      path = traceOnePath(src, dest, res, visitedLinks);
+    }
+  }
+  return paths;
+}
+
+std::vector<LinkState::Path>
+LinkState::tracePrunedPaths(
+    const std::string& src,
+    const std::string& dest,
+    const LinkSet& linksToIgnore,
+    KthPathsState& state) const {
+  fb303::fbData->addStatValue("decision.spf_runs", 1, fb303::COUNT);
+
+  auto const& graph = getCsrGraph();
+  auto srcIter = graph.nodeIds.find(src);
+  auto destIter = graph.nodeIds.find(dest);
+  if (graph.nodeIds.end() == srcIter or graph.nodeIds.end() == destIter or
+      src == dest) {
+    return {};
+  }
+  const auto srcId = srcIter->second;
+  const auto destId = destIter->second;
+
+  // reset state left by previous run
+  constexpr auto kMaxMetric = std::numeric_limits<LinkStateMetric>::max();
+  if (state.metrics.size() != graph.nodeNames.size() or
+      state.ignoredEdges.size() != graph.edges.size()) {
+    state.metrics.assign(graph.nodeNames.size(), kMaxMetric);
+    state.settled.assign(graph.nodeNames.size(), false);
+    state.ignoredEdges.assign(graph.edges.size(), false);
+  } else {
+    for (auto const nodeId : state.touchedNodes) {
+      state.metrics[nodeId] = kMaxMetric;
+      state.settled[nodeId] = false;
+    }
+    for (auto const edgeIdx : state.touchedEdges) {
+      state.ignoredEdges[edgeIdx] = false;
+    }
+  }
+  state.touchedNodes.clear();
+  state.touchedEdges.clear();
+  state.pathEdges.clear();
+
+  // edges of ignored links in both directions
+  for (auto const& link : linksToIgnore) {
+    for (auto const& nodeName :
+         {link->firstNodeName(), link->secondNodeName()}) {
+      auto nodeIter = graph.nodeIds.find(nodeName);
+      if (graph.nodeIds.end() == nodeIter) {
+        continue;
+      }
+      const auto nodeId = nodeIter->second;
+      for (auto edgeIdx = graph.offsets[nodeId];
+           edgeIdx < graph.offsets[nodeId + 1];
+           ++edgeIdx) {
+        if (*graph.edges[edgeIdx].link == *link) {
+          state.ignoredEdges[edgeIdx] = true;
+          state.touchedEdges.push_back(edgeIdx);
+        }
+      }
+    }
+  }
+
+  // same as Dijkstra loop of runSpf(), relaxing edges in the same order.
+  // Nodes no closer than dest can't be on its shortest paths.
+  using QEntry = std::pair<LinkStateMetric, uint32_t>;
+  std::priority_queue<QEntry, std::vector<QEntry>, std::greater<QEntry>> q;
+  state.metrics[srcId] = 0;
+  state.touchedNodes.push_back(srcId);
+  q.emplace(0, srcId);
+  while (!q.empty()) {
+    auto const [nodeMetric, nodeId] = q.top();
+    q.pop();
+    if (state.settled[nodeId]) {
+      continue;
+    }
+    if (state.settled[destId] and nodeMetric > state.metrics[destId]) {
+      break;
+    }
+    state.settled[nodeId] = true;
+    if (graph.nodeOverloads[nodeId] && nodeId != srcId) {
+      continue;
+    }
+    for (auto edgeIdx = graph.offsets[nodeId];
+         edgeIdx < graph.offsets[nodeId + 1];
+         ++edgeIdx) {
+      auto const& edge = graph.edges[edgeIdx];
+      if (state.settled[edge.otherNodeId] or state.ignoredEdges[edgeIdx]) {
+        continue;
+      }
+      auto const otherMetric = nodeMetric + edge.metric;
+      auto& bestMetric = state.metrics[edge.otherNodeId];
+      if (otherMetric > bestMetric) {
+        continue;
+      }
+      if (otherMetric < bestMetric) {
+        if (bestMetric == kMaxMetric) {
+          state.touchedNodes.push_back(edge.otherNodeId);
         }
+        bestMetric = otherMetric;
+        q.emplace(otherMetric, edge.otherNodeId);
       }
+      state.pathEdges.push_back(
+          KthPathsState::PathEdge{edge.otherNodeId, nodeId, edgeIdx});
     }
-    std::vector<LinkState::Path> paths;
-    auto const& res = linksToIgnore.empty() ? getSpfResult(src, true)
-                                            : runSpf(src, true, linksToIgnore);
-    if (res.count(dest)) {
-      LinkSet visitedLinks;
-      auto path = traceOnePath(src, dest, res, visitedLinks);
-      while (path && !path->empty()) {
-        paths.push_back(std::move(*path));
-        path = traceOnePath(src, dest, res, visitedLinks);
+  }
+  if (not state.settled[destId]) {
+    return {};
+  }
+
+  // keep edges on shortest paths towards settled nodes, grouped by node in
+  // order of relaxing
+  auto& pathEdges = state.pathEdges;
+  pathEdges.erase(
+      std::remove_if(
+          pathEdges.begin(),
+          pathEdges.end(),
+          [&](KthPathsState::PathEdge const& pathEdge) {
+            return not state.settled[pathEdge.nodeId] or
+                state.metrics[pathEdge.prevNodeId] +
+                    graph.edges[pathEdge.edgeIdx].metric !=
+                state.metrics[pathEdge.nodeId];
+          }),
+      pathEdges.end());
+  auto byNodeId = [](KthPathsState::PathEdge const& lhs,
+                     KthPathsState::PathEdge const& rhs) {
+    return lhs.nodeId < rhs.nodeId;
+  };
+  std::stable_sort(pathEdges.begin(), pathEdges.end(), byNodeId);
+
+  // same as traceOnePath() over path edges
+  std::unordered_set<Link const*> visitedLinks;
+  std::function<std::optional<Path>(uint32_t)> traceOne =
+      [&](uint32_t nodeId) -> std::optional<Path> {
+    if (nodeId == srcId) {
+      return Path{};
+    }
+    auto [begin, end] = std::equal_range(
+        pathEdges.begin(),
+        pathEdges.end(),
+        KthPathsState::PathEdge{nodeId, 0, 0},
+        byNodeId);
+    for (auto it = begin; it != end; ++it) {
+      auto const& link = graph.edges[it->edgeIdx].link;
+      if (visitedLinks.insert(link.get()).second) {
+        auto path = traceOne(it->prevNodeId);
+        if (path) {
+          path->push_back(link);
+          return path;
+        }
       }
     }
-    entryIter = kthPathResults_.emplace(key, std::move(paths)).first;
+    return std::nullopt;
+  };
+
+  std::vector<LinkState::Path> paths;
+  auto path = traceOne(destId);
+  while (path && !path->empty()) {
+    paths.push_back(std::move(*path));
+    path = traceOne(destId);
+  }
+  return paths;
+}
+
+void
+LinkState::prefetchKthPaths(
+    const std::string& src,
+    std::vector<std::string> const& dests,
+    folly::Executor* executor) const {
+  // Everything shared by computations of distinct dests is computed upfront,
+  // so that concurrent computations read memoized results only
+  getSpfResult(src, true);
+  getCsrGraph();
+  std::vector<std::string const*> pendingDests;
+  for (auto const& dest : dests) {
+    getKthPaths(src, dest, 1);
+    if (not kthPathResults_.count({src, dest, 2})) {
+      pendingDests.emplace_back(&dest);
+    }
+  }
+
+  // dests are computed in batches sharing the state of pruned SPF runs
+  std::vector<folly::Future<std::vector<std::vector<LinkState::Path>>>>
+      futures;
+  futures.reserve(
+      (pendingDests.size() + kKthPathsBatchSize - 1) / kKthPathsBatchSize);
+  for (size_t begin = 0; begin < pendingDests.size();
+       begin += kKthPathsBatchSize) {
+    const auto end =
+        std::min(begin + kKthPathsBatchSize, pendingDests.size());
+    futures.emplace_back(
+        folly::via(executor, [this, &src, &pendingDests, begin, end]() {
+          KthPathsState state;
+          std::vector<std::vector<LinkState::Path>> batch;
+          batch.reserve(end - begin);
+          for (size_t i = begin; i < end; ++i) {
+            batch.emplace_back(
+                computeKthPaths(src, *pendingDests.at(i), 2, state));
+          }
+          return batch;
+        }));
+  }
+  auto results = folly::collectAll(std::move(futures)).get();
+  size_t i = 0;
+  for (auto& result : results) {
+    for (auto& paths : result.value()) {
+      memoizeKthPaths(
+          std::make_tuple(src, *pendingDests.at(i++), size_t{2}),
+          std::move(paths));
+    }
   }
-  return entryIter->second;
 }
 
 LinkState::SpfResult const&
@@ -786,14 +1218,79 @@ LinkState::getSpfResult(
   std::pair<std::string, bool> key{thisNodeName, useLinkMetric};
   auto entryIter = spfResults_.find(key);
   if (spfResults_.end() == entryIter) {
+    ++memoizationMisses_;
     auto res = runSpf(thisNodeName, useLinkMetric);
-    entryIter = spfResults_.emplace(std::move(key), std::move(res)).first;
+    const auto bytes = getMemoizedBytes(res) + getStringBytes(thisNodeName);
+    memoizationBytes_ += bytes;
+    entryIter = spfResults_
+                    .emplace(
+                        std::piecewise_construct,
+                        std::forward_as_tuple(std::move(key)),
+                        std::forward_as_tuple(
+                            std::move(res), bytes, memoizationEpoch_))
+                    .first;
+    return entryIter->second.value;
+  }
+
+  auto& memoized = entryIter->second;
+  if (auto changedIter = spfChangedLinks_.find(key);
+      spfChangedLinks_.end() != changedIter) {
+    runIncrementalSpf(
+        thisNodeName, useLinkMetric, changedIter->second, memoized.value);
+    spfChangedLinks_.erase(changedIter);
+    // repaired in place
+    memoizationBytes_ -= memoized.bytes;
+    memoized.bytes =
+        getMemoizedBytes(memoized.value) + getStringBytes(thisNodeName);
+    memoizationBytes_ += memoized.bytes;
   }
-  return entryIter->second;
+  touchMemoized(memoized);
+  return memoized.value;
+}
+
+LinkState::CsrGraph const&
+LinkState::getCsrGraph() const {
+  if (csrGraph_.has_value()) {
+    return *csrGraph_;
+  }
+
+  auto& graph = csrGraph_.emplace();
+  graph.nodeNames.reserve(linkMap_.size());
+  for (auto const& [nodeName, _] : linkMap_) {
+    graph.nodeNames.emplace_back(nodeName);
+  }
+  // IDs in order of names keep tie-breaking of equal metric nodes in Dijkstra
+  std::sort(graph.nodeNames.begin(), graph.nodeNames.end());
+  graph.nodeIds.reserve(graph.nodeNames.size());
+  for (uint32_t id = 0; id < graph.nodeNames.size(); ++id) {
+    graph.nodeIds.emplace(graph.nodeNames.at(id), id);
+  }
+
+  graph.nodeOverloads.reserve(graph.nodeNames.size());
+  graph.offsets.reserve(graph.nodeNames.size() + 1);
+  graph.edges.reserve(2 * allLinks_.size());
+  for (auto const& nodeName : graph.nodeNames) {
+    graph.nodeOverloads.push_back(isNodeOverloaded(nodeName));
+    graph.offsets.push_back(graph.edges.size());
+    for (auto const& link : linkMap_.at(nodeName)) {
+      if (!link->isUp()) {
+        continue;
+      }
+      graph.edges.push_back(CsrGraph::Edge{
+          graph.nodeIds.at(link->getOtherNodeName(nodeName)),
+          link->getMetricFromNode(nodeName),
+          link});
+    }
+  }
+  graph.offsets.push_back(graph.edges.size());
+  return graph;
 }
 
 /**
  * Compute shortest-path routes from perspective of nodeName;
+ *
+ * Dijkstra runs over integer node IDs of CSR graph. Shortest paths and
+ * nexthops are translated back to node names once all nodes are visited.
  */
 LinkState::SpfResult
 LinkState::runSpf(
@@ -804,65 +1301,144 @@ LinkState::runSpf(
 
   fb303::fbData->addStatValue("decision.spf_runs", 1, fb303::COUNT);
   const auto startTime = std::chrono::steady_clock::now();
-
-  DijkstraQ q;
-  q.insertNode(thisNodeName, 0);
+  ScopedTraceSpan traceSpan("decision.spf", area_);
+
+  auto const& graph = getCsrGraph();
+  auto const numNodes = graph.nodeNames.size();
+  traceSpan.setCount(numNodes);
+  auto getMetric = [useLinkMetric](CsrGraph::Edge const& edge) {
+    return useLinkMetric ? edge.metric : 1;
+  };
+
+  // edge on a path towards node, prevNodeId being the other end of edge
+  struct PathEdge {
+    uint32_t nodeId{0};
+    uint32_t prevNodeId{0};
+    uint32_t edgeIdx{0};
+  };
+  std::vector<LinkStateMetric> metrics(
+      numNodes, std::numeric_limits<LinkStateMetric>::max());
+  std::vector<bool> visited(numNodes, false);
+  // visited nodes in order of increasing metric
+  std::vector<uint32_t> visitOrder;
+  visitOrder.reserve(numNodes);
+  // edges on paths no worse than the best one at the time of relaxing
+  std::vector<PathEdge> pathEdges;
+  pathEdges.reserve(numNodes);
+
+  auto srcIter = graph.nodeIds.find(thisNodeName);
+  if (graph.nodeIds.end() == srcIter) {
+    // node without any link only reaches itself
+    result.emplace(thisNodeName, NodeSpfResult(0));
+    return result;
+  }
+  const auto srcId = srcIter->second;
+
+  // min-heap of (metric, nodeId). Entries of nodes which got a lower metric
+  // since are skipped on extraction as those nodes are already visited.
+  using QEntry = std::pair<LinkStateMetric, uint32_t>;
+  std::priority_queue<QEntry, std::vector<QEntry>, std::greater<QEntry>> q;
+  metrics.at(srcId) = 0;
+  q.emplace(0, srcId);
   uint64_t loop = 0;
-  while (auto node = q.extractMin()) {
+  while (!q.empty()) {
+    auto const [nodeMetric, nodeId] = q.top();
+    q.pop();
+    if (visited[nodeId]) {
+      continue;
+    }
     ++loop;
     // we've found this node's shortest paths. record it
-    auto emplaceRc = result.emplace(node->nodeName, std::move(node->result));
-    CHECK(emplaceRc.second);
+    visited[nodeId] = true;
+    visitOrder.push_back(nodeId);
 
-    auto const& recordedNodeName = emplaceRc.first->first;
-    auto const recordedNodeMetric = emplaceRc.first->second.metric();
-    auto const& recordedNodeNextHops = emplaceRc.first->second.nextHops();
-
-    if (isNodeOverloaded(recordedNodeName) &&
-        recordedNodeName != thisNodeName) {
+    if (graph.nodeOverloads[nodeId] && nodeId != srcId) {
       // no transit traffic through this node. we've recorded the nexthops to
       // this node, but will not consider any of it's adjancecies as offering
       // lower cost paths towards further away nodes. This effectively drains
       // traffic away from this node
       continue;
     }
-    // we have the shortest path nexthops for recordedNodeName. Use these
-    // nextHops for any node that is connected to recordedNodeName that doesn't
-    // already have a lower cost path from thisNodeName
-    //
     // this is the "relax" step in the Dijkstra Algorithm pseudocode in CLRS
-    for (const auto& link : linksFromNode(recordedNodeName)) {
-      auto& otherNodeName = link->getOtherNodeName(recordedNodeName);
-      if (!link->isUp() or result.count(otherNodeName) or
-          linksToIgnore.count(link)) {
+    for (auto edgeIdx = graph.offsets[nodeId];
+         edgeIdx < graph.offsets[nodeId + 1];
+         ++edgeIdx) {
+      auto const& edge = graph.edges[edgeIdx];
+      if (visited[edge.otherNodeId] or
+          (!linksToIgnore.empty() and linksToIgnore.count(edge.link))) {
         continue;
       }
-      auto metric =
-          useLinkMetric ? link->getMetricFromNode(recordedNodeName) : 1;
-      auto otherNode = q.get(otherNodeName);
-      if (!otherNode) {
-        q.insertNode(otherNodeName, recordedNodeMetric + metric);
-        otherNode = q.get(otherNodeName);
-      }
-      if (otherNode->result.metric() >= recordedNodeMetric + metric) {
-        // recordedNodeName is either along an alternate shortest path towards
-        // otherNodeName or is along a new shorter path. In either case,
-        // otherNodeName should use recordedNodeName's nextHops until it finds
-        // some shorter path
-        if (otherNode->result.metric() > recordedNodeMetric + metric) {
-          // if this is strictly better, forget about any other paths
-          otherNode->result.reset(recordedNodeMetric + metric);
-          q.reMake();
-        }
-        otherNode->result.addPath(link, recordedNodeName);
-        otherNode->result.addNextHops(recordedNodeNextHops);
-        if (otherNode->result.nextHops().empty()) {
-          // directly connected node
-          otherNode->result.addNextHop(otherNodeName);
-        }
+      auto const otherMetric = nodeMetric + getMetric(edge);
+      auto& bestMetric = metrics[edge.otherNodeId];
+      if (otherMetric > bestMetric) {
+        continue;
+      }
+      if (otherMetric < bestMetric) {
+        bestMetric = otherMetric;
+        q.emplace(otherMetric, edge.otherNodeId);
       }
+      pathEdges.push_back(PathEdge{edge.otherNodeId, nodeId, edgeIdx});
+    }
+  }
+
+  // keep edges on shortest paths only, grouped by node in order of relaxing
+  auto isShortest = [&](PathEdge const& pathEdge) {
+    return metrics[pathEdge.prevNodeId] +
+        getMetric(graph.edges[pathEdge.edgeIdx]) ==
+        metrics[pathEdge.nodeId];
+  };
+  std::vector<uint32_t> pathOffsets(numNodes + 1, 0);
+  for (auto const& pathEdge : pathEdges) {
+    if (isShortest(pathEdge)) {
+      ++pathOffsets[pathEdge.nodeId + 1];
+    }
+  }
+  std::partial_sum(pathOffsets.begin(), pathOffsets.end(), pathOffsets.begin());
+  std::vector<PathEdge> shortestPathEdges(pathOffsets.back());
+  std::vector<uint32_t> nextFree(pathOffsets.begin(), pathOffsets.end() - 1);
+  for (auto const& pathEdge : pathEdges) {
+    if (isShortest(pathEdge)) {
+      shortestPathEdges[nextFree[pathEdge.nodeId]++] = pathEdge;
     }
   }
+
+  // nexthops are node IDs, previous nodes are visited first
+  std::vector<std::vector<uint32_t>> nextHops(numNodes);
+  result.reserve(visitOrder.size());
+  for (auto const nodeId : visitOrder) {
+    auto& nodeNextHops = nextHops[nodeId];
+    for (auto i = pathOffsets[nodeId]; i < pathOffsets[nodeId + 1]; ++i) {
+      auto const prevNodeId = shortestPathEdges[i].prevNodeId;
+      if (prevNodeId == srcId) {
+        // directly connected node
+        nodeNextHops.push_back(nodeId);
+      } else {
+        nodeNextHops.insert(
+            nodeNextHops.end(),
+            nextHops[prevNodeId].begin(),
+            nextHops[prevNodeId].end());
+      }
+    }
+    std::sort(nodeNextHops.begin(), nodeNextHops.end());
+    nodeNextHops.erase(
+        std::unique(nodeNextHops.begin(), nodeNextHops.end()),
+        nodeNextHops.end());
+
+    auto& nodeResult =
+        result
+            .emplace(graph.nodeNames[nodeId], NodeSpfResult(metrics[nodeId]))
+            .first->second;
+    for (auto i = pathOffsets[nodeId]; i < pathOffsets[nodeId + 1]; ++i) {
+      auto const& pathEdge = shortestPathEdges[i];
+      nodeResult.addPath(
+          graph.edges[pathEdge.edgeIdx].link,
+          graph.nodeNames[pathEdge.prevNodeId]);
+    }
+    for (auto const nextHopId : nodeNextHops) {
+      nodeResult.addNextHop(graph.nodeNames[nextHopId]);
+    }
+  }
+
   VLOG(3) << "Dijkstra loop count: " << loop;
   auto deltaTime = std::chrono::duration_cast<std::chrono::milliseconds>(
       std::chrono::steady_clock::now() - startTime);
@@ -871,4 +1447,203 @@ LinkState::runSpf(
   return result;
 }
 
+/**
+ * Repair shortest-path result of thisNodeName after changedLinks went
+ * up/down or changed metric:
+ *  1. Erase nodes whose shortest paths traversed a changed link or may get
+ *     a new path no worse than the current ones over a changed link, as well
+ *     as all nodes whose shortest paths go through erased nodes
+ *  2. Run Dijkstra over erased nodes, seeded by nodes left in the result. If
+ *     a recomputed node offers a path no worse than the one of a node left in
+ *     the result, the latter and its subtree are erased and recomputed too
+ */
+void
+LinkState::runIncrementalSpf(
+    const std::string& thisNodeName,
+    bool useLinkMetric,
+    const LinkState::LinkSet& changedLinks,
+    LinkState::SpfResult& result) const {
+  fb303::fbData->addStatValue("decision.spf_runs", 1, fb303::COUNT);
+  fb303::fbData->addStatValue(
+      "decision.incremental_spf_runs", 1, fb303::COUNT);
+  const auto startTime = std::chrono::steady_clock::now();
+
+  auto getMetric = [useLinkMetric](
+                       Link const& link, std::string const& fromNode) {
+    return useLinkMetric ? link.getMetricFromNode(fromNode) : 1;
+  };
+  // overloaded nodes carry no transit traffic, see runSpf()
+  auto isTransit = [this, &thisNodeName](std::string const& nodeName) {
+    return nodeName == thisNodeName or not isNodeOverloaded(nodeName);
+  };
+  auto hasPathFrom = [](NodeSpfResult const& nodeResult,
+                        std::string const& prevNode) {
+    for (auto const& pathLink : nodeResult.pathLinks()) {
+      if (pathLink.prevNode == prevNode) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  DijkstraQ q;
+  // nodes recomputed by this run, their results are final
+  std::unordered_set<std::string> recomputed;
+
+  // same as "relax" step of runSpf(), prevNode's result is final
+  auto relax = [&](std::string const& prevNode,
+                   NodeSpfResult const& prevResult,
+                   std::shared_ptr<Link> const& link,
+                   std::string const& nodeName) {
+    auto const metric = prevResult.metric() + getMetric(*link, prevNode);
+    auto node = q.get(nodeName);
+    if (!node) {
+      q.insertNode(nodeName, metric);
+      node = q.get(nodeName);
+    }
+    if (node->result.metric() >= metric) {
+      if (node->result.metric() > metric) {
+        node->result.reset(metric);
+        q.update(*node);
+      }
+      node->result.addPath(link, prevNode);
+      node->result.addNextHops(prevResult.nextHops());
+      if (node->result.nextHops().empty()) {
+        // directly connected node
+        node->result.addNextHop(nodeName);
+      }
+    }
+  };
+
+  // relax links towards nodeName from all neighbors in result
+  auto seed = [&](std::string const& nodeName) {
+    for (auto const& link : linksFromNode(nodeName)) {
+      auto const& prevNode = link->getOtherNodeName(nodeName);
+      auto prevIter = result.find(prevNode);
+      if (!link->isUp() or result.end() == prevIter or !isTransit(prevNode)) {
+        continue;
+      }
+      relax(prevNode, prevIter->second, link, nodeName);
+    }
+  };
+
+  // erase nodes and their subtrees of shortest paths from result, then seed
+  // them. Queued nodes relaxed from erased nodes are seeded from scratch.
+  auto recompute = [&](std::vector<std::string> nodes) {
+    std::unordered_set<std::string> erased;
+    while (!nodes.empty()) {
+      auto nodeName = std::move(nodes.back());
+      nodes.pop_back();
+      if (nodeName == thisNodeName or recomputed.count(nodeName) or
+          erased.count(nodeName)) {
+        continue;
+      }
+      result.erase(nodeName);
+      for (auto const& link : linksFromNode(nodeName)) {
+        auto const& otherNodeName = link->getOtherNodeName(nodeName);
+        auto otherIter = result.find(otherNodeName);
+        if (result.end() != otherIter and
+            hasPathFrom(otherIter->second, nodeName)) {
+          nodes.emplace_back(otherNodeName);
+        }
+      }
+      erased.emplace(std::move(nodeName));
+    }
+
+    std::unordered_set<std::string> stale;
+    for (auto const& nodeName : erased) {
+      for (auto const& link : linksFromNode(nodeName)) {
+        auto const& otherNodeName = link->getOtherNodeName(nodeName);
+        auto otherNode = q.get(otherNodeName);
+        if (otherNode and !erased.count(otherNodeName) and
+            hasPathFrom(otherNode->result, nodeName)) {
+          stale.emplace(otherNodeName);
+        }
+      }
+    }
+    for (auto const& nodeName : stale) {
+      auto staleNode = q.get(nodeName);
+      staleNode->result.reset(std::numeric_limits<LinkStateMetric>::max());
+      q.update(*staleNode);
+      seed(nodeName);
+    }
+    for (auto const& nodeName : erased) {
+      seed(nodeName);
+    }
+  };
+
+  // 1. nodes directly affected by changed links
+  std::vector<std::string> affected;
+  for (auto const& changedLink : changedLinks) {
+    // changed link object may have been replaced or removed since
+    auto linkIter = allLinks_.find(changedLink);
+    auto const link = allLinks_.end() != linkIter and (*linkIter)->isUp()
+        ? *linkIter
+        : nullptr;
+    for (auto const& nodeName :
+         {changedLink->firstNodeName(), changedLink->secondNodeName()}) {
+      auto const& prevNode = changedLink->getOtherNodeName(nodeName);
+      auto nodeIter = result.find(nodeName);
+      auto prevIter = result.find(prevNode);
+      // shortest paths towards nodeName traversed the link
+      bool isAffected = false;
+      if (result.end() != nodeIter) {
+        for (auto const& pathLink : nodeIter->second.pathLinks()) {
+          isAffected |= *pathLink.link == *changedLink;
+        }
+      }
+      // link offers a path towards nodeName no worse than current ones
+      if (link and result.end() != prevIter and isTransit(prevNode)) {
+        isAffected |= result.end() == nodeIter or
+            nodeIter->second.metric() >=
+                prevIter->second.metric() + getMetric(*link, prevNode);
+      }
+      if (isAffected) {
+        affected.emplace_back(nodeName);
+      }
+    }
+  }
+  recompute(std::move(affected));
+
+  // 2. Dijkstra over affected nodes
+  uint64_t loop = 0;
+  while (auto node = q.extractMin()) {
+    if (node->result.pathLinks().empty()) {
+      // all paths seeded before got erased, no longer reachable
+      continue;
+    }
+    ++loop;
+    auto emplaceRc = result.emplace(node->nodeName, std::move(node->result));
+    CHECK(emplaceRc.second);
+    recomputed.emplace(node->nodeName);
+
+    auto const& recordedNodeName = emplaceRc.first->first;
+    auto const& recordedNodeResult = emplaceRc.first->second;
+    if (!isTransit(recordedNodeName)) {
+      continue;
+    }
+    for (auto const& link : linksFromNode(recordedNodeName)) {
+      auto const& otherNodeName = link->getOtherNodeName(recordedNodeName);
+      if (!link->isUp() or recomputed.count(otherNodeName)) {
+        continue;
+      }
+      auto const metric =
+          recordedNodeResult.metric() + getMetric(*link, recordedNodeName);
+      auto otherIter = result.find(otherNodeName);
+      if (result.end() == otherIter) {
+        relax(recordedNodeName, recordedNodeResult, link, otherNodeName);
+      } else if (otherIter->second.metric() >= metric) {
+        // node left in result gets a new path no worse than current ones.
+        // recompute() seeds it from recordedNodeName as well
+        recompute({otherNodeName});
+      }
+    }
+  }
+  VLOG(3) << "Incremental Dijkstra loop count: " << loop;
+  auto deltaTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - startTime);
+  VLOG(3) << "Incremental SPF elapsed time: " << deltaTime.count() << "ms.";
+  fb303::fbData->addStatValue("decision.spf_ms", deltaTime.count(), fb303::AVG);
+}
+
 } // namespace openr
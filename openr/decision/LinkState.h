@@ -8,12 +8,16 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include <folly/Executor.h>
+
 #include <openr/if/gen-cpp2/Network_types.h>
 #include <openr/if/gen-cpp2/Types_types.h>
 
@@ -176,7 +180,8 @@ class Link {
 
 class LinkState {
  public:
-  explicit LinkState(const std::string& area);
+  explicit LinkState(
+      const std::string& area, bool enableIncrementalSpf = true);
 
   struct LinkPtrHash {
     size_t operator()(const std::shared_ptr<Link>& l) const;
@@ -197,6 +202,9 @@ class LinkState {
   using LinkSet =
       std::unordered_set<std::shared_ptr<Link>, LinkPtrHash, LinkPtrEqual>;
 
+  // links ordered by LinkPtrLess
+  using LinkVector = std::vector<std::shared_ptr<Link>>;
+
   // Class holding a network node's SPF result. and useful apis to get and set
   //   - nexthops toward the node
   //   - ultimate link and previous nodes on shortest paths towards node
@@ -268,19 +276,91 @@ class LinkState {
   // each is memoized all params. memoization invalidated for any topolgy
   // altering calls, i.e. if decrementHolds(), updateAdjacencyDatabase(), or
   // deleteAdjacencyDatabase() returns with LinkState::topologyChanged set true
+  //
+  // If incremental SPF is enabled and the topology change is limited to links
+  // going up/down or changing metric, memoized SpfResult is kept and only the
+  // nodes affected by changed links are recomputed on next getSpfResult()
   SpfResult const& getSpfResult(
       const std::string& nodeName, bool useLinkMetric = true) const;
 
+  // Bound memoized SpfResults and paths to `budgetBytes` (estimated) by
+  // evicting least recently used ones, 0 leaves them unbounded. A use is
+  // recorded per epoch, which is advanced by this call, i.e. results used
+  // since the previous call are evicted last.
+  //
+  // NOTE: invalidates references returned by getSpfResult() and
+  //       getKthPaths(), hence must be called once routes are computed
+  void trimMemoization(size_t budgetBytes);
+
+  // Drop all memoized SpfResults and paths, e.g. to shed memory
+  //
+  // NOTE: invalidates references returned by getSpfResult() and getKthPaths()
+  void
+  clearMemoization() {
+    invalidateMemoization(std::nullopt);
+  }
+
+  // estimated bytes held by memoized SpfResults and paths
+  size_t
+  getMemoizationBytes() const {
+    return memoizationBytes_;
+  }
+
  private:
+  // Relaxed atomic, copied along with LinkState. Memoized values are read
+  // concurrently (see prefetchKthPaths()), which is when their use is
+  // recorded.
+  struct MemoizationCounter {
+    explicit MemoizationCounter(uint64_t v) : value(v) {}
+
+    MemoizationCounter(MemoizationCounter const& other)
+        : value(other.value.load(std::memory_order_relaxed)) {}
+
+    MemoizationCounter&
+    operator=(MemoizationCounter const& other) {
+      value.store(
+          other.value.load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+      return *this;
+    }
+
+    mutable std::atomic<uint64_t> value{0};
+  };
+
+  // Value of memoization structures along with its estimated size and the
+  // latest epoch it was used in, see trimMemoization()
+  template <typename T>
+  struct Memoized {
+    Memoized(T v, size_t bytes, uint64_t epoch)
+        : value(std::move(v)), bytes(bytes), epoch(epoch) {}
+
+    T value;
+    size_t bytes{0};
+    MemoizationCounter epoch;
+  };
+
+  // record use of memoized value in the current epoch
+  template <typename T>
+  void touchMemoized(Memoized<T> const& memoized) const;
+
   // LinkState belongs to a unique area
   const std::string area_;
 
+  // repair memoized SpfResult on link changes instead of full SPF run
+  const bool enableIncrementalSpf_{true};
+
   // memoization structure for getSpfResult()
   mutable std::unordered_map<
       std::pair<std::string /* nodeName */, bool /* useLinkMetric */>,
-      SpfResult>
+      Memoized<SpfResult>>
       spfResults_;
 
+  // links changed since memoized SpfResult was computed or last repaired
+  mutable std::unordered_map<
+      std::pair<std::string /* nodeName */, bool /* useLinkMetric */>,
+      LinkSet>
+      spfChangedLinks_;
+
  public:
   // Trace edge-disjoint paths from dest to src.
   // I.e., no two paths returned from this function can share any links
@@ -293,13 +373,95 @@ class LinkState {
   std::vector<LinkState::Path> const& getKthPaths(
       const std::string& src, const std::string& dest, size_t k) const;
 
+  // Memoize getKthPaths(src, dest, k) of all dests for k <= 2. Second
+  // shortest paths towards batches of distinct dests are computed in parallel
+  // on `executor`, results are memoized in order of dests.
+  //
+  // NOTE: blocks till all paths are computed, hence MUST NOT be called from
+  //       a thread of `executor`
+  void prefetchKthPaths(
+      const std::string& src,
+      std::vector<std::string> const& dests,
+      folly::Executor* executor) const;
+
+  // check if path A is a prefix of path B, i.e. path B goes through path A.
+  // Same as pathAInPathB() for paths from the same source as traced paths
+  // visit the source only once, but linear in the length of path A.
+  static bool
+  pathAPrefixOfPathB(Path const& a, Path const& b) {
+    if (a.size() > b.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+      if (!(*a.at(i) == *b.at(i))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
  private:
+  // Scratch state shared by pruned SPF runs from one source towards distinct
+  // dests. Buffers are sized by the CSR graph once and reset by touched
+  // entries only, so a run costs the part of the graph it explores.
+  struct KthPathsState {
+    // edge relaxed towards nodeId from prevNodeId, see runSpf()
+    struct PathEdge {
+      uint32_t nodeId{0};
+      uint32_t prevNodeId{0};
+      uint32_t edgeIdx{0};
+    };
+
+    std::vector<LinkStateMetric> metrics;
+    std::vector<bool> settled;
+    std::vector<bool> ignoredEdges;
+    std::vector<uint32_t> touchedNodes;
+    std::vector<uint32_t> touchedEdges;
+    std::vector<PathEdge> pathEdges;
+  };
+
+  // compute paths for getKthPaths() without memoizing them. Invoked
+  // concurrently by prefetchKthPaths(), reading memoized paths for lower k
+  // and SpfResult of src only.
+  std::vector<LinkState::Path> computeKthPaths(
+      const std::string& src,
+      const std::string& dest,
+      size_t k,
+      KthPathsState& state) const;
+
+  // trace edge-disjoint paths from dest to src, same as traceOnePath() over
+  // runSpf(src, true, linksToIgnore), but Dijkstra stops as soon as all
+  // shortest paths towards dest are known and runs on integer IDs of the CSR
+  // graph without building SpfResult.
+  std::vector<LinkState::Path> tracePrunedPaths(
+      const std::string& src,
+      const std::string& dest,
+      const LinkSet& linksToIgnore,
+      KthPathsState& state) const;
+
   // memoization structure for getKthPaths()
   mutable std::unordered_map<
       std::tuple<std::string /* src */, std::string /* dest */, size_t /* k */>,
-      std::vector<LinkState::Path>>
+      Memoized<std::vector<LinkState::Path>>>
       kthPathResults_;
 
+  // memoize paths computed for getKthPaths()
+  std::vector<LinkState::Path> const& memoizeKthPaths(
+      std::tuple<std::string, std::string, size_t> key,
+      std::vector<LinkState::Path> paths) const;
+
+  // current epoch of memoization, see trimMemoization()
+  uint64_t memoizationEpoch_{0};
+
+  // sum of `bytes` of memoized values
+  mutable size_t memoizationBytes_{0};
+
+  // memoized values used again in a later epoch, counted once per epoch
+  MemoizationCounter memoizationHits_{0};
+
+  // values computed for memoization
+  mutable uint64_t memoizationMisses_{0};
+
  public:
   // non-const public methods
   // IMPT: clear memoization structures as appropirate in these functions
@@ -324,6 +486,8 @@ class LinkState {
     bool nodeLabelChanged{false};
   };
 
+  // decrement holds of links and nodes that have any, O(held) per call.
+  // Memoized SPF results are repaired for links whose hold expired.
   LinkStateChange decrementHolds();
 
   // update adjacencies for the given router
@@ -355,7 +519,8 @@ class LinkState {
     return 0 != adjacencyDatabases_.count(nodeName);
   }
 
-  const LinkSet& linksFromNode(const std::string& nodeName) const;
+  // links of node, ordered by LinkPtrLess
+  const LinkVector& linksFromNode(const std::string& nodeName) const;
 
   bool isNodeOverloaded(const std::string& nodeName) const;
 
@@ -418,6 +583,11 @@ class LinkState {
 
   void removeNode(const std::string& nodeName);
 
+  // invalidate memoization structures on topology change. If the change is
+  // limited to `changedLinks`, memoized SpfResult is kept for incremental
+  // repair, otherwise it is cleared
+  void invalidateMemoization(std::optional<LinkSet> const& changedLinks);
+
   bool updateNodeOverloaded(
       const std::string& nodeName,
       bool isOverloaded,
@@ -434,6 +604,38 @@ class LinkState {
           {} /* optionaly specify a set of links to not use when running */)
       const;
 
+  // Compressed sparse row (CSR) layout of the graph formed by links that are
+  // up. Nodes are mapped to dense integer IDs assigned in order of node names
+  // and edges of each node are stored contiguously with metrics inline.
+  struct CsrGraph {
+    struct Edge {
+      uint32_t otherNodeId{0};
+      // metric of the link as advertised by this node
+      LinkStateMetric metric{0};
+      std::shared_ptr<Link> link;
+    };
+
+    std::unordered_map<std::string, uint32_t> nodeIds;
+    std::vector<std::string> nodeNames;
+    std::vector<bool> nodeOverloads;
+    // edges of node `id` are edges[offsets[id]] to edges[offsets[id + 1] - 1]
+    std::vector<uint32_t> offsets;
+    std::vector<Edge> edges;
+  };
+
+  // CSR graph for runSpf(), built on demand after any change to links or
+  // node overloads
+  CsrGraph const& getCsrGraph() const;
+
+  // repair SpfResult computed from `src` before `changedLinks` went up/down
+  // or changed metric. Only nodes whose shortest paths may have changed are
+  // erased and recomputed by Dijkstra seeded from the rest of the result.
+  void runIncrementalSpf(
+      const std::string& src,
+      bool useLinkMetric,
+      const LinkSet& changedLinks,
+      SpfResult& result) const;
+
   // returns Link object if the reverse adjancency is present in
   // adjacencyDatabases_.at(adj.otherNodeName), else returns nullptr
   std::shared_ptr<Link> maybeMakeLink(
@@ -442,25 +644,32 @@ class LinkState {
   std::vector<std::shared_ptr<Link>> getOrderedLinkSet(
       const thrift::AdjacencyDatabase& adjDb) const;
 
-  std::vector<std::shared_ptr<Link>> orderedLinksFromNode(
-      const std::string& nodeName) const;
-
-  // this stores the same link object accessible from either nodeName
-  std::unordered_map<std::string /* nodeName */, LinkSet> linkMap_;
+  // this stores the same link object accessible from either nodeName. Links
+  // are kept sorted on addLink() and removeLink(), hence traversals neither
+  // allocate nor sort
+  std::unordered_map<std::string /* nodeName */, LinkVector> linkMap_;
 
   // useful for iterating over all the links
   LinkSet allLinks_;
 
+  // cached CSR graph, reset whenever links or node overloads change
+  mutable std::optional<CsrGraph> csrGraph_;
+
   std::unordered_map<std::string /* nodeName */, HoldableValue<bool>>
       nodeOverloads_;
 
+  // links and nodes with an active hold, superset of those whose hasHolds()
+  // is true. Trimmed by decrementHolds()
+  LinkSet heldLinks_;
+  std::unordered_set<std::string /* nodeName */> heldNodes_;
+
   // the latest AdjacencyDatabase we've received from each node
   std::unordered_map<std::string, thrift::AdjacencyDatabase>
       adjacencyDatabases_;
 
 }; // class LinkState
 
-// Classes needed for running Dijkstra
+// Classes needed for running incremental Dijkstra
 // In addition to implementing the priority queue at the heart of Dijkstra's
 // algorithm, this structure also allows us to store appication specfic data:
 // nexthops.
@@ -470,31 +679,83 @@ class DijkstraQNode {
       : nodeName(n), result(m) {}
   const std::string nodeName;
   LinkState::NodeSpfResult result;
+
+ private:
+  friend class DijkstraQ;
+  // position of the node in DijkstraQ heap
+  size_t heapIndex_{0};
 };
 
+// Indexed d-ary min-heap ordered by (metric, nodeName). Every queued node
+// knows its position in the heap, hence changing its metric is restored by
+// sifting the node up or down in O(log n) instead of re-heapifying the queue.
 class DijkstraQ {
  private:
+  // shallower than binary heap and siblings are adjacent in memory
+  static constexpr size_t kArity = 4;
+
   std::vector<std::shared_ptr<DijkstraQNode>> heap_;
   std::unordered_map<std::string, std::shared_ptr<DijkstraQNode>> nameToNode_;
 
-  struct {
-    bool
-    operator()(
-        std::shared_ptr<DijkstraQNode> a,
-        std::shared_ptr<DijkstraQNode> b) const {
-      if (a->result.metric() != b->result.metric()) {
-        return a->result.metric() > b->result.metric();
+  static bool
+  isLess(DijkstraQNode const& a, DijkstraQNode const& b) {
+    if (a.result.metric() != b.result.metric()) {
+      return a.result.metric() < b.result.metric();
+    }
+    return a.nodeName < b.nodeName;
+  }
+
+  void
+  place(size_t index, std::shared_ptr<DijkstraQNode> node) {
+    node->heapIndex_ = index;
+    heap_[index] = std::move(node);
+  }
+
+  void
+  siftUp(size_t index) {
+    auto node = std::move(heap_[index]);
+    while (index > 0) {
+      const size_t parent = (index - 1) / kArity;
+      if (not isLess(*node, *heap_[parent])) {
+        break;
       }
-      return a->nodeName > b->nodeName;
+      place(index, std::move(heap_[parent]));
+      index = parent;
     }
-  } DijkstraQNodeGreater;
+    place(index, std::move(node));
+  }
+
+  void
+  siftDown(size_t index) {
+    auto node = std::move(heap_[index]);
+    while (true) {
+      const size_t firstChild = index * kArity + 1;
+      if (firstChild >= heap_.size()) {
+        break;
+      }
+      const size_t lastChild = std::min(firstChild + kArity, heap_.size());
+      size_t minChild = firstChild;
+      for (size_t child = firstChild + 1; child < lastChild; ++child) {
+        if (isLess(*heap_[child], *heap_[minChild])) {
+          minChild = child;
+        }
+      }
+      if (not isLess(*heap_[minChild], *node)) {
+        break;
+      }
+      place(index, std::move(heap_[minChild]));
+      index = minChild;
+    }
+    place(index, std::move(node));
+  }
 
  public:
   void
   insertNode(const std::string& nodeName, LinkStateMetric d) {
-    heap_.push_back(std::make_shared<DijkstraQNode>(nodeName, d));
-    nameToNode_[nodeName] = heap_.back();
-    std::push_heap(heap_.begin(), heap_.end(), DijkstraQNodeGreater);
+    auto node = std::make_shared<DijkstraQNode>(nodeName, d);
+    nameToNode_[nodeName] = node;
+    heap_.emplace_back(std::move(node));
+    siftUp(heap_.size() - 1);
   }
 
   std::shared_ptr<DijkstraQNode>
@@ -510,19 +771,30 @@ class DijkstraQ {
     if (heap_.empty()) {
       return nullptr;
     }
-    auto min = heap_.at(0);
+    auto min = std::move(heap_.front());
     CHECK(nameToNode_.erase(min->nodeName));
-    std::pop_heap(heap_.begin(), heap_.end(), DijkstraQNodeGreater);
+    auto last = std::move(heap_.back());
     heap_.pop_back();
+    if (not heap_.empty()) {
+      place(0, std::move(last));
+      siftDown(0);
+    }
     return min;
   }
 
+  // restore heap order after metric of the queued node got changed, either
+  // decreased or increased
   void
-  reMake() {
-    // this is a bit slow but is rarely called in our application. In fact,
-    // in networks where the metric is hop count, this will never be called
-    // and the Dijkstra run is no different than BFS
-    std::make_heap(heap_.begin(), heap_.end(), DijkstraQNodeGreater);
+  update(DijkstraQNode const& node) {
+    const auto index = node.heapIndex_;
+    CHECK(index < heap_.size() and heap_[index].get() == &node);
+    siftUp(index);
+    siftDown(node.heapIndex_);
+  }
+
+  size_t
+  size() const {
+    return heap_.size();
   }
 };
 } // namespace openr
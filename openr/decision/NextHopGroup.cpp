@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+#include <openr/decision/NextHopGroup.h>
+
+namespace openr {
+
+namespace {
+// table size at which expired entries are swept for the first time
+const size_t kMinSweepSize{1024};
+} // namespace
+
+struct NextHopGroup::Table {
+  std::mutex mutex;
+  // hash -> groups with the hash, which may have expired
+  std::unordered_multimap<size_t, std::weak_ptr<const Group>> groups;
+  size_t sweepSize{kMinSweepSize};
+
+  // drop expired entries, amortized over growth of the table
+  void
+  maybeSweep() {
+    if (groups.size() < sweepSize) {
+      return;
+    }
+    for (auto it = groups.begin(); it != groups.end();) {
+      if (it->second.expired()) {
+        it = groups.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    sweepSize = std::max(kMinSweepSize, 2 * groups.size());
+  }
+};
+
+NextHopGroup::NextHopGroup(NextHopSet nexthops) {
+  if (nexthops.empty()) {
+    return;
+  }
+
+  const auto hash = std::hash<NextHopSet>()(nexthops);
+  auto& table = getTable();
+  std::lock_guard<std::mutex> lock(table.mutex);
+  auto [begin, end] = table.groups.equal_range(hash);
+  auto expiredIt = end;
+  for (auto it = begin; it != end; ++it) {
+    auto group = it->second.lock();
+    if (not group) {
+      expiredIt = it;
+    } else if (group->nexthops == nexthops) {
+      group_ = std::move(group);
+      return;
+    }
+  }
+
+  // not created with make_shared, to release next-hops as soon as the last
+  // route drops the group, not when its table entry gets swept
+  group_ = std::shared_ptr<const Group>(new Group(std::move(nexthops), hash));
+  if (expiredIt != end) {
+    expiredIt->second = group_;
+    return;
+  }
+  table.groups.emplace(hash, group_);
+  table.maybeSweep();
+}
+
+size_t
+NextHopGroup::getNumGroups() {
+  auto& table = getTable();
+  std::lock_guard<std::mutex> lock(table.mutex);
+  return std::count_if(
+      table.groups.begin(), table.groups.end(), [](auto const& entry) {
+        return not entry.second.expired();
+      });
+}
+
+NextHopGroup::Table&
+NextHopGroup::getTable() {
+  // leaked on purpose, routes may be destroyed after static destruction
+  static auto* table = new Table();
+  return *table;
+}
+
+const NextHopGroup::NextHopSet&
+NextHopGroup::emptySet() {
+  static const auto* empty = new NextHopSet();
+  return *empty;
+}
+
+const NextHopGroup::NextHopList&
+NextHopGroup::emptyList() {
+  static const auto* empty = new NextHopList();
+  return *empty;
+}
+
+} // namespace openr
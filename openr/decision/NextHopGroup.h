@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <initializer_list>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include <openr/common/NetworkUtil.h>
+#include <openr/if/gen-cpp2/Network_types.h>
+
+namespace openr {
+
+/**
+ * Immutable set of next-hops shared by all routes having the same ECMP group.
+ *
+ * Groups are interned in a process wide table, i.e. equal sets of next-hops
+ * refer to the same refcounted object. Hence comparing two groups is a
+ * pointer compare and routes of a Clos fabric, where hundreds of thousands of
+ * prefixes share a handful of ECMP groups, keep a single copy of each set.
+ * Empty group is represented by null and doesn't hit the table.
+ *
+ * Group is read-only, modifications are done by building new set of next-hops
+ * and assigning it back, which interns it again. Being immutable, it also
+ * keeps the list form of its next-hops, as thrift routes carry them, so that
+ * converting routes doesn't rebuild it from the set every time.
+ */
+class NextHopGroup {
+ public:
+  using NextHopSet = std::unordered_set<thrift::NextHopThrift>;
+  using NextHopList = std::vector<thrift::NextHopThrift>;
+  using value_type = NextHopSet::value_type;
+  using const_iterator = NextHopSet::const_iterator;
+  using iterator = const_iterator;
+  using size_type = NextHopSet::size_type;
+
+  NextHopGroup() = default;
+
+  /* implicit */ NextHopGroup(NextHopSet nexthops);
+
+  NextHopGroup(std::initializer_list<thrift::NextHopThrift> nexthops)
+      : NextHopGroup(NextHopSet(nexthops)) {}
+
+  const NextHopSet&
+  asSet() const {
+    return group_ ? group_->nexthops : emptySet();
+  }
+
+  // next-hops in iteration order of the set, built once at interning
+  const NextHopList&
+  asList() const {
+    return group_ ? group_->nexthopList : emptyList();
+  }
+
+  const_iterator
+  begin() const {
+    return asSet().begin();
+  }
+
+  const_iterator
+  end() const {
+    return asSet().end();
+  }
+
+  size_type
+  size() const {
+    return group_ ? group_->nexthops.size() : 0;
+  }
+
+  bool
+  empty() const {
+    return size() == 0;
+  }
+
+  size_type
+  count(const thrift::NextHopThrift& nexthop) const {
+    return asSet().count(nexthop);
+  }
+
+  const_iterator
+  find(const thrift::NextHopThrift& nexthop) const {
+    return asSet().find(nexthop);
+  }
+
+  // precomputed at interning
+  size_t
+  hash() const {
+    return group_ ? group_->hash : 0;
+  }
+
+  // interned groups are equal iff they are the same object
+  bool
+  operator==(const NextHopGroup& other) const {
+    return group_ == other.group_;
+  }
+
+  bool
+  operator!=(const NextHopGroup& other) const {
+    return !(*this == other);
+  }
+
+  bool
+  operator==(const NextHopSet& other) const {
+    return asSet() == other;
+  }
+
+  bool
+  operator!=(const NextHopSet& other) const {
+    return !(*this == other);
+  }
+
+  /**
+   * Number of distinct non-empty groups alive in the process
+   */
+  static size_t getNumGroups();
+
+ private:
+  struct Group {
+    Group(NextHopSet nexthops, size_t hash)
+        : nexthops(std::move(nexthops)),
+          nexthopList(this->nexthops.begin(), this->nexthops.end()),
+          hash(hash) {}
+
+    const NextHopSet nexthops;
+    const NextHopList nexthopList;
+    const size_t hash{0};
+  };
+
+  // process wide table of interned groups
+  struct Table;
+  static Table& getTable();
+
+  static const NextHopSet& emptySet();
+  static const NextHopList& emptyList();
+
+  std::shared_ptr<const Group> group_;
+};
+
+} // namespace openr
+
+namespace std {
+
+/**
+ * Make NextHopGroup hashable
+ */
+template <>
+struct hash<openr::NextHopGroup> {
+  size_t
+  operator()(openr::NextHopGroup const& group) const {
+    return group.hash();
+  }
+};
+
+} // namespace std
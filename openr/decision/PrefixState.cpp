@@ -7,33 +7,79 @@
 
 #include "openr/decision/PrefixState.h"
 
+#include <utility>
+
 #include <openr/common/Util.h>
 
 namespace openr {
 
+namespace {
+const char*
+getKeyFormatName(PrefixKey const& key, bool isBucketKey) {
+  if (isBucketKey) {
+    return "bucket";
+  }
+  if (key.isPrefixKeyCompact()) {
+    return "compact";
+  }
+  return key.isPrefixKeyV2() ? "v2" : "v1";
+}
+} // namespace
+
+uint8_t
+PrefixState::getKeyFormat(PrefixKey const& key, bool isBucketKey) {
+  if (isBucketKey) {
+    return kKeyFormatBucket;
+  }
+  if (key.isPrefixKeyCompact()) {
+    return kKeyFormatCompact;
+  }
+  return key.isPrefixKeyV2() ? kKeyFormatV2 : kKeyFormatV1;
+}
+
 std::unordered_set<folly::CIDRNetwork>
 PrefixState::updatePrefix(
-    PrefixKey const& key, thrift::PrefixEntry const& entry) {
+    PrefixKey const& key, thrift::PrefixEntry const& entry, bool isBucketKey) {
   std::unordered_set<folly::CIDRNetwork> changed;
 
-  auto [it, inserted] = prefixes_[key.getCIDRNetwork()].emplace(
-      key.getNodeAndArea(), std::make_shared<thrift::PrefixEntry>(entry));
-
-  // Update v2 format prefix key collection
-  if (key.isPrefixKeyV2()) {
-    prefixKeyV2_.insert(key);
-  } else {
-    prefixKey_.insert(key);
-  }
+  // Update prefix key format collection
+  auto const originatorId =
+      originatorIds_.emplace(key.getNodeAndArea(), originatorIds_.size())
+          .first->second;
+  keyFormats_[{key.getCIDRNetwork(), originatorId}] |=
+      getKeyFormat(key, isBucketKey);
 
+  auto& prefixEntries = prefixes_[key.getCIDRNetwork()];
+  auto it = prefixEntries.find(key.getNodeAndArea());
   // Skip rest of code, if prefix exists and has no change
-  if (not inserted && *it->second == entry) {
+  if (it != prefixEntries.end() && *it->second == entry) {
     return changed;
   }
+
+  // Share entry with other originator advertising the same, e.g. anycast
+  std::shared_ptr<thrift::PrefixEntry> sharedEntry;
+  for (auto const& [_, otherEntry] : prefixEntries) {
+    if (*otherEntry == entry) {
+      sharedEntry = otherEntry;
+      break;
+    }
+  }
+  if (not sharedEntry) {
+    sharedEntry = std::make_shared<thrift::PrefixEntry>(entry);
+  }
   // Update prefix
-  if (not inserted) {
-    it->second = std::make_shared<thrift::PrefixEntry>(entry);
+  if (it != prefixEntries.end()) {
+    it->second = std::move(sharedEntry);
+  } else {
+    prefixEntries.emplace(key.getNodeAndArea(), std::move(sharedEntry));
   }
+  nodeToPrefixes_[key.getNodeAndArea()].emplace(key.getCIDRNetwork());
+  if (reachability_ and
+      isReachable(reachability_->areaReachableNodes, key.getNodeAndArea())) {
+    reachablePrefixes_[key.getCIDRNetwork()][key.getNodeAndArea()] =
+        prefixEntries.at(key.getNodeAndArea());
+  }
+  updateKsp2Prefix(key.getCIDRNetwork());
   changed.insert(key.getCIDRNetwork());
 
   VLOG(1) << "[ROUTE ADVERTISEMENT] "
@@ -43,24 +89,23 @@ PrefixState::updatePrefix(
 }
 
 std::unordered_set<folly::CIDRNetwork>
-PrefixState::deletePrefix(PrefixKey const& key) {
+PrefixState::deletePrefix(PrefixKey const& key, bool isBucketKey) {
   std::unordered_set<folly::CIDRNetwork> changed;
 
-  if (key.isPrefixKeyV2()) {
-    prefixKeyV2_.erase(key);
-    if (prefixKey_.count(key)) {
-      LOG(INFO) << "Skip withdrawing v2 format prefix: "
-                << folly::IPAddress::networkToString(key.getCIDRNetwork())
-                << " since same key with v1 format received.";
-      return changed;
-    }
-  } else {
-    prefixKey_.erase(key);
-    if (prefixKeyV2_.count(key)) {
-      LOG(INFO) << "Skip withdrawing v1 format prefix: "
-                << folly::IPAddress::networkToString(key.getCIDRNetwork())
-                << " since same key with v2 format received.";
-      return changed;
+  auto originatorIt = originatorIds_.find(key.getNodeAndArea());
+  if (originatorIt != originatorIds_.end()) {
+    auto formatIt =
+        keyFormats_.find({key.getCIDRNetwork(), originatorIt->second});
+    if (formatIt != keyFormats_.end()) {
+      formatIt->second &= ~getKeyFormat(key, isBucketKey);
+      if (formatIt->second) {
+        LOG(INFO) << "Skip withdrawing " << getKeyFormatName(key, isBucketKey)
+                  << " format prefix: "
+                  << folly::IPAddress::networkToString(key.getCIDRNetwork())
+                  << " since same key with other format received.";
+        return changed;
+      }
+      keyFormats_.erase(formatIt);
     }
   }
 
@@ -76,10 +121,157 @@ PrefixState::deletePrefix(PrefixKey const& key) {
     if (search->second.empty()) {
       prefixes_.erase(search);
     }
+    auto nodeIt = nodeToPrefixes_.find(key.getNodeAndArea());
+    if (nodeIt != nodeToPrefixes_.end()) {
+      nodeIt->second.erase(key.getCIDRNetwork());
+      if (nodeIt->second.empty()) {
+        nodeToPrefixes_.erase(nodeIt);
+      }
+    }
+    auto reachableIt = reachablePrefixes_.find(key.getCIDRNetwork());
+    if (reachableIt != reachablePrefixes_.end()) {
+      reachableIt->second.erase(key.getNodeAndArea());
+      if (reachableIt->second.empty()) {
+        reachablePrefixes_.erase(reachableIt);
+      }
+    }
+    updateKsp2Prefix(key.getCIDRNetwork());
   }
   return changed;
 }
 
+bool
+PrefixState::isReachable(
+    AreaNodes const& areaReachableNodes, NodeAndArea const& nodeAndArea) {
+  auto it = areaReachableNodes.find(nodeAndArea.second);
+  return it == areaReachableNodes.end() or it->second.count(nodeAndArea.first);
+}
+
+void
+PrefixState::updateReachableNodes(
+    std::string const& myNodeName, AreaNodes areaReachableNodes) {
+  if (not reachability_ or reachability_->myNodeName != myNodeName) {
+    reachability_ = Reachability{myNodeName, std::move(areaReachableNodes)};
+    reachablePrefixes_.clear();
+    for (auto const& [prefix, prefixEntries] : prefixes_) {
+      for (auto const& [nodeAndArea, entry] : prefixEntries) {
+        if (isReachable(reachability_->areaReachableNodes, nodeAndArea)) {
+          reachablePrefixes_[prefix].emplace(nodeAndArea, entry);
+        }
+      }
+    }
+    return;
+  }
+
+  auto const oldReachableNodes = std::exchange(
+      reachability_->areaReachableNodes, std::move(areaReachableNodes));
+  for (auto const& [nodeAndArea, prefixes] : nodeToPrefixes_) {
+    const bool reachable =
+        isReachable(reachability_->areaReachableNodes, nodeAndArea);
+    if (reachable == isReachable(oldReachableNodes, nodeAndArea)) {
+      continue;
+    }
+    for (auto const& prefix : prefixes) {
+      if (reachable) {
+        reachablePrefixes_[prefix].emplace(
+            nodeAndArea, prefixes_.at(prefix).at(nodeAndArea));
+        continue;
+      }
+      auto it = reachablePrefixes_.find(prefix);
+      if (it != reachablePrefixes_.end()) {
+        it->second.erase(nodeAndArea);
+        if (it->second.empty()) {
+          reachablePrefixes_.erase(it);
+        }
+      }
+    }
+  }
+}
+
+void
+PrefixState::resetReachableNodes() {
+  reachability_.reset();
+  reachablePrefixes_.clear();
+}
+
+PrefixState::PrefixMap const*
+PrefixState::reachablePrefixes(std::string const& myNodeName) const {
+  if (reachability_ and reachability_->myNodeName == myNodeName) {
+    return &reachablePrefixes_;
+  }
+  return nullptr;
+}
+
+std::unordered_set<folly::CIDRNetwork> const&
+PrefixState::getPrefixesByNode(NodeAndArea const& nodeAndArea) const {
+  static const std::unordered_set<folly::CIDRNetwork> kNoPrefixes;
+  auto it = nodeToPrefixes_.find(nodeAndArea);
+  return it == nodeToPrefixes_.end() ? kNoPrefixes : it->second;
+}
+
+size_t
+PrefixState::getMemoryUsage() const {
+  // per node overhead of std::unordered_map/set, i.e. next and hash
+  constexpr size_t kNodeOverhead = 2 * sizeof(void*);
+  auto stringBytes = [](std::string const& str) {
+    // short strings are stored inline
+    return str.capacity() > sizeof(std::string) - 1 ? str.capacity() + 1 : 0;
+  };
+
+  size_t bytes = prefixes_.getAllocatedMemorySize() +
+      originatorIds_.getAllocatedMemorySize() +
+      keyFormats_.getAllocatedMemorySize();
+  for (auto const& [_, prefixEntries] : prefixes_) {
+    bytes += prefixEntries.bucket_count() * sizeof(void*);
+    for (auto const& [nodeAndArea, entry] : prefixEntries) {
+      bytes += kNodeOverhead + sizeof(NodeAndArea) + sizeof(entry) +
+          stringBytes(nodeAndArea.first) + stringBytes(nodeAndArea.second);
+      // shared entry is counted once per prefix
+      bool shared{false};
+      for (auto const& [otherNodeAndArea, otherEntry] : prefixEntries) {
+        if (otherEntry == entry) {
+          shared = &otherNodeAndArea != &nodeAndArea;
+          break;
+        }
+      }
+      if (not shared) {
+        bytes += sizeof(thrift::PrefixEntry);
+      }
+    }
+  }
+  for (auto const& [nodeAndArea, prefixes] : nodeToPrefixes_) {
+    bytes += prefixes.bucket_count() * sizeof(void*) +
+        prefixes.size() * (kNodeOverhead + sizeof(folly::CIDRNetwork));
+  }
+  bytes += ksp2Prefixes_.bucket_count() * sizeof(void*) +
+      ksp2Prefixes_.size() * (kNodeOverhead + sizeof(folly::CIDRNetwork));
+  // reachable view shares entries with `prefixes_`
+  bytes += reachablePrefixes_.getAllocatedMemorySize();
+  for (auto const& [_, prefixEntries] : reachablePrefixes_) {
+    bytes += prefixEntries.bucket_count() * sizeof(void*);
+    for (auto const& [nodeAndArea, entry] : prefixEntries) {
+      bytes += kNodeOverhead + sizeof(NodeAndArea) + sizeof(entry) +
+          stringBytes(nodeAndArea.first) + stringBytes(nodeAndArea.second);
+    }
+  }
+  return bytes;
+}
+
+void
+PrefixState::updateKsp2Prefix(folly::CIDRNetwork const& prefix) {
+  auto search = prefixes_.find(prefix);
+  if (search != prefixes_.end()) {
+    for (auto const& [_, entry] : search->second) {
+      if (*entry->forwardingAlgorithm_ref() ==
+          thrift::PrefixForwardingAlgorithm::KSP2_ED_ECMP) {
+        ksp2Prefixes_.emplace(prefix);
+        return;
+      }
+    }
+  }
+  ksp2Prefixes_.erase(prefix);
+}
+
 std::vector<thrift::ReceivedRouteDetail>
 PrefixState::getReceivedRoutesFiltered(
     thrift::ReceivedRouteFilter const& filter) const {
@@ -7,10 +7,14 @@
 
 #pragma once
 
+#include <optional>
 #include <set>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include <folly/container/F14Map.h>
+
 #include <openr/common/NetworkUtil.h>
 #include <openr/common/Types.h>
 #include <openr/if/gen-cpp2/Network_types.h>
@@ -21,23 +25,63 @@ namespace openr {
 
 class PrefixState {
  public:
-  std::unordered_map<folly::CIDRNetwork, PrefixEntries> const&
+  // node map keeps references to prefix entries stable across updates
+  using PrefixMap = folly::F14NodeMap<folly::CIDRNetwork, PrefixEntries>;
+
+  // area -> nodes reachable within the area
+  using AreaNodes = std::
+      unordered_map<std::string /* area */, std::unordered_set<std::string>>;
+
+  PrefixMap const&
   prefixes() const {
     return prefixes_;
   }
 
   // returns set of changed prefixes (i.e. a node started advertising or any
-  // attributes changed)
+  // attributes changed). `isBucketKey` tells entry came with bucket key of
+  // node's prefix database rather than prefix key `key`.
   std::unordered_set<folly::CIDRNetwork> updatePrefix(
-      PrefixKey const& key, thrift::PrefixEntry const& entry);
+      PrefixKey const& key,
+      thrift::PrefixEntry const& entry,
+      bool isBucketKey = false);
 
   // returns set of changed prefixes (i.e. a node withdrew a prefix) will be
   // empty if node/area did not previosuly advertise
-  std::unordered_set<folly::CIDRNetwork> deletePrefix(PrefixKey const& key);
+  std::unordered_set<folly::CIDRNetwork> deletePrefix(
+      PrefixKey const& key, bool isBucketKey = false);
+
+  // prefixes advertised by the node in the area
+  std::unordered_set<folly::CIDRNetwork> const& getPrefixesByNode(
+      NodeAndArea const& nodeAndArea) const;
+
+  // Set originators reachable from `myNodeName`, i.e. nodes in its SPF result
+  // of each area. Originators of areas missing in `areaReachableNodes` are
+  // considered reachable. reachablePrefixes() is maintained from then on,
+  // across prefix updates, and only entries of originators whose reachability
+  // changed are moved in or out of it.
+  void updateReachableNodes(
+      std::string const& myNodeName, AreaNodes areaReachableNodes);
+
+  // stop maintaining reachablePrefixes(), e.g. once topology of a copy is
+  // altered
+  void resetReachableNodes();
+
+  // prefix entries of originators reachable from `myNodeName` only. nullptr
+  // if not maintained for `myNodeName`, then prefixes() must be filtered.
+  PrefixMap const* reachablePrefixes(std::string const& myNodeName) const;
+
+  // prefixes with at least one KSP2_ED_ECMP prefix entry
+  std::unordered_set<folly::CIDRNetwork> const&
+  ksp2Prefixes() const {
+    return ksp2Prefixes_;
+  }
 
   std::vector<thrift::ReceivedRouteDetail> getReceivedRoutesFiltered(
       thrift::ReceivedRouteFilter const& filter) const;
 
+  // approximate heap bytes held by prefix entries and indices
+  size_t getMemoryUsage() const;
+
   /**
    * Filter routes only the <type> attribute
    */
@@ -55,20 +99,48 @@ class PrefixState {
   static bool hasConflictingForwardingInfo(PrefixEntries const& prefixEntries);
 
  private:
-  // TODO: Also maintain clean list of reachable prefix entries. A node might
-  // become un-reachable we might still have their prefix entries, until gets
-  // expired in KvStore. This will simplify logic in route computation where
-  // we exclude unreachable nodes.
-
   // Data structure to maintain mapping from:
   //  IpPrefix -> collection of originator(i.e. [node, area] combination)
-  std::unordered_map<folly::CIDRNetwork, PrefixEntries> prefixes_;
+  // Originators advertising equal entries of a prefix share one object.
+  PrefixMap prefixes_;
 
-  // TODO: Remove following collection when format migration is done
-  // Local cache for v1 format of prefix keys for downgrade purpose
-  std::unordered_set<PrefixKey> prefixKey_;
+  // Reverse index of `prefixes_`, i.e. [node, area] -> advertised prefixes
+  std::unordered_map<NodeAndArea, std::unordered_set<folly::CIDRNetwork>>
+      nodeToPrefixes_;
+
+  // Prefixes whose paths depend on the whole topology rather than shortest
+  // paths towards advertising nodes only
+  std::unordered_set<folly::CIDRNetwork> ksp2Prefixes_;
+
+  // Entries of `prefixes_` whose originator is reachable. A node might become
+  // un-reachable while its prefix entries linger, until expired in KvStore.
+  // Route computation iterates these rather than filtering every prefix.
+  struct Reachability {
+    std::string myNodeName;
+    AreaNodes areaReachableNodes;
+  };
+  std::optional<Reachability> reachability_;
+  PrefixMap reachablePrefixes_;
 
-  // Local cache for v2 format of prefix keys
-  std::unordered_set<PrefixKey> prefixKeyV2_;
+  static bool isReachable(
+      AreaNodes const& areaReachableNodes, NodeAndArea const& nodeAndArea);
+
+  // update ksp2Prefixes_ after prefix entries of prefix changed
+  void updateKsp2Prefix(folly::CIDRNetwork const& prefix);
+
+  // interned [node, area] of originators, assigned in order of first
+  // advertisement and never reused
+  folly::F14FastMap<NodeAndArea, uint32_t> originatorIds_;
+
+  // TODO: Remove following collection when format migration is done
+  // Formats of prefix keys received per [prefix, originator], for withdrawal
+  // in one format to keep prefix advertised in the other ones
+  static constexpr uint8_t kKeyFormatV1{1 << 0};
+  static constexpr uint8_t kKeyFormatV2{1 << 1};
+  static constexpr uint8_t kKeyFormatCompact{1 << 2};
+  static constexpr uint8_t kKeyFormatBucket{1 << 3};
+  static uint8_t getKeyFormat(PrefixKey const& key, bool isBucketKey);
+  folly::F14FastMap<std::pair<folly::CIDRNetwork, uint32_t>, uint8_t>
+      keyFormats_;
 };
 } // namespace openr
@@ -13,7 +13,9 @@
 #include "openr/if/gen-cpp2/Network_types.h"
 
 #include <folly/IPAddress.h>
+#include <folly/container/F14Map.h>
 #include <openr/common/NetworkUtil.h>
+#include <openr/decision/NextHopGroup.h>
 #include <openr/if/gen-cpp2/Network_types.h>
 #include <openr/if/gen-cpp2/OpenrCtrl.h>
 #include <openr/if/gen-cpp2/Types_types.h>
@@ -22,7 +24,8 @@ namespace openr {
 
 struct RibEntry {
   // TODO: should this be map<area, nexthops>?
-  std::unordered_set<thrift::NextHopThrift> nexthops;
+  // Interned, routes with the same next-hops share a single group
+  NextHopGroup nexthops;
 
   // constructor
   explicit RibEntry(std::unordered_set<thrift::NextHopThrift> nexthops)
@@ -45,6 +48,8 @@ struct RibUnicastEntry : RibEntry {
   // Counter Id assigned to this route. Assignment comes from the
   // RibPolicyStatement that matches to this route.
   std::optional<thrift::RouteCounterID> counterID{std::nullopt};
+  // loop-free alternates of nexthops, none unless LFA is enabled
+  NextHopGroup backupNexthops;
 
   // constructor
   explicit RibUnicastEntry() {}
@@ -69,9 +74,12 @@ struct RibUnicastEntry : RibEntry {
 
   bool
   operator==(const RibUnicastEntry& other) const {
-    return prefix == other.prefix && bestPrefixEntry == other.bestPrefixEntry &&
+    // interned next-hops are a pointer compare, check them before thrift
+    // structs
+    return prefix == other.prefix && RibEntry::operator==(other) &&
+        bestPrefixEntry == other.bestPrefixEntry &&
         doNotInstall == other.doNotInstall && counterID == other.counterID &&
-        RibEntry::operator==(other);
+        backupNexthops == other.backupNexthops;
   }
 
   bool
@@ -84,8 +92,7 @@ struct RibUnicastEntry : RibEntry {
   toThrift() const {
     thrift::UnicastRoute tUnicast;
     tUnicast.dest_ref() = toIpPrefix(prefix);
-    tUnicast.nextHops_ref() =
-        std::vector<thrift::NextHopThrift>(nexthops.begin(), nexthops.end());
+    tUnicast.nextHops_ref() = nexthops.asList();
     tUnicast.counterID_ref().from_optional(counterID);
     return tUnicast;
   }
@@ -96,6 +103,7 @@ struct RibUnicastEntry : RibEntry {
     thrift::UnicastRouteDetail tUnicastDetail;
     tUnicastDetail.unicastRoute_ref() = toThrift();
     tUnicastDetail.bestRoute_ref() = bestPrefixEntry;
+    tUnicastDetail.backupNextHops_ref() = backupNexthops.asList();
     return tUnicastDetail;
   }
 };
@@ -133,8 +141,7 @@ struct RibMplsEntry : RibEntry {
   toThrift() const {
     thrift::MplsRoute tMpls;
     tMpls.topLabel_ref() = label;
-    tMpls.nextHops_ref() =
-        std::vector<thrift::NextHopThrift>(nexthops.begin(), nexthops.end());
+    tMpls.nextHops_ref() = nexthops.asList();
     return tMpls;
   }
 
@@ -174,13 +181,22 @@ struct RibMplsEntry : RibEntry {
     }
 
     // Filter nexthop that do not match selected MPLS action
-    for (auto it = nexthops.begin(); it != nexthops.end();) {
-      if (mplsActionCode != *it->mplsAction_ref()->action_ref()) {
-        it = nexthops.erase(it);
-      } else {
-        ++it;
+    std::unordered_set<thrift::NextHopThrift> filteredNexthops;
+    for (auto const& nextHop : nexthops) {
+      if (mplsActionCode == *nextHop.mplsAction_ref()->action_ref()) {
+        filteredNexthops.emplace(nextHop);
       }
     }
+    if (filteredNexthops.size() != nexthops.size()) {
+      nexthops = std::move(filteredNexthops);
+    }
   }
 };
+
+// Routes keyed by prefix and label. Node maps keep entries at stable addresses,
+// at a fraction of per-entry overhead and lookup cost of std::unordered_map
+using RibUnicastEntries =
+    folly::F14NodeMap<folly::CIDRNetwork /* prefix */, RibUnicastEntry>;
+using RibMplsEntries = folly::F14NodeMap<int32_t /* label */, RibMplsEntry>;
+
 } // namespace openr
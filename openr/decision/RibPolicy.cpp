@@ -9,9 +9,14 @@
 
 #include <fb303/ServiceData.h>
 #include <folly/MapUtil.h>
+#include <folly/lang/Bits.h>
 
 namespace openr {
 
+namespace {
+const size_t kStatementSetWordBits{64};
+} // namespace
+
 //
 // RibPolicyStatement
 //
@@ -112,7 +117,11 @@ RibPolicyStatement::applyAction(RibUnicastEntry& route) const {
   if (not match(route)) {
     return false;
   }
+  return applyMatchedAction(route);
+}
 
+bool
+RibPolicyStatement::applyMatchedAction(RibUnicastEntry& route) const {
   // Assign RibPolicyStatement route counter ID to the route
   route.counterID = counterID_;
 
@@ -181,6 +190,40 @@ RibPolicy::RibPolicy(thrift::RibPolicy const& policy)
   for (auto const& statement : *policy.statements_ref()) {
     policyStatements_.emplace_back(RibPolicyStatement(statement));
   }
+
+  // Compile statements into lookup tables
+  const size_t numWords =
+      (policyStatements_.size() + kStatementSetWordBits - 1) /
+      kStatementSetWordBits;
+  anyPrefixStatements_.resize(numWords, 0);
+  anyTagStatements_.resize(numWords, 0);
+  for (size_t i = 0; i < policyStatements_.size(); ++i) {
+    auto const& statement = policyStatements_.at(i);
+    auto const& prefixSet = statement.getPrefixSet();
+    auto const& tagSet = statement.getTagSet();
+    if (prefixSet.empty() and tagSet.empty()) {
+      // never matches
+      continue;
+    }
+    const auto word = i / kStatementSetWordBits;
+    const uint64_t bit = uint64_t(1) << (i % kStatementSetWordBits);
+    if (prefixSet.empty()) {
+      anyPrefixStatements_.at(word) |= bit;
+    }
+    for (auto const& prefix : prefixSet) {
+      auto& statements = prefixToStatements_[prefix];
+      statements.resize(numWords, 0);
+      statements.at(word) |= bit;
+    }
+    if (tagSet.empty()) {
+      anyTagStatements_.at(word) |= bit;
+    }
+    for (auto const& tag : tagSet) {
+      auto& statements = tagToStatements_[tag];
+      statements.resize(numWords, 0);
+      statements.at(word) |= bit;
+    }
+  }
 }
 
 thrift::RibPolicy
@@ -211,10 +254,37 @@ RibPolicy::isActive() const {
   return getTtlDuration().count() > 0;
 }
 
+RibPolicy::StatementSet
+RibPolicy::getMatchingStatements(const RibUnicastEntry& route) const {
+  auto prefixStatements = anyPrefixStatements_;
+  auto prefixIt = prefixToStatements_.find(route.prefix);
+  if (prefixIt != prefixToStatements_.end()) {
+    for (size_t word = 0; word < prefixStatements.size(); ++word) {
+      prefixStatements[word] |= prefixIt->second[word];
+    }
+  }
+
+  auto tagStatements = anyTagStatements_;
+  for (auto const& tag : *route.bestPrefixEntry.tags_ref()) {
+    auto tagIt = tagToStatements_.find(tag);
+    if (tagIt == tagToStatements_.end()) {
+      continue;
+    }
+    for (size_t word = 0; word < tagStatements.size(); ++word) {
+      tagStatements[word] |= tagIt->second[word];
+    }
+  }
+
+  for (size_t word = 0; word < prefixStatements.size(); ++word) {
+    prefixStatements[word] &= tagStatements[word];
+  }
+  return prefixStatements;
+}
+
 bool
 RibPolicy::match(const RibUnicastEntry& route) const {
-  for (auto const& statement : policyStatements_) {
-    if (statement.match(route)) {
+  for (auto const word : getMatchingStatements(route)) {
+    if (word) {
       return true;
     }
   }
@@ -223,17 +293,23 @@ RibPolicy::match(const RibUnicastEntry& route) const {
 
 bool
 RibPolicy::applyAction(RibUnicastEntry& route) const {
-  for (auto const& statement : policyStatements_) {
-    if (statement.applyAction(route)) {
-      return true;
+  // Statements are tried in order, next one if action of matching statement
+  // is rejected
+  auto const statements = getMatchingStatements(route);
+  for (size_t word = 0; word < statements.size(); ++word) {
+    for (auto bits = statements[word]; bits; bits &= bits - 1) {
+      const auto i =
+          word * kStatementSetWordBits + folly::findFirstSet(bits) - 1;
+      if (policyStatements_.at(i).applyMatchedAction(route)) {
+        return true;
+      }
     }
   }
   return false;
 }
 
 RibPolicy::PolicyChange
-RibPolicy::applyPolicy(std::unordered_map<folly::CIDRNetwork, RibUnicastEntry>&
-                           unicastEntries) const {
+RibPolicy::applyPolicy(RibUnicastEntries& unicastEntries) const {
   PolicyChange change;
   if (not isActive()) {
     return change;
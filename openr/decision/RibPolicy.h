@@ -42,7 +42,22 @@ class RibPolicyStatement {
    */
   bool applyAction(RibUnicastEntry& route) const;
 
+  std::unordered_set<folly::CIDRNetwork> const&
+  getPrefixSet() const {
+    return prefixSet_;
+  }
+
+  std::unordered_set<std::string> const&
+  getTagSet() const {
+    return tagSet_;
+  }
+
  private:
+  friend class RibPolicy;
+
+  // Transform route, which is known to match
+  bool applyMatchedAction(RibUnicastEntry& route) const;
+
   const std::string name_;
 
   // Unordered set for efficient lookup on matching
@@ -109,14 +124,26 @@ class RibPolicy {
    *
    * @returns PolicyChange struct indicating unicastEntries that were modified.
    */
-  PolicyChange applyPolicy(
-      std::unordered_map<folly::CIDRNetwork, RibUnicastEntry>& unicastEntries)
-      const;
+  PolicyChange applyPolicy(RibUnicastEntries& unicastEntries) const;
 
  private:
+  // Set of policy statements, bit `i` stands for `policyStatements_[i]`
+  using StatementSet = std::vector<uint64_t>;
+
+  // Statements matching the route, i.e. selected by its prefix and by one of
+  // its tags. One lookup per tag instead of matching every statement.
+  StatementSet getMatchingStatements(const RibUnicastEntry& route) const;
+
   // List of policy statements
   std::vector<RibPolicyStatement> policyStatements_;
 
+  // Statements compiled into lookup tables of statement sets. Statements
+  // without prefix (tag) criteria match any prefix (tag).
+  std::unordered_map<folly::CIDRNetwork, StatementSet> prefixToStatements_;
+  StatementSet anyPrefixStatements_;
+  std::unordered_map<std::string, StatementSet> tagToStatements_;
+  StatementSet anyTagStatements_;
+
   // Validity
   const std::chrono::steady_clock::time_point validUntilTs_;
 };
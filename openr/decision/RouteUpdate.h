@@ -40,13 +40,12 @@ struct DecisionRouteUpdate {
   // route update is FULL_SYNC
   Type type{INCREMENTAL}; // Incremental route update is default behavior
 
-  // Unicast routes
-  std::unordered_map<folly::CIDRNetwork /* prefix */, RibUnicastEntry>
-      unicastRoutesToUpdate;
+  // Unicast routes, keyed by prefix
+  RibUnicastEntries unicastRoutesToUpdate;
   std::vector<folly::CIDRNetwork> unicastRoutesToDelete;
 
   // MPLS routes
-  std::unordered_map<int32_t, RibMplsEntry> mplsRoutesToUpdate;
+  RibMplsEntries mplsRoutesToUpdate;
   std::vector<int32_t> mplsRoutesToDelete;
 
   // Optional perf events associated with this route update
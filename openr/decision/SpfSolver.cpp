@@ -6,6 +6,8 @@
  */
 
 #include <fb303/ServiceData.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+#include <folly/futures/Future.h>
 
 #include <openr/common/NetworkUtil.h>
 #include <openr/common/Util.h>
@@ -21,8 +23,12 @@ using Metric = openr::LinkStateMetric;
 namespace openr {
 
 DecisionRouteUpdate
-DecisionRouteDb::calculateUpdate(DecisionRouteDb&& newDb) const {
-  DecisionRouteUpdate delta;
+DecisionRouteDb::calculateUpdate(
+    DecisionRouteDb&& newDb,
+    StaticUnicastRoutes const* staticUnicastRoutes,
+    StaticMplsRoutes const* staticMplsRoutes) const {
+  auto delta =
+      calculateMplsUpdate(std::move(newDb.mplsRoutes), staticMplsRoutes);
 
   // unicastRoutesToUpdate
   for (auto& [prefix, entry] : newDb.unicastRoutes) {
@@ -33,25 +39,73 @@ DecisionRouteDb::calculateUpdate(DecisionRouteDb&& newDb) const {
     }
   }
 
-  // unicastRoutesToDelete
-  for (auto const& [prefix, _] : unicastRoutes) {
-    if (!newDb.unicastRoutes.count(prefix)) {
-      delta.unicastRoutesToDelete.emplace_back(prefix);
+  // unicastRoutesToDelete, unless static route takes over
+  for (auto const& [prefix, entry] : unicastRoutes) {
+    if (newDb.unicastRoutes.count(prefix)) {
+      continue;
+    }
+    if (staticUnicastRoutes) {
+      auto it = staticUnicastRoutes->find(prefix);
+      if (it != staticUnicastRoutes->end()) {
+        if (it->second != entry) {
+          delta.addRouteToUpdate(it->second);
+        }
+        continue;
+      }
+    }
+    delta.unicastRoutesToDelete.emplace_back(prefix);
+  }
+
+  // static routes not in this db yet
+  if (staticUnicastRoutes) {
+    for (auto const& [prefix, entry] : *staticUnicastRoutes) {
+      if (not unicastRoutes.count(prefix) and
+          not newDb.unicastRoutes.count(prefix)) {
+        delta.addRouteToUpdate(entry);
+      }
     }
   }
 
+  return delta;
+}
+
+DecisionRouteUpdate
+DecisionRouteDb::calculateMplsUpdate(
+    RibMplsEntries&& newMplsRoutes,
+    StaticMplsRoutes const* staticMplsRoutes) const {
+  DecisionRouteUpdate delta;
+
   // mplsRoutesToUpdate
-  for (auto& [label, entry] : newDb.mplsRoutes) {
+  for (auto& [label, entry] : newMplsRoutes) {
     const auto& search = mplsRoutes.find(label);
     if (search == mplsRoutes.end() || search->second != entry) {
       delta.addMplsRouteToUpdate(std::move(entry));
     }
   }
 
-  // mplsRoutesToDelete
-  for (auto const& [label, _] : mplsRoutes) {
-    if (!newDb.mplsRoutes.count(label)) {
-      delta.mplsRoutesToDelete.emplace_back(label);
+  // mplsRoutesToDelete, unless static route takes over
+  for (auto const& [label, entry] : mplsRoutes) {
+    if (newMplsRoutes.count(label)) {
+      continue;
+    }
+    if (staticMplsRoutes) {
+      auto it = staticMplsRoutes->find(label);
+      if (it != staticMplsRoutes->end()) {
+        if (it->second != entry) {
+          delta.addMplsRouteToUpdate(it->second);
+        }
+        continue;
+      }
+    }
+    delta.mplsRoutesToDelete.emplace_back(label);
+  }
+
+  // static routes not in this db yet
+  if (staticMplsRoutes) {
+    for (auto const& [label, entry] : *staticMplsRoutes) {
+      if (not mplsRoutes.count(label) and not newMplsRoutes.count(label)) {
+        delta.addMplsRouteToUpdate(entry);
+      }
     }
   }
   return delta;
@@ -111,6 +165,14 @@ SpfSolver::SpfSolver(
       "decision.skipped_unicast_route", fb303::COUNT);
   fb303::fbData->addStatExportType("decision.spf_ms", fb303::AVG);
   fb303::fbData->addStatExportType("decision.spf_runs", fb303::COUNT);
+  fb303::fbData->addStatExportType(
+      "decision.incremental_spf_runs", fb303::COUNT);
+  fb303::fbData->addStatExportType(
+      "decision.topology_affected_prefixes", fb303::AVG);
+  fb303::fbData->addStatExportType(
+      "decision.best_routes_cache_hit", fb303::COUNT);
+  fb303::fbData->addStatExportType(
+      "decision.best_routes_cache_invalidated", fb303::SUM);
   fb303::fbData->addStatExportType("decision.errors", fb303::COUNT);
 
   // Create SrPolicy internal classes
@@ -122,14 +184,24 @@ SpfSolver::SpfSolver(
 
   prependLabelAllocator_ =
       std::make_unique<PrependLabelAllocator<thrift::NextHopThrift>>(config);
+
+  const auto spfThreads = config
+      ? *config->getConfig().decision_config_ref()->spf_threads_ref()
+      : 0;
+  if (spfThreads > 0) {
+    spfExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+        spfThreads,
+        std::make_shared<folly::NamedThreadFactory>("SpfSolver"));
+  }
+  enableLfa_ =
+      config and *config->getConfig().decision_config_ref()->enable_lfa_ref();
 }
 
 SpfSolver::~SpfSolver() = default;
 
 void
 SpfSolver::updateStaticUnicastRoutes(
-    const std::unordered_map<folly::CIDRNetwork, RibUnicastEntry>&
-        unicastRoutesToUpdate,
+    const RibUnicastEntries& unicastRoutesToUpdate,
     const std::vector<folly::CIDRNetwork>& unicastRoutesToDelete) {
   // Process IP routes to add or update
   LOG_IF(INFO, unicastRoutesToUpdate.size())
@@ -158,7 +230,7 @@ SpfSolver::updateStaticUnicastRoutes(
 
 void
 SpfSolver::updateStaticMplsRoutes(
-    const std::unordered_map<int32_t, RibMplsEntry>& mplsRoutesToUpdate,
+    const RibMplsEntries& mplsRoutesToUpdate,
     const std::vector<int32_t>& mplsRoutesToDelete) {
   // Process MPLS routes to add or update
   LOG_IF(INFO, mplsRoutesToUpdate.size())
@@ -190,9 +262,16 @@ SpfSolver::createRouteForPrefixOrGetStaticRoute(
     PrefixState const& prefixState,
     folly::CIDRNetwork const& prefix) {
   // route output from `PrefixState` has higher priority over
-  // static unicast routes
+  // static unicast routes. Best route selection of other nodes isn't cached.
+  std::unordered_map<folly::CIDRNetwork, RouteSelectionResult> bestRoutes;
+  const bool isMyNode = myNodeName == myNodeName_;
   if (auto maybeRoute = createRouteForPrefix(
-          myNodeName, areaLinkStates, prefixState, prefix)) {
+          myNodeName,
+          areaLinkStates,
+          prefixState,
+          prefix,
+          isMyNode ? &bestRoutesCache_ : nullptr,
+          isMyNode ? bestRoutesCache_ : bestRoutes)) {
     return maybeRoute;
   }
 
@@ -209,7 +288,10 @@ SpfSolver::createRouteForPrefix(
     const std::string& myNodeName,
     std::unordered_map<std::string, LinkState> const& areaLinkStates,
     PrefixState const& prefixState,
-    folly::CIDRNetwork const& prefix) {
+    folly::CIDRNetwork const& prefix,
+    std::unordered_map<folly::CIDRNetwork, RouteSelectionResult> const*
+        cachedBestRoutes,
+    std::unordered_map<folly::CIDRNetwork, RouteSelectionResult>& bestRoutes) {
   fb303::fbData->addStatValue("decision.get_route_for_prefix", 1, fb303::COUNT);
 
   // Sanity check for V4 prefixes
@@ -226,33 +308,54 @@ SpfSolver::createRouteForPrefix(
 
   auto search = prefixState.prefixes().find(prefix);
   if (search == prefixState.prefixes().end()) {
+    bestRoutes.erase(prefix);
     return std::nullopt;
   }
   auto const& allPrefixEntries = search->second;
 
-  // Clear best route selection in prefix state
-  bestRoutesCache_.erase(prefix);
+  // Take out cached best route selection, put back once route is created
+  std::optional<RouteSelectionResult> cachedSelection;
+  if (cachedBestRoutes) {
+    auto cachedIt = cachedBestRoutes->find(prefix);
+    if (cachedIt != cachedBestRoutes->end()) {
+      cachedSelection = cachedIt->second;
+    }
+  }
+  bestRoutes.erase(prefix);
 
   //
-  // Create list of prefix-entries from reachable nodes only
-  // NOTE: We're copying prefix-entries and it can be expensive. Using
-  // pointers for storing prefix information can be efficient (CPU & Memory)
+  // Create list of prefix-entries from reachable nodes only. PrefixState
+  // maintains them if reachability is kept up to date for `myNodeName`,
+  // otherwise they are filtered against SPF results here.
   //
-  auto prefixEntries = folly::copy(allPrefixEntries);
-  for (auto& [area, linkState] : areaLinkStates) {
-    auto const& mySpfResult = linkState.getSpfResult(myNodeName);
-
-    // Delete entries of unreachable nodes from prefixEntries
-    for (auto it = prefixEntries.cbegin(); it != prefixEntries.cend();) {
-      const auto& [prefixNode, prefixArea] = it->first;
-      // Only check reachability within the area that prefixNode belongs to.
-      if (area != prefixArea || mySpfResult.count(prefixNode)) {
-        ++it; // retain
-      } else {
-        it = prefixEntries.erase(it); // erase the unreachable prefix entry
+  static const PrefixEntries kNoPrefixEntries;
+  PrefixEntries filteredPrefixEntries;
+  PrefixEntries const* reachablePrefixEntries{&filteredPrefixEntries};
+  if (auto reachablePrefixes = prefixState.reachablePrefixes(myNodeName)) {
+    auto reachableIt = reachablePrefixes->find(prefix);
+    reachablePrefixEntries = reachableIt == reachablePrefixes->end()
+        ? &kNoPrefixEntries
+        : &reachableIt->second;
+  } else {
+    filteredPrefixEntries = allPrefixEntries;
+    for (auto& [area, linkState] : areaLinkStates) {
+      auto const& mySpfResult = linkState.getSpfResult(myNodeName);
+
+      // Delete entries of unreachable nodes from prefixEntries
+      for (auto it = filteredPrefixEntries.cbegin();
+           it != filteredPrefixEntries.cend();) {
+        const auto& [prefixNode, prefixArea] = it->first;
+        // Only check reachability within the area that prefixNode belongs to.
+        if (area != prefixArea || mySpfResult.count(prefixNode)) {
+          ++it; // retain
+        } else {
+          // erase the unreachable prefix entry
+          it = filteredPrefixEntries.erase(it);
+        }
       }
     }
   }
+  auto const& prefixEntries = *reachablePrefixEntries;
 
   // Skip if no valid prefixes
   if (prefixEntries.empty()) {
@@ -310,8 +413,16 @@ SpfSolver::createRouteForPrefix(
     }
   }
 
-  auto routeSelectionResult = selectBestRoutes(
-      myNodeName, prefix, prefixEntries, hasBGP, areaLinkStates);
+  RouteSelectionResult routeSelectionResult;
+  if (cachedSelection and cachedSelection->prefixEntries == prefixEntries) {
+    fb303::fbData->addStatValue(
+        "decision.best_routes_cache_hit", 1, fb303::COUNT);
+    routeSelectionResult = std::move(cachedSelection).value();
+  } else {
+    routeSelectionResult = selectBestRoutes(
+        myNodeName, prefix, prefixEntries, hasBGP, areaLinkStates);
+    routeSelectionResult.prefixEntries = prefixEntries;
+  }
   if (not routeSelectionResult.success) {
     return std::nullopt;
   }
@@ -322,8 +433,9 @@ SpfSolver::createRouteForPrefix(
     return std::nullopt;
   }
 
-  // Set best route selection in prefix state
-  bestRoutesCache_.insert_or_assign(prefix, routeSelectionResult);
+  // Set best route selection in prefix state, along with matched SR Policy
+  matchSrPolicies(prefixEntries, routeSelectionResult);
+  bestRoutes.insert_or_assign(prefix, routeSelectionResult);
 
   // Skip adding route for one prefix advertised by current node in all
   // following scenarios:
@@ -373,6 +485,7 @@ SpfSolver::createRouteForPrefix(
   //        - TODO: support this functionality for KSP2 forwarding algorithm
   //    - Combine shortest metric next-hops from all area
   std::unordered_set<thrift::NextHopThrift> totalNextHops;
+  std::unordered_set<thrift::NextHopThrift> totalBackupNextHops;
   std::unordered_set<thrift::NextHopThrift> ksp2NextHops;
   Metric shortestMetric = std::numeric_limits<Metric>::max();
   for (const auto& [area, areaRules] :
@@ -399,21 +512,38 @@ SpfSolver::createRouteForPrefix(
           area,
           linkState->second,
           prefixState);
+      std::unordered_set<thrift::NextHopThrift> areaBackupNextHops;
+      if (enableLfa_ and not metricsAreaNextHops.second.empty() and
+          *areaRules.forwardingType_ref() ==
+              thrift::PrefixForwardingType::IP) {
+        areaBackupNextHops = selectLfaNextHops(
+            myNodeName,
+            prefix,
+            routeSelectionResult,
+            area,
+            linkState->second,
+            metricsAreaNextHops.second);
+      }
       if (*routeComputationRules.allowUcmpPathsBetweenAreas_ref()) {
         // Allow UCMP paths between areas
         totalNextHops.insert(
             metricsAreaNextHops.second.begin(),
             metricsAreaNextHops.second.end());
+        totalBackupNextHops.insert(
+            areaBackupNextHops.begin(), areaBackupNextHops.end());
       } else {
         // Only use next-hops in areas with the shortest IGP metric
         if (shortestMetric >= metricsAreaNextHops.first) {
           if (shortestMetric > metricsAreaNextHops.first) {
             shortestMetric = metricsAreaNextHops.first;
             totalNextHops.clear();
+            totalBackupNextHops.clear();
           }
           totalNextHops.insert(
               metricsAreaNextHops.second.begin(),
               metricsAreaNextHops.second.end());
+          totalBackupNextHops.insert(
+              areaBackupNextHops.begin(), areaBackupNextHops.end());
         }
       }
     } break;
@@ -446,24 +576,211 @@ SpfSolver::createRouteForPrefix(
     totalNextHops.insert(ksp2NextHops.begin(), ksp2NextHops.end());
   }
 
-  return addBestPaths(
+  auto route = addBestPaths(
       myNodeName,
       prefix,
       routeSelectionResult,
       prefixEntries,
       hasBGP,
       std::move(totalNextHops));
+  if (route and not totalBackupNextHops.empty()) {
+    route->backupNexthops = std::move(totalBackupNextHops);
+  }
+  return route;
 
   // SrPolicy TODO: (T94500292) before returning need to apply prepend label
   // rules. Prepend label rules, may create a new MPLS route (RibMplsEntry)
   // that needs to be return along with the IP route (RibUnicastEntry)
 }
 
+void
+SpfSolver::prefetchPaths(
+    const std::string& myNodeName,
+    std::unordered_map<std::string, LinkState> const& areaLinkStates,
+    PrefixState const& prefixState) {
+  if (not spfExecutor_) {
+    return;
+  }
+
+  // SPF of each area, LinkState of distinct areas share nothing. Drained
+  // node filtering reads SPF of myNodeName_ as well.
+  std::vector<folly::Future<folly::Unit>> futures;
+  for (auto const& [_, linkState] : areaLinkStates) {
+    auto const* linkStatePtr = &linkState;
+    futures.emplace_back(
+        folly::via(spfExecutor_.get(), [this, linkStatePtr, &myNodeName]() {
+          linkStatePtr->getSpfResult(myNodeName);
+          if (myNodeName_ != myNodeName) {
+            linkStatePtr->getSpfResult(myNodeName_);
+          }
+          // loop-free alternates read SPF of neighbors
+          if (enableLfa_) {
+            for (auto const& link : linkStatePtr->linksFromNode(myNodeName)) {
+              linkStatePtr->getSpfResult(link->getOtherNodeName(myNodeName));
+            }
+          }
+        }));
+  }
+  folly::collectAll(std::move(futures)).get();
+
+  // KSP2 paths towards nodes advertising KSP2_ED_ECMP prefixes, in order of
+  // node names. Includes myNodeName, as second shortest paths are looked up
+  // for every selected node.
+  std::unordered_map<std::string /* area */, std::set<std::string>> ksp2Nodes;
+  for (auto const& [_, prefixEntries] : prefixState.prefixes()) {
+    for (auto const& [nodeArea, entry] : prefixEntries) {
+      if (*entry->forwardingAlgorithm_ref() ==
+          thrift::PrefixForwardingAlgorithm::KSP2_ED_ECMP) {
+        ksp2Nodes[nodeArea.second].emplace(nodeArea.first);
+      }
+    }
+  }
+  for (auto const& [area, nodes] : ksp2Nodes) {
+    auto linkStateIter = areaLinkStates.find(area);
+    if (linkStateIter == areaLinkStates.end()) {
+      continue;
+    }
+    linkStateIter->second.prefetchKthPaths(
+        myNodeName,
+        std::vector<std::string>(nodes.begin(), nodes.end()),
+        spfExecutor_.get());
+  }
+}
+
+void
+SpfSolver::buildUnicastRoutes(
+    const std::string& myNodeName,
+    std::unordered_map<std::string, LinkState> const& areaLinkStates,
+    PrefixState const& prefixState,
+    DecisionRouteDb& routeDb,
+    RibUnicastEntries const* prevRoutes,
+    std::vector<folly::CIDRNetwork>* deletedPrefixes) {
+  CHECK_EQ(prevRoutes == nullptr, deletedPrefixes == nullptr);
+  auto const& prefixes = prefixState.prefixes();
+  // prevRoutes is only read, hence safe to compare against from every shard
+  auto isUnchanged = [prevRoutes](RibUnicastEntry const& route) {
+    if (not prevRoutes) {
+      return false;
+    }
+    auto it = prevRoutes->find(route.prefix);
+    return it != prevRoutes->end() and it->second == route;
+  };
+  auto hadRoute = [prevRoutes](folly::CIDRNetwork const& prefix) {
+    return prevRoutes and prevRoutes->count(prefix);
+  };
+  // best route selection of other nodes isn't cached
+  std::unordered_map<folly::CIDRNetwork, RouteSelectionResult> bestRoutes;
+  const bool isMyNode = myNodeName == myNodeName_;
+  auto const* cachedBestRoutes = isMyNode ? &bestRoutesCache_ : nullptr;
+  auto& allBestRoutes = isMyNode ? bestRoutesCache_ : bestRoutes;
+  if (isMyNode) {
+    // drop selections of withdrawn prefixes
+    for (auto it = bestRoutesCache_.begin(); it != bestRoutesCache_.end();) {
+      if (prefixes.count(it->first)) {
+        ++it;
+      } else {
+        it = bestRoutesCache_.erase(it);
+      }
+    }
+  }
+
+  const size_t numShards = spfExecutor_
+      ? std::min<size_t>(spfExecutor_->numThreads(), prefixes.size())
+      : 1;
+  if (numShards <= 1) {
+    for (const auto& [prefix, _] : prefixes) {
+      if (auto maybeRoute = createRouteForPrefix(
+              myNodeName,
+              areaLinkStates,
+              prefixState,
+              prefix,
+              cachedBestRoutes,
+              allBestRoutes)) {
+        if (not isUnchanged(*maybeRoute)) {
+          routeDb.addUnicastRoute(std::move(maybeRoute).value());
+        }
+      } else if (hadRoute(prefix)) {
+        deletedPrefixes->emplace_back(prefix);
+      }
+    }
+    return;
+  }
+
+  // Partition prefixes into contiguous ranges of (almost) equal size. SPF and
+  // KSP2 paths are prefetched hence LinkState is read-only from here on, so
+  // is the cache of best route selection until shards are merged.
+  std::vector<folly::CIDRNetwork const*> allPrefixes;
+  allPrefixes.reserve(prefixes.size());
+  for (const auto& [prefix, _] : prefixes) {
+    allPrefixes.emplace_back(&prefix);
+  }
+
+  struct Shard {
+    size_t begin{0};
+    size_t end{0};
+    std::vector<RibUnicastEntry> routes;
+    std::vector<folly::CIDRNetwork> deletedPrefixes;
+    std::unordered_map<folly::CIDRNetwork, RouteSelectionResult> bestRoutes;
+  };
+  std::vector<folly::Future<Shard>> futures;
+  futures.reserve(numShards);
+  for (size_t i = 0; i < numShards; ++i) {
+    const size_t begin = allPrefixes.size() * i / numShards;
+    const size_t end = allPrefixes.size() * (i + 1) / numShards;
+    futures.emplace_back(folly::via(spfExecutor_.get(), [&, begin, end]() {
+      Shard shard;
+      shard.begin = begin;
+      shard.end = end;
+      for (size_t j = begin; j < end; ++j) {
+        auto const& prefix = *allPrefixes.at(j);
+        if (auto maybeRoute = createRouteForPrefix(
+                myNodeName,
+                areaLinkStates,
+                prefixState,
+                prefix,
+                cachedBestRoutes,
+                shard.bestRoutes)) {
+          if (not isUnchanged(*maybeRoute)) {
+            shard.routes.emplace_back(std::move(maybeRoute).value());
+          }
+        } else if (hadRoute(prefix)) {
+          shard.deletedPrefixes.emplace_back(prefix);
+        }
+      }
+      return shard;
+    }));
+  }
+
+  for (auto& result : folly::collectAll(std::move(futures)).get()) {
+    auto& shard = result.value();
+    for (auto& route : shard.routes) {
+      routeDb.addUnicastRoute(std::move(route));
+    }
+    if (deletedPrefixes) {
+      deletedPrefixes->insert(
+          deletedPrefixes->end(),
+          shard.deletedPrefixes.begin(),
+          shard.deletedPrefixes.end());
+    }
+    // selections of this shard's prefixes replace the cached ones
+    for (size_t j = shard.begin; j < shard.end; ++j) {
+      auto const& prefix = *allPrefixes.at(j);
+      auto it = shard.bestRoutes.find(prefix);
+      if (it == shard.bestRoutes.end()) {
+        allBestRoutes.erase(prefix);
+      } else {
+        allBestRoutes.insert_or_assign(prefix, std::move(it->second));
+      }
+    }
+  }
+}
+
 std::optional<DecisionRouteDb>
 SpfSolver::buildRouteDb(
     const std::string& myNodeName,
     std::unordered_map<std::string, LinkState> const& areaLinkStates,
-    PrefixState const& prefixState) {
+    PrefixState const& prefixState,
+    bool withStaticRoutes) {
   bool nodeExist{false};
   for (const auto& [_, linkState] : areaLinkStates) {
     nodeExist |= linkState.hasNode(myNodeName);
@@ -477,33 +794,149 @@ SpfSolver::buildRouteDb(
 
   DecisionRouteDb routeDb{};
 
-  // Clear best route selection cache
-  bestRoutesCache_.clear();
+  prefetchPaths(myNodeName, areaLinkStates, prefixState);
+
+  // Keep best route selections unaffected since the last build
+  if (myNodeName == myNodeName_) {
+    invalidateBestRoutesCache(areaLinkStates, prefixState);
+  }
 
   // Create IPv4, IPv6 routes (includes IP -> MPLS routes)
-  for (const auto& [prefix, _] : prefixState.prefixes()) {
-    if (auto maybeRoute = createRouteForPrefix(
-            myNodeName, areaLinkStates, prefixState, prefix)) {
-      routeDb.addUnicastRoute(std::move(maybeRoute).value());
+  buildUnicastRoutes(myNodeName, areaLinkStates, prefixState, routeDb);
+
+  // Create static unicast routes
+  if (withStaticRoutes) {
+    for (auto const& [prefix, ribUnicastEntry] : staticUnicastRoutes_) {
+      if (routeDb.unicastRoutes.count(prefix)) {
+        // ignore prefixes as prefixState has higher priority
+        continue;
+      }
+      routeDb.addUnicastRoute(RibUnicastEntry(ribUnicastEntry));
     }
   }
 
-  // Create static unicast routes
-  for (auto [prefix, ribUnicastEntry] : staticUnicastRoutes_) {
-    if (routeDb.unicastRoutes.count(prefix)) {
-      // ignore prefixes as prefixState has higher priority
-      continue;
+  // Create MPLS routes
+  buildMplsRoutes(myNodeName, areaLinkStates, routeDb, withStaticRoutes);
+
+  auto deltaTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - startTime);
+  LOG(INFO) << "Decision::buildRouteDb took " << deltaTime.count() << "ms.";
+  fb303::fbData->addStatValue(
+      "decision.route_build_ms", deltaTime.count(), fb303::AVG);
+  return routeDb;
+} // buildRouteDb
+
+std::optional<DecisionRouteUpdate>
+SpfSolver::buildRouteDbDelta(
+    const std::string& myNodeName,
+    std::unordered_map<std::string, LinkState> const& areaLinkStates,
+    PrefixState const& prefixState,
+    DecisionRouteDb const& prevDb) {
+  bool nodeExist{false};
+  for (const auto& [_, linkState] : areaLinkStates) {
+    nodeExist |= linkState.hasNode(myNodeName);
+  }
+  if (not nodeExist) {
+    return std::nullopt;
+  }
+
+  const auto startTime = std::chrono::steady_clock::now();
+  fb303::fbData->addStatValue("decision.route_build_runs", 1, fb303::COUNT);
+
+  prefetchPaths(myNodeName, areaLinkStates, prefixState);
+
+  // Keep best route selections unaffected since the last build
+  if (myNodeName == myNodeName_) {
+    invalidateBestRoutesCache(areaLinkStates, prefixState);
+  }
+
+  // MPLS routes are few, diff them as a whole
+  DecisionRouteDb mplsDb;
+  buildMplsRoutes(myNodeName, areaLinkStates, mplsDb, false);
+  auto delta = prevDb.calculateMplsUpdate(
+      std::move(mplsDb.mplsRoutes), &staticMplsRoutes_);
+
+  // Create changed IPv4, IPv6 routes only
+  DecisionRouteDb changedDb;
+  std::vector<folly::CIDRNetwork> deletedPrefixes;
+  buildUnicastRoutes(
+      myNodeName,
+      areaLinkStates,
+      prefixState,
+      changedDb,
+      &prevDb.unicastRoutes,
+      &deletedPrefixes);
+
+  // Route gone, unless static route takes over
+  auto deleteRoute = [&](folly::CIDRNetwork const& prefix,
+                         RibUnicastEntry const& prevEntry) {
+    auto it = staticUnicastRoutes_.find(prefix);
+    if (it == staticUnicastRoutes_.end()) {
+      delta.unicastRoutesToDelete.emplace_back(prefix);
+    } else if (it->second != prevEntry) {
+      delta.addRouteToUpdate(it->second);
     }
-    routeDb.addUnicastRoute(RibUnicastEntry(ribUnicastEntry));
+  };
+  for (auto const& prefix : deletedPrefixes) {
+    deleteRoute(prefix, prevDb.unicastRoutes.at(prefix));
   }
+  auto const& prefixes = prefixState.prefixes();
+  for (auto const& [prefix, entry] : prevDb.unicastRoutes) {
+    if (not prefixes.count(prefix)) {
+      deleteRoute(prefix, entry);
+    }
+  }
+
+  // static routes not in this db yet
+  for (auto const& [prefix, entry] : staticUnicastRoutes_) {
+    if (not prevDb.unicastRoutes.count(prefix) and
+        not changedDb.unicastRoutes.count(prefix)) {
+      delta.addRouteToUpdate(entry);
+    }
+  }
+
+  for (auto& [_, entry] : changedDb.unicastRoutes) {
+    delta.addRouteToUpdate(std::move(entry));
+  }
+
+  auto deltaTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - startTime);
+  LOG(INFO) << "Decision::buildRouteDbDelta took " << deltaTime.count()
+            << "ms.";
+  fb303::fbData->addStatValue(
+      "decision.route_build_ms", deltaTime.count(), fb303::AVG);
+  return delta;
+} // buildRouteDbDelta
 
+void
+SpfSolver::buildMplsRoutes(
+    const std::string& myNodeName,
+    std::unordered_map<std::string, LinkState> const& areaLinkStates,
+    DecisionRouteDb& routeDb,
+    bool withStaticRoutes) {
   //
   // Create MPLS routes for all nodeLabel
   //
   if (enableNodeSegmentLabel_) {
     std::unordered_map<int32_t, std::pair<std::string, RibMplsEntry>>
         labelToNode;
+    // node label routes are cached for myNodeName_ only
+    const bool isMyNode = myNodeName == myNodeName_;
+    std::unordered_map<std::string, NodeLabelRoutes> nodeLabelRoutes;
     for (const auto& [area, linkState] : areaLinkStates) {
+      NodeLabelRoutes* routes{nullptr};
+      NodeLabelRoutes const* cachedRoutes{nullptr};
+      if (isMyNode) {
+        routes = &nodeLabelRoutes[area];
+        getNodeLabelLocalLinks(myNodeName, linkState, *routes);
+        auto cachedIt = nodeLabelRoutes_.find(area);
+        if (cachedIt != nodeLabelRoutes_.end() and
+            cachedIt->second.localLinks == routes->localLinks) {
+          cachedRoutes = &cachedIt->second;
+        }
+      }
+      auto const& spfResult = linkState.getSpfResult(myNodeName);
+
       for (const auto& [_, adjDb] : linkState.getAdjacencyDatabases()) {
         const auto topLabel = *adjDb.nodeLabel_ref();
         const auto& nodeName = *adjDb.thisNodeName_ref();
@@ -554,49 +987,76 @@ SpfSolver::buildRouteDb(
           continue;
         }
 
-        // Get best nexthop towards the node
-        auto metricNhs = getNextHopsWithMetric(
-            myNodeName,
-            {{adjDb.thisNodeName_ref().value(), area}},
-            false,
-            linkState);
-        if (metricNhs.second.empty()) {
+        // Route depends on the label and shortest paths towards the node
+        NodeLabelRoutes::Entry entry;
+        entry.label = topLabel;
+        auto spfIt = spfResult.find(nodeName);
+        if (spfIt != spfResult.end()) {
+          entry.metricNextHops.emplace(
+              spfIt->second.metric(), spfIt->second.nextHops());
+        }
+
+        NodeLabelRoutes::Entry const* cachedEntry{nullptr};
+        if (cachedRoutes) {
+          auto cachedIt = cachedRoutes->nodes.find(nodeName);
+          if (cachedIt != cachedRoutes->nodes.end() and
+              cachedIt->second.label == entry.label and
+              cachedIt->second.metricNextHops == entry.metricNextHops) {
+            cachedEntry = &cachedIt->second;
+          }
+        }
+
+        if (cachedEntry) {
+          entry.route = cachedEntry->route;
+        } else {
+          fb303::fbData->addStatValue(
+              "decision.node_label_route_builds", 1, fb303::COUNT);
+          // Get best nexthop towards the node
+          auto metricNhs = getNextHopsWithMetric(
+              myNodeName, {{nodeName, area}}, false, linkState);
+          if (not metricNhs.second.empty()) {
+            // Create nexthops with appropriate MplsAction (PHP and SWAP).
+            // Note that all nexthops are valid for routing without loops. Fib
+            // is responsible for installing these routes by making sure it
+            // programs least cost nexthops first and of same action type
+            // (based on HW limitations)
+            entry.route.emplace(
+                topLabel,
+                getNextHopsThrift(
+                    myNodeName,
+                    {{nodeName, area}},
+                    false /* isV4 */,
+                    v4OverV6Nexthop_,
+                    false /* perDestination */,
+                    metricNhs.first,
+                    metricNhs.second,
+                    topLabel,
+                    area,
+                    linkState));
+          }
+        }
+
+        if (not entry.route) {
           LOG(WARNING) << "No route to nodeLabel " << std::to_string(topLabel)
                        << " of node " << nodeName;
           fb303::fbData->addStatValue(
               "decision.no_route_to_label", 1, fb303::COUNT);
-          continue;
+        } else {
+          labelToNode.erase(topLabel);
+          labelToNode.emplace(topLabel, std::make_pair(nodeName, *entry.route));
+        }
+        if (routes) {
+          routes->nodes.emplace(nodeName, std::move(entry));
         }
-
-        // Create nexthops with appropriate MplsAction (PHP and SWAP). Note
-        // that all nexthops are valid for routing without loops. Fib is
-        // responsible for installing these routes by making sure it programs
-        // least cost nexthops first and of same action type (based on HW
-        // limitations)
-        labelToNode.erase(topLabel);
-        labelToNode.emplace(
-            topLabel,
-            std::make_pair(
-                adjDb.thisNodeName_ref().value(),
-                RibMplsEntry(
-                    topLabel,
-                    getNextHopsThrift(
-                        myNodeName,
-                        {{adjDb.thisNodeName_ref().value(), area}},
-                        false /* isV4 */,
-                        v4OverV6Nexthop_,
-                        false /* perDestination */,
-                        metricNhs.first,
-                        metricNhs.second,
-                        topLabel,
-                        area,
-                        linkState))));
       }
     }
 
     for (auto& [_, nodeToEntry] : labelToNode) {
       routeDb.addMplsRoute(std::move(nodeToEntry.second));
     }
+    if (isMyNode) {
+      nodeLabelRoutes_ = std::move(nodeLabelRoutes);
+    }
   }
 
   //
@@ -635,17 +1095,194 @@ SpfSolver::buildRouteDb(
   //
   // Add MPLS static routes
   //
+  if (not withStaticRoutes) {
+    return;
+  }
   for (const auto& [_, mplsEntry] : staticMplsRoutes_) {
     routeDb.addMplsRoute(RibMplsEntry(mplsEntry));
   }
+}
 
-  auto deltaTime = std::chrono::duration_cast<std::chrono::milliseconds>(
-      std::chrono::steady_clock::now() - startTime);
-  LOG(INFO) << "Decision::buildRouteDb took " << deltaTime.count() << "ms.";
+SpfSolver::RoutedAreaTopology
+SpfSolver::getRoutedAreaTopology(
+    const std::string& myNodeName, LinkState const& linkState) const {
+  RoutedAreaTopology topology;
+  for (auto const& [node, result] : linkState.getSpfResult(myNodeName)) {
+    topology.nodes.emplace(
+        node, std::make_pair(result.metric(), result.nextHops()));
+  }
+  for (auto const& [node, _] : linkState.getAdjacencyDatabases()) {
+    if (linkState.isNodeOverloaded(node)) {
+      topology.overloadedNodes.emplace(node);
+    }
+  }
+  for (auto const& link : linkState.linksFromNode(myNodeName)) {
+    topology.localLinks.emplace(
+        link->getOtherNodeName(myNodeName),
+        link->getIfaceFromNode(myNodeName),
+        link->getMetricFromNode(myNodeName),
+        link->isUp());
+  }
+  return topology;
+}
+
+void
+SpfSolver::getNodeLabelLocalLinks(
+    const std::string& myNodeName,
+    LinkState const& linkState,
+    NodeLabelRoutes& routes) const {
+  // nexthop metrics are distances of neighbors over any path
+  for (auto const& link : linkState.linksFromNode(myNodeName)) {
+    auto const& neighbor = link->getOtherNodeName(myNodeName);
+    routes.localLinks.emplace_back(
+        neighbor,
+        link->getIfaceFromNode(myNodeName),
+        link->getMetricFromNode(myNodeName),
+        link->isUp(),
+        link->getNhV4FromNode(myNodeName),
+        link->getNhV6FromNode(myNodeName),
+        linkState.getMetricFromAToB(myNodeName, neighbor));
+  }
+  // links are unordered, {neighbor, interface} is unique among them
+  std::sort(
+      routes.localLinks.begin(),
+      routes.localLinks.end(),
+      [](auto const& lhs, auto const& rhs) {
+        return std::tie(std::get<0>(lhs), std::get<1>(lhs)) <
+            std::tie(std::get<0>(rhs), std::get<1>(rhs));
+      });
+}
+
+void
+SpfSolver::updateRoutedTopology(
+    const std::string& myNodeName,
+    std::unordered_map<std::string, LinkState> const& areaLinkStates) {
+  routedTopology_.emplace();
+  for (auto const& [area, linkState] : areaLinkStates) {
+    routedTopology_->emplace(
+        area, getRoutedAreaTopology(myNodeName, linkState));
+  }
+}
+
+std::optional<std::unordered_set<folly::CIDRNetwork>>
+SpfSolver::getPrefixesAffectedByTopology(
+    const std::string& myNodeName,
+    std::unordered_map<std::string, LinkState> const& areaLinkStates,
+    PrefixState const& prefixState) const {
+  // SR Policies may pick any path computation rules for a prefix. Loop-free
+  // alternates depend on shortest paths of neighbors too.
+  if (not routedTopology_ or not srPolicies_.empty() or enableLfa_) {
+    return std::nullopt;
+  }
+
+  bool nodeExist{false};
+  std::unordered_set<folly::CIDRNetwork> prefixes;
+  for (auto const& [area, linkState] : areaLinkStates) {
+    nodeExist |= linkState.hasNode(myNodeName);
+    auto routedIt = routedTopology_->find(area);
+    if (routedIt == routedTopology_->end()) {
+      return std::nullopt;
+    }
+    auto const& routed = routedIt->second;
+    auto const current = getRoutedAreaTopology(myNodeName, linkState);
+    // nexthops of every route go over local links
+    if (current.localLinks != routed.localLinks) {
+      return std::nullopt;
+    }
+
+    // nodes whose distance, nexthops or drain state changed
+    std::unordered_set<std::string> changedNodes;
+    for (auto const& [node, metricNextHops] : routed.nodes) {
+      auto it = current.nodes.find(node);
+      if (it == current.nodes.end() or it->second != metricNextHops) {
+        changedNodes.emplace(node);
+      }
+    }
+    for (auto const& [node, _] : current.nodes) {
+      if (not routed.nodes.count(node)) {
+        changedNodes.emplace(node);
+      }
+    }
+    for (auto const& node : routed.overloadedNodes) {
+      if (not current.overloadedNodes.count(node)) {
+        changedNodes.emplace(node);
+      }
+    }
+    for (auto const& node : current.overloadedNodes) {
+      if (not routed.overloadedNodes.count(node)) {
+        changedNodes.emplace(node);
+      }
+    }
+
+    for (auto const& node : changedNodes) {
+      auto const& nodePrefixes = prefixState.getPrefixesByNode({node, area});
+      prefixes.insert(nodePrefixes.begin(), nodePrefixes.end());
+    }
+  }
+  if (not nodeExist) {
+    return std::nullopt;
+  }
+
+  // second shortest paths may change with any link in the area
+  prefixes.insert(
+      prefixState.ksp2Prefixes().begin(), prefixState.ksp2Prefixes().end());
   fb303::fbData->addStatValue(
-      "decision.route_build_ms", deltaTime.count(), fb303::AVG);
-  return routeDb;
-} // buildRouteDb
+      "decision.topology_affected_prefixes", prefixes.size(), fb303::AVG);
+  return prefixes;
+}
+
+void
+SpfSolver::invalidateBestRoutesCache(
+    std::unordered_map<std::string, LinkState> const& areaLinkStates,
+    PrefixState const& prefixState) {
+  // best route selection depends on reachability and drain state of
+  // advertising nodes as well as their distance for the best node-area
+  std::unordered_map<
+      std::string,
+      std::unordered_map<std::string, std::pair<LinkStateMetric, bool>>>
+      topology;
+  for (auto const& [area, linkState] : areaLinkStates) {
+    auto& nodes = topology[area];
+    for (auto const& [node, result] : linkState.getSpfResult(myNodeName_)) {
+      nodes.emplace(
+          node,
+          std::make_pair(result.metric(), linkState.isNodeOverloaded(node)));
+    }
+  }
+
+  size_t numInvalidated{0};
+  auto invalidate = [&](std::string const& area, std::string const& node) {
+    for (auto const& prefix : prefixState.getPrefixesByNode({node, area})) {
+      numInvalidated += bestRoutesCache_.erase(prefix);
+    }
+  };
+  for (auto const& [area, nodes] : topology) {
+    auto prevIt = bestRoutesTopology_.find(area);
+    for (auto const& [node, state] : nodes) {
+      if (prevIt == bestRoutesTopology_.end()) {
+        invalidate(area, node);
+        continue;
+      }
+      auto it = prevIt->second.find(node);
+      if (it == prevIt->second.end() or it->second != state) {
+        invalidate(area, node);
+      }
+    }
+  }
+  for (auto const& [area, prevNodes] : bestRoutesTopology_) {
+    auto it = topology.find(area);
+    for (auto const& [node, _] : prevNodes) {
+      if (it == topology.end() or not it->second.count(node)) {
+        invalidate(area, node);
+      }
+    }
+  }
+  bestRoutesTopology_ = std::move(topology);
+  ksp2PathsCache_.wlock()->clear();
+
+  fb303::fbData->addStatValue(
+      "decision.best_routes_cache_invalidated", numInvalidated, fb303::SUM);
+}
 
 RouteSelectionResult
 SpfSolver::selectBestRoutes(
@@ -695,7 +1332,7 @@ SpfSolver::extendRoutes(
 
 std::optional<int64_t>
 SpfSolver::getMinNextHopThreshold(
-    RouteSelectionResult nodes, PrefixEntries const& prefixEntries) {
+    RouteSelectionResult const& nodes, PrefixEntries const& prefixEntries) {
   std::optional<int64_t> maxMinNexthopForPrefix = std::nullopt;
   for (const auto& nodeArea : nodes.allNodeAreas) {
     const auto& prefixEntry = prefixEntries.at(nodeArea);
@@ -713,25 +1350,32 @@ RouteSelectionResult
 SpfSolver::maybeFilterDrainedNodes(
     RouteSelectionResult&& result,
     std::unordered_map<std::string, LinkState> const& areaLinkStates) const {
-  RouteSelectionResult filtered = folly::copy(result);
-  for (auto iter = filtered.allNodeAreas.cbegin();
-       iter != filtered.allNodeAreas.cend();) {
+  // Commonly none of the nodes is drained, in which case result is moved
+  // through untouched
+  std::vector<std::set<NodeAndArea>::const_iterator> drainedNodeAreas;
+  for (auto iter = result.allNodeAreas.cbegin();
+       iter != result.allNodeAreas.cend();
+       ++iter) {
     const auto& [node, area] = *iter;
     if (areaLinkStates.at(area).isNodeOverloaded(node)) {
-      iter = filtered.allNodeAreas.erase(iter);
-    } else {
-      ++iter;
+      drainedNodeAreas.emplace_back(iter);
     }
   }
+  if (drainedNodeAreas.empty() or
+      drainedNodeAreas.size() == result.allNodeAreas.size()) {
+    return std::move(result);
+  }
 
-  // Update the bestNodeArea to a valid key
-  if (not filtered.allNodeAreas.empty() and
-      filtered.bestNodeArea != result.bestNodeArea) {
-    filtered.bestNodeArea =
-        selectBestNodeArea(filtered.allNodeAreas, myNodeName_, areaLinkStates);
+  for (auto const& iter : drainedNodeAreas) {
+    result.allNodeAreas.erase(iter);
   }
 
-  return filtered.allNodeAreas.empty() ? result : filtered;
+  // Update the bestNodeArea to a valid key
+  if (not result.allNodeAreas.count(result.bestNodeArea)) {
+    result.bestNodeArea =
+        selectBestNodeArea(result.allNodeAreas, myNodeName_, areaLinkStates);
+  }
+  return std::move(result);
 }
 
 RouteSelectionResult
@@ -831,6 +1475,77 @@ SpfSolver::selectBestPathsSpf(
           prefixEntries));
 }
 
+std::shared_ptr<const std::vector<SpfSolver::Ksp2Path>>
+SpfSolver::getKsp2Paths(
+    const std::string& myNodeName,
+    const std::string& node,
+    size_t k,
+    const std::string& area,
+    const LinkState& linkState) {
+  const bool isCached = myNodeName == myNodeName_;
+  const auto key = std::make_tuple(area, node, k);
+  if (isCached) {
+    auto cache = ksp2PathsCache_.rlock();
+    auto it = cache->find(key);
+    if (it != cache->end()) {
+      return it->second;
+    }
+  }
+
+  auto paths = std::make_shared<std::vector<Ksp2Path>>();
+  for (auto const& path : linkState.getKthPaths(myNodeName, node, k)) {
+    CHECK_GE(path.size(), 1);
+    auto& ksp2Path = paths->emplace_back();
+    ksp2Path.path = path;
+
+    // node labels along the path, top of the stack first
+    Metric cost = 0;
+    std::vector<int32_t> labels;
+    auto nextNodeName = myNodeName;
+    for (auto& link : path) {
+      cost += link->getMetricFromNode(nextNodeName);
+      nextNodeName = link->getOtherNodeName(nextNodeName);
+      auto& adjDb = linkState.getAdjacencyDatabases().at(nextNodeName);
+      labels.emplace_back(adjDb.get_nodeLabel());
+      if (not isMplsLabelValid(adjDb.get_nodeLabel())) {
+        ksp2Path.invalidNodes.emplace_back(adjDb.get_thisNodeName());
+      }
+    }
+    if (ksp2Path.invalidNodes.size() > 0) {
+      continue;
+    }
+
+    // Remove first node's label to respect PHP, bottom of the stack first
+    std::optional<thrift::MplsAction> mplsAction;
+    if (labels.size() > 1) {
+      mplsAction = createMplsAction(
+          thrift::MplsActionCode::PUSH,
+          std::nullopt,
+          std::vector<int32_t>(labels.crbegin(), labels.crend() - 1));
+    }
+
+    auto const& firstLink = path.front();
+    auto createKsp2NextHop = [&](thrift::BinaryAddress const& address) {
+      return createNextHop(
+          address,
+          firstLink->getIfaceFromNode(myNodeName),
+          cost,
+          mplsAction,
+          firstLink->getArea(),
+          firstLink->getOtherNodeName(myNodeName));
+    };
+    ksp2Path.nextHopV4 =
+        createKsp2NextHop(firstLink->getNhV4FromNode(myNodeName));
+    ksp2Path.nextHopV6 =
+        createKsp2NextHop(firstLink->getNhV6FromNode(myNodeName));
+  }
+
+  if (isCached) {
+    ksp2PathsCache_.wlock()->emplace(key, paths);
+  }
+  return paths;
+}
+
 std::unordered_set<thrift::NextHopThrift>
 SpfSolver::selectBestPathsKsp2(
     const std::string& myNodeName,
@@ -856,14 +1571,18 @@ SpfSolver::selectBestPathsKsp2(
     return nextHops;
   }
 
-  // find shortest and sec shortest routes towards each node.
+  // find shortest and sec shortest routes towards each node. Paths are
+  // shared by all prefixes of the node, hence kept alive by `nodePaths`.
+  std::vector<std::shared_ptr<const std::vector<Ksp2Path>>> nodePaths;
+  std::vector<std::pair<std::string const* /* node */, Ksp2Path const*>> paths;
   for (const auto& [node, bestArea] : routeSelectionResult.allNodeAreas) {
     // if ourself is considered as ECMP nodes.
     if (node == myNodeName and bestArea == area) {
       continue;
     }
-    for (auto const& path : linkState.getKthPaths(myNodeName, node, 1)) {
-      paths.push_back(path);
+    nodePaths.emplace_back(getKsp2Paths(myNodeName, node, 1, area, linkState));
+    for (auto const& path : *nodePaths.back()) {
+      paths.emplace_back(&node, &path);
     }
   }
 
@@ -875,7 +1594,8 @@ SpfSolver::selectBestPathsKsp2(
     if (area != bestArea) {
       continue;
     }
-    for (auto const& secPath : linkState.getKthPaths(myNodeName, node, 2)) {
+    nodePaths.emplace_back(getKsp2Paths(myNodeName, node, 2, area, linkState));
+    for (auto const& secPath : *nodePaths.back()) {
       bool add = true;
       for (size_t i = 0; i < firstPathsSize; ++i) {
         // this could happen for anycast VIPs.
@@ -884,13 +1604,14 @@ SpfSolver::selectBestPathsKsp2(
         // paths are A->B and A->C. And it is second shortest path is
         // A->B->C and A->C->B. In this case,  A->B->C containser A->B
         // already, so we want to avoid this.
-        if (LinkState::pathAInPathB(paths[i], secPath)) {
+        if (LinkState::pathAPrefixOfPathB(
+                paths[i].second->path, secPath.path)) {
           add = false;
           break;
         }
       }
       if (add) {
-        paths.push_back(secPath);
+        paths.emplace_back(&node, &secPath);
       }
     }
   }
@@ -899,64 +1620,115 @@ SpfSolver::selectBestPathsKsp2(
     return nextHops;
   }
 
-  for (const auto& path : paths) {
-    Metric cost = 0;
-    std::list<int32_t> labels;
-    // if self node is one of it's ecmp, it means this prefix is anycast and
-    // we need to add prepend label which is static MPLS route the destination
-    // prepared.
-    std::vector<std::string> invalidNodes;
-    auto nextNodeName = myNodeName;
-    for (auto& link : path) {
-      cost += link->getMetricFromNode(nextNodeName);
-      nextNodeName = link->getOtherNodeName(nextNodeName);
-      auto& adjDb = linkState.getAdjacencyDatabases().at(nextNodeName);
-      labels.push_front(adjDb.get_nodeLabel());
-      if (not isMplsLabelValid(adjDb.get_nodeLabel())) {
-        invalidNodes.emplace_back(adjDb.get_thisNodeName());
-      }
-    }
+  const bool isV4Prefix = prefix.first.isV4();
+  for (const auto& [node, path] : paths) {
     // Ignore paths including nodes with invalid node labels.
-    if (invalidNodes.size() > 0) {
+    if (path->invalidNodes.size() > 0) {
       LOG(WARNING) << fmt::format(
           "Ignore path for {} through [{}] because of invalid node label.",
           folly::IPAddress::networkToString(prefix),
-          folly::join(", ", invalidNodes));
+          folly::join(", ", path->invalidNodes));
       continue;
     }
-    labels.pop_back(); // Remove first node's label to respect PHP
+
+    auto nextHop = isV4Prefix and not v4OverV6Nexthop_ ? path->nextHopV4
+                                                        : path->nextHopV6;
 
     // Add prepend label of last node in the path.
-    auto lastNodeInPath = nextNodeName;
-    auto& prefixEntry = prefixEntries.at({lastNodeInPath, area});
+    auto& prefixEntry = prefixEntries.at({*node, area});
     if (prefixEntry->prependLabel_ref()) {
       // add prepend label to bottom of the stack
-      labels.push_front(prefixEntry->prependLabel_ref().value());
+      const int32_t prependLabel = prefixEntry->prependLabel_ref().value();
+      if (nextHop.mplsAction_ref().has_value()) {
+        auto& labels = *nextHop.mplsAction_ref()->pushLabels_ref();
+        labels.insert(labels.begin(), prependLabel);
+      } else {
+        nextHop.mplsAction_ref() = createMplsAction(
+            thrift::MplsActionCode::PUSH,
+            std::nullopt,
+            std::vector<int32_t>{prependLabel});
+      }
     }
+    nextHops.emplace(std::move(nextHop));
+  }
 
-    // Create nexthop
-    CHECK_GE(path.size(), 1);
-    auto const& firstLink = path.front();
-    std::optional<thrift::MplsAction> mplsAction;
-    if (labels.size()) {
-      std::vector<int32_t> labelVec{labels.cbegin(), labels.cend()};
-      mplsAction = createMplsAction(
-          thrift::MplsActionCode::PUSH, std::nullopt, std::move(labelVec));
-    }
+  return nextHops;
+}
 
-    bool isV4Prefix = prefix.first.isV4();
-    nextHops.emplace(createNextHop(
-        isV4Prefix and not v4OverV6Nexthop_
-            ? firstLink->getNhV4FromNode(myNodeName)
-            : firstLink->getNhV6FromNode(myNodeName),
-        firstLink->getIfaceFromNode(myNodeName),
-        cost,
-        mplsAction,
-        firstLink->getArea(),
-        firstLink->getOtherNodeName(myNodeName)));
+std::unordered_set<thrift::NextHopThrift>
+SpfSolver::selectLfaNextHops(
+    const std::string& myNodeName,
+    const folly::CIDRNetwork& prefix,
+    RouteSelectionResult const& routeSelectionResult,
+    const std::string& area,
+    const LinkState& linkState,
+    std::unordered_set<thrift::NextHopThrift> const& primaryNextHops) const {
+  // alternates must not fail together with primary links
+  std::unordered_set<std::string> primaryIfNames;
+  for (auto const& nextHop : primaryNextHops) {
+    if (auto ifName = nextHop.address_ref()->ifName_ref()) {
+      primaryIfNames.emplace(*ifName);
+    }
   }
 
-  return nextHops;
+  auto const& spfResult = linkState.getSpfResult(myNodeName);
+  Metric bestMetric = std::numeric_limits<Metric>::max();
+  std::unordered_set<thrift::NextHopThrift> lfaNextHops;
+  for (auto const& link : linkState.linksFromNode(myNodeName)) {
+    if (not link->isUp() or
+        primaryIfNames.count(link->getIfaceFromNode(myNodeName))) {
+      continue;
+    }
+    auto const& neighbor = link->getOtherNodeName(myNodeName);
+    auto const& neighborSpfResult = linkState.getSpfResult(neighbor);
+    auto const selfIt = neighborSpfResult.find(myNodeName);
+    if (selfIt == neighborSpfResult.end()) {
+      continue;
+    }
+
+    // lowest metric over neighbor towards any best node it won't loop back
+    std::optional<Metric> metric;
+    for (auto const& [dstNode, dstArea] : routeSelectionResult.allNodeAreas) {
+      if (dstArea != area) {
+        continue;
+      }
+      // overloaded neighbor doesn't carry transit traffic
+      if (neighbor != dstNode and linkState.isNodeOverloaded(neighbor)) {
+        continue;
+      }
+      auto const dstIt = spfResult.find(dstNode);
+      auto const neighborDstIt = neighborSpfResult.find(dstNode);
+      if (dstIt == spfResult.end() or
+          neighborDstIt == neighborSpfResult.end()) {
+        continue;
+      }
+      // inequality 1 of RFC 5286
+      if (neighborDstIt->second.metric() >=
+          selfIt->second.metric() + dstIt->second.metric()) {
+        continue;
+      }
+      const Metric viaNeighbor =
+          link->getMetricFromNode(myNodeName) + neighborDstIt->second.metric();
+      metric = metric ? std::min(*metric, viaNeighbor) : viaNeighbor;
+    }
+    if (not metric or *metric > bestMetric) {
+      continue;
+    }
+    if (*metric < bestMetric) {
+      bestMetric = *metric;
+      lfaNextHops.clear();
+    }
+    lfaNextHops.emplace(createNextHop(
+        prefix.first.isV4() and not v4OverV6Nexthop_
+            ? link->getNhV4FromNode(myNodeName)
+            : link->getNhV6FromNode(myNodeName),
+        link->getIfaceFromNode(myNodeName),
+        *metric,
+        std::nullopt /* mplsAction */,
+        link->getArea(),
+        neighbor));
+  }
+  return lfaNextHops;
 }
 
 std::optional<RibUnicastEntry>
@@ -1190,6 +1962,25 @@ SpfSolver::getNumSrPolicies() const {
   return srPolicies_.size();
 }
 
+void
+SpfSolver::matchSrPolicies(
+    const PrefixEntries& prefixEntries,
+    RouteSelectionResult& routeSelectionResult) const {
+  if (routeSelectionResult.srPoliciesMatched) {
+    return;
+  }
+  routeSelectionResult.srPoliciesMatched = true;
+  routeSelectionResult.srPolicyRules.reset();
+  for (const auto& srPolicy : srPolicies_) {
+    auto rules = srPolicy.matchAndGetRules(
+        prefixEntries.at(routeSelectionResult.bestNodeArea));
+    if (rules) {
+      routeSelectionResult.srPolicyRules = std::move(rules);
+      return;
+    }
+  }
+}
+
 thrift::RouteComputationRules
 SpfSolver::getRouteComputationRules(
     const PrefixEntries& prefixEntries,
@@ -1197,11 +1988,17 @@ SpfSolver::getRouteComputationRules(
     const std::unordered_map<std::string, LinkState>& areaLinkStates) const {
   // Walk the srPolicies_ list and return the rules of the first one that
   // matches the route attributes
-  for (const auto& srPolicy : srPolicies_) {
-    auto rules = srPolicy.matchAndGetRules(
-        prefixEntries.at(routeSelectionResult.bestNodeArea));
-    if (rules) {
-      return *rules;
+  if (routeSelectionResult.srPoliciesMatched) {
+    if (routeSelectionResult.srPolicyRules) {
+      return *routeSelectionResult.srPolicyRules;
+    }
+  } else {
+    for (const auto& srPolicy : srPolicies_) {
+      auto rules = srPolicy.matchAndGetRules(
+          prefixEntries.at(routeSelectionResult.bestNodeArea));
+      if (rules) {
+        return *rules;
+      }
     }
   }
 
@@ -8,8 +8,15 @@
 #pragma once
 
 #include <chrono>
+#include <memory>
+#include <set>
 #include <string>
+#include <tuple>
 #include <unordered_map>
+#include <unordered_set>
+
+#include <folly/Synchronized.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 
 #include <openr/common/PrependLabelAllocator.h>
 #include <openr/config/Config.h>
@@ -23,9 +30,8 @@
 
 namespace openr {
 
-using StaticMplsRoutes = std::unordered_map<int32_t, RibMplsEntry>;
-using StaticUnicastRoutes =
-    std::unordered_map<folly::CIDRNetwork, RibUnicastEntry>;
+using StaticMplsRoutes = RibMplsEntries;
+using StaticUnicastRoutes = RibUnicastEntries;
 
 /**
  * Captures the route selection result. Especially highlights
@@ -45,6 +51,17 @@ struct RouteSelectionResult {
   // redistribution across areas.
   NodeAndArea bestNodeArea;
 
+  // Reachable prefix entries the selection was made from. Entries are
+  // replaced in PrefixState on every change, hence comparing them tells if a
+  // cached selection is still valid.
+  PrefixEntries prefixEntries;
+
+  // Rules of the first SR Policy matching the best prefix entry, std::nullopt
+  // if none matches. Valid once `srPoliciesMatched` is set. Kept along with
+  // the selection, hence matched again only when prefix entries change.
+  bool srPoliciesMatched{false};
+  std::optional<thrift::RouteComputationRules> srPolicyRules;
+
   /**
    * Function to check if provide node is one of the selected nodes.
    */
@@ -61,14 +78,25 @@ struct RouteSelectionResult {
 
 class DecisionRouteDb {
  public:
-  std::unordered_map<folly::CIDRNetwork /* prefix */, RibUnicastEntry>
-      unicastRoutes;
-  std::unordered_map<int32_t /* label */, RibMplsEntry> mplsRoutes;
+  RibUnicastEntries unicastRoutes; // keyed by prefix
+  RibMplsEntries mplsRoutes; // keyed by label
 
   // calculate the delta between this and newDb. Note, this method is const;
   // We are not actually updating here. We may mutate the DecisionRouteUpdate in
   // some way before calling update with it
-  DecisionRouteUpdate calculateUpdate(DecisionRouteDb&& newDb) const;
+  //
+  // If given, static routes are an overlay below newDb, i.e. route of a key
+  // missing in newDb is the static one. Static routes already in this db are
+  // left as they are, hence only changed ones get copied.
+  DecisionRouteUpdate calculateUpdate(
+      DecisionRouteDb&& newDb,
+      StaticUnicastRoutes const* staticUnicastRoutes = nullptr,
+      StaticMplsRoutes const* staticMplsRoutes = nullptr) const;
+
+  // calculate the delta between MPLS routes of this and newMplsRoutes
+  DecisionRouteUpdate calculateMplsUpdate(
+      RibMplsEntries&& newMplsRoutes,
+      StaticMplsRoutes const* staticMplsRoutes = nullptr) const;
 
   // update the state of this with the DecisionRouteUpdate passed
   void update(DecisionRouteUpdate const& update);
@@ -127,21 +155,72 @@ class SpfSolver {
   //
 
   void updateStaticUnicastRoutes(
-      const std::unordered_map<folly::CIDRNetwork, RibUnicastEntry>&
-          unicastRoutesToUpdate,
+      const RibUnicastEntries& unicastRoutesToUpdate,
       const std::vector<folly::CIDRNetwork>& unicastRoutesToDelete);
 
   void updateStaticMplsRoutes(
-      const std::unordered_map<int32_t, RibMplsEntry>& mplsRoutesToUpdate,
+      const RibMplsEntries& mplsRoutesToUpdate,
       const std::vector<int32_t>& mplsRoutesToDelete);
 
   // Build route database using given prefix and link states for a given
   // router, myNodeName
   // Returns std::nullopt if myNodeName doesn't have any prefix database
+  // Static routes are left out with `withStaticRoutes` false, for merging
+  // them as overlay with DecisionRouteDb::calculateUpdate()
   std::optional<DecisionRouteDb> buildRouteDb(
       const std::string& myNodeName,
       std::unordered_map<std::string, LinkState> const& areaLinkStates,
-      PrefixState const& prefixState);
+      PrefixState const& prefixState,
+      bool withStaticRoutes = true);
+
+  // Build routes as buildRouteDb() does, but return the delta to `prevDb`
+  // right away instead of a route db. Built routes are compared against the
+  // ones of `prevDb` as they're created and only changed ones are kept, hence
+  // no second route db is built nor diffed. Static routes are merged as
+  // overlay below built ones, as with DecisionRouteDb::calculateUpdate().
+  // Returns std::nullopt if myNodeName doesn't have any prefix database.
+  std::optional<DecisionRouteUpdate> buildRouteDbDelta(
+      const std::string& myNodeName,
+      std::unordered_map<std::string, LinkState> const& areaLinkStates,
+      PrefixState const& prefixState,
+      DecisionRouteDb const& prevDb);
+
+  // Create MPLS routes of node and adjacency labels as well as static MPLS
+  // routes (unless `withStaticRoutes` is false) into `routeDb`. Node label
+  // routes of myNodeName_ are reused from previous build unless the node's
+  // label, distance or nexthops, or local links changed.
+  void buildMplsRoutes(
+      const std::string& myNodeName,
+      std::unordered_map<std::string, LinkState> const& areaLinkStates,
+      DecisionRouteDb& routeDb,
+      bool withStaticRoutes = true);
+
+  StaticUnicastRoutes const&
+  getStaticUnicastRoutes() const {
+    return staticUnicastRoutes_;
+  }
+
+  StaticMplsRoutes const&
+  getStaticMplsRoutes() const {
+    return staticMplsRoutes_;
+  }
+
+  // Record shortest paths, drained nodes and local links of myNodeName routes
+  // are built against. Must be called whenever programmed routes got rebuilt
+  // after topology change.
+  void updateRoutedTopology(
+      const std::string& myNodeName,
+      std::unordered_map<std::string, LinkState> const& areaLinkStates);
+
+  // Prefixes whose unicast routes may have changed since the last
+  // updateRoutedTopology(), i.e. prefixes advertised by nodes whose distance,
+  // nexthops or drain state changed and all KSP2_ED_ECMP prefixes. Returns
+  // std::nullopt if all routes need to be rebuilt, e.g. a local link changed.
+  std::optional<std::unordered_set<folly::CIDRNetwork>>
+  getPrefixesAffectedByTopology(
+      const std::string& myNodeName,
+      std::unordered_map<std::string, LinkState> const& areaLinkStates,
+      PrefixState const& prefixState) const;
 
   std::optional<RibUnicastEntry> createRouteForPrefixOrGetStaticRoute(
       const std::string& myNodeName,
@@ -149,6 +228,15 @@ class SpfSolver {
       PrefixState const& prefixState,
       folly::CIDRNetwork const& prefix);
 
+  // Invalidate cached best route selections of prefixes advertised by nodes
+  // whose distance, reachability or drain state changed since the last call.
+  // Cached KSP2 paths are dropped altogether.
+  // Must be called after topology change before routes of myNodeName_ are
+  // created for individual prefixes. buildRouteDb() calls it on its own.
+  void invalidateBestRoutesCache(
+      std::unordered_map<std::string, LinkState> const& areaLinkStates,
+      PrefixState const& prefixState);
+
   std::unordered_map<folly::CIDRNetwork, RouteSelectionResult> const&
   getBestRoutesCache() const {
     return bestRoutesCache_;
@@ -159,7 +247,8 @@ class SpfSolver {
 
   // Walk all SR Policies and return the route computation rules of the first
   // one that matches. If none of them match then the default route computation
-  // rules are returned
+  // rules are returned. Result of matching cached in `routeSelectionResult` is
+  // used if present, see matchSrPolicies().
   thrift::RouteComputationRules getRouteComputationRules(
       const PrefixEntries& prefixEntries,
       const RouteSelectionResult& routeSelectionResult,
@@ -170,11 +259,97 @@ class SpfSolver {
   SpfSolver(SpfSolver const&) = delete;
   SpfSolver& operator=(SpfSolver const&) = delete;
 
+  // Create route for prefix and update its best route selection in
+  // `bestRoutes`. Selection is reused from `cachedBestRoutes` if made from the
+  // same prefix entries. Reads memoized SPF/KSP2 paths only, once they're
+  // prefetched, hence safe to run concurrently for distinct prefixes and
+  // output maps.
   std::optional<RibUnicastEntry> createRouteForPrefix(
       const std::string& myNodeName,
       std::unordered_map<std::string, LinkState> const& areaLinkStates,
       PrefixState const& prefixState,
-      folly::CIDRNetwork const& prefix);
+      folly::CIDRNetwork const& prefix,
+      std::unordered_map<folly::CIDRNetwork, RouteSelectionResult> const*
+          cachedBestRoutes,
+      std::unordered_map<folly::CIDRNetwork, RouteSelectionResult>&
+          bestRoutes);
+
+  // Match SR Policies against the best prefix entry of `routeSelectionResult`
+  // and keep the result in it, unless already matched
+  void matchSrPolicies(
+      const PrefixEntries& prefixEntries,
+      RouteSelectionResult& routeSelectionResult) const;
+
+  // Create routes of all prefixes in `prefixState` into `routeDb`. Prefixes
+  // are partitioned across spfExecutor_ if present, every shard builds its
+  // own routes and best route selections which are merged in shard order.
+  //
+  // If `prevRoutes` is given, routes equal to the previous ones are dropped
+  // and prefixes whose previous route is gone are added to `deletedPrefixes`.
+  // Prefixes no longer in `prefixState` are left to the caller.
+  void buildUnicastRoutes(
+      const std::string& myNodeName,
+      std::unordered_map<std::string, LinkState> const& areaLinkStates,
+      PrefixState const& prefixState,
+      DecisionRouteDb& routeDb,
+      RibUnicastEntries const* prevRoutes = nullptr,
+      std::vector<folly::CIDRNetwork>* deletedPrefixes = nullptr);
+
+  // Topology of an area as seen by myNodeName when routes were built
+  struct RoutedAreaTopology {
+    // node -> {distance, nexthops}
+    std::unordered_map<
+        std::string,
+        std::pair<LinkStateMetric, std::unordered_set<std::string>>>
+        nodes;
+    std::unordered_set<std::string> overloadedNodes;
+    // {neighbor, interface, metric, isUp} of links from myNodeName
+    std::set<std::tuple<std::string, std::string, LinkStateMetric, bool>>
+        localLinks;
+  };
+
+  RoutedAreaTopology getRoutedAreaTopology(
+      const std::string& myNodeName, LinkState const& linkState) const;
+
+  // Node label routes of an area as built by myNodeName_
+  struct NodeLabelRoutes {
+    // {neighbor, interface, metric, isUp, nhV4, nhV6, neighbor distance} of
+    // links from myNodeName_, every route goes over them
+    std::vector<std::tuple<
+        std::string,
+        std::string,
+        LinkStateMetric,
+        bool,
+        thrift::BinaryAddress,
+        thrift::BinaryAddress,
+        std::optional<LinkStateMetric>>>
+        localLinks;
+
+    struct Entry {
+      int32_t label{0};
+      // {distance, nexthops} of the node, std::nullopt if unreachable
+      std::optional<
+          std::pair<LinkStateMetric, std::unordered_set<std::string>>>
+          metricNextHops;
+      // std::nullopt if there is no route to the node
+      std::optional<RibMplsEntry> route;
+    };
+    // node -> route towards its label
+    std::unordered_map<std::string, Entry> nodes;
+  };
+
+  void getNodeLabelLocalLinks(
+      const std::string& myNodeName,
+      LinkState const& linkState,
+      NodeLabelRoutes& routes) const;
+
+  // Compute SPF of all areas and KSP2 paths towards nodes advertising
+  // KSP2_ED_ECMP prefixes on spfExecutor_ in parallel. Results are memoized
+  // in LinkState before route selection reads them. No-op without executor.
+  void prefetchPaths(
+      const std::string& myNodeName,
+      std::unordered_map<std::string, LinkState> const& areaLinkStates,
+      PrefixState const& prefixState);
 
   static std::pair<openr::LinkStateMetric, std::unordered_set<std::string>>
   getMinCostNodes(
@@ -194,6 +369,26 @@ class SpfSolver {
       const LinkState& linkState,
       PrefixState const& prefixState);
 
+  // KSP2 path towards a node along with its next-hop, pushing node labels of
+  // the path. Prepend label of the node is left to the prefix.
+  struct Ksp2Path {
+    LinkState::Path path;
+    // nodes of the path without valid node label, path is unusable if any
+    std::vector<std::string> invalidNodes;
+    // next-hop of v4 and v6 prefixes
+    thrift::NextHopThrift nextHopV4;
+    thrift::NextHopThrift nextHopV6;
+  };
+
+  // getKthPaths(myNodeName, node, k) along with their next-hops. Cached for
+  // myNodeName_, as label stacks are shared by all prefixes of the node.
+  std::shared_ptr<const std::vector<Ksp2Path>> getKsp2Paths(
+      const std::string& myNodeName,
+      const std::string& node,
+      size_t k,
+      const std::string& area,
+      const LinkState& linkState);
+
   // Given prefixes and the nodes who announce it, get the kspf2 routes, aka,
   // shortest paths and second shortest paths.
   std::unordered_set<thrift::NextHopThrift> selectBestPathsKsp2(
@@ -206,6 +401,18 @@ class SpfSolver {
       const std::string& area,
       const LinkState& linkState);
 
+  // Loop-free alternates (RFC 5286) of IP next-hops towards best nodes in
+  // area. Alternate goes over a local link not used by primaryNextHops to
+  // neighbor N, with D(N, dst) < D(N, me) + D(me, dst) for some best node
+  // dst. Only alternates of the lowest metric are returned.
+  std::unordered_set<thrift::NextHopThrift> selectLfaNextHops(
+      const std::string& myNodeName,
+      const folly::CIDRNetwork& prefix,
+      RouteSelectionResult const& routeSelectionResult,
+      const std::string& area,
+      const LinkState& linkState,
+      std::unordered_set<thrift::NextHopThrift> const& primaryNextHops) const;
+
   std::optional<RibUnicastEntry> addBestPaths(
       const std::string& myNodeName,
       const folly::CIDRNetwork& prefixThrift,
@@ -247,12 +454,14 @@ class SpfSolver {
 
   // helper to get min nexthop for a prefix, used in selectKsp2
   std::optional<int64_t> getMinNextHopThreshold(
-      RouteSelectionResult nodes, PrefixEntries const& prefixEntries);
+      RouteSelectionResult const& nodes, PrefixEntries const& prefixEntries);
 
   // Helper to filter overloaded nodes for anycast addresses
   //
   // TODO: This should go away, once Open/R policy is in place. The overloaded
-  // nodes will stop advertising specific prefixes if they're overloaded
+  // nodes will stop advertising specific prefixes if they're overloaded.
+  // Drained nodes are erased from `result` in place, unless all of its nodes
+  // are drained, in which case they're all kept.
   RouteSelectionResult maybeFilterDrainedNodes(
       RouteSelectionResult&& result,
       std::unordered_map<std::string, LinkState> const& areaLinkStates) const;
@@ -295,11 +504,39 @@ class SpfSolver {
   StaticMplsRoutes staticMplsRoutes_;
   StaticUnicastRoutes staticUnicastRoutes_;
 
-  // Cache of best route selection.
-  // - Cleared when topology changes
+  // Cache of best route selection of myNodeName_, kept across rebuilds.
+  // - Entry is reused as long as prefix entries it was made from are unchanged
+  // - Invalidated for prefixes of nodes whose distance, reachability or drain
+  //   state changed, see invalidateBestRoutesCache()
   // - Updated for the prefix whenever a route is created for it
   std::unordered_map<folly::CIDRNetwork, RouteSelectionResult> bestRoutesCache_;
 
+  // Cache of KSP2 paths of myNodeName_ with their next-hops, see
+  // getKsp2Paths(). Dropped on topology change along with bestRoutesCache_.
+  // Filled while routes of distinct prefixes are created concurrently.
+  folly::Synchronized<std::unordered_map<
+      std::tuple<
+          std::string /* area */,
+          std::string /* node */,
+          size_t /* k */>,
+      std::shared_ptr<const std::vector<Ksp2Path>>>>
+      ksp2PathsCache_;
+
+  // area -> node -> {distance, overloaded} as seen by myNodeName_ when
+  // bestRoutesCache_ was last invalidated
+  std::unordered_map<
+      std::string,
+      std::unordered_map<std::string, std::pair<LinkStateMetric, bool>>>
+      bestRoutesTopology_;
+
+  // Topology of every area programmed routes were built against, see
+  // updateRoutedTopology()
+  std::optional<std::unordered_map<std::string, RoutedAreaTopology>>
+      routedTopology_;
+
+  // area -> node label routes of myNodeName_ from the last buildMplsRoutes()
+  std::unordered_map<std::string, NodeLabelRoutes> nodeLabelRoutes_;
+
   const std::string myNodeName_;
 
   // is v4 enabled. If yes then Decision will forward v4 prefixes with v4
@@ -319,6 +556,9 @@ class SpfSolver {
   // use v4 over v4 nexthop.
   const bool v4OverV6Nexthop_{false};
 
+  // compute loop-free alternates of IP routes
+  bool enableLfa_{false};
+
   // SR Policies own the route computation rules
   std::vector<SrPolicy> srPolicies_;
 
@@ -340,5 +580,8 @@ class SpfSolver {
   // Allocate and deallocate prepend labels per address family (v4/v6)
   std::unique_ptr<PrependLabelAllocator<thrift::NextHopThrift>>
       prependLabelAllocator_;
+
+  // Bounded thread pool for SPF and KSP2 computation, nullptr if disabled
+  std::unique_ptr<folly::CPUThreadPoolExecutor> spfExecutor_;
 };
 } // namespace openr
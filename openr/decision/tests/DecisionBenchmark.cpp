@@ -7,6 +7,23 @@
 
 #include <openr/decision/tests/RoutingBenchmarkUtils.h>
 
+DEFINE_string(
+    replay_file,
+    "",
+    "Publications captured by KvStoreSnooper for BM_DecisionReplay, which "
+    "runs only if set");
+DEFINE_string(
+    replay_node, "", "Name of the node whose Decision replays publications");
+DEFINE_int32(
+    replay_pub_interval_ms,
+    0,
+    "Interval between replayed publications, back to back if 0");
+DEFINE_double(
+    replay_speedup,
+    0,
+    "Replay publications at their captured pace sped up by this factor, e.g. "
+    "1 for original speed. Ignored if --replay_pub_interval_ms is set.");
+
 namespace openr {
 
 /*
@@ -53,6 +70,26 @@ BENCHMARK_COUNTERS_PARAM(
 BENCHMARK_COUNTERS_PARAM(
     BM_DecisionGridAdjUpdates, counters, 1000, KSP2_ED_ECMP, 1);
 
+/*
+ * BM_DecisionGridSpfMetricUpdates:
+ * measures performance of SPF after a single link metric change for a grid
+ * topology. i.e. How long does it take to repair memoized SPF result
+ * incrementally compared to recomputing it with full SPF run
+ */
+
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_DecisionGridSpfMetricUpdates, counters, 100_full, 100, false);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_DecisionGridSpfMetricUpdates, counters, 100_incremental, 100, true);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_DecisionGridSpfMetricUpdates, counters, 1000_full, 1000, false);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_DecisionGridSpfMetricUpdates, counters, 1000_incremental, 1000, true);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_DecisionGridSpfMetricUpdates, counters, 5000_full, 5000, false);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_DecisionGridSpfMetricUpdates, counters, 5000_incremental, 5000, true);
+
 /*
  * BM_DecisionGridPrefixUpdates:
  * measures preformance of a prefix change for a grid topology.
@@ -83,11 +120,48 @@ BENCHMARK_COUNTERS_PARAM(
 BENCHMARK_COUNTERS_PARAM(BM_DecisionFabric, counters, 344, SP_ECMP, 1);
 BENCHMARK_COUNTERS_PARAM(BM_DecisionFabric, counters, 1000, SP_ECMP, 1);
 BENCHMARK_COUNTERS_PARAM(BM_DecisionFabric, counters, 5000, SP_ECMP, 1);
+
+/*
+ * BM_DecisionFabricSpfMetricUpdates:
+ * measures performance of incremental SPF, i.e. decrease/increase-key heavy
+ * DijkstraQ operations, after a single link metric change for a fabric
+ * topology of same size as BM_DecisionFabric
+ */
+
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_DecisionFabricSpfMetricUpdates, counters, 344, 344);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_DecisionFabricSpfMetricUpdates, counters, 1000, 1000);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_DecisionFabricSpfMetricUpdates, counters, 5000, 5000);
 } // namespace openr
 
 int
 main(int argc, char** argv) {
   folly::init(&argc, &argv);
+
+  /*
+   * BM_DecisionReplay:
+   * measures latency of route rebuilds, allocations and peak memory while
+   * replaying churn recorded from a production node, e.g. by
+   * `openr_kvstore_snooper --dump_file`
+   */
+  if (not FLAGS_replay_file.empty()) {
+    CHECK(not FLAGS_replay_node.empty()) << "--replay_node must be set";
+    folly::addBenchmark(
+        __FILE__,
+        "BM_DecisionReplay",
+        [](folly::UserCounters& counters, unsigned iters) {
+          openr::BM_DecisionReplay(
+              counters,
+              iters,
+              FLAGS_replay_node,
+              FLAGS_replay_file,
+              std::chrono::milliseconds(FLAGS_replay_pub_interval_ms),
+              FLAGS_replay_speedup);
+          return iters;
+        });
+  }
   folly::runBenchmarks();
   return 0;
 }
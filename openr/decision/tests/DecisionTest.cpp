@@ -817,6 +817,342 @@ TEST(MplsRoutes, BasicTest) {
   validateAdjLabelRoutes(routeMap, "3", {adj32});
 }
 
+//
+// Verify node label routes are rebuilt only for nodes whose label or shortest
+// paths changed, in topology below with all links of metric 10
+//
+//  1---2---3
+//       \  |
+//        \ |
+//          4
+//
+TEST(MplsRoutes, IncrementalNodeLabelRoutes) {
+  fb303::fbData->resetAllData();
+  auto config = std::make_shared<Config>(createConfig());
+  auto createSpfSolver = [&config]() {
+    return std::make_unique<SpfSolver>(
+        config,
+        "1",
+        false /* disable v4 */,
+        true /* enable segment label */,
+        false /* disable adj labels */);
+  };
+  auto spfSolver = createSpfSolver();
+
+  std::unordered_map<std::string, LinkState> areaLinkStates;
+  areaLinkStates.emplace(kTestingAreaName, LinkState(kTestingAreaName));
+  auto& linkState = areaLinkStates.at(kTestingAreaName);
+  linkState.updateAdjacencyDatabase(createAdjDb("1", {adj12}, 1));
+  linkState.updateAdjacencyDatabase(
+      createAdjDb("2", {adj21, adj23, adj24}, 2));
+  linkState.updateAdjacencyDatabase(createAdjDb("3", {adj32, adj34}, 3));
+  linkState.updateAdjacencyDatabase(createAdjDb("4", {adj42, adj43}, 4));
+
+  // build routes and verify they match those of a solver building them from
+  // scratch, returns number of node label routes built incrementally
+  auto buildRoutes = [&]() {
+    const auto buildsBefore = fb303::fbData->getCounters().at(
+        "decision.node_label_route_builds.count");
+    DecisionRouteDb routeDb;
+    spfSolver->buildMplsRoutes("1", areaLinkStates, routeDb);
+    const auto builds = fb303::fbData->getCounters().at(
+                            "decision.node_label_route_builds.count") -
+        buildsBefore;
+
+    DecisionRouteDb expectedRouteDb;
+    createSpfSolver()->buildMplsRoutes("1", areaLinkStates, expectedRouteDb);
+    EXPECT_EQ(expectedRouteDb.mplsRoutes, routeDb.mplsRoutes);
+    EXPECT_EQ(4, routeDb.mplsRoutes.size());
+    return builds;
+  };
+
+  // routes towards 2, 3 and 4 are built first
+  DecisionRouteDb routeDb;
+  spfSolver->buildMplsRoutes("1", areaLinkStates, routeDb);
+  auto counters = fb303::fbData->getCounters();
+  EXPECT_EQ(3, counters.at("decision.node_label_route_builds.count"));
+
+  // nothing changed, all routes are reused
+  EXPECT_EQ(0, buildRoutes());
+
+  // label of 4 changed
+  linkState.updateAdjacencyDatabase(createAdjDb("4", {adj42, adj43}, 40));
+  EXPECT_EQ(1, buildRoutes());
+
+  // 2---4 goes down, only the distance towards 4 changes
+  linkState.updateAdjacencyDatabase(createAdjDb("2", {adj21, adj23}, 2));
+  EXPECT_EQ(1, buildRoutes());
+
+  // metric change of local link requires to rebuild all routes
+  auto adj12Metric20 = adj12;
+  adj12Metric20.metric_ref() = 20;
+  linkState.updateAdjacencyDatabase(createAdjDb("1", {adj12Metric20}, 1));
+  EXPECT_EQ(3, buildRoutes());
+}
+
+//
+// Verify prefixes affected by topology changes since routes were built in
+// topology below, all links of metric 10
+//
+//  1---2---3
+//       \  |
+//        \ |
+//          4
+//
+TEST(SpfSolver, PrefixesAffectedByTopology) {
+  auto config = std::make_shared<Config>(createConfig());
+  SpfSolver spfSolver(
+      config,
+      "1",
+      false /* disable v4 */,
+      true /* enable segment label */,
+      true /* enable adj labels */);
+
+  std::unordered_map<std::string, LinkState> areaLinkStates;
+  areaLinkStates.emplace(kTestingAreaName, LinkState(kTestingAreaName));
+  auto& linkState = areaLinkStates.at(kTestingAreaName);
+  PrefixState prefixState;
+
+  linkState.updateAdjacencyDatabase(createAdjDb("1", {adj12}, 1));
+  linkState.updateAdjacencyDatabase(
+      createAdjDb("2", {adj21, adj23, adj24}, 2));
+  linkState.updateAdjacencyDatabase(createAdjDb("3", {adj32, adj34}, 3));
+  linkState.updateAdjacencyDatabase(createAdjDb("4", {adj42, adj43}, 4));
+  for (auto const& prefixDb : {prefixDb1, prefixDb2, prefixDb3, prefixDb4}) {
+    EXPECT_FALSE(updatePrefixDatabase(prefixState, prefixDb).empty());
+  }
+
+  // nothing to compare with before routes are built
+  EXPECT_FALSE(spfSolver
+                   .getPrefixesAffectedByTopology(
+                       "1", areaLinkStates, prefixState)
+                   .has_value());
+  spfSolver.updateRoutedTopology("1", areaLinkStates);
+  auto prefixes =
+      spfSolver.getPrefixesAffectedByTopology("1", areaLinkStates, prefixState);
+  ASSERT_TRUE(prefixes.has_value());
+  EXPECT_TRUE(prefixes->empty());
+
+  // 2---4 goes down, only the distance towards 4 changes
+  linkState.updateAdjacencyDatabase(createAdjDb("2", {adj21, adj23}, 2));
+  prefixes =
+      spfSolver.getPrefixesAffectedByTopology("1", areaLinkStates, prefixState);
+  ASSERT_TRUE(prefixes.has_value());
+  EXPECT_THAT(*prefixes, testing::UnorderedElementsAre(toIPNetwork(addr4)));
+  spfSolver.updateRoutedTopology("1", areaLinkStates);
+
+  // drained 3 is no longer transit node towards 4
+  linkState.updateAdjacencyDatabase(
+      createAdjDb("3", {adj32, adj34}, 3, true /* overloaded */));
+  prefixes =
+      spfSolver.getPrefixesAffectedByTopology("1", areaLinkStates, prefixState);
+  ASSERT_TRUE(prefixes.has_value());
+  EXPECT_THAT(
+      *prefixes,
+      testing::UnorderedElementsAre(toIPNetwork(addr3), toIPNetwork(addr4)));
+  spfSolver.updateRoutedTopology("1", areaLinkStates);
+
+  // metric change of local link requires to rebuild all routes
+  auto adj12Metric20 = adj12;
+  adj12Metric20.metric_ref() = 20;
+  linkState.updateAdjacencyDatabase(createAdjDb("1", {adj12Metric20}, 1));
+  EXPECT_FALSE(spfSolver
+                   .getPrefixesAffectedByTopology(
+                       "1", areaLinkStates, prefixState)
+                   .has_value());
+}
+
+//
+// Verify best route selections are kept across route builds unless prefix
+// entries or state of advertising nodes changed
+//
+TEST(SpfSolver, BestRoutesCacheInvalidation) {
+  auto config = std::make_shared<Config>(createConfig());
+  SpfSolver spfSolver(
+      config,
+      "1",
+      false /* disable v4 */,
+      false /* disable segment label */,
+      false /* disable adj labels */);
+
+  std::unordered_map<std::string, LinkState> areaLinkStates;
+  areaLinkStates.emplace(kTestingAreaName, LinkState(kTestingAreaName));
+  auto& linkState = areaLinkStates.at(kTestingAreaName);
+  PrefixState prefixState;
+
+  linkState.updateAdjacencyDatabase(createAdjDb("1", {adj12, adj13}, 1));
+  linkState.updateAdjacencyDatabase(createAdjDb("2", {adj21}, 2));
+  linkState.updateAdjacencyDatabase(createAdjDb("3", {adj31}, 3));
+  for (auto const& prefixDb : {prefixDb1, prefixDb2, prefixDb3}) {
+    EXPECT_FALSE(updatePrefixDatabase(prefixState, prefixDb).empty());
+  }
+
+  auto getCacheHits = []() {
+    auto counters = fb303::fbData->getCounters();
+    return counters["decision.best_routes_cache_hit.count"];
+  };
+  auto buildRoutes = [&](std::string const& node) {
+    const auto cacheHits = getCacheHits();
+    auto routeDb = spfSolver.buildRouteDb(node, areaLinkStates, prefixState);
+    EXPECT_TRUE(routeDb.has_value());
+    return getCacheHits() - cacheHits;
+  };
+
+  EXPECT_EQ(0, buildRoutes("1"));
+  EXPECT_EQ(3, spfSolver.getBestRoutesCache().size());
+  // nothing changed
+  EXPECT_EQ(3, buildRoutes("1"));
+
+  // prefix entry of addr2 changed
+  EXPECT_FALSE(updatePrefixDatabase(
+                   prefixState,
+                   createPrefixDb(
+                       "2",
+                       {createPrefixEntryWithMetrics(
+                           addr2,
+                           thrift::PrefixType::DEFAULT,
+                           createMetrics(200, 0, 0))}))
+                   .empty());
+  EXPECT_EQ(2, buildRoutes("1"));
+
+  // drained node 3 invalidates selection of addr3 only
+  linkState.updateAdjacencyDatabase(
+      createAdjDb("3", {adj31}, 3, true /* overloaded */));
+  EXPECT_EQ(2, buildRoutes("1"));
+
+  // routes of other nodes neither use nor update the cache
+  EXPECT_EQ(0, buildRoutes("2"));
+  EXPECT_EQ(3, spfSolver.getBestRoutesCache().size());
+  EXPECT_EQ(
+      "1",
+      spfSolver.getBestRoutesCache().at(toIPNetwork(addr1)).bestNodeArea.first);
+
+  // withdrawn prefix is dropped from the cache
+  EXPECT_FALSE(
+      updatePrefixDatabase(prefixState, createPrefixDb("3", {})).empty());
+  EXPECT_EQ(2, buildRoutes("1"));
+  EXPECT_EQ(2, spfSolver.getBestRoutesCache().size());
+  EXPECT_EQ(0, spfSolver.getBestRoutesCache().count(toIPNetwork(addr3)));
+}
+
+//
+// Verify loop-free alternates are attached as backup next-hops
+//
+//    10      10
+//  1------2------4
+//  |             |
+//  +------3------+
+//    10      20
+//
+TEST(SpfSolver, LoopFreeAlternates) {
+  auto tConfig = createConfig();
+  tConfig.decision_config_ref()->enable_lfa_ref() = true;
+  auto config = std::make_shared<Config>(tConfig);
+  SpfSolver spfSolver(
+      config,
+      "1",
+      false /* disable v4 */,
+      false /* disable segment label */,
+      false /* disable adj labels */);
+
+  std::unordered_map<std::string, LinkState> areaLinkStates;
+  areaLinkStates.emplace(kTestingAreaName, LinkState(kTestingAreaName));
+  auto& linkState = areaLinkStates.at(kTestingAreaName);
+  PrefixState prefixState;
+
+  auto adj34Metric20 = adj34;
+  adj34Metric20.metric_ref() = 20;
+  auto adj43Metric20 = adj43;
+  adj43Metric20.metric_ref() = 20;
+  linkState.updateAdjacencyDatabase(createAdjDb("1", {adj12, adj13}, 1));
+  linkState.updateAdjacencyDatabase(createAdjDb("2", {adj21, adj24}, 2));
+  linkState.updateAdjacencyDatabase(
+      createAdjDb("3", {adj31, adj34Metric20}, 3));
+  linkState.updateAdjacencyDatabase(
+      createAdjDb("4", {adj42, adj43Metric20}, 4));
+  for (auto const& prefixDb : {prefixDb2, prefixDb3, prefixDb4}) {
+    EXPECT_FALSE(updatePrefixDatabase(prefixState, prefixDb).empty());
+  }
+
+  auto routeDb = spfSolver.buildRouteDb("1", areaLinkStates, prefixState);
+  ASSERT_TRUE(routeDb.has_value());
+  auto const& routes = routeDb->unicastRoutes;
+
+  // 3 doesn't loop traffic towards 4 back, 4 is 20 away from it
+  ASSERT_EQ(1, routes.count(toIPNetwork(addr4)));
+  EXPECT_THAT(
+      routes.at(toIPNetwork(addr4)).nexthops,
+      testing::UnorderedElementsAre(
+          createNextHopFromAdj(adj12, false, 20, std::nullopt)));
+  EXPECT_THAT(
+      routes.at(toIPNetwork(addr4)).backupNexthops,
+      testing::UnorderedElementsAre(
+          createNextHopFromAdj(adj13, false, 30, std::nullopt)));
+
+  // 3 reaches 2 over 1, i.e. it isn't a loop-free alternate
+  ASSERT_EQ(1, routes.count(toIPNetwork(addr2)));
+  EXPECT_TRUE(routes.at(toIPNetwork(addr2)).backupNexthops.empty());
+
+  // alternates are exposed in route details
+  auto detail = routes.at(toIPNetwork(addr4)).toThriftDetail();
+  EXPECT_EQ(1, detail.backupNextHops_ref()->size());
+}
+
+/**
+ * Verifies static routes merged as overlay below computed routes only show
+ * up in the delta when they change what is in the route db
+ */
+TEST(DecisionRouteDb, StaticRoutesOverlay) {
+  const auto staticPrefix = toIPNetwork(addr1);
+  const auto sharedPrefix = toIPNetwork(addr2);
+  const auto nh1 = createNextHop(toBinaryAddress("fe80::1"));
+  const auto nh2 = createNextHop(toBinaryAddress("fe80::2"));
+
+  StaticUnicastRoutes staticRoutes;
+  staticRoutes.emplace(staticPrefix, RibUnicastEntry(staticPrefix, {nh1}));
+  staticRoutes.emplace(sharedPrefix, RibUnicastEntry(sharedPrefix, {nh1}));
+  StaticMplsRoutes staticMplsRoutes;
+  staticMplsRoutes.emplace(100, RibMplsEntry(100, {nh1}));
+
+  // computed route has precedence over static one
+  DecisionRouteDb routeDb;
+  DecisionRouteDb computedDb;
+  computedDb.addUnicastRoute(RibUnicastEntry(sharedPrefix, {nh2}));
+  auto update = routeDb.calculateUpdate(
+      DecisionRouteDb(computedDb), &staticRoutes, &staticMplsRoutes);
+  EXPECT_EQ(2, update.unicastRoutesToUpdate.size());
+  EXPECT_EQ(
+      RibUnicastEntry(sharedPrefix, {nh2}),
+      update.unicastRoutesToUpdate.at(sharedPrefix));
+  EXPECT_EQ(1, update.mplsRoutesToUpdate.size());
+  routeDb.update(update);
+
+  // resident static routes are left as they are
+  update = routeDb.calculateUpdate(
+      DecisionRouteDb(computedDb), &staticRoutes, &staticMplsRoutes);
+  EXPECT_TRUE(update.empty());
+
+  // static route takes over withdrawn computed route
+  update = routeDb.calculateUpdate(
+      DecisionRouteDb(), &staticRoutes, &staticMplsRoutes);
+  EXPECT_TRUE(update.unicastRoutesToDelete.empty());
+  EXPECT_EQ(1, update.unicastRoutesToUpdate.size());
+  EXPECT_EQ(
+      staticRoutes.at(sharedPrefix),
+      update.unicastRoutesToUpdate.at(sharedPrefix));
+  routeDb.update(update);
+
+  // withdrawn static routes are deleted
+  staticRoutes.erase(staticPrefix);
+  staticMplsRoutes.clear();
+  update = routeDb.calculateUpdate(
+      DecisionRouteDb(), &staticRoutes, &staticMplsRoutes);
+  EXPECT_THAT(
+      update.unicastRoutesToDelete, testing::ElementsAre(staticPrefix));
+  EXPECT_THAT(update.mplsRoutesToDelete, testing::ElementsAre(100));
+  EXPECT_TRUE(update.unicastRoutesToUpdate.empty());
+}
+
 TEST(BGPRedistribution, BasicOperation) {
   auto config = std::make_shared<Config>(createConfig());
   std::string nodeName("1");
@@ -2436,7 +2772,7 @@ TEST_P(SimpleRingTopologyFixture, IpToMplsLabelPrepend) {
   std::unordered_set<thrift::NextHopThrift> staticNextHops{
       createNextHop(nh1Addr, std::nullopt, 0, phpAction),
       createNextHop(nh2Addr, std::nullopt, 0, phpAction)};
-  std::unordered_map<int32_t, RibMplsEntry> mplsRoutesToUpdate{
+  RibMplsEntries mplsRoutesToUpdate{
       {prependLabel, RibMplsEntry(prependLabel, staticNextHops)}};
   spfSolver->updateStaticMplsRoutes(mplsRoutesToUpdate, {});
 
@@ -2474,6 +2810,120 @@ TEST_P(SimpleRingTopologyFixture, IpToMplsLabelPrepend) {
            createNextHop(nh2Addr, std::nullopt, 0, std::nullopt)}));
 }
 
+//
+// Validate KSP2_ED_ECMP routes computed on SPF thread pool are the same as
+// the ones computed serially
+//
+TEST_P(SimpleRingTopologyFixture, Ksp2EdEcmpParallelSpf) {
+  CustomSetUp(
+      true /* multipath - ignored */,
+      true /* useKsp2Ed */,
+      true /* enable node segment label */,
+      true /* enable adj labels */,
+      std::get<1>(GetParam()));
+  // fresh copy without memoized paths
+  auto parallelAreaLinkStates = areaLinkStates;
+
+  auto tConfig = createConfig();
+  tConfig.decision_config_ref()->spf_threads_ref() = 4;
+  SpfSolver parallelSpfSolver(
+      std::make_shared<Config>(tConfig),
+      "1",
+      v4Enabled,
+      true /* enable node segment label */,
+      true /* enable adj labels */,
+      true /* multipath - ignored */);
+
+  for (auto const& node : {"1", "2", "3", "4"}) {
+    auto routeDb = spfSolver->buildRouteDb(node, areaLinkStates, prefixState);
+    auto parallelRouteDb = parallelSpfSolver.buildRouteDb(
+        node, parallelAreaLinkStates, prefixState);
+    ASSERT_TRUE(routeDb.has_value());
+    ASSERT_TRUE(parallelRouteDb.has_value());
+    EXPECT_FALSE(routeDb->unicastRoutes.empty());
+    EXPECT_TRUE(routeDb->calculateUpdate(std::move(*parallelRouteDb)).empty())
+        << node;
+
+    // best route selections merged from all shards
+    auto const& bestRoutes = spfSolver->getBestRoutesCache();
+    auto const& parallelBestRoutes = parallelSpfSolver.getBestRoutesCache();
+    EXPECT_EQ(bestRoutes.size(), parallelBestRoutes.size()) << node;
+    for (auto const& [prefix, result] : bestRoutes) {
+      ASSERT_TRUE(parallelBestRoutes.count(prefix)) << node;
+      auto const& parallelResult = parallelBestRoutes.at(prefix);
+      EXPECT_EQ(result.allNodeAreas, parallelResult.allNodeAreas);
+      EXPECT_EQ(result.bestNodeArea, parallelResult.bestNodeArea);
+    }
+  }
+}
+
+/**
+ * Delta built along with routes matches the one of diffing whole route dbs,
+ * with and without sharding route building
+ */
+TEST_P(SimpleRingTopologyFixture, RouteDbDelta) {
+  CustomSetUp(
+      false /* multipath */,
+      false /* useKsp2Ed */,
+      true /* enable node segment label */,
+      true /* enable adj labels */,
+      std::get<1>(GetParam()));
+
+  auto tConfig = createConfig();
+  tConfig.decision_config_ref()->spf_threads_ref() = 4;
+  SpfSolver parallelSpfSolver(
+      std::make_shared<Config>(tConfig),
+      "1",
+      v4Enabled,
+      true /* enable node segment label */,
+      true /* enable adj labels */);
+
+  // static route overlaid, and stale route of a withdrawn prefix
+  const auto staticPrefix = toIPNetwork(toIpPrefix("10.99.1.0/24"));
+  const auto stalePrefix = toIPNetwork(toIpPrefix("10.99.2.0/24"));
+  const auto nh = createNextHop(toBinaryAddress("fe80::1"));
+  RibUnicastEntries staticRoutes;
+  staticRoutes.emplace(staticPrefix, RibUnicastEntry(staticPrefix, {nh}));
+
+  for (auto* solver : {spfSolver.get(), &parallelSpfSolver}) {
+    solver->updateStaticUnicastRoutes(staticRoutes, {});
+
+    // routes as computed by another node, differ from the ones of node 1
+    auto prevDb =
+        solver->buildRouteDb("2", areaLinkStates, prefixState, false);
+    ASSERT_TRUE(prevDb.has_value());
+    prevDb->addUnicastRoute(RibUnicastEntry(stalePrefix, {nh}));
+
+    auto routeDb =
+        solver->buildRouteDb("1", areaLinkStates, prefixState, false);
+    ASSERT_TRUE(routeDb.has_value());
+    auto expected = prevDb->calculateUpdate(
+        std::move(*routeDb),
+        &solver->getStaticUnicastRoutes(),
+        &solver->getStaticMplsRoutes());
+    auto delta =
+        solver->buildRouteDbDelta("1", areaLinkStates, prefixState, *prevDb);
+    ASSERT_TRUE(delta.has_value());
+    EXPECT_FALSE(delta->empty());
+
+    EXPECT_EQ(expected.unicastRoutesToUpdate, delta->unicastRoutesToUpdate);
+    EXPECT_THAT(
+        delta->unicastRoutesToDelete,
+        testing::UnorderedElementsAreArray(expected.unicastRoutesToDelete));
+    EXPECT_EQ(expected.mplsRoutesToUpdate, delta->mplsRoutesToUpdate);
+    EXPECT_THAT(
+        delta->mplsRoutesToDelete,
+        testing::UnorderedElementsAreArray(expected.mplsRoutesToDelete));
+
+    // nothing changes against the db the delta was applied to
+    prevDb->update(*delta);
+    delta =
+        solver->buildRouteDbDelta("1", areaLinkStates, prefixState, *prevDb);
+    ASSERT_TRUE(delta.has_value());
+    EXPECT_TRUE(delta->empty());
+  }
+}
+
 //
 // Validate KSP2_ED_ECMP routes on SimpleRingTopology
 //
@@ -2683,6 +3133,40 @@ TEST_P(SimpleRingTopologyFixture, Ksp2EdEcmp) {
       routeMap.end());
 }
 
+/**
+ * KSP2_ED_ECMP label stacks cached along with paths follow node label changes
+ */
+TEST_P(SimpleRingTopologyFixture, Ksp2EdEcmpNodeLabelChange) {
+  CustomSetUp(
+      true /* multipath - ignored */,
+      true /* useKsp2Ed */,
+      true /* enable node segment label */,
+      true /* enable adj labels */,
+      std::get<1>(GetParam()));
+  auto pushCode = thrift::MplsActionCode::PUSH;
+  auto routeMap = getRouteMap(*spfSolver, {"1"}, areaLinkStates, prefixState);
+  auto push4 =
+      createMplsAction(pushCode, std::nullopt, std::vector<int32_t>{4});
+  EXPECT_EQ(
+      routeMap[make_pair("1", toString(v4Enabled ? addr4V4 : addr4))],
+      NextHops(
+          {createNextHopFromAdj(adj12, v4Enabled, 20, push4),
+           createNextHopFromAdj(adj13, v4Enabled, 20, push4)}));
+
+  // new node label of node 4 is pushed by rebuilt routes
+  adjacencyDb4.nodeLabel_ref() = 44;
+  auto& linkState = areaLinkStates.at(kTestingAreaName);
+  EXPECT_TRUE(linkState.updateAdjacencyDatabase(adjacencyDb4).nodeLabelChanged);
+  routeMap = getRouteMap(*spfSolver, {"1"}, areaLinkStates, prefixState);
+  auto push44 =
+      createMplsAction(pushCode, std::nullopt, std::vector<int32_t>{44});
+  EXPECT_EQ(
+      routeMap[make_pair("1", toString(v4Enabled ? addr4V4 : addr4))],
+      NextHops(
+          {createNextHopFromAdj(adj12, v4Enabled, 20, push44),
+           createNextHopFromAdj(adj13, v4Enabled, 20, push44)}));
+}
+
 TEST_P(SimpleRingTopologyFixture, Ksp2EdEcmpForBGP) {
   CustomSetUp(
       true /* multipath - ignored */,
@@ -5105,6 +5589,28 @@ TEST_F(DecisionTestFixture, PrefixKeyBackwardCompatibility) {
   }
 }
 
+/**
+ * Verify prefixes of expired prefix keys are withdrawn as carried by the last
+ * value of the key, if present, rather than decoded from the key
+ */
+TEST_F(DecisionTestFixture, ExpiredPrefixKeyVals) {
+  // key name doesn't decode to node and prefix
+  const std::string opaqueKey{"prefix:2:opaque"};
+  auto value = createPrefixKeyValue("2", 1, addr1).second;
+  auto publication = createThriftPublication(
+      {{"adj:1", createAdjValue("1", 1, {adj12}, false, 1)},
+       {"adj:2", createAdjValue("2", 1, {adj21}, false, 2)},
+       {opaqueKey, value}},
+      {});
+  sendKvPublication(publication);
+  verifyReceivedRoutes(toIPNetwork(addr1), false);
+
+  publication = createThriftPublication({}, {opaqueKey});
+  publication.expiredKeyVals_ref() = thrift::KeyVals{{opaqueKey, value}};
+  sendKvPublication(publication);
+  verifyReceivedRoutes(toIPNetwork(addr1), true);
+}
+
 // The following topology is used:
 //
 // 1---2---3
@@ -5418,6 +5924,99 @@ TEST_F(DecisionTestFixture, BasicOperations) {
  * - Prefixes
  * - MPLS Static routes
  */
+//
+// Adjacencies advertised with one key per adjacency are merged into the
+// adjacency database of the node
+//
+TEST_F(DecisionTestFixture, PerAdjacencyKeys) {
+  auto adjKey = [](std::string const& node, thrift::Adjacency const& adj) {
+    return getAdjacencyKey(node, *adj.otherNodeName_ref(), *adj.ifName_ref());
+  };
+
+  auto publication = createThriftPublication(
+      {{adjKey("1", adj12), createAdjValue("1", 1, {adj12}, false, 1)},
+       {adjKey("2", adj21), createAdjValue("2", 1, {adj21}, false, 2)},
+       createPrefixKeyValue("1", 1, addr1),
+       createPrefixKeyValue("2", 1, addr2)},
+      {},
+      {},
+      {},
+      std::string(""));
+  sendKvPublication(publication);
+  auto routeDbDelta = recvRouteUpdates();
+  EXPECT_EQ(1, routeDbDelta.unicastRoutesToUpdate.size());
+
+  // new adjacency of node 2 does not replace existing one
+  publication = createThriftPublication(
+      {{adjKey("2", adj23), createAdjValue("2", 1, {adj23}, false, 2)},
+       {adjKey("3", adj32), createAdjValue("3", 1, {adj32}, false, 3)},
+       createPrefixKeyValue("3", 1, addr3)},
+      {},
+      {},
+      {},
+      std::string(""));
+  sendKvPublication(publication);
+  routeDbDelta = recvRouteUpdates();
+  ASSERT_EQ(1, routeDbDelta.unicastRoutesToUpdate.size());
+  EXPECT_EQ(
+      routeDbDelta.unicastRoutesToUpdate.begin()->second.prefix,
+      toIPNetwork(addr3));
+  EXPECT_EQ(0, routeDbDelta.unicastRoutesToDelete.size());
+
+  // withdraw adjacency 2 -> 1, node 2 and 3 become unreachable
+  publication = createThriftPublication(
+      {{adjKey("2", adj21), createAdjValue("2", 2, {}, false, 2)}},
+      {},
+      {},
+      {},
+      std::string(""));
+  sendKvPublication(publication);
+  routeDbDelta = recvRouteUpdates();
+  EXPECT_EQ(0, routeDbDelta.unicastRoutesToUpdate.size());
+  EXPECT_EQ(2, routeDbDelta.unicastRoutesToDelete.size());
+}
+
+//
+// Prefixes advertised in bucket keys of prefix database are withdrawn once
+// dropped from their bucket, or once the bucket key expires
+//
+TEST_F(DecisionTestFixture, PrefixDbBucketKeys) {
+  const auto bucketKey = getPrefixDbBucketKey("2", 0);
+  auto publication = createThriftPublication(
+      {{"adj:1", createAdjValue("1", 1, {adj12}, false, 1)},
+       {"adj:2", createAdjValue("2", 1, {adj21}, false, 2)},
+       createPrefixKeyValue("1", 1, addr1),
+       {bucketKey, createPrefixValue("2", 1, {addr2, addr3})}},
+      {},
+      {},
+      {},
+      std::string(""));
+  sendKvPublication(publication);
+  auto routeDbDelta = recvRouteUpdates();
+  EXPECT_EQ(2, routeDbDelta.unicastRoutesToUpdate.size());
+
+  // addr3 dropped from the bucket
+  publication = createThriftPublication(
+      {{bucketKey, createPrefixValue("2", 2, {addr2})}},
+      {},
+      {},
+      {},
+      std::string(""));
+  sendKvPublication(publication);
+  routeDbDelta = recvRouteUpdates();
+  EXPECT_EQ(0, routeDbDelta.unicastRoutesToUpdate.size());
+  ASSERT_EQ(1, routeDbDelta.unicastRoutesToDelete.size());
+  EXPECT_EQ(toIPNetwork(addr3), routeDbDelta.unicastRoutesToDelete.front());
+
+  // bucket key expired
+  publication =
+      createThriftPublication({}, {bucketKey}, {}, {}, std::string(""));
+  sendKvPublication(publication);
+  routeDbDelta = recvRouteUpdates();
+  ASSERT_EQ(1, routeDbDelta.unicastRoutesToDelete.size());
+  EXPECT_EQ(toIPNetwork(addr2), routeDbDelta.unicastRoutesToDelete.front());
+}
+
 TEST_F(DecisionTestFixture, InitialRouteUpdate) {
   // Send adj publication
   sendKvPublication(
@@ -6238,6 +6837,140 @@ TEST(Decision, RibPolicyFeatureKnob) {
   routeUpdatesQueue.close();
 }
 
+/**
+ * Verify own routeDb is published as immutable snapshot. Snapshot held by a
+ * reader is left as is by later route updates, which are applied to a copy.
+ */
+TEST_F(DecisionTestFixture, RouteDbSnapshot) {
+  auto snapshot = decision->getDecisionRouteDbSnapshot();
+  ASSERT_NE(nullptr, snapshot);
+  EXPECT_THAT(snapshot->unicastRoutes, testing::IsEmpty());
+
+  auto publication = createThriftPublication(
+      {{"adj:1", createAdjValue("1", 1, {adj12}, false, 1)},
+       {"adj:2", createAdjValue("2", 1, {adj21}, false, 2)},
+       createPrefixKeyValue("1", 1, addr1),
+       createPrefixKeyValue("2", 1, addr2)},
+      {},
+      {},
+      {},
+      std::string(""));
+  sendKvPublication(publication);
+  recvRouteUpdates();
+
+  EXPECT_THAT(snapshot->unicastRoutes, testing::IsEmpty());
+  EXPECT_EQ(
+      1,
+      fb303::fbData->getCounters().at(
+          "decision.route_db_snapshot_copies.count"));
+
+  auto newSnapshot = decision->getDecisionRouteDbSnapshot();
+  EXPECT_NE(snapshot, newSnapshot);
+  EXPECT_EQ(1, newSnapshot->unicastRoutes.size());
+  EXPECT_EQ(1, newSnapshot->unicastRoutes.count(addr2Cidr));
+
+  // own routeDb is served from the snapshot
+  auto routeDb = dumpRouteDb({"1"})["1"];
+  EXPECT_EQ(1, routeDb.unicastRoutes_ref()->size());
+  EXPECT_EQ(newSnapshot->mplsRoutes.size(), routeDb.mplsRoutes_ref()->size());
+}
+
+/**
+ * Verify routeDb of other nodes is cached until link or prefix state changes
+ */
+TEST_F(DecisionTestFixture, ComputedRouteDbCache) {
+  auto publication = createThriftPublication(
+      {{"adj:1", createAdjValue("1", 1, {adj12}, false, 1)},
+       {"adj:2", createAdjValue("2", 1, {adj21}, false, 2)},
+       createPrefixKeyValue("1", 1, addr1),
+       createPrefixKeyValue("2", 1, addr2)},
+      {},
+      {},
+      {},
+      std::string(""));
+  sendKvPublication(publication);
+  recvRouteUpdates();
+
+  auto getCacheHits = []() {
+    return fb303::fbData->getCounters().at(
+        "decision.computed_route_db_cache_hits.count");
+  };
+  const auto cacheHits = getCacheHits();
+  auto routeDb = dumpRouteDb({"2"})["2"];
+  EXPECT_EQ("2", *routeDb.thisNodeName_ref());
+  EXPECT_EQ(1, routeDb.unicastRoutes_ref()->size());
+  EXPECT_EQ(routeDb, dumpRouteDb({"2"})["2"]);
+  EXPECT_EQ(cacheHits + 1, getCacheHits());
+
+  // new prefix of node 1 is reflected in routes of node 2. Prefix of node 2
+  // makes own routes change, i.e. routes are rebuilt.
+  publication = createThriftPublication(
+      {createPrefixKeyValue("1", 1, addr3),
+       createPrefixKeyValue("2", 1, addr4)},
+      {},
+      {},
+      {},
+      std::string(""));
+  sendKvPublication(publication);
+  recvRouteUpdates();
+
+  routeDb = dumpRouteDb({"2"})["2"];
+  EXPECT_EQ(2, routeDb.unicastRoutes_ref()->size());
+  EXPECT_EQ(cacheHits + 1, getCacheHits());
+}
+
+/**
+ * Verifies simulated topology changes yield the route delta without changing
+ * programmed routes
+ */
+TEST_F(DecisionTestFixture, RouteDbSimulated) {
+  auto publication = createThriftPublication(
+      {{"adj:1", createAdjValue("1", 1, {adj12}, false, 1)},
+       {"adj:2", createAdjValue("2", 1, {adj21, adj23}, false, 2)},
+       {"adj:3", createAdjValue("3", 1, {adj32}, false, 3)},
+       createPrefixKeyValue("1", 1, addr1),
+       createPrefixKeyValue("2", 1, addr2),
+       createPrefixKeyValue("3", 1, addr3)},
+      {},
+      {},
+      {},
+      std::string(""));
+  sendKvPublication(publication);
+  recvRouteUpdates();
+  auto routeDb = decision->getDecisionRouteDbSnapshot();
+  ASSERT_EQ(2, routeDb->unicastRoutes.size());
+
+  // no change
+  auto delta = decision->getRouteDbSimulated({}).get();
+  EXPECT_THAT(*delta->unicastRoutesToUpdate_ref(), testing::IsEmpty());
+  EXPECT_THAT(*delta->unicastRoutesToDelete_ref(), testing::IsEmpty());
+
+  // drained node 2 is no transit to node 3
+  thrift::RouteSimulationRequest request;
+  request.drainNodes_ref()->emplace("2");
+  delta = decision->getRouteDbSimulated(request).get();
+  EXPECT_THAT(*delta->unicastRoutesToUpdate_ref(), testing::IsEmpty());
+  EXPECT_THAT(
+      *delta->unicastRoutesToDelete_ref(), testing::ElementsAre(addr3));
+
+  // down node 2 takes all routes with it
+  request = thrift::RouteSimulationRequest();
+  request.downNodes_ref()->emplace("2");
+  delta = decision->getRouteDbSimulated(request).get();
+  EXPECT_THAT(
+      *delta->unicastRoutesToDelete_ref(),
+      testing::UnorderedElementsAre(addr2, addr3));
+
+  // unknown node
+  request = thrift::RouteSimulationRequest();
+  request.drainNodes_ref()->emplace("4");
+  EXPECT_THROW(
+      decision->getRouteDbSimulated(request).get(), thrift::OpenrError);
+
+  // programmed routes are untouched
+  EXPECT_EQ(routeDb, decision->getDecisionRouteDbSnapshot());
+}
+
 // The following topology is used:
 //
 //         100
@@ -6384,6 +7117,8 @@ TEST_F(DecisionTestFixture, PubDebouncing) {
   counters = fb303::fbData->getCounters();
   EXPECT_EQ(1, counters["decision.spf_runs.count"]);
   EXPECT_EQ(1, counters["decision.route_build_runs.count"]);
+  auto getRouteForPrefixCount =
+      counters.at("decision.get_route_for_prefix.count");
 
   //
   // publish the link state info to KvStore via the KvStore pub socket
@@ -6419,13 +7154,17 @@ TEST_F(DecisionTestFixture, PubDebouncing) {
 
   counters = fb303::fbData->getCounters();
   EXPECT_EQ(2, counters["decision.spf_runs.count"]);
-  EXPECT_EQ(2, counters["decision.route_build_runs.count"]);
+  // local links and shortest paths towards 2 are unchanged, route of addr3
+  // advertised by new node 3 is the only one built
+  EXPECT_EQ(1, counters["decision.route_build_runs.count"]);
+  EXPECT_EQ(
+      getRouteForPrefixCount + 1,
+      counters["decision.get_route_for_prefix.count"]);
 
   //
   // Only publish prefix updates
   //
-  auto getRouteForPrefixCount =
-      counters.at("decision.get_route_for_prefix.count");
+  getRouteForPrefixCount = counters.at("decision.get_route_for_prefix.count");
   publication = createThriftPublication(
       {createPrefixKeyValue("4", 1, addr4)}, {}, {}, {}, std::string(""));
   sendKvPublication(publication);
@@ -6434,7 +7173,7 @@ TEST_F(DecisionTestFixture, PubDebouncing) {
   counters = fb303::fbData->getCounters();
   EXPECT_EQ(2, counters["decision.spf_runs.count"]);
   // only prefix changed no full rebuild needed
-  EXPECT_EQ(2, counters["decision.route_build_runs.count"]);
+  EXPECT_EQ(1, counters["decision.route_build_runs.count"]);
 
   EXPECT_EQ(
       getRouteForPrefixCount + 1,
@@ -6466,7 +7205,8 @@ TEST_F(DecisionTestFixture, PubDebouncing) {
 
   counters = fb303::fbData->getCounters();
   EXPECT_EQ(3, counters["decision.spf_runs.count"]);
-  EXPECT_EQ(3, counters["decision.route_build_runs.count"]);
+  // nodes 3 and 4 got unreachable, only routes of their prefixes are built
+  EXPECT_EQ(1, counters["decision.route_build_runs.count"]);
 
   //
   // publish multiple prefix updates in a row
@@ -6895,7 +7635,12 @@ TEST_F(DecisionTestFixture, DecisionSubReliability) {
   auto counters = fb303::fbData->getCounters();
   EXPECT_EQ(1, counters["decision.spf_runs.count"]);
   EXPECT_EQ(adjUpdateCnt, counters["decision.adj_db_update.count"]);
-  EXPECT_EQ(prefixUpdateCnt, counters["decision.prefix_db_update.count"]);
+  // values superseded within debounce window are never deserialized
+  EXPECT_EQ(
+      prefixUpdateCnt,
+      counters["decision.prefix_db_update.count"] +
+          counters["decision.superseded_key_vals.count"]);
+  EXPECT_LT(0, counters["decision.superseded_key_vals.count"]);
 }
 
 //
@@ -7028,6 +7773,128 @@ TEST_F(DecisionTestFixture, ExceedMaxBackoff) {
   sendKvPublication(publication);
 }
 
+// DecisionTestFixture with urgent rebuild on local adjacency loss and debounce
+// long enough to tell urgent rebuilds from debounced ones
+class DecisionUrgentTestFixture : public DecisionTestFixture {
+ protected:
+  openr::thrift::OpenrConfig
+  createConfig() override {
+    auto tConfig = DecisionTestFixture::createConfig();
+    tConfig.decision_config_ref()->debounce_min_ms_ref() =
+        kDebounceTimeout.count();
+    tConfig.decision_config_ref()->debounce_max_ms_ref() =
+        kDebounceTimeout.count();
+    tConfig.decision_config_ref()->enable_urgent_local_adj_down_ref() = true;
+    return tConfig;
+  }
+
+  const std::chrono::milliseconds kDebounceTimeout{1000};
+};
+
+TEST_F(DecisionUrgentTestFixture, LocalAdjacencyDown) {
+  auto publication = createThriftPublication(
+      {{"adj:1", createAdjValue("1", 1, {adj12, adj13}, false, 1)},
+       {"adj:2", createAdjValue("2", 1, {adj21}, false, 2)},
+       {"adj:3", createAdjValue("3", 1, {adj31}, false, 3)},
+       createPrefixKeyValue("2", 1, addr2),
+       createPrefixKeyValue("3", 1, addr3)},
+      {},
+      {},
+      {},
+      std::string(""));
+  sendKvPublication(publication);
+  auto routeDbDelta = recvRouteUpdates();
+  EXPECT_EQ(2, routeDbDelta.unicastRoutesToUpdate.size());
+
+  // loss of local adjacency 1 -> 3 is not debounced
+  publication = createThriftPublication(
+      {{"adj:1", createAdjValue("1", 2, {adj12}, false, 1)}},
+      {},
+      {},
+      {},
+      std::string(""));
+  auto start = std::chrono::steady_clock::now();
+  sendKvPublication(publication);
+  routeDbDelta = recvRouteUpdates();
+  EXPECT_LT(std::chrono::steady_clock::now() - start, kDebounceTimeout);
+  EXPECT_THAT(
+      routeDbDelta.unicastRoutesToDelete,
+      testing::UnorderedElementsAre(toIPNetwork(addr3)));
+  EXPECT_EQ(
+      1,
+      fb303::fbData->getCounters().at("decision.urgent_route_rebuilds.count"));
+
+  // local adjacency coming back up is debounced
+  publication = createThriftPublication(
+      {{"adj:1", createAdjValue("1", 3, {adj12, adj13}, false, 1)}},
+      {},
+      {},
+      {},
+      std::string(""));
+  start = std::chrono::steady_clock::now();
+  sendKvPublication(publication);
+  routeDbDelta = recvRouteUpdates();
+  EXPECT_GE(std::chrono::steady_clock::now() - start, kDebounceTimeout / 2);
+  EXPECT_EQ(1, routeDbDelta.unicastRoutesToUpdate.count(toIPNetwork(addr3)));
+  EXPECT_EQ(
+      1,
+      fb303::fbData->getCounters().at("decision.urgent_route_rebuilds.count"));
+}
+
+class DecisionPipelinedIngestTestFixture : public DecisionTestFixture {
+ protected:
+  openr::thrift::OpenrConfig
+  createConfig() override {
+    auto tConfig = DecisionTestFixture::createConfig();
+    tConfig.decision_config_ref()->enable_pipelined_ingest_ref() = true;
+    return tConfig;
+  }
+};
+
+TEST_F(DecisionPipelinedIngestTestFixture, BasicOperations) {
+  auto publication = createThriftPublication(
+      {{"adj:1", createAdjValue("1", 1, {adj12, adj13}, false, 1)},
+       {"adj:2", createAdjValue("2", 1, {adj21}, false, 2)},
+       {"adj:3", createAdjValue("3", 1, {adj31}, false, 3)},
+       createPrefixKeyValue("2", 1, addr2),
+       createPrefixKeyValue("3", 1, addr3)},
+      {},
+      {},
+      {},
+      std::string(""));
+  sendKvPublication(publication);
+  auto routeDbDelta = recvRouteUpdates();
+  EXPECT_EQ(2, routeDbDelta.unicastRoutesToUpdate.size());
+
+  // burst of updates, newest value of a key wins
+  sendKvPublication(createThriftPublication(
+      {{"adj:1", createAdjValue("1", 2, {adj12}, false, 1)}},
+      {},
+      {},
+      {},
+      std::string("")));
+  sendKvPublication(createThriftPublication(
+      {{"adj:1", createAdjValue("1", 3, {adj12, adj13}, false, 1)}},
+      {},
+      {},
+      {},
+      std::string("")));
+  sendKvPublication(createThriftPublication(
+      {}, {"adj:3"}, {}, {}, std::string("")));
+  routeDbDelta = recvRouteUpdates();
+  EXPECT_THAT(
+      routeDbDelta.unicastRoutesToDelete,
+      testing::UnorderedElementsAre(toIPNetwork(addr3)));
+
+  auto routeDb = dumpRouteDb({"1"})["1"];
+  RouteMap routeMap;
+  fillRouteMap("1", routeMap, routeDb);
+  EXPECT_EQ(
+      routeMap[make_pair("1", toString(addr2))],
+      NextHops({createNextHopFromAdj(adj12, false, 10)}));
+  EXPECT_EQ(0, routeMap.count(make_pair("1", toString(addr3))));
+}
+
 // DecisionTestFixture with different enableBestRouteSelection_ input
 class EnableBestRouteSelectionFixture
     : public DecisionTestFixture,
@@ -7397,9 +8264,12 @@ TEST(DecisionPendingUpdates, needsFullRebuild) {
   linkStateChange.topologyChanged = true;
   updates.applyLinkStateChange("node2", linkStateChange, kEmptyPerfEventRef);
   EXPECT_TRUE(updates.needsRouteUpdate());
-  EXPECT_TRUE(updates.needsFullRebuild());
+  // routes of affected prefixes only are rebuilt
+  EXPECT_FALSE(updates.needsFullRebuild());
+  EXPECT_TRUE(updates.topologyChanged());
 
   updates.reset();
+  EXPECT_FALSE(updates.topologyChanged());
   linkStateChange.topologyChanged = false;
   linkStateChange.nodeLabelChanged = true;
   updates.applyLinkStateChange("node2", linkStateChange, kEmptyPerfEventRef);
@@ -5,6 +5,13 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <map>
+#include <random>
+#include <set>
+
+#include <fb303/ServiceData.h>
+#include <folly/Format.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -17,6 +24,52 @@
 
 using namespace testing;
 
+namespace {
+
+// adjacency database of node with given {neighbor -> metric}
+openr::thrift::AdjacencyDatabase
+createNodeAdjDb(
+    int node, std::map<int, int> const& adjMetrics, bool overloaded = false) {
+  std::vector<openr::thrift::Adjacency> adjs;
+  for (auto const& [adj, metric] : adjMetrics) {
+    adjs.emplace_back(openr::createAdjacency(
+        folly::sformat("{}", adj),
+        folly::sformat("{}/{}", node, adj),
+        folly::sformat("{}/{}", adj, node),
+        folly::sformat("fe80::{:x}", adj),
+        folly::sformat("10.0.{}.{}", adj / 256, adj % 256),
+        metric,
+        (node << 16) + adj));
+  }
+  return openr::createAdjDb(folly::sformat("{}", node), adjs, node, overloaded);
+}
+
+void
+expectSpfResultEq(
+    openr::LinkState::SpfResult const& expected,
+    openr::LinkState::SpfResult const& actual) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (auto const& [nodeName, nodeResult] : expected) {
+    auto it = actual.find(nodeName);
+    ASSERT_NE(actual.end(), it) << nodeName;
+    EXPECT_EQ(nodeResult.metric(), it->second.metric()) << nodeName;
+    EXPECT_EQ(nodeResult.nextHops(), it->second.nextHops()) << nodeName;
+    // path links are in no particular order
+    std::set<std::string> expectedPaths, actualPaths;
+    for (auto const& pathLink : nodeResult.pathLinks()) {
+      expectedPaths.emplace(
+          pathLink.link->directionalToString(pathLink.prevNode));
+    }
+    for (auto const& pathLink : it->second.pathLinks()) {
+      actualPaths.emplace(
+          pathLink.link->directionalToString(pathLink.prevNode));
+    }
+    EXPECT_EQ(expectedPaths, actualPaths) << nodeName;
+  }
+}
+
+} // namespace
+
 TEST(HoldableValueTest, BasicOperation) {
   openr::HoldableValue<bool> hv{true};
   EXPECT_TRUE(hv.value());
@@ -80,6 +133,41 @@ TEST(HoldableValueTest, BasicOperation) {
   EXPECT_EQ(5, hvLsm.value());
 }
 
+TEST(DijkstraQTest, DecreaseAndIncreaseKey) {
+  std::mt19937 gen(1);
+  openr::DijkstraQ q;
+  std::map<std::string, openr::LinkStateMetric> metrics;
+  for (int i = 0; i < 200; ++i) {
+    auto const nodeName = folly::sformat("node{}", i);
+    metrics[nodeName] = gen() % 50;
+    q.insertNode(nodeName, metrics.at(nodeName));
+  }
+  // change metric of random queued nodes in both directions
+  for (int i = 0; i < 1000; ++i) {
+    auto const nodeName = folly::sformat("node{}", gen() % 200);
+    auto node = q.get(nodeName);
+    ASSERT_NE(nullptr, node);
+    metrics[nodeName] = gen() % 50;
+    node->result.reset(metrics.at(nodeName));
+    q.update(*node);
+  }
+
+  // nodes come out in order of (metric, name)
+  std::set<std::pair<openr::LinkStateMetric, std::string>> expected;
+  for (auto const& [nodeName, metric] : metrics) {
+    expected.emplace(metric, nodeName);
+  }
+  for (auto const& [metric, nodeName] : expected) {
+    auto node = q.extractMin();
+    ASSERT_NE(nullptr, node);
+    EXPECT_EQ(nodeName, node->nodeName);
+    EXPECT_EQ(metric, node->result.metric());
+    EXPECT_EQ(nullptr, q.get(nodeName));
+  }
+  EXPECT_EQ(nullptr, q.extractMin());
+  EXPECT_EQ(0, q.size());
+}
+
 TEST(LinkTest, BasicOperation) {
   std::string n1 = "node1";
   auto adj1 =
@@ -174,6 +262,11 @@ TEST(LinkStateTest, BasicOperation) {
   EXPECT_THAT(
       state.linksFromNode(n3), UnorderedElementsAre(Pointee(l2), Pointee(l3)));
   EXPECT_THAT(state.linksFromNode("node4"), testing::IsEmpty());
+  for (auto const& node : {n1, n2, n3}) {
+    auto const& links = state.linksFromNode(node);
+    EXPECT_TRUE(std::is_sorted(
+        links.begin(), links.end(), openr::LinkState::LinkPtrLess{}));
+  }
 
   EXPECT_FALSE(state.isNodeOverloaded(n1));
   adjDb1.isOverloaded_ref() = true;
@@ -316,6 +409,306 @@ TEST(LinkStateTest, getKthPaths) {
   }
 }
 
+TEST(LinkStateTest, pathAPrefixOfPathB) {
+  auto l1 =
+      std::make_shared<openr::Link>(kTestingAreaName, "1", "1/2", "2", "2/1");
+  auto l2 =
+      std::make_shared<openr::Link>(kTestingAreaName, "2", "2/3", "3", "3/2");
+  openr::LinkState::Path p1, p2;
+
+  EXPECT_TRUE(openr::LinkState::pathAPrefixOfPathB(p1, p2));
+
+  p2.push_back(l1);
+  p2.push_back(l2);
+
+  EXPECT_TRUE(openr::LinkState::pathAPrefixOfPathB(p1, p2));
+  EXPECT_FALSE(openr::LinkState::pathAPrefixOfPathB(p2, p1));
+
+  p1.push_back(l1);
+
+  EXPECT_TRUE(openr::LinkState::pathAPrefixOfPathB(p1, p2));
+  EXPECT_FALSE(openr::LinkState::pathAPrefixOfPathB(p2, p1));
+
+  p1.push_back(l2);
+
+  EXPECT_TRUE(openr::LinkState::pathAPrefixOfPathB(p1, p2));
+  EXPECT_TRUE(openr::LinkState::pathAPrefixOfPathB(p2, p1));
+
+  p1.clear();
+  p1.push_back(l2);
+
+  EXPECT_FALSE(openr::LinkState::pathAPrefixOfPathB(p1, p2));
+}
+
+/*
+ * Second shortest paths of a random graph, computed by pruned SPF runs on
+ * demand and prefetched in batches. Verify both agree, are edge disjoint with
+ * first shortest paths and as short as SPF over graph without those links.
+ */
+TEST(LinkStateTest, KthPathsRandomGraph) {
+  const int kNumNodes = 40;
+  std::mt19937 gen(0x5eed);
+  auto randInt = [&gen](int lo, int hi) {
+    return std::uniform_int_distribution<int>(lo, hi)(gen);
+  };
+
+  // node -> {neighbor -> metric}, low metrics to get plenty of ECMP paths
+  std::map<int, std::map<int, int>> adjMetrics;
+  for (int node = 1; node < kNumNodes; ++node) {
+    auto other = randInt(0, node - 1);
+    adjMetrics[node][other] = randInt(1, 3);
+    adjMetrics[other][node] = randInt(1, 3);
+  }
+  for (int i = 0; i < 2 * kNumNodes; ++i) {
+    auto node1 = randInt(0, kNumNodes - 1);
+    auto node2 = randInt(0, kNumNodes - 1);
+    if (node1 != node2) {
+      adjMetrics[node1][node2] = randInt(1, 3);
+      adjMetrics[node2][node1] = randInt(1, 3);
+    }
+  }
+  auto getState = [](std::map<int, std::map<int, int>> const& metrics) {
+    openr::LinkState state{kTestingAreaName};
+    for (auto const& [node, nodeMetrics] : metrics) {
+      state.updateAdjacencyDatabase(createNodeAdjDb(node, nodeMetrics), 0, 0);
+    }
+    return state;
+  };
+  auto getPathMetric = [](openr::LinkState::Path const& path) {
+    std::string node = "0";
+    openr::LinkStateMetric metric = 0;
+    for (auto const& link : path) {
+      metric += link->getMetricFromNode(node);
+      node = link->getOtherNodeName(node);
+    }
+    return metric;
+  };
+
+  auto onDemandState = getState(adjMetrics);
+  auto prefetchState = getState(adjMetrics);
+  std::vector<std::string> dests;
+  for (int node = 1; node < kNumNodes; ++node) {
+    dests.emplace_back(folly::sformat("{}", node));
+  }
+  folly::CPUThreadPoolExecutor executor(4);
+  prefetchState.prefetchKthPaths("0", dests, &executor);
+
+  for (auto const& dest : dests) {
+    SCOPED_TRACE(dest);
+    auto const& firstPaths = onDemandState.getKthPaths("0", dest, 1);
+    auto const& secondPaths = onDemandState.getKthPaths("0", dest, 2);
+    auto const& prefetchedPaths = prefetchState.getKthPaths("0", dest, 2);
+    ASSERT_EQ(secondPaths.size(), prefetchedPaths.size());
+    for (size_t i = 0; i < secondPaths.size(); ++i) {
+      ASSERT_EQ(secondPaths.at(i).size(), prefetchedPaths.at(i).size());
+      for (size_t j = 0; j < secondPaths.at(i).size(); ++j) {
+        EXPECT_EQ(*secondPaths.at(i).at(j), *prefetchedPaths.at(i).at(j));
+      }
+    }
+
+    // drop links of first paths and run full SPF
+    auto prunedMetrics = adjMetrics;
+    openr::LinkState::LinkSet firstLinks;
+    for (auto const& path : firstPaths) {
+      for (auto const& link : path) {
+        firstLinks.insert(link);
+        auto node1 = std::stoi(link->firstNodeName());
+        auto node2 = std::stoi(link->secondNodeName());
+        prunedMetrics[node1].erase(node2);
+        prunedMetrics[node2].erase(node1);
+      }
+    }
+    auto prunedState = getState(prunedMetrics);
+    auto const& spfResult =
+        prunedState.getSpfResult("0", true /* useLinkMetric */);
+    auto it = spfResult.find(dest);
+    if (spfResult.end() == it) {
+      EXPECT_THAT(secondPaths, IsEmpty());
+      continue;
+    }
+    EXPECT_THAT(secondPaths, Not(IsEmpty()));
+    for (auto const& path : secondPaths) {
+      EXPECT_EQ(it->second.metric(), getPathMetric(path));
+      for (auto const& link : path) {
+        EXPECT_EQ(0, firstLinks.count(link));
+      }
+    }
+  }
+}
+
+/*
+ * Randomly bring links up/down and change their metrics. Verify SpfResult
+ * repaired incrementally matches the one computed by full SPF run.
+ */
+TEST(LinkStateTest, IncrementalSpf) {
+  const int kNumNodes = 40;
+  std::mt19937 gen(0x5eed);
+  auto randInt = [&gen](int lo, int hi) {
+    return std::uniform_int_distribution<int>(lo, hi)(gen);
+  };
+
+  // node -> {neighbor -> metric}, low metrics to get plenty of ECMP paths
+  std::map<int, std::map<int, int>> adjMetrics;
+  for (int node = 1; node < kNumNodes; ++node) {
+    // keep the graph connected at start
+    auto other = randInt(0, node - 1);
+    adjMetrics[node][other] = randInt(1, 3);
+    adjMetrics[other][node] = randInt(1, 3);
+  }
+  for (int i = 0; i < kNumNodes; ++i) {
+    auto node1 = randInt(0, kNumNodes - 1);
+    auto node2 = randInt(0, kNumNodes - 1);
+    if (node1 != node2) {
+      adjMetrics[node1][node2] = randInt(1, 3);
+      adjMetrics[node2][node1] = randInt(1, 3);
+    }
+  }
+
+  openr::LinkState incrementalState{kTestingAreaName};
+  openr::LinkState fullState{kTestingAreaName, false};
+  auto updateNode = [&](int node, bool overloaded = false) {
+    auto adjDb = createNodeAdjDb(node, adjMetrics[node], overloaded);
+    EXPECT_EQ(
+        fullState.updateAdjacencyDatabase(adjDb, 0, 0),
+        incrementalState.updateAdjacencyDatabase(adjDb, 0, 0));
+  };
+  for (int node = 0; node < kNumNodes; ++node) {
+    updateNode(node);
+  }
+
+  fb303::fbData->resetAllData();
+  for (int round = 0; round < 300; ++round) {
+    for (auto const& src : {"0", "7"}) {
+      for (bool useLinkMetric : {true, false}) {
+        SCOPED_TRACE(folly::sformat(
+            "round {}, src {}, useLinkMetric {}", round, src, useLinkMetric));
+        expectSpfResultEq(
+            fullState.getSpfResult(src, useLinkMetric),
+            incrementalState.getSpfResult(src, useLinkMetric));
+      }
+    }
+
+    auto node1 = randInt(0, kNumNodes - 1);
+    auto node2 = randInt(0, kNumNodes - 1);
+    if (node1 == node2) {
+      // node overload change, memoized results are cleared
+      updateNode(node1, round % 2);
+      continue;
+    }
+    auto& metrics1 = adjMetrics[node1];
+    auto& metrics2 = adjMetrics[node2];
+    switch (randInt(0, 2)) {
+    case 0:
+      // link down
+      metrics1.erase(node2);
+      metrics2.erase(node1);
+      updateNode(node1);
+      break;
+    case 1:
+      // link up, only once adjacency is reported by both ends
+      metrics1[node2] = randInt(1, 3);
+      metrics2[node1] = randInt(1, 3);
+      updateNode(node1);
+      updateNode(node2);
+      break;
+    default:
+      // metric change in one direction
+      if (metrics1.count(node2)) {
+        metrics1[node2] = randInt(1, 3);
+        updateNode(node1);
+      }
+    }
+  }
+
+  const auto counters = fb303::fbData->getCounters();
+  EXPECT_LT(0, counters.at("decision.incremental_spf_runs.count"));
+}
+
+/**
+ * Verifies holds of links are released by decrementHolds() once their ttl
+ * expires, and only then alter the topology
+ */
+TEST(LinkStateTest, Holds) {
+  openr::LinkState state{kTestingAreaName};
+  // line topology 0 - 1 - 2, links are held up for 2 ticks
+  state.updateAdjacencyDatabase(createNodeAdjDb(0, {{1, 1}}), 2, 0);
+  state.updateAdjacencyDatabase(createNodeAdjDb(1, {{0, 1}, {2, 1}}), 2, 0);
+  state.updateAdjacencyDatabase(createNodeAdjDb(2, {{1, 1}}), 2, 0);
+  EXPECT_TRUE(state.hasHolds());
+  EXPECT_EQ(0, state.getSpfResult("0").count("2"));
+
+  EXPECT_FALSE(state.decrementHolds().topologyChanged);
+  EXPECT_TRUE(state.hasHolds());
+  EXPECT_TRUE(state.decrementHolds().topologyChanged);
+  EXPECT_FALSE(state.hasHolds());
+  EXPECT_EQ(2, state.getSpfResult("0").at("2").metric());
+
+  // metric increase is held down for 1 tick
+  EXPECT_FALSE(
+      state.updateAdjacencyDatabase(createNodeAdjDb(0, {{1, 5}}), 0, 1)
+          .topologyChanged);
+  EXPECT_TRUE(state.hasHolds());
+  EXPECT_EQ(2, state.getSpfResult("0").at("2").metric());
+  EXPECT_TRUE(state.decrementHolds().topologyChanged);
+  EXPECT_FALSE(state.hasHolds());
+  EXPECT_EQ(6, state.getSpfResult("0").at("2").metric());
+
+  // hold of a removed link is dropped along with it
+  state.updateAdjacencyDatabase(createNodeAdjDb(1, {{0, 1}, {2, 7}}), 0, 1);
+  EXPECT_TRUE(state.hasHolds());
+  state.deleteAdjacencyDatabase("2");
+  EXPECT_FALSE(state.hasHolds());
+  EXPECT_FALSE(state.decrementHolds().topologyChanged);
+}
+
+/**
+ * Verifies memoized SpfResults and paths are bounded by the budget, evicting
+ * the least recently used ones first
+ */
+TEST(LinkStateTest, MemoizationBudget) {
+  // ring of 4 nodes
+  const int kNumNodes{4};
+  openr::LinkState state{kTestingAreaName};
+  for (int node = 0; node < kNumNodes; ++node) {
+    state.updateAdjacencyDatabase(
+        createNodeAdjDb(
+            node,
+            {{(node + 1) % kNumNodes, 1},
+             {(node + kNumNodes - 1) % kNumNodes, 1}}),
+        0,
+        0);
+  }
+  EXPECT_EQ(0, state.getMemoizationBytes());
+
+  state.getSpfResult("0");
+  const auto bytes0 = state.getMemoizationBytes();
+  EXPECT_LT(0, bytes0);
+  state.trimMemoization(0 /* unbounded */);
+  EXPECT_EQ(bytes0, state.getMemoizationBytes());
+
+  state.getSpfResult("1");
+  state.getKthPaths("1", "3", 1);
+  const auto bytes = state.getMemoizationBytes();
+  EXPECT_LT(bytes0, bytes);
+
+  // SpfResult of "0" is the least recently used one
+  fb303::fbData->resetAllData();
+  state.trimMemoization(bytes - 1);
+  EXPECT_EQ(bytes - bytes0, state.getMemoizationBytes());
+
+  // evicted result is computed again, remaining ones are reused
+  state.getSpfResult("0");
+  state.getSpfResult("1");
+  state.getKthPaths("1", "3", 1);
+  EXPECT_EQ(bytes, state.getMemoizationBytes());
+  state.trimMemoization(bytes);
+
+  const auto counters = fb303::fbData->getCounters();
+  EXPECT_EQ(1, counters.at("decision.spf_memoization.evictions.count"));
+  EXPECT_EQ(2, counters.at("decision.spf_memoization.hits.count"));
+  EXPECT_EQ(3, counters.at("decision.spf_memoization.misses.count"));
+}
+
 int
 main(int argc, char* argv[]) {
   // Parse command line flags
@@ -58,7 +58,7 @@ class PrefixStateTestFixture : public ::testing::Test {
   void
   comparePrefixMaps(
       const std::unordered_map<folly::CIDRNetwork, PrefixEntries>& map1,
-      const std::unordered_map<folly::CIDRNetwork, PrefixEntries>& map2) {
+      const PrefixState::PrefixMap& map2) {
     EXPECT_EQ(map1.size(), map2.size());
     for (const auto& [key, innerMap1] : map1) {
       const auto& iter = map2.find(key);
@@ -104,6 +104,147 @@ TEST_F(PrefixStateTestFixture, basicOperation) {
       *entry);
 }
 
+/**
+ * Verifies reverse index of advertising nodes and KSP2 prefixes follows prefix
+ * updates and withdrawals
+ */
+TEST_F(PrefixStateTestFixture, prefixesByNode) {
+  auto& [nodeArea, entry] = *(initialEntries_.begin()->second.begin());
+  const auto prefix = toIPNetwork(entry->get_prefix());
+  const PrefixKey key(nodeArea.first, prefix, nodeArea.second);
+  EXPECT_EQ(2, state_.getPrefixesByNode(nodeArea).size());
+  EXPECT_EQ(1, state_.getPrefixesByNode(nodeArea).count(prefix));
+  EXPECT_TRUE(state_.getPrefixesByNode({"unknown", nodeArea.second}).empty());
+  EXPECT_TRUE(state_.ksp2Prefixes().empty());
+
+  // same prefix advertised by another node with KSP2_ED_ECMP
+  auto ksp2Entry = *entry;
+  ksp2Entry.forwardingAlgorithm_ref() =
+      thrift::PrefixForwardingAlgorithm::KSP2_ED_ECMP;
+  const PrefixKey otherKey("other", prefix, nodeArea.second);
+  EXPECT_FALSE(state_.updatePrefix(otherKey, ksp2Entry).empty());
+  EXPECT_THAT(
+      state_.getPrefixesByNode({"other", nodeArea.second}),
+      testing::UnorderedElementsAre(prefix));
+  EXPECT_THAT(state_.ksp2Prefixes(), testing::UnorderedElementsAre(prefix));
+
+  // prefix is still advertised by node, but none of them is KSP2_ED_ECMP
+  EXPECT_FALSE(state_.deletePrefix(otherKey).empty());
+  EXPECT_TRUE(state_.getPrefixesByNode({"other", nodeArea.second}).empty());
+  EXPECT_TRUE(state_.ksp2Prefixes().empty());
+
+  EXPECT_FALSE(state_.deletePrefix(key).empty());
+  EXPECT_EQ(1, state_.getPrefixesByNode(nodeArea).size());
+  EXPECT_EQ(0, state_.getPrefixesByNode(nodeArea).count(prefix));
+}
+
+/**
+ * Verifies prefix advertised with both v1 and v2 format of prefix key is only
+ * withdrawn once both keys are withdrawn
+ */
+TEST_F(PrefixStateTestFixture, prefixKeyFormats) {
+  auto& [nodeArea, entry] = *(initialEntries_.begin()->second.begin());
+  const auto prefix = toIPNetwork(entry->get_prefix());
+  const PrefixKey key(nodeArea.first, prefix, nodeArea.second);
+  const PrefixKey keyV2(
+      nodeArea.first, prefix, nodeArea.second, true /* isPrefixKeyV2 */);
+  EXPECT_TRUE(state_.updatePrefix(keyV2, *entry).empty());
+
+  EXPECT_TRUE(state_.deletePrefix(keyV2).empty());
+  EXPECT_EQ(1, state_.prefixes().at(prefix).count(nodeArea));
+  EXPECT_FALSE(state_.deletePrefix(key).empty());
+  EXPECT_EQ(0, state_.prefixes().count(prefix));
+
+  EXPECT_FALSE(state_.updatePrefix(keyV2, *entry).empty());
+  EXPECT_FALSE(state_.deletePrefix(keyV2).empty());
+  EXPECT_EQ(0, state_.prefixes().count(prefix));
+
+  // same with prefix carried by bucket key of prefix database
+  EXPECT_FALSE(
+      state_.updatePrefix(key, *entry, true /* isBucketKey */).empty());
+  EXPECT_TRUE(state_.updatePrefix(keyV2, *entry).empty());
+  EXPECT_TRUE(state_.deletePrefix(keyV2).empty());
+  EXPECT_EQ(1, state_.prefixes().at(prefix).count(nodeArea));
+  EXPECT_FALSE(state_.deletePrefix(key, true /* isBucketKey */).empty());
+  EXPECT_EQ(0, state_.prefixes().count(prefix));
+}
+
+/**
+ * Verifies originators advertising equal entries of a prefix share the entry
+ */
+TEST_F(PrefixStateTestFixture, sharedPrefixEntries) {
+  auto& [nodeArea, entry] = *(initialEntries_.begin()->second.begin());
+  const auto prefix = toIPNetwork(entry->get_prefix());
+  const auto bytes = state_.getMemoryUsage();
+  EXPECT_LT(0, bytes);
+
+  // anycast prefix advertised by another node
+  const PrefixKey otherKey("other", prefix, nodeArea.second);
+  EXPECT_FALSE(state_.updatePrefix(otherKey, *entry).empty());
+  auto const& prefixEntries = state_.prefixes().at(prefix);
+  EXPECT_EQ(
+      prefixEntries.at(nodeArea).get(),
+      prefixEntries.at({"other", nodeArea.second}).get());
+  EXPECT_LT(bytes, state_.getMemoryUsage());
+
+  // diverging entry gets its own copy
+  auto otherEntry = *entry;
+  otherEntry.type_ref() = thrift::PrefixType::BREEZE;
+  EXPECT_FALSE(state_.updatePrefix(otherKey, otherEntry).empty());
+  EXPECT_NE(
+      prefixEntries.at(nodeArea).get(),
+      prefixEntries.at({"other", nodeArea.second}).get());
+  EXPECT_EQ(*prefixEntries.at(nodeArea), *entry);
+  EXPECT_EQ(*prefixEntries.at({"other", nodeArea.second}), otherEntry);
+
+  EXPECT_FALSE(state_.deletePrefix(otherKey).empty());
+  EXPECT_EQ(1, prefixEntries.size());
+}
+
+/**
+ * Verifies reachable prefix entries follow reachability of originators and
+ * prefix updates and withdrawals
+ */
+TEST_F(PrefixStateTestFixture, reachablePrefixes) {
+  const std::string area{kTestingAreaName};
+  const auto prefix = toIPNetwork(getAddrFromSeed(0, false));
+  auto const& entry = initialEntries_.at(prefix).at({"0", area});
+  EXPECT_EQ(nullptr, state_.reachablePrefixes("0"));
+
+  // only prefixes of node 0 are reachable
+  state_.updateReachableNodes("0", {{area, {"0"}}});
+  EXPECT_EQ(nullptr, state_.reachablePrefixes("1"));
+  ASSERT_NE(nullptr, state_.reachablePrefixes("0"));
+  auto const& reachablePrefixes = *state_.reachablePrefixes("0");
+  EXPECT_EQ(2, reachablePrefixes.size());
+  EXPECT_EQ(1, reachablePrefixes.at(prefix).size());
+
+  // anycast prefix advertised by unreachable node 1 is left out
+  const PrefixKey otherKey("1", prefix, area);
+  EXPECT_FALSE(state_.updatePrefix(otherKey, *entry).empty());
+  EXPECT_EQ(2, state_.prefixes().at(prefix).size());
+  EXPECT_EQ(1, reachablePrefixes.at(prefix).size());
+
+  // node 1 becomes reachable
+  state_.updateReachableNodes("0", {{area, {"0", "1"}}});
+  EXPECT_EQ(4, reachablePrefixes.size());
+  EXPECT_EQ(2, reachablePrefixes.at(prefix).size());
+  EXPECT_FALSE(state_.deletePrefix(otherKey).empty());
+  comparePrefixMaps(initialEntries_, reachablePrefixes);
+
+  // node 0 becomes unreachable
+  state_.updateReachableNodes("0", {{area, {"1"}}});
+  EXPECT_EQ(2, reachablePrefixes.size());
+  EXPECT_EQ(0, reachablePrefixes.count(prefix));
+
+  // originators of areas without reachability are considered reachable
+  state_.updateReachableNodes("0", {});
+  comparePrefixMaps(initialEntries_, reachablePrefixes);
+
+  state_.resetReachableNodes();
+  EXPECT_EQ(nullptr, state_.reachablePrefixes("0"));
+}
+
 /**
  * Verifies `getReceivedRoutesFiltered` with all filter combinations
  */
@@ -93,6 +93,50 @@ TEST(RibEntryTest, RibMplsEntry_filterNexthopsToUniqueAction) {
       std::unordered_set<thrift::NextHopThrift>({path1_3_1_php}));
 }
 
+/*
+ * Verify equal next-hops are interned to the same group and released along
+ * with the last route referring to them
+ */
+TEST(RibEntryTest, NextHopGroup_interning) {
+  const auto numGroups = NextHopGroup::getNumGroups();
+  {
+    RibUnicastEntry entry1(
+        folly::IPAddress::createNetwork("fc00::1/128"),
+        {path1_2_1_swap, path1_3_1_swap});
+    RibUnicastEntry entry2(
+        folly::IPAddress::createNetwork("fc00::2/128"),
+        {path1_3_1_swap, path1_2_1_swap});
+    RibMplsEntry mplsEntry(1, {path1_2_1_swap, path1_3_1_swap});
+    EXPECT_EQ(numGroups + 1, NextHopGroup::getNumGroups());
+    EXPECT_EQ(entry1.nexthops, entry2.nexthops);
+    EXPECT_EQ(entry1.nexthops, mplsEntry.nexthops);
+    EXPECT_EQ(&entry1.nexthops.asSet(), &entry2.nexthops.asSet());
+    // list form is shared too and converted routes carry it as is
+    EXPECT_EQ(&entry1.nexthops.asList(), &entry2.nexthops.asList());
+    EXPECT_EQ(entry1.nexthops.asList(), *entry1.toThrift().nextHops_ref());
+    EXPECT_EQ(entry1.nexthops.asList(), *mplsEntry.toThrift().nextHops_ref());
+    EXPECT_EQ(
+        std::hash<NextHopGroup>()(entry1.nexthops),
+        std::hash<NextHopGroup>()(entry2.nexthops));
+
+    // modified copy gets a new group, the original one is left as is
+    auto entry3 = entry1;
+    entry3.nexthops = {path1_2_1_swap};
+    EXPECT_NE(entry1.nexthops, entry3.nexthops);
+    EXPECT_NE(entry1, entry3);
+    EXPECT_EQ(2, entry1.nexthops.size());
+    EXPECT_EQ(numGroups + 2, NextHopGroup::getNumGroups());
+
+    // empty next-hops are not interned
+    entry3.nexthops = {};
+    EXPECT_TRUE(entry3.nexthops.empty());
+    EXPECT_EQ(NextHopGroup(), entry3.nexthops);
+    EXPECT_TRUE(entry3.nexthops.asList().empty());
+    EXPECT_EQ(numGroups + 1, NextHopGroup::getNumGroups());
+  }
+  EXPECT_EQ(numGroups, NextHopGroup::getNumGroups());
+}
+
 } // namespace openr
 
 int
@@ -354,7 +354,7 @@ TEST(RibPolicy, ApplyPolicy) {
   RibUnicastEntry const entry2(
       folly::IPAddress::createNetwork("fc02::/64"), {nh2});
   {
-    std::unordered_map<folly::CIDRNetwork, RibUnicastEntry> entries;
+    RibUnicastEntries entries;
     entries.emplace(entry1.prefix, entry1);
     entries.emplace(entry2.prefix, entry2);
 
@@ -388,7 +388,7 @@ TEST(RibPolicy, ApplyPolicy) {
   std::this_thread::sleep_for(std::chrono::seconds(1));
   EXPECT_FALSE(policy.isActive());
   {
-    std::unordered_map<folly::CIDRNetwork, RibUnicastEntry> entries;
+    RibUnicastEntries entries;
     entries.emplace(entry1.prefix, entry1);
     entries.emplace(entry2.prefix, entry2);
     auto const change = policy.applyPolicy(entries);
@@ -409,3 +409,66 @@ main(int argc, char* argv[]) {
   // Run the tests
   return RUN_ALL_TESTS();
 }
+
+/**
+ * Verifies first matching statement is applied with more statements than fit
+ * into a word of compiled statement sets, and that the next matching one is
+ * tried if action of the first one invalidates all next-hops
+ */
+TEST(RibPolicy, ApplyActionManyStatements) {
+  const size_t kNumPrefixStatements{100};
+  std::vector<thrift::RibPolicyStatement> statements;
+  for (size_t i = 0; i < kNumPrefixStatements; ++i) {
+    std::vector<thrift::IpPrefix> prefixes{
+        toIpPrefix(fmt::format("fc00:{}::/64", i))};
+    statements.emplace_back(createPolicyStatement(
+        prefixes, std::nullopt, i + 1, {{"area1", i ? 1 : 0}}));
+  }
+  std::vector<std::string> tags{"tag1"};
+  statements.emplace_back(createPolicyStatement(std::nullopt, tags, 200, {}));
+  auto policy = RibPolicy(createPolicy(std::move(statements), 10));
+
+  const auto nh1 = createNextHop(
+      toBinaryAddress("fe80::1"), "iface1", 0, std::nullopt, "area1");
+  const auto nh2 = createNextHop(
+      toBinaryAddress("fe80::2"), "iface2", 0, std::nullopt, "area2");
+  auto getWeight = [](RibUnicastEntry const& entry, std::string const& ifName) {
+    for (auto const& nh : entry.nexthops) {
+      if (nh.ifName_ref() == ifName) {
+        return std::make_optional(*nh.weight_ref());
+      }
+    }
+    return std::optional<int32_t>();
+  };
+  auto applyAction = [&](std::string const& prefix,
+                         std::set<std::string> const& routeTags) {
+    RibUnicastEntry entry(folly::IPAddress::createNetwork(prefix), {nh1, nh2});
+    entry.bestPrefixEntry.tags_ref() = routeTags;
+    if (not policy.applyAction(entry)) {
+      return std::optional<int32_t>();
+    }
+    return getWeight(entry, "iface2");
+  };
+
+  // prefix statements, including the ones past the first word
+  EXPECT_EQ(1, applyAction("fc00:0::/64", {}));
+  EXPECT_EQ(71, applyAction("fc00:70::/64", {}));
+  EXPECT_EQ(100, applyAction("fc00:99::/64", {"tag2"}));
+  EXPECT_FALSE(applyAction("fc01::/64", {"tag2"}).has_value());
+
+  // tag statement, unless an earlier prefix statement matches
+  EXPECT_EQ(200, applyAction("fc01::/64", {"tag1"}));
+  EXPECT_EQ(6, applyAction("fc00:5::/64", {"tag1"}));
+  EXPECT_TRUE(policy.match(RibUnicastEntry(
+      folly::IPAddress::createNetwork("fc00:5::/64"), {nh1})));
+
+  // first statement drops all next-hops, next matching one is applied
+  {
+    RibUnicastEntry entry(
+        folly::IPAddress::createNetwork("fc00:0::/64"), {nh1});
+    EXPECT_FALSE(policy.applyAction(entry));
+    entry.bestPrefixEntry.tags_ref() = {"tag1"};
+    EXPECT_TRUE(policy.applyAction(entry));
+    EXPECT_EQ(200, getWeight(entry, "iface1"));
+  }
+}
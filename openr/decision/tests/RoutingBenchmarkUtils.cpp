@@ -5,7 +5,50 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <sys/resource.h>
+#include <numeric>
+#include <thread>
+
+#include <folly/memory/MallctlHelper.h>
+#include <folly/memory/Malloc.h>
+
 #include <openr/decision/tests/RoutingBenchmarkUtils.h>
+#include <openr/kvstore/KvStoreCapture.h>
+#include <openr/kvstore/KvStoreUtil.h>
+
+namespace {
+// first perf event of the last publication replayed by BM_DecisionReplay
+const std::string kReplaySentinelEvent{"REPLAY_SENTINEL"};
+
+// Number of allocations made by the process so far, 0 if it is not using
+// jemalloc. Thread caches are merged into arena stats lazily, hence this is
+// an approximation.
+uint64_t
+getNumAllocations() {
+  if (not folly::usingJEMalloc()) {
+    return 0;
+  }
+  try {
+    folly::mallctlWrite<uint64_t>("epoch", 1);
+    uint64_t small{0}, large{0};
+    // MALLCTL_ARENAS_ALL, i.e. merged stats of all arenas
+    folly::mallctlRead("stats.arenas.4096.small.nmalloc", &small);
+    folly::mallctlRead("stats.arenas.4096.large.nmalloc", &large);
+    return small + large;
+  } catch (std::exception const& e) {
+    LOG(WARNING) << "Failed to read jemalloc stats: " << e.what();
+    return 0;
+  }
+}
+
+// Peak resident set size of the process in KB
+int64_t
+getPeakRssKb() {
+  struct rusage usage;
+  CHECK_EQ(0, getrusage(RUSAGE_SELF, &usage));
+  return usage.ru_maxrss;
+}
+} // namespace
 
 namespace openr {
 // Get a unique Id for adjacency-label
@@ -733,6 +776,96 @@ BM_DecisionGridPrefixUpdates(
 //
 // Benchmark test for fabric topology.
 //
+void
+BM_DecisionReplay(
+    folly::UserCounters& counters,
+    uint32_t iters,
+    std::string const& nodeName,
+    std::string const& replayFile,
+    std::chrono::milliseconds pubInterval,
+    double speedup) {
+  auto suspender = folly::BenchmarkSuspender();
+  const auto captured = readKvStoreCapture(replayFile);
+  CHECK(not captured.empty()) << "No publications in " << replayFile;
+  LOG(INFO) << "Replaying " << captured.size() << " publications";
+
+  // Prefix of a node out of topology, advertised after all publications to
+  // get a route update for the last rebuild. Its perf events are older than
+  // any other, hence Decision reports them for the rebuild it is part of.
+  thrift::PerfEvents sentinelEvents;
+  sentinelEvents.events_ref()->emplace_back(
+      createPerfEvent(nodeName, kReplaySentinelEvent, 0));
+  auto [sentinelKey, sentinelDb] = createPrefixKeyAndDb(
+      "replay-sentinel",
+      createPrefixEntry(toIpPrefix("fdff::/128")),
+      *captured.back().publication.area_ref());
+  sentinelDb.perfEvents_ref() = std::move(sentinelEvents);
+  apache::thrift::CompactSerializer serializer;
+  thrift::Publication sentinelPub;
+  sentinelPub.area_ref() = *captured.back().publication.area_ref();
+  sentinelPub.keyVals_ref() = {
+      {sentinelKey.getPrefixKey(),
+       createThriftValue(
+           1, "replay-sentinel", writeThriftObjStr(sentinelDb, serializer))}};
+
+  // time from start of every rebuild until its route update
+  std::vector<uint64_t> rebuildTimes;
+  uint64_t numAllocations{0};
+  for (uint32_t i = 0; i < iters; ++i) {
+    auto decisionWrapper = std::make_shared<DecisionWrapper>(nodeName);
+    const auto allocationsBefore = getNumAllocations();
+
+    suspender.dismiss(); // Start measuring benchmark time
+    for (size_t j = 0; j < captured.size(); ++j) {
+      const auto delay = j == 0 ? std::chrono::microseconds(0)
+          : pubInterval.count() > 0
+          ? std::chrono::microseconds(pubInterval)
+          : getKvStoreReplayDelay(captured[j - 1], captured[j], speedup);
+      if (delay.count() > 0) {
+        suspender.rehire();
+        /* sleep override */
+        std::this_thread::sleep_for(delay);
+        suspender.dismiss();
+      }
+      decisionWrapper->sendKvPublication(captured[j].publication);
+    }
+    decisionWrapper->sendKvPublication(sentinelPub);
+
+    // every route update is published by one rebuild
+    while (true) {
+      auto routes = decisionWrapper->recvMyRouteDb();
+      CHECK(routes.perfEvents.has_value());
+      auto const& events = *routes.perfEvents->events_ref();
+      CHECK_GE(events.size(), 2);
+      rebuildTimes.emplace_back(
+          *events.back().unixTs_ref() -
+          *events.at(events.size() - 2).unixTs_ref());
+      if (*events.front().eventDescr_ref() == kReplaySentinelEvent) {
+        break;
+      }
+    }
+    suspender.rehire(); // Stop measuring time again
+    numAllocations += getNumAllocations() - allocationsBefore;
+
+    // Decision shutdown is not measured
+    decisionWrapper.reset();
+  }
+
+  std::sort(rebuildTimes.begin(), rebuildTimes.end());
+  auto percentile = [&rebuildTimes](size_t pct) {
+    return rebuildTimes.at(
+        std::min(rebuildTimes.size() - 1, rebuildTimes.size() * pct / 100));
+  };
+  counters["rebuilds"] = rebuildTimes.size() / iters;
+  counters["rebuild_p50_ms"] = percentile(50);
+  counters["rebuild_p99_ms"] = percentile(99);
+  counters["rebuild_total_ms"] =
+      std::accumulate(rebuildTimes.begin(), rebuildTimes.end(), uint64_t{0}) /
+      iters;
+  counters["allocations"] = numAllocations / iters;
+  counters["peak_rss_kb"] = getPeakRssKb();
+}
+
 void
 BM_DecisionFabric(
     folly::UserCounters& counters,
@@ -803,4 +936,90 @@ BM_DecisionFabric(
   // Insert processTimes as user counters
   insertUserCounters(counters, iters, processTimes, std::nullopt);
 }
+
+void
+BM_DecisionGridSpfMetricUpdates(
+    folly::UserCounters& counters,
+    uint32_t iters,
+    uint32_t numOfSws,
+    bool enableIncrementalSpf) {
+  auto suspender = folly::BenchmarkSuspender();
+  const std::string nodeName{"1"};
+  const int n = std::sqrt(numOfSws);
+  auto adjDbs = createGrid(n, 0 /* numPrefixes */, SP_ECMP).first;
+
+  LinkState linkState(kTestingAreaName, enableIncrementalSpf);
+  for (auto const& [_, adjDb] : adjDbs) {
+    linkState.updateAdjacencyDatabase(adjDb);
+  }
+  linkState.getSpfResult(nodeName);
+
+  uint64_t spfTime{0};
+  for (uint32_t i = 0; i < iters; i++) {
+    // Toggle metric of a random link in one direction
+    auto& adjDb =
+        adjDbs.at(folly::sformat("adj:{}", folly::Random::rand32(n * n)));
+    auto& adj = adjDb.adjacencies_ref()->at(
+        folly::Random::rand32(adjDb.adjacencies_ref()->size()));
+    adj.metric_ref() = *adj.metric_ref() == 1 ? 10 : 1;
+
+    suspender.dismiss(); // Start measuring benchmark time
+    CHECK(linkState.updateAdjacencyDatabase(adjDb).topologyChanged);
+    const auto startTime = std::chrono::steady_clock::now();
+    linkState.getSpfResult(nodeName);
+    spfTime += std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now() - startTime)
+                   .count();
+    suspender.rehire(); // Stop measuring time again
+  }
+  counters["spf_us"] = spfTime / iters;
+}
+
+void
+BM_DecisionFabricSpfMetricUpdates(
+    folly::UserCounters& counters, uint32_t iters, uint32_t numOfSws) {
+  auto suspender = folly::BenchmarkSuspender();
+  const std::string nodeName = getNodeName(kFswMarker, 0, 0);
+  auto decisionWrapper = std::make_shared<DecisionWrapper>(nodeName);
+  const int numOfPods =
+      (numOfSws - kNumOfFswsPerPod * kNumOfSswsPerPlane) /
+      (kNumOfFswsPerPod + kNumOfRswsPerPod);
+  auto initialPub = createFabric(
+      decisionWrapper,
+      numOfPods,
+      kNumOfSswsPerPlane,
+      kNumOfFswsPerPod,
+      kNumOfRswsPerPod);
+
+  apache::thrift::CompactSerializer serializer;
+  std::vector<thrift::AdjacencyDatabase> adjDbs;
+  LinkState linkState(kTestingAreaName);
+  for (auto const& [_, value] : *initialPub.keyVals_ref()) {
+    adjDbs.emplace_back(readThriftObjStr<thrift::AdjacencyDatabase>(
+        value.value_ref().value(), serializer));
+    linkState.updateAdjacencyDatabase(adjDbs.back());
+  }
+  linkState.getSpfResult(nodeName);
+
+  uint64_t spfTime{0};
+  for (uint32_t i = 0; i < iters; i++) {
+    // Toggle metric of a random link in one direction. Repair of SPF result
+    // decreases and increases metrics of queued nodes in DijkstraQ.
+    auto& adjDb = adjDbs.at(folly::Random::rand32(adjDbs.size()));
+    auto& adj = adjDb.adjacencies_ref()->at(
+        folly::Random::rand32(adjDb.adjacencies_ref()->size()));
+    adj.metric_ref() = *adj.metric_ref() == 1 ? 10 : 1;
+
+    suspender.dismiss(); // Start measuring benchmark time
+    // adjacency may lack the reverse one, i.e. not form a link
+    linkState.updateAdjacencyDatabase(adjDb);
+    const auto startTime = std::chrono::steady_clock::now();
+    linkState.getSpfResult(nodeName);
+    spfTime += std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now() - startTime)
+                   .count();
+    suspender.rehire(); // Stop measuring time again
+  }
+  counters["spf_us"] = spfTime / iters;
+}
 } // namespace openr
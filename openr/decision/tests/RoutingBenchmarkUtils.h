@@ -388,6 +388,35 @@ void BM_DecisionGridAdjUpdates(
     thrift::PrefixForwardingAlgorithm forwardingAlgorithm,
     uint32_t numberOfPrefixes);
 
+//
+// Benchmark SPF after a link metric change in grid topology, with or without
+// incremental SPF
+//
+void BM_DecisionGridSpfMetricUpdates(
+    folly::UserCounters& counters,
+    uint32_t iters,
+    uint32_t numOfSws,
+    bool enableIncrementalSpf);
+
+//
+// Benchmark incremental SPF after a link metric change in fabric topology
+//
+void BM_DecisionFabricSpfMetricUpdates(
+    folly::UserCounters& counters, uint32_t iters, uint32_t numOfSws);
+
+//
+// Benchmark replaying publications captured by KvStoreSnooper through
+// Decision of nodeName, either every pubInterval or paced as captured sped up
+// by speedup
+//
+void BM_DecisionReplay(
+    folly::UserCounters& counters,
+    uint32_t iters,
+    std::string const& nodeName,
+    std::string const& replayFile,
+    std::chrono::milliseconds pubInterval,
+    double speedup);
+
 //
 // Benchmark test for fabric topology.
 //
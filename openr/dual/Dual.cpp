@@ -67,11 +67,13 @@ Dual::Dual(
     const std::unordered_map<std::string, int64_t>& localDistance,
     std::function<void(
         const std::optional<std::string>& oldNh,
-        const std::optional<std::string>& newNh)> nexthopChangeCb)
+        const std::optional<std::string>& newNh)> nexthopChangeCb,
+    bool incrementalPeerFlap)
     : nodeId(nodeId),
       rootId(rootId),
       localDistances_(localDistance),
-      nexthopCb_(std::move(nexthopChangeCb)) {
+      nexthopCb_(std::move(nexthopChangeCb)),
+      incrementalPeerFlap_(incrementalPeerFlap) {
   // set distance to 0 if I'm the root, otherwise default to inf
   if (rootId == nodeId) {
     info_.distance = 0;
@@ -142,6 +144,19 @@ Dual::routeAffected() {
   return false;
 }
 
+bool
+Dual::peerFlapAffectsRoute(const std::string& neighbor) {
+  if (not info_.nexthop.has_value() or *info_.nexthop == neighbor) {
+    // no route to keep, or lost/regained my feasible successor
+    return true;
+  }
+  // down neighbor has max local-distance, new neighbor max report-distance
+  // until its update arrives, neither offers a shorter distance
+  const auto d = addDistances(
+      localDistances_[neighbor], info_.neighborInfos[neighbor].reportDistance);
+  return d < info_.distance;
+}
+
 bool
 Dual::meetFeasibleCondition(std::string& nexthop, int64_t& distance) {
   int64_t dmin = getMinDistance();
@@ -414,7 +429,12 @@ Dual::peerUp(
 
   if (info_.sm.state == DualState::PASSIVE) {
     // passive
-    tryLocalOrDiffusing(DualEvent::OTHERS, false, msgsToSend);
+    if (incrementalPeerFlap_ and not peerFlapAffectsRoute(neighbor)) {
+      VLOG(2) << rootId << "::" << nodeId << ": route unaffected by "
+              << neighbor << " up, skip computation";
+    } else {
+      tryLocalOrDiffusing(DualEvent::OTHERS, false, msgsToSend);
+    }
   } else {
     // active
     if (info_.neighborInfos[neighbor].expectReply) {
@@ -474,6 +494,11 @@ Dual::peerDown(
 
   if (info_.sm.state == DualState::PASSIVE) {
     // passive
+    if (incrementalPeerFlap_ and not peerFlapAffectsRoute(neighbor)) {
+      VLOG(2) << rootId << "::" << nodeId << ": route unaffected by "
+              << neighbor << " down, skip computation";
+      return;
+    }
     tryLocalOrDiffusing(event, false, msgsToSend);
   } else {
     // active
@@ -679,8 +704,9 @@ Dual::processReply(
 
 // class DualNode methods
 
-DualNode::DualNode(const std::string& nodeId, bool isRoot)
-    : nodeId(nodeId), isRoot(isRoot) {
+DualNode::DualNode(
+    const std::string& nodeId, bool isRoot, bool incrementalPeerFlap)
+    : nodeId(nodeId), isRoot(isRoot), incrementalPeerFlap(incrementalPeerFlap) {
   if (isRoot) {
     addDual(nodeId);
   }
@@ -691,7 +717,9 @@ DualNode::peerUp(const std::string& neighbor, int64_t cost) {
   // update local-distance
   localDistances_[neighbor] = cost;
 
+  // every root sends neighbor an update, and possibly a reply
   std::unordered_map<std::string, thrift::DualMessages> msgsToSend;
+  msgsToSend[neighbor].messages_ref()->reserve(2 * duals_.size());
   for (auto& [_, dual] : duals_) {
     dual.peerUp(neighbor, cost, msgsToSend);
   }
@@ -727,7 +755,7 @@ DualNode::getDual(const std::string& rootId) {
   return duals_.at(rootId);
 }
 
-std::map<std::string, Dual>&
+folly::F14FastMap<std::string, Dual>&
 DualNode::getDuals() {
   return duals_;
 }
@@ -740,13 +768,16 @@ DualNode::getSptRootId() const noexcept {
   }
 
   // pick smallest root-id who has valid route
-  for (const auto& kv : duals_) {
-    if (kv.second.hasValidRoute()) {
-      return kv.first;
+  const std::string* sptRootId{nullptr};
+  for (const auto& [rootId, dual] : duals_) {
+    if (dual.hasValidRoute() and (not sptRootId or rootId < *sptRootId)) {
+      sptRootId = &rootId;
     }
   }
-
-  return std::nullopt;
+  if (not sptRootId) {
+    return std::nullopt;
+  }
+  return *sptRootId;
 }
 
 std::unordered_set<std::string>
@@ -768,6 +799,24 @@ DualNode::getSptPeers(const std::optional<std::string>& rootId) const noexcept {
 void
 DualNode::processDualMessages(const thrift::DualMessages& messages) {
   std::unordered_map<std::string, thrift::DualMessages> msgsToSend;
+  processDualMessagesFrom(messages, msgsToSend);
+  sendAllDualMessages(msgsToSend);
+}
+
+void
+DualNode::processDualMessagesBatch(
+    const std::vector<thrift::DualMessages>& messagesBatch) {
+  std::unordered_map<std::string, thrift::DualMessages> msgsToSend;
+  for (const auto& messages : messagesBatch) {
+    processDualMessagesFrom(messages, msgsToSend);
+  }
+  sendAllDualMessages(msgsToSend);
+}
+
+void
+DualNode::processDualMessagesFrom(
+    const thrift::DualMessages& messages,
+    std::unordered_map<std::string, thrift::DualMessages>& msgsToSend) {
   const auto& neighbor = *messages.srcId_ref();
 
   (*counters_[neighbor].pktRecv_ref())++;
@@ -797,8 +846,6 @@ DualNode::processDualMessages(const thrift::DualMessages& messages) {
     }
     }
   }
-
-  sendAllDualMessages(msgsToSend);
 }
 
 std::optional<Dual::RouteInfo>
@@ -913,7 +960,9 @@ DualNode::addDual(const std::string& rootId) {
                        const std::optional<std::string>& newNh) {
     processNexthopChange(rootId, oldNh, newNh);
   };
-  duals_.emplace(rootId, Dual(nodeId, rootId, localDistances_, nexthopCb));
+  duals_.emplace(
+      rootId,
+      Dual(nodeId, rootId, localDistances_, nexthopCb, incrementalPeerFlap));
 }
 
 } // namespace openr
@@ -13,6 +13,7 @@
 #include <unordered_map>
 
 #include <folly/Format.h>
+#include <folly/container/F14Map.h>
 
 #include <openr/if/gen-cpp2/Types_types.h>
 
@@ -68,13 +69,16 @@ class Dual {
  public:
   // constructor
   // takes nodeId, rootId, current local-distances
+  // if incrementalPeerFlap: skip computation on peer up/down as long as the
+  // flapped peer doesn't affect my route, see peerFlapAffectsRoute()
   Dual(
       const std::string& nodeId,
       const std::string& rootId,
       const std::unordered_map<std::string, int64_t>& localDistance,
       std::function<void(
           const std::optional<std::string>& oldNh,
-          const std::optional<std::string>& newNh)> nexthopChangeCb);
+          const std::optional<std::string>& newNh)> nexthopChangeCb,
+      bool incrementalPeerFlap = false);
 
   // peer up event
   // input: (neighbor-id, link-metric)
@@ -225,6 +229,11 @@ class Dual {
   // check if my route-to-root is affected
   bool routeAffected();
 
+  // cheap check if flap of a neighbor may affect my route-to-root while
+  // PASSIVE. It can't as long as neighbor is not my feasible successor and
+  // doesn't offer a shorter distance than mine
+  bool peerFlapAffectsRoute(const std::string& neighbor);
+
   // check if meet the feasible condition or not according to SNC (source node
   // condition)
   // if we can find a neighbor whose report-distance < my-feasible-distance
@@ -283,6 +292,9 @@ class Dual {
 
   // spt children
   std::unordered_set<std::string> children_;
+
+  // skip computation on peer flap not affecting my route
+  const bool incrementalPeerFlap_{false};
 };
 
 /**
@@ -306,7 +318,12 @@ class Dual {
 class DualNode {
  public:
   // constructor takes nodeId, and a indicator if I'm the root or not
-  explicit DualNode(const std::string& nodeId, bool isRoot = false);
+  // if incrementalPeerFlap: on peer up/down, roots whose feasible successor
+  // is unaffected by the flapped peer skip local and diffusing computation
+  explicit DualNode(
+      const std::string& nodeId,
+      bool isRoot = false,
+      bool incrementalPeerFlap = false);
 
   virtual ~DualNode() = default;
 
@@ -332,6 +349,12 @@ class DualNode {
   // process dual messages
   void processDualMessages(const thrift::DualMessages& messages);
 
+  // process dual messages received from any neighbors at once. Messages to
+  // each neighbor resulting from all of them, across all roots, are sent out
+  // coalesced in a single DualMessages
+  void processDualMessagesBatch(
+      const std::vector<thrift::DualMessages>& messagesBatch);
+
   // check if a given root-id is discovered or not
   bool hasDual(const std::string& rootId);
 
@@ -339,7 +362,7 @@ class DualNode {
   Dual& getDual(const std::string& rootId);
 
   // get all discovered duals reference as map<root-id: Dual>
-  std::map<std::string, Dual>& getDuals();
+  folly::F14FastMap<std::string, Dual>& getDuals();
 
   // pick smallest root-id who has a valid-route
   // return none if no ready SPT found
@@ -378,11 +401,19 @@ class DualNode {
   // I'm a root or not
   const bool isRoot{false};
 
+  // skip computation of roots unaffected by peer flap or not
+  const bool incrementalPeerFlap{false};
+
  private:
   // send out dual messages for a given <neighbor: dual-messages>
   void sendAllDualMessages(
       std::unordered_map<std::string, thrift::DualMessages>& msgsToSend);
 
+  // process dual messages from one neighbor, adding resulting messages
+  void processDualMessagesFrom(
+      const thrift::DualMessages& messages,
+      std::unordered_map<std::string, thrift::DualMessages>& msgsToSend);
+
   // add Dual for a given root-id if not exist yet
   void addDual(const std::string& rootId);
 
@@ -393,7 +424,7 @@ class DualNode {
   std::unordered_map<std::string, int64_t> localDistances_;
 
   // map<root-id: Dual-object>
-  std::map<std::string, Dual> duals_;
+  folly::F14FastMap<std::string, Dual> duals_;
 
   // map<neighbor-id: counters>
   std::unordered_map<std::string, thrift::DualPerNeighborCounters> counters_;
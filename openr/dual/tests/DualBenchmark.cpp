@@ -0,0 +1,385 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <deque>
+
+#include <fmt/format.h>
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+#include <glog/logging.h>
+
+#include <openr/common/Util.h>
+#include <openr/dual/Dual.h>
+
+/*
+ * Defines a benchmark that allows users to record customized counter during
+ * benchmarking and passes parameters to another one. A custom name is
+ * specified for each set of parameters.
+ */
+#define BENCHMARK_COUNTERS_NAME_PARAM(name, counters, param_name, ...) \
+  BENCHMARK_IMPL_COUNTERS(                                             \
+      FB_CONCATENATE(name, FB_CONCATENATE(_, param_name)),             \
+      FOLLY_PP_STRINGIZE(name) "(" FOLLY_PP_STRINGIZE(param_name) ")", \
+      counters,                                                        \
+      iters,                                                           \
+      unsigned,                                                        \
+      iters) {                                                         \
+    name(counters, iters, ##__VA_ARGS__);                              \
+  }
+
+namespace {
+
+// Fabric dimensions, number of pods is the benchmark parameter
+const int kNumOfPlanes = 4;
+const int kNumOfSswsPerPlane = 4;
+const int kNumOfRswsPerPod = 16;
+
+// link metric of every link
+const int64_t kLinkCost = 1;
+
+enum class Topology {
+  // size x size grid, each node connected to its right and lower neighbor
+  GRID = 0,
+  // `size` pods, see kNumOf* above. Each fsw of a pod connects to all ssws
+  // of its plane, and each rsw to all fsws of its pod
+  FABRIC = 1,
+};
+
+struct TopologySpec {
+  // node names. Roots are picked from the front, i.e. ssws for fabric
+  std::vector<std::string> nodes;
+  std::vector<std::pair<std::string, std::string>> edges;
+};
+
+TopologySpec
+createGrid(int size) {
+  TopologySpec spec;
+  auto nodeName = [](int row, int col) {
+    return fmt::format("node-{}-{}", row, col);
+  };
+  for (int row = 0; row < size; ++row) {
+    for (int col = 0; col < size; ++col) {
+      spec.nodes.emplace_back(nodeName(row, col));
+      if (col + 1 < size) {
+        spec.edges.emplace_back(nodeName(row, col), nodeName(row, col + 1));
+      }
+      if (row + 1 < size) {
+        spec.edges.emplace_back(nodeName(row, col), nodeName(row + 1, col));
+      }
+    }
+  }
+  return spec;
+}
+
+TopologySpec
+createFabric(int numOfPods) {
+  TopologySpec spec;
+  for (int plane = 0; plane < kNumOfPlanes; ++plane) {
+    for (int ssw = 0; ssw < kNumOfSswsPerPlane; ++ssw) {
+      spec.nodes.emplace_back(fmt::format("ssw-{}-{}", plane, ssw));
+    }
+  }
+  for (int pod = 0; pod < numOfPods; ++pod) {
+    for (int plane = 0; plane < kNumOfPlanes; ++plane) {
+      const auto fsw = fmt::format("fsw-{}-{}", pod, plane);
+      spec.nodes.emplace_back(fsw);
+      for (int ssw = 0; ssw < kNumOfSswsPerPlane; ++ssw) {
+        spec.edges.emplace_back(fmt::format("ssw-{}-{}", plane, ssw), fsw);
+      }
+    }
+    for (int rsw = 0; rsw < kNumOfRswsPerPod; ++rsw) {
+      const auto rswName = fmt::format("rsw-{}-{}", pod, rsw);
+      spec.nodes.emplace_back(rswName);
+      for (int plane = 0; plane < kNumOfPlanes; ++plane) {
+        spec.edges.emplace_back(fmt::format("fsw-{}-{}", pod, plane), rswName);
+      }
+    }
+  }
+  return spec;
+}
+
+// Bytes allocated and not yet freed by calling thread, 0 if not running with
+// jemalloc
+int64_t
+getThreadLiveBytes() {
+  return static_cast<int64_t>(openr::memory::getThreadBytesImpl(true)) -
+      static_cast<int64_t>(openr::memory::getThreadBytesImpl(false));
+}
+
+} // namespace
+
+namespace openr {
+
+class DualBenchNode;
+
+/**
+ * In-memory message bus delivering dual messages among nodes in FIFO order
+ * on the calling thread, counting messages exchanged.
+ */
+class DualMessageBus {
+ public:
+  void
+  send(const std::string& neighbor, const thrift::DualMessages& msgs) {
+    ++numPkts;
+    numMsgs += msgs.messages_ref()->size();
+    pending_.emplace_back(neighbor, msgs);
+  }
+
+  // deliver messages until no more are sent, i.e. DUAL converged
+  void converge(std::unordered_map<std::string, DualBenchNode*> const& nodes);
+
+  // dual-messages sent so far, and their packets (one per neighbor per event)
+  uint64_t numMsgs{0};
+  uint64_t numPkts{0};
+
+ private:
+  std::deque<std::pair<std::string, thrift::DualMessages>> pending_;
+};
+
+class DualBenchNode final : public DualNode {
+ public:
+  DualBenchNode(
+      const std::string& nodeId,
+      bool isRoot,
+      bool incrementalPeerFlap,
+      DualMessageBus& bus)
+      : DualNode(nodeId, isRoot, incrementalPeerFlap), bus_(bus) {}
+
+  bool
+  sendDualMessages(
+      const std::string& neighbor,
+      const thrift::DualMessages& msgs) noexcept override {
+    bus_.send(neighbor, msgs);
+    return true;
+  }
+
+  void
+  processNexthopChange(
+      const std::string& /* rootId */,
+      const std::optional<std::string>& /* oldNh */,
+      const std::optional<std::string>& /* newNh */) noexcept override {}
+
+ private:
+  DualMessageBus& bus_;
+};
+
+void
+DualMessageBus::converge(
+    std::unordered_map<std::string, DualBenchNode*> const& nodes) {
+  while (not pending_.empty()) {
+    auto [neighbor, msgs] = std::move(pending_.front());
+    pending_.pop_front();
+    auto* node = nodes.at(neighbor);
+    if (not node->neighborUp(*msgs.srcId_ref())) {
+      // link went down while message was in flight
+      continue;
+    }
+    node->processDualMessages(msgs);
+  }
+}
+
+/**
+ * Network of DualBenchNodes connected as per topology over DualMessageBus
+ */
+class DualNetwork {
+ public:
+  DualNetwork(
+      Topology topology, int size, int numOfRoots, bool incrementalPeerFlap)
+      : spec_(topology == Topology::GRID ? createGrid(size)
+                                         : createFabric(size)) {
+    CHECK_LE(numOfRoots, static_cast<int>(spec_.nodes.size()));
+    for (size_t i = 0; i < spec_.nodes.size(); ++i) {
+      const auto& name = spec_.nodes.at(i);
+      auto node = std::make_unique<DualBenchNode>(
+          name, static_cast<int>(i) < numOfRoots, incrementalPeerFlap, bus);
+      nodePtrs_.emplace(name, node.get());
+      nodes_.emplace_back(std::move(node));
+    }
+  }
+
+  void
+  linkUp(const std::pair<std::string, std::string>& edge) {
+    nodePtrs_.at(edge.first)->peerUp(edge.second, kLinkCost);
+    nodePtrs_.at(edge.second)->peerUp(edge.first, kLinkCost);
+  }
+
+  void
+  linkDown(const std::pair<std::string, std::string>& edge) {
+    nodePtrs_.at(edge.first)->peerDown(edge.second);
+    nodePtrs_.at(edge.second)->peerDown(edge.first);
+  }
+
+  void
+  converge() {
+    bus.converge(nodePtrs_);
+  }
+
+  const std::vector<std::pair<std::string, std::string>>&
+  edges() const {
+    return spec_.edges;
+  }
+
+  size_t
+  size() const {
+    return nodes_.size();
+  }
+
+  DualMessageBus bus;
+
+ private:
+  const TopologySpec spec_;
+  std::vector<std::unique_ptr<DualBenchNode>> nodes_;
+  std::unordered_map<std::string, DualBenchNode*> nodePtrs_;
+};
+
+/**
+ * Benchmark for DUAL convergence on network bring-up:
+ * 1. Create nodes of topology, first #numOfRoots being flood-roots
+ * 2. Benchmark bringing up all links and converging all roots' SPTs
+ *
+ * Counters are averaged per bring-up:
+ *  - dual_msgs / dual_pkts: dual-messages and packets exchanged
+ *  - bytes_per_root: memory held after convergence per (node, root), if
+ *    running with jemalloc
+ */
+static void
+BM_DualBringUp(
+    folly::UserCounters& counters,
+    uint32_t iters,
+    Topology topology,
+    int size,
+    int numOfRoots) {
+  auto suspender = folly::BenchmarkSuspender();
+  uint64_t numMsgs{0};
+  uint64_t numPkts{0};
+  int64_t liveBytes{0};
+  size_t numOfNodes{0};
+
+  for (uint32_t i = 0; i < iters; ++i) {
+    auto network = std::make_unique<DualNetwork>(
+        topology, size, numOfRoots, false /* incrementalPeerFlap */);
+    numOfNodes = network->size();
+    const auto liveBytesBefore = getThreadLiveBytes();
+
+    suspender.dismiss(); // Start measuring benchmark time
+    for (const auto& edge : network->edges()) {
+      network->linkUp(edge);
+    }
+    network->converge();
+    suspender.rehire(); // Stop measuring time again
+
+    liveBytes += getThreadLiveBytes() - liveBytesBefore;
+    numMsgs += network->bus.numMsgs;
+    numPkts += network->bus.numPkts;
+  }
+
+  counters["dual_msgs"] = numMsgs / iters;
+  counters["dual_pkts"] = numPkts / iters;
+  counters["bytes_per_root"] =
+      liveBytes / iters / static_cast<int64_t>(numOfNodes * numOfRoots);
+}
+
+/**
+ * Benchmark for DUAL convergence on link flap:
+ * 1. Create nodes of topology and converge all roots' SPTs
+ * 2. Benchmark bringing a random link down and converging, then up and
+ *    converging again
+ *
+ * Counters are averaged per flap:
+ *  - dual_msgs / dual_pkts: dual-messages and packets exchanged
+ */
+static void
+BM_DualLinkFlap(
+    folly::UserCounters& counters,
+    uint32_t iters,
+    Topology topology,
+    int size,
+    int numOfRoots,
+    bool incrementalPeerFlap) {
+  auto suspender = folly::BenchmarkSuspender();
+  auto network = std::make_unique<DualNetwork>(
+      topology, size, numOfRoots, incrementalPeerFlap);
+  for (const auto& edge : network->edges()) {
+    network->linkUp(edge);
+  }
+  network->converge();
+  const auto numMsgsBefore = network->bus.numMsgs;
+  const auto numPktsBefore = network->bus.numPkts;
+
+  for (uint32_t i = 0; i < iters; ++i) {
+    const auto& edge = network->edges().at(
+        folly::Random::rand32(network->edges().size()));
+
+    suspender.dismiss(); // Start measuring benchmark time
+    network->linkDown(edge);
+    network->converge();
+    network->linkUp(edge);
+    network->converge();
+    suspender.rehire(); // Stop measuring time again
+  }
+
+  counters["dual_msgs"] = (network->bus.numMsgs - numMsgsBefore) / iters;
+  counters["dual_pkts"] = (network->bus.numPkts - numPktsBefore) / iters;
+
+  // network teardown is not measured
+  network.reset();
+}
+
+// The first parameter is the topology
+// The second parameter is the size of topology: side of grid, pods of fabric
+// The third parameter is the number of flood-roots
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_DualBringUp, counters, GRID_10_1, Topology::GRID, 10, 1);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_DualBringUp, counters, GRID_10_4, Topology::GRID, 10, 4);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_DualBringUp, counters, GRID_30_1, Topology::GRID, 30, 1);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_DualBringUp, counters, GRID_30_4, Topology::GRID, 30, 4);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_DualBringUp, counters, FABRIC_8_1, Topology::FABRIC, 8, 1);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_DualBringUp, counters, FABRIC_8_4, Topology::FABRIC, 8, 4);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_DualBringUp, counters, FABRIC_32_1, Topology::FABRIC, 32, 1);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_DualBringUp, counters, FABRIC_32_4, Topology::FABRIC, 32, 4);
+
+BENCHMARK_DRAW_LINE();
+
+// The fourth parameter is whether roots unaffected by the flap skip
+// computation or not
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_DualLinkFlap, counters, GRID_30_4, Topology::GRID, 30, 4, false);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_DualLinkFlap,
+    counters,
+    GRID_30_4_INCREMENTAL,
+    Topology::GRID,
+    30,
+    4,
+    true);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_DualLinkFlap, counters, FABRIC_32_4, Topology::FABRIC, 32, 4, false);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_DualLinkFlap,
+    counters,
+    FABRIC_32_4_INCREMENTAL,
+    Topology::FABRIC,
+    32,
+    4,
+    true);
+
+} // namespace openr
+
+int
+main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -229,8 +229,13 @@ class DualTestNode final : public DualNode {
       const std::string& nodeId,
       bool isRoot,
       std::shared_ptr<folly::EventBase> evb,
-      std::map<std::string, std::shared_ptr<DualTestNode>>& nodes)
-      : DualNode(nodeId, isRoot), evb_(std::move(evb)), nodes_(nodes) {}
+      std::map<std::string, std::shared_ptr<DualTestNode>>& nodes,
+      bool batchMessages,
+      bool incrementalPeerFlap)
+      : DualNode(nodeId, isRoot, incrementalPeerFlap),
+        evb_(std::move(evb)),
+        nodes_(nodes),
+        batchMessages_(batchMessages) {}
 
   bool
   sendDualMessages(
@@ -241,12 +246,31 @@ class DualTestNode final : public DualNode {
         << nodeId << ": sending dual msgs to down neighbor " << neighbor;
     CHECK(msgs.messages_ref()->size()) << " send empty messages";
 
-    evb_->runInEventBaseThread(
-        [&, otherNode, msgs]() { otherNode->processDualMessages(msgs); });
+    evb_->runInEventBaseThread([&, otherNode, msgs]() {
+      if (otherNode->batchMessages_) {
+        otherNode->addPendingMessages(msgs);
+      } else {
+        otherNode->processDualMessages(msgs);
+      }
+    });
 
     return true;
   }
 
+  // process messages received within a loop iteration at its end
+  void
+  addPendingMessages(const thrift::DualMessages& msgs) {
+    pendingMessages_.emplace_back(msgs);
+    if (pendingMessages_.size() > 1) {
+      return;
+    }
+    evb_->runInLoop([this]() {
+      auto messagesBatch = std::move(pendingMessages_);
+      pendingMessages_.clear();
+      processDualMessagesBatch(messagesBatch);
+    });
+  }
+
   void
   processNexthopChange(
       const std::string& rootId,
@@ -263,6 +287,9 @@ class DualTestNode final : public DualNode {
   std::shared_ptr<folly::EventBase> evb_;
   // reference to map<node-id: DualTestNode*>
   std::map<std::string, std::shared_ptr<DualTestNode>>& nodes_;
+  // process received messages in batches
+  const bool batchMessages_{false};
+  std::vector<thrift::DualMessages> pendingMessages_;
 };
 
 // Dual test fixture
@@ -287,7 +314,8 @@ class DualBaseFixture : public ::testing::Test {
 
   void
   addNode(const std::string& nodeId, bool isRoot) {
-    auto node = std::make_shared<DualTestNode>(nodeId, isRoot, evb, nodes);
+    auto node = std::make_shared<DualTestNode>(
+        nodeId, isRoot, evb, nodes, batchMessages, incrementalPeerFlap);
     nodes.emplace(nodeId, node);
     vertices.emplace_back(Vertex{nodeId, true});
     if (isRoot) {
@@ -844,6 +872,10 @@ class DualBaseFixture : public ::testing::Test {
   // map<node-id: DualTestNode*>
   std::map<std::string, std::shared_ptr<DualTestNode>> nodes;
   std::vector<std::string> rootIds{};
+  // nodes added process received messages in batches
+  bool batchMessages{false};
+  // nodes added skip computation of roots unaffected by peer flap
+  bool incrementalPeerFlap{false};
 
   std::vector<Vertex> vertices;
   std::vector<Edge> edges;
@@ -853,7 +885,14 @@ class DualBaseFixture : public ::testing::Test {
 struct TestParam {
   int totalRoots; // number of roots
   bool flap; // flap link/node or not
-  TestParam(int totalRoots, bool flap) : totalRoots(totalRoots), flap(flap) {}
+  bool batch; // process received dual messages in batches or not
+  bool incremental; // skip computation of roots unaffected by flap or not
+  TestParam(
+      int totalRoots, bool flap, bool batch = false, bool incremental = false)
+      : totalRoots(totalRoots),
+        flap(flap),
+        batch(batch),
+        incremental(incremental) {}
 };
 
 class DualFixture : public DualBaseFixture,
@@ -869,7 +908,11 @@ INSTANTIATE_TEST_CASE_P(
         TestParam(1, false),
         TestParam(1, true),
         TestParam(2, false),
-        TestParam(2, true)));
+        TestParam(2, true),
+        TestParam(1, true, true),
+        TestParam(2, true, true),
+        TestParam(1, true, false, true),
+        TestParam(2, true, false, true)));
 
 /**
  *  Circular Topology
@@ -884,7 +927,10 @@ TEST_P(DualFixture, CircularTest) {
   const auto& param = GetParam();
   const auto& totalRoots = param.totalRoots;
   const auto& flap = param.flap;
-  VLOG(1) << "test params: " << totalRoots << ", " << flap;
+  batchMessages = param.batch;
+  incrementalPeerFlap = param.incremental;
+  VLOG(1) << "test params: " << totalRoots << ", " << flap << ", "
+          << batchMessages << ", " << incrementalPeerFlap;
 
   int numNodes = 4;
   // add nodes
@@ -919,7 +965,10 @@ TEST_P(DualFixture, FabricTest) {
   const auto& param = GetParam();
   const auto& totalRoots = param.totalRoots;
   const auto& flap = param.flap;
-  VLOG(1) << "test params: " << totalRoots << ", " << flap;
+  batchMessages = param.batch;
+  incrementalPeerFlap = param.incremental;
+  VLOG(1) << "test params: " << totalRoots << ", " << flap << ", "
+          << batchMessages << ", " << incrementalPeerFlap;
 
   int m = 2;
   int n = 4;
@@ -951,7 +1000,10 @@ TEST_P(DualFixture, FullMeshTest) {
   const auto& param = GetParam();
   const auto& totalRoots = param.totalRoots;
   const auto& flap = param.flap;
-  VLOG(1) << "test params: " << totalRoots << ", " << flap;
+  batchMessages = param.batch;
+  incrementalPeerFlap = param.incremental;
+  VLOG(1) << "test params: " << totalRoots << ", " << flap << ", "
+          << batchMessages << ", " << incrementalPeerFlap;
 
   int numNodes = 4;
   // add nodes
@@ -986,7 +1038,10 @@ TEST_P(DualFixture, GridTest) {
   const auto& param = GetParam();
   const auto& totalRoots = param.totalRoots;
   const auto& flap = param.flap;
-  VLOG(1) << "test params: " << totalRoots << ", " << flap;
+  batchMessages = param.batch;
+  incrementalPeerFlap = param.incremental;
+  VLOG(1) << "test params: " << totalRoots << ", " << flap << ", "
+          << batchMessages << ", " << incrementalPeerFlap;
 
   int m = 2;
   int n = 3;
@@ -7,11 +7,13 @@
 
 #include <fb303/ServiceData.h>
 #include <folly/IPAddress.h>
+#include <folly/futures/Future.h>
 #include <thrift/lib/cpp/protocol/TProtocolTypes.h>
 #include <thrift/lib/cpp/transport/THeader.h>
 #include <thrift/lib/cpp2/async/HeaderClientChannel.h>
 
 #include <openr/common/Constants.h>
+#include <openr/common/HotPathTrace.h>
 #include <openr/common/NetworkUtil.h>
 #include <openr/common/Util.h>
 #include <openr/decision/RouteUpdate.h>
@@ -24,6 +26,9 @@ namespace openr {
 
 namespace { // anonymous for local function definitions
 
+// name of the priority class of routes matching no configured class
+const std::string kDefaultPriorityClass{"default"};
+
 void
 logFibUpdateError(thrift::PlatformFibUpdateError const& error) {
   fb303::fbData->addStatValue(
@@ -47,6 +52,169 @@ logFibUpdateError(thrift::PlatformFibUpdateError const& error) {
   }
 }
 
+// Route with next-hops in canonical order, for comparing routes of agent
+template <typename Route>
+Route
+normalizeRoute(Route route) {
+  std::sort(route.nextHops_ref()->begin(), route.nextHops_ref()->end());
+  return route;
+}
+
+/**
+ * Difference between route tables of agent and ours. Return routes to add,
+ * i.e. missing or different in agent, and keys of agent routes to delete.
+ */
+template <typename Route, typename GetKey>
+auto
+getRoutesDelta(
+    std::vector<Route> const& agentRoutes,
+    std::vector<Route> const& routes,
+    GetKey getKey) {
+  using Key = std::decay_t<decltype(getKey(std::declval<Route>()))>;
+  std::unordered_map<Key, Route> agentRouteMap;
+  for (auto const& route : agentRoutes) {
+    agentRouteMap.emplace(getKey(route), normalizeRoute(route));
+  }
+
+  std::vector<Route> routesToAdd;
+  for (auto const& route : routes) {
+    auto it = agentRouteMap.find(getKey(route));
+    if (it == agentRouteMap.end()) {
+      routesToAdd.emplace_back(route);
+      continue;
+    }
+    if (it->second != normalizeRoute(route)) {
+      routesToAdd.emplace_back(route);
+    }
+    agentRouteMap.erase(it);
+  }
+
+  std::vector<Key> keysToDelete;
+  for (auto const& [key, _] : agentRouteMap) {
+    keysToDelete.emplace_back(key);
+  }
+  return std::make_pair(std::move(routesToAdd), std::move(keysToDelete));
+}
+
+// invoke func with consecutive chunks of at most chunkSize items, all items
+// in a single chunk if chunkSize is 0
+template <typename T, typename Func>
+void
+forEachChunk(std::vector<T> const& items, size_t chunkSize, Func&& func) {
+  if (chunkSize == 0) {
+    chunkSize = items.size();
+  }
+  for (size_t begin = 0; begin < items.size(); begin += chunkSize) {
+    const auto end = std::min(items.size(), begin + chunkSize);
+    func(std::vector<T>(items.begin() + begin, items.begin() + end));
+  }
+}
+
+void
+mergeFibUpdateError(
+    thrift::PlatformFibUpdateError& error,
+    thrift::PlatformFibUpdateError const& other) {
+  for (auto const& [vrf, prefixes] : *other.vrf2failedAddUpdatePrefixes_ref()) {
+    auto& failed = (*error.vrf2failedAddUpdatePrefixes_ref())[vrf];
+    failed.insert(failed.end(), prefixes.begin(), prefixes.end());
+  }
+  for (auto const& [vrf, prefixes] : *other.vrf2failedDeletePrefixes_ref()) {
+    auto& failed = (*error.vrf2failedDeletePrefixes_ref())[vrf];
+    failed.insert(failed.end(), prefixes.begin(), prefixes.end());
+  }
+  auto& failedAddUpdateLabels = *error.failedAddUpdateMplsLabels_ref();
+  failedAddUpdateLabels.insert(
+      failedAddUpdateLabels.end(),
+      other.failedAddUpdateMplsLabels_ref()->begin(),
+      other.failedAddUpdateMplsLabels_ref()->end());
+  auto& failedDeleteLabels = *error.failedDeleteMplsLabels_ref();
+  failedDeleteLabels.insert(
+      failedDeleteLabels.end(),
+      other.failedDeleteMplsLabels_ref()->begin(),
+      other.failedDeleteMplsLabels_ref()->end());
+}
+
+/**
+ * Fold next route updates/deletions of one table into pending ones, as if
+ * both were programmed in order. Return the number of route operations made
+ * obsolete, i.e. superseded or duplicate.
+ */
+template <typename Key, typename Route>
+size_t
+foldRoutes(
+    std::unordered_map<Key, Route>& routesToUpdate,
+    std::vector<Key>& routesToDelete,
+    std::unordered_map<Key, Route>&& nextRoutesToUpdate,
+    std::vector<Key>&& nextRoutesToDelete) {
+  size_t numFolded{0};
+
+  // Pending deletions of routes updated again are superseded
+  if (not routesToDelete.empty() and not nextRoutesToUpdate.empty()) {
+    auto it = std::remove_if(
+        routesToDelete.begin(), routesToDelete.end(), [&](Key const& key) {
+          return nextRoutesToUpdate.count(key) != 0;
+        });
+    numFolded += std::distance(it, routesToDelete.end());
+    routesToDelete.erase(it, routesToDelete.end());
+  }
+
+  for (auto& [key, route] : nextRoutesToUpdate) {
+    const auto [_, inserted] =
+        routesToUpdate.insert_or_assign(key, std::move(route));
+    numFolded += inserted ? 0 : 1;
+  }
+
+  if (not nextRoutesToDelete.empty()) {
+    std::unordered_set<Key> deleted(
+        routesToDelete.begin(), routesToDelete.end());
+    for (auto& key : nextRoutesToDelete) {
+      numFolded += routesToUpdate.erase(key);
+      if (deleted.insert(key).second) {
+        routesToDelete.emplace_back(key);
+      } else {
+        ++numFolded; // duplicate deletion
+      }
+    }
+  }
+  return numFolded;
+}
+
+/**
+ * Fold next route update from Decision into pending one. Perf events of the
+ * pending (oldest) update are kept, and the result is a FULL_SYNC if any of
+ * the two is. Return the number of route operations folded away.
+ */
+size_t
+foldRouteUpdate(DecisionRouteUpdate& update, DecisionRouteUpdate&& next) {
+  // doNotInstall routes are dropped on processing, and must not supersede
+  // pending ones
+  for (auto it = next.unicastRoutesToUpdate.begin();
+       it != next.unicastRoutesToUpdate.end();) {
+    if (it->second.doNotInstall) {
+      it = next.unicastRoutesToUpdate.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  if (next.type == DecisionRouteUpdate::FULL_SYNC) {
+    update.type = DecisionRouteUpdate::FULL_SYNC;
+  }
+  if (not update.perfEvents.has_value()) {
+    update.perfEvents = std::move(next.perfEvents);
+  }
+  return foldRoutes(
+             update.unicastRoutesToUpdate,
+             update.unicastRoutesToDelete,
+             std::move(next.unicastRoutesToUpdate),
+             std::move(next.unicastRoutesToDelete)) +
+      foldRoutes(
+             update.mplsRoutesToUpdate,
+             update.mplsRoutesToDelete,
+             std::move(next.mplsRoutesToUpdate),
+             std::move(next.mplsRoutesToDelete));
+}
+
 } // namespace
 
 Fib::Fib(
@@ -61,6 +229,11 @@ Fib::Fib(
       enableSegmentRouting_(
           config->getConfig().enable_segment_routing_ref().value_or(false)),
       routeDeleteDelay_(*config->getConfig().route_delete_delay_ms_ref()),
+      programmingWindow_(std::max(
+          0, *config->getConfig().fib_programming_window_ref())),
+      syncChunkSize_(
+          std::max(0, *config->getConfig().fib_sync_chunk_size_ref())),
+      enableWarmBoot_(*config->getConfig().enable_fib_warm_boot_ref()),
       retryRoutesExpBackoff_(
           Constants::kFibInitialBackoff, Constants::kFibMaxBackoff, false),
       fibRouteUpdatesQueue_(fibRouteUpdatesQueue),
@@ -68,9 +241,28 @@ Fib::Fib(
   CHECK_GE(routeDeleteDelay_.count(), 0)
       << "Route delete duration must be >= 0ms";
 
+  for (auto const& priorityClass :
+       *config->getConfig().fib_priority_classes_ref()) {
+    auto& pClass = priorityClasses_.emplace_back();
+    pClass.name = *priorityClass.name_ref();
+    for (auto const& prefix : *priorityClass.prefixes_ref()) {
+      pClass.prefixes.insert(folly::IPAddress::createNetwork(prefix));
+    }
+    pClass.tags.insert(
+        priorityClass.tags_ref()->begin(), priorityClass.tags_ref()->end());
+  }
+
   // On startup we do require routedb_sync so explicitly set the counter to 0
   fb303::fbData->setCounter("fib.synced", 0);
 
+  memoryShedder_ = MemoryPressure::addShedder(
+      "fib", getEvb(), [this]() noexcept { perfDb_.clear(); });
+
+  // Cumulative number and duration of route retries, a measure of the
+  // overhead caused by programming failures
+  fb303::fbData->setCounter("fib.retry_routes.runs", 0);
+  fb303::fbData->setCounter("fib.retry_routes.time_ms", 0);
+
   //
   // Start RetryRoute fiber with stop signal.
   //
@@ -86,6 +278,12 @@ Fib::Fib(
   addFiberTask(
       [this]() mutable noexcept { keepAliveTask(keepAliveStopSignal_); });
 
+  // Read routes programmed before restart, if warm boot is enabled
+  if (enableWarmBoot_ and not dryrun_) {
+    addFiberTask(
+        [this]() mutable noexcept { warmBootTask(warmBootStopSignal_); });
+  }
+
   // Fiber to process route updates from Decision
   addFiberTask([q = std::move(routeUpdatesQueue), this]() mutable noexcept {
     while (true) {
@@ -95,7 +293,29 @@ Fib::Fib(
         break;
       }
       fb303::fbData->addStatValue("fib.process_route_db", 1, fb303::COUNT);
-      processDecisionRouteUpdate(std::move(maybeThriftObj).value());
+
+      // Updates queued up while programming are folded into one net update,
+      // intermediate states of a route are never programmed
+      auto routeUpdate = std::move(maybeThriftObj).value();
+      size_t numUpdates{1}, numFolded{0};
+      while (q.size()) {
+        auto maybeNext = q.get(); // doesn't block on pending data
+        if (maybeNext.hasError()) {
+          break;
+        }
+        fb303::fbData->addStatValue("fib.process_route_db", 1, fb303::COUNT);
+        numFolded += foldRouteUpdate(routeUpdate, std::move(maybeNext).value());
+        ++numUpdates;
+      }
+      if (numUpdates > 1) {
+        LOG(INFO) << fmt::format(
+            "Coalesced {} route updates, {} route operations folded away",
+            numUpdates,
+            numFolded);
+        fb303::fbData->addStatValue(
+            "fib.coalesced_route_updates", numFolded, fb303::SUM);
+      }
+      processDecisionRouteUpdate(std::move(routeUpdate));
     }
   });
 
@@ -125,6 +345,7 @@ Fib::Fib(
   fb303::fbData->addStatExportType(
       "fib.local_route_program_time_ms", fb303::AVG);
   fb303::fbData->addStatExportType("fib.num_of_route_updates", fb303::SUM);
+  fb303::fbData->addStatExportType("fib.coalesced_route_updates", fb303::SUM);
   fb303::fbData->addStatExportType("fib.process_route_db", fb303::COUNT);
   fb303::fbData->addStatExportType("fib.sync_fib_calls", fb303::COUNT);
   fb303::fbData->addStatExportType(
@@ -139,6 +360,7 @@ void
 Fib::stop() {
   // Send stop signal to internal fibers
   keepAliveStopSignal_.post();
+  warmBootStopSignal_.post();
   retryRoutesStopSignal_.post();
   retryRoutesSignal_.signal();
 
@@ -150,8 +372,7 @@ Fib::stop() {
 std::optional<folly::CIDRNetwork>
 Fib::longestPrefixMatch(
     const folly::CIDRNetwork& inputPrefix,
-    const std::unordered_map<folly::CIDRNetwork, RibUnicastEntry>&
-        unicastRoutes) {
+    const RibUnicastEntries& unicastRoutes) {
   std::optional<folly::CIDRNetwork> matchedPrefix;
   int maxMask = -1;
   const auto& inputIP = inputPrefix.first;
@@ -210,6 +431,25 @@ Fib::getRouteDetailDb() {
   return sf;
 }
 
+folly::SemiFuture<std::unique_ptr<Fib::RouteDbSnapshot>>
+Fib::getRouteDbSnapshot() {
+  folly::Promise<std::unique_ptr<RouteDbSnapshot>> p;
+  auto sf = p.getSemiFuture();
+  runInEventBaseThread([p = std::move(p), this]() mutable {
+    auto snapshot = std::make_unique<RouteDbSnapshot>();
+    snapshot->unicastRoutes.reserve(routeState_.unicastRoutes.size());
+    for (const auto& route : routeState_.unicastRoutes) {
+      snapshot->unicastRoutes.emplace_back(route.second);
+    }
+    snapshot->mplsRoutes.reserve(routeState_.mplsRoutes.size());
+    for (const auto& route : routeState_.mplsRoutes) {
+      snapshot->mplsRoutes.emplace_back(route.second);
+    }
+    p.setValue(std::move(snapshot));
+  });
+  return sf;
+}
+
 folly::SemiFuture<std::unique_ptr<std::vector<thrift::UnicastRoute>>>
 Fib::getUnicastRoutes(std::vector<std::string> prefixes) {
   folly::Promise<std::unique_ptr<std::vector<thrift::UnicastRoute>>> p;
@@ -272,7 +512,7 @@ Fib::getUnicastRoutesFiltered(std::vector<std::string> prefixes) {
 
     // do longest prefix match, add the matched prefix to the result set
     const auto& matchedPrefix =
-        Fib::longestPrefixMatch(inputPrefix, routeState_.unicastRoutes);
+        routeState_.unicastPrefixes.longestPrefixMatch(inputPrefix);
     if (matchedPrefix.has_value()) {
       matchPrefixSet.insert(matchedPrefix.value());
     }
@@ -322,9 +562,12 @@ Fib::getFibUpdatesReader() {
 
 void
 Fib::RouteState::update(const DecisionRouteUpdate& routeUpdate) {
+  ++generation;
+
   // Add/Update unicast routes to update
   for (const auto& [prefix, route] : routeUpdate.unicastRoutesToUpdate) {
     unicastRoutes.insert_or_assign(prefix, route);
+    unicastPrefixes.insert(prefix);
   }
 
   // Add mpls routes to update
@@ -335,6 +578,7 @@ Fib::RouteState::update(const DecisionRouteUpdate& routeUpdate) {
   // Delete unicast routes
   for (const auto& dest : routeUpdate.unicastRoutesToDelete) {
     unicastRoutes.erase(dest);
+    unicastPrefixes.erase(dest);
   }
 
   // Delete mpls routes
@@ -343,6 +587,25 @@ Fib::RouteState::update(const DecisionRouteUpdate& routeUpdate) {
   }
 }
 
+size_t
+Fib::RouteState::getMemoryUsage() const {
+  auto stringBytes = [](std::string const& str) {
+    // short strings are stored inline
+    return str.capacity() > sizeof(std::string) - 1 ? str.capacity() + 1 : 0;
+  };
+
+  size_t bytes = unicastRoutes.getAllocatedMemorySize() +
+      mplsRoutes.getAllocatedMemorySize() +
+      dirtyPrefixes.getAllocatedMemorySize() +
+      dirtyLabels.getAllocatedMemorySize() +
+      inFlightPrefixes.getAllocatedMemorySize() +
+      inFlightLabels.getAllocatedMemorySize();
+  for (auto const& [_, route] : unicastRoutes) {
+    bytes += stringBytes(route.bestArea);
+  }
+  return bytes;
+}
+
 DecisionRouteUpdate
 Fib::RouteState::createUpdate() {
   DecisionRouteUpdate update;
@@ -354,8 +617,9 @@ Fib::RouteState::createUpdate() {
 
   if (state == SYNCING and not isInitialSynced) {
     update.type = DecisionRouteUpdate::FULL_SYNC;
-    update.unicastRoutesToUpdate = unicastRoutes;
-    update.mplsRoutesToUpdate = mplsRoutes;
+    update.unicastRoutesToUpdate.insert(
+        unicastRoutes.begin(), unicastRoutes.end());
+    update.mplsRoutesToUpdate.insert(mplsRoutes.begin(), mplsRoutes.end());
     return update;
   }
 
@@ -366,39 +630,36 @@ Fib::RouteState::createUpdate() {
   update.type = DecisionRouteUpdate::INCREMENTAL;
   auto const currentTime = std::chrono::steady_clock::now();
 
-  // Populate unicast routes to add, update, or delete
-  for (auto itrPrefixes = dirtyPrefixes.begin();
-       itrPrefixes != dirtyPrefixes.end();) {
-    if (currentTime < itrPrefixes->second) {
-      ++itrPrefixes;
-      continue; // Route is not yet ready for retry
-    }
-    auto iter = unicastRoutes.find(itrPrefixes->first);
+  // Populate unicast routes to add, update, or delete. Only routes due for
+  // programming are removed from dirty state, those in flight stay dirty.
+  for (auto const& prefix :
+       dirtyPrefixes.popDue(currentTime, [this](auto const& key) {
+         return inFlightPrefixes.count(key) > 0;
+       })) {
+    auto iter = unicastRoutes.find(prefix);
     if (iter == unicastRoutes.end()) { // Delete
-      update.unicastRoutesToDelete.emplace_back(itrPrefixes->first);
+      update.unicastRoutesToDelete.emplace_back(prefix);
     } else { // Add or Update
-      update.unicastRoutesToUpdate.emplace(itrPrefixes->first, iter->second);
+      update.unicastRoutesToUpdate.emplace(prefix, iter->second);
     }
-    // remove as we are creating a new update to program
-    itrPrefixes = dirtyPrefixes.erase(itrPrefixes);
   }
 
   // Populate mpls routes to add, update, or delete
-  for (auto itrLabel = dirtyLabels.begin(); itrLabel != dirtyLabels.end();) {
-    if (currentTime < itrLabel->second) {
-      ++itrLabel;
-      continue; // Route is not yet ready for retry
-    }
-    auto it = mplsRoutes.find(itrLabel->first);
+  for (auto label : dirtyLabels.popDue(currentTime, [this](uint32_t key) {
+         return inFlightLabels.count(key) > 0;
+       })) {
+    auto it = mplsRoutes.find(label);
     if (it == mplsRoutes.end()) { // Delete
-      update.mplsRoutesToDelete.emplace_back(itrLabel->first);
+      update.mplsRoutesToDelete.emplace_back(label);
     } else { // Add or Update
-      update.mplsRoutesToUpdate.emplace(itrLabel->first, it->second);
+      update.mplsRoutesToUpdate.emplace(label, it->second);
     }
-    // remove as we are creating a new update to program
-    itrLabel = dirtyLabels.erase(itrLabel);
   }
 
+  if (not update.empty()) {
+    update.perfEvents = std::move(queuedPerfEvents);
+    queuedPerfEvents.reset();
+  }
   return update;
 }
 
@@ -417,16 +678,9 @@ Fib::nextRetryDuration() const {
   }
 
   auto const currTime = std::chrono::steady_clock::now();
-  auto nextRetryTime =
-      std::chrono::time_point<std::chrono::steady_clock>::max();
-
-  for (auto& [prefix, addDeleteTime] : routeState_.dirtyPrefixes) {
-    nextRetryTime = std::min(addDeleteTime, nextRetryTime);
-  }
-
-  for (auto& [label, addDeleteTime] : routeState_.dirtyLabels) {
-    nextRetryTime = std::min(addDeleteTime, nextRetryTime);
-  }
+  auto const nextRetryTime = std::min(
+      routeState_.dirtyPrefixes.getNextDueTime(),
+      routeState_.dirtyLabels.getNextDueTime());
 
   return std::chrono::ceil<std::chrono::milliseconds>(
       std::max(nextRetryTime, currTime) - currTime);
@@ -492,6 +746,12 @@ Fib::processDecisionRouteUpdate(DecisionRouteUpdate&& routeUpdate) {
     mplsRoute.filterNexthopsToUniqueAction();
   }
 
+  if (programmingWindow_ and routeState_.state == RouteState::SYNCED) {
+    queueRoutes(std::move(routeUpdate));
+    programQueuedRoutes();
+    return;
+  }
+
   updateRoutes(std::move(routeUpdate));
   if (routeState_.needsRetry()) {
     // Trigger initial Fib sync, or schedule retry routes timer if needed.
@@ -580,6 +840,12 @@ Fib::updateRoutes(DecisionRouteUpdate&& routeUpdate, bool useDeleteDelay) {
   // Update flat counters here as they depend on routeState_ and its change
   updateGlobalCounters();
 
+  // Static routes programmed before the initial sync change MPLS routes of the
+  // agent, those read on warm boot are outdated
+  if (routeState_.state == RouteState::AWAITING) {
+    routeState_.warmBootMplsRoutes.reset();
+  }
+
   // Skip route programming if we're in the SYNCING state. We only perform
   // incremental route programming in AWAITING or SYNCED state. In SYNCING
   // state we let `syncRoutes` do the work instead.
@@ -589,6 +855,7 @@ Fib::updateRoutes(DecisionRouteUpdate&& routeUpdate, bool useDeleteDelay) {
   }
 
   LOG(INFO) << "Updating routes in FIB";
+  ScopedTraceSpan traceSpan("fib.update_routes", "", routeUpdate.size());
   auto const currentTime = std::chrono::steady_clock::now();
   auto const retryAt =
       currentTime + retryRoutesExpBackoff_.getTimeRemainingUntilRetry();
@@ -649,10 +916,23 @@ Fib::updateRoutes(DecisionRouteUpdate&& routeUpdate, bool useDeleteDelay) {
   }
 
   //
-  // Update Unicast routes
+  // Update Unicast routes, in a separate batch per priority class
   //
-  auto const& unicastRoutesToUpdate = *routeDbDelta.unicastRoutesToUpdate_ref();
-  if (unicastRoutesToUpdate.size()) {
+  std::vector<std::vector<thrift::UnicastRoute>> unicastRoutesByClass(
+      priorityClasses_.size() + 1);
+  for (auto& route : *routeDbDelta.unicastRoutesToUpdate_ref()) {
+    auto const& entry =
+        routeUpdate.unicastRoutesToUpdate.at(toIPNetwork(*route.dest_ref()));
+    unicastRoutesByClass.at(getPriorityClass(entry))
+        .emplace_back(std::move(route));
+  }
+  for (size_t classIdx = 0; classIdx < unicastRoutesByClass.size();
+       ++classIdx) {
+    auto const& unicastRoutesToUpdate = unicastRoutesByClass.at(classIdx);
+    if (unicastRoutesToUpdate.empty()) {
+      continue;
+    }
+    auto const classStartTime = std::chrono::steady_clock::now();
     LOG(INFO) << "Adding/Updating " << unicastRoutesToUpdate.size()
               << " unicast routes in FIB";
     printUnicastRoutesAddUpdate(unicastRoutesToUpdate);
@@ -680,15 +960,35 @@ Fib::updateRoutes(DecisionRouteUpdate&& routeUpdate, bool useDeleteDelay) {
         // these routes as deleted to client, because we failed to update them
         // Next retry should restore, but meanwhile clients can take appropriate
         // action because FIB state is unclear e.g. withdraw route from KvStore
-        for (auto& [prefix, _] : routeUpdate.unicastRoutesToUpdate) {
+        // NOTE: We don't want to advertise failed route add/updates
+        for (auto const& route : unicastRoutesToUpdate) {
+          auto const prefix = toIPNetwork(*route.dest_ref());
           routeState_.dirtyPrefixes.insert_or_assign(prefix, retryAt);
+          routeUpdate.unicastRoutesToUpdate.erase(prefix);
           routeUpdate.unicastRoutesToDelete.emplace_back(prefix);
         }
-
-        // We don't want to advertise failed route add/updates
-        routeUpdate.unicastRoutesToUpdate.clear();
       }
     }
+
+    // Report programming latency of the priority class
+    if (priorityClasses_.empty()) {
+      continue;
+    }
+    auto const& className = classIdx < priorityClasses_.size()
+        ? priorityClasses_.at(classIdx).name
+        : kDefaultPriorityClass;
+    const auto classElapsedTime = std::chrono::ceil<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - classStartTime);
+    fb303::fbData->addStatValue(
+        fmt::format("fib.route_programming.{}.time_ms", className),
+        classElapsedTime.count(),
+        fb303::AVG);
+    if (routeUpdate.perfEvents.has_value()) {
+      addPerfEvent(
+          *routeUpdate.perfEvents,
+          myNodeName_,
+          fmt::format("FIB_{}_ROUTES_PROGRAMMED", className));
+    }
   }
 
   //
@@ -793,6 +1093,13 @@ Fib::updateRoutes(DecisionRouteUpdate&& routeUpdate, bool useDeleteDelay) {
   fb303::fbData->addStatValue(
       "fib.num_of_route_updates", routeUpdate.size(), fb303::SUM);
 
+  // Record convergence of the update in perf db, a copy as the published
+  // update carries the perf events to Fib clients
+  if (routeUpdate.perfEvents.has_value()) {
+    auto perfEvents = routeUpdate.perfEvents;
+    logPerfEvents(perfEvents);
+  }
+
   // Publish the route update. Clear MPLS routes if segment routing is disabled
   routeUpdate.type = DecisionRouteUpdate::INCREMENTAL;
   if (not enableSegmentRouting_) {
@@ -804,6 +1111,286 @@ Fib::updateRoutes(DecisionRouteUpdate&& routeUpdate, bool useDeleteDelay) {
   return success;
 }
 
+void
+Fib::queueRoutes(DecisionRouteUpdate&& routeUpdate) {
+  if (routeUpdate.empty()) {
+    LOG(INFO) << "No entries in route update";
+    return;
+  }
+
+  routeState_.update(routeUpdate);
+  updateGlobalCounters();
+
+  // Mark routes dirty, program them right away unless deletion is delayed
+  auto const currentTime = std::chrono::steady_clock::now();
+  auto const deleteAt = currentTime + routeDeleteDelay_;
+  for (auto const& [prefix, _] : routeUpdate.unicastRoutesToUpdate) {
+    routeState_.dirtyPrefixes.insert_or_assign(prefix, currentTime);
+  }
+  for (auto const& prefix : routeUpdate.unicastRoutesToDelete) {
+    routeState_.dirtyPrefixes.insert_or_assign(prefix, deleteAt);
+  }
+  if (enableSegmentRouting_) {
+    for (auto const& [label, _] : routeUpdate.mplsRoutesToUpdate) {
+      routeState_.dirtyLabels.insert_or_assign(label, currentTime);
+    }
+    for (auto const& label : routeUpdate.mplsRoutesToDelete) {
+      routeState_.dirtyLabels.insert_or_assign(label, deleteAt);
+    }
+  }
+  if (routeUpdate.perfEvents.has_value() and
+      not routeState_.queuedPerfEvents.has_value()) {
+    routeState_.queuedPerfEvents = std::move(routeUpdate.perfEvents);
+  }
+}
+
+void
+Fib::programQueuedRoutes() {
+  // Synchronous programming (retry or sync) holds the semaphore. Routes stay
+  // dirty and are programmed by the retry which follows.
+  if (not updateRoutesSemaphore_.try_wait()) {
+    return;
+  }
+  SCOPE_EXIT {
+    updateRoutesSemaphore_.signal();
+  };
+
+  while (numInFlightBatches_ < programmingWindow_) {
+    auto routeUpdate = routeState_.createUpdate();
+    if (routeUpdate.empty()) {
+      break;
+    }
+    programRoutesAsync(std::move(routeUpdate));
+  }
+
+  // Schedule programming of delayed deletes
+  if (routeState_.needsRetry() and numInFlightBatches_ == 0) {
+    retryRoutesSignal_.signal();
+  }
+}
+
+void
+Fib::programRoutesAsync(DecisionRouteUpdate&& routeUpdate) {
+  ++numInFlightBatches_;
+  for (auto const& [prefix, _] : routeUpdate.unicastRoutesToUpdate) {
+    routeState_.inFlightPrefixes.emplace(prefix);
+  }
+  for (auto const& prefix : routeUpdate.unicastRoutesToDelete) {
+    routeState_.inFlightPrefixes.emplace(prefix);
+  }
+  for (auto const& [label, _] : routeUpdate.mplsRoutesToUpdate) {
+    routeState_.inFlightLabels.emplace(label);
+  }
+  for (auto const& label : routeUpdate.mplsRoutesToDelete) {
+    routeState_.inFlightLabels.emplace(label);
+  }
+
+  LOG(INFO) << "Programming batch of " << routeUpdate.size()
+            << " routes in FIB, " << numInFlightBatches_ << " in flight";
+  auto const startTime = std::chrono::steady_clock::now();
+  auto const routeDbDelta = routeUpdate.toThrift();
+  auto const& unicastRoutesToDelete = *routeDbDelta.unicastRoutesToDelete_ref();
+  auto const& unicastRoutesToUpdate = *routeDbDelta.unicastRoutesToUpdate_ref();
+  auto const& mplsRoutesToDelete = *routeDbDelta.mplsRoutesToDelete_ref();
+  auto const& mplsRoutesToUpdate = *routeDbDelta.mplsRoutesToUpdate_ref();
+  printUnicastRoutesAddUpdate(unicastRoutesToUpdate);
+  printMplsRoutesAddUpdate(mplsRoutesToUpdate);
+
+  // One future per FibService call, in the order of processProgrammedRoutes()
+  std::vector<folly::SemiFuture<folly::Unit>> futures;
+  auto addCall = [&](bool skip, auto&& call) {
+    if (skip or dryrun_) {
+      futures.emplace_back(folly::makeSemiFuture());
+      return;
+    }
+    try {
+      createFibClient(*getEvb(), socket_, client_, thriftPort_);
+      futures.emplace_back(call());
+    } catch (std::exception const&) {
+      futures.emplace_back(folly::makeSemiFuture<folly::Unit>(
+          folly::exception_wrapper(std::current_exception())));
+    }
+  };
+  addCall(unicastRoutesToDelete.empty(), [&]() {
+    return client_->semifuture_deleteUnicastRoutes(
+        kFibId_, unicastRoutesToDelete);
+  });
+  addCall(unicastRoutesToUpdate.empty(), [&]() {
+    return client_->semifuture_addUnicastRoutes(kFibId_, unicastRoutesToUpdate);
+  });
+  addCall(not enableSegmentRouting_ or mplsRoutesToDelete.empty(), [&]() {
+    return client_->semifuture_deleteMplsRoutes(kFibId_, mplsRoutesToDelete);
+  });
+  addCall(not enableSegmentRouting_ or mplsRoutesToUpdate.empty(), [&]() {
+    return client_->semifuture_addMplsRoutes(kFibId_, mplsRoutesToUpdate);
+  });
+
+  folly::collectAll(std::move(futures))
+      .via(getEvb())
+      .thenValue([this, routeUpdate = std::move(routeUpdate), startTime](
+                     std::vector<folly::Try<folly::Unit>>&& results) mutable {
+        processProgrammedRoutes(
+            std::move(routeUpdate), std::move(results), startTime);
+      });
+}
+
+void
+Fib::processProgrammedRoutes(
+    DecisionRouteUpdate&& routeUpdate,
+    std::vector<folly::Try<folly::Unit>>&& results,
+    std::chrono::steady_clock::time_point startTime) {
+  CHECK_EQ(4, results.size());
+  --numInFlightBatches_;
+  // batch sent to FibService till acked
+  HotPathTrace::record(
+      "fib.program_batch",
+      "",
+      startTime,
+      std::chrono::steady_clock::now(),
+      routeUpdate.size());
+  for (auto const& [prefix, _] : routeUpdate.unicastRoutesToUpdate) {
+    routeState_.inFlightPrefixes.erase(prefix);
+  }
+  for (auto const& prefix : routeUpdate.unicastRoutesToDelete) {
+    routeState_.inFlightPrefixes.erase(prefix);
+  }
+  for (auto const& [label, _] : routeUpdate.mplsRoutesToUpdate) {
+    routeState_.inFlightLabels.erase(label);
+  }
+  for (auto const& label : routeUpdate.mplsRoutesToDelete) {
+    routeState_.inFlightLabels.erase(label);
+  }
+
+  bool success = std::all_of(
+      results.begin(), results.end(), [](auto const& result) {
+        return result.hasValue();
+      });
+  if (success) {
+    retryRoutesExpBackoff_.reportSuccess();
+  } else {
+    retryRoutesExpBackoff_.reportError();
+  }
+  auto const retryAt = std::chrono::steady_clock::now() +
+      retryRoutesExpBackoff_.getTimeRemainingUntilRetry();
+
+  // Routes changed while in flight are dirty already and programmed with the
+  // newer state, failed ones are marked dirty only otherwise
+  auto markPrefixDirty = [&](folly::CIDRNetwork const& prefix) {
+    routeState_.dirtyPrefixes.emplace(prefix, retryAt);
+  };
+  auto markLabelDirty = [&](int32_t label) {
+    routeState_.dirtyLabels.emplace(label, retryAt);
+  };
+  auto markFibErrorDirty = [&](thrift::PlatformFibUpdateError const& error) {
+    for (auto const& [_, prefixes] : *error.vrf2failedAddUpdatePrefixes_ref()) {
+      for (auto const& prefix : prefixes) {
+        markPrefixDirty(toIPNetwork(prefix));
+      }
+    }
+    for (auto const& [_, prefixes] : *error.vrf2failedDeletePrefixes_ref()) {
+      for (auto const& prefix : prefixes) {
+        markPrefixDirty(toIPNetwork(prefix));
+      }
+    }
+    for (auto const& label : *error.failedAddUpdateMplsLabels_ref()) {
+      markLabelDirty(label);
+    }
+    for (auto const& label : *error.failedDeleteMplsLabels_ref()) {
+      markLabelDirty(label);
+    }
+  };
+  auto logFailure = [](std::string const& what, folly::Try<folly::Unit>& r) {
+    fb303::fbData->addStatValue(
+        "fib.thrift.failure.add_del_route", 1, fb303::COUNT);
+    LOG(ERROR) << "Failed to " << what
+               << " in FIB. Error: " << r.exception().what();
+  };
+
+  // Unicast deletes. We still want to advertise these prefixes as deleted
+  if (results[0].hasException()) {
+    client_.reset();
+    logFailure("delete unicast routes", results[0]);
+    for (auto const& prefix : routeUpdate.unicastRoutesToDelete) {
+      markPrefixDirty(prefix);
+    }
+  }
+
+  // Unicast adds/updates. Failed ones are advertised as deleted
+  if (auto* fibError = results[1]
+                           .tryGetExceptionObject<
+                               thrift::PlatformFibUpdateError>()) {
+    logFibUpdateError(*fibError);
+    routeUpdate.processFibUpdateError(*fibError);
+    markFibErrorDirty(*fibError);
+  } else if (results[1].hasException()) {
+    client_.reset();
+    logFailure("add/update unicast routes", results[1]);
+    for (auto const& [prefix, _] : routeUpdate.unicastRoutesToUpdate) {
+      markPrefixDirty(prefix);
+      routeUpdate.unicastRoutesToDelete.emplace_back(prefix);
+    }
+    routeUpdate.unicastRoutesToUpdate.clear();
+  }
+
+  // MPLS deletes
+  if (results[2].hasException()) {
+    client_.reset();
+    logFailure("delete mpls routes", results[2]);
+    for (auto const& label : routeUpdate.mplsRoutesToDelete) {
+      markLabelDirty(label);
+    }
+  }
+
+  // MPLS adds/updates
+  if (auto* fibError = results[3]
+                           .tryGetExceptionObject<
+                               thrift::PlatformFibUpdateError>()) {
+    logFibUpdateError(*fibError);
+    routeUpdate.processFibUpdateError(*fibError);
+    markFibErrorDirty(*fibError);
+  } else if (results[3].hasException()) {
+    client_.reset();
+    logFailure("add/update mpls routes", results[3]);
+    for (auto const& [label, _] : routeUpdate.mplsRoutesToUpdate) {
+      markLabelDirty(label);
+      routeUpdate.mplsRoutesToDelete.emplace_back(label);
+    }
+    routeUpdate.mplsRoutesToUpdate.clear();
+  }
+
+  // Log statistics
+  const auto elapsedTime = std::chrono::ceil<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - startTime);
+  LOG(INFO) << fmt::format(
+      "It took {} ms to program batch of routes in FIB", elapsedTime.count());
+  fb303::fbData->addStatValue(
+      "fib.route_programming.time_ms", elapsedTime.count(), fb303::AVG);
+  fb303::fbData->addStatValue(
+      "fib.num_of_route_updates", routeUpdate.size(), fb303::SUM);
+
+  // Record convergence of the update in perf db
+  if (routeUpdate.perfEvents.has_value()) {
+    auto perfEvents = routeUpdate.perfEvents;
+    logPerfEvents(perfEvents);
+  }
+
+  // Publish the route update. Clear MPLS routes if segment routing is disabled
+  routeUpdate.type = DecisionRouteUpdate::INCREMENTAL;
+  if (not enableSegmentRouting_) {
+    routeUpdate.mplsRoutesToUpdate.clear();
+    routeUpdate.mplsRoutesToDelete.clear();
+  }
+  fibRouteUpdatesQueue_.push(std::move(routeUpdate));
+
+  // Send routes queued in the meantime, or let retry take over, e.g. for full
+  // sync after FibAgent restart
+  if (routeState_.state == RouteState::SYNCED) {
+    programQueuedRoutes();
+  } else if (numInFlightBatches_ == 0) {
+    retryRoutesSignal_.signal();
+  }
+}
+
 bool
 Fib::syncRoutes() {
   SCOPE_EXIT {
@@ -812,9 +1399,16 @@ Fib::syncRoutes() {
   updateRoutesSemaphore_.wait();
 
   // Create set of routes to sync in thrift format
-  const auto& unicastRoutes =
-      createUnicastRoutesFromMap(routeState_.unicastRoutes);
-  const auto& mplsRoutes = createMplsRoutesFromMap(routeState_.mplsRoutes);
+  std::vector<thrift::UnicastRoute> unicastRoutes;
+  unicastRoutes.reserve(routeState_.unicastRoutes.size());
+  for (auto const& [_, route] : routeState_.unicastRoutes) {
+    unicastRoutes.emplace_back(route.toThrift());
+  }
+  std::vector<thrift::MplsRoute> mplsRoutes;
+  mplsRoutes.reserve(routeState_.mplsRoutes.size());
+  for (auto const& [_, route] : routeState_.mplsRoutes) {
+    mplsRoutes.emplace_back(route.toThrift());
+  }
   const auto currentTime = std::chrono::steady_clock::now();
   const auto retryAt =
       currentTime + retryRoutesExpBackoff_.getTimeRemainingUntilRetry();
@@ -837,7 +1431,11 @@ Fib::syncRoutes() {
   } else {
     try {
       createFibClient(*getEvb(), socket_, client_, thriftPort_);
-      client_->sync_syncFib(kFibId_, unicastRoutes);
+      if (syncChunkSize_ or enableWarmBoot_) {
+        syncUnicastRoutesDelta(unicastRoutes);
+      } else {
+        client_->sync_syncFib(kFibId_, unicastRoutes);
+      }
     } catch (thrift::PlatformFibUpdateError const& fibUpdateError) {
       logFibUpdateError(fibUpdateError);
       // Remove failed routes from fibRouteUpdates
@@ -865,7 +1463,11 @@ Fib::syncRoutes() {
     } else {
       try {
         createFibClient(*getEvb(), socket_, client_, thriftPort_);
-        client_->sync_syncMplsFib(kFibId_, mplsRoutes);
+        if (syncChunkSize_ or enableWarmBoot_) {
+          syncMplsRoutesDelta(mplsRoutes);
+        } else {
+          client_->sync_syncMplsFib(kFibId_, mplsRoutes);
+        }
       } catch (thrift::PlatformFibUpdateError const& fibUpdateError) {
         logFibUpdateError(fibUpdateError);
         // Remove failed routes from fibRouteUpdates
@@ -906,6 +1508,140 @@ Fib::syncRoutes() {
   return true;
 }
 
+void
+Fib::syncUnicastRoutesDelta(
+    std::vector<thrift::UnicastRoute> const& unicastRoutes) {
+  // Routes read on warm boot are valid for the initial sync only
+  std::vector<thrift::UnicastRoute> agentRoutes;
+  if (routeState_.warmBootUnicastRoutes.has_value()) {
+    agentRoutes = std::move(*routeState_.warmBootUnicastRoutes);
+    routeState_.warmBootUnicastRoutes.reset();
+  } else {
+    client_->sync_getRouteTableByClient(agentRoutes, kFibId_);
+  }
+  auto const [routesToAdd, prefixesToDelete] = getRoutesDelta(
+      agentRoutes, unicastRoutes, [](thrift::UnicastRoute const& route) {
+        return *route.dest_ref();
+      });
+  LOG(INFO) << fmt::format(
+      "Syncing unicast routes by difference, {} to add/update and {} to "
+      "delete out of {} in FIB",
+      routesToAdd.size(),
+      prefixesToDelete.size(),
+      agentRoutes.size());
+
+  forEachChunk(prefixesToDelete, syncChunkSize_, [this](auto const& chunk) {
+    client_->sync_deleteUnicastRoutes(kFibId_, chunk);
+  });
+
+  // program remaining chunks on partial failure
+  std::optional<thrift::PlatformFibUpdateError> fibUpdateError;
+  forEachChunk(routesToAdd, syncChunkSize_, [&](auto const& chunk) {
+    try {
+      client_->sync_addUnicastRoutes(kFibId_, chunk);
+    } catch (thrift::PlatformFibUpdateError const& error) {
+      if (not fibUpdateError.has_value()) {
+        fibUpdateError.emplace();
+      }
+      mergeFibUpdateError(*fibUpdateError, error);
+    }
+  });
+  if (fibUpdateError.has_value()) {
+    throw *fibUpdateError;
+  }
+}
+
+void
+Fib::syncMplsRoutesDelta(std::vector<thrift::MplsRoute> const& mplsRoutes) {
+  // Routes read on warm boot are valid for the initial sync only
+  std::vector<thrift::MplsRoute> agentRoutes;
+  if (routeState_.warmBootMplsRoutes.has_value()) {
+    agentRoutes = std::move(*routeState_.warmBootMplsRoutes);
+    routeState_.warmBootMplsRoutes.reset();
+  } else {
+    client_->sync_getMplsRouteTableByClient(agentRoutes, kFibId_);
+  }
+  auto const [routesToAdd, labelsToDelete] = getRoutesDelta(
+      agentRoutes, mplsRoutes, [](thrift::MplsRoute const& route) {
+        return *route.topLabel_ref();
+      });
+  LOG(INFO) << fmt::format(
+      "Syncing mpls routes by difference, {} to add/update and {} to delete "
+      "out of {} in FIB",
+      routesToAdd.size(),
+      labelsToDelete.size(),
+      agentRoutes.size());
+
+  forEachChunk(labelsToDelete, syncChunkSize_, [this](auto const& chunk) {
+    client_->sync_deleteMplsRoutes(kFibId_, chunk);
+  });
+
+  // program remaining chunks on partial failure
+  std::optional<thrift::PlatformFibUpdateError> fibUpdateError;
+  forEachChunk(routesToAdd, syncChunkSize_, [&](auto const& chunk) {
+    try {
+      client_->sync_addMplsRoutes(kFibId_, chunk);
+    } catch (thrift::PlatformFibUpdateError const& error) {
+      if (not fibUpdateError.has_value()) {
+        fibUpdateError.emplace();
+      }
+      mergeFibUpdateError(*fibUpdateError, error);
+    }
+  });
+  if (fibUpdateError.has_value()) {
+    throw *fibUpdateError;
+  }
+}
+
+void
+Fib::warmBootTask(folly::fibers::Baton& stopSignal) noexcept {
+  LOG(INFO) << "Starting WarmBoot fiber task";
+  while (routeState_.state == RouteState::AWAITING) {
+    {
+      SCOPE_EXIT {
+        updateRoutesSemaphore_.signal(); // Release when this scope exits
+      };
+      updateRoutesSemaphore_.wait();
+
+      // Initial sync may have started while waiting
+      if (routeState_.state != RouteState::AWAITING) {
+        break;
+      }
+
+      try {
+        createFibClient(*getEvb(), socket_, client_, thriftPort_);
+        std::vector<thrift::UnicastRoute> unicastRoutes;
+        client_->sync_getRouteTableByClient(unicastRoutes, kFibId_);
+        std::vector<thrift::MplsRoute> mplsRoutes;
+        if (enableSegmentRouting_) {
+          client_->sync_getMplsRouteTableByClient(mplsRoutes, kFibId_);
+        }
+        LOG(INFO) << fmt::format(
+            "Warm boot with {} unicast and {} mpls routes programmed in FIB",
+            unicastRoutes.size(),
+            mplsRoutes.size());
+        fb303::fbData->setCounter(
+            "fib.warm_boot.num_routes",
+            unicastRoutes.size() + mplsRoutes.size());
+        routeState_.warmBootUnicastRoutes = std::move(unicastRoutes);
+        routeState_.warmBootMplsRoutes = std::move(mplsRoutes);
+        break;
+      } catch (std::exception const& e) {
+        client_.reset();
+        LOG(ERROR) << "Failed to read programmed routes for warm boot. Error: "
+                   << folly::exceptionStr(e);
+      }
+    }
+
+    // Wait before retrying. Will terminate if signal is ready
+    if (stopSignal.try_wait_for(Constants::kKeepAliveCheckInterval)) {
+      break; // Baton was posted
+    }
+    stopSignal.reset(); // Baton experienced timeout
+  } // while
+  LOG(INFO) << "WarmBoot fiber task got stopped";
+}
+
 void
 Fib::retryRoutesTask(folly::fibers::Baton& stopSignal) noexcept {
   LOG(INFO) << "Starting RetryRoutes fiber task";
@@ -916,10 +1652,18 @@ Fib::retryRoutesTask(folly::fibers::Baton& stopSignal) noexcept {
   while (not stopSignal.ready()) {
     // Wait for signal & retry routes
     retryRoutesSignal_.wait();
+    const auto startTime = std::chrono::steady_clock::now();
     retryRoutes();
-
-    // Add async sleep signal for next invocation. Add only if non zero wait
-    if (routeState_.needsRetry()) {
+    fb303::fbData->incrementCounter("fib.retry_routes.runs");
+    fb303::fbData->incrementCounter(
+        "fib.retry_routes.time_ms",
+        std::chrono::ceil<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startTime)
+            .count());
+
+    // Add async sleep signal for next invocation. Add only if non zero wait.
+    // Completion of route batches in flight signals retry on its own.
+    if (routeState_.needsRetry() and numInFlightBatches_ == 0) {
       auto retryDuration = nextRetryDuration();
       LOG(INFO) << "Scheduling timer after " << retryDuration.count() << "ms";
       timeout->scheduleTimeout(retryDuration);
@@ -930,6 +1674,13 @@ Fib::retryRoutesTask(folly::fibers::Baton& stopSignal) noexcept {
 
 void
 Fib::retryRoutes() noexcept {
+  if (numInFlightBatches_) {
+    // Programming must not overtake route batches in flight. Retry is
+    // signalled again once they complete.
+    LOG(INFO) << "Deferring retry until route batches in flight complete";
+    return;
+  }
+
   bool success{false};
   retryRoutesExpBackoff_.reportError(); // We increase backoff on every retry
   LOG(INFO) << "Increasing backoff "
@@ -1057,6 +1808,45 @@ Fib::updateGlobalCounters() {
       "fib.num_unicast_routes", routeState_.unicastRoutes.size());
   fb303::fbData->setCounter(
       "fib.num_mpls_routes", routeState_.mplsRoutes.size());
+  const auto routeStateBytes = routeState_.getMemoryUsage();
+  fb303::fbData->setCounter("fib.route_state.bytes", routeStateBytes);
+  fb303::fbData->setCounter(
+      "fib.route_state.bytes_per_route",
+      routeStateBytes /
+          std::max(
+              routeState_.unicastRoutes.size() + routeState_.mplsRoutes.size(),
+              static_cast<size_t>(1ul)));
+}
+
+void
+Fib::addConvergenceHistogramValue(
+    std::string const& key, std::chrono::milliseconds duration) {
+  if (convergenceHistograms_.emplace(key).second) {
+    fb303::fbData->addHistogram(
+        key,
+        Constants::kConvergenceHistogramBucketWidth.count(),
+        0,
+        std::chrono::milliseconds(Constants::kConvergenceMaxDuration).count());
+    fb303::fbData->exportHistogramPercentile(key, 50, 90, 99);
+  }
+  fb303::fbData->addHistogramValue(key, duration.count());
+}
+
+size_t
+Fib::getPriorityClass(RibUnicastEntry const& route) const {
+  auto const& tags = *route.bestPrefixEntry.tags_ref();
+  for (size_t idx = 0; idx < priorityClasses_.size(); ++idx) {
+    auto const& priorityClass = priorityClasses_.at(idx);
+    if (priorityClass.prefixes.longestPrefixMatch(route.prefix).has_value()) {
+      return idx;
+    }
+    for (auto const& tag : tags) {
+      if (priorityClass.tags.count(tag)) {
+        return idx;
+      }
+    }
+  }
+  return priorityClasses_.size();
 }
 
 void
@@ -1108,6 +1898,18 @@ Fib::logPerfEvents(std::optional<thrift::PerfEvents>& perfEvents) {
   fb303::fbData->addStatValue(
       "fib.convergence_time_ms", totalDuration.count(), fb303::AVG);
 
+  // Export percentiles of total duration and of each stage, i.e. duration
+  // between an event and the previous one, keyed by the stage's last event
+  addConvergenceHistogramValue("fib.convergence.total.time_ms", totalDuration);
+  auto const& events = *perfEvents->events_ref();
+  for (size_t idx = 1; idx < events.size(); ++idx) {
+    addConvergenceHistogramValue(
+        fmt::format(
+            "fib.convergence.{}.time_ms", *events.at(idx).eventDescr_ref()),
+        std::chrono::milliseconds(
+            *events.at(idx).unixTs_ref() - *events.at(idx - 1).unixTs_ref()));
+  }
+
   // Add event logs
   LogSample sample{};
   sample.addString("event", "ROUTE_CONVERGENCE");
@@ -1176,7 +1978,9 @@ Fib::transitionRouteState(const RouteState::Event event) {
   // previously installed static route should be ignored.
   if (prevState == RouteState::AWAITING && nextState == RouteState::SYNCING) {
     routeState_.unicastRoutes.clear();
+    routeState_.unicastPrefixes.clear();
     routeState_.mplsRoutes.clear();
+    ++routeState_.generation;
   }
 }
 
@@ -7,14 +7,22 @@
 
 #pragma once
 
+#include <folly/container/F14Map.h>
+#include <folly/container/F14Set.h>
 #include <folly/fibers/Semaphore.h>
 #include <folly/io/async/AsyncSocket.h>
 #include <folly/io/async/AsyncTimeout.h>
 #include <folly/io/async/EventBase.h>
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <unordered_set>
+#include <vector>
 
 #include <openr/common/ExponentialBackoff.h>
+#include <openr/common/MemoryPressure.h>
 #include <openr/common/OpenrEventBase.h>
+#include <openr/common/PrefixTrie.h>
 #include <openr/common/Util.h>
 #include <openr/config/Config.h>
 #include <openr/decision/RibEntry.h>
@@ -73,8 +81,7 @@ class Fib final : public OpenrEventBase {
    */
   static std::optional<folly::CIDRNetwork> longestPrefixMatch(
       const folly::CIDRNetwork& inputPrefix,
-      const std::unordered_map<folly::CIDRNetwork, RibUnicastEntry>&
-          unicastRoutes);
+      const RibUnicastEntries& unicastRoutes);
 
   /**
    * Show unicast routes which are to be added or updated
@@ -96,6 +103,25 @@ class Fib final : public OpenrEventBase {
   folly::SemiFuture<std::unique_ptr<thrift::RouteDatabaseDetail>>
   getRouteDetailDb();
 
+  /**
+   * Copy of routes, for building large responses off the Fib thread. Routes
+   * share their next-hop groups with Fib, hence copying them is much cheaper
+   * than conversion to thrift.
+   */
+  struct RouteDbSnapshot {
+    std::vector<RibUnicastEntry> unicastRoutes;
+    std::vector<RibMplsEntry> mplsRoutes;
+  };
+  folly::SemiFuture<std::unique_ptr<RouteDbSnapshot>> getRouteDbSnapshot();
+
+  /**
+   * Generation of routes, changes whenever routes change. Thread safe.
+   */
+  int64_t
+  getRouteDbGeneration() const {
+    return routeState_.generation.load();
+  }
+
   /**
    * Retrieve unicast routes for specified prefixes or IP. Returns all if
    * no prefix is specified in filter list.
@@ -163,6 +189,25 @@ class Fib final : public OpenrEventBase {
   bool updateRoutes(
       DecisionRouteUpdate&& routeUpdate, bool useDeleteDelay = true);
 
+  /**
+   * Pipelined route programming (fib_programming_window > 0) in SYNCED state.
+   * Route update is folded into RouteState and its prefixes/labels marked
+   * dirty. Dirty routes not in flight are sent in batches with asynchronous
+   * FibService calls, as long as the window has room.
+   */
+  void queueRoutes(DecisionRouteUpdate&& routeUpdate);
+  void programQueuedRoutes();
+  void programRoutesAsync(DecisionRouteUpdate&& routeUpdate);
+
+  /**
+   * Complete batch of routes with the result of each FibService call, i.e.
+   * unicast delete/add and mpls delete/add in this order.
+   */
+  void processProgrammedRoutes(
+      DecisionRouteUpdate&& routeUpdate,
+      std::vector<folly::Try<folly::Unit>>&& results,
+      std::chrono::steady_clock::time_point startTime);
+
   /**
    * Sync the current RouteState with the switch agent.
    * - On complete failure retry is scheduled
@@ -171,6 +216,23 @@ class Fib final : public OpenrEventBase {
    */
   bool syncRoutes();
 
+  /**
+   * Sync routes by difference with the route tables of the agent, in chunks
+   * of fib_sync_chunk_size routes. Route tables are retrieved from the agent
+   * unless known from warm boot. Throw like syncFib/syncMplsFib, i.e.
+   * PlatformFibUpdateError of all chunks merged on partial failure.
+   */
+  void syncUnicastRoutesDelta(
+      std::vector<thrift::UnicastRoute> const& unicastRoutes);
+  void syncMplsRoutesDelta(std::vector<thrift::MplsRoute> const& mplsRoutes);
+
+  /**
+   * Read routes programmed by the agent before restart into RouteState, so
+   * that the first sync programs only their difference to Decision routes.
+   * Retries until the agent responds or the first sync started.
+   */
+  void warmBootTask(folly::fibers::Baton& stopSignal) noexcept;
+
   /**
    * Implements route re-programming logic, for failed routes and delayed route
    * deletion.
@@ -203,12 +265,142 @@ class Fib final : public OpenrEventBase {
   void logPerfEvents(std::optional<thrift::PerfEvents>& perfEvents);
 
   /**
-   * State variables to represent computed and programmed routes.
+   * Add sample to convergence histogram exporting p50/p90/p99 counters,
+   * created on first use
+   */
+  void addConvergenceHistogramValue(
+      std::string const& key, std::chrono::milliseconds duration);
+
+  /**
+   * Index of the priority class of unicast route, in order of programming
+   */
+  size_t getPriorityClass(RibUnicastEntry const& route) const;
+
+ public:
+  /**
+   * Dirty route keys (prefixes or labels) along with the time they are due for
+   * (re-)programming, e.g. after delete delay or retry backoff. Due times are
+   * kept in a min-heap, hence finding due keys touches only them and not all
+   * dirty keys. Heap entries of keys re-marked or programmed since are stale
+   * and skipped once they reach the top.
+   */
+  template <typename Key>
+  class DirtyRouteKeys {
+   public:
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    std::pair<typename folly::F14FastMap<Key, TimePoint>::iterator, bool>
+    insert_or_assign(Key const& key, TimePoint dueAt) {
+      auto result = keys_.insert_or_assign(key, dueAt);
+      schedule(key, dueAt);
+      return result;
+    }
+
+    // mark key dirty unless it is already
+    std::pair<typename folly::F14FastMap<Key, TimePoint>::iterator, bool>
+    emplace(Key const& key, TimePoint dueAt) {
+      auto result = keys_.emplace(key, dueAt);
+      if (result.second) {
+        schedule(key, dueAt);
+      }
+      return result;
+    }
+
+    size_t
+    size() const {
+      return keys_.size();
+    }
+
+    bool
+    empty() const {
+      return keys_.empty();
+    }
+
+    size_t
+    getAllocatedMemorySize() const {
+      return keys_.getAllocatedMemorySize() +
+          heap_.capacity() * sizeof(HeapEntry);
+    }
+
+    // Earliest due time, TimePoint::max() if no key is dirty. May be earlier
+    // than due time of any key if the top heap entry is stale.
+    TimePoint
+    getNextDueTime() const {
+      return heap_.empty() ? TimePoint::max() : heap_.front().first;
+    }
+
+    // Remove and return keys due by `now`. Keys for which `skip(key)` holds
+    // stay dirty.
+    template <typename Skip>
+    std::vector<Key>
+    popDue(TimePoint now, Skip&& skip) {
+      std::vector<Key> dueKeys;
+      std::vector<HeapEntry> skipped;
+      while (not heap_.empty() and heap_.front().first <= now) {
+        std::pop_heap(heap_.begin(), heap_.end(), laterDue);
+        auto entry = std::move(heap_.back());
+        heap_.pop_back();
+        auto it = keys_.find(entry.second);
+        if (it == keys_.end() or it->second != entry.first) {
+          continue; // stale
+        }
+        if (skip(entry.second)) {
+          skipped.emplace_back(std::move(entry));
+          continue;
+        }
+        keys_.erase(it);
+        dueKeys.emplace_back(std::move(entry.second));
+      }
+      for (auto& entry : skipped) {
+        heap_.emplace_back(std::move(entry));
+        std::push_heap(heap_.begin(), heap_.end(), laterDue);
+      }
+      return dueKeys;
+    }
+
+   private:
+    using HeapEntry = std::pair<TimePoint, Key>;
+
+    static bool
+    laterDue(HeapEntry const& lhs, HeapEntry const& rhs) {
+      return lhs.first > rhs.first;
+    }
+
+    void
+    schedule(Key const& key, TimePoint dueAt) {
+      // rebuild from dirty keys once mostly stale
+      if (heap_.size() > 2 * keys_.size() + 64) {
+        heap_.clear();
+        for (auto const& [dirtyKey, dirtyDueAt] : keys_) {
+          heap_.emplace_back(dirtyDueAt, dirtyKey);
+        }
+        std::make_heap(heap_.begin(), heap_.end(), laterDue);
+        return; // key is in keys_ already
+      }
+      heap_.emplace_back(dueAt, key);
+      std::push_heap(heap_.begin(), heap_.end(), laterDue);
+    }
+
+    folly::F14FastMap<Key, TimePoint> keys_;
+    std::vector<HeapEntry> heap_;
+  };
+
+  /**
+   * State variables to represent computed and programmed routes. Public for
+   * measuring its memory footprint standalone, see MemoryBenchmark.
    */
   struct RouteState {
-    // Non modified copy of Unicast and MPLS routes received from Decision
-    std::unordered_map<folly::CIDRNetwork, RibUnicastEntry> unicastRoutes;
-    std::unordered_map<int32_t, RibMplsEntry> mplsRoutes;
+    // Non modified copy of Unicast and MPLS routes received from Decision.
+    // Entries are stored contiguously, their next-hop groups are interned and
+    // shared with Decision and among routes.
+    folly::F14FastMap<folly::CIDRNetwork, RibUnicastEntry> unicastRoutes;
+    // prefixes of unicastRoutes for longest prefix match
+    PrefixTrie unicastPrefixes;
+    folly::F14FastMap<int32_t, RibMplsEntry> mplsRoutes;
+
+    // Incremented on every change of unicastRoutes or mplsRoutes. Read from
+    // other threads to tell if a response built from routes is outdated.
+    std::atomic<int64_t> generation{0};
 
     /**
      * Set of route keys (prefixes & labels) that needs to be updated in HW. Two
@@ -219,14 +411,27 @@ class Fib final : public OpenrEventBase {
      * Along with prefixes and labels, we also store timestamp when routes are
      * received or updated.
      */
-    std::unordered_map<
-        folly::CIDRNetwork,
-        std::chrono::time_point<std::chrono::steady_clock>>
-        dirtyPrefixes;
-    std::unordered_map<
-        uint32_t,
-        std::chrono::time_point<std::chrono::steady_clock>>
-        dirtyLabels;
+    DirtyRouteKeys<folly::CIDRNetwork> dirtyPrefixes;
+    DirtyRouteKeys<uint32_t> dirtyLabels;
+
+    /**
+     * Prefixes and labels of batches in flight in pipelined route programming.
+     * Excluded from createUpdate() until the batch completes, to keep updates
+     * of a route in order.
+     */
+    folly::F14FastSet<folly::CIDRNetwork> inFlightPrefixes;
+    folly::F14FastSet<uint32_t> inFlightLabels;
+
+    // perf events of updates queued for pipelined programming, oldest wins
+    std::optional<thrift::PerfEvents> queuedPerfEvents;
+
+    /**
+     * Routes of the agent read on warm boot, i.e. programmed before restart.
+     * Initial sync programs the difference to them and clears them. MPLS
+     * routes are dropped if static routes get programmed meanwhile.
+     */
+    std::optional<std::vector<thrift::UnicastRoute>> warmBootUnicastRoutes;
+    std::optional<std::vector<thrift::MplsRoute>> warmBootMplsRoutes;
 
     /**
      * Enumeration depicting the route event that may arrive and affect `State`
@@ -271,6 +476,12 @@ class Fib final : public OpenrEventBase {
     // Util function to convert ENUM State to string
     static std::string toStr(const State state);
 
+    /**
+     * Estimate of heap bytes held by route and dirty state tables. Next-hop
+     * groups are shared and not accounted for.
+     */
+    size_t getMemoryUsage() const;
+
     /**
      * 1. Update RouteState with the received route update from Decision or
      * Static RouteUpdates queue. Update - unicastRoutes and mplsRoutes which
@@ -297,6 +508,7 @@ class Fib final : public OpenrEventBase {
         std::chrono::time_point<std::chrono::steady_clock> retryAt);
   };
 
+ private:
   bool
   delayedDeletionEnabled() const {
     return routeDeleteDelay_ > std::chrono::milliseconds(0);
@@ -323,6 +535,9 @@ class Fib final : public OpenrEventBase {
   // Create timestamp of recently logged perf event
   int64_t recentPerfEventCreateTs_{0};
 
+  // Convergence histograms exported so far
+  std::unordered_set<std::string> convergenceHistograms_;
+
   // Name of node on which OpenR is running
   const std::string myNodeName_;
 
@@ -341,6 +556,30 @@ class Fib final : public OpenrEventBase {
   // deleting a a route (both unicast and mpls).
   const std::chrono::milliseconds routeDeleteDelay_{0};
 
+  // Config knob - Max number of route update batches in flight, 0 if route
+  // programming is not pipelined.
+  const size_t programmingWindow_{0};
+
+  // Number of route update batches in flight
+  size_t numInFlightBatches_{0};
+
+  // Config knob - Max number of routes per call in diff-based full sync, 0 if
+  // full sync replaces complete tables.
+  const size_t syncChunkSize_{0};
+
+  // Config knob - Read programmed routes on startup and sync by difference
+  const bool enableWarmBoot_{false};
+
+  // Config knob - Priority classes of unicast routes, in decreasing order of
+  // priority. Routes matching no class belong to an implicit default class
+  // at index `priorityClasses_.size()`.
+  struct PriorityClass {
+    std::string name;
+    PrefixTrie prefixes;
+    std::unordered_set<std::string> tags;
+  };
+  std::vector<PriorityClass> priorityClasses_;
+
   // Thrift client connection to switch FIB Agent using which we actually
   // manipulate routes.
   folly::AsyncSocket* socket_{nullptr};
@@ -357,6 +596,9 @@ class Fib final : public OpenrEventBase {
   // Stop signal for KeepAlive fiber
   folly::fibers::Baton keepAliveStopSignal_;
 
+  // Stop signal for WarmBoot fiber
+  folly::fibers::Baton warmBootStopSignal_;
+
   // Queues to publish programmed incremental IP/label routes or those from Fib
   // sync. (Fib streaming)
   messaging::ReplicateQueue<DecisionRouteUpdate>& fibRouteUpdatesQueue_;
@@ -376,6 +618,9 @@ class Fib final : public OpenrEventBase {
 
   // Queue to publish the event log
   messaging::ReplicateQueue<LogSample>& logSampleQueue_;
+
+  // drops perf events under memory pressure
+  std::unique_ptr<MemoryPressure::Shedder> memoryShedder_;
 };
 
 } // namespace openr
@@ -5,8 +5,11 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <thread>
+
 #include <gtest/gtest.h>
 
+#include <fb303/ServiceData.h>
 #include <folly/Benchmark.h>
 #include <folly/init/Init.h>
 #include <thrift/lib/cpp2/server/ThriftServer.h>
@@ -199,28 +202,57 @@ class FibWrapper {
   PrefixGenerator prefixGenerator;
 };
 
+/**
+ * Wait until `predicate` holds, polling every millisecond
+ */
+template <typename Predicate>
+static void
+waitUntil(Predicate predicate) {
+  while (not predicate()) {
+    /* sleep override */
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
 /**
  * Benchmark for fib
- * 1. Create a fib
+ * 1. Create a fib, optionally against a platform with programming latency
+ *    and failures
  * 2. Generate random IpV6s and routes
- * 3. Send routes to fib
- * 4. Wait until the completion of routes update
+ * 3. Send routes to fib and measure the time until all of them are
+ *    programmed and Fib is SYNCED
+ * 4. Send updates of `batchSize` routes and wait until each is programmed,
+ *    including retries of failed routes
  */
 static void
-BM_Fib(folly::UserCounters& counters, uint32_t iters, unsigned numOfPrefixes) {
+BM_Fib(
+    folly::UserCounters& counters,
+    uint32_t iters,
+    unsigned numOfPrefixes,
+    unsigned batchSize = kDeltaSize,
+    unsigned platformLatencyMs = 0,
+    unsigned failurePercent = 0) {
   auto suspender = folly::BenchmarkSuspender();
   // Fib starts with clean route database
   auto fibWrapper = std::make_unique<FibWrapper>();
+  auto& mockFibHandler = fibWrapper->mockFibHandler;
+  mockFibHandler->setProgrammingLatency(
+      std::chrono::milliseconds(platformLatencyMs));
+  mockFibHandler->setFailureRate(failurePercent / 100.0);
 
-  // Initial syncFib debounce
-  fibWrapper->routeUpdatesQueue.push(DecisionRouteUpdate());
-  fibWrapper->mockFibHandler->waitForSyncFib();
+  // Retry counters are cumulative across benchmark runs
+  const auto retryRunsBase =
+      fb303::fbData->getCounter("fib.retry_routes.runs");
+  const auto retryTimeBase =
+      fb303::fbData->getCounter("fib.retry_routes.time_ms");
 
   // Generate random prefixes
   auto prefixes = fibWrapper->prefixGenerator.ipv6PrefixGenerator(
       numOfPrefixes, kBitMaskLen);
+  const auto syncStartTime = std::chrono::steady_clock::now();
   {
     DecisionRouteUpdate routeUpdate;
+    routeUpdate.type = DecisionRouteUpdate::FULL_SYNC;
     for (auto& prefix : prefixes) {
       auto nhs = fibWrapper->prefixGenerator.getRandomNextHopsUnicast(
           kNumOfNexthops, kVethNameY);
@@ -229,24 +261,32 @@ BM_Fib(folly::UserCounters& counters, uint32_t iters, unsigned numOfPrefixes) {
       routeUpdate.unicastRoutesToUpdate.emplace(
           toIPNetwork(prefix), RibUnicastEntry(toIPNetwork(prefix), nhsSet));
     }
-    // Send routeDB to Fib and wait for updating completing
+    // Send routeDB to Fib and wait for all routes to be programmed
     fibWrapper->routeUpdatesQueue.push(std::move(routeUpdate));
   }
-  fibWrapper->mockFibHandler->waitForUpdateUnicastRoutes();
+  waitUntil([&]() {
+    return fb303::fbData->getCounter("fib.synced") == 1 and
+        mockFibHandler->getUnicastRoutesCount() == numOfPrefixes;
+  });
+  const auto timeToSynced = std::chrono::ceil<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - syncStartTime);
 
   // Customized time counter
   // processTimes[0] is the time of sending routDB from decision to Fib
   // processTimes[1] is the time of processing DB within Fib
   // processTimes[2] is the time of programming routs with Fib agent server
   std::vector<uint64_t> processTimes{0, 0, 0};
-  // Maek sure deltaSize <= numOfPrefixes
-  auto deltaSize = kDeltaSize <= numOfPrefixes ? kDeltaSize : numOfPrefixes;
+  // Maek sure batchSize <= numOfPrefixes
+  batchSize = std::min(batchSize, numOfPrefixes);
+  // Successful route additions so far. Failed routes are retried until they
+  // succeed, each of them is counted once.
+  auto numOfRoutesAdded = mockFibHandler->getAddRoutesCount();
   suspender.dismiss(); // Start measuring benchmark time
 
   for (uint32_t i = 0; i < iters; i++) {
-    // Update routes by randomly regenerating nextHops for deltaSize prefixes.
+    // Update routes by randomly regenerating nextHops for batchSize prefixes.
     DecisionRouteUpdate routeUpdate;
-    for (uint32_t index = 0; index < deltaSize; index++) {
+    for (uint32_t index = 0; index < batchSize; index++) {
       auto nhs = fibWrapper->prefixGenerator.getRandomNextHopsUnicast(
           kNumOfNexthops, kVethNameY);
       auto nhsSet =
@@ -262,7 +302,10 @@ BM_Fib(folly::UserCounters& counters, uint32_t iters, unsigned numOfPrefixes) {
 
     // Send routeDB to Fib for updates
     fibWrapper->routeUpdatesQueue.push(std::move(routeUpdate));
-    fibWrapper->mockFibHandler->waitForUpdateUnicastRoutes();
+    numOfRoutesAdded += batchSize;
+    waitUntil([&]() {
+      return mockFibHandler->getAddRoutesCount() >= numOfRoutesAdded;
+    });
 
     // Get time information from perf event
     fibWrapper->accumulatePerfTimes(processTimes);
@@ -277,6 +320,11 @@ BM_Fib(folly::UserCounters& counters, uint32_t iters, unsigned numOfPrefixes) {
   // Add customized counters to state.
   counters["route_receive"] = processTimes[0];
   counters["route_install"] = processTimes[2];
+  counters["time_to_synced_ms"] = timeToSynced.count();
+  counters["retry_runs"] =
+      fb303::fbData->getCounter("fib.retry_routes.runs") - retryRunsBase;
+  counters["retry_time_ms"] =
+      fb303::fbData->getCounter("fib.retry_routes.time_ms") - retryTimeBase;
 }
 
 // The parameter is the number of prefixes sent to fib
@@ -285,6 +333,20 @@ BENCHMARK_COUNTERS_PARAM(BM_Fib, counters, 100);
 BENCHMARK_COUNTERS_PARAM(BM_Fib, counters, 1000);
 BENCHMARK_COUNTERS_PARAM(BM_Fib, counters, 9000);
 
+// The parameters are the number of prefixes sent to fib, the number of
+// prefixes per update, the simulated agent latency per call in ms and the
+// percentage of routes failing to program
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_Fib, counters, 1000_10_5ms_0pct, 1000, 10, 5, 0);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_Fib, counters, 1000_100_5ms_0pct, 1000, 100, 5, 0);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_Fib, counters, 1000_10_5ms_1pct, 1000, 10, 5, 1);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_Fib, counters, 1000_100_5ms_5pct, 1000, 100, 5, 5);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_Fib, counters, 9000_100_20ms_1pct, 9000, 100, 20, 1);
+
 } // namespace openr
 
 int
@@ -5,6 +5,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <fb303/ServiceData.h>
 #include <folly/init/Init.h>
 #include <glog/logging.h>
 #include <gmock/gmock.h>
@@ -27,6 +28,8 @@
 using namespace std;
 using namespace openr;
 
+namespace fb303 = facebook::fb303;
+
 using apache::thrift::ThriftServer;
 using apache::thrift::util::ScopedServerThread;
 
@@ -315,8 +318,17 @@ checkEqualDecisionRouteUpdate(
 
 class FibTestFixture : public ::testing::Test {
  public:
-  explicit FibTestFixture(int32_t routeDeleteDelayMs = 1000)
-      : routeDeleteDelay_(routeDeleteDelayMs) {}
+  explicit FibTestFixture(
+      int32_t routeDeleteDelayMs = 1000,
+      int32_t programmingWindow = 0,
+      int32_t syncChunkSize = 0,
+      std::vector<thrift::FibPriorityClass> priorityClasses = {},
+      bool enableWarmBoot = false)
+      : routeDeleteDelay_(routeDeleteDelayMs),
+        programmingWindow_(programmingWindow),
+        syncChunkSize_(syncChunkSize),
+        priorityClasses_(std::move(priorityClasses)),
+        enableWarmBoot_(enableWarmBoot) {}
   void
   SetUp() override {
     mockFibHandler_ = std::make_shared<MockNetlinkFibHandler>();
@@ -329,6 +341,9 @@ class FibTestFixture : public ::testing::Test {
 
     fibThriftThread.start(server);
 
+    // routes programmed before Fib starts
+    programAgentRoutes();
+
     auto tConfig = getBasicOpenrConfig(
         "node-1",
         "domain",
@@ -338,6 +353,10 @@ class FibTestFixture : public ::testing::Test {
         false /*orderedFibProgramming*/,
         false /*dryrun*/);
     tConfig.route_delete_delay_ms_ref() = routeDeleteDelay_;
+    tConfig.fib_programming_window_ref() = programmingWindow_;
+    tConfig.fib_sync_chunk_size_ref() = syncChunkSize_;
+    tConfig.fib_priority_classes_ref() = priorityClasses_;
+    tConfig.enable_fib_warm_boot_ref() = enableWarmBoot_;
     tConfig.fib_port_ref() = fibThriftThread.getAddress()->getPort();
 
     config_ = make_shared<Config>(tConfig);
@@ -548,6 +567,14 @@ class FibTestFixture : public ::testing::Test {
 
  private:
   const int32_t routeDeleteDelay_{0};
+  const int32_t programmingWindow_{0};
+  const int32_t syncChunkSize_{0};
+  const std::vector<thrift::FibPriorityClass> priorityClasses_;
+  const bool enableWarmBoot_{false};
+
+  // Program routes of the agent before Fib starts, e.g. to mimic a restart
+  virtual void
+  programAgentRoutes() {}
 };
 
 // Fib single streaming client test.
@@ -963,6 +990,405 @@ TEST_F(FibTestFixture, processRouteDb) {
       checkEqualRouteDatabaseUnicastDetail(routeDetailDb, getRouteDetailDb()));
 }
 
+class FibPipelinedTestFixture : public FibTestFixture {
+ public:
+  FibPipelinedTestFixture()
+      : FibTestFixture(0 /* routeDeleteDelayMs */, 2 /* programmingWindow */) {}
+};
+
+TEST_F(FibPipelinedTestFixture, CoalescedUpdates) {
+  // initial syncFib
+  routeUpdatesQueue.push(DecisionRouteUpdate());
+  mockFibHandler_->waitForSyncFib();
+  EXPECT_EQ(
+      DecisionRouteUpdate::FULL_SYNC,
+      fibRouteUpdatesQueueReader.get().value().type);
+
+  // burst of updates, prefix2 is added, updated and deleted again
+  DecisionRouteUpdate routeUpdate1;
+  routeUpdate1.addRouteToUpdate(
+      RibUnicastEntry(toIPNetwork(prefix2), {path1_2_1, path1_2_2}));
+  routeUpdatesQueue.push(routeUpdate1);
+  DecisionRouteUpdate routeUpdate2;
+  routeUpdate2.addRouteToUpdate(
+      RibUnicastEntry(toIPNetwork(prefix2), {path1_2_2}));
+  routeUpdate2.addRouteToUpdate(
+      RibUnicastEntry(toIPNetwork(prefix3), {path1_3_1, path1_3_2}));
+  routeUpdatesQueue.push(routeUpdate2);
+  DecisionRouteUpdate routeUpdate3;
+  routeUpdate3.unicastRoutesToDelete.emplace_back(toIPNetwork(prefix2));
+  routeUpdatesQueue.push(routeUpdate3);
+
+  // programmed routes as published, until prefix2 is deleted in the end
+  RibUnicastEntries programmedRoutes;
+  bool prefix2Deleted{false};
+  while (not prefix2Deleted or programmedRoutes.size() != 1) {
+    auto update = fibRouteUpdatesQueueReader.get().value();
+    EXPECT_EQ(DecisionRouteUpdate::INCREMENTAL, update.type);
+    for (auto const& prefix : update.unicastRoutesToDelete) {
+      programmedRoutes.erase(prefix);
+      prefix2Deleted |= prefix == toIPNetwork(prefix2);
+    }
+    for (auto& [prefix, entry] : update.unicastRoutesToUpdate) {
+      programmedRoutes.insert_or_assign(prefix, entry);
+      prefix2Deleted &= prefix != toIPNetwork(prefix2);
+    }
+  }
+  EXPECT_EQ(1, programmedRoutes.count(toIPNetwork(prefix3)));
+
+  // agent ends up with the latest state of every route
+  std::vector<thrift::UnicastRoute> routes;
+  mockFibHandler_->getRouteTableByClient(routes, kFibId);
+  ASSERT_EQ(1, routes.size());
+  EXPECT_EQ(prefix3, *routes.at(0).dest_ref());
+  EXPECT_EQ(1, getRouteDb().unicastRoutes_ref()->size());
+}
+
+TEST_F(FibTestFixture, FoldQueuedUpdates) {
+  // initial syncFib
+  routeUpdatesQueue.push(DecisionRouteUpdate());
+  mockFibHandler_->waitForSyncFib();
+  EXPECT_EQ(
+      DecisionRouteUpdate::FULL_SYNC,
+      fibRouteUpdatesQueueReader.get().value().type);
+
+  // keep Fib busy programming prefix1 while a burst of updates is queued
+  mockFibHandler_->setProgrammingLatency(std::chrono::milliseconds(500));
+  DecisionRouteUpdate routeUpdate1;
+  routeUpdate1.addRouteToUpdate(
+      RibUnicastEntry(toIPNetwork(prefix1), {path1_2_1}));
+  routeUpdatesQueue.push(routeUpdate1);
+  /* sleep override */
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  // prefix2 is added and updated, prefix3 is added and deleted
+  DecisionRouteUpdate routeUpdate2;
+  routeUpdate2.addRouteToUpdate(
+      RibUnicastEntry(toIPNetwork(prefix2), {path1_2_1, path1_2_2}));
+  routeUpdate2.addRouteToUpdate(
+      RibUnicastEntry(toIPNetwork(prefix3), {path1_3_1}));
+  routeUpdatesQueue.push(routeUpdate2);
+  DecisionRouteUpdate routeUpdate3;
+  routeUpdate3.addRouteToUpdate(
+      RibUnicastEntry(toIPNetwork(prefix2), {path1_2_2}));
+  routeUpdate3.unicastRoutesToDelete.emplace_back(toIPNetwork(prefix3));
+  routeUpdatesQueue.push(routeUpdate3);
+
+  // burst is programmed as one net update
+  auto update = fibRouteUpdatesQueueReader.get().value();
+  EXPECT_EQ(1, update.unicastRoutesToUpdate.count(toIPNetwork(prefix1)));
+  update = fibRouteUpdatesQueueReader.get().value();
+  ASSERT_EQ(1, update.unicastRoutesToUpdate.size());
+  EXPECT_EQ(
+      RibUnicastEntry(toIPNetwork(prefix2), {path1_2_2}),
+      update.unicastRoutesToUpdate.at(toIPNetwork(prefix2)));
+
+  // prefix2 is programmed once and prefix3 never
+  EXPECT_EQ(2, mockFibHandler_->getAddRoutesCount());
+  std::vector<thrift::UnicastRoute> routes;
+  mockFibHandler_->getRouteTableByClient(routes, kFibId);
+  EXPECT_EQ(2, routes.size());
+}
+
+class FibDeltaSyncTestFixture : public FibTestFixture {
+ public:
+  FibDeltaSyncTestFixture()
+      : FibTestFixture(
+            1000 /* routeDeleteDelayMs */,
+            0 /* programmingWindow */,
+            1 /* syncChunkSize */) {}
+};
+
+TEST_F(FibDeltaSyncTestFixture, SyncByDifference) {
+  // agent has stale prefix1/label1 and outdated prefix2
+  DecisionRouteUpdate agentRoutes;
+  agentRoutes.addRouteToUpdate(
+      RibUnicastEntry(toIPNetwork(prefix1), {path1_2_1}));
+  agentRoutes.addRouteToUpdate(
+      RibUnicastEntry(toIPNetwork(prefix2), {path1_2_1}));
+  agentRoutes.addRouteToUpdate(
+      RibUnicastEntry(toIPNetwork(prefix3), {path1_3_1, path1_3_2}));
+  agentRoutes.addMplsRouteToUpdate(RibMplsEntry(label1, {mpls_path1_2_1}));
+  auto agentRouteDb = agentRoutes.toThrift();
+  mockFibHandler_->addUnicastRoutes(
+      kFibId_,
+      std::make_unique<std::vector<::openr::thrift::UnicastRoute>>(
+          std::move(*agentRouteDb.unicastRoutesToUpdate_ref())));
+  mockFibHandler_->addMplsRoutes(
+      kFibId_,
+      std::make_unique<std::vector<::openr::thrift::MplsRoute>>(
+          std::move(*agentRouteDb.mplsRoutesToUpdate_ref())));
+  EXPECT_EQ(3, mockFibHandler_->getAddRoutesCount());
+  EXPECT_EQ(1, mockFibHandler_->getAddMplsRoutesCount());
+
+  // prefix3 is up to date, with next-hops in different order
+  DecisionRouteUpdate routeUpdate;
+  routeUpdate.addRouteToUpdate(
+      RibUnicastEntry(toIPNetwork(prefix2), {path1_2_1, path1_2_2}));
+  routeUpdate.addRouteToUpdate(
+      RibUnicastEntry(toIPNetwork(prefix3), {path1_3_2, path1_3_1}));
+  routeUpdate.addRouteToUpdate(
+      RibUnicastEntry(toIPNetwork(prefix4), {path1_2_2}));
+  routeUpdate.addMplsRouteToUpdate(RibMplsEntry(label2, {mpls_path1_2_2}));
+  routeUpdatesQueue.push(routeUpdate);
+
+  // initial full sync is published once done
+  EXPECT_EQ(
+      DecisionRouteUpdate::FULL_SYNC,
+      fibRouteUpdatesQueueReader.get().value().type);
+
+  // only difference is programmed, one route per call
+  EXPECT_EQ(0, mockFibHandler_->getFibSyncCount());
+  EXPECT_EQ(0, mockFibHandler_->getFibMplsSyncCount());
+  EXPECT_EQ(3 + 2, mockFibHandler_->getAddRoutesCount());
+  EXPECT_EQ(1, mockFibHandler_->getDelRoutesCount());
+  EXPECT_EQ(1 + 1, mockFibHandler_->getAddMplsRoutesCount());
+  EXPECT_EQ(1, mockFibHandler_->getDelMplsRoutesCount());
+
+  std::vector<thrift::UnicastRoute> routes;
+  std::vector<thrift::MplsRoute> mplsRoutes;
+  mockFibHandler_->getRouteTableByClient(routes, kFibId);
+  mockFibHandler_->getMplsRouteTableByClient(mplsRoutes, kFibId);
+  std::set<thrift::IpPrefix> prefixes;
+  for (auto const& route : routes) {
+    prefixes.emplace(*route.dest_ref());
+  }
+  EXPECT_EQ(std::set<thrift::IpPrefix>({prefix2, prefix3, prefix4}), prefixes);
+  ASSERT_EQ(1, mplsRoutes.size());
+  EXPECT_EQ(label2, *mplsRoutes.at(0).topLabel_ref());
+}
+
+class FibWarmBootTestFixture : public FibTestFixture {
+ public:
+  FibWarmBootTestFixture()
+      : FibTestFixture(
+            1000 /* routeDeleteDelayMs */,
+            0 /* programmingWindow */,
+            0 /* syncChunkSize */,
+            {} /* priorityClasses */,
+            true /* enableWarmBoot */) {}
+
+ private:
+  // agent has stale prefix1/label1 and outdated prefix2 from before restart
+  void
+  programAgentRoutes() override {
+    DecisionRouteUpdate agentRoutes;
+    agentRoutes.addRouteToUpdate(
+        RibUnicastEntry(toIPNetwork(prefix1), {path1_2_1}));
+    agentRoutes.addRouteToUpdate(
+        RibUnicastEntry(toIPNetwork(prefix2), {path1_2_1}));
+    agentRoutes.addRouteToUpdate(
+        RibUnicastEntry(toIPNetwork(prefix3), {path1_3_1, path1_3_2}));
+    agentRoutes.addMplsRouteToUpdate(RibMplsEntry(label1, {mpls_path1_2_1}));
+    auto agentRouteDb = agentRoutes.toThrift();
+    mockFibHandler_->addUnicastRoutes(
+        kFibId_,
+        std::make_unique<std::vector<::openr::thrift::UnicastRoute>>(
+            std::move(*agentRouteDb.unicastRoutesToUpdate_ref())));
+    mockFibHandler_->addMplsRoutes(
+        kFibId_,
+        std::make_unique<std::vector<::openr::thrift::MplsRoute>>(
+            std::move(*agentRouteDb.mplsRoutesToUpdate_ref())));
+  }
+};
+
+TEST_F(FibWarmBootTestFixture, SyncByDifferenceOnRestart) {
+  // wait for programmed routes to be read on startup
+  while (not fb303::fbData->hasCounter("fib.warm_boot.num_routes")) {
+    /* sleep override */
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(3 + 1, fb303::fbData->getCounter("fib.warm_boot.num_routes"));
+
+  // prefix3 is up to date, with next-hops in different order
+  DecisionRouteUpdate routeUpdate;
+  routeUpdate.type = DecisionRouteUpdate::FULL_SYNC;
+  routeUpdate.addRouteToUpdate(
+      RibUnicastEntry(toIPNetwork(prefix2), {path1_2_1, path1_2_2}));
+  routeUpdate.addRouteToUpdate(
+      RibUnicastEntry(toIPNetwork(prefix3), {path1_3_2, path1_3_1}));
+  routeUpdate.addRouteToUpdate(
+      RibUnicastEntry(toIPNetwork(prefix4), {path1_2_2}));
+  routeUpdate.addMplsRouteToUpdate(RibMplsEntry(label2, {mpls_path1_2_2}));
+  routeUpdatesQueue.push(routeUpdate);
+
+  // initial full sync is published once done
+  EXPECT_EQ(
+      DecisionRouteUpdate::FULL_SYNC,
+      fibRouteUpdatesQueueReader.get().value().type);
+
+  // only difference is programmed, tables are never replaced
+  EXPECT_EQ(0, mockFibHandler_->getFibSyncCount());
+  EXPECT_EQ(0, mockFibHandler_->getFibMplsSyncCount());
+  EXPECT_EQ(3 + 2, mockFibHandler_->getAddRoutesCount());
+  EXPECT_EQ(1, mockFibHandler_->getDelRoutesCount());
+  EXPECT_EQ(1 + 1, mockFibHandler_->getAddMplsRoutesCount());
+  EXPECT_EQ(1, mockFibHandler_->getDelMplsRoutesCount());
+
+  std::vector<thrift::UnicastRoute> routes;
+  mockFibHandler_->getRouteTableByClient(routes, kFibId);
+  std::set<thrift::IpPrefix> prefixes;
+  for (auto const& route : routes) {
+    prefixes.emplace(*route.dest_ref());
+  }
+  EXPECT_EQ(std::set<thrift::IpPrefix>({prefix2, prefix3, prefix4}), prefixes);
+  EXPECT_EQ(3, getRouteDb().unicastRoutes_ref()->size());
+}
+
+namespace {
+std::vector<thrift::FibPriorityClass>
+getPriorityClasses() {
+  thrift::FibPriorityClass loopbacks;
+  loopbacks.name_ref() = "loopback";
+  loopbacks.prefixes_ref() = {"::ffff:10.1.1.0/120"};
+  thrift::FibPriorityClass tagged;
+  tagged.name_ref() = "tagged";
+  tagged.tags_ref() = {"TAG_PRIO"};
+  return {loopbacks, tagged};
+}
+} // namespace
+
+class FibPriorityClassTestFixture : public FibTestFixture {
+ public:
+  FibPriorityClassTestFixture()
+      : FibTestFixture(
+            1000 /* routeDeleteDelayMs */,
+            0 /* programmingWindow */,
+            0 /* syncChunkSize */,
+            getPriorityClasses()) {}
+};
+
+TEST_F(FibPriorityClassTestFixture, ProgrammingOrder) {
+  // initial syncFib
+  routeUpdatesQueue.push(DecisionRouteUpdate());
+  mockFibHandler_->waitForSyncFib();
+  EXPECT_EQ(
+      DecisionRouteUpdate::FULL_SYNC,
+      fibRouteUpdatesQueueReader.get().value().type);
+
+  // prefix1 is covered by loopback class, prefix3 is tagged and prefix2 has
+  // no class
+  auto taggedEntry = createPrefixEntry(prefix3);
+  taggedEntry.tags_ref() = {"TAG_PRIO"};
+  DecisionRouteUpdate routeUpdate;
+  routeUpdate.addRouteToUpdate(
+      RibUnicastEntry(toIPNetwork(prefix2), {path1_2_1}));
+  routeUpdate.addRouteToUpdate(RibUnicastEntry(
+      toIPNetwork(prefix3), {path1_3_1}, taggedEntry, kTestingAreaName));
+  routeUpdate.addRouteToUpdate(
+      RibUnicastEntry(toIPNetwork(prefix1), {path1_2_2}));
+  routeUpdate.perfEvents = thrift::PerfEvents();
+  addPerfEvent(*routeUpdate.perfEvents, "node-1", "DECISION_DEBOUNCE");
+  routeUpdatesQueue.push(routeUpdate);
+
+  // classes are programmed in separate calls, in order of priority
+  auto update = fibRouteUpdatesQueueReader.get().value();
+  EXPECT_EQ(3, update.unicastRoutesToUpdate.size());
+  EXPECT_EQ(3, mockFibHandler_->getAddRoutesCount());
+  ASSERT_TRUE(update.perfEvents.has_value());
+  std::vector<std::string> eventDescrs;
+  for (auto const& event : *update.perfEvents->events_ref()) {
+    eventDescrs.emplace_back(*event.eventDescr_ref());
+  }
+  EXPECT_EQ(
+      std::vector<std::string>(
+          {"DECISION_DEBOUNCE",
+           "FIB_ROUTE_DB_RECVD",
+           "FIB_loopback_ROUTES_PROGRAMMED",
+           "FIB_tagged_ROUTES_PROGRAMMED",
+           "FIB_default_ROUTES_PROGRAMMED"}),
+      eventDescrs);
+
+  // convergence with per class latency is recorded in perf db
+  auto perfDb = fib_->getPerfDb().get();
+  ASSERT_EQ(1, perfDb->eventInfo_ref()->size());
+  EXPECT_EQ(
+      eventDescrs.size() + 1,
+      perfDb->eventInfo_ref()->at(0).events_ref()->size());
+}
+
+TEST_F(FibTestFixture, ConvergenceHistograms) {
+  // initial syncFib
+  routeUpdatesQueue.push(DecisionRouteUpdate());
+  mockFibHandler_->waitForSyncFib();
+  EXPECT_EQ(
+      DecisionRouteUpdate::FULL_SYNC,
+      fibRouteUpdatesQueueReader.get().value().type);
+
+  DecisionRouteUpdate routeUpdate;
+  routeUpdate.addRouteToUpdate(
+      RibUnicastEntry(toIPNetwork(prefix2), {path1_2_1}));
+  routeUpdate.perfEvents = thrift::PerfEvents();
+  addPerfEvent(*routeUpdate.perfEvents, "node-1", "DECISION_DEBOUNCE");
+  routeUpdatesQueue.push(routeUpdate);
+  fibRouteUpdatesQueueReader.get().value();
+
+  // percentiles of total and per stage duration are exported
+  auto counters = fb303::fbData->getCounters();
+  for (auto const& key :
+       {"fib.convergence.total.time_ms",
+        "fib.convergence.FIB_ROUTE_DB_RECVD.time_ms",
+        "fib.convergence.OPENR_FIB_ROUTES_PROGRAMMED.time_ms"}) {
+    for (auto const& pct : {"p50", "p90", "p99"}) {
+      EXPECT_EQ(1, counters.count(fmt::format("{}.{}", key, pct)));
+    }
+  }
+}
+
+TEST_F(FibTestFixture, RouteStateMemoryUsage) {
+  DecisionRouteUpdate routeUpdate;
+  routeUpdate.addRouteToUpdate(
+      RibUnicastEntry(toIPNetwork(prefix1), {path1_2_1, path1_2_2}));
+  routeUpdate.addRouteToUpdate(
+      RibUnicastEntry(toIPNetwork(prefix2), {path1_2_1, path1_2_2}));
+  routeUpdate.addMplsRouteToUpdate(RibMplsEntry(label1, {mpls_path1_2_1}));
+  routeUpdatesQueue.push(routeUpdate);
+  fibRouteUpdatesQueueReader.get().value();
+
+  // routes share interned next-hop group, only tables are accounted for
+  auto const bytes = fb303::fbData->getCounter("fib.route_state.bytes");
+  EXPECT_GE(bytes, 3 * sizeof(RibMplsEntry));
+  EXPECT_EQ(
+      bytes / 3, fb303::fbData->getCounter("fib.route_state.bytes_per_route"));
+}
+
+/**
+ * Verify dirty route keys are returned once due, re-marked keys only at their
+ * latest due time, and skipped keys stay dirty
+ */
+TEST(FibDirtyRouteKeysTest, PopDue) {
+  Fib::DirtyRouteKeys<uint32_t> dirtyLabels;
+  auto const now = std::chrono::steady_clock::now();
+  auto const later = now + std::chrono::seconds(10);
+  auto const noSkip = [](uint32_t) { return false; };
+
+  dirtyLabels.insert_or_assign(1, now);
+  dirtyLabels.insert_or_assign(2, later);
+  dirtyLabels.insert_or_assign(3, now);
+  // re-marked key is due at the latest time only
+  dirtyLabels.insert_or_assign(3, later);
+  // already dirty key is left as is
+  dirtyLabels.emplace(1, later);
+  EXPECT_EQ(3, dirtyLabels.size());
+  EXPECT_EQ(now, dirtyLabels.getNextDueTime());
+
+  EXPECT_EQ(std::vector<uint32_t>{1}, dirtyLabels.popDue(now, noSkip));
+  EXPECT_EQ(2, dirtyLabels.size());
+  EXPECT_EQ(later, dirtyLabels.getNextDueTime());
+
+  // skipped key stays dirty
+  auto dueLabels =
+      dirtyLabels.popDue(later, [](uint32_t label) { return label == 2; });
+  EXPECT_EQ(std::vector<uint32_t>{3}, dueLabels);
+  EXPECT_EQ(1, dirtyLabels.size());
+
+  EXPECT_EQ(std::vector<uint32_t>{2}, dirtyLabels.popDue(later, noSkip));
+  EXPECT_TRUE(dirtyLabels.empty());
+  EXPECT_EQ(
+      std::chrono::steady_clock::time_point::max(),
+      dirtyLabels.getNextDueTime());
+}
+
 TEST_F(FibTestFixture, WaitOnDecision) {
   // Make sure fib starts with clean route database
   std::vector<thrift::UnicastRoute> routes;
@@ -1181,7 +1607,7 @@ TEST_F(FibTestFixture, getUnicastRoutesFilteredTest) {
 }
 
 TEST_F(FibTestFixture, longestPrefixMatchTest) {
-  std::unordered_map<folly::CIDRNetwork, RibUnicastEntry> unicastRoutes;
+  RibUnicastEntries unicastRoutes;
   const auto& defaultRoute = toIpPrefix("::/0");
   const auto& dbPrefix1 = toIpPrefix("192.168.0.0/16");
   const auto& dbPrefix2 = toIpPrefix("192.168.0.0/20");
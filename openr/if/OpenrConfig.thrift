@@ -55,6 +55,13 @@ struct KvstoreConfig {
   1: i32 key_ttl_ms = 300000;
   2: i32 sync_interval_s = 60;
   3: i32 ttl_decrement_ms = 1;
+
+  /**
+   * Rate limit flooding of key-vals, applied to each peer independently.
+   * Updates blocked for a peer are buffered (coalescing superseded versions
+   * of a key) without holding back flooding to other peers. Applied live
+   * when config is reloaded on SIGHUP.
+   */
   4: optional KvstoreFloodRate flood_rate;
 
   /**
@@ -94,6 +101,102 @@ struct KvstoreConfig {
    */
   9: optional bool is_flood_root;
 
+  /**
+   * Set this true to exchange merkle tree digests of KvStore keyspace with
+   * peers before full-sync. Only hashes of diverged key-buckets will then be
+   * exchanged, and full-sync is skipped entirely if both stores are in sync.
+   * Falls back to legacy full-sync if peer doesn't support it.
+   */
+  10: optional bool enable_merkle_sync;
+
+  /**
+   * Set this true to run KvStoreDb of every area on its own dedicated thread,
+   * so that merging, flooding and TTL handling of different areas no longer
+   * contend for a single core. Not supported along with
+   * enable_flood_optimization.
+   */
+  11: optional bool enable_per_area_thread;
+
+  /**
+   * Set this true to flood TTL refreshes to thrift peers as compact batches of
+   * (key, version, ttlVersion, ttl, hash) tuples, coalesced per peer over a
+   * short flood interval, instead of TTL-only key-values. ALL nodes in the
+   * network must support `setKvStoreTtlUpdates` before turning it on.
+   */
+  12: optional bool enable_compact_ttl_flood;
+
+  /**
+   * Set this true to split the keyspace (by merkle bucket) across peers on
+   * cold start, fetching each range from a single peer in parallel instead of
+   * a complete dump from every peer. Range of a peer failing mid-transfer is
+   * re-fetched from another peer.
+   */
+  13: optional bool enable_partitioned_initial_sync;
+
+  /**
+   * Set this true to receive full-sync responses from thrift peers as a
+   * stream of bounded-size chunks, merged as they arrive, instead of a single
+   * publication of the complete keyspace. Falls back to the unary full-sync
+   * if peer doesn't support it.
+   */
+  14: optional bool enable_streaming_full_sync;
+
+  /**
+   * zstd dictionaries for compression of KvStore values, as map of key
+   * prefix (e.g. "adj:", "prefix:") to dictionary file trained offline on
+   * sample values via `zstd --train`. Values set via KvStore client for keys
+   * matching one of the prefixes are flooded and stored compressed, and
+   * transparently decompressed for local modules.
+   * ATTN: every node of the network MUST be configured with the same
+   * dictionaries before enabling this on any node.
+   */
+  15: optional map<string, string> value_compression_dictionaries;
+
+  /**
+   * Set this true to keep a bounded change-log of recent value updates, and
+   * to resync with a reconnecting thrift peer by fetching ONLY keys changed
+   * since the last sync with it. Falls back to full-sync if the change-log of
+   * peer no longer covers it (e.g. too many updates or peer restarted).
+   */
+  16: optional bool enable_incremental_sync;
+
+  /**
+   * Path prefix of on-disk KvStore snapshots, one file per area suffixed by
+   * area name. If set, KvStore periodically writes its key-vals to the
+   * snapshot and seeds itself from it (with TTLs adjusted for the elapsed
+   * time) on restart. Once seeded, Decision computes routes without waiting
+   * for peers to finish full-sync (or `eor_time_s`), hence routes retained by
+   * the agent are re-programmed by delta only, see `enable_fib_warm_boot`.
+   * Regular full-sync with peers reconciles stale key-vals.
+   */
+  17: optional string warm_start_snapshot_path;
+
+  /**
+   * Set this true to make flood topology follow peer flaps incrementally.
+   * On peer up/down, only flood-roots whose feasible successor is affected
+   * by the flapped peer run DUAL local or diffusing computation, and the
+   * periodic flood topology dump only logs SPT changes since the last dump.
+   * Only effective along with enable_flood_optimization.
+   */
+  18: optional bool enable_incremental_flood_topo;
+
+  /**
+   * Version of hash generated for key-vals. 1 (default) is the legacy hash,
+   * 2 is a cheaper single-pass hash which is computed once by the originator
+   * and carried along with flooded values instead of being recomputed on
+   * every hop. Hashes are compared across nodes, hence 2 must be enabled on
+   * ALL nodes of the network at once.
+   */
+  19: optional i32 value_hash_version;
+
+  /**
+   * Max number of flooding RPCs in flight to each thrift peer. Once reached,
+   * updates to the peer are buffered (coalescing superseded versions of a
+   * key) and flooded as one merged RPC as soon as an outstanding one
+   * completes. Unset or 0 leaves the number unbounded.
+   */
+  20: optional i32 flood_window_size;
+
   /**
   * Set buffering size for KvStore socket communication. Updates to neighbor node during
   * flooding can be buffered upto this number. For larger networks where burst of updates
@@ -205,13 +308,63 @@ struct DecisionConfig {
   (in milliseconds). */
   1: i32 debounce_min_ms = 10;
   /** Decision debounce time to update SPF in frequent adj db update
-    (in milliseconds). */
+    (in milliseconds). Both debounce times are applied live when config is
+    reloaded on SIGHUP. */
   2: i32 debounce_max_ms = 250;
+  /** Number of threads computing SPF of different areas, second shortest
+  paths of KSP2_ED_ECMP prefixes and routes of disjoint prefix sets in
+  parallel. 0 computes everything on the Decision thread. */
+  3: i32 spf_threads = 0;
+  /** Rebuild routes right away, without waiting for debounce, as soon as an
+  adjacency of this node goes down. Other updates are still debounced. */
+  4: bool enable_urgent_local_adj_down = false;
+  /** Compute loop-free alternates (RFC 5286) of IP routes and attach them
+  to routes as backup next-hops. */
+  5: bool enable_lfa = false;
+  /** Memory budget (estimated, in bytes) of memoized shortest paths per
+  area. Least recently used ones are evicted after route computation.
+  0 leaves memoization unbounded. */
+  6: i64 spf_memoization_budget_bytes = 0;
+  /** Deserialize KvStore publications on a dedicated ingest thread, so that
+  parsing of a burst overlaps route computation on the Decision thread.
+  Parsed deltas are applied to link/prefix state between route rebuilds. */
+  7: bool enable_pipelined_ingest = false;
 
   /** Knob to enable/disable BGP route programming. */
   101: bool enable_bgp_route_programming = true;
 }
 
+/**
+ * Dampening of flapping adjacencies, similar to BGP route flap dampening
+ * (RFC 2439). Each adjacency accumulates a penalty on every down event and
+ * on every change of its (quantized) RTT metric. The penalty decays
+ * exponentially with configured half life. Once it exceeds the suppress
+ * threshold, adjacency is suppressed until penalty decays below the reuse
+ * threshold. While suppressed, a newly formed adjacency is not advertised
+ * and an already advertised adjacency keeps its last advertised metric.
+ * Down events are always advertised right away.
+ */
+struct AdjacencyDampeningConfig {
+  /** Penalty added when adjacency goes down */
+  1: i32 flap_penalty = 1000;
+  /** Penalty added when RTT metric of adjacency changes */
+  2: i32 metric_change_penalty = 250;
+  /** Suppress adjacency when penalty exceeds this value */
+  3: i32 suppress_threshold = 2000;
+  /** Un-suppress adjacency when penalty decays below this value */
+  4: i32 reuse_threshold = 750;
+  /** Time (in seconds) for the penalty to decay to half of its value */
+  5: i32 half_life_s = 60;
+  /** Upper bound of the penalty, hence of the suppression time */
+  6: i32 max_penalty = 8000;
+  /**
+   * RTT metric is rounded to nearest multiple of this value before it is
+   * compared with current metric. Jitter of measured RTT within the quantum
+   * neither penalizes nor re-advertises adjacency.
+   */
+  7: i32 metric_quantum = 1;
+}
+
 struct LinkMonitorConfig {
   /**
    * When link goes down after being stable/up for long time, then the backoff
@@ -249,6 +402,20 @@ struct LinkMonitorConfig {
   * Enable convergence performance measurement for adjacency updates.
   */
   7: bool enable_perf_measurement = true;
+
+  /**
+   * Advertise each adjacency in its own KvStore key
+   * "adj:<node>:<otherNode>:<ifName>" instead of the whole adjacency database
+   * in "adj:<node>". A single adjacency change then floods only the affected
+   * key. Nodes running older versions do not understand these keys, hence
+   * enable only once all nodes in the network are upgraded.
+   */
+  8: bool enable_per_adjacency_keys = false;
+
+  /**
+   * Dampen flapping adjacencies and RTT metric churn. Disabled if not set.
+   */
+  9: optional AdjacencyDampeningConfig adjacency_dampening_config;
 }
 
 struct StepDetectorConfig {
@@ -286,6 +453,23 @@ struct SparkConfig {
   6: i32 graceful_restart_time_s = 30;
 
   7: StepDetectorConfig step_detector_conf;
+
+  /**
+   * If set, SparkHeartbeatMsg send/receive and heartbeat hold-timers are
+   * handled by a dedicated high priority thread, independent of hello and
+   * handshake processing in Spark. This allows to use aggressive
+   * keepalive_time_s/hold_time_s without risking false neighbor down events
+   * when Spark is busy.
+   */
+  8: bool enable_heartbeat_thread = false;
+
+  /**
+   * If set, heartbeat thread sends SparkHeartbeatMsg of all interfaces with a
+   * single sendmmsg() syscall per keepalive_time_s instead of one sendmsg()
+   * per interface. Reduces syscall overhead on nodes with many interfaces.
+   * Only effective with enable_heartbeat_thread.
+   */
+  9: bool enable_batched_heartbeat_send = false;
 }
 
 struct WatchdogConfig {
@@ -300,6 +484,22 @@ struct WatchdogConfig {
    * useful to guarantee protocol doesn’t cause trouble to other services on
    * device where it runs and takes care of slow memory leak kind of issues. */
   3: i32 max_memory_mb = 800;
+  /**
+   * If set, watchdog captures a CPU profile of an event base thread showing no
+   * activity for longer than this, ahead of crashing it on thread_timeout_s.
+   * MUST be smaller than thread_timeout_s. */
+  4: optional i32 cpu_profile_stall_s;
+  /**
+   * If set, event base threads log and count callbacks running for this long
+   * or longer, to spot modules saturating their thread. */
+  5: optional i32 slow_callback_threshold_ms;
+  /**
+   * If set, above this amount of memory in mega-bytes Open/R enters memory
+   * pressure. Modules then shed optional memory, e.g. SPF memoization, perf
+   * events and caches, and refuse new ctrl stream subscriptions, in order to
+   * degrade gracefully rather than reaching max_memory_mb. MUST be smaller
+   * than max_memory_mb. */
+  6: optional i32 soft_memory_mb;
 }
 
 struct MonitorConfig {
@@ -361,6 +561,24 @@ struct ThriftServerConfig {
   9: optional string ticket_seed_path;
   /** Verify type for client when enabling secure server. */
   10: optional VerifyClientType verify_client_type;
+  /**
+   * Number of threads serving OpenrCtrl requests of normal priority, e.g.
+   * operator queries and dumps.
+   */
+  11: i32 num_ctrl_threads = 1;
+  /**
+   * Number of threads serving high priority OpenrCtrl requests, i.e. KvStore
+   * peer-sync and flooding RPCs. Dedicated pool ensures that a heavy dump of
+   * an operator can't delay full-sync with a peer.
+   */
+  12: i32 num_peer_sync_threads = 1;
+  /**
+   * Responses and stream chunks smaller than this many bytes are sent
+   * uncompressed, even to clients asking for compression. Compression is
+   * negotiated per connection by the client, e.g. remote subscribers of
+   * KvStore or Fib streams over WAN.
+   */
+  13: optional i32 min_compress_bytes;
 }
 
 struct ThriftClientConfig {
@@ -412,6 +630,15 @@ struct PrefixAllocationConfig {
    * set as 80, /80 prefix will be elected for a node. e.g. face:b00c:0:0:1234::/80
    */
   6: optional i32 allocate_prefix_len;
+
+  /**
+   * Set this true for fast allocation from large prefix pools, e.g. when
+   * thousands of leaves boot at once. Initial prefix index is a stable hash
+   * of the node name, and on collision the next index not known to be taken
+   * in KvStore is claimed (linear probing), instead of a random one. Keeps
+   * allocation churn flooded through KvStore to a minimum.
+   */
+  7: optional bool enable_fast_allocation;
 }
 
 struct OriginatedPrefix {
@@ -603,6 +830,8 @@ struct SegmentRoutingConfig {
  *  }
  * ```
  *
+ * Regexes of an existing area are applied live when config is reloaded on
+ * SIGHUP. Adding or removing areas takes effect on restart only.
  */
 
 struct AreaConfig {
@@ -718,6 +947,50 @@ struct BgpRouteTranslationConfig {
   11: bool enable_path_pref_to_local_pref_translation = 0;
 } (cpp.minimize_padding)
 
+/**
+ * Class of routes programmed by Fib ahead of the routes of lower classes.
+ * A route belongs to the first class one of whose prefixes covers it, or
+ * whose tags contain any of its best PrefixEntry tags.
+ */
+struct FibPriorityClass {
+  /** Name of the class, used in perf event and counter names */
+  1: string name;
+
+  /** Prefixes covering the routes of this class, e.g. loopbacks */
+  2: list<string> prefixes = [];
+
+  /** PrefixEntry tags of the routes of this class */
+  3: set<string> tags = [];
+}
+
+/**
+ * CPU placement and scheduling of a module thread, applied by the thread
+ * itself on start. Failure to apply is logged, not fatal.
+ */
+struct ThreadSchedulingConfig {
+  /**
+   * CPUs the thread may run on. Empty allows all CPUs, or all CPUs of
+   * `numa_node` if set.
+   */
+  1: list<i32> cpus = [];
+
+  /**
+   * Restrict the thread to the CPUs of this NUMA node, intersected with
+   * `cpus` if non-empty. Memory is then allocated on the node by first touch
+   * of the thread, as every module allocates from its own arena.
+   */
+  2: optional i32 numa_node;
+
+  /** Nice value of the thread in [-20, 19], under SCHED_OTHER */
+  3: optional i32 nice;
+
+  /**
+   * Run the thread under SCHED_FIFO with this priority in [1, 99]. Mutually
+   * exclusive with `nice`. Requires CAP_SYS_NICE.
+   */
+  4: optional i32 fifo_priority;
+}
+
 struct OpenrConfig {
   1: string node_name;
   /** Deprecated. Use area config. */
@@ -940,6 +1213,87 @@ struct OpenrConfig {
    */
   60: i32 route_delete_delay_ms = 1000;
 
+  /**
+   * Max number of route update batches in flight to FibService. Updates
+   * received while batches are in flight are coalesced per prefix/label and
+   * sent with the next batch, routes of the same prefix/label are never in
+   * two batches at once. 0 programs each update synchronously.
+   */
+  61: i32 fib_programming_window = 0;
+
+  /**
+   * Full sync of routes with FibService by difference. If non-zero, route
+   * tables of the agent are retrieved and only routes which differ are
+   * added/deleted, in calls of at most this many routes. 0 replaces complete
+   * tables with a single syncFib/syncMplsFib call.
+   */
+  62: i32 fib_sync_chunk_size = 0;
+
+  /**
+   * Priority classes of routes in decreasing order of priority. Fib programs
+   * the unicast route additions of each class in a separate FibService call,
+   * before those of the next class. Routes matching no class come last.
+   * Programming latency of each class is reported with perf events.
+   */
+  63: list<FibPriorityClass> fib_priority_classes = [];
+
+  /**
+   * Warm boot of Fib. On startup the routes currently programmed by the agent
+   * are read and treated as the initial route state. The first sync with
+   * routes from Decision then only adds/deletes routes which differ, in calls
+   * of at most fib_sync_chunk_size routes if non-zero, and never replaces
+   * complete tables.
+   */
+  64: bool enable_fib_warm_boot = false;
+
+  /**
+   * Program unicast routes in Linux via kernel nexthop objects (Linux 5.3+).
+   * Each unique set of nexthops is programmed once as a nexthop group and
+   * routes refer to it by ID, instead of every route carrying its nexthops.
+   * Only applicable to the netlink FIB agent started by Open/R.
+   */
+  65: bool enable_kernel_nexthop_objects = false;
+
+  /**
+   * Number of additional netlink sockets used for programming routes. Routes
+   * are sharded across them by prefix, which keeps acks of route updates off
+   * the socket receiving netlink events. 0 programs routes over the event
+   * socket. Not used along with `enable_kernel_nexthop_objects` as nexthop
+   * objects and routes referring them need to be programmed in order.
+   */
+  66: i32 netlink_route_sockets = 0;
+
+  /**
+   * Advertise prefix keys in compact format, i.e. with binary encoded prefix
+   * instead of IP address string, which reduces key size in KvStore and in
+   * every message carrying keys. Takes precedence over
+   * `enable_new_prefix_format`.
+   * ATTN: Nodes before version `kOpenrCompactPrefixKeyVersion` can't parse
+   * compact keys. Only enable once all nodes in the network support it.
+   */
+  67: bool enable_compact_prefix_key = false;
+
+  /**
+   * CPU placement and scheduling of module threads, keyed by module thread
+   * name, e.g. `spark`, `fib`, `kvstore`, `decision`, `link_monitor`,
+   * `prefix_manager`, `netlink`. E.g. pin Spark and Fib to isolated cores,
+   * away from the forwarding agent, while KvStore and Decision stay on shared
+   * ones. Threads not listed are scheduled by the kernel as usual.
+   */
+  68: map<string, ThreadSchedulingConfig> thread_scheduling = {};
+
+  /**
+   * Pack prefixes advertised into each area into this many KvStore keys,
+   * "prefix:<node>:#<bucket>", instead of one key per prefix. Prefixes are
+   * assigned to buckets by hash, and each key carries PrefixDatabase with all
+   * prefixes of its bucket. Cuts keys to refresh, flood and compare in full
+   * syncs by orders of magnitude, at the cost of re-flooding the bucket on
+   * any change of its prefixes. 0 advertises one key per prefix.
+   * ATTN: Nodes before version `kOpenrPrefixDbBucketKeyVersion` can't parse
+   * bucket keys. Only enable once all nodes in the network support it.
+   */
+  69: i32 prefix_db_buckets = 0;
+
   # vip thrift injection service
   90: optional bool enable_vip_service;
   91: optional vip_service_config.VipServiceConfig vip_service_config;
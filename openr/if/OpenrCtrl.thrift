@@ -187,6 +187,8 @@ struct RibPolicy {
 struct UnicastRouteDetail {
   1: Network.UnicastRoute unicastRoute (cpp.mixin);
   2: optional Types.PrefixEntry bestRoute;
+  // loop-free alternates of next-hops, if computed
+  3: list<Network.NextHopThrift> backupNextHops;
 }
 
 /*
@@ -218,9 +220,29 @@ struct RouteDatabaseDeltaDetail {
   4: list<i32> mplsRoutesToDelete;
 }
 
+/*
+ * Hypothetical changes to the topology of all areas, e.g. maintenance to
+ * validate before carrying it out
+ */
+struct RouteSimulationRequest {
+  /**
+   * Nodes to drain, i.e. set overloaded
+   */
+  1: set<string> drainNodes;
+
+  /**
+   * Nodes to take down along with all of their adjacencies
+   */
+  2: set<string> downNodes;
+}
+
 /**
  * Thrift service - exposes RPC APIs for interaction with all of Open/R's
  * modules.
+ *
+ * APIs used by KvStore peers for syncing and flooding are annotated with HIGH
+ * priority and get served by a dedicated thread pool, separate from the one
+ * serving operator queries. See `ThriftServerConfig`.
  */
 service OpenrCtrl extends fb303_core.BaseService {
   //
@@ -359,6 +381,17 @@ service OpenrCtrl extends fb303_core.BaseService {
     1: OpenrError error,
   );
 
+  /**
+   * Get changes of the current node's routes if given changes to the topology
+   * were applied. Routes are computed on a snapshot of Decision state without
+   * affecting programmed routes.
+   *
+   * @throws OpenrError if any of the nodes is unknown
+   */
+  Types.RouteDatabaseDelta getRouteDbSimulated(
+    1: RouteSimulationRequest request,
+  ) throws (1: OpenrError error);
+
   /**
    * Get unicast routes after applying a list of prefix filter.
    * Perform longest prefix match for each input filter among the prefixes
@@ -470,7 +503,7 @@ service OpenrCtrl extends fb303_core.BaseService {
   Types.Publication getKvStoreKeyValsFilteredArea(
     1: Types.KeyDumpParams filter,
     2: string area,
-  ) throws (1: OpenrError error);
+  ) throws (1: OpenrError error) (priority = 'HIGH');
 
   /**
    * Get kvstore metadata (no values) with filter
@@ -487,13 +520,30 @@ service OpenrCtrl extends fb303_core.BaseService {
     2: string area,
   ) throws (1: OpenrError error);
 
+  /**
+   * Get merkle tree digests of KvStore keyspace in an area. Used by peers to
+   * find out diverged key-buckets before exchanging key-hashes on full-sync.
+   */
+  Types.KvStoreMerkleDigests getKvStoreMerkleDigestsArea(
+    1: string area,
+  ) throws (1: OpenrError error) (priority = 'HIGH');
+
   /**
    * Set/Update key-values in KvStore.
    */
   void setKvStoreKeyVals(
     1: Types.KeySetParams setParams,
     2: string area,
-  ) throws (1: OpenrError error);
+  ) throws (1: OpenrError error) (priority = 'HIGH');
+
+  /**
+   * Refresh TTLs of existing key-values in KvStore with compact batch of TTL
+   * updates. Used by peers for flooding TTL refreshes.
+   */
+  void setKvStoreTtlUpdates(
+    1: Types.KvStoreTtlUpdates ttlUpdates,
+    2: string area,
+  ) throws (1: OpenrError error) (priority = 'HIGH');
 
   /**
    * Long poll API to get KvStore
@@ -516,7 +566,7 @@ service OpenrCtrl extends fb303_core.BaseService {
   void processKvStoreDualMessage(
     1: Types.DualMessages messages,
     2: string area,
-  ) throws (1: OpenrError error);
+  ) throws (1: OpenrError error) (priority = 'HIGH');
 
   /**
    * Set flood-topology parameters. Called by neighbors
@@ -524,7 +574,7 @@ service OpenrCtrl extends fb303_core.BaseService {
   void updateFloodTopologyChild(
     1: Types.FloodTopoSetParams params,
     2: string area,
-  ) throws (1: OpenrError error);
+  ) throws (1: OpenrError error) (priority = 'HIGH');
 
   /**
    * Get spanning tree information
@@ -625,6 +675,21 @@ service OpenrCtrl extends fb303_core.BaseService {
     1: AdjacenciesFilter filter,
   ) throws (1: OpenrError error);
 
+  /**
+   * Get flap dampening state of adjacencies with penalty history. Empty if
+   * adjacency dampening is not enabled.
+   */
+  list<Types.AdjacencyDampeningState> getAdjacencyDampeningState() throws (
+    1: OpenrError error,
+  );
+
+  /**
+   * Get latest spans traced at hot-path points of route convergence, from
+   * KvStore receive to FIB programmed, oldest first. Buffer holds up to
+   * `Constants::kHotPathTraceSize` spans.
+   */
+  list<Types.TraceSpan> getTraceSpans() throws (1: OpenrError error);
+
   /**
    * Command to request OpenR version
    */
@@ -681,6 +746,19 @@ service OpenrCtrl extends fb303_core.BaseService {
   // Get log events
   list<string> getEventLogs() throws (1: OpenrError error);
 
+  /**
+   * Take a sampling CPU profile for `durationMs` and return path of the
+   * written pprof compatible profile on the node, once done. Profile covers
+   * all Open/R threads if `threadName` is empty, else only threads named so,
+   * e.g. `openr-decision`.
+   *
+   * @throws OpenrError if duration is out of range, no thread is named
+   * `threadName` or another CPU profile is running
+   */
+  string dumpCpuProfile(1: i64 durationMs, 2: string threadName) throws (
+    1: OpenrError error,
+  );
+
   // Get Openr Node Name
   string getMyNodeName();
 
@@ -48,6 +48,35 @@ service OpenrCtrlCpp extends OpenrCtrl.OpenrCtrl {
    * are also in snapshot.
    */
 
+  /**
+   * Streaming version of `getKvStoreKeyValsFilteredArea` used for full-sync
+   * between peers. Response is split into chunks of bounded size, each
+   * carrying its share of `keyVals` and `tobeUpdatedKeys`. Stream completes
+   * after the last chunk.
+   */
+  stream<Types.Publication> getKvStoreKeyValsFilteredAreaStream(
+    1: Types.KeyDumpParams filter,
+    2: string area,
+  ) (priority = 'HIGH');
+
+  /**
+   * Streaming versions of large dump APIs. Response is built off a snapshot
+   * taken on the owning module, outside of its thread, and split into chunks
+   * of at most `Constants::kCtrlStreamChunkSize` routes. Stream completes
+   * after the last chunk, hence an empty dump yields no chunk.
+   */
+  // Chunks of `getRouteDb`, each carrying `thisNodeName`
+  stream<Types.RouteDatabase> getRouteDbStream();
+  // Chunks of `getRouteDetailDb`, each carrying `thisNodeName`
+  stream<OpenrCtrl.RouteDatabaseDetail> getRouteDetailDbStream();
+  // Chunks of `getReceivedRoutesFiltered`
+  stream<list<OpenrCtrl.ReceivedRouteDetail>> getReceivedRoutesStream(
+    1: OpenrCtrl.ReceivedRouteFilter filter,
+  );
+  // Chunks of `getDecisionPrefixDbs`. Prefix entries of a node may span
+  // multiple chunks and need to be merged by the client.
+  stream<Types.PrefixDbs> getDecisionPrefixDbsStream();
+
   Types.RouteDatabase, stream<Types.RouteDatabaseDelta> subscribeAndGetFib();
   OpenrCtrl.RouteDatabaseDetail, stream<
     OpenrCtrl.RouteDatabaseDeltaDetail
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+namespace cpp2 openr.thrift
+namespace py3 openr.thrift
+namespace wiki Open_Routing.Thrift_APIs.PlatformCpp
+
+include "openr/if/Network.thrift"
+include "openr/if/Platform.thrift"
+
+/**
+ * Extends FibService and implements stream APIs as streams are only
+ * supported in C++
+ */
+service FibServiceCpp extends Platform.FibService {
+  /**
+   * Streaming versions of `getRouteTableByClient` and
+   * `getMplsRouteTableByClient`. Routes are sent in chunks of bounded size as
+   * they're read from the kernel, instead of being collected into one list.
+   * Stream completes after the last chunk.
+   */
+  stream<list<Network.UnicastRoute>> getRouteTableByClientStream(
+    1: i16 clientId,
+  );
+  stream<list<Network.MplsRoute>> getMplsRouteTableByClientStream(
+    1: i16 clientId,
+  );
+}
@@ -59,6 +59,37 @@ struct PerfEvents {
   1: list<PerfEvent> events;
 }
 
+/**
+ * Span of work traced at a hot-path point of route convergence, e.g. KvStore
+ * merge, SPF of an area or FIB programming. See `HotPathTrace`.
+ */
+struct TraceSpan {
+  /**
+   * Name of traced point, e.g. "kvstore.merge"
+   */
+  1: string name;
+
+  /**
+   * Area the work is done for. Empty if not area specific
+   */
+  2: string area;
+
+  /**
+   * Start of span, in microseconds since epoch
+   */
+  3: i64 startUnixTsUs = 0;
+
+  /**
+   * Duration of span in microseconds
+   */
+  4: i64 durationUs = 0;
+
+  /**
+   * Number of items processed within span, e.g. keys or routes
+   */
+  5: i64 count = 0;
+}
+
 /**
  * InterfaceDb is the entire interface state for this system providing link
  * status and IPv4 / IPv6 LinkLocal addresses. Spark subscribes the interface
@@ -688,6 +719,38 @@ struct KeySetParams {
   7: optional i64 timestamp_ms;
 } (cpp.minimize_padding)
 
+/**
+ * Compact TTL refresh of a single key. Unlike TTL-only `Value`, originatorId
+ * is not carried. Receiver refreshes its own copy ONLY if both version and
+ * hash (which covers originatorId and value) match.
+ */
+struct KvStoreTtlUpdate {
+  1: string key;
+  2: i64 version;
+  3: i64 ttlVersion;
+  4: i64 ttl;
+  5: i64 hash;
+} (cpp.minimize_padding)
+
+/**
+ * Request object for flooding batched TTL refreshes to a KvStore peer
+ */
+struct KvStoreTtlUpdates {
+  1: list<KvStoreTtlUpdate> ttlUpdates;
+
+  /**
+   * Same as `KeySetParams.nodeIds`. Batched TTL refreshes are coalesced
+   * across publications, hence ONLY the sender is listed.
+   */
+  2: optional list<string> nodeIds;
+
+  /**
+   * Optional attribute to indicate timestamp when request is sent. This is
+   * system timestamp in milliseconds since epoch
+   */
+  3: optional i64 timestamp_ms;
+} (cpp.minimize_padding)
+
 /**
  * Request object for retrieving specific keys from KvStore
  */
@@ -695,6 +758,15 @@ struct KeyGetParams {
   1: list<string> keys;
 }
 
+/**
+ * Position in change-log of a KvStoreDb instance. `instanceId` is picked
+ * randomly on creation of the instance, as sequence numbers restart from 0.
+ */
+struct KvStoreChangeLogPosition {
+  1: i64 instanceId;
+  2: i64 seq;
+} (cpp.minimize_padding)
+
 /**
  * Request object for retrieving KvStore entries or subscribing KvStore updates.
  * This is more powerful version than KeyGetParams.
@@ -744,6 +816,50 @@ struct KeyDumpParams {
    * getting "adj:.*" keys from open/r domain.
    */
   5: optional list<string> keys;
+
+  /**
+   * Optional set of merkle tree buckets to restrict response to. If set, ONLY
+   * keys falling into one of these buckets are considered. This is used along
+   * with `keyValHashes` for anti-entropy full-sync.
+   */
+  8: optional list<i32> merkleBuckets;
+
+  /**
+   * Optional position in responder's change-log the requester is synced up
+   * to. If set, respond ONLY with keys changed after it (incremental sync).
+   * Response without `changeLogPosition` indicates the change-log doesn't
+   * cover it any more, and requester must fall back to full-sync.
+   */
+  9: optional KvStoreChangeLogPosition changeLogSince;
+} (cpp.minimize_padding)
+
+/**
+ * On-disk snapshot of KvStore key-vals of an area for warm start. TTLs of
+ * key-vals are the remaining ones as of `timestampMs`.
+ */
+struct KvStoreSnapshot {
+  1: string area;
+
+  /**
+   * Wall clock time in milliseconds the snapshot is taken at
+   */
+  2: i64 timestampMs;
+  3: KeyVals keyVals;
+} (cpp.minimize_padding)
+
+/**
+ * Merkle tree digests of KvStore keyspace of an area. Nodes are stored in
+ * heap layout (root at index 0, children of node `i` at `2i + 1` and `2i + 2`)
+ * and leaves represent `numBuckets` buckets of keys.
+ */
+struct KvStoreMerkleDigests {
+  1: i32 numBuckets;
+  2: list<i64> digests;
+
+  /**
+   * Position of responder's change-log the digests are taken at
+   */
+  3: optional KvStoreChangeLogPosition changeLogPosition;
 } (cpp.minimize_padding)
 
 /**
@@ -918,13 +1034,18 @@ struct Publication {
   /**
    * List of expired keys. This is applicable for KvStore subscriptions and
    * flooding.
-   * TODO: Expose more detailed information `expiredKeyVals` so that subscribers
-   * can act on the values as well. e.g. in Decision/PrefixManager we no longer
-   * need to rely on the key name to decode prefix/area/node and can use more
-   * compact key formatting.
    */
   3: list<string> expiredKeys;
 
+  /**
+   * Last values of `expiredKeys`, as they expired. Set on publications to
+   * local subscribers only, all keys expiring within one TTL countdown tick
+   * are coalesced into one publication. Subscribers can act on the values,
+   * e.g. Decision withdraws prefixes of expired prefix keys without decoding
+   * prefix and node from the key.
+   */
+  10: optional KeyVals expiredKeyVals;
+
   /**
    * Optional attributes. List of nodes through which this publication has
    * traversed. Client shouldn't worry about this attribute.
@@ -954,8 +1075,22 @@ struct Publication {
    * in milliseconds since epoch
    */
   8: optional i64 timestamp_ms;
+
+  /**
+   * Optional position of responder's change-log a full-sync or incremental
+   * sync response is up to date with
+   */
+  9: optional KvStoreChangeLogPosition changeLogPosition;
 } (cpp.minimize_padding)
 
+/**
+ * Number of keys and their size in bytes, as accounted by KvStoreAreaSummary
+ */
+struct KvStoreSizeStats {
+  1: i64 numKeys;
+  2: i64 bytes;
+}
+
 /**
  * Struct summarizing KvStoreDB for a given area. This is currently used for
  * sending responses to 'breeze kvstore summary'
@@ -981,6 +1116,17 @@ struct KvStoreAreaSummary {
    * Total size in bytes of KvStoreDB for this area
    */
   4: i32 keyValsBytes;
+
+  /**
+   * Breakdown of keyValsCount/keyValsBytes by originatorId of values
+   */
+  5: map<string, KvStoreSizeStats> originatorSizes;
+
+  /**
+   * Breakdown of keyValsCount/keyValsBytes by key prefix, i.e. the part of key
+   * up to first ':' (e.g. `adj`, `prefix`), empty for keys without ':'
+   */
+  6: map<string, KvStoreSizeStats> keyPrefixSizes;
 } (cpp.minimize_padding)
 
 /**
@@ -1181,6 +1327,43 @@ struct AdjKey {
   2: string ifName;
 }
 
+/**
+ * Flap dampening state of an adjacency. Refer to AdjacencyDampeningConfig for
+ * the semantics.
+ */
+struct AdjacencyDampeningState {
+  /**
+   * Adjacency for which the state is kept
+   */
+  1: AdjKey adjKey;
+
+  /**
+   * Current (decayed) penalty
+   */
+  2: double penalty;
+
+  /**
+   * Is adjacency suppressed. Suppressed adjacency is either not advertised or
+   * advertised with metric frozen at `advertisedMetric`
+   */
+  3: bool isSuppressed;
+
+  /**
+   * Time (in milliseconds) until suppressed adjacency is reused
+   */
+  4: i64 reuseInMs;
+
+  /**
+   * Number of flaps and metric changes since penalty history started
+   */
+  5: i64 numEvents;
+
+  /**
+   * Metric (before overrides) with which adjacency is advertised, if any
+   */
+  6: optional i32 advertisedMetric;
+}
+
 /**
  * Struct to store internal override states for links (e.g. metric, overloaded
  * state) etc. This is not currently exposed via any API
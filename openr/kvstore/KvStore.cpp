@@ -5,16 +5,22 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <atomic>
+
 #include <fb303/ServiceData.h>
 #include <fbzmq/zmq/Zmq.h>
+#include <folly/FileUtil.h>
 #include <folly/Format.h>
 #include <folly/GLog.h>
 #include <folly/Random.h>
 #include <folly/String.h>
 #include <openr/common/Util.h>
+#include <thrift/lib/cpp/TApplicationException.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
 
 #include <openr/common/Constants.h>
 #include <openr/common/EventLogger.h>
+#include <openr/common/HotPathTrace.h>
 #include <openr/common/Types.h>
 #include <openr/common/Util.h>
 #include <openr/if/gen-cpp2/OpenrCtrl_types.h>
@@ -26,6 +32,11 @@ namespace fb303 = facebook::fb303;
 
 namespace openr {
 
+namespace {
+// source of thrift client ids of KvStore peers, shared by all areas
+std::atomic<uint64_t> nextThriftClientId{0};
+} // namespace
+
 KvStore::KvStore(
     // initializers for immutable state
     fbzmq::Context& zmqContext,
@@ -77,6 +88,38 @@ KvStore::KvStore(
     maybeIpTos = ipTosConfig.value();
   }
   kvParams_.maybeIpTos = maybeIpTos;
+  kvParams_.enableMerkleSync =
+      config->getKvStoreConfig().enable_merkle_sync_ref().value_or(false);
+  kvParams_.enablePerAreaThread =
+      config->getKvStoreConfig().enable_per_area_thread_ref().value_or(false);
+  kvParams_.enableCompactTtlFlood =
+      config->getKvStoreConfig().enable_compact_ttl_flood_ref().value_or(false);
+  kvParams_.floodWindowSize =
+      config->getKvStoreConfig().flood_window_size_ref().value_or(0);
+  kvParams_.enablePartitionedInitialSync =
+      config->getKvStoreConfig().enable_partitioned_initial_sync_ref().value_or(
+          false);
+  kvParams_.enableStreamingFullSync =
+      config->getKvStoreConfig().enable_streaming_full_sync_ref().value_or(
+          false);
+  kvParams_.enableIncrementalSync =
+      config->getKvStoreConfig().enable_incremental_sync_ref().value_or(false);
+  kvParams_.enableIncrementalFloodTopo =
+      config->getKvStoreConfig().enable_incremental_flood_topo_ref().value_or(
+          false);
+  kvParams_.snapshotPath =
+      config->getKvStoreConfig().warm_start_snapshot_path_ref().to_optional();
+  setValueHashVersion(
+      config->getKvStoreConfig().value_hash_version_ref().value_or(
+          Constants::kValueHashVersionLegacy));
+  kvParams_.valueCodec = KvStoreValueCodec::createFromConfig(*config);
+  if (kvParams_.enablePerAreaThread and kvParams_.enableFloodOptimization) {
+    // [TO BE DEPRECATED]
+    // ZMQ command socket is served on KvStore's own thread
+    LOG(WARNING) << "Per-area thread is not supported with flood optimization. "
+                 << "Running all KvStoreDb instances on KvStore thread.";
+    kvParams_.enablePerAreaThread = false;
+  }
 
   // [TO BE DEPRECATED]
   if (kvParams_.enableFloodOptimization) {
@@ -153,11 +196,20 @@ KvStore::KvStore(
 
   // create KvStoreDb instances
   for (auto const& area : config->getAreaIds()) {
+    // KvStoreDb shares KvStore's event-base unless per-area thread is enabled
+    OpenrEventBase* areaEvb = this;
+    if (kvParams_.enablePerAreaThread) {
+      auto& evb = areaEvbs_[area];
+      evb = std::make_unique<OpenrEventBase>();
+      evb->setEvbName(fmt::format("KvStore.{}", area));
+      areaEvb = evb.get();
+    }
+
     kvStoreDb_.emplace(
         std::piecewise_construct,
         std::forward_as_tuple(area),
         std::forward_as_tuple(
-            this,
+            areaEvb,
             kvParams_,
             area,
             fbzmq::Socket<ZMQ_ROUTER, fbzmq::ZMQ_CLIENT>(
@@ -168,7 +220,30 @@ KvStore::KvStore(
                 fbzmq::NonblockingFlag{true}),
             config->getKvStoreConfig().is_flood_root_ref().value_or(false),
             config->getNodeName(),
-            std::bind(&KvStore::initialKvStoreDbSynced, this)));
+            [this]() {
+              if (kvParams_.enablePerAreaThread) {
+                // ATTN: invoked from per-area thread. Jump to KvStore thread.
+                runInEventBaseThread([this]() { initialKvStoreDbSynced(); });
+              } else {
+                initialKvStoreDbSynced();
+              }
+            },
+            [this](size_t numSeeded) {
+              if (kvParams_.enablePerAreaThread) {
+                // ATTN: invoked from per-area thread. Jump to KvStore thread.
+                runInEventBaseThread(
+                    [this, numSeeded]() { snapshotLoaded(numSeeded); });
+              } else {
+                snapshotLoaded(numSeeded);
+              }
+            }));
+  }
+
+  // start per-area threads if any
+  for (auto& [area, evb] : areaEvbs_) {
+    LOG(INFO) << "Starting KvStoreDb thread for area: " << area;
+    areaEvbThreads_.emplace_back([evb = evb.get()]() noexcept { evb->run(); });
+    evb->waitUntilRunning();
   }
 }
 
@@ -183,6 +258,16 @@ KvStore::stop() {
     }
   });
 
+  // Stop per-area threads after all KvStoreDb instances are stopped
+  for (auto& [area, evb] : areaEvbs_) {
+    evb->stop();
+    evb->waitUntilStopped();
+  }
+  for (auto& areaEvbThread : areaEvbThreads_) {
+    areaEvbThread.join();
+  }
+  areaEvbThreads_.clear();
+
   // Invoke stop method of super class
   OpenrEventBase::stop();
   VLOG(1) << "KvStore event base stopped";
@@ -221,6 +306,19 @@ KvStore::prepareSocket(
   }
 }
 
+OpenrEventBase*
+KvStore::getAreaEvb(std::string const& areaId) {
+  auto search = kvStoreDb_.find(areaId);
+  if (search != kvStoreDb_.end()) {
+    return search->second.getEvb();
+  }
+  // same fallback as getAreaDbOrThrow() for single configured area
+  if (kvStoreDb_.size() == 1) {
+    return kvStoreDb_.begin()->second.getEvb();
+  }
+  return this;
+}
+
 KvStoreDb&
 KvStore::getAreaDbOrThrow(
     std::string const& areaId, std::string const& caller) {
@@ -281,6 +379,16 @@ KvStore::processKeyValueRequest(KeyValueRequest&& kvRequest) {
   const auto& area = std::visit(
       [](auto&& request) -> AreaId { return request.getArea(); }, kvRequest);
 
+  // Redirect request to the thread of area's KvStoreDb if running on its own
+  auto* evb = getAreaEvb(area);
+  if (not evb->getEvb()->isInEventBaseThread()) {
+    evb->runInEventBaseThread(
+        [this, kvRequest = std::move(kvRequest)]() mutable {
+          processKeyValueRequest(std::move(kvRequest));
+        });
+    return;
+  }
+
   try {
     auto& kvStoreDb = getAreaDbOrThrow(area, "processKeyValueRequest");
     if (auto pPersistKvRequest =
@@ -301,6 +409,17 @@ KvStore::processKeyValueRequest(KeyValueRequest&& kvRequest) {
       } else {
         kvStoreDb.eraseSelfOriginatedKey(pClearKvRequest->getKey());
       }
+    } else if (
+        auto pBatchKvRequest = std::get_if<BatchKeyValueRequest>(&kvRequest)) {
+      for (auto const& [key, value] : pBatchKvRequest->getUnsetKeyVals()) {
+        kvStoreDb.unsetSelfOriginatedKey(key, value);
+      }
+      kvStoreDb.persistSelfOriginatedKeys(
+          pBatchKvRequest->getPersistKeyVals());
+      fb303::fbData->addStatValue(
+          "kvstore.batch_key_value_request_size",
+          pBatchKvRequest->size(),
+          fb303::AVG);
     } else {
       LOG(ERROR)
           << "Error processing key value request. Request type not recognized.";
@@ -371,12 +490,15 @@ KvStore::processPeerUpdates(PeerEvent&& event) {
     // 'initialKvStoreDbSynced()' will not publish kvStoreSynced signal, and
     // downstream modules cannot proceed to complete initialization.
     for (auto& [area, kvStoreDb] : kvStoreDb_) {
-      if (kvStoreDb.getPeerCnt() != 0) {
-        continue;
-      }
-      LOG(INFO)
-          << fmt::format("[Initialization] Received 0 peers in area {}.", area);
-      kvStoreDb.processInitializationEvent();
+      runInAreaThreadAndWait(
+          kvStoreDb, [&area = area, &kvStoreDb = kvStoreDb]() {
+            if (kvStoreDb.getPeerCnt() != 0) {
+              return;
+            }
+            LOG(INFO) << fmt::format(
+                "[Initialization] Received 0 peers in area {}.", area);
+            kvStoreDb.processInitializationEvent();
+          });
     }
   }
 }
@@ -386,10 +508,11 @@ KvStore::getKvStoreKeyVals(
     std::string area, thrift::KeyGetParams keyGetParams) {
   folly::Promise<std::unique_ptr<thrift::Publication>> p;
   auto sf = p.getSemiFuture();
-  runInEventBaseThread([this,
-                        p = std::move(p),
-                        keyGetParams = std::move(keyGetParams),
-                        area]() mutable {
+  auto* evb = getAreaEvb(area);
+  evb->runInEventBaseThread([this,
+                             p = std::move(p),
+                             keyGetParams = std::move(keyGetParams),
+                             area]() mutable {
     VLOG(3) << "Get key requested for AREA: " << area;
     try {
       auto& kvStoreDb = getAreaDbOrThrow(area, "getKvStoreKeyVals");
@@ -409,7 +532,8 @@ folly::SemiFuture<std::unique_ptr<SelfOriginatedKeyVals>>
 KvStore::dumpKvStoreSelfOriginatedKeys(std::string area) {
   folly::Promise<std::unique_ptr<SelfOriginatedKeyVals>> p;
   auto sf = p.getSemiFuture();
-  runInEventBaseThread([this, p = std::move(p), area]() mutable {
+  auto* evb = getAreaEvb(area);
+  evb->runInEventBaseThread([this, p = std::move(p), area]() mutable {
     VLOG(3) << "Dump self originated key-vals for AREA: " << area;
     try {
       auto& kvStoreDb = getAreaDbOrThrow(area, "dumpKvStoreSelfOriginatedKeys");
@@ -431,10 +555,13 @@ KvStore::dumpKvStoreKeys(
     thrift::KeyDumpParams keyDumpParams, std::set<std::string> selectAreas) {
   folly::Promise<std::unique_ptr<std::vector<thrift::Publication>>> p;
   auto sf = p.getSemiFuture();
-  runInEventBaseThread([this,
-                        p = std::move(p),
-                        selectAreas = std::move(selectAreas),
-                        keyDumpParams = std::move(keyDumpParams)]() mutable {
+  // serve single area request (i.e. full-sync from peer) on area's thread
+  auto* evb = selectAreas.size() == 1 ? getAreaEvb(*selectAreas.begin()) : this;
+  evb->runInEventBaseThread([this,
+                             p = std::move(p),
+                             selectAreas = std::move(selectAreas),
+                             keyDumpParams =
+                                 std::move(keyDumpParams)]() mutable {
     VLOG(3)
         << "Dump all keys requested for "
         << (selectAreas.empty()
@@ -461,16 +588,42 @@ KvStore::dumpKvStoreKeys(
           oper = *keyDumpParams.oper_ref();
         }
 
-        auto thriftPub = kvStoreDb.dumpAllWithFilters(
-            keyPrefixMatch, oper, *keyDumpParams.doNotPublishValue_ref());
-        if (keyDumpParams.keyValHashes_ref().has_value()) {
-          thriftPub = kvStoreDb.dumpDifference(
-              *thriftPub.keyVals_ref(),
-              keyDumpParams.keyValHashes_ref().value());
+        // restrict dump to diverged merkle buckets if requested by peer
+        std::optional<std::unordered_set<int32_t>> merkleBuckets;
+        if (keyDumpParams.merkleBuckets_ref().has_value()) {
+          merkleBuckets = std::unordered_set<int32_t>(
+              keyDumpParams.merkleBuckets_ref()->begin(),
+              keyDumpParams.merkleBuckets_ref()->end());
         }
-        kvStoreDb.updatePublicationTtl(thriftPub);
-        // I'm the initiator, set flood-root-id
-        thriftPub.floodRootId_ref().from_optional(kvStoreDb.getSptRootId());
+
+        thrift::Publication thriftPub;
+        runInAreaThreadAndWait(kvStoreDb, [&]() {
+          if (keyDumpParams.changeLogSince_ref().has_value()) {
+            // incremental sync from reconnecting peer
+            thriftPub = kvStoreDb.dumpChangesSince(
+                *keyDumpParams.changeLogSince_ref(), keyPrefixMatch, oper);
+          } else {
+            thriftPub = kvStoreDb.dumpAllWithFilters(
+                keyPrefixMatch,
+                oper,
+                *keyDumpParams.doNotPublishValue_ref(),
+                merkleBuckets);
+            if (keyDumpParams.keyValHashes_ref().has_value()) {
+              thriftPub = kvStoreDb.dumpDifference(
+                  *thriftPub.keyVals_ref(),
+                  keyDumpParams.keyValHashes_ref().value());
+            }
+            // response covering complete keyspace is a base for incremental
+            // sync of requester
+            if (not merkleBuckets.has_value()) {
+              thriftPub.changeLogPosition_ref().from_optional(
+                  kvStoreDb.getChangeLogPosition());
+            }
+          }
+          kvStoreDb.updatePublicationTtl(thriftPub);
+          // I'm the initiator, set flood-root-id
+          thriftPub.floodRootId_ref().from_optional(kvStoreDb.getSptRootId());
+        });
 
         if (keyDumpParams.keyValHashes_ref().has_value() and
             (*keyDumpParams.prefix_ref()).empty() and
@@ -497,15 +650,40 @@ KvStore::dumpKvStoreKeys(
   return sf;
 }
 
+void
+KvStore::streamKvStoreKeyVals(
+    thrift::KeyDumpParams keyDumpParams,
+    std::string area,
+    std::function<void(thrift::Publication&&)> onChunk,
+    std::function<void(folly::exception_wrapper)> onComplete) {
+  auto* evb = getAreaEvb(area);
+  evb->runInEventBaseThread([this,
+                             keyDumpParams = std::move(keyDumpParams),
+                             area,
+                             onChunk = std::move(onChunk),
+                             onComplete = std::move(onComplete)]() mutable {
+    VLOG(3) << "Stream all keys requested for AREA: " << area;
+    try {
+      auto& kvStoreDb = getAreaDbOrThrow(area, "streamKvStoreKeyVals");
+      fb303::fbData->addStatValue("kvstore.cmd_key_dump", 1, fb303::COUNT);
+      kvStoreDb.streamKeyValsWithFilters(
+          std::move(keyDumpParams), std::move(onChunk), std::move(onComplete));
+    } catch (thrift::OpenrError const& e) {
+      onComplete(folly::make_exception_wrapper<thrift::OpenrError>(e));
+    }
+  });
+}
+
 folly::SemiFuture<std::unique_ptr<thrift::Publication>>
 KvStore::dumpKvStoreHashes(
     std::string area, thrift::KeyDumpParams keyDumpParams) {
   folly::Promise<std::unique_ptr<thrift::Publication>> p;
   auto sf = p.getSemiFuture();
-  runInEventBaseThread([this,
-                        p = std::move(p),
-                        keyDumpParams = std::move(keyDumpParams),
-                        area]() mutable {
+  auto* evb = getAreaEvb(area);
+  evb->runInEventBaseThread([this,
+                             p = std::move(p),
+                             keyDumpParams = std::move(keyDumpParams),
+                             area]() mutable {
     VLOG(3) << "Dump all hashes requested for AREA: " << area;
     try {
       auto& kvStoreDb = getAreaDbOrThrow(area, "dumpKvStoreHashes");
@@ -529,15 +707,38 @@ KvStore::dumpKvStoreHashes(
   return sf;
 }
 
+folly::SemiFuture<std::unique_ptr<thrift::KvStoreMerkleDigests>>
+KvStore::getKvStoreMerkleDigests(std::string area) {
+  folly::Promise<std::unique_ptr<thrift::KvStoreMerkleDigests>> p;
+  auto sf = p.getSemiFuture();
+  auto* evb = getAreaEvb(area);
+  evb->runInEventBaseThread([this, p = std::move(p), area]() mutable {
+    VLOG(3) << "Dump merkle digests requested for AREA: " << area;
+    try {
+      auto& kvStoreDb = getAreaDbOrThrow(area, "getKvStoreMerkleDigests");
+      fb303::fbData->addStatValue("kvstore.cmd_merkle_dump", 1, fb303::COUNT);
+      auto digests = kvStoreDb.getMerkleDigests();
+      digests.changeLogPosition_ref().from_optional(
+          kvStoreDb.getChangeLogPosition());
+      p.setValue(
+          std::make_unique<thrift::KvStoreMerkleDigests>(std::move(digests)));
+    } catch (thrift::OpenrError const& e) {
+      p.setException(e);
+    }
+  });
+  return sf;
+}
+
 folly::SemiFuture<folly::Unit>
 KvStore::setKvStoreKeyVals(
     std::string area, thrift::KeySetParams keySetParams) {
   folly::Promise<folly::Unit> p;
   auto sf = p.getSemiFuture();
-  runInEventBaseThread([this,
-                        p = std::move(p),
-                        keySetParams = std::move(keySetParams),
-                        area]() mutable {
+  auto* evb = getAreaEvb(area);
+  evb->runInEventBaseThread([this,
+                             p = std::move(p),
+                             keySetParams = std::move(keySetParams),
+                             area]() mutable {
     VLOG(3) << "Set key requested for AREA: " << area;
     try {
       auto& kvStoreDb = getAreaDbOrThrow(area, "setKvStoreKeyVals");
@@ -551,12 +752,36 @@ KvStore::setKvStoreKeyVals(
   return sf;
 }
 
+folly::SemiFuture<folly::Unit>
+KvStore::setKvStoreTtlUpdates(
+    std::string area, thrift::KvStoreTtlUpdates ttlUpdates) {
+  folly::Promise<folly::Unit> p;
+  auto sf = p.getSemiFuture();
+  auto* evb = getAreaEvb(area);
+  evb->runInEventBaseThread([this,
+                             p = std::move(p),
+                             ttlUpdates = std::move(ttlUpdates),
+                             area]() mutable {
+    VLOG(3) << "Set ttl updates requested for AREA: " << area;
+    try {
+      auto& kvStoreDb = getAreaDbOrThrow(area, "setKvStoreTtlUpdates");
+      kvStoreDb.setTtlUpdates(std::move(ttlUpdates));
+      // ready to return
+      p.setValue();
+    } catch (thrift::OpenrError const& e) {
+      p.setException(e);
+    }
+  });
+  return sf;
+}
+
 folly::SemiFuture<std::optional<thrift::KvStorePeerState>>
 KvStore::getKvStorePeerState(
     std::string const& area, std::string const& peerName) {
   folly::Promise<std::optional<thrift::KvStorePeerState>> promise;
   auto sf = promise.getSemiFuture();
-  runInEventBaseThread(
+  auto* evb = getAreaEvb(area);
+  evb->runInEventBaseThread(
       [this, p = std::move(promise), peerName, area]() mutable {
         try {
           p.setValue(getAreaDbOrThrow(area, "getKvStorePeerState")
@@ -572,7 +797,8 @@ folly::SemiFuture<std::unique_ptr<thrift::PeersMap>>
 KvStore::getKvStorePeers(std::string area) {
   folly::Promise<std::unique_ptr<thrift::PeersMap>> p;
   auto sf = p.getSemiFuture();
-  runInEventBaseThread([this, p = std::move(p), area]() mutable {
+  auto* evb = getAreaEvb(area);
+  evb->runInEventBaseThread([this, p = std::move(p), area]() mutable {
     VLOG(2) << "Peer dump requested for AREA: " << area;
     try {
       p.setValue(std::make_unique<thrift::PeersMap>(
@@ -603,10 +829,14 @@ KvStore::getKvStoreAreaSummaryInternal(std::set<std::string> selectAreas) {
       thrift::KvStoreAreaSummary areaSummary;
 
       areaSummary.area_ref() = area;
-      auto kvDbCounters = kvStoreDb.getCounters();
-      areaSummary.keyValsCount_ref() = kvDbCounters["kvstore.num_keys"];
-      areaSummary.peersMap_ref() = kvStoreDb.dumpPeers();
-      areaSummary.keyValsBytes_ref() = kvStoreDb.getKeyValsSize();
+      runInAreaThreadAndWait(kvStoreDb, [&, &kvStoreDb = kvStoreDb]() {
+        auto kvDbCounters = kvStoreDb.getCounters();
+        areaSummary.keyValsCount_ref() = kvDbCounters["kvstore.num_keys"];
+        areaSummary.peersMap_ref() = kvStoreDb.dumpPeers();
+        areaSummary.keyValsBytes_ref() = kvStoreDb.getKeyValsSize();
+        areaSummary.originatorSizes_ref() = kvStoreDb.getOriginatorSizes();
+        areaSummary.keyPrefixSizes_ref() = kvStoreDb.getKeyPrefixSizes();
+      });
 
       result->emplace_back(std::move(areaSummary));
     }
@@ -615,14 +845,25 @@ KvStore::getKvStoreAreaSummaryInternal(std::set<std::string> selectAreas) {
   return sf;
 }
 
+int64_t
+KvStore::getKvStoreAreaSummaryGeneration() const {
+  // Areas are fixed on construction, hence iterating them is thread safe
+  int64_t generation{0};
+  for (auto const& [_, kvStoreDb] : kvStoreDb_) {
+    generation += kvStoreDb.getGeneration();
+  }
+  return generation;
+}
+
 folly::SemiFuture<folly::Unit>
 KvStore::addUpdateKvStorePeers(std::string area, thrift::PeersMap peersToAdd) {
   folly::Promise<folly::Unit> p;
   auto sf = p.getSemiFuture();
-  runInEventBaseThread([this,
-                        p = std::move(p),
-                        peersToAdd = std::move(peersToAdd),
-                        area]() mutable {
+  auto* evb = getAreaEvb(area);
+  evb->runInEventBaseThread([this,
+                             p = std::move(p),
+                             peersToAdd = std::move(peersToAdd),
+                             area]() mutable {
     try {
       auto str = folly::gen::from(peersToAdd) | folly::gen::get<0>() |
           folly::gen::as<std::vector<std::string>>();
@@ -650,10 +891,11 @@ KvStore::deleteKvStorePeers(
     std::string area, std::vector<std::string> peersToDel) {
   folly::Promise<folly::Unit> p;
   auto sf = p.getSemiFuture();
-  runInEventBaseThread([this,
-                        p = std::move(p),
-                        peersToDel = std::move(peersToDel),
-                        area]() mutable {
+  auto* evb = getAreaEvb(area);
+  evb->runInEventBaseThread([this,
+                             p = std::move(p),
+                             peersToDel = std::move(peersToDel),
+                             area]() mutable {
     LOG(INFO) << "Peer deletion for: [" << folly::join(",", peersToDel)
               << "] in area: " << area;
     try {
@@ -677,7 +919,8 @@ folly::SemiFuture<std::unique_ptr<thrift::SptInfos>>
 KvStore::getSpanningTreeInfos(std::string area) {
   folly::Promise<std::unique_ptr<thrift::SptInfos>> p;
   auto sf = p.getSemiFuture();
-  runInEventBaseThread([this, p = std::move(p), area]() mutable {
+  auto* evb = getAreaEvb(area);
+  evb->runInEventBaseThread([this, p = std::move(p), area]() mutable {
     VLOG(3) << "FLOOD_TOPO_GET command requested for AREA: " << area;
     try {
       p.setValue(std::make_unique<thrift::SptInfos>(
@@ -695,10 +938,11 @@ KvStore::updateFloodTopologyChild(
     std::string area, thrift::FloodTopoSetParams floodTopoSetParams) {
   folly::Promise<folly::Unit> p;
   auto sf = p.getSemiFuture();
-  runInEventBaseThread([this,
-                        p = std::move(p),
-                        floodTopoSetParams = std::move(floodTopoSetParams),
-                        area]() mutable {
+  auto* evb = getAreaEvb(area);
+  evb->runInEventBaseThread([this,
+                             p = std::move(p),
+                             floodTopoSetParams = std::move(floodTopoSetParams),
+                             area]() mutable {
     VLOG(2) << "FLOOD_TOPO_SET command requested for AREA: " << area;
     try {
       getAreaDbOrThrow(area, "updateFloodTopologyChild")
@@ -716,10 +960,11 @@ KvStore::processKvStoreDualMessage(
     std::string area, thrift::DualMessages dualMessages) {
   folly::Promise<folly::Unit> p;
   auto sf = p.getSemiFuture();
-  runInEventBaseThread([this,
-                        p = std::move(p),
-                        dualMessages = std::move(dualMessages),
-                        area]() mutable {
+  auto* evb = getAreaEvb(area);
+  evb->runInEventBaseThread([this,
+                             p = std::move(p),
+                             dualMessages = std::move(dualMessages),
+                             area]() mutable {
     VLOG(2) << "DUAL messages received for AREA: " << area;
     try {
       auto& kvStoreDb = getAreaDbOrThrow(area, "processKvStoreDualMessage");
@@ -730,8 +975,7 @@ KvStore::processKvStoreDualMessage(
         fb303::fbData->addStatValue(
             "kvstore.received_dual_messages", 1, fb303::COUNT);
 
-        kvStoreDb.processDualMessages(std::move(dualMessages));
-        p.setValue();
+        kvStoreDb.addPendingDualMessages(std::move(dualMessages), std::move(p));
       }
     } catch (thrift::OpenrError const& e) {
       p.setException(e);
@@ -758,6 +1002,25 @@ KvStore::initialKvStoreDbSynced() {
   }
 }
 
+void
+KvStore::snapshotLoaded(size_t numSeeded) {
+  numSnapshotKeyValsSeeded_ += numSeeded;
+  if (++numSnapshotsLoaded_ < kvStoreDb_.size()) {
+    return;
+  }
+  // Nothing to warm start from, or already synced with peers
+  if (numSnapshotKeyValsSeeded_ == 0 or initialSyncSignalSent_) {
+    return;
+  }
+  LOG(INFO) << fmt::format(
+      "[Warm Start] Seeded {} key-vals from snapshot in all {} areas.",
+      numSnapshotKeyValsSeeded_,
+      kvStoreDb_.size());
+
+  // Seeded key-vals are published ahead of this signal
+  kvParams_.kvStoreUpdatesQueue.push(Publication::warmStarted());
+}
+
 folly::SemiFuture<std::map<std::string, int64_t>>
 KvStore::getCounters() {
   auto pf = folly::makePromiseContract<std::map<std::string, int64_t>>();
@@ -767,11 +1030,34 @@ KvStore::getCounters() {
   return std::move(pf.second);
 }
 
+folly::SemiFuture<folly::Unit>
+KvStore::processConfigUpdate(ConfigUpdate update) {
+  auto [p, sf] = folly::makePromiseContract<folly::Unit>();
+  runInEventBaseThread(
+      [this, p = std::move(p), update = std::move(update)]() mutable {
+        if (update.kvStoreFloodRateChanged) {
+          auto const floodRate = update.config->getKvStoreConfig()
+                                     .flood_rate_ref()
+                                     .to_optional();
+          for (auto& [_, kvStoreDb] : kvStoreDb_) {
+            runInAreaThreadAndWait(kvStoreDb, [&, &kvStoreDb = kvStoreDb]() {
+              kvStoreDb.setFloodRate(floodRate);
+            });
+          }
+        }
+        p.setValue();
+      });
+  return std::move(sf);
+}
+
 std::map<std::string, int64_t>
 KvStore::getGlobalCounters() const {
   std::map<std::string, int64_t> flatCounters;
   for (auto& [_, kvDb] : kvStoreDb_) {
-    auto kvDbCounters = kvDb.getCounters();
+    std::map<std::string, int64_t> kvDbCounters;
+    runInAreaThreadAndWait(kvDb, [&, &kvDb = kvDb]() {
+      kvDbCounters = kvDb.getCounters();
+    });
     // add up counters for same key from all kvStoreDb instances
     flatCounters = std::accumulate(
         kvDbCounters.begin(),
@@ -797,12 +1083,20 @@ KvStore::initGlobalCounters() {
       "kvstore.thrift.num_full_sync_success", fb303::COUNT);
   fb303::fbData->addStatExportType(
       "kvstore.thrift.num_full_sync_failure", fb303::COUNT);
+  fb303::fbData->addStatExportType(
+      "kvstore.thrift.num_merkle_sync", fb303::COUNT);
+  fb303::fbData->addStatExportType(
+      "kvstore.thrift.num_merkle_sync_skipped", fb303::COUNT);
+  fb303::fbData->addStatExportType(
+      "kvstore.thrift.num_merkle_sync_failure", fb303::COUNT);
   fb303::fbData->addStatExportType(
       "kvstore.thrift.num_flood_pub", fb303::COUNT);
   fb303::fbData->addStatExportType(
       "kvstore.thrift.num_flood_pub_success", fb303::COUNT);
   fb303::fbData->addStatExportType(
       "kvstore.thrift.num_flood_pub_failure", fb303::COUNT);
+  fb303::fbData->addStatExportType(
+      "kvstore.thrift.num_flood_window_full", fb303::COUNT);
   fb303::fbData->addStatExportType(
       "kvstore.thrift.num_finalized_sync", fb303::COUNT);
   fb303::fbData->addStatExportType(
@@ -818,6 +1112,10 @@ KvStore::initGlobalCounters() {
       "kvstore.thrift.full_sync_duration_ms", fb303::AVG);
   fb303::fbData->addStatExportType(
       "kvstore.thrift.flood_pub_duration_ms", fb303::AVG);
+  fb303::fbData->addStatExportType(
+      "kvstore.thrift.flood_pub_key_vals", fb303::AVG);
+  fb303::fbData->addStatExportType(
+      "kvstore.thrift.flood_pub_in_flight", fb303::AVG);
   fb303::fbData->addStatExportType(
       "kvstore.thrift.finalized_sync_duration_ms", fb303::AVG);
   fb303::fbData->addStatExportType(
@@ -829,6 +1127,8 @@ KvStore::initGlobalCounters() {
       "kvstore.thrift.num_flood_key_vals", fb303::SUM);
   fb303::fbData->addStatExportType(
       "kvstore.thrift.num_keyvals_update", fb303::SUM);
+  fb303::fbData->addStatExportType(
+      "kvstore.thrift.num_merkle_mismatched_buckets", fb303::SUM);
 
   // TODO: remove `kvstore.zmq.*` counters once ZMQ socket is deprecated
   fb303::fbData->addStatExportType("kvstore.zmq.num_missing_keys", fb303::SUM);
@@ -842,6 +1142,7 @@ KvStore::initGlobalCounters() {
   fb303::fbData->addStatExportType("kvstore.cmd_key_dump", fb303::COUNT);
   fb303::fbData->addStatExportType("kvstore.cmd_key_get", fb303::COUNT);
   fb303::fbData->addStatExportType("kvstore.cmd_key_set", fb303::COUNT);
+  fb303::fbData->addStatExportType("kvstore.cmd_merkle_dump", fb303::COUNT);
   fb303::fbData->addStatExportType("kvstore.cmd_peer_add", fb303::COUNT);
   fb303::fbData->addStatExportType("kvstore.cmd_peer_dump", fb303::COUNT);
   fb303::fbData->addStatExportType("kvstore.cmd_per_del", fb303::COUNT);
@@ -883,6 +1184,7 @@ KvStoreDb::logStateTransition(
     std::string const& peerName,
     thrift::KvStorePeerState oldState,
     thrift::KvStorePeerState newState) {
+  ++generation_;
   SYSLOG(INFO)
       << EventTag() << AreaTag()
       << fmt::format(
@@ -1004,6 +1306,8 @@ KvStoreDb::KvStorePeer::getOrCreateThriftClient(
         folly::AsyncSocket::anyAddress(), /* bindAddress */
         maybeIpTos /* IP_TOS value for control plane */);
     client = std::move(thriftClient);
+    clientId = ++nextThriftClientId;
+    numFloodsInFlight = 0;
 
     // schedule periodic keepAlive time with 20% jitter variance
     auto period = addJitter<std::chrono::seconds>(
@@ -1068,28 +1372,21 @@ KvStoreDb::KvStoreDb(
     fbzmq::Socket<ZMQ_ROUTER, fbzmq::ZMQ_CLIENT> peerSyncSock,
     bool isFloodRoot,
     const std::string& nodeId,
-    std::function<void()> initialKvStoreSyncedCallback)
-    : DualNode(nodeId, isFloodRoot),
+    std::function<void()> initialKvStoreSyncedCallback,
+    std::function<void(size_t)> snapshotLoadedCallback)
+    : DualNode(nodeId, isFloodRoot, kvParams.enableIncrementalFloodTopo),
       kvParams_(kvParams),
       area_(area),
       areaTag_(fmt::format("[Area {}] ", area)),
       peerSyncSock_(std::move(peerSyncSock)),
+      changeLogInstanceId_(static_cast<int64_t>(folly::Random::rand64())),
+      floodRate_(kvParams.floodRate),
       initialKvStoreSyncedCallback_(initialKvStoreSyncedCallback),
+      snapshotLoadedCallback_(std::move(snapshotLoadedCallback)),
       evb_(evb) {
-  if (kvParams_.floodRate) {
-    floodLimiter_ = std::make_unique<folly::BasicTokenBucket<>>(
-        *kvParams_.floodRate->flood_msg_per_sec_ref(),
-        *kvParams_.floodRate->flood_msg_burst_size_ref());
-    pendingPublicationTimer_ =
-        folly::AsyncTimeout::make(*evb_->getEvb(), [this]() noexcept {
-          if (!floodLimiter_->consume(1)) {
-            pendingPublicationTimer_->scheduleTimeout(
-                Constants::kFloodPendingPublication);
-            return;
-          }
-          floodBufferedUpdates();
-        });
-  }
+  // rate limiters are created per peer, see addThriftPeers()
+  pendingPublicationTimer_ = folly::AsyncTimeout::make(
+      *evb_->getEvb(), [this]() noexcept { floodBufferedUpdates(); });
 
   LOG(INFO) << AreaTag()
             << fmt::format("Starting kvstore DB instance for node: {}", nodeId);
@@ -1120,6 +1417,29 @@ KvStoreDb::KvStoreDb(
   ttlCountdownTimer_ = folly::AsyncTimeout::make(
       *evb_->getEvb(), [this]() noexcept { cleanupTtlCountdownQueue(); });
 
+  // Create timer to flush coalesced ttl updates to peers. The actual
+  // scheduling happens within floodPublication()
+  if (kvParams_.enableCompactTtlFlood) {
+    ttlFloodTimer_ = folly::AsyncTimeout::make(
+        *evb_->getEvb(), [this]() noexcept { floodPendingTtlUpdates(); });
+  }
+
+  // Seed key-vals from snapshot of last run and keep snapshot up to date
+  if (kvParams_.snapshotPath.has_value()) {
+    snapshotTimer_ =
+        folly::AsyncTimeout::make(*evb_->getEvb(), [this]() noexcept {
+          saveSnapshot();
+          snapshotTimer_->scheduleTimeout(Constants::kKvStoreSnapshotInterval);
+        });
+    evb_->getEvb()->runInEventBaseThread([this]() noexcept {
+      const auto numSeeded = loadSnapshot();
+      if (snapshotLoadedCallback_) {
+        snapshotLoadedCallback_(numSeeded);
+      }
+      snapshotTimer_->scheduleTimeout(Constants::kKvStoreSnapshotInterval);
+    });
+  }
+
   // Create ttl timer for refreshing ttls of self-originated key-vals
   selfOriginatedKeyTtlTimer_ = folly::AsyncTimeout::make(
       *evb_->getEvb(), [this]() noexcept { advertiseTtlUpdates(); });
@@ -1178,11 +1498,18 @@ KvStoreDb::stop() {
   floodTopoStopSignal_.post();
 
   evb_->getEvb()->runImmediatelyOrRunInEventBaseThreadAndWait([this]() {
+    // Keep latest key-vals for warm start
+    if (snapshotTimer_) {
+      snapshotTimer_.reset();
+      saveSnapshot();
+    }
+
     // Destroy thrift clients associated with peers, which will
     // fulfill promises with exceptions if any.
     thriftPeers_.clear();
     selfOriginatedKeyTtlTimer_.reset();
     advertiseKeyValsTimer_.reset();
+    ttlFloodTimer_.reset();
     selfOriginatedTtlUpdatesThrottled_.reset();
     unsetSelfOriginatedKeysThrottled_.reset();
     advertiseSelfOriginatedKeysThrottled_.reset();
@@ -1220,6 +1547,37 @@ KvStoreDb::floodTopoDump() noexcept {
   const auto floodRootId = DualNode::getSptRootId();
   const auto& floodPeers = getFloodPeers(floodRootId);
 
+  if (kvParams_.enableIncrementalFloodTopo) {
+    if (floodRootId == dumpedFloodRootId_ and floodPeers == dumpedFloodPeers_) {
+      VLOG(2) << AreaTag() << "[Flood Topo] No change since last dump";
+      return;
+    }
+    std::vector<std::string> addedPeers;
+    std::vector<std::string> removedPeers;
+    for (const auto& peer : floodPeers) {
+      if (not dumpedFloodPeers_.count(peer)) {
+        addedPeers.emplace_back(peer);
+      }
+    }
+    for (const auto& peer : dumpedFloodPeers_) {
+      if (not floodPeers.count(peer)) {
+        removedPeers.emplace_back(peer);
+      }
+    }
+    LOG(INFO) << AreaTag()
+              << fmt::format(
+                     "[Flood Topo] NodeId: {}, SptRootId: {} -> {}, "
+                     "added flooding peers: [{}], removed: [{}]",
+                     kvParams_.nodeId,
+                     dumpedFloodRootId_.value_or("NA"),
+                     floodRootId.value_or("NA"),
+                     folly::join(",", addedPeers),
+                     folly::join(",", removedPeers));
+    dumpedFloodRootId_ = floodRootId;
+    dumpedFloodPeers_ = floodPeers;
+    return;
+  }
+
   LOG(INFO)
       << AreaTag()
       << fmt::format(
@@ -1256,7 +1614,8 @@ KvStoreDb::setSelfOriginatedKey(
   }
 
   // Store self-originated key-vals in cache
-  // ATTN: ttl backoff will be set separately in scheduleTtlUpdates()
+  // ATTN: ttl refresh will be set separately in scheduleTtlUpdates()
+  removeFromTtlRefreshCohort(key);
   auto selfOriginatedVal = SelfOriginatedValue(thriftValue);
   selfOriginatedKeyVals_[key] = std::move(selfOriginatedVal);
 
@@ -1276,6 +1635,47 @@ KvStoreDb::persistSelfOriginatedKey(
   VLOG(3) << AreaTag()
           << fmt::format("{} called for key: {}", __FUNCTION__, key);
 
+  if (not persistSelfOriginatedKeyVal(key, value)) {
+    return;
+  }
+
+  // Throttled advertisement of pending keys
+  advertiseSelfOriginatedKeysThrottled_->operator()();
+
+  // Add ttl refresh and trigger selfOriginatedKeyTtlTimer_
+  scheduleTtlUpdates(key, false /* advertiseImmediately */);
+}
+
+void
+KvStoreDb::persistSelfOriginatedKeys(
+    std::vector<std::pair<std::string, std::string>> const& keyVals) {
+  VLOG(3) << AreaTag()
+          << fmt::format(
+                 "{} called for {} keys", __FUNCTION__, keyVals.size());
+
+  // Changed keys join one TTL refresh cohort, hence are refreshed together
+  const auto refreshTime =
+      std::chrono::steady_clock::now() + kvParams_.keyTtl / 4;
+  bool changed{false};
+  for (auto const& [key, value] : keyVals) {
+    if (persistSelfOriginatedKeyVal(key, value)) {
+      addToTtlRefreshCohort(key, refreshTime);
+      changed = true;
+    }
+  }
+  if (not changed) {
+    return;
+  }
+
+  // Throttled advertisement of pending keys, and of ttl updates which
+  // reschedules selfOriginatedKeyTtlTimer_
+  advertiseSelfOriginatedKeysThrottled_->operator()();
+  selfOriginatedTtlUpdatesThrottled_->operator()();
+}
+
+bool
+KvStoreDb::persistSelfOriginatedKeyVal(
+    std::string const& key, std::string const& value) {
   // Look key up in local cached storage
   auto selfOriginatedKeyIt = selfOriginatedKeyVals_.find(key);
 
@@ -1323,7 +1723,7 @@ KvStoreDb::persistSelfOriginatedKey(
     thriftValue = selfOriginatedKeyIt->second.value;
     if (*thriftValue.value_ref() == value) {
       // this is a no op, return early and change no state
-      return;
+      return false;
     }
   }
 
@@ -1358,12 +1758,7 @@ KvStoreDb::persistSelfOriginatedKey(
   if (shouldAdvertise) {
     keysToAdvertise_.insert(key);
   }
-
-  // Throttled advertisement of pending keys
-  advertiseSelfOriginatedKeysThrottled_->operator()();
-
-  // Add ttl backoff and trigger selfOriginatedKeyTtlTimer_
-  scheduleTtlUpdates(key, false /* advertiseImmediately */);
+  return true;
 }
 
 void
@@ -1457,6 +1852,7 @@ void
 KvStoreDb::eraseSelfOriginatedKey(std::string const& key) {
   VLOG(3) << AreaTag()
           << fmt::format("{} called for key: {}", __FUNCTION__, key);
+  removeFromTtlRefreshCohort(key);
   selfOriginatedKeyVals_.erase(key);
   keysToAdvertise_.erase(key);
 }
@@ -1510,47 +1906,82 @@ KvStoreDb::unsetPendingSelfOriginatedKeys() {
 void
 KvStoreDb::scheduleTtlUpdates(
     std::string const& key, bool advertiseImmediately) {
-  int64_t ttl = kvParams_.keyTtl.count();
-
-  auto& value = selfOriginatedKeyVals_.at(key);
-
-  // renew before ttl expires. renew every ttl/4, i.e., try 3 times using
-  // ExponetialBackoff to track remaining time before ttl expiration.
-  value.ttlBackoff = ExponentialBackoff<std::chrono::milliseconds>(
-      std::chrono::milliseconds(ttl / 4),
-      std::chrono::milliseconds(ttl / 4 + 1));
-
-  // Delay first ttl advertisement by (ttl / 4). We have just advertised key or
-  // update and would like to avoid sending unncessary immediate ttl update
+  // renew before ttl expires, every ttl/4, i.e., 3 times before ttl
+  // expiration. Delay first ttl advertisement by (ttl / 4) unless asked
+  // otherwise. We have just advertised key or update and would like to avoid
+  // sending unncessary immediate ttl update.
+  auto refreshTime = std::chrono::steady_clock::now();
   if (not advertiseImmediately) {
-    selfOriginatedKeyVals_[key].ttlBackoff.reportError();
+    refreshTime += kvParams_.keyTtl / 4;
   }
+  addToTtlRefreshCohort(key, refreshTime);
 
   // Trigger timer to advertise ttl updates for self-originated key-vals.
   selfOriginatedTtlUpdatesThrottled_->operator()();
 }
 
+void
+KvStoreDb::addToTtlRefreshCohort(
+    std::string const& key, std::chrono::steady_clock::time_point time) {
+  removeFromTtlRefreshCohort(key);
+  // keys with infinite TTL never expire, hence need no ttl update
+  if (kvParams_.keyTtl == Constants::kTtlInfInterval) {
+    return;
+  }
+
+  // Round up to 1/16 of ttl, i.e. at most 5/16 of ttl between ttl updates,
+  // so that keys scheduled around the same time join the same cohort
+  const auto span = std::max(
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          kvParams_.keyTtl / 16),
+      std::chrono::steady_clock::duration(1));
+  const auto sinceEpoch = time.time_since_epoch();
+  const auto cohortTime = std::chrono::steady_clock::time_point(
+      (sinceEpoch + span - std::chrono::steady_clock::duration(1)) / span *
+      span);
+
+  ttlRefreshCohorts_[cohortTime].emplace(key);
+  selfOriginatedKeyVals_.at(key).ttlRefreshTime = cohortTime;
+}
+
+void
+KvStoreDb::removeFromTtlRefreshCohort(std::string const& key) {
+  auto it = selfOriginatedKeyVals_.find(key);
+  if (it == selfOriginatedKeyVals_.end() or
+      not it->second.ttlRefreshTime.has_value()) {
+    return;
+  }
+  auto cohortIt = ttlRefreshCohorts_.find(*it->second.ttlRefreshTime);
+  if (cohortIt != ttlRefreshCohorts_.end()) {
+    cohortIt->second.erase(key);
+    if (cohortIt->second.empty()) {
+      ttlRefreshCohorts_.erase(cohortIt);
+    }
+  }
+  it->second.ttlRefreshTime.reset();
+}
+
 void
 KvStoreDb::advertiseTtlUpdates() {
-  // Build set of keys to advertise ttl updates
-  auto timeout = Constants::kMaxTtlUpdateInterval;
+  const auto now = std::chrono::steady_clock::now();
 
   // all key-vals to advertise ttl updates for
   std::unordered_map<std::string, thrift::Value> keyVals;
 
-  for (auto& [key, val] : selfOriginatedKeyVals_) {
-    auto& thriftValue = val.value;
-    auto& backoff = val.ttlBackoff;
-    if (not backoff.canTryNow()) {
-      VLOG(2) << AreaTag() << fmt::format("Skipping key: {}", key);
-
-      timeout = std::min(timeout, backoff.getTimeRemainingUntilRetry());
-      continue;
+  // refresh all due cohorts at once
+  std::vector<std::string> refreshedKeys;
+  while (not ttlRefreshCohorts_.empty() and
+         ttlRefreshCohorts_.begin()->first <= now) {
+    auto cohort = std::move(ttlRefreshCohorts_.begin()->second);
+    ttlRefreshCohorts_.erase(ttlRefreshCohorts_.begin());
+    for (auto const& key : cohort) {
+      selfOriginatedKeyVals_.at(key).ttlRefreshTime.reset();
+      refreshedKeys.emplace_back(key);
     }
+  }
 
-    // Apply backoff
-    backoff.reportError();
-    timeout = std::min(timeout, backoff.getTimeRemainingUntilRetry());
+  for (auto const& key : refreshedKeys) {
+    auto& thriftValue = selfOriginatedKeyVals_.at(key).value;
 
     // Bump ttl version
     (*thriftValue.ttlVersion_ref())++;
@@ -1573,6 +2004,9 @@ KvStoreDb::advertiseTtlUpdates() {
         key,
         advertiseValue);
     keyVals.emplace(key, advertiseValue);
+
+    // refreshed keys stay together in the next cohort
+    addToTtlRefreshCohort(key, now + kvParams_.keyTtl / 4);
   }
 
   // Advertise to KvStore
@@ -1582,7 +2016,14 @@ KvStoreDb::advertiseTtlUpdates() {
     setKeyVals(std::move(params));
   }
 
-  // Schedule next-timeout for processing/clearing backoffs
+  // Schedule next-timeout for the earliest cohort
+  auto timeout = Constants::kMaxTtlUpdateInterval;
+  if (not ttlRefreshCohorts_.empty()) {
+    timeout = std::min(
+        timeout,
+        std::chrono::ceil<std::chrono::milliseconds>(
+            ttlRefreshCohorts_.begin()->first - now));
+  }
   VLOG(2) << AreaTag()
           << fmt::format("Scheduling ttl timer after {}ms.", timeout.count());
 
@@ -1601,8 +2042,16 @@ KvStoreDb::setKeyVals(thrift::KeySetParams&& setParams) {
     }
   }
 
-  // Update hash for key-values
+  // Update hash for key-values. With v2 hash, flooded values carry the hash
+  // computed by the originator, hence only hash locally set ones
+  const bool keepFloodedHash =
+      getValueHashVersion() == Constants::kValueHashVersionV2 and
+      setParams.nodeIds_ref().has_value() and
+      not setParams.nodeIds_ref()->empty();
   for (auto& [_, value] : *setParams.keyVals_ref()) {
+    if (keepFloodedHash and value.hash_ref().has_value()) {
+      continue;
+    }
     if (value.value_ref().has_value()) {
       value.hash_ref() = generateHash(
           *value.version_ref(), *value.originatorId_ref(), value.value_ref());
@@ -1617,50 +2066,142 @@ KvStoreDb::setKeyVals(thrift::KeySetParams&& setParams) {
   mergePublication(rcvdPublication);
 }
 
+void
+KvStoreDb::setTtlUpdates(thrift::KvStoreTtlUpdates&& ttlUpdates) {
+  // Update statistics
+  fb303::fbData->addStatValue("kvstore.cmd_ttl_updates", 1, fb303::COUNT);
+  if (ttlUpdates.timestamp_ms_ref().has_value()) {
+    auto floodMs = getUnixTimeStampMs() - ttlUpdates.timestamp_ms_ref().value();
+    if (floodMs > 0) {
+      fb303::fbData->addStatValue(
+          "kvstore.flood_duration_ms", floodMs, fb303::AVG);
+    }
+  }
+
+  // Expand compact updates into ttl-only key-vals. ATTN: originatorId is NOT
+  // carried over the wire, hash is used to make sure local value is the same
+  // one the sender holds.
+  thrift::KeySetParams params;
+  size_t numUnmatched{0};
+  for (auto const& update : *ttlUpdates.ttlUpdates_ref()) {
+    auto kvStoreIt = kvStore_.find(*update.key_ref());
+    if (kvStoreIt == kvStore_.end() or
+        *kvStoreIt->second.version_ref() != *update.version_ref() or
+        kvStoreIt->second.hash_ref().value_or(0) != *update.hash_ref()) {
+      ++numUnmatched;
+      continue;
+    }
+    params.keyVals_ref()->emplace(
+        *update.key_ref(),
+        createThriftValue(
+            *update.version_ref(),
+            *kvStoreIt->second.originatorId_ref(),
+            std::nullopt /* value */,
+            *update.ttl_ref(),
+            *update.ttlVersion_ref()));
+  }
+  if (numUnmatched) {
+    // stale or unknown keys, value will be reconciled by full-sync
+    fb303::fbData->addStatValue(
+        "kvstore.ttl_updates_unmatched", numUnmatched, fb303::SUM);
+  }
+  if (params.keyVals_ref()->empty()) {
+    return;
+  }
+
+  params.nodeIds_ref().move_from(ttlUpdates.nodeIds_ref());
+  setKeyVals(std::move(params));
+}
+
 void
 KvStoreDb::updateTtlCountdownQueue(const thrift::Publication& publication) {
   for (const auto& [key, value] : *publication.keyVals_ref()) {
-    if (*value.ttl_ref() != Constants::kTtlInfinity) {
-      TtlCountdownQueueEntry queueEntry;
-      queueEntry.expiryTime = std::chrono::steady_clock::now() +
-          std::chrono::milliseconds(*value.ttl_ref());
-      queueEntry.key = key;
-      queueEntry.version = *value.version_ref();
-      queueEntry.ttlVersion = *value.ttlVersion_ref();
-      queueEntry.originatorId = *value.originatorId_ref();
-
-      if ((ttlCountdownQueue_.empty() or
-           (queueEntry.expiryTime <= ttlCountdownQueue_.top().expiryTime)) and
-          ttlCountdownTimer_) {
-        // Reschedule the shorter timeout
-        ttlCountdownTimer_->scheduleTimeout(
-            std::chrono::milliseconds(*value.ttl_ref()));
-      }
-
-      ttlCountdownQueue_.push(std::move(queueEntry));
+    if (*value.ttl_ref() == Constants::kTtlInfinity) {
+      // key will never expire, drop countdown of previous value if any
+      ttlCountdownWheel_.erase(key);
+      continue;
     }
+    TtlCountdownEntry entry;
+    entry.expiryTime = std::chrono::steady_clock::now() +
+        std::chrono::milliseconds(*value.ttl_ref());
+    entry.key = stringPool_.intern(key);
+    entry.version = *value.version_ref();
+    entry.ttlVersion = *value.ttlVersion_ref();
+    entry.originatorId = stringPool_.intern(*value.originatorId_ref());
+
+    // reschedule in place, any previous countdown of the key is replaced
+    ttlCountdownWheel_.schedule(std::move(entry));
   }
+  scheduleTtlCountdownTimer();
 }
 
-// loop through all key/vals and count the size of KvStoreDB (per area)
-size_t
-KvStoreDb::getKeyValsSize() const {
-  size_t size = 0;
-  if (kvStore_.empty()) {
-    return size;
+void
+KvStoreDb::scheduleTtlCountdownTimer() {
+  if (not ttlCountdownTimer_) {
+    return;
+  }
+  const auto wakeupTime = ttlCountdownWheel_.getNextWakeupTime();
+  if (not wakeupTime.has_value()) {
+    ttlCountdownTimer_->cancelTimeout();
+    return;
+  }
+  const auto timeout = std::chrono::ceil<std::chrono::milliseconds>(
+      *wakeupTime - std::chrono::steady_clock::now());
+  ttlCountdownTimer_->scheduleTimeout(
+      std::max(timeout, std::chrono::milliseconds(0)));
+}
+
+int64_t
+KvStoreDb::getKeyValSize(std::string const& key, thrift::Value const& value) {
+  return sizeof(std::string) + sizeof(thrift::Value) + key.size() +
+      value.originatorId_ref()->size() +
+      (value.value_ref().has_value() ? value.value_ref()->size() : 0);
+}
+
+void
+KvStoreDb::updateKeyValsSize(
+    std::string const& key,
+    std::string const& originatorId,
+    int64_t bytes,
+    int sign) {
+  const auto colon = key.find(':');
+  const auto keyPrefix =
+      colon == std::string::npos ? std::string() : key.substr(0, colon);
+  for (auto* sizes :
+       {&keyValsSize_,
+        &originatorSizes_[originatorId],
+        &keyPrefixSizes_[keyPrefix]}) {
+    sizes->numKeys += sign;
+    sizes->bytes += sign * bytes;
+  }
+  if (originatorSizes_.at(originatorId).numKeys == 0) {
+    originatorSizes_.erase(originatorId);
+  }
+  if (keyPrefixSizes_.at(keyPrefix).numKeys == 0) {
+    keyPrefixSizes_.erase(keyPrefix);
   }
-  // calculate total of struct members with fixed size once at the beginning
-  size_t fixed_size =
-      kvStore_.size() * (sizeof(std::string) + sizeof(thrift::Value));
+}
 
-  // loop through all key/vals and add size of each KV entry
-  for (auto const& [key, value] : kvStore_) {
-    size += key.size() + value.originatorId_ref()->size() +
-        value.value_ref()->size();
+std::map<std::string, thrift::KvStoreSizeStats>
+KvStoreDb::getOriginatorSizes() const {
+  std::map<std::string, thrift::KvStoreSizeStats> result;
+  for (auto const& [originatorId, sizes] : originatorSizes_) {
+    auto& stats = result[originatorId];
+    stats.numKeys_ref() = sizes.numKeys;
+    stats.bytes_ref() = sizes.bytes;
   }
-  size += fixed_size;
+  return result;
+}
 
-  return size;
+std::map<std::string, thrift::KvStoreSizeStats>
+KvStoreDb::getKeyPrefixSizes() const {
+  std::map<std::string, thrift::KvStoreSizeStats> result;
+  for (auto const& [keyPrefix, sizes] : keyPrefixSizes_) {
+    auto& stats = result[keyPrefix];
+    stats.numKeys_ref() = sizes.numKeys;
+    stats.bytes_ref() = sizes.bytes;
+  }
+  return result;
 }
 
 // build publication out of the requested keys (per request)
@@ -1681,61 +2222,135 @@ KvStoreDb::getKeyVals(std::vector<std::string> const& keys) {
   return thriftPub;
 }
 
+void
+KvStoreDb::forEachFilterCandidate(
+    KvStoreFilters const& kvFilters,
+    bool matchAll,
+    std::function<void(std::string const&, thrift::Value const&)> const&
+        visitor) const {
+  const auto originatorIds = kvFilters.getOriginatorIdList();
+  const bool isMatchAll =
+      matchAll or kvFilters.getFilterOperator() == thrift::FilterOperator::AND;
+  // prefix ranges covering keys matching prefix filters, regardless of logic
+  const auto maybePrefixes = kvFilters.getLiteralKeyPrefixes(true);
+
+  // Literal prefixes are sorted and non-overlapping, hence every key is
+  // visited at most once. Skip keys already visited through originator index.
+  auto visitPrefixes = [&](bool skipOriginatorIds) {
+    for (auto const& prefix : *maybePrefixes) {
+      for (auto it = keyIndex_.lower_bound(prefix); it != keyIndex_.end() and
+           (*it)->compare(0, prefix.size(), prefix) == 0;
+           ++it) {
+        auto kvIt = kvStore_.find(**it);
+        DCHECK(kvIt != kvStore_.end());
+        if (skipOriginatorIds and
+            originatorIds.count(*kvIt->second.originatorId_ref())) {
+          continue;
+        }
+        visitor(kvIt->first, kvIt->second);
+      }
+    }
+  };
+  auto visitOriginators = [&]() {
+    for (auto const& originatorId : originatorIds) {
+      auto indexIt = originatorIndex_.find(originatorId);
+      if (indexIt == originatorIndex_.end()) {
+        continue;
+      }
+      for (auto const& key : indexIt->second) {
+        auto kvIt = kvStore_.find(*key);
+        DCHECK(kvIt != kvStore_.end());
+        visitor(kvIt->first, kvIt->second);
+      }
+    }
+  };
+
+  if (isMatchAll and maybePrefixes.has_value()) {
+    // every match is within prefix ranges
+    visitPrefixes(false /* skipOriginatorIds */);
+  } else if (isMatchAll and not originatorIds.empty()) {
+    // every match is originated by one of originatorIds
+    visitOriginators();
+  } else if (originatorIds.empty() and maybePrefixes.has_value()) {
+    visitPrefixes(false /* skipOriginatorIds */);
+  } else if (
+      not originatorIds.empty() and kvFilters.getKeyPrefixes().empty()) {
+    visitOriginators();
+  } else if (not originatorIds.empty() and maybePrefixes.has_value()) {
+    // OR logic: union of both indexes
+    visitOriginators();
+    visitPrefixes(true /* skipOriginatorIds */);
+  } else {
+    for (auto const& [key, val] : kvStore_) {
+      visitor(key, val);
+    }
+  }
+}
+
 // dump the entries of my KV store whose keys match filter
 thrift::Publication
 KvStoreDb::dumpAllWithFilters(
     KvStoreFilters const& kvFilters,
     thrift::FilterOperator oper,
-    bool doNotPublishValue) const {
+    bool doNotPublishValue,
+    std::optional<std::unordered_set<int32_t>> const& merkleBuckets) const {
   thrift::Publication thriftPub;
   thriftPub.area_ref() = area_;
 
-  switch (oper) {
-  case thrift::FilterOperator::AND:
-    for (auto const& [key, val] : kvStore_) {
-      if (not kvFilters.keyMatchAll(key, val)) {
-        continue;
-      }
-      if (not doNotPublishValue) {
-        thriftPub.keyVals_ref()[key] = val;
-      } else {
-        thriftPub.keyVals_ref()[key] = createThriftValueWithoutBinaryValue(val);
-      }
-    }
-    break;
-  default:
-    for (auto const& [key, val] : kvStore_) {
-      if (not kvFilters.keyMatch(key, val)) {
-        continue;
-      }
-      if (not doNotPublishValue) {
-        thriftPub.keyVals_ref()[key] = val;
-      } else {
-        thriftPub.keyVals_ref()[key] = createThriftValueWithoutBinaryValue(val);
-      }
-    }
-  }
+  auto inMerkleBuckets = [&](std::string const& key) {
+    return not merkleBuckets.has_value() or
+        merkleBuckets->count(
+            static_cast<int32_t>(merkleTree_.getBucket(key)));
+  };
+
+  const bool matchAll = oper == thrift::FilterOperator::AND;
+  forEachFilterCandidate(
+      kvFilters,
+      matchAll,
+      [&](std::string const& key, thrift::Value const& val) {
+        const bool isMatch = matchAll ? kvFilters.keyMatchAll(key, val)
+                                      : kvFilters.keyMatch(key, val);
+        if (not isMatch or not inMerkleBuckets(key)) {
+          return;
+        }
+        if (not doNotPublishValue) {
+          thriftPub.keyVals_ref()[key] = val;
+        } else {
+          thriftPub.keyVals_ref()[key] =
+              createThriftValueWithoutBinaryValue(val);
+        }
+      });
   return thriftPub;
 }
 
 // dump the hashes of my KV store whose keys match the given prefix
 // if prefix is the empty string, the full hash store is dumped
 thrift::Publication
-KvStoreDb::dumpHashWithFilters(KvStoreFilters const& kvFilters) const {
+KvStoreDb::dumpHashWithFilters(
+    KvStoreFilters const& kvFilters,
+    std::optional<std::unordered_set<int32_t>> const& merkleBuckets) const {
   thrift::Publication thriftPub;
   thriftPub.area_ref() = area_;
-  for (auto const& [key, val] : kvStore_) {
-    if (not kvFilters.keyMatch(key, val)) {
-      continue;
-    }
-    DCHECK(val.hash_ref().has_value());
-    auto& value = thriftPub.keyVals_ref()[key];
-    value.version_ref() = *val.version_ref();
-    value.originatorId_ref() = *val.originatorId_ref();
-    value.hash_ref().copy_from(val.hash_ref());
-    value.ttl_ref() = *val.ttl_ref();
-    value.ttlVersion_ref() = *val.ttlVersion_ref();
-  }
+  forEachFilterCandidate(
+      kvFilters,
+      false /* matchAll */,
+      [&](std::string const& key, thrift::Value const& val) {
+        if (not kvFilters.keyMatch(key, val)) {
+          return;
+        }
+        if (merkleBuckets.has_value() and
+            not merkleBuckets->count(
+                static_cast<int32_t>(merkleTree_.getBucket(key)))) {
+          return;
+        }
+        DCHECK(val.hash_ref().has_value());
+        auto& value = thriftPub.keyVals_ref()[key];
+        value.version_ref() = *val.version_ref();
+        value.originatorId_ref() = *val.originatorId_ref();
+        value.hash_ref().copy_from(val.hash_ref());
+        value.ttl_ref() = *val.ttl_ref();
+        value.ttlVersion_ref() = *val.ttlVersion_ref();
+      });
   return thriftPub;
 }
 
@@ -1790,6 +2405,241 @@ KvStoreDb::dumpDifference(
   return thriftPub;
 }
 
+thrift::Publication
+KvStoreDb::dumpChangesSince(
+    thrift::KvStoreChangeLogPosition const& position,
+    KvStoreFilters const& kvFilters,
+    thrift::FilterOperator oper) const {
+  thrift::Publication thriftPub;
+  thriftPub.area_ref() = area_;
+
+  // ATTN: entries with sequence number in (position.seq, front.seq) have
+  //       been evicted if front.seq exceeds position.seq + 1
+  const bool isCovered = kvParams_.enableIncrementalSync and
+      *position.instanceId_ref() == changeLogInstanceId_ and
+      *position.seq_ref() <= changeLogSeq_ and
+      (changeLog_.empty() ? *position.seq_ref() == changeLogSeq_
+                          : changeLog_.front().first <= *position.seq_ref() + 1);
+  if (not isCovered) {
+    fb303::fbData->addStatValue(
+        "kvstore.change_log.num_uncovered", 1, fb303::COUNT);
+    return thriftPub;
+  }
+
+  const bool matchAll = oper == thrift::FilterOperator::AND;
+  auto it = std::upper_bound(
+      changeLog_.cbegin(),
+      changeLog_.cend(),
+      *position.seq_ref(),
+      [](int64_t seq, auto const& entry) { return seq < entry.first; });
+  for (; it != changeLog_.cend(); ++it) {
+    auto const& key = *it->second;
+    if (thriftPub.keyVals_ref()->count(key)) {
+      continue;
+    }
+    // key may have expired since
+    auto kvIt = kvStore_.find(key);
+    if (kvIt == kvStore_.end()) {
+      continue;
+    }
+    const bool isMatch = matchAll ? kvFilters.keyMatchAll(key, kvIt->second)
+                                  : kvFilters.keyMatch(key, kvIt->second);
+    if (isMatch) {
+      thriftPub.keyVals_ref()->emplace(key, kvIt->second);
+    }
+  }
+  thriftPub.changeLogPosition_ref() = *getChangeLogPosition();
+  return thriftPub;
+}
+
+std::optional<thrift::KvStoreChangeLogPosition>
+KvStoreDb::getChangeLogPosition() const {
+  if (not kvParams_.enableIncrementalSync) {
+    return std::nullopt;
+  }
+  thrift::KvStoreChangeLogPosition position;
+  position.instanceId_ref() = changeLogInstanceId_;
+  position.seq_ref() = changeLogSeq_;
+  return position;
+}
+
+void
+KvStoreDb::removeFromOriginatorIndex(
+    std::string const& originatorId, std::string const& key) {
+  auto indexIt = originatorIndex_.find(originatorId);
+  if (indexIt == originatorIndex_.end()) {
+    return;
+  }
+  auto& keys = indexIt->second;
+  auto keyIt = keys.find(key);
+  if (keyIt != keys.end()) {
+    keys.erase(keyIt);
+  }
+  if (keys.empty()) {
+    originatorIndex_.erase(indexIt);
+  }
+}
+
+void
+KvStoreDb::recordChangeLog(std::string const& key) {
+  if (not kvParams_.enableIncrementalSync) {
+    return;
+  }
+  changeLog_.emplace_back(++changeLogSeq_, stringPool_.intern(key));
+  if (changeLog_.size() > Constants::kKvStoreChangeLogSize) {
+    changeLog_.pop_front();
+  }
+}
+
+struct KvStoreDb::StreamSyncState {
+  KvStoreFilters kvFilters{{}, {}};
+  bool matchAll{false};
+  bool doNotPublishValue{false};
+  std::optional<std::unordered_set<int32_t>> merkleBuckets;
+
+  // key-hashes of the requester. Entries are erased once compared, hence the
+  // rest are keys NOT in my store by the end of stream.
+  std::optional<thrift::KeyVals> keyValHashes;
+
+  // last key visited, next chunk resumes right after it
+  std::optional<std::string> lastKey;
+
+  // position of my change-log when stream started, carried by first chunk
+  std::optional<thrift::KvStoreChangeLogPosition> changeLogPosition;
+
+  std::function<void(thrift::Publication&&)> onChunk;
+  std::function<void(folly::exception_wrapper)> onComplete;
+};
+
+void
+KvStoreDb::streamKeyValsWithFilters(
+    thrift::KeyDumpParams keyDumpParams,
+    std::function<void(thrift::Publication&&)> onChunk,
+    std::function<void(folly::exception_wrapper)> onComplete) {
+  auto state = std::make_shared<StreamSyncState>();
+
+  std::vector<std::string> keyPrefixList;
+  if (keyDumpParams.keys_ref().has_value()) {
+    keyPrefixList = *keyDumpParams.keys_ref();
+  } else {
+    folly::split(",", *keyDumpParams.prefix_ref(), keyPrefixList, true);
+  }
+  state->kvFilters =
+      KvStoreFilters(keyPrefixList, *keyDumpParams.originatorIds_ref());
+  state->matchAll = keyDumpParams.oper_ref().has_value() and
+      *keyDumpParams.oper_ref() == thrift::FilterOperator::AND;
+  state->doNotPublishValue = *keyDumpParams.doNotPublishValue_ref();
+  if (keyDumpParams.merkleBuckets_ref().has_value()) {
+    state->merkleBuckets = std::unordered_set<int32_t>(
+        keyDumpParams.merkleBuckets_ref()->begin(),
+        keyDumpParams.merkleBuckets_ref()->end());
+  }
+  if (keyDumpParams.keyValHashes_ref().has_value()) {
+    state->keyValHashes = std::move(*keyDumpParams.keyValHashes_ref());
+  }
+  // ATTN: keys visited later are at least as recent as on stream start
+  if (not state->merkleBuckets.has_value()) {
+    state->changeLogPosition = getChangeLogPosition();
+  }
+  state->onChunk = std::move(onChunk);
+  state->onComplete = std::move(onComplete);
+
+  sendNextStreamSyncChunk(std::move(state));
+}
+
+void
+KvStoreDb::sendNextStreamSyncChunk(std::shared_ptr<StreamSyncState> state) {
+  thrift::Publication chunk;
+  chunk.area_ref() = area_;
+  if (state->keyValHashes.has_value()) {
+    chunk.tobeUpdatedKeys_ref() = std::vector<std::string>{};
+  }
+
+  auto isMatch = [&](std::string const& key, thrift::Value const& val) {
+    if (state->merkleBuckets.has_value() and
+        not state->merkleBuckets->count(
+            static_cast<int32_t>(merkleTree_.getBucket(key)))) {
+      return false;
+    }
+    return state->matchAll ? state->kvFilters.keyMatchAll(key, val)
+                           : state->kvFilters.keyMatch(key, val);
+  };
+
+  // ATTN: keys are visited in order, hence keys added behind the cursor
+  //       while streaming are left to flooding
+  size_t chunkBytes{0};
+  auto it = state->lastKey.has_value() ? keyIndex_.upper_bound(*state->lastKey)
+                                       : keyIndex_.begin();
+  for (; it != keyIndex_.end() and
+       chunkBytes < Constants::kKvStoreFullSyncChunkMaxBytes;
+       ++it) {
+    auto const& key = **it;
+    auto kvIt = kvStore_.find(key);
+    DCHECK(kvIt != kvStore_.end());
+    auto const& myVal = kvIt->second;
+    if (not isMatch(key, myVal)) {
+      continue;
+    }
+
+    if (state->keyValHashes.has_value()) {
+      auto reqIt = state->keyValHashes->find(key);
+      if (reqIt != state->keyValHashes->end()) {
+        // common key, same as dumpDifference()
+        int rc = compareValues(myVal, reqIt->second);
+        state->keyValHashes->erase(reqIt);
+        if (rc == -1 or rc == -2) {
+          // reqVal is better or unknown
+          chunk.tobeUpdatedKeys_ref()->emplace_back(key);
+        }
+        if (rc != 1 and rc != -2) {
+          continue;
+        }
+      }
+    }
+
+    chunkBytes += key.size() +
+        (myVal.value_ref().has_value() ? myVal.value_ref()->size() : 0);
+    chunk.keyVals_ref()->emplace(
+        key,
+        state->doNotPublishValue ? createThriftValueWithoutBinaryValue(myVal)
+                                 : myVal);
+  }
+
+  const bool lastChunk = it == keyIndex_.end();
+  if (lastChunk) {
+    // the rest of requester's keys do NOT exist in my store
+    if (state->keyValHashes.has_value()) {
+      for (auto const& [key, _] : *state->keyValHashes) {
+        chunk.tobeUpdatedKeys_ref()->emplace_back(key);
+      }
+    }
+  } else {
+    state->lastKey = **std::prev(it);
+  }
+
+  updatePublicationTtl(chunk);
+  // I'm the initiator, set flood-root-id
+  chunk.floodRootId_ref().from_optional(getSptRootId());
+  if (state->changeLogPosition.has_value()) {
+    chunk.changeLogPosition_ref() = std::move(*state->changeLogPosition);
+    state->changeLogPosition.reset();
+  }
+
+  fb303::fbData->addStatValue(
+      "kvstore.thrift.num_full_sync_chunks_sent", 1, fb303::COUNT);
+  state->onChunk(std::move(chunk));
+
+  if (lastChunk) {
+    state->onComplete(folly::exception_wrapper());
+    return;
+  }
+  // yield to other events before producing the next chunk
+  evb_->getEvb()->runInEventBaseThread(
+      [this, state = std::move(state)]() mutable {
+        sendNextStreamSyncChunk(std::move(state));
+      });
+}
+
 // This function serves the purpose of periodically scanning peers in
 // IDLE state and promote them to SYNCING state. The initial dump will
 // happen in async nature to unblock KvStore to process other requests.
@@ -1802,6 +2652,13 @@ KvStoreDb::requestThriftPeerSync() {
   uint32_t numThriftPeersInSync =
       getPeersByState(thrift::KvStorePeerState::SYNCING).size();
 
+  // On cold start, peers promoted in this round share the keyspace instead
+  // of each sending a complete dump
+  const bool partitionedSync = kvParams_.enablePartitionedInitialSync and
+      not initialSyncCompleted_ and kvStore_.empty() and
+      numThriftPeersInSync == 0;
+  std::vector<std::pair<std::string, thrift::KeyDumpParams>> partitionedPeers;
+
   // Scan over thriftPeers to promote IDLE peers to SYNCING
   for (auto& [peerName, thriftPeer] : thriftPeers_) {
     auto& peerSpec = thriftPeer.peerSpec; // thrift::PeerSpec
@@ -1847,54 +2704,20 @@ KvStoreDb::requestThriftPeerSync() {
       params.originatorIds_ref() =
           kvParams_.filters.value().getOriginatorIdList();
     }
-    KvStoreFilters kvFilters(
-        std::vector<std::string>{}, /* keyPrefixList */
-        std::set<std::string>{} /* originator */);
-    params.keyValHashes_ref() =
-        std::move(*dumpHashWithFilters(kvFilters).keyVals_ref());
-
-    // record telemetry for initial full-sync
-    fb303::fbData->addStatValue(
-        "kvstore.thrift.num_full_sync", 1, fb303::COUNT);
-
-    LOG(INFO) << AreaTag()
-              << fmt::format(
-                     "[Thrift Sync] Initiating full-sync request for peer: {}",
-                     peerName);
-
-    // send request over thrift client and attach callback
-    auto startTime = std::chrono::steady_clock::now();
-    // TODO: switch to getKvStoreKeyValsFiltered() when all nodes have
-    // version with area param
-    auto sf = thriftPeer.client->semifuture_getKvStoreKeyValsFilteredArea(
-        params, area_);
-    std::move(sf)
-        .via(evb_->getEvb())
-        .thenValue(
-            [this, peer = peerName, startTime](thrift::Publication&& pub) {
-              // state transition to INITIALIZED
-              auto endTime = std::chrono::steady_clock::now();
-              auto timeDelta =
-                  std::chrono::duration_cast<std::chrono::milliseconds>(
-                      endTime - startTime);
-              processThriftSuccess(peer, std::move(pub), timeDelta);
-            })
-        .thenError([this, peer = peerName, startTime](
-                       const folly::exception_wrapper& ew) {
-          // state transition to IDLE
-          auto endTime = std::chrono::steady_clock::now();
-          auto timeDelta =
-              std::chrono::duration_cast<std::chrono::milliseconds>(
-                  endTime - startTime);
-          processThriftFailure(
-              peer,
-              fmt::format("FULL_SYNC failure with {}, {}", peer, ew.what()),
-              timeDelta);
 
-          // record telemetry for thrift calls
-          fb303::fbData->addStatValue(
-              "kvstore.thrift.num_full_sync_failure", 1, fb303::COUNT);
-        });
+    thriftPeer.syncBuckets.clear();
+    thriftPeer.syncChangeLogPosition.reset();
+    if (partitionedSync) {
+      // defer request until key ranges are assigned to all peers
+      partitionedPeers.emplace_back(peerName, std::move(params));
+    } else if (
+        kvParams_.enableIncrementalSync and
+        peerChangeLogPositions_.count(peerName)) {
+      // synced with this peer before, fetch ONLY what changed since
+      requestThriftPeerIncrementalSync(peerName, std::move(params));
+    } else {
+      requestThriftPeerFullSync(peerName, std::move(params));
+    }
 
     // in case pending peer size is over parallelSyncLimit,
     // wait until kMaxBackoff before sending next round of sync
@@ -1910,6 +2733,10 @@ KvStoreDb::requestThriftPeerSync() {
     }
   } // for loop
 
+  if (not partitionedPeers.empty()) {
+    requestPartitionedThriftPeerSync(std::move(partitionedPeers));
+  }
+
   // process the rest after min timeout if NOT scheduled
   uint32_t numThriftPeersInIdle =
       getPeersByState(thrift::KvStorePeerState::IDLE).size();
@@ -1925,6 +2752,521 @@ KvStoreDb::requestThriftPeerSync() {
   }
 }
 
+void
+KvStoreDb::requestThriftPeerMerkleSync(
+    std::string const& peerName, thrift::KeyDumpParams&& params) {
+  auto& thriftPeer = thriftPeers_.at(peerName);
+
+  // record telemetry for merkle digests exchange
+  fb303::fbData->addStatValue("kvstore.thrift.num_merkle_sync", 1, fb303::COUNT);
+
+  auto startTime = std::chrono::steady_clock::now();
+  auto sf = thriftPeer.client->semifuture_getKvStoreMerkleDigestsArea(area_);
+  std::move(sf)
+      .via(evb_->getEvb())
+      .thenValue([this, peer = peerName, params, startTime](
+                     thrift::KvStoreMerkleDigests&& peerDigests) mutable {
+        // ATTN: peer can be removed or reset to IDLE while waiting for
+        //       digests. New full-sync will be initiated for it.
+        auto peerIt = thriftPeers_.find(peer);
+        if (peerIt == thriftPeers_.end() or
+            peerIt->second.peerSpec.get_state() !=
+                thrift::KvStorePeerState::SYNCING or
+            not peerIt->second.client) {
+          return;
+        }
+
+        // store is up to date with peer as of digests once buckets are synced
+        peerIt->second.syncChangeLogPosition =
+            peerDigests.changeLogPosition_ref().to_optional();
+
+        KvStoreFilters kvFilters(
+            std::vector<std::string>{}, /* keyPrefixList */
+            std::set<std::string>{} /* originator */);
+        auto mismatchedBuckets = merkleTree_.getMismatchedBuckets(peerDigests);
+        if (not mismatchedBuckets.has_value()) {
+          // incompatible tree layout. Exchange all hashes.
+          LOG(WARNING) << AreaTag()
+                       << fmt::format(
+                              "[Thrift Sync] Incompatible merkle digests from "
+                              "peer: {}. Fall back to full-sync.",
+                              peer);
+          params.keyValHashes_ref() =
+              std::move(*dumpHashWithFilters(kvFilters).keyVals_ref());
+          sendThriftPeerSyncRequest(peer, std::move(params));
+          return;
+        }
+
+        fb303::fbData->addStatValue(
+            "kvstore.thrift.num_merkle_mismatched_buckets",
+            mismatchedBuckets->size(),
+            fb303::SUM);
+
+        if (mismatchedBuckets->empty()) {
+          // both stores are in sync. Skip full-sync and promote state.
+          fb303::fbData->addStatValue(
+              "kvstore.thrift.num_merkle_sync_skipped", 1, fb303::COUNT);
+          LOG(INFO) << AreaTag()
+                    << fmt::format(
+                           "[Thrift Sync] Merkle digests match with peer: {}. "
+                           "Skip full-sync.",
+                           peer);
+          thrift::Publication pub;
+          pub.area_ref() = area_;
+          auto timeDelta =
+              std::chrono::duration_cast<std::chrono::milliseconds>(
+                  std::chrono::steady_clock::now() - startTime);
+          processThriftSuccess(peer, std::move(pub), timeDelta);
+          return;
+        }
+
+        LOG(INFO) << AreaTag()
+                  << fmt::format(
+                         "[Thrift Sync] {} out of {} merkle buckets diverged "
+                         "with peer: {}",
+                         mismatchedBuckets->size(),
+                         merkleTree_.getNumBuckets(),
+                         peer);
+        std::unordered_set<int32_t> buckets(
+            mismatchedBuckets->begin(), mismatchedBuckets->end());
+        params.keyValHashes_ref() =
+            std::move(*dumpHashWithFilters(kvFilters, buckets).keyVals_ref());
+        params.merkleBuckets_ref() = std::move(*mismatchedBuckets);
+        sendThriftPeerSyncRequest(peer, std::move(params));
+      })
+      .thenError([this, peer = peerName, params](
+                     const folly::exception_wrapper& ew) mutable {
+        // peer doesn't support merkle digests. Fall back to full-sync.
+        fb303::fbData->addStatValue(
+            "kvstore.thrift.num_merkle_sync_failure", 1, fb303::COUNT);
+
+        auto peerIt = thriftPeers_.find(peer);
+        if (peerIt == thriftPeers_.end() or
+            peerIt->second.peerSpec.get_state() !=
+                thrift::KvStorePeerState::SYNCING or
+            not peerIt->second.client) {
+          return;
+        }
+
+        LOG(WARNING) << AreaTag()
+                     << fmt::format(
+                            "[Thrift Sync] Failed to get merkle digests from "
+                            "peer: {}, {}. Fall back to full-sync.",
+                            peer,
+                            ew.what());
+        KvStoreFilters kvFilters(
+            std::vector<std::string>{}, /* keyPrefixList */
+            std::set<std::string>{} /* originator */);
+        params.keyValHashes_ref() =
+            std::move(*dumpHashWithFilters(kvFilters).keyVals_ref());
+        sendThriftPeerSyncRequest(peer, std::move(params));
+      });
+}
+
+void
+KvStoreDb::requestThriftPeerFullSync(
+    std::string const& peerName, thrift::KeyDumpParams&& params) {
+  if (kvParams_.enableMerkleSync) {
+    // exchange merkle digests first to find out diverged buckets
+    requestThriftPeerMerkleSync(peerName, std::move(params));
+    return;
+  }
+
+  KvStoreFilters kvFilters(
+      std::vector<std::string>{}, /* keyPrefixList */
+      std::set<std::string>{} /* originator */);
+  params.keyValHashes_ref() =
+      std::move(*dumpHashWithFilters(kvFilters).keyVals_ref());
+  sendThriftPeerSyncRequest(peerName, std::move(params));
+}
+
+void
+KvStoreDb::requestThriftPeerIncrementalSync(
+    std::string const& peerName, thrift::KeyDumpParams&& params) {
+  auto& thriftPeer = thriftPeers_.at(peerName);
+
+  // record telemetry for incremental sync
+  fb303::fbData->addStatValue(
+      "kvstore.thrift.num_incremental_sync", 1, fb303::COUNT);
+
+  auto const& position = peerChangeLogPositions_.at(peerName);
+  LOG(INFO) << AreaTag()
+            << fmt::format(
+                   "[Thrift Sync] Initiating incremental sync request for "
+                   "peer: {} since change-log seq: {}",
+                   peerName,
+                   *position.seq_ref());
+
+  auto incrementalParams = params;
+  incrementalParams.changeLogSince_ref() = position;
+
+  auto startTime = std::chrono::steady_clock::now();
+  auto sf = thriftPeer.client->semifuture_getKvStoreKeyValsFilteredArea(
+      incrementalParams, area_);
+  std::move(sf)
+      .via(evb_->getEvb())
+      .thenValue([this, peer = peerName, params, startTime](
+                     thrift::Publication&& pub) mutable {
+        auto timeDelta = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startTime);
+        if (pub.changeLogPosition_ref().has_value()) {
+          fb303::fbData->addStatValue(
+              "kvstore.thrift.num_incremental_sync_success", 1, fb303::COUNT);
+          processThriftSuccess(peer, std::move(pub), timeDelta);
+          return;
+        }
+
+        // peer's change-log no longer covers the last sync
+        fb303::fbData->addStatValue(
+            "kvstore.thrift.num_incremental_sync_fallback", 1, fb303::COUNT);
+        peerChangeLogPositions_.erase(peer);
+
+        auto peerIt = thriftPeers_.find(peer);
+        if (peerIt == thriftPeers_.end() or
+            peerIt->second.peerSpec.get_state() !=
+                thrift::KvStorePeerState::SYNCING or
+            not peerIt->second.client) {
+          return;
+        }
+        LOG(INFO) << AreaTag()
+                  << fmt::format(
+                         "[Thrift Sync] Change-log of peer: {} doesn't cover "
+                         "last sync. Fall back to full-sync.",
+                         peer);
+        requestThriftPeerFullSync(peer, std::move(params));
+      })
+      .thenError([this, peer = peerName, startTime](
+                     const folly::exception_wrapper& ew) {
+        // state transition to IDLE
+        auto timeDelta = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startTime);
+        processThriftFailure(
+            peer,
+            fmt::format(
+                "INCREMENTAL_SYNC failure with {}, {}", peer, ew.what()),
+            timeDelta);
+
+        // record telemetry for thrift calls
+        fb303::fbData->addStatValue(
+            "kvstore.thrift.num_incremental_sync_failure", 1, fb303::COUNT);
+      });
+}
+
+void
+KvStoreDb::requestPartitionedThriftPeerSync(
+    std::vector<std::pair<std::string, thrift::KeyDumpParams>>&& peers) {
+  const size_t numBuckets = merkleTree_.getNumBuckets();
+  const size_t numPeers = peers.size();
+
+  LOG(INFO) << AreaTag()
+            << fmt::format(
+                   "[Thrift Sync] Partitioning {} merkle buckets across {} "
+                   "peer(s) for initial full-sync",
+                   numBuckets,
+                   numPeers);
+  fb303::fbData->addStatValue(
+      "kvstore.thrift.num_partitioned_sync", 1, fb303::COUNT);
+
+  for (size_t i = 0; i < numPeers; ++i) {
+    auto& [peerName, params] = peers.at(i);
+
+    // contiguous range of buckets [begin, end) per peer
+    std::vector<int32_t> buckets;
+    for (size_t bucket = i * numBuckets / numPeers;
+         bucket < (i + 1) * numBuckets / numPeers;
+         ++bucket) {
+      buckets.emplace_back(bucket);
+    }
+    thriftPeers_.at(peerName).syncBuckets = buckets;
+
+    // ATTN: local store is empty, hence no key-hashes to exchange. Empty
+    //       key-hashes are still set to make it a full-sync request.
+    params.keyValHashes_ref() = thrift::KeyVals{};
+    params.merkleBuckets_ref() = std::move(buckets);
+    sendThriftPeerSyncRequest(peerName, std::move(params));
+  }
+}
+
+void
+KvStoreDb::reassignSyncBuckets(std::string const& peerName) {
+  auto& failedPeer = thriftPeers_.at(peerName);
+  if (failedPeer.syncBuckets.empty()) {
+    return;
+  }
+  auto buckets = std::move(failedPeer.syncBuckets);
+  failedPeer.syncBuckets.clear();
+
+  // pick a peer in good standing, prefer the ones already initialized
+  std::optional<std::string> newPeer;
+  for (auto const& [name, peer] : thriftPeers_) {
+    if (name == peerName or not peer.client) {
+      continue;
+    }
+    const auto state = peer.peerSpec.get_state();
+    if (state == thrift::KvStorePeerState::INITIALIZED) {
+      newPeer = name;
+      break;
+    }
+    if (state == thrift::KvStorePeerState::SYNCING and
+        not newPeer.has_value()) {
+      newPeer = name;
+    }
+  }
+
+  if (not newPeer.has_value()) {
+    // no peer to take over. Key range will be fetched by full-sync with
+    // the next peer once it is back.
+    LOG(WARNING) << AreaTag()
+                 << fmt::format(
+                        "[Thrift Sync] No peer to take over {} merkle buckets "
+                        "from peer: {}",
+                        buckets.size(),
+                        peerName);
+    return;
+  }
+
+  LOG(INFO) << AreaTag()
+            << fmt::format(
+                   "[Thrift Sync] Reassigning {} merkle buckets from peer: {} "
+                   "to peer: {}",
+                   buckets.size(),
+                   peerName,
+                   *newPeer);
+  fb303::fbData->addStatValue(
+      "kvstore.thrift.num_partitioned_sync_reassigned", 1, fb303::COUNT);
+  requestThriftPeerBucketSync(*newPeer, buckets);
+}
+
+void
+KvStoreDb::requestThriftPeerBucketSync(
+    std::string const& peerName, std::vector<int32_t> const& buckets) {
+  auto& thriftPeer = thriftPeers_.at(peerName);
+
+  // keys in the range could have been flooded to us meanwhile
+  KvStoreFilters kvFilters(
+      std::vector<std::string>{}, /* keyPrefixList */
+      std::set<std::string>{} /* originator */);
+  thrift::KeyDumpParams params;
+  if (kvParams_.filters.has_value()) {
+    auto keyPrefixes = kvParams_.filters.value().getKeyPrefixes();
+    if (not keyPrefixes.empty()) {
+      params.keys_ref() = std::move(keyPrefixes);
+    }
+    params.originatorIds_ref() =
+        kvParams_.filters.value().getOriginatorIdList();
+  }
+  params.keyValHashes_ref() = std::move(
+      *dumpHashWithFilters(
+           kvFilters,
+           std::unordered_set<int32_t>(buckets.begin(), buckets.end()))
+           .keyVals_ref());
+  params.merkleBuckets_ref() = buckets;
+
+  // initial sync is NOT completed until the range is fetched
+  ++numPendingBucketSyncs_;
+  auto startTime = std::chrono::steady_clock::now();
+  auto sf = thriftPeer.client->semifuture_getKvStoreKeyValsFilteredArea(
+      params, area_);
+  std::move(sf)
+      .via(evb_->getEvb())
+      .thenValue([this, peer = peerName](thrift::Publication&& pub) {
+        --numPendingBucketSyncs_;
+        // check if it is valid peer(i.e. peer removed in process of syncing)
+        if (thriftPeers_.count(peer)) {
+          fb303::fbData->addStatValue(
+              "kvstore.thrift.num_partitioned_sync_key_vals",
+              pub.keyVals_ref()->size(),
+              fb303::SUM);
+          // ATTN: `peer` is MANDATORY to fulfill the finialized sync
+          mergePublication(pub, peer);
+        }
+        if (not initialSyncCompleted_) {
+          processInitializationEvent();
+        }
+      })
+      .thenError([this, peer = peerName, startTime](
+                     const folly::exception_wrapper& ew) {
+        --numPendingBucketSyncs_;
+        // state transition to IDLE, full-sync with peer covers the range
+        auto endTime = std::chrono::steady_clock::now();
+        auto timeDelta = std::chrono::duration_cast<std::chrono::milliseconds>(
+            endTime - startTime);
+        processThriftFailure(
+            peer,
+            fmt::format("BUCKET_SYNC failure with {}, {}", peer, ew.what()),
+            timeDelta);
+      });
+}
+
+void
+KvStoreDb::sendThriftPeerSyncRequest(
+    std::string const& peerName,
+    thrift::KeyDumpParams&& params,
+    bool allowStreaming) {
+  if (kvParams_.enableStreamingFullSync and allowStreaming) {
+    sendThriftPeerStreamSyncRequest(peerName, std::move(params));
+    return;
+  }
+
+  auto& thriftPeer = thriftPeers_.at(peerName);
+
+  // record telemetry for initial full-sync
+  fb303::fbData->addStatValue("kvstore.thrift.num_full_sync", 1, fb303::COUNT);
+
+  LOG(INFO) << AreaTag()
+            << fmt::format(
+                   "[Thrift Sync] Initiating full-sync request for peer: {}",
+                   peerName);
+
+  // send request over thrift client and attach callback
+  auto startTime = std::chrono::steady_clock::now();
+  // TODO: switch to getKvStoreKeyValsFiltered() when all nodes have
+  // version with area param
+  auto sf = thriftPeer.client->semifuture_getKvStoreKeyValsFilteredArea(
+      params, area_);
+  std::move(sf)
+      .via(evb_->getEvb())
+      .thenValue([this, peer = peerName, startTime](thrift::Publication&& pub) {
+        // state transition to INITIALIZED
+        auto endTime = std::chrono::steady_clock::now();
+        auto timeDelta = std::chrono::duration_cast<std::chrono::milliseconds>(
+            endTime - startTime);
+        processThriftSuccess(peer, std::move(pub), timeDelta);
+      })
+      .thenError([this, peer = peerName, startTime](
+                     const folly::exception_wrapper& ew) {
+        // state transition to IDLE
+        auto endTime = std::chrono::steady_clock::now();
+        auto timeDelta = std::chrono::duration_cast<std::chrono::milliseconds>(
+            endTime - startTime);
+        processThriftFailure(
+            peer,
+            fmt::format("FULL_SYNC failure with {}, {}", peer, ew.what()),
+            timeDelta);
+
+        // record telemetry for thrift calls
+        fb303::fbData->addStatValue(
+            "kvstore.thrift.num_full_sync_failure", 1, fb303::COUNT);
+      });
+}
+
+void
+KvStoreDb::sendThriftPeerStreamSyncRequest(
+    std::string const& peerName, thrift::KeyDumpParams&& params) {
+  auto& thriftPeer = thriftPeers_.at(peerName);
+  const auto streamId = ++thriftPeer.syncStreamId;
+
+  // record telemetry for initial full-sync
+  fb303::fbData->addStatValue("kvstore.thrift.num_full_sync", 1, fb303::COUNT);
+
+  LOG(INFO)
+      << AreaTag()
+      << fmt::format(
+             "[Thrift Sync] Initiating streaming full-sync request for peer: {}",
+             peerName);
+
+  // check if chunk belongs to the latest full-sync with a syncing peer
+  auto isCurrentStream = [this, streamId](std::string const& peer) {
+    auto peerIt = thriftPeers_.find(peer);
+    return peerIt != thriftPeers_.end() and
+        peerIt->second.syncStreamId == streamId and
+        peerIt->second.peerSpec.get_state() ==
+        thrift::KvStorePeerState::SYNCING;
+  };
+
+  auto startTime = std::chrono::steady_clock::now();
+  auto sf = thriftPeer.client->semifuture_getKvStoreKeyValsFilteredAreaStream(
+      params, area_);
+  std::move(sf)
+      .via(evb_->getEvb())
+      .thenValue([this, peer = peerName, startTime, isCurrentStream](
+                     apache::thrift::ClientBufferedStream<thrift::Publication>&&
+                         stream) {
+        // ATTN: subscription is detached. Chunks of stale stream are dropped
+        //       by `isCurrentStream`.
+        std::move(stream)
+            .subscribeExTry(
+                folly::Executor::getKeepAliveToken(evb_->getEvb()),
+                [this, peer, startTime, isCurrentStream](
+                    folly::Try<thrift::Publication>&& chunk) {
+                  if (not isCurrentStream(peer)) {
+                    return;
+                  }
+                  auto timeDelta =
+                      std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::steady_clock::now() - startTime);
+                  if (chunk.hasException()) {
+                    // state transition to IDLE
+                    processThriftFailure(
+                        peer,
+                        fmt::format(
+                            "STREAM_FULL_SYNC failure with {}, {}",
+                            peer,
+                            chunk.exception().what()),
+                        timeDelta);
+                    fb303::fbData->addStatValue(
+                        "kvstore.thrift.num_full_sync_failure",
+                        1,
+                        fb303::COUNT);
+                    return;
+                  }
+                  if (not chunk.hasValue()) {
+                    // end of stream. All chunks are merged, promote state.
+                    thrift::Publication pub;
+                    pub.area_ref() = area_;
+                    processThriftSuccess(peer, std::move(pub), timeDelta);
+                    return;
+                  }
+
+                  fb303::fbData->addStatValue(
+                      "kvstore.thrift.num_full_sync_chunks", 1, fb303::COUNT);
+                  if (chunk.value().changeLogPosition_ref().has_value()) {
+                    thriftPeers_.at(peer).syncChangeLogPosition =
+                        *chunk.value().changeLogPosition_ref();
+                  }
+                  // ATTN: `peer` is MANDATORY to fulfill the finialized
+                  //       full-sync with keys of this chunk
+                  mergePublication(chunk.value(), peer);
+                })
+            .detach();
+      })
+      .thenError([this,
+                  peer = peerName,
+                  startTime,
+                  isCurrentStream,
+                  params = std::move(params)](
+                     const folly::exception_wrapper& ew) mutable {
+        if (not isCurrentStream(peer)) {
+          return;
+        }
+        if (ew.is_compatible_with<apache::thrift::TApplicationException>()) {
+          // peer doesn't support streaming full-sync
+          LOG(WARNING) << AreaTag()
+                       << fmt::format(
+                              "[Thrift Sync] Streaming full-sync unsupported "
+                              "by peer: {}, {}. Fall back to full-sync.",
+                              peer,
+                              ew.what());
+          sendThriftPeerSyncRequest(
+              peer, std::move(params), false /* allowStreaming */);
+          return;
+        }
+
+        // state transition to IDLE
+        auto endTime = std::chrono::steady_clock::now();
+        auto timeDelta = std::chrono::duration_cast<std::chrono::milliseconds>(
+            endTime - startTime);
+        processThriftFailure(
+            peer,
+            fmt::format("FULL_SYNC failure with {}, {}", peer, ew.what()),
+            timeDelta);
+
+        // record telemetry for thrift calls
+        fb303::fbData->addStatValue(
+            "kvstore.thrift.num_full_sync_failure", 1, fb303::COUNT);
+      });
+}
+
 // This function will process the full-dump response from peers:
 //  1) Merge peer's publication with local KvStoreDb;
 //  2) Send a finalized full-sync to peer for missing keys;
@@ -1991,7 +3333,16 @@ KvStoreDb::processThriftSuccess(
              kvUpdateCnt,
              timeDelta.count());
 
+  // Keep position of peer's change-log for incremental sync on reconnect
+  if (pub.changeLogPosition_ref().has_value()) {
+    peerChangeLogPositions_[peerName] = *pub.changeLogPosition_ref();
+  } else if (peer.syncChangeLogPosition.has_value()) {
+    peerChangeLogPositions_[peerName] = *peer.syncChangeLogPosition;
+  }
+  peer.syncChangeLogPosition.reset();
+
   // State transition
+  peer.syncBuckets.clear();
   auto oldState = peer.peerSpec.get_state();
   peer.peerSpec.state_ref() =
       getNextState(oldState, KvStorePeerEvent::SYNC_RESP_RCVD);
@@ -2029,6 +3380,11 @@ KvStoreDb::processThriftSuccess(
 
 void
 KvStoreDb::processInitializationEvent() {
+  if (numPendingBucketSyncs_ > 0) {
+    // key range of failed peer is still being fetched from other peer
+    return;
+  }
+
   int initialSyncSuccessCnt = 0;
   int initialSyncFailureCnt = 0;
   for (const auto& [peerName, peerStore] : thriftPeers_) {
@@ -2093,6 +3449,9 @@ KvStoreDb::processThriftFailure(
   ++peer.numThriftApiErrors;
   logStateTransition(peerName, oldState, peer.peerSpec.get_state());
 
+  // hand key range over to other peer if failed in partitioned sync
+  reassignSyncBuckets(peerName);
+
   // Thrift error is treated as a completion signal of syncing with peer. Check
   // whether initial sync is completed.
   if (not initialSyncCompleted_) {
@@ -2153,6 +3512,7 @@ KvStoreDb::addThriftPeers(
           thrift::KvStorePeerState::IDLE; // set IDLE initially
       peerIter->second.keepAliveTimer->cancelTimeout(); // cancel timer
       peerIter->second.client.reset(); // destruct thriftClient
+      reassignSyncBuckets(peerName);
     } else {
       // case 3: found a new peer coming up
       LOG(INFO)
@@ -2180,13 +3540,20 @@ KvStoreDb::addThriftPeers(
             p.client->semifuture_getStatus();
             p.keepAliveTimer->scheduleTimeout(period);
           });
+      if (floodRate_) {
+        peer.floodLimiter = std::make_unique<folly::BasicTokenBucket<>>(
+            *floodRate_->flood_msg_per_sec_ref(),
+            *floodRate_->flood_msg_burst_size_ref());
+      }
       thriftPeers_.emplace(name, std::move(peer));
+      ++generation_;
     }
 
     // create thrift client and do backoff if can't go through
     auto& thriftPeer = thriftPeers_.at(peerName);
     thriftPeer.getOrCreateThriftClient(evb_, kvParams_.maybeIpTos);
   } // for loop
+  invalidateFloodPeers();
 
   // kick off thriftSyncTimer_ if not yet to asyc process full-sync
   if (not thriftSyncTimer_->isScheduled()) {
@@ -2320,6 +3687,7 @@ KvStoreDb::addPeers(
       LOG(INFO) << AreaTag() << fmt::format("[Dual] peer up: {}", peer);
       DualNode::peerUp(peer, 1 /* link-cost */); // use hop count as metric
     }
+    invalidateFloodPeers();
   }
 }
 
@@ -2340,8 +3708,47 @@ KvStoreDb::getCounters() const {
 
   // Add some more flat counters
   counters["kvstore.num_keys"] = kvStore_.size();
+  counters["kvstore.keyvals_bytes"] = keyValsSize_.bytes;
+  for (auto const& [keyPrefix, sizes] : keyPrefixSizes_) {
+    if (keyPrefix.empty()) {
+      continue;
+    }
+    counters[fmt::format("kvstore.num_keys.{}", keyPrefix)] = sizes.numKeys;
+    counters[fmt::format("kvstore.keyvals_bytes.{}", keyPrefix)] =
+        sizes.bytes;
+  }
   counters["kvstore.num_peers"] = thriftPeers_.size();
   counters["kvstore.num_zmq_peers"] = peers_.size();
+  // Memory footprint of key-value map and key/TTL bookkeeping
+  counters["kvstore.keyvals_map_bytes"] = kvStore_.getAllocatedMemorySize();
+  counters["kvstore.interned_strings"] = stringPool_.size();
+  counters["kvstore.interned_bytes_saved"] = stringPool_.getBytesSaved();
+  // TTL countdown wheel occupancy
+  counters["kvstore.ttl_wheel.num_entries"] = ttlCountdownWheel_.size();
+  counters["kvstore.ttl_wheel.num_occupied_slots"] =
+      ttlCountdownWheel_.getNumOccupiedSlots();
+  for (size_t level = 0; level < ttlCountdownWheel_.getNumLevels(); ++level) {
+    counters[fmt::format("kvstore.ttl_wheel.level{}.num_entries", level)] =
+        ttlCountdownWheel_.getNumEntries(level);
+  }
+  // Per-peer flooding RPCs in flight, and backlog of keys blocked by flood
+  // window or rate limiter
+  for (auto const& [peerName, thriftPeer] : thriftPeers_) {
+    if (kvParams_.floodWindowSize) {
+      counters[fmt::format(
+          "kvstore.thrift.num_floods_in_flight.{}", peerName)] =
+          thriftPeer.numFloodsInFlight;
+    }
+    if (not thriftPeer.floodLimiter and not kvParams_.floodWindowSize) {
+      continue;
+    }
+    size_t numKeys{0};
+    for (auto const& [_, keys] : thriftPeer.floodBuffer) {
+      numKeys += keys.size();
+    }
+    counters[fmt::format("kvstore.flood_buffer.num_keys.{}", peerName)] =
+        numKeys;
+  }
   return counters;
 }
 
@@ -2367,11 +3774,16 @@ KvStoreDb::delThriftPeers(std::vector<std::string> const& peers) {
                peerSpec.get_peerAddr(),
                peerSpec.get_supportFloodOptimization());
 
+    // hand key range over to other peer if in partitioned sync
+    reassignSyncBuckets(peerName);
+
     // destroy peer info
     peerIter->second.keepAliveTimer.reset();
     peerIter->second.client.reset();
     thriftPeers_.erase(peerIter);
+    ++generation_;
   }
+  invalidateFloodPeers();
 }
 
 // TODO: replace delPeers with delThriftPeers call
@@ -2429,6 +3841,7 @@ KvStoreDb::delPeers(std::vector<std::string> const& peers) {
       LOG(INFO) << AreaTag() << fmt::format("[Dual] peer down: {}", peer);
       DualNode::peerDown(peer);
     }
+    invalidateFloodPeers();
   }
 }
 
@@ -2554,26 +3967,27 @@ void
 KvStoreDb::updatePublicationTtl(
     thrift::Publication& thriftPub, bool removeAboutToExpire) {
   auto timeNow = std::chrono::steady_clock::now();
-  for (const auto& qE : ttlCountdownQueue_) {
-    // Find key and ensure we are taking time from right entry from queue
-    auto kv = thriftPub.keyVals_ref()->find(qE.key);
-    if (kv == thriftPub.keyVals_ref()->end() or
-        *kv->second.version_ref() != qE.version or
-        *kv->second.originatorId_ref() != qE.originatorId or
-        *kv->second.ttlVersion_ref() != qE.ttlVersion) {
+  auto& keyVals = *thriftPub.keyVals_ref();
+  for (auto kv = keyVals.begin(); kv != keyVals.end();) {
+    // Find key and ensure we are taking time from right countdown entry
+    auto const* qE = ttlCountdownWheel_.find(kv->first);
+    if (qE == nullptr or *kv->second.version_ref() != qE->version or
+        *kv->second.originatorId_ref() != *qE->originatorId or
+        *kv->second.ttlVersion_ref() != qE->ttlVersion) {
+      ++kv;
       continue;
     }
 
     // Compute timeLeft and do sanity check on it
-    auto timeLeft = duration_cast<milliseconds>(qE.expiryTime - timeNow);
+    auto timeLeft = duration_cast<milliseconds>(qE->expiryTime - timeNow);
     if (timeLeft <= kvParams_.ttlDecr) {
-      thriftPub.keyVals_ref()->erase(kv);
+      kv = keyVals.erase(kv);
       continue;
     }
 
     // filter key from publication if time left is below ttl threshold
     if (removeAboutToExpire and timeLeft < Constants::kTtlThreshold) {
-      thriftPub.keyVals_ref()->erase(kv);
+      kv = keyVals.erase(kv);
       continue;
     }
 
@@ -2581,7 +3995,101 @@ KvStoreDb::updatePublicationTtl(
     // deterministically whenever it is exchanged between KvStores. This
     // will avoid looping of updates between stores.
     kv->second.ttl_ref() = timeLeft.count() - kvParams_.ttlDecr.count();
+    ++kv;
+  }
+}
+
+bool
+KvStoreDb::saveSnapshot() {
+  CHECK(kvParams_.snapshotPath.has_value());
+  const auto file = fmt::format("{}.{}", *kvParams_.snapshotPath, area_);
+
+  thrift::Publication thriftPub;
+  thriftPub.keyVals_ref() = kvStore_;
+  // remaining ttls as of now
+  updatePublicationTtl(thriftPub, true);
+
+  thrift::KvStoreSnapshot snapshot;
+  snapshot.area_ref() = area_;
+  snapshot.timestampMs_ref() = getUnixTimeStampMs();
+  snapshot.keyVals_ref() = std::move(*thriftPub.keyVals_ref());
+
+  apache::thrift::CompactSerializer serializer;
+  std::string content;
+  serializer.serialize(snapshot, &content);
+  if (folly::writeFileAtomicNoThrow(file, content) != 0) {
+    LOG(ERROR) << AreaTag()
+               << fmt::format("[Warm Start] Failed to write snapshot {}", file);
+    fb303::fbData->addStatValue(
+        "kvstore.snapshot.num_save_failure", 1, fb303::COUNT);
+    return false;
+  }
+  fb303::fbData->addStatValue("kvstore.snapshot.num_saved", 1, fb303::COUNT);
+  fb303::fbData->addStatValue(
+      "kvstore.snapshot.bytes", content.size(), fb303::AVG);
+  return true;
+}
+
+size_t
+KvStoreDb::loadSnapshot() {
+  CHECK(kvParams_.snapshotPath.has_value());
+  const auto file = fmt::format("{}.{}", *kvParams_.snapshotPath, area_);
+
+  std::string content;
+  if (not folly::readFile(file.c_str(), content)) {
+    LOG(INFO) << AreaTag()
+              << fmt::format("[Warm Start] No snapshot {} to seed from", file);
+    return 0;
+  }
+
+  thrift::KvStoreSnapshot snapshot;
+  try {
+    apache::thrift::CompactSerializer serializer;
+    serializer.deserialize(content, snapshot);
+  } catch (std::exception const& ex) {
+    LOG(ERROR) << AreaTag()
+               << fmt::format(
+                      "[Warm Start] Failed to parse snapshot {}: {}",
+                      file,
+                      folly::exceptionStr(ex));
+    return 0;
+  }
+  if (*snapshot.area_ref() != area_) {
+    LOG(ERROR) << AreaTag()
+               << fmt::format(
+                      "[Warm Start] Snapshot {} is taken for area {}",
+                      file,
+                      *snapshot.area_ref());
+    return 0;
+  }
+
+  // drop key-vals expired since snapshot. Remaining ones are reconciled by
+  // full-sync with peers.
+  const auto elapsedMs =
+      std::max(int64_t(0), getUnixTimeStampMs() - *snapshot.timestampMs_ref());
+  thrift::Publication thriftPub;
+  thriftPub.area_ref() = area_;
+  for (auto& [key, value] : *snapshot.keyVals_ref()) {
+    if (*value.ttl_ref() != Constants::kTtlInfinity) {
+      value.ttl_ref() = *value.ttl_ref() - elapsedMs;
+      if (*value.ttl_ref() < Constants::kTtlThreshold.count()) {
+        continue;
+      }
+    }
+    thriftPub.keyVals_ref()->emplace(key, std::move(value));
   }
+
+  const auto numSeeded = mergePublication(thriftPub);
+  LOG(INFO) << AreaTag()
+            << fmt::format(
+                   "[Warm Start] Seeded {} out of {} key-vals from snapshot "
+                   "taken {}ms ago",
+                   numSeeded,
+                   snapshot.keyVals_ref()->size(),
+                   elapsedMs);
+  fb303::fbData->addStatValue(
+      "kvstore.snapshot.num_seeded_key_vals", numSeeded, fb303::SUM);
+  return numSeeded;
 }
 
 // process a request
@@ -2659,6 +4167,7 @@ KvStoreDb::processRequestMsgHelper(
     fb303::fbData->addStatValue(
         "kvstore.received_dual_messages", 1, fb303::COUNT);
     DualNode::processDualMessages(std::move(*thriftReq.dualMessages_ref()));
+    invalidateFloodPeers();
     return fbzmq::Message();
   }
   case thrift::Command::FLOOD_TOPO_SET: {
@@ -2711,9 +4220,36 @@ KvStoreDb::processFloodTopoGet() noexcept {
   return sptInfos;
 }
 
+void
+KvStoreDb::addPendingDualMessages(
+    thrift::DualMessages&& messages, folly::Promise<folly::Unit>&& p) {
+  pendingDualMessages_.emplace_back(std::move(messages));
+  pendingDualPromises_.emplace_back(std::move(p));
+  if (pendingDualMessages_.size() > 1) {
+    // batch already scheduled
+    return;
+  }
+
+  evb_->getEvb()->runInLoop([this]() noexcept {
+    auto messagesBatch = std::move(pendingDualMessages_);
+    auto promises = std::move(pendingDualPromises_);
+    pendingDualMessages_.clear();
+    pendingDualPromises_.clear();
+
+    fb303::fbData->addStatValue(
+        "kvstore.dual_messages_batch_size", messagesBatch.size(), fb303::AVG);
+    DualNode::processDualMessagesBatch(messagesBatch);
+    invalidateFloodPeers();
+    for (auto& promise : promises) {
+      promise.setValue();
+    }
+  });
+}
+
 void
 KvStoreDb::processFloodTopoSet(
     const thrift::FloodTopoSetParams& setParams) noexcept {
+  invalidateFloodPeers();
   if (setParams.allRoots_ref().has_value() and *setParams.allRoots_ref() and
       not(*setParams.setChild_ref())) {
     // process unset-child for all-roots command
@@ -2862,6 +4398,7 @@ KvStoreDb::processNexthopChange(
       << ": callback invoked while nexthop does not change: " << oldNhStr;
   // root should NEVER change its nexthop (nexthop always equal to myself)
   CHECK_NE(kvParams_.nodeId, rootId);
+  invalidateFloodPeers();
 
   LOG(INFO) << AreaTag()
             << fmt::format(
@@ -3118,45 +4655,46 @@ KvStoreDb::drainPeerSyncSock() {
 
 void
 KvStoreDb::cleanupTtlCountdownQueue() {
-  // record all expired keys
+  // record all expired keys along with their last values
   std::vector<std::string> expiredKeys;
+  thrift::KeyVals expiredKeyVals;
   auto now = std::chrono::steady_clock::now();
 
-  // Iterate through ttlCountdownQueue_ until the top expires in the future
-  while (not ttlCountdownQueue_.empty()) {
-    auto top = ttlCountdownQueue_.top();
-    if (top.expiryTime > now) {
-      // Nothing in queue worth evicting
-      break;
-    }
-    auto it = kvStore_.find(top.key);
+  // Advance countdown wheel and purge keys whose countdown is over
+  for (auto const& top : ttlCountdownWheel_.expire(now)) {
+    auto it = kvStore_.find(*top.key);
     if (it != kvStore_.end() and *it->second.version_ref() == top.version and
-        *it->second.originatorId_ref() == top.originatorId and
+        *it->second.originatorId_ref() == *top.originatorId and
         *it->second.ttlVersion_ref() == top.ttlVersion) {
-      expiredKeys.emplace_back(top.key);
+      expiredKeys.emplace_back(*top.key);
       LOG(WARNING)
           << AreaTag()
           << "Delete expired (key, version, originatorId, ttlVersion, ttl, node) "
           << fmt::format(
                  "({}, {}, {}, {}, {}, {})",
-                 top.key,
+                 *top.key,
                  *it->second.version_ref(),
                  *it->second.originatorId_ref(),
                  *it->second.ttlVersion_ref(),
                  *it->second.ttl_ref(),
                  kvParams_.nodeId);
-      logKvEvent("KEY_EXPIRE", top.key);
+      logKvEvent("KEY_EXPIRE", *top.key);
+      merkleTree_.remove(*top.key, *it->second.hash_ref());
+      keyIndex_.erase(top.key);
+      removeFromOriginatorIndex(*it->second.originatorId_ref(), *top.key);
+      updateKeyValsSize(
+          *top.key,
+          *it->second.originatorId_ref(),
+          getKeyValSize(*top.key, it->second),
+          -1);
+      expiredKeyVals.emplace(*top.key, std::move(it->second));
       kvStore_.erase(it);
+      ++generation_;
     }
-    ttlCountdownQueue_.pop();
   }
 
   // Reschedule based on most recent timeout
-  if (not ttlCountdownQueue_.empty()) {
-    ttlCountdownTimer_->scheduleTimeout(
-        std::chrono::duration_cast<std::chrono::milliseconds>(
-            ttlCountdownQueue_.top().expiryTime - now));
-  }
+  scheduleTtlCountdownTimer();
 
   if (expiredKeys.empty()) {
     // no key expires
@@ -3171,64 +4709,142 @@ KvStoreDb::cleanupTtlCountdownQueue() {
   //       with expired keys ONLY to external peers.
   thrift::Publication expiredKeysPub{};
   expiredKeysPub.expiredKeys_ref() = std::move(expiredKeys);
+  expiredKeysPub.expiredKeyVals_ref() = std::move(expiredKeyVals);
   expiredKeysPub.area_ref() = area_;
   floodPublication(std::move(expiredKeysPub));
 }
 
 void
-KvStoreDb::bufferPublication(thrift::Publication&& publication) {
+KvStoreDb::bufferPublication(
+    std::string const& peerName,
+    std::optional<std::string> const& floodRootId,
+    thrift::KeyVals const& keyVals) {
   fb303::fbData->addStatValue("kvstore.rate_limit_suppress", 1, fb303::COUNT);
   fb303::fbData->addStatValue(
-      "kvstore.rate_limit_keys", publication.keyVals_ref()->size(), fb303::AVG);
-  std::optional<std::string> floodRootId{std::nullopt};
-  if (publication.floodRootId_ref().has_value()) {
-    floodRootId = publication.floodRootId_ref().value();
+      "kvstore.rate_limit_keys", keyVals.size(), fb303::AVG);
+
+  // update or add keys. Keys already buffered are coalesced as the latest
+  // value is looked up on flush.
+  auto& keys = thriftPeers_.at(peerName).floodBuffer[floodRootId];
+  size_t numCoalesced{0};
+  for (auto const& [key, _] : keyVals) {
+    if (not keys.emplace(key).second) {
+      ++numCoalesced;
+    }
+  }
+  if (numCoalesced) {
+    fb303::fbData->addStatValue(
+        fmt::format("kvstore.flood_buffer.coalesced_keys.{}", peerName),
+        numCoalesced,
+        fb303::SUM);
   }
-  // update or add keys
-  for (auto const& [key, _] : *publication.keyVals_ref()) {
-    publicationBuffer_[floodRootId].emplace(key);
+
+  if (not pendingPublicationTimer_->isScheduled()) {
+    pendingPublicationTimer_->scheduleTimeout(
+        Constants::kFloodPendingPublication);
   }
-  for (auto const& key : *publication.expiredKeys_ref()) {
-    publicationBuffer_[floodRootId].emplace(key);
+}
+
+void
+KvStoreDb::setFloodRate(std::optional<thrift::KvstoreFloodRate> floodRate) {
+  floodRate_ = std::move(floodRate);
+  for (auto& [peerName, thriftPeer] : thriftPeers_) {
+    if (floodRate_) {
+      thriftPeer.floodLimiter = std::make_unique<folly::BasicTokenBucket<>>(
+          *floodRate_->flood_msg_per_sec_ref(),
+          *floodRate_->flood_msg_burst_size_ref());
+    } else {
+      thriftPeer.floodLimiter = nullptr;
+      if (not thriftPeer.floodBuffer.empty() and
+          not isFloodWindowFull(thriftPeer)) {
+        floodBufferedUpdates(peerName);
+      }
+    }
   }
+  LOG(INFO) << AreaTag() << "Set flood rate of peers to "
+            << (floodRate_ ? fmt::format(
+                                 "{} msg/s, burst {}",
+                                 *floodRate_->flood_msg_per_sec_ref(),
+                                 *floodRate_->flood_msg_burst_size_ref())
+                           : "unlimited");
 }
 
 void
 KvStoreDb::floodBufferedUpdates() {
-  if (!publicationBuffer_.size()) {
-    return;
+  bool backlogged{false};
+  for (auto& [peerName, thriftPeer] : thriftPeers_) {
+    if (thriftPeer.floodBuffer.empty()) {
+      continue;
+    }
+    if (not canFloodToPeer(thriftPeer)) {
+      // ATTN: other peers are NOT held back by this peer. Peers with full
+      // flood window are flushed once an outstanding RPC completes.
+      backlogged |= not isFloodWindowFull(thriftPeer);
+      continue;
+    }
+    floodBufferedUpdates(peerName);
+  }
+
+  if (backlogged) {
+    pendingPublicationTimer_->scheduleTimeout(
+        Constants::kFloodPendingPublication);
   }
+}
 
-  // merged-publications to be sent
-  std::vector<thrift::Publication> publications;
+void
+KvStoreDb::floodBufferedUpdates(std::string const& peerName) {
+  auto& thriftPeer = thriftPeers_.at(peerName);
+  auto floodBuffer = std::move(thriftPeer.floodBuffer);
+  thriftPeer.floodBuffer.clear();
 
-  // merge publication per root-id
-  for (const auto& [rootId, keys] : publicationBuffer_) {
-    thrift::Publication publication{};
-    // convert from std::optional to std::optional
-    std::optional<std::string> floodRootId{std::nullopt};
-    if (rootId.has_value()) {
-      floodRootId = rootId.value();
+  if (thriftPeer.peerSpec.get_state() !=
+          thrift::KvStorePeerState::INITIALIZED or
+      (not thriftPeer.client)) {
+    // peer went IDLE while backlogged, flood keys after intialized
+    for (auto const& [_, keys] : floodBuffer) {
+      thriftPeer.pendingKeysDuringInitialization.insert(
+          keys.begin(), keys.end());
     }
-    publication.floodRootId_ref().from_optional(floodRootId);
-    for (const auto& key : keys) {
+    return;
+  }
+
+  // merge publication per root-id
+  size_t numDropped{0};
+  for (auto const& [rootId, keys] : floodBuffer) {
+    thrift::Publication publication;
+    for (auto const& key : keys) {
       auto kvStoreIt = kvStore_.find(key);
-      if (kvStoreIt != kvStore_.end()) {
-        publication.keyVals_ref()->emplace(make_pair(key, kvStoreIt->second));
-      } else {
-        publication.expiredKeys_ref()->emplace_back(key);
+      if (kvStoreIt == kvStore_.end()) {
+        // expired while buffered, peer expires it on its own
+        ++numDropped;
+        continue;
       }
+      publication.keyVals_ref()->emplace(key, kvStoreIt->second);
     }
-    publications.emplace_back(std::move(publication));
-  }
 
-  publicationBuffer_.clear();
+    // Update ttl on keys and remove keys which are about to expire
+    const auto numKeys = publication.keyVals_ref()->size();
+    updatePublicationTtl(publication, true);
+    numDropped += numKeys - publication.keyVals_ref()->size();
+    if (publication.keyVals_ref()->empty()) {
+      continue;
+    }
 
-  for (auto& pub : publications) {
     // when sending out merged publication, we maintain orginal-root-id
-    // we act as a forwarder, NOT an initiator. Disable set-flood-root here
-    floodPublication(
-        std::move(pub), false /* rate-limit */, false /* set-flood-root */);
+    // we act as a forwarder, NOT an initiator.
+    thrift::KeySetParams params;
+    params.keyVals_ref() = std::move(*publication.keyVals_ref());
+    params.nodeIds_ref() = std::vector<std::string>{kvParams_.nodeId};
+    params.floodRootId_ref().from_optional(rootId);
+    params.timestamp_ms_ref() = getUnixTimeStampMs();
+    floodKeyValsToPeer(peerName, params);
+  }
+
+  if (numDropped) {
+    fb303::fbData->addStatValue(
+        fmt::format("kvstore.flood_buffer.dropped_keys.{}", peerName),
+        numDropped,
+        fb303::SUM);
   }
 }
 
@@ -3328,8 +4944,13 @@ KvStoreDb::finalizeFullSync(
       });
 }
 
-std::unordered_set<std::string>
+std::unordered_set<std::string> const&
 KvStoreDb::getFloodPeers(const std::optional<std::string>& rootId) {
+  auto cacheIt = floodPeersCache_.find(rootId);
+  if (cacheIt != floodPeersCache_.end()) {
+    return cacheIt->second;
+  }
+
   auto sptPeers = DualNode::getSptPeers(rootId);
   bool floodToAll = false;
   if (not kvParams_.enableFloodOptimization or sptPeers.empty()) {
@@ -3348,7 +4969,14 @@ KvStoreDb::getFloodPeers(const std::optional<std::string>& rootId) {
       floodPeers.emplace(peerName);
     }
   }
-  return floodPeers;
+  fb303::fbData->addStatValue(
+      "kvstore.num_flood_peers_computed", 1, fb303::COUNT);
+  return floodPeersCache_.emplace(rootId, std::move(floodPeers)).first->second;
+}
+
+void
+KvStoreDb::invalidateFloodPeers() noexcept {
+  floodPeersCache_.clear();
 }
 
 void
@@ -3362,19 +4990,7 @@ KvStoreDb::collectSendFailureStats(
 
 void
 KvStoreDb::floodPublication(
-    thrift::Publication&& publication, bool rateLimit, bool setFloodRoot) {
-  // rate limit if configured
-  if (floodLimiter_ && rateLimit && !floodLimiter_->consume(1)) {
-    bufferPublication(std::move(publication));
-    pendingPublicationTimer_->scheduleTimeout(
-        Constants::kFloodPendingPublication);
-    return;
-  }
-  // merge with buffered publication and flood
-  if (publicationBuffer_.size()) {
-    bufferPublication(std::move(publication));
-    return floodBufferedUpdates();
-  }
+    thrift::Publication&& publication, bool setFloodRoot) {
   // Update ttl on keys we are trying to advertise. Also remove keys which
   // are about to expire.
   updatePublicationTtl(publication, true);
@@ -3384,6 +5000,8 @@ KvStoreDb::floodPublication(
       publication.expiredKeys_ref()->empty()) {
     return;
   }
+  ScopedTraceSpan traceSpan(
+      "kvstore.flood", area_, publication.keyVals_ref()->size());
 
   // Find from whom we might have got this publication. Last entry is our ID
   // and hence second last entry is the node from whom we get this
@@ -3398,12 +5016,22 @@ KvStoreDb::floodPublication(
   }
   publication.nodeIds_ref()->emplace_back(kvParams_.nodeId);
 
-  // Flood publication to internal subscribers
-  kvParams_.kvStoreUpdatesQueue.push(Publication(publication));
-  fb303::fbData->addStatValue("kvstore.num_updates", 1, fb303::COUNT);
+  // Flood publication to internal subscribers, which share it. Compressed
+  // values are decompressed for them, while flooded and stored as is.
+  auto publishToSubscribers = [this, &publication]() {
+    if (kvParams_.valueCodec) {
+      kvParams_.valueCodec->decompressKeyVals(*publication.keyVals_ref());
+      if (auto expiredKeyVals = publication.expiredKeyVals_ref()) {
+        kvParams_.valueCodec->decompressKeyVals(*expiredKeyVals);
+      }
+    }
+    kvParams_.kvStoreUpdatesQueue.push(Publication(std::move(publication)));
+    fb303::fbData->addStatValue("kvstore.num_updates", 1, fb303::COUNT);
+  };
 
   // Flood keyValue ONLY updates to external neighbors
   if (publication.keyVals_ref()->empty()) {
+    publishToSubscribers();
     return;
   }
 
@@ -3418,17 +5046,28 @@ KvStoreDb::floodPublication(
                  keysToUpdate.size())
           << fmt::format("Updated keys: {}", folly::join(",", keysToUpdate));
 
-  if (setFloodRoot and not senderId.has_value()) {
-    // I'm the initiator, set flood-root-id
-    publication.floodRootId_ref().from_optional(DualNode::getSptRootId());
-  }
-
   // prepare thrift structure for flooding purpose
   thrift::KeySetParams params;
-  params.keyVals_ref() = *publication.keyVals_ref();
   params.nodeIds_ref().copy_from(publication.nodeIds_ref());
   params.floodRootId_ref().copy_from(publication.floodRootId_ref());
   params.timestamp_ms_ref() = getUnixTimeStampMs();
+  if (setFloodRoot and not senderId.has_value()) {
+    // I'm the initiator, set flood-root-id
+    params.floodRootId_ref().from_optional(DualNode::getSptRootId());
+  }
+
+  // With compact ttl flooding, ttl-only key-vals are coalesced per peer and
+  // flushed by ttlFloodTimer_ instead of being flooded with full key-vals.
+  // Values are moved, not copied, into the flooded params, and moved back
+  // for subscribers once serialized towards every peer.
+  std::vector<std::string> ttlOnlyKeys;
+  for (auto& [key, value] : *publication.keyVals_ref()) {
+    if (kvParams_.enableCompactTtlFlood and not value.value_ref().has_value()) {
+      ttlOnlyKeys.emplace_back(key);
+      continue;
+    }
+    params.keyVals_ref()->emplace(key, std::move(value));
+  }
 
   std::optional<std::string> floodRootId{std::nullopt};
   if (params.floodRootId_ref().has_value()) {
@@ -3458,41 +5097,224 @@ KvStoreDb::floodPublication(
       // Skip flooding to those peers if peer has NOT finished
       // initial sync(i.e. promoted to `INITIALIZED`)
       // store key for flooding after intialized
-      for (auto const& [key, _] : params.get_keyVals()) {
+      for (auto const& [key, _] : *publication.keyVals_ref()) {
         thriftPeer.pendingKeysDuringInitialization.insert(key);
       }
       continue;
     }
 
-    // record telemetry for flooding publications
+    if (not ttlOnlyKeys.empty()) {
+      thriftPeer.pendingTtlUpdates.insert(
+          ttlOnlyKeys.begin(), ttlOnlyKeys.end());
+      if (not ttlFloodTimer_->isScheduled()) {
+        ttlFloodTimer_->scheduleTimeout(Constants::kFloodPendingTtlUpdates);
+      }
+    }
+    if (params.keyVals_ref()->empty()) {
+      continue;
+    }
+
+    // bound RPCs in flight and rate limit if configured. Once backlogged,
+    // updates are merged into the buffer to keep them in order
+    if (not thriftPeer.floodBuffer.empty()) {
+      bufferPublication(peerName, floodRootId, *params.keyVals_ref());
+      if (canFloodToPeer(thriftPeer)) {
+        floodBufferedUpdates(peerName);
+      }
+      continue;
+    }
+    if (not canFloodToPeer(thriftPeer)) {
+      bufferPublication(peerName, floodRootId, *params.keyVals_ref());
+      continue;
+    }
+
+    floodKeyValsToPeer(peerName, params);
+  }
+
+  for (auto& [key, value] : *params.keyVals_ref()) {
+    publication.keyVals_ref()->at(key) = std::move(value);
+  }
+  publishToSubscribers();
+}
+
+void
+KvStoreDb::floodKeyValsToPeer(
+    std::string const& peerName, thrift::KeySetParams const& params) {
+  auto& thriftPeer = thriftPeers_.at(peerName);
+  ++thriftPeer.numFloodsInFlight;
+
+  // record telemetry for flooding publications
+  fb303::fbData->addStatValue("kvstore.thrift.num_flood_pub", 1, fb303::COUNT);
+  fb303::fbData->addStatValue(
+      "kvstore.thrift.num_flood_key_vals",
+      params.keyVals_ref()->size(),
+      fb303::SUM);
+  fb303::fbData->addStatValue(
+      "kvstore.thrift.flood_pub_key_vals",
+      params.keyVals_ref()->size(),
+      fb303::AVG);
+  fb303::fbData->addStatValue(
+      "kvstore.thrift.flood_pub_in_flight",
+      thriftPeer.numFloodsInFlight,
+      fb303::AVG);
+
+  auto startTime = std::chrono::steady_clock::now();
+  auto sf = thriftPeer.client->semifuture_setKvStoreKeyVals(params, area_);
+  std::move(sf)
+      .via(evb_->getEvb())
+      .thenValue([this,
+                  peerName,
+                  clientId = thriftPeer.clientId,
+                  startTime](folly::Unit&&) {
+        VLOG(4) << "Flooding ack received from peer: " << peerName;
+
+        auto endTime = std::chrono::steady_clock::now();
+        auto timeDelta = std::chrono::duration_cast<std::chrono::milliseconds>(
+            endTime - startTime);
+
+        // record telemetry for thrift calls
+        fb303::fbData->addStatValue(
+            "kvstore.thrift.num_flood_pub_success", 1, fb303::COUNT);
+        fb303::fbData->addStatValue(
+            "kvstore.thrift.flood_pub_duration_ms",
+            timeDelta.count(),
+            fb303::AVG);
+        processFloodCompletion(peerName, clientId);
+      })
+      .thenError([this,
+                  peerName,
+                  clientId = thriftPeer.clientId,
+                  startTime](const folly::exception_wrapper& ew) {
+        // state transition to IDLE
+        auto endTime = std::chrono::steady_clock::now();
+        auto timeDelta = std::chrono::duration_cast<std::chrono::milliseconds>(
+            endTime - startTime);
+        processThriftFailure(
+            peerName,
+            fmt::format("FLOOD_PUB failure with {}, {}", peerName, ew.what()),
+            timeDelta);
+        // buffered updates are deferred until the peer is initialized again
+        processFloodCompletion(peerName, clientId);
+
+        // record telemetry for thrift calls
+        fb303::fbData->addStatValue(
+            "kvstore.thrift.num_flood_pub_failure", 1, fb303::COUNT);
+      });
+}
+
+bool
+KvStoreDb::isFloodWindowFull(KvStorePeer const& thriftPeer) const {
+  return kvParams_.floodWindowSize and
+      thriftPeer.numFloodsInFlight >= kvParams_.floodWindowSize;
+}
+
+bool
+KvStoreDb::canFloodToPeer(KvStorePeer& thriftPeer) {
+  if (isFloodWindowFull(thriftPeer)) {
+    fb303::fbData->addStatValue(
+        "kvstore.thrift.num_flood_window_full", 1, fb303::COUNT);
+    return false;
+  }
+  return not thriftPeer.floodLimiter or thriftPeer.floodLimiter->consume(1);
+}
+
+void
+KvStoreDb::processFloodCompletion(
+    std::string const& peerName, uint64_t clientId) {
+  // check if it is valid peer(i.e. peer removed or reconnected meanwhile)
+  auto peerIt = thriftPeers_.find(peerName);
+  if (peerIt == thriftPeers_.end() or peerIt->second.clientId != clientId) {
+    return;
+  }
+
+  auto& thriftPeer = peerIt->second;
+  CHECK_GT(thriftPeer.numFloodsInFlight, 0);
+  --thriftPeer.numFloodsInFlight;
+
+  // updates buffered while window was full go out merged
+  if (not thriftPeer.floodBuffer.empty() and canFloodToPeer(thriftPeer)) {
+    floodBufferedUpdates(peerName);
+  }
+}
+
+void
+KvStoreDb::floodPendingTtlUpdates() {
+  auto timeNow = std::chrono::steady_clock::now();
+  for (auto& [peerName, thriftPeer] : thriftPeers_) {
+    if (thriftPeer.pendingTtlUpdates.empty()) {
+      continue;
+    }
+    auto pendingKeys = std::move(thriftPeer.pendingTtlUpdates);
+    thriftPeer.pendingTtlUpdates.clear();
+    if (thriftPeer.peerSpec.get_state() !=
+            thrift::KvStorePeerState::INITIALIZED or
+        (not thriftPeer.client)) {
+      // peer went through re-sync, which carries the latest ttl anyway
+      continue;
+    }
+
+    // Build updates out of the latest local state of the key. Key might be
+    // expired or updated with new value since the ttl refresh got coalesced.
+    thrift::KvStoreTtlUpdates ttlUpdates;
+    for (auto const& key : pendingKeys) {
+      auto kvStoreIt = kvStore_.find(key);
+      if (kvStoreIt == kvStore_.end()) {
+        continue;
+      }
+      auto const& value = kvStoreIt->second;
+      int64_t ttl = Constants::kTtlInfinity;
+      if (*value.ttl_ref() != Constants::kTtlInfinity) {
+        // Ensure we are taking time from right countdown entry
+        auto const* qE = ttlCountdownWheel_.find(key);
+        if (qE == nullptr or *value.version_ref() != qE->version or
+            *value.ttlVersion_ref() != qE->ttlVersion) {
+          continue;
+        }
+        auto timeLeft = duration_cast<milliseconds>(qE->expiryTime - timeNow);
+        if (timeLeft <= kvParams_.ttlDecr or
+            timeLeft < Constants::kTtlThreshold) {
+          continue;
+        }
+        ttl = timeLeft.count() - kvParams_.ttlDecr.count();
+      }
+
+      thrift::KvStoreTtlUpdate update;
+      update.key_ref() = key;
+      update.version_ref() = *value.version_ref();
+      update.ttlVersion_ref() = *value.ttlVersion_ref();
+      update.ttl_ref() = ttl;
+      update.hash_ref() = value.hash_ref().value_or(0);
+      ttlUpdates.ttlUpdates_ref()->emplace_back(std::move(update));
+    }
+    if (ttlUpdates.ttlUpdates_ref()->empty()) {
+      continue;
+    }
+    // ATTN: updates are coalesced from multiple publications, only the
+    // local node is reported as sender
+    ttlUpdates.nodeIds_ref() = std::vector<std::string>{kvParams_.nodeId};
+    ttlUpdates.timestamp_ms_ref() = getUnixTimeStampMs();
+
+    // record telemetry for flooding ttl updates
     fb303::fbData->addStatValue(
-        "kvstore.thrift.num_flood_pub", 1, fb303::COUNT);
+        "kvstore.thrift.num_flood_ttl_pub", 1, fb303::COUNT);
     fb303::fbData->addStatValue(
-        "kvstore.thrift.num_flood_key_vals",
-        publication.keyVals_ref()->size(),
+        "kvstore.thrift.num_flood_ttl_updates",
+        ttlUpdates.ttlUpdates_ref()->size(),
         fb303::SUM);
 
+    auto sf = thriftPeer.client->semifuture_setKvStoreTtlUpdates(
+        ttlUpdates, area_);
     auto startTime = std::chrono::steady_clock::now();
-    auto sf = thriftPeer.client->semifuture_setKvStoreKeyVals(params, area_);
     std::move(sf)
         .via(evb_->getEvb())
-        .thenValue([peerName, startTime](folly::Unit&&) {
-          VLOG(4) << "Flooding ack received from peer: " << peerName;
-
-          auto endTime = std::chrono::steady_clock::now();
-          auto timeDelta =
-              std::chrono::duration_cast<std::chrono::milliseconds>(
-                  endTime - startTime);
+        .thenValue([peerName = peerName](folly::Unit&&) {
+          VLOG(4) << "Ttl flooding ack received from peer: " << peerName;
 
           // record telemetry for thrift calls
           fb303::fbData->addStatValue(
-              "kvstore.thrift.num_flood_pub_success", 1, fb303::COUNT);
-          fb303::fbData->addStatValue(
-              "kvstore.thrift.flood_pub_duration_ms",
-              timeDelta.count(),
-              fb303::AVG);
+              "kvstore.thrift.num_flood_ttl_pub_success", 1, fb303::COUNT);
         })
-        .thenError([this, peerName, startTime](
+        .thenError([this, peerName = peerName, startTime](
                        const folly::exception_wrapper& ew) {
           // state transition to IDLE
           auto endTime = std::chrono::steady_clock::now();
@@ -3501,12 +5323,13 @@ KvStoreDb::floodPublication(
                   endTime - startTime);
           processThriftFailure(
               peerName,
-              fmt::format("FLOOD_PUB failure with {}, {}", peerName, ew.what()),
+              fmt::format(
+                  "FLOOD_TTL_PUB failure with {}, {}", peerName, ew.what()),
               timeDelta);
 
           // record telemetry for thrift calls
           fb303::fbData->addStatValue(
-              "kvstore.thrift.num_flood_pub_failure", 1, fb303::COUNT);
+              "kvstore.thrift.num_flood_ttl_pub_failure", 1, fb303::COUNT);
         });
   }
 }
@@ -3527,6 +5350,8 @@ KvStoreDb::mergePublication(
       "kvstore.received_key_vals." + area_,
       rcvdPublication.keyVals_ref()->size(),
       fb303::SUM);
+  ScopedTraceSpan traceSpan(
+      "kvstore.merge", area_, rcvdPublication.keyVals_ref()->size());
 
   static const std::vector<std::string> kUpdatedKeys = {};
 
@@ -3560,10 +5385,64 @@ KvStoreDb::mergePublication(
     return 0;
   }
 
+  // Record hashes, originatorIds and sizes of existing keys which can be
+  // overridden by value update. Used to maintain merkle tree, originator index
+  // and size accounting incrementally.
+  std::unordered_map<
+      std::string,
+      std::tuple<int64_t /* hash */, std::string /* originatorId */, int64_t>>
+      oldValues;
+  for (auto const& [key, value] : *rcvdPublication.keyVals_ref()) {
+    if (not value.value_ref().has_value()) {
+      continue;
+    }
+    auto it = kvStore_.find(key);
+    if (it != kvStore_.end()) {
+      oldValues.emplace(
+          key,
+          std::make_tuple(
+              *it->second.hash_ref(),
+              *it->second.originatorId_ref(),
+              getKeyValSize(key, it->second)));
+    }
+  }
+
   // Generate delta with local KvStore
   thrift::Publication deltaPublication;
   deltaPublication.keyVals_ref() = mergeKeyValues(
       kvStore_, *rcvdPublication.keyVals_ref(), kvParams_.filters);
+  if (not deltaPublication.keyVals_ref()->empty()) {
+    ++generation_;
+  }
+
+  // Update merkle tree for keys with value update. ttl-only updates don't
+  // change the hash.
+  for (auto const& [key, value] : *deltaPublication.keyVals_ref()) {
+    if (not value.value_ref().has_value()) {
+      continue;
+    }
+    recordChangeLog(key);
+    auto const& newValue = kvStore_.at(key);
+    const auto newHash = *newValue.hash_ref();
+    auto const& newOriginatorId = *newValue.originatorId_ref();
+    auto oldIt = oldValues.find(key);
+    if (oldIt != oldValues.end()) {
+      auto const& [oldHash, oldOriginatorId, oldSize] = oldIt->second;
+      updateKeyValsSize(key, oldOriginatorId, oldSize, -1);
+      merkleTree_.update(key, oldHash, newHash);
+      if (oldOriginatorId != newOriginatorId) {
+        removeFromOriginatorIndex(oldOriginatorId, key);
+        originatorIndex_[newOriginatorId].emplace(stringPool_.intern(key));
+      }
+    } else {
+      merkleTree_.add(key, newHash);
+      auto handle = stringPool_.intern(key);
+      keyIndex_.emplace(handle);
+      originatorIndex_[newOriginatorId].emplace(std::move(handle));
+    }
+    updateKeyValsSize(
+        key, newOriginatorId, getKeyValSize(key, newValue), 1);
+  }
   deltaPublication.floodRootId_ref().copy_from(
       rcvdPublication.floodRootId_ref());
   deltaPublication.area_ref() = area_;
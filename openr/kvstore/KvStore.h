@@ -7,7 +7,13 @@
 
 #pragma once
 
-#include <boost/heap/priority_queue.hpp>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <map>
+#include <set>
+#include <thread>
+
 #include <fbzmq/zmq/Zmq.h>
 #include <folly/Optional.h>
 #include <folly/TokenBucket.h>
@@ -29,7 +35,11 @@
 #include <openr/if/gen-cpp2/OpenrConfig_types.h>
 #include <openr/if/gen-cpp2/Types_constants.h>
 #include <openr/if/gen-cpp2/Types_types.h>
+#include <openr/kvstore/KvStoreMerkleTree.h>
+#include <openr/kvstore/KvStoreStringPool.h>
+#include <openr/kvstore/KvStoreTtlWheel.h>
 #include <openr/kvstore/KvStoreUtil.h>
+#include <openr/kvstore/KvStoreValueCodec.h>
 #include <openr/messaging/ReplicateQueue.h>
 #include <openr/monitor/LogSample.h>
 
@@ -46,26 +56,14 @@ enum class KvStorePeerEvent {
   THRIFT_API_ERROR = 3,
 };
 
-struct TtlCountdownQueueEntry {
-  std::chrono::steady_clock::time_point expiryTime;
-  std::string key;
-  int64_t version{0};
-  int64_t ttlVersion{0};
-  std::string originatorId;
-  bool
-  operator>(TtlCountdownQueueEntry other) const {
-    return expiryTime > other.expiryTime;
-  }
-};
-
 // Structure for values and their backoffs for self-originated key-vals
 struct SelfOriginatedValue {
   // Value associated with the self-originated key
   thrift::Value value;
   // Backoff for advertising key-val to kvstore_. Only for persisted key-vals.
   std::optional<ExponentialBackoff<std::chrono::milliseconds>> keyBackoff;
-  // Backoff for advertising ttl updates for this key-val
-  ExponentialBackoff<std::chrono::milliseconds> ttlBackoff;
+  // Time of next ttl update, i.e. TTL refresh cohort the key-val is in
+  std::optional<std::chrono::steady_clock::time_point> ttlRefreshTime;
 
   SelfOriginatedValue() {}
   explicit SelfOriginatedValue(const thrift::Value& val) : value(val) {}
@@ -74,13 +72,6 @@ struct SelfOriginatedValue {
 using SelfOriginatedKeyVals =
     std::unordered_map<std::string, SelfOriginatedValue>;
 
-// TODO: migrate to std::priority_queue
-using TtlCountdownQueue = boost::heap::priority_queue<
-    TtlCountdownQueueEntry,
-    // Always returns smallest first
-    boost::heap::compare<std::greater<TtlCountdownQueueEntry>>,
-    boost::heap::stable<true>>;
-
 // structure for common params across all instances of KvStoreDb
 struct KvStoreParams {
   // the name of this node (unique in domain)
@@ -110,6 +101,8 @@ struct KvStoreParams {
   std::optional<KvStoreFilters> filters;
   // Kvstore flooding rate
   std::optional<thrift::KvstoreFloodRate> floodRate;
+  // Max flooding RPCs in flight per thrift peer, 0 if unbounded
+  size_t floodWindowSize{0};
   // TTL decrement factor
   std::chrono::milliseconds ttlDecr{Constants::kTtlDecrement};
   // TTL for self-originated keys
@@ -118,8 +111,27 @@ struct KvStoreParams {
   bool enableFloodOptimization{false};
   bool isFloodRoot{false};
   bool enableThriftDualMsg{false};
+  // Knob to skip DUAL computation of roots unaffected by peer flap, and to
+  // dump flood topology incrementally
+  bool enableIncrementalFloodTopo{false};
   // Knob to consume requests to update key-vals via queue
   bool enableKvStoreRequestQueue{false};
+  // Knob to exchange merkle digests before full-sync with thrift peers
+  bool enableMerkleSync{false};
+  // Knob to run every KvStoreDb on its own dedicated thread
+  bool enablePerAreaThread{false};
+  // Knob to flood TTL refreshes to thrift peers as compact batches
+  bool enableCompactTtlFlood{false};
+  // Knob to split initial full-sync on cold start across peers by key range
+  bool enablePartitionedInitialSync{false};
+  // Knob to receive full-sync responses from thrift peers as chunked stream
+  bool enableStreamingFullSync{false};
+  // Knob to keep change-log and incrementally resync with reconnecting peers
+  bool enableIncrementalSync{false};
+  // Path prefix of per-area snapshot files for warm start, if enabled
+  std::optional<std::string> snapshotPath;
+  // Codec of compressed values, nullptr if value compression is disabled
+  std::shared_ptr<const KvStoreValueCodec> valueCodec{nullptr};
 
   KvStoreParams(
       std::string nodeId,
@@ -174,7 +186,8 @@ class KvStoreDb : public DualNode {
       fbzmq::Socket<ZMQ_ROUTER, fbzmq::ZMQ_CLIENT> peersyncSock,
       bool isFloodRoot,
       const std::string& nodeId,
-      std::function<void()> initialKvStoreSyncedCallback);
+      std::function<void()> initialKvStoreSyncedCallback,
+      std::function<void(size_t)> snapshotLoadedCallback = nullptr);
 
   ~KvStoreDb() override = default;
 
@@ -196,11 +209,24 @@ class KvStoreDb : public DualNode {
     return thriftPeers_.size();
   }
 
+  // Generation of keys and peers, changes whenever a key-value is updated or
+  // expired, or a peer is added, removed or changes state. Thread safe.
+  inline int64_t
+  getGeneration() const {
+    return generation_.load();
+  }
+
   inline bool
   getInitialSyncedWithPeers() const {
     return initialSyncCompleted_;
   }
 
+  // event-base this KvStoreDb instance runs on
+  inline OpenrEventBase*
+  getEvb() const {
+    return evb_;
+  }
+
   // get all active (ttl-refreshable) self-originated key-vals
   SelfOriginatedKeyVals const&
   getSelfOriginatedKeyVals() const {
@@ -214,8 +240,19 @@ class KvStoreDb : public DualNode {
   // Extracts the counters
   std::map<std::string, int64_t> getCounters() const;
 
-  // Calculate size of KvStoreDB (just the key/val pairs)
-  size_t getKeyValsSize() const;
+  // set flood rate of thrift peers, e.g. on config reload. Rate limiters of
+  // peers are reset, key-vals held back by the removed ones are flooded.
+  void setFloodRate(std::optional<thrift::KvstoreFloodRate> floodRate);
+
+  // Size of KvStoreDB (just the key/val pairs). Maintained incrementally,
+  // along with its breakdown by originatorId and key prefix.
+  size_t
+  getKeyValsSize() const {
+    return keyValsSize_.bytes;
+  }
+
+  std::map<std::string, thrift::KvStoreSizeStats> getOriginatorSizes() const;
+  std::map<std::string, thrift::KvStoreSizeStats> getKeyPrefixSizes() const;
 
   // get multiple keys at once
   thrift::Publication getKeyVals(std::vector<std::string> const& keys);
@@ -223,16 +260,63 @@ class KvStoreDb : public DualNode {
   // add new key-vals to kvstore_'s key-vals
   void setKeyVals(thrift::KeySetParams&& setParams);
 
+  // refresh TTL of keys from compact TTL-only updates sent by peers. Updates
+  // not matching version and hash of the local value are ignored.
+  void setTtlUpdates(thrift::KvStoreTtlUpdates&& ttlUpdates);
+
   // dump the entries of my KV store whose keys match the filter
+  // if merkleBuckets is set, ONLY keys in those buckets are dumped
   thrift::Publication dumpAllWithFilters(
       KvStoreFilters const& kvFilters,
       thrift::FilterOperator oper = thrift::FilterOperator::OR,
-      bool doNotPublishValue = false) const;
+      bool doNotPublishValue = false,
+      std::optional<std::unordered_set<int32_t>> const& merkleBuckets =
+          std::nullopt) const;
 
   // dump the hashes of my KV store whose keys match the given prefix
   // if prefix is the empty sting, the full hash store is dumped
+  // if merkleBuckets is set, ONLY keys in those buckets are dumped
   thrift::Publication dumpHashWithFilters(
-      KvStoreFilters const& kvFilters) const;
+      KvStoreFilters const& kvFilters,
+      std::optional<std::unordered_set<int32_t>> const& merkleBuckets =
+          std::nullopt) const;
+
+  // invoke `visitor` on every key-val that can possibly match the filters.
+  // Keys are range scanned from key index if filters consist of literal key
+  // prefixes and looked up from originator index if filters match on
+  // originatorIds, hence cost is proportional to the result. Whole kvStore_
+  // is scanned only if filters can't be answered by indexes. Caller is still
+  // responsible to match the key-vals against filters.
+  void forEachFilterCandidate(
+      KvStoreFilters const& kvFilters,
+      bool matchAll,
+      std::function<void(std::string const&, thrift::Value const&)> const&
+          visitor) const;
+
+  // get merkle tree digests of my KV store
+  thrift::KvStoreMerkleDigests
+  getMerkleDigests() const {
+    return merkleTree_.toThrift();
+  }
+
+  // stream the entries of my KV store matching dump params in chunks of
+  // bounded size. Chunks are produced in key order on separate event loop
+  // iterations, hence other events of KvStoreDb are served in between.
+  void streamKeyValsWithFilters(
+      thrift::KeyDumpParams keyDumpParams,
+      std::function<void(thrift::Publication&&)> onChunk,
+      std::function<void(folly::exception_wrapper)> onComplete);
+
+  // dump the entries of my KV store matching the filter, which changed after
+  // the given position of my change-log. Response is stamped with current
+  // change-log position ONLY if change-log still covers the position.
+  thrift::Publication dumpChangesSince(
+      thrift::KvStoreChangeLogPosition const& position,
+      KvStoreFilters const& kvFilters,
+      thrift::FilterOperator oper = thrift::FilterOperator::OR) const;
+
+  // current position of my change-log, std::nullopt if not maintained
+  std::optional<thrift::KvStoreChangeLogPosition> getChangeLogPosition() const;
 
   // dump the keys on which hashes differ from given keyVals
   thrift::Publication dumpDifference(
@@ -247,6 +331,13 @@ class KvStoreDb : public DualNode {
       thrift::Publication const& rcvdPublication,
       std::optional<std::string> senderId = std::nullopt);
 
+  // [Warm Start]
+  // write key-vals to snapshot file of the area / seed from it. TTLs are
+  // adjusted for the time elapsed since snapshot.
+  // @return: false on failure / number of key-vals seeded
+  bool saveSnapshot();
+  size_t loadSnapshot();
+
   // update Time to expire filed in Publication
   // removeAboutToExpire: knob to remove keys which are about to expire
   // and hence do not want to include them. Constants::kTtlThreshold
@@ -285,6 +376,13 @@ class KvStoreDb : public DualNode {
   // get current snapshot of SPT(s) information
   thrift::SptInfos processFloodTopoGet() noexcept;
 
+  // queue dual messages received from a peer. Messages queued within one
+  // event loop iteration are processed as a batch at its end, so that
+  // resulting messages to each peer go out coalesced. Promise is fulfilled
+  // once processed.
+  void addPendingDualMessages(
+      thrift::DualMessages&& messages, folly::Promise<folly::Unit>&& p);
+
   /*
    * [KvStore Peer State]
    *
@@ -319,11 +417,12 @@ class KvStoreDb : public DualNode {
    * [Self Originated Key Management]
    *
    * Public API used for self-originated key management including:
-   *    1) persistSelfOriginatedKey
+   *    1) persistSelfOriginatedKey(s)
    *      Set specified key-value in KvStore. This is an authoratitive call,
    *      meaning if someone else advertises the same key we try to win over
    *      it by setting key-value with higher version. By default key is
-   *      published to default area.
+   *      published to default area. Keys persisted in a batch are advertised
+   *      and TTL refreshed together.
    *    2) setSelfOriginatedKey
    *      Set key-value in KvStore with specified version. If version is 0,
    *      the one greater than the latest known will be used.
@@ -336,6 +435,8 @@ class KvStoreDb : public DualNode {
    */
   void persistSelfOriginatedKey(
       std::string const& key, std::string const& value);
+  void persistSelfOriginatedKeys(
+      std::vector<std::pair<std::string, std::string>> const& keyVals);
   void setSelfOriginatedKey(
       std::string const& key, std::string const& value, uint32_t version);
   void unsetSelfOriginatedKey(std::string const& key, std::string const& value);
@@ -365,6 +466,106 @@ class KvStoreDb : public DualNode {
    */
   void requestThriftPeerSync();
 
+  /*
+   * [Initial Sync]
+   *
+   * util method to exchange merkle digests with peer before full-sync.
+   * Based on the diverged buckets:
+   *    1) skip full-sync if both stores are in sync;
+   *    2) send full-sync request with key-hashes in diverged buckets ONLY;
+   *    3) fall back to legacy full-sync if peer doesn't support merkle sync;
+   */
+  void requestThriftPeerMerkleSync(
+      std::string const& peerName, thrift::KeyDumpParams&& params);
+
+  /*
+   * [Initial Sync]
+   *
+   * util method to request full-sync from peer, by exchanging merkle digests
+   * first if enabled, or sending all key-hashes otherwise
+   */
+  void requestThriftPeerFullSync(
+      std::string const& peerName, thrift::KeyDumpParams&& params);
+
+  /*
+   * [Initial Sync]
+   *
+   * util method to request ONLY keys changed since the last sync from a
+   * reconnecting peer. Falls back to full-sync if change-log of peer no
+   * longer covers the last sync.
+   */
+  void requestThriftPeerIncrementalSync(
+      std::string const& peerName, thrift::KeyDumpParams&& params);
+
+  // append key with value update to change-log
+  void recordChangeLog(std::string const& key);
+
+  // drop key from originator index of given originatorId
+  void removeFromOriginatorIndex(
+      std::string const& originatorId, std::string const& key);
+
+  // bytes accounted for key-val in getKeyValsSize()
+  static int64_t getKeyValSize(
+      std::string const& key, thrift::Value const& value);
+
+  // add (sign 1) or remove (sign -1) key-val of `bytes` to/from size
+  // accounting
+  void updateKeyValsSize(
+      std::string const& key,
+      std::string const& originatorId,
+      int64_t bytes,
+      int sign);
+
+  /*
+   * [Initial Sync]
+   *
+   * util method to split the keyspace by merkle bucket into contiguous ranges,
+   * one per peer, and request them from peers in parallel. Used on cold start,
+   * where a complete dump from every peer only carries the same keys N times.
+   */
+  void requestPartitionedThriftPeerSync(
+      std::vector<std::pair<std::string, thrift::KeyDumpParams>>&& peers);
+
+  /*
+   * [Initial Sync]
+   *
+   * util method to hand key range of a peer which failed or got reset in the
+   * middle of partitioned sync over to another peer
+   */
+  void reassignSyncBuckets(std::string const& peerName);
+
+  /*
+   * [Initial Sync]
+   *
+   * util method to fetch key-vals of given merkle buckets from an already
+   * syncing/initialized peer, without driving its state machine
+   */
+  void requestThriftPeerBucketSync(
+      std::string const& peerName, std::vector<int32_t> const& buckets);
+
+  /*
+   * [Initial Sync]
+   *
+   * util method to send full-sync request over thrift and attach callbacks
+   */
+  void sendThriftPeerSyncRequest(
+      std::string const& peerName,
+      thrift::KeyDumpParams&& params,
+      bool allowStreaming = true);
+
+  /*
+   * [Initial Sync]
+   *
+   * util method to send full-sync request over thrift and merge response
+   * chunks as they are streamed from peer
+   */
+  void sendThriftPeerStreamSyncRequest(
+      std::string const& peerName, thrift::KeyDumpParams&& params);
+
+  // state of a streaming full-sync response being produced
+  struct StreamSyncState;
+  void sendNextStreamSyncChunk(std::shared_ptr<StreamSyncState> state);
+
   /*
    * [Initial Sync]
    *
@@ -400,13 +601,18 @@ class KvStoreDb : public DualNode {
    * util method to flood publication to neighbors
    *
    * @param: publication => data element to flood
-   * @param: rateLimit => if 'false', publication will not be rate limited
    * @param: setFloodRoot => if 'false', floodRootId will not be set
    */
   void floodPublication(
-      thrift::Publication&& publication,
-      bool rateLimit = true,
-      bool setFloodRoot = true);
+      thrift::Publication&& publication, bool setFloodRoot = true);
+
+  /*
+   * [Incremental flooding]
+   *
+   * util method to send key-vals to a single INITIALIZED thrift peer
+   */
+  void floodKeyValsToPeer(
+      std::string const& peerName, thrift::KeySetParams const& params);
 
   /*
    * [Incremental flooding]
@@ -416,13 +622,23 @@ class KvStoreDb : public DualNode {
    *    std::nullopt: flood to all physical peers
    *    not std::nullopt: only flood to formed SPT-peers for rootId
    */
-  std::unordered_set<std::string> getFloodPeers(
+  std::unordered_set<std::string> const& getFloodPeers(
       const std::optional<std::string>& rootId);
 
+  /*
+   * [Incremental flooding]
+   *
+   * drop memoized flooding peers. MUST be called whenever SPT state or
+   * peers change, i.e. on dual events, child set/unset and peer add/del.
+   */
+  void invalidateFloodPeers() noexcept;
+
   /*
    * [Incremental flooding]
    *
    * fiber task and util function to periodically dump flooding topology.
+   * With incremental flood topology, only changes since the last dump are
+   * logged.
    *
    * Signaling part consists of:
    *  - Promise retained in state variable of KvStoreDb. Fiber awaits on it.
@@ -435,11 +651,24 @@ class KvStoreDb : public DualNode {
   /*
    * [Incremental flooding]
    *
-   * buffer publications blocked by the rate limiter
-   * flood pending update blocked by rate limiter
+   * buffer key-vals blocked by the flood window or rate limiter of the peer
+   * flood pending updates of all peers whose window and rate limiter allow
+   * flood pending updates of a single peer, token MUST be consumed by caller
    */
-  void bufferPublication(thrift::Publication&& publication);
+  void bufferPublication(
+      std::string const& peerName,
+      std::optional<std::string> const& floodRootId,
+      thrift::KeyVals const& keyVals);
   void floodBufferedUpdates();
+  void floodBufferedUpdates(std::string const& peerName);
+
+  /*
+   * [Incremental flooding]
+   *
+   * flood TTL refreshes coalesced per peer since the last flush as compact
+   * TTL-only updates, carrying the latest TTL of each key
+   */
+  void floodPendingTtlUpdates();
 
   /*
    * [Dual]
@@ -504,18 +733,25 @@ class KvStoreDb : public DualNode {
   /*
    * [Ttl Management]
    *
-   * add new query entries into ttlCountdownQueue from publication
-   * and reschedule ttl expiry timer if needed
+   * schedule (or reschedule in place) keys of publication in TTL countdown
+   * wheel and reschedule ttl expiry timer if needed
    */
   void updateTtlCountdownQueue(const thrift::Publication& publication);
 
   /*
    * [Ttl Management]
    *
-   * periodically count down and purge expired keys from CountdownQueue
+   * periodically count down and purge expired keys from countdown wheel
    */
   void cleanupTtlCountdownQueue();
 
+  /*
+   * [Ttl Management]
+   *
+   * schedule ttl expiry timer to the next wakeup time of countdown wheel
+   */
+  void scheduleTtlCountdownTimer();
+
   // [TO BE DEPRECATED]
   // collect router-client send failure statistics in following form
   // "kvstore.send_failure.dst-peer-id.error-code"
@@ -567,9 +803,22 @@ class KvStoreDb : public DualNode {
    *    2) key ttl-refreshing
    * update ttls for all self-originated key-vals
    * schedule ttl updates for self-originated key-vals
+   *
+   * Self-originated key-vals share TTL, hence ttl updates are due every
+   * ttl/4 for all of them. Keys are grouped into cohorts by the time of their
+   * next ttl update, rounded up to a fraction of ttl, and each cohort is
+   * refreshed and flooded at once.
    */
   void advertiseTtlUpdates();
   void scheduleTtlUpdates(std::string const& key, bool advertiseImmediately);
+  void addToTtlRefreshCohort(
+      std::string const& key, std::chrono::steady_clock::time_point time);
+  void removeFromTtlRefreshCohort(std::string const& key);
+
+  // Cache key-val to persist. Return true if its TTL refresh has to be
+  // scheduled, i.e. key-val changed.
+  bool persistSelfOriginatedKeyVal(
+      std::string const& key, std::string const& value);
 
   /*
    * [Self Originated Key Management with Throttling]
@@ -626,6 +875,13 @@ class KvStoreDb : public DualNode {
     // thrift client for this peer
     std::unique_ptr<thrift::OpenrCtrlCppAsyncClient> client{nullptr};
 
+    // Id of the thrift client, unique across peers and reconnections, hence
+    // completions of RPCs sent over a previous client are told apart
+    uint64_t clientId{0};
+
+    // Flooding RPCs sent over the current client and not completed yet
+    size_t numFloodsInFlight{0};
+
     // timer to periodically send keep-alive status
     // ATTN: this mechanism serves the purpose of avoiding channel being
     //       closed from thrift server due to IDLE timeout(i.e. 60s by default)
@@ -636,13 +892,55 @@ class KvStoreDb : public DualNode {
     // sync.
     std::unordered_set<std::string> pendingKeysDuringInitialization;
 
+    // Stores set of keys with TTL refreshed since the last flush of compact
+    // TTL updates to this peer. ONLY used with compact TTL flooding enabled.
+    std::unordered_set<std::string> pendingTtlUpdates;
+
+    // Flood rate limiter of this peer. ONLY created with flood rate configured,
+    // hence a slow or backlogged peer doesn't delay flooding to other peers.
+    std::unique_ptr<folly::BasicTokenBucket<>> floodLimiter{nullptr};
+
+    // Keys blocked by the flood window or rate limiter of this peer,
+    // map<flood-root-id: keys>.
+    // Values are looked up on flush, hence superseded versions of a key
+    // are coalesced into the latest one.
+    std::unordered_map<
+        std::optional<std::string>,
+        std::unordered_set<std::string>>
+        floodBuffer;
+
     // Number of occured Thrift API errors in the process of syncing with peer.
     int64_t numThriftApiErrors{0};
+
+    // Merkle buckets requested from this peer in partitioned initial sync.
+    // Empty if syncing complete keyspace with this peer.
+    std::vector<int32_t> syncBuckets;
+
+    // Id of the latest streaming full-sync with this peer. Chunks of earlier
+    // streams (i.e. peer reset mid-transfer) are ignored.
+    uint64_t syncStreamId{0};
+
+    // Position of change-log of this peer the ongoing sync is up to date
+    // with, if not carried by the sync response itself
+    std::optional<thrift::KvStoreChangeLogPosition> syncChangeLogPosition;
   };
 
   // Set of peers with all info over thrift channel
   std::unordered_map<std::string, KvStorePeer> thriftPeers_{};
 
+  /*
+   * [Flood window]
+   *
+   * check whether flooding RPCs in flight to the peer reached the window
+   * check whether flooding to the peer is allowed now, consuming a token of
+   * its rate limiter if so
+   * account completion of a flooding RPC sent over client `clientId` and
+   * flood updates buffered meanwhile
+   */
+  bool isFloodWindowFull(KvStorePeer const& thriftPeer) const;
+  bool canFloodToPeer(KvStorePeer& thriftPeer);
+  void processFloodCompletion(std::string const& peerName, uint64_t clientId);
+
   // [TO BE DEPRECATED]
   // The peers we will be talking to: both PUB and CMD URLs for each. We use
   // peerAddCounter_ to uniquely identify a peering session's socket-id.
@@ -669,17 +967,81 @@ class KvStoreDb : public DualNode {
 
   // Boolean flag indicating whether initial KvStoreDb sync with all peers
   // completed in OpenR initialization procedure.
-  bool initialSyncCompleted_{false};
+  // ATTN: atomic as it is read by KvStore across per-area threads
+  std::atomic<bool> initialSyncCompleted_{false};
 
   // store keys mapped to (version, originatoId, value)
-  std::unordered_map<std::string, thrift::Value> kvStore_;
+  KvStoreMap kvStore_;
+
+  // merkle tree over (key, hash) of kvStore_ for anti-entropy full-sync
+  KvStoreMerkleTree merkleTree_{Constants::kKvStoreMerkleNumBuckets};
+
+  // interned keys and originatorIds referred by key index and TTL count down
+  // wheel.
+  // ATTN: MUST be declared before `keyIndex_` and `ttlCountdownWheel_` to
+  // outlive their entries
+  KvStoreStringPool stringPool_;
+
+  // sorted index of keys in kvStore_. Allows filters of literal key prefixes
+  // to be answered with range scans instead of a full scan.
+  std::set<KvStoreStringPool::Handle, KvStoreStringPool::HandleLess> keyIndex_;
+
+  // Number of keys and bytes of key-vals in kvStore_, in total and by
+  // originatorId and key prefix. Updated along with kvStore_.
+  struct KeyValsSize {
+    int64_t numKeys{0};
+    int64_t bytes{0};
+  };
+  KeyValsSize keyValsSize_;
+  std::unordered_map<std::string /* originatorId */, KeyValsSize>
+      originatorSizes_;
+  std::unordered_map<std::string /* key prefix */, KeyValsSize>
+      keyPrefixSizes_;
+
+  // index of keys in kvStore_ by originatorId of their value. Allows filters
+  // of originatorIds, e.g. dump of a node's keys, to skip unrelated keys.
+  std::unordered_map<
+      std::string /* originatorId */,
+      std::set<KvStoreStringPool::Handle, KvStoreStringPool::HandleLess>>
+      originatorIndex_;
 
-  // TTL count down queue
-  TtlCountdownQueue ttlCountdownQueue_;
+  // TTL count down wheel, holding single entry per key with finite TTL
+  KvStoreTtlWheel ttlCountdownWheel_{
+      Constants::kKvStoreTtlWheelTick,
+      Constants::kKvStoreTtlWheelSlotsPerLevel,
+      Constants::kKvStoreTtlWheelNumLevels};
 
   // TTL count down timer
   std::unique_ptr<folly::AsyncTimeout> ttlCountdownTimer_;
 
+  // timer to periodically write snapshot for warm start
+  std::unique_ptr<folly::AsyncTimeout> snapshotTimer_;
+
+  // Bounded log of <sequence number, key> of the latest value updates,
+  // ordered by sequence number. ONLY maintained with incremental sync.
+  std::deque<std::pair<int64_t, KvStoreStringPool::Handle>> changeLog_;
+
+  // sequence number of the latest value update
+  int64_t changeLogSeq_{0};
+
+  // random id telling apart change-logs across restarts
+  const int64_t changeLogInstanceId_{0};
+
+  // see getGeneration()
+  std::atomic<int64_t> generation_{0};
+
+  // position of change-log of each peer we've synced with. Kept across peer
+  // removal to resync incrementally when peer comes back after a flap.
+  std::unordered_map<std::string, thrift::KvStoreChangeLogPosition>
+      peerChangeLogPositions_;
+
+  // memoized flooding peers per flood-root-id (std::nullopt for naive
+  // flooding). Invalidated on any change of SPT state or peers.
+  std::unordered_map<
+      std::optional<std::string>,
+      std::unordered_set<std::string>>
+      floodPeersCache_;
+
   // [TO BE DEPRECATED]
   // Map of latest peer sync up request send to each peer
   // this is used to measure full-dump sync time between this node and each of
@@ -689,12 +1051,16 @@ class KvStoreDb : public DualNode {
       std::chrono::time_point<std::chrono::steady_clock>>
       latestSentPeerSync_;
 
-  // Kvstore rate limiter
-  std::unique_ptr<folly::BasicTokenBucket<>> floodLimiter_{nullptr};
+  // flood rate of thrift peers, rate limited if set. Initially the one of
+  // `kvParams_`, changes on config reload.
+  std::optional<thrift::KvstoreFloodRate> floodRate_;
 
-  // timer to send pending kvstore publication
+  // timer to send key-vals buffered by per-peer rate limiters
   std::unique_ptr<folly::AsyncTimeout> pendingPublicationTimer_{nullptr};
 
+  // timer to flush coalesced TTL updates to peers
+  std::unique_ptr<folly::AsyncTimeout> ttlFloodTimer_{nullptr};
+
   // timer for requesting full-sync
   std::unique_ptr<folly::AsyncTimeout> requestSyncTimer_{nullptr};
 
@@ -712,6 +1078,12 @@ class KvStoreDb : public DualNode {
   std::unordered_map<std::string /* key */, SelfOriginatedValue>
       selfOriginatedKeyVals_;
 
+  // self-originated keys by time of their next ttl update
+  std::map<
+      std::chrono::steady_clock::time_point,
+      std::unordered_set<std::string /* key */>>
+      ttlRefreshCohorts_;
+
   // Map of keys to unset to new values to set. Used for batch processing of
   // unset ClearKeyValueRequests.
   std::unordered_map<std::string /* key */, thrift::Value> keysToUnset_;
@@ -731,16 +1103,14 @@ class KvStoreDb : public DualNode {
   // Calls `unsetPendingSelfOriginatedKeys()`.
   std::unique_ptr<AsyncThrottle> unsetSelfOriginatedKeysThrottled_;
 
-  // pending keys to flood publication
-  // map<flood-root-id: set<keys>>
-  std::
-      unordered_map<std::optional<std::string>, std::unordered_set<std::string>>
-          publicationBuffer_{};
-
   // Callback function to signal KvStore that KvStoreDb sync with all peers are
   // completed.
   std::function<void()> initialKvStoreSyncedCallback_;
 
+  // Callback function to signal KvStore that snapshot of the area is loaded
+  // with number of key-vals seeded.
+  std::function<void(size_t)> snapshotLoadedCallback_;
+
   // [TO BE DEPRECATED]
   // max parallel syncs allowed. It's initialized with '2' and doubles
   // up to a max value of kMaxFullSyncPendingCountThresholdfor each full sync
@@ -750,9 +1120,22 @@ class KvStoreDb : public DualNode {
   // max parallel syncs allowed
   size_t parallelSyncLimitOverThrift_{2};
 
+  // number of in-flight requests fetching key range of a failed peer in
+  // partitioned initial sync
+  size_t numPendingBucketSyncs_{0};
+
   // Stop signal for fiber to periodically dump flood topology
   folly::fibers::Baton floodTopoStopSignal_;
 
+  // flood topology logged by last incremental dump, see floodTopoDump()
+  std::optional<std::string> dumpedFloodRootId_;
+  std::unordered_set<std::string> dumpedFloodPeers_;
+
+  // dual messages received in current event loop iteration along with
+  // promises to fulfill once processed, see addPendingDualMessages()
+  std::vector<thrift::DualMessages> pendingDualMessages_;
+  std::vector<folly::Promise<folly::Unit>> pendingDualPromises_;
+
   // event loop
   OpenrEventBase* evb_{nullptr};
 };
@@ -796,6 +1179,15 @@ class KvStore final : public OpenrEventBase {
    */
   void initialKvStoreDbSynced();
 
+  /*
+   * [Warm Start]
+   *
+   * Callback used by KvStoreDb once seeded from snapshot. After all areas,
+   * kvStoreWarmStarted signal is published if any key-val is seeded, so
+   * that routes are computed from seeded state ahead of sync with peers.
+   */
+  void snapshotLoaded(size_t numSeeded);
+
   /*
    * [Public APIs]
    *
@@ -810,17 +1202,33 @@ class KvStore final : public OpenrEventBase {
   folly::SemiFuture<folly::Unit> setKvStoreKeyVals(
       std::string area, thrift::KeySetParams keySetParams);
 
+  folly::SemiFuture<folly::Unit> setKvStoreTtlUpdates(
+      std::string area, thrift::KvStoreTtlUpdates ttlUpdates);
+
   folly::SemiFuture<std::unique_ptr<std::vector<thrift::Publication>>>
   dumpKvStoreKeys(
       thrift::KeyDumpParams keyDumpParams,
       std::set<std::string> selectAreas = {});
 
+  // Same as dumpKvStoreKeys() for a single area, but delivers response of
+  // full-sync request in chunks of bounded size via `onChunk`. `onComplete`
+  // is invoked once with empty exception_wrapper after the last chunk, or
+  // with the error if any.
+  void streamKvStoreKeyVals(
+      thrift::KeyDumpParams keyDumpParams,
+      std::string area,
+      std::function<void(thrift::Publication&&)> onChunk,
+      std::function<void(folly::exception_wrapper)> onComplete);
+
   folly::SemiFuture<std::unique_ptr<SelfOriginatedKeyVals>>
   dumpKvStoreSelfOriginatedKeys(std::string area);
 
   folly::SemiFuture<std::unique_ptr<thrift::Publication>> dumpKvStoreHashes(
       std::string area, thrift::KeyDumpParams keyDumpParams);
 
+  folly::SemiFuture<std::unique_ptr<thrift::KvStoreMerkleDigests>>
+  getKvStoreMerkleDigests(std::string area);
+
   /*
    * [Public APIs]
    *
@@ -857,11 +1265,25 @@ class KvStore final : public OpenrEventBase {
   folly::SemiFuture<std::unique_ptr<std::vector<thrift::KvStoreAreaSummary>>>
   getKvStoreAreaSummaryInternal(std::set<std::string> selectAreas = {});
 
+  // Changes whenever response of getKvStoreAreaSummaryInternal() may change.
+  // Thread safe.
+  int64_t getKvStoreAreaSummaryGeneration() const;
+
   folly::SemiFuture<std::map<std::string, int64_t>> getCounters();
 
+  // Apply config reloaded from file, see `ConfigUpdate`. Flood rate of peers
+  // is applied live to all areas.
+  folly::SemiFuture<folly::Unit> processConfigUpdate(ConfigUpdate update);
+
   // API to get reader for kvStoreUpdatesQueue
   messaging::RQueue<Publication> getKvStoreUpdatesReader();
 
+  // API to get codec of compressed values, nullptr if not configured
+  std::shared_ptr<const KvStoreValueCodec>
+  getValueCodec() const {
+    return kvParams_.valueCodec;
+  }
+
   // API to fetch state of peerNode, used for unit-testing
   folly::SemiFuture<std::optional<thrift::KvStorePeerState>>
   getKvStorePeerState(std::string const& area, std::string const& peerName);
@@ -919,6 +1341,29 @@ class KvStore final : public OpenrEventBase {
   KvStoreDb& getAreaDbOrThrow(
       std::string const& areaId, std::string const& caller);
 
+  /*
+   * [Per-Area Thread]
+   *
+   * Return the event-base on which KvStoreDb of given area runs. This is
+   * KvStore's own event-base unless `enable_per_area_thread` is set. Area
+   * lookup follows the same fallback as `getAreaDbOrThrow()`. KvStore's own
+   * event-base is returned for unknown area so that caller hits the error.
+   */
+  OpenrEventBase* getAreaEvb(std::string const& areaId);
+
+  /*
+   * [Per-Area Thread]
+   *
+   * Run function in the thread of given KvStoreDb and wait for completion.
+   * Function is executed inline if KvStoreDb shares KvStore's event-base.
+   */
+  template <typename F>
+  static void
+  runInAreaThreadAndWait(KvStoreDb const& kvStoreDb, F&& func) {
+    kvStoreDb.getEvb()->getEvb()->runImmediatelyOrRunInEventBaseThreadAndWait(
+        std::forward<F>(func));
+  }
+
   /*
    * Private variables
    */
@@ -929,6 +1374,13 @@ class KvStore final : public OpenrEventBase {
   // kvstore parameters common to all kvstoreDB
   KvStoreParams kvParams_;
 
+  // [Per-Area Thread]
+  // dedicated event-base and thread of every area's KvStoreDb.
+  // ATTN: MUST be declared before `kvStoreDb_` to outlive KvStoreDb instances
+  std::unordered_map<std::string /* area ID */, std::unique_ptr<OpenrEventBase>>
+      areaEvbs_{};
+  std::vector<std::thread> areaEvbThreads_{};
+
   // map of area IDs and instance of KvStoreDb
   std::unordered_map<std::string /* area ID */, KvStoreDb> kvStoreDb_{};
 
@@ -938,5 +1390,9 @@ class KvStore final : public OpenrEventBase {
   // Boolean flag to indicate if kvStoreSynced signal is published in OpenR
   // initialization process.
   bool initialSyncSignalSent_{false};
+
+  // Number of areas whose snapshot is loaded and key-vals seeded in total
+  size_t numSnapshotsLoaded_{0};
+  size_t numSnapshotKeyValsSeeded_{0};
 };
 } // namespace openr
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <openr/kvstore/KvStoreCapture.h>
+
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include <fmt/format.h>
+#include <folly/FileUtil.h>
+#include <folly/lang/Bits.h>
+#include <glog/logging.h>
+
+#include <openr/common/Util.h>
+#include <openr/kvstore/KvStoreUtil.h>
+
+namespace openr {
+
+namespace {
+
+// First bytes of zstd frame, i.e. ZSTD_MAGICNUMBER in little endian
+constexpr folly::StringPiece kZstdMagic{"\x28\xB5\x2F\xFD"};
+
+// Decompress zstd stream up to where it is complete
+std::string
+decompress(folly::StringPiece data) {
+  std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> dctx(
+      ZSTD_createDCtx(), &ZSTD_freeDCtx);
+  std::string buf(ZSTD_DStreamOutSize(), '\0');
+  std::string result;
+  ZSTD_inBuffer input{data.data(), data.size(), 0};
+  bool outputFull{false};
+  while (input.pos < input.size or outputFull) {
+    ZSTD_outBuffer output{buf.data(), buf.size(), 0};
+    const auto ret = ZSTD_decompressStream(dctx.get(), &output, &input);
+    if (ZSTD_isError(ret)) {
+      LOG(WARNING) << "Ignoring corrupted capture after " << result.size()
+                   << " bytes: " << ZSTD_getErrorName(ret);
+      break;
+    }
+    result.append(buf.data(), output.pos);
+    outputFull = output.pos == output.size;
+  }
+  return result;
+}
+
+} // namespace
+
+KvStoreCaptureWriter::KvStoreCaptureWriter(
+    std::string const& path, bool compress)
+    : file_(path, std::ios::binary | std::ios::trunc) {
+  if (not file_.good()) {
+    throw std::runtime_error(fmt::format("Failed to open {}", path));
+  }
+  if (compress) {
+    cctx_.reset(ZSTD_createCCtx());
+    compressBuf_.resize(ZSTD_CStreamOutSize());
+  }
+  append(kKvStoreCaptureMagic, ZSTD_e_flush);
+}
+
+KvStoreCaptureWriter::~KvStoreCaptureWriter() {
+  if (cctx_) {
+    try {
+      append("", ZSTD_e_end);
+    } catch (std::exception const& err) {
+      LOG(ERROR) << "Failed to end capture: " << folly::exceptionStr(err);
+    }
+  }
+}
+
+void
+KvStoreCaptureWriter::write(
+    thrift::Publication const& publication,
+    std::chrono::microseconds timestamp) {
+  const uint64_t ts =
+      folly::Endian::big(static_cast<uint64_t>(timestamp.count()));
+  std::string record(reinterpret_cast<const char*>(&ts), sizeof(ts));
+  record.append(serializePublicationRecord(publication));
+  append(record, ZSTD_e_flush);
+}
+
+void
+KvStoreCaptureWriter::append(folly::StringPiece data, ZSTD_EndDirective endOp) {
+  if (not cctx_) {
+    file_.write(data.data(), data.size());
+    file_.flush();
+    return;
+  }
+  ZSTD_inBuffer input{data.data(), data.size(), 0};
+  size_t remaining{0};
+  do {
+    ZSTD_outBuffer output{compressBuf_.data(), compressBuf_.size(), 0};
+    remaining = ZSTD_compressStream2(cctx_.get(), &output, &input, endOp);
+    if (ZSTD_isError(remaining)) {
+      throw std::runtime_error(fmt::format(
+          "Failed to compress capture: {}", ZSTD_getErrorName(remaining)));
+    }
+    file_.write(compressBuf_.data(), output.pos);
+  } while (remaining != 0);
+  file_.flush();
+}
+
+std::vector<CapturedPublication>
+parseKvStoreCapture(folly::StringPiece data) {
+  std::string decompressed;
+  if (data.startsWith(kZstdMagic)) {
+    decompressed = decompress(data);
+    data = decompressed;
+  }
+
+  std::vector<CapturedPublication> captured;
+  if (not data.startsWith(kKvStoreCaptureMagic)) {
+    // plain publication records
+    for (auto& publication : parsePublicationRecords(data)) {
+      captured.emplace_back(CapturedPublication{
+          std::chrono::microseconds(0), std::move(publication)});
+    }
+    return captured;
+  }
+
+  data.advance(kKvStoreCaptureMagic.size());
+  apache::thrift::CompactSerializer serializer;
+  while (not data.empty()) {
+    uint64_t ts{0};
+    uint32_t length{0};
+    if (data.size() < sizeof(ts) + sizeof(length)) {
+      break;
+    }
+    std::memcpy(&ts, data.data(), sizeof(ts));
+    std::memcpy(&length, data.data() + sizeof(ts), sizeof(length));
+    length = folly::Endian::big(length);
+    const auto headerSize = sizeof(ts) + sizeof(length);
+    if (data.size() - headerSize < length) {
+      break;
+    }
+    captured.emplace_back(CapturedPublication{
+        std::chrono::microseconds(folly::Endian::big(ts)),
+        readThriftObjStr<thrift::Publication>(
+            data.subpiece(headerSize, length).str(), serializer)});
+    data.advance(headerSize + length);
+  }
+  LOG_IF(WARNING, not data.empty())
+      << "Ignoring partial capture record of " << data.size()
+      << " bytes at the end of the capture";
+  return captured;
+}
+
+std::vector<CapturedPublication>
+readKvStoreCapture(std::string const& path) {
+  std::string data;
+  if (not folly::readFile(path.c_str(), data)) {
+    throw std::runtime_error(fmt::format("Failed to read {}", path));
+  }
+  return parseKvStoreCapture(data);
+}
+
+std::chrono::microseconds
+getKvStoreReplayDelay(
+    CapturedPublication const& prev,
+    CapturedPublication const& next,
+    double speedup) {
+  if (speedup <= 0 or next.timestamp <= prev.timestamp) {
+    return std::chrono::microseconds(0);
+  }
+  return std::chrono::microseconds(static_cast<int64_t>(
+      (next.timestamp - prev.timestamp).count() / speedup));
+}
+
+void
+replayKvStoreCapture(
+    std::vector<CapturedPublication> const& captured,
+    double speedup,
+    folly::Function<void(thrift::Publication const&)> publish) {
+  // pace against the start of replay, hence publishing time doesn't add up
+  auto publishTime = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < captured.size(); ++i) {
+    if (i > 0) {
+      publishTime +=
+          getKvStoreReplayDelay(captured[i - 1], captured[i], speedup);
+      std::this_thread::sleep_until(publishTime);
+    }
+    publish(captured[i].publication);
+  }
+}
+
+} // namespace openr
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <folly/Function.h>
+#include <folly/Range.h>
+#include <zstd.h>
+
+#include <openr/if/gen-cpp2/Types_types.h>
+
+namespace openr {
+
+/*
+ * Capture of KvStore publications as received, e.g. recorded from a
+ * production node by KvStoreSnooper, for replaying its churn offline into
+ * KvStoreWrapper, Decision or benchmarks.
+ *
+ * Capture starts with magic `kKvStoreCaptureMagic`, followed by a record per
+ * publication: receive time as 8 bytes microseconds since epoch, in network
+ * byte order, followed by publication record of serializePublicationRecord().
+ * Optionally the whole capture is a zstd stream, flushed after every record,
+ * hence capture of killed snooper can be read up to its last record.
+ *
+ * Streams without magic, i.e. plain publication records, are read as
+ * captured all at time zero.
+ */
+constexpr folly::StringPiece kKvStoreCaptureMagic{"ORKVCAP1"};
+
+struct CapturedPublication {
+  // receive time since epoch
+  std::chrono::microseconds timestamp{0};
+  thrift::Publication publication;
+};
+
+/*
+ * Append-only writer of capture file. Every record is flushed to the file
+ * once written.
+ */
+class KvStoreCaptureWriter {
+ public:
+  // Throws std::runtime_error if file can't be opened
+  KvStoreCaptureWriter(std::string const& path, bool compress);
+
+  // Ends zstd stream if compressed
+  ~KvStoreCaptureWriter();
+
+  // Throws std::runtime_error on compression failure
+  void write(
+      thrift::Publication const& publication,
+      std::chrono::microseconds timestamp =
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              std::chrono::system_clock::now().time_since_epoch()));
+
+ private:
+  struct CCtxDeleter {
+    void
+    operator()(ZSTD_CCtx* cctx) const {
+      ZSTD_freeCCtx(cctx);
+    }
+  };
+
+  // Write `data` through compression if any and flush the file
+  void append(folly::StringPiece data, ZSTD_EndDirective endOp);
+
+  std::ofstream file_;
+  // compression context, nullptr if not compressed
+  std::unique_ptr<ZSTD_CCtx, CCtxDeleter> cctx_;
+  std::string compressBuf_;
+};
+
+/*
+ * Parse capture, decompressing it if needed. Partially written record at the
+ * end, e.g. when snooper got killed, is ignored.
+ */
+std::vector<CapturedPublication> parseKvStoreCapture(folly::StringPiece data);
+
+// Read and parse capture file. Throws std::runtime_error if it can't be read.
+std::vector<CapturedPublication> readKvStoreCapture(std::string const& path);
+
+/*
+ * Delay between replaying captured publications `prev` and `next`, keeping
+ * their original spacing divided by `speedup`. Zero if `speedup` is zero,
+ * i.e. replay is back to back.
+ */
+std::chrono::microseconds getKvStoreReplayDelay(
+    CapturedPublication const& prev,
+    CapturedPublication const& next,
+    double speedup);
+
+/*
+ * Replay captured publications in order through `publish`, e.g. setting
+ * their key-vals into KvStoreWrapper or pushing them to Decision, paced as
+ * per getKvStoreReplayDelay(). Blocks until all are published.
+ */
+void replayKvStoreCapture(
+    std::vector<CapturedPublication> const& captured,
+    double speedup,
+    folly::Function<void(thrift::Publication const&)> publish);
+
+} // namespace openr
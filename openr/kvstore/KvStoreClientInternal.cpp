@@ -30,6 +30,7 @@ KvStoreClientInternal::KvStoreClientInternal(
   CHECK_NE(eventBase_, static_cast<void*>(nullptr));
   CHECK(not nodeId.empty());
   CHECK(kvStore_);
+  valueCodec_ = kvStore_->getValueCodec();
 
   if (createKvStoreUpdatesReader) {
     // Fiber to process thrift::Publication from KvStore
@@ -44,9 +45,11 @@ KvStoreClientInternal::KvStoreClientInternal(
               break;
             }
             // Publication.kvStoreSynced is published dedicatedly in OpenR
-            // initialization procedure without any thrift::Publication.
-            if (not maybePub.value().kvStoreSynced) {
-              processPublication(maybePub.value().tPublication);
+            // initialization procedure without any thrift::Publication. So is
+            // Publication.kvStoreWarmStarted on warm start.
+            if (not maybePub.value().kvStoreSynced and
+                not maybePub.value().kvStoreWarmStarted) {
+              processPublication(*maybePub.value().tPublication);
             }
           }
         });
@@ -193,6 +196,10 @@ KvStoreClientInternal::checkPersistKeyInStore() {
       continue;
     }
 
+    if (valueCodec_) {
+      valueCodec_->decompressKeyVals(*pub.keyVals_ref());
+    }
+
     // Find expired keys from latest KvStore
     std::unordered_map<std::string, thrift::Value> keyVals;
     for (auto const& [key, _] : persistedKeyVals) {
@@ -563,6 +570,9 @@ KvStoreClientInternal::getKey(AreaId const& area, std::string const& key) {
     VLOG(2) << "Key: " << key << " NOT found in kvstore. Area: " << area.t;
     return std::nullopt;
   }
+  if (valueCodec_) {
+    valueCodec_->decompressValue(it->second);
+  }
   return it->second;
 }
 
@@ -583,6 +593,9 @@ KvStoreClientInternal::dumpAllWithPrefix(
     LOG(ERROR) << "Failed to add peers to kvstore. Exception: " << ex.what();
     return std::nullopt;
   }
+  if (valueCodec_) {
+    valueCodec_->decompressKeyVals(*pub.keyVals_ref());
+  }
   return *pub.keyVals_ref();
 }
 
@@ -620,6 +633,84 @@ KvStoreClientInternal::unsubscribeKeyFilter() {
   return;
 }
 
+void
+KvStoreClientInternal::subscribeKeyPrefix(
+    AreaId const& area,
+    std::string const& keyPrefix,
+    KeyPrefixCallback callback) {
+  CHECK(eventBase_->getEvb()->isInEventBaseThread());
+  CHECK(bool(callback)) << "Callback function for " << keyPrefix
+                        << " is empty";
+
+  VLOG(3) << "KvStoreClientInternal: subscribeKeyPrefix called for prefix "
+          << keyPrefix;
+  auto* node = &keyPrefixCallbacks_[area];
+  for (auto const c : keyPrefix) {
+    auto& child = node->children[c];
+    if (not child) {
+      child = std::make_unique<KeyPrefixNode>();
+    }
+    node = child.get();
+  }
+  node->callback = std::move(callback);
+}
+
+void
+KvStoreClientInternal::unsubscribeKeyPrefix(
+    AreaId const& area, std::string const& keyPrefix) {
+  CHECK(eventBase_->getEvb()->isInEventBaseThread());
+
+  VLOG(3) << "KvStoreClientInternal: unsubscribeKeyPrefix called for prefix "
+          << keyPrefix;
+  // path of nodes from root to the one of prefix
+  std::vector<KeyPrefixNode*> path{&keyPrefixCallbacks_[area]};
+  for (auto const c : keyPrefix) {
+    auto it = path.back()->children.find(c);
+    if (it == path.back()->children.end()) {
+      break;
+    }
+    path.emplace_back(it->second.get());
+  }
+  if (path.size() != keyPrefix.size() + 1 or not path.back()->callback) {
+    LOG(WARNING) << "UnsubscribeKeyPrefix called for non-existing prefix "
+                 << keyPrefix;
+    return;
+  }
+  path.back()->callback = nullptr;
+
+  // prune nodes left without any subscription below them
+  for (size_t i = keyPrefix.size(); i > 0; --i) {
+    auto* node = path.at(i);
+    if (node->callback or not node->children.empty()) {
+      break;
+    }
+    path.at(i - 1)->children.erase(keyPrefix.at(i - 1));
+  }
+}
+
+void
+KvStoreClientInternal::addKeyPrefixMatches(
+    AreaId const& area,
+    std::string const& key,
+    std::optional<thrift::Value> const& value,
+    std::unordered_map<std::string, KeyValUpdates>& batches) {
+  auto rootIt = keyPrefixCallbacks_.find(area);
+  if (rootIt == keyPrefixCallbacks_.end()) {
+    return;
+  }
+  KeyPrefixNode const* node = &rootIt->second;
+  for (size_t i = 0; node; ++i) {
+    if (node->callback) {
+      batches[key.substr(0, i)].emplace(key, value);
+    }
+    if (i == key.size()) {
+      break;
+    }
+    auto it = node->children.find(key[i]);
+    node = it == node->children.end() ? nullptr : it->second.get();
+  }
+}
+
 void
 KvStoreClientInternal::unsubscribeKey(
     AreaId const& area, std::string const& key) {
@@ -660,6 +751,10 @@ KvStoreClientInternal::processPublication(
   auto& keysToAdvertise = keysToAdvertise_[area];
   auto& callbacks = keyCallbacks_[area];
 
+  // key-vals matching subscribed prefixes, delivered per publication
+  std::unordered_map<std::string /* key prefix */, KeyValUpdates>
+      prefixBatches;
+
   for (auto const& [key, rcvdValue] : *publication.keyVals_ref()) {
     if (not rcvdValue.value_ref().has_value()) {
       // ignore TTL update
@@ -713,6 +808,7 @@ KvStoreClientInternal::processPublication(
           keyPrefixFilter_.keyMatch(key, rcvdValue)) {
         keyPrefixFilterCallback_(key, rcvdValue);
       }
+      addKeyPrefixMatches(area, key, rcvdValue, prefixBatches);
       // Skip rest of the processing. We are not interested.
       continue;
     }
@@ -779,6 +875,24 @@ KvStoreClientInternal::processPublication(
 
   if (publication.expiredKeys_ref()->size()) {
     processExpiredKeys(publication);
+    for (auto const& key : *publication.expiredKeys_ref()) {
+      addKeyPrefixMatches(area, key, std::nullopt, prefixBatches);
+    }
+  }
+
+  // ATTN: look callback up again as previous callback may unsubscribe
+  for (auto const& [keyPrefix, keyVals] : prefixBatches) {
+    KeyPrefixNode* node = &keyPrefixCallbacks_[area];
+    for (auto const c : keyPrefix) {
+      auto it = node->children.find(c);
+      node = it == node->children.end() ? nullptr : it->second.get();
+      if (not node) {
+        break;
+      }
+    }
+    if (node and node->callback) {
+      node->callback(keyVals);
+    }
   }
 }
 
@@ -922,6 +1036,13 @@ KvStoreClientInternal::setKeysHelper(
         thriftValue);
   }
 
+  // Compress values right before sending, local state holds plain values
+  if (valueCodec_) {
+    for (auto& [key, thriftValue] : keyVals) {
+      valueCodec_->compressValue(key, thriftValue);
+    }
+  }
+
   thrift::KeySetParams params;
   *params.keyVals_ref() = std::move(keyVals);
 
@@ -38,12 +38,21 @@ using namespace std::chrono_literals;
  * `setKey`, `getKey` operations. With `subscribeKey` you can write your
  * logic in asynchronous fashion.
  *
+ * If value compression is configured for KvStore, values are compressed on
+ * set and decompressed on get, i.e. users ALWAYS deal with plain values.
  */
 class KvStoreClientInternal {
  public:
   using KeyCallback = folly::Function<void(
       std::string const&, std::optional<thrift::Value>) noexcept>;
 
+  // key-vals of a publication matching subscribed key prefix. Expired keys
+  // have std::nullopt value.
+  using KeyValUpdates =
+      std::unordered_map<std::string, std::optional<thrift::Value>>;
+  using KeyPrefixCallback =
+      folly::Function<void(KeyValUpdates const&) noexcept>;
+
   /**
    * Creates and initializes all necessary sockets for communicating with
    * KvStore.
@@ -148,6 +157,18 @@ class KvStoreClientInternal {
   void subscribeKeyFilter(KvStoreFilters kvFilters, KeyCallback callback);
   void unsubscribeKeyFilter();
 
+  /**
+   * APIs to subscribe/unsubscribe to value changes of keys with given prefix
+   * in KvStore. Unlike `subscribeKey`, callback is invoked once per
+   * publication with all matching key-vals. Subscribing again to the same
+   * prefix will overwrite the existing callback.
+   */
+  void subscribeKeyPrefix(
+      AreaId const& area,
+      std::string const& keyPrefix,
+      KeyPrefixCallback callback);
+  void unsubscribeKeyPrefix(AreaId const& area, std::string const& keyPrefix);
+
   OpenrEventBase*
   getOpenrEventBase() const noexcept {
     return eventBase_;
@@ -196,6 +217,15 @@ class KvStoreClientInternal {
     return getCount(keyCallbacks_);
   }
 
+  int64_t
+  getKeyPrefixCallbackCount() {
+    int64_t count{0};
+    for (auto const& [_, root] : keyPrefixCallbacks_) {
+      count += root.getNumCallbacks();
+    }
+    return count;
+  }
+
   int64_t
   getBackoffCount() {
     return getCount(backoffs_);
@@ -214,11 +244,40 @@ class KvStoreClientInternal {
   void processPublication(thrift::Publication const& publication);
 
  private:
+  /**
+   * Trie of subscribed key prefixes. Every node represents the prefix spelled
+   * by the path from root, hence matching prefixes of a key are found by a
+   * single walk along the key.
+   */
+  struct KeyPrefixNode {
+    std::unordered_map<char, std::unique_ptr<KeyPrefixNode>> children;
+    KeyPrefixCallback callback{nullptr};
+
+    int64_t
+    getNumCallbacks() const {
+      int64_t count = callback ? 1 : 0;
+      for (auto const& [_, child] : children) {
+        count += child->getNumCallbacks();
+      }
+      return count;
+    }
+  };
+
   /**
    * Function to process received expired keys
    */
   void processExpiredKeys(thrift::Publication const& publication);
 
+  /**
+   * Add key-val to batch of every subscribed prefix of the key
+   */
+  void addKeyPrefixMatches(
+      AreaId const& area,
+      std::string const& key,
+      std::optional<thrift::Value> const& value,
+      std::unordered_map<std::string /* key prefix */, KeyValUpdates>&
+          batches);
+
   /*
    * Utility function to build thrift::Value in KvStoreClientInternal
    * This method will:
@@ -297,6 +356,9 @@ class KvStoreClientInternal {
   // Pointers to KvStore module
   KvStore* kvStore_{nullptr};
 
+  // Codec of compressed values of KvStore, nullptr if not configured
+  std::shared_ptr<const KvStoreValueCodec> valueCodec_{nullptr};
+
   // periodic timer to check existence of persist key in kv store
   std::optional<std::chrono::milliseconds> checkPersistKeyPeriod_{std::nullopt};
 
@@ -337,6 +399,9 @@ class KvStoreClientInternal {
   // callback for updates from keys filtered with provided filter
   KeyCallback keyPrefixFilterCallback_{nullptr};
 
+  // Subscribed key prefixes to their batch callback functions
+  std::unordered_map<AreaId, KeyPrefixNode> keyPrefixCallbacks_;
+
   // backoff associated with each key for re-advertisements
   std::unordered_map<
       AreaId,
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/hash/Hash.h>
+#include <glog/logging.h>
+
+#include <openr/kvstore/KvStoreMerkleTree.h>
+
+namespace openr {
+
+namespace {
+
+uint64_t
+combine(uint64_t left, uint64_t right) {
+  return folly::hash::hash_128_to_64(left, right);
+}
+
+} // namespace
+
+KvStoreMerkleTree::KvStoreMerkleTree(size_t numBuckets)
+    : numBuckets_(numBuckets), digests_(2 * numBuckets - 1, 0) {
+  CHECK_GT(numBuckets_, 0);
+  CHECK_EQ(0, numBuckets_ & (numBuckets_ - 1))
+      << "Number of buckets must be power of 2";
+
+  // initialize internal nodes for empty leaves
+  for (int64_t i = static_cast<int64_t>(numBuckets_) - 2; i >= 0; --i) {
+    digests_[i] = combine(digests_[2 * i + 1], digests_[2 * i + 2]);
+  }
+}
+
+size_t
+KvStoreMerkleTree::getBucket(std::string const& key, size_t numBuckets) {
+  // ATTN: bucket MUST be deterministic across nodes. Don't use std::hash.
+  return folly::hash::twang_mix64(folly::hash::fnv64(key)) & (numBuckets - 1);
+}
+
+void
+KvStoreMerkleTree::toggle(std::string const& key, int64_t hash) {
+  const auto keyHash = folly::hash::fnv64(key);
+  const auto bucket = folly::hash::twang_mix64(keyHash) & (numBuckets_ - 1);
+
+  size_t idx = numBuckets_ - 1 + bucket;
+  digests_[idx] ^= combine(keyHash, static_cast<uint64_t>(hash));
+  while (idx > 0) {
+    idx = (idx - 1) / 2;
+    digests_[idx] = combine(digests_[2 * idx + 1], digests_[2 * idx + 2]);
+  }
+}
+
+void
+KvStoreMerkleTree::add(std::string const& key, int64_t hash) {
+  toggle(key, hash);
+}
+
+void
+KvStoreMerkleTree::remove(std::string const& key, int64_t hash) {
+  // XOR is self-inverse
+  toggle(key, hash);
+}
+
+void
+KvStoreMerkleTree::update(
+    std::string const& key, int64_t oldHash, int64_t newHash) {
+  if (oldHash == newHash) {
+    return;
+  }
+  toggle(key, oldHash);
+  toggle(key, newHash);
+}
+
+thrift::KvStoreMerkleDigests
+KvStoreMerkleTree::toThrift() const {
+  thrift::KvStoreMerkleDigests thriftDigests;
+  thriftDigests.numBuckets_ref() = static_cast<int32_t>(numBuckets_);
+  auto& digests = *thriftDigests.digests_ref();
+  digests.reserve(digests_.size());
+  for (const auto& digest : digests_) {
+    digests.emplace_back(static_cast<int64_t>(digest));
+  }
+  return thriftDigests;
+}
+
+std::optional<std::vector<int32_t>>
+KvStoreMerkleTree::getMismatchedBuckets(
+    thrift::KvStoreMerkleDigests const& peerDigests) const {
+  const auto& peerNodes = *peerDigests.digests_ref();
+  if (static_cast<size_t>(*peerDigests.numBuckets_ref()) != numBuckets_ or
+      peerNodes.size() != digests_.size()) {
+    return std::nullopt;
+  }
+
+  std::vector<int32_t> buckets;
+  std::vector<size_t> stack{0};
+  while (not stack.empty()) {
+    const auto idx = stack.back();
+    stack.pop_back();
+    if (static_cast<uint64_t>(peerNodes[idx]) == digests_[idx]) {
+      // identical subtree, prune it
+      continue;
+    }
+    if (idx >= numBuckets_ - 1) {
+      buckets.emplace_back(static_cast<int32_t>(idx - (numBuckets_ - 1)));
+      continue;
+    }
+    stack.emplace_back(2 * idx + 2);
+    stack.emplace_back(2 * idx + 1);
+  }
+  return buckets;
+}
+
+} // namespace openr
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <openr/if/gen-cpp2/Types_types.h>
+
+namespace openr {
+
+/*
+ * Bucketed Merkle tree over the keyspace of a KvStoreDb.
+ *
+ * Every key is deterministically mapped into one of `numBuckets` leaves. A
+ * leaf digest is the XOR of per-key digests computed from (key, value-hash),
+ * which allows O(1) incremental add/remove of a key without rescanning the
+ * bucket. Internal nodes combine their two children and are updated along
+ * the path to the root on every leaf change.
+ *
+ * Nodes are stored in heap layout: root at index 0, children of node `i` at
+ * `2i + 1` and `2i + 2`, leaves at `[numBuckets - 1, 2 * numBuckets - 2]`.
+ *
+ * ATTN: digest only covers (key, version, originatorId, value) via the value
+ *       hash. TTL refreshes are propagated by flooding and do not change it.
+ */
+class KvStoreMerkleTree {
+ public:
+  explicit KvStoreMerkleTree(size_t numBuckets);
+
+  // add/remove the contribution of a key with given value hash
+  void add(std::string const& key, int64_t hash);
+  void remove(std::string const& key, int64_t hash);
+
+  // replace contribution of a key whose value hash changed
+  void update(std::string const& key, int64_t oldHash, int64_t newHash);
+
+  // bucket the key belongs to
+  size_t
+  getBucket(std::string const& key) const {
+    return getBucket(key, numBuckets_);
+  }
+
+  static size_t getBucket(std::string const& key, size_t numBuckets);
+
+  size_t
+  getNumBuckets() const {
+    return numBuckets_;
+  }
+
+  int64_t
+  getRootDigest() const {
+    return static_cast<int64_t>(digests_.front());
+  }
+
+  // serialize the whole tree for exchanging it with peers
+  thrift::KvStoreMerkleDigests toThrift() const;
+
+  /*
+   * Compare with peer's tree top-down and return buckets whose digests are
+   * different. Subtrees with matching digests are pruned.
+   *
+   * @return std::nullopt if peer's tree has an incompatible layout (i.e.
+   *         different number of buckets) and can't be compared.
+   */
+  std::optional<std::vector<int32_t>> getMismatchedBuckets(
+      thrift::KvStoreMerkleDigests const& peerDigests) const;
+
+ private:
+  // toggle per-key digest in its leaf and recompute path up to the root
+  void toggle(std::string const& key, int64_t hash);
+
+  // number of leaves. Must be power of 2
+  const size_t numBuckets_{0};
+
+  // tree nodes in heap layout
+  std::vector<uint64_t> digests_;
+};
+
+} // namespace openr
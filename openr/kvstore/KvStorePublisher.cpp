@@ -78,6 +78,7 @@ KvStorePublisher::publish(const thrift::Publication& pub) {
   if (pub.expiredKeys_ref().is_set()) {
     publication_filtered.expiredKeys_ref() = *pub.expiredKeys_ref();
   }
+  publication_filtered.expiredKeyVals_ref().copy_from(pub.expiredKeyVals_ref());
 
   if (pub.nodeIds_ref().has_value()) {
     publication_filtered.nodeIds_ref() = *pub.nodeIds_ref();
@@ -122,4 +123,168 @@ KvStorePublisher::publish(const thrift::Publication& pub) {
     publisher_.next(std::move(publication_filtered));
   }
 }
+
+void
+KvStorePublisher::publishMatched(
+    const thrift::Publication& pub,
+    std::vector<thrift::KeyVals::const_pointer> const& keyVals) {
+  thrift::Publication filteredPub;
+  if (pub.expiredKeys_ref().is_set()) {
+    filteredPub.expiredKeys_ref() = *pub.expiredKeys_ref();
+  }
+  filteredPub.expiredKeyVals_ref().copy_from(pub.expiredKeyVals_ref());
+  if (pub.nodeIds_ref().has_value()) {
+    filteredPub.nodeIds_ref() = *pub.nodeIds_ref();
+  }
+  if (pub.tobeUpdatedKeys_ref().has_value()) {
+    filteredPub.tobeUpdatedKeys_ref() = *pub.tobeUpdatedKeys_ref();
+  }
+  if (pub.floodRootId_ref().has_value()) {
+    filteredPub.floodRootId_ref() = *pub.floodRootId_ref();
+  }
+  if (pub.area_ref().is_set()) {
+    filteredPub.area_ref() = *pub.area_ref();
+  }
+
+  auto& filteredKeyVals = *filteredPub.keyVals_ref();
+  for (auto const* keyVal : keyVals) {
+    auto const& [key, val] = *keyVal;
+    if (*filter_.ignoreTtl_ref() and not val.value_ref().has_value()) {
+      // ignore TTL updates
+      continue;
+    }
+    if ((not *filter_.doNotPublishValue_ref()) or
+        (not val.value_ref().has_value())) {
+      filteredKeyVals.emplace(key, val);
+    } else {
+      // Exclude Value.value if it's filtered
+      filteredKeyVals.emplace(key, createThriftValueWithoutBinaryValue(val));
+    }
+  }
+
+  if (not filteredKeyVals.empty()) {
+    filteredPub.timestamp_ms_ref() = getUnixTimeStampMs();
+    publisher_.next(std::move(filteredPub));
+  }
+}
+
+void
+KvStorePublisherDispatcher::add(
+    int64_t token, std::unique_ptr<KvStorePublisher> publisher) {
+  auto const& filters = publisher->getKeyFilters();
+  auto const& originatorIds = filters.getOriginatorIdList();
+  if (filters.getKeyPrefixes().empty() and not originatorIds.empty()) {
+    for (auto const& originatorId : originatorIds) {
+      originatorTokens_[originatorId].emplace(token);
+    }
+  } else if (auto keyPrefixes = filters.getLiteralKeyPrefixes()) {
+    // with originators, filter is AND hence they are checked on lookup
+    for (auto const& keyPrefix : *keyPrefixes) {
+      keyPrefixTokens_[keyPrefix].emplace(token);
+      ++keyPrefixLengths_[keyPrefix.size()];
+    }
+  } else {
+    unindexedTokens_.emplace(token);
+  }
+  publishers_.emplace(token, std::move(publisher));
+}
+
+bool
+KvStorePublisherDispatcher::erase(int64_t token) {
+  auto it = publishers_.find(token);
+  if (it == publishers_.end()) {
+    return false;
+  }
+  if (not unindexedTokens_.erase(token)) {
+    auto const& filters = it->second->getKeyFilters();
+    for (auto const& originatorId : filters.getOriginatorIdList()) {
+      auto originatorIt = originatorTokens_.find(originatorId);
+      if (originatorIt != originatorTokens_.end() and
+          originatorIt->second.erase(token) and originatorIt->second.empty()) {
+        originatorTokens_.erase(originatorIt);
+      }
+    }
+    if (auto keyPrefixes = filters.getLiteralKeyPrefixes()) {
+      for (auto const& keyPrefix : *keyPrefixes) {
+        auto prefixIt = keyPrefixTokens_.find(keyPrefix);
+        if (prefixIt == keyPrefixTokens_.end() or
+            not prefixIt->second.erase(token)) {
+          continue;
+        }
+        if (prefixIt->second.empty()) {
+          keyPrefixTokens_.erase(prefixIt);
+        }
+        auto lengthIt = keyPrefixLengths_.find(keyPrefix.size());
+        if (--lengthIt->second == 0) {
+          keyPrefixLengths_.erase(lengthIt);
+        }
+      }
+    }
+  }
+  publishers_.erase(it);
+  return true;
+}
+
+std::vector<std::unique_ptr<KvStorePublisher>>
+KvStorePublisherDispatcher::releaseAll() {
+  std::vector<std::unique_ptr<KvStorePublisher>> publishers;
+  publishers.reserve(publishers_.size());
+  for (auto& [_, publisher] : publishers_) {
+    publishers.emplace_back(std::move(publisher));
+  }
+  publishers_.clear();
+  unindexedTokens_.clear();
+  keyPrefixTokens_.clear();
+  keyPrefixLengths_.clear();
+  originatorTokens_.clear();
+  return publishers;
+}
+
+void
+KvStorePublisherDispatcher::publish(const thrift::Publication& pub) {
+  auto const& area = pub.get_area();
+  for (auto token : unindexedTokens_) {
+    publishers_.at(token)->publish(pub);
+  }
+  if (keyPrefixTokens_.empty() and originatorTokens_.empty()) {
+    return;
+  }
+
+  // Look every key up once, collecting matched keys per indexed publisher
+  std::unordered_map<int64_t, std::vector<thrift::KeyVals::const_pointer>>
+      matchedKeyVals;
+  for (auto const& keyVal : *pub.keyVals_ref()) {
+    auto const& [key, val] = keyVal;
+    for (auto const& [length, _] : keyPrefixLengths_) {
+      if (length > key.size()) {
+        break;
+      }
+      auto it = keyPrefixTokens_.find(key.substr(0, length));
+      if (it == keyPrefixTokens_.end()) {
+        continue;
+      }
+      for (auto token : it->second) {
+        auto const& originatorIds =
+            publishers_.at(token)->getKeyFilters().getOriginatorIdList();
+        if (originatorIds.empty() or
+            originatorIds.count(*val.originatorId_ref())) {
+          matchedKeyVals[token].emplace_back(&keyVal);
+        }
+      }
+    }
+    auto it = originatorTokens_.find(*val.originatorId_ref());
+    if (it != originatorTokens_.end()) {
+      for (auto token : it->second) {
+        matchedKeyVals[token].emplace_back(&keyVal);
+      }
+    }
+  }
+
+  for (auto const& [token, keyVals] : matchedKeyVals) {
+    auto& publisher = publishers_.at(token);
+    if (publisher->isAreaSelected(area)) {
+      publisher->publishMatched(pub, keyVals);
+    }
+  }
+}
 } // namespace openr
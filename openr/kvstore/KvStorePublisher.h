@@ -7,6 +7,10 @@
 
 #pragma once
 
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+
 #include <openr/common/Types.h>
 #include <openr/config/Config.h>
 #include <openr/if/gen-cpp2/OpenrCtrlCpp.h>
@@ -27,6 +31,21 @@ class KvStorePublisher {
   // Invoked whenever there is change. Apply filter and publish changes
   void publish(const thrift::Publication& pub);
 
+  // Publish changes of `keyVals`, already known to match the key filter
+  void publishMatched(
+      const thrift::Publication& pub,
+      std::vector<thrift::KeyVals::const_pointer> const& keyVals);
+
+  bool
+  isAreaSelected(std::string const& area) const {
+    return selectAreas_.empty() or selectAreas_.count(area);
+  }
+
+  KvStoreFilters const&
+  getKeyFilters() const {
+    return keyPrefixFilter_;
+  }
+
   template <class... Args>
   void
   complete(Args&&... args) {
@@ -40,4 +59,45 @@ class KvStorePublisher {
   KvStoreFilters keyPrefixFilter_{{}, {}};
   apache::thrift::ServerStreamPublisher<thrift::Publication> publisher_;
 };
+
+/**
+ * Fans publications out to KvStore publishers. Publishers filtering by literal
+ * key prefixes or by originator only are indexed, hence each key is looked up
+ * once per publication and handed to interested publishers, instead of being
+ * matched against the filter of every publisher. Publishers with regex filters
+ * match keys on their own.
+ */
+class KvStorePublisherDispatcher {
+ public:
+  void add(int64_t token, std::unique_ptr<KvStorePublisher> publisher);
+
+  // Return false if there is no publisher of `token`
+  bool erase(int64_t token);
+
+  size_t
+  size() const {
+    return publishers_.size();
+  }
+
+  // Remove all publishers, e.g. to complete them outside of lock
+  std::vector<std::unique_ptr<KvStorePublisher>> releaseAll();
+
+  void publish(const thrift::Publication& pub);
+
+ private:
+  std::unordered_map<int64_t, std::unique_ptr<KvStorePublisher>> publishers_;
+
+  // publishers matching keys on their own, or with no filter at all
+  std::unordered_set<int64_t> unindexedTokens_;
+
+  // literal key prefix to publishers interested in keys starting with it,
+  // along with reference counts of prefix lengths to look keys up by
+  std::unordered_map<std::string, std::unordered_set<int64_t>>
+      keyPrefixTokens_;
+  std::map<size_t, size_t> keyPrefixLengths_;
+
+  // originator to publishers filtering only by originator
+  std::unordered_map<std::string, std::unordered_set<int64_t>>
+      originatorTokens_;
+};
 } // namespace openr
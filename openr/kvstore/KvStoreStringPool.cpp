@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <glog/logging.h>
+
+#include <openr/kvstore/KvStoreStringPool.h>
+
+namespace openr {
+
+KvStoreStringPool::Handle
+KvStoreStringPool::intern(std::string const& str) {
+  auto it = pool_.find(std::string_view(str));
+  if (it != pool_.end()) {
+    auto handle = it->second.lock();
+    // entry is erased by deleter of the last handle, hence always alive
+    DCHECK(handle);
+    return handle;
+  }
+
+  auto handle = Handle(new std::string(str), [this](const std::string* s) {
+    pool_.erase(std::string_view(*s));
+    delete s;
+  });
+  pool_.emplace(std::string_view(*handle), handle);
+  return handle;
+}
+
+int64_t
+KvStoreStringPool::getBytesSaved() const {
+  int64_t bytesSaved{0};
+  for (auto const& [str, weakHandle] : pool_) {
+    const int64_t useCnt = weakHandle.use_count();
+    // heap allocation is avoided ONLY for strings beyond SSO capacity
+    const int64_t strSize = sizeof(std::string) +
+        (str.size() > std::string().capacity() ? str.size() : 0);
+    // every handle holding a std::string copy vs. one shared copy + handles
+    bytesSaved += useCnt * strSize - (strSize + useCnt * sizeof(Handle));
+  }
+  return bytesSaved;
+}
+
+} // namespace openr
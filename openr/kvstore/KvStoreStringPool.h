@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <folly/container/F14Map.h>
+
+namespace openr {
+
+/*
+ * Pool of interned strings for KvStoreDb bookkeeping structures.
+ *
+ * Keys and originatorIds are replicated into every TTL countdown entry and
+ * the sorted key index of KvStoreDb, while the number of distinct strings is bounded by the keyspace
+ * and number of nodes. The pool hands out reference-counted handles so that
+ * all copies of the same string share a single allocation. Entry is removed
+ * from the pool as soon as its last handle goes away.
+ *
+ * ATTN: NOT thread-safe. Pool MUST outlive all handles it gave out.
+ */
+class KvStoreStringPool {
+ public:
+  using Handle = std::shared_ptr<const std::string>;
+
+  // Lexicographic order of handles by string content. Transparent to allow
+  // lookup by plain string without interning it.
+  struct HandleLess {
+    using is_transparent = void;
+
+    bool
+    operator()(Handle const& lhs, Handle const& rhs) const {
+      return *lhs < *rhs;
+    }
+    bool
+    operator()(Handle const& lhs, std::string const& rhs) const {
+      return *lhs < rhs;
+    }
+    bool
+    operator()(std::string const& lhs, Handle const& rhs) const {
+      return lhs < *rhs;
+    }
+  };
+
+  KvStoreStringPool() = default;
+
+  // non-copyable and non-movable as live handles refer back to the pool
+  KvStoreStringPool(KvStoreStringPool const&) = delete;
+  KvStoreStringPool& operator=(KvStoreStringPool const&) = delete;
+
+  // get handle of interned copy of `str`
+  Handle intern(std::string const& str);
+
+  // number of distinct strings currently interned
+  size_t
+  size() const {
+    return pool_.size();
+  }
+
+  // approximate bytes saved by sharing interned strings across handles
+  // compared to holding a std::string copy per handle
+  int64_t getBytesSaved() const;
+
+ private:
+  // ATTN: string_view refers to the string owned by the handles
+  folly::F14FastMap<std::string_view, std::weak_ptr<const std::string>> pool_;
+};
+
+} // namespace openr
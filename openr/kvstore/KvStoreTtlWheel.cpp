@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <limits>
+
+#include <glog/logging.h>
+
+#include <openr/kvstore/KvStoreTtlWheel.h>
+
+namespace openr {
+
+KvStoreTtlWheel::KvStoreTtlWheel(
+    std::chrono::milliseconds tick,
+    size_t slotsPerLevel,
+    size_t numLevels,
+    Clock::time_point startTime)
+    : tick_(tick),
+      slotsPerLevel_(slotsPerLevel),
+      numLevels_(numLevels),
+      startTime_(startTime),
+      slots_(
+          numLevels,
+          std::vector<folly::F14FastSet<std::string_view>>(slotsPerLevel)),
+      levelSizes_(numLevels, 0) {
+  CHECK_GT(tick_.count(), 0);
+  CHECK_GT(slotsPerLevel_, 1);
+  CHECK_GT(numLevels_, 0);
+
+  spans_.emplace_back(1);
+  for (size_t level = 0; level < numLevels_; ++level) {
+    CHECK_LE(
+        spans_.back(), std::numeric_limits<uint64_t>::max() / slotsPerLevel_)
+        << "Timing wheel span overflow";
+    spans_.emplace_back(spans_.back() * slotsPerLevel_);
+  }
+}
+
+uint64_t
+KvStoreTtlWheel::toTickCeil(Clock::time_point timePoint) const {
+  if (timePoint <= startTime_) {
+    return 0;
+  }
+  const auto elapsed = timePoint - startTime_;
+  const auto ticks = static_cast<uint64_t>(elapsed / tick_);
+  return elapsed % tick_ == elapsed.zero() ? ticks : ticks + 1;
+}
+
+uint64_t
+KvStoreTtlWheel::toTickFloor(Clock::time_point timePoint) const {
+  if (timePoint <= startTime_) {
+    return 0;
+  }
+  return static_cast<uint64_t>((timePoint - startTime_) / tick_);
+}
+
+KvStoreTtlWheel::Clock::time_point
+KvStoreTtlWheel::toTimePoint(uint64_t tick) const {
+  return startTime_ + tick_ * static_cast<int64_t>(tick);
+}
+
+void
+KvStoreTtlWheel::place(std::string_view key, Node& node, uint64_t minTick) {
+  const auto tick = std::max(node.expiryTick, minTick);
+
+  // lowest level sharing the epoch of next-upper level with current tick.
+  // Entries beyond the top level epoch are parked on the top level.
+  size_t level = 0;
+  while (level + 1 < numLevels_ and
+         tick / spans_[level + 1] != currentTick_ / spans_[level + 1]) {
+    ++level;
+  }
+
+  node.level = level;
+  node.slot = (tick / spans_[level]) % slotsPerLevel_;
+  auto& slot = slots_[level][node.slot];
+  if (slot.empty()) {
+    ++numOccupiedSlots_;
+  }
+  slot.emplace(key);
+  ++levelSizes_[level];
+}
+
+void
+KvStoreTtlWheel::unplace(std::string_view key, Node const& node) {
+  auto& slot = slots_[node.level][node.slot];
+  if (slot.erase(key) == 0) {
+    return;
+  }
+  --levelSizes_[node.level];
+  if (slot.empty()) {
+    --numOccupiedSlots_;
+  }
+}
+
+folly::F14FastSet<std::string_view>
+KvStoreTtlWheel::takeCurrentSlot(size_t level) {
+  auto& slot = slots_[level][(currentTick_ / spans_[level]) % slotsPerLevel_];
+  folly::F14FastSet<std::string_view> keys;
+  keys.swap(slot);
+  if (not keys.empty()) {
+    levelSizes_[level] -= keys.size();
+    --numOccupiedSlots_;
+  }
+  return keys;
+}
+
+void
+KvStoreTtlWheel::schedule(TtlCountdownEntry entry) {
+  CHECK(entry.key);
+  // ATTN: drop existing node first, the new entry may hold a distinct (but
+  // equal) key string for the node's string_view to refer to
+  erase(*entry.key);
+
+  Node node;
+  node.expiryTick = toTickCeil(entry.expiryTime);
+  node.entry = std::move(entry);
+  const std::string_view key(*node.entry.key);
+  auto [it, inserted] = nodes_.emplace(key, std::move(node));
+  DCHECK(inserted);
+  // expired entries are due on the next tick
+  place(it->first, it->second, currentTick_ + 1);
+}
+
+bool
+KvStoreTtlWheel::erase(std::string const& key) {
+  auto it = nodes_.find(std::string_view(key));
+  if (it == nodes_.end()) {
+    return false;
+  }
+  unplace(it->first, it->second);
+  nodes_.erase(it);
+  return true;
+}
+
+TtlCountdownEntry const*
+KvStoreTtlWheel::find(std::string const& key) const {
+  auto it = nodes_.find(std::string_view(key));
+  return it == nodes_.end() ? nullptr : &it->second.entry;
+}
+
+std::vector<TtlCountdownEntry>
+KvStoreTtlWheel::expire(Clock::time_point now) {
+  std::vector<TtlCountdownEntry> expired;
+  const auto nowTick = toTickFloor(now);
+
+  while (currentTick_ < nowTick) {
+    if (nodes_.empty()) {
+      currentTick_ = nowTick;
+      break;
+    }
+
+    // Jump to the next slot boundary of the lowest non-empty level. Levels
+    // below are empty, so there is nothing in between to expire or cascade.
+    size_t lowest = 0;
+    while (levelSizes_[lowest] == 0) {
+      ++lowest;
+    }
+    const auto nextTick = (currentTick_ / spans_[lowest] + 1) * spans_[lowest];
+    if (nextTick > nowTick) {
+      currentTick_ = nowTick;
+      break;
+    }
+    currentTick_ = nextTick;
+
+    // Cascade entries of reached slots down, starting from the top level as
+    // those can land in slots of lower levels being reached at the same time
+    for (size_t level = numLevels_ - 1; level > 0; --level) {
+      if (currentTick_ % spans_[level] != 0) {
+        continue;
+      }
+      for (auto const& key : takeCurrentSlot(level)) {
+        place(key, nodes_.at(key), currentTick_);
+      }
+    }
+
+    // Expire entries of the current level 0 slot
+    for (auto const& key : takeCurrentSlot(0)) {
+      auto it = nodes_.find(key);
+      DCHECK(it != nodes_.end());
+      if (it->second.expiryTick > currentTick_) {
+        // parked beyond the top level epoch, not yet due
+        place(it->first, it->second, currentTick_ + 1);
+        continue;
+      }
+      expired.emplace_back(std::move(it->second.entry));
+      nodes_.erase(it);
+    }
+  }
+  return expired;
+}
+
+std::optional<KvStoreTtlWheel::Clock::time_point>
+KvStoreTtlWheel::getNextWakeupTime() const {
+  if (nodes_.empty()) {
+    return std::nullopt;
+  }
+
+  // Earliest event is the next non-empty slot of the lowest non-empty level.
+  // Entries on upper levels can't be due before the lower ones.
+  size_t lowest = 0;
+  while (levelSizes_[lowest] == 0) {
+    ++lowest;
+  }
+  const auto span = spans_[lowest];
+  const auto currentBlock = currentTick_ / span;
+  for (size_t i = 1; i <= slotsPerLevel_; ++i) {
+    const auto block = currentBlock + i;
+    if (not slots_[lowest][block % slotsPerLevel_].empty()) {
+      return toTimePoint(block * span);
+    }
+  }
+  LOG(DFATAL) << "Timing wheel level " << lowest << " has no occupied slot";
+  return toTimePoint((currentBlock + 1) * span);
+}
+
+} // namespace openr
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <folly/container/F14Map.h>
+#include <folly/container/F14Set.h>
+
+#include <openr/kvstore/KvStoreStringPool.h>
+
+namespace openr {
+
+// ATTN: key and originatorId are interned via KvStoreStringPool as they are
+//       shared with the key index of KvStoreDb
+struct TtlCountdownEntry {
+  std::chrono::steady_clock::time_point expiryTime;
+  KvStoreStringPool::Handle key;
+  int64_t version{0};
+  int64_t ttlVersion{0};
+  KvStoreStringPool::Handle originatorId;
+};
+
+/*
+ * Hierarchical timing wheel for TTL countdown of KvStoreDb keys.
+ *
+ * Holds at most one entry per key. Scheduling an entry for a key already in
+ * the wheel reschedules it in place, hence refreshing TTL of a key doesn't
+ * leave stale entries behind. Insert, reschedule and erase are O(1).
+ *
+ * Level `l` has `slotsPerLevel` slots, each spanning `slotsPerLevel ^ l`
+ * ticks. An entry is placed on the lowest level whose next-upper epoch is the
+ * same as the current tick, and cascades down one or more levels whenever the
+ * wheel reaches the boundary of its slot. Entries ONLY expire from level 0,
+ * never before their `expiryTime`, and at most one tick after it.
+ *
+ * ATTN: NOT thread-safe.
+ */
+class KvStoreTtlWheel {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  KvStoreTtlWheel(
+      std::chrono::milliseconds tick,
+      size_t slotsPerLevel,
+      size_t numLevels,
+      Clock::time_point startTime = Clock::now());
+
+  // non-copyable as slots refer to keys owned by entries
+  KvStoreTtlWheel(KvStoreTtlWheel const&) = delete;
+  KvStoreTtlWheel& operator=(KvStoreTtlWheel const&) = delete;
+
+  // insert entry or reschedule existing entry of the same key in place
+  void schedule(TtlCountdownEntry entry);
+
+  // remove entry of the key. Return false if key is not in the wheel.
+  bool erase(std::string const& key);
+
+  // entry of the key, nullptr if key is not in the wheel
+  TtlCountdownEntry const* find(std::string const& key) const;
+
+  // advance the wheel to `now`, remove and return expired entries
+  std::vector<TtlCountdownEntry> expire(Clock::time_point now);
+
+  // earliest time to advance the wheel at, std::nullopt if wheel is empty
+  std::optional<Clock::time_point> getNextWakeupTime() const;
+
+  size_t
+  size() const {
+    return nodes_.size();
+  }
+
+  bool
+  empty() const {
+    return nodes_.empty();
+  }
+
+  size_t
+  getNumLevels() const {
+    return numLevels_;
+  }
+
+  // number of entries on the given level
+  size_t
+  getNumEntries(size_t level) const {
+    return levelSizes_.at(level);
+  }
+
+  // number of non-empty slots across all levels
+  size_t
+  getNumOccupiedSlots() const {
+    return numOccupiedSlots_;
+  }
+
+ private:
+  struct Node {
+    TtlCountdownEntry entry;
+    uint64_t expiryTick{0};
+    size_t level{0};
+    size_t slot{0};
+  };
+
+  // ticks elapsed since start, rounded up and down respectively
+  uint64_t toTickCeil(Clock::time_point timePoint) const;
+  uint64_t toTickFloor(Clock::time_point timePoint) const;
+
+  Clock::time_point toTimePoint(uint64_t tick) const;
+
+  // put node into slot of its expiry tick, no earlier than `minTick`
+  void place(std::string_view key, Node& node, uint64_t minTick);
+
+  // remove node from its slot
+  void unplace(std::string_view key, Node const& node);
+
+  // take out all keys of the current slot of the given level
+  folly::F14FastSet<std::string_view> takeCurrentSlot(size_t level);
+
+  const std::chrono::milliseconds tick_;
+  const size_t slotsPerLevel_;
+  const size_t numLevels_;
+  const Clock::time_point startTime_;
+
+  // spans_[l] is number of ticks covered by one slot of level l
+  std::vector<uint64_t> spans_;
+
+  // last tick the wheel has advanced to
+  uint64_t currentTick_{0};
+
+  // ATTN: string_view refers to the key of the entry held by the node
+  folly::F14FastMap<std::string_view, Node> nodes_;
+
+  // slots_[level][slot] holds keys of nodes placed in the slot
+  std::vector<std::vector<folly::F14FastSet<std::string_view>>> slots_;
+
+  std::vector<size_t> levelSizes_;
+  size_t numOccupiedSlots_{0};
+};
+
+} // namespace openr
@@ -5,7 +5,13 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <cstring>
+
+#include <folly/lang/Bits.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+
 #include <openr/common/Constants.h>
+#include <openr/common/Util.h>
 #include <openr/kvstore/KvStoreUtil.h>
 
 namespace openr {
@@ -36,9 +42,31 @@ getKvStoreFilters(std::shared_ptr<const openr::Config> config) {
   return kvFilters;
 }
 
+namespace {
+
+/*
+ * Compare value bytes of two thrift::Values with the same version and
+ * originatorId. Matching hashes and sizes imply the same bytes, a reflected
+ * value is hence detected without touching possibly large payloads. Bytes are
+ * ONLY compared to order distinct values, which terminates on first mismatch.
+ */
+int
+compareValueBytes(thrift::Value const& v1, thrift::Value const& v2) {
+  auto const& bytes1 = *v1.value_ref();
+  auto const& bytes2 = *v2.value_ref();
+  if (v1.hash_ref().has_value() and v2.hash_ref().has_value() and
+      *v1.hash_ref() == *v2.hash_ref() and bytes1.size() == bytes2.size()) {
+    return 0;
+  }
+  return bytes1.compare(bytes2);
+}
+
+} // namespace
+
+template <typename KvStoreMapT>
 std::unordered_map<std::string, thrift::Value>
 mergeKeyValues(
-    std::unordered_map<std::string, thrift::Value>& kvStore,
+    KvStoreMapT& kvStore,
     std::unordered_map<std::string, thrift::Value> const& keyVals,
     std::optional<KvStoreFilters> const& filters) {
   // the publication to build if we update our KV store
@@ -101,7 +129,7 @@ mergeKeyValues(
         // differ(higher in this case but can be lower as long as it's
         // deterministic). Otherwise, local store can have new value while
         // other stores have old value and they never sync.
-        int rc = (*value.value_ref()).compare(*kvStoreIt->second.value_ref());
+        int rc = compareValueBytes(value, kvStoreIt->second);
         if (rc > 0) {
           // versions and orginatorIds are same but value is higher
           VLOG(3) << "Previous incarnation reflected back for key " << key;
@@ -196,6 +224,16 @@ mergeKeyValues(
   return kvUpdates;
 }
 
+// explicit instantiations for supported key-value map types
+template std::unordered_map<std::string, thrift::Value> mergeKeyValues(
+    KvStoreMap& kvStore,
+    std::unordered_map<std::string, thrift::Value> const& keyVals,
+    std::optional<KvStoreFilters> const& filters);
+template std::unordered_map<std::string, thrift::Value> mergeKeyValues(
+    std::unordered_map<std::string, thrift::Value>& kvStore,
+    std::unordered_map<std::string, thrift::Value> const& keyVals,
+    std::optional<KvStoreFilters> const& filters);
+
 /**
  * Compare two values to find out which value is better
  */
@@ -299,7 +337,19 @@ KvStoreFilters::getKeyPrefixes() const {
   return keyPrefixList_;
 }
 
-std::set<std::string>
+std::optional<std::vector<std::string>>
+KvStoreFilters::getLiteralKeyPrefixes(bool matchAll) const {
+  if (keyPrefixList_.empty() or not keyRegexSet_.isLiteralOnly()) {
+    return std::nullopt;
+  }
+  if (not matchAll and filterOperator_ == thrift::FilterOperator::OR and
+      not originatorIds_.empty()) {
+    return std::nullopt;
+  }
+  return keyRegexSet_.getLiteralPrefixes();
+}
+
+std::set<std::string> const&
 KvStoreFilters::getOriginatorIdList() const {
   return originatorIds_;
 }
@@ -318,4 +368,39 @@ KvStoreFilters::str() const {
   return result;
 }
 
+std::string
+serializePublicationRecord(thrift::Publication const& publication) {
+  apache::thrift::CompactSerializer serializer;
+  const auto data = writeThriftObjStrBuffered(publication, serializer);
+  const uint32_t length =
+      folly::Endian::big(static_cast<uint32_t>(data.size()));
+  std::string record(reinterpret_cast<const char*>(&length), sizeof(length));
+  record.append(data);
+  return record;
+}
+
+std::vector<thrift::Publication>
+parsePublicationRecords(folly::StringPiece records) {
+  apache::thrift::CompactSerializer serializer;
+  std::vector<thrift::Publication> publications;
+  while (not records.empty()) {
+    uint32_t length{0};
+    if (records.size() < sizeof(length)) {
+      break;
+    }
+    std::memcpy(&length, records.data(), sizeof(length));
+    length = folly::Endian::big(length);
+    if (records.size() - sizeof(length) < length) {
+      break;
+    }
+    publications.emplace_back(readThriftObjStr<thrift::Publication>(
+        records.subpiece(sizeof(length), length).str(), serializer));
+    records.advance(sizeof(length) + length);
+  }
+  LOG_IF(WARNING, not records.empty())
+      << "Ignoring partial publication record of " << records.size()
+      << " bytes at the end of the stream";
+  return publications;
+}
+
 }; // namespace openr
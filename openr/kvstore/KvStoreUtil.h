@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <folly/container/F14Map.h>
 #include <folly/io/async/AsyncSocket.h>
 #include <openr/common/Constants.h>
 #include <openr/common/Types.h>
@@ -18,6 +19,12 @@
 
 namespace openr {
 
+/*
+ * Map type to store key-vals of KvStoreDb. Vector-backed flat hash map keeps
+ * all entries in one contiguous allocation instead of one node per key-val.
+ */
+using KvStoreMap = folly::F14VectorMap<std::string, thrift::Value>;
+
 class KvStoreFilters {
  public:
   // takes the list of comma separated key prefixes to match,
@@ -39,8 +46,22 @@ class KvStoreFilters {
   // return comma separeated string prefix
   std::vector<std::string> getKeyPrefixes() const;
 
+  // Return literal key prefixes whose key ranges cover all keys possibly
+  // matching the filters. Set `matchAll` for `keyMatchAll()` semantics,
+  // otherwise `keyMatch()` semantics apply. Return std::nullopt if there is
+  // no prefix filter, any of prefixes is a regex or, with OR logic, keys out
+  // of prefix ranges can match originatorIds.
+  std::optional<std::vector<std::string>> getLiteralKeyPrefixes(
+      bool matchAll = false) const;
+
   // return set of origninator IDs
-  std::set<std::string> getOriginatorIdList() const;
+  std::set<std::string> const& getOriginatorIdList() const;
+
+  // return OR/AND matching logic of `keyMatch()`
+  thrift::FilterOperator
+  getFilterOperator() const {
+    return filterOperator_;
+  }
 
   // print filters
   std::string str() const;
@@ -160,7 +181,8 @@ static void printKeyValInArea(
  in
  * the existing map, and return a publication made out of the updated values.
  *
- * @param kvStore - key-value map with current key-values in KVStore
+ * @param kvStore - key-value map with current key-values in KVStore. Either
+ *                  `KvStoreMap` or `std::unordered_map` of key-values
  * @param keyVals - key-value map with key-values to merge in
  * @param filters - optional filters, matching keys in keyVals will be
                     merged in
@@ -169,8 +191,9 @@ static void printKeyValInArea(
  *  - key-value map obtained by merging data; publication made out of
  *    the updated values
  */
+template <typename KvStoreMapT>
 std::unordered_map<std::string, thrift::Value> mergeKeyValues(
-    std::unordered_map<std::string, thrift::Value>& kvStore,
+    KvStoreMapT& kvStore,
     std::unordered_map<std::string, thrift::Value> const& keyVals,
     std::optional<KvStoreFilters> const& filters = std::nullopt);
 
@@ -194,6 +217,32 @@ std::optional<openr::KvStoreFilters> getKvStoreFilters(
  */
 int compareValues(const thrift::Value& v1, const thrift::Value& v2);
 
+/*
+ * Stream of publications recorded by KvStoreSnooper for replaying them, e.g.
+ * through Decision benchmark. Every record is the length of serialized
+ * publication as 4 bytes in network byte order, followed by the publication
+ * in compact serialization.
+ *
+ * @param publication - publication to serialize into a record
+ *
+ * @return
+ *  - record to append to the stream
+ */
+std::string serializePublicationRecord(thrift::Publication const& publication);
+
+/*
+ * Parse publications of a recorded stream, see serializePublicationRecord().
+ * Partially written record at the end of the stream, e.g. when snooper got
+ * killed, is ignored.
+ *
+ * @param records - recorded stream of publications
+ *
+ * @return
+ *  - publications in order of the stream
+ */
+std::vector<thrift::Publication> parsePublicationRecords(
+    folly::StringPiece records);
+
 } // namespace openr
 
 #include <openr/kvstore/KvStoreUtil-inl.h>
@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <fb303/ServiceData.h>
+#include <fmt/format.h>
+#include <folly/FileUtil.h>
+#include <glog/logging.h>
+
+#include <openr/kvstore/KvStoreValueCodec.h>
+
+namespace fb303 = facebook::fb303;
+
+namespace openr {
+
+namespace {
+
+struct CCtxDeleter {
+  void
+  operator()(ZSTD_CCtx* cctx) const {
+    ZSTD_freeCCtx(cctx);
+  }
+};
+
+struct DCtxDeleter {
+  void
+  operator()(ZSTD_DCtx* dctx) const {
+    ZSTD_freeDCtx(dctx);
+  }
+};
+
+ZSTD_CCtx*
+getThreadCCtx() {
+  thread_local std::unique_ptr<ZSTD_CCtx, CCtxDeleter> cctx{ZSTD_createCCtx()};
+  return cctx.get();
+}
+
+ZSTD_DCtx*
+getThreadDCtx() {
+  thread_local std::unique_ptr<ZSTD_DCtx, DCtxDeleter> dctx{ZSTD_createDCtx()};
+  return dctx.get();
+}
+
+} // namespace
+
+KvStoreValueCodec::KvStoreValueCodec(
+    std::unordered_map<std::string, std::string> const& dictionaries,
+    int compressionLevel) {
+  for (auto const& [keyPrefix, content] : dictionaries) {
+    if (keyPrefix.empty()) {
+      throw std::invalid_argument("Empty key prefix for value dictionary");
+    }
+    // raw content dictionaries have no ID and can't be told apart on decode
+    const auto dictId = ZSTD_getDictID_fromDict(content.data(), content.size());
+    if (dictId == 0) {
+      throw std::invalid_argument(fmt::format(
+          "Value dictionary of key prefix {} is not a trained zstd dictionary",
+          keyPrefix));
+    }
+
+    Dictionary dictionary;
+    dictionary.keyPrefix = keyPrefix;
+    dictionary.cdict.reset(
+        ZSTD_createCDict(content.data(), content.size(), compressionLevel));
+    CHECK(dictionary.cdict) << "Failed to create zstd compression dictionary";
+    dictionaries_.emplace_back(std::move(dictionary));
+
+    if (not ddicts_.count(dictId)) {
+      ddicts_[dictId].reset(ZSTD_createDDict(content.data(), content.size()));
+      CHECK(ddicts_.at(dictId))
+          << "Failed to create zstd decompression dictionary";
+    }
+  }
+}
+
+std::shared_ptr<const KvStoreValueCodec>
+KvStoreValueCodec::createFromConfig(Config const& config) {
+  auto const& dictionaryFiles =
+      config.getKvStoreConfig().value_compression_dictionaries_ref();
+  if (not dictionaryFiles.has_value() or dictionaryFiles->empty()) {
+    return nullptr;
+  }
+
+  std::unordered_map<std::string, std::string> dictionaries;
+  for (auto const& [keyPrefix, file] : *dictionaryFiles) {
+    std::string content;
+    if (not folly::readFile(file.c_str(), content)) {
+      throw std::invalid_argument(fmt::format(
+          "Failed to read value dictionary {} of key prefix {}",
+          file,
+          keyPrefix));
+    }
+    dictionaries.emplace(keyPrefix, std::move(content));
+  }
+  LOG(INFO) << "Loaded " << dictionaries.size()
+            << " dictionaries for KvStore value compression";
+  return std::make_shared<KvStoreValueCodec>(dictionaries);
+}
+
+ZSTD_CDict const*
+KvStoreValueCodec::findCDict(std::string const& key) const {
+  Dictionary const* match{nullptr};
+  for (auto const& dictionary : dictionaries_) {
+    if (key.compare(0, dictionary.keyPrefix.size(), dictionary.keyPrefix) ==
+            0 and
+        (not match or dictionary.keyPrefix.size() > match->keyPrefix.size())) {
+      match = &dictionary;
+    }
+  }
+  return match ? match->cdict.get() : nullptr;
+}
+
+std::optional<std::string>
+KvStoreValueCodec::compress(
+    std::string const& key, std::string const& value) const {
+  if (value.size() < Constants::kKvStoreValueCompressionMinBytes) {
+    return std::nullopt;
+  }
+  auto const* cdict = findCDict(key);
+  if (not cdict) {
+    return std::nullopt;
+  }
+
+  std::string compressed;
+  compressed.resize(ZSTD_compressBound(value.size()));
+  const auto size = ZSTD_compress_usingCDict(
+      getThreadCCtx(),
+      compressed.data(),
+      compressed.size(),
+      value.data(),
+      value.size(),
+      cdict);
+  if (ZSTD_isError(size)) {
+    LOG(ERROR) << "Failed to compress value of key " << key << ": "
+               << ZSTD_getErrorName(size);
+    return std::nullopt;
+  }
+  if (size >= value.size()) {
+    return std::nullopt;
+  }
+  compressed.resize(size);
+
+  fb303::fbData->addStatValue(
+      "kvstore.value_codec.num_compressed", 1, fb303::COUNT);
+  fb303::fbData->addStatValue(
+      "kvstore.value_codec.bytes_saved", value.size() - size, fb303::SUM);
+  return compressed;
+}
+
+std::optional<std::string>
+KvStoreValueCodec::decompress(std::string const& value) const {
+  // ID is 0 for anything but zstd frame referring to a dictionary
+  const auto dictId = ZSTD_getDictID_fromFrame(value.data(), value.size());
+  if (dictId == 0) {
+    return std::nullopt;
+  }
+  auto it = ddicts_.find(dictId);
+  if (it == ddicts_.end()) {
+    fb303::fbData->addStatValue(
+        "kvstore.value_codec.unknown_dictionary", 1, fb303::COUNT);
+    return std::nullopt;
+  }
+
+  const auto contentSize = ZSTD_getFrameContentSize(value.data(), value.size());
+  if (contentSize == ZSTD_CONTENTSIZE_UNKNOWN or
+      contentSize == ZSTD_CONTENTSIZE_ERROR or
+      contentSize > Constants::kKvStoreValueMaxDecompressedBytes) {
+    fb303::fbData->addStatValue(
+        "kvstore.value_codec.decompress_failure", 1, fb303::COUNT);
+    return std::nullopt;
+  }
+
+  std::string decompressed;
+  decompressed.resize(contentSize);
+  const auto size = ZSTD_decompress_usingDDict(
+      getThreadDCtx(),
+      decompressed.data(),
+      decompressed.size(),
+      value.data(),
+      value.size(),
+      it->second.get());
+  if (ZSTD_isError(size) or size != contentSize) {
+    fb303::fbData->addStatValue(
+        "kvstore.value_codec.decompress_failure", 1, fb303::COUNT);
+    return std::nullopt;
+  }
+  return decompressed;
+}
+
+void
+KvStoreValueCodec::compressValue(
+    std::string const& key, thrift::Value& value) const {
+  if (not value.value_ref().has_value()) {
+    return;
+  }
+  if (auto compressed = compress(key, *value.value_ref())) {
+    value.value_ref() = std::move(*compressed);
+  }
+}
+
+void
+KvStoreValueCodec::decompressValue(thrift::Value& value) const {
+  if (not value.value_ref().has_value()) {
+    return;
+  }
+  if (auto decompressed = decompress(*value.value_ref())) {
+    value.value_ref() = std::move(*decompressed);
+  }
+}
+
+void
+KvStoreValueCodec::decompressKeyVals(thrift::KeyVals& keyVals) const {
+  for (auto& [_, value] : keyVals) {
+    decompressValue(value);
+  }
+}
+
+} // namespace openr
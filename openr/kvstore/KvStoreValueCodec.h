@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <zstd.h>
+
+#include <openr/common/Constants.h>
+#include <openr/config/Config.h>
+#include <openr/if/gen-cpp2/Types_types.h>
+
+namespace openr {
+
+/*
+ * Dictionary based zstd codec for KvStore values.
+ *
+ * Values of keys matching one of the configured key prefixes are compressed
+ * with the dictionary of the longest matching prefix. Compressed values are
+ * plain zstd frames referring to the dictionary by its ID, hence decompression
+ * doesn't need the key and values not compressed by a known dictionary are
+ * passed through as is.
+ *
+ * ATTN: compression is deterministic for the same dictionary and level, i.e.
+ *       the same value always results in the same bytes (and hash).
+ *
+ * Thread-safe. Compression contexts are kept per thread.
+ */
+class KvStoreValueCodec {
+ public:
+  // key prefix -> content of dictionary trained by `zstd --train`
+  explicit KvStoreValueCodec(
+      std::unordered_map<std::string, std::string> const& dictionaries,
+      int compressionLevel = Constants::kKvStoreValueCompressionLevel);
+
+  // create codec with dictionary files of KvStore config. Return nullptr if
+  // value compression is not configured.
+  static std::shared_ptr<const KvStoreValueCodec> createFromConfig(
+      Config const& config);
+
+  // compressed value, std::nullopt if no dictionary applies to the key or
+  // compression doesn't save any bytes
+  std::optional<std::string> compress(
+      std::string const& key, std::string const& value) const;
+
+  // decompressed value, std::nullopt if value is not compressed by a known
+  // dictionary
+  std::optional<std::string> decompress(std::string const& value) const;
+
+  // compress/decompress `value` field of thrift::Value in place. `hash` is
+  // left as is, i.e. it always refers to the value stored in KvStore.
+  void compressValue(std::string const& key, thrift::Value& value) const;
+  void decompressValue(thrift::Value& value) const;
+  void decompressKeyVals(thrift::KeyVals& keyVals) const;
+
+ private:
+  struct CDictDeleter {
+    void
+    operator()(ZSTD_CDict* cdict) const {
+      ZSTD_freeCDict(cdict);
+    }
+  };
+  struct DDictDeleter {
+    void
+    operator()(ZSTD_DDict* ddict) const {
+      ZSTD_freeDDict(ddict);
+    }
+  };
+
+  struct Dictionary {
+    std::string keyPrefix;
+    std::unique_ptr<ZSTD_CDict, CDictDeleter> cdict;
+  };
+
+  // dictionary of the longest key prefix matching the key, nullptr if none
+  ZSTD_CDict const* findCDict(std::string const& key) const;
+
+  std::vector<Dictionary> dictionaries_;
+
+  // dictionary ID -> decompression dictionary
+  std::unordered_map<uint32_t, std::unique_ptr<ZSTD_DDict, DDictDeleter>>
+      ddicts_;
+};
+
+} // namespace openr
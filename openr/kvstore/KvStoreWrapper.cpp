@@ -217,7 +217,7 @@ KvStoreWrapper::recvPublication() {
   if (maybePublication.hasError()) {
     throw std::runtime_error(std::string("recvPublication failed"));
   }
-  return maybePublication.value().tPublication;
+  return *maybePublication.value().tPublication;
 }
 
 void
@@ -230,6 +230,22 @@ KvStoreWrapper::recvKvStoreSyncedSignal() {
   CHECK(maybePublication.value().kvStoreSynced);
 }
 
+size_t
+KvStoreWrapper::recvKvStoreWarmStartedSignal() {
+  size_t numPublications{0};
+  while (true) {
+    auto maybePublication = kvStoreUpdatesQueueReader_.get(); // perform read
+    if (maybePublication.hasError()) {
+      throw std::runtime_error(std::string("recvPublication failed"));
+    }
+    CHECK(not maybePublication.value().kvStoreSynced);
+    if (maybePublication.value().kvStoreWarmStarted) {
+      return numPublications;
+    }
+    ++numPublications;
+  }
+}
+
 KvStoreSyncEvent
 KvStoreWrapper::recvSyncEvent() {
   auto maybeEvent = kvStoreSyncEventsQueueReader_.get(); // perform read
@@ -154,6 +154,12 @@ class KvStoreWrapper {
    */
   void recvKvStoreSyncedSignal();
 
+  /**
+   * API to listen for KvStore warm start signal on PUB queue, skipping
+   * publications of seeded key-vals. Return number of skipped publications.
+   */
+  size_t recvKvStoreWarmStartedSignal();
+
   /*
    * API to read initial sync event from kvStoreSyncEventsQueue
    */
@@ -32,6 +32,8 @@ const std::chrono::seconds kDbSyncInterval(10000);
 const int kSizeOfKey = 32;
 // The byte size of a value
 const int kSizeOfValue = 1024;
+// The byte size of a large value
+const int kSizeOfLargeValue = 64 * 1024;
 
 /**
  * Produce a random string of given length - for value generation
@@ -97,13 +99,16 @@ class KvStoreTestFixture {
 /**
  * Merge update with kvStore:
  * 1. Randomly choose #numOfUpdateKeys keys from kvStore
- * 2. Randomly choose a newValue for each key
+ * 2. Randomly choose a newValue for each key, or reflect the existing value
+ *    back with higher ttlVersion if `isReflected` is set
  * 3. Insert (key, newValue)s into update
  * 4. Merge update with kvStore
  */
 void
 updateKvStore(
     const uint32_t numOfUpdateKeys,
+    const size_t sizeOfValue,
+    const bool isReflected,
     uint64_t& version,
     std::unordered_map<std::string, thrift::Value>& kvStore) {
   auto suspender = folly::BenchmarkSuspender();
@@ -118,14 +123,24 @@ updateKvStore(
     auto kvIt = kvStore.begin();
     std::advance(kvIt, idx);
     auto key = kvIt->first;
-    auto newValue = genRandomStr(kSizeOfValue);
+    if (isReflected) {
+      // same (version, originatorId, value) flooded back by peer
+      auto thriftValue = kvIt->second;
+      thriftValue.ttlVersion_ref() = version;
+      update.emplace(key, std::move(thriftValue));
+      continue;
+    }
+    auto newValue = genRandomStr(sizeOfValue);
     auto thriftValue = createThriftValue(
         version, /* version */
         "kvStore", /* node id */
         newValue,
         3600, /* ttl */
-        0 /* ttl version */,
-        0 /* hash */);
+        0 /* ttl version */);
+    thriftValue.hash_ref() = generateHash(
+        *thriftValue.version_ref(),
+        *thriftValue.originatorId_ref(),
+        thriftValue.value_ref());
 
     update.emplace(
         std::piecewise_construct,
@@ -182,12 +197,17 @@ floodingUpdate(
 
 /**
  * Benchmark for mergeKeyValues():
- * 1. Generate (key, value) pairs, and put them into kvStore
- * 2. Merge update with kvStore
+ * 1. Generate (key, value) pairs of `sizeOfValue` bytes, and put them into
+ *    kvStore
+ * 2. Merge update (new or reflected values) with kvStore
  */
 static void
 BM_KvStoreMergeKeyValues(
-    uint32_t iters, uint32_t numOfKeysInStore, size_t numOfUpdateKeys) {
+    uint32_t iters,
+    uint32_t numOfKeysInStore,
+    size_t numOfUpdateKeys,
+    size_t sizeOfValue,
+    bool isReflected) {
   CHECK_LE(numOfUpdateKeys, numOfKeysInStore);
   auto suspender = folly::BenchmarkSuspender();
   std::unordered_map<std::string, thrift::Value> kvStore;
@@ -196,14 +216,17 @@ BM_KvStoreMergeKeyValues(
   uint64_t version = 1;
   for (uint32_t idx = 0; idx < numOfKeysInStore; idx++) {
     auto key = genRandomStr(kSizeOfKey);
-    auto value = genRandomStr(kSizeOfValue);
+    auto value = genRandomStr(sizeOfValue);
     auto thriftValue = createThriftValue(
         version, /* version */
         "kvStore", /* node id */
         value,
         3600, /* ttl */
-        0 /* ttl version */,
-        0 /* hash */);
+        0 /* ttl version */);
+    thriftValue.hash_ref() = generateHash(
+        *thriftValue.version_ref(),
+        *thriftValue.originatorId_ref(),
+        thriftValue.value_ref());
 
     kvStore.emplace(
         std::piecewise_construct,
@@ -215,7 +238,8 @@ BM_KvStoreMergeKeyValues(
   version++;
   suspender.dismiss(); // Start measuring benchmark time
   for (uint32_t i = 0; i < iters; i++) {
-    updateKvStore(numOfUpdateKeys, version, kvStore);
+    updateKvStore(
+        numOfUpdateKeys, sizeOfValue, isReflected, version, kvStore);
   }
 }
 
@@ -289,13 +313,45 @@ BM_KvStoreFloodingUpdate(uint32_t iters, size_t numOfUpdateKeys) {
 
 // The first integer parameter is number of keyVals already in store
 // The second integer parameter is the number of keyVals for update
-BENCHMARK_NAMED_PARAM(BM_KvStoreMergeKeyValues, 10_10, 10, 10);
-BENCHMARK_NAMED_PARAM(BM_KvStoreMergeKeyValues, 100_10, 100, 10);
-BENCHMARK_NAMED_PARAM(BM_KvStoreMergeKeyValues, 1000_10, 1000, 10);
-BENCHMARK_NAMED_PARAM(BM_KvStoreMergeKeyValues, 10000_10, 10000, 10);
-BENCHMARK_NAMED_PARAM(BM_KvStoreMergeKeyValues, 10000_100, 10000, 100);
-BENCHMARK_NAMED_PARAM(BM_KvStoreMergeKeyValues, 10000_1000, 10000, 1000);
-BENCHMARK_NAMED_PARAM(BM_KvStoreMergeKeyValues, 10000_10000, 10000, 10000);
+// The third integer parameter is the byte size of values
+// The last parameter is whether the update reflects existing values back
+BENCHMARK_NAMED_PARAM(
+    BM_KvStoreMergeKeyValues, 10_10, 10, 10, kSizeOfValue, false);
+BENCHMARK_NAMED_PARAM(
+    BM_KvStoreMergeKeyValues, 100_10, 100, 10, kSizeOfValue, false);
+BENCHMARK_NAMED_PARAM(
+    BM_KvStoreMergeKeyValues, 1000_10, 1000, 10, kSizeOfValue, false);
+BENCHMARK_NAMED_PARAM(
+    BM_KvStoreMergeKeyValues, 10000_10, 10000, 10, kSizeOfValue, false);
+BENCHMARK_NAMED_PARAM(
+    BM_KvStoreMergeKeyValues, 10000_100, 10000, 100, kSizeOfValue, false);
+BENCHMARK_NAMED_PARAM(
+    BM_KvStoreMergeKeyValues, 10000_1000, 10000, 1000, kSizeOfValue, false);
+BENCHMARK_NAMED_PARAM(
+    BM_KvStoreMergeKeyValues, 10000_10000, 10000, 10000, kSizeOfValue, false);
+BENCHMARK_NAMED_PARAM(
+    BM_KvStoreMergeKeyValues, 100_10_64KB, 100, 10, kSizeOfLargeValue, false);
+BENCHMARK_NAMED_PARAM(
+    BM_KvStoreMergeKeyValues,
+    1000_100_64KB,
+    1000,
+    100,
+    kSizeOfLargeValue,
+    false);
+BENCHMARK_NAMED_PARAM(
+    BM_KvStoreMergeKeyValues,
+    100_10_64KB_reflected,
+    100,
+    10,
+    kSizeOfLargeValue,
+    true);
+BENCHMARK_NAMED_PARAM(
+    BM_KvStoreMergeKeyValues,
+    1000_100_64KB_reflected,
+    1000,
+    100,
+    kSizeOfLargeValue,
+    true);
 
 // The parameter is number of keyVals already in store
 BENCHMARK_PARAM(BM_KvStoreDumpAll, 10);
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/FileUtil.h>
+#include <folly/experimental/TestUtil.h>
+#include <folly/init/Init.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <openr/common/Util.h>
+#include <openr/kvstore/KvStoreCapture.h>
+#include <openr/kvstore/KvStoreUtil.h>
+
+using namespace openr;
+
+namespace {
+
+std::vector<thrift::Publication>
+createPublications() {
+  std::vector<thrift::Publication> pubs(3);
+  pubs[0].area_ref() = "area1";
+  pubs[0].keyVals_ref()->emplace(
+      "key1", createThriftValue(1, "node1", std::string("value1")));
+  pubs[1].area_ref() = "area2";
+  pubs[1].expiredKeys_ref()->emplace_back("key2");
+  pubs[2].area_ref() = "area1";
+  pubs[2].keyVals_ref()->emplace(
+      "key1", createThriftValue(2, "node1", std::string("value2")));
+  return pubs;
+}
+
+// write publications 10ms apart into capture and return its content
+std::string
+writeCapture(std::vector<thrift::Publication> const& pubs, bool compress) {
+  folly::test::TemporaryFile file;
+  {
+    KvStoreCaptureWriter writer(file.path().string(), compress);
+    for (size_t i = 0; i < pubs.size(); ++i) {
+      writer.write(pubs[i], std::chrono::microseconds(1000000 + i * 10000));
+    }
+  }
+  std::string data;
+  CHECK(folly::readFile(file.path().string().c_str(), data));
+  return data;
+}
+
+} // namespace
+
+//
+// Captured publications are read back in order with their timestamps, with
+// and without compression. Partially written capture is read up to its last
+// complete record.
+//
+TEST(KvStoreCaptureTest, WriteAndParse) {
+  const auto pubs = createPublications();
+  for (bool compress : {false, true}) {
+    const auto data = writeCapture(pubs, compress);
+    auto captured = parseKvStoreCapture(data);
+    ASSERT_EQ(pubs.size(), captured.size());
+    for (size_t i = 0; i < pubs.size(); ++i) {
+      EXPECT_EQ(pubs[i], captured[i].publication);
+      EXPECT_EQ(
+          std::chrono::microseconds(1000000 + i * 10000),
+          captured[i].timestamp);
+    }
+
+    size_t prevSize{0};
+    for (size_t length = 0; length < data.size(); ++length) {
+      captured =
+          parseKvStoreCapture(folly::StringPiece(data).subpiece(0, length));
+      EXPECT_LT(captured.size(), pubs.size());
+      EXPECT_GE(captured.size(), prevSize);
+      prevSize = captured.size();
+    }
+  }
+}
+
+//
+// Plain publication records are read as captured at time zero
+//
+TEST(KvStoreCaptureTest, ParsePublicationRecords) {
+  const auto pubs = createPublications();
+  std::string records;
+  for (auto const& pub : pubs) {
+    records += serializePublicationRecord(pub);
+  }
+  const auto captured = parseKvStoreCapture(records);
+  ASSERT_EQ(pubs.size(), captured.size());
+  for (size_t i = 0; i < pubs.size(); ++i) {
+    EXPECT_EQ(pubs[i], captured[i].publication);
+    EXPECT_EQ(std::chrono::microseconds(0), captured[i].timestamp);
+  }
+}
+
+//
+// Replay keeps captured spacing divided by speedup, or is back to back
+//
+TEST(KvStoreCaptureTest, Replay) {
+  const auto pubs = createPublications();
+  const auto captured = parseKvStoreCapture(writeCapture(pubs, false));
+
+  EXPECT_EQ(
+      std::chrono::microseconds(10000),
+      getKvStoreReplayDelay(captured[0], captured[1], 1));
+  EXPECT_EQ(
+      std::chrono::microseconds(1000),
+      getKvStoreReplayDelay(captured[0], captured[1], 10));
+  EXPECT_EQ(
+      std::chrono::microseconds(0),
+      getKvStoreReplayDelay(captured[0], captured[1], 0));
+  EXPECT_EQ(
+      std::chrono::microseconds(0),
+      getKvStoreReplayDelay(captured[1], captured[0], 1));
+
+  std::vector<thrift::Publication> replayed;
+  const auto start = std::chrono::steady_clock::now();
+  replayKvStoreCapture(
+      captured, 1, [&replayed](thrift::Publication const& pub) {
+        replayed.emplace_back(pub);
+      });
+  EXPECT_GE(
+      std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+  EXPECT_EQ(pubs, replayed);
+}
+
+int
+main(int argc, char* argv[]) {
+  // Parse command line flags
+  testing::InitGoogleTest(&argc, argv);
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::init(&argc, &argv);
+  google::InstallFailureSignalHandler();
+
+  // Run the tests
+  auto rc = RUN_ALL_TESTS();
+
+  return rc;
+}
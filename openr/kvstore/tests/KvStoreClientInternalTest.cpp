@@ -1422,6 +1422,93 @@ TEST(KvStoreClientInternal, SubscribeKeyFilterApiTest) {
   evbThread.join();
 }
 
+TEST(KvStoreClientInternal, SubscribeKeyPrefixApiTest) {
+  fbzmq::Context context;
+  folly::Baton waitBaton;
+  const std::string nodeId{"test_store"};
+
+  // Initialize and start KvStore with empty peer
+  auto config = std::make_shared<Config>(getBasicOpenrConfig(nodeId));
+  auto store = std::make_shared<KvStoreWrapper>(context, config);
+  store->run();
+
+  // Create another OpenrEventBase instance for looping clients
+  OpenrEventBase evb;
+  auto client1 = std::make_unique<KvStoreClientInternal>(
+      &evb, nodeId, store->getKvStore());
+
+  auto createKeyVals = [&](std::vector<std::string> const& keys) {
+    std::vector<std::pair<std::string, thrift::Value>> keyVals;
+    for (auto const& key : keys) {
+      keyVals.emplace_back(
+          key, createThriftValue(1, nodeId, std::string("value")));
+    }
+    return keyVals;
+  };
+
+  std::vector<size_t> adjBatches;
+  std::vector<size_t> adjKeyBatches;
+  evb.scheduleTimeout(std::chrono::milliseconds(0), [&]() noexcept {
+    client1->subscribeKeyPrefix(
+        kTestingAreaName,
+        "adj:",
+        [&](KvStoreClientInternal::KeyValUpdates const& keyVals) noexcept {
+          for (auto const& [key, _] : keyVals) {
+            EXPECT_THAT(key, testing::StartsWith("adj:"));
+          }
+          adjBatches.emplace_back(keyVals.size());
+        });
+    client1->subscribeKeyPrefix(
+        kTestingAreaName,
+        "adj:node1",
+        [&](KvStoreClientInternal::KeyValUpdates const& keyVals) noexcept {
+          adjKeyBatches.emplace_back(keyVals.size());
+        });
+    EXPECT_EQ(2, client1->getKeyPrefixCallbackCount());
+
+    // all matching keys of publication are delivered at once
+    store->setKeys(
+        kTestingAreaName,
+        createKeyVals({"adj:node1", "adj:node2", "prefix:node1"}));
+  });
+
+  evb.scheduleTimeout(std::chrono::milliseconds(50), [&]() noexcept {
+    client1->unsubscribeKeyPrefix(kTestingAreaName, "adj:");
+    EXPECT_EQ(1, client1->getKeyPrefixCallbackCount());
+    store->setKeys(kTestingAreaName, createKeyVals({"adj:node1_2", "adj:n3"}));
+  });
+
+  evb.scheduleTimeout(std::chrono::milliseconds(100), [&]() noexcept {
+    client1->unsubscribeKeyPrefix(kTestingAreaName, "adj:node1");
+    EXPECT_EQ(0, client1->getKeyPrefixCallbackCount());
+    store->setKeys(kTestingAreaName, createKeyVals({"adj:node1_3"}));
+  });
+
+  evb.scheduleTimeout(std::chrono::milliseconds(150), [&]() noexcept {
+    // Synchronization primitive
+    waitBaton.post();
+  });
+
+  // Start the event loop
+  std::thread evbThread([&]() { evb.run(); });
+  evb.waitUntilRunning();
+
+  // Synchronization primitive
+  waitBaton.wait();
+
+  EXPECT_EQ(std::vector<size_t>({2}), adjBatches);
+  EXPECT_EQ(std::vector<size_t>({1, 1}), adjKeyBatches);
+
+  // Stop server
+  LOG(INFO) << "Stopping store";
+  store->stop();
+  client1.reset();
+
+  evb.stop();
+  evb.waitUntilStopped();
+  evbThread.join();
+}
+
 /*
  * area related tests for KvStoreClientInternal. Things to test:
  * - Flooding is contained within area - basic verification
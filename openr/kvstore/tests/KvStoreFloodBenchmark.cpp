@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <sys/resource.h>
+
+#include <folly/Benchmark.h>
+#include <folly/Format.h>
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+
+#include <fb303/ServiceData.h>
+#include <fbzmq/zmq/Zmq.h>
+
+#include <openr/common/Types.h>
+#include <openr/common/Util.h>
+#include <openr/config/Config.h>
+#include <openr/config/tests/Utils.h>
+#include <openr/kvstore/KvStoreWrapper.h>
+
+namespace fb303 = facebook::fb303;
+
+namespace {
+
+// interval for periodic syncs, large enough to never kick in
+const std::chrono::seconds kDbSyncInterval(10000);
+
+// The byte size of a key
+const int kSizeOfKey = 32;
+// The byte size of a value
+const int kSizeOfValue = 1024;
+
+// Number of spines in Clos topology. Remaining stores are leaves.
+const uint32_t kNumClosSpines = 4;
+
+enum class Topology {
+  RING = 0,
+  FULL_MESH = 1,
+  CLOS = 2,
+};
+
+/**
+ * Produce a random string of given length - for key/value generation
+ */
+std::string
+genRandomStr(const int len) {
+  std::string s;
+  s.resize(len);
+
+  static const std::string alphanum =
+      "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+
+  for (int i = 0; i < len; ++i) {
+    s[i] = alphanum[folly::Random::rand32() % alphanum.size()];
+  }
+  return s;
+}
+
+/**
+ * Undirected edges of the topology over stores [0, numOfStores). For Clos,
+ * the first `kNumClosSpines` stores are spines connected to every leaf.
+ */
+std::vector<std::pair<uint32_t, uint32_t>>
+getEdges(Topology topology, uint32_t numOfStores) {
+  std::vector<std::pair<uint32_t, uint32_t>> edges;
+  switch (topology) {
+  case Topology::RING: {
+    for (uint32_t i = 0; i < numOfStores; ++i) {
+      edges.emplace_back(i, (i + 1) % numOfStores);
+    }
+    break;
+  }
+  case Topology::FULL_MESH: {
+    for (uint32_t i = 0; i < numOfStores; ++i) {
+      for (uint32_t j = i + 1; j < numOfStores; ++j) {
+        edges.emplace_back(i, j);
+      }
+    }
+    break;
+  }
+  case Topology::CLOS: {
+    CHECK_GT(numOfStores, kNumClosSpines);
+    for (uint32_t spine = 0; spine < kNumClosSpines; ++spine) {
+      for (uint32_t leaf = kNumClosSpines; leaf < numOfStores; ++leaf) {
+        edges.emplace_back(spine, leaf);
+      }
+    }
+    break;
+  }
+  }
+  return edges;
+}
+
+// all-time sum of fb303 counter shared by every store in this process
+int64_t
+getCounterSum(std::string const& key) {
+  auto counters = fb303::fbData->getCounters();
+  auto it = counters.find(key);
+  return it == counters.end() ? 0 : it->second;
+}
+
+// CPU time (user + system) consumed by this process
+std::chrono::microseconds
+getProcessCpuTime() {
+  struct rusage usage;
+  CHECK_EQ(0, getrusage(RUSAGE_SELF, &usage));
+  auto toUs = [](struct timeval const& tv) {
+    return std::chrono::seconds(tv.tv_sec) +
+        std::chrono::microseconds(tv.tv_usec);
+  };
+  return toUs(usage.ru_utime) + toUs(usage.ru_stime);
+}
+} // namespace
+
+namespace openr {
+
+/**
+ * Fixture running stores peered with each other over thrift as per topology
+ */
+class KvStoreFloodFixture {
+ public:
+  KvStoreFloodFixture(Topology topology, uint32_t numOfStores) {
+    for (uint32_t i = 0; i < numOfStores; ++i) {
+      auto tConfig = getBasicOpenrConfig(fmt::format("store{}", i));
+      tConfig.kvstore_config_ref()->sync_interval_s_ref() =
+          kDbSyncInterval.count();
+      tConfig.kvstore_config_ref()->enable_thrift_dual_msg_ref() = false;
+      auto config = std::make_shared<Config>(tConfig);
+      stores_.emplace_back(std::make_unique<KvStoreWrapper>(context_, config));
+      stores_.back()->run();
+    }
+
+    for (auto const& [i, j] : getEdges(topology, numOfStores)) {
+      auto& store1 = stores_.at(i);
+      auto& store2 = stores_.at(j);
+      CHECK(store1->addPeer(
+          kTestingAreaName, store2->getNodeId(), store2->getPeerSpec()));
+      CHECK(store2->addPeer(
+          kTestingAreaName, store1->getNodeId(), store1->getPeerSpec()));
+    }
+    for (auto& store : stores_) {
+      store->recvKvStoreSyncedSignal();
+    }
+  }
+
+  ~KvStoreFloodFixture() {
+    for (auto& store : stores_) {
+      store->stop();
+    }
+  }
+
+  KvStoreWrapper*
+  getStore(uint32_t idx) {
+    return stores_.at(idx).get();
+  }
+
+  size_t
+  size() const {
+    return stores_.size();
+  }
+
+ private:
+  fbzmq::Context context_;
+
+  std::vector<std::unique_ptr<KvStoreWrapper>> stores_;
+};
+
+/**
+ * Block until store published every key of the burst
+ */
+void
+waitForKeys(KvStoreWrapper* store, std::vector<std::string> const& keys) {
+  std::unordered_set<std::string> pendingKeys(keys.begin(), keys.end());
+  while (not pendingKeys.empty()) {
+    auto pub = store->recvPublication();
+    for (auto const& [key, _] : *pub.keyVals_ref()) {
+      pendingKeys.erase(key);
+    }
+  }
+}
+
+/**
+ * Benchmark for flooding a burst of key updates across the topology:
+ * 1. Start stores and peer them with each other as per topology
+ * 2. Inject burst of #numOfUpdateKeys keys into the last (edge) store
+ * 3. Benchmark the time till every store has received the burst
+ *
+ * Counters are averaged per burst:
+ *  - flood_pub: flooding requests sent among all stores
+ *  - flood_bytes: key-val payload bytes sent among all stores
+ *  - cpu_us_per_store: CPU time of the process divided by number of stores
+ */
+static void
+BM_KvStoreFloodStorm(
+    folly::UserCounters& counters,
+    uint32_t iters,
+    Topology topology,
+    uint32_t numOfStores,
+    uint32_t numOfUpdateKeys) {
+  auto suspender = folly::BenchmarkSuspender();
+  fb303::fbData->resetAllData();
+  auto fixture = std::make_unique<KvStoreFloodFixture>(topology, numOfStores);
+  // inject into a store at the edge of topology, i.e. leaf for Clos
+  auto* origin = fixture->getStore(numOfStores - 1);
+
+  const auto floodPubBefore =
+      getCounterSum("kvstore.thrift.num_flood_pub.count");
+  const auto floodKeyValsBefore =
+      getCounterSum("kvstore.thrift.num_flood_key_vals.sum");
+  std::chrono::microseconds cpuTime{0};
+
+  for (uint32_t i = 0; i < iters; ++i) {
+    std::vector<std::string> keys;
+    std::vector<std::pair<std::string, thrift::Value>> keyVals;
+    keys.reserve(numOfUpdateKeys);
+    keyVals.reserve(numOfUpdateKeys);
+    for (uint32_t idx = 0; idx < numOfUpdateKeys; ++idx) {
+      auto thriftVal = createThriftValue(
+          1 /* version */,
+          origin->getNodeId() /* originatorId */,
+          genRandomStr(kSizeOfValue) /* value */,
+          Constants::kTtlInfinity /* ttl */,
+          0 /* ttl version */,
+          0 /* hash */);
+      thriftVal.hash_ref() = generateHash(
+          *thriftVal.version_ref(),
+          *thriftVal.originatorId_ref(),
+          thriftVal.value_ref());
+      keys.emplace_back(genRandomStr(kSizeOfKey));
+      keyVals.emplace_back(keys.back(), std::move(thriftVal));
+    }
+
+    const auto cpuTimeStart = getProcessCpuTime();
+    suspender.dismiss(); // Start measuring benchmark time
+    origin->setKeys(kTestingAreaName, keyVals);
+    for (size_t idx = 0; idx < fixture->size(); ++idx) {
+      waitForKeys(fixture->getStore(idx), keys);
+    }
+    suspender.rehire(); // Stop measuring time again
+    cpuTime += getProcessCpuTime() - cpuTimeStart;
+  }
+
+  const auto floodKeyVals =
+      getCounterSum("kvstore.thrift.num_flood_key_vals.sum") -
+      floodKeyValsBefore;
+  counters["flood_pub"] =
+      (getCounterSum("kvstore.thrift.num_flood_pub.count") - floodPubBefore) /
+      iters;
+  counters["flood_bytes"] = floodKeyVals * (kSizeOfKey + kSizeOfValue) / iters;
+  counters["cpu_us_per_store"] = cpuTime.count() / iters / numOfStores;
+
+  // store shutdown is not measured
+  fixture.reset();
+}
+
+// The first parameter is the topology
+// The second parameter is the number of stores
+// The third parameter is the number of keys updated per burst
+BENCHMARK_COUNTERS_PARAM(
+    BM_KvStoreFloodStorm, counters, Topology::RING, 8, 100);
+BENCHMARK_COUNTERS_PARAM(
+    BM_KvStoreFloodStorm, counters, Topology::RING, 32, 100);
+BENCHMARK_COUNTERS_PARAM(
+    BM_KvStoreFloodStorm, counters, Topology::RING, 32, 1000);
+BENCHMARK_COUNTERS_PARAM(
+    BM_KvStoreFloodStorm, counters, Topology::FULL_MESH, 8, 100);
+BENCHMARK_COUNTERS_PARAM(
+    BM_KvStoreFloodStorm, counters, Topology::FULL_MESH, 16, 100);
+BENCHMARK_COUNTERS_PARAM(
+    BM_KvStoreFloodStorm, counters, Topology::FULL_MESH, 16, 1000);
+BENCHMARK_COUNTERS_PARAM(
+    BM_KvStoreFloodStorm, counters, Topology::CLOS, 12, 100);
+BENCHMARK_COUNTERS_PARAM(
+    BM_KvStoreFloodStorm, counters, Topology::CLOS, 36, 100);
+BENCHMARK_COUNTERS_PARAM(
+    BM_KvStoreFloodStorm, counters, Topology::CLOS, 36, 1000);
+
+} // namespace openr
+
+int
+main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <set>
+
+#include <fmt/format.h>
+#include <folly/init/Init.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <openr/kvstore/KvStoreMerkleTree.h>
+
+using namespace openr;
+
+namespace {
+const size_t kNumBuckets{64};
+} // namespace
+
+/*
+ * Verify trees with same content generate same digests regardless of the
+ * order in which keys are added.
+ */
+TEST(KvStoreMerkleTreeTest, OrderIndependentDigest) {
+  KvStoreMerkleTree treeA(kNumBuckets);
+  KvStoreMerkleTree treeB(kNumBuckets);
+  KvStoreMerkleTree emptyTree(kNumBuckets);
+
+  for (int i = 0; i < 100; ++i) {
+    treeA.add(fmt::format("key-{}", i), i);
+  }
+  for (int i = 99; i >= 0; --i) {
+    treeB.add(fmt::format("key-{}", i), i);
+  }
+  EXPECT_EQ(treeA.getRootDigest(), treeB.getRootDigest());
+  EXPECT_NE(treeA.getRootDigest(), emptyTree.getRootDigest());
+
+  auto buckets = treeA.getMismatchedBuckets(treeB.toThrift());
+  ASSERT_TRUE(buckets.has_value());
+  EXPECT_TRUE(buckets->empty());
+
+  // remove all keys and expect empty tree
+  for (int i = 0; i < 100; ++i) {
+    treeA.remove(fmt::format("key-{}", i), i);
+  }
+  EXPECT_EQ(emptyTree.getRootDigest(), treeA.getRootDigest());
+}
+
+/*
+ * Verify update of key-hash changes ONLY the bucket holding the key
+ */
+TEST(KvStoreMerkleTreeTest, MismatchedBuckets) {
+  KvStoreMerkleTree treeA(kNumBuckets);
+  KvStoreMerkleTree treeB(kNumBuckets);
+
+  for (int i = 0; i < 100; ++i) {
+    treeA.add(fmt::format("key-{}", i), i);
+    treeB.add(fmt::format("key-{}", i), i);
+  }
+
+  // change hash of one key and add a new one
+  treeB.update("key-7", 7, 1007);
+  treeB.add("key-new", 1);
+
+  auto buckets = treeA.getMismatchedBuckets(treeB.toThrift());
+  ASSERT_TRUE(buckets.has_value());
+
+  std::set<int32_t> expected{
+      static_cast<int32_t>(treeA.getBucket("key-7")),
+      static_cast<int32_t>(treeA.getBucket("key-new"))};
+  EXPECT_EQ(expected, std::set<int32_t>(buckets->begin(), buckets->end()));
+
+  // no-op update
+  treeB.update("key-8", 8, 8);
+  buckets = treeA.getMismatchedBuckets(treeB.toThrift());
+  ASSERT_TRUE(buckets.has_value());
+  EXPECT_EQ(expected.size(), buckets->size());
+
+  // revert changes
+  treeB.update("key-7", 1007, 7);
+  treeB.remove("key-new", 1);
+  EXPECT_EQ(treeA.getRootDigest(), treeB.getRootDigest());
+}
+
+/*
+ * Verify bucket assignment is deterministic and trees with different layout
+ * can't be compared.
+ */
+TEST(KvStoreMerkleTreeTest, IncompatibleLayout) {
+  KvStoreMerkleTree treeA(kNumBuckets);
+  KvStoreMerkleTree treeB(2 * kNumBuckets);
+
+  EXPECT_EQ(
+      treeA.getBucket("adj:node1"),
+      KvStoreMerkleTree::getBucket("adj:node1", kNumBuckets));
+  EXPECT_LT(treeA.getBucket("adj:node1"), kNumBuckets);
+  EXPECT_FALSE(treeA.getMismatchedBuckets(treeB.toThrift()).has_value());
+
+  auto digests = treeA.toThrift();
+  EXPECT_EQ(kNumBuckets, *digests.numBuckets_ref());
+  EXPECT_EQ(2 * kNumBuckets - 1, digests.digests_ref()->size());
+  digests.digests_ref()->pop_back();
+  EXPECT_FALSE(treeA.getMismatchedBuckets(digests).has_value());
+}
+
+int
+main(int argc, char* argv[]) {
+  // Parse command line flags
+  testing::InitGoogleTest(&argc, argv);
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::init(&argc, &argv);
+  google::InstallFailureSignalHandler();
+
+  // Run the tests
+  auto rc = RUN_ALL_TESTS();
+
+  return rc;
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/init/Init.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <openr/kvstore/KvStoreStringPool.h>
+
+using namespace openr;
+
+namespace {
+// longer than SSO capacity to enforce heap allocation
+const std::string kLongKey(64, 'k');
+} // namespace
+
+/*
+ * Verify same string is interned once and shared across handles
+ */
+TEST(KvStoreStringPoolTest, InternShared) {
+  KvStoreStringPool pool;
+  EXPECT_EQ(0, pool.size());
+
+  auto handle1 = pool.intern(kLongKey);
+  auto handle2 = pool.intern(std::string(kLongKey));
+  auto handle3 = pool.intern("node1");
+  EXPECT_EQ(2, pool.size());
+  EXPECT_EQ(handle1.get(), handle2.get());
+  EXPECT_NE(handle1.get(), handle3.get());
+  EXPECT_EQ(kLongKey, *handle1);
+  EXPECT_EQ("node1", *handle3);
+
+  // two handles sharing long string saves its second heap copy
+  EXPECT_GT(pool.getBytesSaved(), 0);
+}
+
+/*
+ * Verify entry is released from pool along with its last handle
+ */
+TEST(KvStoreStringPoolTest, ReleaseOnLastHandle) {
+  KvStoreStringPool pool;
+
+  auto handle1 = pool.intern(kLongKey);
+  auto handle2 = pool.intern(kLongKey);
+  EXPECT_EQ(1, pool.size());
+
+  handle1.reset();
+  EXPECT_EQ(1, pool.size());
+  EXPECT_EQ(kLongKey, *handle2);
+
+  handle2.reset();
+  EXPECT_EQ(0, pool.size());
+
+  // re-intern after release creates fresh entry
+  auto handle3 = pool.intern(kLongKey);
+  EXPECT_EQ(1, pool.size());
+  EXPECT_EQ(kLongKey, *handle3);
+}
+
+int
+main(int argc, char* argv[]) {
+  // Parse command line flags
+  testing::InitGoogleTest(&argc, argv);
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::init(&argc, &argv);
+  google::InstallFailureSignalHandler();
+
+  // Run the tests
+  auto rc = RUN_ALL_TESTS();
+
+  return rc;
+}
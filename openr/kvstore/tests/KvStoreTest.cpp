@@ -16,6 +16,7 @@
 #include <folly/Format.h>
 #include <folly/Memory.h>
 #include <folly/Random.h>
+#include <folly/experimental/TestUtil.h>
 #include <folly/gen/Base.h>
 #include <folly/init/Init.h>
 #include <gtest/gtest.h>
@@ -632,6 +633,94 @@ TEST_F(
   evb.waitUntilStopped();
 }
 
+/**
+ * Validate BatchKeyValueRequest processing. All key-vals of the batch are
+ * persisted (unset) and flooded together.
+ */
+TEST_F(
+    KvStoreSelfOriginatedKeyValueRequestFixture, ProcessBatchKeyValueRequest) {
+  // create and start kv store with kvRequestQueue enabled
+  const std::string nodeId = "node-batch";
+  initKvStore(nodeId);
+
+  const std::string key1 = "batch-key-1";
+  const std::string key2 = "batch-key-2";
+  const std::string value = "batch-value";
+  const std::string unsetValue = "batch-unset-value";
+
+  OpenrEventBase evb;
+  evb.scheduleTimeout(std::chrono::milliseconds(0), [&]() noexcept {
+    // persist two keys in one batch
+    {
+      auto batchKvRequest = BatchKeyValueRequest(kTestingAreaName);
+      batchKvRequest.persistKey(key1, value);
+      batchKvRequest.persistKey(key2, value);
+      EXPECT_EQ(2, batchKvRequest.size());
+      kvRequestQueue_.push(std::move(batchKvRequest));
+
+      auto pub = kvStore_->recvPublication();
+      EXPECT_EQ(2, pub.keyVals_ref()->size());
+      EXPECT_EQ(1, *(pub.keyVals_ref()->at(key1).version_ref()));
+      EXPECT_EQ(1, *(pub.keyVals_ref()->at(key2).version_ref()));
+
+      auto kvStoreCache = kvStore_->dumpAllSelfOriginated(kTestingAreaName);
+      EXPECT_EQ(2, kvStoreCache.size());
+    }
+
+    // unset one of the keys
+    {
+      auto batchKvRequest = BatchKeyValueRequest(kTestingAreaName);
+      batchKvRequest.unsetKey(key1, unsetValue);
+      kvRequestQueue_.push(std::move(batchKvRequest));
+
+      auto pub = kvStore_->recvPublication();
+      EXPECT_EQ(1, pub.keyVals_ref()->size());
+      EXPECT_EQ(2, *(pub.keyVals_ref()->at(key1).version_ref()));
+      EXPECT_EQ(unsetValue, *(pub.keyVals_ref()->at(key1).value_ref()));
+
+      auto kvStoreCache = kvStore_->dumpAllSelfOriginated(kTestingAreaName);
+      EXPECT_EQ(1, kvStoreCache.size());
+      EXPECT_EQ(1, kvStoreCache.count(key2));
+    }
+    evb.stop();
+  });
+
+  // Start the event loop and wait until it is finished execution.
+  evb.run();
+  evb.waitUntilStopped();
+}
+
+/**
+ * Validate key-vals persisted in one batch are TTL refreshed as one cohort,
+ * i.e. ttl updates of all keys are flooded together.
+ */
+TEST_F(
+    KvStoreSelfOriginatedKeyValueRequestFixture,
+    BatchKeyValueTtlRefreshCohort) {
+  const std::string nodeId = "node-cohort";
+  initKvStore(nodeId, kShortTtl);
+
+  std::vector<std::string> keys;
+  auto batchKvRequest = BatchKeyValueRequest(kTestingAreaName);
+  for (int i = 0; i < 10; ++i) {
+    keys.emplace_back(fmt::format("cohort-key-{}", i));
+    batchKvRequest.persistKey(keys.back(), "cohort-value");
+  }
+  kvRequestQueue_.push(std::move(batchKvRequest));
+
+  auto pub = kvStore_->recvPublication();
+  EXPECT_EQ(keys.size(), pub.keyVals_ref()->size());
+
+  // first ttl update covers all keys at once
+  auto ttlPub = kvStore_->recvPublication();
+  ASSERT_EQ(keys.size(), ttlPub.keyVals_ref()->size());
+  for (auto const& key : keys) {
+    auto const& value = ttlPub.keyVals_ref()->at(key);
+    EXPECT_FALSE(value.value_ref().has_value());
+    EXPECT_EQ(1, *value.ttlVersion_ref());
+  }
+}
+
 /**
  * Validate PersistKeyValueRequest version overriding of self-originated key-val
  * if another originator has advertised same key.
@@ -1246,6 +1335,12 @@ TEST_F(KvStoreTestFixture, TtlVerification) {
     EXPECT_EQ(0, publication.keyVals_ref()->size());
     ASSERT_EQ(1, publication.expiredKeys_ref()->size());
     EXPECT_EQ(key, publication.expiredKeys_ref()->at(0));
+    // last value is carried along
+    ASSERT_TRUE(publication.expiredKeyVals_ref().has_value());
+    ASSERT_EQ(1, publication.expiredKeyVals_ref()->count(key));
+    EXPECT_EQ(
+        "dummyValue",
+        publication.expiredKeyVals_ref()->at(key).value_ref().value());
   }
 
   //
@@ -2977,6 +3072,66 @@ TEST_F(KvStoreTestFixture, DumpPrefix) {
       myStore->dumpAll(kTestingAreaName, std::move(kvFilters)));
 }
 
+/**
+ * Verify dumps filtered by originatorIds, served off originator index
+ * - Keys of given originators are dumped, with or without prefix filters
+ * - Index follows value updates changing originator of a key
+ */
+TEST_F(KvStoreTestFixture, DumpOriginator) {
+  auto kvStore = createKvStore("node1");
+  kvStore->run();
+
+  auto setKey = [&](std::string const& key,
+                    int64_t version,
+                    std::string const& originatorId) {
+    kvStore->setKey(
+        kTestingAreaName,
+        key,
+        createThriftValue(
+            version,
+            originatorId,
+            std::string("value"),
+            Constants::kTtlInfinity /* ttl */,
+            0 /* ttl version */,
+            0 /* hash */));
+  };
+  auto dumpKeys = [&](KvStoreFilters filters) {
+    std::set<std::string> keys;
+    for (auto const& [key, _] :
+         kvStore->dumpAll(kTestingAreaName, std::move(filters))) {
+      keys.emplace(key);
+    }
+    return keys;
+  };
+
+  setKey("adj:node-a", 1, "node-a");
+  setKey("prefix:node-a", 1, "node-a");
+  setKey("adj:node-b", 1, "node-b");
+  setKey("prefix:node-b", 1, "node-b");
+  setKey("adj:node-c", 1, "node-c");
+
+  // originatorIds only
+  EXPECT_EQ(
+      std::set<std::string>({"adj:node-a", "prefix:node-a"}),
+      dumpKeys(KvStoreFilters({}, {"node-a"})));
+  EXPECT_EQ(
+      std::set<std::string>({"adj:node-a", "prefix:node-a", "adj:node-c"}),
+      dumpKeys(KvStoreFilters({}, {"node-a", "node-c"})));
+  EXPECT_TRUE(dumpKeys(KvStoreFilters({}, {"node-d"})).empty());
+
+  // OR logic: union of prefix and originator matches, without duplicates
+  EXPECT_EQ(
+      std::set<std::string>({"adj:node-a", "prefix:node-a", "adj:node-b"}),
+      dumpKeys(KvStoreFilters({"adj:node-a", "adj:node-b"}, {"node-a"})));
+
+  // key taken over by another originator moves across index
+  setKey("adj:node-c", 2, "node-a");
+  EXPECT_EQ(
+      std::set<std::string>({"adj:node-a", "prefix:node-a", "adj:node-c"}),
+      dumpKeys(KvStoreFilters({}, {"node-a"})));
+  EXPECT_TRUE(dumpKeys(KvStoreFilters({}, {"node-c"})).empty());
+}
+
 /**
  * Start single testable store, and set key values.
  * Try to request for KEY_DUMP with a few keyValHashes.
@@ -3150,6 +3305,270 @@ TEST_F(KvStoreTestFixture, TtlDecrementValue) {
   }
 }
 
+/**
+ * Test ttl refreshes are flooded as compact ttl updates with
+ * `enable_compact_ttl_flood` on, while value updates are flooded as usual.
+ */
+TEST_F(KvStoreTestFixture, CompactTtlFlood) {
+  auto compactConf = getTestKvConf();
+  compactConf.enable_compact_ttl_flood_ref() = true;
+  auto store0 = createKvStore("store0", compactConf);
+  auto store1 = createKvStore("store1", compactConf);
+  store0->run();
+  store1->run();
+
+  store0->addPeer(kTestingAreaName, store1->getNodeId(), store1->getPeerSpec());
+  store1->addPeer(kTestingAreaName, store0->getNodeId(), store0->getPeerSpec());
+  store0->recvKvStoreSyncedSignal();
+  store1->recvKvStoreSyncedSignal();
+
+  int64_t ttl = 6000;
+  auto thriftVal = createThriftValue(
+      1 /* version */,
+      "utest" /* originatorId */,
+      "value" /* value */,
+      ttl /* ttl */,
+      1 /* ttl version */,
+      0 /* hash */);
+  thriftVal.hash_ref() = generateHash(
+      *thriftVal.version_ref(),
+      *thriftVal.originatorId_ref(),
+      thriftVal.value_ref());
+  EXPECT_TRUE(store1->setKey(kTestingAreaName, "key1", thriftVal));
+  {
+    // value update is flooded with full key-val
+    auto pub = store0->recvPublication();
+    ASSERT_EQ(1, pub.keyVals_ref()->count("key1"));
+    EXPECT_EQ("value", pub.keyVals_ref()->at("key1").value_ref().value());
+  }
+
+  // refresh ttl with ttl-only value
+  auto ttlVal = createThriftValue(
+      1 /* version */,
+      "utest" /* originatorId */,
+      std::nullopt /* value */,
+      ttl /* ttl */,
+      2 /* ttl version */);
+  EXPECT_TRUE(store1->setKey(kTestingAreaName, "key1", ttlVal));
+  {
+    auto pub = store0->recvPublication();
+    ASSERT_EQ(1, pub.keyVals_ref()->count("key1"));
+    auto const& val = pub.keyVals_ref()->at("key1");
+    EXPECT_FALSE(val.value_ref().has_value());
+    EXPECT_EQ(2, *val.ttlVersion_ref());
+    EXPECT_LE(*val.ttl_ref(), ttl);
+    // ATTN: compact updates carry ONLY the sender
+    ASSERT_TRUE(pub.nodeIds_ref().has_value());
+    EXPECT_EQ(store1->getNodeId(), pub.nodeIds_ref()->front());
+  }
+
+  // value is intact with refreshed ttl version
+  auto maybeVal = store0->getKey(kTestingAreaName, "key1");
+  ASSERT_TRUE(maybeVal.has_value());
+  EXPECT_EQ("value", maybeVal->value_ref().value());
+  EXPECT_EQ(2, *maybeVal->ttlVersion_ref());
+  EXPECT_EQ(*thriftVal.hash_ref(), *maybeVal->hash_ref());
+}
+
+/**
+ * Test cold start of a store with `enable_partitioned_initial_sync` on. Key
+ * ranges are fetched from peers in parallel and the store ends up with the
+ * complete keyspace.
+ */
+TEST_F(KvStoreTestFixture, PartitionedInitialSync) {
+  fb303::fbData->resetAllData();
+
+  auto partitionedConf = getTestKvConf();
+  partitionedConf.enable_partitioned_initial_sync_ref() = true;
+  auto store0 = createKvStore("store0", partitionedConf);
+  auto store1 = createKvStore("store1");
+  auto store2 = createKvStore("store2");
+  store0->run();
+  store1->run();
+  store2->run();
+
+  // store1 and store2 hold the same keyspace
+  const int numKeys{100};
+  for (int i = 0; i < numKeys; ++i) {
+    auto thriftVal = createThriftValue(
+        1 /* version */,
+        "utest" /* originatorId */,
+        fmt::format("value{}", i) /* value */,
+        Constants::kTtlInfinity /* ttl */,
+        0 /* ttl version */,
+        0 /* hash */);
+    thriftVal.hash_ref() = generateHash(
+        *thriftVal.version_ref(),
+        *thriftVal.originatorId_ref(),
+        thriftVal.value_ref());
+    const auto key = fmt::format("key{}", i);
+    EXPECT_TRUE(store1->setKey(kTestingAreaName, key, thriftVal));
+    EXPECT_TRUE(store2->setKey(kTestingAreaName, key, thriftVal));
+  }
+
+  thrift::PeersMap peers;
+  peers.emplace(store1->getNodeId(), store1->getPeerSpec());
+  peers.emplace(store2->getNodeId(), store2->getPeerSpec());
+  EXPECT_TRUE(store0->addPeers(kTestingAreaName, peers));
+  store0->recvKvStoreSyncedSignal();
+
+  EXPECT_EQ(numKeys, store0->dumpAll(kTestingAreaName).size());
+  auto counters = fb303::fbData->getCounters();
+  EXPECT_EQ(1, counters.at("kvstore.thrift.num_partitioned_sync.count"));
+}
+
+/**
+ * Test full-sync with `enable_streaming_full_sync` on. Response spanning
+ * multiple chunks is merged and keys missing in peer are sent back.
+ */
+TEST_F(KvStoreTestFixture, StreamingFullSync) {
+  fb303::fbData->resetAllData();
+
+  auto streamingConf = getTestKvConf();
+  streamingConf.enable_streaming_full_sync_ref() = true;
+  auto storeA = createKvStore("storeA", streamingConf);
+  auto storeB = createKvStore("storeB", streamingConf);
+  storeA->run();
+  storeB->run();
+
+  auto createValue = [](std::string const& originatorId, std::string value) {
+    auto thriftVal = createThriftValue(
+        1 /* version */,
+        originatorId,
+        std::move(value),
+        Constants::kTtlInfinity /* ttl */,
+        0 /* ttl version */,
+        0 /* hash */);
+    thriftVal.hash_ref() = generateHash(
+        *thriftVal.version_ref(),
+        *thriftVal.originatorId_ref(),
+        thriftVal.value_ref());
+    return thriftVal;
+  };
+
+  // storeB holds keys spanning multiple chunks
+  const int numKeys{40};
+  const std::string largeValue(64 * 1024, 'b');
+  for (int i = 0; i < numKeys; ++i) {
+    EXPECT_TRUE(storeB->setKey(
+        kTestingAreaName,
+        fmt::format("key{}", i),
+        createValue("storeB", largeValue)));
+  }
+  // storeA holds a key storeB doesn't have
+  EXPECT_TRUE(storeA->setKey(
+      kTestingAreaName, "keyA", createValue("storeA", "a")));
+
+  storeA->addPeer(kTestingAreaName, "storeB", storeB->getPeerSpec());
+  storeA->recvKvStoreSyncedSignal();
+
+  EXPECT_EQ(numKeys + 1, storeA->dumpAll(kTestingAreaName).size());
+  auto counters = fb303::fbData->getCounters();
+  EXPECT_LE(
+      numKeys * largeValue.size() / Constants::kKvStoreFullSyncChunkMaxBytes,
+      counters.at("kvstore.thrift.num_full_sync_chunks.count"));
+
+  // finalized full-sync sends keyA back to storeB
+  OpenrEventBase evb;
+  evb.scheduleTimeout(std::chrono::milliseconds(1000), [&]() noexcept {
+    EXPECT_TRUE(storeB->getKey(kTestingAreaName, "keyA").has_value());
+    evb.stop();
+  });
+  evb.run();
+  evb.waitUntilStopped();
+}
+
+/**
+ * Test re-sync with `enable_incremental_sync` on. Reconnecting peer fetches
+ * only keys updated since last sync.
+ */
+TEST_F(KvStoreTestFixture, IncrementalSync) {
+  fb303::fbData->resetAllData();
+
+  auto incrementalConf = getTestKvConf();
+  incrementalConf.enable_incremental_sync_ref() = true;
+  auto storeA = createKvStore("storeA", incrementalConf);
+  auto storeB = createKvStore("storeB", incrementalConf);
+  storeA->run();
+  storeB->run();
+
+  const auto thriftVal = createThriftValue(
+      1 /* version */,
+      "storeB" /* originatorId */,
+      "value" /* value */,
+      Constants::kTtlInfinity /* ttl */);
+  EXPECT_TRUE(storeB->setKey(kTestingAreaName, "key0", thriftVal));
+
+  // initial full-sync records change-log position of storeB
+  storeA->addPeer(kTestingAreaName, "storeB", storeB->getPeerSpec());
+  storeA->recvKvStoreSyncedSignal();
+  EXPECT_TRUE(storeA->getKey(kTestingAreaName, "key0").has_value());
+
+  // storeB is updated while disconnected
+  EXPECT_TRUE(storeA->delPeer(kTestingAreaName, "storeB"));
+  const int numKeys{10};
+  for (int i = 1; i <= numKeys; ++i) {
+    EXPECT_TRUE(
+        storeB->setKey(kTestingAreaName, fmt::format("key{}", i), thriftVal));
+  }
+
+  storeA->addPeer(kTestingAreaName, "storeB", storeB->getPeerSpec());
+  OpenrEventBase evb;
+  evb.scheduleTimeout(std::chrono::milliseconds(1000), [&]() noexcept {
+    EXPECT_EQ(numKeys + 1, storeA->dumpAll(kTestingAreaName).size());
+    evb.stop();
+  });
+  evb.run();
+  evb.waitUntilStopped();
+
+  auto counters = fb303::fbData->getCounters();
+  EXPECT_EQ(1, counters.at("kvstore.thrift.num_incremental_sync.count"));
+  EXPECT_EQ(
+      1, counters.at("kvstore.thrift.num_incremental_sync_success.count"));
+}
+
+/**
+ * Test warm start with `warm_start_snapshot_path` set. Restarted store is
+ * seeded with key-vals of snapshot written on stop, ttls being adjusted, and
+ * signals warm start after publishing them.
+ */
+TEST_F(KvStoreTestFixture, WarmStartSnapshot) {
+  fb303::fbData->resetAllData();
+
+  folly::test::TemporaryDirectory snapshotDir;
+  auto snapshotConf = getTestKvConf();
+  snapshotConf.warm_start_snapshot_path_ref() =
+      (snapshotDir.path() / "kvstore").string();
+
+  const int64_t ttl{60000};
+  auto store = createKvStore("store", snapshotConf);
+  store->run();
+  EXPECT_TRUE(store->setKey(
+      kTestingAreaName,
+      "key1",
+      createThriftValue(1, "store", "value1", Constants::kTtlInfinity)));
+  EXPECT_TRUE(store->setKey(
+      kTestingAreaName, "key2", createThriftValue(1, "store", "value2", ttl)));
+  // snapshot is written on stop
+  store->stop();
+
+  auto restartedStore = createKvStore("store", snapshotConf);
+  restartedStore->run();
+  EXPECT_LE(1, restartedStore->recvKvStoreWarmStartedSignal());
+  auto val1 = restartedStore->getKey(kTestingAreaName, "key1");
+  ASSERT_TRUE(val1.has_value());
+  EXPECT_EQ("value1", *val1->value_ref());
+  EXPECT_EQ(Constants::kTtlInfinity, *val1->ttl_ref());
+
+  auto val2 = restartedStore->getKey(kTestingAreaName, "key2");
+  ASSERT_TRUE(val2.has_value());
+  EXPECT_EQ("value2", *val2->value_ref());
+  EXPECT_LT(*val2->ttl_ref(), ttl);
+
+  auto counters = fb303::fbData->getCounters();
+  EXPECT_EQ(2, counters.at("kvstore.snapshot.num_seeded_key_vals.sum"));
+}
+
 /**
  * Test kvstore-consistency with flooding rate-limiter enabled
  * linear topology, intentionlly increate db-sync interval from 1s -> 60s so
@@ -3227,6 +3646,57 @@ TEST_F(KvStoreTestFixture, RateLimiterFlood) {
   EXPECT_EQ(expectNumKeys, kv2.size());
 }
 
+/**
+ * Test kvstore-consistency with flood window of a single RPC in flight.
+ * s0 -- s1 (window of 1)
+ * Burst of keys set in s1 is flooded without ever having more than one RPC
+ * in flight to s0, updates buffered meanwhile are merged, and s0 ends up
+ * with all keys.
+ */
+TEST_F(KvStoreTestFixture, FloodWindow) {
+  fb303::fbData->resetAllData();
+
+  auto windowConf = getTestKvConf();
+  windowConf.flood_window_size_ref() = 1;
+  auto store0 = createKvStore("store0");
+  auto store1 = createKvStore("store1", windowConf);
+  store0->run();
+  store1->run();
+
+  store0->addPeer(kTestingAreaName, store1->getNodeId(), store1->getPeerSpec());
+  store1->addPeer(kTestingAreaName, store0->getNodeId(), store0->getPeerSpec());
+
+  // keys below are flooded, not synced
+  waitForAllPeersInitialized();
+
+  const int numKeys{500};
+  for (int i = 0; i < numKeys; ++i) {
+    auto thriftVal = createThriftValue(
+        1 /* version */,
+        "store1" /* originatorId */,
+        "value" /* value */,
+        300000 /* ttl */,
+        1 /* ttl version */,
+        0 /* hash */);
+    thriftVal.hash_ref() = generateHash(
+        *thriftVal.version_ref(),
+        *thriftVal.originatorId_ref(),
+        thriftVal.value_ref());
+    EXPECT_TRUE(
+        store1->setKey(kTestingAreaName, fmt::format("key{}", i), thriftVal));
+  }
+
+  for (int i = 0; i < numKeys; ++i) {
+    waitForKeyInStoreWithTimeout(
+        store0, kTestingAreaName, fmt::format("key{}", i));
+  }
+
+  // only s1 floods, s0 doesn't flood back to the sender
+  auto counters = fb303::fbData->getCounters();
+  EXPECT_LE(counters.at("kvstore.thrift.flood_pub_in_flight.avg"), 1);
+  EXPECT_LE(counters.at("kvstore.thrift.num_flood_pub.count"), numKeys);
+}
+
 TEST_F(KvStoreTestFixture, RateLimiter) {
   fb303::fbData->resetAllData();
 
@@ -3330,6 +3800,13 @@ TEST_F(KvStoreTestFixture, RateLimiter) {
   // +3 as some messages could have been sent after the counter
   EXPECT_LT(s1PubSent2, (duration2 + wait + 3) * messageRate);
 
+  // superseded ttl versions of the same key are coalesced in the per-peer
+  // buffer, which is drained by now
+  EXPECT_GT(allCounters["kvstore.flood_buffer.coalesced_keys.store0.sum"], 0);
+  auto s1Counters = store1->getCounters();
+  ASSERT_EQ(1, s1Counters.count("kvstore.flood_buffer.num_keys.store0"));
+  EXPECT_EQ(0, s1Counters.at("kvstore.flood_buffer.num_keys.store0"));
+
   /**
    * TEST3: similar to TEST2, except instead of key ttl version, new keys
    * are inserted. Some updates will be supressed and merged into a single
@@ -3530,6 +4007,150 @@ TEST_F(KvStoreTestFixture, FullSync) {
   evbThread.join();
 }
 
+/**
+ * Verify 3-way full-sync with merkle digests exchange enabled:
+ * storeA has (k0, 5, a), (k1, 1, a), (k2, 9, a)
+ * storeB has             (k1, 1, a), (k2, 1, b), (k3, 6, b)
+ * Only diverged buckets get synced, and we expect both storeA and storeB have:
+ *           (k0, 5, a), (k1, 1, a), (k2, 9, a), (k3, 6, b)
+ * Then storeC with same content as storeA syncs with storeA, which will be
+ * skipped as merkle digests match.
+ */
+TEST_F(KvStoreTestFixture, MerkleFullSync) {
+  auto kvConf = getTestKvConf();
+  kvConf.enable_merkle_sync_ref() = true;
+  auto storeA = createKvStore("storeA", kvConf);
+  auto storeB = createKvStore("storeB", kvConf);
+  auto storeC = createKvStore("storeC", kvConf);
+  storeA->run();
+  storeB->run();
+  storeC->run();
+
+  const std::string k0{"key0"};
+  const std::string k1{"key1"};
+  const std::string k2{"key2"};
+  const std::string k3{"key3"};
+  std::vector<std::string> allKeys = {k0, k1, k2, k3};
+
+  auto makeValue = [](int version, std::string const& value) {
+    thrift::Value val = createThriftValue(
+        version /* version */,
+        "storeA" /* originatorId */,
+        value /* value */,
+        30000 /* ttl */,
+        99 /* ttl version */,
+        0 /* hash*/
+    );
+    val.hash_ref() = generateHash(
+        *val.version_ref(), *val.originatorId_ref(), val.value_ref());
+    return val;
+  };
+
+  for (const auto& [key, version] :
+       std::vector<std::pair<std::string, int>>{{k0, 5}, {k1, 1}, {k2, 9}}) {
+    EXPECT_TRUE(storeA->setKey(kTestingAreaName, key, makeValue(version, "a")));
+  }
+  EXPECT_TRUE(storeB->setKey(kTestingAreaName, k1, makeValue(1, "a")));
+  EXPECT_TRUE(storeB->setKey(kTestingAreaName, k2, makeValue(1, "b")));
+  EXPECT_TRUE(storeB->setKey(kTestingAreaName, k3, makeValue(6, "b")));
+
+  // let A sends a full sync request to B and wait for completion
+  storeA->addPeer(kTestingAreaName, "storeB", storeB->getPeerSpec());
+  EXPECT_EQ(
+      KvStoreSyncEvent("storeB", kTestingAreaName), storeA->recvSyncEvent());
+
+  // wait for finalized full-sync from A to B
+  // sleep override
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+  for (const auto& key : allKeys) {
+    auto valA = storeA->getKey(kTestingAreaName, key);
+    auto valB = storeB->getKey(kTestingAreaName, key);
+    ASSERT_TRUE(valA.has_value());
+    ASSERT_TRUE(valB.has_value());
+    EXPECT_EQ(valA->value_ref().value(), valB->value_ref().value());
+    EXPECT_EQ(*valA->version_ref(), *valB->version_ref());
+  }
+  EXPECT_EQ(*storeA->getKey(kTestingAreaName, k2)->version_ref(), 9);
+  EXPECT_EQ(*storeA->getKey(kTestingAreaName, k3)->version_ref(), 6);
+
+  // storeC gets identical content as storeA and syncs with it
+  for (const auto& key : allKeys) {
+    EXPECT_TRUE(storeC->setKey(
+        kTestingAreaName, key, *storeA->getKey(kTestingAreaName, key)));
+  }
+  storeC->addPeer(kTestingAreaName, "storeA", storeA->getPeerSpec());
+  EXPECT_EQ(
+      KvStoreSyncEvent("storeA", kTestingAreaName), storeC->recvSyncEvent());
+  EXPECT_EQ(
+      thrift::KvStorePeerState::INITIALIZED,
+      storeC->getPeerState(kTestingAreaName, "storeA").value());
+  for (const auto& key : allKeys) {
+    EXPECT_TRUE(storeC->getKey(kTestingAreaName, key).has_value());
+  }
+}
+
+/*
+ * Verify multi-area KvStore with every KvStoreDb running on its own thread.
+ * Keys are synced and flooded within area and all public APIs are served.
+ *
+ * Topology: StoreA <--(pod-area, plane-area)--> StoreB
+ */
+TEST_F(KvStoreTestFixture, PerAreaThread) {
+  thrift::AreaConfig pod, plane;
+  pod.area_id_ref() = "pod-area";
+  pod.neighbor_regexes_ref()->emplace_back(".*");
+  plane.area_id_ref() = "plane-area";
+  plane.neighbor_regexes_ref()->emplace_back(".*");
+  AreaId podAreaId{pod.get_area_id()};
+  AreaId planeAreaId{plane.get_area_id()};
+
+  auto kvConf = getTestKvConf();
+  kvConf.enable_per_area_thread_ref() = true;
+  auto storeA = createKvStore("storeA", kvConf, {pod, plane});
+  auto storeB = createKvStore("storeB", kvConf, {pod, plane});
+  storeA->run();
+  storeB->run();
+
+  auto makeValue = [](std::string const& value) {
+    auto val = createThriftValue(
+        1 /* version */,
+        "storeA" /* originatorId */,
+        value /* value */,
+        Constants::kTtlInfinity /* ttl */);
+    val.hash_ref() = generateHash(
+        *val.version_ref(), *val.originatorId_ref(), val.value_ref());
+    return val;
+  };
+
+  // key set before peering gets synced via full-sync
+  EXPECT_TRUE(storeA->setKey(podAreaId, "pod-key-0", makeValue("pod")));
+
+  storeA->addPeer(podAreaId, "storeB", storeB->getPeerSpec());
+  storeA->addPeer(planeAreaId, "storeB", storeB->getPeerSpec());
+  storeB->addPeer(podAreaId, "storeA", storeA->getPeerSpec());
+  storeB->addPeer(planeAreaId, "storeA", storeA->getPeerSpec());
+  waitForAllPeersInitialized();
+
+  waitForKeyInStoreWithTimeout(storeB, podAreaId, "pod-key-0");
+  EXPECT_FALSE(storeB->getKey(planeAreaId, "pod-key-0").has_value());
+
+  // key set after peering gets flooded
+  EXPECT_TRUE(storeA->setKey(planeAreaId, "plane-key-0", makeValue("plane")));
+  waitForKeyInStoreWithTimeout(storeB, planeAreaId, "plane-key-0");
+  EXPECT_FALSE(storeB->getKey(podAreaId, "plane-key-0").has_value());
+
+  // multi-area APIs collect state from every area thread
+  auto summaries = storeB->getSummary({pod.get_area_id(), plane.get_area_id()});
+  EXPECT_EQ(2, summaries.size());
+  for (auto const& summary : summaries) {
+    EXPECT_EQ(1, *summary.keyValsCount_ref());
+    EXPECT_EQ(1, summary.peersMap_ref()->size());
+  }
+  EXPECT_EQ(2, storeB->getCounters().at("kvstore.num_keys"));
+  EXPECT_EQ(1, storeB->dumpAll(podAreaId).size());
+}
+
 /*
  * Verify kvStore flooding is containted within an area.
  * Add a key in one area and verify that key is not flooded into the other.
@@ -3759,6 +4380,17 @@ TEST_F(KvStoreTestFixture, KeySyncMultipleArea) {
     EXPECT_EQ(summary.at(0).get_area(), plane.get_area_id());
     EXPECT_EQ(keyVal2Size + keyVal3Size, summary.at(0).get_keyValsBytes());
 
+    // both keys of plane area are originated by storeC and have no key
+    // prefix, hence are accounted for under the empty one
+    auto const& originatorSizes = summary.at(0).get_originatorSizes();
+    ASSERT_EQ(1, originatorSizes.count("storeC"));
+    EXPECT_EQ(2, *originatorSizes.at("storeC").numKeys_ref());
+    EXPECT_EQ(
+        keyVal2Size + keyVal3Size, *originatorSizes.at("storeC").bytes_ref());
+    auto const& keyPrefixSizes = summary.at(0).get_keyPrefixSizes();
+    ASSERT_EQ(1, keyPrefixSizes.count(""));
+    EXPECT_EQ(2, *keyPrefixSizes.at("").numKeys_ref());
+
     summary = storeC->getSummary(areaSetEmpty);
     EXPECT_EQ(1, summary.size());
     EXPECT_EQ(2, summary.at(0).get_keyValsCount());
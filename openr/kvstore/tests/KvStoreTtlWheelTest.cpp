@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <fmt/format.h>
+#include <folly/init/Init.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <openr/kvstore/KvStoreTtlWheel.h>
+
+using namespace openr;
+using namespace std::chrono;
+
+namespace {
+// small wheel to exercise cascading: 3 levels of 4 slots cover 64 ticks
+const milliseconds kTick{1};
+const size_t kSlotsPerLevel{4};
+const size_t kNumLevels{3};
+
+TtlCountdownEntry
+createEntry(
+    KvStoreStringPool& pool,
+    std::string const& key,
+    steady_clock::time_point expiryTime,
+    int64_t ttlVersion = 1) {
+  TtlCountdownEntry entry;
+  entry.expiryTime = expiryTime;
+  entry.key = pool.intern(key);
+  entry.version = 1;
+  entry.ttlVersion = ttlVersion;
+  entry.originatorId = pool.intern("node1");
+  return entry;
+}
+} // namespace
+
+/*
+ * Verify entries expire in order, never before their expiry time, including
+ * ones cascading from upper levels and ones beyond the top level epoch.
+ */
+TEST(KvStoreTtlWheelTest, ExpireInOrder) {
+  KvStoreStringPool pool;
+  const auto start = steady_clock::now();
+  KvStoreTtlWheel wheel(kTick, kSlotsPerLevel, kNumLevels, start);
+  EXPECT_FALSE(wheel.getNextWakeupTime().has_value());
+
+  const std::vector<int> expiryMs{1, 3, 7, 18, 50, 130};
+  for (auto const& ms : expiryMs) {
+    wheel.schedule(createEntry(
+        pool, fmt::format("key-{}", ms), start + milliseconds(ms)));
+  }
+  EXPECT_EQ(expiryMs.size(), wheel.size());
+  EXPECT_GT(wheel.getNumEntries(kNumLevels - 1), 0);
+
+  for (auto const& ms : expiryMs) {
+    // nothing expires right before expiry time
+    EXPECT_TRUE(wheel.expire(start + milliseconds(ms) - microseconds(1))
+                    .empty());
+
+    auto expired = wheel.expire(start + milliseconds(ms));
+    ASSERT_EQ(1, expired.size());
+    EXPECT_EQ(fmt::format("key-{}", ms), *expired.front().key);
+  }
+  EXPECT_TRUE(wheel.empty());
+  EXPECT_EQ(0, wheel.getNumOccupiedSlots());
+  EXPECT_FALSE(wheel.getNextWakeupTime().has_value());
+}
+
+/*
+ * Verify rescheduling of the same key keeps single entry in the wheel
+ */
+TEST(KvStoreTtlWheelTest, RescheduleInPlace) {
+  KvStoreStringPool pool;
+  const auto start = steady_clock::now();
+  KvStoreTtlWheel wheel(kTick, kSlotsPerLevel, kNumLevels, start);
+
+  wheel.schedule(createEntry(pool, "key1", start + 5ms, 1));
+  wheel.schedule(createEntry(pool, "key1", start + 40ms, 2));
+  EXPECT_EQ(1, wheel.size());
+  EXPECT_EQ(1, wheel.getNumOccupiedSlots());
+
+  auto const* entry = wheel.find("key1");
+  ASSERT_NE(nullptr, entry);
+  EXPECT_EQ(2, entry->ttlVersion);
+  EXPECT_EQ(nullptr, wheel.find("key2"));
+
+  // old countdown is gone
+  EXPECT_TRUE(wheel.expire(start + 10ms).empty());
+  auto wakeupTime = wheel.getNextWakeupTime();
+  ASSERT_TRUE(wakeupTime.has_value());
+  EXPECT_LE(*wakeupTime, start + 40ms);
+
+  auto expired = wheel.expire(start + 40ms);
+  ASSERT_EQ(1, expired.size());
+  EXPECT_EQ(2, expired.front().ttlVersion);
+}
+
+/*
+ * Verify erase and already expired entries
+ */
+TEST(KvStoreTtlWheelTest, EraseAndPastExpiry) {
+  KvStoreStringPool pool;
+  const auto start = steady_clock::now();
+  KvStoreTtlWheel wheel(kTick, kSlotsPerLevel, kNumLevels, start);
+
+  wheel.schedule(createEntry(pool, "key1", start + 20ms));
+  wheel.schedule(createEntry(pool, "key2", start + 20ms));
+  EXPECT_TRUE(wheel.erase("key1"));
+  EXPECT_FALSE(wheel.erase("key1"));
+  EXPECT_EQ(1, wheel.size());
+
+  auto expired = wheel.expire(start + 30ms);
+  ASSERT_EQ(1, expired.size());
+  EXPECT_EQ("key2", *expired.front().key);
+
+  // entry with expiry in the past is due on the next tick
+  wheel.schedule(createEntry(pool, "key3", start));
+  auto wakeupTime = wheel.getNextWakeupTime();
+  ASSERT_TRUE(wakeupTime.has_value());
+  EXPECT_EQ(start + 31ms, *wakeupTime);
+  EXPECT_EQ(1, wheel.expire(*wakeupTime).size());
+  EXPECT_TRUE(wheel.empty());
+}
+
+int
+main(int argc, char* argv[]) {
+  // Parse command line flags
+  testing::InitGoogleTest(&argc, argv);
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::init(&argc, &argv);
+  google::InstallFailureSignalHandler();
+
+  // Run the tests
+  auto rc = RUN_ALL_TESTS();
+
+  return rc;
+}
@@ -175,6 +175,30 @@ TEST(KvStoreUtil, mergeKeyValuesTest) {
     EXPECT_EQ(keyVals.size(), 0);
   }
 
+  // update same-sized value with distinct hash
+  {
+    myKvIt->second = thriftValue;
+    myKvIt->second.hash_ref() = 1;
+    newKvIt->second = thriftValue;
+    newKvIt->second.value_ref() = "dummyValuf";
+    newKvIt->second.hash_ref() = 2;
+    auto keyVals = mergeKeyValues(myStore, newStore);
+    EXPECT_EQ(myStore, newStore);
+    EXPECT_EQ(keyVals, newStore);
+  }
+
+  // reflected value with same hash and higher ttlVersion
+  {
+    myKvIt->second = thriftValue;
+    myKvIt->second.hash_ref() = 1;
+    newKvIt->second = thriftValue;
+    newKvIt->second.hash_ref() = 1;
+    (*newKvIt->second.ttlVersion_ref())++;
+    auto keyVals = mergeKeyValues(myStore, newStore);
+    EXPECT_EQ(myStore, newStore);
+    EXPECT_EQ(keyVals, newStore);
+  }
+
   // update ttl only (new value.value() is none)
   {
     myKvIt->second = thriftValue;
@@ -465,6 +489,83 @@ TEST(KvStoreUtil, KvStoreFiltersTest) {
   ASSERT_FALSE(andFilter.keyMatch(node3_key1, node3_val1)); // No match
 }
 
+TEST(KvStoreUtil, KvStoreFiltersLiteralPrefixTest) {
+  const auto value = createThriftValue(1, "node1", "dummyValue");
+
+  // 1. Literal prefixes are pruned and sorted
+  {
+    auto filter = KvStoreFilters({"prefix:", "adj:", "adj:node1"}, {});
+    auto prefixes = filter.getLiteralKeyPrefixes();
+    ASSERT_TRUE(prefixes.has_value());
+    EXPECT_EQ(std::vector<std::string>({"adj:", "prefix:"}), *prefixes);
+
+    EXPECT_TRUE(filter.keyMatch("adj:node1", value));
+    EXPECT_TRUE(filter.keyMatch("adj:", value));
+    EXPECT_TRUE(filter.keyMatch("prefix:node1:[::/0]", value));
+    EXPECT_FALSE(filter.keyMatch("ad", value));
+    EXPECT_FALSE(filter.keyMatch("adjacency", value));
+    EXPECT_FALSE(filter.keyMatch("nodeLabel:1", value));
+    EXPECT_FALSE(filter.keyMatch("aaa", value));
+    EXPECT_FALSE(filter.keyMatch("zzz", value));
+  }
+
+  // 2. Regex disables literal prefix ranges, but matches both
+  {
+    auto filter = KvStoreFilters({"adj:", "prefix:.*:area1"}, {});
+    EXPECT_FALSE(filter.getLiteralKeyPrefixes().has_value());
+    EXPECT_TRUE(filter.keyMatch("adj:node1", value));
+    EXPECT_TRUE(filter.keyMatch("prefix:node1:area1", value));
+    EXPECT_FALSE(filter.keyMatch("prefix:node1:area2", value));
+  }
+
+  // 3. OR logic with originatorIds can match keys out of prefix ranges
+  {
+    auto filter =
+        KvStoreFilters({"adj:"}, {"node1"}, thrift::FilterOperator::OR);
+    EXPECT_FALSE(filter.getLiteralKeyPrefixes().has_value());
+    EXPECT_TRUE(filter.getLiteralKeyPrefixes(true /* matchAll */).has_value());
+    EXPECT_TRUE(filter.keyMatch("prefix:node1", value));
+
+    auto andFilter =
+        KvStoreFilters({"adj:"}, {"node1"}, thrift::FilterOperator::AND);
+    EXPECT_TRUE(andFilter.getLiteralKeyPrefixes().has_value());
+  }
+
+  // 4. No prefix filter to build ranges from
+  {
+    auto filter = KvStoreFilters({}, {"node1"});
+    EXPECT_FALSE(filter.getLiteralKeyPrefixes().has_value());
+  }
+}
+
+//
+// Test publications recorded into a stream are parsed back in order
+//
+TEST(KvStoreUtil, PublicationRecordsTest) {
+  thrift::Publication pub1;
+  pub1.area_ref() = "area1";
+  pub1.keyVals_ref()->emplace(
+      "key1", createThriftValue(1, "node1", std::string("value1")));
+  thrift::Publication pub2;
+  pub2.area_ref() = "area2";
+  pub2.expiredKeys_ref()->emplace_back("key2");
+
+  auto records =
+      serializePublicationRecord(pub1) + serializePublicationRecord(pub2);
+  auto publications = parsePublicationRecords(records);
+  ASSERT_EQ(2, publications.size());
+  EXPECT_EQ(pub1, publications.at(0));
+  EXPECT_EQ(pub2, publications.at(1));
+
+  // partially written last record is ignored
+  for (size_t length = 1; length < records.size(); ++length) {
+    publications = parsePublicationRecords(
+        folly::StringPiece(records).subpiece(0, length));
+    EXPECT_LE(publications.size(), 1);
+  }
+  EXPECT_TRUE(parsePublicationRecords("").empty());
+}
+
 int
 main(int argc, char* argv[]) {
   // Parse command line flags
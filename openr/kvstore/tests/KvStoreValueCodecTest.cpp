@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <fmt/format.h>
+#include <folly/init/Init.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <zdict.h>
+
+#include <openr/common/Util.h>
+#include <openr/kvstore/KvStoreValueCodec.h>
+
+using namespace openr;
+
+namespace {
+const std::string kAdjKey{"adj:node1"};
+
+// repetitive value resembling serialized adjacency database
+std::string
+createSampleValue(int seed) {
+  std::string value;
+  for (int i = 0; i < 8; ++i) {
+    value += fmt::format(
+        "otherNodeName=node{};ifName=po{};metric={};adjLabel={};isOverloaded=0;"
+        "nextHopV6=fe80::{:x};weight=1;",
+        (seed + i) % 97,
+        (seed * i) % 13,
+        10 + i,
+        50000 + seed,
+        seed * 31 + i);
+  }
+  return value;
+}
+
+// train dictionary on sample values with given seed offset
+std::string
+trainDictionary(int seedOffset) {
+  std::string samples;
+  std::vector<size_t> sampleSizes;
+  for (int i = 0; i < 500; ++i) {
+    auto sample = createSampleValue(seedOffset + i);
+    samples += sample;
+    sampleSizes.emplace_back(sample.size());
+  }
+  std::string dictionary(4096, '\0');
+  const auto size = ZDICT_trainFromBuffer(
+      dictionary.data(),
+      dictionary.size(),
+      samples.data(),
+      sampleSizes.data(),
+      sampleSizes.size());
+  CHECK(not ZDICT_isError(size)) << ZDICT_getErrorName(size);
+  dictionary.resize(size);
+  return dictionary;
+}
+} // namespace
+
+/*
+ * Verify values of matching keys are compressed and decompressed back, while
+ * others are left as is
+ */
+TEST(KvStoreValueCodecTest, CompressDecompress) {
+  KvStoreValueCodec codec({{"adj:", trainDictionary(0)}});
+
+  const auto value = createSampleValue(1000);
+  auto compressed = codec.compress(kAdjKey, value);
+  ASSERT_TRUE(compressed.has_value());
+  EXPECT_LT(compressed->size(), value.size());
+  // deterministic output
+  EXPECT_EQ(*compressed, codec.compress(kAdjKey, value));
+
+  auto decompressed = codec.decompress(*compressed);
+  ASSERT_TRUE(decompressed.has_value());
+  EXPECT_EQ(value, *decompressed);
+
+  // no dictionary for key or value too short to compress
+  EXPECT_FALSE(codec.compress("prefix:node1", value).has_value());
+  EXPECT_FALSE(codec.compress(kAdjKey, "short").has_value());
+
+  // plain value is not decompressed
+  EXPECT_FALSE(codec.decompress(value).has_value());
+  EXPECT_FALSE(codec.decompress("").has_value());
+}
+
+/*
+ * Verify values compressed by unknown dictionary are passed through
+ */
+TEST(KvStoreValueCodecTest, UnknownDictionary) {
+  KvStoreValueCodec codec1({{"adj:", trainDictionary(0)}});
+  KvStoreValueCodec codec2({{"adj:", trainDictionary(5000)}});
+
+  auto compressed = codec1.compress(kAdjKey, createSampleValue(1000));
+  ASSERT_TRUE(compressed.has_value());
+  EXPECT_FALSE(codec2.decompress(*compressed).has_value());
+
+  // truncated frame
+  EXPECT_FALSE(
+      codec1.decompress(compressed->substr(0, compressed->size() / 2))
+          .has_value());
+}
+
+/*
+ * Verify in place compression of thrift::Value and invalid dictionary
+ */
+TEST(KvStoreValueCodecTest, ThriftValue) {
+  KvStoreValueCodec codec({{"adj:", trainDictionary(0)}});
+
+  const auto value = createSampleValue(1000);
+  auto thriftValue = createThriftValue(1, "node1", value);
+  codec.compressValue(kAdjKey, thriftValue);
+  EXPECT_NE(value, *thriftValue.value_ref());
+  codec.decompressValue(thriftValue);
+  EXPECT_EQ(value, *thriftValue.value_ref());
+
+  // ttl update is left as is
+  auto ttlValue = createThriftValue(1, "node1", std::nullopt);
+  codec.compressValue(kAdjKey, ttlValue);
+  EXPECT_FALSE(ttlValue.value_ref().has_value());
+
+  thrift::KeyVals keyVals;
+  keyVals.emplace(kAdjKey, thriftValue);
+  codec.compressValue(kAdjKey, keyVals.at(kAdjKey));
+  codec.decompressKeyVals(keyVals);
+  EXPECT_EQ(value, *keyVals.at(kAdjKey).value_ref());
+
+  // raw content without dictionary ID is rejected
+  EXPECT_THROW(
+      KvStoreValueCodec({{"adj:", "raw-content"}}), std::invalid_argument);
+  EXPECT_THROW(
+      KvStoreValueCodec({{"", trainDictionary(0)}}), std::invalid_argument);
+}
+
+int
+main(int argc, char* argv[]) {
+  // Parse command line flags
+  testing::InitGoogleTest(&argc, argv);
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::init(&argc, &argv);
+  google::InstallFailureSignalHandler();
+
+  // Run the tests
+  auto rc = RUN_ALL_TESTS();
+
+  return rc;
+}
@@ -11,12 +11,24 @@
 
 #include <openr/common/OpenrClient.h>
 #include <openr/kvstore/KvStore.h>
+#include <openr/kvstore/KvStoreCapture.h>
 #include <openr/kvstore/KvStoreUtil.h>
 
 DEFINE_string(host, "::1", "Host to connect to");
 DEFINE_int32(port, openr::Constants::kOpenrCtrlPort, "OpenrCtrl server port");
 DEFINE_int32(connect_timeout_ms, 1000, "Connect timeout for client");
 DEFINE_int32(processing_timeout_ms, 5000, "Processing timeout for client");
+DEFINE_string(
+    dump_file,
+    "",
+    "Capture initial dump and updates with their receive time into file for "
+    "replay, e.g. by decision benchmark");
+DEFINE_bool(dump_compress, false, "Compress capture of --dump_file with zstd");
+DEFINE_bool(
+    compress,
+    false,
+    "Ask server to compress initial dump and updates, e.g. when snooping "
+    "across WAN");
 
 int
 main(int argc, char** argv) {
@@ -34,8 +46,25 @@ main(int argc, char** argv) {
           folly::IPAddress(FLAGS_host),
           FLAGS_port,
           std::chrono::milliseconds(FLAGS_connect_timeout_ms),
-          std::chrono::milliseconds(FLAGS_processing_timeout_ms));
+          std::chrono::milliseconds(FLAGS_processing_timeout_ms),
+          folly::AsyncSocket::anyAddress(),
+          std::nullopt /* maybeIpTos */,
+          FLAGS_compress);
   auto response = client->semifuture_subscribeAndGetAreaKvStores({}, {}).get();
+
+  // Capture publications as they are received
+  std::shared_ptr<openr::KvStoreCaptureWriter> captureWriter;
+  if (not FLAGS_dump_file.empty()) {
+    captureWriter = std::make_shared<openr::KvStoreCaptureWriter>(
+        FLAGS_dump_file, FLAGS_dump_compress);
+  }
+  auto recordPublication =
+      [captureWriter](openr::thrift::Publication const& pub) {
+        if (captureWriter) {
+          captureWriter->write(pub);
+        }
+      };
+
   std::unordered_map<
       std::string /* area */,
       std::unordered_map<std::string /* key */, openr::thrift::Value>>
@@ -45,6 +74,7 @@ main(int argc, char** argv) {
     LOG(INFO) << "Received " << pub.get_keyVals().size()
               << " entries in initial dump for area: " << pub.get_area();
     areaKeyVals[pub.get_area()] = pub.get_keyVals();
+    recordPublication(pub);
   }
   LOG(INFO) << "";
 
@@ -52,13 +82,14 @@ main(int argc, char** argv) {
       std::move(response.stream)
           .subscribeExTry(
               folly::Executor::getKeepAliveToken(&evb),
-              [areaKeyVals = std::move(areaKeyVals)](
+              [areaKeyVals = std::move(areaKeyVals), recordPublication](
                   folly::Try<openr::thrift::Publication>&& maybePub) mutable {
                 if (maybePub.hasException()) {
                   LOG(ERROR) << maybePub.exception().what();
                   return;
                 }
                 auto& pub = maybePub.value();
+                recordPublication(pub);
                 // Print expired key-vals
                 for (const auto& key : *pub.expiredKeys_ref()) {
                   std::cout << "Expired Key: " << key << std::endl;
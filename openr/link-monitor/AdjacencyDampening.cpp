@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "AdjacencyDampening.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glog/logging.h>
+
+namespace openr {
+
+AdjacencyDampening::AdjacencyDampening(
+    thrift::AdjacencyDampeningConfig const& config)
+    : config_(config), lastUpdate_(Clock::now()) {
+  CHECK_GT(*config_.half_life_s_ref(), 0);
+  CHECK_LT(*config_.reuse_threshold_ref(), *config_.suppress_threshold_ref());
+}
+
+void
+AdjacencyDampening::reportFlap(Clock::time_point now) {
+  addPenalty(*config_.flap_penalty_ref(), now);
+}
+
+void
+AdjacencyDampening::reportMetricChange(Clock::time_point now) {
+  addPenalty(*config_.metric_change_penalty_ref(), now);
+}
+
+double
+AdjacencyDampening::getPenalty(Clock::time_point now) const {
+  if (now <= lastUpdate_) {
+    return penalty_;
+  }
+  const std::chrono::duration<double> elapsed = now - lastUpdate_;
+  return penalty_ * std::exp2(-elapsed.count() / *config_.half_life_s_ref());
+}
+
+bool
+AdjacencyDampening::isSuppressed(Clock::time_point now) const {
+  return suppressed_ and getPenalty(now) >= *config_.reuse_threshold_ref();
+}
+
+std::chrono::milliseconds
+AdjacencyDampening::getReuseDuration(Clock::time_point now) const {
+  if (not isSuppressed(now)) {
+    return std::chrono::milliseconds(0);
+  }
+  const auto penalty = getPenalty(now);
+  const auto reuseThreshold = *config_.reuse_threshold_ref();
+  // penalty * 2^(-t / halfLife) = reuseThreshold
+  const double reuseS =
+      *config_.half_life_s_ref() * std::log2(penalty / reuseThreshold);
+  // round up so that penalty has decayed below threshold on expiry
+  return std::chrono::milliseconds(
+      static_cast<int64_t>(std::ceil(reuseS * 1000)) + 1);
+}
+
+bool
+AdjacencyDampening::isIdle(Clock::time_point now) const {
+  return not isSuppressed(now) and getPenalty(now) < 1;
+}
+
+void
+AdjacencyDampening::addPenalty(int32_t penalty, Clock::time_point now) {
+  suppressed_ = isSuppressed(now);
+  penalty_ = std::min<double>(
+      getPenalty(now) + penalty, *config_.max_penalty_ref());
+  lastUpdate_ = std::max(lastUpdate_, now);
+  ++numEvents_;
+  if (penalty_ > *config_.suppress_threshold_ref()) {
+    suppressed_ = true;
+  }
+}
+
+} // namespace openr
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <optional>
+
+#include <openr/if/gen-cpp2/OpenrConfig_types.h>
+
+namespace openr {
+
+/**
+ * Flap dampening state of a single adjacency, in the spirit of BGP route flap
+ * dampening (RFC 2439). Penalty is added on every reported flap or metric
+ * change and decays exponentially with configured half life.
+ *
+ * - Adjacency gets suppressed once penalty exceeds the suppress threshold
+ * - Suppressed adjacency is reused once penalty decays below reuse threshold
+ *
+ * Time is passed in explicitly so that state can be evaluated lazily.
+ */
+class AdjacencyDampening final {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit AdjacencyDampening(thrift::AdjacencyDampeningConfig const& config);
+
+  // Penalize adjacency going down
+  void reportFlap(Clock::time_point now = Clock::now());
+
+  // Penalize change of adjacency metric
+  void reportMetricChange(Clock::time_point now = Clock::now());
+
+  // Penalty decayed till `now`
+  double getPenalty(Clock::time_point now = Clock::now()) const;
+
+  // Is adjacency suppressed. Suppression ends once penalty has decayed below
+  // reuse threshold
+  bool isSuppressed(Clock::time_point now = Clock::now()) const;
+
+  // Time until a suppressed adjacency can be reused. Zero if not suppressed
+  std::chrono::milliseconds getReuseDuration(
+      Clock::time_point now = Clock::now()) const;
+
+  // State carries no history anymore and can be discarded
+  bool isIdle(Clock::time_point now = Clock::now()) const;
+
+  // Number of penalized events since state is created
+  int64_t
+  getNumEvents() const {
+    return numEvents_;
+  }
+
+  // Metric advertised for this adjacency before it got suppressed. Frozen
+  // while adjacency is suppressed, unset if adjacency is not advertised.
+  std::optional<int32_t> advertisedMetric;
+
+ private:
+  void addPenalty(int32_t penalty, Clock::time_point now);
+
+  thrift::AdjacencyDampeningConfig const config_;
+
+  // Penalty as of `lastUpdate_`
+  double penalty_{0};
+  Clock::time_point lastUpdate_;
+
+  // Penalty has exceeded suppress threshold and not yet decayed below reuse
+  // threshold as of `lastUpdate_`
+  bool suppressed_{false};
+  int64_t numEvents_{0};
+};
+
+} // namespace openr
@@ -5,6 +5,8 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
+
 #include <fb303/ServiceData.h>
 #include <folly/futures/Future.h>
 
@@ -35,6 +37,17 @@ getRttMetric(int64_t rttUs) {
   return std::max((int)(rttUs / 100), (int)1);
 }
 
+/**
+ * Round metric to nearest multiple of quantum. Metric can never be zero.
+ */
+int32_t
+quantizeMetric(int32_t metric, int32_t quantum) {
+  if (quantum <= 1) {
+    return metric;
+  }
+  return std::max((metric + quantum / 2) / quantum * quantum, quantum);
+}
+
 void
 printLinkMonitorState(openr::thrift::LinkMonitorState const& state) {
   VLOG(1) << "LinkMonitor state .... ";
@@ -67,7 +80,7 @@ LinkMonitor::LinkMonitor(
     fbnl::NetlinkProtocolSocket* nlSock,
     KvStore* kvStore,
     PersistentStore* configStore,
-    messaging::ReplicateQueue<InterfaceDatabase>& interfaceUpdatesQueue,
+    messaging::ReplicateQueue<InterfaceUpdate>& interfaceUpdatesQueue,
     messaging::ReplicateQueue<PrefixEvent>& prefixUpdatesQueue,
     messaging::ReplicateQueue<PeerEvent>& peerUpdatesQueue,
     messaging::ReplicateQueue<LogSample>& logSampleQueue,
@@ -94,6 +107,11 @@ LinkMonitor::LinkMonitor(
       areas_(config->getAreas()),
       enableKvStoreRequestQueue_(
           config->getConfig().get_enable_kvstore_request_queue()),
+      enablePerAdjacencyKeys_(
+          config->getLinkMonitorConfig().get_enable_per_adjacency_keys()),
+      adjDampeningConfig_(config->getLinkMonitorConfig()
+                              .adjacency_dampening_config_ref()
+                              .to_optional()),
       interfaceUpdatesQueue_(interfaceUpdatesQueue),
       prefixUpdatesQueue_(prefixUpdatesQueue),
       peerUpdatesQueue_(peerUpdatesQueue),
@@ -116,10 +134,23 @@ LinkMonitor::LinkMonitor(
   // Schedule callback to advertise the initial set of adjacencies and prefixes
   adjHoldTimer_ = folly::AsyncTimeout::make(*getEvb(), [this]() noexcept {
     LOG(INFO) << "Hold time expired. Advertising adjacencies and addresses";
+    addStartupPerfEvent("ADJ_HOLD_TIMER_EXPIRED");
     // Advertise adjacencies and addresses after hold-timeout
     advertiseAdjacencies();
     advertiseRedistAddrs();
+    startupPerfEvents_.reset();
   });
+  if (enablePerfMeasurement_) {
+    startupPerfEvents_ = thrift::PerfEvents();
+    addStartupPerfEvent("LINK_MONITOR_STARTED");
+  }
+
+  // Re-advertise adjacencies once suppressed ones decay to reuse threshold
+  adjDampeningReuseTimer_ =
+      folly::AsyncTimeout::make(*getEvb(), [this]() noexcept {
+        advertiseAdjacencies();
+        scheduleAdjDampeningReuse();
+      });
 
   // Create throttled adjacency advertiser
   advertiseAdjacenciesThrottled_ = std::make_unique<AsyncThrottle>(
@@ -327,12 +358,16 @@ LinkMonitor::neighborUpEvent(const thrift::SparkNeighbor& info) {
       std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch())
           .count();
 
+  const int32_t metricQuantum = adjDampeningConfig_
+      ? *adjDampeningConfig_->metric_quantum_ref()
+      : 1;
   thrift::Adjacency newAdj = createThriftAdjacency(
       remoteNodeName /* neighbor node name */,
       localIfName /* local ifName neighbor discovered on */,
       toString(neighborAddrV6) /* nextHopV6 */,
       toString(neighborAddrV4) /* nextHopV4 */,
-      useRttMetric_ ? getRttMetric(rttUs) : 1 /* metric */,
+      useRttMetric_ ? quantizeMetric(getRttMetric(rttUs), metricQuantum)
+                    : 1 /* metric */,
       enableSegmentRouting_ ? *info.label_ref() : 0 /* adjacency-label */,
       false /* overload bit */,
       useRttMetric_ ? rttUs : 0 /* rtt */,
@@ -424,11 +459,18 @@ LinkMonitor::neighborDownEvent(const thrift::SparkNeighbor& info) {
   // update KvStore Peer
   updateKvStorePeerNeighborDown(area, adjId, adjValueIt->second);
 
-  // remove such adjacencies
-  adjacencies_.erase(adjValueIt);
+  // Down event is always advertised. Penalty decides whether adjacency is
+  // advertised again when it comes back up.
+  if (adjDampeningConfig_) {
+    auto& dampening = getAdjDampening(adjId);
+    dampening.reportFlap();
+    dampening.advertisedMetric.reset();
+    scheduleAdjDampeningReuse();
+  }
 
-  // advertise adjacencies
-  advertiseAdjacencies(area);
+  // remove such adjacencies. Caller advertises adjacencies of the area once
+  // the whole batch of neighbor events is processed
+  adjacencies_.erase(adjValueIt);
 }
 
 void
@@ -464,16 +506,35 @@ LinkMonitor::neighborRttChangeEvent(const thrift::SparkNeighbor& info) {
   const auto& rttUs = *info.rttUs_ref();
   int32_t newRttMetric = getRttMetric(rttUs);
 
+  auto it = adjacencies_.find({remoteNodeName, localIfName});
+  if (it == adjacencies_.end()) {
+    return;
+  }
+  auto& adj = it->second.adjacency;
+  adj.rtt_ref() = rttUs;
+
+  if (adjDampeningConfig_) {
+    // RTT jitter within metric quantum is neither penalized nor advertised
+    newRttMetric = quantizeMetric(
+        newRttMetric, *adjDampeningConfig_->metric_quantum_ref());
+    if (newRttMetric == *adj.metric_ref()) {
+      return;
+    }
+    // Adjacency without penalty history is advertised with current metric
+    const bool hasHistory = adjDampening_.count(it->first) > 0;
+    auto& dampening = getAdjDampening(it->first);
+    if (not hasHistory) {
+      dampening.advertisedMetric = *adj.metric_ref();
+    }
+    dampening.reportMetricChange();
+    scheduleAdjDampeningReuse();
+  }
+
   VLOG(1) << "Metric value changed for neighbor " << remoteNodeName
           << " on interface: " << localIfName << " to " << newRttMetric;
 
-  auto it = adjacencies_.find({remoteNodeName, localIfName});
-  if (it != adjacencies_.end()) {
-    auto& adj = it->second.adjacency;
-    adj.metric_ref() = newRttMetric;
-    adj.rtt_ref() = rttUs;
-    advertiseAdjacenciesThrottled_->operator()();
-  }
+  adj.metric_ref() = newRttMetric;
+  advertiseAdjacenciesThrottled_->operator()();
 }
 
 void
@@ -654,19 +715,32 @@ LinkMonitor::advertiseAdjacencies(const std::string& area) {
   // Extract information from `adjacencies_`
   auto adjDb = buildAdjacencyDatabase(area);
 
+  // First advertisement after startup carries the startup phases
+  if (startupPerfEvents_.has_value() and adjDb.perfEvents_ref().has_value()) {
+    auto perfEvents = *startupPerfEvents_;
+    for (auto& event : *adjDb.perfEvents_ref()->events_ref()) {
+      perfEvents.events_ref()->emplace_back(std::move(event));
+    }
+    adjDb.perfEvents_ref() = std::move(perfEvents);
+  }
+
   LOG(INFO) << "Updating adjacency database in KvStore with "
             << adjDb.adjacencies_ref()->size() << " entries in area: " << area;
 
-  // Persist `adj:node_Id` key into KvStore
-  const auto keyName = Constants::kAdjDbMarker.toString() + nodeId_;
-  std::string adjDbStr = writeThriftObjStr(adjDb, serializer_);
-  if (enableKvStoreRequestQueue_) {
-    auto persistAdjacencyKeyVal =
-        PersistKeyValueRequest(AreaId{area}, keyName, adjDbStr);
-    kvRequestQueue_.push(std::move(persistAdjacencyKeyVal));
+  if (enablePerAdjacencyKeys_) {
+    advertiseAdjacencyKeys(area, adjDb);
   } else {
-    kvStoreClient_->persistKey(
-        AreaId{area}, keyName, adjDbStr, ttlKeyInKvStore_);
+    // Persist `adj:node_Id` key into KvStore
+    const auto keyName = Constants::kAdjDbMarker.toString() + nodeId_;
+    std::string adjDbStr = writeThriftObjStrBuffered(adjDb, serializer_);
+    if (enableKvStoreRequestQueue_) {
+      auto persistAdjacencyKeyVal =
+          PersistKeyValueRequest(AreaId{area}, keyName, adjDbStr);
+      kvRequestQueue_.push(std::move(persistAdjacencyKeyVal));
+    } else {
+      kvStoreClient_->persistKey(
+          AreaId{area}, keyName, adjDbStr, ttlKeyInKvStore_);
+    }
   }
 
   // Config is most likely to have changed. Update it in `ConfigStore`
@@ -682,6 +756,65 @@ LinkMonitor::advertiseAdjacencies(const std::string& area) {
         "link_monitor.metric." + *adj.otherNodeName_ref(), *adj.metric_ref());
   }
 }
+void
+LinkMonitor::advertiseAdjacencyKeys(
+    const std::string& area, thrift::AdjacencyDatabase const& adjDb) {
+  auto& advertisedKeys = advertisedAdjacencyKeys_[area];
+
+  // node attributes, shared by the database of every adjacency
+  auto nodeDb = folly::copy(adjDb);
+  nodeDb.adjacencies_ref()->clear();
+  nodeDb.perfEvents_ref().reset();
+
+  std::unordered_map<std::string, std::string> newKeys;
+  size_t numChangedKeys{0};
+  for (auto const& adj : *adjDb.adjacencies_ref()) {
+    auto singleAdjDb = folly::copy(nodeDb);
+    singleAdjDb.adjacencies_ref()->emplace_back(adj);
+    auto key =
+        getAdjacencyKey(nodeId_, *adj.otherNodeName_ref(), *adj.ifName_ref());
+    auto value = writeThriftObjStrBuffered(singleAdjDb, serializer_);
+
+    auto it = advertisedKeys.find(key);
+    if (it == advertisedKeys.end() or it->second != value) {
+      ++numChangedKeys;
+      if (adjDb.perfEvents_ref().has_value()) {
+        singleAdjDb.perfEvents_ref() = *adjDb.perfEvents_ref();
+      }
+      auto adjDbStr = writeThriftObjStrBuffered(singleAdjDb, serializer_);
+      if (enableKvStoreRequestQueue_) {
+        kvRequestQueue_.push(
+            PersistKeyValueRequest(AreaId{area}, key, adjDbStr));
+      } else {
+        kvStoreClient_->persistKey(
+            AreaId{area}, key, adjDbStr, ttlKeyInKvStore_);
+      }
+    }
+    newKeys.emplace(std::move(key), std::move(value));
+  }
+
+  // Withdraw removed adjacencies by setting database without adjacencies.
+  // The key expires from KvStore once it is no longer refreshed.
+  auto const withdrawnDbStr = writeThriftObjStrBuffered(nodeDb, serializer_);
+  for (auto const& [key, _] : advertisedKeys) {
+    if (newKeys.count(key)) {
+      continue;
+    }
+    ++numChangedKeys;
+    if (enableKvStoreRequestQueue_) {
+      kvRequestQueue_.push(
+          ClearKeyValueRequest(AreaId{area}, key, withdrawnDbStr, true));
+    } else {
+      kvStoreClient_->clearKey(
+          AreaId{area}, key, withdrawnDbStr, ttlKeyInKvStore_);
+    }
+  }
+
+  advertisedKeys = std::move(newKeys);
+  fb303::fbData->addStatValue(
+      "link_monitor.advertise_adjacency_keys", numChangedKeys, fb303::SUM);
+}
+
 void
 LinkMonitor::advertiseAdjacencies() {
   // advertise to all areas. Once area configuration per link is implemented
@@ -718,7 +851,7 @@ LinkMonitor::advertiseInterfaces() {
   fb303::fbData->addStatValue("link_monitor.advertise_links", 1, fb303::SUM);
 
   // Create interface database
-  InterfaceDatabase ifDb;
+  std::unordered_map<std::string, InterfaceInfo> ifDb;
   for (auto& [_, interface] : interfaces_) {
     // Perform regex match
     if (not anyAreaShouldDiscoverOnIface(interface.getIfName())) {
@@ -730,12 +863,49 @@ LinkMonitor::advertiseInterfaces() {
     // Override `UP` status
     interfaceInfo.isUp = interface.isActive();
 
-    // Construct `InterfaceDatabase` object
-    ifDb.emplace_back(std::move(interfaceInfo));
+    ifDb.emplace(interfaceInfo.ifName, std::move(interfaceInfo));
   }
 
+  // Construct full snapshot or changes since last advertisement
+  InterfaceUpdate update;
+  update.isFullSync = advertiseAllInterfaces_;
+  for (auto const& [ifName, info] : ifDb) {
+    auto it = advertisedInterfaces_.find(ifName);
+    if (advertiseAllInterfaces_ or it == advertisedInterfaces_.end() or
+        not(it->second == info)) {
+      update.interfaces.emplace_back(info);
+    }
+  }
+  if (not advertiseAllInterfaces_) {
+    for (auto const& [ifName, _] : advertisedInterfaces_) {
+      if (not ifDb.count(ifName)) {
+        update.removedIfNames.emplace_back(ifName);
+      }
+    }
+  }
+  advertisedInterfaces_ = std::move(ifDb);
+  advertiseAllInterfaces_ = false;
+
   // publish via replicate queue
-  interfaceUpdatesQueue_.push(std::move(ifDb));
+  interfaceUpdatesQueue_.push(std::move(update));
+}
+
+std::vector<std::string> const&
+LinkMonitor::getRedistAreas(std::string const& ifName) {
+  auto it = redistAreas_.find(ifName);
+  if (it != redistAreas_.end()) {
+    return it->second;
+  }
+
+  // Derive list of area to advertise (NOTE: areas are ordered persistently)
+  std::vector<std::string> dstAreas;
+  for (auto const& [areaId, areaConf] : areas_) {
+    if (areaConf.shouldRedistributeIface(ifName)) {
+      dstAreas.emplace_back(areaId);
+    }
+  }
+  std::sort(dstAreas.begin(), dstAreas.end());
+  return redistAreas_.emplace(ifName, std::move(dstAreas)).first->second;
 }
 
 void
@@ -744,8 +914,7 @@ LinkMonitor::advertiseRedistAddrs() {
     return;
   }
 
-  std::map<folly::CIDRNetwork, std::vector<std::string>> prefixesToAdvertise;
-  std::unordered_map<folly::CIDRNetwork, thrift::PrefixEntry> prefixMap;
+  std::map<folly::CIDRNetwork, RedistPrefix> prefixesToAdvertise;
 
   // Add redistribute addresses
   for (auto& [_, interface] : interfaces_) {
@@ -756,13 +925,7 @@ LinkMonitor::advertiseRedistAddrs() {
       continue;
     }
 
-    // Derive list of area to advertise (NOTE: areas are ordered persistently)
-    std::vector<std::string> dstAreas;
-    for (auto const& [areaId, areaConf] : areas_) {
-      if (areaConf.shouldRedistributeIface(interface.getIfName())) {
-        dstAreas.emplace_back(areaId);
-      }
-    }
+    auto const& dstAreas = getRedistAreas(interface.getIfName());
 
     // Do not advertise interface addresses if no destination area qualifies
     if (dstAreas.empty()) {
@@ -773,43 +936,48 @@ LinkMonitor::advertiseRedistAddrs() {
 
     // Add all prefixes of this interface
     for (auto& prefix : interface.getGlobalUnicastNetworks(enableV4_)) {
-      // Add prefix in the cache
-      prefixesToAdvertise.emplace(prefix, dstAreas);
-
-      // Create prefix entry and populate the
-      thrift::PrefixEntry prefixEntry;
-      prefixEntry.prefix_ref() = toIpPrefix(prefix);
-      prefixEntry.type_ref() = thrift::PrefixType::LOOPBACK;
-
-      // Forwarding information
-      prefixEntry.forwardingType_ref() = prefixForwardingType_;
-      prefixEntry.forwardingAlgorithm_ref() = prefixForwardingAlgorithm_;
-
-      // Tags
-      {
-        auto& tags = prefixEntry.tags_ref().value();
-        tags.emplace("INTERFACE_SUBNET");
-        tags.emplace(fmt::format("{}:{}", nodeId_, interface.getIfName()));
-      }
-      // Metrics
-      {
-        auto& metrics = prefixEntry.metrics_ref().value();
-        metrics.path_preference_ref() = Constants::kDefaultPathPreference;
-        metrics.source_preference_ref() = Constants::kDefaultSourcePreference;
-      }
-
-      prefixMap.emplace(prefix, std::move(prefixEntry));
-
-      VLOG(1) << "Advertise LOOPBACK prefix: "
-              << folly::IPAddress::networkToString(prefix);
+      prefixesToAdvertise.emplace(
+          prefix, RedistPrefix{dstAreas, interface.getIfName()});
     }
   }
 
-  // Find prefixes to advertise or update
+  // Find prefixes to advertise or update, i.e. new ones or ones whose areas
+  // or interface changed. Unchanged ones are NOT sent again.
   std::map<std::vector<std::string>, std::vector<thrift::PrefixEntry>>
       toAdvertise;
-  for (auto const& [prefix, areas] : prefixesToAdvertise) {
-    toAdvertise[areas].emplace_back(std::move(prefixMap.at(prefix)));
+  for (auto const& [prefix, redistPrefix] : prefixesToAdvertise) {
+    auto advertisedIt = advertisedPrefixes_.find(prefix);
+    if (advertisedIt != advertisedPrefixes_.end() and
+        advertisedIt->second == redistPrefix) {
+      continue;
+    }
+
+    // Create prefix entry and populate the
+    thrift::PrefixEntry prefixEntry;
+    prefixEntry.prefix_ref() = toIpPrefix(prefix);
+    prefixEntry.type_ref() = thrift::PrefixType::LOOPBACK;
+
+    // Forwarding information
+    prefixEntry.forwardingType_ref() = prefixForwardingType_;
+    prefixEntry.forwardingAlgorithm_ref() = prefixForwardingAlgorithm_;
+
+    // Tags
+    {
+      auto& tags = prefixEntry.tags_ref().value();
+      tags.emplace("INTERFACE_SUBNET");
+      tags.emplace(fmt::format("{}:{}", nodeId_, redistPrefix.ifName));
+    }
+    // Metrics
+    {
+      auto& metrics = prefixEntry.metrics_ref().value();
+      metrics.path_preference_ref() = Constants::kDefaultPathPreference;
+      metrics.source_preference_ref() = Constants::kDefaultSourcePreference;
+    }
+
+    toAdvertise[redistPrefix.areas].emplace_back(std::move(prefixEntry));
+
+    VLOG(1) << "Advertise LOOPBACK prefix: "
+            << folly::IPAddress::networkToString(prefix);
   }
 
   // Find prefixes to withdraw
@@ -838,7 +1006,7 @@ LinkMonitor::advertiseRedistAddrs() {
   }
 
   // Withdraw prefixes
-  {
+  if (not toWithdraw.empty()) {
     PrefixEvent event(
         PrefixEventType::WITHDRAW_PREFIXES,
         thrift::PrefixType::LOOPBACK,
@@ -850,6 +1018,42 @@ LinkMonitor::advertiseRedistAddrs() {
   advertisedPrefixes_.swap(prefixesToAdvertise);
 }
 
+AdjacencyDampening&
+LinkMonitor::getAdjDampening(const AdjacencyKey& adjKey) {
+  CHECK(adjDampeningConfig_.has_value());
+  return adjDampening_.try_emplace(adjKey, *adjDampeningConfig_).first->second;
+}
+
+void
+LinkMonitor::scheduleAdjDampeningReuse() {
+  std::chrono::milliseconds minReuse{0};
+  size_t numSuppressed{0};
+  for (auto it = adjDampening_.begin(); it != adjDampening_.end();) {
+    auto& dampening = it->second;
+    // history is discarded once penalty has fully decayed
+    if (dampening.isIdle()) {
+      it = adjDampening_.erase(it);
+      continue;
+    }
+    if (dampening.isSuppressed()) {
+      ++numSuppressed;
+      auto reuse = dampening.getReuseDuration();
+      if (minReuse.count() == 0 or reuse < minReuse) {
+        minReuse = reuse;
+      }
+    }
+    ++it;
+  }
+  fb303::fbData->setCounter(
+      "link_monitor.adjacencies_suppressed", numSuppressed);
+
+  if (minReuse.count() > 0) {
+    adjDampeningReuseTimer_->scheduleTimeout(minReuse);
+  } else {
+    adjDampeningReuseTimer_->cancelTimeout();
+  }
+}
+
 std::chrono::milliseconds
 LinkMonitor::getRetryTimeOnUnstableInterfaces() {
   std::chrono::milliseconds minRemainMs{0};
@@ -912,6 +1116,22 @@ LinkMonitor::buildAdjacencyDatabase(const std::string& area) {
     // NOTE: copy on purpose
     auto adj = folly::copy(adjValue.adjacency);
 
+    // Suppressed adjacency is withheld if it is not advertised yet, otherwise
+    // its metric is frozen at the last advertised value
+    if (adjDampeningConfig_) {
+      auto dampeningIt = adjDampening_.find(adjKey);
+      if (dampeningIt != adjDampening_.end()) {
+        auto& dampening = dampeningIt->second;
+        if (not dampening.isSuppressed()) {
+          dampening.advertisedMetric = *adj.metric_ref();
+        } else if (dampening.advertisedMetric.has_value()) {
+          adj.metric_ref() = *dampening.advertisedMetric;
+        } else {
+          continue;
+        }
+      }
+    }
+
     // Set link overload bit
     adj.isOverloaded_ref() =
         state_.overloadedLinks_ref()->count(*adj.ifName_ref()) > 0;
@@ -979,6 +1199,13 @@ LinkMonitor::syncInterfaceTask() noexcept {
   // small amount of time when thread starts before syncing
   std::chrono::milliseconds timeout{expBackoff_.getInitialBackoff()};
 
+  // Interfaces are kept up to date with netlink events once synced. Full
+  // sync is repeated only if events got lost or at a long safety interval.
+  bool synced{false};
+  bool initialSynced{false};
+  auto lastSyncTime = std::chrono::steady_clock::now();
+  uint64_t eventsLostCount = nlSock_->getEventsLostCount();
+
   while (true) { // Break when stop signal is ready
     // Sleep before next check
     if (syncInterfaceStopSignal_.try_wait_for(timeout)) {
@@ -987,17 +1214,48 @@ LinkMonitor::syncInterfaceTask() noexcept {
       syncInterfaceStopSignal_.reset(); // Baton experienced timeout
     }
 
+    // ATTN: read lost count before the dump so that events lost while
+    // dumping trigger another sync
+    const auto newEventsLostCount = nlSock_->getEventsLostCount();
+    const bool eventsLost = newEventsLostCount != eventsLostCount;
+    if (synced and not eventsLost and not needsInterfaceSync_ and
+        std::chrono::steady_clock::now() - lastSyncTime <
+            Constants::kInterfaceFullSyncInterval) {
+      timeout = Constants::kNetlinkEventsLostCheckInterval;
+      continue;
+    }
+    if (eventsLost) {
+      LOG(WARNING) << "[Interface Sync] Netlink events are lost. Resyncing.";
+      advertiseAllInterfaces_ = true;
+    }
+    eventsLostCount = newEventsLostCount;
+
+    if (not initialSynced) {
+      addStartupPerfEvent("INTERFACE_DUMP_REQUESTED");
+    }
     auto success = syncInterfaces();
     if (success) {
+      if (not initialSynced) {
+        // Start discovery on the interfaces right away instead of waiting
+        // for throttled advertisement
+        addStartupPerfEvent("INTERFACE_DUMP_RECEIVED");
+        advertiseIfaceAddr();
+        addStartupPerfEvent("INTERFACES_ADVERTISED");
+        initialSynced = true;
+      } else if (needsInterfaceSync_) {
+        advertiseIfaceAddr();
+      }
+      needsInterfaceSync_ = false;
       expBackoff_.reportSuccess();
-      timeout = std::chrono::milliseconds(Constants::kPlatformSyncInterval);
+      synced = true;
+      lastSyncTime = std::chrono::steady_clock::now();
+      timeout = Constants::kNetlinkEventsLostCheckInterval;
 
-      VLOG(2) << fmt::format(
-          "[Interface Sync] Successfully synced interfaceDb. Schedule next sync in {}ms",
-          timeout.count());
+      VLOG(2) << "[Interface Sync] Successfully synced interfaceDb.";
     } else {
       // Apply exponential backoff and schedule next run
       expBackoff_.reportError();
+      synced = false;
       timeout = expBackoff_.getTimeRemainingUntilRetry();
 
       fb303::fbData->addStatValue(
@@ -1089,6 +1347,18 @@ LinkMonitor::syncInterfaces() {
   return true;
 }
 
+void
+LinkMonitor::addStartupPerfEvent(const std::string& eventDescr) {
+  if (not startupPerfEvents_.has_value()) {
+    return;
+  }
+  addPerfEvent(*startupPerfEvents_, nodeId_, eventDescr);
+  auto const& events = *startupPerfEvents_->events_ref();
+  LOG(INFO) << "[Startup] " << eventDescr << " at "
+            << *events.back().unixTs_ref() - *events.front().unixTs_ref()
+            << "ms since LinkMonitor start";
+}
+
 void
 LinkMonitor::processNetlinkEvent(fbnl::NetlinkEvent&& event) {
   if (auto* link = std::get_if<fbnl::Link>(&event)) {
@@ -1137,6 +1407,9 @@ LinkMonitor::processNetlinkEvent(fbnl::NetlinkEvent&& event) {
 
 void
 LinkMonitor::processNeighborEvents(NeighborEvents&& events) {
+  // areas with neighbors gone down in this batch
+  std::unordered_set<std::string> downAreas;
+
   for (const auto& event : events) {
     const auto& info = event.info;
     const auto& neighborAddrV4 = *info.transportAddressV4_ref();
@@ -1169,6 +1442,7 @@ LinkMonitor::processNeighborEvents(NeighborEvents&& events) {
       CHECK(initialNeighborsReceived_);
       logNeighborEvent(event);
       neighborDownEvent(info);
+      downAreas.emplace(area);
       break;
     }
     case NeighborEventType::NEIGHBOR_RTT_CHANGE: {
@@ -1185,6 +1459,12 @@ LinkMonitor::processNeighborEvents(NeighborEvents&& events) {
     }
   } // for
 
+  // Advertise adjacencies immediately, but only once per area for all the
+  // neighbors gone down together (e.g. on line card reboot)
+  for (const auto& area : downAreas) {
+    advertiseAdjacencies(area);
+  }
+
   // Publish all peers to KvStore in OpenR initialization procedure.
   if (not initialNeighborsReceived_) {
     PeerEvent event;
@@ -1201,6 +1481,7 @@ LinkMonitor::processNeighborEvents(NeighborEvents&& events) {
     peerUpdatesQueue_.push(std::move(event));
 
     initialNeighborsReceived_ = true;
+    addStartupPerfEvent("INITIAL_NEIGHBORS_RECEIVED");
   }
 }
 
@@ -1227,6 +1508,29 @@ LinkMonitor::semifuture_setNodeOverload(bool isOverloaded) {
   return sf;
 }
 
+folly::SemiFuture<folly::Unit>
+LinkMonitor::processConfigUpdate(ConfigUpdate update) {
+  folly::Promise<folly::Unit> p;
+  auto sf = p.getSemiFuture();
+  runInEventBaseThread(
+      [this, p = std::move(p), update = std::move(update)]() mutable {
+        if (not update.areasWithChangedRegexes.empty()) {
+          for (auto const& areaId : update.areasWithChangedRegexes) {
+            LOG(INFO) << "[Config] Applying regexes of area " << areaId;
+            areas_.erase(areaId);
+            areas_.emplace(areaId, update.config->getAreas().at(areaId));
+          }
+          redistAreas_.clear();
+          // known interfaces are re-evaluated right away, newly matching
+          // ones are discovered by the sync
+          needsInterfaceSync_ = true;
+          advertiseIfaceAddr();
+        }
+        p.setValue();
+      });
+  return sf;
+}
+
 folly::SemiFuture<folly::Unit>
 LinkMonitor::semifuture_setInterfaceOverload(
     std::string interfaceName, bool isOverloaded) {
@@ -1453,6 +1757,31 @@ LinkMonitor::semifuture_getAdjacencies(thrift::AdjacenciesFilter filter) {
   return sf;
 }
 
+folly::SemiFuture<std::unique_ptr<std::vector<thrift::AdjacencyDampeningState>>>
+LinkMonitor::semifuture_getAdjacencyDampeningState() {
+  folly::Promise<std::unique_ptr<std::vector<thrift::AdjacencyDampeningState>>>
+      p;
+  auto sf = p.getSemiFuture();
+  runInEventBaseThread([this, p = std::move(p)]() mutable {
+    auto res = std::make_unique<std::vector<thrift::AdjacencyDampeningState>>();
+    for (auto& [adjKey, dampening] : adjDampening_) {
+      thrift::AdjacencyDampeningState state;
+      state.adjKey_ref()->nodeName_ref() = adjKey.first;
+      state.adjKey_ref()->ifName_ref() = adjKey.second;
+      state.penalty_ref() = dampening.getPenalty();
+      state.isSuppressed_ref() = dampening.isSuppressed();
+      state.reuseInMs_ref() = dampening.getReuseDuration().count();
+      state.numEvents_ref() = dampening.getNumEvents();
+      if (dampening.advertisedMetric.has_value()) {
+        state.advertisedMetric_ref() = *dampening.advertisedMetric;
+      }
+      res->emplace_back(std::move(state));
+    }
+    p.setValue(std::move(res));
+  });
+  return sf;
+}
+
 folly::SemiFuture<InterfaceDatabase>
 LinkMonitor::semifuture_getAllLinks() {
   VLOG(2) << "Querying all links and their addresses from system";
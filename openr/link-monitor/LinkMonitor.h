@@ -28,6 +28,7 @@
 #include <openr/if/gen-cpp2/Platform_types.h>
 #include <openr/if/gen-cpp2/Types_types.h>
 #include <openr/kvstore/KvStoreClientInternal.h>
+#include <openr/link-monitor/AdjacencyDampening.h>
 #include <openr/link-monitor/InterfaceEntry.h>
 #include <openr/messaging/ReplicateQueue.h>
 #include <openr/nl/NetlinkProtocolSocket.h>
@@ -106,7 +107,7 @@ class LinkMonitor final : public OpenrEventBase {
       KvStore* kvstore,
       PersistentStore* configStore,
       // producer queue
-      messaging::ReplicateQueue<InterfaceDatabase>& interfaceUpdatesQueue,
+      messaging::ReplicateQueue<InterfaceUpdate>& interfaceUpdatesQueue,
       messaging::ReplicateQueue<PrefixEvent>& prefixUpdatesQueue,
       messaging::ReplicateQueue<PeerEvent>& peerUpdatesQueue,
       messaging::ReplicateQueue<LogSample>& logSampleQueue,
@@ -163,6 +164,16 @@ class LinkMonitor final : public OpenrEventBase {
   folly::SemiFuture<std::unique_ptr<std::vector<thrift::AdjacencyDatabase>>>
   semifuture_getAdjacencies(thrift::AdjacenciesFilter filter = {});
   folly::SemiFuture<InterfaceDatabase> semifuture_getAllLinks();
+  folly::SemiFuture<
+      std::unique_ptr<std::vector<thrift::AdjacencyDampeningState>>>
+  semifuture_getAdjacencyDampeningState();
+
+  /*
+   * Apply config reloaded from file, see `ConfigUpdate`. Interface regexes of
+   * areas are applied live. Interfaces are resynced, as the ones not matching
+   * before aren't tracked.
+   */
+  folly::SemiFuture<folly::Unit> processConfigUpdate(ConfigUpdate update);
 
  private:
   // make no-copy
@@ -196,6 +207,9 @@ class LinkMonitor final : public OpenrEventBase {
    */
   void processNetlinkEvent(fbnl::NetlinkEvent&& event);
 
+  // Record startup phase as perf event (if perf measurement is enabled)
+  void addStartupPerfEvent(const std::string& eventDescr);
+
   void syncInterfaceTask() noexcept;
   bool syncInterfaces();
 
@@ -240,10 +254,16 @@ class LinkMonitor final : public OpenrEventBase {
   void advertiseAdjacencies(const std::string& area);
   void advertiseAdjacencies(); // Advertise my adjacencies_ in to all areas
 
+  // Advertise adjacencies of area with one key per adjacency. Only the keys
+  // whose adjacency changed are persisted, removed ones are withdrawn.
+  void advertiseAdjacencyKeys(
+      const std::string& area, thrift::AdjacencyDatabase const& adjDb);
+
   /*
    * [Spark/Fib] Advertise interfaces_ over interfaceUpdatesQueue_ to Spark/Fib
    *
-   * Called in advertiseIfaceAddr() upon interface changes
+   * Called in advertiseIfaceAddr() upon interface changes. Only interfaces
+   * changed since last advertisement are sent, unless full sync is pending.
    */
   void advertiseInterfaces();
 
@@ -258,6 +278,9 @@ class LinkMonitor final : public OpenrEventBase {
    */
   void advertiseRedistAddrs();
 
+  // areas addresses of interface are redistributed to, from `redistAreas_`
+  std::vector<std::string> const& getRedistAreas(std::string const& ifName);
+
   /*
    * [Util function] general function used for util purpose
    */
@@ -277,6 +300,13 @@ class LinkMonitor final : public OpenrEventBase {
   // build AdjacencyDatabase
   thrift::AdjacencyDatabase buildAdjacencyDatabase(const std::string& area);
 
+  // Dampening state of adjacency, created on first penalty
+  AdjacencyDampening& getAdjDampening(const AdjacencyKey& adjKey);
+
+  // Discard idle dampening states and schedule re-advertisement for the
+  // earliest reuse of suppressed adjacencies
+  void scheduleAdjDampeningReuse();
+
   // returns any(a.shouldDiscoverOnIface(iface) for a in areas_)
   bool anyAreaShouldDiscoverOnIface(std::string const& iface) const;
 
@@ -340,9 +370,14 @@ class LinkMonitor final : public OpenrEventBase {
   // TTL for a key in the key value store
   std::chrono::milliseconds ttlKeyInKvStore_;
 
-  std::unordered_map<std::string, AreaConfiguration> const areas_;
+  // changes on config reload only, see processConfigUpdate()
+  std::unordered_map<std::string, AreaConfiguration> areas_;
   // Send update requests to KvStore via queue
   bool enableKvStoreRequestQueue_{false};
+  // Advertise one KvStore key per adjacency
+  bool enablePerAdjacencyKeys_{false};
+  // Flap dampening of adjacencies, disabled if not set
+  std::optional<thrift::AdjacencyDampeningConfig> adjDampeningConfig_;
 
   //
   // Mutable state
@@ -355,7 +390,7 @@ class LinkMonitor final : public OpenrEventBase {
   thrift::LinkMonitorState state_;
 
   // Queue to publish interface updates to fib/spark
-  messaging::ReplicateQueue<InterfaceDatabase>& interfaceUpdatesQueue_;
+  messaging::ReplicateQueue<InterfaceUpdate>& interfaceUpdatesQueue_;
 
   // Queue to publish prefix updates to PrefixManager
   messaging::ReplicateQueue<PrefixEvent>& prefixUpdatesQueue_;
@@ -384,12 +419,47 @@ class LinkMonitor final : public OpenrEventBase {
       std::unordered_map<std::string /* node name */, KvStorePeerValue>>
       peers_;
 
+  // Per adjacency keys advertised in each area, with value serialized without
+  // perf events to tell which adjacencies changed
+  std::unordered_map<
+      std::string /* area */,
+      std::unordered_map<std::string /* key */, std::string /* value */>>
+      advertisedAdjacencyKeys_;
+
+  // Flap dampening state of adjacencies with penalty history. Outlives the
+  // adjacency itself so that flaps accumulate penalty.
+  std::unordered_map<AdjacencyKey, AdjacencyDampening> adjDampening_;
+
+  // Timer to re-advertise adjacencies once suppressed ones are reused
+  std::unique_ptr<folly::AsyncTimeout> adjDampeningReuseTimer_;
+
   // all interfaces states, including DOWN one
   // Keyed by interface Name
   std::unordered_map<std::string, InterfaceEntry> interfaces_;
 
-  // Container storing map of advertised prefixes - Map<prefix, list<area>>
-  std::map<folly::CIDRNetwork, std::vector<std::string>> advertisedPrefixes_;
+  // Redistributed address of an interface, as advertised to areas
+  struct RedistPrefix {
+    std::vector<std::string> areas;
+    std::string ifName;
+
+    bool
+    operator==(RedistPrefix const& other) const {
+      return areas == other.areas and ifName == other.ifName;
+    }
+  };
+
+  // Container storing map of advertised prefixes - Map<prefix, {areas, iface}>
+  std::map<folly::CIDRNetwork, RedistPrefix> advertisedPrefixes_;
+
+  // Areas addresses of an interface are redistributed to (ordered), as
+  // matched by redistribute regexes of areas. Keyed by interface name and
+  // cleared once regexes change.
+  std::unordered_map<std::string, std::vector<std::string>> redistAreas_;
+
+  // Interfaces last advertised to Spark, keyed by name. Set to advertise full
+  // snapshot instead of changes, i.e. on startup and resync with netlink.
+  std::unordered_map<std::string, InterfaceInfo> advertisedInterfaces_;
+  bool advertiseAllInterfaces_{true};
 
   // Cache of interface index to name. Used for resolving ifIndex
   // on address events
@@ -428,12 +498,20 @@ class LinkMonitor final : public OpenrEventBase {
   // Timer for initial hold time expiry
   std::unique_ptr<folly::AsyncTimeout> adjHoldTimer_;
 
+  // Perf events of startup phases, till adjacencies are first advertised on
+  // hold time expiry. Attached to the first adjacency database advertised.
+  std::optional<thrift::PerfEvents> startupPerfEvents_;
+
   // Boolean flag indicating whether initial neighbors are received in OpenR
   // initialization procedure.
   bool initialNeighborsReceived_{false};
 
   // Stop signal for fiber to periodically dump interface info from platform
   folly::fibers::Baton syncInterfaceStopSignal_;
+
+  // set to request full sync of interfaces on next check, e.g. as interface
+  // regexes changed
+  bool needsInterfaceSync_{false};
 }; // LinkMonitor
 
 } // namespace openr
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/init/Init.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <openr/link-monitor/AdjacencyDampening.h>
+
+namespace openr {
+
+namespace {
+thrift::AdjacencyDampeningConfig
+getTestDampeningConfig() {
+  thrift::AdjacencyDampeningConfig config;
+  config.flap_penalty_ref() = 1000;
+  config.metric_change_penalty_ref() = 250;
+  config.suppress_threshold_ref() = 2000;
+  config.reuse_threshold_ref() = 750;
+  config.half_life_s_ref() = 10;
+  config.max_penalty_ref() = 8000;
+  return config;
+}
+} // namespace
+
+/**
+ * Verify penalty accumulation and exponential decay
+ */
+TEST(AdjacencyDampening, PenaltyDecay) {
+  AdjacencyDampening dampening(getTestDampeningConfig());
+  const auto start = AdjacencyDampening::Clock::now();
+  EXPECT_TRUE(dampening.isIdle(start));
+
+  dampening.reportFlap(start);
+  EXPECT_DOUBLE_EQ(1000, dampening.getPenalty(start));
+  EXPECT_FALSE(dampening.isIdle(start));
+
+  // One half life later penalty is halved
+  const auto halfLife = start + std::chrono::seconds(10);
+  EXPECT_NEAR(500, dampening.getPenalty(halfLife), 0.001);
+
+  // Metric change adds on top of decayed penalty
+  dampening.reportMetricChange(halfLife);
+  EXPECT_NEAR(750, dampening.getPenalty(halfLife), 0.001);
+  EXPECT_EQ(2, dampening.getNumEvents());
+
+  // History is gone eventually
+  EXPECT_TRUE(dampening.isIdle(halfLife + std::chrono::seconds(200)));
+}
+
+/**
+ * Verify suppression and reuse
+ * - Adjacency is suppressed only when penalty exceeds suppress threshold
+ * - Suppressed adjacency is reused after penalty decays below reuse threshold
+ * - Penalty is bounded by max penalty
+ */
+TEST(AdjacencyDampening, SuppressAndReuse) {
+  AdjacencyDampening dampening(getTestDampeningConfig());
+  const auto start = AdjacencyDampening::Clock::now();
+
+  dampening.reportFlap(start);
+  dampening.reportFlap(start);
+  EXPECT_FALSE(dampening.isSuppressed(start));
+  EXPECT_EQ(std::chrono::milliseconds(0), dampening.getReuseDuration(start));
+
+  dampening.reportFlap(start);
+  EXPECT_TRUE(dampening.isSuppressed(start));
+
+  // 3000 -> 750 takes two half lives
+  auto reuseDuration = dampening.getReuseDuration(start);
+  EXPECT_LE(std::chrono::milliseconds(20000), reuseDuration);
+  EXPECT_GE(std::chrono::milliseconds(20010), reuseDuration);
+
+  // Penalty below suppress threshold but above reuse threshold
+  const auto halfLife = start + std::chrono::seconds(10);
+  EXPECT_TRUE(dampening.isSuppressed(halfLife));
+  EXPECT_FALSE(dampening.isSuppressed(start + reuseDuration));
+  EXPECT_FALSE(dampening.isIdle(start + reuseDuration));
+
+  // Penalty is capped
+  for (int i = 0; i < 20; ++i) {
+    dampening.reportFlap(start);
+  }
+  EXPECT_DOUBLE_EQ(8000, dampening.getPenalty(start));
+  EXPECT_TRUE(dampening.isSuppressed(start));
+}
+
+} // namespace openr
+
+int
+main(int argc, char* argv[]) {
+  // Parse command line flags
+  testing::InitGoogleTest(&argc, argv);
+  folly::init(&argc, &argv);
+  google::InstallFailureSignalHandler();
+
+  // Run the tests
+  return RUN_ALL_TESTS();
+}
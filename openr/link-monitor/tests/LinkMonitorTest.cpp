@@ -415,10 +415,10 @@ class LinkMonitorTestFixture : public testing::Test {
   // Receive and process interface updates from the update queue
   void
   recvAndReplyIfUpdate() {
-    auto ifDb = interfaceUpdatesReader.get();
-    ASSERT_TRUE(ifDb.hasValue());
+    auto ifUpdate = interfaceUpdatesReader.get();
+    ASSERT_TRUE(ifUpdate.hasValue());
     // ATTN: update class variable `sparkIfDb` for later verification
-    sparkIfDb = ifDb.value();
+    ifUpdate->applyTo(sparkIfDb);
     LOG(INFO) << "----------- Interface Updates ----------";
     for (const auto& info : sparkIfDb) {
       LOG(INFO) << "  Name=" << info.ifName << ", Status=" << info.isUp
@@ -610,7 +610,7 @@ class LinkMonitorTestFixture : public testing::Test {
   folly::EventBase nlEvb_;
   std::unique_ptr<fbnl::MockNetlinkProtocolSocket> nlSock{nullptr};
 
-  messaging::ReplicateQueue<InterfaceDatabase> interfaceUpdatesQueue;
+  messaging::ReplicateQueue<InterfaceUpdate> interfaceUpdatesQueue;
   messaging::ReplicateQueue<PeerEvent> peerUpdatesQueue;
   messaging::ReplicateQueue<KeyValueRequest> kvRequestQueue;
   messaging::ReplicateQueue<NeighborEvents> neighborUpdatesQueue;
@@ -618,7 +618,7 @@ class LinkMonitorTestFixture : public testing::Test {
   messaging::ReplicateQueue<PrefixEvent> prefixUpdatesQueue;
   messaging::ReplicateQueue<DecisionRouteUpdate> staticRouteUpdatesQueue;
   messaging::ReplicateQueue<DecisionRouteUpdate> fibRouteUpdatesQueue;
-  messaging::RQueue<InterfaceDatabase> interfaceUpdatesReader{
+  messaging::RQueue<InterfaceUpdate> interfaceUpdatesReader{
       interfaceUpdatesQueue.getReader()};
   messaging::ReplicateQueue<openr::LogSample> logSampleQueue;
 
@@ -1115,6 +1115,39 @@ TEST_F(LinkMonitorTestFixture, Throttle) {
   checkNextAdjPub("adj:node-1");
 }
 
+// Neighbors going down in one batch are withdrawn with single advertisement
+TEST_F(LinkMonitorTestFixture, BatchedNeighborDown) {
+  SetUp({});
+  {
+    auto adjDb = createAdjDatabase("node-1", {adj_2_1, adj_3_1}, kNodeLabel);
+    expectedAdjDbs.push(std::move(adjDb));
+  }
+
+  // neighbor up on nb2 and nb3
+  neighborUpdatesQueue.push(NeighborEvents(
+      {NeighborEvent(NeighborEventType::NEIGHBOR_UP, nb2),
+       NeighborEvent(NeighborEventType::NEIGHBOR_UP, nb3)}));
+  kvStoreSyncEventsQueue.push(
+      KvStoreSyncEvent(*nb2.nodeName_ref(), kTestingAreaName));
+  kvStoreSyncEventsQueue.push(
+      KvStoreSyncEvent(*nb3.nodeName_ref(), kTestingAreaName));
+  checkNextAdjPub("adj:node-1");
+
+  // both neighbors down at once
+  neighborUpdatesQueue.push(NeighborEvents(
+      {NeighborEvent(NeighborEventType::NEIGHBOR_DOWN, nb2),
+       NeighborEvent(NeighborEventType::NEIGHBOR_DOWN, nb3)}));
+
+  // first advertised adjacency database must not have any intermediate state
+  std::optional<thrift::Value> value;
+  while (not value.has_value()) {
+    value = getPublicationValueForKey("adj:node-1");
+  }
+  auto adjDb = readThriftObjStr<thrift::AdjacencyDatabase>(
+      value->value_ref().value(), serializer);
+  EXPECT_EQ(0, adjDb.adjacencies_ref()->size());
+}
+
 // parallel adjacencies between two nodes via different interfaces
 TEST_F(LinkMonitorTestFixture, ParallelAdj) {
   SetUp({});
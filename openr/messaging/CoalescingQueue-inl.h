@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "openr/messaging/CoalescingQueue.h"
+namespace openr {
+namespace messaging {
+
+template <typename Key, typename Value>
+CoalescingQueue<Key, Value>::CoalescingQueue(const std::string& queueId)
+    : Base(queueId) {}
+
+template <typename Key, typename Value>
+template <typename KeyT, typename ValueT>
+bool
+CoalescingQueue<Key, Value>::push(KeyT&& key, ValueT&& value) {
+  std::unique_lock<std::mutex> l(this->lock_);
+  if (this->closed_) {
+    return false;
+  }
+
+  // All data elements are read, index is stale
+  if (this->queue_.empty()) {
+    index_.clear();
+  }
+
+  // Replace pending value in place
+  auto it = index_.find(key);
+  if (it != index_.end() and it->second >= this->numDequeued_) {
+    auto& entry = this->queue_.at(it->second - this->numDequeued_);
+    entry.value.second = std::forward<ValueT>(value);
+    ++this->writes_;
+    ++this->drops_;
+    return true;
+  }
+
+  // Append otherwise. Data element is not queued if handed over to pending
+  // read directly.
+  const auto position = this->numDequeued_ + this->queue_.size();
+  Key indexKey(key);
+  if (not Base::pushLocked(
+          l,
+          std::pair<Key, Value>(
+              std::forward<KeyT>(key), std::forward<ValueT>(value)))) {
+    return false;
+  }
+  if (this->numDequeued_ + this->queue_.size() > position) {
+    index_.insert_or_assign(std::move(indexKey), position);
+  } else {
+    index_.erase(indexKey);
+  }
+  return true;
+}
+
+} // namespace messaging
+} // namespace openr
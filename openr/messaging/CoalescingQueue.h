@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <utility>
+
+#include <folly/container/F14Map.h>
+#include <openr/messaging/Queue.h>
+
+namespace openr {
+namespace messaging {
+
+/**
+ * Queue for state-style updates, where only the latest value per key matters.
+ * Pushing value for a key which is still pending replaces pending value in
+ * place instead of appending, hence readers process O(distinct keys) instead
+ * of O(events) under churn. Order of keys is the order of their first pending
+ * push.
+ *
+ * Readers use RQueue interface and read (key, value) pairs, e.g.
+ *
+ *   auto q = std::make_shared<CoalescingQueue<std::string, int>>();
+ *   RQueue<std::pair<std::string, int>> reader(q);
+ *
+ * Queue is always lock based. Replaced values are accounted as drops.
+ */
+template <typename Key, typename Value>
+class CoalescingQueue final : public RWQueue<std::pair<Key, Value>> {
+ public:
+  CoalescingQueue() = default;
+  explicit CoalescingQueue(const std::string& queueId);
+
+  /**
+   * Non blocking push. Replaces pending value of `key` if any.
+   */
+  template <typename KeyT, typename ValueT>
+  bool push(KeyT&& key, ValueT&& value);
+
+ private:
+  using Base = RWQueue<std::pair<Key, Value>>;
+
+  // Key to `numDequeued_ + position` of its data element in `queue_`. Stale
+  // once data element is dequeued.
+  folly::F14FastMap<Key, size_t> index_;
+};
+
+} // namespace messaging
+} // namespace openr
+
+#include <openr/messaging/CoalescingQueue-inl.h>
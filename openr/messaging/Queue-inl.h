@@ -7,7 +7,10 @@
 
 #pragma once
 
+#include <algorithm>
 #include <string>
+
+#include <folly/lang/Bits.h>
 #include "openr/messaging/Queue.h"
 namespace openr {
 namespace messaging {
@@ -33,6 +36,21 @@ RQueue<ValueType>::getCoro() {
 }
 #endif
 
+template <typename ValueType>
+folly::Expected<std::vector<ValueType>, QueueError>
+RQueue<ValueType>::getAll(size_t maxItems) {
+  return queue_->getAll(maxItems);
+}
+
+#if FOLLY_HAS_COROUTINES
+template <typename ValueType>
+folly::coro::Task<folly::Expected<std::vector<ValueType>, QueueError>>
+RQueue<ValueType>::getAllCoro(size_t maxItems) {
+  auto vals = co_await queue_->getAllCoro(maxItems);
+  co_return vals;
+}
+#endif
+
 template <typename ValueType>
 size_t
 RQueue<ValueType>::size() {
@@ -51,6 +69,29 @@ RWQueue<ValueType>::RWQueue() {}
 template <typename ValueType>
 RWQueue<ValueType>::RWQueue(const std::string& queueId) : queueId_(queueId) {}
 
+template <typename ValueType>
+RWQueue<ValueType>::RWQueue(
+    const std::string& queueId,
+    QueueReaders readers,
+    std::optional<QueueLimits<ValueType>> limits)
+    : queueId_(queueId), limits_(std::move(limits)) {
+  if (limits_) {
+    CHECK_GT(limits_->capacity, 0);
+    if (not limits_->highWatermark) {
+      limits_->highWatermark = limits_->capacity;
+    }
+    if (limits_->overflowPolicy == QueueOverflowPolicy::COALESCE) {
+      CHECK(limits_->coalesceKey) << "Coalesce policy requires key function";
+    }
+  }
+  if (readers == QueueReaders::SINGLE and not limits_) {
+    singleReaderQueue_ =
+        std::make_unique<folly::UMPSCQueue<Entry, false /* MayBlock */>>();
+    singleReaderHighPriorityQueue_ =
+        std::make_unique<folly::UMPSCQueue<Entry, false /* MayBlock */>>();
+  }
+}
+
 template <typename ValueType>
 RWQueue<ValueType>::~RWQueue() {
   close();
@@ -59,32 +100,159 @@ RWQueue<ValueType>::~RWQueue() {
 template <typename ValueType>
 template <typename ValueTypeT>
 bool
-RWQueue<ValueType>::push(ValueTypeT&& val) {
-  std::lock_guard<std::mutex> l(lock_);
+RWQueue<ValueType>::push(ValueTypeT&& val, QueuePriority priority) {
+  if (singleReaderQueue_) {
+    if (closed_) {
+      return false;
+    }
+    if (priority == QueuePriority::HIGH) {
+      singleReaderHighPriorityQueue_->enqueue(
+          Entry(std::forward<ValueTypeT>(val)));
+      ++highPriorityWrites_;
+    } else {
+      singleReaderQueue_->enqueue(Entry(std::forward<ValueTypeT>(val)));
+    }
+    ++writes_;
+    // Wake up reader if it is waiting. Fence pairs with the one of reader
+    // announcing waiting, so that either reader sees the data or writer sees
+    // the announcement.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (readerWaiting_.load(std::memory_order_relaxed) and
+        readerWaiting_.exchange(false)) {
+      readerBaton_.post();
+    }
+    return true;
+  }
 
+  std::unique_lock<std::mutex> l(lock_);
+  return pushLocked(l, std::forward<ValueTypeT>(val), priority);
+}
+
+template <typename ValueType>
+template <typename ValueTypeT>
+bool
+RWQueue<ValueType>::pushLocked(
+    std::unique_lock<std::mutex>& l, ValueTypeT&& val, QueuePriority priority) {
   // If queue is closed, don't enqueue
   if (closed_) {
     return false;
   }
 
+  const bool isHighPriority = priority == QueuePriority::HIGH;
+  if (isHighPriority) {
+    ++highPriorityWrites_;
+  }
+
+  // Full bounded queue. High priority lane is not bounded.
+  if (limits_ and not isHighPriority and
+      queue_.size() >= limits_->capacity) {
+    if (limits_->overflowPolicy == QueueOverflowPolicy::COALESCE and
+        coalesce(val)) {
+      ++writes_;
+      ++drops_;
+      return true;
+    }
+    if (not makeRoom(l)) {
+      return false;
+    }
+  }
+
   if (pendingReads_.size()) {
     // Unblock a pending read
     auto& pendingRead = pendingReads_.front().get();
     pendingRead.data = std::forward<ValueTypeT>(val);
+    pendingRead.enqueueTime = Clock::now();
     pendingRead.baton.post();
     pendingReads_.pop_front();
+    if (isHighPriority) {
+      ++highPriorityReads_;
+    }
+  } else if (isHighPriority) {
+    highPriorityQueue_.emplace_back(std::forward<ValueTypeT>(val));
   } else {
     // Add data into the queue
     queue_.emplace_back(std::forward<ValueTypeT>(val));
+    if (limits_ and not aboveHighWatermark_ and
+        queue_.size() >= *limits_->highWatermark) {
+      aboveHighWatermark_ = true;
+      ++highWatermarkCrossings_;
+    }
   }
   ++writes_;
 
   return true;
 }
 
+template <typename ValueType>
+template <typename ValueTypeT>
+bool
+RWQueue<ValueType>::coalesce(ValueTypeT& val) {
+  const auto key = limits_->coalesceKey(val);
+  for (auto it = queue_.rbegin(); it != queue_.rend(); ++it) {
+    if (limits_->coalesceKey(it->value) == key) {
+      *it = Entry(std::forward<ValueTypeT>(val));
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename ValueType>
+bool
+RWQueue<ValueType>::makeRoom(std::unique_lock<std::mutex>& l) {
+  if (limits_->overflowPolicy != QueueOverflowPolicy::BLOCK) {
+    queue_.pop_front();
+    ++numDequeued_;
+    ++drops_;
+    return true;
+  }
+
+  // Wait till reader frees up space. Reader may drain queue completely and
+  // wait for data in the meantime.
+  while (queue_.size() >= limits_->capacity) {
+    folly::fibers::Baton baton;
+    pendingWrites_.emplace_back(baton);
+    l.unlock();
+    baton.wait();
+    l.lock();
+    if (closed_) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename ValueType>
+void
+RWQueue<ValueType>::onRead() {
+  if (not limits_) {
+    return;
+  }
+  if (queue_.size() < *limits_->highWatermark) {
+    aboveHighWatermark_ = false;
+  }
+  // Wake up as many writers waiting for room as there is room
+  for (auto room = limits_->capacity - queue_.size();
+       room > 0 and pendingWrites_.size();
+       --room) {
+    pendingWrites_.front().get().post();
+    pendingWrites_.pop_front();
+  }
+}
+
 template <typename ValueType>
 folly::Expected<ValueType, QueueError>
 RWQueue<ValueType>::get() {
+  if (singleReaderQueue_) {
+    while (true) {
+      auto maybeRead = tryGetSingleReader();
+      if (maybeRead.has_value()) {
+        return std::move(maybeRead).value();
+      }
+      readerBaton_.wait();
+    }
+  }
+
   PendingRead pendingRead;
 
   // Queue is closed
@@ -105,6 +273,7 @@ RWQueue<ValueType>::get() {
   pendingRead.baton.wait();
   if (pendingRead.data) {
     ++reads_;
+    recordLatency(pendingRead.enqueueTime);
     return std::move(pendingRead.data).value();
   }
   return folly::makeUnexpected(QueueError::QUEUE_CLOSED);
@@ -114,6 +283,16 @@ RWQueue<ValueType>::get() {
 template <typename ValueType>
 folly::coro::Task<folly::Expected<ValueType, QueueError>>
 RWQueue<ValueType>::getCoro() {
+  if (singleReaderQueue_) {
+    while (true) {
+      auto maybeRead = tryGetSingleReader();
+      if (maybeRead.has_value()) {
+        co_return std::move(maybeRead).value();
+      }
+      co_await readerBaton_;
+    }
+  }
+
   PendingRead pendingRead;
 
   // Queue is closed
@@ -132,12 +311,89 @@ RWQueue<ValueType>::getCoro() {
   co_await pendingRead.baton;
   if (pendingRead.data) {
     ++reads_;
+    recordLatency(pendingRead.enqueueTime);
     co_return std::move(pendingRead.data).value();
   }
   co_return folly::makeUnexpected(QueueError::QUEUE_CLOSED);
 }
 #endif
 
+template <typename ValueType>
+folly::Expected<std::vector<ValueType>, QueueError>
+RWQueue<ValueType>::getAll(size_t maxItems) {
+  CHECK_GT(maxItems, 0);
+  auto maybeRead = get();
+  if (maybeRead.hasError()) {
+    return folly::makeUnexpected(maybeRead.error());
+  }
+  std::vector<ValueType> items;
+  items.emplace_back(std::move(maybeRead).value());
+  drainPending(items, maxItems);
+  return items;
+}
+
+#if FOLLY_HAS_COROUTINES
+template <typename ValueType>
+folly::coro::Task<folly::Expected<std::vector<ValueType>, QueueError>>
+RWQueue<ValueType>::getAllCoro(size_t maxItems) {
+  CHECK_GT(maxItems, 0);
+  auto maybeRead = co_await getCoro();
+  if (maybeRead.hasError()) {
+    co_return folly::makeUnexpected(maybeRead.error());
+  }
+  std::vector<ValueType> items;
+  items.emplace_back(std::move(maybeRead).value());
+  drainPending(items, maxItems);
+  co_return items;
+}
+#endif
+
+template <typename ValueType>
+void
+RWQueue<ValueType>::drainPending(
+    std::vector<ValueType>& items, size_t maxItems) {
+  if (singleReaderQueue_) {
+    while (items.size() < maxItems and not closed_) {
+      auto val = tryDequeueSingleReader();
+      if (not val) {
+        break;
+      }
+      ++reads_;
+      recordLatency(val->enqueueTime);
+      items.emplace_back(std::move(val->value));
+    }
+    return;
+  }
+
+  std::lock_guard<std::mutex> l(lock_);
+  while (items.size() < maxItems) {
+    auto entry = popLocked();
+    if (not entry) {
+      break;
+    }
+    ++reads_;
+    recordLatency(entry->enqueueTime);
+    items.emplace_back(std::move(entry->value));
+  }
+  onRead();
+}
+
+template <typename ValueType>
+std::optional<typename RWQueue<ValueType>::Entry>
+RWQueue<ValueType>::popLocked() {
+  std::optional<Entry> entry;
+  if (highPriorityQueue_.size()) {
+    entry.emplace(std::move(highPriorityQueue_.front()));
+    highPriorityQueue_.pop_front();
+    ++highPriorityReads_;
+  } else if (queue_.size()) {
+    entry.emplace(std::move(queue_.front()));
+    queue_.pop_front();
+    ++numDequeued_;
+  }
+  return entry;
+}
+
 template <typename ValueType>
 folly::Expected<bool, QueueError>
 RWQueue<ValueType>::getAnyImpl(PendingRead& pendingRead) {
@@ -149,9 +405,10 @@ RWQueue<ValueType>::getAnyImpl(PendingRead& pendingRead) {
   }
 
   // Perform immediate read if data is available
-  if (queue_.size()) {
-    pendingRead.data = std::move(queue_.front());
-    queue_.pop_front();
+  if (auto entry = popLocked()) {
+    pendingRead.data = std::move(entry->value);
+    pendingRead.enqueueTime = entry->enqueueTime;
+    onRead();
     return true;
   }
 
@@ -160,29 +417,108 @@ RWQueue<ValueType>::getAnyImpl(PendingRead& pendingRead) {
   return false;
 }
 
+template <typename ValueType>
+void
+RWQueue<ValueType>::recordLatency(Clock::time_point enqueueTime) {
+  const uint64_t latencyUs =
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          Clock::now() - enqueueTime)
+          .count();
+  const size_t bucket = std::min<size_t>(
+      (folly::findLastSet(latencyUs) + 1) / 2, kNumQueueLatencyBuckets - 1);
+  latencyBuckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+template <typename ValueType>
+std::optional<folly::Expected<ValueType, QueueError>>
+RWQueue<ValueType>::tryGetSingleReader() {
+  // Pending data is dropped once queue is closed
+  if (closed_) {
+    return folly::makeUnexpected(QueueError::QUEUE_CLOSED);
+  }
+  if (auto val = tryDequeueSingleReader()) {
+    ++reads_;
+    recordLatency(val->enqueueTime);
+    return std::move(val->value);
+  }
+
+  // Announce waiting, then check again to not miss push or close which
+  // happened before the announcement
+  readerBaton_.reset();
+  readerWaiting_ = true;
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (closed_) {
+    cancelReaderWait();
+    return folly::makeUnexpected(QueueError::QUEUE_CLOSED);
+  }
+  if (auto val = tryDequeueSingleReader()) {
+    cancelReaderWait();
+    ++reads_;
+    recordLatency(val->enqueueTime);
+    return std::move(val->value);
+  }
+  return std::nullopt;
+}
+
+template <typename ValueType>
+folly::Optional<typename RWQueue<ValueType>::Entry>
+RWQueue<ValueType>::tryDequeueSingleReader() {
+  if (auto val = singleReaderHighPriorityQueue_->try_dequeue()) {
+    ++highPriorityReads_;
+    return val;
+  }
+  return singleReaderQueue_->try_dequeue();
+}
+
+template <typename ValueType>
+void
+RWQueue<ValueType>::cancelReaderWait() {
+  if (not readerWaiting_.exchange(false)) {
+    // Writer has taken back the announcement and is posting baton. Wait for
+    // it, as baton can't be reset while being posted.
+    readerBaton_.wait();
+  }
+}
+
 template <typename ValueType>
 void
 RWQueue<ValueType>::close() {
+  if (singleReaderQueue_) {
+    // Pending data is left for destructor, as only reader can dequeue
+    if (not closed_.exchange(true) and readerWaiting_.exchange(false)) {
+      readerBaton_.post();
+    }
+    return;
+  }
+
   std::lock_guard<std::mutex> l(lock_);
 
   if (not closed_) {
     closed_ = true;
     // Either one of these must be zero
-    assert(pendingReads_.size() == 0 || queue_.size() == 0);
+    assert(
+        pendingReads_.size() == 0 ||
+        queue_.size() + highPriorityQueue_.size() == 0);
     // Set empy value to all pending reads
     while (pendingReads_.size()) {
       auto& pendingRead = pendingReads_.front().get();
       pendingRead.baton.post();
       pendingReads_.pop_front();
     }
+    // Unblock all pending writes
+    while (pendingWrites_.size()) {
+      pendingWrites_.front().get().post();
+      pendingWrites_.pop_front();
+    }
+    numDequeued_ += queue_.size();
     queue_.clear();
+    highPriorityQueue_.clear();
   }
 }
 
 template <typename ValueType>
 bool
 RWQueue<ValueType>::isClosed() {
-  std::lock_guard<std::mutex> l(lock_);
   return closed_;
 }
 
@@ -195,13 +531,22 @@ RWQueue<ValueType>::getQueueId() {
 template <typename ValueType>
 size_t
 RWQueue<ValueType>::size() {
+  if (singleReaderQueue_) {
+    if (closed_) {
+      return 0;
+    }
+    return singleReaderQueue_->size() + singleReaderHighPriorityQueue_->size();
+  }
   std::lock_guard<std::mutex> l(lock_);
-  return queue_.size();
+  return queue_.size() + highPriorityQueue_.size();
 }
 
 template <typename ValueType>
 size_t
 RWQueue<ValueType>::numPendingReads() {
+  if (singleReaderQueue_) {
+    return readerWaiting_ ? 1 : 0;
+  }
   std::lock_guard<std::mutex> l(lock_);
   return pendingReads_.size();
 }
@@ -209,22 +554,45 @@ RWQueue<ValueType>::numPendingReads() {
 template <typename ValueType>
 size_t
 RWQueue<ValueType>::numWrites() {
-  std::lock_guard<std::mutex> l(lock_);
   return writes_;
 }
 
 template <typename ValueType>
 size_t
 RWQueue<ValueType>::numReads() {
-  std::lock_guard<std::mutex> l(lock_);
   return reads_;
 }
 
+template <typename ValueType>
+size_t
+RWQueue<ValueType>::numDrops() {
+  return drops_;
+}
+
+template <typename ValueType>
+size_t
+RWQueue<ValueType>::numHighWatermarkCrossings() {
+  return highWatermarkCrossings_;
+}
+
 template <typename ValueType>
 RWQueueStats
 RWQueue<ValueType>::getStats() {
-  std::lock_guard<std::mutex> l(lock_);
-  return RWQueueStats{"", reads_, writes_, queue_.size()};
+  std::vector<size_t> latencyBuckets;
+  latencyBuckets.reserve(kNumQueueLatencyBuckets);
+  for (auto const& count : latencyBuckets_) {
+    latencyBuckets.emplace_back(count.load(std::memory_order_relaxed));
+  }
+  return RWQueueStats{
+      "",
+      reads_,
+      writes_,
+      size(),
+      drops_,
+      highWatermarkCrossings_,
+      std::move(latencyBuckets),
+      highPriorityReads_,
+      highPriorityWrites_};
 }
 
 } // namespace messaging
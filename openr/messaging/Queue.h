@@ -8,12 +8,20 @@
 #pragma once
 
 #include <any>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <deque>
+#include <functional>
+#include <limits>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <utility>
+#include <vector>
 
 #include <folly/Expected.h>
+#include <folly/concurrency/UnboundedQueue.h>
 #include <folly/fibers/Baton.h>
 #if FOLLY_HAS_COROUTINES
 #include <folly/experimental/coro/Task.h>
@@ -26,12 +34,71 @@ enum class QueueError {
   QUEUE_CLOSED,
 };
 
+// Readers of RWQueue
+enum class QueueReaders {
+  // Any number of concurrent readers
+  MULTIPLE,
+  // At most one reader at a time, e.g. reader stream of ReplicateQueue
+  SINGLE,
+};
+
+// Priority lane of data element in RWQueue. Readers drain higher priority
+// lane first, hence data elements of different lanes may get reordered.
+enum class QueuePriority {
+  // Urgent events, e.g. neighbor down
+  HIGH,
+  // Everything else, e.g. bulk updates
+  NORMAL,
+};
+
+// Policy of bounded RWQueue on pushing into full queue
+enum class QueueOverflowPolicy {
+  // Block writer until reader frees up space
+  BLOCK,
+  // Drop the oldest pending data element
+  DROP_OLDEST,
+  // Replace the latest pending data element with the same key. Drop the
+  // oldest one if there is none.
+  COALESCE,
+};
+
+// Capacity limits of RWQueue
+template <typename ValueType>
+struct QueueLimits {
+  // Max number of pending data elements
+  size_t capacity{0};
+  // Number of pending data elements at which high watermark is crossed.
+  // Defaults to `capacity`.
+  std::optional<size_t> highWatermark;
+  QueueOverflowPolicy overflowPolicy{QueueOverflowPolicy::BLOCK};
+  // Key of data element, required by `QueueOverflowPolicy::COALESCE`
+  std::function<std::string(ValueType const&)> coalesceKey;
+};
+
+// Enqueue to dequeue latency of RWQueue is recorded in buckets with
+// exponentially growing bounds, i.e. bucket `i` counts latencies below 4^i
+// microseconds. Last bucket counts the rest.
+constexpr size_t kNumQueueLatencyBuckets{14};
+
+inline uint64_t
+getQueueLatencyBucketBoundUs(size_t bucket) {
+  return uint64_t{1} << (2 * bucket);
+}
+
 // Stats recording of
 struct RWQueueStats {
   std::string queueId; // TODO: Change to const post T98477650
   const size_t reads{0};
   const size_t writes{0};
   const size_t size{0};
+  // Data elements dropped or coalesced by bounded queue
+  const size_t drops{0};
+  const size_t highWatermarkCrossings{0};
+  // Number of reads per latency bucket, see `kNumQueueLatencyBuckets`
+  const std::vector<size_t> latencyBuckets{};
+  // Reads/writes of high priority lane, included in reads/writes
+  const size_t highPriorityReads{0};
+  const size_t highPriorityWrites{0};
 };
 
 template <typename ValueType>
@@ -59,6 +126,19 @@ class RQueue {
   folly::coro::Task<folly::Expected<ValueType, QueueError>> getCoro();
 #endif
 
+  /**
+   * Blocking batched read. Waits for at least one data element like `get()`
+   * and then drains all pending elements, up to `maxItems`, in one call. Let
+   * consumers fold bursts of messages into one processing pass.
+   */
+  folly::Expected<std::vector<ValueType>, QueueError> getAll(
+      size_t maxItems = std::numeric_limits<size_t>::max());
+
+#if FOLLY_HAS_COROUTINES
+  folly::coro::Task<folly::Expected<std::vector<ValueType>, QueueError>>
+  getAllCoro(size_t maxItems = std::numeric_limits<size_t>::max());
+#endif
+
   // Utility function to retrieve size of pending data in underlying queue
   size_t size();
 
@@ -75,8 +155,20 @@ class RQueue {
  * Code in critical path is minimal and ensures that readers/writers will never
  * block each other because of lock.
  *
+ * Queue created for `QueueReaders::SINGLE` is lock-free instead. Data is kept
+ * in MPSC queue and the only reader waits on its own baton, which gets posted
+ * by the writer that takes back reader's announcement of waiting. Reads must
+ * not be performed concurrently, e.g. from multiple fibers.
+ *
  *There are various get (blocking and async) methods to retrieve typed object.
  *
+ * Queue can optionally be bounded with `QueueLimits`, in which case pushing
+ * into full queue blocks writer or drops data as per overflow policy. Bounded
+ * queue is always lock based, regardless of its readers.
+ *
+ * Data elements pushed with `QueuePriority::HIGH` are kept in a separate lane
+ * which readers drain first. High priority lane is never bounded.
+ *
  * After closing queue, all subsequent push are ignored and return false. All
  * subsequent reads return QUEUE_CLOSED error
  */
@@ -85,6 +177,10 @@ class RWQueue {
  public:
   RWQueue();
   explicit RWQueue(const std::string&);
+  RWQueue(
+      const std::string&,
+      QueueReaders readers,
+      std::optional<QueueLimits<ValueType>> limits = std::nullopt);
   ~RWQueue();
 
   /**
@@ -92,7 +188,8 @@ class RWQueue {
    * Return true/false!!
    */
   template <typename ValueTypeT>
-  bool push(ValueTypeT&& val);
+  bool push(
+      ValueTypeT&& val, QueuePriority priority = QueuePriority::NORMAL);
 
   /**
    * Blocking read for native threads/fibers. In-case of fibers, the fiber
@@ -107,6 +204,18 @@ class RWQueue {
   folly::coro::Task<folly::Expected<ValueType, QueueError>> getCoro();
 #endif
 
+  /**
+   * Blocking batched read. Waits for at least one data element and then
+   * drains all pending elements, up to `maxItems`, in one call.
+   */
+  folly::Expected<std::vector<ValueType>, QueueError> getAll(
+      size_t maxItems = std::numeric_limits<size_t>::max());
+
+#if FOLLY_HAS_COROUTINES
+  folly::coro::Task<folly::Expected<std::vector<ValueType>, QueueError>>
+  getAllCoro(size_t maxItems = std::numeric_limits<size_t>::max());
+#endif
+
   /**
    * Close the queue. All new push will be ignored and pending data will be lost
    */
@@ -138,18 +247,41 @@ class RWQueue {
    */
   size_t numReads();
 
+  /**
+   * Return the number of messages dropped or coalesced by bounded queue
+   */
+  size_t numDrops();
+
+  /**
+   * Return the number of times bounded queue has crossed its high watermark
+   */
+  size_t numHighWatermarkCrossings();
+
   /**
    * Package and return the individual queue stats.
    */
   RWQueueStats getStats();
 
- private:
+ protected:
   // Name/id of the queue
   std::string queueId_{""};
 
+  using Clock = std::chrono::steady_clock;
+
+  // Data element along with time it got pushed
+  struct Entry {
+    template <typename ValueTypeT>
+    explicit Entry(ValueTypeT&& val)
+        : value(std::forward<ValueTypeT>(val)), enqueueTime(Clock::now()) {}
+
+    ValueType value;
+    Clock::time_point enqueueTime;
+  };
+
   struct PendingRead {
     folly::fibers::Baton baton;
     std::optional<ValueType> data;
+    Clock::time_point enqueueTime;
   };
 
   /**
@@ -160,23 +292,109 @@ class RWQueue {
    */
   folly::Expected<bool, QueueError> getAnyImpl(PendingRead& pendingRead);
 
+  // [Single reader] Dequeue data element from the highest priority non-empty
+  // lane
+  folly::Optional<Entry> tryDequeueSingleReader();
+
+  /**
+   * [Single reader] Read data without waiting.
+   *
+   * @returns std::nullopt if reader has announced waiting and must wait on
+   *          `readerBaton_` before reading again
+   */
+  std::optional<folly::Expected<ValueType, QueueError>> tryGetSingleReader();
+
+  // Push data element with `lock_` held
+  template <typename ValueTypeT>
+  bool pushLocked(
+      std::unique_lock<std::mutex>& l,
+      ValueTypeT&& val,
+      QueuePriority priority = QueuePriority::NORMAL);
+
+  // Pop data element from the highest priority non-empty lane, with `lock_`
+  // held. Returns std::nullopt if queue is empty.
+  std::optional<Entry> popLocked();
+
+  // [Bounded] Replace the latest pending data element with the same key.
+  // Returns false if there is none.
+  template <typename ValueTypeT>
+  bool coalesce(ValueTypeT& val);
+
+  // [Bounded] Make room for data element being pushed. Returns false if
+  // queue got closed while waiting.
+  bool makeRoom(std::unique_lock<std::mutex>& l);
+
+  // [Bounded] Update state after data elements got read
+  void onRead();
+
+  // Record enqueue to dequeue latency of data element being read
+  void recordLatency(Clock::time_point enqueueTime);
+
+  // Move pending data elements, without waiting, to `items` till it holds
+  // `maxItems` elements
+  void drainPending(std::vector<ValueType>& items, size_t maxItems);
+
+  // [Single reader] Take back announcement of waiting, after which reader
+  // reads without waiting
+  void cancelReaderWait();
+
   // Lock to protect below private variables
   std::mutex lock_;
 
-  // State of queue
-  bool closed_{false};
+  // State of queue. Read without lock for single reader.
+  std::atomic<bool> closed_{false};
 
   // Pending reads - readers are actively waiting for data
   std::deque<std::reference_wrapper<PendingRead>> pendingReads_;
 
   // Pending data
-  std::deque<ValueType> queue_;
+  std::deque<Entry> queue_;
+
+  // Pending data of high priority lane
+  std::deque<Entry> highPriorityQueue_;
+
+  // Number of data elements ever removed from front of `queue_`. Position of
+  // data element in `queue_` changes, but `numDequeued_ + position` doesn't.
+  size_t numDequeued_{0};
+
+  // [Bounded] Capacity limits
+  std::optional<QueueLimits<ValueType>> limits_;
+
+  // [Bounded] Pending writes - writers are waiting for room in the queue
+  std::deque<std::reference_wrapper<folly::fibers::Baton>> pendingWrites_;
+
+  // [Bounded] Size of queue is at or above high watermark
+  bool aboveHighWatermark_{false};
+
+  // [Single reader] Pending data, replacing `queue_` and `pendingReads_`
+  std::unique_ptr<folly::UMPSCQueue<Entry, false /* MayBlock */>>
+      singleReaderQueue_;
+  std::unique_ptr<folly::UMPSCQueue<Entry, false /* MayBlock */>>
+      singleReaderHighPriorityQueue_;
+
+  // [Single reader] Reader announces waiting with `readerWaiting_` before
+  // waiting on `readerBaton_`
+  folly::fibers::Baton readerBaton_;
+  std::atomic<bool> readerWaiting_{false};
 
   // Sent messages
-  size_t writes_{0};
+  std::atomic<size_t> writes_{0};
 
   // Received messages
-  size_t reads_{0};
+  std::atomic<size_t> reads_{0};
+
+  // [Bounded] Dropped or coalesced messages
+  std::atomic<size_t> drops_{0};
+
+  // [Bounded] High watermark crossings
+  std::atomic<size_t> highWatermarkCrossings_{0};
+
+  // Reads/writes of high priority lane
+  std::atomic<size_t> highPriorityReads_{0};
+  std::atomic<size_t> highPriorityWrites_{0};
+
+  // Number of reads per latency bucket
+  std::array<std::atomic<size_t>, kNumQueueLatencyBuckets> latencyBuckets_{};
 };
 
 } // namespace messaging
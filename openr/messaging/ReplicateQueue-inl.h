@@ -25,37 +25,50 @@ ReplicateQueue<ValueType>::~ReplicateQueue() {
 template <typename ValueType>
 template <typename ValueTypeT>
 bool
-ReplicateQueue<ValueType>::push(ValueTypeT&& value) {
-  std::vector<std::shared_ptr<RWQueue<ValueType>>> readers;
+ReplicateQueue<ValueType>::push(
+    ValueTypeT&& value, QueuePriority priority) {
+  if constexpr (
+      detail::IsSharedConstPtr<ValueType>::value and
+      not std::is_convertible_v<ValueTypeT&&, ValueType>) {
+    // Zero-copy mode: wrap value once, readers share it. Object is created
+    // non-const so that sole owner can move it out.
+    using ElementType = std::remove_const_t<typename ValueType::element_type>;
+    return push(
+        ValueType(
+            std::make_shared<ElementType>(std::forward<ValueTypeT>(value))),
+        priority);
+  } else {
+    std::vector<std::shared_ptr<RWQueue<ValueType>>> readers;
 
-  // Copy reader information - and cleans up stale reader
-  {
-    auto lockedReaders = readers_.wlock();
-    if (closed_) {
-      return false;
-    }
-    for (auto it = lockedReaders->begin(); it != lockedReaders->end();) {
-      if (it->use_count() == 1) {
-        (*it)->close(); // Close before erasing
-        it = lockedReaders->erase(it);
-      } else {
-        readers.emplace_back(*it); // NOTE: intentionally copying shared_ptr
-        ++it;
+    // Copy reader information - and cleans up stale reader
+    {
+      auto lockedReaders = readers_.wlock();
+      if (closed_) {
+        return false;
+      }
+      for (auto it = lockedReaders->begin(); it != lockedReaders->end();) {
+        if (it->use_count() == 1) {
+          (*it)->close(); // Close before erasing
+          it = lockedReaders->erase(it);
+        } else {
+          readers.emplace_back(*it); // NOTE: intentionally copying shared_ptr
+          ++it;
+        }
       }
     }
-  }
 
-  // Replicate messages
-  if (readers.size()) {
-    for (size_t i = 0; i < readers.size() - 1; i++) {
-      readers.at(i)->push(ValueType(value)); // Intended copy
+    // Replicate messages
+    if (readers.size()) {
+      for (size_t i = 0; i < readers.size() - 1; i++) {
+        readers.at(i)->push(ValueType(value), priority); // Intended copy
+      }
+      // Perfect forwarding for last reader
+      readers.back()->push(std::forward<ValueTypeT>(value), priority);
     }
-    // Perfect forwarding for last reader
-    readers.back()->push(std::forward<ValueTypeT>(value));
-  }
-  ++writes_;
+    ++writes_;
 
-  return true;
+    return true;
+  }
 }
 
 /**
@@ -65,17 +78,15 @@ ReplicateQueue<ValueType>::push(ValueTypeT&& value) {
 template <typename ValueType>
 RQueue<ValueType>
 ReplicateQueue<ValueType>::getReader(
-    const std::optional<std::string>& readerId) {
+    const std::optional<std::string>& readerId,
+    const std::optional<QueueLimits<ValueType>>& limits) {
   auto lockedReaders = readers_.wlock();
   if (closed_) {
     throw std::runtime_error("queue is closed");
   }
-  if (readerId) {
-    lockedReaders->emplace_back(
-        std::make_shared<RWQueue<ValueType>>(*readerId));
-  } else {
-    lockedReaders->emplace_back(std::make_shared<RWQueue<ValueType>>());
-  }
+  // Every reader stream has its own queue, hence single reader
+  lockedReaders->emplace_back(std::make_shared<RWQueue<ValueType>>(
+      readerId.value_or(""), QueueReaders::SINGLE, limits));
   return RQueue<ValueType>(lockedReaders->back());
 }
 
@@ -136,5 +147,15 @@ ReplicateQueue<ValueType>::getReplicationStats() {
   return stats;
 }
 
+template <typename T>
+T
+takeOrCopy(std::shared_ptr<const T>&& message) {
+  auto ptr = std::move(message);
+  if (ptr.use_count() == 1) {
+    return std::move(const_cast<T&>(*ptr));
+  }
+  return *ptr;
+}
+
 } // namespace messaging
 } // namespace openr
@@ -9,6 +9,7 @@
 
 #include <openr/messaging/Queue.h>
 #include <list>
+#include <type_traits>
 
 namespace openr {
 namespace messaging {
@@ -24,12 +25,24 @@ class ReplicateQueueBase {
   virtual std::vector<RWQueueStats> getReplicationStats() = 0;
 };
 
+namespace detail {
+template <typename T>
+struct IsSharedConstPtr : std::false_type {};
+template <typename T>
+struct IsSharedConstPtr<std::shared_ptr<const T>> : std::true_type {};
+} // namespace detail
+
 /**
  * Multiple writers and readers. Each reader gets every written element push by
  * every writer. Writer pays the cost of replicating data to all readers. If no
  * reader exists then all the messages are silently dropped.
  *
  * Pushed object must be copy constructible.
+ *
+ * ReplicateQueue<std::shared_ptr<const T>> (aka SharedReplicateQueue<T>) is
+ * the zero-copy mode for large messages. Pushed value of type T is moved into
+ * a single shared object and all readers get references to it. Readers can
+ * take the value out with `takeOrCopy()`.
  */
 template <typename ValueType>
 class ReplicateQueue : public ReplicateQueueBase {
@@ -53,16 +66,25 @@ class ReplicateQueue : public ReplicateQueueBase {
   /**
    * Push any value into the queue. Will get replicated to all the readers.
    * This also cleans up any lingering queue which has no active reader
+   *
+   * High priority values are read before normal ones by every reader. Use it
+   * only for values which are fine to be reordered, e.g. urgent events.
    */
   template <typename ValueTypeT>
-  bool push(ValueTypeT&& value);
+  bool push(
+      ValueTypeT&& value, QueuePriority priority = QueuePriority::NORMAL);
 
   /**
    * Get new reader stream of this queue. Stream will get closed automatically
-   * when reader is destructed.
+   * when reader is destructed. Stream is backed by a single reader queue, and
+   * must not be read from multiple threads/fibers concurrently.
+   *
+   * Optional `limits` bound the stream, e.g. to protect against slow reader.
+   * NOTE: With `QueueOverflowPolicy::BLOCK`, push blocks on full stream.
    */
   RQueue<ValueType> getReader(
-      const std::optional<std::string>& readerId = std::nullopt);
+      const std::optional<std::string>& readerId = std::nullopt,
+      const std::optional<QueueLimits<ValueType>>& limits = std::nullopt);
 
   /**
    * Number of replicated streams/readers
@@ -98,6 +120,22 @@ class ReplicateQueue : public ReplicateQueueBase {
   size_t writes_{0};
 };
 
+/**
+ * Replicate queue sharing a single copy of every message among all readers
+ */
+template <typename T>
+using SharedReplicateQueue = ReplicateQueue<std::shared_ptr<const T>>;
+
+/**
+ * Take value out of message read from SharedReplicateQueue. Value is moved if
+ * reader is the sole owner of the message, otherwise copied.
+ *
+ * NOTE: Message must not have been created as const object, which holds for
+ * values pushed as T into SharedReplicateQueue.
+ */
+template <typename T>
+T takeOrCopy(std::shared_ptr<const T>&& message);
+
 } // namespace messaging
 } // namespace openr
 
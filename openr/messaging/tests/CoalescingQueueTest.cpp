@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <folly/fibers/FiberManager.h>
+#include <folly/fibers/FiberManagerMap.h>
+#include <folly/io/async/EventBase.h>
+
+#include <openr/messaging/CoalescingQueue.h>
+
+using namespace openr::messaging;
+
+using Update = std::pair<std::string, int>;
+
+TEST(CoalescingQueueTest, CoalescePendingKeys) {
+  auto q = std::make_shared<CoalescingQueue<std::string, int>>("q");
+  RQueue<Update> reader(q);
+
+  EXPECT_TRUE(q->push("a", 1));
+  EXPECT_TRUE(q->push("b", 1));
+  EXPECT_TRUE(q->push("a", 2));
+  EXPECT_TRUE(q->push("c", 1));
+  EXPECT_TRUE(q->push("b", 2));
+
+  // Keys retain order of their first pending push
+  EXPECT_EQ(3, reader.size());
+  EXPECT_EQ(5, q->numWrites());
+  EXPECT_EQ(2, q->numDrops());
+  EXPECT_EQ(Update("a", 2), reader.get().value());
+
+  // Key is not pending anymore once read
+  EXPECT_TRUE(q->push("a", 3));
+  EXPECT_TRUE(q->push("c", 2));
+  EXPECT_EQ(
+      std::vector<Update>({{"b", 2}, {"c", 2}, {"a", 3}}),
+      reader.getAll().value());
+  EXPECT_EQ(0, reader.size());
+
+  q->close();
+  EXPECT_FALSE(q->push("a", 4));
+  EXPECT_TRUE(reader.get().hasError());
+}
+
+TEST(CoalescingQueueTest, PendingRead) {
+  auto q = std::make_shared<CoalescingQueue<int, int>>();
+  RQueue<std::pair<int, int>> reader(q);
+
+  folly::EventBase evb;
+  auto& manager = folly::fibers::getFiberManager(evb);
+  manager.addTask([&reader]() mutable {
+    EXPECT_EQ(std::make_pair(1, 1), reader.get().value());
+    EXPECT_EQ(std::make_pair(1, 3), reader.get().value());
+  });
+
+  evb.loopOnce(); // Fiber should get stuck at the read
+  EXPECT_EQ(1, q->numPendingReads());
+
+  // First value is handed over to pending read and can't be coalesced
+  EXPECT_TRUE(q->push(1, 1));
+  EXPECT_TRUE(q->push(1, 2));
+  EXPECT_TRUE(q->push(1, 3));
+  EXPECT_EQ(1, q->size());
+  EXPECT_EQ(1, q->numDrops());
+
+  evb.loop();
+  EXPECT_EQ(0, q->size());
+  EXPECT_EQ(2, q->numReads());
+}
@@ -18,6 +18,7 @@ namespace openr {
 static void
 BM_RWQueue(
     uint32_t iters,
+    const messaging::QueueReaders kReaders,
     const size_t kNumReaders,
     const size_t kNumWriters,
     const size_t kCount) {
@@ -32,7 +33,7 @@ BM_RWQueue(
   // Queue under testing. We use primitive type. This is good enough for us to
   // measure the performance overhead of messaging queue.
   //
-  messaging::RWQueue<size_t> q;
+  messaging::RWQueue<size_t> q("", kReaders);
 
   //
   // Add reader tasks. Reader would continue to read as long as queue is open
@@ -196,15 +197,29 @@ BM_ReplicateQueue(
  *
  * In our benchmark we intends to keep Number of Messages Written same. So when
  * we increase writers, we reduce number of messages per writer (third param)
+ *
+ * BM_RWQueue additionally takes reader mode of the queue as first parameter.
+ * Single reader (lock-free) mode is only benchmarked with one reader.
  */
 
-BENCHMARK_NAMED_PARAM(BM_RWQueue, M1000000_R1_W1, 1, 1, 1000000);
-BENCHMARK_NAMED_PARAM(BM_RWQueue, M1000000_R10_W1, 10, 1, 1000000);
-BENCHMARK_NAMED_PARAM(BM_RWQueue, M1000000_R100_W1, 100, 1, 1000000);
-BENCHMARK_NAMED_PARAM(BM_RWQueue, M1000000_R1000_W1, 1000, 1, 1000000);
-BENCHMARK_NAMED_PARAM(BM_RWQueue, M1000000_R1_W10, 1, 10, 100000);
-BENCHMARK_NAMED_PARAM(BM_RWQueue, M1000000_R1_W100, 1, 100, 10000);
-BENCHMARK_NAMED_PARAM(BM_RWQueue, M1000000_R1_W1000, 1, 1000, 1000);
+// Multiple readers queue
+#define MULTI messaging::QueueReaders::MULTIPLE
+BENCHMARK_NAMED_PARAM(BM_RWQueue, M1000000_R1_W1, MULTI, 1, 1, 1000000);
+BENCHMARK_NAMED_PARAM(BM_RWQueue, M1000000_R10_W1, MULTI, 10, 1, 1000000);
+BENCHMARK_NAMED_PARAM(BM_RWQueue, M1000000_R100_W1, MULTI, 100, 1, 1000000);
+BENCHMARK_NAMED_PARAM(BM_RWQueue, M1000000_R1000_W1, MULTI, 1000, 1, 1000000);
+BENCHMARK_NAMED_PARAM(BM_RWQueue, M1000000_R1_W10, MULTI, 1, 10, 100000);
+BENCHMARK_NAMED_PARAM(BM_RWQueue, M1000000_R1_W100, MULTI, 1, 100, 10000);
+BENCHMARK_NAMED_PARAM(BM_RWQueue, M1000000_R1_W1000, MULTI, 1, 1000, 1000);
+#undef MULTI
+
+// Single reader (lock-free) queue
+#define SINGLE messaging::QueueReaders::SINGLE
+BENCHMARK_NAMED_PARAM(BM_RWQueue, SR_M1000000_R1_W1, SINGLE, 1, 1, 1000000);
+BENCHMARK_NAMED_PARAM(BM_RWQueue, SR_M1000000_R1_W10, SINGLE, 1, 10, 100000);
+BENCHMARK_NAMED_PARAM(BM_RWQueue, SR_M1000000_R1_W100, SINGLE, 1, 100, 10000);
+BENCHMARK_NAMED_PARAM(BM_RWQueue, SR_M1000000_R1_W1000, SINGLE, 1, 1000, 1000);
+#undef SINGLE
 
 BENCHMARK_NAMED_PARAM(BM_ReplicateQueue, M1000000_R1_W1, 1, 1, 1000000);
 BENCHMARK_NAMED_PARAM(BM_ReplicateQueue, M1000000_R10_W1, 10, 1, 1000000);
@@ -6,6 +6,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <thread>
 
 #include <folly/executors/ManualExecutor.h>
 #include <folly/fibers/EventBaseLoopController.h>
@@ -308,6 +309,147 @@ TEST(RWQueueTest, CoroTest) {
 }
 #endif
 
+TEST(RWQueueSingleReaderTest, OrderedPushGet) {
+  RWQueue<std::string> q("", QueueReaders::SINGLE);
+
+  q.push(std::string("one"));
+  q.push(std::string("two"));
+  q.push(std::string("three"));
+
+  EXPECT_EQ(3, q.size());
+  EXPECT_EQ(0, q.numPendingReads());
+  EXPECT_EQ("one", q.get().value());
+  EXPECT_EQ("two", q.get().value());
+  EXPECT_EQ("three", q.get().value());
+  EXPECT_EQ(0, q.size());
+  EXPECT_EQ(3, q.numWrites());
+  EXPECT_EQ(3, q.numReads());
+
+  // Pending data is dropped on close
+  q.push(std::string("four"));
+  q.close();
+  EXPECT_EQ(0, q.size());
+  EXPECT_FALSE(q.push(std::string("five")));
+  EXPECT_EQ(q.get().error(), QueueError::QUEUE_CLOSED);
+}
+
+TEST(RWQueueSingleReaderTest, PendingRead) {
+  RWQueue<int> q("", QueueReaders::SINGLE);
+
+  folly::EventBase evb;
+  auto& manager = folly::fibers::getFiberManager(evb);
+  manager.addTask([&q]() mutable {
+    EXPECT_EQ(1, q.get().value());
+    auto x = q.get(); // Perform read
+    EXPECT_TRUE(q.isClosed());
+    EXPECT_TRUE(x.hasError());
+    EXPECT_EQ(x.error(), QueueError::QUEUE_CLOSED);
+  });
+
+  evb.loopOnce(); // Fiber should get stuck at the read
+  EXPECT_EQ(1, q.numPendingReads());
+
+  q.push(1);
+  evb.loopOnce(); // Fiber should get stuck at the next read
+  EXPECT_EQ(1, q.numPendingReads());
+  EXPECT_EQ(1, q.numReads());
+
+  q.close();
+  evb.loopOnce();
+  EXPECT_EQ(0, q.size());
+  EXPECT_EQ(0, q.numPendingReads());
+}
+
+TEST(RWQueueSingleReaderTest, MultiThreadTest) {
+  const size_t kNumWriters{16};
+  const size_t kCountPerWriter{8192};
+  RWQueue<size_t> q("", QueueReaders::SINGLE);
+  std::vector<std::unique_ptr<folly::EventBase>> evbs;
+
+  // Add reader task. Data of every writer must be read in order
+  size_t totalReads{0};
+  evbs.emplace_back(std::make_unique<folly::EventBase>());
+  folly::fibers::getFiberManager(*evbs.back()).addTask([&q, &totalReads]() {
+    std::vector<size_t> nextNums(kNumWriters, 0);
+    while (true) {
+      auto maybeNum = q.get();
+      if (maybeNum.hasError()) {
+        EXPECT_EQ(QueueError::QUEUE_CLOSED, maybeNum.error());
+        break;
+      }
+      const auto num = maybeNum.value();
+      EXPECT_EQ(nextNums.at(num / kCountPerWriter)++, num % kCountPerWriter);
+      if (++totalReads == kNumWriters * kCountPerWriter) {
+        LOG(INFO) << "Closing queue";
+        q.close();
+      }
+    }
+  });
+
+  // Add writer task
+  for (size_t i = 0; i < kNumWriters; ++i) {
+    evbs.emplace_back(std::make_unique<folly::EventBase>());
+    folly::fibers::getFiberManager(*evbs.back()).addTask([&q, i]() {
+      for (size_t j = 0; j < kCountPerWriter; ++j) {
+        q.push(i * kCountPerWriter + j);
+      }
+    });
+  }
+
+  std::vector<std::thread> evbThreads;
+  for (auto& evb : evbs) {
+    evbThreads.emplace_back([evbPtr = evb.get()]() { evbPtr->loop(); });
+  }
+  for (auto& evbThread : evbThreads) {
+    evbThread.join();
+  }
+
+  EXPECT_EQ(kNumWriters * kCountPerWriter, totalReads);
+  EXPECT_EQ(totalReads, q.numReads());
+  EXPECT_EQ(totalReads, q.numWrites());
+}
+
+#if FOLLY_HAS_COROUTINES
+TEST(RWQueueSingleReaderTest, CoroTest) {
+  const size_t kNumWriters{16};
+  const size_t kCountPerWriter{8192};
+  size_t totalReads{0};
+
+  auto readerCoro = [&totalReads](RWQueue<int>& q) -> folly::coro::Task<void> {
+    while (true) {
+      auto item = co_await q.getCoro();
+      if (item.hasError()) {
+        break;
+      }
+      if (++totalReads == kNumWriters * kCountPerWriter) {
+        q.close();
+      }
+    }
+    co_return;
+  };
+
+  auto writerCoro = [](RWQueue<int>& q,
+                       size_t count) -> folly::coro::Task<void> {
+    for (size_t i = 0; i < count; ++i) {
+      q.push(i);
+    }
+    co_return;
+  };
+
+  RWQueue<int> q("", QueueReaders::SINGLE);
+  folly::ManualExecutor executor;
+  readerCoro(q).scheduleOn(&executor).start();
+  for (size_t i = 0; i < kNumWriters; ++i) {
+    writerCoro(q, kCountPerWriter).scheduleOn(&executor).start();
+  }
+
+  executor.drain();
+  EXPECT_EQ(kNumWriters * kCountPerWriter, totalReads);
+  EXPECT_EQ(0, q.numPendingReads());
+  EXPECT_EQ(totalReads, q.numReads());
+}
+#endif
+
 TEST(RQueueTest, ReadTest) {
   auto rwq = std::make_shared<RWQueue<int>>();
   RQueue<int> rq(rwq);
@@ -339,3 +481,196 @@ TEST(RQueueTest, ReadTest) {
   EXPECT_EQ(0, rwq->size());
 #endif
 }
+
+TEST(RQueueTest, GetAllTest) {
+  for (auto readers : {QueueReaders::MULTIPLE, QueueReaders::SINGLE}) {
+    auto rwq = std::make_shared<RWQueue<int>>("", readers);
+    RQueue<int> rq(rwq);
+
+    for (int i = 1; i <= 5; ++i) {
+      rwq->push(i);
+    }
+
+    // Drain is bounded by maxItems
+    EXPECT_EQ(std::vector<int>({1, 2}), rq.getAll(2).value());
+    EXPECT_EQ(std::vector<int>({3, 4, 5}), rq.getAll().value());
+    EXPECT_EQ(0, rwq->size());
+    EXPECT_EQ(5, rwq->numReads());
+
+    // Wait for first element, then drain the burst
+    folly::EventBase evb;
+    auto& manager = folly::fibers::getFiberManager(evb);
+    manager.addTask([&rq]() mutable {
+      EXPECT_EQ(std::vector<int>({6, 7, 8}), rq.getAll().value());
+      EXPECT_EQ(QueueError::QUEUE_CLOSED, rq.getAll().error());
+    });
+    evb.loopOnce(); // Fiber should get stuck at the read
+    EXPECT_EQ(1, rwq->numPendingReads());
+
+    rwq->push(6);
+    rwq->push(7);
+    rwq->push(8);
+    evb.loopOnce();
+    EXPECT_EQ(1, rwq->numPendingReads());
+    EXPECT_EQ(8, rwq->numReads());
+
+    rwq->close();
+    evb.loop();
+    EXPECT_EQ(0, rwq->numPendingReads());
+
+#if FOLLY_HAS_COROUTINES
+    auto rwqCoro = std::make_shared<RWQueue<int>>("", readers);
+    RQueue<int> rqCoro(rwqCoro);
+    auto coroRead = [](RQueue<int>& rq) -> folly::coro::Task<void> {
+      auto items = co_await rq.getAllCoro();
+      EXPECT_EQ(std::vector<int>({1, 2}), items.value());
+    };
+
+    rwqCoro->push(1);
+    rwqCoro->push(2);
+    folly::ManualExecutor executor;
+    coroRead(rqCoro).scheduleOn(&executor).start();
+    executor.drain();
+    EXPECT_EQ(0, rwqCoro->size());
+    EXPECT_EQ(2, rwqCoro->numReads());
+#endif
+  }
+}
+
+TEST(RWQueueBoundedTest, DropOldest) {
+  QueueLimits<int> limits;
+  limits.capacity = 3;
+  limits.highWatermark = 2;
+  limits.overflowPolicy = QueueOverflowPolicy::DROP_OLDEST;
+  RWQueue<int> q("", QueueReaders::SINGLE, limits);
+
+  for (int i = 1; i <= 5; ++i) {
+    EXPECT_TRUE(q.push(i));
+  }
+  EXPECT_EQ(3, q.size());
+  EXPECT_EQ(5, q.numWrites());
+  EXPECT_EQ(2, q.numDrops());
+  EXPECT_EQ(1, q.numHighWatermarkCrossings());
+  EXPECT_EQ(std::vector<int>({3, 4, 5}), q.getAll().value());
+
+  // Crossing is recorded again once queue has drained below high watermark
+  q.push(6);
+  q.push(7);
+  EXPECT_EQ(2, q.numHighWatermarkCrossings());
+
+  auto stats = q.getStats();
+  EXPECT_EQ(2, stats.drops);
+  EXPECT_EQ(2, stats.highWatermarkCrossings);
+}
+
+TEST(RWQueueBoundedTest, Coalesce) {
+  QueueLimits<std::pair<std::string, int>> limits;
+  limits.capacity = 2;
+  limits.overflowPolicy = QueueOverflowPolicy::COALESCE;
+  limits.coalesceKey = [](std::pair<std::string, int> const& val) {
+    return val.first;
+  };
+  RWQueue<std::pair<std::string, int>> q("", QueueReaders::MULTIPLE, limits);
+
+  q.push(std::make_pair("a", 1));
+  q.push(std::make_pair("b", 1));
+  // Replaces pending element with the same key
+  q.push(std::make_pair("a", 2));
+  EXPECT_EQ(2, q.size());
+  EXPECT_EQ(1, q.numDrops());
+  // No element with the same key, oldest is dropped
+  q.push(std::make_pair("c", 1));
+  EXPECT_EQ(2, q.size());
+  EXPECT_EQ(2, q.numDrops());
+
+  EXPECT_EQ(std::make_pair(std::string("b"), 1), q.get().value());
+  EXPECT_EQ(std::make_pair(std::string("c"), 1), q.get().value());
+}
+
+TEST(RWQueueBoundedTest, BlockWriter) {
+  QueueLimits<int> limits;
+  limits.capacity = 2;
+  RWQueue<int> q("", QueueReaders::SINGLE, limits);
+
+  folly::EventBase evb;
+  auto& manager = folly::fibers::getFiberManager(evb);
+  size_t numPushed{0};
+  manager.addTask([&q, &numPushed]() mutable {
+    for (int i = 1; i <= 4; ++i) {
+      EXPECT_TRUE(q.push(i));
+      ++numPushed;
+    }
+    // Blocked push fails once queue is closed
+    EXPECT_TRUE(q.push(5));
+    EXPECT_FALSE(q.push(6));
+  });
+
+  evb.loopOnce(); // Writer should get stuck on the third push
+  EXPECT_EQ(2, numPushed);
+  EXPECT_EQ(2, q.size());
+
+  EXPECT_EQ(1, q.get().value());
+  evb.loopOnce(); // Writer should get stuck on the fourth push
+  EXPECT_EQ(3, numPushed);
+
+  EXPECT_EQ(std::vector<int>({2, 3}), q.getAll().value());
+  evb.loopOnce(); // Writer should get stuck on the sixth push
+  EXPECT_EQ(4, numPushed);
+  EXPECT_EQ(2, q.size());
+  EXPECT_EQ(0, q.numDrops());
+
+  q.close();
+  evb.loop();
+  EXPECT_EQ(5, q.numWrites());
+}
+
+TEST(RWQueueTest, LatencyBuckets) {
+  for (auto readers : {QueueReaders::MULTIPLE, QueueReaders::SINGLE}) {
+    RWQueue<int> q("", readers);
+
+    q.push(1);
+    q.push(2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(1, q.get().value());
+    EXPECT_EQ(std::vector<int>({2}), q.getAll().value());
+
+    // Both reads waited for more than 4^7 microseconds, i.e. fall into
+    // bucket 8 or above
+    auto stats = q.getStats();
+    ASSERT_EQ(kNumQueueLatencyBuckets, stats.latencyBuckets.size());
+    size_t totalReads{0};
+    for (size_t i = 0; i < kNumQueueLatencyBuckets; ++i) {
+      totalReads += stats.latencyBuckets.at(i);
+      if (i < 8) {
+        EXPECT_EQ(0, stats.latencyBuckets.at(i));
+      }
+    }
+    EXPECT_EQ(2, totalReads);
+    EXPECT_EQ(16384, getQueueLatencyBucketBoundUs(7));
+  }
+}
+
+TEST(RWQueueTest, PriorityLanes) {
+  for (auto readers : {QueueReaders::MULTIPLE, QueueReaders::SINGLE}) {
+    RWQueue<int> q("", readers);
+
+    q.push(1);
+    q.push(2);
+    q.push(10, QueuePriority::HIGH);
+    q.push(3);
+    q.push(20, QueuePriority::HIGH);
+    EXPECT_EQ(5, q.size());
+
+    // High priority lane is drained first, each lane in order
+    EXPECT_EQ(10, q.get().value());
+    EXPECT_EQ(std::vector<int>({20, 1}), q.getAll(2).value());
+    q.push(30, QueuePriority::HIGH);
+    EXPECT_EQ(std::vector<int>({30, 2, 3}), q.getAll().value());
+
+    auto stats = q.getStats();
+    EXPECT_EQ(6, stats.writes);
+    EXPECT_EQ(6, stats.reads);
+    EXPECT_EQ(3, stats.highPriorityWrites);
+    EXPECT_EQ(3, stats.highPriorityReads);
+  }
+}
@@ -110,3 +110,59 @@ TEST(ReplicateQueueTest, OpenQueueTest) {
 
   q.close();
 }
+
+TEST(ReplicateQueueTest, SharedReplicateQueueTest) {
+  SharedReplicateQueue<std::vector<int>> q;
+  auto r1 = q.getReader("r1");
+  auto r2 = q.getReader("r2");
+
+  // Value is pushed once and shared by all readers
+  std::vector<int> value{1, 2, 3};
+  const auto* data = value.data();
+  EXPECT_TRUE(q.push(std::move(value)));
+  EXPECT_EQ(1, q.getNumWrites());
+
+  auto m1 = r1.get().value();
+  auto m2 = r2.get().value();
+  EXPECT_EQ(m1.get(), m2.get());
+  EXPECT_EQ(data, m1->data());
+
+  // Copied while message is shared
+  auto copied = takeOrCopy(std::move(m1));
+  EXPECT_EQ(std::vector<int>({1, 2, 3}), copied);
+  EXPECT_NE(data, copied.data());
+
+  // Moved out by the sole owner
+  auto moved = takeOrCopy(std::move(m2));
+  EXPECT_EQ(data, moved.data());
+
+  // Pushing shared message as is
+  auto message = std::make_shared<const std::vector<int>>(moved);
+  EXPECT_TRUE(q.push(message));
+  EXPECT_EQ(message.get(), r1.get().value().get());
+  EXPECT_EQ(message.get(), r2.get().value().get());
+
+  q.close();
+}
+
+TEST(ReplicateQueueTest, PriorityTest) {
+  ReplicateQueue<std::string> q;
+  auto r1 = q.getReader("r1");
+  auto r2 = q.getReader("r2");
+
+  q.push(std::string("bulk"));
+  q.push(std::string("urgent"), QueuePriority::HIGH);
+
+  // Every reader gets urgent value first
+  EXPECT_EQ("urgent", r1.get().value());
+  EXPECT_EQ("bulk", r1.get().value());
+  EXPECT_EQ("urgent", r2.get().value());
+  EXPECT_EQ("bulk", r2.get().value());
+
+  for (auto const& stat : q.getReplicationStats()) {
+    EXPECT_EQ(1, stat.highPriorityWrites);
+    EXPECT_EQ(1, stat.highPriorityReads);
+  }
+
+  q.close();
+}
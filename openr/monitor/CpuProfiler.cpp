@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "openr/monitor/CpuProfiler.h"
+
+#include <dirent.h>
+#include <execinfo.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <fb303/ServiceData.h>
+#include <fmt/format.h>
+#include <folly/Conv.h>
+#include <folly/FileUtil.h>
+#include <folly/String.h>
+#include <glog/logging.h>
+
+#include <openr/common/Constants.h>
+
+namespace fb303 = facebook::fb303;
+
+namespace openr {
+
+namespace {
+
+// Max number of threads a profile can be restricted to
+constexpr size_t kMaxThreads{64};
+
+// Frames of signal handler and kernel signal trampoline on top of samples
+constexpr size_t kSkipFrames{2};
+
+// Max length of thread name as per Linux, excluding terminating null
+constexpr size_t kMaxThreadNameLen{15};
+
+struct Sample {
+  int depth{0};
+  void* pcs[Constants::kCpuProfileMaxDepth];
+};
+
+// State shared with the signal handler. Handler only ever touches it in
+// async-signal-safe ways, i.e. atomics and pre-allocated memory
+struct SamplerState {
+  std::atomic<bool> active{false};
+  // number of handlers in flight, to drain them on stop
+  std::atomic<int> numInHandler{0};
+  // threads to sample, all threads if empty. Set before activation
+  std::array<pid_t, kMaxThreads> tids{};
+  size_t numTids{0};
+  std::unique_ptr<Sample[]> samples;
+  std::atomic<size_t> numSamples{0};
+};
+
+SamplerState gSampler;
+
+// Guards below and start/stop of gSampler
+std::mutex gMutex;
+bool gRunning{false};
+bool gHandlerInstalled{false};
+
+bool
+isSampledThread() {
+  if (gSampler.numTids == 0) {
+    return true;
+  }
+  const pid_t tid = syscall(SYS_gettid);
+  for (size_t i = 0; i < gSampler.numTids; ++i) {
+    if (gSampler.tids[i] == tid) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void
+onSigprof(int /* sig */, siginfo_t* /* info */, void* /* ucontext */) {
+  const int savedErrno = errno;
+  gSampler.numInHandler.fetch_add(1);
+  if (gSampler.active.load() and isSampledThread()) {
+    const auto idx = gSampler.numSamples.fetch_add(1);
+    if (idx < Constants::kCpuProfileMaxSamples) {
+      auto& sample = gSampler.samples[idx];
+      sample.depth = backtrace(sample.pcs, Constants::kCpuProfileMaxDepth);
+    }
+  }
+  gSampler.numInHandler.fetch_sub(1);
+  errno = savedErrno;
+}
+
+// Ids of threads of this process named `threadName`
+std::vector<pid_t>
+getThreadIds(std::string const& threadName) {
+  std::vector<pid_t> tids;
+  const auto name = threadName.substr(0, kMaxThreadNameLen);
+  auto dir = opendir("/proc/self/task");
+  if (not dir) {
+    return tids;
+  }
+  while (auto entry = readdir(dir)) {
+    if (entry->d_name[0] == '.') {
+      continue;
+    }
+    std::string comm;
+    if (not folly::readFile(
+            fmt::format("/proc/self/task/{}/comm", entry->d_name).c_str(),
+            comm)) {
+      continue;
+    }
+    if (folly::rtrimWhitespace(comm) == name) {
+      tids.emplace_back(folly::to<pid_t>(entry->d_name));
+    }
+  }
+  closedir(dir);
+  return tids;
+}
+
+} // namespace
+
+void
+CpuProfiler::start(std::optional<std::string> const& threadName) {
+  std::lock_guard<std::mutex> lock(gMutex);
+  if (gRunning) {
+    throw std::runtime_error("A CPU profile is already running");
+  }
+
+  gSampler.numTids = 0;
+  if (threadName.has_value()) {
+    const auto tids = getThreadIds(*threadName);
+    if (tids.empty()) {
+      throw std::runtime_error(
+          fmt::format("No thread named {} to profile", *threadName));
+    }
+    if (tids.size() > kMaxThreads) {
+      LOG(WARNING) << "Profiling first " << kMaxThreads << " out of "
+                   << tids.size() << " threads named " << *threadName;
+    }
+    for (auto tid : tids) {
+      if (gSampler.numTids == kMaxThreads) {
+        break;
+      }
+      gSampler.tids[gSampler.numTids++] = tid;
+    }
+  }
+  gSampler.samples =
+      std::make_unique<Sample[]>(Constants::kCpuProfileMaxSamples);
+  gSampler.numSamples = 0;
+
+  // backtrace() lazily loads the unwinder on first call, which is not
+  // async-signal-safe, hence do it here
+  void* pcs[1];
+  backtrace(pcs, 1);
+
+  // Handler stays installed once profiled, as SIGPROF still in flight after
+  // stop would otherwise terminate the process. Inactive it does nothing
+  if (not gHandlerInstalled) {
+    struct sigaction action {};
+    action.sa_sigaction = onSigprof;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGPROF, &action, nullptr) != 0) {
+      gSampler.samples.reset();
+      throw std::runtime_error(fmt::format(
+          "Failed to install SIGPROF handler: {}", folly::errnoStr(errno)));
+    }
+    gHandlerInstalled = true;
+  }
+
+  gSampler.active = true;
+  struct itimerval timer {};
+  timer.it_interval.tv_usec = 1000000 / Constants::kCpuProfileFrequencyHz;
+  timer.it_value = timer.it_interval;
+  if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+    gSampler.active = false;
+    gSampler.samples.reset();
+    throw std::runtime_error(fmt::format(
+        "Failed to start profiling timer: {}", folly::errnoStr(errno)));
+  }
+  gRunning = true;
+  LOG(INFO) << "Started CPU profile of "
+            << (threadName.has_value() ? *threadName : "all threads");
+}
+
+std::string
+CpuProfiler::stop() {
+  std::lock_guard<std::mutex> lock(gMutex);
+  if (not gRunning) {
+    throw std::runtime_error("No CPU profile is running");
+  }
+
+  struct itimerval timer {};
+  setitimer(ITIMER_PROF, &timer, nullptr);
+  gSampler.active = false;
+  // drain handlers which may still be writing a sample
+  while (gSampler.numInHandler.load() != 0) {
+    std::this_thread::yield();
+  }
+  gRunning = false;
+
+  const auto numTaken = gSampler.numSamples.load();
+  const auto numSamples = std::min(numTaken, Constants::kCpuProfileMaxSamples);
+
+  // aggregate identical stacks
+  std::map<std::vector<uintptr_t>, uintptr_t> stacks;
+  for (size_t i = 0; i < numSamples; ++i) {
+    auto const& sample = gSampler.samples[i];
+    if (sample.depth <= static_cast<int>(kSkipFrames)) {
+      continue;
+    }
+    std::vector<uintptr_t> pcs;
+    pcs.reserve(sample.depth - kSkipFrames);
+    for (int j = kSkipFrames; j < sample.depth; ++j) {
+      pcs.emplace_back(reinterpret_cast<uintptr_t>(sample.pcs[j]));
+    }
+    ++stacks[std::move(pcs)];
+  }
+  gSampler.samples.reset();
+
+  // Legacy gperftools CPU profile, in machine words: header of (0, header
+  // words, version, sampling period us, padding), then records of (count,
+  // depth, pcs...), then trailer, followed by the text of /proc/self/maps
+  // for symbolization
+  std::vector<uintptr_t> words{
+      0, 3, 0, 1000000 / Constants::kCpuProfileFrequencyHz, 0};
+  for (auto const& [pcs, count] : stacks) {
+    words.emplace_back(count);
+    words.emplace_back(pcs.size());
+    words.insert(words.end(), pcs.begin(), pcs.end());
+  }
+  words.insert(words.end(), {0, 1, 0});
+
+  std::string output(
+      reinterpret_cast<char const*>(words.data()),
+      words.size() * sizeof(uintptr_t));
+  std::string maps;
+  if (folly::readFile("/proc/self/maps", maps)) {
+    output += maps;
+  }
+
+  const auto path = fmt::format(
+      "{}.{}.{}.prof",
+      Constants::kCpuProfilePathPrefix,
+      getpid(),
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count());
+  if (not folly::writeFile(output, path.c_str())) {
+    throw std::runtime_error(fmt::format(
+        "Failed to write CPU profile {}: {}", path, folly::errnoStr(errno)));
+  }
+
+  fb303::fbData->addStatValue("monitor.cpu_profile.dumped", 1, fb303::COUNT);
+  LOG(INFO) << "Wrote CPU profile " << path << " of " << numSamples
+            << " samples, dropped " << numTaken - numSamples;
+  return path;
+}
+
+bool
+CpuProfiler::isRunning() {
+  std::lock_guard<std::mutex> lock(gMutex);
+  return gRunning;
+}
+
+folly::SemiFuture<std::string>
+CpuProfiler::profile(
+    folly::EventBase* evb,
+    std::chrono::milliseconds duration,
+    std::optional<std::string> const& threadName) {
+  try {
+    start(threadName);
+  } catch (std::exception const& e) {
+    return folly::makeSemiFuture<std::string>(
+        folly::exception_wrapper(std::current_exception(), e));
+  }
+
+  auto [p, sf] = folly::makePromiseContract<std::string>();
+  evb->runInEventBaseThread([evb, duration, p = std::move(p)]() mutable {
+    evb->runAfterDelay(
+        [p = std::move(p)]() mutable {
+          p.setTry(folly::makeTryWith([]() { return stop(); }));
+        },
+        duration.count());
+  });
+  return std::move(sf);
+}
+
+} // namespace openr
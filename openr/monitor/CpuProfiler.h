@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <string>
+
+#include <folly/futures/Future.h>
+#include <folly/io/async/EventBase.h>
+
+namespace openr {
+
+/**
+ * Process wide sampling CPU profiler, the CPU counterpart of heap profiles.
+ *
+ * Samples stacks on SIGPROF delivered by ITIMER_PROF, i.e. only while threads
+ * burn CPU, at `Constants::kCpuProfileFrequencyHz`. Profile is restricted to
+ * threads named `threadName` (as per /proc/self/task/<tid>/comm, hence
+ * truncated to 15 chars) if set, else covers all threads of the process.
+ *
+ * Output is written in legacy gperftools CPU profile format, understood by
+ * `pprof`, e.g.
+ *
+ *   pprof --text /usr/sbin/openr /tmp/openr.cpu.<pid>.<ts>.prof
+ *
+ * Only one profile can run at a time within the process. Thread-safe.
+ */
+class CpuProfiler {
+ public:
+  // start sampling. Throws std::runtime_error if a profile is already running
+  // or no thread matches `threadName`
+  static void start(std::optional<std::string> const& threadName);
+
+  // stop sampling, write profile and return path of written file. Throws
+  // std::runtime_error if no profile is running or writing fails
+  static std::string stop();
+
+  static bool isRunning();
+
+  // start sampling and stop after `duration`, scheduled on `evb`. Returned
+  // future is fulfilled with path of written profile
+  static folly::SemiFuture<std::string> profile(
+      folly::EventBase* evb,
+      std::chrono::milliseconds duration,
+      std::optional<std::string> const& threadName = std::nullopt);
+};
+
+} // namespace openr
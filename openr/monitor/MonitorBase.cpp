@@ -6,6 +6,9 @@
  */
 
 #include "openr/monitor/MonitorBase.h"
+
+#include <fmt/format.h>
+
 #include <openr/common/Constants.h>
 
 namespace openr {
@@ -17,9 +20,11 @@ MonitorBase::MonitorBase(
     : category_{category},
       maxLogEvents_{
           folly::to<uint32_t>(*config->getMonitorConfig().max_event_log_ref())},
+      recentLogs_(maxLogEvents_),
       startTime_{std::chrono::steady_clock::now()} {
   // Initialize stats counter
   fb303::fbData->addStatExportType("monitor.log.publish.failure", fb303::COUNT);
+  fb303::fbData->addStatExportType("monitor.cpu_profile.dumped", fb303::COUNT);
 
   // Periodically set process cpu/uptime/memory counter
   setProcessCounterTimer_ =
@@ -68,15 +73,17 @@ MonitorBase::MonitorBase(
             // throws std::invalid_argument if not exist
             inputLog.getString("event");
 
-            // add to recent log list
-            if (recentLog_.size() >= maxLogEvents_) {
-              recentLog_.pop_front();
+            // add to recent log ring, overwriting the oldest
+            auto log = std::make_shared<const LogSample>(std::move(inputLog));
+            if (not recentLogs_.empty()) {
+              const auto idx = numRecentLogs_.load(std::memory_order_relaxed);
+              recentLogs_[idx % recentLogs_.size()].store(log);
+              numRecentLogs_.store(idx + 1, std::memory_order_release);
             }
-            recentLog_.emplace_back(inputLog.toJson());
 
             // publish the log if enable log submission
             if (config->isLogSubmissionEnabled()) {
-              processEventLog(inputLog);
+              processEventLog(*log);
             }
           } catch (const std::exception& e) {
             fb303::fbData->addStatValue(
@@ -90,7 +97,23 @@ MonitorBase::MonitorBase(
 
 std::list<std::string>
 MonitorBase::getRecentEventLogs() {
-  return recentLog_;
+  std::list<std::string> logs;
+  const uint64_t numLogs = numRecentLogs_.load(std::memory_order_acquire);
+  const uint64_t size = recentLogs_.size();
+  for (auto i = numLogs - std::min(numLogs, size); i < numLogs; ++i) {
+    // slot may have been overwritten by a newer log in the meantime
+    if (auto log = recentLogs_[i % size].load()) {
+      logs.emplace_back(log->toJson());
+    }
+  }
+  return logs;
+}
+
+folly::SemiFuture<std::string>
+MonitorBase::dumpCpuProfile(
+    std::chrono::milliseconds duration,
+    std::optional<std::string> const& threadName) {
+  return CpuProfiler::profile(getEvb(), duration, threadName);
 }
 
 void
@@ -113,6 +136,13 @@ MonitorBase::updateProcessCounters() {
   if (cpuPct.has_value()) {
     fb303::fbData->setCounter("process.cpu.pct", cpuPct.value());
   }
+
+  // set process.thread.<name>.cpu.pct counters, e.g. to tell if a module
+  // thread is saturated
+  for (auto const& [name, pct] : systemMetrics_.getThreadCPUpercentages()) {
+    fb303::fbData->setCounter(
+        fmt::format("process.thread.{}.cpu.pct", name), pct);
+  }
 }
 
 } // namespace openr
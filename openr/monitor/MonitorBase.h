@@ -8,11 +8,13 @@
 #pragma once
 
 #include <folly/Function.h>
+#include <folly/concurrency/AtomicSharedPtr.h>
 
 #include <fb303/ServiceData.h>
 #include <openr/common/OpenrEventBase.h>
 #include <openr/config/Config.h>
 #include <openr/messaging/ReplicateQueue.h>
+#include <openr/monitor/CpuProfiler.h>
 #include <openr/monitor/LogSample.h>
 #include <openr/monitor/SystemMetrics.h>
 
@@ -25,9 +27,11 @@ namespace openr {
  * implements common functions:
  * 1. Start a fiber to read the log queue and export logs to database based on
  *    subclass's processEventLog() implementation.
- * 2. Store and return the most recent logs;
+ * 2. Store the most recent logs in a fixed-size ring and return them
+ *    serialized on read;
  * 3. Export process counters: process.memory.rss, process.uptime,
  *    and process.cpu.pct
+ * 4. Dump heap profiles periodically and CPU profiles on demand
  */
 class MonitorBase : public OpenrEventBase {
  public:
@@ -36,9 +40,15 @@ class MonitorBase : public OpenrEventBase {
       const std::string& category,
       messaging::RQueue<LogSample> logSampleQueue);
 
-  // Get recent event logs
+  // Get recent event logs, oldest first. Thread-safe, lock-free
   std::list<std::string> getRecentEventLogs();
 
+  // Take a sampling CPU profile of all threads, or of `threadName` only if
+  // set, for `duration`. Future holds path of the written profile
+  folly::SemiFuture<std::string> dumpCpuProfile(
+      std::chrono::milliseconds duration,
+      std::optional<std::string> const& threadName = std::nullopt);
+
   // Destructor
   virtual ~MonitorBase() = default;
 
@@ -62,8 +72,12 @@ class MonitorBase : public OpenrEventBase {
   // Number of last log events to queue
   const uint32_t maxLogEvents_{0};
 
-  // List of recent log
-  std::list<std::string> recentLog_{};
+  // Fixed-size ring of recent logs, kept structured and serialized only on
+  // read. Written by log processing fiber only, read from any thread
+  std::vector<folly::atomic_shared_ptr<const LogSample>> recentLogs_;
+
+  // Number of logs ever written to recentLogs_, published after each write
+  std::atomic<uint64_t> numRecentLogs_{0};
 
   // Timer to periodically set process cpu/uptime/memory counter
   std::unique_ptr<folly::AsyncTimeout> setProcessCounterTimer_;
@@ -7,6 +7,11 @@
 
 #include "openr/monitor/SystemMetrics.h"
 
+#include <dirent.h>
+#include <unistd.h>
+
+#include <sstream>
+
 namespace openr {
 
 /* Return RSS memory the process currently used from /proc/[pid]/status.
@@ -74,6 +79,79 @@ SystemMetrics::getCPUpercentage() {
   return cpuPct;
 }
 
+/* Return CPU% used by each thread named with `namePrefix`, from
+ / /proc/self/task/[tid]/stat. Fields 14 and 15 (after the thread name in
+ / parentheses) are the user and system CPU time in clock ticks.
+ /
+ / A thread is reported from the second query after it started, as CPU%
+ / needs the time difference of two queries.
+*/
+std::unordered_map<std::string, double>
+SystemMetrics::getThreadCPUpercentages(std::string const& namePrefix) {
+  std::unordered_map<std::string, double> threadCpuPcts;
+  std::unordered_map<std::string, uint64_t> threadCpuTicks;
+  const auto timestamp = getCurrentNanoTime();
+  static const auto ticksPerSec = sysconf(_SC_CLK_TCK);
+
+  auto dir = opendir("/proc/self/task");
+  if (not dir) {
+    LOG(ERROR) << "Fail to open \"/proc/self/task\" of current process";
+    return threadCpuPcts;
+  }
+  while (auto entry = readdir(dir)) {
+    if (entry->d_name[0] == '.') {
+      continue;
+    }
+    const std::string tid(entry->d_name);
+    std::ifstream input("/proc/self/task/" + tid + "/stat");
+    std::string stat;
+    if (not std::getline(input, stat)) {
+      continue; // thread is gone
+    }
+
+    // thread name may contain spaces and parentheses, e.g. "(a) b"
+    const auto nameBegin = stat.find('(');
+    const auto nameEnd = stat.rfind(')');
+    if (nameBegin == std::string::npos or nameEnd == std::string::npos or
+        nameEnd < nameBegin) {
+      continue;
+    }
+    const auto name = stat.substr(nameBegin + 1, nameEnd - nameBegin - 1);
+    if (name.compare(0, namePrefix.size(), namePrefix) != 0) {
+      continue;
+    }
+
+    // skip fields 3 (state) to 13 to reach utime and stime
+    std::istringstream fields(stat.substr(nameEnd + 1));
+    std::string field;
+    for (int i = 3; i <= 13; ++i) {
+      fields >> field;
+    }
+    uint64_t utime{0}, stime{0};
+    if (not(fields >> utime >> stime)) {
+      continue;
+    }
+    const auto ticks = utime + stime;
+    threadCpuTicks.emplace(tid, ticks);
+
+    auto it = prevThreadCpuTicks.find(tid);
+    if (it == prevThreadCpuTicks.end() or ticks < it->second or
+        timestamp <= prevThreadTimestamp) {
+      continue;
+    }
+    const double cpuSecs = (double)(ticks - it->second) / ticksPerSec;
+    const double elapsedSecs = (timestamp - prevThreadTimestamp) / 1.0e9;
+    threadCpuPcts[name] += cpuSecs / elapsedSecs * 100;
+  }
+  closedir(dir);
+
+  // update the cache for next CPU% update. Exited threads are dropped
+  prevThreadCpuTicks = std::move(threadCpuTicks);
+  prevThreadTimestamp = timestamp;
+
+  return threadCpuPcts;
+}
+
 // get current timestamp
 uint64_t
 SystemMetrics::getCurrentNanoTime() {
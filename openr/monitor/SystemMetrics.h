@@ -13,6 +13,9 @@
 #include <sys/time.h>
 #include <chrono>
 #include <fstream>
+#include <optional>
+#include <string>
+#include <unordered_map>
 
 namespace openr {
 
@@ -28,6 +31,12 @@ class SystemMetrics {
   // get CPU% the process used
   std::optional<double> getCPUpercentage();
 
+  // get CPU% used by each thread whose name starts with `namePrefix`, keyed
+  // by thread name. Threads sharing a name (e.g. pools) are summed up. Like
+  // getCPUpercentage, threads show up from their second query on.
+  std::unordered_map<std::string, double> getThreadCPUpercentages(
+      std::string const& namePrefix = "openr");
+
  private:
   /**
   / To record CPU used time of current process (in nanoseconds)
@@ -50,6 +59,11 @@ class SystemMetrics {
   // cache for CPU used time of previous query
   ProcCpuTime prevCpuTime;
 
+  // cache for CPU used time (in clock ticks) of threads at previous query,
+  // along with its timestamp
+  std::unordered_map<std::string /* tid */, uint64_t> prevThreadCpuTicks;
+  uint64_t prevThreadTimestamp = 0;
+
   // get current timestamp (in nanoseconds)
   uint64_t static getCurrentNanoTime();
 };
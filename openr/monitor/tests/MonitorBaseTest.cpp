@@ -7,6 +7,7 @@
 
 #include <openr/monitor/MonitorBase.h>
 
+#include <folly/FileUtil.h>
 #include <glog/logging.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -112,6 +113,38 @@ TEST_F(MonitorTestFixture, LogBasicOperation) {
   }
 }
 
+TEST_F(MonitorTestFixture, RecentLogRingTest) {
+  EXPECT_CALL(*monitor, processEventLog(_)).Times(AnyNumber());
+
+  // Overflow the ring of recent logs
+  const int64_t maxLogs = thrift::MonitorConfig().get_max_event_log();
+  const int64_t numLogs = maxLogs + 50;
+  for (int64_t i = 0; i < numLogs; ++i) {
+    LogSample log;
+    log.addString("event", "event_unit_test");
+    log.addInt("num", i);
+    eventLogUpdatesQueue.push(log);
+  }
+
+  // Wait for the last log to be processed
+  while (true) {
+    auto logs = monitor->getRecentEventLogs();
+    if (not logs.empty() and
+        LogSample::fromJson(logs.back()).getInt("num") == numLogs - 1) {
+      break;
+    }
+    std::this_thread::yield();
+  }
+
+  // Only latest logs are kept, oldest first
+  auto logs = monitor->getRecentEventLogs();
+  ASSERT_EQ(maxLogs, static_cast<int64_t>(logs.size()));
+  int64_t expectedNum = numLogs - maxLogs;
+  for (auto const& log : logs) {
+    EXPECT_EQ(expectedNum++, LogSample::fromJson(log).getInt("num"));
+  }
+}
+
 TEST_F(MonitorTestFixture, ProcessCounterTest) {
   // Wait for calling getCPUpercentage() twice for calculating the cpu% counter
   while (true) {
@@ -129,6 +162,43 @@ TEST_F(MonitorTestFixture, ProcessCounterTest) {
   }
 }
 
+TEST_F(MonitorTestFixture, CpuProfileTest) {
+  // No thread to profile
+  EXPECT_THROW(
+      monitor->dumpCpuProfile(std::chrono::milliseconds(100), "no-such-thread")
+          .get(),
+      std::runtime_error);
+
+  auto sf = monitor->dumpCpuProfile(std::chrono::milliseconds(500));
+  // Only one profile at a time
+  EXPECT_THROW(
+      monitor->dumpCpuProfile(std::chrono::milliseconds(100)).get(),
+      std::runtime_error);
+
+  // Burn some CPU to be sampled
+  const auto start = std::chrono::steady_clock::now();
+  volatile uint64_t sum{0};
+  while (std::chrono::steady_clock::now() - start <
+         std::chrono::milliseconds(500)) {
+    sum = sum + 1;
+  }
+
+  const auto path = std::move(sf).get();
+  std::string content;
+  ASSERT_TRUE(folly::readFile(path.c_str(), content));
+  ASSERT_GT(content.size(), 5 * sizeof(uintptr_t));
+  // legacy pprof header: (0, 3, 0, period us, 0)
+  const auto words = reinterpret_cast<const uintptr_t*>(content.data());
+  EXPECT_EQ(uintptr_t{0}, words[0]);
+  EXPECT_EQ(uintptr_t{3}, words[1]);
+  EXPECT_EQ(uintptr_t{0}, words[2]);
+  EXPECT_EQ(
+      static_cast<uintptr_t>(1000000 / Constants::kCpuProfileFrequencyHz),
+      words[3]);
+  EXPECT_FALSE(CpuProfiler::isRunning());
+  std::remove(path.c_str());
+}
+
 int
 main(int argc, char* argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
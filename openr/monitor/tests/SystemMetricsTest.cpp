@@ -7,6 +7,10 @@
 
 #include <openr/monitor/SystemMetrics.h>
 
+#include <atomic>
+#include <thread>
+
+#include <folly/system/ThreadName.h>
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
@@ -41,6 +45,37 @@ TEST(MonitorTestFixture, SystemMetrics) {
   EXPECT_GT(cpu2.value(), 0);
 }
 
+TEST(MonitorTestFixture, ThreadCpuPercentage) {
+  SystemMetrics systemMetrics_{};
+  std::atomic<bool> started{false};
+  std::atomic<bool> stop{false};
+
+  // Busy thread named with prefix of Open/R threads
+  std::thread busyThread([&]() {
+    folly::setThreadName("openr-busy");
+    started = true;
+    while (not stop) {
+    }
+  });
+  while (not started) {
+    std::this_thread::yield();
+  }
+
+  // First query only records CPU time of threads
+  EXPECT_TRUE(systemMetrics_.getThreadCPUpercentages().empty());
+
+  /* sleep override */
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  auto threadCpuPcts = systemMetrics_.getThreadCPUpercentages();
+  stop = true;
+  busyThread.join();
+
+  // Test thread itself isn't named with prefix
+  EXPECT_EQ(1, threadCpuPcts.size());
+  ASSERT_EQ(1, threadCpuPcts.count("openr-busy"));
+  EXPECT_GT(threadCpuPcts.at("openr-busy"), 50);
+}
+
 int
 main(int argc, char* argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
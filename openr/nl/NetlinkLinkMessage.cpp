@@ -63,7 +63,10 @@ NetlinkLinkMessage::init(int type, uint32_t linkFlags) {
   ifinfomsg_ = reinterpret_cast<struct ifinfomsg*>((char*)msghdr_ + nlmsgAlen);
 
   ifinfomsg_->ifi_flags = linkFlags;
-  ifinfomsg_->ifi_change = 0xffffffff;
+  // NOTE: Dump request must not set it with strict checks on socket
+  if (type != RTM_GETLINK) {
+    ifinfomsg_->ifi_change = 0xffffffff;
+  }
 }
 
 Link
@@ -5,15 +5,85 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <mutex>
+
+#include <fb303/ServiceData.h>
+
 #include <openr/nl/NetlinkMessageBase.h>
 
+using facebook::fb303::fbData;
+namespace fb303 = facebook::fb303;
+
 namespace openr::fbnl {
 
+namespace {
+
+constexpr size_t kNumSizeClasses{kMaxNlPayloadSize / kNlBufferSizeClass};
+
+struct FreeList {
+  std::mutex lock;
+  std::vector<char*> buffers;
+};
+
+std::array<FreeList, kNumSizeClasses>&
+getFreeLists() {
+  // NOTE: Intentionally leaked to outlive messages destroyed on exit
+  static auto* freeLists = new std::array<FreeList, kNumSizeClasses>();
+  return *freeLists;
+}
+
+} // namespace
+
+size_t
+NetlinkBufferPool::getSizeClass(size_t size) {
+  CHECK_GT(size, 0);
+  CHECK_LE(size, kMaxNlPayloadSize);
+  return (size - 1) / kNlBufferSizeClass;
+}
+
+char*
+NetlinkBufferPool::allocate(size_t size) {
+  const auto sizeClass = getSizeClass(size);
+  auto& freeList = getFreeLists().at(sizeClass);
+  {
+    std::lock_guard<std::mutex> l(freeList.lock);
+    if (not freeList.buffers.empty()) {
+      auto buf = freeList.buffers.back();
+      freeList.buffers.pop_back();
+      fbData->addStatValue("netlink.buffer_pool.hit", 1, fb303::SUM);
+      return buf;
+    }
+  }
+  fbData->addStatValue("netlink.buffer_pool.miss", 1, fb303::SUM);
+  return new char[(sizeClass + 1) * kNlBufferSizeClass];
+}
+
+void
+NetlinkBufferPool::release(char* buf, size_t size) {
+  const auto sizeClass = getSizeClass(size);
+  // Memory budget is divided equally among size classes
+  const size_t maxBuffers = kNlBufferPoolMaxBytes / kNumSizeClasses /
+      ((sizeClass + 1) * kNlBufferSizeClass);
+  auto& freeList = getFreeLists().at(sizeClass);
+  {
+    std::lock_guard<std::mutex> l(freeList.lock);
+    if (freeList.buffers.size() < maxBuffers) {
+      freeList.buffers.emplace_back(buf);
+      return;
+    }
+  }
+  delete[] buf;
+}
+
 NetlinkMessageBase::NetlinkMessageBase()
-    : msghdr_(reinterpret_cast<struct nlmsghdr*>(msg.data())) {}
+    : buf_(NetlinkBufferPool::allocate(kMaxNlPayloadSize)),
+      bufSize_(kMaxNlPayloadSize) {
+  // NOTE: Message fields not set explicitly are expected to be zero
+  ::memset(buf_, 0, bufSize_);
+  msghdr_ = reinterpret_cast<struct nlmsghdr*>(buf_);
+}
 
-NetlinkMessageBase::NetlinkMessageBase(int type)
-    : msghdr_(reinterpret_cast<struct nlmsghdr*>(msg.data())) {
+NetlinkMessageBase::NetlinkMessageBase(int type) : NetlinkMessageBase() {
   // initialize netlink header
   msghdr_->nlmsg_len = NLMSG_LENGTH(0);
   msghdr_->nlmsg_type = type;
@@ -21,6 +91,22 @@ NetlinkMessageBase::NetlinkMessageBase(int type)
 
 NetlinkMessageBase::~NetlinkMessageBase() {
   CHECK(promise_.isFulfilled());
+  NetlinkBufferPool::release(buf_, bufSize_);
+}
+
+void
+NetlinkMessageBase::compact() {
+  const size_t size = NLMSG_ALIGN(msghdr_->nlmsg_len);
+  if (NetlinkBufferPool::getSizeClass(size) ==
+      NetlinkBufferPool::getSizeClass(bufSize_)) {
+    return; // Already in buffer of right size
+  }
+  auto buf = NetlinkBufferPool::allocate(size);
+  ::memcpy(buf, buf_, size);
+  NetlinkBufferPool::release(buf_, bufSize_);
+  buf_ = buf;
+  bufSize_ = size;
+  msghdr_ = reinterpret_cast<struct nlmsghdr*>(buf_);
 }
 
 struct nlmsghdr*
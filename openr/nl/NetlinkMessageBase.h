@@ -25,6 +25,36 @@ namespace openr::fbnl {
 
 constexpr uint16_t kMaxNlPayloadSize{4096};
 
+// Buffers of netlink messages are allocated in multiples of this size
+constexpr size_t kNlBufferSizeClass{256};
+static_assert(kMaxNlPayloadSize % kNlBufferSizeClass == 0);
+
+// Upper bound on the memory held by free buffers in NetlinkBufferPool
+constexpr size_t kNlBufferPoolMaxBytes{64 * 1024 * 1024};
+
+/*
+ * Pool of buffers for netlink messages, bucketed in size classes of
+ * `kNlBufferSizeClass` bytes upto `kMaxNlPayloadSize`. Buffer of a message is
+ * recycled on its destruction (i.e. on completion of request) instead of
+ * being returned to the allocator. Buffers can be allocated and released from
+ * any thread.
+ *
+ * Exposed fb303 counters
+ *   netlink.buffer_pool.hit : Allocations served from the pool
+ *   netlink.buffer_pool.miss : Allocations served by the allocator
+ */
+class NetlinkBufferPool {
+ public:
+  // Allocate buffer of at-least `size` bytes (upto `kMaxNlPayloadSize`)
+  static char* allocate(size_t size);
+
+  // Release buffer allocated with the same `size`
+  static void release(char* buf, size_t size);
+
+  // Index of size class for the given size
+  static size_t getSizeClass(size_t size);
+};
+
 /*
  * Data structure representing a netlink message, either to be sent or received.
  * It wraps `struct nlmsghdr` and provides buffer for appending message payload.
@@ -35,6 +65,8 @@ constexpr uint16_t kMaxNlPayloadSize{4096};
  * C++ object (application) to/from bytes (kernel).
  *
  * Maximum size of message is limited by `kMaxNlPayloadSize` parameter.
+ * Message is built in a buffer of maximum size and moved to a buffer of its
+ * actual size with `compact()` before it is queued for sending.
  */
 /*
  * For netlink reference:
@@ -100,8 +132,13 @@ class NetlinkMessageBase {
   // get current length
   uint32_t getDataLength() const;
 
-  // Buffer to create message
-  std::array<char, kMaxNlPayloadSize> msg = {};
+  /**
+   * Move message to a buffer of its actual size and release the one of
+   * `kMaxNlPayloadSize` used for building it. Must be invoked only once the
+   * message is built as it invalidates the pointers into the message held by
+   * sub-classes.
+   */
+  void compact();
 
   /**
    * APIs for accumulating objects of `GET_<>` request. These APIs are invoked
@@ -138,6 +175,11 @@ class NetlinkMessageBase {
     CHECK(false) << "Must be implemented by subclass";
   }
 
+  virtual void
+  rcvdNexthop(NextHopObject&& /* nexthop */) {
+    CHECK(false) << "Must be implemented by subclass";
+  }
+
   /**
    * Get SemiFuture associated with the the associated netlink request. Upon
    * receipt of the ack from kernel, the value will be set.
@@ -204,6 +246,10 @@ class NetlinkMessageBase {
   // Promise to relay the status code received from kernel
   folly::Promise<int> promise_;
 
+  // Buffer holding the message, allocated from NetlinkBufferPool
+  char* buf_{nullptr};
+  size_t bufSize_{0};
+
   // Timestamp when message object was created
   const std::chrono::steady_clock::time_point createTs_{
       std::chrono::steady_clock::now()};
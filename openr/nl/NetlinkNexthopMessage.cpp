@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <openr/nl/NetlinkNexthopMessage.h>
+#include <openr/nl/NetlinkRouteMessage.h>
+
+namespace openr::fbnl {
+NetlinkNexthopMessage::NetlinkNexthopMessage() : NetlinkMessageBase() {}
+
+NetlinkNexthopMessage::~NetlinkNexthopMessage() {
+  CHECK(nexthopPromise_.isFulfilled());
+}
+
+void
+NetlinkNexthopMessage::rcvdNexthop(NextHopObject&& nexthop) {
+  rcvdNexthops_.emplace_back(std::move(nexthop));
+}
+
+void
+NetlinkNexthopMessage::setReturnStatus(int status) {
+  if (status == 0) {
+    nexthopPromise_.setValue(std::move(rcvdNexthops_));
+  } else {
+    nexthopPromise_.setValue(folly::makeUnexpected(status));
+  }
+  NetlinkMessageBase::setReturnStatus(status);
+}
+
+void
+NetlinkNexthopMessage::init(int type) {
+  if (type != RTM_NEWNEXTHOP && type != RTM_DELNEXTHOP &&
+      type != RTM_GETNEXTHOP) {
+    LOG(ERROR) << "Incorrect Netlink message type";
+    return;
+  }
+
+  // initialize netlink header
+  msghdr_->nlmsg_len = NLMSG_LENGTH(sizeof(struct nhmsg));
+  msghdr_->nlmsg_type = type;
+  msghdr_->nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK;
+
+  if (type == RTM_GETNEXTHOP) {
+    // Get all nexthops
+    msghdr_->nlmsg_flags |= NLM_F_DUMP;
+  }
+
+  if (type == RTM_NEWNEXTHOP) {
+    // We create new nexthop or replace existing
+    msghdr_->nlmsg_flags |= NLM_F_CREATE;
+    msghdr_->nlmsg_flags |= NLM_F_REPLACE;
+  }
+
+  // intialize the nexthop message header
+  auto nlmsgAlen = NLMSG_ALIGN(sizeof(struct nlmsghdr));
+  nhmsg_ = reinterpret_cast<struct nhmsg*>((char*)msghdr_ + nlmsgAlen);
+}
+
+std::vector<int32_t>
+NetlinkNexthopMessage::parseMplsLabels(const struct rtattr* nhAttr) {
+  std::vector<int32_t> pushLabels;
+  const struct rtattr* mplsAttr;
+  int mplsAttrLen = RTA_PAYLOAD(nhAttr);
+  for (mplsAttr = reinterpret_cast<struct rtattr*> RTA_DATA(nhAttr);
+       RTA_OK(mplsAttr, mplsAttrLen);
+       mplsAttr = RTA_NEXT(mplsAttr, mplsAttrLen)) {
+    if (mplsAttr->rta_type != MPLS_IPTUNNEL_DST) {
+      continue;
+    }
+    const struct mpls_label* mplsLabels =
+        reinterpret_cast<struct mpls_label*> RTA_DATA(mplsAttr);
+    int numLabels = RTA_PAYLOAD(mplsAttr) / sizeof(struct mpls_label);
+    CHECK_LE(numLabels, kMaxLabels);
+    for (int i = 0; i < numLabels; i++) {
+      pushLabels.emplace_back(ntohl(mplsLabels[i].entry) >> kLabelShift);
+    }
+  }
+  // reverse the push labels becasue thrift API definition.
+  std::reverse(pushLabels.begin(), pushLabels.end());
+  return pushLabels;
+}
+
+NextHopObject
+NetlinkNexthopMessage::parseMessage(const struct nlmsghdr* nlmsg) {
+  const struct nhmsg* const nhEntry =
+      reinterpret_cast<struct nhmsg*>(NLMSG_DATA(nlmsg));
+
+  uint32_t id{0};
+  std::vector<std::pair<uint32_t, uint8_t>> group;
+  NextHopBuilder nhBuilder;
+  bool isNextHop{false};
+
+  const struct rtattr* nhAttr;
+  auto nhAttrLen = NLMSG_PAYLOAD(nlmsg, sizeof(struct nhmsg));
+  // process all nexthop attributes
+  for (nhAttr = reinterpret_cast<const struct rtattr*>(
+           reinterpret_cast<const char*>(nhEntry) +
+           NLMSG_ALIGN(sizeof(struct nhmsg)));
+       RTA_OK(nhAttr, nhAttrLen);
+       nhAttr = RTA_NEXT(nhAttr, nhAttrLen)) {
+    switch (nhAttr->rta_type) {
+    case NHA_ID: {
+      id = *(reinterpret_cast<uint32_t*> RTA_DATA(nhAttr));
+    } break;
+    case NHA_GROUP: {
+      const struct nexthop_grp* members =
+          reinterpret_cast<struct nexthop_grp*> RTA_DATA(nhAttr);
+      const size_t numMembers =
+          RTA_PAYLOAD(nhAttr) / sizeof(struct nexthop_grp);
+      for (size_t i = 0; i < numMembers; ++i) {
+        // kernel stores weight - 1
+        group.emplace_back(members[i].id, members[i].weight + 1);
+      }
+    } break;
+    case NHA_OIF: {
+      isNextHop = true;
+      nhBuilder.setIfIndex(*(reinterpret_cast<int*> RTA_DATA(nhAttr)));
+    } break;
+    case NHA_GATEWAY: {
+      isNextHop = true;
+      auto ipAddress = parseIp(nhAttr, nhEntry->nh_family);
+      if (ipAddress.hasValue()) {
+        nhBuilder.setGateway(ipAddress.value());
+      }
+    } break;
+    case NHA_ENCAP: {
+      auto pushLabels = parseMplsLabels(nhAttr);
+      if (not pushLabels.empty()) {
+        nhBuilder.setPushLabels(pushLabels);
+        nhBuilder.setLabelAction(thrift::MplsActionCode::PUSH);
+      }
+    } break;
+    }
+  }
+
+  NextHopObject nexthop(id, nhEntry->nh_protocol);
+  if (not group.empty()) {
+    nexthop.setGroup(std::move(group));
+  } else if (isNextHop) {
+    nexthop.setNextHop(nhBuilder.build());
+  }
+
+  VLOG(3) << "Netlink parsed nexthop message. " << nexthop.str();
+  return nexthop;
+}
+
+int
+NetlinkNexthopMessage::addNexthop(const NextHopObject& nexthop) {
+  init(RTM_NEWNEXTHOP);
+
+  nhmsg_->nh_family = nexthop.getFamily();
+  nhmsg_->nh_protocol = nexthop.getProtocolId();
+
+  int status{0};
+  const uint32_t id = nexthop.getId();
+  if ((status = addAttributes(
+           NHA_ID, reinterpret_cast<const char*>(&id), sizeof(uint32_t)))) {
+    return status;
+  }
+
+  if (nexthop.isGroup()) {
+    return addGroupAttributes(nexthop.getGroup());
+  }
+  if (nexthop.getNextHop().has_value()) {
+    return addNextHopAttributes(nexthop.getNextHop().value());
+  }
+  LOG(ERROR) << "Neither nexthop nor group specified. " << nexthop.str();
+  return EINVAL;
+}
+
+int
+NetlinkNexthopMessage::deleteNexthop(const NextHopObject& nexthop) {
+  init(RTM_DELNEXTHOP);
+
+  // Nexthop object is identified by its ID only
+  const uint32_t id = nexthop.getId();
+  return addAttributes(
+      NHA_ID, reinterpret_cast<const char*>(&id), sizeof(uint32_t));
+}
+
+int
+NetlinkNexthopMessage::addNextHopAttributes(const NextHop& nextHop) {
+  int status{0};
+
+  // Kernel requires output interface for non-blackhole nexthop
+  if (not nextHop.getIfIndex().has_value()) {
+    LOG(ERROR) << "Interface index not provided for nexthop object";
+    return EINVAL;
+  }
+  const uint32_t oif = nextHop.getIfIndex().value();
+  if ((status = addAttributes(
+           NHA_OIF, reinterpret_cast<const char*>(&oif), sizeof(uint32_t)))) {
+    return status;
+  }
+
+  const auto via = nextHop.getGateway();
+  if (via.has_value()) {
+    if ((status = addAttributes(
+             NHA_GATEWAY,
+             reinterpret_cast<const char*>(via->bytes()),
+             via->byteCount()))) {
+      return status;
+    }
+  }
+
+  // Only PUSH action is supported for IP nexthops
+  const auto action = nextHop.getLabelAction();
+  if (not action.has_value()) {
+    return status;
+  }
+  if (action.value() != thrift::MplsActionCode::PUSH) {
+    LOG(ERROR) << "Unsupported label action for nexthop object";
+    return EINVAL;
+  }
+  auto labels = nextHop.getPushLabels();
+  if (not labels.has_value()) {
+    LOG(ERROR) << "Labels not provided for PUSH action";
+    return EINVAL;
+  }
+
+  // NHA_ENCAP [MPLS_IPTUNNEL_DST]
+  CHECK_LE(labels->size(), kMaxLabels);
+  std::array<struct mpls_label, kMaxLabels> mplsLabel;
+  std::reverse(labels->begin(), labels->end());
+  for (size_t i = 0; i < labels->size(); ++i) {
+    const bool bos = i == labels->size() - 1;
+    mplsLabel[i].entry = NetlinkRouteMessage::encodeLabel(labels->at(i), bos);
+  }
+  std::array<char, kMaxNlPayloadSize> encap = {};
+  struct rtattr* rta = reinterpret_cast<struct rtattr*>(encap.data());
+  rta->rta_type = NHA_ENCAP;
+  rta->rta_len = RTA_LENGTH(0);
+  if (addSubAttributes(
+          rta,
+          MPLS_IPTUNNEL_DST,
+          mplsLabel.data(),
+          labels->size() * sizeof(struct mpls_label)) == nullptr) {
+    return ENOBUFS;
+  }
+  if ((status = addAttributes(
+           NHA_ENCAP,
+           reinterpret_cast<const char*>(RTA_DATA(rta)),
+           RTA_PAYLOAD(rta)))) {
+    return status;
+  }
+
+  // NHA_ENCAP_TYPE
+  const uint16_t encapType = LWTUNNEL_ENCAP_MPLS;
+  return addAttributes(
+      NHA_ENCAP_TYPE,
+      reinterpret_cast<const char*>(&encapType),
+      sizeof(uint16_t));
+}
+
+int
+NetlinkNexthopMessage::addGroupAttributes(
+    const std::vector<std::pair<uint32_t, uint8_t>>& group) {
+  std::vector<struct nexthop_grp> members(group.size());
+  for (size_t i = 0; i < group.size(); ++i) {
+    members[i].id = group[i].first;
+    // kernel stores weight - 1. Weight 0 is treated as 1
+    members[i].weight = group[i].second ? group[i].second - 1 : 0;
+  }
+  return addAttributes(
+      NHA_GROUP,
+      reinterpret_cast<const char*>(members.data()),
+      members.size() * sizeof(struct nexthop_grp));
+}
+
+} // namespace openr::fbnl
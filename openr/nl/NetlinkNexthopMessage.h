@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <openr/nl/NetlinkMessageBase.h>
+#include <openr/nl/NetlinkTypes.h>
+
+extern "C" {
+#include <linux/nexthop.h>
+}
+
+namespace openr::fbnl {
+/**
+ * Message specialization for rtnetlink NEXTHOP type (Linux 5.3+)
+ *
+ * For reference: https://man7.org/linux/man-pages/man8/ip-nexthop.8.html
+ *
+ * RTM_NEWNEXTHOP, RTM_DELNEXTHOP, RTM_GETNEXTHOP
+ *    Add, delete, or retrieve a nexthop object. Nexthop object is either a
+ *    single nexthop (NHA_OIF, NHA_GATEWAY, NHA_ENCAP) or a group of nexthop
+ *    objects (NHA_GROUP). Carries a struct nhmsg
+ *
+ *    struct nhmsg {
+ *        unsigned char nh_family;
+ *        unsigned char nh_scope;     // return only
+ *        unsigned char nh_protocol;  // Routing protocol that installed nh
+ *        unsigned char resvd;
+ *        unsigned int  nh_flags;     // RTNH_F flags
+ *    };
+ */
+class NetlinkNexthopMessage final : public NetlinkMessageBase {
+ public:
+  NetlinkNexthopMessage();
+
+  ~NetlinkNexthopMessage() override;
+
+  // Override setReturnStatus. Set nexthopPromise_ with rcvdNexthops_
+  void setReturnStatus(int status) override;
+
+  // Get future for received nexthops in response to GET request
+  folly::SemiFuture<folly::Expected<std::vector<NextHopObject>, int>>
+  getNexthopsSemiFuture() {
+    return nexthopPromise_.getSemiFuture();
+  }
+
+  // initiallize nexthop message with default params
+  void init(int type);
+
+  // parse Netlink Nexthop message
+  static NextHopObject parseMessage(const struct nlmsghdr* nlh);
+
+  int addNexthop(const NextHopObject& nexthop);
+
+  int deleteNexthop(const NextHopObject& nexthop);
+
+ private:
+  // inherited class implementation
+  void rcvdNexthop(NextHopObject&& nexthop) override;
+
+  // add NHA attributes of single nexthop object
+  int addNextHopAttributes(const NextHop& nextHop);
+
+  // add NHA attributes of nexthop group object
+  int addGroupAttributes(
+      const std::vector<std::pair<uint32_t, uint8_t>>& group);
+
+  // parse MPLS push labels from NHA_ENCAP attribute
+  static std::vector<int32_t> parseMplsLabels(const struct rtattr* nhAttr);
+
+  //
+  // Private variables for rtnetlink msg exchange
+  //
+
+  // pointer to nexthop message header
+  struct nhmsg* nhmsg_{nullptr};
+
+  // promise to be fulfilled when receiving kernel reply
+  folly::Promise<folly::Expected<std::vector<NextHopObject>, int>>
+      nexthopPromise_;
+  std::vector<NextHopObject> rcvdNexthops_;
+};
+
+} // namespace openr::fbnl
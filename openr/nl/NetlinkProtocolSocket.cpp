@@ -5,10 +5,13 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <arpa/inet.h>
 #include <thread>
 
 #include <fb303/ServiceData.h>
+#include <folly/hash/Hash.h>
 
+#include <openr/common/HotPathTrace.h>
 #include <openr/common/Util.h>
 #include <openr/nl/NetlinkProtocolSocket.h>
 
@@ -20,16 +23,29 @@ namespace openr::fbnl {
 NetlinkProtocolSocket::NetlinkProtocolSocket(
     folly::EventBase* evb,
     messaging::ReplicateQueue<NetlinkEvent>& netlinkEventsQ,
-    bool enableIPv6RouteReplaceSemantics)
+    bool enableIPv6RouteReplaceSemantics,
+    size_t numRouteSockets,
+    NetlinkEventsConfig eventsConfig)
     : EventHandler(evb),
       evb_(evb),
       netlinkEventsQueue_(netlinkEventsQ),
-      enableIPv6RouteReplaceSemantics_(enableIPv6RouteReplaceSemantics) {
+      enableIPv6RouteReplaceSemantics_(enableIPv6RouteReplaceSemantics),
+      eventsConfig_(std::move(eventsConfig)) {
   // We expect ctrl-evb not be running. Attaching and scheduling
   // of timers is not thread safe.
   CHECK_NOTNULL(evb_);
   CHECK(not evb_->isRunning());
 
+  // Create sockets for programming routes
+  for (size_t i = 0; i < numRouteSockets; ++i) {
+    routeSockets_.emplace_back(new NetlinkProtocolSocket(
+        evb,
+        netlinkEventsQ,
+        enableIPv6RouteReplaceSemantics,
+        0 /* numRouteSockets */,
+        NetlinkEventsConfig{0 /* groups */}));
+  }
+
   nlMessageTimer_ = folly::AsyncTimeout::make(*evb_, [this]() noexcept {
     DCHECK(false) << "This shouldn't occur usually. Adding DCHECK to get "
                   << "attention in UTs";
@@ -48,6 +64,7 @@ NetlinkProtocolSocket::NetlinkProtocolSocket(
       kv.second->setReturnStatus(-ETIMEDOUT);
     }
     nlSeqNumMap_.clear(); // Clear all timed out requests
+    nlNoAckSeqNums_.clear();
 
     LOG(INFO) << "Closing netlink socket. fd=" << nlSock_
               << ", port=" << portId_;
@@ -63,6 +80,8 @@ NetlinkProtocolSocket::NetlinkProtocolSocket(
   notifConsumer_ =
       folly::NotificationQueue<std::unique_ptr<NetlinkMessageBase>>::Consumer::
           make([this](std::unique_ptr<NetlinkMessageBase>&& nlmsg) noexcept {
+            // Release the unused part of message buffer while it is queued
+            nlmsg->compact();
             msgQueue_.push(std::move(nlmsg));
             // Invoke send messages API if socket is initialized and no in
             // flight messages
@@ -91,6 +110,7 @@ NetlinkProtocolSocket::~NetlinkProtocolSocket() {
     kv.second->setReturnStatus(-ESHUTDOWN);
   }
   nlSeqNumMap_.clear(); // Clear all timed out requests
+  nlNoAckSeqNums_.clear();
 
   // Clear all requests that yet needs to be sent
   std::unique_ptr<NetlinkMessageBase> msg;
@@ -117,17 +137,45 @@ NetlinkProtocolSocket::init() {
     LOG(FATAL) << "Netlink socket set recv buffer failed.";
   };
 
+  // Enable strict checking of dump requests. Kernel (4.20+) then filters
+  // dumps on the attributes of request e.g. routes by table and protocol,
+  // instead of sending all the objects to be filtered on user side.
+  int strictChk = 1;
+  if (setsockopt(
+          nlSock_,
+          SOL_NETLINK,
+          NETLINK_GET_STRICT_CHK,
+          &strictChk,
+          sizeof(strictChk)) < 0) {
+    LOG(WARNING) << "Netlink socket set strict check failed. Dumps will be "
+                 << "filtered on user side. Error: "
+                 << folly::errnoStr(errno);
+  }
+
   // Bind on the source address. We let kernel chose the available port-ID
   struct sockaddr_nl saddr;
   ::memset(&saddr, 0, sizeof(saddr));
   saddr.nl_family = AF_NETLINK;
   saddr.nl_pid = 0; // We let kernel assign the port-ID
   /* We can subscribe to different Netlink mutlicast groups for specific types
-   * of events: link, IPv4/IPv6 address and neighbor. */
-  saddr.nl_groups = RTMGRP_LINK // listen for link events
-      | RTMGRP_IPV4_IFADDR // listen for IPv4 address events
-      | RTMGRP_IPV6_IFADDR // listen for IPv6 address events
-      | RTMGRP_NEIGH; // listen for Neighbor (ARP) events
+   * of events e.g. link, IPv4/IPv6 address and neighbor. */
+  saddr.nl_groups = eventsConfig_.groups;
+
+  // Drop route notifications we don't consume within kernel
+  const uint32_t routeGroups = RTMGRP_IPV4_ROUTE | RTMGRP_IPV6_ROUTE;
+  if ((eventsConfig_.groups & routeGroups) and
+      (eventsConfig_.routeProtocols.size() or
+       eventsConfig_.routeTables.size())) {
+    auto filter = createRouteEventsFilter(
+        eventsConfig_.routeProtocols, eventsConfig_.routeTables);
+    struct sock_fprog prog = {
+        .len = static_cast<uint16_t>(filter.size()), .filter = filter.data()};
+    if (setsockopt(
+            nlSock_, SOL_SOCKET, SO_ATTACH_FILTER, &prog, sizeof(prog)) < 0) {
+      LOG(FATAL) << "Netlink socket attach filter failed. Error: "
+                 << folly::errnoStr(errno);
+    }
+  }
 
   if (bind(nlSock_, (struct sockaddr*)&saddr, sizeof(saddr)) != 0) {
     LOG(FATAL) << "Failed to bind netlink socket: " << folly::errnoStr(errno);
@@ -149,6 +197,66 @@ NetlinkProtocolSocket::init() {
   sendNetlinkMessage();
 }
 
+std::vector<struct sock_filter>
+NetlinkProtocolSocket::createRouteEventsFilter(
+    const std::vector<uint8_t>& protocols, const std::vector<uint8_t>& tables) {
+  // Route attributes (offset within message) to match against values
+  const std::vector<std::pair<uint32_t, const std::vector<uint8_t>*>> matches{
+      {NLMSG_HDRLEN + offsetof(struct rtmsg, rtm_protocol), &protocols},
+      {NLMSG_HDRLEN + offsetof(struct rtmsg, rtm_table), &tables}};
+
+  // Compute size of program to know the offset of final `accept` statement
+  size_t size = 6;
+  for (auto const& [_, values] : matches) {
+    size += values->empty() ? 0 : values->size() + 2;
+  }
+  CHECK_LE(size, std::numeric_limits<uint8_t>::max())
+      << "Too many values to filter route notifications on";
+  const size_t accept = size - 1;
+
+  std::vector<struct sock_filter> filter;
+  filter.reserve(size);
+  // Relative offset of jump from the statement being added to `target`
+  auto jumpTo = [&filter](size_t target) {
+    return static_cast<uint8_t>(target - filter.size() - 1);
+  };
+
+  // NOTE: Half-word loads are in network byte order, while netlink header is
+  // in host byte order. Hence constants are compared in network byte order.
+
+  // Accept anything but route messages
+  filter.push_back(BPF_STMT(
+      BPF_LD | BPF_H | BPF_ABS, offsetof(struct nlmsghdr, nlmsg_type)));
+  filter.push_back(
+      BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, htons(RTM_NEWROUTE), 1, 0));
+  filter.push_back(BPF_JUMP(
+      BPF_JMP | BPF_JEQ | BPF_K, htons(RTM_DELROUTE), 0, jumpTo(accept)));
+
+  // Accept responses of route dump requests
+  filter.push_back(BPF_STMT(
+      BPF_LD | BPF_H | BPF_ABS, offsetof(struct nlmsghdr, nlmsg_flags)));
+  filter.push_back(BPF_JUMP(
+      BPF_JMP | BPF_JSET | BPF_K, htons(NLM_F_MULTI), jumpTo(accept), 0));
+
+  // Drop route notification unless attribute matches one of the values
+  for (auto const& [offset, values] : matches) {
+    if (values->empty()) {
+      continue;
+    }
+    const size_t next = filter.size() + values->size() + 2;
+    filter.push_back(BPF_STMT(BPF_LD | BPF_B | BPF_ABS, offset));
+    for (auto value : *values) {
+      filter.push_back(
+          BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, value, jumpTo(next), 0));
+    }
+    filter.push_back(BPF_STMT(BPF_RET | BPF_K, 0));
+  }
+
+  filter.push_back(BPF_STMT(BPF_RET | BPF_K, 0xffffffff));
+  CHECK_EQ(size, filter.size());
+  return filter;
+}
+
 void
 NetlinkProtocolSocket::handlerReady(uint16_t events) noexcept {
   CHECK_EQ(events, folly::EventHandler::READ);
@@ -187,9 +295,19 @@ NetlinkProtocolSocket::processAck(uint32_t ack, int status) {
     fbData->addStatValue("netlink.errors", 1, fb303::SUM);
   }
 
+  // Kernel processes requests in order. Complete the requests sent without
+  // NLM_F_ACK before this one, as they would have been reported on error.
+  processCoalescedAcks(ack);
+
   // Cancel timer if there are no more expected responses
   if (nlSeqNumMap_.empty()) {
     nlMessageTimer_->cancelTimeout();
+    HotPathTrace::record(
+        "netlink.ack",
+        "",
+        burstStartTs_,
+        std::chrono::steady_clock::now(),
+        numBurstRequests_);
   } else {
     // Extend timer and wait for next ack
     nlMessageTimer_->scheduleTimeout(kNlRequestAckTimeout);
@@ -203,6 +321,26 @@ NetlinkProtocolSocket::processAck(uint32_t ack, int status) {
   }
 }
 
+void
+NetlinkProtocolSocket::processCoalescedAcks(uint32_t ack) {
+  // NOTE: Sequence numbers can wrap around, hence compare with the distance
+  while (not nlNoAckSeqNums_.empty() and
+         static_cast<int32_t>(nlNoAckSeqNums_.front() - ack) <= 0) {
+    const auto seq = nlNoAckSeqNums_.front();
+    nlNoAckSeqNums_.pop_front();
+    auto it = nlSeqNumMap_.find(seq);
+    if (it == nlSeqNumMap_.end()) {
+      // Request failed and its status is already set
+      continue;
+    }
+    VLOG(2) << "Completed netlink request with coalesced ack. seq=" << seq;
+    fbData->addStatValue("netlink.requests.success", 1, fb303::SUM);
+    fbData->addStatValue("netlink.requests.coalesced", 1, fb303::SUM);
+    it->second->setReturnStatus(0);
+    nlSeqNumMap_.erase(it);
+  }
+}
+
 void
 NetlinkProtocolSocket::sendNetlinkMessage() {
   CHECK(evb_->isInEventBaseThread());
@@ -218,6 +356,11 @@ NetlinkProtocolSocket::sendNetlinkMessage() {
     return;
   }
 
+  if (nlSeqNumMap_.empty()) {
+    burstStartTs_ = std::chrono::steady_clock::now();
+    numBurstRequests_ = 0;
+  }
+
   auto iov = std::make_unique<struct iovec[]>(iovSize);
 
   while (count < iovSize && !msgQueue_.empty()) {
@@ -242,6 +385,12 @@ NetlinkProtocolSocket::sendNetlinkMessage() {
       fbData->addStatValue("netlink.errors", 1, fb303::SUM);
     }
 
+    // Kernel will only respond to these on error. Track them for completion
+    // on the ack of a subsequent request.
+    if ((nlmsg_hdr->nlmsg_flags & NLM_F_ACK) == 0) {
+      nlNoAckSeqNums_.push_back(nlmsg_hdr->nlmsg_seq);
+    }
+
     // Add seq number -> netlink request mapping
     auto res = nlSeqNumMap_.insert({nlmsg_hdr->nlmsg_seq, std::move(m)});
     CHECK(res.second) << "Entry exists for " << nlmsg_hdr->nlmsg_seq;
@@ -258,6 +407,7 @@ NetlinkProtocolSocket::sendNetlinkMessage() {
   outMsg->msg_namelen = sizeof(nladdr);
   outMsg->msg_iov = &iov[0];
   outMsg->msg_iovlen = count;
+  numBurstRequests_ += count;
 
   // `sendmsg` return -1 in case of error else number of bytes sent. `errno`
   // will be set to an appropriate code in case of error.
@@ -279,10 +429,9 @@ NetlinkProtocolSocket::sendNetlinkMessage() {
 }
 
 void
-NetlinkProtocolSocket::processMessage(
-    const std::array<char, kMaxNlPayloadSize>& rxMsg, uint32_t bytesRead) {
+NetlinkProtocolSocket::processMessage(const char* rxMsg, uint32_t bytesRead) {
   // first netlink message header
-  struct nlmsghdr* nlh = (struct nlmsghdr*)rxMsg.data();
+  struct nlmsghdr* nlh = (struct nlmsghdr*)rxMsg;
   do {
     if (!NLMSG_OK(nlh, bytesRead)) {
       break;
@@ -306,7 +455,7 @@ NetlinkProtocolSocket::processMessage(
       } else {
         // Route notification
         fbData->addStatValue("netlink.notifications.route", 1, fb303::SUM);
-        DCHECK(false) << "Route notifications are not subscribed";
+        netlinkEventsQueue_.push(std::move(route));
       }
     } break;
 
@@ -398,6 +547,23 @@ NetlinkProtocolSocket::processMessage(
       }
     } break;
 
+    case RTM_DELNEXTHOP:
+    case RTM_NEWNEXTHOP: {
+      // process nexthop information received from netlink
+      auto nexthop = NetlinkNexthopMessage::parseMessage(nlh);
+
+      if (nlSeqIt != nlSeqNumMap_.end()) {
+        // Extend message timer as we received a valid ack
+        nlMessageTimer_->scheduleTimeout(kNlRequestAckTimeout);
+        // Received nexthop in response to request
+        nlSeqIt->second->rcvdNexthop(std::move(nexthop));
+      } else {
+        // Nexthop notification
+        fbData->addStatValue("netlink.notifications.nexthop", 1, fb303::SUM);
+        DCHECK(false) << "Nexthop notifications are not subscribed";
+      }
+    } break;
+
     case NLMSG_ERROR: {
       const struct nlmsgerr* const ack =
           reinterpret_cast<struct nlmsgerr*>(NLMSG_DATA(nlh));
@@ -428,24 +594,77 @@ NetlinkProtocolSocket::processMessage(
 
 void
 NetlinkProtocolSocket::recvNetlinkMessage() {
-  // messages buffer
-  std::array<char, kMaxNlPayloadSize> recvMsg = {};
+  // Peek the size of pending datagram and grow the slots if it won't fit
+  // NOTE: With MSG_TRUNC, real length of the datagram is returned
+  int32_t pendingBytes = ::recv(
+      nlSock_, recvBuf_.data(), 0, MSG_PEEK | MSG_TRUNC | MSG_DONTWAIT);
+  if (pendingBytes < 0) {
+    if (errno == EINTR || errno == EAGAIN) {
+      return;
+    }
+    if (errno == ENOBUFS) {
+      processEventsLost();
+      return;
+    }
+    LOG(ERROR) << "Error in netlink socket receive: " << pendingBytes
+               << " err: " << folly::errnoStr(std::abs(errno));
+    fbData->addStatValue("netlink.errors", 1, fb303::SUM);
+    return;
+  }
+  if (static_cast<size_t>(pendingBytes) > recvMsgSize_) {
+    recvMsgSize_ = NLMSG_ALIGN(pendingBytes);
+    recvBuf_.resize(recvMsgSize_ * kNlRecvMsgBatch);
+    VLOG(2) << "Increased netlink receive slot size to " << recvMsgSize_;
+  }
 
-  int32_t bytesRead = ::recv(nlSock_, recvMsg.data(), kMaxNlPayloadSize, 0);
-  VLOG(4) << "Message received with size: " << bytesRead;
+  // Read all the pending datagrams (upto a limit) in one system call
+  std::array<struct iovec, kNlRecvMsgBatch> iov;
+  std::array<struct mmsghdr, kNlRecvMsgBatch> msgs;
+  ::memset(msgs.data(), 0, sizeof(msgs));
+  for (size_t i = 0; i < kNlRecvMsgBatch; ++i) {
+    iov[i].iov_base = recvBuf_.data() + i * recvMsgSize_;
+    iov[i].iov_len = recvMsgSize_;
+    msgs[i].msg_hdr.msg_iov = &iov[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+  int numMsgs =
+      ::recvmmsg(nlSock_, msgs.data(), kNlRecvMsgBatch, MSG_DONTWAIT, nullptr);
+  VLOG(4) << "Messages received: " << numMsgs;
 
-  if (bytesRead < 0) {
+  if (numMsgs < 0) {
     if (errno == EINTR || errno == EAGAIN) {
       return;
     }
-    LOG(ERROR) << "Error in netlink socket receive: " << bytesRead
+    if (errno == ENOBUFS) {
+      processEventsLost();
+      return;
+    }
+    LOG(ERROR) << "Error in netlink socket receive: " << numMsgs
                << " err: " << folly::errnoStr(std::abs(errno));
     fbData->addStatValue("netlink.errors", 1, fb303::SUM);
     return;
-  } else {
+  }
+
+  for (int i = 0; i < numMsgs; ++i) {
+    const uint32_t bytesRead = msgs[i].msg_len;
+    VLOG(4) << "Message received with size: " << bytesRead;
+    if (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) {
+      // Only datagrams after the peeked one can hit this
+      LOG(ERROR) << "Truncated netlink message of size " << bytesRead;
+      fbData->addStatValue("netlink.errors", 1, fb303::SUM);
+    }
     fbData->addStatValue("netlink.bytes.rx", bytesRead, fb303::SUM);
+    processMessage(static_cast<const char*>(iov[i].iov_base), bytesRead);
   }
-  processMessage(recvMsg, static_cast<uint32_t>(bytesRead));
+}
+
+void
+NetlinkProtocolSocket::processEventsLost() {
+  // Kernel drops notifications when socket receive buffer is full. Socket
+  // remains usable, but subscribers have missed updates.
+  LOG(ERROR) << "Netlink event notifications are lost (receive buffer overrun)";
+  eventsLostCount_.fetch_add(1, std::memory_order_relaxed);
+  fbData->addStatValue("netlink.events_lost", 1, fb303::SUM);
 }
 
 folly::SemiFuture<folly::Unit>
@@ -466,8 +685,47 @@ NetlinkProtocolSocket::collectReturnStatus(
       });
 }
 
+folly::SemiFuture<folly::Unit>
+NetlinkProtocolSocket::collectReturnStatus(
+    folly::SemiFuture<std::vector<int>>&& future,
+    std::unordered_set<int> ignoredErrors) {
+  return std::move(future).deferValue(
+      [ignoredErrors](std::vector<int>&& results) {
+        for (auto result : results) {
+          auto retval = std::abs(result);
+          if (retval == 0 or ignoredErrors.count(retval)) {
+            continue;
+          }
+          throw fbnl::NlException("One or more netlink request failed", retval);
+        }
+        return folly::Unit();
+      });
+}
+
+size_t
+NetlinkProtocolSocket::getRouteSocketIndex(
+    const openr::fbnl::Route& route) const {
+  // Routes referring nexthop object must be ordered with nexthop objects
+  if (routeSockets_.empty() or route.getNextHopId().has_value()) {
+    return routeSockets_.size();
+  }
+  size_t hash{0};
+  if (route.getFamily() == AF_MPLS) {
+    hash = std::hash<uint32_t>()(route.getMplsLabel().value_or(0));
+  } else {
+    hash = folly::hash::hash_combine(
+        route.getDestination().first, route.getDestination().second);
+  }
+  return hash % routeSockets_.size();
+}
+
 folly::SemiFuture<int>
 NetlinkProtocolSocket::addRoute(const openr::fbnl::Route& route) {
+  const auto sockIdx = getRouteSocketIndex(route);
+  if (sockIdx < routeSockets_.size()) {
+    return routeSockets_.at(sockIdx)->addRoute(route);
+  }
+
   VLOG(1) << "Netlink add route. " << route.str();
   auto rtmMsg = std::make_unique<NetlinkRouteMessage>();
   auto future = rtmMsg->getSemiFuture();
@@ -501,8 +759,117 @@ NetlinkProtocolSocket::addRoute(const openr::fbnl::Route& route) {
   return future;
 }
 
+folly::SemiFuture<std::vector<int>>
+NetlinkProtocolSocket::addRoutes(std::vector<openr::fbnl::Route> routes) {
+  // Shard routes on route sockets and merge their result in original order
+  if (not routeSockets_.empty()) {
+    const size_t numSockets = routeSockets_.size() + 1;
+    std::vector<std::vector<openr::fbnl::Route>> shards(numSockets);
+    std::vector<std::pair<size_t, size_t>> positions;
+    positions.reserve(routes.size());
+    for (auto& route : routes) {
+      auto& shard = shards.at(getRouteSocketIndex(route));
+      positions.emplace_back(&shard - shards.data(), shard.size());
+      shard.emplace_back(std::move(route));
+    }
+
+    std::vector<folly::SemiFuture<std::vector<int>>> futures;
+    for (size_t i = 0; i < routeSockets_.size(); ++i) {
+      futures.emplace_back(
+          routeSockets_.at(i)->addRoutes(std::move(shards.at(i))));
+    }
+    // Routes to be programmed on this socket
+    futures.emplace_back(addRoutesImpl(std::move(shards.back())));
+
+    return folly::collectAll(std::move(futures))
+        .deferValue([positions = std::move(positions)](
+                        std::vector<folly::Try<std::vector<int>>>&& results) {
+          std::vector<int> statuses;
+          statuses.reserve(positions.size());
+          for (auto const& [shardIdx, idx] : positions) {
+            statuses.emplace_back(results.at(shardIdx).value().at(idx));
+          }
+          return statuses;
+        });
+  }
+
+  return addRoutesImpl(std::move(routes));
+}
+
+folly::SemiFuture<std::vector<int>>
+NetlinkProtocolSocket::addRoutesImpl(std::vector<openr::fbnl::Route> routes) {
+  VLOG(1) << "Netlink add routes. numRoutes=" << routes.size();
+  std::vector<std::unique_ptr<NetlinkMessageBase>> msgs;
+  std::vector<folly::SemiFuture<int>> futures;
+  msgs.reserve(routes.size());
+  futures.reserve(routes.size());
+
+  for (auto const& route : routes) {
+    VLOG(2) << "Netlink add route. " << route.str();
+    auto rtmMsg = std::make_unique<NetlinkRouteMessage>();
+    futures.emplace_back(rtmMsg->getSemiFuture());
+
+    int status{0};
+    switch (route.getFamily()) {
+    case AF_INET6:
+      if (not enableIPv6RouteReplaceSemantics_) {
+        // Special case for IPv6 route add. See addRoute(...)
+        // NOTE: We ignore the error for the delete
+        auto delMsg = std::make_unique<NetlinkRouteMessage>();
+        if (delMsg->deleteRoute(route) != 0) {
+          delMsg->setReturnStatus(-EINVAL);
+        } else {
+          msgs.emplace_back(std::move(delMsg));
+        }
+      }
+      FOLLY_FALLTHROUGH;
+    case AF_INET:
+      status = rtmMsg->addRoute(route);
+      break;
+    case AF_MPLS:
+      status = rtmMsg->addLabelRoute(route);
+      break;
+    default:
+      status = -EPROTONOSUPPORT;
+    }
+
+    if (status != 0) {
+      rtmMsg->setReturnStatus(status);
+    } else {
+      msgs.emplace_back(std::move(rtmMsg));
+    }
+  }
+
+  // Request ack only for every `kNlBatchAckInterval`-th and the last message
+  for (size_t i = 0; i < msgs.size(); ++i) {
+    if ((i + 1) % kNlBatchAckInterval != 0 and i + 1 != msgs.size()) {
+      msgs[i]->getMessagePtr()->nlmsg_flags &= ~NLM_F_ACK;
+    }
+  }
+
+  // Enqueue all messages together to keep them in order
+  notifQueue_.putMessages(
+      std::make_move_iterator(msgs.begin()),
+      std::make_move_iterator(msgs.end()));
+
+  return folly::collectAll(std::move(futures))
+      .deferValue([](std::vector<folly::Try<int>>&& results) {
+        std::vector<int> statuses;
+        statuses.reserve(results.size());
+        for (auto& result : results) {
+          statuses.emplace_back(result.value());
+        }
+        return statuses;
+      });
+}
+
 folly::SemiFuture<int>
 NetlinkProtocolSocket::deleteRoute(const openr::fbnl::Route& route) {
+  const auto sockIdx = getRouteSocketIndex(route);
+  if (sockIdx < routeSockets_.size()) {
+    return routeSockets_.at(sockIdx)->deleteRoute(route);
+  }
+
   VLOG(1) << "Netlink delete route. " << route.str();
   auto rtmMsg = std::make_unique<openr::fbnl::NetlinkRouteMessage>();
   auto future = rtmMsg->getSemiFuture();
@@ -627,6 +994,39 @@ NetlinkProtocolSocket::deleteRule(const openr::fbnl::Rule& rule) {
   return future;
 }
 
+folly::SemiFuture<int>
+NetlinkProtocolSocket::addNexthop(const openr::fbnl::NextHopObject& nexthop) {
+  VLOG(1) << "Netlink add nexthop. " << nexthop.str();
+  auto nhMsg = std::make_unique<openr::fbnl::NetlinkNexthopMessage>();
+  auto future = nhMsg->getSemiFuture();
+
+  int status = nhMsg->addNexthop(nexthop);
+  if (status != 0) {
+    nhMsg->setReturnStatus(status);
+  } else {
+    notifQueue_.putMessage(std::move(nhMsg));
+  }
+
+  return future;
+}
+
+folly::SemiFuture<int>
+NetlinkProtocolSocket::deleteNexthop(
+    const openr::fbnl::NextHopObject& nexthop) {
+  VLOG(1) << "Netlink delete nexthop. " << nexthop.str();
+  auto nhMsg = std::make_unique<openr::fbnl::NetlinkNexthopMessage>();
+  auto future = nhMsg->getSemiFuture();
+
+  int status = nhMsg->deleteNexthop(nexthop);
+  if (status != 0) {
+    nhMsg->setReturnStatus(status);
+  } else {
+    notifQueue_.putMessage(std::move(nhMsg));
+  }
+
+  return future;
+}
+
 folly::SemiFuture<folly::Expected<std::vector<fbnl::Link>, int>>
 NetlinkProtocolSocket::getAllLinks() {
   VLOG(1) << "Netlink get links";
@@ -679,6 +1079,19 @@ NetlinkProtocolSocket::getAllRules() {
   return future;
 }
 
+folly::SemiFuture<folly::Expected<std::vector<fbnl::NextHopObject>, int>>
+NetlinkProtocolSocket::getAllNexthops() {
+  VLOG(1) << "Netlink get nexthops";
+  auto nhMsg = std::make_unique<openr::fbnl::NetlinkNexthopMessage>();
+  auto future = nhMsg->getNexthopsSemiFuture();
+
+  // Initialize message fields to get all nexthops
+  nhMsg->init(RTM_GETNEXTHOP);
+  notifQueue_.putMessage(std::move(nhMsg));
+
+  return future;
+}
+
 folly::SemiFuture<folly::Expected<std::vector<fbnl::Route>, int>>
 NetlinkProtocolSocket::getRoutes(const fbnl::Route& filter) {
   VLOG(1) << "Netlink get routes with filter. " << filter.str();
@@ -692,6 +1105,22 @@ NetlinkProtocolSocket::getRoutes(const fbnl::Route& filter) {
   return future;
 }
 
+void
+NetlinkProtocolSocket::streamRoutes(
+    const fbnl::Route& filter,
+    size_t chunkSize,
+    RouteChunkCallback onChunk,
+    RouteDumpDoneCallback onDone) {
+  VLOG(1) << "Netlink stream routes with filter. " << filter.str();
+  auto routeMsg = std::make_unique<openr::fbnl::NetlinkRouteMessage>();
+  routeMsg->setRouteChunkCallbacks(
+      chunkSize, std::move(onChunk), std::move(onDone));
+
+  // Initialize message fields to get all addresses
+  routeMsg->initGet(0, filter);
+  notifQueue_.putMessage(std::move(routeMsg));
+}
+
 folly::SemiFuture<folly::Expected<std::vector<fbnl::Route>, int>>
 NetlinkProtocolSocket::getAllRoutes() {
   fbnl::RouteBuilder builder;
@@ -702,34 +1131,49 @@ NetlinkProtocolSocket::getAllRoutes() {
 
 folly::SemiFuture<folly::Expected<std::vector<fbnl::Route>, int>>
 NetlinkProtocolSocket::getIPv4Routes(uint8_t protocolId) {
+  return getRoutes(createIPv4RouteFilter(protocolId));
+}
+
+folly::SemiFuture<folly::Expected<std::vector<fbnl::Route>, int>>
+NetlinkProtocolSocket::getIPv6Routes(uint8_t protocolId) {
+  return getRoutes(createIPv6RouteFilter(protocolId));
+}
+
+folly::SemiFuture<folly::Expected<std::vector<fbnl::Route>, int>>
+NetlinkProtocolSocket::getMplsRoutes(uint8_t protocolId) {
+  return getRoutes(createMplsRouteFilter(protocolId));
+}
+
+fbnl::Route
+NetlinkProtocolSocket::createIPv4RouteFilter(uint8_t protocolId) {
   fbnl::RouteBuilder builder;
   // Set address family to MPLS with default v4 route
   builder.setDestination({folly::IPAddressV4("0.0.0.0"), 0});
   // Set protocol ID
   builder.setProtocolId(protocolId);
   builder.setType(RTN_UNSPEC); // Explicitly set type to 0
-  return getRoutes(builder.build());
+  return builder.build();
 }
 
-folly::SemiFuture<folly::Expected<std::vector<fbnl::Route>, int>>
-NetlinkProtocolSocket::getIPv6Routes(uint8_t protocolId) {
+fbnl::Route
+NetlinkProtocolSocket::createIPv6RouteFilter(uint8_t protocolId) {
   fbnl::RouteBuilder builder;
   // Set address family to MPLS with default v6 route
   builder.setDestination({folly::IPAddressV6("::"), 0});
   // Set protocol ID
   builder.setProtocolId(protocolId);
   builder.setType(RTN_UNSPEC); // Explicitly set type to 0
-  return getRoutes(builder.build());
+  return builder.build();
 }
 
-folly::SemiFuture<folly::Expected<std::vector<fbnl::Route>, int>>
-NetlinkProtocolSocket::getMplsRoutes(uint8_t protocolId) {
+fbnl::Route
+NetlinkProtocolSocket::createMplsRouteFilter(uint8_t protocolId) {
   fbnl::RouteBuilder builder;
   // Set address family to MPLS with default label
   builder.setMplsLabel(0);
   // Set protocol ID
   builder.setProtocolId(protocolId);
-  return getRoutes(builder.build());
+  return builder.build();
 }
 
 } // namespace openr::fbnl
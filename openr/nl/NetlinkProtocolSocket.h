@@ -7,6 +7,11 @@
 
 #pragma once
 
+#include <atomic>
+#include <deque>
+
+#include <linux/filter.h>
+
 #include <folly/IPAddress.h>
 #include <folly/futures/Future.h>
 #include <folly/io/async/AsyncTimeout.h>
@@ -19,19 +24,41 @@
 #include <openr/nl/NetlinkLinkMessage.h>
 #include <openr/nl/NetlinkMessageBase.h>
 #include <openr/nl/NetlinkNeighborMessage.h>
+#include <openr/nl/NetlinkNexthopMessage.h>
 #include <openr/nl/NetlinkRouteMessage.h>
 #include <openr/nl/NetlinkRuleMessage.h>
 #include <openr/nl/NetlinkTypes.h>
 
+#ifndef SOL_NETLINK
+#define SOL_NETLINK 270
+#endif
+
+#ifndef NETLINK_GET_STRICT_CHK
+#define NETLINK_GET_STRICT_CHK 12
+#endif
+
 namespace openr::fbnl {
 
-// Netlink event as union of LINK/ADDR/NEIGH/RULE event
-using NetlinkEvent =
-    std::variant<fbnl::Link, fbnl::IfAddress, fbnl::Neighbor, fbnl::Rule>;
+// Netlink event as union of LINK/ADDR/NEIGH/RULE/ROUTE event
+using NetlinkEvent = std::variant<
+    fbnl::Link,
+    fbnl::IfAddress,
+    fbnl::Neighbor,
+    fbnl::Rule,
+    fbnl::Route>;
 
 // Receive socket buffer for netlink socket
 constexpr uint32_t kNetlinkSockRecvBuf{1 * 1024 * 1024};
 
+// Initial size of a datagram slot in receive buffer. Kernel sizes the parts
+// of a dump response on the read buffer size (capped at 32KB), hence larger
+// slot reduces the number of reads for big dumps. Slot grows if kernel ever
+// sends a bigger datagram.
+constexpr size_t kNlRecvMsgSize{32 * 1024};
+
+// Maximum number of datagrams read with one `recvmmsg` call
+constexpr size_t kNlRecvMsgBatch{16};
+
 // Maximum number of in-flight messages. `kMinIovMsg` indicates the soft
 // requirement for sending bufferred messages.
 constexpr size_t kMaxIovMsg{500};
@@ -43,6 +70,28 @@ constexpr size_t kMinIovMsg{200};
 // assume kernel is not responsive.
 constexpr std::chrono::milliseconds kNlRequestAckTimeout{1000};
 
+// Messages of a bulk request (e.g. `addRoutes`) are sent without NLM_F_ACK,
+// except for every `kNlBatchAckInterval`-th and the last one. Kernel
+// processes messages of a socket in order and always reports errors, hence
+// the ack of a message implies success of all the silent messages sent before
+// it. It must be small enough for acks to free up `kMinIovMsg` slots.
+constexpr size_t kNlBatchAckInterval{100};
+static_assert(kNlBatchAckInterval < kMaxIovMsg - kMinIovMsg);
+
+/**
+ * Netlink events to subscribe to. See `NOTE Events`
+ */
+struct NetlinkEventsConfig {
+  // Netlink multicast groups (RTMGRP_*) to listen on
+  uint32_t groups{
+      RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR | RTMGRP_NEIGH};
+
+  // Route notifications are delivered only for the routes of these protocols
+  // and tables. Empty list doesn't filter on the attribute.
+  std::vector<uint8_t> routeProtocols{};
+  std::vector<uint8_t> routeTables{};
+};
+
 /**
  * C++ async interface for netlink APIs. It supports minimal functionality that
  * Open/R needs but can be easily extended to support any netlink message
@@ -62,6 +111,23 @@ constexpr std::chrono::milliseconds kNlRequestAckTimeout{1000};
  * for any messages that needs to be read. Received messages may fulfil the
  * future of outstanding requests.
  *
+ * NOTE Route sockets:
+ * Optionally route add/delete requests can be programmed over a pool of
+ * additional netlink sockets (`numRouteSockets`), which are not subscribed to
+ * any event. Acks for route programming then don't compete with the netlink
+ * events and other requests on the primary socket. Requests are sharded by
+ * the hash of prefix (or label) to retain the ordering of updates for a
+ * route. Routes referring nexthop objects stay on the primary socket to be
+ * ordered with the nexthop object updates. All sockets share the EventBase.
+ *
+ * NOTE Events:
+ * Socket subscribes to the multicast groups of `NetlinkEventsConfig` and
+ * publishes the notifications on `netlinkEventsQueue`. By default these are
+ * LINK, ADDR and NEIGHBOR events. Route notifications (e.g. RTMGRP_IPV6_ROUTE)
+ * can be subscribed for, in which case a classic BPF filter is attached to the
+ * socket. It drops the notifications for other protocols and tables within
+ * kernel, so they never reach user space to be parsed.
+ *
  * NOTE Performance:
  * Above threading model allows multiple requests to be sent in parallel and
  * process their response asynchronously. Outstanding requests to kernel is
@@ -89,6 +155,7 @@ constexpr std::chrono::milliseconds kNlRequestAckTimeout{1000};
  *   netlink.requests.success : Request that completed successfully
  *   netlink.requests.error : Request with non zero return code
  *   netlink.requests.latency_ms : Average latency of netlink request
+ *   netlink.requests.coalesced : Requests completed by ack of later request
  *   netlink.bytes.rx : Bytes received over netlink socket
  *   netlink.bytes.tx : Bytes sent over netlink socket
  *   netlink.notifications.link : Received link notifications
@@ -101,10 +168,21 @@ class NetlinkProtocolSocket : public folly::EventHandler {
   explicit NetlinkProtocolSocket(
       folly::EventBase* evb,
       messaging::ReplicateQueue<NetlinkEvent>& netlinkEventsQ,
-      bool enableIPv6RouteReplaceSemantics = false);
+      bool enableIPv6RouteReplaceSemantics = false,
+      size_t numRouteSockets = 0,
+      NetlinkEventsConfig eventsConfig = NetlinkEventsConfig());
 
   virtual ~NetlinkProtocolSocket();
 
+  /**
+   * Create BPF program accepting all but the route notifications for the
+   * protocols and tables not in given lists. Responses of route dumps
+   * (NLM_F_MULTI) are always accepted.
+   */
+  static std::vector<struct sock_filter> createRouteEventsFilter(
+      const std::vector<uint8_t>& protocols,
+      const std::vector<uint8_t>& tables);
+
   /**
    * Add or replace route. An existing paths of route will be replaced with
    * new paths. Supports AF_INET, AF_INET6 and AF_MPLS address families.
@@ -123,6 +201,16 @@ class NetlinkProtocolSocket : public folly::EventHandler {
    */
   virtual folly::SemiFuture<int> addRoute(const openr::fbnl::Route& route);
 
+  /**
+   * Bulk version of `addRoute`. All the messages are enqueued together and
+   * acks from kernel are coalesced (see `kNlBatchAckInterval`) which reduces
+   * the number of messages kernel has to send back for large route updates.
+   *
+   * @returns return status of every route, in order of the input routes
+   */
+  virtual folly::SemiFuture<std::vector<int>> addRoutes(
+      std::vector<openr::fbnl::Route> routes);
+
   /**
    * Delete route. This API deletes all the paths associated with the route
    * based on key (destination-address or mpls top-label). Supports AF_INET,
@@ -179,6 +267,25 @@ class NetlinkProtocolSocket : public folly::EventHandler {
    */
   virtual folly::SemiFuture<int> deleteRule(const openr::fbnl::Rule& rule);
 
+  /**
+   * Add or replace a kernel nexthop object (single nexthop or group). Members
+   * of a group must be added before the group itself. Routes can refer the
+   * object via `RouteBuilder::setNextHopId`
+   *
+   * @returns 0 on success else appropriate system error code
+   */
+  virtual folly::SemiFuture<int> addNexthop(
+      const openr::fbnl::NextHopObject& nexthop);
+
+  /**
+   * Delete a kernel nexthop object. Only ID of the object is used. NOTE:
+   * Kernel removes all the routes referring to the deleted nexthop object
+   *
+   * @returns 0 on success else appropriate system error code
+   */
+  virtual folly::SemiFuture<int> deleteNexthop(
+      const openr::fbnl::NextHopObject& nexthop);
+
   /**
    * API to get interfaces from kernel
    */
@@ -203,6 +310,13 @@ class NetlinkProtocolSocket : public folly::EventHandler {
   virtual folly::SemiFuture<folly::Expected<std::vector<fbnl::Rule>, int>>
   getAllRules();
 
+  /**
+   * API to get nexthop objects from kernel
+   */
+  virtual folly::SemiFuture<
+      folly::Expected<std::vector<fbnl::NextHopObject>, int>>
+  getAllNexthops();
+
   /**
    * API to retrieve routes from kernel. Attributes specified in filter will be
    * used to selectively retrieve routes. Filter is supported on following
@@ -228,6 +342,35 @@ class NetlinkProtocolSocket : public folly::EventHandler {
   virtual folly::SemiFuture<folly::Expected<std::vector<fbnl::Route>, int>>
   getMplsRoutes(uint8_t protocolId);
 
+  /**
+   * Streaming variant of `getRoutes`. Routes are handed to `onChunk` in chunks
+   * of at most `chunkSize` as the kernel's dump is parsed, so that the whole
+   * table is never held at once. `onDone` is invoked with status (0 on
+   * success) after the last chunk. Both are invoked on event base thread.
+   */
+  virtual void streamRoutes(
+      const fbnl::Route& filter,
+      size_t chunkSize,
+      RouteChunkCallback onChunk,
+      RouteDumpDoneCallback onDone);
+
+  /**
+   * Filters used by getIPv4Routes, getIPv6Routes and getMplsRoutes
+   */
+  static fbnl::Route createIPv4RouteFilter(uint8_t protocolId);
+  static fbnl::Route createIPv6RouteFilter(uint8_t protocolId);
+  static fbnl::Route createMplsRouteFilter(uint8_t protocolId);
+
+  /**
+   * Number of times kernel reported loss of event notifications (ENOBUFS) on
+   * this socket. Any change in the value means that the state derived from
+   * events must be re-synced with a full dump. Thread safe.
+   */
+  uint64_t
+  getEventsLostCount() const {
+    return eventsLostCount_.load(std::memory_order_relaxed);
+  }
+
   /**
    * Utility function to accumulate result of multiple requests into one.
    * It will throw the exception with the first non-zero value(aka error code),
@@ -236,15 +379,29 @@ class NetlinkProtocolSocket : public folly::EventHandler {
   static folly::SemiFuture<folly::Unit> collectReturnStatus(
       std::vector<folly::SemiFuture<int>>&& futures,
       std::unordered_set<int> ignoredErrors = {});
+  static folly::SemiFuture<folly::Unit> collectReturnStatus(
+      folly::SemiFuture<std::vector<int>>&& future,
+      std::unordered_set<int> ignoredErrors = {});
 
  protected:
   // Initialize netlink socket and add to eventloop for polling
   virtual void init();
 
+  // Record loss of event notifications reported by kernel
+  void processEventsLost();
+
  private:
   NetlinkProtocolSocket(NetlinkProtocolSocket const&) = delete;
   NetlinkProtocolSocket& operator=(NetlinkProtocolSocket const&) = delete;
 
+  // Index of the route socket to program the route with. Returns size of
+  // `routeSockets_` if route is to be programmed with this socket.
+  size_t getRouteSocketIndex(const openr::fbnl::Route& route) const;
+
+  // Implementation of `addRoutes` for routes to be programmed on this socket
+  folly::SemiFuture<std::vector<int>> addRoutesImpl(
+      std::vector<openr::fbnl::Route> routes);
+
   // Implement EventHandler callback for reading netlink messages
   void handlerReady(uint16_t events) noexcept override;
 
@@ -252,18 +409,21 @@ class NetlinkProtocolSocket : public folly::EventHandler {
   void sendNetlinkMessage();
 
   // Receive messages from netlink socket. Invoke `processMessage` for every
-  // message received.
+  // message received. Reads upto `kNlRecvMsgBatch` datagrams at once.
   void recvNetlinkMessage();
 
   // Process received netlink message. Set return values for pending requests
-  // or send notifications.
-  void processMessage(
-      const std::array<char, kMaxNlPayloadSize>& rxMsg, uint32_t bytesRead);
+  // or send notifications. Messages are parsed directly off the receive buffer
+  void processMessage(const char* rxMsg, uint32_t bytesRead);
 
   // Process ack message. Set return status on pending requests in nlSeqNumMap_
   // Resume sending messages from queue_ if any pending
   void processAck(uint32_t ack, int status);
 
+  // Complete the messages sent without NLM_F_ACK before the given sequence
+  // number. Invoked on receipt of any ack as kernel processes them in order.
+  void processCoalescedAcks(uint32_t ack);
+
   // Event base for serializing read/write requests to netlink socket. Also
   // ensure thread safety of private member variables.
   folly::EventBase* evb_{nullptr};
@@ -282,10 +442,19 @@ class NetlinkProtocolSocket : public folly::EventHandler {
   // Use new IPv6 route replace semantics. See documentation for addRoute(...)
   const bool enableIPv6RouteReplaceSemantics_{false};
 
+  // Events to subscribe to. Route sockets have no subscriptions
+  const NetlinkEventsConfig eventsConfig_;
+
+  // Sockets for programming routes. See `NOTE Route sockets`
+  std::vector<std::unique_ptr<NetlinkProtocolSocket>> routeSockets_;
+
   // Netlink socket fd. Created when class is constructed. Re-created on timeout
   // when no response is received for any of our pending requests.
   int nlSock_{-1};
 
+  // See getEventsLostCount()
+  std::atomic<uint64_t> eventsLostCount_{0};
+
   // nl_pid stands for port-ID and not process-ID. Netlink sockets are bound on
   // this specified port. This must be unique for every netlink socket that
   // is created on the system. Ironically kernel assigns the process-ID as the
@@ -307,6 +476,12 @@ class NetlinkProtocolSocket : public folly::EventHandler {
   //    value of nlh->nlmsg_seq will set to 0.
   uint32_t nextNlSeqNum_{1};
 
+  // Receive buffer re-used across reads. It is divided into
+  // `kNlRecvMsgBatch` slots of `recvMsgSize_` bytes, one for each datagram.
+  size_t recvMsgSize_{kNlRecvMsgSize};
+  std::vector<char> recvBuf_ =
+      std::vector<char>(kNlRecvMsgSize * kNlRecvMsgBatch);
+
   // Netlink message queue. Every add/del/get call for
   // route/addr/neighbor/link/rule translates into one or more NetlinkMessages.
   // These messages are first stored in the queue and sent to kernel in rate
@@ -318,9 +493,20 @@ class NetlinkProtocolSocket : public folly::EventHandler {
   // sent to kernel, is assigned a unique sequence-number and stored in this
   // map. On receipt of ack from kernel (either success or error) we clear the
   // corresponding entry from this map.
-  std::unordered_map<uint32_t, std::shared_ptr<NetlinkMessageBase>>
+  std::unordered_map<uint32_t, std::unique_ptr<NetlinkMessageBase>>
       nlSeqNumMap_;
 
+  // Sequence numbers of in-flight messages sent without NLM_F_ACK, in the
+  // order they're sent. Kernel only responds to them on error, else they're
+  // completed by the ack of a subsequent message.
+  std::deque<uint32_t> nlNoAckSeqNums_;
+
+  // Start of the current burst of in-flight messages, i.e. since
+  // `nlSeqNumMap_` was empty last, and number of messages sent within. Burst
+  // is traced as a span once all of its messages are acked.
+  std::chrono::steady_clock::time_point burstStartTs_;
+  size_t numBurstRequests_{0};
+
   // Timer to help keep track of timeout of messages sent to kernel. It also
   // ensures the aliveness of the netlink socket-fd. Timer is
   // - Started when a new message is sent
@@ -9,6 +9,52 @@
 
 namespace openr::fbnl {
 
+namespace {
+
+// Write attribute at `rta`. Its space must be reserved and zeroed
+void
+putAttribute(struct rtattr* rta, int type, const void* data, size_t len) {
+  rta->rta_type = type;
+  rta->rta_len = RTA_LENGTH(len);
+  ::memcpy(RTA_DATA(rta), data, len);
+}
+
+// Location of attribute following `rta`
+struct rtattr*
+nextAttribute(struct rtattr* rta) {
+  return reinterpret_cast<struct rtattr*>(
+      reinterpret_cast<char*>(rta) + RTA_ALIGN(rta->rta_len));
+}
+
+bool
+isPushNextHop(const thrift::NextHopThrift& nh) {
+  return nh.mplsAction_ref().has_value() and
+      *nh.mplsAction_ref()->action_ref() == thrift::MplsActionCode::PUSH;
+}
+
+// Space of next-hop within RTA_MULTIPATH, as encoded by `encodeNextHop()`
+size_t
+getNextHopSize(const thrift::NextHopThrift& nh, bool isV4Route) {
+  const size_t gwLen = nh.address_ref()->addr_ref()->size();
+  size_t size = RTNH_ALIGN(sizeof(struct rtnexthop));
+  if (isPushNextHop(nh)) {
+    const auto& labels = nh.mplsAction_ref()->pushLabels_ref();
+    const size_t numLabels = labels.has_value() ? labels->size() : 0;
+    // RTA_ENCAP nesting MPLS_IPTUNNEL_DST, RTA_ENCAP_TYPE and RTA_GATEWAY
+    size += RTA_SPACE(RTA_SPACE(numLabels * sizeof(struct mpls_label)));
+    size += RTA_SPACE(sizeof(uint16_t));
+    size += RTA_SPACE(gwLen);
+  } else if (isV4Route and gwLen == folly::IPAddressV6::byteCount()) {
+    // RTA_VIA with address family
+    size += RTA_SPACE(sizeof(uint16_t) + gwLen);
+  } else {
+    size += RTA_SPACE(gwLen);
+  }
+  return size;
+}
+
+} // namespace
+
 NetlinkRouteMessage::NetlinkRouteMessage() : NetlinkMessageBase() {}
 
 NetlinkRouteMessage::~NetlinkRouteMessage() {
@@ -50,10 +96,32 @@ NetlinkRouteMessage::rcvdRoute(Route&& route) {
   }
 
   rcvdRoutes_.emplace_back(std::move(route));
+  if (onChunk_ and rcvdRoutes_.size() >= chunkSize_) {
+    onChunk_(std::exchange(rcvdRoutes_, {}));
+  }
+}
+
+void
+NetlinkRouteMessage::setRouteChunkCallbacks(
+    size_t chunkSize,
+    RouteChunkCallback onChunk,
+    RouteDumpDoneCallback onDone) {
+  CHECK_GT(chunkSize, 0);
+  chunkSize_ = chunkSize;
+  onChunk_ = std::move(onChunk);
+  onDone_ = std::move(onDone);
 }
 
 void
 NetlinkRouteMessage::setReturnStatus(int status) {
+  if (onChunk_) {
+    if (status == 0 and not rcvdRoutes_.empty()) {
+      onChunk_(std::exchange(rcvdRoutes_, {}));
+    }
+    rcvdRoutes_.clear();
+    onDone_(status);
+  }
+
   if (status == 0) {
     routePromise_.setValue(std::move(rcvdRoutes_));
   } else {
@@ -77,9 +145,9 @@ NetlinkRouteMessage::init(int type, uint32_t rtFlags, const Route& route) {
   if (type == RTM_GETROUTE) {
     // Get routes matching subsequent criteria specified below
     msghdr_->nlmsg_flags |= NLM_F_DUMP;
-    // NOTE - Only `rtmsg_->rtm_family` will be used by kernel as filter
-    // parameter. Other parameters such as table, protocol, scope, type will
-    // need to be filtered on user side.
+    // NOTE - With NETLINK_GET_STRICT_CHK enabled on socket, kernel filters the
+    // dump on family, table, protocol and type set in header. Filters are
+    // still applied on user side for kernels not supporting strict checks.
     filters_.table = route.getRouteTable();
     filters_.type = route.getType();
     filters_.protocol = route.getProtocolId();
@@ -113,7 +181,7 @@ NetlinkRouteMessage::init(int type, uint32_t rtFlags, const Route& route) {
   rtmsg_->rtm_flags = rtFlags;
 
   auto rtFlag = route.getFlags();
-  if (rtFlag.has_value()) {
+  if (rtFlag.has_value() && type != RTM_GETROUTE) {
     rtmsg_->rtm_flags |= rtFlag.value();
   }
 }
@@ -121,6 +189,15 @@ NetlinkRouteMessage::init(int type, uint32_t rtFlags, const Route& route) {
 void
 NetlinkRouteMessage::initGet(uint32_t flags, const Route& route) {
   init(RTM_GETROUTE, flags, route);
+
+  // Strict check for MPLS dump only allows protocol as filter. Any other value
+  // in the header or attribute will fail the request
+  if (route.getFamily() == AF_MPLS) {
+    rtmsg_->rtm_table = 0;
+    rtmsg_->rtm_type = 0;
+    rtmsg_->rtm_scope = 0;
+    return;
+  }
   addRtaTable(route.getRouteTable());
 }
 
@@ -640,7 +717,7 @@ NetlinkRouteMessage::parseMessage(const struct nlmsghdr* nlmsg) {
       for (auto& nh : nextHops) {
         // don't add empty nexthop
         if (nh.getGateway().has_value() || nh.getIfIndex().has_value()) {
-          routeBuilder.addNextHop(nh);
+          routeBuilder.addNextHop(std::move(nh));
         }
       }
     } break;
@@ -650,6 +727,13 @@ NetlinkRouteMessage::parseMessage(const struct nlmsghdr* nlmsg) {
       uint32_t table = *(reinterpret_cast<uint32_t*> RTA_DATA(routeAttr));
       routeBuilder.setRouteTable(table);
     } break;
+
+    // Route refers to kernel nexthop object. Kernel still reports the
+    // resolved nexthops along with it
+    case RTA_NH_ID: {
+      routeBuilder.setNextHopId(
+          *(reinterpret_cast<uint32_t*> RTA_DATA(routeAttr)));
+    } break;
     }
   }
 
@@ -659,7 +743,7 @@ NetlinkRouteMessage::parseMessage(const struct nlmsghdr* nlmsg) {
     auto nh = nhBuilder.build();
     // don't add empty nexthop
     if (nh.getGateway().has_value() || nh.getIfIndex().has_value()) {
-      routeBuilder.addNextHop(nh);
+      routeBuilder.addNextHop(std::move(nh));
     }
   }
 
@@ -710,8 +794,7 @@ NetlinkRouteMessage::parseNextHops(
       nhBuilder.setWeight(nh->rtnh_hops + 1);
     }
     setMplsAction(nhBuilder, family);
-    auto nexthop = nhBuilder.build();
-    nextHops.emplace_back(nexthop);
+    nextHops.emplace_back(nhBuilder.build());
     nhLen -= NLMSG_ALIGN(nh->rtnh_len);
     nh = RTNH_NEXT(nh);
   } while (RTNH_OK(nh, nhLen));
@@ -753,9 +836,202 @@ NetlinkRouteMessage::addRoute(const Route& route) {
     return status;
   }
 
+  // Refer to kernel nexthop object instead of encoding nexthops inline
+  if (route.getNextHopId().has_value()) {
+    const uint32_t nhId = route.getNextHopId().value();
+    return addAttributes(
+        RTA_NH_ID, reinterpret_cast<const char*>(&nhId), sizeof(uint32_t));
+  }
+
   return addNextHops(route);
 }
 
+size_t
+NetlinkRouteMessage::getUnicastRouteSize(
+    const thrift::UnicastRoute& route, bool hasPriority) {
+  const size_t destLen =
+      route.dest_ref()->prefixAddress_ref()->addr_ref()->size();
+  const bool isV4Route = destLen == folly::IPAddressV4::byteCount();
+
+  size_t size = NLMSG_SPACE(sizeof(struct rtmsg));
+  size += RTA_SPACE(destLen); // RTA_DST
+  if (hasPriority) {
+    size += RTA_SPACE(sizeof(uint32_t)); // RTA_PRIORITY
+  }
+  size += RTA_SPACE(sizeof(uint32_t)); // RTA_TABLE
+
+  if (route.nextHops_ref()->empty()) {
+    return size;
+  }
+  size_t multipathLen{0};
+  for (const auto& nh : *route.nextHops_ref()) {
+    multipathLen += getNextHopSize(nh, isV4Route);
+  }
+  return size + RTA_SPACE(multipathLen); // RTA_MULTIPATH
+}
+
+int
+NetlinkRouteMessage::encodeUnicastRoute(
+    const thrift::UnicastRoute& route,
+    uint8_t protocol,
+    std::optional<uint32_t> priority,
+    IfIndexResolver getIfIndex,
+    folly::MutableByteRange buf) {
+  const auto& destAddr = *route.dest_ref()->prefixAddress_ref()->addr_ref();
+  const int prefixLen = *route.dest_ref()->prefixLength_ref();
+  unsigned char family{AF_UNSPEC};
+  if (destAddr.size() == folly::IPAddressV4::byteCount()) {
+    family = AF_INET;
+  } else if (destAddr.size() == folly::IPAddressV6::byteCount()) {
+    family = AF_INET6;
+  }
+  if (family == AF_UNSPEC or prefixLen < 0 or
+      static_cast<size_t>(prefixLen) > destAddr.size() * 8) {
+    LOG(ERROR) << "Invalid route destination";
+    return EINVAL;
+  }
+
+  const size_t size = getUnicastRouteSize(route, priority.has_value());
+  if (buf.size() < size) {
+    LOG(ERROR) << "Space not available to encode route of size " << size;
+    return ENOBUFS;
+  }
+  // NOTE: Message fields not set explicitly are expected to be zero
+  ::memset(buf.begin(), 0, size);
+
+  auto nlmsg = reinterpret_cast<struct nlmsghdr*>(buf.begin());
+  nlmsg->nlmsg_len = size;
+  nlmsg->nlmsg_type = RTM_NEWROUTE;
+  nlmsg->nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK | NLM_F_CREATE | NLM_F_REPLACE;
+
+  auto rtm = reinterpret_cast<struct rtmsg*>(NLMSG_DATA(nlmsg));
+  rtm->rtm_family = family;
+  rtm->rtm_dst_len = prefixLen;
+  rtm->rtm_table = RT_TABLE_MAIN;
+  rtm->rtm_protocol = protocol;
+  rtm->rtm_scope = RT_SCOPE_UNIVERSE;
+  // Empty nexthops is same as DROP (aka RTN_BLACKHOLE)
+  rtm->rtm_type = route.nextHops_ref()->empty() ? RTN_BLACKHOLE : RTN_UNICAST;
+
+  // RTA_DST, with host bits of prefix cleared
+  struct rtattr* rta = reinterpret_cast<struct rtattr*>(
+      buf.begin() + NLMSG_SPACE(sizeof(struct rtmsg)));
+  putAttribute(rta, RTA_DST, destAddr.data(), destAddr.size());
+  auto dst = reinterpret_cast<uint8_t*>(RTA_DATA(rta));
+  for (size_t i = prefixLen / 8; i < destAddr.size(); ++i) {
+    const int bits = std::max(prefixLen - static_cast<int>(i * 8), 0);
+    dst[i] &= static_cast<uint8_t>(0xff00 >> bits);
+  }
+  rta = nextAttribute(rta);
+
+  if (priority.has_value()) {
+    const uint32_t adminDistance = priority.value();
+    putAttribute(rta, RTA_PRIORITY, &adminDistance, sizeof(uint32_t));
+    rta = nextAttribute(rta);
+  }
+
+  const uint32_t tableId = RT_TABLE_MAIN;
+  putAttribute(rta, RTA_TABLE, &tableId, sizeof(uint32_t));
+  rta = nextAttribute(rta);
+
+  if (route.nextHops_ref()->empty()) {
+    return 0;
+  }
+
+  // RTA_MULTIPATH spans rest of the message
+  rta->rta_type = RTA_MULTIPATH;
+  rta->rta_len = buf.begin() + size - reinterpret_cast<uint8_t*>(rta);
+  auto rtnh = reinterpret_cast<struct rtnexthop*>(RTA_DATA(rta));
+  for (const auto& nh : *route.nextHops_ref()) {
+    int status{0};
+    if ((status = encodeNextHop(nh, family, getIfIndex, rtnh))) {
+      return status;
+    }
+    rtnh = RTNH_NEXT(rtnh);
+  }
+  DCHECK_EQ(reinterpret_cast<uint8_t*>(rtnh), buf.begin() + size);
+  return 0;
+}
+
+int
+NetlinkRouteMessage::encodeNextHop(
+    const thrift::NextHopThrift& nh,
+    unsigned char family,
+    IfIndexResolver getIfIndex,
+    struct rtnexthop* rtnh) {
+  const auto& gw = *nh.address_ref()->addr_ref();
+  if (gw.size() != folly::IPAddressV4::byteCount() and
+      gw.size() != folly::IPAddressV6::byteCount()) {
+    LOG(ERROR) << "Nexthop address not provided";
+    return EINVAL;
+  }
+
+  if (nh.address_ref()->ifName_ref().has_value()) {
+    const auto& ifName = nh.address_ref()->ifName_ref().value();
+    const auto ifIndex = getIfIndex(ifName);
+    if (not ifIndex.has_value()) {
+      LOG(ERROR) << "Failed to resolve interface " << ifName;
+      return ENODEV;
+    }
+    rtnh->rtnh_ifindex = ifIndex.value();
+  }
+
+  // Weight of fbnl::NextHop is of 8 bits
+  const uint8_t weight = *nh.weight_ref();
+  rtnh->rtnh_hops = weight ? weight - 1 : 0;
+
+  struct rtattr* rta = reinterpret_cast<struct rtattr*>(RTNH_DATA(rtnh));
+  const bool isPush = isPushNextHop(nh);
+  if (isPush) {
+    const auto& labels = nh.mplsAction_ref()->pushLabels_ref();
+    if (not labels.has_value()) {
+      LOG(ERROR) << "Labels not provided for PUSH action";
+      return EINVAL;
+    }
+    // abort immediately to bring attention
+    CHECK_LE(labels->size(), kMaxLabels);
+
+    // RTA_ENCAP nesting MPLS_IPTUNNEL_DST. Top of stack comes first
+    struct rtattr* rtaLabels = reinterpret_cast<struct rtattr*>(RTA_DATA(rta));
+    rtaLabels->rta_type = MPLS_IPTUNNEL_DST;
+    rtaLabels->rta_len =
+        RTA_LENGTH(labels->size() * sizeof(struct mpls_label));
+    auto mplsLabels = reinterpret_cast<struct mpls_label*>(RTA_DATA(rtaLabels));
+    const size_t numLabels = labels->size();
+    for (size_t i = 0; i < numLabels; ++i) {
+      mplsLabels[i].entry =
+          encodeLabel(labels->at(numLabels - 1 - i), i == numLabels - 1);
+    }
+    rta->rta_type = RTA_ENCAP;
+    rta->rta_len = RTA_LENGTH(RTA_ALIGN(rtaLabels->rta_len));
+    rta = nextAttribute(rta);
+
+    const uint16_t encapType = LWTUNNEL_ENCAP_MPLS;
+    putAttribute(rta, RTA_ENCAP_TYPE, &encapType, sizeof(encapType));
+    rta = nextAttribute(rta);
+  } else if (nh.mplsAction_ref().has_value()) {
+    LOG(ERROR) << "Only PUSH action is supported for unicast route";
+    return EINVAL;
+  }
+
+  // In case of route family is different from the NH gateway family,
+  // it requires to specify `RTA_VIA` field instead of `RTA_GATEWAY`.
+  if (not isPush and family == AF_INET and
+      gw.size() == folly::IPAddressV6::byteCount()) {
+    struct _NextHop via;
+    via.addrFamily = AF_INET6;
+    ::memcpy(via.ip, gw.data(), gw.size());
+    putAttribute(rta, RTA_VIA, &via, sizeof(via));
+  } else {
+    putAttribute(rta, RTA_GATEWAY, gw.data(), gw.size());
+  }
+
+  // Gateway is the last attribute of next-hop
+  rtnh->rtnh_len = reinterpret_cast<char*>(rta) + rta->rta_len -
+      reinterpret_cast<char*>(rtnh);
+  return 0;
+}
+
 int
 NetlinkRouteMessage::deleteRoute(const Route& route) {
   auto const& pfix = route.getDestination();
@@ -7,7 +7,11 @@
 
 #pragma once
 
+#include <functional>
+
+#include <folly/Function.h>
 #include <folly/IPAddress.h>
+#include <folly/Range.h>
 #include <openr/if/gen-cpp2/Network_types.h>
 #include <openr/nl/NetlinkMessageBase.h>
 #include <openr/nl/NetlinkTypes.h>
@@ -29,6 +33,14 @@ constexpr uint32_t kLabelBosShift{8};
 constexpr uint32_t kLabelShift{12};
 constexpr uint32_t kLabelSizeBits{20};
 
+// Callbacks of streamed route dump. Invoked on netlink event base thread
+using RouteChunkCallback = std::function<void(std::vector<Route>&&)>;
+using RouteDumpDoneCallback = std::function<void(int /* status */)>;
+
+// Resolve interface name of next-hop to its index
+using IfIndexResolver =
+    folly::FunctionRef<std::optional<int>(const std::string& /* ifName */)>;
+
 /**
  * Message specialization for rtnetlink ROUTE type
  *
@@ -70,6 +82,17 @@ class NetlinkRouteMessage final : public NetlinkMessageBase {
     return routePromise_.getSemiFuture();
   }
 
+  /**
+   * Stream received routes instead of accumulating all of them. Routes are
+   * handed to `onChunk` as soon as `chunkSize` of them are received, and the
+   * remaining ones on completion, followed by `onDone` with return status.
+   * Future of `getRoutesSemiFuture` is then fulfilled with no routes.
+   */
+  void setRouteChunkCallbacks(
+      size_t chunkSize,
+      RouteChunkCallback onChunk,
+      RouteDumpDoneCallback onDone);
+
   // initiallize route message with default params
   void init(int type, uint32_t flags, const Route& route);
 
@@ -94,6 +117,36 @@ class NetlinkRouteMessage final : public NetlinkMessageBase {
   // process netlink route message
   static Route parseMessage(const struct nlmsghdr* nlmsg);
 
+  /**
+   * Size of RTM_NEWROUTE message of `route` as encoded by
+   * `encodeUnicastRoute()`, i.e. buffer size it requires
+   */
+  static size_t getUnicastRouteSize(
+      const thrift::UnicastRoute& route, bool hasPriority);
+
+  /**
+   * Encode RTM_NEWROUTE message of `route` straight into `buf`, without
+   * building fbnl::Route and its set of fbnl::NextHop as `addRoute()` does.
+   * Message size is computed upfront, hence attributes are written in place,
+   * with no bound check per attribute nor copy of RTA_MULTIPATH.
+   *
+   * Message is the one `addRoute()` builds for the equivalent route of
+   * NetlinkFibHandler, in main routing table. Only IP and PUSH next-hops,
+   * i.e. the ones of unicast routes, are supported.
+   *
+   * @return:
+   *  - 0: on success, `nlmsg_len` of message is its size
+   *  - ENOBUFS: if `buf` is smaller than `getUnicastRouteSize()`
+   *  - EINVAL: if route or its next-hops are invalid
+   *  - ENODEV: if interface of next-hop can't be resolved
+   */
+  static int encodeUnicastRoute(
+      const thrift::UnicastRoute& route,
+      uint8_t protocol,
+      std::optional<uint32_t> priority,
+      IfIndexResolver getIfIndex,
+      folly::MutableByteRange buf);
+
  private:
   // inherited class implementation
   void rcvdRoute(Route&& route) override;
@@ -144,6 +197,13 @@ class NetlinkRouteMessage final : public NetlinkMessageBase {
       const NextHop& path,
       const Route& route) const;
 
+  // Encode next-hop of `encodeUnicastRoute()` at `rtnh`
+  static int encodeNextHop(
+      const thrift::NextHopThrift& nh,
+      unsigned char family,
+      IfIndexResolver getIfIndex,
+      struct rtnexthop* rtnh);
+
   // Add attribute RTA_TABLE. MPLS does not allow the table attribute to be set
   int addRtaTable(uint32_t tableId);
 
@@ -178,6 +238,11 @@ class NetlinkRouteMessage final : public NetlinkMessageBase {
   // promise to be fulfilled when receiving kernel reply
   folly::Promise<folly::Expected<std::vector<Route>, int>> routePromise_;
   std::vector<Route> rcvdRoutes_;
+
+  // set for streamed route dump
+  size_t chunkSize_{0};
+  RouteChunkCallback onChunk_;
+  RouteDumpDoneCallback onDone_;
 };
 
 } // namespace openr::fbnl
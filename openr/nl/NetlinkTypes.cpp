@@ -5,6 +5,9 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <folly/String.h>
+#include <folly/hash/Hash.h>
+
 #include <openr/nl/NetlinkTypes.h>
 
 extern "C" {
@@ -144,12 +147,29 @@ RouteBuilder::getAdvMss() const {
   return advMss_;
 }
 
+RouteBuilder&
+RouteBuilder::setNextHopId(uint32_t nhId) {
+  nhId_ = nhId;
+  return *this;
+}
+
+std::optional<uint32_t>
+RouteBuilder::getNextHopId() const {
+  return nhId_;
+}
+
 RouteBuilder&
 RouteBuilder::addNextHop(const NextHop& nextHop) {
   nextHops_.emplace(nextHop);
   return *this;
 }
 
+RouteBuilder&
+RouteBuilder::addNextHop(NextHop&& nextHop) {
+  nextHops_.emplace(std::move(nextHop));
+  return *this;
+}
+
 const NextHopSet&
 RouteBuilder::getNextHops() const {
   return nextHops_;
@@ -183,6 +203,7 @@ RouteBuilder::reset() {
   tos_.reset();
   mtu_.reset();
   advMss_.reset();
+  nhId_.reset();
   nextHops_.clear();
 }
 
@@ -200,7 +221,8 @@ Route::Route(const RouteBuilder& builder)
       advMss_(builder.getAdvMss()),
       nextHops_(builder.getNextHops()),
       dst_(builder.getDestination()),
-      mplsLabel_(builder.getMplsLabel()) {}
+      mplsLabel_(builder.getMplsLabel()),
+      nhId_(builder.getNextHopId()) {}
 
 Route::~Route() {}
 
@@ -227,6 +249,7 @@ Route::operator=(Route&& other) noexcept {
   dst_ = std::move(other.dst_);
   family_ = std::move(other.family_);
   mplsLabel_ = std::move(other.mplsLabel_);
+  nhId_ = std::move(other.nhId_);
   return *this;
 }
 
@@ -253,6 +276,7 @@ Route::operator=(const Route& other) {
   dst_ = other.dst_;
   family_ = other.family_;
   mplsLabel_ = other.mplsLabel_;
+  nhId_ = other.nhId_;
   return *this;
 }
 
@@ -269,6 +293,7 @@ operator==(const Route& lhs, const Route& rhs) {
        lhs.getFlags() == rhs.getFlags() &&
        lhs.getPriority() == rhs.getPriority() && lhs.getTos() == rhs.getTos() &&
        lhs.getMtu() == rhs.getMtu() && lhs.getAdvMss() == rhs.getAdvMss() &&
+       lhs.getNextHopId() == rhs.getNextHopId() &&
        lhs.getFamily() == rhs.getFamily());
 
   if (!ret) {
@@ -320,6 +345,11 @@ Route::getAdvMss() const {
   return advMss_;
 }
 
+std::optional<uint32_t>
+Route::getNextHopId() const {
+  return nhId_;
+}
+
 uint32_t
 Route::getRouteTable() const {
   return routeTable_;
@@ -387,6 +417,9 @@ Route::str() const {
   if (advMss_) {
     result += fmt::format(", advmss {}", advMss_.value());
   }
+  if (nhId_) {
+    result += fmt::format(", nhid {}", nhId_.value());
+  }
   for (auto const& nextHop : nextHops_) {
     result += "\n  " + nextHop.str();
   }
@@ -403,6 +436,85 @@ Route::setNextHops(const NextHopSet& nextHops) {
   nextHops_ = nextHops;
 }
 
+void
+Route::setNextHopId(uint32_t nhId) {
+  nhId_ = nhId;
+}
+
+/*=============================NextHopObject==================================*/
+
+NextHopObject::NextHopObject(uint32_t id, uint8_t protocolId)
+    : id_(id), protocolId_(protocolId) {}
+
+uint32_t
+NextHopObject::getId() const {
+  return id_;
+}
+
+uint8_t
+NextHopObject::getProtocolId() const {
+  return protocolId_;
+}
+
+uint8_t
+NextHopObject::getFamily() const {
+  if (nextHop_.has_value()) {
+    return nextHop_->getFamily();
+  }
+  return AF_UNSPEC;
+}
+
+bool
+NextHopObject::isGroup() const {
+  return not group_.empty();
+}
+
+void
+NextHopObject::setNextHop(const NextHop& nextHop) {
+  nextHop_ = nextHop;
+  group_.clear();
+}
+
+const std::optional<NextHop>&
+NextHopObject::getNextHop() const {
+  return nextHop_;
+}
+
+void
+NextHopObject::setGroup(std::vector<std::pair<uint32_t, uint8_t>> group) {
+  group_ = std::move(group);
+  nextHop_.reset();
+}
+
+const std::vector<std::pair<uint32_t, uint8_t>>&
+NextHopObject::getGroup() const {
+  return group_;
+}
+
+std::string
+NextHopObject::str() const {
+  std::string result = fmt::format("nexthop id {}, proto {}", id_, protocolId_);
+  if (nextHop_.has_value()) {
+    result += ", " + nextHop_->str();
+  }
+  if (not group_.empty()) {
+    std::vector<std::string> members;
+    for (auto const& [id, weight] : group_) {
+      members.emplace_back(fmt::format("{},{}", id, weight));
+    }
+    result += fmt::format(", group {}", folly::join("/", members));
+  }
+  return result;
+}
+
+bool
+operator==(const NextHopObject& lhs, const NextHopObject& rhs) {
+  return lhs.getId() == rhs.getId() and
+      lhs.getProtocolId() == rhs.getProtocolId() and
+      lhs.getNextHop() == rhs.getNextHop() and
+      lhs.getGroup() == rhs.getGroup();
+}
+
 /*=================================NextHop====================================*/
 
 NextHop
@@ -524,16 +636,16 @@ operator==(const NextHop& lhs, const NextHop& rhs) {
 
 size_t
 NextHopHash::operator()(const NextHop& nh) const {
+  // NOTE: Avoid string conversions, it is computed for every nexthop of every
+  // route on insertion and lookup
   size_t res = 0;
   if (nh.getIfIndex().has_value()) {
-    res += std::hash<std::string>()(std::to_string(nh.getIfIndex().value()));
+    res = folly::hash::hash_combine(res, nh.getIfIndex().value());
   }
   if (nh.getGateway().has_value()) {
-    res += std::hash<std::string>()(nh.getGateway().value().str());
+    res = folly::hash::hash_combine(res, nh.getGateway().value());
   }
-  res += std::hash<std::string>()(
-      std::to_string(std::max(nh.getWeight(), uint8_t(1))));
-  return res;
+  return folly::hash::hash_combine(res, std::max(nh.getWeight(), uint8_t(1)));
 }
 
 std::optional<int>
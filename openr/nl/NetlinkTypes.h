@@ -186,6 +186,7 @@ class RouteBuilder {
 
   // [REQUIRED] unicast routes nexthop related methods
   RouteBuilder& addNextHop(const NextHop& nextHop);
+  RouteBuilder& addNextHop(NextHop&& nextHop);
   const NextHopSet& getNextHops() const;
 
   // [REQUIRED] mpls routes label related methods
@@ -221,6 +222,11 @@ class RouteBuilder {
   RouteBuilder& setAdvMss(uint32_t tos);
   std::optional<uint32_t> getAdvMss() const;
 
+  // Kernel nexthop object (RTA_NH_ID) related methods. When set, route is
+  // programmed with the nexthop object instead of its own nexthops
+  RouteBuilder& setNextHopId(uint32_t nhId);
+  std::optional<uint32_t> getNextHopId() const;
+
   // ATTN: `family_` will be set when:
   //    UNICAST: `dst_` is set;
   //    MPLS: `mplsLabel_` is set;
@@ -245,6 +251,7 @@ class RouteBuilder {
   NextHopSet nextHops_;
   folly::CIDRNetwork dst_;
   std::optional<uint32_t> mplsLabel_;
+  std::optional<uint32_t> nhId_;
 };
 
 class Route final {
@@ -283,6 +290,8 @@ class Route final {
 
   std::optional<uint32_t> getAdvMss() const;
 
+  std::optional<uint32_t> getNextHopId() const;
+
   const NextHopSet& getNextHops() const;
 
   bool isValid() const;
@@ -293,6 +302,8 @@ class Route final {
 
   void setNextHops(const NextHopSet& nextHops);
 
+  void setNextHopId(uint32_t nhId);
+
  private:
   uint8_t type_{RTN_UNICAST};
   uint32_t routeTable_{RT_TABLE_MAIN};
@@ -308,10 +319,50 @@ class Route final {
   NextHopSet nextHops_;
   folly::CIDRNetwork dst_;
   std::optional<uint32_t> mplsLabel_;
+  std::optional<uint32_t> nhId_;
 };
 
 bool operator==(const Route& lhs, const Route& rhs);
 
+/**
+ * Kernel nexthop object (RTM_NEWNEXTHOP, Linux 5.3+). An object is either a
+ * single nexthop or a group of other nexthop objects referred by their IDs
+ * along with per member weight. Routes refer to a nexthop object by its ID
+ * (see `RouteBuilder::setNextHopId`) so that the nexthops shared by many
+ * routes are programmed only once.
+ */
+class NextHopObject final {
+ public:
+  explicit NextHopObject(uint32_t id, uint8_t protocolId = DEFAULT_PROTOCOL_ID);
+
+  uint32_t getId() const;
+
+  uint8_t getProtocolId() const;
+
+  // AF_UNSPEC for group, else family of nexthop gateway
+  uint8_t getFamily() const;
+
+  bool isGroup() const;
+
+  // Set for single nexthop object. Weight of nexthop is ignored
+  void setNextHop(const NextHop& nextHop);
+  const std::optional<NextHop>& getNextHop() const;
+
+  // Set for group object. Each member is pair of <nexthop-id, weight>
+  void setGroup(std::vector<std::pair<uint32_t, uint8_t>> group);
+  const std::vector<std::pair<uint32_t, uint8_t>>& getGroup() const;
+
+  std::string str() const;
+
+ private:
+  uint32_t id_{0};
+  uint8_t protocolId_{DEFAULT_PROTOCOL_ID};
+  std::optional<NextHop> nextHop_;
+  std::vector<std::pair<uint32_t, uint8_t>> group_;
+};
+
+bool operator==(const NextHopObject& lhs, const NextHopObject& rhs);
+
 class IfAddress;
 class IfAddressBuilder final {
  public:
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <fmt/format.h>
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include <openr/common/NetworkUtil.h>
+#include <openr/common/Util.h>
+#include <openr/nl/NetlinkRouteMessage.h>
+
+using namespace openr::fbnl;
+
+namespace {
+// Protocol and priority of routes, as programmed by NetlinkFibHandler
+const uint8_t kProtocolId{99};
+const uint32_t kPriority{10};
+// Number of interfaces next-hops are spread across
+const int kNumIfaces{16};
+} // namespace
+
+namespace openr {
+
+namespace {
+
+std::string
+getIfName(int ifIndex) {
+  return fmt::format("eth{}", ifIndex);
+}
+
+std::optional<int>
+getIfIndex(const std::string& ifName) {
+  return folly::to<int>(ifName.substr(3));
+}
+
+/**
+ * Unicast route towards v6 prefix over `numNexthops` link-local next-hops,
+ * pushing `numLabels` labels if any
+ */
+thrift::UnicastRoute
+createRoute(uint32_t index, uint32_t numNexthops, uint32_t numLabels) {
+  std::vector<thrift::NextHopThrift> nexthops;
+  for (uint32_t i = 0; i < numNexthops; ++i) {
+    std::optional<thrift::MplsAction> mplsAction;
+    if (numLabels) {
+      std::vector<int32_t> labels;
+      for (uint32_t j = 0; j < numLabels; ++j) {
+        labels.emplace_back(100 + i * numLabels + j);
+      }
+      mplsAction = createMplsAction(
+          thrift::MplsActionCode::PUSH, std::nullopt, std::move(labels));
+    }
+    nexthops.emplace_back(createNextHop(
+        toBinaryAddress(fmt::format("fe80::{}", i + 1)),
+        getIfName(i % kNumIfaces),
+        0,
+        std::move(mplsAction)));
+  }
+  return createUnicastRoute(
+      toIpPrefix(fmt::format("fc00:{:x}::/64", index)), std::move(nexthops));
+}
+
+/**
+ * fbnl::Route of thrift route, as built by NetlinkFibHandler for addRoute()
+ */
+Route
+buildRoute(const thrift::UnicastRoute& route) {
+  RouteBuilder rtBuilder;
+  rtBuilder.setDestination(toIPNetwork(*route.dest_ref()))
+      .setProtocolId(kProtocolId)
+      .setPriority(kPriority)
+      .setFlags(0)
+      .setValid(true);
+  NextHopBuilder nhBuilder;
+  for (const auto& nh : *route.nextHops_ref()) {
+    nhBuilder.setIfIndex(getIfIndex(*nh.address_ref()->ifName_ref()).value());
+    nhBuilder.setGateway(toIPAddress(*nh.address_ref()));
+    if (nh.mplsAction_ref().has_value()) {
+      nhBuilder.setLabelAction(thrift::MplsActionCode::PUSH);
+      nhBuilder.setPushLabels(*nh.mplsAction_ref()->pushLabels_ref());
+    }
+    nhBuilder.setWeight(*nh.weight_ref());
+    rtBuilder.addNextHop(nhBuilder.build());
+    nhBuilder.reset();
+  }
+  return rtBuilder.build();
+}
+
+} // namespace
+
+/**
+ * Encode message of route already built as fbnl::Route
+ */
+static void
+BM_AddRoute(uint32_t iters, uint32_t numNexthops, uint32_t numLabels) {
+  auto suspender = folly::BenchmarkSuspender();
+  const auto route = buildRoute(createRoute(0, numNexthops, numLabels));
+
+  suspender.dismiss(); // Start measuring benchmark time
+  for (uint32_t i = 0; i < iters; ++i) {
+    NetlinkRouteMessage msg;
+    CHECK_EQ(0, msg.addRoute(route));
+    folly::doNotOptimizeAway(msg.getDataLength());
+    msg.setReturnStatus(0);
+  }
+  suspender.rehire(); // Stop measuring time again
+}
+
+/**
+ * Encode message of thrift route, building fbnl::Route out of it first as
+ * NetlinkFibHandler does
+ */
+static void
+BM_BuildAndAddRoute(
+    uint32_t iters, uint32_t numNexthops, uint32_t numLabels) {
+  auto suspender = folly::BenchmarkSuspender();
+  const auto route = createRoute(0, numNexthops, numLabels);
+
+  suspender.dismiss(); // Start measuring benchmark time
+  for (uint32_t i = 0; i < iters; ++i) {
+    NetlinkRouteMessage msg;
+    CHECK_EQ(0, msg.addRoute(buildRoute(route)));
+    folly::doNotOptimizeAway(msg.getDataLength());
+    msg.setReturnStatus(0);
+  }
+  suspender.rehire(); // Stop measuring time again
+}
+
+/**
+ * Encode message of thrift route straight into a reused buffer
+ */
+static void
+BM_EncodeUnicastRoute(
+    uint32_t iters, uint32_t numNexthops, uint32_t numLabels) {
+  auto suspender = folly::BenchmarkSuspender();
+  const auto route = createRoute(0, numNexthops, numLabels);
+  std::vector<uint8_t> buf(
+      NetlinkRouteMessage::getUnicastRouteSize(route, true));
+
+  suspender.dismiss(); // Start measuring benchmark time
+  for (uint32_t i = 0; i < iters; ++i) {
+    CHECK_EQ(
+        0,
+        NetlinkRouteMessage::encodeUnicastRoute(
+            route,
+            kProtocolId,
+            kPriority,
+            getIfIndex,
+            folly::MutableByteRange(buf.data(), buf.size())));
+    folly::doNotOptimizeAway(buf.data());
+  }
+  suspender.rehire(); // Stop measuring time again
+}
+
+/**
+ * Parse route of dump, i.e. RTM_NEWROUTE message, into fbnl::Route
+ */
+static void
+BM_ParseRoute(uint32_t iters, uint32_t numNexthops, uint32_t numLabels) {
+  auto suspender = folly::BenchmarkSuspender();
+  const auto route = createRoute(0, numNexthops, numLabels);
+  std::vector<uint8_t> buf(
+      NetlinkRouteMessage::getUnicastRouteSize(route, true));
+  CHECK_EQ(
+      0,
+      NetlinkRouteMessage::encodeUnicastRoute(
+          route,
+          kProtocolId,
+          kPriority,
+          getIfIndex,
+          folly::MutableByteRange(buf.data(), buf.size())));
+  const auto nlmsg = reinterpret_cast<const struct nlmsghdr*>(buf.data());
+
+  suspender.dismiss(); // Start measuring benchmark time
+  for (uint32_t i = 0; i < iters; ++i) {
+    auto parsedRoute = NetlinkRouteMessage::parseMessage(nlmsg);
+    CHECK_EQ(numNexthops, parsedRoute.getNextHops().size());
+  }
+  suspender.rehire(); // Stop measuring time again
+}
+
+// The parameters are number of next-hops and labels pushed by each of them
+BENCHMARK_NAMED_PARAM(BM_AddRoute, 1_0, 1, 0);
+BENCHMARK_NAMED_PARAM(BM_AddRoute, 16_0, 16, 0);
+BENCHMARK_NAMED_PARAM(BM_AddRoute, 128_0, 128, 0);
+BENCHMARK_NAMED_PARAM(BM_AddRoute, 16_2, 16, 2);
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_NAMED_PARAM(BM_BuildAndAddRoute, 1_0, 1, 0);
+BENCHMARK_RELATIVE_NAMED_PARAM(BM_EncodeUnicastRoute, 1_0, 1, 0);
+BENCHMARK_NAMED_PARAM(BM_BuildAndAddRoute, 16_0, 16, 0);
+BENCHMARK_RELATIVE_NAMED_PARAM(BM_EncodeUnicastRoute, 16_0, 16, 0);
+BENCHMARK_NAMED_PARAM(BM_BuildAndAddRoute, 128_0, 128, 0);
+BENCHMARK_RELATIVE_NAMED_PARAM(BM_EncodeUnicastRoute, 128_0, 128, 0);
+BENCHMARK_NAMED_PARAM(BM_BuildAndAddRoute, 16_2, 16, 2);
+BENCHMARK_RELATIVE_NAMED_PARAM(BM_EncodeUnicastRoute, 16_2, 16, 2);
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_NAMED_PARAM(BM_ParseRoute, 1_0, 1, 0);
+BENCHMARK_NAMED_PARAM(BM_ParseRoute, 16_0, 16, 0);
+BENCHMARK_NAMED_PARAM(BM_ParseRoute, 128_0, 128, 0);
+BENCHMARK_NAMED_PARAM(BM_ParseRoute, 16_2, 16, 2);
+
+} // namespace openr
+
+int
+main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -583,6 +583,94 @@ TEST(NetlinkRouteMessage, EncodeLabel) {
   }
 }
 
+/**
+ * Dump request carries the filters in header for kernel to filter on. MPLS
+ * dump request must only carry protocol to pass kernel strict checks.
+ */
+TEST(NetlinkRouteMessage, GetRouteFilters) {
+  {
+    NetlinkRouteMessage msg;
+    msg.initGet(
+        0,
+        RouteBuilder()
+            .setDestination({folly::IPAddressV6("::"), 0})
+            .setProtocolId(99)
+            .setRouteTable(1000)
+            .build());
+    auto rtm = reinterpret_cast<struct rtmsg*>(NLMSG_DATA(msg.getMessagePtr()));
+    EXPECT_EQ(AF_INET6, rtm->rtm_family);
+    EXPECT_EQ(99, rtm->rtm_protocol);
+    EXPECT_EQ(RT_TABLE_COMPAT, rtm->rtm_table);
+    EXPECT_EQ(RTN_UNICAST, rtm->rtm_type);
+    // RTA_TABLE attribute is added for table id
+    EXPECT_LT(NLMSG_LENGTH(sizeof(struct rtmsg)), msg.getDataLength());
+    msg.setReturnStatus(0);
+  }
+
+  {
+    NetlinkRouteMessage msg;
+    msg.initGet(0, RouteBuilder().setMplsLabel(0).setProtocolId(99).build());
+    auto rtm = reinterpret_cast<struct rtmsg*>(NLMSG_DATA(msg.getMessagePtr()));
+    EXPECT_EQ(AF_MPLS, rtm->rtm_family);
+    EXPECT_EQ(99, rtm->rtm_protocol);
+    EXPECT_EQ(0, rtm->rtm_table);
+    EXPECT_EQ(0, rtm->rtm_type);
+    EXPECT_EQ(NLMSG_LENGTH(sizeof(struct rtmsg)), msg.getDataLength());
+    msg.setReturnStatus(0);
+  }
+}
+
+TEST(NetlinkProtocolSocket, RouteEventsFilter) {
+  // Only route messages are inspected when there is nothing to match
+  auto filter = NetlinkProtocolSocket::createRouteEventsFilter({}, {});
+  ASSERT_EQ(6, filter.size());
+  EXPECT_EQ(BPF_RET | BPF_K, filter.back().code);
+  EXPECT_EQ(0xffffffff, filter.back().k);
+
+  // Load, match per value and drop for every non-empty list
+  filter = NetlinkProtocolSocket::createRouteEventsFilter({99, 253}, {254});
+  ASSERT_EQ(6 + 4 + 3, filter.size());
+  EXPECT_EQ(
+      NLMSG_HDRLEN + offsetof(struct rtmsg, rtm_protocol), filter.at(5).k);
+  EXPECT_EQ(99, filter.at(6).k);
+  EXPECT_EQ(253, filter.at(7).k);
+  // Match jumps past the drop statement
+  EXPECT_EQ(2, filter.at(6).jt);
+  EXPECT_EQ(1, filter.at(7).jt);
+  EXPECT_EQ(BPF_RET | BPF_K, filter.at(8).code);
+  EXPECT_EQ(0, filter.at(8).k);
+  EXPECT_EQ(NLMSG_HDRLEN + offsetof(struct rtmsg, rtm_table), filter.at(9).k);
+  EXPECT_EQ(254, filter.at(10).k);
+}
+
+TEST(NetlinkMessageBase, CompactBuffer) {
+  NetlinkRouteMessage msg;
+  msg.initGet(0, RouteBuilder().setMplsLabel(0).setProtocolId(99).build());
+  const std::string data(
+      reinterpret_cast<const char*>(msg.getMessagePtr()),
+      msg.getDataLength());
+
+  // Message contents are retained after moving it to a smaller buffer
+  msg.compact();
+  EXPECT_EQ(NLMSG_LENGTH(sizeof(struct rtmsg)), msg.getDataLength());
+  EXPECT_EQ(
+      data,
+      std::string(
+          reinterpret_cast<const char*>(msg.getMessagePtr()),
+          msg.getDataLength()));
+  msg.setReturnStatus(0);
+
+  // Released buffers are handed out for next allocation of same size class
+  auto buf = NetlinkBufferPool::allocate(kMaxNlPayloadSize);
+  NetlinkBufferPool::release(buf, kMaxNlPayloadSize);
+  EXPECT_EQ(buf, NetlinkBufferPool::allocate(kMaxNlPayloadSize - 1));
+  NetlinkBufferPool::release(buf, kMaxNlPayloadSize);
+
+  EXPECT_EQ(0, NetlinkBufferPool::getSizeClass(1));
+  EXPECT_EQ(0, NetlinkBufferPool::getSizeClass(kNlBufferSizeClass));
+  EXPECT_EQ(1, NetlinkBufferPool::getSizeClass(kNlBufferSizeClass + 1));
+}
+
 /**
  * This test intends to test the delayed looping of event-base. Request is
  * made before event loop is started. This will help ensuring that socket
@@ -1815,6 +1903,146 @@ TEST_F(NlMessageFixture, MultipleLabelRoutes) {
   EXPECT_EQ(0, kernelRoutes.size());
 }
 
+/*
+ * Add label routes in bulk. Acks are coalesced and error of an invalid route
+ * in the middle of batch is reported for that route only
+ */
+TEST_F(NlMessageFixture, MultipleLabelRoutesBulk) {
+  const uint32_t count{1000};
+  std::vector<NextHop> paths;
+  paths.push_back(buildNextHop(
+      std::nullopt,
+      swapLabel,
+      thrift::MplsActionCode::SWAP,
+      ipAddrY1V6,
+      ifIndexX));
+  std::vector<Route> labelRoutes;
+  for (uint32_t i = 0; i < count; i++) {
+    labelRoutes.push_back(
+        buildRoute(kRouteProtoId, std::nullopt, 600 + i, paths));
+  }
+
+  // Invalid route (AF_UNSPEC) in the middle of batch
+  auto routes = labelRoutes;
+  routes.insert(
+      routes.begin() + count / 2,
+      buildRoute(kRouteProtoId, std::nullopt, std::nullopt, paths));
+
+  const auto coalescedCount = facebook::fb303::fbData->getCounters()
+                                  ["netlink.requests.coalesced.sum"];
+  auto statuses = nlSock->addRoutes(std::move(routes)).get();
+  ASSERT_EQ(count + 1, statuses.size());
+  for (size_t i = 0; i < statuses.size(); ++i) {
+    EXPECT_EQ(i == count / 2 ? -EPROTONOSUPPORT : 0, statuses.at(i));
+  }
+  EXPECT_EQ(0, getErrorCount());
+  // Only every `kNlBatchAckInterval`-th message and the last one are acked
+  EXPECT_EQ(
+      coalescedCount + count - count / kNlBatchAckInterval,
+      facebook::fb303::fbData->getCounters()
+          ["netlink.requests.coalesced.sum"]);
+
+  // verify routes in kernel
+  auto kernelRoutes = nlSock->getMplsRoutes(kRouteProtoId).get().value();
+  EXPECT_EQ(kernelRoutes.size(), labelRoutes.size());
+  EXPECT_EQ(findRoutesInKernelRoutes(kernelRoutes, labelRoutes), count);
+
+  {
+    std::vector<folly::SemiFuture<int>> futures;
+    for (auto& route : labelRoutes) {
+      futures.emplace_back(nlSock->deleteRoute(route));
+    }
+    EXPECT_EQ(
+        NetlinkProtocolSocket::collectReturnStatus(std::move(futures)).get(),
+        folly::Unit());
+  }
+  kernelRoutes = nlSock->getMplsRoutes(kRouteProtoId).get().value();
+  EXPECT_EQ(0, kernelRoutes.size());
+}
+
+/*
+ * Program routes over route sockets. Routes are sharded across sockets and
+ * results are reported in order of request
+ */
+TEST_F(NlMessageFixture, RouteSocketsProgramming) {
+  // Netlink socket with route sockets. Event base must not be running when
+  // socket is constructed
+  folly::EventBase routeEvb;
+  auto routeNlSock = std::make_unique<NetlinkProtocolSocket>(
+      &routeEvb, netlinkEventsQ, FLAGS_enable_ipv6_rr_semantics, 4);
+  std::thread routeEvbThread([&]() { routeEvb.loopForever(); });
+  routeEvb.waitUntilRunning();
+
+  const uint32_t count{1000};
+  auto routes = buildV6RouteDb(count);
+  EXPECT_EQ(std::vector<int>(count, 0), routeNlSock->addRoutes(routes).get());
+  EXPECT_EQ(0, getErrorCount());
+
+  // Routes are visible to other sockets
+  auto kernelRoutes = nlSock->getIPv6Routes(kRouteProtoId).get().value();
+  EXPECT_EQ(count, kernelRoutes.size());
+  EXPECT_EQ(count, findRoutesInKernelRoutes(kernelRoutes, routes));
+
+  {
+    std::vector<folly::SemiFuture<int>> futures;
+    for (auto& route : routes) {
+      futures.emplace_back(routeNlSock->deleteRoute(route));
+    }
+    EXPECT_EQ(
+        NetlinkProtocolSocket::collectReturnStatus(std::move(futures)).get(),
+        folly::Unit());
+  }
+  EXPECT_EQ(0, getErrorCount());
+  kernelRoutes = nlSock->getIPv6Routes(kRouteProtoId).get().value();
+  EXPECT_EQ(0, kernelRoutes.size());
+
+  routeEvb.terminateLoopSoon();
+  routeEvbThread.join();
+  routeNlSock.reset();
+}
+
+TEST_F(NlMessageFixture, RouteEventsSubscription) {
+  // Socket subscribed to IPv6 route notifications of Open/R protocol only.
+  // Event base must not be running when socket is constructed.
+  folly::EventBase eventsEvb;
+  messaging::ReplicateQueue<NetlinkEvent> routeEventsQ;
+  auto routeEventsReader = routeEventsQ.getReader();
+  NetlinkEventsConfig eventsConfig;
+  eventsConfig.groups = RTMGRP_IPV6_ROUTE;
+  eventsConfig.routeProtocols = {kRouteProtoId};
+  auto eventsNlSock = std::make_unique<NetlinkProtocolSocket>(
+      &eventsEvb, routeEventsQ, false, 0, eventsConfig);
+  std::thread eventsEvbThread([&]() { eventsEvb.loopForever(); });
+  eventsEvb.waitUntilRunning();
+
+  // Add route of other protocol followed by the Open/R one
+  const std::vector<NextHop> paths{buildNextHop(
+      std::nullopt, std::nullopt, std::nullopt, ipAddrY1V6, ifIndexX)};
+  auto bgpRoute = buildRoute(kBgpProtoId, ipPrefix1, std::nullopt, paths);
+  auto openrRoute = buildRoute(kRouteProtoId, ipPrefix2, std::nullopt, paths);
+  EXPECT_EQ(0, nlSock->addRoute(bgpRoute).get());
+  EXPECT_EQ(0, nlSock->addRoute(openrRoute).get());
+
+  // Only the notification of Open/R route is received
+  auto event = routeEventsReader.get();
+  ASSERT_TRUE(event.hasValue());
+  auto* route = std::get_if<Route>(&event.value());
+  ASSERT_NE(nullptr, route);
+  EXPECT_EQ(kRouteProtoId, route->getProtocolId());
+  EXPECT_EQ(ipPrefix2, route->getDestination());
+
+  // Dump of all the protocols isn't filtered
+  EXPECT_LE(2, eventsNlSock->getAllRoutes().get().value().size());
+
+  EXPECT_EQ(0, nlSock->deleteRoute(bgpRoute).get());
+  EXPECT_EQ(0, nlSock->deleteRoute(openrRoute).get());
+
+  routeEventsQ.close();
+  eventsEvb.terminateLoopSoon();
+  eventsEvbThread.join();
+  eventsNlSock.reset();
+}
+
 /*
  * Flap multiple links up and down and stress test link events
  */
@@ -2224,6 +2452,76 @@ TEST_F(NlMessageFixture, RuleAddDeleteTest) {
   EXPECT_EQ(rules.size(), before.size());
 }
 
+/*
+ * Tests nexthop object add/get/del API and route referring nexthop group
+ * - add two nexthops and a group of them, verify the objects
+ * - add route with the nexthop group, verify route and resolved nexthops
+ * - delete group and nexthops, verify route is removed along with them
+ */
+TEST_F(NlMessageFixture, NexthopGroupAddDeleteTest) {
+  using namespace ::testing;
+
+  uint32_t ackCount{0};
+  const auto before = nlSock->getAllNexthops().get().value();
+
+  NextHopObject nh1(1001, kRouteProtoId);
+  nh1.setNextHop(buildNextHop(
+      std::nullopt, std::nullopt, std::nullopt, ipAddrY1V6, ifIndexX));
+  NextHopObject nh2(1002, kRouteProtoId);
+  nh2.setNextHop(buildNextHop(
+      outLabel2,
+      std::nullopt,
+      thrift::MplsActionCode::PUSH,
+      ipAddrY2V6,
+      ifIndexX));
+  NextHopObject group(1003, kRouteProtoId);
+  group.setGroup({{nh1.getId(), 1}, {nh2.getId(), 2}});
+
+  // add nexthops and group
+  ackCount = getAckCount();
+  EXPECT_EQ(0, nlSock->addNexthop(nh1).get());
+  EXPECT_EQ(0, nlSock->addNexthop(nh2).get());
+  EXPECT_EQ(0, nlSock->addNexthop(group).get());
+  EXPECT_EQ(0, getErrorCount());
+  EXPECT_GE(getAckCount(), ackCount + 3);
+
+  // verify nexthop objects
+  auto nexthops = nlSock->getAllNexthops().get().value();
+  EXPECT_EQ(before.size() + 3, nexthops.size());
+  EXPECT_THAT(nexthops, AllOf(Contains(nh1), Contains(nh2), Contains(group)));
+
+  // add route referring to nexthop group
+  auto route = RouteBuilder()
+                   .setDestination(ipPrefix1)
+                   .setProtocolId(kRouteProtoId)
+                   .setPriority(protoIdToPriority.at(kRouteProtoId))
+                   .setNextHopId(group.getId())
+                   .setValid(true)
+                   .build();
+  ackCount = getAckCount();
+  EXPECT_EQ(0, nlSock->addRoute(route).get());
+  EXPECT_EQ(0, getErrorCount());
+  EXPECT_GE(getAckCount(), ackCount + 1);
+
+  // verify route refers nexthop group and resolves to its nexthops
+  auto routes = nlSock->getIPv6Routes(kRouteProtoId).get().value();
+  ASSERT_EQ(1, routes.size());
+  EXPECT_EQ(group.getId(), routes.at(0).getNextHopId());
+  EXPECT_EQ(2, routes.at(0).getNextHops().size());
+
+  // delete group and nexthops. Kernel removes route referring to them
+  ackCount = getAckCount();
+  EXPECT_EQ(0, nlSock->deleteNexthop(group).get());
+  EXPECT_EQ(0, nlSock->deleteNexthop(nh1).get());
+  EXPECT_EQ(0, nlSock->deleteNexthop(nh2).get());
+  EXPECT_EQ(0, getErrorCount());
+  EXPECT_GE(getAckCount(), ackCount + 3);
+  nexthops = nlSock->getAllNexthops().get().value();
+  EXPECT_EQ(before.size(), nexthops.size());
+  routes = nlSock->getIPv6Routes(kRouteProtoId).get().value();
+  EXPECT_EQ(0, routes.size());
+}
+
 /*
  * Validate unicast routes with with 1 push label next-hop, empty gateway
  */
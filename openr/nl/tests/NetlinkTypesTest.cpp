@@ -5,6 +5,8 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <openr/common/NetworkUtil.h>
+#include <openr/nl/NetlinkRouteMessage.h>
 #include <openr/nl/NetlinkTypes.h>
 
 #include <glog/logging.h>
@@ -653,6 +655,98 @@ TEST(NetlinkTypes, RuleTypeBaseTest) {
   EXPECT_EQ(priority, rule.getPriority());
 }
 
+TEST(NetlinkTypes, EncodeUnicastRouteTest) {
+  auto getIfIndex = [](const std::string& ifName) -> std::optional<int> {
+    if (ifName == "eth1") {
+      return kIfIndex;
+    }
+    return std::nullopt;
+  };
+  const auto gw1 = folly::IPAddress("fe80::1");
+  const auto gw2 = folly::IPAddress("10.0.0.2");
+  const auto gw3 = folly::IPAddress("10.0.0.3");
+  const std::vector<int32_t> labels{100, 200};
+
+  // Same route, as thrift::UnicastRoute and as fbnl::Route. Host bits of
+  // thrift destination must be cleared, and PUSH next-hop encoded.
+  std::vector<thrift::NextHopThrift> tNextHops{
+      createNextHop(toBinaryAddress(gw1), "eth1"),
+      createNextHop(toBinaryAddress(gw2)),
+      createNextHop(
+          toBinaryAddress(gw3),
+          "eth1",
+          0,
+          createMplsAction(
+              thrift::MplsActionCode::PUSH, std::nullopt, labels))};
+  tNextHops.at(1).weight_ref() = kWeight;
+  auto tRoute =
+      createUnicastRoute(toIpPrefix("10.1.0.0/16"), std::move(tNextHops));
+  tRoute.dest_ref()->prefixAddress_ref() = toBinaryAddress("10.1.1.1");
+
+  NextHopBuilder nhBuilder;
+  RouteBuilder rtBuilder;
+  rtBuilder.setDestination(folly::IPAddress::createNetwork("10.1.0.0/16"))
+      .setProtocolId(kProtocolId)
+      .setPriority(10)
+      .setFlags(0)
+      .setValid(true)
+      .addNextHop(nhBuilder.setIfIndex(kIfIndex).setGateway(gw1).build());
+  nhBuilder.reset();
+  rtBuilder.addNextHop(nhBuilder.setGateway(gw2).setWeight(kWeight).build());
+  nhBuilder.reset();
+  rtBuilder.addNextHop(nhBuilder.setIfIndex(kIfIndex)
+                           .setGateway(gw3)
+                           .setLabelAction(thrift::MplsActionCode::PUSH)
+                           .setPushLabels(labels)
+                           .build());
+  const auto route = rtBuilder.build();
+
+  // Encode with addRoute()
+  NetlinkRouteMessage msg;
+  ASSERT_EQ(0, msg.addRoute(route));
+  msg.setReturnStatus(0);
+
+  // Encode with encodeUnicastRoute(). Buffer must be large enough
+  const auto size = NetlinkRouteMessage::getUnicastRouteSize(tRoute, true);
+  EXPECT_EQ(msg.getDataLength(), size);
+  std::vector<uint8_t> buf(size);
+  EXPECT_EQ(
+      ENOBUFS,
+      NetlinkRouteMessage::encodeUnicastRoute(
+          tRoute,
+          kProtocolId,
+          10,
+          getIfIndex,
+          folly::MutableByteRange(buf.data(), size - 1)));
+  ASSERT_EQ(
+      0,
+      NetlinkRouteMessage::encodeUnicastRoute(
+          tRoute,
+          kProtocolId,
+          10,
+          getIfIndex,
+          folly::MutableByteRange(buf.data(), buf.size())));
+  const auto nlmsg = reinterpret_cast<const struct nlmsghdr*>(buf.data());
+  EXPECT_EQ(size, nlmsg->nlmsg_len);
+  EXPECT_EQ(msg.getMessagePtr()->nlmsg_flags, nlmsg->nlmsg_flags);
+
+  // Both encode the same route
+  EXPECT_EQ(
+      NetlinkRouteMessage::parseMessage(msg.getMessagePtr()),
+      NetlinkRouteMessage::parseMessage(nlmsg));
+
+  // Unknown interface
+  tRoute.nextHops_ref()->front().address_ref()->ifName_ref() = "eth2";
+  EXPECT_EQ(
+      ENODEV,
+      NetlinkRouteMessage::encodeUnicastRoute(
+          tRoute,
+          kProtocolId,
+          10,
+          getIfIndex,
+          folly::MutableByteRange(buf.data(), buf.size())));
+}
+
 int
 main(int argc, char* argv[]) {
   // Parse command line flags
@@ -18,6 +18,15 @@
 
 DEFINE_int32(
     fib_thrift_port, 60100, "Thrift server port for the NetlinkFibHandler");
+DEFINE_bool(
+    enable_nexthop_objects,
+    false,
+    "Program unicast routes via kernel nexthop objects (Linux 5.3+)");
+DEFINE_int32(
+    netlink_route_sockets,
+    0,
+    "Number of additional netlink sockets for programming routes. Ignored "
+    "with nexthop objects enabled");
 
 using openr::NetlinkFibHandler;
 
@@ -38,7 +47,12 @@ main(int argc, char** argv) {
   openr::messaging::ReplicateQueue<openr::fbnl::NetlinkEvent>
       netlinkEventsQueue;
   auto nlSock = std::make_unique<openr::fbnl::NetlinkProtocolSocket>(
-      nlEvb.get(), netlinkEventsQueue);
+      nlEvb.get(),
+      netlinkEventsQueue,
+      false /* enableIPv6RouteReplaceSemantics */,
+      FLAGS_enable_nexthop_objects
+          ? 0
+          : std::max(0, FLAGS_netlink_route_sockets));
   allThreads.emplace_back(std::thread([&nlEvb]() {
     LOG(INFO) << "Starting NetlinkProtolSocketEvl thread...";
     folly::setThreadName("NetlinkProtolSocketEvl");
@@ -48,7 +62,10 @@ main(int argc, char** argv) {
   nlEvb->waitUntilRunning();
 
   apache::thrift::ThriftServer linuxFibAgentServer;
-  auto fibHandler = std::make_shared<NetlinkFibHandler>(nlSock.get());
+  auto fibHandler = std::make_shared<NetlinkFibHandler>(
+      nlSock.get(),
+      FLAGS_enable_nexthop_objects,
+      netlinkEventsQueue.getReader("fibHandler"));
 
   // start FibService thread
   auto fibThriftThread = std::thread([fibHandler, &linuxFibAgentServer]() {
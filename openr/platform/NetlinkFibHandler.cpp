@@ -15,6 +15,7 @@
 
 #include <folly/Format.h>
 #include <folly/gen/Base.h>
+#include <folly/system/ThreadName.h>
 
 #include <openr/common/NetworkUtil.h>
 #include <openr/common/Util.h>
@@ -32,6 +33,13 @@ namespace {
 const uint8_t kMinRouteProtocolId = 17;
 const uint8_t kMaxRouteProtocolId = 253;
 
+// Kernel nexthop object IDs are allocated as `protocol << 24 | sequence`
+const uint32_t kNexthopIdProtocolShift = 24;
+const uint32_t kNexthopIdSeqMask = (1 << kNexthopIdProtocolShift) - 1;
+
+// Max number of routes per chunk of route table streams
+const size_t kRouteStreamChunkSize = 1000;
+
 template <typename T>
 folly::SemiFuture<T>
 createSemiFutureWithClientIdError() {
@@ -40,18 +48,56 @@ createSemiFutureWithClientIdError() {
   return std::move(sf);
 }
 
+template <typename T>
+void
+completeRouteStream(
+    apache::thrift::ServerStreamPublisher<T>& publisher, int status) {
+  if (status == 0) {
+    std::move(publisher).complete();
+  } else {
+    std::move(publisher).complete(
+        folly::make_exception_wrapper<fbnl::NlException>(
+            "Failed fetching routes", status));
+  }
+}
+
 } // namespace
 
-NetlinkFibHandler::NetlinkFibHandler(fbnl::NetlinkProtocolSocket* nlSock)
+NetlinkFibHandler::NetlinkFibHandler(
+    fbnl::NetlinkProtocolSocket* nlSock,
+    bool enableNexthopObjects,
+    std::optional<messaging::RQueue<fbnl::NetlinkEvent>> netlinkEventsQueue)
     : facebook::fb303::BaseService("openr"),
       nlSock_(nlSock),
+      enableNexthopObjects_(enableNexthopObjects),
       startTime_(std::chrono::duration_cast<std::chrono::seconds>(
                      std::chrono::system_clock::now().time_since_epoch())
                      .count()) {
   CHECK_NOTNULL(nlSock);
+
+  if (netlinkEventsQueue.has_value()) {
+    linkEventsThread_ =
+        std::thread([this, q = std::move(*netlinkEventsQueue)]() mutable {
+          folly::setThreadName("openr-fibLinkEvents");
+          while (true) {
+            auto maybeEvent = q.get();
+            if (maybeEvent.hasError()) {
+              LOG(INFO) << "Terminating netlink events processing thread";
+              break;
+            }
+            if (auto link = std::get_if<fbnl::Link>(&maybeEvent.value())) {
+              updateInterfaceCache({*link});
+            }
+          }
+        });
+  }
 }
 
-NetlinkFibHandler::~NetlinkFibHandler() {}
+NetlinkFibHandler::~NetlinkFibHandler() {
+  if (linkEventsThread_.joinable()) {
+    linkEventsThread_.join();
+  }
+}
 
 std::optional<int16_t>
 NetlinkFibHandler::getProtocol(int16_t clientId) {
@@ -113,10 +159,24 @@ NetlinkFibHandler::semifuture_addUnicastRoutes(
   LOG(INFO) << "Adding/Updating unicast routes of client "
             << getClientName(clientId) << ", numRoutes=" << routes->size();
 
+  // Add routes in bulk and return a collected semifuture
+  if (not enableNexthopObjects_) {
+    std::vector<fbnl::Route> nlRoutes;
+    nlRoutes.reserve(routes->size());
+    for (auto& route : *routes) {
+      nlRoutes.emplace_back(buildRoute(route, protocol.value()));
+    }
+    return fbnl::NetlinkProtocolSocket::collectReturnStatus(
+        nlSock_->addRoutes(std::move(nlRoutes)), {EEXIST});
+  }
+
   // Add routes and return a collected semifuture
   std::vector<folly::SemiFuture<int>> result;
+  auto cache = nexthopCache_.wlock();
+  auto& protocolCache = (*cache)[protocol.value()];
   for (auto& route : *routes) {
-    result.emplace_back(nlSock_->addRoute(buildRoute(route, protocol.value())));
+    addRouteWithNexthopObject(
+        protocolCache, buildRoute(route, protocol.value()), result);
   }
   return fbnl::NetlinkProtocolSocket::collectReturnStatus(
       std::move(result), {EEXIST});
@@ -135,11 +195,17 @@ NetlinkFibHandler::semifuture_deleteUnicastRoutes(
 
   // Delete routes and return a collected semifuture
   std::vector<folly::SemiFuture<int>> result;
+  auto cache = nexthopCache_.wlock();
   for (auto& prefix : *prefixes) {
     fbnl::RouteBuilder rtBuilder;
     rtBuilder.setDestination(toIPNetwork(prefix));
     rtBuilder.setProtocolId(protocol.value());
-    result.emplace_back(nlSock_->deleteRoute(rtBuilder.build()));
+    if (enableNexthopObjects_) {
+      deleteRouteWithNexthopObject(
+          (*cache)[protocol.value()], rtBuilder.build(), result);
+    } else {
+      result.emplace_back(nlSock_->deleteRoute(rtBuilder.build()));
+    }
   }
   return fbnl::NetlinkProtocolSocket::collectReturnStatus(
       std::move(result), {ESRCH});
@@ -156,14 +222,14 @@ NetlinkFibHandler::semifuture_addMplsRoutes(
   LOG(INFO) << "Adding/Updating mpls routes of client "
             << getClientName(clientId) << ", numRoutes=" << routes->size();
 
-  // Add routes and return a collected semifuture
-  std::vector<folly::SemiFuture<int>> result;
+  // Add routes in bulk and return a collected semifuture
+  std::vector<fbnl::Route> nlRoutes;
+  nlRoutes.reserve(routes->size());
   for (auto& route : *routes) {
-    result.emplace_back(
-        nlSock_->addRoute(buildMplsRoute(route, protocol.value())));
+    nlRoutes.emplace_back(buildMplsRoute(route, protocol.value()));
   }
   return fbnl::NetlinkProtocolSocket::collectReturnStatus(
-      std::move(result), {EEXIST});
+      nlSock_->addRoutes(std::move(nlRoutes)), {EEXIST});
 }
 
 folly::SemiFuture<folly::Unit>
@@ -209,6 +275,7 @@ NetlinkFibHandler::semifuture_syncFib(
   // requests to retrieve IPv4 and IPv6 routes. Subsequently we wait on them
   // to complete and prepare the map of existing routes
   std::unordered_map<folly::CIDRNetwork, fbnl::Route> existingRoutes;
+  std::vector<fbnl::NextHopObject> existingNexthops;
   {
     auto v4Routes = nlSock_->getIPv4Routes(protocol.value()).get();
     auto v6Routes = nlSock_->getIPv6Routes(protocol.value()).get();
@@ -218,6 +285,7 @@ NetlinkFibHandler::semifuture_syncFib(
     if (v6Routes.hasError()) {
       throw fbnl::NlException("Failed fetching IPv6 routes", v6Routes.error());
     }
+    existingRoutes.reserve(v4Routes->size() + v6Routes->size());
     for (auto& routesPtr : {&v4Routes, &v6Routes}) {
       for (auto& route : routesPtr->value()) {
         const auto prefix = route.getDestination();
@@ -229,40 +297,94 @@ NetlinkFibHandler::semifuture_syncFib(
         existingRoutes.emplace(prefix, std::move(route));
       }
     }
+    if (enableNexthopObjects_) {
+      auto nexthops = nlSock_->getAllNexthops().get();
+      if (nexthops.hasError()) {
+        throw fbnl::NlException("Failed fetching nexthops", nexthops.error());
+      }
+      for (auto& nexthop : nexthops.value()) {
+        if (nexthop.getProtocolId() == protocol.value()) {
+          existingNexthops.emplace_back(std::move(nexthop));
+        }
+      }
+    }
   }
 
-  // Go over the new routes. Add or update
-  std::unordered_set<folly::CIDRNetwork> newPrefixes;
+  // Lock on nexthop objects is held till all requests are enqueued
+  auto cache = nexthopCache_.wlock();
+  auto& protocolCache = (*cache)[protocol.value()];
+
+  // Avoid re-using IDs of objects which are already programmed (e.g. by
+  // previous instance). Objects unknown to cache are stale and are removed
+  // at the end of sync, groups before their members.
+  std::unordered_set<uint32_t> nexthopIds;
+  for (auto const& [_, entry] : protocolCache.nexthops) {
+    nexthopIds.insert(entry.id);
+  }
+  for (auto const& [groupId, _] : protocolCache.groups) {
+    nexthopIds.insert(groupId);
+  }
+  std::vector<fbnl::NextHopObject> staleNexthops;
+  for (auto& nexthop : existingNexthops) {
+    protocolCache.lastSeq = std::max(
+        protocolCache.lastSeq, nexthop.getId() & kNexthopIdSeqMask);
+    if (not nexthopIds.count(nexthop.getId())) {
+      staleNexthops.emplace_back(std::move(nexthop));
+    }
+  }
+  std::sort(
+      staleNexthops.begin(),
+      staleNexthops.end(),
+      [](const auto& lhs, const auto& rhs) {
+        return lhs.isGroup() > rhs.isGroup();
+      });
+
+  // Go over the new routes. Add or update. Existing routes are removed from
+  // the map as they're visited, leaving only the stale ones
   for (auto& route : *unicastRoutes) {
-    const auto network = toIPNetwork(*route.dest_ref());
-    newPrefixes.insert(network);
     auto nlRoute = buildRoute(route, protocol.value());
-    auto it = existingRoutes.find(network);
-    if (it != existingRoutes.end() and it->second == nlRoute) {
+    auto it = existingRoutes.find(nlRoute.getDestination());
+    const bool exists = it != existingRoutes.end();
+    if (enableNexthopObjects_) {
+      addRouteWithNexthopObject(
+          protocolCache,
+          std::move(nlRoute),
+          result,
+          exists ? &it->second : nullptr);
+    } else if (exists and isSameRoute(it->second, nlRoute)) {
       // Existing route is same as the one we're trying to add. SKIP
-      continue;
-    }
-    if (it != existingRoutes.end()) {
-      LOG(INFO) << "Updating unicast-route "
-                << "\n[OLD] " << it->second.str() << "\n[NEW] "
-                << nlRoute.str();
     } else {
-      LOG(INFO) << "Adding unicast-route \n[NEW]" << nlRoute.str();
+      if (exists) {
+        LOG(INFO) << "Updating unicast-route "
+                  << "\n[OLD] " << it->second.str() << "\n[NEW] "
+                  << nlRoute.str();
+      } else {
+        LOG(INFO) << "Adding unicast-route \n[NEW]" << nlRoute.str();
+      }
+      // Add new route or replace existing one
+      result.emplace_back(nlSock_->addRoute(nlRoute));
+    }
+    if (exists) {
+      existingRoutes.erase(it);
     }
-    // Add new route or replace existing one
-    result.emplace_back(nlSock_->addRoute(nlRoute));
   }
 
   // Go over the old routes to remove stale ones
   for (auto& [prefix, nlRoute] : existingRoutes) {
-    if (newPrefixes.count(prefix)) {
-      // not a stale route
-      continue;
-    }
     // Delete stale route
     LOG(INFO) << "Deleting unicast-route "
               << folly::IPAddress::networkToString(prefix);
-    result.emplace_back(nlSock_->deleteRoute(nlRoute));
+    if (enableNexthopObjects_) {
+      deleteRouteWithNexthopObject(protocolCache, nlRoute, result);
+    } else {
+      result.emplace_back(nlSock_->deleteRoute(nlRoute));
+    }
+  }
+
+  // Remove stale nexthop objects
+  for (auto const& nexthop : staleNexthops) {
+    LOG(INFO) << "Deleting stale " << nexthop.str();
+    result.emplace_back(nlSock_->deleteNexthop(nexthop));
   }
 
   // Return collected result
@@ -306,7 +428,7 @@ NetlinkFibHandler::semifuture_syncMplsFib(
     newLabels.insert(label);
     auto nlRoute = buildMplsRoute(route, protocol.value());
     auto it = existingRoutes.find(label);
-    if (it != existingRoutes.end() and it->second == nlRoute) {
+    if (it != existingRoutes.end() and isSameRoute(it->second, nlRoute)) {
       // Existing route is same as the one we're trying to add. SKIP
       continue;
     }
@@ -416,8 +538,100 @@ NetlinkFibHandler::semifuture_getMplsRouteTableByClient(int16_t clientId) {
           });
 }
 
+apache::thrift::ServerStream<std::vector<thrift::UnicastRoute>>
+NetlinkFibHandler::getRouteTableByClientStream(int16_t clientId) {
+  const auto protocol = getProtocol(clientId);
+  if (not protocol.has_value()) {
+    throw fbnl::NlException("Invalid clientId or protocol mapping");
+  }
+  LOG(INFO) << "Stream unicast routes for client " << getClientName(clientId);
+
+  // Chunks are converted on netlink event base thread, which can't refresh
+  // interface cache. Warm it up beforehand.
+  initializeInterfaceCache();
+
+  using Publisher =
+      apache::thrift::ServerStreamPublisher<std::vector<thrift::UnicastRoute>>;
+  auto streamAndPublisher = apache::thrift::ServerStream<
+      std::vector<thrift::UnicastRoute>>::createPublisher();
+  // ATTN: std::function requires copyable callbacks
+  auto publisher =
+      std::make_shared<Publisher>(std::move(streamAndPublisher.second));
+  auto onChunk = [this, publisher](std::vector<fbnl::Route>&& nlRoutes) {
+    std::vector<thrift::UnicastRoute> routes;
+    routes.reserve(nlRoutes.size());
+    for (auto& nlRoute : nlRoutes) {
+      thrift::UnicastRoute route;
+      route.dest_ref() = toIpPrefix(nlRoute.getDestination());
+      route.nextHops_ref() = toThriftNextHops(
+          nlRoute.getNextHops(), false /* refreshInterfaceCache */);
+      routes.emplace_back(std::move(route));
+    }
+    publisher->next(std::move(routes));
+  };
+
+  // IPv4 routes are followed by IPv6 routes
+  nlSock_->streamRoutes(
+      fbnl::NetlinkProtocolSocket::createIPv4RouteFilter(protocol.value()),
+      kRouteStreamChunkSize,
+      onChunk,
+      [this, publisher, onChunk, protocol = protocol.value()](int status) {
+        if (status != 0) {
+          completeRouteStream(*publisher, status);
+          return;
+        }
+        nlSock_->streamRoutes(
+            fbnl::NetlinkProtocolSocket::createIPv6RouteFilter(protocol),
+            kRouteStreamChunkSize,
+            onChunk,
+            [publisher](int status) {
+              completeRouteStream(*publisher, status);
+            });
+      });
+  return std::move(streamAndPublisher.first);
+}
+
+apache::thrift::ServerStream<std::vector<thrift::MplsRoute>>
+NetlinkFibHandler::getMplsRouteTableByClientStream(int16_t clientId) {
+  const auto protocol = getProtocol(clientId);
+  if (not protocol.has_value()) {
+    throw fbnl::NlException("Invalid clientId or protocol mapping");
+  }
+  LOG(INFO) << "Stream mpls routes for client " << getClientName(clientId);
+
+  // Chunks are converted on netlink event base thread, which can't refresh
+  // interface cache. Warm it up beforehand.
+  initializeInterfaceCache();
+
+  using Publisher =
+      apache::thrift::ServerStreamPublisher<std::vector<thrift::MplsRoute>>;
+  auto streamAndPublisher = apache::thrift::ServerStream<
+      std::vector<thrift::MplsRoute>>::createPublisher();
+  // ATTN: std::function requires copyable callbacks
+  auto publisher =
+      std::make_shared<Publisher>(std::move(streamAndPublisher.second));
+  nlSock_->streamRoutes(
+      fbnl::NetlinkProtocolSocket::createMplsRouteFilter(protocol.value()),
+      kRouteStreamChunkSize,
+      [this, publisher](std::vector<fbnl::Route>&& nlRoutes) {
+        std::vector<thrift::MplsRoute> routes;
+        routes.reserve(nlRoutes.size());
+        for (auto& nlRoute : nlRoutes) {
+          thrift::MplsRoute route;
+          route.topLabel_ref() = nlRoute.getMplsLabel().value();
+          route.nextHops_ref() = toThriftNextHops(
+              nlRoute.getNextHops(), false /* refreshInterfaceCache */);
+          routes.emplace_back(std::move(route));
+        }
+        publisher->next(std::move(routes));
+      },
+      [publisher](int status) { completeRouteStream(*publisher, status); });
+  return std::move(streamAndPublisher.first);
+}
+
 std::vector<thrift::NextHopThrift>
-NetlinkFibHandler::toThriftNextHops(const fbnl::NextHopSet& nextHops) {
+NetlinkFibHandler::toThriftNextHops(
+    const fbnl::NextHopSet& nextHops, bool refreshInterfaceCache) {
   std::vector<thrift::NextHopThrift> thriftNextHops;
 
   for (auto const& nh : nextHops) {
@@ -429,8 +643,14 @@ NetlinkFibHandler::toThriftNextHops(const fbnl::NextHopSet& nextHops) {
       *nextHop.address_ref() = toBinaryAddress(nh.getGateway().value());
       // Add nexthop interface if any
       if (nh.getIfIndex().has_value()) {
-        nextHop.address_ref()->ifName_ref() =
-            getIfName(nh.getIfIndex().value()).value();
+        const auto ifIndex = nh.getIfIndex().value();
+        if (refreshInterfaceCache) {
+          nextHop.address_ref()->ifName_ref() = getIfName(ifIndex).value();
+        } else if (auto ifName = getCachedIfName(ifIndex)) {
+          nextHop.address_ref()->ifName_ref() = std::move(ifName).value();
+        } else {
+          LOG(ERROR) << "Unknown interface index " << ifIndex;
+        }
       }
     } else {
       // POP_AND_LOOKUP mpls nexthop has no nexthop address so we assign
@@ -554,13 +774,280 @@ NetlinkFibHandler::buildMplsRoute(
   return rtBuilder.setValid(true).build();
 }
 
+bool
+NetlinkFibHandler::isSameRoute(
+    const fbnl::Route& existing, const fbnl::Route& route) {
+  if (existing.getType() != route.getType() or
+      existing.getPriority() != route.getPriority() or
+      existing.getNextHopId() != route.getNextHopId() or
+      existing.getNextHops().size() != route.getNextHops().size()) {
+    return false;
+  }
+
+  // Compare order independent hash of nexthops before comparing them
+  fbnl::NextHopHash nhHash;
+  size_t existingHash{0}, hash{0};
+  for (auto const& nh : existing.getNextHops()) {
+    existingHash += nhHash(nh);
+  }
+  for (auto const& nh : route.getNextHops()) {
+    hash += nhHash(nh);
+  }
+  if (existingHash != hash) {
+    return false;
+  }
+  for (auto const& nh : route.getNextHops()) {
+    if (not existing.getNextHops().count(nh)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool
+NetlinkFibHandler::canUseNexthopObject(const fbnl::Route& route) {
+  if (route.getType() != RTN_UNICAST or route.getNextHops().empty()) {
+    return false;
+  }
+  for (auto const& nh : route.getNextHops()) {
+    // Kernel requires interface and family (of gateway) for nexthop object
+    if (not nh.getIfIndex().has_value() or not nh.getGateway().has_value()) {
+      return false;
+    }
+    const auto action = nh.getLabelAction();
+    if (action.has_value() and action.value() != thrift::MplsActionCode::PUSH) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void
+NetlinkFibHandler::addRouteWithNexthopObject(
+    NexthopObjectCache& cache,
+    fbnl::Route&& route,
+    std::vector<folly::SemiFuture<int>>& result,
+    const fbnl::Route* existingRoute) {
+  const auto prefix = route.getDestination();
+  const auto protocol = route.getProtocolId();
+  auto it = cache.routes.find(prefix);
+
+  // Nexthop change of route owning its group. Replace group in place which
+  // updates the route (one message for ECMP member change)
+  if (canUseNexthopObject(route) and it != cache.routes.end() and
+      replaceNexthopGroup(
+          cache, it->second, route.getNextHops(), protocol, result)) {
+    route.setNextHopId(it->second);
+    if (existingRoute != nullptr and not isSameRoute(*existingRoute, route)) {
+      result.emplace_back(nlSock_->addRoute(route));
+    }
+    return;
+  }
+
+  // Create (or reference) nexthop group before route refers to it
+  std::optional<uint32_t> groupId;
+  if (canUseNexthopObject(route)) {
+    groupId = acquireNexthopGroup(cache, route.getNextHops(), protocol, result);
+    route.setNextHopId(groupId.value());
+  }
+
+  // Add new route or replace existing one. Skip if it is same
+  if (existingRoute == nullptr or not isSameRoute(*existingRoute, route)) {
+    VLOG(1) << "Adding/Updating unicast-route " << route.str();
+    result.emplace_back(nlSock_->addRoute(route));
+  }
+
+  // Release group of previous route once route stops referring to it
+  if (it != cache.routes.end()) {
+    const auto oldGroupId = it->second;
+    cache.routes.erase(it);
+    releaseNexthopGroup(cache, oldGroupId, protocol, result);
+  }
+  if (groupId.has_value()) {
+    cache.routes.emplace(prefix, groupId.value());
+  }
+}
+
+void
+NetlinkFibHandler::deleteRouteWithNexthopObject(
+    NexthopObjectCache& cache,
+    const fbnl::Route& route,
+    std::vector<folly::SemiFuture<int>>& result) {
+  result.emplace_back(nlSock_->deleteRoute(route));
+
+  auto it = cache.routes.find(route.getDestination());
+  if (it != cache.routes.end()) {
+    const auto groupId = it->second;
+    cache.routes.erase(it);
+    releaseNexthopGroup(cache, groupId, route.getProtocolId(), result);
+  }
+}
+
+uint32_t
+NetlinkFibHandler::allocateNexthopId(
+    NexthopObjectCache& cache, uint8_t protocol) {
+  uint32_t seq{0};
+  if (not cache.freeIds.empty()) {
+    seq = cache.freeIds.back();
+    cache.freeIds.pop_back();
+  } else {
+    seq = ++cache.lastSeq;
+  }
+  CHECK_LE(seq, kNexthopIdSeqMask) << "Exhausted nexthop object IDs";
+  return (static_cast<uint32_t>(protocol) << kNexthopIdProtocolShift) | seq;
+}
+
+std::vector<uint32_t>
+NetlinkFibHandler::createNexthops(
+    NexthopObjectCache& cache,
+    const fbnl::NextHopSet& nextHops,
+    uint8_t protocol,
+    std::vector<folly::SemiFuture<int>>& result) {
+  std::vector<uint32_t> memberIds;
+  memberIds.reserve(nextHops.size());
+  for (auto const& nh : nextHops) {
+    auto nhIt = cache.nexthops.find(nh);
+    if (nhIt == cache.nexthops.end()) {
+      fbnl::NextHopObject nexthop(allocateNexthopId(cache, protocol), protocol);
+      nexthop.setNextHop(nh);
+      result.emplace_back(nlSock_->addNexthop(nexthop));
+      nhIt = cache.nexthops.emplace(nh, NexthopObjectCache::NexthopEntry{})
+                 .first;
+      nhIt->second.id = nexthop.getId();
+    }
+    memberIds.emplace_back(nhIt->second.id);
+  }
+  std::sort(memberIds.begin(), memberIds.end());
+  return memberIds;
+}
+
+void
+NetlinkFibHandler::releaseNexthops(
+    NexthopObjectCache& cache,
+    const fbnl::NextHopSet& nextHops,
+    uint8_t protocol,
+    std::vector<folly::SemiFuture<int>>& result) {
+  for (auto const& nh : nextHops) {
+    auto nhIt = cache.nexthops.find(nh);
+    CHECK(nhIt != cache.nexthops.end());
+    if (--nhIt->second.refCount > 0) {
+      continue;
+    }
+    const auto nhId = nhIt->second.id;
+    result.emplace_back(
+        nlSock_->deleteNexthop(fbnl::NextHopObject(nhId, protocol)));
+    cache.freeIds.emplace_back(nhId & kNexthopIdSeqMask);
+    cache.nexthops.erase(nhIt);
+  }
+}
+
+fbnl::NextHopObject
+NetlinkFibHandler::buildNexthopGroup(
+    NexthopObjectCache& cache,
+    uint32_t groupId,
+    const fbnl::NextHopSet& nextHops,
+    uint8_t protocol) {
+  // Take reference on members. Weight of nexthop is the weight of member
+  // (0 is same as 1)
+  std::vector<std::pair<uint32_t, uint8_t>> members;
+  for (auto const& nh : nextHops) {
+    auto& entry = cache.nexthops.at(nh);
+    ++entry.refCount;
+    members.emplace_back(entry.id, nh.getWeight());
+  }
+  fbnl::NextHopObject group(groupId, protocol);
+  group.setGroup(std::move(members));
+  return group;
+}
+
+uint32_t
+NetlinkFibHandler::acquireNexthopGroup(
+    NexthopObjectCache& cache,
+    const fbnl::NextHopSet& nextHops,
+    uint8_t protocol,
+    std::vector<folly::SemiFuture<int>>& result) {
+  auto memberIds = createNexthops(cache, nextHops, protocol, result);
+
+  // Reference existing group
+  auto groupIt = cache.groupIds.find(memberIds);
+  if (groupIt != cache.groupIds.end()) {
+    ++cache.groups.at(groupIt->second).refCount;
+    return groupIt->second;
+  }
+
+  // Create new group
+  const auto group = buildNexthopGroup(
+      cache, allocateNexthopId(cache, protocol), nextHops, protocol);
+  result.emplace_back(nlSock_->addNexthop(group));
+
+  auto& groupEntry = cache.groups[group.getId()];
+  groupEntry.id = group.getId();
+  groupEntry.refCount = 1;
+  groupEntry.nextHops = nextHops;
+  groupEntry.memberIds = memberIds;
+  cache.groupIds.emplace(std::move(memberIds), group.getId());
+  return group.getId();
+}
+
+bool
+NetlinkFibHandler::replaceNexthopGroup(
+    NexthopObjectCache& cache,
+    uint32_t groupId,
+    const fbnl::NextHopSet& nextHops,
+    uint8_t protocol,
+    std::vector<folly::SemiFuture<int>>& result) {
+  auto& groupEntry = cache.groups.at(groupId);
+  if (groupEntry.refCount > 1 or groupEntry.nextHops == nextHops) {
+    return false; // Shared or unchanged group
+  }
+
+  // Reference existing group if any for new nexthops
+  auto memberIds = createNexthops(cache, nextHops, protocol, result);
+  if (cache.groupIds.count(memberIds)) {
+    return false;
+  }
+
+  // Replace group with new members and then release old members
+  result.emplace_back(nlSock_->addNexthop(
+      buildNexthopGroup(cache, groupId, nextHops, protocol)));
+  auto oldNextHops = std::move(groupEntry.nextHops);
+  cache.groupIds.erase(groupEntry.memberIds);
+  groupEntry.nextHops = nextHops;
+  groupEntry.memberIds = memberIds;
+  cache.groupIds.emplace(std::move(memberIds), groupId);
+  releaseNexthops(cache, oldNextHops, protocol, result);
+  return true;
+}
+
+void
+NetlinkFibHandler::releaseNexthopGroup(
+    NexthopObjectCache& cache,
+    uint32_t groupId,
+    uint8_t protocol,
+    std::vector<folly::SemiFuture<int>>& result) {
+  auto groupIt = cache.groups.find(groupId);
+  CHECK(groupIt != cache.groups.end()) << "Unknown nexthop group " << groupId;
+  if (--groupIt->second.refCount > 0) {
+    return;
+  }
+
+  // Last reference. Remove group and then its unreferenced members. IDs are
+  // safe to reuse as removals are enqueued before any subsequent addition.
+  result.emplace_back(
+      nlSock_->deleteNexthop(fbnl::NextHopObject(groupId, protocol)));
+  releaseNexthops(cache, groupIt->second.nextHops, protocol, result);
+  cache.groupIds.erase(groupIt->second.memberIds);
+  cache.freeIds.emplace_back(groupId & kNexthopIdSeqMask);
+  cache.groups.erase(groupIt);
+}
+
 std::optional<int>
 NetlinkFibHandler::getIfIndex(const std::string& ifName) {
   // Lambda function to lookup ifName in cache
   auto getCachedIndex = [this, &ifName]() -> std::optional<int> {
-    auto cache = ifNameToIndex_.rlock();
-    auto it = cache->find(ifName);
-    if (it != cache->end()) {
+    auto cache = interfaceCache_.load();
+    auto it = cache->ifNameToIndex.find(ifName);
+    if (it != cache->ifNameToIndex.end()) {
       return it->second;
     }
     return std::nullopt;
@@ -579,25 +1066,25 @@ NetlinkFibHandler::getIfIndex(const std::string& ifName) {
 
 std::optional<std::string>
 NetlinkFibHandler::getIfName(const int ifIndex) {
-  // Lambda function to lookup ifIndex in cache
-  auto getCachedName = [this, ifIndex]() -> std::optional<std::string> {
-    auto cache = ifIndexToName_.rlock();
-    auto it = cache->find(ifIndex);
-    if (it != cache->end()) {
-      return it->second;
-    }
-    return std::nullopt;
-  };
-
   // Lookup in cache. Return if exists
-  auto maybeName = getCachedName();
+  auto maybeName = getCachedIfName(ifIndex);
   if (maybeName.has_value()) {
     return maybeName;
   }
 
   // Update cache and return cached index
   initializeInterfaceCache();
-  return getCachedName();
+  return getCachedIfName(ifIndex);
+}
+
+std::optional<std::string>
+NetlinkFibHandler::getCachedIfName(const int ifIndex) {
+  auto cache = interfaceCache_.load();
+  auto it = cache->ifIndexToName.find(ifIndex);
+  if (it != cache->ifIndexToName.end()) {
+    return it->second;
+  }
+  return std::nullopt;
 }
 
 std::optional<int>
@@ -616,36 +1103,59 @@ NetlinkFibHandler::getLoopbackIfIndex() {
 
 void
 NetlinkFibHandler::initializeInterfaceCache() noexcept {
-  auto links = nlSock_->getAllLinks().get().value();
+  updateInterfaceCache(nlSock_->getAllLinks().get().value());
+}
+
+void
+NetlinkFibHandler::updateInterfaceCache(
+    const std::vector<fbnl::Link>& links) noexcept {
+  std::lock_guard<std::mutex> l(interfaceCacheMutex_);
 
-  // Acquire locks on the cache
-  auto lockedIfNameToIndex = ifNameToIndex_.wlock();
-  auto lockedIfIndexToName = ifIndexToName_.wlock();
+  // Copy current snapshot and publish it once updated
+  auto cache = std::make_shared<InterfaceCache>(*interfaceCache_.load());
 
   // NOTE: We don't clear cache instead override entries
   for (auto const& link : links) {
     // Update name <-> index mappings
-    (*lockedIfNameToIndex)[link.getLinkName()] = link.getIfIndex();
-    (*lockedIfIndexToName)[link.getIfIndex()] = link.getLinkName();
+    cache->ifNameToIndex[link.getLinkName()] = link.getIfIndex();
+    cache->ifIndexToName[link.getIfIndex()] = link.getLinkName();
 
     // Update loopbackIfIndex_
     if (link.isLoopback()) {
       loopbackIfIndex_.store(link.getIfIndex());
     }
   }
+
+  interfaceCache_.store(std::move(cache));
 }
 
 void
 NetlinkFibHandler::sendNeighborDownInfo(
     std::unique_ptr<std::vector<std::string>> neighborIps) {
+  queueNeighborChanges(*neighborIps, false /* isReachable */);
+}
+
+void
+NetlinkFibHandler::queueNeighborChanges(
+    const std::vector<std::string>& neighborIps, bool isReachable) {
+  if (neighborIps.empty()) {
+    return;
+  }
+
   std::lock_guard<std::mutex> g(listenersMutex_);
   for (auto& listener : listeners_.accessAllThreads()) {
-    LOG(INFO) << "Sending notification to bgpD";
-    listener.eventBase->runInEventBaseThread(
-        [this, neighborIps = std::move(*neighborIps), listenerPtr = &listener] {
-          LOG(INFO) << "firing off notification";
-          invokeNeighborListeners(listenerPtr, neighborIps, false);
-        });
+    for (auto const& neighborIp : neighborIps) {
+      listener.pendingChanges.insert_or_assign(neighborIp, isReachable);
+    }
+    if (listener.isNotificationScheduled) {
+      continue;
+    }
+    listener.isNotificationScheduled = true;
+    listener.eventBase->runInEventBaseThread([this, listenerPtr = &listener] {
+      listenerPtr->eventBase->runAfterDelay(
+          [this, listenerPtr] { notifyNeighborListener(listenerPtr); },
+          Constants::kNeighborChangesThrottleTimeout.count());
+    });
   }
 }
 
@@ -678,34 +1188,40 @@ NetlinkFibHandler::async_eb_registerForNeighborChanged(
 }
 
 void
-NetlinkFibHandler::invokeNeighborListeners(
-    ThreadLocalListener* listener,
-    const std::vector<std::string>& neighborIps,
-    bool isReachable) {
+NetlinkFibHandler::notifyNeighborListener(ThreadLocalListener* listener) {
+  CHECK(listener->eventBase->isInEventBaseThread());
+  std::vector<std::string> added, removed;
+  {
+    std::lock_guard<std::mutex> g(listenersMutex_);
+    for (auto& [neighborIp, isReachable] : listener->pendingChanges) {
+      (isReachable ? added : removed).emplace_back(neighborIp);
+    }
+    listener->pendingChanges.clear();
+    listener->isNotificationScheduled = false;
+  }
+
   // Collect the iterators to avoid erasing and potentially reordering
   // the iterators in the list.
-  for (const auto& ctx : brokenClients_) {
+  for (const auto& ctx : listener->brokenClients) {
     listener->clients.erase(ctx);
   }
-  brokenClients_.clear();
-  for (auto& client : listener->clients) {
-    auto clientDone = [&](apache::thrift::ClientReceiveState&& state) {
+  listener->brokenClients.clear();
+
+  LOG(INFO) << "Sending neighbor changes to " << listener->clients.size()
+            << " listeners, added: " << added.size()
+            << ", removed: " << removed.size();
+  for (auto& [ctx, client] : listener->clients) {
+    auto clientDone = [listener, ctx = ctx](
+                          apache::thrift::ClientReceiveState&& state) {
       try {
         thrift::NeighborListenerClientForFibagentAsyncClient::
             recv_neighborsChanged(state);
       } catch (const std::exception& ex) {
         LOG(ERROR) << "Exception in neighbor listener: " << ex.what();
-        brokenClients_.push_back(client.first);
+        listener->brokenClients.push_back(ctx);
       }
     };
-
-    std::vector<std::string> added, removed;
-    if (isReachable) {
-      added = neighborIps;
-    } else {
-      removed = neighborIps;
-    }
-    client.second->neighborsChanged(clientDone, added, removed);
+    client->neighborsChanged(clientDone, added, removed);
   }
 }
 
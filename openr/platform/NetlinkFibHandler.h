@@ -8,37 +8,54 @@
 #pragma once
 
 #include <chrono>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <fb303/BaseService.h>
 #include <folly/Expected.h>
+#include <folly/concurrency/AtomicSharedPtr.h>
 #include <folly/futures/Future.h>
 #include <folly/io/async/AsyncSocket.h>
 
 #include <openr/common/NetworkUtil.h>
 #include <openr/common/Util.h>
-#include <openr/if/gen-cpp2/FibService.h>
+#include <openr/if/gen-cpp2/FibServiceCpp.h>
 #include <openr/if/gen-cpp2/NeighborListenerClientForFibagent.h>
 #include <openr/if/gen-cpp2/Types_types.h>
+#include <openr/messaging/Queue.h>
 #include <openr/nl/NetlinkProtocolSocket.h>
 #include <openr/nl/NetlinkTypes.h>
 
 namespace openr {
 /**
- * This class implements OpenR's Platform.FibService thrit interface. It uses
+ * This class implements OpenR's PlatformCpp.FibServiceCpp thrift interface,
+ * i.e. Platform.FibService along with its stream APIs. It uses
  * NetlinkProtocolSocket to program routes in kernel. At a high level
  * - It translates thrift representation of routes to netlink for programming
  * - Translates netlink representation of routes to thrift for get* queries
  * - All APIs exposed are asynchronous. Sync API retries the existing routing
  *   state in synchronous way and program changes asynchrnously.
  */
-class NetlinkFibHandler : public thrift::FibServiceSvIf,
+class NetlinkFibHandler : public thrift::FibServiceCppSvIf,
                           public facebook::fb303::BaseService {
  public:
-  explicit NetlinkFibHandler(fbnl::NetlinkProtocolSocket* nlSock);
+  /**
+   * @param enableNexthopObjects - program unicast routes via kernel nexthop
+   *        objects (Linux 5.3+). Every unique set of nexthops is programmed
+   *        once as nexthop group and shared by all the routes using it.
+   * @param netlinkEventsQueue - if provided, LINK events are consumed to keep
+   *        interface cache up to date. Queue must be closed before handler is
+   *        destroyed.
+   */
+  explicit NetlinkFibHandler(
+      fbnl::NetlinkProtocolSocket* nlSock,
+      bool enableNexthopObjects = false,
+      std::optional<messaging::RQueue<fbnl::NetlinkEvent>> netlinkEventsQueue =
+          std::nullopt);
   ~NetlinkFibHandler() override;
 
   void
@@ -94,6 +111,17 @@ class NetlinkFibHandler : public thrift::FibServiceSvIf,
   folly::SemiFuture<std::unique_ptr<std::vector<openr::thrift::MplsRoute>>>
   semifuture_getMplsRouteTableByClient(int16_t clientId) override;
 
+  /**
+   * Stream routes of client in chunks as they're read from kernel, instead of
+   * collecting all of them first. Memory stays bounded by the chunk size
+   * unless client doesn't keep up with the stream.
+   */
+  apache::thrift::ServerStream<std::vector<thrift::UnicastRoute>>
+  getRouteTableByClientStream(int16_t clientId) override;
+
+  apache::thrift::ServerStream<std::vector<thrift::MplsRoute>>
+  getMplsRouteTableByClientStream(int16_t clientId) override;
+
   /**
    * Static API to convert protocol to clientId
    */
@@ -109,6 +137,14 @@ class NetlinkFibHandler : public thrift::FibServiceSvIf,
    */
   static uint8_t protocolToPriority(const uint8_t protocol);
 
+  /**
+   * Returns true if programmed route (e.g. retrieved from kernel) is same as
+   * the route to be programmed. Only the attributes programmed by this handler
+   * are compared, and nexthops are compared by their hash first.
+   */
+  static bool isSameRoute(
+      const fbnl::Route& existing, const fbnl::Route& route);
+
  protected:
   /**
    * TODO: Migrate BGP++ to stream API for neighbor notifications. Also need to
@@ -121,24 +157,42 @@ class NetlinkFibHandler : public thrift::FibServiceSvIf,
         std::shared_ptr<thrift::NeighborListenerClientForFibagentAsyncClient>>
         clients;
 
+    // Clients whose last notification failed, dropped before the next one.
+    // Accessed in `eventBase` thread only.
+    std::vector<const apache::thrift::TConnectionContext*> brokenClients;
+
+    // Neighbor changes coalesced since last notification, i.e. latest
+    // reachability of each changed neighbor. Guarded by `listenersMutex_`.
+    std::unordered_map<std::string, bool /* isReachable */> pendingChanges;
+    bool isNotificationScheduled{false};
+
     explicit ThreadLocalListener(folly::EventBase* eb) : eventBase(eb) {}
   };
 
   std::mutex listenersMutex_;
   folly::ThreadLocalPtr<ThreadLocalListener, int> listeners_;
-  std::vector<const apache::thrift::TConnectionContext*> brokenClients_;
 
-  void invokeNeighborListeners(
-      ThreadLocalListener* listener,
-      const std::vector<std::string>& neighborIps,
-      bool isReachable);
+  /**
+   * Queue neighbor changes for all listeners. Changes within
+   * `kNeighborChangesThrottleTimeout` are sent as one notification, from the
+   * event base of listener, hence caller is never blocked by a slow listener.
+   */
+  void queueNeighborChanges(
+      const std::vector<std::string>& neighborIps, bool isReachable);
+
+  // Send pending changes of `listener`. Invoked in its event base thread.
+  void notifyNeighborListener(ThreadLocalListener* listener);
 
   /**
    * APIs to convert netlink route representation to thrift. Used for sending
    * routes read from kernel to client.
+   *
+   * Interface cache is refreshed on lookup miss unless `refreshInterfaceCache`
+   * is false, i.e. when invoked on netlink event base thread, which can't wait
+   * for the netlink reply. Interface name is then left unset on miss.
    */
   std::vector<thrift::NextHopThrift> toThriftNextHops(
-      const fbnl::NextHopSet& nextHopSet);
+      const fbnl::NextHopSet& nextHopSet, bool refreshInterfaceCache = true);
 
   /**
    * API to convert thrift route representation to netlink. Used for programming
@@ -158,12 +212,13 @@ class NetlinkFibHandler : public thrift::FibServiceSvIf,
    *
    * Cache is used for optimized response to subsequent query for same interface
    * name or index. Entries in cache are lazily initialized on first instance by
-   * querying `getAllLinks`.
+   * querying `getAllLinks` and updated on LINK events. Lookups are lock-free.
    *
    * Returns `std::nullopt` if mapping is not found
    */
   std::optional<int> getIfIndex(const std::string& ifName);
   std::optional<std::string> getIfName(const int ifIndex);
+  std::optional<std::string> getCachedIfName(const int ifIndex);
 
   /**
    * Get interface index of loopback interface. Lazily query it from netlink
@@ -174,6 +229,144 @@ class NetlinkFibHandler : public thrift::FibServiceSvIf,
   // Used to interact with Linux kernel routing table
   fbnl::NetlinkProtocolSocket* nlSock_{nullptr};
 
+  /**
+   * Kernel nexthop objects programmed on behalf of routes of a client
+   * (protocol). Every unique nexthop (including its weight) and every unique
+   * set of them is programmed once. Objects are reference counted and
+   * removed from kernel once no route refers to them.
+   *
+   * IDs are allocated as `protocol << 24 | sequence` so that objects of
+   * different clients never collide.
+   */
+  struct NexthopObjectCache {
+    struct NexthopEntry {
+      uint32_t id{0};
+      size_t refCount{0};
+    };
+    struct GroupEntry {
+      uint32_t id{0};
+      size_t refCount{0};
+      fbnl::NextHopSet nextHops;
+      std::vector<uint32_t> memberIds;
+    };
+
+    // Nexthop -> nexthop object, referenced by groups
+    std::unordered_map<fbnl::NextHop, NexthopEntry, fbnl::NextHopHash>
+        nexthops;
+
+    // Group ID -> group object, referenced by routes
+    std::unordered_map<uint32_t, GroupEntry> groups;
+
+    // Sorted member IDs -> group ID
+    std::map<std::vector<uint32_t>, uint32_t> groupIds;
+
+    // Prefix -> group ID of programmed route
+    std::unordered_map<folly::CIDRNetwork, uint32_t> routes;
+
+    // Sequence of last allocated ID, and IDs released for reuse
+    uint32_t lastSeq{0};
+    std::vector<uint32_t> freeIds;
+  };
+
+  /**
+   * Program `route` via nexthop group if possible, else program it as is.
+   * Nexthop objects to be created or to be removed are enqueued in order
+   * around the route update. Futures of all the requests are appended to
+   * `result`. Route update is skipped if it is same as `existingRoute`.
+   */
+  void addRouteWithNexthopObject(
+      NexthopObjectCache& cache,
+      fbnl::Route&& route,
+      std::vector<folly::SemiFuture<int>>& result,
+      const fbnl::Route* existingRoute = nullptr);
+
+  /**
+   * Delete route and release its nexthop group if any
+   */
+  void deleteRouteWithNexthopObject(
+      NexthopObjectCache& cache,
+      const fbnl::Route& route,
+      std::vector<folly::SemiFuture<int>>& result);
+
+  /**
+   * Get ID of nexthop group for set of nexthops, create if it doesn't exist,
+   * and take reference on it.
+   */
+  uint32_t acquireNexthopGroup(
+      NexthopObjectCache& cache,
+      const fbnl::NextHopSet& nextHops,
+      uint8_t protocol,
+      std::vector<folly::SemiFuture<int>>& result);
+
+  /**
+   * Replace members of a nexthop group referenced only by one route with
+   * `nextHops`. Returns false if group is shared or is unchanged, or if a
+   * group for `nextHops` already exists.
+   */
+  bool replaceNexthopGroup(
+      NexthopObjectCache& cache,
+      uint32_t groupId,
+      const fbnl::NextHopSet& nextHops,
+      uint8_t protocol,
+      std::vector<folly::SemiFuture<int>>& result);
+
+  /**
+   * Release reference on nexthop group and delete it (and its unreferenced
+   * members) from kernel on last reference.
+   */
+  void releaseNexthopGroup(
+      NexthopObjectCache& cache,
+      uint32_t groupId,
+      uint8_t protocol,
+      std::vector<folly::SemiFuture<int>>& result);
+
+  /**
+   * Create nexthop objects of `nextHops` which don't exist. Returns sorted IDs
+   * of the nexthop objects.
+   */
+  std::vector<uint32_t> createNexthops(
+      NexthopObjectCache& cache,
+      const fbnl::NextHopSet& nextHops,
+      uint8_t protocol,
+      std::vector<folly::SemiFuture<int>>& result);
+
+  /**
+   * Release reference on nexthop objects of `nextHops` and delete the ones
+   * without reference.
+   */
+  void releaseNexthops(
+      NexthopObjectCache& cache,
+      const fbnl::NextHopSet& nextHops,
+      uint8_t protocol,
+      std::vector<folly::SemiFuture<int>>& result);
+
+  /**
+   * Build group object for `nextHops` taking reference on its members
+   */
+  static fbnl::NextHopObject buildNexthopGroup(
+      NexthopObjectCache& cache,
+      uint32_t groupId,
+      const fbnl::NextHopSet& nextHops,
+      uint8_t protocol);
+
+  // Allocate ID for new nexthop object
+  static uint32_t allocateNexthopId(
+      NexthopObjectCache& cache, uint8_t protocol);
+
+  /**
+   * Returns true if route can be programmed via nexthop object. Blackhole
+   * routes, and nexthops without interface or with label action other than
+   * PUSH, are programmed inline.
+   */
+  static bool canUseNexthopObject(const fbnl::Route& route);
+
+  // Program unicast routes via kernel nexthop objects
+  const bool enableNexthopObjects_{false};
+
+  // Per protocol cache of nexthop objects
+  folly::Synchronized<std::unordered_map<uint8_t, NexthopObjectCache>>
+      nexthopCache_;
+
  private:
   /**
    * Disable copy & assignment operators
@@ -187,9 +380,27 @@ class NetlinkFibHandler : public thrift::FibServiceSvIf,
    */
   void initializeInterfaceCache() noexcept;
 
-  // Cache for interface index <-> name mapping
-  folly::Synchronized<std::unordered_map<std::string, int>> ifNameToIndex_;
-  folly::Synchronized<std::unordered_map<int, std::string>> ifIndexToName_;
+  /**
+   * Update interface cache with the given links. Publishes a new snapshot of
+   * the cache.
+   */
+  void updateInterfaceCache(const std::vector<fbnl::Link>& links) noexcept;
+
+  // Cache for interface index <-> name mapping. It is an immutable snapshot
+  // replaced as a whole on update (copy-on-write), so that readers building
+  // routes never acquire a lock.
+  struct InterfaceCache {
+    std::unordered_map<std::string, int> ifNameToIndex;
+    std::unordered_map<int, std::string> ifIndexToName;
+  };
+  folly::atomic_shared_ptr<const InterfaceCache> interfaceCache_{
+      std::make_shared<const InterfaceCache>()};
+
+  // Serializes the writers of interfaceCache_
+  std::mutex interfaceCacheMutex_;
+
+  // Thread processing LINK events from netlinkEventsQueue
+  std::thread linkEventsThread_;
 
   // Loopback interface index cache. Initialized to negative number
   std::atomic<int> loopbackIfIndex_{-1};
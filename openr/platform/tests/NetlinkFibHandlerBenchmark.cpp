@@ -22,6 +22,7 @@
 #include <folly/system/Shell.h>
 #include <folly/test/TestUtils.h>
 
+#include <openr/common/NetworkUtil.h>
 #include <openr/platform/NetlinkFibHandler.h>
 #include <openr/tests/mocks/MockNetlinkProtocolSocket.h>
 #include <openr/tests/mocks/PrefixGenerator.h>
@@ -106,12 +107,72 @@ BM_NetlinkFibHandler(uint32_t iters, size_t numOfPrefixes) {
   }
 }
 
+// Build netlink routes via one of the veth interface
+static std::vector<fbnl::Route>
+createNlRoutes(const std::vector<thrift::IpPrefix>& prefixes) {
+  std::vector<fbnl::Route> routes;
+  routes.reserve(prefixes.size());
+  for (auto const& prefix : prefixes) {
+    fbnl::NextHopBuilder nhBuilder;
+    nhBuilder.setIfIndex(1).setGateway(folly::IPAddress("fe80::1"));
+    fbnl::RouteBuilder rtBuilder;
+    rtBuilder.setDestination(toIPNetwork(prefix)).addNextHop(nhBuilder.build());
+    routes.emplace_back(rtBuilder.build());
+  }
+  return routes;
+}
+
+/**
+ * Benchmark test to compare per-route and bulk route APIs of netlink socket
+ * 1. Generate random IpV6 routes
+ * 2. Add routes one request at a time (`addRoute`) or in bulk (`addRoutes`)
+ * 3. Wait until the completion of all the requests
+ */
+static void
+BM_NetlinkAddRoute(uint32_t iters, size_t numOfPrefixes) {
+  auto suspender = folly::BenchmarkSuspender();
+  auto netlinkFibWrapper = std::make_unique<NetlinkFibWrapper>();
+  auto routes = createNlRoutes(
+      netlinkFibWrapper->prefixGenerator.ipv6PrefixGenerator(
+          numOfPrefixes, kBitMaskLen));
+  suspender.dismiss(); // Start measuring benchmark time
+
+  for (uint32_t i = 0; i < iters; i++) {
+    std::vector<folly::SemiFuture<int>> result;
+    for (auto const& route : routes) {
+      result.emplace_back(netlinkFibWrapper->nlSock->addRoute(route));
+    }
+    NetlinkProtocolSocket::collectReturnStatus(std::move(result)).wait();
+  }
+}
+
+static void
+BM_NetlinkAddRoutes(uint32_t iters, size_t numOfPrefixes) {
+  auto suspender = folly::BenchmarkSuspender();
+  auto netlinkFibWrapper = std::make_unique<NetlinkFibWrapper>();
+  auto routes = createNlRoutes(
+      netlinkFibWrapper->prefixGenerator.ipv6PrefixGenerator(
+          numOfPrefixes, kBitMaskLen));
+  suspender.dismiss(); // Start measuring benchmark time
+
+  for (uint32_t i = 0; i < iters; i++) {
+    NetlinkProtocolSocket::collectReturnStatus(
+        netlinkFibWrapper->nlSock->addRoutes(routes))
+        .wait();
+  }
+}
+
 // The parameter is the number of prefixes
 BENCHMARK_PARAM(BM_NetlinkFibHandler, 10);
 BENCHMARK_PARAM(BM_NetlinkFibHandler, 100);
 BENCHMARK_PARAM(BM_NetlinkFibHandler, 1000);
 BENCHMARK_PARAM(BM_NetlinkFibHandler, 10000);
 
+BENCHMARK_PARAM(BM_NetlinkAddRoute, 1000);
+BENCHMARK_RELATIVE_PARAM(BM_NetlinkAddRoutes, 1000);
+BENCHMARK_PARAM(BM_NetlinkAddRoute, 10000);
+BENCHMARK_RELATIVE_PARAM(BM_NetlinkAddRoutes, 10000);
+
 } // namespace openr
 
 int
@@ -0,0 +1,410 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <sched.h>
+#include <unistd.h>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <folly/Benchmark.h>
+#include <folly/Format.h>
+#include <folly/IPAddress.h>
+#include <folly/Subprocess.h>
+#include <folly/init/Init.h>
+#include <folly/io/async/EventBase.h>
+#include <folly/system/Shell.h>
+
+#include <openr/common/NetworkUtil.h>
+#include <openr/common/Util.h>
+#include <openr/messaging/ReplicateQueue.h>
+#include <openr/nl/NetlinkProtocolSocket.h>
+#include <openr/platform/NetlinkFibHandler.h>
+
+/**
+ * End-to-end benchmark of NetlinkFibHandler against the Linux kernel. Unlike
+ * NetlinkFibHandlerBenchmark (which uses MockNetlinkProtocolSocket), routes
+ * are programmed for real. To be reproducible and to not disturb the host,
+ * the benchmark runs in a dedicated network namespace with dummy interfaces.
+ *
+ * Must be run as root. MPLS benchmarks require `mpls_router` kernel module.
+ *
+ * For every route type (IPv4/IPv6/MPLS) and scale it measures
+ * - Install : Add routes with `addUnicastRoutes` / `addMplsRoutes`
+ * - Sync : `syncFib` / `syncMplsFib` of the already programmed routes
+ * - Delete : Delete routes with `deleteUnicastRoutes` / `deleteMplsRoutes`
+ * Unicast routes are programmed with multipath encoding as well as with kernel
+ * nexthop objects. Kernel memory (slab) used per route is logged on install.
+ */
+
+using namespace folly::literals::shell_literals;
+
+namespace {
+
+// Dummy interfaces used as nexthops. Every route uses a subset of them and
+// hence there are as many unique nexthop groups as interfaces
+const size_t kNumInterfaces{4};
+const std::string kIfNamePrefix{"dummy"};
+
+// Offset of MPLS labels to stay out of reserved range
+const int32_t kMplsLabelOffset{100};
+
+const int16_t kFibId{static_cast<int16_t>(openr::thrift::FibClient::OPENR)};
+
+enum class RouteType { V4, V6, MPLS };
+
+void
+runCommand(folly::Subprocess::Options::CmdVec&& cmd) {
+  folly::Subprocess proc(std::move(cmd));
+  CHECK_EQ(0, proc.wait().exitStatus());
+}
+
+/**
+ * Move the process into a new network namespace and create dummy interfaces
+ * with addresses for nexthops to resolve.
+ */
+void
+setupNetworkNamespace() {
+  CHECK_EQ(0, getuid()) << "Must run this benchmark as root";
+  PCHECK(::unshare(CLONE_NEWNET) == 0) << "Failed to create network namespace";
+
+  runCommand("ip link set dev lo up"_shellify());
+  for (size_t i = 0; i < kNumInterfaces; ++i) {
+    const auto ifName = kIfNamePrefix + std::to_string(i);
+    const auto addrV4 = folly::sformat("10.0.{}.1/24", i);
+    const auto addrV6 = folly::sformat("fc00:{}::1/64", i);
+    runCommand("ip link add {} type dummy"_shellify(ifName.c_str()));
+    runCommand("ip link set dev {} up"_shellify(ifName.c_str()));
+    runCommand(
+        "ip addr add {} dev {}"_shellify(addrV4.c_str(), ifName.c_str()));
+    runCommand("ip -6 addr add {} nodad dev {}"_shellify(
+        addrV6.c_str(), ifName.c_str()));
+  }
+
+  // Enable MPLS label table. Ignore failure if MPLS is not supported
+  folly::Subprocess proc(
+      "sysctl -qw net.mpls.platform_labels=1048575"_shellify());
+  if (proc.wait().exitStatus() != 0) {
+    LOG(WARNING) << "MPLS is not supported. MPLS benchmarks will fail";
+  }
+}
+
+// Kernel slab memory in KB as reported in /proc/meminfo
+int64_t
+getKernelSlabMemory() {
+  std::ifstream meminfo("/proc/meminfo");
+  std::string key;
+  int64_t value{0};
+  std::string unit;
+  while (meminfo >> key >> value >> unit) {
+    if (key == "Slab:") {
+      return value;
+    }
+  }
+  return 0;
+}
+
+std::vector<openr::thrift::NextHopThrift>
+createNextHops(size_t index, RouteType type) {
+  std::vector<openr::thrift::NextHopThrift> nextHops;
+  for (size_t i = 0; i <= index % kNumInterfaces; ++i) {
+    const auto gateway = type == RouteType::V4
+        ? folly::sformat("10.0.{}.2", i)
+        : folly::sformat("fc00:{}::2", i);
+    std::optional<openr::thrift::MplsAction> mplsAction;
+    if (type == RouteType::MPLS) {
+      mplsAction = openr::createMplsAction(
+          openr::thrift::MplsActionCode::SWAP,
+          kMplsLabelOffset + static_cast<int32_t>(index));
+    }
+    nextHops.emplace_back(openr::createNextHop(
+        openr::toBinaryAddress(folly::IPAddress(gateway)),
+        kIfNamePrefix + std::to_string(i),
+        0 /* metric */,
+        mplsAction));
+  }
+  return nextHops;
+}
+
+std::vector<openr::thrift::UnicastRoute>
+createUnicastRoutes(size_t numRoutes, RouteType type) {
+  std::vector<openr::thrift::UnicastRoute> routes;
+  routes.reserve(numRoutes);
+  for (size_t i = 0; i < numRoutes; ++i) {
+    // Host routes from 100.64.0.0/10 or fd00::/64
+    const auto prefix = type == RouteType::V4
+        ? folly::sformat(
+              "100.{}.{}.{}/32",
+              64 + (i >> 16),
+              (i >> 8) & 0xff,
+              i & 0xff)
+        : folly::sformat("fd00::{:x}:{:x}/128", i >> 16, i & 0xffff);
+    routes.emplace_back(openr::createUnicastRoute(
+        openr::toIpPrefix(prefix), createNextHops(i, type)));
+  }
+  return routes;
+}
+
+std::vector<openr::thrift::MplsRoute>
+createMplsRoutes(size_t numRoutes) {
+  std::vector<openr::thrift::MplsRoute> routes;
+  routes.reserve(numRoutes);
+  for (size_t i = 0; i < numRoutes; ++i) {
+    routes.emplace_back(openr::createMplsRoute(
+        kMplsLabelOffset + static_cast<int32_t>(i),
+        createNextHops(i, RouteType::MPLS)));
+  }
+  return routes;
+}
+
+} // namespace
+
+namespace openr {
+
+// Runs NetlinkProtocolSocket on its own event-base thread and creates
+// NetlinkFibHandler on top of it. Routes are generated up-front so that only
+// copying them is accounted in measurements.
+class NetlinkFibSystemWrapper {
+ public:
+  NetlinkFibSystemWrapper(
+      RouteType type, size_t numRoutes, bool enableNexthopObjects)
+      : type(type) {
+    if (type == RouteType::MPLS) {
+      mplsRoutes = createMplsRoutes(numRoutes);
+      for (auto const& route : mplsRoutes) {
+        labels.emplace_back(*route.topLabel_ref());
+      }
+    } else {
+      unicastRoutes = createUnicastRoutes(numRoutes, type);
+      for (auto const& route : unicastRoutes) {
+        prefixes.emplace_back(*route.dest_ref());
+      }
+    }
+
+    nlSock = std::make_unique<fbnl::NetlinkProtocolSocket>(
+        &evb, netlinkEventsQueue);
+    evbThread = std::thread([this]() { evb.loopForever(); });
+    evb.waitUntilRunning();
+    fibHandler =
+        std::make_unique<NetlinkFibHandler>(nlSock.get(), enableNexthopObjects);
+  }
+
+  ~NetlinkFibSystemWrapper() {
+    fibHandler.reset();
+    netlinkEventsQueue.close();
+    evb.terminateLoopSoon();
+    evbThread.join();
+    nlSock.reset();
+  }
+
+  void
+  install() {
+    if (type == RouteType::MPLS) {
+      fibHandler
+          ->semifuture_addMplsRoutes(
+              kFibId,
+              std::make_unique<std::vector<thrift::MplsRoute>>(mplsRoutes))
+          .get();
+    } else {
+      fibHandler
+          ->semifuture_addUnicastRoutes(
+              kFibId,
+              std::make_unique<std::vector<thrift::UnicastRoute>>(
+                  unicastRoutes))
+          .get();
+    }
+  }
+
+  void
+  sync() {
+    if (type == RouteType::MPLS) {
+      fibHandler
+          ->semifuture_syncMplsFib(
+              kFibId,
+              std::make_unique<std::vector<thrift::MplsRoute>>(mplsRoutes))
+          .get();
+    } else {
+      fibHandler
+          ->semifuture_syncFib(
+              kFibId,
+              std::make_unique<std::vector<thrift::UnicastRoute>>(
+                  unicastRoutes))
+          .get();
+    }
+  }
+
+  void
+  remove() {
+    if (type == RouteType::MPLS) {
+      fibHandler
+          ->semifuture_deleteMplsRoutes(
+              kFibId, std::make_unique<std::vector<int32_t>>(labels))
+          .get();
+    } else {
+      fibHandler
+          ->semifuture_deleteUnicastRoutes(
+              kFibId, std::make_unique<std::vector<thrift::IpPrefix>>(prefixes))
+          .get();
+    }
+  }
+
+  const RouteType type;
+  std::vector<thrift::UnicastRoute> unicastRoutes;
+  std::vector<thrift::IpPrefix> prefixes;
+  std::vector<thrift::MplsRoute> mplsRoutes;
+  std::vector<int32_t> labels;
+
+  folly::EventBase evb;
+  std::thread evbThread;
+  messaging::ReplicateQueue<fbnl::NetlinkEvent> netlinkEventsQueue;
+  std::unique_ptr<fbnl::NetlinkProtocolSocket> nlSock;
+  std::unique_ptr<NetlinkFibHandler> fibHandler;
+};
+
+/**
+ * Benchmark of route installation. Routes are deleted between iterations
+ * outside of measurement.
+ */
+static void
+BM_Install(
+    uint32_t iters, RouteType type, size_t numRoutes, bool nexthopObjects) {
+  auto suspender = folly::BenchmarkSuspender();
+  auto wrapper = std::make_unique<NetlinkFibSystemWrapper>(
+      type, numRoutes, nexthopObjects);
+  const auto slabBefore = getKernelSlabMemory();
+
+  for (uint32_t i = 0; i < iters; i++) {
+    suspender.dismiss(); // Start measuring benchmark time
+    wrapper->install();
+    suspender.rehire(); // Stop measuring time again
+
+    if (i == 0) {
+      LOG(INFO) << "Kernel slab memory per route: "
+                << (getKernelSlabMemory() - slabBefore) * 1024.0 / numRoutes
+                << " bytes";
+    }
+    wrapper->remove();
+  }
+}
+
+/**
+ * Benchmark of syncing already programmed routes. Measures the cost of
+ * dumping routes from kernel and computing the difference.
+ */
+static void
+BM_Sync(uint32_t iters, RouteType type, size_t numRoutes, bool nexthopObjects) {
+  auto suspender = folly::BenchmarkSuspender();
+  auto wrapper = std::make_unique<NetlinkFibSystemWrapper>(
+      type, numRoutes, nexthopObjects);
+  wrapper->install();
+
+  for (uint32_t i = 0; i < iters; i++) {
+    suspender.dismiss(); // Start measuring benchmark time
+    wrapper->sync();
+    suspender.rehire(); // Stop measuring time again
+  }
+  wrapper->remove();
+}
+
+/**
+ * Benchmark of route deletion. Routes are installed between iterations
+ * outside of measurement.
+ */
+static void
+BM_Delete(
+    uint32_t iters, RouteType type, size_t numRoutes, bool nexthopObjects) {
+  auto suspender = folly::BenchmarkSuspender();
+  auto wrapper = std::make_unique<NetlinkFibSystemWrapper>(
+      type, numRoutes, nexthopObjects);
+
+  for (uint32_t i = 0; i < iters; i++) {
+    wrapper->install();
+    suspender.dismiss(); // Start measuring benchmark time
+    wrapper->remove();
+    suspender.rehire(); // Stop measuring time again
+  }
+}
+
+// Multipath encoding is the baseline. Unicast routes are compared against
+// programming via kernel nexthop objects.
+BENCHMARK_NAMED_PARAM(BM_Install, V4_10000, RouteType::V4, 10000, false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    BM_Install, V4_10000_nhobj, RouteType::V4, 10000, true);
+BENCHMARK_NAMED_PARAM(BM_Install, V4_100000, RouteType::V4, 100000, false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    BM_Install, V4_100000_nhobj, RouteType::V4, 100000, true);
+BENCHMARK_NAMED_PARAM(BM_Install, V4_1000000, RouteType::V4, 1000000, false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    BM_Install, V4_1000000_nhobj, RouteType::V4, 1000000, true);
+BENCHMARK_NAMED_PARAM(BM_Install, V6_10000, RouteType::V6, 10000, false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    BM_Install, V6_10000_nhobj, RouteType::V6, 10000, true);
+BENCHMARK_NAMED_PARAM(BM_Install, V6_100000, RouteType::V6, 100000, false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    BM_Install, V6_100000_nhobj, RouteType::V6, 100000, true);
+BENCHMARK_NAMED_PARAM(BM_Install, V6_1000000, RouteType::V6, 1000000, false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    BM_Install, V6_1000000_nhobj, RouteType::V6, 1000000, true);
+BENCHMARK_NAMED_PARAM(BM_Install, MPLS_10000, RouteType::MPLS, 10000, false);
+BENCHMARK_NAMED_PARAM(BM_Install, MPLS_100000, RouteType::MPLS, 100000, false);
+BENCHMARK_NAMED_PARAM(
+    BM_Install, MPLS_1000000, RouteType::MPLS, 1000000, false);
+BENCHMARK_DRAW_LINE();
+BENCHMARK_NAMED_PARAM(BM_Sync, V4_10000, RouteType::V4, 10000, false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    BM_Sync, V4_10000_nhobj, RouteType::V4, 10000, true);
+BENCHMARK_NAMED_PARAM(BM_Sync, V4_100000, RouteType::V4, 100000, false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    BM_Sync, V4_100000_nhobj, RouteType::V4, 100000, true);
+BENCHMARK_NAMED_PARAM(BM_Sync, V4_1000000, RouteType::V4, 1000000, false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    BM_Sync, V4_1000000_nhobj, RouteType::V4, 1000000, true);
+BENCHMARK_NAMED_PARAM(BM_Sync, V6_10000, RouteType::V6, 10000, false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    BM_Sync, V6_10000_nhobj, RouteType::V6, 10000, true);
+BENCHMARK_NAMED_PARAM(BM_Sync, V6_100000, RouteType::V6, 100000, false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    BM_Sync, V6_100000_nhobj, RouteType::V6, 100000, true);
+BENCHMARK_NAMED_PARAM(BM_Sync, V6_1000000, RouteType::V6, 1000000, false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    BM_Sync, V6_1000000_nhobj, RouteType::V6, 1000000, true);
+BENCHMARK_NAMED_PARAM(BM_Sync, MPLS_10000, RouteType::MPLS, 10000, false);
+BENCHMARK_NAMED_PARAM(BM_Sync, MPLS_100000, RouteType::MPLS, 100000, false);
+BENCHMARK_NAMED_PARAM(BM_Sync, MPLS_1000000, RouteType::MPLS, 1000000, false);
+BENCHMARK_DRAW_LINE();
+BENCHMARK_NAMED_PARAM(BM_Delete, V4_10000, RouteType::V4, 10000, false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    BM_Delete, V4_10000_nhobj, RouteType::V4, 10000, true);
+BENCHMARK_NAMED_PARAM(BM_Delete, V4_100000, RouteType::V4, 100000, false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    BM_Delete, V4_100000_nhobj, RouteType::V4, 100000, true);
+BENCHMARK_NAMED_PARAM(BM_Delete, V4_1000000, RouteType::V4, 1000000, false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    BM_Delete, V4_1000000_nhobj, RouteType::V4, 1000000, true);
+BENCHMARK_NAMED_PARAM(BM_Delete, V6_10000, RouteType::V6, 10000, false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    BM_Delete, V6_10000_nhobj, RouteType::V6, 10000, true);
+BENCHMARK_NAMED_PARAM(BM_Delete, V6_100000, RouteType::V6, 100000, false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    BM_Delete, V6_100000_nhobj, RouteType::V6, 100000, true);
+BENCHMARK_NAMED_PARAM(BM_Delete, V6_1000000, RouteType::V6, 1000000, false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    BM_Delete, V6_1000000_nhobj, RouteType::V6, 1000000, true);
+BENCHMARK_NAMED_PARAM(BM_Delete, MPLS_10000, RouteType::MPLS, 10000, false);
+BENCHMARK_NAMED_PARAM(BM_Delete, MPLS_100000, RouteType::MPLS, 100000, false);
+BENCHMARK_NAMED_PARAM(BM_Delete, MPLS_1000000, RouteType::MPLS, 1000000, false);
+
+} // namespace openr
+
+int
+main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  setupNetworkNamespace();
+  folly::runBenchmarks();
+  return 0;
+}
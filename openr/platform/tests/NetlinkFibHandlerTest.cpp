@@ -9,12 +9,16 @@
 #include <algorithm>
 #include <chrono>
 #include <stdexcept>
+#include <thread>
 
+#include <fb303/ServiceData.h>
 #include <folly/Format.h>
 #include <folly/IPAddress.h>
 #include <folly/Random.h>
 #include <folly/init/Init.h>
+#include <folly/executors/GlobalExecutor.h>
 #include <folly/io/async/EventBase.h>
+#include <folly/synchronization/Baton.h>
 #include <folly/system/ThreadName.h>
 #include <gflags/gflags.h>
 #include <glog/logging.h>
@@ -160,6 +164,12 @@ class FibHandlerFixture : public testing::TestWithParam<bool> {
     }
   }
 
+  // Number of kernel nexthop objects programmed
+  size_t
+  getNumNexthops() {
+    return nlSock_.getAllNexthops().get()->size();
+  }
+
  private:
   // Intentionally keeping private to not expose in UTs
   folly::EventBase nlEvb_;
@@ -169,8 +179,45 @@ class FibHandlerFixture : public testing::TestWithParam<bool> {
   // FibHandler is accessible in UTs for testing
   NetlinkFibHandler handler{
       dynamic_cast<fbnl::NetlinkProtocolSocket*>(&nlSock_)};
+
+  // FibHandler programming unicast routes via kernel nexthop objects
+  NetlinkFibHandler nhObjHandler{
+      dynamic_cast<fbnl::NetlinkProtocolSocket*>(&nlSock_),
+      true /* enableNexthopObjects */};
 };
 
+//
+// Tests static API - NetlinkFibHandler::isSameRoute
+// Attributes not programmed (e.g. flags reported by kernel) are ignored
+//
+TEST(NetlinkFibHandler, isSameRoute) {
+  const auto prefix = folly::IPAddress::createNetwork("fc00::/64");
+  auto nh1 = fbnl::NextHopBuilder()
+                 .setIfIndex(1)
+                 .setGateway(folly::IPAddress("fe80::1"))
+                 .build();
+  auto nh2 = fbnl::NextHopBuilder()
+                 .setIfIndex(2)
+                 .setGateway(folly::IPAddress("fe80::2"))
+                 .build();
+  fbnl::RouteBuilder builder;
+  builder.setDestination(prefix).setPriority(10).addNextHop(nh1);
+  const auto route = builder.build();
+
+  EXPECT_TRUE(NetlinkFibHandler::isSameRoute(route, route));
+  EXPECT_TRUE(NetlinkFibHandler::isSameRoute(
+      fbnl::RouteBuilder(builder).setFlags(RTM_F_NOTIFY).build(), route));
+  EXPECT_FALSE(NetlinkFibHandler::isSameRoute(
+      fbnl::RouteBuilder(builder).setPriority(20).build(), route));
+  EXPECT_FALSE(NetlinkFibHandler::isSameRoute(
+      fbnl::RouteBuilder(builder).addNextHop(nh2).build(), route));
+
+  // Same number of nexthops but different ones
+  fbnl::RouteBuilder otherBuilder;
+  otherBuilder.setDestination(prefix).setPriority(10).addNextHop(nh2);
+  EXPECT_FALSE(NetlinkFibHandler::isSameRoute(otherBuilder.build(), route));
+}
+
 //
 // Tests static API - NetlinkFibHandler::getProtocol
 // For mapping see `clientIdToProtocolId` in `Platform.thrift`
@@ -223,6 +270,29 @@ TEST(NetlinkFibHandler, getRoutesWithInvalidClient) {
       fbnl::NlException);
 }
 
+//
+// Interface cache is updated on LINK events. Renamed interface is reflected
+// even though existing entry would be served from cache otherwise
+//
+TEST(NetlinkFibHandler, InterfaceCacheLinkEvents) {
+  folly::EventBase evb;
+  fbnl::MockNetlinkProtocolSocket nlSock(&evb);
+  ASSERT_EQ(0, nlSock.addLink(fbnl::utils::createLink(1, "eth0")).get());
+
+  NetlinkFibHandler handler(&nlSock, false, nlSock.getReader());
+  EXPECT_EQ("eth0", handler.getIfName(1));
+  EXPECT_EQ(1, handler.getIfIndex("eth0"));
+
+  ASSERT_EQ(0, nlSock.addLink(fbnl::utils::createLink(1, "eth1")).get());
+  while (handler.getIfName(1) != "eth1") {
+    std::this_thread::yield();
+  }
+  EXPECT_EQ(1, handler.getIfIndex("eth1"));
+
+  // Close queue to stop events processing thread of handler
+  nlSock.closeQueue();
+}
+
 //
 // Test correctness of route add, update, and remove
 //
@@ -410,6 +480,135 @@ TEST_P(FibHandlerFixture, UnicastSync) {
   ASSERT_EQ(6, routes->size());
   sortNextHops(*routes);
   EXPECT_EQ(rts, *routes);
+
+  // Sync same routes again. Ensure no route is programmed
+  auto counters = facebook::fb303::fbData->getCounters();
+  const auto numAdds = counters["nlmock.add_route.sum"];
+  const auto numDeletes = counters["nlmock.delete_route.sum"];
+  handler
+      .semifuture_syncFib(
+          kClientId, std::make_unique<std::vector<thrift::UnicastRoute>>(rts))
+      .get();
+  counters = facebook::fb303::fbData->getCounters();
+  EXPECT_EQ(numAdds, counters["nlmock.add_route.sum"]);
+  EXPECT_EQ(numDeletes, counters["nlmock.delete_route.sum"]);
+}
+
+//
+// Stream route table. Routes are received in bounded chunks, and are same as
+// the ones returned by non-streaming API
+//
+TEST_P(FibHandlerFixture, UnicastStream) {
+  const int16_t kClientId = 786;
+  const bool isV4 = GetParam();
+
+  // Invalid client
+  EXPECT_THROW(handler.getRouteTableByClientStream(111), fbnl::NlException);
+
+  auto rts = createUnicastRoutes(1500, isV4);
+  handler
+      .semifuture_syncFib(
+          kClientId, std::make_unique<std::vector<thrift::UnicastRoute>>(rts))
+      .get();
+
+  folly::Baton<> baton;
+  std::vector<size_t> chunkSizes;
+  std::vector<thrift::UnicastRoute> routes;
+  auto subscription = handler.getRouteTableByClientStream(kClientId)
+                          .toClientStreamUnsafeDoNotUse()
+                          .subscribeExTry(folly::getEventBase(), [&](auto&& t) {
+                            if (t.hasValue()) {
+                              chunkSizes.emplace_back(t->size());
+                              routes.insert(routes.end(), t->begin(), t->end());
+                              return;
+                            }
+                            EXPECT_FALSE(t.hasException());
+                            baton.post();
+                          });
+  baton.wait();
+  std::move(subscription).detach();
+
+  EXPECT_EQ(std::vector<size_t>({1000, 500}), chunkSizes);
+  sortNextHops(routes);
+  auto expectedRoutes =
+      handler.semifuture_getRouteTableByClient(kClientId).get();
+  sortNextHops(*expectedRoutes);
+  EXPECT_EQ(*expectedRoutes, routes);
+}
+
+//
+// Test programming of unicast routes via kernel nexthop objects
+//
+// Add [r1, r2, r3] where r1 & r2 share nexthops - ensure nexthop group of r1
+// is shared with r2. Add nexthop to r3 - ensure its group is updated in place.
+// Delete r1 & r2 - ensure their objects are removed only after last route.
+// syncFib with [r1] - ensure r3 objects are removed.
+//
+TEST_P(FibHandlerFixture, UnicastNexthopObjects) {
+  const int16_t kClientId = 786;
+  const bool isV4 = GetParam();
+
+  auto r1 = createUnicastRoute(0, 2, isV4);
+  auto r2 = createUnicastRoute(1, 2, isV4);
+  *r2.nextHops_ref() = *r1.nextHops_ref();
+  auto r3 = createUnicastRoute(2, 3, isV4);
+  r3.nextHops_ref()->clear();
+  for (size_t i = 0; i < 3; ++i) {
+    r3.nextHops_ref()->emplace_back(createNextHop(10 + i, isV4));
+  }
+  const std::vector<thrift::UnicastRoute> rts{r1, r2, r3};
+
+  // Add routes. 2 nexthops + group for r1/r2, 3 nexthops + group for r3
+  nhObjHandler
+      .semifuture_addUnicastRoutes(
+          kClientId, std::make_unique<std::vector<thrift::UnicastRoute>>(rts))
+      .get();
+  auto routes = nhObjHandler.semifuture_getRouteTableByClient(kClientId).get();
+  ASSERT_EQ(3, routes->size());
+  sortNextHops(*routes);
+  EXPECT_EQ(rts, *routes);
+  EXPECT_EQ(7, getNumNexthops());
+
+  // Add nexthop to r3. Its group is replaced in place with one more member
+  r3.nextHops_ref()->emplace_back(createNextHop(13, isV4));
+  nhObjHandler
+      .semifuture_addUnicastRoute(
+          kClientId, std::make_unique<thrift::UnicastRoute>(r3))
+      .get();
+  routes = nhObjHandler.semifuture_getRouteTableByClient(kClientId).get();
+  ASSERT_EQ(3, routes->size());
+  sortNextHops(*routes);
+  EXPECT_EQ(r3, routes->at(2));
+  EXPECT_EQ(8, getNumNexthops());
+
+  // Delete r1. Group is still referred by r2
+  nhObjHandler
+      .semifuture_deleteUnicastRoute(
+          kClientId, std::make_unique<thrift::IpPrefix>(*r1.dest_ref()))
+      .get();
+  EXPECT_EQ(8, getNumNexthops());
+
+  // Delete r2. Group and its nexthops are removed
+  nhObjHandler
+      .semifuture_deleteUnicastRoute(
+          kClientId, std::make_unique<thrift::IpPrefix>(*r2.dest_ref()))
+      .get();
+  routes = nhObjHandler.semifuture_getRouteTableByClient(kClientId).get();
+  ASSERT_EQ(1, routes->size());
+  EXPECT_EQ(5, getNumNexthops());
+
+  // Sync with r1. r3 and its objects are removed
+  nhObjHandler
+      .semifuture_syncFib(
+          kClientId,
+          std::make_unique<std::vector<thrift::UnicastRoute>>(
+              std::vector<thrift::UnicastRoute>{r1}))
+      .get();
+  routes = nhObjHandler.semifuture_getRouteTableByClient(kClientId).get();
+  ASSERT_EQ(1, routes->size());
+  sortNextHops(*routes);
+  EXPECT_EQ(r1, routes->at(0));
+  EXPECT_EQ(3, getNumNexthops());
 }
 
 //
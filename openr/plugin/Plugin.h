@@ -20,6 +20,10 @@
 #include <openr/messaging/ReplicateQueue.h>
 
 namespace openr {
+/**
+ * Plugins inject routes through `prefixUpdatesQueue`. Large tables should be
+ * set as `PrefixEvent::prefixBatch` rather than a PrefixEntry per route.
+ */
 struct PluginArgs {
   messaging::ReplicateQueue<PrefixEvent>& prefixUpdatesQueue;
   messaging::ReplicateQueue<DecisionRouteUpdate>& staticRouteUpdatesQueue;
@@ -7,18 +7,73 @@
 
 #include "openr/policy/PolicyManager.h"
 
+#include <fb303/ServiceData.h>
+#include <folly/Conv.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+
+namespace fb303 = facebook::fb303;
+
 namespace openr {
 
 class PolicyManagerImpl {};
 
 PolicyManager::PolicyManager(
-    const neteng::config::routing_policy::PolicyConfig& config) {}
+    const neteng::config::routing_policy::PolicyConfig& config,
+    size_t cacheSize)
+    : cache_(cacheSize) {}
 PolicyManager::~PolicyManager() = default;
 
 std::pair<std::shared_ptr<thrift::PrefixEntry>, std::string /*policy name*/>
 PolicyManager::applyPolicy(
     const std::string& policyStatementName,
     const std::shared_ptr<thrift::PrefixEntry>& prefixEntry) noexcept {
+  // length of policy name delimits it from the serialized entry
+  const auto key = folly::to<std::string>(
+      policyStatementName.size(),
+      ':',
+      policyStatementName,
+      apache::thrift::CompactSerializer::serialize<std::string>(*prefixEntry));
+
+  auto it = cache_.find(key);
+  if (it != cache_.end()) {
+    fb303::fbData->addStatValue("policy_manager.cache_hits", 1, fb303::SUM);
+    const auto& result = it->second;
+    if (not result.accepted) {
+      return {nullptr, result.hitPolicyName};
+    }
+    if (not result.modifiedEntry.has_value()) {
+      return {prefixEntry, result.hitPolicyName};
+    }
+    // copy, callers own the returned entry
+    return {
+        std::make_shared<thrift::PrefixEntry>(*result.modifiedEntry),
+        result.hitPolicyName};
+  }
+  fb303::fbData->addStatValue("policy_manager.cache_misses", 1, fb303::SUM);
+
+  auto [postPolicyEntry, hitPolicyName] =
+      evaluatePolicy(policyStatementName, prefixEntry);
+
+  PolicyResult result;
+  result.accepted = postPolicyEntry != nullptr;
+  if (postPolicyEntry and *postPolicyEntry != *prefixEntry) {
+    result.modifiedEntry = *postPolicyEntry;
+  }
+  result.hitPolicyName = hitPolicyName;
+  cache_.set(key, std::move(result));
+
+  return {std::move(postPolicyEntry), std::move(hitPolicyName)};
+}
+
+void
+PolicyManager::invalidateCache() noexcept {
+  cache_.clear();
+}
+
+std::pair<std::shared_ptr<thrift::PrefixEntry>, std::string /*policy name*/>
+PolicyManager::evaluatePolicy(
+    const std::string& policyStatementName,
+    const std::shared_ptr<thrift::PrefixEntry>& prefixEntry) noexcept {
   return {prefixEntry, "Always Allow"};
 }
 
@@ -7,7 +7,10 @@
 
 #pragma once
 
+#include <optional>
+
 #include <configerator/structs/neteng/config/gen-cpp2/routing_policy_types.h>
+#include <folly/container/EvictingCacheMap.h>
 #include <openr/if/gen-cpp2/Types_types.h>
 
 namespace openr {
@@ -16,11 +19,17 @@ class PolicyManagerImpl;
 
 /**
  * PolicyManager manages all policies defined in the config file.
+ *
+ * Results of policy evaluation are memoized per (policy name, PrefixEntry) in
+ * a bounded LRU cache, as the same entries get evaluated again on every
+ * re-advertisement and area crossing. PrefixEntry is part of the key as a
+ * whole, since policies can match on the prefix itself. Not thread-safe.
  */
 class PolicyManager {
  public:
   explicit PolicyManager(
-      const neteng::config::routing_policy::PolicyConfig& config);
+      const neteng::config::routing_policy::PolicyConfig& config,
+      size_t cacheSize = kDefaultCacheSize);
   ~PolicyManager();
 
   std::pair<std::shared_ptr<thrift::PrefixEntry>, std::string /*policy name*/>
@@ -28,9 +37,34 @@ class PolicyManager {
       const std::string& policyStatementName,
       const std::shared_ptr<thrift::PrefixEntry>& prefixEntry) noexcept;
 
+  // Drop memoized results, e.g. when policy definitions change
+  void invalidateCache() noexcept;
+
+  // Default number of memoized policy results
+  static constexpr size_t kDefaultCacheSize{100000};
+
   // PolicyManagerImpl uses forward declaration
   // Use shared_ptr because it works with incomplete type, where unique_ptr
   // requires full declaration
   std::shared_ptr<PolicyManagerImpl> impl_{nullptr};
+
+ private:
+  // Memoized result of policy evaluation
+  struct PolicyResult {
+    // Entry is accepted by the policy
+    bool accepted{false};
+    // Entry modified by the policy, unset if accepted as is
+    std::optional<thrift::PrefixEntry> modifiedEntry;
+    // Name of the policy term hit
+    std::string hitPolicyName;
+  };
+
+  std::pair<std::shared_ptr<thrift::PrefixEntry>, std::string /*policy name*/>
+  evaluatePolicy(
+      const std::string& policyStatementName,
+      const std::shared_ptr<thrift::PrefixEntry>& prefixEntry) noexcept;
+
+  // Keyed by policy name and serialized PrefixEntry
+  folly::EvictingCacheMap<std::string, PolicyResult> cache_;
 };
 } // namespace openr
@@ -48,7 +48,10 @@ PrefixManager::PrefixManager(
       preferOpenrOriginatedRoutes_(
           config->getConfig().get_prefer_openr_originated_routes()),
       enableNewPrefixFormat_(
-          config->getConfig().get_enable_new_prefix_format()) {
+          config->getConfig().get_enable_new_prefix_format()),
+      enableCompactPrefixKey_(
+          config->getConfig().get_enable_compact_prefix_key()),
+      prefixDbBuckets_(config->getConfig().get_prefix_db_buckets()) {
   CHECK(kvStore_);
   CHECK(config);
 
@@ -62,10 +65,21 @@ PrefixManager::PrefixManager(
 
   if (auto policyConf = config->getAreaPolicies()) {
     policyManager_ = std::make_unique<PolicyManager>(*policyConf);
+    memoryShedder_ = MemoryPressure::addShedder(
+        "prefix_manager", getEvb(), [this]() noexcept {
+          policyManager_->invalidateCache();
+        });
   }
 
   for (const auto& [areaId, areaConf] : config->getAreas()) {
     areaToPolicy_.emplace(areaId, areaConf.getImportPolicyName());
+
+    // Create area shard with its own throttled sync
+    auto& shard = areaShards_.try_emplace(areaId, areaId).first->second;
+    shard.syncThrottled = std::make_unique<AsyncThrottle>(
+        getEvb(),
+        Constants::kPrefixAreaSyncThrottleTimeout,
+        [this, area = areaId]() noexcept { syncAreaShard(area); });
   }
 
   //
@@ -93,11 +107,16 @@ PrefixManager::PrefixManager(
     initialSyncKvStoreTimer_ =
         folly::AsyncTimeout::make(*getEvb(), [this]() noexcept {
           LOG(INFO) << "syncKvStore() from initialSyncKvStoreTimer_.";
-          syncKvStore();
+          syncKvStore(true /* fullSync */);
         });
     initialSyncKvStoreTimer_->scheduleTimeout(initialPrefixHoldTime);
   }
 
+  // Create audit timer. Scheduled after initial full sync of prefixes.
+  auditKvStoreTimer_ = folly::AsyncTimeout::make(*getEvb(), [this]() noexcept {
+    syncKvStore(true /* fullSync */);
+  });
+
   // Create throttled update state
   syncKvStoreThrottled_ = std::make_unique<AsyncThrottle>(
       getEvb(), Constants::kKvStoreSyncThrottleTimeout, [this]() noexcept {
@@ -156,13 +175,18 @@ PrefixManager::PrefixManager(
             std::move(std::move(update.prefixEntries)),
             dstAreas,
             update.policyName);
+        if (update.prefixBatch) {
+          advertisePrefixBatchImpl(
+              *update.prefixBatch, dstAreas, update.policyName);
+        }
 
         if (uninitializedPrefixTypes_.erase(update.type)) {
           // Received initial prefixes of certain type in OpenR initialization
           // process.
           LOG(INFO) << fmt::format(
               "[Initialization] Received {} prefixes of type {}.",
-              update.prefixes.size() + update.prefixEntries.size(),
+              update.prefixes.size() + update.prefixEntries.size() +
+                  (update.prefixBatch ? update.prefixBatch->size() : 0),
               apache::thrift::util::enumNameSafe<thrift::PrefixType>(
                   update.type));
           triggerInitialPrefixDbSync();
@@ -172,6 +196,9 @@ PrefixManager::PrefixManager(
       case PrefixEventType::WITHDRAW_PREFIXES:
         withdrawPrefixesImpl(update.prefixes);
         withdrawPrefixEntriesImpl(update.prefixEntries);
+        if (update.prefixBatch) {
+          withdrawPrefixBatchImpl(*update.prefixBatch);
+        }
         break;
       case PrefixEventType::WITHDRAW_PREFIXES_BY_TYPE:
         withdrawPrefixesByTypeImpl(update.type);
@@ -232,20 +259,24 @@ PrefixManager::PrefixManager(
             << "[Initialization] All prefix keys are retrieved from KvStore.";
         initialKvStoreSynced_ = true;
         triggerInitialPrefixDbSync();
+      } else if (pub.kvStoreWarmStarted) {
+        // Seeded key-vals are already received. Prefixes are still synced
+        // with KvStore on kvStoreSynced signal.
+        continue;
       } else {
         // TODO: Do not call KvStoreClient_ to process publications after
         // persistKey() and clearKey() are natively supported in KvStore.
-        kvStoreClient_->processPublication(pub.tPublication);
+        kvStoreClient_->processPublication(*pub.tPublication);
 
         // Process KvStore Thrift publication.
-        processPublication(std::move(pub.tPublication));
+        processPublication(*pub.tPublication);
       }
     }
   });
 }
 
 void
-PrefixManager::processPublication(thrift::Publication&& thriftPub) {
+PrefixManager::processPublication(thrift::Publication const& thriftPub) {
   folly::small_vector<folly::CIDRNetwork> changed{};
   for (const auto& [keyStr, val] : *thriftPub.keyVals_ref()) {
     // Only interested in prefix updates.
@@ -255,8 +286,24 @@ PrefixManager::processPublication(thrift::Publication&& thriftPub) {
       continue;
     }
 
-    // TODO: remove fromStr() key parsing logic once every key is on V2 format
     auto const& area = thriftPub.get_area();
+    if (auto bucket = getPrefixDbBucketFromKey(keyStr)) {
+      // Skip none-self advertised buckets
+      if (getNodeNameFromKey(keyStr) != nodeId_ or
+          areaShards_.count(area) == 0) {
+        continue;
+      }
+      // ATTN: to avoid prefix churn, skip buckets of previous incarnation
+      // while advertising one key per prefix, as for other key formats.
+      if (prefixDbBuckets_ == 0) {
+        LOG(INFO) << "Skip processing bucket of prefixes: " << keyStr;
+        continue;
+      }
+      processPrefixDbBucketKey(area, *bucket, *val.get_value());
+      continue;
+    }
+
+    // TODO: remove fromStr() key parsing logic once every key is on V2 format
     auto prefixKey = PrefixKey::fromStr(keyStr, area);
     // Skip bad format of key.
     if (prefixKey.hasError()) {
@@ -267,18 +314,23 @@ PrefixManager::processPublication(thrift::Publication&& thriftPub) {
       continue;
     }
     // Skip none-self advertised prefixes or already persisted keys.
+    auto shardIt = areaShards_.find(area);
     if (prefixKey->getNodeName() != nodeId_ or
-        keysInKvStore_.count(prefixKey->getCIDRNetwork()) > 0) {
+        shardIt == areaShards_.end() or
+        shardIt->second.advertisedPrefixes.count(
+            prefixKey->getCIDRNetwork()) > 0) {
       continue;
     }
     // ATTN: to avoid prefix churn, skip processing prefixes from previous
     // incarnation with different prefix key format.
-    if (enableNewPrefixFormat_ != prefixKey.value().isPrefixKeyV2()) {
-      const std::string version =
-          prefixKey.value().isPrefixKeyV2() ? "v2" : "v1";
+    const bool isCompact = prefixKey.value().isPrefixKeyCompact();
+    const bool isV2 = prefixKey.value().isPrefixKeyV2();
+    if (prefixDbBuckets_ > 0 or enableCompactPrefixKey_ != isCompact or
+        (not isCompact and enableNewPrefixFormat_ != isV2)) {
+      const std::string version = isCompact ? "compact" : (isV2 ? "v2" : "v1");
       LOG(INFO) << fmt::format(
           "Skip processing {} format of prefix: {}", version, keyStr);
-      return;
+      continue;
     }
     try {
       const auto prefixDb = readThriftObjStr<thrift::PrefixDatabase>(
@@ -295,9 +347,9 @@ PrefixManager::processPublication(thrift::Publication&& thriftPub) {
             "[Prefix Update]: Area: {}, {} updated inside KvStore",
             area,
             keyStr);
-        // populate keysInKvStore_ collection to make sure we can find
-        // <key, area> when clear key from `KvStore`
-        keysInKvStore_[network].areas.emplace(area);
+        // populate area shard to make sure we can find <key, area> when
+        // clear key from `KvStore`
+        shardIt->second.advertisedPrefixes.emplace(network);
 
         // Populate pendingState to check keys
         pendingUpdates_.addPrefixChange(network);
@@ -310,12 +362,58 @@ PrefixManager::processPublication(thrift::Publication&& thriftPub) {
   } // for
 }
 
+void
+PrefixManager::processPrefixDbBucketKey(
+    const std::string& area, uint32_t bucket, const std::string& value) {
+  auto& shard = areaShards_.at(area);
+  thrift::PrefixDatabase prefixDb;
+  try {
+    prefixDb = readThriftObjStr<thrift::PrefixDatabase>(value, serializer_);
+  } catch (const std::exception& ex) {
+    LOG(ERROR) << "Failed to deserialize bucket " << bucket
+               << " of prefixes. Exception: " << folly::exceptionStr(ex);
+    return;
+  }
+  if (*prefixDb.deletePrefix_ref()) {
+    return;
+  }
+
+  // Bucket left over from larger number of buckets is withdrawn on next sync
+  // of the area, while its prefixes are reconciled like any other.
+  if (bucket >= prefixDbBuckets_) {
+    shard.dirtyBuckets.emplace(bucket);
+  }
+
+  // Prefixes not advertised by this incarnation (yet) are withdrawn, or
+  // re-advertised, by next syncKvStore(). Bucket is rewritten along.
+  bool changed{false};
+  for (const auto& tPrefixEntry : prefixDb.get_prefixEntries()) {
+    auto const& network = toIPNetwork(tPrefixEntry.get_prefix());
+    if (shard.advertisedPrefixes.emplace(network).second) {
+      pendingUpdates_.addPrefixChange(network);
+      changed = true;
+    }
+  }
+  if (changed) {
+    VLOG(1) << fmt::format(
+        "[Prefix Update]: Area: {}, bucket {} of prefixes updated inside "
+        "KvStore",
+        area,
+        bucket);
+    syncKvStoreThrottled_->operator()();
+  }
+}
+
 PrefixManager::~PrefixManager() {
   // - If EventBase is stopped or it is within the evb thread, run immediately;
   // - Otherwise, will wait the EventBase to run;
   getEvb()->runImmediatelyOrRunInEventBaseThreadAndWait([this]() {
     initialSyncKvStoreTimer_.reset();
+    auditKvStoreTimer_.reset();
     syncKvStoreThrottled_.reset();
+    for (auto& [_, shard] : areaShards_) {
+      shard.syncThrottled.reset();
+    }
   });
   kvStoreClient_.reset();
 }
@@ -377,6 +475,7 @@ PrefixManager::buildOriginatedPrefixDb(
     unicastEntry.bestPrefixEntry = std::move(entry);
 
     // ATTN: upon initialization, no supporting routes
+    originatedPrefixTrie_.insert(network);
     originatedPrefixDb_.emplace(
         network,
         OriginatedRoute(
@@ -389,28 +488,29 @@ PrefixManager::buildOriginatedPrefixDb(
 void
 PrefixManager::updatePrefixKeysInKvStore(
     const folly::CIDRNetwork& prefix, const PrefixEntry& prefixEntry) {
-  // advertise best-entry for this prefix to `KvStore`
-  auto updatedArea = addKvStoreKeyHelper(prefixEntry);
+  const auto& tPrefixEntry = prefixEntry.tPrefixEntry;
+  const std::unordered_set<std::string> areaStack{
+      tPrefixEntry->area_stack_ref()->begin(),
+      tPrefixEntry->area_stack_ref()->end()};
 
-  auto keysIt = keysInKvStore_.find(prefix);
-  if (keysIt != keysInKvStore_.end()) {
-    // ATTN: keysInKvStore_ collection holds "advertised" prefixes in previous
-    // round of syncing. By removing prefixes in current run, whatever left in
-    // `keysInKvStore_` will be the delta to be removed.
-    for (const auto& area : updatedArea) {
-      keysIt->second.areas.erase(area);
+  for (auto& [area, shard] : areaShards_) {
+    // prevent area_stack loop
+    // ATTN: for local-originated prefixes, `area_stack` is explicitly
+    //       set to empty.
+    if (prefixEntry.dstAreas.count(area) and not areaStack.count(area)) {
+      // advertise best-entry for this prefix to `KvStore`
+      queueAreaKeyUpdate(area, prefix, tPrefixEntry);
+    } else if (
+        shard.advertisedPrefixes.count(prefix) or
+        shard.pendingPrefixes.count(prefix)) {
+      // remove keys which are no longer advertised
+      // e.g.
+      // t0: prefix_1 => {area_1, area_2}
+      // t1: prefix_1 => {area_1, area_3}
+      //     (prefix_1, area_2) will be removed
+      queueAreaKeyUpdate(area, prefix, nullptr);
     }
-
-    // remove keys which are no longer advertised
-    // e.g.
-    // t0: prefix_1 => {area_1, area_2}
-    // t1: prefix_1 => {area_1, area_3}
-    //     (prefix_1, area_2) will be removed
-    deleteKvStoreKeyHelper(prefix, keysIt->second.areas);
   }
-
-  // override `keysInKvStore_` for next-round syncing
-  keysInKvStore_[prefix].areas = std::move(updatedArea);
 }
 
 void
@@ -438,77 +538,90 @@ PrefixManager::populateRouteUpdates(
   } // else
 }
 
-std::unordered_set<std::string>
-PrefixManager::addKvStoreKeyHelper(const PrefixEntry& entry) {
-  std::unordered_set<std::string> areasToUpdate;
-  const auto& tPrefixEntry = entry.tPrefixEntry;
-  const auto& type = *tPrefixEntry->type_ref();
-  const std::unordered_set<std::string> areaStack{
-      tPrefixEntry->area_stack_ref()->begin(),
-      tPrefixEntry->area_stack_ref()->end()};
+std::string
+PrefixManager::getPrefixKeyStr(const PrefixKey& prefixKey) const {
+  if (enableCompactPrefixKey_) {
+    return prefixKey.getPrefixKeyCompact();
+  }
+  return enableNewPrefixFormat_ ? prefixKey.getPrefixKeyV2()
+                                : prefixKey.getPrefixKey();
+}
 
-  for (const auto& toArea : entry.dstAreas) {
-    // prevent area_stack loop
-    // ATTN: for local-originated prefixes, `area_stack` is explicitly
-    //       set to empty.
-    if (areaStack.count(toArea)) {
-      continue;
-    }
+void
+PrefixManager::queueAreaKeyUpdate(
+    const std::string& area,
+    const folly::CIDRNetwork& prefix,
+    std::shared_ptr<thrift::PrefixEntry> tPrefixEntry) {
+  auto& shard = areaShards_.at(area);
+  shard.pendingPrefixes[prefix] = std::move(tPrefixEntry);
+  shard.syncThrottled->operator()();
+}
 
-    // run ingress policy
-    std::shared_ptr<thrift::PrefixEntry> postPolicyTPrefixEntry;
-    std::string hitPolicyName;
+bool
+PrefixManager::addKvStoreKeyHelper(
+    const std::string& area,
+    const folly::CIDRNetwork& prefix,
+    const std::shared_ptr<thrift::PrefixEntry>& tPrefixEntry) {
+  const auto& type = *tPrefixEntry->type_ref();
 
-    const auto& policy = areaToPolicy_.at(toArea);
-    if (policy) {
-      std::tie(postPolicyTPrefixEntry, hitPolicyName) =
-          policyManager_->applyPolicy(*policy, tPrefixEntry);
+  // run ingress policy
+  std::shared_ptr<thrift::PrefixEntry> postPolicyTPrefixEntry;
+  std::string hitPolicyName;
 
-      // policy reject prefix, nothing to do.
-      if (not postPolicyTPrefixEntry) {
-        VLOG(2) << "[Area Policy] " << *policy << " rejected prefix: "
-                << "(Type, PrefixEntry): (" << toString(type) << ", "
-                << toString(*tPrefixEntry, true) << "), hit term ("
-                << hitPolicyName << ")";
-        continue;
-      }
+  const auto& policy = areaToPolicy_.at(area);
+  if (policy) {
+    std::tie(postPolicyTPrefixEntry, hitPolicyName) =
+        policyManager_->applyPolicy(*policy, tPrefixEntry);
 
-      // policy accept prefix, go ahread with prefix announcement.
-      VLOG(2) << "[Area Policy] " << *policy << " accepted/modified prefix: "
+    // policy reject prefix, nothing to do.
+    if (not postPolicyTPrefixEntry) {
+      VLOG(2) << "[Area Policy] " << *policy << " rejected prefix: "
               << "(Type, PrefixEntry): (" << toString(type) << ", "
-              << toString(*tPrefixEntry, true) << "), PostPolicyEntry: ("
-              << toString(*postPolicyTPrefixEntry) << "), hit term ("
+              << toString(*tPrefixEntry, true) << "), hit term ("
               << hitPolicyName << ")";
-    } else {
-      postPolicyTPrefixEntry = tPrefixEntry;
+      return false;
     }
 
-    const auto prefixKey = PrefixKey(nodeId_, entry.network, toArea);
-    const auto prefixKeyStr = enableNewPrefixFormat_
-        ? prefixKey.getPrefixKeyV2()
-        : prefixKey.getPrefixKey();
-    auto prefixDb = createPrefixDb(nodeId_, {*postPolicyTPrefixEntry}, toArea);
-    auto prefixDbStr = writeThriftObjStr(std::move(prefixDb), serializer_);
+    // policy accept prefix, go ahread with prefix announcement.
+    VLOG(2) << "[Area Policy] " << *policy << " accepted/modified prefix: "
+            << "(Type, PrefixEntry): (" << toString(type) << ", "
+            << toString(*tPrefixEntry, true) << "), PostPolicyEntry: ("
+            << toString(*postPolicyTPrefixEntry) << "), hit term ("
+            << hitPolicyName << ")";
+  } else {
+    postPolicyTPrefixEntry = tPrefixEntry;
+  }
+
+  if (prefixDbBuckets_ > 0) {
+    // packed into bucket key, written once the area is synced
+    auto& shard = areaShards_.at(area);
+    const auto bucket = getPrefixDbBucket(prefix, prefixDbBuckets_);
+    shard.bucketEntries[bucket].insert_or_assign(
+        prefix, *postPolicyTPrefixEntry);
+    shard.dirtyBuckets.emplace(bucket);
+  } else {
+    auto prefixKeyStr = getPrefixKeyStr(PrefixKey(nodeId_, prefix, area));
+    auto prefixDb = createPrefixDb(nodeId_, {*postPolicyTPrefixEntry}, area);
+    auto prefixDbStr =
+        writeThriftObjStrBuffered(std::move(prefixDb), serializer_);
 
     // advertise key to `KvStore`
     if (config_->getConfig().get_enable_kvstore_request_queue()) {
-      auto persistPrefixKeyVal =
-          PersistKeyValueRequest(AreaId{toArea}, prefixKeyStr, prefixDbStr);
-      kvRequestQueue_.push(std::move(persistPrefixKeyVal));
+      areaShards_.at(area).kvRequestBatch.persistKey(
+          std::move(prefixKeyStr), std::move(prefixDbStr));
     } else {
       kvStoreClient_->persistKey(
-          AreaId{toArea}, prefixKeyStr, prefixDbStr, ttlKeyInKvStore_);
+          AreaId{area}, prefixKeyStr, prefixDbStr, ttlKeyInKvStore_);
     }
+  }
 
-    fb303::fbData->addStatValue(
-        "prefix_manager.route_advertisements", 1, fb303::SUM);
-    VLOG(1) << "[Prefix Advertisement] "
-            << "Area: " << toArea << ", "
-            << "Type: " << toString(type) << ", "
-            << toString(*postPolicyTPrefixEntry, VLOG_IS_ON(2));
-    areasToUpdate.emplace(toArea);
-  }
-  return areasToUpdate;
+  fb303::fbData->addStatValue(
+      "prefix_manager.route_advertisements", 1, fb303::SUM);
+  VLOG(1) << "[Prefix Advertisement] "
+          << "Area: " << area << ", "
+          << "Type: " << toString(type) << ", "
+          << toString(*postPolicyTPrefixEntry, VLOG_IS_ON(2));
+  return true;
 }
 
 void
@@ -520,9 +633,15 @@ PrefixManager::deletePrefixKeysInKvStore(
   //  prefix    :    node1    :    0    :    0.0.0.0/32
   //    |              |           |             |
   //  marker        nodeId      areaId        prefixStr
+  for (auto& [area, shard] : areaShards_) {
+    if (shard.advertisedPrefixes.count(prefix) or
+        shard.pendingPrefixes.count(prefix)) {
+      queueAreaKeyUpdate(area, prefix, nullptr);
+    }
+  }
+
   auto keysIt = keysInKvStore_.find(prefix);
   if (keysIt != keysInKvStore_.end()) {
-    deleteKvStoreKeyHelper(prefix, keysIt->second.areas);
     if (keysIt->second.installedToFib) {
       routeUpdatesOut.unicastRoutesToDelete.emplace_back(prefix);
     }
@@ -532,43 +651,92 @@ PrefixManager::deletePrefixKeysInKvStore(
 
 void
 PrefixManager::deleteKvStoreKeyHelper(
-    const folly::CIDRNetwork& prefix,
-    const std::unordered_set<std::string>& deletedArea) {
+    const std::string& area, const folly::CIDRNetwork& prefix) {
+  if (prefixDbBuckets_ > 0) {
+    // dropped from bucket key, written once the area is synced
+    auto& shard = areaShards_.at(area);
+    const auto bucket = getPrefixDbBucket(prefix, prefixDbBuckets_);
+    auto bucketIt = shard.bucketEntries.find(bucket);
+    if (bucketIt != shard.bucketEntries.end()) {
+      bucketIt->second.erase(prefix);
+      if (bucketIt->second.empty()) {
+        shard.bucketEntries.erase(bucketIt);
+      }
+    }
+    shard.dirtyBuckets.emplace(bucket);
+
+    VLOG(1) << "[Prefix Withdraw] "
+            << "Area: " << area << ", "
+            << folly::IPAddress::networkToString(prefix);
+    fb303::fbData->addStatValue(
+        "prefix_manager.route_withdraws", 1, fb303::SUM);
+    return;
+  }
+
   // Prepare thrift::PrefixDatabase object for deletion
+  thrift::PrefixEntry entry;
+  entry.prefix_ref() = toIpPrefix(prefix);
   thrift::PrefixDatabase deletedPrefixDb;
   deletedPrefixDb.thisNodeName_ref() = nodeId_;
   deletedPrefixDb.deletePrefix_ref() = true;
+  deletedPrefixDb.prefixEntries_ref() = {entry};
+  deletedPrefixDb.area_ref() = area;
 
-  for (const auto& area : deletedArea) {
-    thrift::PrefixEntry entry;
-    entry.prefix_ref() = toIpPrefix(prefix);
-    deletedPrefixDb.prefixEntries_ref() = {entry};
-    deletedPrefixDb.area_ref() = area;
+  const auto prefixStr = getPrefixKeyStr(PrefixKey(nodeId_, prefix, area));
 
-    const auto prefixKey = PrefixKey(nodeId_, prefix, area);
-    const auto prefixStr = enableNewPrefixFormat_ ? prefixKey.getPrefixKeyV2()
-                                                  : prefixKey.getPrefixKey();
+  // Remove prefix from KvStore and flood deletion by setting deleted value.
+  if (config_->getConfig().get_enable_kvstore_request_queue()) {
+    areaShards_.at(area).kvRequestBatch.unsetKey(
+        prefixStr,
+        writeThriftObjStrBuffered(std::move(deletedPrefixDb), serializer_));
+  } else {
+    kvStoreClient_->clearKey(
+        AreaId{area},
+        prefixStr,
+        writeThriftObjStrBuffered(std::move(deletedPrefixDb), serializer_),
+        ttlKeyInKvStore_);
+  }
 
-    // Remove prefix from KvStore and flood deletion by setting deleted value.
+  VLOG(1) << "[Prefix Withdraw] "
+          << "Area: " << area << ", " << toString(*entry.prefix_ref());
+  fb303::fbData->addStatValue("prefix_manager.route_withdraws", 1, fb303::SUM);
+}
+
+void
+PrefixManager::syncPrefixDbBucket(const std::string& area, uint32_t bucket) {
+  auto& shard = areaShards_.at(area);
+  auto bucketKeyStr = getPrefixDbBucketKey(nodeId_, bucket);
+  auto bucketIt = shard.bucketEntries.find(bucket);
+
+  if (bucketIt != shard.bucketEntries.end()) {
+    std::vector<thrift::PrefixEntry> entries;
+    entries.reserve(bucketIt->second.size());
+    for (const auto& [_, entry] : bucketIt->second) {
+      entries.emplace_back(entry);
+    }
+    auto prefixDbStr = writeThriftObjStrBuffered(
+        createPrefixDb(nodeId_, entries, area), serializer_);
+
+    // advertise key to `KvStore`
     if (config_->getConfig().get_enable_kvstore_request_queue()) {
-      auto unsetPrefixRequest = ClearKeyValueRequest(
-          AreaId{area},
-          prefixStr,
-          writeThriftObjStr(std::move(deletedPrefixDb), serializer_),
-          true);
-      kvRequestQueue_.push(std::move(unsetPrefixRequest));
+      shard.kvRequestBatch.persistKey(
+          std::move(bucketKeyStr), std::move(prefixDbStr));
     } else {
-      kvStoreClient_->clearKey(
-          AreaId{area},
-          prefixStr,
-          writeThriftObjStr(std::move(deletedPrefixDb), serializer_),
-          ttlKeyInKvStore_);
+      kvStoreClient_->persistKey(
+          AreaId{area}, bucketKeyStr, prefixDbStr, ttlKeyInKvStore_);
     }
+    return;
+  }
 
-    VLOG(1) << "[Prefix Withdraw] "
-            << "Area: " << area << ", " << toString(*entry.prefix_ref());
-    fb303::fbData->addStatValue(
-        "prefix_manager.route_withdraws", 1, fb303::SUM);
+  // Remove bucket from KvStore and flood deletion by setting deleted value.
+  auto deletedPrefixDbStr = writeThriftObjStrBuffered(
+      createPrefixDb(nodeId_, {}, area, true /* withdraw */), serializer_);
+  if (config_->getConfig().get_enable_kvstore_request_queue()) {
+    shard.kvRequestBatch.unsetKey(
+        std::move(bucketKeyStr), std::move(deletedPrefixDbStr));
+  } else {
+    kvStoreClient_->clearKey(
+        AreaId{area}, bucketKeyStr, deletedPrefixDbStr, ttlKeyInKvStore_);
   }
 }
 
@@ -581,7 +749,7 @@ PrefixManager::triggerInitialPrefixDbSync() {
     // Trigger initial syncKvStore(), after receiving prefixes of all expected
     // types and all inital prefix keys from KvStore.
     LOG(INFO) << "[Initialization] Triggering initial syncKvStore().";
-    syncKvStore();
+    syncKvStore(true /* fullSync */);
   }
 }
 
@@ -663,73 +831,47 @@ getBestPrefixEntry(
 } // namespace
 
 void
-PrefixManager::syncKvStore() {
+PrefixManager::syncKvStore(bool fullSync) {
   VLOG(1) << "[KvStore Sync] Syncing " << pendingUpdates_.size()
-          << " pending updates.";
+          << " pending updates" << (fullSync ? " with full sync." : ".");
   DecisionRouteUpdate routeUpdatesOut;
-  size_t receivedPrefixCnt = 0;
   size_t syncedPrefixCnt = 0;
-  size_t awaitingPrefixCnt = 0;
-
-  // Withdraw prefixes that no longer exist.
-  for (auto const& prefix : pendingUpdates_.getChangedPrefixes()) {
-    auto it = prefixMap_.find(prefix);
-    if (it == prefixMap_.end()) {
-      // Delete prefixes that do not exist in prefixMap_.
-      VLOG(1) << "Deleting keys for "
-              << folly::IPAddress::networkToString(prefix);
-      deletePrefixKeysInKvStore(prefix, routeUpdatesOut);
-      advertisedPrefixes_.erase(prefix);
-      ++syncedPrefixCnt;
-    }
-  }
-
-  for (const auto& [prefix, prefixEntries] : prefixMap_) {
-    receivedPrefixCnt += prefixEntries.size();
-
-    // Check if prefix is updated and ready to be advertised.
-    auto [_, bestEntry] =
-        getBestPrefixEntry(prefixEntries, preferOpenrOriginatedRoutes_);
-    const auto& labelRef = bestEntry.tPrefixEntry->prependLabel_ref();
-    bool hasPrefixUpdate = pendingUpdates_.hasPrefix(prefix);
-    bool haslabelUpdate =
-        labelRef.has_value() ? pendingUpdates_.hasLabel(*labelRef) : false;
-    bool readyToBeAdvertised = prefixEntryReadyToBeAdvertised(bestEntry);
-    bool needToAdvertise =
-        ((hasPrefixUpdate or haslabelUpdate) and readyToBeAdvertised);
-    // Get route updates from updated prefix entry.
-    if (hasPrefixUpdate) {
-      populateRouteUpdates(prefix, bestEntry, routeUpdatesOut);
-    }
-    if (needToAdvertise) {
-      VLOG(1) << fmt::format(
-          "Adding/updating keys for {}",
-          folly::IPAddress::networkToString(prefix));
-      updatePrefixKeysInKvStore(prefix, bestEntry);
-      advertisedPrefixes_[prefix] = bestEntry;
-      ++syncedPrefixCnt;
-      continue;
-    } else if (readyToBeAdvertised) {
-      // Skip still-ready-to-be and previously advertised prefix.
-      CHECK(advertisedPrefixes_.count(prefix));
-      continue;
-    }
 
-    // The prefix is awaiting to be advertised.
-    ++awaitingPrefixCnt;
-
-    // Check if previously advertised prefix is no longer ready to be
-    // advertised.
-    if (advertisedPrefixes_.count(prefix) and
-        (not prefixEntryReadyToBeAdvertised(advertisedPrefixes_.at(prefix)))) {
-      VLOG(1) << fmt::format(
-          "Deleting advertised keys for {}",
-          folly::IPAddress::networkToString(prefix));
-      deletePrefixKeysInKvStore(prefix, routeUpdatesOut);
-      advertisedPrefixes_.erase(prefix);
-      ++syncedPrefixCnt;
+  if (fullSync) {
+    // Withdraw advertised prefixes that no longer exist and reconcile all
+    // existing ones
+    std::vector<folly::CIDRNetwork> withdrawnPrefixes;
+    for (const auto& [prefix, _] : advertisedPrefixes_) {
+      if (not prefixMap_.count(prefix)) {
+        withdrawnPrefixes.emplace_back(prefix);
+      }
     }
-  } // for
+    for (const auto& prefix : withdrawnPrefixes) {
+      syncPrefix(prefix, routeUpdatesOut, syncedPrefixCnt);
+    }
+    for (const auto& [prefix, _] : prefixMap_) {
+      syncPrefix(prefix, routeUpdatesOut, syncedPrefixCnt);
+    }
+  } else {
+    // Pre-size for bulk updates, e.g. full table of redistributed routes
+    const auto numChanged = pendingUpdates_.getChangedPrefixes().size();
+    advertisedPrefixes_.reserve(advertisedPrefixes_.size() + numChanged);
+    keysInKvStore_.reserve(keysInKvStore_.size() + numChanged);
+
+    // Changed prefixes, and prefixes whose prepend label route got
+    // programmed or removed
+    std::unordered_set<folly::CIDRNetwork> prefixesToSync{
+        pendingUpdates_.getChangedPrefixes()};
+    for (const auto& label : pendingUpdates_.getChangedLabels()) {
+      auto it = labelToPrefixes_.find(label);
+      if (it != labelToPrefixes_.end()) {
+        prefixesToSync.insert(it->second.begin(), it->second.end());
+      }
+    }
+    for (const auto& prefix : prefixesToSync) {
+      syncPrefix(prefix, routeUpdatesOut, syncedPrefixCnt);
+    }
+  }
 
   // Reset pendingUpdates_ since all pending updates are processed.
   pendingUpdates_.clear();
@@ -744,17 +886,146 @@ PrefixManager::syncKvStore() {
   VLOG(1) << fmt::format(
       "[KvStore Sync] Updated {} prefixes in KvStore; {} more awaiting FIB-ACK.",
       syncedPrefixCnt,
-      awaitingPrefixCnt);
+      awaitingPrefixes_.size());
+
+  // Schedule next audit
+  if (fullSync) {
+    fb303::fbData->addStatValue(
+        "prefix_manager.kvstore_full_sync", 1, fb303::COUNT);
+    auditKvStoreTimer_->scheduleTimeout(
+        Constants::kPrefixKvStoreAuditInterval);
+  }
 
   // Update flat counters
   fb303::fbData->setCounter(
-      "prefix_manager.received_prefixes", receivedPrefixCnt);
-  // TODO: report per-area advertised prefixes if openr is running in
-  // multi-areas.
+      "prefix_manager.received_prefixes", numPrefixEntries_);
   fb303::fbData->setCounter(
       "prefix_manager.advertised_prefixes", advertisedPrefixes_.size());
   fb303::fbData->setCounter(
-      "prefix_manager.awaiting_prefixes", awaitingPrefixCnt);
+      "prefix_manager.awaiting_prefixes", awaitingPrefixes_.size());
+}
+
+void
+PrefixManager::syncPrefix(
+    const folly::CIDRNetwork& prefix,
+    DecisionRouteUpdate& routeUpdatesOut,
+    size_t& syncedPrefixCnt) {
+  auto it = prefixMap_.find(prefix);
+  if (it == prefixMap_.end()) {
+    // Delete prefixes that do not exist in prefixMap_.
+    VLOG(1) << "Deleting keys for "
+            << folly::IPAddress::networkToString(prefix);
+    deletePrefixKeysInKvStore(prefix, routeUpdatesOut);
+    advertisedPrefixes_.erase(prefix);
+    awaitingPrefixes_.erase(prefix);
+    updatePrefixLabel(prefix, std::nullopt);
+    ++syncedPrefixCnt;
+    return;
+  }
+
+  // Check if prefix is updated and ready to be advertised.
+  auto [_, bestEntry] =
+      getBestPrefixEntry(it->second, preferOpenrOriginatedRoutes_);
+  const auto& labelRef = bestEntry.tPrefixEntry->prependLabel_ref();
+  updatePrefixLabel(prefix, labelRef.to_optional());
+
+  bool hasPrefixUpdate = pendingUpdates_.hasPrefix(prefix);
+  bool haslabelUpdate =
+      labelRef.has_value() ? pendingUpdates_.hasLabel(*labelRef) : false;
+  bool readyToBeAdvertised = prefixEntryReadyToBeAdvertised(bestEntry);
+  // ATTN: ready but not yet advertised prefix is only expected on full sync
+  bool needToAdvertise = readyToBeAdvertised and
+      (hasPrefixUpdate or haslabelUpdate or
+       advertisedPrefixes_.count(prefix) == 0);
+  // Get route updates from updated prefix entry.
+  if (hasPrefixUpdate) {
+    populateRouteUpdates(prefix, bestEntry, routeUpdatesOut);
+  }
+  if (needToAdvertise) {
+    VLOG(1) << fmt::format(
+        "Adding/updating keys for {}",
+        folly::IPAddress::networkToString(prefix));
+    updatePrefixKeysInKvStore(prefix, bestEntry);
+    advertisedPrefixes_[prefix] = bestEntry;
+    awaitingPrefixes_.erase(prefix);
+    ++syncedPrefixCnt;
+    return;
+  } else if (readyToBeAdvertised) {
+    // Skip still-ready-to-be and previously advertised prefix.
+    return;
+  }
+
+  // The prefix is awaiting to be advertised.
+  awaitingPrefixes_.insert(prefix);
+
+  // Check if previously advertised prefix is no longer ready to be
+  // advertised.
+  auto advertisedIt = advertisedPrefixes_.find(prefix);
+  if (advertisedIt != advertisedPrefixes_.end() and
+      (not prefixEntryReadyToBeAdvertised(advertisedIt->second))) {
+    VLOG(1) << fmt::format(
+        "Deleting advertised keys for {}",
+        folly::IPAddress::networkToString(prefix));
+    deletePrefixKeysInKvStore(prefix, routeUpdatesOut);
+    advertisedPrefixes_.erase(advertisedIt);
+    ++syncedPrefixCnt;
+  }
+}
+
+void
+PrefixManager::syncAreaShard(const std::string& area) {
+  auto& shard = areaShards_.at(area);
+  VLOG(1) << fmt::format(
+      "[KvStore Sync] Syncing {} pending prefixes of area {}.",
+      shard.pendingPrefixes.size(),
+      area);
+
+  for (const auto& [prefix, tPrefixEntry] : shard.pendingPrefixes) {
+    if (tPrefixEntry and addKvStoreKeyHelper(area, prefix, tPrefixEntry)) {
+      shard.advertisedPrefixes.emplace(prefix);
+    } else if (shard.advertisedPrefixes.erase(prefix)) {
+      // withdrawn, or rejected by area policy after being advertised
+      deleteKvStoreKeyHelper(area, prefix);
+    }
+  }
+  shard.pendingPrefixes.clear();
+
+  // Rewrite bucket keys whose prefixes changed
+  for (const auto bucket : shard.dirtyBuckets) {
+    syncPrefixDbBucket(area, bucket);
+  }
+  shard.dirtyBuckets.clear();
+
+  // Send key updates of all synced prefixes to KvStore in one go
+  if (shard.kvRequestBatch.size()) {
+    kvRequestQueue_.push(std::exchange(
+        shard.kvRequestBatch, BatchKeyValueRequest(AreaId{area})));
+  }
+
+  fb303::fbData->setCounter(
+      fmt::format("prefix_manager.advertised_prefixes.{}", area),
+      shard.advertisedPrefixes.size());
+}
+
+void
+PrefixManager::updatePrefixLabel(
+    const folly::CIDRNetwork& prefix, std::optional<int32_t> label) {
+  auto it = prefixToLabel_.find(prefix);
+  if (it != prefixToLabel_.end()) {
+    if (label.has_value() and it->second == *label) {
+      return;
+    }
+    auto labelIt = labelToPrefixes_.find(it->second);
+    labelIt->second.erase(prefix);
+    if (labelIt->second.empty()) {
+      labelToPrefixes_.erase(labelIt);
+    }
+    prefixToLabel_.erase(it);
+  }
+  if (label.has_value()) {
+    prefixToLabel_.emplace(prefix, *label);
+    labelToPrefixes_[*label].insert(prefix);
+  }
 }
 
 folly::SemiFuture<bool>
@@ -1246,6 +1517,9 @@ PrefixManager::advertisePrefixesImpl(
       ? applyOriginationPolicy(prefixEntries, *policyName)
       : prefixEntries;
 
+  // Pre-size for bulk injection, e.g. full table of redistributed routes
+  prefixMap_.reserve(prefixMap_.size() + postOriginationPrefixes.size());
+
   bool updated{false};
   for (const auto& entry : postOriginationPrefixes) {
     const auto& type = *entry.tPrefixEntry->type_ref();
@@ -1256,7 +1530,9 @@ PrefixManager::advertisePrefixesImpl(
     //       used intentionally.
     auto [it, inserted] = prefixMap_[prefixCidr].emplace(type, entry);
 
-    if (not inserted) {
+    if (inserted) {
+      ++numPrefixEntries_;
+    } else {
       if (it->second == entry) {
         // Case 1: ignore SAME `PrefixEntry`
         continue;
@@ -1298,6 +1574,7 @@ PrefixManager::withdrawPrefixesImpl(
     // ONLY populate changed collection when successfully erased key
     if (typeIt != prefixMap_.end() and typeIt->second.erase(type)) {
       updated = true;
+      --numPrefixEntries_;
       // store pendingUpdate for batch processing
       pendingUpdates_.addPrefixChange(prefixCidr);
       // clean up data structure
@@ -1335,6 +1612,7 @@ PrefixManager::withdrawPrefixEntriesImpl(
     // ONLY populate changed collection when successfully erased key
     if (typeIt != prefixMap_.end() and typeIt->second.erase(type)) {
       updated = true;
+      --numPrefixEntries_;
       // store pendingUpdate for batch processing
       pendingUpdates_.addPrefixChange(prefixEntry.network);
       // clean up data structure
@@ -1352,6 +1630,72 @@ PrefixManager::withdrawPrefixEntriesImpl(
   return updated;
 }
 
+bool
+PrefixManager::advertisePrefixBatchImpl(
+    const PrefixBatch& batch,
+    const std::unordered_set<std::string>& dstAreas,
+    const std::optional<std::string>& policyName) {
+  if (batch.empty()) {
+    return false;
+  }
+
+  // ATTN: advertisement to KvStore is keyed by thrift::PrefixEntry, hence
+  //       attributes shared in batch are expanded per route here.
+  std::vector<PrefixEntry> toAddOrUpdate;
+  toAddOrUpdate.reserve(batch.size());
+  for (size_t i = 0; i < batch.size(); ++i) {
+    auto tPrefixEntry =
+        std::make_shared<thrift::PrefixEntry>(batch.getAttributes(i));
+    tPrefixEntry->prefix_ref() = toIpPrefix(batch.getNetwork(i));
+    auto dstAreasCp = dstAreas;
+    std::optional<std::unordered_set<thrift::NextHopThrift>> nexthops;
+    if (auto batchNexthops = batch.getNextHops(i)) {
+      nexthops = *batchNexthops;
+    }
+    toAddOrUpdate.emplace_back(
+        std::move(tPrefixEntry), std::move(dstAreasCp), std::move(nexthops));
+  }
+  return advertisePrefixesImpl(toAddOrUpdate, policyName);
+}
+
+bool
+PrefixManager::withdrawPrefixBatchImpl(const PrefixBatch& batch) {
+  bool updated{false};
+  for (size_t i = 0; i < batch.size(); ++i) {
+    const auto& type = *batch.getAttributes(i).type_ref();
+    const auto& prefixCidr = batch.getNetwork(i);
+
+    // Remove prefix from originated prefixes map, regardless of policy
+    auto originatedIt = originatedPrefixMap_.find(prefixCidr);
+    if (originatedIt != originatedPrefixMap_.end()) {
+      originatedIt->second.erase(type);
+      if (originatedIt->second.empty()) {
+        originatedPrefixMap_.erase(originatedIt);
+      }
+    }
+
+    // ONLY populate changed collection when successfully erased key
+    auto typeIt = prefixMap_.find(prefixCidr);
+    if (typeIt != prefixMap_.end() and typeIt->second.erase(type)) {
+      updated = true;
+      --numPrefixEntries_;
+      // store pendingUpdate for batch processing
+      pendingUpdates_.addPrefixChange(prefixCidr);
+      // clean up data structure
+      if (typeIt->second.empty()) {
+        prefixMap_.erase(typeIt);
+      }
+    }
+  }
+
+  if (updated) {
+    // schedule `syncKvStore` after throttled timeout
+    syncKvStoreThrottled_->operator()();
+  }
+
+  return updated;
+}
+
 bool
 PrefixManager::syncPrefixesByTypeImpl(
     thrift::PrefixType type,
@@ -1402,30 +1746,30 @@ void
 PrefixManager::aggregatesToAdvertise(const folly::CIDRNetwork& prefix) {
   // ATTN: ignore attribute-ONLY update for existing RIB entries
   //       as it won't affect `supporting_route_cnt`
-  auto [ribPrefixIt, inserted] =
-      ribPrefixDb_.emplace(prefix, std::vector<folly::CIDRNetwork>());
-  if (not inserted) {
+  if (ribPrefixDb_.count(prefix)) {
     return;
   }
 
-  for (auto& [network, route] : originatedPrefixDb_) {
-    // folly::CIDRNetwork.first -> IPAddress
-    // folly::CIDRNetwork.second -> cidr length
-    if (not prefix.first.inSubnet(network.first, network.second)) {
-      continue;
-    }
+  // originated prefixes covering the route
+  auto networks = originatedPrefixTrie_.getSuperPrefixes(prefix);
+  if (networks.empty()) {
+    return;
+  }
+
+  for (auto const& network : networks) {
+    auto& route = originatedPrefixDb_.at(network);
 
     VLOG(1) << "[Route Origination] Adding supporting route "
             << folly::IPAddress::networkToString(prefix)
             << " for originated route "
             << folly::IPAddress::networkToString(network);
 
-    // reverse mapping: RIB prefixEntry -> OriginatedPrefixes
-    ribPrefixIt->second.emplace_back(network);
-
     // mapping: OriginatedPrefix -> RIB prefixEntries
     route.supportingRoutes.emplace(prefix);
   }
+
+  // reverse mapping: RIB prefixEntry -> OriginatedPrefixes
+  ribPrefixDb_.emplace(prefix, std::move(networks));
 }
 
 void
@@ -1468,7 +1812,8 @@ PrefixManager::processOriginatedPrefixes() {
           allAreaIds());
       if (route.originatedPrefix.install_to_fib_ref().has_value() &&
           *route.originatedPrefix.install_to_fib_ref()) {
-        advertisedPrefixes.back().nexthops = route.unicastEntry.nexthops;
+        advertisedPrefixes.back().nexthops =
+            route.unicastEntry.nexthops.asSet();
       }
       LOG(INFO) << "[Route Origination] Advertising originated route "
                 << folly::IPAddress::networkToString(network);
@@ -12,7 +12,9 @@
 #include <folly/futures/Future.h>
 
 #include <openr/common/AsyncThrottle.h>
+#include <openr/common/MemoryPressure.h>
 #include <openr/common/OpenrEventBase.h>
+#include <openr/common/PrefixTrie.h>
 #include <openr/common/Types.h>
 #include <openr/common/Util.h>
 #include <openr/config-store/PersistentStore.h>
@@ -48,6 +50,11 @@ class PrefixManagerPendingUpdates {
     return changedPrefixes_;
   }
 
+  const std::unordered_set<int32_t>&
+  getChangedLabels() {
+    return changedLabels_;
+  }
+
   bool
   hasPrefix(const folly::CIDRNetwork& prefix) {
     return changedPrefixes_.count(prefix) > 0;
@@ -218,7 +225,7 @@ class PrefixManager final : public OpenrEventBase {
 
  private:
   // Process thrift publication from KvStore.
-  void processPublication(thrift::Publication&& thriftPub);
+  void processPublication(thrift::Publication const& thriftPub);
 
   /*
    * Private helpers to update `prefixMap_`
@@ -244,6 +251,11 @@ class PrefixManager final : public OpenrEventBase {
   bool withdrawPrefixesImpl(
       const std::vector<thrift::PrefixEntry>& tPrefixEntries);
   bool withdrawPrefixEntriesImpl(const std::vector<PrefixEntry>& prefixEntries);
+  bool advertisePrefixBatchImpl(
+      const PrefixBatch& batch,
+      const std::unordered_set<std::string>& dstAreas,
+      const std::optional<std::string>& policyName = std::nullopt);
+  bool withdrawPrefixBatchImpl(const PrefixBatch& batch);
   bool withdrawPrefixesByTypeImpl(thrift::PrefixType type);
   bool syncPrefixesByTypeImpl(
       thrift::PrefixType type,
@@ -272,25 +284,67 @@ class PrefixManager final : public OpenrEventBase {
    * Util function to interact with KvStore to advertise/withdraw prefixes
    * ATTN: syncKvStore() has throttled version `syncKvStoreThrottled_` to
    *       batch processing updates
+   *
+   * Only prefixes in `pendingUpdates_` (or the ones whose prepend label
+   * changed) are synced, unless `fullSync` is set. Full sync reconciles all
+   * prefixes and is performed on startup and periodically as an audit.
+   */
+  void syncKvStore(bool fullSync = false);
+
+  // Advertise/withdraw keys of one prefix based on its best entry. Called by
+  // syncKvStore() for each prefix to be synced.
+  void syncPrefix(
+      const folly::CIDRNetwork& prefix,
+      DecisionRouteUpdate& routeUpdatesOut,
+      size_t& syncedPrefixCnt);
+
+  /*
+   * Advertise/withdraw pending prefix keys of one area into KvStore. Called
+   * via throttle of the area shard, independently of other areas.
    */
-  void syncKvStore();
+  void syncAreaShard(const std::string& area);
+
+  // Update prepend label of the best entry of a prefix in `labelToPrefixes_`
+  void updatePrefixLabel(
+      const folly::CIDRNetwork& prefix, std::optional<int32_t> label);
 
   // Update KvStore keys of one prefix entry.
   void updatePrefixKeysInKvStore(
       const folly::CIDRNetwork& prefix, const PrefixEntry& prefixEntry);
 
-  // Add KvStore keys of one prefix entry.
-  // @return: set of the areas that this prefix will advertise to.
-  std::unordered_set<std::string> addKvStoreKeyHelper(const PrefixEntry& entry);
-
   // Delete KvStore keys of one prefix entry.
   void deletePrefixKeysInKvStore(
       const folly::CIDRNetwork& prefix, DecisionRouteUpdate& routeUpdatesOut);
 
-  // Delete KvStore keys form the areas for one prefix entry.
-  void deleteKvStoreKeyHelper(
+  // Key string of prefix key in the configured format
+  std::string getPrefixKeyStr(const PrefixKey& prefixKey) const;
+
+  // Queue key of prefix in the area shard to be advertised with the entry,
+  // or to be withdrawn if entry is null.
+  void queueAreaKeyUpdate(
+      const std::string& area,
       const folly::CIDRNetwork& prefix,
-      const std::unordered_set<std::string>& deletedArea);
+      std::shared_ptr<thrift::PrefixEntry> tPrefixEntry);
+
+  // Add KvStore key of one prefix entry into the area, after area policy.
+  // @return: false if prefix entry is rejected by area policy.
+  bool addKvStoreKeyHelper(
+      const std::string& area,
+      const folly::CIDRNetwork& prefix,
+      const std::shared_ptr<thrift::PrefixEntry>& tPrefixEntry);
+
+  // Delete KvStore key of one prefix from the area.
+  void deleteKvStoreKeyHelper(
+      const std::string& area, const folly::CIDRNetwork& prefix);
+
+  // Advertise bucket key of prefix database with prefixes of the bucket in
+  // the area, or withdraw it if none is left. ONLY with prefix db buckets.
+  void syncPrefixDbBucket(const std::string& area, uint32_t bucket);
+
+  // Reconcile own bucket key of prefix database received from KvStore, e.g.
+  // advertised by previous incarnation
+  void processPrefixDbBucketKey(
+      const std::string& area, uint32_t bucket, const std::string& value);
 
   /*
    * Get route updates of prefixEntry.
@@ -390,6 +444,9 @@ class PrefixManager final : public OpenrEventBase {
   std::unique_ptr<AsyncThrottle> syncKvStoreThrottled_;
   std::unique_ptr<folly::AsyncTimeout> initialSyncKvStoreTimer_;
 
+  // Timer for periodic full sync of all prefixes with KvStore
+  std::unique_ptr<folly::AsyncTimeout> auditKvStoreTimer_;
+
   // kvStoreClient for persisting our prefix db
   std::unique_ptr<KvStoreClientInternal> kvStoreClient_{nullptr};
 
@@ -401,8 +458,18 @@ class PrefixManager final : public OpenrEventBase {
       folly::CIDRNetwork,
       std::unordered_map<thrift::PrefixType, PrefixEntry>>
       prefixMap_;
+  // Number of entries (of all types) in `prefixMap_`
+  size_t numPrefixEntries_{0};
   // Advertised prefixes in KvStore and associated best PrefixEntry.
   std::unordered_map<folly::CIDRNetwork, PrefixEntry> advertisedPrefixes_;
+  // Prefixes whose best entry is not ready to be advertised yet
+  std::unordered_set<folly::CIDRNetwork> awaitingPrefixes_;
+
+  // Prepend label of best entry of prefixes, to look up prefixes to sync when
+  // label route is programmed or removed
+  std::unordered_map<int32_t, std::unordered_set<folly::CIDRNetwork>>
+      labelToPrefixes_;
+  std::unordered_map<folly::CIDRNetwork, int32_t> prefixToLabel_;
 
   // For prefixes came from PrefixEvent with an origination policy,
   // store the pre-policy version in originatedPrefixMap_.
@@ -417,21 +484,52 @@ class PrefixManager final : public OpenrEventBase {
   // the serializer/deserializer helper we'll be using
   apache::thrift::CompactSerializer serializer_;
 
-  // This collection serves for easy clean up when certain prefix is withdrawn.
-  // `PrefixManager` will advertise prefixes based on best-route-selection
-  // process. With multi-area support, one prefix will map to multiple
-  // key-advertisement in `KvStore`.
+  // Prefixes with best entry advertised. Used to withdraw the unicast route
+  // from Decision when certain prefix is withdrawn.
   struct AdervertiseStatus {
     // If the prefix was sent for programming.
     bool installedToFib{false};
-    // Saving the set of areas this prefix advertised to
-    std::unordered_set<std::string> areas;
   };
   std::unordered_map<folly::CIDRNetwork, AdervertiseStatus> keysInKvStore_{};
 
   // store pending updates from advertise/withdraw operation
   detail::PrefixManagerPendingUpdates pendingUpdates_;
 
+  /*
+   * With multi-area support, one prefix maps to one key-advertisement per
+   * area in `KvStore`. Area policy, key serialization and KvStore updates of
+   * each area are carried out by its own shard, so that a burst of updates
+   * into one area doesn't hold back advertisements into the others.
+   *
+   * syncKvStore() decides on the best entry of prefixes, and hands the
+   * resulting key updates over to the shards of affected areas.
+   */
+  struct AreaShard {
+    explicit AreaShard(const std::string& area)
+        : kvRequestBatch(AreaId{area}) {}
+
+    // Prefixes with key advertised into this area
+    std::unordered_set<folly::CIDRNetwork> advertisedPrefixes;
+    // Prefixes whose key is to be synced, with the pre-policy entry to
+    // advertise. Null entry withdraws the key.
+    std::unordered_map<
+        folly::CIDRNetwork,
+        std::shared_ptr<thrift::PrefixEntry>>
+        pendingPrefixes;
+    // Post-policy entries of advertised prefixes per bucket key, and buckets
+    // whose key is to be rewritten. ONLY used with prefix db buckets.
+    std::unordered_map<
+        uint32_t /* bucket */,
+        std::map<folly::CIDRNetwork, thrift::PrefixEntry>>
+        bucketEntries;
+    std::unordered_set<uint32_t> dirtyBuckets;
+    // Key updates to KvStore (via kvRequestQueue_) collected while syncing
+    BatchKeyValueRequest kvRequestBatch;
+    // Throttled version of syncAreaShard()
+    std::unique_ptr<AsyncThrottle> syncThrottled;
+  };
+  std::unordered_map<std::string, AreaShard> areaShards_;
+
   std::unique_ptr<PolicyManager> policyManager_{nullptr};
 
   /*
@@ -504,6 +602,18 @@ class PrefixManager final : public OpenrEventBase {
    */
   bool enableNewPrefixFormat_{false};
 
+  /*
+   * Advertise prefix keys in compact format, which takes precedence over
+   * `enableNewPrefixFormat_`
+   */
+  bool enableCompactPrefixKey_{false};
+
+  /*
+   * Number of bucket keys prefixes of each area are packed into. 0 advertises
+   * one key per prefix.
+   */
+  uint32_t prefixDbBuckets_{0};
+
   /*
    * prefixes to be originated from prefix-manager
    * ATTN: to support quick information retrieval, cache the mapping:
@@ -512,8 +622,12 @@ class PrefixManager final : public OpenrEventBase {
    */
   std::unordered_map<folly::CIDRNetwork, OriginatedRoute> originatedPrefixDb_;
 
+  // Originated prefixes in a trie, to look up the ones covering a FIB route
+  // in O(prefix-length)
+  PrefixTrie originatedPrefixTrie_;
+
   /*
-   * prefixes received from OpenR/Fib.
+   * prefixes received from OpenR/Fib, which support any originated prefix.
    * ATTN: to avoid loop through ALL entries inside `originatedPrefixes`,
    *       cache the reverse mapping:
    *
@@ -556,6 +670,9 @@ class PrefixManager final : public OpenrEventBase {
    * the concept of `RIB` for simplicity).
    */
   std::unordered_set<thrift::PrefixType> uninitializedPrefixTypes_{};
+
+  // drops memoized policy results under memory pressure
+  std::unique_ptr<MemoryPressure::Shedder> memoryShedder_;
 }; // PrefixManager
 
 } // namespace openr
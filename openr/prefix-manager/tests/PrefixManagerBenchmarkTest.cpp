@@ -5,6 +5,8 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <sys/resource.h>
+
 #include <folly/Benchmark.h>
 #include <folly/init/Init.h>
 #include <openr/config/tests/Utils.h>
@@ -12,12 +14,49 @@
 #include <openr/prefix-manager/PrefixManager.h>
 #include <openr/tests/mocks/PrefixGenerator.h>
 
+/*
+ * Like BENCHMARK_NAMED_PARAM(), but reports custom counters through
+ * folly::UserCounters
+ */
+#define BENCHMARK_COUNTERS_NAME_PARAM(name, counters, param_name, ...) \
+  BENCHMARK_IMPL_COUNTERS(                                             \
+      FB_CONCATENATE(name, FB_CONCATENATE(_, param_name)),             \
+      FOLLY_PP_STRINGIZE(name) "(" FOLLY_PP_STRINGIZE(param_name) ")", \
+      counters,                                                        \
+      iters,                                                           \
+      unsigned,                                                        \
+      iters) {                                                         \
+    name(counters, iters, ##__VA_ARGS__);                              \
+  }
+
 namespace detail {
 
 // interval for periodic sync
 const std::chrono::seconds kDbSyncIntervalOverride(10000);
 // Prefix length of a subnet
 static const uint8_t kBitMaskLen = 128;
+// Name of area import policy applied on cross-area redistribution
+const std::string kAreaPolicyName{"area_policy"};
+
+// Peak resident set size of the process in KB
+int64_t
+getPeakRssKb() {
+  struct rusage usage;
+  CHECK_EQ(0, getrusage(RUSAGE_SELF, &usage));
+  return usage.ru_maxrss;
+}
+
+// CPU time (user + system) consumed by this process
+std::chrono::microseconds
+getProcessCpuTime() {
+  struct rusage usage;
+  CHECK_EQ(0, getrusage(RUSAGE_SELF, &usage));
+  auto toUs = [](struct timeval const& tv) {
+    return std::chrono::seconds(tv.tv_sec) +
+        std::chrono::microseconds(tv.tv_usec);
+  };
+  return toUs(usage.ru_utime) + toUs(usage.ru_stime);
+}
 
 } // namespace detail
 
@@ -25,9 +64,10 @@ namespace openr {
 
 class PrefixManagerBenchmarkTestFixture {
  public:
-  explicit PrefixManagerBenchmarkTestFixture(const std::string& nodeId) {
-    // construct basic `OpenrConfig`
-    auto tConfig = getBasicOpenrConfig(nodeId);
+  explicit PrefixManagerBenchmarkTestFixture(const std::string& nodeId)
+      : PrefixManagerBenchmarkTestFixture(getBasicOpenrConfig(nodeId)) {}
+
+  explicit PrefixManagerBenchmarkTestFixture(thrift::OpenrConfig tConfig) {
     tConfig.enable_kvstore_request_queue_ref() = true;
     tConfig.kvstore_config_ref()->sync_interval_s_ref() =
         ::detail::kDbSyncIntervalOverride.count();
@@ -77,6 +117,34 @@ class PrefixManagerBenchmarkTestFixture {
     return prefixGenerator_;
   }
 
+  // Inject route update as programmed by Fib
+  void
+  pushFibRouteUpdate(DecisionRouteUpdate&& routeUpdate) {
+    fibRouteUpdatesQueue_.push(std::move(routeUpdate));
+  }
+
+  // Wait until `num` prefix keys are advertised into KvStore across all areas
+  void
+  waitForPrefixKeys(uint32_t num) {
+    uint32_t total{0};
+    auto kvStoreUpdatesQ = kvStoreWrapper_->getReader();
+    while (total < num) {
+      auto thriftPub = kvStoreUpdatesQ.get();
+      if (not thriftPub.hasValue() or
+          not thriftPub.value().tPublication) {
+        continue;
+      }
+      for (const auto& [key, tVal] :
+           *thriftPub.value().tPublication->keyVals_ref()) {
+        // skip ttl updates
+        if (tVal.value_ref().has_value() and
+            key.find(Constants::kPrefixDbMarker.toString()) == 0) {
+          ++total;
+        }
+      }
+    }
+  }
+
   void
   checkPrefixesInKvStore(uint32_t num) {
     while (true) {
@@ -107,10 +175,10 @@ class PrefixManagerBenchmarkTestFixture {
       // stop measuring time as this is just parsing
       suspender.rehire();
       if (not checkDeletion) {
-        total += thriftPub.value().tPublication.keyVals_ref()->size();
+        total += thriftPub.value().tPublication->keyVals_ref()->size();
       } else {
         for (const auto& [key, tVal] :
-             *thriftPub.value().tPublication.keyVals_ref()) {
+             *thriftPub.value().tPublication->keyVals_ref()) {
           if (auto value = tVal.value_ref()) {
             const auto prefixDb =
                 readThriftObjStr<thrift::PrefixDatabase>(*value, serializer_);
@@ -248,6 +316,92 @@ BM_PrefixManagerWithdrawPrefixes(
   }
 }
 
+/*
+ * Config with `numOfAreas` areas, each of them importing redistributed routes
+ * through the same area policy
+ */
+thrift::OpenrConfig
+getMultiAreaConfig(const std::string& nodeId, uint32_t numOfAreas) {
+  std::vector<thrift::AreaConfig> areas;
+  for (uint32_t i = 0; i < numOfAreas; ++i) {
+    areas.emplace_back(createAreaConfig(
+        fmt::format("area{}", i), {".*"}, {".*"}, ::detail::kAreaPolicyName));
+  }
+  auto tConfig = getBasicOpenrConfig(nodeId, "domain", areas);
+
+  neteng::config::routing_policy::Filters propagationPolicy;
+  propagationPolicy.objects_ref()->emplace(
+      ::detail::kAreaPolicyName, neteng::config::routing_policy::Filter());
+  tConfig.area_policies_ref() = neteng::config::routing_policy::PolicyConfig();
+  tConfig.area_policies_ref()->filters_ref() =
+      neteng::config::routing_policy::PolicyFilters();
+  tConfig.area_policies_ref()->filters_ref()->routePropagationPolicy_ref() =
+      std::move(propagationPolicy);
+  return tConfig;
+}
+
+/*
+ * Benchmark test for cross-area redistribution of programmed routes:
+ * Test setup:
+ *  - Spawn PrefixManager with `numOfAreas` areas, all with an area policy
+ *  - Generate `numOfRoutes` routes learnt from the first area
+ * Benchmark:
+ *  - Inject routes through Fib route updates and wait until they are
+ *    redistributed into KvStore of all other areas
+ * Counters:
+ *  - Peak memory of the process, and CPU time spent per redistributed prefix
+ *    across all modules
+ */
+static void
+BM_PrefixManagerRedistributeRoutes(
+    folly::UserCounters& counters,
+    uint32_t iters,
+    uint32_t numOfAreas,
+    uint32_t numOfRoutes) {
+  // Spawn suspender object to NOT calculating setup time into benchmark
+  auto suspender = folly::BenchmarkSuspender();
+  CHECK_GT(numOfAreas, 1);
+
+  const std::string nodeId{"node-1"};
+  const std::string srcArea{"area0"};
+  const uint32_t numOfKeys = numOfRoutes * (numOfAreas - 1);
+  std::chrono::microseconds cpuTime{0};
+
+  for (uint32_t i = 0; i < iters; ++i) {
+    // Fresh PrefixManager for every iteration, so that all routes are new
+    auto testFixture = std::make_unique<PrefixManagerBenchmarkTestFixture>(
+        getMultiAreaConfig(nodeId, numOfAreas));
+
+    auto nh = createNextHop(
+        toBinaryAddress(folly::IPAddress("fe80::2")), "iface", 1);
+    nh.area_ref() = srcArea;
+    DecisionRouteUpdate routeUpdate;
+    routeUpdate.type = DecisionRouteUpdate::FULL_SYNC;
+    for (auto& prefixEntry : generatePrefixEntries(
+             numOfRoutes, testFixture->getPrefixGenerator())) {
+      const auto prefix = toIPNetwork(*prefixEntry.prefix_ref());
+      routeUpdate.addRouteToUpdate(RibUnicastEntry(
+          prefix, {nh}, std::move(prefixEntry), srcArea, false));
+    }
+
+    // Start measuring benchmark time
+    const auto cpuTimeBefore = ::detail::getProcessCpuTime();
+    suspender.dismiss();
+
+    testFixture->pushFibRouteUpdate(std::move(routeUpdate));
+    testFixture->waitForPrefixKeys(numOfKeys);
+
+    // Stop measuring time. Fixture teardown is not measured
+    suspender.rehire();
+    cpuTime += ::detail::getProcessCpuTime() - cpuTimeBefore;
+  }
+
+  counters["cpu_ns_per_prefix"] =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(cpuTime).count() /
+      (static_cast<int64_t>(iters) * numOfKeys);
+  counters["peak_rss_kb"] = ::detail::getPeakRssKb();
+}
+
 /*
  * @first integer: number of prefixes existing inside PrefixManager
  * @second integer: number of prefixes to advertise/withdraw
@@ -277,8 +431,21 @@ BENCHMARK_NAMED_PARAM(
     BM_PrefixManagerWithdrawPrefixes, 100000_100000, 100000, 100000);
 
 /*
- * TODO: add decision route processing benchmark
+ * @first integer: number of areas
+ * @second integer: number of routes redistributed from the first area
  */
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_PrefixManagerRedistributeRoutes, counters, 2_10000, 2, 10000);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_PrefixManagerRedistributeRoutes, counters, 2_100000, 2, 100000);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_PrefixManagerRedistributeRoutes, counters, 2_500000, 2, 500000);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_PrefixManagerRedistributeRoutes, counters, 4_10000, 4, 10000);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_PrefixManagerRedistributeRoutes, counters, 4_100000, 4, 100000);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_PrefixManagerRedistributeRoutes, counters, 4_500000, 4, 500000);
 
 /*
  * TODO: add initial sync of KvStore benchmark
@@ -1105,6 +1105,55 @@ TEST_F(PrefixManagerTestFixture, PrefixUpdatesQueue) {
   }
 }
 
+/**
+ * Verify bulk routes of `PrefixBatch` are advertised and withdrawn from
+ * queue, sharing attributes across routes.
+ */
+TEST_F(PrefixManagerTestFixture, PrefixBatchUpdatesQueue) {
+  auto batch = std::make_shared<PrefixBatch>();
+  batch->reserve(2);
+  const auto attributes = batch->addAttributes(
+      createPrefixEntry(thrift::IpPrefix(), thrift::PrefixType::BGP));
+  batch->addRoute(toIPNetwork(addr7), attributes);
+  batch->addRoute(toIPNetwork(addr10), attributes);
+  EXPECT_EQ(2, batch->size());
+  EXPECT_EQ(nullptr, batch->getNextHops(0));
+
+  // ADD_PREFIXES
+  {
+    PrefixEvent event(PrefixEventType::ADD_PREFIXES, thrift::PrefixType::BGP);
+    event.prefixBatch = batch;
+    prefixUpdatesQueue.push(std::move(event));
+
+    // Wait for update in KvStore
+    auto pub = kvStoreWrapper->recvPublication();
+    EXPECT_EQ(2, pub.keyVals_ref()->size());
+
+    // Verify
+    auto prefixes = prefixManager->getPrefixes().get();
+    EXPECT_THAT(
+        *prefixes,
+        testing::UnorderedElementsAre(
+            prefixEntry7, createPrefixEntry(addr10, thrift::PrefixType::BGP)));
+  }
+
+  // WITHDRAW_PREFIXES
+  {
+    PrefixEvent event(
+        PrefixEventType::WITHDRAW_PREFIXES, thrift::PrefixType::BGP);
+    event.prefixBatch = batch;
+    prefixUpdatesQueue.push(std::move(event));
+
+    // Wait for update in KvStore (PrefixManager has processed the update)
+    auto pub = kvStoreWrapper->recvPublication();
+    EXPECT_EQ(2, pub.keyVals_ref()->size());
+
+    // Verify
+    auto prefixes = prefixManager->getPrefixes().get();
+    EXPECT_EQ(0, prefixes->size());
+  }
+}
+
 /**
  * Validate PrefixManager does not advertise prefixes with prepend labels to
  * KvStore, until receiving from Fib that associated label routes are already
@@ -1645,10 +1694,10 @@ TEST_F(PrefixManagerMultiAreaTestFixture, DecisionRouteUpdates) {
     expected.emplace(prefixKeyAreaB, expectedPrefixEntry1A);
     expected.emplace(prefixKeyAreaC, expectedPrefixEntry1A);
 
-    auto pub1 = kvStoreUpdatesQueue.get().value().tPublication;
+    auto pub1 = *kvStoreUpdatesQueue.get().value().tPublication;
     readPublication(pub1, got, gotDeleted);
 
-    auto pub2 = kvStoreUpdatesQueue.get().value().tPublication;
+    auto pub2 = *kvStoreUpdatesQueue.get().value().tPublication;
     readPublication(pub2, got, gotDeleted);
 
     EXPECT_EQ(expected, got);
@@ -1695,13 +1744,13 @@ TEST_F(PrefixManagerMultiAreaTestFixture, DecisionRouteUpdates) {
     expected.emplace(prefixKeyAreaA, expectedPrefixEntry1B);
     expected.emplace(prefixKeyAreaC, expectedPrefixEntry1B);
 
-    auto pub1 = kvStoreUpdatesQueue.get().value().tPublication;
+    auto pub1 = *kvStoreUpdatesQueue.get().value().tPublication;
     readPublication(pub1, got, gotDeleted);
 
-    auto pub2 = kvStoreUpdatesQueue.get().value().tPublication;
+    auto pub2 = *kvStoreUpdatesQueue.get().value().tPublication;
     readPublication(pub2, got, gotDeleted);
 
-    auto pub3 = kvStoreUpdatesQueue.get().value().tPublication;
+    auto pub3 = *kvStoreUpdatesQueue.get().value().tPublication;
     readPublication(pub3, got, gotDeleted);
 
     EXPECT_EQ(expected, got);
@@ -1722,10 +1771,10 @@ TEST_F(PrefixManagerMultiAreaTestFixture, DecisionRouteUpdates) {
     std::map<std::pair<std::string, std::string>, thrift::PrefixEntry> expected,
         got, gotDeleted;
 
-    auto pub1 = kvStoreUpdatesQueue.get().value().tPublication;
+    auto pub1 = *kvStoreUpdatesQueue.get().value().tPublication;
     readPublication(pub1, got, gotDeleted);
 
-    auto pub2 = kvStoreUpdatesQueue.get().value().tPublication;
+    auto pub2 = *kvStoreUpdatesQueue.get().value().tPublication;
     readPublication(pub2, got, gotDeleted);
 
     EXPECT_EQ(0, got.size());
@@ -1802,7 +1851,7 @@ TEST_F(PrefixManagerMultiAreaTestFixture, DecisionRouteNexthopUpdates) {
         got, gotDeleted;
     expected.emplace(prefixKeyAreaC, expectedPrefixEntry1A);
 
-    auto pub1 = kvStoreUpdatesQueue.get().value().tPublication;
+    auto pub1 = *kvStoreUpdatesQueue.get().value().tPublication;
     readPublication(pub1, got, gotDeleted);
 
     EXPECT_EQ(expected, got);
@@ -1813,7 +1862,7 @@ TEST_F(PrefixManagerMultiAreaTestFixture, DecisionRouteNexthopUpdates) {
   // 2. add C into ecmp group, ecmp areas = [A, B, C], best area = A
   //    => C receive withdraw
   //
-  unicast1A.nexthops.emplace(path1_2_3);
+  unicast1A.nexthops = {path1_2_1, path1_2_2, path1_2_3};
   {
     DecisionRouteUpdate routeUpdate;
     routeUpdate.addRouteToUpdate(unicast1A);
@@ -1822,7 +1871,7 @@ TEST_F(PrefixManagerMultiAreaTestFixture, DecisionRouteNexthopUpdates) {
     std::map<std::pair<std::string, std::string>, thrift::PrefixEntry> got,
         gotDeleted;
 
-    auto pub1 = kvStoreUpdatesQueue.get().value().tPublication;
+    auto pub1 = *kvStoreUpdatesQueue.get().value().tPublication;
     readPublication(pub1, got, gotDeleted);
 
     EXPECT_EQ(0, got.size());
@@ -1834,7 +1883,7 @@ TEST_F(PrefixManagerMultiAreaTestFixture, DecisionRouteNexthopUpdates) {
   // 3. withdraw B from ecmp group, ecmp areas = [A, C], best area = A
   //    => B receive update
   //
-  unicast1A.nexthops.erase(path1_2_2);
+  unicast1A.nexthops = {path1_2_1, path1_2_3};
   {
     DecisionRouteUpdate routeUpdate;
     routeUpdate.addRouteToUpdate(unicast1A);
@@ -1844,7 +1893,7 @@ TEST_F(PrefixManagerMultiAreaTestFixture, DecisionRouteNexthopUpdates) {
         got, gotDeleted;
     expected.emplace(prefixKeyAreaB, expectedPrefixEntry1A);
 
-    auto pub1 = kvStoreUpdatesQueue.get().value().tPublication;
+    auto pub1 = *kvStoreUpdatesQueue.get().value().tPublication;
     readPublication(pub1, got, gotDeleted);
 
     EXPECT_EQ(expected, got);
@@ -1885,7 +1934,7 @@ TEST_F(PrefixManagerMultiAreaTestFixture, DecisionRouteNexthopUpdates) {
     // here skip ttl updates
     int expectedPubCnt{3}, gotPubCnt{0};
     while (gotPubCnt < expectedPubCnt) {
-      auto pub = kvStoreUpdatesQueue.get().value().tPublication;
+      auto pub = *kvStoreUpdatesQueue.get().value().tPublication;
       gotPubCnt += readPublication(pub, got, gotDeleted);
     }
 
@@ -1908,7 +1957,7 @@ TEST_F(PrefixManagerMultiAreaTestFixture, DecisionRouteNexthopUpdates) {
         gotDeleted;
 
     while (gotDeleted.size() < 2) {
-      auto pub = kvStoreUpdatesQueue.get().value().tPublication;
+      auto pub = *kvStoreUpdatesQueue.get().value().tPublication;
       readPublication(pub, got, gotDeleted);
     }
 
@@ -1998,7 +2047,7 @@ class RouteOriginationFixture : public PrefixManagerMultiAreaTestFixture {
       std::unordered_set<std::pair<std::string, std::string>>& expDeleted) {
     while (exp.size() or expDeleted.size()) {
       auto pub = reader.get().value();
-      for (const auto& [key, thriftVal] : *pub.tPublication.keyVals_ref()) {
+      for (const auto& [key, thriftVal] : *pub.tPublication->keyVals_ref()) {
         if (not thriftVal.value_ref().has_value()) {
           // skip TTL update
           continue;
@@ -2009,7 +2058,7 @@ class RouteOriginationFixture : public PrefixManagerMultiAreaTestFixture {
         auto isDeleted = *db.deletePrefix_ref();
         auto prefixEntry = db.prefixEntries_ref()->at(0);
         auto prefixKeyWithArea =
-            std::make_pair(key, pub.tPublication.get_area());
+            std::make_pair(key, pub.tPublication->get_area());
         if (isDeleted and expDeleted.count(prefixKeyWithArea)) {
           VLOG(2) << fmt::format(
               "Withdraw of prefix: {} in area: {} received",
@@ -52,6 +52,12 @@ IoProvider::sendto(
   return ::sendto(sockfd, buf, len, flags, dest_addr, addrlen);
 }
 
+int
+IoProvider::recvmmsg(
+    int sockfd, struct mmsghdr* msgvec, unsigned int vlen, int flags) {
+  return ::recvmmsg(sockfd, msgvec, vlen, flags, nullptr);
+}
+
 int
 IoProvider::setsockopt(
     int sockfd, int level, int optname, const void* optval, socklen_t optlen) {
@@ -68,14 +74,16 @@ IoProvider::sendmsg(int sockfd, const struct msghdr* msg, int flags) {
   return ::sendmsg(sockfd, msg, flags);
 }
 
-std::tuple<
-    ssize_t /* size */,
-    int /* ifIndex */,
-    folly::SocketAddress /* srcAddr */,
-    int /* hopLimit */,
-    std::chrono::microseconds /* kernel timestamp */>
-IoProvider::recvMessage(
-    int fd, unsigned char* buf, int len, openr::IoProvider* ioProvider) {
+int
+IoProvider::sendmmsg(
+    int sockfd, struct mmsghdr* msgvec, unsigned int vlen, int flags) {
+  return ::sendmmsg(sockfd, msgvec, vlen, flags);
+}
+
+namespace {
+
+// Buffers to receive a message and its ancillary data into
+struct RecvBuffers {
   // the control message buffer
   // XXX: hardcoded, but this hardly should be a problem
   union {
@@ -83,39 +91,108 @@ IoProvider::recvMessage(
     struct cmsghdr align;
   } u;
 
-  // the message header to receive into
-  struct msghdr msg;
-
   // the IO vector for data to be received with recvmsg
   struct iovec entry;
 
   // for address of the sender
   sockaddr_storage addrStorage;
 
-  ::memset(&msg, 0, sizeof(msg));
+  // Prepare message header to receive data in `buf`
+  void
+  prepare(struct msghdr& msg, unsigned char* buf, int len) {
+    ::memset(&msg, 0, sizeof(msg));
+
+    // we only expect to receive one block of data, single entry
+    // in the vector
+    msg.msg_iov = &entry;
+    msg.msg_iovlen = 1;
+
+    // this part is important - if we don't zero the buffer,
+    // the CMSG_NXTHDR may burp, because it tries extracting
+    // fields from "next header" in the buffer
+    ::memset(&u.ctrlBuf[0], 0, sizeof(u.ctrlBuf));
+
+    // control message buffer used to receive dest IP from the kernel
+    msg.msg_control = u.ctrlBuf;
+    msg.msg_controllen = sizeof(u.ctrlBuf);
+
+    // prepare to receive either v4 or v6 addresses
+    ::memset(&addrStorage, 0, sizeof(addrStorage));
+    msg.msg_name = &addrStorage;
+    msg.msg_namelen = sizeof(sockaddr_storage);
+
+    // write the data here
+    entry.iov_base = buf;
+    entry.iov_len = len;
+  }
+};
+
+// Buffers to send a message and its ancillary data from
+struct SendBuffers {
+  // pack control buffer, aligned by control message hdr
+  union {
+    char cbuf[CMSG_SPACE(sizeof(struct in6_pktinfo))];
+    struct cmsghdr align;
+  } u;
 
-  // we only expect to receive one block of data, single entry
-  // in the vector
-  msg.msg_iov = &entry;
-  msg.msg_iovlen = 1;
+  // the IO vector for data to be sent
+  struct iovec entry;
 
-  // this part is important - if we don't zero the buffer,
-  // the CMSG_NXTHDR may burp, because it tries extracting
-  // fields from "next header" in the buffer
-  ::memset(&u.ctrlBuf[0], 0, sizeof(u.ctrlBuf));
+  // for destination address of the message
+  sockaddr_storage addrStorage;
 
-  // control message buffer used to receive dest IP from the kernel
-  msg.msg_control = u.ctrlBuf;
-  msg.msg_controllen = sizeof(u.ctrlBuf);
+  // Prepare message header to send `packet` via interface `ifIndex`
+  void
+  prepare(
+      struct msghdr& msg,
+      int ifIndex,
+      folly::IPAddressV6 const& srcAddr,
+      folly::SocketAddress const& dstAddr,
+      std::string const& packet) {
+    // Set the destination address for the message
+    dstAddr.getAddress(&addrStorage);
+
+    ::memset(&msg, 0, sizeof(msg));
+    msg.msg_name = reinterpret_cast<void*>(&addrStorage);
+    msg.msg_namelen = dstAddr.getActualSize();
+
+    // set the source address and source if index for this message
+    // this goes into ancilliary data fields
+    msg.msg_control = u.cbuf;
+    msg.msg_controllen = sizeof(u.cbuf);
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+
+    cmsg->cmsg_level = IPPROTO_IPV6;
+    cmsg->cmsg_type = IPV6_PKTINFO;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(struct in6_pktinfo));
+
+    auto pktinfo = (struct in6_pktinfo*)CMSG_DATA(cmsg);
+    pktinfo->ipi6_ifindex = ifIndex;
+    ::memcpy(&pktinfo->ipi6_addr, srcAddr.bytes(), srcAddr.byteCount());
+
+    msg.msg_iov = &entry;
+    msg.msg_iovlen = 1;
+
+    // write the data here (we need to remove the const qualifier)
+    entry.iov_base = const_cast<char*>(packet.data());
+    entry.iov_len = packet.size();
+  }
+};
 
-  // prepare to receive either v4 or v6 addresses
-  ::memset(&addrStorage, 0, sizeof(addrStorage));
-  msg.msg_name = &addrStorage;
-  msg.msg_namelen = sizeof(sockaddr_storage);
+} // namespace
 
-  // write the data here
-  entry.iov_base = buf;
-  entry.iov_len = len;
+std::tuple<
+    ssize_t /* size */,
+    int /* ifIndex */,
+    folly::SocketAddress /* srcAddr */,
+    int /* hopLimit */,
+    std::chrono::microseconds /* kernel timestamp */>
+IoProvider::recvMessage(
+    int fd, unsigned char* buf, int len, openr::IoProvider* ioProvider) {
+  // the message header to receive into
+  struct msghdr msg;
+  RecvBuffers buffers;
+  buffers.prepare(msg, buf, len);
 
   ssize_t bytesRead = ioProvider->recvmsg(fd, &msg, MSG_DONTWAIT);
 
@@ -124,9 +201,59 @@ IoProvider::recvMessage(
         "Failed reading message on fd {}: {}", fd, folly::errnoStr(errno)));
   }
 
+  return parseMessage(msg, bytesRead);
+}
+
+std::vector<IoProvider::RecvMessageInfo>
+IoProvider::recvMessages(
+    int fd,
+    unsigned char* buf,
+    int len,
+    size_t maxMessages,
+    openr::IoProvider* ioProvider) {
+  std::vector<struct mmsghdr> msgs(maxMessages);
+  std::vector<RecvBuffers> buffers(maxMessages);
+  for (size_t i = 0; i < maxMessages; ++i) {
+    ::memset(&msgs[i], 0, sizeof(msgs[i]));
+    buffers[i].prepare(msgs[i].msg_hdr, buf + i * len, len);
+  }
+
+  int numMsgs =
+      ioProvider->recvmmsg(fd, msgs.data(), maxMessages, MSG_DONTWAIT);
+
+  std::vector<RecvMessageInfo> infos;
+  if (numMsgs < 0) {
+    if (errno == EAGAIN or errno == EWOULDBLOCK) {
+      return infos; // No message to read
+    }
+    throw std::runtime_error(fmt::format(
+        "Failed reading messages on fd {}: {}", fd, folly::errnoStr(errno)));
+  }
+
+  infos.reserve(numMsgs);
+  for (int i = 0; i < numMsgs; ++i) {
+    try {
+      infos.emplace_back(parseMessage(msgs[i].msg_hdr, msgs[i].msg_len));
+    } catch (std::exception const& err) {
+      // Report negative size for the message to not fail the whole batch
+      LOG(ERROR) << "Failed parsing message on fd " << fd << ": "
+                 << folly::exceptionStr(err);
+      infos.emplace_back(
+          -1, -1, folly::SocketAddress(), 0, std::chrono::microseconds(0));
+    }
+  }
+  return infos;
+}
+
+IoProvider::RecvMessageInfo
+IoProvider::parseMessage(struct msghdr& msg, ssize_t bytesRead) {
   if (msg.msg_flags & MSG_TRUNC) {
     throw std::runtime_error("Message truncated");
   }
+  if (msg.msg_flags & MSG_CTRUNC) {
+    // kernel timestamp may be lost and RTT measured with user space time
+    LOG(ERROR) << "Ancillary data of received message is truncated";
+  }
 
   // grab the inIndex we received this packet on and the hopLimit
   // those are available since we requested them via socket options
@@ -138,6 +265,7 @@ IoProvider::recvMessage(
   std::chrono::microseconds recvTs{
       std::chrono::duration_cast<std::chrono::microseconds>(
           std::chrono::system_clock::now().time_since_epoch())};
+  bool hasKernelTs{false};
 
   for (cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
     if (cmsg->cmsg_level == IPPROTO_IPV6) {
@@ -172,13 +300,20 @@ IoProvider::recvMessage(
               << (recvTs - kernelRecvTs).count()
               << " us for the packet to get from kernel to user space";
       recvTs = kernelRecvTs;
+      hasKernelTs = true;
     }
   } // for
 
+  // user space timestamp includes the time packet waited for the reader,
+  // which shows up as RTT noise when the receiving thread is busy
+  LOG_IF_EVERY_N(WARNING, not hasKernelTs, 1000)
+      << "Kernel timestamp is missing for received message. Using user "
+      << "space timestamp instead";
+
   // build the source socket address from recvmsg data
   folly::SocketAddress srcAddr{};
   // this will throw if sender address was not filled in
-  srcAddr.setFromSockaddr(reinterpret_cast<struct sockaddr*>(&addrStorage));
+  srcAddr.setFromSockaddr(reinterpret_cast<struct sockaddr*>(msg.msg_name));
 
   DCHECK(ifIndex != -1) << "ifIndex is not found";
   DCHECK(hopLimit) << "hopLimit is not found";
@@ -195,46 +330,45 @@ IoProvider::sendMessage(
     std::string const& packet,
     IoProvider* ioProvider) {
   struct msghdr msg;
-  struct cmsghdr* cmsg{nullptr};
-
-  // pack control buffer, aligned by control message hdr
-  union {
-    char cbuf[CMSG_SPACE(sizeof(struct in6_pktinfo))];
-    struct cmsghdr align;
-  } u;
-
-  // Set the destination address for the message
-  sockaddr_storage addrStorage;
-  dstAddr.getAddress(&addrStorage);
-
-  ::memset(&msg, 0, sizeof(msg));
-  msg.msg_name = reinterpret_cast<void*>(&addrStorage);
-  msg.msg_namelen = dstAddr.getActualSize();
+  SendBuffers buffers;
+  buffers.prepare(msg, ifIndex, srcAddr, dstAddr, packet);
 
-  // set the source address and source if index for this message
-  // this goes into ancilliary data fields
-  msg.msg_control = u.cbuf;
-  msg.msg_controllen = sizeof(u.cbuf);
-  cmsg = CMSG_FIRSTHDR(&msg);
-
-  cmsg->cmsg_level = IPPROTO_IPV6;
-  cmsg->cmsg_type = IPV6_PKTINFO;
-  cmsg->cmsg_len = CMSG_LEN(sizeof(struct in6_pktinfo));
-
-  auto pktinfo = (struct in6_pktinfo*)CMSG_DATA(cmsg);
-  pktinfo->ipi6_ifindex = ifIndex;
-  ::memcpy(&pktinfo->ipi6_addr, srcAddr.bytes(), srcAddr.byteCount());
-
-  // the IO vector for data to be sent
-  struct iovec entry;
-  msg.msg_iov = &entry;
-  msg.msg_iovlen = 1;
+  return ioProvider->sendmsg(fd, &msg, MSG_DONTWAIT);
+}
 
-  // write the data here (we need to remove the const qualifier)
-  entry.iov_base = const_cast<char*>(packet.data());
-  entry.iov_len = packet.size();
+std::vector<ssize_t>
+IoProvider::sendMessages(
+    int fd,
+    folly::SocketAddress dstAddr,
+    std::vector<SendMessageInfo> const& messages,
+    IoProvider* ioProvider) {
+  const auto numMsgs = messages.size();
+  std::vector<struct mmsghdr> msgs(numMsgs);
+  std::vector<SendBuffers> buffers(numMsgs);
+  for (size_t i = 0; i < numMsgs; ++i) {
+    auto const& [ifIndex, srcAddr, packet] = messages[i];
+    ::memset(&msgs[i], 0, sizeof(msgs[i]));
+    buffers[i].prepare(msgs[i].msg_hdr, ifIndex, srcAddr, dstAddr, packet);
+  }
 
-  return ioProvider->sendmsg(fd, &msg, MSG_DONTWAIT);
+  // kernel stops at the first message failing, e.g. interface went down.
+  // Report it and resume with the next one.
+  std::vector<ssize_t> bytesSent(numMsgs, -1);
+  size_t sent = 0;
+  while (sent < numMsgs) {
+    int ret = ioProvider->sendmmsg(
+        fd, msgs.data() + sent, numMsgs - sent, MSG_DONTWAIT);
+    if (ret <= 0) {
+      VLOG(1) << "Failed sending message on ifIndex "
+              << std::get<0>(messages[sent]) << ": " << folly::errnoStr(errno);
+      ++sent;
+      continue;
+    }
+    for (int i = 0; i < ret; ++i, ++sent) {
+      bytesSent[sent] = msgs[sent].msg_len;
+    }
+  }
+  return bytesSent;
 }
 
 } // namespace openr
@@ -13,6 +13,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 #include <chrono>
+#include <vector>
 
 #include <folly/IPAddress.h>
 #include <folly/SocketAddress.h>
@@ -57,13 +58,28 @@ class IoProvider {
 
   virtual ssize_t recvmsg(int sockfd, struct msghdr* msg, int flags);
 
+  virtual int recvmmsg(
+      int sockfd, struct mmsghdr* msgvec, unsigned int vlen, int flags);
+
   virtual ssize_t sendmsg(int sockfd, const struct msghdr* msg, int flags);
 
+  virtual int sendmmsg(
+      int sockfd, struct mmsghdr* msgvec, unsigned int vlen, int flags);
+
   virtual int setsockopt(
       int sockfd, int level, int optname, const void* optval, socklen_t optlen);
 
   // Utility functions that operate on sockets
 
+  // Size, interface index, source address, hop limit and kernel timestamp of
+  // a received message
+  using RecvMessageInfo = std::tuple<
+      ssize_t /* size */,
+      int /* ifIndex */,
+      folly::SocketAddress /* srcAddr */,
+      int /* hopLimit */,
+      std::chrono::microseconds /* kernel timestamp */>;
+
   /*
    * Receive a message on fd, and return its size, interface index,
    * and the source address
@@ -76,6 +92,20 @@ class IoProvider {
       std::chrono::microseconds /* kernel timestamp */>
   recvMessage(int fd, unsigned char* buf, int len, IoProvider* ioProvider);
 
+  /*
+   * Receive up to `maxMessages` messages on fd with a single syscall. The i-th
+   * message is received in `buf + i * len`, hence `buf` must be of size
+   * `maxMessages * len`. Returns info of the received messages in order, or
+   * empty list if there is no message to read. Message which can't be parsed
+   * (e.g. truncated) is reported with negative size.
+   */
+  static std::vector<RecvMessageInfo> recvMessages(
+      int fd,
+      unsigned char* buf,
+      int len,
+      size_t maxMessages,
+      IoProvider* ioProvider);
+
   /*
    * Send message on fd via given interface to the address provided
    * We supply socket address, which has dst IPv6 and port
@@ -88,7 +118,28 @@ class IoProvider {
       std::string const& packet,
       IoProvider* ioProvider);
 
+  // Interface index, source address and payload of a message to send
+  using SendMessageInfo = std::tuple<
+      int /* ifIndex */,
+      folly::IPAddressV6 /* srcAddr */,
+      std::string /* packet */>;
+
+  /*
+   * Send messages on fd to the same address, each via its own interface, with
+   * as few syscalls as possible (one unless some message fails). Returns
+   * bytes sent for every message in order, negative on failure. Failure of
+   * one message doesn't prevent sending the rest.
+   */
+  static std::vector<ssize_t> sendMessages(
+      int fd,
+      folly::SocketAddress dstAddr,
+      std::vector<SendMessageInfo> const& messages,
+      IoProvider* ioProvider);
+
  private:
+  // Parse ancillary data and source address of the received message
+  static RecvMessageInfo parseMessage(struct msghdr& msg, ssize_t bytesRead);
+
   IoProvider(IoProvider const&) = delete;
   IoProvider& operator=(IoProvider const&) = delete;
 };
@@ -8,6 +8,9 @@
 #include <ifaddrs.h>
 #include <net/if.h>
 #include <netinet/in.h>
+#include <sys/resource.h>
+
+#include <algorithm>
 
 #include <fb303/ServiceData.h>
 #include <folly/GLog.h>
@@ -19,6 +22,7 @@
 #include <folly/futures/Future.h>
 #include <folly/futures/Promise.h>
 #include <folly/gen/Base.h>
+#include <folly/system/ThreadName.h>
 
 #include <openr/common/Constants.h>
 #include <openr/common/EventLogger.h>
@@ -41,6 +45,12 @@ namespace {
 //
 const int kMinIpv6Mtu = 1280;
 
+//
+// Max number of packets received per read event. Hello/heartbeat packets of
+// many interfaces arriving together are received with a single syscall
+//
+const size_t kMaxPacketsPerRead = 32;
+
 //
 // The acceptable hop limit, assuming we send packets with this TTL
 //
@@ -49,6 +59,12 @@ const int kSparkHopLimit = 255;
 // number of restarting packets to send out per interface before I'm going down
 const int kNumRestartingPktSent = 3;
 
+// nice value of heartbeat thread. Lowering it requires CAP_SYS_NICE
+const int kHeartbeatThreadNice = -10;
+
+// hello interval on stable interface backs off up to 2^N * hello_time_s
+const uint32_t kMaxHelloBackoffExp = 2;
+
 //
 // Function to get current timestamp in microseconds using steady clock
 // NOTE: we use non-monotonic clock since kernel time-stamps do not support
@@ -108,10 +124,407 @@ toggleMcastGroup(
   return true;
 }
 
+//
+// Create UDP socket bound to neighbor discovery port for sending and receiving
+// Spark multicast packets
+//
+int
+createMcastSocket(
+    uint16_t port, std::optional<int> ipTos, openr::IoProvider* ioProvider) {
+  int fd = ioProvider->socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+  CHECK_GT(fd, 0);
+
+  if (fd < 0) {
+    LOG(FATAL) << "Failed creating Spark UDP socket. Error: "
+               << folly::errnoStr(errno);
+  }
+
+  // make socket non-blocking
+  if (ioProvider->fcntl(fd, F_SETFL, O_NONBLOCK) != 0) {
+    LOG(FATAL) << "Failed making the socket non-blocking. Error: "
+               << folly::errnoStr(errno);
+  }
+
+  // make v6 only
+  int v6Only = 1;
+  if (ioProvider->setsockopt(
+          fd, IPPROTO_IPV6, IPV6_V6ONLY, &v6Only, sizeof(v6Only)) != 0) {
+    LOG(FATAL) << "Failed making the socket v6 only. Error: "
+               << folly::errnoStr(errno);
+  }
+
+  // not really needed, but helps us use same port with other listeners, if any
+  int reuseAddr = 1;
+  if (ioProvider->setsockopt(
+          fd, SOL_SOCKET, SO_REUSEADDR, &reuseAddr, sizeof(reuseAddr)) != 0) {
+    LOG(FATAL) << "Failed making the socket reuse addr. Error: "
+               << folly::errnoStr(errno);
+  }
+
+  // request additional packet info, e.g. input iface index and sender address
+  int recvPktInfo = 1;
+  if (ioProvider->setsockopt(
+          fd,
+          IPPROTO_IPV6,
+          IPV6_RECVPKTINFO,
+          &recvPktInfo,
+          sizeof(recvPktInfo)) == -1) {
+    LOG(FATAL) << "Failed enabling PKTINFO option. Error: "
+               << folly::errnoStr(errno);
+  }
+
+  // Set ip-tos
+  if (ipTos.has_value()) {
+    if (ioProvider->setsockopt(
+            fd, IPPROTO_IPV6, IPV6_TCLASS, &ipTos.value(), sizeof(int)) != 0) {
+      LOG(FATAL) << "Failed setting ip-tos value on socket. Error: "
+                 << folly::errnoStr(errno);
+    }
+  }
+
+  // bind the socket to receive any mcast packet
+  {
+    VLOG(2) << "Binding UDP socket to receive on any destination address";
+
+    auto mcastSockAddr =
+        folly::SocketAddress(folly::IPAddress("::"), port);
+
+    sockaddr_storage addrStorage;
+    mcastSockAddr.getAddress(&addrStorage);
+    sockaddr* saddr = reinterpret_cast<sockaddr*>(&addrStorage);
+
+    if (ioProvider->bind(fd, saddr, mcastSockAddr.getActualSize()) != 0) {
+      LOG(FATAL) << "Failed binding the socket. Error: "
+                 << folly::errnoStr(errno);
+    }
+  }
+
+  // set the TTL to maximum, so we can check for spoofed addresses
+  int ttl = kSparkHopLimit;
+  if (ioProvider->setsockopt(
+          fd, IPPROTO_IPV6, IPV6_MULTICAST_HOPS, &ttl, sizeof(ttl)) != 0) {
+    LOG(FATAL) << "Failed setting TTL on socket. Error: "
+               << folly::errnoStr(errno);
+  }
+
+  // allow reporting the packet TTL to user space
+  int recvHopLimit = 1;
+  if (ioProvider->setsockopt(
+          fd,
+          IPPROTO_IPV6,
+          IPV6_RECVHOPLIMIT,
+          &recvHopLimit,
+          sizeof(recvHopLimit)) != 0) {
+    LOG(FATAL) << "Failed enabling TTL receive on socket. Error: "
+               << folly::errnoStr(errno);
+  }
+
+  // disable looping packets to ourselves
+  const int loop = 0;
+  if (ioProvider->setsockopt(
+          fd, IPPROTO_IPV6, IPV6_MULTICAST_LOOP, &loop, sizeof(loop)) != 0) {
+    LOG(FATAL) << "Failed disabling looping on socket. Error: "
+               << folly::errnoStr(errno);
+  }
+
+  // enable timestamping for this socket
+  const int enabled = 1;
+  if (ioProvider->setsockopt(
+          fd, SOL_SOCKET, SO_TIMESTAMPNS, &enabled, sizeof(enabled)) != 0) {
+    LOG(ERROR) << "Failed to enable kernel timestamping. Measured RTTs are "
+               << "likely to have more noise in them. Error: "
+               << folly::errnoStr(errno);
+  }
+
+  return fd;
+}
+
 } // namespace
 
 namespace openr {
 
+SparkHeartbeat::SparkHeartbeat(
+    std::string const& myNodeName,
+    int sockFd,
+    uint16_t neighborDiscoveryPort,
+    std::chrono::milliseconds keepAliveTime,
+    bool batchedSend,
+    std::shared_ptr<IoProvider> ioProvider,
+    HoldTimerCallback holdTimerCallback)
+    : myNodeName_(myNodeName),
+      mcastFd_(sockFd),
+      neighborDiscoveryPort_(neighborDiscoveryPort),
+      keepAliveTime_(keepAliveTime),
+      batchedSend_(batchedSend),
+      ioProvider_(std::move(ioProvider)),
+      holdTimerCallback_(std::move(holdTimerCallback)) {
+  heartbeatMsg_.nodeName_ref() = myNodeName_;
+
+  recvBuf_.resize(kMaxPacketsPerRead * kMinIpv6Mtu);
+  addSocketFd(mcastFd_, ZMQ_POLLIN, [this](uint16_t) noexcept {
+    try {
+      processPacket();
+    } catch (std::exception const& err) {
+      LOG(ERROR) << "SparkHeartbeat: error processing packet "
+                 << folly::exceptionStr(err);
+    }
+  });
+
+  keepAliveTimer_ = SparkTimeout::make(getEvb()->timer(), [this]() noexcept {
+    if (batchedSend_) {
+      sendHeartbeatMsgsBatched();
+    } else {
+      sendHeartbeatMsgs();
+    }
+    keepAliveTimer_->scheduleTimeout(keepAliveTime_);
+  });
+  keepAliveTimer_->scheduleTimeout(keepAliveTime_);
+}
+
+void
+SparkHeartbeat::addInterfaces(std::vector<InterfaceInfo> interfaces) {
+  if (interfaces.empty()) {
+    return;
+  }
+  runInEventBaseThread([this, interfaces = std::move(interfaces)]() {
+    const folly::IPAddress mcastGroup(Constants::kSparkMcastAddr);
+    for (auto const& [ifName, ifIndex, v6Addr] : interfaces) {
+      auto& interface = interfaces_[ifName];
+      if (interface.ifIndex != ifIndex) {
+        if (interface.ifIndex != 0) {
+          toggleMcastGroup(
+              mcastFd_,
+              mcastGroup,
+              interface.ifIndex,
+              false /* leave */,
+              ioProvider_.get());
+          ifIndexToName_.erase(interface.ifIndex);
+        }
+        if (!toggleMcastGroup(
+                mcastFd_,
+                mcastGroup,
+                ifIndex,
+                true /* join */,
+                ioProvider_.get())) {
+          LOG(ERROR) << "SparkHeartbeat: failed joining multicast group on "
+                     << ifName << ". Error: " << folly::errnoStr(errno);
+        }
+        ifIndexToName_[ifIndex] = ifName;
+      }
+      interface.ifIndex = ifIndex;
+      interface.v6Addr = v6Addr;
+    }
+  });
+}
+
+void
+SparkHeartbeat::removeInterfaces(std::vector<std::string> ifNames) {
+  if (ifNames.empty()) {
+    return;
+  }
+  runInEventBaseThread([this, ifNames = std::move(ifNames)]() {
+    const folly::IPAddress mcastGroup(Constants::kSparkMcastAddr);
+    for (auto const& ifName : ifNames) {
+      auto it = interfaces_.find(ifName);
+      if (it == interfaces_.end()) {
+        continue;
+      }
+      toggleMcastGroup(
+          mcastFd_,
+          mcastGroup,
+          it->second.ifIndex,
+          false /* leave */,
+          ioProvider_.get());
+      ifIndexToName_.erase(it->second.ifIndex);
+      interfaces_.erase(it);
+      holdTimers_.erase(ifName);
+    }
+  });
+}
+
+void
+SparkHeartbeat::setInterfaceActive(std::string const& ifName, bool active) {
+  runInEventBaseThread([this, ifName, active]() {
+    auto it = interfaces_.find(ifName);
+    if (it != interfaces_.end()) {
+      it->second.active = active;
+    }
+  });
+}
+
+void
+SparkHeartbeat::scheduleHoldTimer(
+    std::string const& ifName,
+    std::string const& neighborName,
+    std::chrono::milliseconds holdTime,
+    uint64_t version) {
+  runInEventBaseThread([this, ifName, neighborName, holdTime, version]() {
+    auto& holdTimer = holdTimers_[ifName][neighborName];
+    holdTimer.holdTime = holdTime;
+    holdTimer.timer = SparkTimeout::make(
+        getEvb()->timer(), [this, ifName, neighborName, version]() noexcept {
+          processHoldTimeout(ifName, neighborName, version);
+        });
+    holdTimer.timer->scheduleTimeout(holdTime);
+  });
+}
+
+void
+SparkHeartbeat::processHoldTimeout(
+    std::string ifName, std::string neighborName, uint64_t version) {
+  LOG(INFO) << "Heartbeat timer expired for: " << neighborName
+            << " on interface " << ifName;
+  fb303::fbData->addStatValue(
+      "spark.heartbeat_thread.hold_timer_expired", 1, fb303::SUM);
+
+  // NOTE: arguments are copies. The timer holding callback is destroyed here
+  holdTimers_.at(ifName).erase(neighborName);
+  holdTimerCallback_(ifName, neighborName, version);
+}
+
+void
+SparkHeartbeat::cancelHoldTimer(
+    std::string const& ifName, std::string const& neighborName) {
+  runInEventBaseThread([this, ifName, neighborName]() {
+    auto it = holdTimers_.find(ifName);
+    if (it != holdTimers_.end()) {
+      it->second.erase(neighborName);
+    }
+  });
+}
+
+void
+SparkHeartbeat::processPacket() {
+  const auto recvInfos = IoProvider::recvMessages(
+      mcastFd_,
+      recvBuf_.data(),
+      kMinIpv6Mtu,
+      kMaxPacketsPerRead,
+      ioProvider_.get());
+
+  for (size_t i = 0; i < recvInfos.size(); ++i) {
+    auto const& [bytesRead, ifIndex, clientAddr, hopLimit, recvTime] =
+        recvInfos.at(i);
+    if (bytesRead < 0 || static_cast<size_t>(bytesRead) > kMinIpv6Mtu ||
+        hopLimit < kSparkHopLimit) {
+      continue; // Rejected and logged by Spark
+    }
+
+    auto ifIt = ifIndexToName_.find(ifIndex);
+    if (ifIt == ifIndexToName_.end()) {
+      continue;
+    }
+
+    thrift::SparkHelloPacket pkt;
+    try {
+      pkt = readThriftObjStr<thrift::SparkHelloPacket>(
+          std::string(
+              reinterpret_cast<const char*>(recvBuf_.data()) +
+                  i * kMinIpv6Mtu,
+              bytesRead),
+          serializer_);
+    } catch (std::exception const&) {
+      continue; // Rejected and logged by Spark
+    }
+    if (!pkt.heartbeatMsg_ref().has_value()) {
+      continue; // Processed by Spark
+    }
+
+    // Reset the hold-timer for neighbor as we have received a keep-alive msg
+    auto timersIt = holdTimers_.find(ifIt->second);
+    if (timersIt == holdTimers_.end()) {
+      continue;
+    }
+    auto const& neighborName = *pkt.heartbeatMsg_ref()->nodeName_ref();
+    auto timerIt = timersIt->second.find(neighborName);
+    if (timerIt == timersIt->second.end()) {
+      continue;
+    }
+    auto& holdTimer = timerIt->second;
+    holdTimer.timer->scheduleTimeout(holdTimer.holdTime);
+  }
+}
+
+void
+SparkHeartbeat::sendHeartbeatMsgs() {
+  folly::SocketAddress dstAddr(
+      folly::IPAddress(Constants::kSparkMcastAddr.toString()),
+      neighborDiscoveryPort_);
+
+  for (auto const& [ifName, interface] : interfaces_) {
+    if (!interface.active) {
+      continue;
+    }
+
+    heartbeatMsg_.seqNum_ref() = seqNum_++;
+    thrift::SparkHelloPacket pkt;
+    pkt.heartbeatMsg_ref() = heartbeatMsg_;
+    auto packet = writeThriftObjStrBuffered(pkt, serializer_);
+
+    auto bytesSent = IoProvider::sendMessage(
+        mcastFd_,
+        interface.ifIndex,
+        interface.v6Addr,
+        dstAddr,
+        packet,
+        ioProvider_.get());
+    if ((bytesSent < 0) || (static_cast<size_t>(bytesSent) != packet.size())) {
+      VLOG(1) << "SparkHeartbeat: sending heartbeat on " << ifName
+              << " failed due to error " << folly::errnoStr(errno);
+      continue;
+    }
+
+    fb303::fbData->addStatValue(
+        "spark.heartbeat_thread.packet_sent", 1, fb303::SUM);
+  }
+}
+
+void
+SparkHeartbeat::sendHeartbeatMsgsBatched() {
+  folly::SocketAddress dstAddr(
+      folly::IPAddress(Constants::kSparkMcastAddr.toString()),
+      neighborDiscoveryPort_);
+
+  std::vector<IoProvider::SendMessageInfo> messages;
+  std::vector<std::string> ifNames;
+  for (auto const& [ifName, interface] : interfaces_) {
+    if (!interface.active) {
+      continue;
+    }
+
+    heartbeatMsg_.seqNum_ref() = seqNum_++;
+    thrift::SparkHelloPacket pkt;
+    pkt.heartbeatMsg_ref() = heartbeatMsg_;
+    messages.emplace_back(
+        interface.ifIndex,
+        interface.v6Addr,
+        writeThriftObjStrBuffered(pkt, serializer_));
+    ifNames.emplace_back(ifName);
+  }
+  if (messages.empty()) {
+    return;
+  }
+
+  const auto bytesSent = IoProvider::sendMessages(
+      mcastFd_, dstAddr, messages, ioProvider_.get());
+  size_t numSent{0};
+  for (size_t i = 0; i < messages.size(); ++i) {
+    if ((bytesSent[i] < 0) ||
+        (static_cast<size_t>(bytesSent[i]) !=
+         std::get<2>(messages[i]).size())) {
+      VLOG(1) << "SparkHeartbeat: sending heartbeat on " << ifNames[i]
+              << " failed";
+      continue;
+    }
+    ++numSent;
+  }
+
+  fb303::fbData->addStatValue(
+      "spark.heartbeat_thread.packet_sent", numSent, fb303::SUM);
+  fb303::fbData->addStatValue(
+      "spark.heartbeat_thread.batch_sent", 1, fb303::SUM);
+}
+
 const std::vector<std::vector<std::optional<SparkNeighState>>>
     Spark::stateMap_ = {
         /*
@@ -227,7 +640,7 @@ Spark::SparkNeighbor::SparkNeighbor(
 }
 
 Spark::Spark(
-    messaging::RQueue<InterfaceDatabase> interfaceUpdatesQueue,
+    messaging::RQueue<InterfaceUpdate> interfaceUpdatesQueue,
     messaging::ReplicateQueue<NeighborEvents>& neighborUpdatesQueue,
     std::shared_ptr<IoProvider> ioProvider,
     std::shared_ptr<const Config> config,
@@ -335,6 +748,10 @@ Spark::Spark(
   // Initialize UDP socket for neighbor discovery
   prepareSocket();
 
+  if (config_->getSparkConfig().get_enable_heartbeat_thread()) {
+    startHeartbeatThread();
+  }
+
   // Initialize some stat keys
   fb303::fbData->addStatExportType(
       "spark.invalid_keepalive.different_domain", fb303::SUM);
@@ -370,127 +787,40 @@ Spark::toStr(SparkNeighState state) {
   }
 }
 
+Spark::~Spark() {
+  if (heartbeatThread_.joinable()) {
+    heartbeat_->stop();
+    heartbeatThread_.join();
+  }
+}
+
 void
 Spark::stop() {
   // NOTE: explicitly wait for msg to send out before going down
   floodRestartingMsg().get();
+  if (heartbeatThread_.joinable()) {
+    heartbeat_->stop();
+    heartbeatThread_.join();
+    VLOG(1) << "Spark heartbeat thread stopped";
+  }
   OpenrEventBase::stop();
   VLOG(1) << "Spark Event Base stopped";
 }
 
 void
 Spark::prepareSocket() noexcept {
-  int fd = ioProvider_->socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
-  mcastFd_ = fd;
-  LOG(INFO) << "Created UDP socket for neighbor discovery. fd: " << mcastFd_;
-  CHECK_GT(fd, 0);
-
-  if (fd < 0) {
-    LOG(FATAL) << "Failed creating Spark UDP socket. Error: "
-               << folly::errnoStr(errno);
-  }
-
-  // make socket non-blocking
-  if (ioProvider_->fcntl(fd, F_SETFL, O_NONBLOCK) != 0) {
-    LOG(FATAL) << "Failed making the socket non-blocking. Error: "
-               << folly::errnoStr(errno);
-  }
-
-  // make v6 only
-  int v6Only = 1;
-  if (ioProvider_->setsockopt(
-          fd, IPPROTO_IPV6, IPV6_V6ONLY, &v6Only, sizeof(v6Only)) != 0) {
-    LOG(FATAL) << "Failed making the socket v6 only. Error: "
-               << folly::errnoStr(errno);
-  }
-
-  // not really needed, but helps us use same port with other listeners, if any
-  int reuseAddr = 1;
-  if (ioProvider_->setsockopt(
-          fd, SOL_SOCKET, SO_REUSEADDR, &reuseAddr, sizeof(reuseAddr)) != 0) {
-    LOG(FATAL) << "Failed making the socket reuse addr. Error: "
-               << folly::errnoStr(errno);
-  }
-
-  // request additional packet info, e.g. input iface index and sender address
-  int recvPktInfo = 1;
-  if (ioProvider_->setsockopt(
-          fd,
-          IPPROTO_IPV6,
-          IPV6_RECVPKTINFO,
-          &recvPktInfo,
-          sizeof(recvPktInfo)) == -1) {
-    LOG(FATAL) << "Failed enabling PKTINFO option. Error: "
-               << folly::errnoStr(errno);
-  }
-
-  // Set ip-tos
+  std::optional<int> ipTos;
   if (config_->getConfig().ip_tos_ref().has_value()) {
-    int ipTos = config_->getConfig().ip_tos_ref().value();
-    if (ioProvider_->setsockopt(
-            fd, IPPROTO_IPV6, IPV6_TCLASS, &ipTos, sizeof(int)) != 0) {
-      LOG(FATAL) << "Failed setting ip-tos value on socket. Error: "
-                 << folly::errnoStr(errno);
-    }
-  }
-
-  // bind the socket to receive any mcast packet
-  {
-    VLOG(2) << "Binding UDP socket to receive on any destination address";
-
-    auto mcastSockAddr =
-        folly::SocketAddress(folly::IPAddress("::"), neighborDiscoveryPort_);
-
-    sockaddr_storage addrStorage;
-    mcastSockAddr.getAddress(&addrStorage);
-    sockaddr* saddr = reinterpret_cast<sockaddr*>(&addrStorage);
-
-    if (ioProvider_->bind(fd, saddr, mcastSockAddr.getActualSize()) != 0) {
-      LOG(FATAL) << "Failed binding the socket. Error: "
-                 << folly::errnoStr(errno);
-    }
-  }
-
-  // set the TTL to maximum, so we can check for spoofed addresses
-  int ttl = kSparkHopLimit;
-  if (ioProvider_->setsockopt(
-          fd, IPPROTO_IPV6, IPV6_MULTICAST_HOPS, &ttl, sizeof(ttl)) != 0) {
-    LOG(FATAL) << "Failed setting TTL on socket. Error: "
-               << folly::errnoStr(errno);
-  }
-
-  // allow reporting the packet TTL to user space
-  int recvHopLimit = 1;
-  if (ioProvider_->setsockopt(
-          fd,
-          IPPROTO_IPV6,
-          IPV6_RECVHOPLIMIT,
-          &recvHopLimit,
-          sizeof(recvHopLimit)) != 0) {
-    LOG(FATAL) << "Failed enabling TTL receive on socket. Error: "
-               << folly::errnoStr(errno);
-  }
-
-  // disable looping packets to ourselves
-  const int loop = 0;
-  if (ioProvider_->setsockopt(
-          fd, IPPROTO_IPV6, IPV6_MULTICAST_LOOP, &loop, sizeof(loop)) != 0) {
-    LOG(FATAL) << "Failed disabling looping on socket. Error: "
-               << folly::errnoStr(errno);
-  }
-
-  // enable timestamping for this socket
-  const int enabled = 1;
-  if (ioProvider_->setsockopt(
-          fd, SOL_SOCKET, SO_TIMESTAMPNS, &enabled, sizeof(enabled)) != 0) {
-    LOG(ERROR) << "Failed to enable kernel timestamping. Measured RTTs are "
-               << "likely to have more noise in them. Error: "
-               << folly::errnoStr(errno);
+    ipTos = config_->getConfig().ip_tos_ref().value();
   }
+  mcastFd_ =
+      createMcastSocket(neighborDiscoveryPort_, ipTos, ioProvider_.get());
+  LOG(INFO) << "Created UDP socket for neighbor discovery. fd: " << mcastFd_;
 
   LOG(INFO) << "Spark thread attaching socket/events callbacks...";
 
   // Listen for incoming messages on multicast FD
+  recvBuf_.resize(kMaxPacketsPerRead * kMinIpv6Mtu);
   addSocketFd(mcastFd_, ZMQ_POLLIN, [this](uint16_t) noexcept {
     try {
       processPacket();
@@ -509,6 +839,46 @@ Spark::prepareSocket() noexcept {
   counterUpdateTimer_->scheduleTimeout(Constants::kCounterSubmitInterval);
 }
 
+void
+Spark::startHeartbeatThread() {
+  std::optional<int> ipTos;
+  if (config_->getConfig().ip_tos_ref().has_value()) {
+    ipTos = config_->getConfig().ip_tos_ref().value();
+  }
+  heartbeatFd_ =
+      createMcastSocket(neighborDiscoveryPort_, ipTos, ioProvider_.get());
+  LOG(INFO) << "Created UDP socket for heartbeat thread. fd: " << heartbeatFd_;
+
+  heartbeat_ = std::make_unique<SparkHeartbeat>(
+      myNodeName_,
+      heartbeatFd_,
+      neighborDiscoveryPort_,
+      keepAliveTime_,
+      config_->getSparkConfig().get_enable_batched_heartbeat_send(),
+      ioProvider_,
+      [this](
+          std::string const& ifName,
+          std::string const& neighborName,
+          uint64_t version) noexcept {
+        runInEventBaseThread([this, ifName, neighborName, version]() {
+          processHeartbeatThreadTimeout(ifName, neighborName, version);
+        });
+      });
+
+  heartbeatThread_ = std::thread([this]() noexcept {
+    LOG(INFO) << "Starting spark heartbeat thread ...";
+    folly::setThreadName("openr-spark-heartbeat");
+    // `who` 0 refers to calling thread only on Linux
+    if (setpriority(PRIO_PROCESS, 0, kHeartbeatThreadNice) != 0) {
+      LOG(WARNING) << "Failed raising priority of heartbeat thread. Error: "
+                   << folly::errnoStr(errno);
+    }
+    heartbeat_->run();
+    LOG(INFO) << "Spark heartbeat thread got stopped.";
+  });
+  heartbeat_->waitUntilRunning();
+}
+
 PacketValidationResult
 Spark::sanityCheckHelloPkt(
     std::string const& neighborName,
@@ -559,19 +929,20 @@ Spark::shouldProcessHelloPacket(
 
 bool
 Spark::parsePacket(
+    const uint8_t* buf,
+    const IoProvider::RecvMessageInfo& recvInfo,
     thrift::SparkHelloPacket& pkt,
     std::string& ifName,
     std::chrono::microseconds& recvTime) {
-  // the read buffer
-  uint8_t buf[kMinIpv6Mtu];
-
   ssize_t bytesRead;
   int ifIndex;
   folly::SocketAddress clientAddr;
   int hopLimit;
 
-  std::tie(bytesRead, ifIndex, clientAddr, hopLimit, recvTime) =
-      IoProvider::recvMessage(mcastFd_, buf, kMinIpv6Mtu, ioProvider_.get());
+  std::tie(bytesRead, ifIndex, clientAddr, hopLimit, recvTime) = recvInfo;
+  if (bytesRead < 0) {
+    return false; // Failure is logged on receiving the packet
+  }
 
   if (hopLimit < kSparkHopLimit) {
     LOG(ERROR) << "Rejecting packet from " << clientAddr.getAddressStr()
@@ -693,6 +1064,7 @@ Spark::processRttChange(
 
   // update rtt value
   sparkNeighbor.rtt = std::chrono::microseconds(newRtt);
+  ++neighborsGeneration_;
 
   if (*config_->getLinkMonitorConfig().use_rtt_metric_ref()) {
     VLOG(1) << "RTT for sparkNeighbor " << neighborName << " has changed "
@@ -775,6 +1147,7 @@ Spark::updateNeighborRtt(
         VLOG(2) << "Setting initial value for RTT for sparkNeighbor "
                 << neighborName;
         sparkNeighbor.rtt = rtt;
+        ++neighborsGeneration_;
       }
       // Update rttLatest
       sparkNeighbor.rttLatest = rtt;
@@ -819,7 +1192,7 @@ Spark::sendHandshakeMsg(
   thrift::SparkHelloPacket pkt;
   pkt.handshakeMsg_ref() = std::move(handshakeMsg);
 
-  auto packet = writeThriftObjStr(pkt, serializer_);
+  auto packet = writeThriftObjStrBuffered(pkt, serializer_);
 
   // send the pkt
   folly::SocketAddress dstAddr(
@@ -846,6 +1219,13 @@ Spark::sendHandshakeMsg(
   fb303::fbData->addStatValue("spark.handshake.packet_sent", 1, fb303::SUM);
 }
 
+std::string const&
+Spark::serializePacket(thrift::SparkHelloPacket const& pkt) {
+  sendBuf_.clear();
+  serializer_.serialize(pkt, &sendBuf_);
+  return sendBuf_;
+}
+
 void
 Spark::sendHeartbeatMsg(std::string const& ifName) {
   SCOPE_EXIT {
@@ -871,15 +1251,15 @@ Spark::sendHeartbeatMsg(std::string const& ifName) {
   const auto ifIndex = interfaceEntry.ifIndex;
   const auto v6Addr = interfaceEntry.v6LinkLocalNetwork.first;
 
-  // build heartbeat msg
-  thrift::SparkHeartbeatMsg heartbeatMsg;
-  heartbeatMsg.nodeName_ref() = myNodeName_;
-  heartbeatMsg.seqNum_ref() = mySeqNum_;
-
-  thrift::SparkHelloPacket pkt;
-  pkt.heartbeatMsg_ref() = std::move(heartbeatMsg);
+  // heartbeat msg is the same for all interfaces except for seqNum
+  if (!heartbeatPacket_.heartbeatMsg_ref().has_value()) {
+    thrift::SparkHeartbeatMsg heartbeatMsg;
+    heartbeatMsg.nodeName_ref() = myNodeName_;
+    heartbeatPacket_.heartbeatMsg_ref() = std::move(heartbeatMsg);
+  }
+  heartbeatPacket_.heartbeatMsg_ref()->seqNum_ref() = mySeqNum_;
 
-  auto packet = writeThriftObjStr(pkt, serializer_);
+  auto& packet = serializePacket(heartbeatPacket_);
 
   // send the pkt
   folly::SocketAddress dstAddr(
@@ -912,11 +1292,17 @@ Spark::logStateTransition(
     std::string const& ifName,
     SparkNeighState const& oldState,
     SparkNeighState const& newState) {
+  ++neighborsGeneration_;
   SYSLOG(INFO) << EventTag() << "State change: [" << toStr(oldState) << "] -> ["
                << toStr(newState) << "] "
                << "for neighbor: (" << neighborName << ") on interface: ("
                << ifName << ").";
 
+  // neighbor is in transition, resume regular hello interval on interface
+  if (newState != SparkNeighState::ESTABLISHED) {
+    resetHelloBackoff(ifName);
+  }
+
   auto& ifNeighbors = sparkNeighbors_.at(ifName);
   auto& neighbor = ifNeighbors.at(neighborName);
 
@@ -1018,6 +1404,25 @@ Spark::floodRestartingMsg() {
   return sf;
 }
 
+folly::SemiFuture<folly::Unit>
+Spark::processConfigUpdate(ConfigUpdate update) {
+  folly::Promise<folly::Unit> promise;
+  auto sf = promise.getSemiFuture();
+  runInEventBaseThread([this,
+                        p = std::move(promise),
+                        update = std::move(update)]() mutable {
+    if (not update.areasWithChangedRegexes.empty()) {
+      // only live changes differ from running config, hence it is swapped
+      // as a whole
+      config_ = update.config;
+      LOG(INFO) << "[Config] Applied neighbor regexes of "
+                << update.areasWithChangedRegexes.size() << " areas";
+    }
+    p.setValue();
+  });
+  return sf;
+}
+
 folly::SemiFuture<std::unique_ptr<std::vector<thrift::SparkNeighbor>>>
 Spark::getNeighbors() {
   folly::Promise<std::unique_ptr<std::vector<thrift::SparkNeighbor>>> promise;
@@ -1047,14 +1452,13 @@ Spark::neighborUpWrapper(
   neighbor.negotiateHoldTimer.reset();
 
   // create heartbeat hold timer when promote to "ESTABLISHED"
-  neighbor.heartbeatHoldTimer = folly::AsyncTimeout::make(
-      *getEvb(), [this, ifName, neighborName]() noexcept {
-        processHeartbeatTimeout(ifName, neighborName);
-      });
-  neighbor.heartbeatHoldTimer->scheduleTimeout(neighbor.heartbeatHoldTime);
+  scheduleHeartbeatHoldTimer(ifName, neighborName, neighbor);
 
   // add neighborName to collection
   ifNameToActiveNeighbors_[ifName].emplace(neighborName);
+  if (heartbeat_) {
+    heartbeat_->setInterfaceActive(ifName, true);
+  }
 
   // notify LinkMonitor about neighbor UP state
   notifySparkNeighborEvent(NeighborEventType::NEIGHBOR_UP, neighbor.toThrift());
@@ -1078,6 +1482,9 @@ Spark::neighborDownWrapper(
   ifNameToActiveNeighbors_.at(ifName).erase(neighborName);
   if (ifNameToActiveNeighbors_.at(ifName).empty()) {
     ifNameToActiveNeighbors_.erase(ifName);
+    if (heartbeat_) {
+      heartbeat_->setInterfaceActive(ifName, false);
+    }
   }
 }
 
@@ -1090,7 +1497,24 @@ Spark::notifySparkNeighborEvent(
       initializationHoldTimer_->isScheduled()) {
     return;
   }
-  neighborUpdatesQueue_.push(NeighborEvents({NeighborEvent(eventType, info)}));
+  // schedule the flush once, with the first event of this loop iteration
+  if (pendingNeighborEvents_.empty()) {
+    getEvb()->runInLoop([this]() noexcept { flushNeighborEvents(); });
+  }
+  pendingNeighborEvents_.emplace_back(NeighborEvent(eventType, info));
+}
+
+void
+Spark::flushNeighborEvents() {
+  if (pendingNeighborEvents_.empty()) {
+    return;
+  }
+  fb303::fbData->addStatValue(
+      "spark.neighbor_events_batch_size",
+      pendingNeighborEvents_.size(),
+      fb303::AVG);
+  neighborUpdatesQueue_.push(std::move(pendingNeighborEvents_));
+  pendingNeighborEvents_.clear();
 }
 
 void
@@ -1104,6 +1528,7 @@ Spark::processHeartbeatTimeout(
   SCOPE_EXIT {
     allocatedLabels_.erase(neighbor.label);
     ifNeighbors.erase(neighborName);
+    ++neighborsGeneration_;
   };
 
   LOG(INFO) << "Heartbeat timer expired for: " << neighborName
@@ -1122,6 +1547,66 @@ Spark::processHeartbeatTimeout(
   neighborDownWrapper(neighbor, ifName, neighborName);
 }
 
+void
+Spark::scheduleHeartbeatHoldTimer(
+    std::string const& ifName,
+    std::string const& neighborName,
+    SparkNeighbor& neighbor) {
+  if (not neighbor.heartbeatHoldTimer) {
+    neighbor.heartbeatHoldTimer = SparkTimeout::make(
+        getEvb()->timer(), [this, ifName, neighborName]() noexcept {
+          processHeartbeatTimeout(ifName, neighborName);
+        });
+  }
+
+  if (heartbeat_) {
+    neighbor.heartbeatHoldTimerVersion = ++heartbeatHoldTimerVersion_;
+    heartbeat_->scheduleHoldTimer(
+        ifName,
+        neighborName,
+        neighbor.heartbeatHoldTime,
+        neighbor.heartbeatHoldTimerVersion);
+    return;
+  }
+  neighbor.heartbeatHoldTimer->scheduleTimeout(neighbor.heartbeatHoldTime);
+}
+
+void
+Spark::cancelHeartbeatHoldTimer(
+    std::string const& ifName,
+    std::string const& neighborName,
+    SparkNeighbor& neighbor) {
+  neighbor.heartbeatHoldTimer.reset();
+  if (heartbeat_) {
+    heartbeat_->cancelHoldTimer(ifName, neighborName);
+  }
+}
+
+void
+Spark::processHeartbeatThreadTimeout(
+    std::string const& ifName,
+    std::string const& neighborName,
+    uint64_t version) {
+  auto ifIt = sparkNeighbors_.find(ifName);
+  if (ifIt == sparkNeighbors_.end()) {
+    return;
+  }
+  auto neighborIt = ifIt->second.find(neighborName);
+  if (neighborIt == ifIt->second.end()) {
+    return;
+  }
+
+  // ignore expiry of hold-timer which has been cancelled or re-armed since
+  auto const& neighbor = neighborIt->second;
+  if (not neighbor.heartbeatHoldTimer or
+      neighbor.heartbeatHoldTimerVersion != version or
+      neighbor.state != SparkNeighState::ESTABLISHED) {
+    return;
+  }
+
+  processHeartbeatTimeout(ifName, neighborName);
+}
+
 void
 Spark::processNegotiateTimeout(
     std::string const& ifName, std::string const& neighborName) {
@@ -1156,6 +1641,7 @@ Spark::processGRTimeout(
   SCOPE_EXIT {
     allocatedLabels_.erase(neighbor.label);
     ifNeighbors.erase(neighborName);
+    ++neighborsGeneration_;
   };
 
   LOG(INFO) << "Graceful restart timer expired for: " << neighborName
@@ -1183,8 +1669,8 @@ Spark::processGRMsg(
       NeighborEventType::NEIGHBOR_RESTARTING, neighbor.toThrift());
 
   // start graceful-restart timer
-  neighbor.gracefulRestartHoldTimer = folly::AsyncTimeout::make(
-      *getEvb(), [this, ifName, neighborName]() noexcept {
+  neighbor.gracefulRestartHoldTimer = SparkTimeout::make(
+      getEvb()->timer(), [this, ifName, neighborName]() noexcept {
         // change the state back to IDLE
         processGRTimeout(ifName, neighborName);
       });
@@ -1197,7 +1683,7 @@ Spark::processGRMsg(
   logStateTransition(neighborName, ifName, oldState, neighbor.state);
 
   // neihbor is restarting, shutdown heartbeat hold timer
-  neighbor.heartbeatHoldTimer.reset();
+  cancelHeartbeatHoldTimer(ifName, neighborName, neighbor);
 }
 
 void
@@ -1243,7 +1729,7 @@ Spark::processHelloMsg(
     // TODO: Spark is yet to support area change due to dynamic configuration.
     //       To avoid running area deducing logic for every single helloMsg,
     //       ONLY deduce for unknown neighbors.
-    auto areaId = getNeighborArea(neighborName, ifName, config_->getAreas());
+    auto areaId = getNeighborAreaCached(neighborName, ifName);
     if (not areaId.has_value()) {
       return;
     }
@@ -1269,6 +1755,7 @@ Spark::processHelloMsg(
             keepAliveTime_, // stepDetector sample period
             std::move(rttChangeCb),
             areaId.value()));
+    ++neighborsGeneration_;
 
     auto& neighbor = ifNeighbors.at(neighborName);
     checkNeighborState(neighbor, SparkNeighState::IDLE);
@@ -1341,25 +1828,20 @@ Spark::processHelloMsg(
     }
 
     // Starts timer to periodically send hankshake msg
+    // NOTE: timer is owned by neighbor, which outlives it at stable address
     const std::string neighborAreaId = neighbor.area;
-    neighbor.negotiateTimer = folly::AsyncTimeout::make(
-        *getEvb(), [this, ifName, neighborName, neighborAreaId]() noexcept {
+    neighbor.negotiateTimer = SparkTimeout::make(
+        getEvb()->timer(),
+        [this, ifName, neighborName, neighborAreaId, &neighbor]() noexcept {
           sendHandshakeMsg(ifName, neighborName, neighborAreaId, false);
           // send out handshake msg periodically to this neighbor
-          CHECK(sparkNeighbors_.count(ifName) > 0)
-              << fmt::format("Key NOT found for: {}", ifName);
-          CHECK(sparkNeighbors_.at(ifName).count(neighborName) > 0)
-              << fmt::format(
-                     "Key NOT found: {} under: {}", neighborName, ifName);
-          sparkNeighbors_.at(ifName)
-              .at(neighborName)
-              .negotiateTimer->scheduleTimeout(handshakeTime_);
+          neighbor.negotiateTimer->scheduleTimeout(handshakeTime_);
         });
     neighbor.negotiateTimer->scheduleTimeout(handshakeTime_);
 
     // Starts negotiate hold-timer
-    neighbor.negotiateHoldTimer = folly::AsyncTimeout::make(
-        *getEvb(), [this, ifName, neighborName]() noexcept {
+    neighbor.negotiateHoldTimer = SparkTimeout::make(
+        getEvb()->timer(), [this, ifName, neighborName]() noexcept {
           // prevent to stucking in NEGOTIATE forever
           processNegotiateTimeout(ifName, neighborName);
         });
@@ -1398,6 +1880,7 @@ Spark::processHelloMsg(
       // remove from tracked neighbor at the end
       allocatedLabels_.erase(neighbor.label);
       ifNeighbors.erase(neighborName);
+      ++neighborsGeneration_;
     }
   } else if (neighbor.state == SparkNeighState::RESTART) {
     // Neighbor is undergoing restart. Will reply immediately for hello msg for
@@ -1428,11 +1911,7 @@ Spark::processHelloMsg(
         NeighborEventType::NEIGHBOR_RESTARTED, neighbor.toThrift());
 
     // start heartbeat timer again to make sure neighbor is alive
-    neighbor.heartbeatHoldTimer = folly::AsyncTimeout::make(
-        *getEvb(), [this, ifName, neighborName]() noexcept {
-          processHeartbeatTimeout(ifName, neighborName);
-        });
-    neighbor.heartbeatHoldTimer->scheduleTimeout(neighbor.heartbeatHoldTime);
+    scheduleHeartbeatHoldTimer(ifName, neighborName, neighbor);
 
     // stop the graceful-restart hold-timer
     neighbor.gracefulRestartHoldTimer.reset();
@@ -1500,7 +1979,7 @@ Spark::processHandshakeMsg(
   if (neighbor.heartbeatHoldTimer) {
     // Reset the hold-timer for neighbor as we have received a keep-alive msg
     LOG(INFO) << "Extend heartbeat timer for neighbor: " << neighborName;
-    neighbor.heartbeatHoldTimer->scheduleTimeout(neighbor.heartbeatHoldTime);
+    scheduleHeartbeatHoldTimer(ifName, neighborName, neighbor);
   }
 
   // skip NEGOTIATE step if neighbor is NOT in state. This can happen:
@@ -1520,6 +1999,7 @@ Spark::processHandshakeMsg(
   neighbor.transportAddressV6 = *handshakeMsg.transportAddressV6_ref();
   neighbor.enableFloodOptimization =
       handshakeMsg.enableFloodOptimization_ref().value_or(false);
+  ++neighborsGeneration_;
 
   // update neighbor holdTime as "NEGOTIATING" process
   neighbor.heartbeatHoldTime = std::max(
@@ -1642,22 +2122,40 @@ Spark::processHeartbeatMsg(
 
 void
 Spark::processPacket() {
-  // receive and parse pkt
-  thrift::SparkHelloPacket helloPacket;
-  std::string ifName;
-  std::chrono::microseconds myRecvTime;
-
-  if (!parsePacket(helloPacket, ifName, myRecvTime)) {
-    return;
-  }
+  // receive all the available packets, up to kMaxPacketsPerRead
+  const auto recvInfos = IoProvider::recvMessages(
+      mcastFd_,
+      recvBuf_.data(),
+      kMinIpv6Mtu,
+      kMaxPacketsPerRead,
+      ioProvider_.get());
+
+  for (size_t i = 0; i < recvInfos.size(); ++i) {
+    // parse pkt
+    thrift::SparkHelloPacket helloPacket;
+    std::string ifName;
+    std::chrono::microseconds myRecvTime;
+
+    if (!parsePacket(
+            recvBuf_.data() + i * kMinIpv6Mtu,
+            recvInfos.at(i),
+            helloPacket,
+            ifName,
+            myRecvTime)) {
+      continue;
+    }
 
-  // Spark specific msg processing
-  if (helloPacket.helloMsg_ref().has_value()) {
-    processHelloMsg(helloPacket.helloMsg_ref().value(), ifName, myRecvTime);
-  } else if (helloPacket.heartbeatMsg_ref().has_value()) {
-    processHeartbeatMsg(helloPacket.heartbeatMsg_ref().value(), ifName);
-  } else if (helloPacket.handshakeMsg_ref().has_value()) {
-    processHandshakeMsg(helloPacket.handshakeMsg_ref().value(), ifName);
+    // Spark specific msg processing
+    if (helloPacket.helloMsg_ref().has_value()) {
+      processHelloMsg(helloPacket.helloMsg_ref().value(), ifName, myRecvTime);
+    } else if (helloPacket.heartbeatMsg_ref().has_value()) {
+      // heartbeat thread receives its own copy of heartbeatMsg
+      if (not heartbeat_) {
+        processHeartbeatMsg(helloPacket.heartbeatMsg_ref().value(), ifName);
+      }
+    } else if (helloPacket.handshakeMsg_ref().has_value()) {
+      processHandshakeMsg(helloPacket.handshakeMsg_ref().value(), ifName);
+    }
   }
 }
 
@@ -1687,39 +2185,47 @@ Spark::sendHelloMsg(
   const auto ifIndex = interfaceEntry.ifIndex;
   const auto v4Addr = interfaceEntry.v4Network.first;
   const auto v6Addr = interfaceEntry.v6LinkLocalNetwork.first;
-  thrift::OpenrVersion openrVer(*kVersion_.version_ref());
 
-  // build the helloMsg from scratch
-  thrift::SparkHelloMsg helloMsg;
-  helloMsg.domainName_ref() = myDomainName_;
-  helloMsg.nodeName_ref() = myNodeName_;
-  helloMsg.ifName_ref() = ifName;
+  // build the static part of helloMsg once per interface
+  auto [helloPacketIt, inserted] = ifNameToHelloPackets_.try_emplace(ifName);
+  auto& helloPacket = helloPacketIt->second;
+  if (inserted) {
+    thrift::SparkHelloMsg helloMsg;
+    helloMsg.domainName_ref() = myDomainName_;
+    helloMsg.nodeName_ref() = myNodeName_;
+    helloMsg.ifName_ref() = ifName;
+    helloMsg.version_ref() = *kVersion_.version_ref();
+    helloPacket.helloMsg_ref() = std::move(helloMsg);
+  }
+
+  // update fields changing between ticks
+  auto& helloMsg = *helloPacket.helloMsg_ref();
   helloMsg.seqNum_ref() = mySeqNum_;
-  helloMsg.neighborInfos_ref() =
-      std::map<std::string, thrift::ReflectedNeighborInfo>{};
-  helloMsg.version_ref() = openrVer;
   helloMsg.solicitResponse_ref() = inFastInitState;
   helloMsg.restarting_ref() = restarting;
   helloMsg.sentTsInUs_ref() = getCurrentTimeInUs().count();
 
-  // bake neighborInfo into helloMsg
-  for (const auto& kv : sparkNeighbors_.at(ifName)) {
-    auto const& neighborName = kv.first;
-    auto const& neighbor = kv.second;
-
-    auto& neighborInfo = helloMsg.neighborInfos_ref()[neighborName];
+  // bake neighborInfo into helloMsg. Drop neighbors gone since last tick and
+  // refresh the rest in place.
+  const auto& neighbors = sparkNeighbors_.at(ifName);
+  auto& neighborInfos = *helloMsg.neighborInfos_ref();
+  for (auto it = neighborInfos.begin(); it != neighborInfos.end();) {
+    if (neighbors.count(it->first)) {
+      ++it;
+    } else {
+      it = neighborInfos.erase(it);
+    }
+  }
+  for (const auto& [neighborName, neighbor] : neighbors) {
+    auto& neighborInfo = neighborInfos[neighborName];
     neighborInfo.seqNum_ref() = neighbor.seqNum;
     neighborInfo.lastNbrMsgSentTsInUs_ref() =
         neighbor.neighborTimestamp.count();
     neighborInfo.lastMyMsgRcvdTsInUs_ref() = neighbor.localTimestamp.count();
   }
 
-  // fill in helloMsg field
-  thrift::SparkHelloPacket helloPacket;
-  helloPacket.helloMsg_ref() = std::move(helloMsg);
-
   // send the payload
-  auto packet = writeThriftObjStr(helloPacket, serializer_);
+  auto& packet = serializePacket(helloPacket);
   folly::SocketAddress dstAddr(
       folly::IPAddress(Constants::kSparkMcastAddr.toString()),
       neighborDiscoveryPort_);
@@ -1746,59 +2252,87 @@ Spark::sendHelloMsg(
   VLOG(4) << "Sent " << bytesSent << " bytes in hello packet";
 }
 
-void
-Spark::processInterfaceUpdates(InterfaceDatabase&& ifDb) {
-  decltype(interfaceDb_) newInterfaceDb{};
-
+std::optional<Spark::Interface>
+Spark::toTrackedInterface(const InterfaceInfo& info) const {
   //
   // To be conisdered a valid interface for Spark to track, it must:
   // - be up
   // - have a v6LinkLocal IP
   // - have an IPv4 addr when v4 is enabled
   //
-  for (const auto& info : ifDb) {
-    // ATTN: multiple networks can be associated with one ifName.
-    //  - Retrieve networks in sorted order;
-    //  - Use the lowest one (other node will do similar)
-    const auto v4Networks = info.getSortedV4Addrs();
-    const auto v6LinkLocalNetworks = info.getSortedV6LinkLocalAddrs();
-
-    if (not info.isUp) {
-      continue;
-    }
-    if (v6LinkLocalNetworks.empty()) {
-      VLOG(2) << "IPv6 link local address not found";
-      continue;
-    }
-    if (enableV4_ and v4Networks.empty()) {
-      VLOG(2) << "IPv4 enabled but no IPv4 addresses are configured";
-      continue;
-    }
+  // ATTN: multiple networks can be associated with one ifName.
+  //  - Retrieve networks in sorted order;
+  //  - Use the lowest one (other node will do similar)
+  const auto v4Networks = info.getSortedV4Addrs();
+  const auto v6LinkLocalNetworks = info.getSortedV6LinkLocalAddrs();
 
-    folly::CIDRNetwork v4Network = enableV4_
-        ? *v4Networks.begin()
-        : folly::IPAddress::createNetwork("0.0.0.0/32");
-    folly::CIDRNetwork v6LinkLocalNetwork = *v6LinkLocalNetworks.begin();
-
-    newInterfaceDb.emplace(
-        info.ifName, Interface(info.ifIndex, v4Network, v6LinkLocalNetwork));
+  if (not info.isUp) {
+    return std::nullopt;
+  }
+  if (v6LinkLocalNetworks.empty()) {
+    VLOG(2) << "IPv6 link local address not found";
+    return std::nullopt;
   }
+  if (enableV4_ and v4Networks.empty()) {
+    VLOG(2) << "IPv4 enabled but no IPv4 addresses are configured";
+    return std::nullopt;
+  }
+
+  folly::CIDRNetwork v4Network = enableV4_
+      ? *v4Networks.begin()
+      : folly::IPAddress::createNetwork("0.0.0.0/32");
+  folly::CIDRNetwork v6LinkLocalNetwork = *v6LinkLocalNetworks.begin();
+  return Interface(info.ifIndex, v4Network, v6LinkLocalNetwork);
+}
+
+void
+Spark::processInterfaceUpdates(InterfaceUpdate&& interfaceUpdate) {
+  // Tracked interfaces out of update. All of them on full sync, otherwise
+  // only the changed ones.
+  decltype(interfaceDb_) newInterfaceDb{};
 
   std::vector<std::string> toAdd{};
   std::vector<std::string> toDel{};
   std::vector<std::string> toUpdate{};
 
-  // iterate old and new interfaceDb to catch difference
-  for (const auto& [oldIfName, oldInterface] : interfaceDb_) {
-    auto it = newInterfaceDb.find(oldIfName);
-    if (it != newInterfaceDb.end()) {
-      if (it->second != oldInterface) {
-        // interface info has changed!
-        toUpdate.emplace_back(oldIfName);
+  for (const auto& info : interfaceUpdate.interfaces) {
+    if (auto interface = toTrackedInterface(info)) {
+      newInterfaceDb.emplace(info.ifName, std::move(*interface));
+    }
+  }
+
+  if (interfaceUpdate.isFullSync) {
+    // iterate old and new interfaceDb to catch difference
+    for (const auto& [oldIfName, oldInterface] : interfaceDb_) {
+      auto it = newInterfaceDb.find(oldIfName);
+      if (it != newInterfaceDb.end()) {
+        if (it->second != oldInterface) {
+          // interface info has changed!
+          toUpdate.emplace_back(oldIfName);
+        }
+      } else {
+        // interface being removed!
+        toDel.emplace_back(oldIfName);
+      }
+    }
+  } else {
+    // Changed interfaces no longer qualifying, and removed ones
+    for (const auto& info : interfaceUpdate.interfaces) {
+      if (interfaceDb_.count(info.ifName) and
+          not newInterfaceDb.count(info.ifName)) {
+        toDel.emplace_back(info.ifName);
+      }
+    }
+    for (const auto& ifName : interfaceUpdate.removedIfNames) {
+      if (interfaceDb_.count(ifName)) {
+        toDel.emplace_back(ifName);
+      }
+    }
+    for (const auto& [newIfName, newInterface] : newInterfaceDb) {
+      auto it = interfaceDb_.find(newIfName);
+      if (it != interfaceDb_.end() and it->second != newInterface) {
+        toUpdate.emplace_back(newIfName);
       }
-    } else {
-      // interface being removed!
-      toDel.emplace_back(oldIfName);
     }
   }
 
@@ -1824,6 +2358,7 @@ Spark::processInterfaceUpdates(InterfaceDatabase&& ifDb) {
 
 void
 Spark::deleteInterface(const std::vector<std::string>& toDel) {
+  const folly::IPAddress mcastGroup(Constants::kSparkMcastAddr);
   for (const auto& ifName : toDel) {
     LOG(INFO) << "Removing " << ifName << " from Spark. "
               << "It is down, declaring all neighbors down";
@@ -1847,13 +2382,15 @@ Spark::deleteInterface(const std::vector<std::string>& toDel) {
       neighborDownWrapper(neighbor, ifName, neighborName);
     }
     sparkNeighbors_.erase(ifName);
+    ifNameToAreas_.erase(ifName);
+    ++neighborsGeneration_;
     ifNameToHeartbeatTimers_.erase(ifName);
 
     // unsubscribe the socket from mcast group on this interface
     // On error, log and continue
     if (!toggleMcastGroup(
             mcastFd_,
-            folly::IPAddress(Constants::kSparkMcastAddr.toString()),
+            mcastGroup,
             interfaceDb_.at(ifName).ifIndex,
             false /* leave */,
             ioProvider_.get())) {
@@ -1862,15 +2399,32 @@ Spark::deleteInterface(const std::vector<std::string>& toDel) {
     }
     // cleanup for this interface
     ifNameToHelloTimers_.erase(ifName);
+    ifNameToHelloPackets_.erase(ifName);
+    ifNameToHelloBackoff_.erase(ifName);
+    ifIndexToName_.erase(interfaceDb_.at(ifName).ifIndex);
     interfaceDb_.erase(ifName);
   }
+  if (heartbeat_) {
+    heartbeat_->removeInterfaces(toDel);
+  }
 }
 
 void
 Spark::addInterface(
     const std::vector<std::string>& toAdd,
     const std::unordered_map<std::string, Interface>& newInterfaceDb) {
+  // interfaces added together (e.g. on startup) get their first hello spread
+  // evenly across one fast-init interval, and their first heartbeat across
+  // one keep-alive interval, to avoid a burst of multicast
+  const folly::IPAddress mcastGroup(Constants::kSparkMcastAddr);
+  std::vector<SparkHeartbeat::InterfaceInfo> heartbeatInterfaces;
+  size_t addIndex = 0;
   for (const auto& ifName : toAdd) {
+    const std::chrono::milliseconds spreadOffset =
+        fastInitHelloTime_ * addIndex / toAdd.size();
+    const std::chrono::milliseconds heartbeatSpreadOffset =
+        keepAliveTime_ * addIndex / toAdd.size();
+    ++addIndex;
     auto newInterface = newInterfaceDb.at(ifName);
     auto ifIndex = newInterface.ifIndex;
     CHECK_NE(ifIndex, 0) << "Could not get ifIndex for Iface " << ifName;
@@ -1881,7 +2435,7 @@ Spark::addInterface(
     // We throw an error on the first one to encounter a problem
     if (!toggleMcastGroup(
             mcastFd_,
-            folly::IPAddress(Constants::kSparkMcastAddr.toString()),
+            mcastGroup,
             ifIndex,
             true /* join */,
             ioProvider_.get())) {
@@ -1892,17 +2446,27 @@ Spark::addInterface(
     {
       auto result = interfaceDb_.emplace(ifName, newInterface);
       CHECK(result.second);
+      ifIndexToName_[ifIndex] = ifName;
     }
 
     {
       // create place-holders for newly added interface
       auto result = sparkNeighbors_.emplace(
-          ifName, std::unordered_map<std::string, SparkNeighbor>{});
+          ifName, folly::F14NodeMap<std::string, SparkNeighbor>{});
       CHECK(result.second);
+      ifNameToAreas_[ifName].areas =
+          getInterfaceAreas(ifName, config_->getAreas());
+
+    }
 
+    if (heartbeat_) {
+      // heartbeatMsg is sent by heartbeat thread
+      heartbeatInterfaces.emplace_back(SparkHeartbeat::InterfaceInfo{
+          ifName, ifIndex, newInterface.v6LinkLocalNetwork.first.asV6()});
+    } else {
       // heartbeatTimers will start as soon as intf is in UP state
       auto heartbeatTimer =
-          folly::AsyncTimeout::make(*getEvb(), [this, ifName]() noexcept {
+          SparkTimeout::make(getEvb()->timer(), [this, ifName]() noexcept {
             sendHeartbeatMsg(ifName);
             // schedule heartbeatTimers periodically as soon as intf is UP
             ifNameToHeartbeatTimers_.at(ifName)->scheduleTimeout(
@@ -1910,30 +2474,18 @@ Spark::addInterface(
           });
 
       ifNameToHeartbeatTimers_.emplace(ifName, std::move(heartbeatTimer));
-      ifNameToHeartbeatTimers_.at(ifName)->scheduleTimeout(keepAliveTime_);
+      ifNameToHeartbeatTimers_.at(ifName)->scheduleTimeout(
+          keepAliveTime_ + heartbeatSpreadOffset);
     }
 
-    auto rollHelper = [](std::chrono::milliseconds timeDuration) {
-      auto base = timeDuration.count();
-      std::uniform_int_distribution<int> distribution(-0.2 * base, 0.2 * base);
-      std::default_random_engine generator;
-      return [timeDuration, distribution, generator]() mutable {
-        return timeDuration +
-            std::chrono::milliseconds(distribution(generator));
-      };
-    };
-
-    auto roll = rollHelper(helloTime_);
-    auto rollFast = rollHelper(fastInitHelloTime_);
     auto timePoint = std::chrono::steady_clock::now();
 
     // NOTE: We do not send hello packet immediately after adding new interface
     // this is due to the fact that it may not have yet configured a link-local
     // address. The hello packet will be sent later and will have good chances
     // of making it out if small delay is introduced.
-    auto helloTimer = folly::AsyncTimeout::make(
-        *getEvb(),
-        [this, ifName, timePoint, roll, rollFast]() mutable noexcept {
+    auto helloTimer = SparkTimeout::make(
+        getEvb()->timer(), [this, ifName, timePoint]() noexcept {
           VLOG(3) << "Sending hello multicast packet on interface " << ifName;
           bool inFastInitState = false;
           // Under Spark context, hello pkt will be sent in relatively low
@@ -1947,24 +2499,72 @@ Spark::addInterface(
 
           sendHelloMsg(ifName, inFastInitState);
 
-          // Schedule next run (add 20% variance)
-          // overriding timeoutPeriod if I am in fast initial state
-          std::chrono::milliseconds timeoutPeriod =
-              inFastInitState ? rollFast() : roll();
+          // Schedule next run, overriding timeoutPeriod if I am in fast
+          // initial state
+          std::chrono::milliseconds timeoutPeriod = inFastInitState
+              ? addJitter(fastInitHelloTime_)
+              : getHelloInterval(ifName);
 
           ifNameToHelloTimers_.at(ifName)->scheduleTimeout(timeoutPeriod);
         });
 
     // should be in fast init state when the node just starts
-    helloTimer->scheduleTimeout(rollFast());
+    helloTimer->scheduleTimeout(addJitter(fastInitHelloTime_) + spreadOffset);
     ifNameToHelloTimers_[ifName] = std::move(helloTimer);
   }
+  if (heartbeat_) {
+    heartbeat_->addInterfaces(std::move(heartbeatInterfaces));
+  }
+}
+
+std::chrono::milliseconds
+Spark::addJitter(std::chrono::milliseconds timeDuration) {
+  // add 20% variance
+  auto const base = timeDuration.count();
+  std::uniform_int_distribution<int64_t> distribution(-0.2 * base, 0.2 * base);
+  return timeDuration + std::chrono::milliseconds(distribution(jitterGen_));
+}
+
+std::chrono::milliseconds
+Spark::getHelloInterval(std::string const& ifName) {
+  auto& backoff = ifNameToHelloBackoff_[ifName];
+  auto const interval = addJitter(helloTime_ * (1 << backoff));
+
+  // Back off if all neighbors on interface are established. New or restarting
+  // neighbors solicit a response with their fast-init hellos, hence they are
+  // still discovered quickly.
+  bool isStable = true;
+  for (auto const& [_, neighbor] : sparkNeighbors_.at(ifName)) {
+    if (neighbor.state != SparkNeighState::ESTABLISHED) {
+      isStable = false;
+      break;
+    }
+  }
+  backoff = isStable ? std::min(backoff + 1, kMaxHelloBackoffExp) : 0;
+  return interval;
+}
+
+void
+Spark::resetHelloBackoff(std::string const& ifName) {
+  auto it = ifNameToHelloBackoff_.find(ifName);
+  if (it == ifNameToHelloBackoff_.end() or it->second == 0) {
+    return;
+  }
+  it->second = 0;
+
+  // next hello may be scheduled far out with previous backoff
+  auto timerIt = ifNameToHelloTimers_.find(ifName);
+  if (timerIt != ifNameToHelloTimers_.end()) {
+    timerIt->second->scheduleTimeout(addJitter(helloTime_));
+  }
 }
 
 void
 Spark::updateInterface(
     const std::vector<std::string>& toUpdate,
     const std::unordered_map<std::string, Interface>& newInterfaceDb) {
+  const folly::IPAddress mcastGroup(Constants::kSparkMcastAddr);
+  std::vector<SparkHeartbeat::InterfaceInfo> heartbeatInterfaces;
   for (const auto& ifName : toUpdate) {
     auto& interface = interfaceDb_.at(ifName);
     auto& newInterface = newInterfaceDb.at(ifName);
@@ -1976,7 +2576,7 @@ Spark::updateInterface(
       // On error, log and continue
       if (!toggleMcastGroup(
               mcastFd_,
-              folly::IPAddress(Constants::kSparkMcastAddr.toString()),
+              mcastGroup,
               interface.ifIndex,
               false /* leave */,
               ioProvider_.get())) {
@@ -1988,7 +2588,7 @@ Spark::updateInterface(
       // We throw an error on the first one to encounter a problem
       if (!toggleMcastGroup(
               mcastFd_,
-              folly::IPAddress(Constants::kSparkMcastAddr.toString()),
+              mcastGroup,
               newInterface.ifIndex,
               true /* join */,
               ioProvider_.get())) {
@@ -2004,18 +2604,28 @@ Spark::updateInterface(
               << newInterface.v6LinkLocalNetwork.first << " , "
               << newInterface.v4Network.first << ")";
 
+    ifIndexToName_.erase(interface.ifIndex);
+    ifIndexToName_[newInterface.ifIndex] = ifName;
     interface = std::move(newInterface);
+    if (heartbeat_) {
+      heartbeatInterfaces.emplace_back(SparkHeartbeat::InterfaceInfo{
+          ifName,
+          interface.ifIndex,
+          interface.v6LinkLocalNetwork.first.asV6()});
+    }
+  }
+  if (heartbeat_) {
+    heartbeat_->addInterfaces(std::move(heartbeatInterfaces));
   }
 }
 
 std::optional<std::string>
 Spark::findInterfaceFromIfindex(int ifIndex) {
-  for (const auto& kv : interfaceDb_) {
-    if (kv.second.ifIndex == ifIndex) {
-      return kv.first;
-    }
+  auto it = ifIndexToName_.find(ifIndex);
+  if (it == ifIndexToName_.end()) {
+    return std::nullopt;
   }
-  return std::nullopt;
+  return it->second;
 }
 
 int32_t
@@ -2101,38 +2711,66 @@ Spark::updateGlobalCounters() {
 std::optional<std::string>
 Spark::getNeighborArea(
     const std::string& peerNodeName,
-    const std::string& localIfName,
+    const std::vector<std::string>& interfaceAreas,
     const std::unordered_map<std::string /* areaId */, AreaConfiguration>&
         areaConfigs) {
-  // IMPT: ordered set. Function yeilds lowest areaId in case of multiple
-  // candidate areas
-  std::set<std::string> candidateAreas{};
+  // IMPT: interface areas are ordered. Function yeilds lowest areaId in case
+  // of multiple candidate areas
+  std::optional<std::string> candidateArea;
+  size_t numCandidateAreas{0};
 
-  // looping through areaIdRegexList
-  for (const auto& [areaId, areaConfig] : areaConfigs) {
-    if (areaConfig.shouldDiscoverOnIface(localIfName) &&
-        areaConfig.shouldPeerWithNeighbor(peerNodeName)) {
+  for (const auto& areaId : interfaceAreas) {
+    if (areaConfigs.at(areaId).shouldPeerWithNeighbor(peerNodeName)) {
       VLOG(1) << fmt::format(
-          "Area: {} found for neighbor: {} on interface: {}",
-          areaId,
-          peerNodeName,
-          localIfName);
-      candidateAreas.insert(areaId);
+          "Area: {} found for neighbor: {}", areaId, peerNodeName);
+      if (not candidateArea.has_value()) {
+        candidateArea = areaId;
+      }
+      ++numCandidateAreas;
     }
   }
 
-  if (candidateAreas.empty()) {
+  if (not candidateArea.has_value()) {
     LOG(ERROR) << "No matching area found for neighbor: " << peerNodeName;
     fb303::fbData->addStatValue("spark.neighbor_no_area", 1, fb303::COUNT);
-    return std::nullopt;
-  } else if (candidateAreas.size() > 1) {
-    LOG(ERROR)
-        << "Multiple area found for neighbor: " << peerNodeName
-        << ". Will use lowest candidate area: " << *candidateAreas.begin();
+  } else if (numCandidateAreas > 1) {
+    LOG(ERROR) << "Multiple area found for neighbor: " << peerNodeName
+               << ". Will use lowest candidate area: " << *candidateArea;
     fb303::fbData->addStatValue(
         "spark.neighbor_multiple_area", 1, fb303::COUNT);
   }
-  return *candidateAreas.begin();
+  return candidateArea;
+}
+
+std::vector<std::string>
+Spark::getInterfaceAreas(
+    const std::string& ifName,
+    const std::unordered_map<std::string /* areaId */, AreaConfiguration>&
+        areaConfigs) {
+  std::vector<std::string> areas;
+  for (const auto& [areaId, areaConfig] : areaConfigs) {
+    if (areaConfig.shouldDiscoverOnIface(ifName)) {
+      areas.emplace_back(areaId);
+    }
+  }
+  std::sort(areas.begin(), areas.end());
+  return areas;
+}
+
+std::optional<std::string>
+Spark::getNeighborAreaCached(
+    const std::string& peerNodeName, const std::string& ifName) {
+  auto& ifAreas = ifNameToAreas_.at(ifName);
+  auto it = ifAreas.neighborAreas.find(peerNodeName);
+  if (it == ifAreas.neighborAreas.end()) {
+    it = ifAreas.neighborAreas
+             .emplace(
+                 peerNodeName,
+                 getNeighborArea(
+                     peerNodeName, ifAreas.areas, config_->getAreas()))
+             .first;
+  }
+  return it->second;
 }
 
 void
@@ -8,11 +8,19 @@
 #pragma once
 
 #include <fmt/format.h>
+#include <atomic>
 #include <chrono>
 #include <functional>
+#include <optional>
+#include <random>
+#include <thread>
 
 #include <folly/SocketAddress.h>
+#include <folly/Function.h>
+#include <folly/Random.h>
+#include <folly/container/F14Map.h>
 #include <folly/io/async/AsyncTimeout.h>
+#include <folly/io/async/HHWheelTimer.h>
 #include <folly/stats/BucketedTimeSeries.h>
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 
@@ -30,6 +38,140 @@
 
 namespace openr {
 
+//
+// Timeout scheduled on HHWheelTimer of the event base. Spark keeps several
+// timers per interface and neighbor, which are rescheduled on every received
+// packet. Wheel timer offers O(1) schedule and cancel unlike the timer heap of
+// the event base used by folly::AsyncTimeout, whose API this resembles.
+//
+class SparkTimeout : public folly::HHWheelTimer::Callback {
+ public:
+  static std::unique_ptr<SparkTimeout>
+  make(folly::HHWheelTimer& timer, folly::Function<void()> callback) {
+    return std::unique_ptr<SparkTimeout>(
+        new SparkTimeout(timer, std::move(callback)));
+  }
+
+  // Schedule (or re-schedule) the timeout
+  void
+  scheduleTimeout(std::chrono::milliseconds timeout) {
+    timer_.scheduleTimeout(this, timeout);
+  }
+
+  void
+  timeoutExpired() noexcept override {
+    callback_();
+  }
+
+ private:
+  SparkTimeout(folly::HHWheelTimer& timer, folly::Function<void()> callback)
+      : timer_(timer), callback_(std::move(callback)) {}
+
+  folly::HHWheelTimer& timer_;
+  folly::Function<void()> callback_;
+};
+
+//
+// Optional dedicated thread handling only heartbeats: it sends heartbeatMsg on
+// interfaces with established neighbors, receives heartbeatMsg and runs the
+// heartbeat hold-timers. Failure detection is thus not delayed by hello and
+// handshake processing, interface updates etc. on the Spark thread. Expiry of
+// a hold-timer is reported via callback invoked in heartbeat thread.
+//
+// It listens on its own socket bound to the neighbor discovery port. Kernel
+// delivers copy of every multicast packet to all sockets bound to the port
+// with SO_REUSEADDR. Packets other than heartbeatMsg are ignored.
+//
+// All public APIs are thread-safe and are applied asynchronously.
+//
+class SparkHeartbeat final : public OpenrEventBase {
+ public:
+  using HoldTimerCallback = folly::Function<void(
+      std::string const& ifName,
+      std::string const& neighborName,
+      uint64_t version) noexcept>;
+
+  SparkHeartbeat(
+      std::string const& myNodeName,
+      int sockFd,
+      uint16_t neighborDiscoveryPort,
+      std::chrono::milliseconds keepAliveTime,
+      bool batchedSend,
+      std::shared_ptr<IoProvider> ioProvider,
+      HoldTimerCallback holdTimerCallback);
+
+  struct InterfaceInfo {
+    std::string ifName;
+    int ifIndex{0};
+    folly::IPAddressV6 v6Addr;
+  };
+
+  // Start/stop listening for heartbeatMsg on interfaces. Interfaces added or
+  // removed together are handed over to heartbeat thread at once.
+  void addInterfaces(std::vector<InterfaceInfo> interfaces);
+  void removeInterfaces(std::vector<std::string> ifNames);
+
+  // Start/stop sending heartbeatMsg on interface
+  void setInterfaceActive(std::string const& ifName, bool active);
+
+  // (Re)start hold-timer for neighbor. Every heartbeatMsg received from
+  // neighbor re-arms it. `version` is passed back to callback on expiry.
+  void scheduleHoldTimer(
+      std::string const& ifName,
+      std::string const& neighborName,
+      std::chrono::milliseconds holdTime,
+      uint64_t version);
+  void cancelHoldTimer(
+      std::string const& ifName, std::string const& neighborName);
+
+ private:
+  struct Interface {
+    int ifIndex{0};
+    folly::IPAddressV6 v6Addr;
+    bool active{false};
+  };
+
+  struct HoldTimer {
+    std::unique_ptr<SparkTimeout> timer;
+    std::chrono::milliseconds holdTime{0};
+  };
+
+  // receive packets and re-arm hold-timers on heartbeatMsg
+  void processPacket();
+
+  // drop expired hold-timer and report it via callback
+  void processHoldTimeout(
+      std::string ifName, std::string neighborName, uint64_t version);
+
+  // send heartbeatMsg on all active interfaces
+  void sendHeartbeatMsgs();
+
+  // send heartbeatMsg on all active interfaces with a single syscall
+  void sendHeartbeatMsgsBatched();
+
+  const std::string myNodeName_;
+  const int mcastFd_{-1};
+  const uint16_t neighborDiscoveryPort_{0};
+  const std::chrono::milliseconds keepAliveTime_{0};
+  const bool batchedSend_{false};
+  std::shared_ptr<IoProvider> ioProvider_{nullptr};
+  HoldTimerCallback holdTimerCallback_;
+
+  std::unordered_map<std::string /* ifName */, Interface> interfaces_;
+  std::unordered_map<int /* ifIndex */, std::string /* ifName */>
+      ifIndexToName_;
+  std::unordered_map<
+      std::string /* ifName */,
+      std::unordered_map<std::string /* neighborName */, HoldTimer>>
+      holdTimers_;
+
+  std::unique_ptr<SparkTimeout> keepAliveTimer_{nullptr};
+  int64_t seqNum_{1};
+  thrift::SparkHeartbeatMsg heartbeatMsg_;
+  apache::thrift::CompactSerializer serializer_;
+  std::vector<uint8_t> recvBuf_;
+};
+
 enum class PacketValidationResult {
   SUCCESS = 1,
   FAILURE = 2,
@@ -78,7 +220,7 @@ class Spark final : public OpenrEventBase {
  public:
   Spark(
       // consumer Queue
-      messaging::RQueue<InterfaceDatabase> interfaceUpdatesQueue,
+      messaging::RQueue<InterfaceUpdate> interfaceUpdatesQueue,
       // producer Queue
       messaging::ReplicateQueue<NeighborEvents>& nbrUpdatesQueue,
       // raw ptr of modules
@@ -90,13 +232,20 @@ class Spark final : public OpenrEventBase {
       // rate limit
       std::optional<uint32_t> maybeMaxAllowedPps = Constants::kMaxAllowedPps);
 
-  ~Spark() override = default;
+  ~Spark() override;
 
   // Public APIs
   folly::SemiFuture<folly::Unit> floodRestartingMsg();
   folly::SemiFuture<std::unique_ptr<std::vector<thrift::SparkNeighbor>>>
   getNeighbors();
 
+  // Generation of neighbors returned by getNeighbors(), changes whenever any
+  // of them changes. Thread safe.
+  int64_t
+  getNeighborsGeneration() const {
+    return neighborsGeneration_.load();
+  }
+
   // get the current state of neighborNode, used for unit-testing
   folly::SemiFuture<std::optional<SparkNeighState>> getSparkNeighState(
       std::string const& ifName, std::string const& neighborName);
@@ -110,6 +259,11 @@ class Spark final : public OpenrEventBase {
   // Turn on the throwing of parsing errors.
   void setThrowParserErrors(bool);
 
+  // Apply config reloaded from file, see `ConfigUpdate`. Neighbor regexes of
+  // areas apply to neighbors discovered from now on, established ones keep
+  // their area.
+  folly::SemiFuture<folly::Unit> processConfigUpdate(ConfigUpdate update);
+
  private:
   //
   // Interface tracking
@@ -142,6 +296,9 @@ class Spark final : public OpenrEventBase {
   // Initializes UDP socket for multicast neighbor discovery
   void prepareSocket() noexcept;
 
+  // Starts heartbeat thread if enabled, see SparkHeartbeat
+  void startHeartbeatThread();
+
   // check neighbor's hello packet; return true if packet is valid and
   // passed the following checks:
   // (1) neighbor is not self (packet not looped back)
@@ -155,8 +312,9 @@ class Spark final : public OpenrEventBase {
   bool shouldProcessHelloPacket(
       std::string const& ifName, folly::IPAddress const& addr);
 
-  // process hello packet from a neighbor. we want to see if
-  // the neighbor could be added as adjacent peer.
+  // process hello packets from neighbors. we want to see if
+  // the neighbor could be added as adjacent peer. All the packets available
+  // on socket (up to a limit) are received and processed at once.
   void processPacket();
 
   // process helloMsg in Spark context
@@ -179,6 +337,16 @@ class Spark final : public OpenrEventBase {
       bool inFastInitState = false,
       bool restarting = false);
 
+  // randomize given duration by +/- 20% to desynchronize periodic packets
+  std::chrono::milliseconds addJitter(std::chrono::milliseconds timeDuration);
+
+  // interval till next regular hello on interface. Backs off exponentially
+  // while all neighbors on the interface are established
+  std::chrono::milliseconds getHelloInterval(std::string const& ifName);
+
+  // resume regular hello interval on interface
+  void resetHelloBackoff(std::string const& ifName);
+
   // util call to send handshake msg
   void sendHandshakeMsg(
       std::string const& ifName,
@@ -189,9 +357,15 @@ class Spark final : public OpenrEventBase {
   // util call to send heartbeat msg
   void sendHeartbeatMsg(std::string const& ifName);
 
+  // serialize hello/heartbeat packet into sendBuf_ and return it
+  std::string const& serializePacket(thrift::SparkHelloPacket const& pkt);
+
   // Function processes interface updates from LinkMonitor and appropriately
   // enable/disable neighbor discovery
-  void processInterfaceUpdates(InterfaceDatabase&& interfaceUpdates);
+  void processInterfaceUpdates(InterfaceUpdate&& interfaceUpdate);
+
+  // Interface to track for `info`, if it qualifies for neighbor discovery
+  std::optional<Interface> toTrackedInterface(const InterfaceInfo& info) const;
 
   // util function to delete interface in spark
   void deleteInterface(const std::vector<std::string>& toDel);
@@ -232,7 +406,8 @@ class Spark final : public OpenrEventBase {
   // This is util function to deduce `areaId` from neighbor during helloMsg
   // processing by leveraging:
   //
-  //  1). interface from which helloMsg received;
+  //  1). interface from which helloMsg received, i.e. areas whose interface
+  //      regexes match it, see getInterfaceAreas();
   //  2). neighbor's nodeName;
   //
   // against `thrift::AreaConfig` parsed by Spark. It support both
@@ -241,12 +416,24 @@ class Spark final : public OpenrEventBase {
   // if needed.
   static std::optional<std::string> getNeighborArea(
       const std::string& peerNodeName,
+      const std::vector<std::string>& interfaceAreas,
+      const std::unordered_map<std::string /* areaId */, AreaConfiguration>&
+          areaConfigs);
+
+  // areas to discover neighbors on interface in, in ascending order of areaId
+  static std::vector<std::string> getInterfaceAreas(
       const std::string& ifName,
       const std::unordered_map<std::string /* areaId */, AreaConfiguration>&
           areaConfigs);
 
-  // function to receive and parse received pkt
+  // getNeighborArea() of neighbor on tracked interface, memoized
+  std::optional<std::string> getNeighborAreaCached(
+      const std::string& peerNodeName, const std::string& ifName);
+
+  // function to parse received pkt
   bool parsePacket(
+      const uint8_t* buf /* received data */,
+      const IoProvider::RecvMessageInfo& recvInfo /* info of received data */,
       thrift::SparkHelloPacket& pkt /* packet( type will be renamed later) */,
       std::string& ifName /* interface */,
       std::chrono::microseconds& recvTime /* kernel timestamp when recved */);
@@ -333,16 +520,20 @@ class Spark final : public OpenrEventBase {
     SparkNeighState state{SparkNeighState::IDLE};
 
     // timer to periodically send out handshake pkt
-    std::unique_ptr<folly::AsyncTimeout> negotiateTimer{nullptr};
+    std::unique_ptr<SparkTimeout> negotiateTimer{nullptr};
 
     // negotiate stage hold-timer
-    std::unique_ptr<folly::AsyncTimeout> negotiateHoldTimer{nullptr};
+    std::unique_ptr<SparkTimeout> negotiateHoldTimer{nullptr};
 
-    // heartbeat hold-timer
-    std::unique_ptr<folly::AsyncTimeout> heartbeatHoldTimer{nullptr};
+    // heartbeat hold-timer. With heartbeat thread enabled, timer is run by
+    // heartbeat thread and this one is never scheduled but marks it as armed.
+    std::unique_ptr<SparkTimeout> heartbeatHoldTimer{nullptr};
+
+    // version of the last hold-timer armed on heartbeat thread
+    uint64_t heartbeatHoldTimerVersion{0};
 
     // graceful restart hold-timer
-    std::unique_ptr<folly::AsyncTimeout> gracefulRestartHoldTimer{nullptr};
+    std::unique_ptr<SparkTimeout> gracefulRestartHoldTimer{nullptr};
 
     // KvStore related port. Info passed to LinkMonitor for neighborEvent
     int32_t kvStoreCmdPort{0};
@@ -408,10 +599,14 @@ class Spark final : public OpenrEventBase {
       std::string const& ifName,
       std::string const& neighborName);
 
-  // utility call to send SparkNeighborEvent
+  // utility call to send SparkNeighborEvent. Events are published in a batch
+  // at the end of current event loop iteration
   void notifySparkNeighborEvent(
       NeighborEventType type, thrift::SparkNeighbor const& info);
 
+  // publish neighbor events collected in current event loop iteration
+  void flushNeighborEvents();
+
   // callback function for rtt change
   void processRttChange(
       std::string const& ifName,
@@ -428,6 +623,24 @@ class Spark final : public OpenrEventBase {
   void processHeartbeatTimeout(
       std::string const& ifName, std::string const& neighborName);
 
+  // (re)start heartbeat hold-timer of neighbor, on heartbeat thread if enabled
+  void scheduleHeartbeatHoldTimer(
+      std::string const& ifName,
+      std::string const& neighborName,
+      SparkNeighbor& neighbor);
+
+  // stop heartbeat hold-timer of neighbor
+  void cancelHeartbeatHoldTimer(
+      std::string const& ifName,
+      std::string const& neighborName,
+      SparkNeighbor& neighbor);
+
+  // process hold-timer expiry reported by heartbeat thread
+  void processHeartbeatThreadTimeout(
+      std::string const& ifName,
+      std::string const& neighborName,
+      uint64_t version);
+
   // process timeout for negotiate stage
   void processNegotiateTimeout(
       std::string const& ifName, std::string const& neighborName);
@@ -505,6 +718,9 @@ class Spark final : public OpenrEventBase {
   // Queue to publish neighbor events
   messaging::ReplicateQueue<NeighborEvents>& neighborUpdatesQueue_;
 
+  // Neighbor events waiting to be published at the end of loop iteration
+  NeighborEvents pendingNeighborEvents_;
+
   // this is used to inform peers about my kvstore tcp ports
   const uint16_t kOpenrCtrlThriftPort_{0};
 
@@ -514,21 +730,47 @@ class Spark final : public OpenrEventBase {
   // Map of interface entries keyed by ifName
   std::unordered_map<std::string, Interface> interfaceDb_{};
 
-  std::unordered_map<
+  // Map of ifIndex to ifName of tracked interfaces, for received packets
+  folly::F14FastMap<int /* ifIndex */, std::string /* ifName */>
+      ifIndexToName_{};
+
+  // Neighbors tracked on each interface. Node maps keep address of every
+  // SparkNeighbor stable for its lifetime, hence timers owned by a neighbor
+  // can refer to it directly instead of looking it up by names.
+  folly::F14NodeMap<
       std::string /* ifName */,
-      std::unordered_map<std::string /* neighborName */, SparkNeighbor>>
+      folly::F14NodeMap<std::string /* neighborName */, SparkNeighbor>>
       sparkNeighbors_{};
 
+  // Areas of each tracked interface, and area deduced for every neighbor
+  // name heard on it. Area regexes are run once per interface and neighbor
+  // rather than for every hello of a new neighbor, e.g. during fast-init.
+  // Area configuration is fixed for the life of Spark, hence entries only
+  // go away along with their interface.
+  struct InterfaceAreas {
+    std::vector<std::string> areas;
+    std::unordered_map<
+        std::string /* neighborName */,
+        std::optional<std::string> /* areaId */>
+        neighborAreas;
+  };
+  std::unordered_map<std::string /* ifName */, InterfaceAreas>
+      ifNameToAreas_{};
+
+  // Incremented on every change of `sparkNeighbors_` visible in
+  // getNeighbors()
+  std::atomic<int64_t> neighborsGeneration_{0};
+
   // Hello packet send timers for each interface
   std::unordered_map<
       std::string /* ifName */,
-      std::unique_ptr<folly::AsyncTimeout>>
+      std::unique_ptr<SparkTimeout>>
       ifNameToHelloTimers_{};
 
   // heartbeat packet send timers for each interface
   std::unordered_map<
       std::string /* ifName */,
-      std::unique_ptr<folly::AsyncTimeout>>
+      std::unique_ptr<SparkTimeout>>
       ifNameToHeartbeatTimers_{};
 
   // number of active neighbors for each interface
@@ -548,6 +790,33 @@ class Spark final : public OpenrEventBase {
   // instances, hence the shared_ptr
   std::shared_ptr<IoProvider> ioProvider_{nullptr};
 
+  // Buffer to receive batch of packets in
+  std::vector<uint8_t> recvBuf_;
+
+  // Dedicated heartbeat thread, if enabled
+  std::unique_ptr<SparkHeartbeat> heartbeat_{nullptr};
+  std::thread heartbeatThread_;
+  int heartbeatFd_{-1};
+  uint64_t heartbeatHoldTimerVersion_{0};
+
+  // Buffer to serialize outgoing hello/heartbeat packets into
+  std::string sendBuf_;
+
+  // hello and heartbeat packets sent periodically. Static fields are filled
+  // once and only the fields changing between ticks are updated before
+  // serialization.
+  std::unordered_map<std::string /* ifName */, thrift::SparkHelloPacket>
+      ifNameToHelloPackets_{};
+  thrift::SparkHelloPacket heartbeatPacket_;
+
+  // exponent of hello interval backoff on stable interfaces
+  std::unordered_map<std::string /* ifName */, uint32_t>
+      ifNameToHelloBackoff_{};
+
+  // random engine for hello jitter, seeded per instance so that timers of
+  // different interfaces and nodes do not fire in lockstep
+  std::default_random_engine jitterGen_{folly::Random::rand32()};
+
   // vector of BucketedTimeSeries to make sure we don't take too many
   // hello packets from any one iface, address pair
   std::vector<folly::BucketedTimeSeries<int64_t, std::chrono::steady_clock>>
@@ -90,7 +90,7 @@ class SparkWrapper {
       neighborUpdatesQueue_.getReader()};
 
   // Queue to receive interface update from LinkMonitor
-  messaging::ReplicateQueue<InterfaceDatabase> interfaceUpdatesQueue_;
+  messaging::ReplicateQueue<InterfaceUpdate> interfaceUpdatesQueue_;
 
   // Spark owned by this wrapper.
   std::shared_ptr<Spark> spark_{nullptr};
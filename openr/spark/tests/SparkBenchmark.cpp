@@ -0,0 +1,432 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <pthread.h>
+#include <sys/resource.h>
+#include <time.h>
+
+#include <folly/Benchmark.h>
+#include <folly/Format.h>
+#include <folly/init/Init.h>
+
+#include <openr/common/Types.h>
+#include <openr/config/Config.h>
+#include <openr/config/tests/Utils.h>
+#include <openr/spark/SparkWrapper.h>
+#include <openr/tests/mocks/MockIoProvider.h>
+
+namespace {
+
+const std::string kDomainName{"domain"};
+
+// Give up waiting for neighbor events after this long
+const std::chrono::seconds kEventTimeout(120);
+
+// Latency of every emulated link
+const int32_t kLinkLatencyMs{1};
+
+// (local interface, neighbor node) of an adjacency reported by Spark
+using Adjacency = std::pair<std::string, std::string>;
+
+std::string
+getDutIfName(uint32_t iface) {
+  return fmt::format("dut-if{}", iface);
+}
+
+std::string
+getNeighborName(uint32_t neighbor) {
+  return fmt::format("neighbor{}", neighbor);
+}
+
+std::string
+getNeighborIfName(uint32_t neighbor, uint32_t iface) {
+  return fmt::format("neighbor{}-if{}", neighbor, iface);
+}
+
+// CPU time (user + system) consumed by this process
+std::chrono::microseconds
+getProcessCpuTime() {
+  struct rusage usage;
+  CHECK_EQ(0, getrusage(RUSAGE_SELF, &usage));
+  auto toUs = [](struct timeval const& tv) {
+    return std::chrono::seconds(tv.tv_sec) +
+        std::chrono::microseconds(tv.tv_usec);
+  };
+  return toUs(usage.ru_utime) + toUs(usage.ru_stime);
+}
+
+// CPU time consumed by given thread
+std::chrono::microseconds
+getThreadCpuTime(std::thread& thread) {
+  clockid_t clockId;
+  CHECK_EQ(0, pthread_getcpuclockid(thread.native_handle(), &clockId));
+  struct timespec ts;
+  CHECK_EQ(0, clock_gettime(clockId, &ts));
+  return std::chrono::seconds(ts.tv_sec) +
+      std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::nanoseconds(ts.tv_nsec));
+}
+} // namespace
+
+namespace openr {
+
+/**
+ * Device under test (DUT) with #numIfaces interfaces. Every interface is
+ * connected to one interface of each of #numNeighbors neighbor nodes, forming
+ * numIfaces * numNeighbors adjacencies on DUT. Neighbors don't see each other.
+ *
+ * All nodes are Spark instances talking over MockIoProvider.
+ */
+class SparkScaleFixture {
+ public:
+  SparkScaleFixture(
+      uint32_t numIfaces, uint32_t numNeighbors, double packetLossRate)
+      : numIfaces_(numIfaces), numNeighbors_(numNeighbors) {
+    mockIoProvider_ = std::make_shared<MockIoProvider>();
+    mockIoProviderThread_ = std::thread([this]() {
+      mockIoProvider_->start();
+    });
+    mockIoProvider_->waitUntilRunning();
+    mockIoProvider_->setPacketLossRate(packetLossRate);
+
+    // Every interface gets globally unique ifIndex and link-local address
+    IfNameAndifIndex ifIndexes;
+    int ifIndex{0};
+    for (uint32_t iface = 0; iface < numIfaces_; ++iface) {
+      ifIndexes.emplace_back(getDutIfName(iface), ++ifIndex);
+    }
+    for (uint32_t neighbor = 0; neighbor < numNeighbors_; ++neighbor) {
+      for (uint32_t iface = 0; iface < numIfaces_; ++iface) {
+        ifIndexes.emplace_back(getNeighborIfName(neighbor, iface), ++ifIndex);
+      }
+    }
+    mockIoProvider_->addIfNameIfIndex(ifIndexes);
+    for (auto const& [ifName, index] : ifIndexes) {
+      ifNameToIndex_.emplace(ifName, index);
+    }
+    setConnectedPairs();
+
+    dut_ = createSpark("dut");
+    for (uint32_t neighbor = 0; neighbor < numNeighbors_; ++neighbor) {
+      neighbors_.emplace_back(createSpark(getNeighborName(neighbor)));
+    }
+  }
+
+  ~SparkScaleFixture() {
+    // Sparks flood restarting msg on stop, keep mock running till then
+    neighbors_.clear();
+    dut_.reset();
+    mockIoProvider_->stop();
+    mockIoProviderThread_.join();
+  }
+
+  // Start tracking interfaces on all nodes
+  void
+  start() {
+    InterfaceDatabase dutIfDb;
+    for (uint32_t iface = 0; iface < numIfaces_; ++iface) {
+      dutIfDb.emplace_back(getInterfaceInfo(getDutIfName(iface)));
+    }
+    dut_->updateInterfaceDb(dutIfDb);
+
+    for (uint32_t neighbor = 0; neighbor < numNeighbors_; ++neighbor) {
+      InterfaceDatabase ifDb;
+      for (uint32_t iface = 0; iface < numIfaces_; ++iface) {
+        ifDb.emplace_back(
+            getInterfaceInfo(getNeighborIfName(neighbor, iface)));
+      }
+      neighbors_.at(neighbor)->updateInterfaceDb(ifDb);
+    }
+  }
+
+  // Silently (without restarting msg) cut/restore links of a neighbor
+  void
+  setNeighborConnected(uint32_t neighbor, bool connected) {
+    if (connected) {
+      disconnected_.erase(neighbor);
+    } else {
+      disconnected_.emplace(neighbor);
+    }
+    setConnectedPairs();
+  }
+
+  // All adjacencies of DUT, or only the ones to given neighbor
+  std::set<Adjacency>
+  getAdjacencies(std::optional<uint32_t> neighbor = std::nullopt) const {
+    std::set<Adjacency> adjacencies;
+    for (uint32_t n = 0; n < numNeighbors_; ++n) {
+      if (neighbor.has_value() and *neighbor != n) {
+        continue;
+      }
+      for (uint32_t iface = 0; iface < numIfaces_; ++iface) {
+        adjacencies.emplace(getDutIfName(iface), getNeighborName(n));
+      }
+    }
+    return adjacencies;
+  }
+
+  /**
+   * Block until DUT has reported event of given type for all of pending
+   * adjacencies. Events of other type or for other adjacencies are returned.
+   */
+  std::vector<NeighborEvent>
+  waitForEvents(NeighborEventType eventType, std::set<Adjacency> pending) {
+    std::vector<NeighborEvent> others;
+    const auto deadline = std::chrono::steady_clock::now() + kEventTimeout;
+    while (not pending.empty()) {
+      auto maybeEvents = dut_->recvNeighborEvent(
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              deadline - std::chrono::steady_clock::now()));
+      CHECK(maybeEvents.has_value())
+          << "Timed out waiting for " << pending.size() << " adjacencies";
+      for (auto& event : *maybeEvents) {
+        const Adjacency adj{
+            *event.info.localIfName_ref(), *event.info.nodeName_ref()};
+        if (event.eventType == eventType and pending.erase(adj)) {
+          continue;
+        }
+        others.emplace_back(std::move(event));
+      }
+    }
+    return others;
+  }
+
+  std::chrono::microseconds
+  getMockIoProviderCpuTime() {
+    return getThreadCpuTime(mockIoProviderThread_);
+  }
+
+  std::shared_ptr<const Config>
+  getConfig() const {
+    return config_;
+  }
+
+ private:
+  std::unique_ptr<SparkWrapper>
+  createSpark(std::string const& nodeName) {
+    auto tConfig = getBasicOpenrConfig(
+        nodeName, kDomainName, {} /* areas */, false /* enableV4 */);
+    config_ = std::make_shared<Config>(tConfig);
+    return std::make_unique<SparkWrapper>(
+        nodeName,
+        std::make_pair(
+            Constants::kOpenrVersion, Constants::kOpenrSupportedVersion),
+        mockIoProvider_,
+        config_);
+  }
+
+  InterfaceInfo
+  getInterfaceInfo(std::string const& ifName) const {
+    const auto ifIndex = ifNameToIndex_.at(ifName);
+    return InterfaceInfo(
+        ifName,
+        true /* isUp */,
+        ifIndex,
+        {folly::IPAddress::createNetwork(
+            fmt::format("fe80::{:x}/128", ifIndex))});
+  }
+
+  void
+  setConnectedPairs() {
+    ConnectedIfPairs connectedPairs;
+    for (uint32_t iface = 0; iface < numIfaces_; ++iface) {
+      auto& dutPeers = connectedPairs[getDutIfName(iface)];
+      for (uint32_t neighbor = 0; neighbor < numNeighbors_; ++neighbor) {
+        if (disconnected_.count(neighbor)) {
+          continue;
+        }
+        const auto neighborIfName = getNeighborIfName(neighbor, iface);
+        dutPeers.emplace_back(neighborIfName, kLinkLatencyMs);
+        connectedPairs[neighborIfName] = {
+            {getDutIfName(iface), kLinkLatencyMs}};
+      }
+    }
+    mockIoProvider_->setConnectedPairs(connectedPairs);
+  }
+
+  const uint32_t numIfaces_{0};
+  const uint32_t numNeighbors_{0};
+
+  std::shared_ptr<MockIoProvider> mockIoProvider_{nullptr};
+  std::thread mockIoProviderThread_;
+
+  std::unordered_map<std::string, int> ifNameToIndex_;
+  std::set<uint32_t> disconnected_;
+
+  // Spark config, the same on every node except for node name
+  std::shared_ptr<const Config> config_{nullptr};
+
+  std::unique_ptr<SparkWrapper> dut_;
+  std::vector<std::unique_ptr<SparkWrapper>> neighbors_;
+};
+
+/**
+ * Benchmark time for all adjacencies of DUT to reach ESTABLISHED state, i.e.
+ * NEIGHBOR_UP being reported to LinkMonitor, from the moment interfaces are
+ * added on all nodes.
+ *
+ * Counters are averaged per bring-up:
+ *  - adjacencies: number of adjacencies on DUT
+ *  - spark_cpu_ms: CPU time of all Spark instances (process CPU time minus
+ *    MockIoProvider thread)
+ */
+static void
+BM_SparkEstablish(
+    folly::UserCounters& counters,
+    uint32_t iters,
+    uint32_t numIfaces,
+    uint32_t numNeighbors,
+    uint32_t lossPercent) {
+  auto suspender = folly::BenchmarkSuspender();
+  std::chrono::microseconds cpuTime{0};
+
+  for (uint32_t i = 0; i < iters; ++i) {
+    auto fixture = std::make_unique<SparkScaleFixture>(
+        numIfaces, numNeighbors, lossPercent / 100.0);
+
+    const auto cpuTimeStart =
+        getProcessCpuTime() - fixture->getMockIoProviderCpuTime();
+    suspender.dismiss(); // Start measuring benchmark time
+    fixture->start();
+    fixture->waitForEvents(
+        NeighborEventType::NEIGHBOR_UP, fixture->getAdjacencies());
+    suspender.rehire(); // Stop measuring time again
+    cpuTime += getProcessCpuTime() - fixture->getMockIoProviderCpuTime() -
+        cpuTimeStart;
+
+    // shutdown is not measured
+    fixture.reset();
+  }
+
+  counters["adjacencies"] = numIfaces * numNeighbors;
+  counters["spark_cpu_ms"] = cpuTime.count() / 1000 / iters;
+}
+
+/**
+ * Benchmark steady state with all adjacencies established. Every iteration
+ * lasts one keepalive interval.
+ *
+ * Counters are averaged per keepalive interval:
+ *  - spark_cpu_us: CPU time of all Spark instances
+ *  - node_cpu_us: spark_cpu_us divided by number of nodes
+ */
+static void
+BM_SparkSteadyState(
+    folly::UserCounters& counters,
+    uint32_t iters,
+    uint32_t numIfaces,
+    uint32_t numNeighbors) {
+  auto suspender = folly::BenchmarkSuspender();
+  auto fixture =
+      std::make_unique<SparkScaleFixture>(numIfaces, numNeighbors, 0);
+  fixture->start();
+  fixture->waitForEvents(
+      NeighborEventType::NEIGHBOR_UP, fixture->getAdjacencies());
+  const std::chrono::milliseconds keepAliveTime(std::chrono::seconds(
+      *fixture->getConfig()->getSparkConfig().keepalive_time_s_ref()));
+
+  const auto cpuTimeStart =
+      getProcessCpuTime() - fixture->getMockIoProviderCpuTime();
+  suspender.dismiss(); // Start measuring benchmark time
+  for (uint32_t i = 0; i < iters; ++i) {
+    std::this_thread::sleep_for(keepAliveTime);
+  }
+  suspender.rehire(); // Stop measuring time again
+  const auto cpuTime = getProcessCpuTime() -
+      fixture->getMockIoProviderCpuTime() - cpuTimeStart;
+
+  counters["spark_cpu_us"] = cpuTime.count() / iters;
+  counters["node_cpu_us"] = cpuTime.count() / iters / (numNeighbors + 1);
+
+  // shutdown is not measured
+  fixture.reset();
+}
+
+/**
+ * Benchmark latency of NEIGHBOR_DOWN reported to LinkMonitor after links to a
+ * neighbor are silently cut, under random packet loss on all links. Latency
+ * is dominated by heartbeat hold time. Links are restored and adjacencies
+ * re-established between iterations, which is not measured.
+ *
+ * Counters are averaged per iteration:
+ *  - false_down: NEIGHBOR_DOWN events reported for other (alive) neighbors
+ *    due to packet loss
+ */
+static void
+BM_SparkNeighborDown(
+    folly::UserCounters& counters,
+    uint32_t iters,
+    uint32_t numIfaces,
+    uint32_t numNeighbors,
+    uint32_t lossPercent) {
+  auto suspender = folly::BenchmarkSuspender();
+  auto fixture = std::make_unique<SparkScaleFixture>(
+      numIfaces, numNeighbors, lossPercent / 100.0);
+  fixture->start();
+  fixture->waitForEvents(
+      NeighborEventType::NEIGHBOR_UP, fixture->getAdjacencies());
+
+  size_t falseDown{0};
+  for (uint32_t i = 0; i < iters; ++i) {
+    const uint32_t neighbor = i % numNeighbors;
+
+    suspender.dismiss(); // Start measuring benchmark time
+    fixture->setNeighborConnected(neighbor, false);
+    auto others = fixture->waitForEvents(
+        NeighborEventType::NEIGHBOR_DOWN, fixture->getAdjacencies(neighbor));
+    suspender.rehire(); // Stop measuring time again
+
+    // Restore links and wait for all adjacencies to come back up
+    std::set<Adjacency> down = fixture->getAdjacencies(neighbor);
+    for (auto const& event : others) {
+      if (event.eventType == NeighborEventType::NEIGHBOR_DOWN) {
+        ++falseDown;
+        down.emplace(*event.info.localIfName_ref(), *event.info.nodeName_ref());
+      } else if (event.eventType == NeighborEventType::NEIGHBOR_UP) {
+        down.erase({*event.info.localIfName_ref(), *event.info.nodeName_ref()});
+      }
+    }
+    fixture->setNeighborConnected(neighbor, true);
+    fixture->waitForEvents(NeighborEventType::NEIGHBOR_UP, std::move(down));
+  }
+
+  counters["false_down"] = falseDown / iters;
+
+  // shutdown is not measured
+  fixture.reset();
+}
+
+// The first parameter is the number of interfaces on DUT
+// The second parameter is the number of neighbors on each interface
+// The third parameter is the percentage of packets lost on every link
+BENCHMARK_COUNTERS_PARAM(BM_SparkEstablish, counters, 1, 10, 0);
+BENCHMARK_COUNTERS_PARAM(BM_SparkEstablish, counters, 10, 10, 0);
+BENCHMARK_COUNTERS_PARAM(BM_SparkEstablish, counters, 20, 50, 0);
+BENCHMARK_COUNTERS_PARAM(BM_SparkEstablish, counters, 20, 100, 0);
+BENCHMARK_COUNTERS_PARAM(BM_SparkEstablish, counters, 10, 10, 10);
+BENCHMARK_COUNTERS_PARAM(BM_SparkEstablish, counters, 20, 100, 10);
+
+// The first parameter is the number of interfaces on DUT
+// The second parameter is the number of neighbors on each interface
+BENCHMARK_COUNTERS_PARAM(BM_SparkSteadyState, counters, 10, 10);
+BENCHMARK_COUNTERS_PARAM(BM_SparkSteadyState, counters, 20, 100);
+
+// The first parameter is the number of interfaces on DUT
+// The second parameter is the number of neighbors on each interface
+// The third parameter is the percentage of packets lost on every link
+BENCHMARK_COUNTERS_PARAM(BM_SparkNeighborDown, counters, 10, 10, 0);
+BENCHMARK_COUNTERS_PARAM(BM_SparkNeighborDown, counters, 10, 10, 10);
+BENCHMARK_COUNTERS_PARAM(BM_SparkNeighborDown, counters, 20, 100, 10);
+
+} // namespace openr
+
+int
+main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -108,7 +108,8 @@ class SparkFixture : public testing::Test {
 class SimpleSparkFixture : public SparkFixture {
  protected:
   void
-  createAndConnect() {
+  createAndConnect(
+      std::optional<thrift::SparkConfig> sparkConfig = std::nullopt) {
     // Define interface names for the test
     mockIoProvider_->addIfNameIfIndex({{iface1, ifIndex1}, {iface2, ifIndex2}});
 
@@ -120,9 +121,12 @@ class SimpleSparkFixture : public SparkFixture {
     mockIoProvider_->setConnectedPairs(connectedPairs);
 
     auto tConfig1 = getBasicOpenrConfig("node-1", kDomainName);
-    auto config1 = std::make_shared<Config>(tConfig1);
-
     auto tConfig2 = getBasicOpenrConfig("node-2", kDomainName);
+    if (sparkConfig.has_value()) {
+      tConfig1.spark_config_ref() = *sparkConfig;
+      tConfig2.spark_config_ref() = *sparkConfig;
+    }
+    auto config1 = std::make_shared<Config>(tConfig1);
     auto config2 = std::make_shared<Config>(tConfig2);
 
     // start one spark2 instance
@@ -486,6 +490,32 @@ TEST_F(SimpleSparkFixture, HeartbeatTimerExpireTest) {
   }
 }
 
+//
+// Start 2 Spark instances with heartbeats sent in batch by heartbeat thread.
+// Adjacency is kept well beyond hold time, and lost once link goes away.
+//
+TEST_F(SimpleSparkFixture, BatchedHeartbeatTest) {
+  auto sparkConfig =
+      *getBasicOpenrConfig("node-1", kDomainName).spark_config_ref();
+  sparkConfig.keepalive_time_s_ref() = 1;
+  sparkConfig.hold_time_s_ref() = 3;
+  sparkConfig.enable_heartbeat_thread_ref() = true;
+  sparkConfig.enable_batched_heartbeat_send_ref() = true;
+  createAndConnect(sparkConfig);
+
+  auto holdTime = std::chrono::seconds(*sparkConfig.hold_time_s_ref());
+  EXPECT_FALSE(
+      node1->waitForEvents(NB_DOWN, holdTime * 2, holdTime * 2).has_value());
+  EXPECT_FALSE(
+      node2->waitForEvents(NB_DOWN, holdTime * 2, holdTime * 2).has_value());
+
+  // remove underneath connections between to nodes
+  ConnectedIfPairs connectedPairs = {};
+  mockIoProvider_->setConnectedPairs(connectedPairs);
+  EXPECT_TRUE(node1->waitForEvents(NB_DOWN).has_value());
+  EXPECT_TRUE(node2->waitForEvents(NB_DOWN).has_value());
+}
+
 //
 // Start 2 Spark instances and wait them forming adj. Then
 // update interface from one instance's perspective. Due to same
@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <thread>
+
+#include <fb303/ServiceData.h>
+#include <fbzmq/zmq/Zmq.h>
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+#include <thrift/lib/cpp2/server/ThriftServer.h>
+#include <thrift/lib/cpp2/util/ScopedServerThread.h>
+
+#include <openr/config/Config.h>
+#include <openr/config/tests/Utils.h>
+#include <openr/decision/Decision.h>
+#include <openr/decision/tests/RoutingBenchmarkUtils.h>
+#include <openr/fib/Fib.h>
+#include <openr/kvstore/KvStore.h>
+#include <openr/messaging/ReplicateQueue.h>
+#include <openr/prefix-manager/PrefixManager.h>
+#include <openr/tests/mocks/MockNetlinkFibHandler.h>
+
+namespace {
+// Node running KvStore, Decision, Fib and PrefixManager. Corner of the grid.
+const std::string kNodeName{"0"};
+} // namespace
+
+namespace openr {
+
+using apache::thrift::ThriftServer;
+using apache::thrift::util::ScopedServerThread;
+
+/**
+ * KvStore, Decision, Fib and PrefixManager of one node, wired through their
+ * queues as in Main.cpp. Fib programs routes to a mock FibService.
+ */
+class ConvergenceWrapper {
+ public:
+  ConvergenceWrapper() {
+    // Register Singleton
+    folly::SingletonVault::singleton()->registrationComplete();
+    // Create MockNetlinkFibHandler
+    mockFibHandler = std::make_shared<MockNetlinkFibHandler>();
+
+    // Start ThriftServer
+    server = std::make_shared<ThriftServer>();
+    server->setNumIOWorkerThreads(1);
+    server->setNumAcceptThreads(1);
+    server->setPort(0);
+    server->setInterface(mockFibHandler);
+    fibThriftThread.start(server);
+
+    auto tConfig = getBasicOpenrConfig(
+        kNodeName,
+        "domain",
+        {}, /* area config */
+        false, /* enableV4 */
+        false /*enableSegmentRouting*/,
+        false /*dryrun*/);
+    tConfig.fib_port_ref() = fibThriftThread.getAddress()->getPort();
+    // compute routes as soon as key-vals are received
+    tConfig.eor_time_s_ref() = 0;
+    tConfig.decision_config_ref()->debounce_min_ms_ref() = 10;
+    tConfig.decision_config_ref()->debounce_max_ms_ref() = 250;
+    config = std::make_shared<Config>(tConfig);
+
+    kvStore = std::make_unique<KvStore>(
+        context,
+        kvStoreUpdatesQueue,
+        kvStoreSyncEventsQueue,
+        peerUpdatesQueue.getReader(),
+        kvRequestQueue.getReader(),
+        logSampleQueue,
+        KvStoreGlobalCmdUrl{"inproc://convergence-kvstore-cmd-global"},
+        config);
+    startModule(kvStore.get(), "KvStore");
+
+    decision = std::make_unique<Decision>(
+        config,
+        kvStoreUpdatesQueue.getReader(),
+        staticRoutesQueue.getReader(),
+        routeUpdatesQueue);
+    startModule(decision.get(), "Decision");
+
+    fib = std::make_unique<Fib>(
+        config,
+        routeUpdatesQueue.getReader(),
+        staticRoutesQueue.getReader(),
+        fibRouteUpdatesQueue,
+        logSampleQueue);
+    startModule(fib.get(), "Fib");
+
+    prefixManager = std::make_unique<PrefixManager>(
+        staticRoutesQueue,
+        kvRequestQueue,
+        kvStoreUpdatesQueue.getReader(),
+        prefixUpdatesQueue.getReader(),
+        fibRouteUpdatesQueue.getReader(),
+        config,
+        kvStore.get());
+    startModule(prefixManager.get(), "PrefixManager");
+  }
+
+  ~ConvergenceWrapper() {
+    LOG(INFO) << "Closing queues";
+    kvStoreUpdatesQueue.close();
+    kvStoreSyncEventsQueue.close();
+    peerUpdatesQueue.close();
+    kvRequestQueue.close();
+    routeUpdatesQueue.close();
+    staticRoutesQueue.close();
+    fibRouteUpdatesQueue.close();
+    prefixUpdatesQueue.close();
+    logSampleQueue.close();
+
+    // stop modules in reverse order
+    prefixManager->stop();
+    prefixManager->waitUntilStopped();
+    fib->stop();
+    fib->waitUntilStopped();
+    decision->stop();
+    decision->waitUntilStopped();
+    kvStore->stop();
+    kvStore->waitUntilStopped();
+    for (auto& t : threads) {
+      t.join();
+    }
+
+    // Stop mocked nl platform
+    mockFibHandler->stop();
+    fibThriftThread.stop();
+  }
+
+  // set key-vals into KvStore, as if flooded by peers
+  void
+  setKeyVals(std::unordered_map<std::string, thrift::Value> keyVals) {
+    thrift::KeySetParams params;
+    params.keyVals_ref() = std::move(keyVals);
+    kvStore->setKvStoreKeyVals(kTestingAreaName, std::move(params)).get();
+  }
+
+  fbzmq::Context context;
+
+  messaging::ReplicateQueue<Publication> kvStoreUpdatesQueue;
+  messaging::ReplicateQueue<KvStoreSyncEvent> kvStoreSyncEventsQueue;
+  messaging::ReplicateQueue<PeerEvent> peerUpdatesQueue;
+  messaging::ReplicateQueue<KeyValueRequest> kvRequestQueue;
+  messaging::ReplicateQueue<DecisionRouteUpdate> routeUpdatesQueue;
+  messaging::ReplicateQueue<DecisionRouteUpdate> staticRoutesQueue;
+  messaging::ReplicateQueue<DecisionRouteUpdate> fibRouteUpdatesQueue;
+  messaging::ReplicateQueue<PrefixEvent> prefixUpdatesQueue;
+  messaging::ReplicateQueue<LogSample> logSampleQueue;
+
+  // routes programmed by Fib, i.e. acknowledged by agent
+  messaging::RQueue<DecisionRouteUpdate> fibRouteUpdatesReader{
+      fibRouteUpdatesQueue.getReader()};
+
+  std::shared_ptr<ThriftServer> server;
+  ScopedServerThread fibThriftThread;
+  std::shared_ptr<MockNetlinkFibHandler> mockFibHandler{nullptr};
+
+  std::shared_ptr<Config> config;
+  std::unique_ptr<KvStore> kvStore;
+  std::unique_ptr<Decision> decision;
+  std::unique_ptr<Fib> fib;
+  std::unique_ptr<PrefixManager> prefixManager;
+
+ private:
+  template <typename Module>
+  void
+  startModule(Module* module, std::string const& name) {
+    threads.emplace_back([module, name]() {
+      LOG(INFO) << name << " thread starting";
+      module->run();
+      LOG(INFO) << name << " thread finishing";
+    });
+    module->waitUntilRunning();
+  }
+
+  std::vector<std::thread> threads;
+};
+
+/**
+ * Wait until `predicate` holds, polling every millisecond
+ */
+template <typename Predicate>
+static void
+waitUntil(Predicate predicate) {
+  while (not predicate()) {
+    /* sleep override */
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+/**
+ * End-to-end convergence benchmark of one node in a grid topology
+ * 1. Wire real KvStore, Decision, Fib and PrefixManager, Fib programming a
+ *    mock agent
+ * 2. Set adjacencies and prefixes of grid into KvStore and wait until all
+ *    routes are programmed
+ * 3. Every iteration toggles overload bit of a neighbor, i.e. adjacencies
+ *    through it are down or back up, and measures time until the changed
+ *    route is acknowledged by the agent
+ */
+static void
+BM_Convergence(
+    folly::UserCounters& counters, uint32_t iters, unsigned gridSize) {
+  auto suspender = folly::BenchmarkSuspender();
+  CHECK_GE(gridSize, 3);
+  auto wrapper = std::make_unique<ConvergenceWrapper>();
+  auto& mockFibHandler = wrapper->mockFibHandler;
+  CompactSerializer serializer;
+
+  // Node 1 is toggled, hence route towards node 2 moves between going
+  // through node 1 and around it
+  auto [adjDbs, prefixDbs] =
+      createGrid(gridSize, 1, thrift::PrefixForwardingAlgorithm::SP_ECMP);
+  auto toggledAdjDb = adjDbs.at("adj:1");
+  std::optional<folly::CIDRNetwork> watchedPrefix;
+
+  std::unordered_map<std::string, thrift::Value> keyVals;
+  for (auto& [key, adjDb] : adjDbs) {
+    keyVals.emplace(
+        key,
+        createThriftValue(
+            1,
+            *adjDb.thisNodeName_ref(),
+            writeThriftObjStr(adjDb, serializer)));
+  }
+  for (auto& [key, prefixDb] : prefixDbs) {
+    auto const& nodeName = *prefixDb.thisNodeName_ref();
+    // prefixes of this node are owned by PrefixManager
+    if (nodeName == kNodeName) {
+      continue;
+    }
+    if (nodeName == "2") {
+      watchedPrefix = toIPNetwork(
+          *prefixDb.prefixEntries_ref()->front().prefix_ref());
+    }
+    keyVals.emplace(
+        key,
+        createThriftValue(
+            1, nodeName, writeThriftObjStr(prefixDb, serializer)));
+  }
+  CHECK(watchedPrefix.has_value());
+
+  const auto syncStartTime = std::chrono::steady_clock::now();
+  wrapper->setKeyVals(std::move(keyVals));
+  const size_t numRoutes = gridSize * gridSize - 1;
+  waitUntil([&]() {
+    return fb303::fbData->getCounter("fib.synced") == 1 and
+        mockFibHandler->getUnicastRoutesCount() == numRoutes;
+  });
+  const auto timeToSynced = std::chrono::ceil<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - syncStartTime);
+  while (wrapper->fibRouteUpdatesReader.size()) {
+    wrapper->fibRouteUpdatesReader.get();
+  }
+
+  suspender.dismiss(); // Start measuring benchmark time
+  for (uint32_t i = 0; i < iters; i++) {
+    toggledAdjDb.isOverloaded_ref() = not *toggledAdjDb.isOverloaded_ref();
+    wrapper->setKeyVals(
+        {{"adj:1",
+          createThriftValue(
+              i + 2, "1", writeThriftObjStr(toggledAdjDb, serializer))}});
+
+    // wait until route towards node 2 is reprogrammed
+    while (true) {
+      auto update = wrapper->fibRouteUpdatesReader.get();
+      CHECK(update.hasValue());
+      if (update->unicastRoutesToUpdate.count(*watchedPrefix)) {
+        break;
+      }
+    }
+  }
+  suspender.rehire(); // Stop measuring time again
+
+  counters["time_to_synced_ms"] = timeToSynced.count();
+  counters["num_routes"] = numRoutes;
+}
+
+// The parameter is the width of grid topology
+BENCHMARK_COUNTERS_NAME_PARAM(BM_Convergence, counters, 10, 10);
+BENCHMARK_COUNTERS_NAME_PARAM(BM_Convergence, counters, 30, 30);
+BENCHMARK_COUNTERS_NAME_PARAM(BM_Convergence, counters, 100, 100);
+
+} // namespace openr
+
+int
+main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
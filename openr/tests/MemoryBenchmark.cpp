@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <thread>
+
+#include <fmt/format.h>
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+#include <folly/memory/Malloc.h>
+#include <folly/memory/MallctlHelper.h>
+
+#include <openr/common/Util.h>
+#include <openr/config/Config.h>
+#include <openr/config/tests/Utils.h>
+#include <openr/decision/LinkState.h>
+#include <openr/decision/NextHopGroup.h>
+#include <openr/decision/PrefixState.h>
+#include <openr/decision/SpfSolver.h>
+#include <openr/decision/tests/RoutingBenchmarkUtils.h>
+#include <openr/fib/Fib.h>
+#include <openr/kvstore/KvStoreUtil.h>
+
+namespace {
+// Node computing routes. Corner of the grid.
+const std::string kNodeName{"0"};
+} // namespace
+
+namespace openr {
+
+/**
+ * Bytes allocated by the calling thread, as accounted by a jemalloc arena
+ * dedicated to it. Thread cache is disabled, as it holds on to freed memory
+ * which the arena accounts as allocated, hence differences of
+ * getAllocatedBytes() are exact.
+ */
+class ArenaMeter {
+ public:
+  ArenaMeter() : arenaIndex_(memory::bindThreadToNewArena()) {
+    if (arenaIndex_.has_value()) {
+      folly::mallctlWrite<bool>("thread.tcache.enabled", false);
+    }
+  }
+
+  bool
+  isValid() const {
+    return arenaIndex_.has_value();
+  }
+
+  int64_t
+  getAllocatedBytes() const {
+    memory::refreshMallocStats();
+    auto stats = memory::getArenaStats(arenaIndex_.value());
+    CHECK(stats.has_value());
+    return stats->allocatedBytes;
+  }
+
+ private:
+  const std::optional<unsigned> arenaIndex_;
+};
+
+/**
+ * Link-state of grid topology, as received by every area
+ */
+struct SyntheticState {
+  std::unordered_map<
+      std::string /* area */,
+      std::unordered_map<std::string, thrift::Value>>
+      areaKeyVals;
+  std::unordered_map<std::string, std::vector<thrift::AdjacencyDatabase>>
+      areaAdjDbs;
+  std::vector<std::pair<PrefixKey, thrift::PrefixEntry>> prefixEntries;
+};
+
+static SyntheticState
+createSyntheticState(
+    unsigned gridSize,
+    unsigned numPrefixes,
+    std::vector<std::string> const& areas) {
+  CompactSerializer serializer;
+  SyntheticState state;
+  auto [adjDbs, prefixDbs] = createGrid(
+      gridSize, numPrefixes, thrift::PrefixForwardingAlgorithm::SP_ECMP);
+  for (auto const& area : areas) {
+    auto& keyVals = state.areaKeyVals[area];
+    auto& areaAdjDbs = state.areaAdjDbs[area];
+    for (auto const& [key, adjDb] : adjDbs) {
+      auto areaAdjDb = adjDb;
+      areaAdjDb.area_ref() = area;
+      keyVals.emplace(
+          key,
+          createThriftValue(
+              1,
+              *areaAdjDb.thisNodeName_ref(),
+              writeThriftObjStr(areaAdjDb, serializer)));
+      areaAdjDbs.emplace_back(std::move(areaAdjDb));
+    }
+    for (auto const& [_, prefixDb] : prefixDbs) {
+      auto const& nodeName = *prefixDb.thisNodeName_ref();
+      for (auto const& entry : *prefixDb.prefixEntries_ref()) {
+        auto [prefixKey, areaPrefixDb] =
+            createPrefixKeyAndDb(nodeName, entry, area);
+        keyVals.emplace(
+            prefixKey.getPrefixKey(),
+            createThriftValue(
+                1, nodeName, writeThriftObjStr(areaPrefixDb, serializer)));
+        state.prefixEntries.emplace_back(std::move(prefixKey), entry);
+      }
+    }
+  }
+  return state;
+}
+
+/**
+ * Build state of KvStore, Decision and Fib from `state` and record bytes
+ * allocated per entry of each into `counters`. Along with measured bytes,
+ * estimates the modules report as counters are recorded, to tell how far off
+ * they are.
+ */
+static void
+measureMemoryFootprint(
+    std::shared_ptr<const Config> config,
+    SyntheticState const& state,
+    folly::UserCounters& counters) {
+  ArenaMeter meter;
+  if (not meter.isValid()) {
+    LOG(WARNING) << "Not running with jemalloc, skip measuring memory";
+    return;
+  }
+
+  // KvStore: key-value map of every area
+  auto bytesBefore = meter.getAllocatedBytes();
+  std::vector<KvStoreMap> kvStoreMaps;
+  kvStoreMaps.reserve(state.areaKeyVals.size());
+  size_t numKeys{0};
+  for (auto const& [_, keyVals] : state.areaKeyVals) {
+    mergeKeyValues(kvStoreMaps.emplace_back(), keyVals);
+    numKeys += keyVals.size();
+  }
+  counters["kvstore.num_keys"] = numKeys;
+  counters["kvstore.bytes_per_key"] =
+      (meter.getAllocatedBytes() - bytesBefore) / numKeys;
+
+  // Decision: link-state and prefix-state
+  std::unordered_map<std::string, LinkState> areaLinkStates;
+  for (auto const& [area, adjDbs] : state.areaAdjDbs) {
+    auto& linkState =
+        areaLinkStates.emplace(area, LinkState(area)).first->second;
+    for (auto const& adjDb : adjDbs) {
+      linkState.updateAdjacencyDatabase(adjDb);
+    }
+  }
+
+  bytesBefore = meter.getAllocatedBytes();
+  PrefixState prefixState;
+  for (auto const& [prefixKey, entry] : state.prefixEntries) {
+    prefixState.updatePrefix(prefixKey, entry);
+  }
+  const auto numPrefixEntries = state.prefixEntries.size();
+  counters["prefix_state.num_entries"] = numPrefixEntries;
+  counters["prefix_state.bytes_per_entry"] =
+      (meter.getAllocatedBytes() - bytesBefore) / numPrefixEntries;
+  counters["prefix_state.estimated_bytes_per_entry"] =
+      prefixState.getMemoryUsage() / numPrefixEntries;
+
+  // Decision: SPF result of this node in every area
+  bytesBefore = meter.getAllocatedBytes();
+  size_t numSpfEntries{0};
+  size_t estimatedSpfBytes{0};
+  for (auto const& [_, linkState] : areaLinkStates) {
+    numSpfEntries += linkState.getSpfResult(kNodeName).size();
+    estimatedSpfBytes += linkState.getMemoizationBytes();
+  }
+  counters["spf_result.num_entries"] = numSpfEntries;
+  counters["spf_result.bytes_per_entry"] =
+      (meter.getAllocatedBytes() - bytesBefore) / numSpfEntries;
+  counters["spf_result.estimated_bytes_per_entry"] =
+      estimatedSpfBytes / numSpfEntries;
+
+  // Decision: route db. Routes towards prefixes of other nodes
+  SpfSolver spfSolver(
+      config,
+      kNodeName,
+      false /* enableV4 */,
+      false /* enableNodeSegmentLabel */,
+      false /* enableAdjacencyLabels */);
+  auto routeDb =
+      spfSolver.buildRouteDb(kNodeName, areaLinkStates, prefixState);
+  CHECK(routeDb.has_value());
+  const auto numRoutes = routeDb->unicastRoutes.size();
+  CHECK_GT(numRoutes, 0);
+
+  // Fib: route state as updated from Decision. Next-hop groups are interned,
+  // hence shared with route db and not accounted for here.
+  DecisionRouteUpdate routeUpdate;
+  routeUpdate.unicastRoutesToUpdate = routeDb->unicastRoutes;
+  bytesBefore = meter.getAllocatedBytes();
+  auto fibRouteState = std::make_unique<Fib::RouteState>();
+  fibRouteState->update(routeUpdate);
+  counters["fib.bytes_per_route"] =
+      (meter.getAllocatedBytes() - bytesBefore) / numRoutes;
+  counters["fib.estimated_bytes_per_route"] =
+      fibRouteState->getMemoryUsage() / numRoutes;
+  routeUpdate = DecisionRouteUpdate();
+  fibRouteState.reset();
+
+  // Route db is measured by the bytes it frees, as building it populates
+  // caches of SpfSolver too. Includes the next-hop groups.
+  counters["decision.num_routes"] = numRoutes;
+  counters["decision.num_nexthop_groups"] = NextHopGroup::getNumGroups();
+  bytesBefore = meter.getAllocatedBytes();
+  routeDb.reset();
+  counters["decision.route_db_bytes_per_route"] =
+      (bytesBefore - meter.getAllocatedBytes()) / numRoutes;
+}
+
+/**
+ * Memory footprint of synthetic grid topology
+ * 1. Create adjacencies and `numPrefixes` prefixes per node of grid, in each
+ *    of `numAreas` areas
+ * 2. Build KvStore key-values, Decision link-state, prefix-state, SPF result
+ *    and route db, and Fib route state out of them, in a thread bound to a
+ *    jemalloc arena of its own
+ * 3. Report bytes per key, prefix entry, SPF result entry and route. Time
+ *    measured is the one of building all state.
+ */
+static void
+BM_MemoryFootprint(
+    folly::UserCounters& counters,
+    uint32_t iters,
+    unsigned gridSize,
+    unsigned numPrefixes,
+    unsigned numAreas) {
+  auto suspender = folly::BenchmarkSuspender();
+  std::vector<std::string> areas;
+  std::vector<thrift::AreaConfig> areaConfigs;
+  for (unsigned i = 0; i < numAreas; ++i) {
+    areas.emplace_back(fmt::format("area{}", i));
+    areaConfigs.emplace_back(createAreaConfig(areas.back(), {".*"}, {".*"}));
+  }
+  auto config = std::make_shared<Config>(getBasicOpenrConfig(
+      kNodeName, "domain", areaConfigs, false /* enableV4 */));
+  const auto state = createSyntheticState(gridSize, numPrefixes, areas);
+
+  suspender.dismiss(); // Start measuring benchmark time
+  for (uint32_t i = 0; i < iters; ++i) {
+    std::thread([&]() {
+      measureMemoryFootprint(config, state, counters);
+    }).join();
+  }
+  suspender.rehire(); // Stop measuring time again
+}
+
+// The parameters are width of grid, prefixes per node and number of areas
+BENCHMARK_COUNTERS_NAME_PARAM(BM_MemoryFootprint, counters, 10_1_1, 10, 1, 1);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_MemoryFootprint, counters, 100_1_1, 100, 1, 1);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_MemoryFootprint, counters, 100_10_1, 100, 10, 1);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_MemoryFootprint, counters, 100_1_4, 100, 1, 4);
+BENCHMARK_COUNTERS_NAME_PARAM(
+    BM_MemoryFootprint, counters, 300_1_1, 300, 1, 1);
+
+} // namespace openr
+
+int
+main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
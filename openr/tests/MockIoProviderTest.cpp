@@ -199,6 +199,87 @@ TEST(MockIoProviderTestSetup, TwoNodesAndOneNodeTest) {
   mockIoProviderThread.join();
 }
 
+//
+// This test receives multiple packets at once with IoProvider::recvMessages
+//
+// 2-node topology: 1 -> 2
+//
+TEST(MockIoProviderTestSetup, RecvMessagesTest) {
+  folly::IPAddressV6 ipAddr1V6("fe80::1");
+  folly::IPAddressV6 ipAddr2V6("fe80::2");
+  std::string ifName1("iface1");
+  std::string ifName2("iface2");
+  int ifIndex1 = 1;
+  int ifIndex2 = 2;
+
+  auto mockIoProvider = std::make_shared<MockIoProvider>();
+  std::thread mockIoProviderThread([&]() { mockIoProvider->start(); });
+  mockIoProvider->waitUntilRunning();
+
+  mockIoProvider->addIfNameIfIndex({{ifName1, ifIndex1}, {ifName2, ifIndex2}});
+  mockIoProvider->setConnectedPairs({{ifName1, {{ifName2, 100}}}});
+
+  int fd1 = createSocketAndJoinGroup(
+      mockIoProvider, ifIndex1, folly::IPAddress(kDiscardMulticastAddr));
+  int fd2 = createSocketAndJoinGroup(
+      mockIoProvider, ifIndex2, folly::IPAddress(kDiscardMulticastAddr));
+
+  // Send three packets from node1 to node2
+  const std::vector<std::string> packets{"packet #1", "packet #2", "pkt #3"};
+  for (auto const& packet : packets) {
+    struct msghdr sendMsg;
+    AlignedCtrlBuf<struct in6_pktinfo> sendUnion;
+    sockaddr_storage dstAddrStorage;
+    struct iovec sendEntry;
+    prepareSendMessage(
+        (openr::MockIoProviderUtils::bufferArgs<struct in6_pktinfo>){
+            .msg = sendMsg,
+            .data = const_cast<char*>(packet.c_str()),
+            .len = packet.size(),
+            .entry = sendEntry,
+            .u = sendUnion,
+        },
+        (struct openr::MockIoProviderUtils::networkArgs){
+            .srcIfIndex = ifIndex1,
+            .srcIPAddr = ipAddr1V6,
+            .dstIPAddr = ipAddr2V6,
+            .dstPort = kMockedUdpPort,
+            .dstAddrStorage = dstAddrStorage,
+        });
+    EXPECT_EQ(
+        packet.size(), mockIoProvider->sendmsg(fd1, &sendMsg, MSG_DONTWAIT));
+  }
+
+  // Receive at most two packets at once
+  std::vector<unsigned char> recvBuf(2 * kMinIpv6PktSize);
+  auto infos = IoProvider::recvMessages(
+      fd2, recvBuf.data(), kMinIpv6PktSize, 2, mockIoProvider.get());
+  ASSERT_EQ(2, infos.size());
+  for (size_t i = 0; i < infos.size(); ++i) {
+    EXPECT_EQ(packets.at(i).size(), std::get<0>(infos.at(i)));
+    EXPECT_EQ(ifIndex2, std::get<1>(infos.at(i)));
+    EXPECT_EQ(
+        packets.at(i),
+        std::string(
+            reinterpret_cast<const char*>(
+                recvBuf.data() + i * kMinIpv6PktSize),
+            packets.at(i).size()));
+  }
+
+  // Remaining packet and then nothing
+  infos = IoProvider::recvMessages(
+      fd2, recvBuf.data(), kMinIpv6PktSize, 2, mockIoProvider.get());
+  ASSERT_EQ(1, infos.size());
+  EXPECT_EQ(packets.back().size(), std::get<0>(infos.at(0)));
+  EXPECT_TRUE(IoProvider::recvMessages(
+                  fd2, recvBuf.data(), kMinIpv6PktSize, 2, mockIoProvider.get())
+                  .empty());
+
+  // Cleanup
+  mockIoProvider->stop();
+  mockIoProviderThread.join();
+}
+
 //
 // This test sends packets along the follow topology
 // with the two nodes running in separate thread for
@@ -0,0 +1,553 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * Large scale in-process emulation of Open/R network. Runs hundreds of
+ * `OpenrWrapper` instances in one process, linked via `MockIoProvider`, and
+ * reports convergence time, per-instance CPU and memory while replaying
+ * events, e.g. link flaps and node drains, on configurable topologies.
+ *
+ * Example:
+ *   openr_emulation --topology=fabric --num_nodes=200 \
+ *     --events="random_flap 3;drain 0;undrain 0"
+ *
+ * Events are separated by ';'. Node is referred by its index.
+ *   link_down <node> <node>, link_up <node> <node>
+ *   flap <node> <node>        link down and back up, converging in between
+ *   random_flap <count>       flap of randomly chosen links, one by one
+ *   drain <node>, undrain <node>
+ *
+ * Convergence is tracked by polling route databases of all instances. Time
+ * of the last observed change is reported once routes stay unchanged for
+ * `quiet_period_ms`, hence resolution is about `poll_interval_ms`.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <set>
+#include <thread>
+
+#include <fbzmq/zmq/Zmq.h>
+#include <fmt/format.h>
+#include <folly/Random.h>
+#include <folly/String.h>
+#include <folly/hash/Hash.h>
+#include <folly/init/Init.h>
+#include <glog/logging.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+
+#include <openr/common/NetworkUtil.h>
+#include <openr/common/Util.h>
+#include <openr/config/tests/Utils.h>
+#include <openr/monitor/SystemMetrics.h>
+#include <openr/tests/OpenrWrapper.h>
+#include <openr/tests/mocks/MockIoProvider.h>
+
+DEFINE_string(topology, "fabric", "Topology to emulate: fabric, grid, area");
+DEFINE_int32(num_nodes, 100, "Number of Open/R instances");
+DEFINE_int32(fabric_num_spines, 4, "Spines of fabric, connected to all leafs");
+DEFINE_int32(grid_width, 0, "Width of grid, square grid if 0");
+DEFINE_int32(num_areas, 4, "Number of areas, grid rows are split among them");
+DEFINE_int32(link_latency_ms, 1, "Latency of every link");
+DEFINE_string(events, "", "Events to replay, separated by ';'");
+DEFINE_int32(poll_interval_ms, 100, "Interval of polling route databases");
+DEFINE_int32(quiet_period_ms, 3000, "Converged if no route change meanwhile");
+DEFINE_int32(convergence_timeout_s, 300, "Give up waiting for convergence");
+
+using namespace openr;
+
+namespace {
+
+const std::chrono::seconds kKvStoreDbSyncInterval(60);
+const std::chrono::milliseconds kSpark2HelloTime(1000);
+const std::chrono::milliseconds kSpark2FastInitHelloTime(100);
+const std::chrono::milliseconds kSpark2HandshakeTime(100);
+const std::chrono::milliseconds kSpark2HeartbeatTime(500);
+const std::chrono::milliseconds kSpark2HandshakeHoldTime(1000);
+const std::chrono::milliseconds kSpark2HeartbeatHoldTime(3000);
+const std::chrono::milliseconds kSpark2GRHoldTime(5000);
+const std::chrono::milliseconds kLinkFlapInitialBackoff(1);
+const std::chrono::milliseconds kLinkFlapMaxBackoff(8);
+
+const std::string kDefaultArea = kTestingAreaName;
+
+struct Link {
+  size_t nodeA{0};
+  size_t nodeB{0};
+  std::string area;
+  std::string ifNameA;
+  std::string ifNameB;
+  int ifIndexA{0};
+  int ifIndexB{0};
+  bool isUp{true};
+};
+
+struct Node {
+  std::string name;
+  std::vector<size_t> links;
+  std::set<std::string> areas;
+  folly::CIDRNetwork loopback;
+  folly::CIDRNetwork addrV4;
+  folly::CIDRNetwork addrV6;
+};
+
+/**
+ * Nodes and links of emulated network
+ */
+class Topology {
+ public:
+  static Topology
+  createFabric(size_t numNodes, size_t numSpines) {
+    CHECK_LT(numSpines, numNodes) << "Fabric needs at least one leaf";
+    Topology topo(numNodes);
+    for (size_t spine = 0; spine < numSpines; ++spine) {
+      for (size_t leaf = numSpines; leaf < numNodes; ++leaf) {
+        topo.addLink(spine, leaf, kDefaultArea);
+      }
+    }
+    return topo;
+  }
+
+  // Grid rows are split among areas evenly. Link between rows of different
+  // areas belongs to the area of lower row, making upper row area border.
+  static Topology
+  createGrid(size_t numNodes, size_t width, size_t numAreas) {
+    if (width == 0) {
+      width = std::max<size_t>(1, std::lround(std::sqrt(numNodes)));
+    }
+    const size_t numRows = (numNodes + width - 1) / width;
+    numAreas = std::max<size_t>(1, std::min(numAreas, numRows));
+    auto area = [&](size_t row) {
+      return numAreas == 1 ? kDefaultArea
+                           : fmt::format("area{}", row * numAreas / numRows);
+    };
+
+    Topology topo(numNodes);
+    for (size_t node = 0; node < numNodes; ++node) {
+      const size_t row = node / width;
+      if ((node % width) + 1 < width and node + 1 < numNodes) {
+        topo.addLink(node, node + 1, area(row));
+      }
+      if (node + width < numNodes) {
+        topo.addLink(node, node + width, area(row + 1));
+      }
+    }
+    return topo;
+  }
+
+  // Area configs of node, empty if in default area only
+  std::vector<thrift::AreaConfig>
+  getAreaConfigs(size_t node) const {
+    std::vector<thrift::AreaConfig> areaConfigs;
+    for (auto const& area : nodes.at(node).areas) {
+      if (area == kDefaultArea) {
+        continue;
+      }
+      areaConfigs.emplace_back(createAreaConfig(
+          area, {".*"}, {fmt::format("if-{}-.*", area)}));
+    }
+    return areaConfigs;
+  }
+
+  InterfaceDatabase
+  getInterfaceDb(size_t node) const {
+    auto const& n = nodes.at(node);
+    InterfaceDatabase ifDb;
+    for (auto linkId : n.links) {
+      auto const& link = links.at(linkId);
+      const bool isA = link.nodeA == node;
+      ifDb.emplace_back(
+          isA ? link.ifNameA : link.ifNameB,
+          link.isUp,
+          isA ? link.ifIndexA : link.ifIndexB,
+          std::unordered_set<folly::CIDRNetwork>{n.addrV4, n.addrV6});
+    }
+    return ifDb;
+  }
+
+  std::optional<size_t>
+  findLink(size_t nodeA, size_t nodeB) const {
+    for (auto linkId : nodes.at(nodeA).links) {
+      auto const& link = links.at(linkId);
+      if (link.nodeA == nodeB or link.nodeB == nodeB) {
+        return linkId;
+      }
+    }
+    return std::nullopt;
+  }
+
+  std::vector<Node> nodes;
+  std::vector<Link> links;
+
+ private:
+  explicit Topology(size_t numNodes) {
+    for (size_t i = 0; i < numNodes; ++i) {
+      Node node;
+      node.name = fmt::format("node-{}", i);
+      node.loopback = folly::IPAddress::createNetwork(
+          fmt::format("fd00::{:x}:{:x}/128", (i + 1) >> 16, (i + 1) & 0xffff));
+      node.addrV4 = {folly::IPAddressV4::fromLongHBO(0x0a000000 + i + 1), 32};
+      node.addrV6 = folly::IPAddress::createNetwork(fmt::format(
+          "fe80::{:x}:{:x}/128", (i + 1) >> 16, (i + 1) & 0xffff));
+      nodes.emplace_back(std::move(node));
+    }
+  }
+
+  void
+  addLink(size_t nodeA, size_t nodeB, std::string const& area) {
+    Link link;
+    link.nodeA = nodeA;
+    link.nodeB = nodeB;
+    link.area = area;
+    link.ifNameA = fmt::format("if-{}-{}-{}", area, nodeA, nodeB);
+    link.ifNameB = fmt::format("if-{}-{}-{}", area, nodeB, nodeA);
+    link.ifIndexA = 2 * links.size() + 1;
+    link.ifIndexB = 2 * links.size() + 2;
+    nodes.at(nodeA).links.emplace_back(links.size());
+    nodes.at(nodeB).links.emplace_back(links.size());
+    nodes.at(nodeA).areas.emplace(area);
+    nodes.at(nodeB).areas.emplace(area);
+    links.emplace_back(std::move(link));
+  }
+};
+
+class Emulation {
+ public:
+  explicit Emulation(Topology topo) : topo_(std::move(topo)) {
+    // wire up interfaces
+    IfNameAndifIndex ifIndexes;
+    ConnectedIfPairs connectedPairs;
+    for (auto const& link : topo_.links) {
+      ifIndexes.emplace_back(link.ifNameA, link.ifIndexA);
+      ifIndexes.emplace_back(link.ifNameB, link.ifIndexB);
+      connectedPairs[link.ifNameA].emplace_back(
+          link.ifNameB, FLAGS_link_latency_ms);
+      connectedPairs[link.ifNameB].emplace_back(
+          link.ifNameA, FLAGS_link_latency_ms);
+    }
+    mockIoProvider_->addIfNameIfIndex(ifIndexes);
+    mockIoProvider_->setConnectedPairs(connectedPairs);
+    mockIoProviderThread_ = std::thread([this]() {
+      LOG(INFO) << "Starting mockIoProvider thread.";
+      mockIoProvider_->start();
+      LOG(INFO) << "mockIoProvider thread got stopped.";
+    });
+    mockIoProvider_->waitUntilRunning();
+
+    // create instances, measuring memory of each
+    SystemMetrics systemMetrics;
+    for (size_t i = 0; i < topo_.nodes.size(); ++i) {
+      const auto rssBefore = systemMetrics.getRSSMemBytes().value_or(0);
+      openrs_.emplace_back(
+          std::make_unique<OpenrWrapper<apache::thrift::CompactSerializer>>(
+              context_,
+              topo_.nodes.at(i).name,
+              false /* v4Enabled */,
+              kKvStoreDbSyncInterval,
+              kSpark2HelloTime,
+              kSpark2FastInitHelloTime,
+              kSpark2HandshakeTime,
+              kSpark2HeartbeatTime,
+              kSpark2HandshakeHoldTime,
+              kSpark2HeartbeatHoldTime,
+              kSpark2GRHoldTime,
+              kLinkFlapInitialBackoff,
+              kLinkFlapMaxBackoff,
+              mockIoProvider_,
+              openr::memLimitMB,
+              topo_.getAreaConfigs(i),
+              false /* enablePrefixAllocation */));
+      const auto rssAfter = systemMetrics.getRSSMemBytes().value_or(0);
+      instanceMemBytes_.emplace_back(
+          rssAfter > rssBefore ? rssAfter - rssBefore : 0);
+    }
+    routeFingerprints_.resize(topo_.nodes.size(), 0);
+    numLoopbackRoutes_.resize(topo_.nodes.size(), 0);
+  }
+
+  ~Emulation() {
+    openrs_.clear();
+    mockIoProvider_->stop();
+    mockIoProviderThread_.join();
+  }
+
+  // start instances and bring up all links, return convergence time
+  std::optional<std::chrono::milliseconds>
+  start() {
+    for (auto& openr : openrs_) {
+      openr->run();
+    }
+    const auto startTime = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < openrs_.size(); ++i) {
+      openrs_.at(i)->addPrefixEntries(
+          thrift::PrefixType::LOOPBACK,
+          {createPrefixEntry(toIpPrefix(topo_.nodes.at(i).loopback))});
+      openrs_.at(i)->updateInterfaceDb(topo_.getInterfaceDb(i));
+    }
+    return waitForConvergence(startTime, true /* requireAllLoopbacks */);
+  }
+
+  // apply event, return convergence time
+  std::optional<std::chrono::milliseconds>
+  runEvent(std::function<void()> const& event) {
+    const auto startTime = std::chrono::steady_clock::now();
+    event();
+    return waitForConvergence(startTime, false /* requireAllLoopbacks */);
+  }
+
+  size_t
+  getNode(std::string const& str) const {
+    auto node = folly::to<size_t>(str);
+    CHECK_LT(node, topo_.nodes.size()) << "No node " << node;
+    return node;
+  }
+
+  size_t
+  getLink(std::vector<std::string> const& args) const {
+    CHECK_EQ(3, args.size()) << "Usage: " << args.at(0) << " <node> <node>";
+    auto link = topo_.findLink(getNode(args.at(1)), getNode(args.at(2)));
+    CHECK(link.has_value()) << "No link between " << args.at(1) << " and "
+                            << args.at(2);
+    return *link;
+  }
+
+  size_t
+  getRandomLink() const {
+    return folly::Random::rand32(topo_.links.size());
+  }
+
+  void
+  setLinkUp(size_t linkId, bool isUp) {
+    auto& link = topo_.links.at(linkId);
+    link.isUp = isUp;
+    openrs_.at(link.nodeA)->updateInterfaceDb(topo_.getInterfaceDb(link.nodeA));
+    openrs_.at(link.nodeB)->updateInterfaceDb(topo_.getInterfaceDb(link.nodeB));
+  }
+
+  void
+  setNodeOverload(size_t node, bool isOverloaded) {
+    openrs_.at(node)->setNodeOverload(isOverloaded);
+  }
+
+  void
+  printResources() {
+    std::vector<std::pair<std::chrono::nanoseconds, size_t>> cpuTimes;
+    for (size_t i = 0; i < openrs_.size(); ++i) {
+      cpuTimes.emplace_back(openrs_.at(i)->getCpuTime(), i);
+    }
+    std::sort(cpuTimes.begin(), cpuTimes.end());
+    std::chrono::nanoseconds totalCpu{0};
+    for (auto const& [cpuTime, _] : cpuTimes) {
+      totalCpu += cpuTime;
+    }
+    const auto toMs = [](std::chrono::nanoseconds ns) {
+      return std::chrono::duration_cast<std::chrono::milliseconds>(ns).count();
+    };
+    std::cout << fmt::format(
+                     "CPU per instance (ms): min {}, avg {}, max {}",
+                     toMs(cpuTimes.front().first),
+                     toMs(totalCpu / cpuTimes.size()),
+                     toMs(cpuTimes.back().first))
+              << std::endl;
+    for (size_t i = 0; i < std::min<size_t>(5, cpuTimes.size()); ++i) {
+      auto const& [cpuTime, node] = cpuTimes.at(cpuTimes.size() - 1 - i);
+      std::cout << fmt::format(
+                       "  {}: {} ms, {} links",
+                       topo_.nodes.at(node).name,
+                       toMs(cpuTime),
+                       topo_.nodes.at(node).links.size())
+                << std::endl;
+    }
+
+    auto [minMem, maxMem] =
+        std::minmax_element(instanceMemBytes_.begin(), instanceMemBytes_.end());
+    size_t totalMem{0};
+    for (auto mem : instanceMemBytes_) {
+      totalMem += mem;
+    }
+    std::cout << fmt::format(
+                     "RSS growth per instance creation (KB): min {}, avg {}, "
+                     "max {}",
+                     *minMem / 1024,
+                     totalMem / instanceMemBytes_.size() / 1024,
+                     *maxMem / 1024)
+              << std::endl;
+    std::cout << fmt::format(
+                     "Process RSS (MB): {}, {} KB per instance",
+                     SystemMetrics().getRSSMemBytes().value_or(0) >> 20,
+                     SystemMetrics().getRSSMemBytes().value_or(0) /
+                         openrs_.size() / 1024)
+              << std::endl;
+  }
+
+ private:
+  // Order insensitive fingerprint of unicast routes. Also count routes
+  // towards loopbacks of other nodes.
+  size_t
+  getRouteFingerprint(thrift::RouteDatabase const& routeDb, size_t& count) {
+    size_t fingerprint{0};
+    count = 0;
+    for (auto const& route : *routeDb.unicastRoutes_ref()) {
+      size_t nextHopsHash{0};
+      for (auto const& nextHop : *route.nextHops_ref()) {
+        nextHopsHash += folly::hash::hash_combine(
+            toString(nextHop), *nextHop.metric_ref());
+      }
+      const auto dest = toIPNetwork(*route.dest_ref());
+      fingerprint += folly::hash::hash_combine(
+          dest.first.str(), dest.second, nextHopsHash);
+      if (loopbacks_.count(dest)) {
+        ++count;
+      }
+    }
+    return fingerprint;
+  }
+
+  std::optional<std::chrono::milliseconds>
+  waitForConvergence(
+      std::chrono::steady_clock::time_point startTime,
+      bool requireAllLoopbacks) {
+    if (loopbacks_.empty()) {
+      for (auto const& node : topo_.nodes) {
+        loopbacks_.emplace(node.loopback);
+      }
+    }
+    auto lastChangeTime = startTime;
+    while (true) {
+      const auto now = std::chrono::steady_clock::now();
+      bool allLoopbacks{true};
+      for (size_t i = 0; i < openrs_.size(); ++i) {
+        const auto fingerprint = getRouteFingerprint(
+            openrs_.at(i)->fibDumpRouteDatabase(), numLoopbackRoutes_.at(i));
+        if (fingerprint != routeFingerprints_.at(i)) {
+          routeFingerprints_.at(i) = fingerprint;
+          lastChangeTime = now;
+        }
+        allLoopbacks &= numLoopbackRoutes_.at(i) + 1 == openrs_.size();
+      }
+
+      if ((allLoopbacks or not requireAllLoopbacks) and
+          now - lastChangeTime >=
+              std::chrono::milliseconds(FLAGS_quiet_period_ms)) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            lastChangeTime - startTime);
+      }
+      if (now - startTime >=
+          std::chrono::seconds(FLAGS_convergence_timeout_s)) {
+        return std::nullopt;
+      }
+      std::this_thread::sleep_for(
+          std::chrono::milliseconds(FLAGS_poll_interval_ms));
+    }
+  }
+
+  Topology topo_;
+  fbzmq::Context context_;
+  std::shared_ptr<MockIoProvider> mockIoProvider_{
+      std::make_shared<MockIoProvider>()};
+  std::thread mockIoProviderThread_;
+  std::vector<std::unique_ptr<OpenrWrapper<apache::thrift::CompactSerializer>>>
+      openrs_;
+
+  // RSS grown by creation of each instance
+  std::vector<size_t> instanceMemBytes_;
+
+  // state of route databases as of last poll
+  std::unordered_set<folly::CIDRNetwork> loopbacks_;
+  std::vector<size_t> routeFingerprints_;
+  std::vector<size_t> numLoopbackRoutes_;
+};
+
+void
+printConvergence(
+    std::string const& event, std::optional<std::chrono::milliseconds> time) {
+  if (time.has_value()) {
+    std::cout << fmt::format("{}: converged in {} ms", event, time->count())
+              << std::endl;
+  } else {
+    std::cout << fmt::format(
+                     "{}: not converged in {} s",
+                     event,
+                     FLAGS_convergence_timeout_s)
+              << std::endl;
+  }
+}
+
+} // namespace
+
+int
+main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+
+  CHECK_GT(FLAGS_num_nodes, 1) << "Need at least two nodes";
+  std::optional<Topology> topo;
+  if (FLAGS_topology == "fabric") {
+    topo = Topology::createFabric(FLAGS_num_nodes, FLAGS_fabric_num_spines);
+  } else if (FLAGS_topology == "grid") {
+    topo = Topology::createGrid(FLAGS_num_nodes, FLAGS_grid_width, 1);
+  } else if (FLAGS_topology == "area") {
+    topo = Topology::createGrid(
+        FLAGS_num_nodes, FLAGS_grid_width, FLAGS_num_areas);
+  } else {
+    LOG(FATAL) << "Unknown topology: " << FLAGS_topology;
+  }
+  std::cout << fmt::format(
+                   "Emulating {} topology of {} nodes and {} links",
+                   FLAGS_topology,
+                   topo->nodes.size(),
+                   topo->links.size())
+            << std::endl;
+
+  Emulation emulation(std::move(*topo));
+  printConvergence("start", emulation.start());
+
+  std::vector<std::string> events;
+  folly::split(';', FLAGS_events, events, true /* ignoreEmpty */);
+  for (auto const& event : events) {
+    std::vector<std::string> args;
+    folly::split(' ', folly::trimWhitespace(event), args, true);
+    if (args.empty()) {
+      continue;
+    }
+    auto const& type = args.at(0);
+    auto flap = [&](std::string const& name, size_t link) {
+      printConvergence(name + " (down)", emulation.runEvent([&]() {
+        emulation.setLinkUp(link, false);
+      }));
+      printConvergence(name + " (up)", emulation.runEvent([&]() {
+        emulation.setLinkUp(link, true);
+      }));
+    };
+    if (type == "link_down" or type == "link_up") {
+      const auto link = emulation.getLink(args);
+      printConvergence(event, emulation.runEvent([&]() {
+        emulation.setLinkUp(link, type == "link_up");
+      }));
+    } else if (type == "flap") {
+      flap(event, emulation.getLink(args));
+    } else if (type == "random_flap") {
+      CHECK_EQ(2, args.size()) << "Usage: random_flap <count>";
+      for (size_t i = 0; i < folly::to<size_t>(args.at(1)); ++i) {
+        const auto link = emulation.getRandomLink();
+        flap(fmt::format("random_flap link {}", link), link);
+      }
+    } else if (type == "drain" or type == "undrain") {
+      CHECK_EQ(2, args.size()) << "Usage: " << type << " <node>";
+      const auto node = emulation.getNode(args.at(1));
+      printConvergence(event, emulation.runEvent([&]() {
+        emulation.setNodeOverload(node, type == "drain");
+      }));
+    } else {
+      LOG(FATAL) << "Unknown event: " << type;
+    }
+  }
+
+  emulation.printResources();
+  return 0;
+}
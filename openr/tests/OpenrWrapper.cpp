@@ -7,6 +7,9 @@
 
 #include <openr/tests/OpenrWrapper.h>
 
+#include <pthread.h>
+#include <time.h>
+
 #include <openr/config/tests/Utils.h>
 
 namespace openr {
@@ -27,7 +30,9 @@ OpenrWrapper<Serializer>::OpenrWrapper(
     std::chrono::milliseconds linkFlapInitialBackoff,
     std::chrono::milliseconds linkFlapMaxBackoff,
     std::shared_ptr<IoProvider> ioProvider,
-    uint32_t memLimit)
+    uint32_t memLimit,
+    std::vector<thrift::AreaConfig> const& areaConfigs,
+    bool enablePrefixAllocation)
     : context_(context),
       nodeId_(nodeId),
       ioProvider_(std::move(ioProvider)),
@@ -37,7 +42,7 @@ OpenrWrapper<Serializer>::OpenrWrapper(
   auto tConfig = getBasicOpenrConfig(
       nodeId_,
       "terragraph",
-      {}, /* area config */
+      areaConfigs,
       v4Enabled,
       true /*enableSegmentRouting*/,
       true /*dryrun*/,
@@ -63,14 +68,16 @@ OpenrWrapper<Serializer>::OpenrWrapper(
   tConfig.decision_config_ref()->enable_bgp_route_programming_ref() = true;
 
   // prefix allocation config
-  tConfig.enable_prefix_allocation_ref() = true;
-  thrift::PrefixAllocationConfig pfxAllocationConf;
-  pfxAllocationConf.loopback_interface_ref() = "";
-  pfxAllocationConf.prefix_allocation_mode_ref() =
-      thrift::PrefixAllocationMode::DYNAMIC_ROOT_NODE;
-  pfxAllocationConf.seed_prefix_ref() = "fc00:cafe:babe::/62";
-  pfxAllocationConf.allocate_prefix_len_ref() = 64;
-  tConfig.prefix_allocation_config_ref() = std::move(pfxAllocationConf);
+  tConfig.enable_prefix_allocation_ref() = enablePrefixAllocation;
+  if (enablePrefixAllocation) {
+    thrift::PrefixAllocationConfig pfxAllocationConf;
+    pfxAllocationConf.loopback_interface_ref() = "";
+    pfxAllocationConf.prefix_allocation_mode_ref() =
+        thrift::PrefixAllocationMode::DYNAMIC_ROOT_NODE;
+    pfxAllocationConf.seed_prefix_ref() = "fc00:cafe:babe::/62";
+    pfxAllocationConf.allocate_prefix_len_ref() = 64;
+    tConfig.prefix_allocation_config_ref() = std::move(pfxAllocationConf);
+  }
 
   // watchdog
   tConfig.enable_watchdog_ref() = true;
@@ -230,16 +237,18 @@ OpenrWrapper<Serializer>::OpenrWrapper(
   //
   // create PrefixAllocator
   //
-  prefixAllocator_ = std::make_unique<PrefixAllocator>(
-      kTestingAreaName,
-      config_,
-      nlSock_.get(),
-      kvStore_.get(),
-      configStore_.get(),
-      prefixUpdatesQueue_,
-      logSampleQueue_,
-      kvRequestQueue_,
-      Constants::kPrefixAllocatorSyncInterval);
+  if (enablePrefixAllocation) {
+    prefixAllocator_ = std::make_unique<PrefixAllocator>(
+        kTestingAreaName,
+        config_,
+        nlSock_.get(),
+        kvStore_.get(),
+        configStore_.get(),
+        prefixUpdatesQueue_,
+        logSampleQueue_,
+        kvRequestQueue_,
+        Constants::kPrefixAllocatorSyncInterval);
+  }
 
   // create thrift-server for this openr node
   thriftServer_ = std::make_unique<OpenrThriftServerWrapper>(
@@ -290,13 +299,15 @@ OpenrWrapper<Serializer>::run() {
   allThreads_.emplace_back(std::move(prefixManagerThread));
 
   // Spawn a PrefixAllocator thread
-  std::thread prefixAllocatorThread([this]() noexcept {
-    VLOG(1) << nodeId_ << " PrefixAllocator running.";
-    prefixAllocator_->run();
-    VLOG(1) << nodeId_ << " PrefixAllocator stopped.";
-  });
-  prefixAllocator_->waitUntilRunning();
-  allThreads_.emplace_back(std::move(prefixAllocatorThread));
+  if (prefixAllocator_) {
+    std::thread prefixAllocatorThread([this]() noexcept {
+      VLOG(1) << nodeId_ << " PrefixAllocator running.";
+      prefixAllocator_->run();
+      VLOG(1) << nodeId_ << " PrefixAllocator stopped.";
+    });
+    prefixAllocator_->waitUntilRunning();
+    allThreads_.emplace_back(std::move(prefixAllocatorThread));
+  }
 
   // start spark thread
   std::thread sparkThread([this]() {
@@ -386,8 +397,10 @@ OpenrWrapper<Serializer>::stop() {
   linkMonitor_->waitUntilStopped();
   spark_->stop();
   spark_->waitUntilStopped();
-  prefixAllocator_->stop();
-  prefixAllocator_->waitUntilStopped();
+  if (prefixAllocator_) {
+    prefixAllocator_->stop();
+    prefixAllocator_->waitUntilStopped();
+  }
   prefixManager_->stop();
   prefixManager_->waitUntilStopped();
   monitor_->stop();
@@ -505,6 +518,30 @@ OpenrWrapper<Serializer>::getCounters() {
   return facebook::fb303::fbData->getCounters();
 }
 
+template <class Serializer>
+void
+OpenrWrapper<Serializer>::setNodeOverload(bool isOverloaded) {
+  linkMonitor_->semifuture_setNodeOverload(isOverloaded).get();
+}
+
+template <class Serializer>
+std::chrono::nanoseconds
+OpenrWrapper<Serializer>::getCpuTime() {
+  std::chrono::nanoseconds cpuTime{0};
+  for (auto& t : allThreads_) {
+    clockid_t clockId;
+    struct timespec ts;
+    if (not t.joinable() or
+        pthread_getcpuclockid(t.native_handle(), &clockId) != 0 or
+        clock_gettime(clockId, &ts) != 0) {
+      continue;
+    }
+    cpuTime += std::chrono::seconds(ts.tv_sec) +
+        std::chrono::nanoseconds(ts.tv_nsec);
+  }
+  return cpuTime;
+}
+
 // define template instance for some common serializers
 template class OpenrWrapper<apache::thrift::CompactSerializer>;
 template class OpenrWrapper<apache::thrift::BinarySerializer>;
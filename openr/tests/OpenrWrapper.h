@@ -54,7 +54,9 @@ class OpenrWrapper {
       std::chrono::milliseconds linkFlapInitialBackoff,
       std::chrono::milliseconds linkFlapMaxBackoff,
       std::shared_ptr<IoProvider> ioProvider,
-      uint32_t memLimit = openr::memLimitMB);
+      uint32_t memLimit = openr::memLimitMB,
+      std::vector<thrift::AreaConfig> const& areaConfigs = {},
+      bool enablePrefixAllocation = true);
 
   ~OpenrWrapper() {
     stop();
@@ -108,6 +110,17 @@ class OpenrWrapper {
    */
   std::map<std::string, int64_t> getCounters();
 
+  /**
+   * drain or undrain node via link monitor
+   */
+  void setNodeOverload(bool isOverloaded);
+
+  /**
+   * CPU time consumed by module threads of this instance so far. Threads
+   * spawned by modules themselves, e.g. thread pools, are not accounted.
+   */
+  std::chrono::nanoseconds getCpuTime();
+
   /*
    * watchdog thread (used for checking memory limit exceeded)
    */
@@ -165,7 +178,7 @@ class OpenrWrapper {
   // sub module communication queues
   const std::string kvStoreGlobalCmdUrl_;
   messaging::ReplicateQueue<DecisionRouteUpdate> routeUpdatesQueue_;
-  messaging::ReplicateQueue<InterfaceDatabase> interfaceUpdatesQueue_;
+  messaging::ReplicateQueue<InterfaceUpdate> interfaceUpdatesQueue_;
   messaging::ReplicateQueue<PeerEvent> peerUpdatesQueue_;
   messaging::ReplicateQueue<KeyValueRequest> kvRequestQueue_;
   messaging::ReplicateQueue<NeighborEvents> neighborUpdatesQueue_;
@@ -9,6 +9,7 @@
 #include <chrono>
 
 #include <folly/Exception.h>
+#include <folly/Random.h>
 #include <folly/ScopeGuard.h>
 #include <folly/SocketAddress.h>
 #include <openr/tests/mocks/MockIoProvider.h>
@@ -31,6 +32,14 @@ MockIoProvider::setConnectedPairs(ConnectedIfPairs connectedIfPairs) {
   connectedIfPairs_ = std::move(connectedIfPairs);
 }
 
+void
+MockIoProvider::setPacketLossRate(double packetLossRate) {
+  VLOG(4) << "MockIoProvider::setPacketLossRate called";
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  packetLossRate_ = packetLossRate;
+}
+
 int
 MockIoProvider::socket(int /* domain */, int /* type */, int /* protocol */) {
   VLOG(4) << "MockIoProvider::socket called";
@@ -86,6 +95,13 @@ MockIoProvider::recvmsg(int sockFd, struct msghdr* msg, int /* flags */) {
     return -1;
   }
 
+  // messages still in flight are not visible to the receiver yet
+  if (not it->second.front().isActive()) {
+    VLOG(4) << "No delivered message for fd " << sockFd << " ifName "
+            << fdToIfName_[sockFd];
+    return -1;
+  }
+
   // Read a byte from the buffer if any. There can be multiple read attempts
   uint8_t buf;
   if (read(sockFd, &buf, sizeof(buf)) > 0) {
@@ -158,8 +174,12 @@ MockIoProvider::recvmsg(int sockFd, struct msghdr* msg, int /* flags */) {
   cmsg->cmsg_type = SO_TIMESTAMPNS;
   cmsg->cmsg_len = CMSG_LEN(sizeof(struct timespec));
 
+  // stamp the message with its arrival time like the kernel would, so that
+  // time spent waiting for the reader is not accounted in measured RTT
+  auto const sinceDelivery =
+      std::chrono::steady_clock::now() - ioMessage.deliveryTime;
   auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
-      std::chrono::system_clock::now().time_since_epoch());
+      std::chrono::system_clock::now().time_since_epoch() - sinceDelivery);
   auto sec = std::chrono::duration_cast<std::chrono::seconds>(ns);
   struct timespec curTime;
   curTime.tv_sec = sec.count();
@@ -173,6 +193,46 @@ MockIoProvider::recvmsg(int sockFd, struct msghdr* msg, int /* flags */) {
   return packet.size();
 }
 
+int
+MockIoProvider::recvmmsg(
+    int sockFd, struct mmsghdr* msgvec, unsigned int vlen, int flags) {
+  VLOG(4) << "MockIoProvider::recvmmsg called ";
+
+  // Receive messages one by one until mailbox is drained
+  unsigned int numMsgs = 0;
+  for (; numMsgs < vlen; ++numMsgs) {
+    auto bytesRead = recvmsg(sockFd, &msgvec[numMsgs].msg_hdr, flags);
+    if (bytesRead < 0) {
+      break;
+    }
+    msgvec[numMsgs].msg_len = bytesRead;
+  }
+
+  if (numMsgs == 0) {
+    errno = EAGAIN;
+    return -1;
+  }
+  return numMsgs;
+}
+
+int
+MockIoProvider::sendmmsg(
+    int sockFd, struct mmsghdr* msgvec, unsigned int vlen, int flags) {
+  VLOG(4) << "MockIoProvider::sendmmsg called ";
+
+  // Send messages one by one until one fails
+  unsigned int numMsgs = 0;
+  for (; numMsgs < vlen; ++numMsgs) {
+    auto bytesSent = sendmsg(sockFd, &msgvec[numMsgs].msg_hdr, flags);
+    if (bytesSent < 0) {
+      break;
+    }
+    msgvec[numMsgs].msg_len = bytesSent;
+  }
+
+  return numMsgs == 0 ? -1 : numMsgs;
+}
+
 ssize_t
 MockIoProvider::sendmsg(int sockFd, const struct msghdr* msg, int /* flags */) {
   VLOG(4) << "MockIoProvider::sendmsg called";
@@ -235,6 +295,13 @@ MockIoProvider::sendmsg(int sockFd, const struct msghdr* msg, int /* flags */) {
       LOG(WARNING) << "Src and dst fd is the same. Pkt looped";
     }
 
+    // packet is lost on the wire, sender doesn't notice
+    if (packetLossRate_ > 0 and
+        folly::Random::randDouble01() < packetLossRate_) {
+      sent = true;
+      continue;
+    }
+
     auto& msgQueue = mailboxes_[otherFd];
 
     // copy the data from iov
@@ -82,6 +82,9 @@ class MockIoProvider final : public IoProvider {
   // packet sent off of x will be delivered to y, z
   void setConnectedPairs(ConnectedIfPairs connectedIfPairs);
 
+  // drop given fraction [0, 1] of packets, chosen randomly, on every link
+  void setPacketLossRate(double packetLossRate);
+
   //
   // The usual IO jazz
   //
@@ -95,8 +98,20 @@ class MockIoProvider final : public IoProvider {
 
   ssize_t recvmsg(int sockfd, struct msghdr* msg, int flags) override;
 
+  int recvmmsg(
+      int sockfd,
+      struct mmsghdr* msgvec,
+      unsigned int vlen,
+      int flags) override;
+
   ssize_t sendmsg(int sockfd, const struct msghdr* msg, int flags) override;
 
+  int sendmmsg(
+      int sockfd,
+      struct mmsghdr* msgvec,
+      unsigned int vlen,
+      int flags) override;
+
   int setsockopt(
       int sockfd,
       int level,
@@ -118,6 +133,8 @@ class MockIoProvider final : public IoProvider {
 
   ConnectedIfPairs connectedIfPairs_{};
 
+  double packetLossRate_{0};
+
   // Map of send/recv fds. All fds used below belong to recv-fd which is being
   // polled by Spark (or returned to spark).
   std::map<int /* recv-fd */, int /* send-fd */> pipeFds_;
@@ -5,8 +5,10 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <thread>
 #include <unistd.h>
 
+#include <folly/Random.h>
 #include <folly/futures/Promise.h>
 #include <folly/gen/Base.h>
 #include <glog/logging.h>
@@ -41,6 +43,7 @@ void
 MockNetlinkFibHandler::addUnicastRoutes(
     int16_t, std::unique_ptr<std::vector<openr::thrift::UnicastRoute>> routes) {
   ensureHealthy();
+  simulateLatency();
 
   // Acquire locks
   auto unicastRouteDb = unicastRouteDb_.wlock();
@@ -53,7 +56,7 @@ MockNetlinkFibHandler::addUnicastRoutes(
         toIPAddress(*route.dest_ref()->prefixAddress_ref()),
         *route.dest_ref()->prefixLength_ref());
 
-    if (dirtyPrefixes->count(prefix)) {
+    if (dirtyPrefixes->count(prefix) or shouldFail()) {
       failedPrefixes.emplace_back(*route.dest_ref());
       continue;
     }
@@ -83,6 +86,7 @@ void
 MockNetlinkFibHandler::deleteUnicastRoutes(
     int16_t, std::unique_ptr<std::vector<openr::thrift::IpPrefix>> prefixes) {
   ensureHealthy();
+  simulateLatency();
 
   // Acquire locks
   auto unicastRouteDb = unicastRouteDb_.wlock();
@@ -102,6 +106,7 @@ void
 MockNetlinkFibHandler::syncFib(
     int16_t, std::unique_ptr<std::vector<openr::thrift::UnicastRoute>> routes) {
   ensureHealthy();
+  simulateLatency();
 
   // Acquire locks
   auto unicastRouteDb = unicastRouteDb_.wlock();
@@ -115,7 +120,7 @@ MockNetlinkFibHandler::syncFib(
         toIPAddress(*route.dest_ref()->prefixAddress_ref()),
         *route.dest_ref()->prefixLength_ref());
 
-    if (dirtyPrefixes->count(prefix)) {
+    if (dirtyPrefixes->count(prefix) or shouldFail()) {
       failedPrefixesToAdd.emplace_back(*route.dest_ref());
       continue;
     }
@@ -160,6 +165,7 @@ void
 MockNetlinkFibHandler::addMplsRoutes(
     int16_t, std::unique_ptr<std::vector<openr::thrift::MplsRoute>> routes) {
   ensureHealthy();
+  simulateLatency();
 
   // Acquire locks
   auto mplsRouteDb = mplsRouteDb_.wlock();
@@ -169,7 +175,7 @@ MockNetlinkFibHandler::addMplsRoutes(
   std::vector<int32_t> failedLabels;
   for (auto& route : *routes) {
     // If route is marked dirty add it to exception and continue
-    if (dirtyLabels->count(*route.topLabel_ref())) {
+    if (dirtyLabels->count(*route.topLabel_ref()) or shouldFail()) {
       failedLabels.emplace_back(*route.topLabel_ref());
       continue;
     }
@@ -192,6 +198,7 @@ void
 MockNetlinkFibHandler::deleteMplsRoutes(
     int16_t, std::unique_ptr<std::vector<int32_t>> labels) {
   ensureHealthy();
+  simulateLatency();
 
   // Acquire locks
   auto mplsRouteDb = mplsRouteDb_.wlock();
@@ -208,6 +215,7 @@ void
 MockNetlinkFibHandler::syncMplsFib(
     int16_t, std::unique_ptr<std::vector<openr::thrift::MplsRoute>> routes) {
   ensureHealthy();
+  simulateLatency();
 
   // Acquire locks
   auto mplsRouteDb = mplsRouteDb_.wlock();
@@ -218,7 +226,7 @@ MockNetlinkFibHandler::syncMplsFib(
   mplsRouteDb->clear();
   for (auto& route : *routes) {
     // If route is marked dirty add it to exception and continue
-    if (dirtyLabels->count(*route.topLabel_ref())) {
+    if (dirtyLabels->count(*route.topLabel_ref()) or shouldFail()) {
       failedLabelsToAdd.emplace_back(*route.topLabel_ref());
       continue;
     }
@@ -391,4 +399,18 @@ MockNetlinkFibHandler::ensureHealthy() {
   }
 }
 
+void
+MockNetlinkFibHandler::simulateLatency() {
+  if (auto latencyMs = programmingLatencyMs_.load(); latencyMs > 0) {
+    /* sleep override */
+    std::this_thread::sleep_for(std::chrono::milliseconds(latencyMs));
+  }
+}
+
+bool
+MockNetlinkFibHandler::shouldFail() {
+  auto failureRate = failureRate_.load();
+  return failureRate > 0 and folly::Random::randDouble01() < failureRate;
+}
+
 } // namespace openr
@@ -127,6 +127,26 @@ class MockNetlinkFibHandler final : public thrift::FibServiceSvIf {
       std::vector<folly::CIDRNetwork> const& dirtyPrefixes,
       std::vector<int32_t> const& dirtyLabels);
 
+  /**
+   * Simulates a real platform agent. Each route programming call takes
+   * `latency` to complete, and each route of an add or sync call fails to
+   * program with probability `failureRate`. Failed routes are reported the
+   * same way as dirty ones.
+   */
+  void
+  setProgrammingLatency(std::chrono::milliseconds latency) {
+    programmingLatencyMs_ = latency.count();
+  }
+  void
+  setFailureRate(double failureRate) {
+    failureRate_ = failureRate;
+  }
+
+  size_t
+  getUnicastRoutesCount() {
+    return unicastRouteDb_.rlock()->size();
+  }
+
   void stop();
 
   void restart();
@@ -135,6 +155,12 @@ class MockNetlinkFibHandler final : public thrift::FibServiceSvIf {
   // Make sure the FibHandler is in healthy state. Else throw exception
   void ensureHealthy();
 
+  // Block for the simulated programming latency, if any
+  void simulateLatency();
+
+  // Returns true if a route should fail to program as per the failure rate
+  bool shouldFail();
+
   // Time when service started, in number of seconds, since epoch
   folly::Synchronized<int64_t> startTime_{0};
 
@@ -159,6 +185,10 @@ class MockNetlinkFibHandler final : public thrift::FibServiceSvIf {
   std::atomic<size_t> delMplsRoutesCount_{0};
   std::atomic<bool> isHealthy_{true};
 
+  // Simulated platform behavior
+  std::atomic<int64_t> programmingLatencyMs_{0};
+  std::atomic<double> failureRate_{0};
+
   // A baton for synchronization
   folly::Baton<> updateUnicastRoutesBaton_;
   folly::Baton<> deleteUnicastRoutesBaton_;
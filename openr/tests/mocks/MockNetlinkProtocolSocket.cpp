@@ -53,7 +53,10 @@ MockNetlinkProtocolSocket::MockNetlinkProtocolSocket(folly::EventBase* evb)
     : NetlinkProtocolSocket(evb, netlinkEventsQueue_) {
   // Initialize stats
   fb303::fbData->addStatExportType("nlmock.add_route", fb303::SUM);
+  fb303::fbData->addStatExportType("nlmock.add_routes", fb303::SUM);
   fb303::fbData->addStatExportType("nlmock.delete_route", fb303::SUM);
+  fb303::fbData->addStatExportType("nlmock.add_nexthop", fb303::SUM);
+  fb303::fbData->addStatExportType("nlmock.delete_nexthop", fb303::SUM);
 }
 
 folly::SemiFuture<int>
@@ -61,6 +64,11 @@ MockNetlinkProtocolSocket::addRoute(const fbnl::Route& route) {
   fb303::fbData->addStatValue("nlmock.add_route", 1, fb303::SUM);
   // Blindly replace existing route
   const auto proto = route.getProtocolId();
+  // Referred nexthop object must exist
+  if (route.getNextHopId().has_value() and
+      not nexthops_.count(route.getNextHopId().value())) {
+    return folly::SemiFuture<int>(-EINVAL);
+  }
   if (route.getFamily() == AF_MPLS) {
     mplsRoutes_[proto][route.getMplsLabel().value()] = route;
   } else {
@@ -69,6 +77,17 @@ MockNetlinkProtocolSocket::addRoute(const fbnl::Route& route) {
   return folly::SemiFuture<int>(0);
 }
 
+folly::SemiFuture<std::vector<int>>
+MockNetlinkProtocolSocket::addRoutes(std::vector<fbnl::Route> routes) {
+  fb303::fbData->addStatValue("nlmock.add_routes", 1, fb303::SUM);
+  std::vector<int> statuses;
+  statuses.reserve(routes.size());
+  for (auto const& route : routes) {
+    statuses.emplace_back(addRoute(route).get());
+  }
+  return folly::SemiFuture<std::vector<int>>(std::move(statuses));
+}
+
 folly::SemiFuture<int>
 MockNetlinkProtocolSocket::deleteRoute(const fbnl::Route& route) {
   fb303::fbData->addStatValue("nlmock.delete_route", 1, fb303::SUM);
@@ -107,6 +126,13 @@ MockNetlinkProtocolSocket::getRoutes(const fbnl::Route& filter) {
       return;
     }
 
+    // Like kernel, report nexthops of the referred nexthop object
+    if (route.getNextHopId().has_value()) {
+      result.emplace_back(route);
+      result.back().setNextHops(getNextHops(route.getNextHopId().value()));
+      return;
+    }
+
     result.emplace_back(route);
   };
 
@@ -127,6 +153,97 @@ MockNetlinkProtocolSocket::getRoutes(const fbnl::Route& filter) {
   return result;
 }
 
+void
+MockNetlinkProtocolSocket::streamRoutes(
+    const fbnl::Route& filter,
+    size_t chunkSize,
+    RouteChunkCallback onChunk,
+    RouteDumpDoneCallback onDone) {
+  CHECK_GT(chunkSize, 0);
+  auto routes = getRoutes(filter).get().value();
+  for (size_t i = 0; i < routes.size(); i += chunkSize) {
+    const auto end = std::min(routes.size(), i + chunkSize);
+    onChunk(std::vector<fbnl::Route>(
+        std::make_move_iterator(routes.begin() + i),
+        std::make_move_iterator(routes.begin() + end)));
+  }
+  onDone(0);
+}
+
+fbnl::NextHopSet
+MockNetlinkProtocolSocket::getNextHops(uint32_t nhId) const {
+  fbnl::NextHopSet nextHops;
+  auto it = nexthops_.find(nhId);
+  if (it == nexthops_.end()) {
+    return nextHops;
+  }
+  if (it->second.getNextHop().has_value()) {
+    nextHops.emplace(it->second.getNextHop().value());
+  }
+  for (auto const& [id, weight] : it->second.getGroup()) {
+    const auto& nh = nexthops_.at(id).getNextHop().value();
+    fbnl::NextHopBuilder builder;
+    if (nh.getIfIndex().has_value()) {
+      builder.setIfIndex(nh.getIfIndex().value());
+    }
+    if (nh.getGateway().has_value()) {
+      builder.setGateway(nh.getGateway().value());
+    }
+    if (nh.getLabelAction().has_value()) {
+      builder.setLabelAction(nh.getLabelAction().value());
+    }
+    if (nh.getPushLabels().has_value()) {
+      builder.setPushLabels(nh.getPushLabels().value());
+    }
+    builder.setWeight(weight);
+    nextHops.emplace(builder.build());
+  }
+  return nextHops;
+}
+
+folly::SemiFuture<int>
+MockNetlinkProtocolSocket::addNexthop(const fbnl::NextHopObject& nexthop) {
+  fb303::fbData->addStatValue("nlmock.add_nexthop", 1, fb303::SUM);
+  // Group members must exist
+  for (auto const& [id, _] : nexthop.getGroup()) {
+    if (not nexthops_.count(id)) {
+      return folly::SemiFuture<int>(-EINVAL);
+    }
+  }
+  // Blindly replace existing nexthop
+  nexthops_.erase(nexthop.getId());
+  nexthops_.emplace(nexthop.getId(), nexthop);
+  return folly::SemiFuture<int>(0);
+}
+
+folly::SemiFuture<int>
+MockNetlinkProtocolSocket::deleteNexthop(const fbnl::NextHopObject& nexthop) {
+  fb303::fbData->addStatValue("nlmock.delete_nexthop", 1, fb303::SUM);
+  if (not nexthops_.erase(nexthop.getId())) {
+    return folly::SemiFuture<int>(-ENOENT);
+  }
+  // Like kernel, remove routes referring to the deleted nexthop
+  for (auto& [_, routes] : unicastRoutes_) {
+    for (auto it = routes.begin(); it != routes.end();) {
+      if (it->second.getNextHopId() == nexthop.getId()) {
+        it = routes.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  return folly::SemiFuture<int>(0);
+}
+
+folly::SemiFuture<folly::Expected<std::vector<fbnl::NextHopObject>, int>>
+MockNetlinkProtocolSocket::getAllNexthops() {
+  std::vector<fbnl::NextHopObject> nexthops;
+  for (auto& [_, nexthop] : nexthops_) {
+    nexthops.emplace_back(nexthop);
+  }
+  return nexthops;
+}
+
 folly::SemiFuture<int>
 MockNetlinkProtocolSocket::addIfAddress(const fbnl::IfAddress& addr) {
   // Search for addr list of interface index (it must exists)
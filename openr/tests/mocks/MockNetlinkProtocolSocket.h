@@ -51,9 +51,16 @@ class MockNetlinkProtocolSocket : public NetlinkProtocolSocket {
    * Overrides API of NetlinkProtocolSocket for testing
    */
   folly::SemiFuture<int> addRoute(const fbnl::Route& route) override;
+  folly::SemiFuture<std::vector<int>> addRoutes(
+      std::vector<fbnl::Route> routes) override;
   folly::SemiFuture<int> deleteRoute(const fbnl::Route& route) override;
   folly::SemiFuture<folly::Expected<std::vector<fbnl::Route>, int>> getRoutes(
       const fbnl::Route& filter) override;
+  void streamRoutes(
+      const fbnl::Route& filter,
+      size_t chunkSize,
+      RouteChunkCallback onChunk,
+      RouteDumpDoneCallback onDone) override;
 
   folly::SemiFuture<int> addIfAddress(const fbnl::IfAddress&) override;
   folly::SemiFuture<int> deleteIfAddress(const fbnl::IfAddress&) override;
@@ -66,6 +73,11 @@ class MockNetlinkProtocolSocket : public NetlinkProtocolSocket {
   folly::SemiFuture<folly::Expected<std::vector<fbnl::Neighbor>, int>>
   getAllNeighbors() override;
 
+  folly::SemiFuture<int> addNexthop(const fbnl::NextHopObject&) override;
+  folly::SemiFuture<int> deleteNexthop(const fbnl::NextHopObject&) override;
+  folly::SemiFuture<folly::Expected<std::vector<fbnl::NextHopObject>, int>>
+  getAllNexthops() override;
+
   /*
    * API to manipulate netlinkEvents queue
    */
@@ -91,6 +103,9 @@ class MockNetlinkProtocolSocket : public NetlinkProtocolSocket {
   }
 
  private:
+  // Resolve nexthops of nexthop object (single or group)
+  fbnl::NextHopSet getNextHops(uint32_t nhId) const;
+
   // map<ifIndex -> Link>
   // NOTE: using map for ordered entries
   std::map<int, fbnl::Link> links_;
@@ -105,6 +120,10 @@ class MockNetlinkProtocolSocket : public NetlinkProtocolSocket {
       unicastRoutes_;
   std::unordered_map<uint8_t, std::map<uint32_t, fbnl::Route>> mplsRoutes_;
 
+  // map<nexthop-id -> NextHopObject>
+  // NOTE: using map for ordered entries
+  std::map<uint32_t, fbnl::NextHopObject> nexthops_;
+
   // queue to publish LINK/ADDR updates
   messaging::ReplicateQueue<NetlinkEvent> netlinkEventsQueue_;
 };
@@ -8,6 +8,7 @@
 #include "openr/watchdog/Watchdog.h"
 #include <fb303/ServiceData.h>
 #include <openr/common/Constants.h>
+#include <openr/common/MemoryPressure.h>
 #include <openr/common/Util.h>
 #include <openr/watchdog/Watchdog.h>
 #include "folly/Range.h"
@@ -23,6 +24,17 @@ Watchdog::Watchdog(std::shared_ptr<const Config> config)
       threadTimeout_(*config->getWatchdogConfig().thread_timeout_s_ref()),
       maxMemoryMB_(*config->getWatchdogConfig().max_memory_mb_ref()),
       isDeadThreadDetected_(false) {
+  if (auto stallS = config->getWatchdogConfig().cpu_profile_stall_s_ref()) {
+    cpuProfileStallTime_ = std::chrono::seconds(*stallS);
+  }
+  if (auto softMemoryMB = config->getWatchdogConfig().soft_memory_mb_ref()) {
+    softMemoryMB_ = *softMemoryMB;
+  }
+  if (auto thresholdMs =
+          config->getWatchdogConfig().slow_callback_threshold_ms_ref()) {
+    slowCallbackThreshold_ = std::chrono::milliseconds(*thresholdMs);
+  }
+
   // Schedule periodic timer for checking thread health
   watchdogTimer_ = folly::AsyncTimeout::make(*getEvb(), [this]() noexcept {
     // check dead thread
@@ -49,6 +61,9 @@ Watchdog::addEvb(OpenrEventBase* evb) {
   getEvb()->runInEventBaseThreadAndWait([this, evb]() {
     CHECK_EQ(monitorEvbs_.count(evb), 0);
     monitorEvbs_.emplace(evb);
+    if (slowCallbackThreshold_.has_value()) {
+      evb->setSlowCallbackThreshold(*slowCallbackThreshold_);
+    }
   });
 }
 
@@ -75,6 +90,20 @@ Watchdog::monitorMemory() {
   if (not memInUse_.has_value()) {
     return;
   }
+  // shed optional memory of modules while above soft limit, hoping to never
+  // reach the hard limit
+  if (softMemoryMB_.has_value()) {
+    const bool underPressure = memInUse_.value() / 1e6 > *softMemoryMB_;
+    MemoryPressure::setUnderPressure(underPressure);
+    if (underPressure) {
+      LOG(WARNING) << fmt::format(
+          "[Mem Detector] High memory usage: {} bytes. Soft limit: {} MB. "
+          "Shedding optional memory.",
+          memInUse_.value(),
+          *softMemoryMB_);
+      MemoryPressure::shed();
+    }
+  }
   if (memInUse_.value() / 1e6 > maxMemoryMB_) {
     LOG(WARNING) << fmt::format(
         "[Mem Detector] Critical memory usage: {} bytes. Memory limit: {} MB.",
@@ -121,6 +150,14 @@ Watchdog::monitorThreadStatus() {
           "[Dead Thread Detector] {} thread detected to be dead.", name);
       stuckThreads.emplace_back(name);
     }
+
+    if (cpuProfileStallTime_.has_value()) {
+      if (timeDiff <= *cpuProfileStallTime_) {
+        cpuProfiledThreads_.erase(name);
+      } else if (cpuProfiledThreads_.emplace(name).second) {
+        dumpStallCpuProfile(name);
+      }
+    }
   }
 
   if (stuckThreads.size() and isDeadThreadDetected_) {
@@ -139,9 +176,44 @@ Watchdog::monitorThreadStatus() {
   isDeadThreadDetected_ = (stuckThreads.size() ? true : false);
 }
 
+void
+Watchdog::dumpStallCpuProfile(const std::string& evbName) {
+  // event base threads are named by Main as `openr-<evb name>`
+  const auto threadName = fmt::format("openr-{}", evbName);
+  LOG(WARNING) << fmt::format(
+      "[Dead Thread Detector] {} thread stalled. Capturing CPU profile.",
+      evbName);
+  CpuProfiler::profile(
+      getEvb(), Constants::kCpuProfileOnStallDuration, threadName)
+      .via(getEvb())
+      .thenTry([threadName](folly::Try<std::string>&& path) {
+        if (path.hasException()) {
+          LOG(ERROR) << "Failed to capture CPU profile of " << threadName
+                     << ": " << path.exception().what();
+          return;
+        }
+        LOG(INFO) << "Captured CPU profile of " << threadName << ": "
+                  << path.value();
+      });
+}
+
 void
 Watchdog::updateThreadCounters() {
+  memory::refreshMallocStats();
   for (auto& evb : monitorEvbs_) {
+    // Memory held by dedicated arena of eventbase, i.e. allocated by its
+    // thread and not freed yet
+    if (auto arenaIndex = evb->getArenaIndex()) {
+      if (auto stats = memory::getArenaStats(*arenaIndex)) {
+        fb303::fbData->setCounter(
+            fmt::format("watchdog.arena_allocated_bytes.{}", evb->getEvbName()),
+            stats->allocatedBytes);
+        fb303::fbData->setCounter(
+            fmt::format("watchdog.arena_resident_bytes.{}", evb->getEvbName()),
+            stats->residentBytes);
+      }
+    }
+
     // Asynchronously fetch thread mem usage data inside each individual evb
     evb->runInEventBaseThread([name = evb->getEvbName()]() {
       auto allocBytes = memory::getThreadBytesImpl(true);
@@ -198,6 +270,45 @@ Watchdog::updateQueueCounters() {
       fb303::fbData->setCounter(
           fmt::format("messaging.rw_queue.{}-{}.sent", qName, stat.queueId),
           stat.writes);
+
+      fb303::fbData->setCounter(
+          fmt::format("messaging.rw_queue.{}-{}.drops", qName, stat.queueId),
+          stat.drops);
+
+      fb303::fbData->setCounter(
+          fmt::format(
+              "messaging.rw_queue.{}-{}.high_watermark_crossings",
+              qName,
+              stat.queueId),
+          stat.highWatermarkCrossings);
+
+      fb303::fbData->setCounter(
+          fmt::format(
+              "messaging.rw_queue.{}-{}.high_priority.read",
+              qName,
+              stat.queueId),
+          stat.highPriorityReads);
+
+      fb303::fbData->setCounter(
+          fmt::format(
+              "messaging.rw_queue.{}-{}.high_priority.sent",
+              qName,
+              stat.queueId),
+          stat.highPriorityWrites);
+
+      // Enqueue to dequeue latency histogram, as count of reads per bucket
+      for (size_t i = 0; i < stat.latencyBuckets.size(); ++i) {
+        const auto bound = i + 1 < messaging::kNumQueueLatencyBuckets
+            ? std::to_string(messaging::getQueueLatencyBucketBoundUs(i))
+            : std::string("inf");
+        fb303::fbData->setCounter(
+            fmt::format(
+                "messaging.rw_queue.{}-{}.latency_us.lt_{}",
+                qName,
+                stat.queueId,
+                bound),
+            stat.latencyBuckets.at(i));
+      }
     }
   }
 }
@@ -11,6 +11,7 @@
 #include <openr/common/Constants.h>
 #include <openr/common/OpenrEventBase.h>
 #include <openr/config/Config.h>
+#include <openr/monitor/CpuProfiler.h>
 #include <openr/monitor/SystemMetrics.h>
 #include "openr/messaging/ReplicateQueue.h"
 
@@ -37,6 +38,9 @@ class Watchdog final : public OpenrEventBase {
   // monitor thread status in case they get stuck
   void monitorThreadStatus();
 
+  // capture CPU profile of a stalled event base thread
+  void dumpStallCpuProfile(const std::string& evbName);
+
   // monitor memory usage
   void monitorMemory();
 
@@ -69,6 +73,18 @@ class Watchdog final : public OpenrEventBase {
   // critcal memory threhsold
   uint32_t maxMemoryMB_{0};
 
+  // memory threshold to shed optional memory of modules above
+  std::optional<uint32_t> softMemoryMB_;
+
+  // threshold to log slow callbacks of monitored eventbases
+  std::optional<std::chrono::milliseconds> slowCallbackThreshold_;
+
+  // thread inactivity threshold to capture CPU profile of the thread
+  std::optional<std::chrono::seconds> cpuProfileStallTime_;
+
+  // threads profiled in their ongoing stall, to profile once per stall
+  std::unordered_set<std::string> cpuProfiledThreads_;
+
   // boolean to indicate previous failure
   bool isDeadThreadDetected_{false};
 
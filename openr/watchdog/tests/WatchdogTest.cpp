@@ -182,6 +182,16 @@ TEST_F(WatchdogTestFixture, QueueCounterReport) {
               fb303::fbData->getCounter(fmt::format(
                   "messaging.rw_queue.{}-{}.sent", "Queue1", stat.queueId)),
               stat.writes);
+          ASSERT_EQ(
+              fb303::fbData->getCounter(fmt::format(
+                  "messaging.rw_queue.{}-{}.drops", "Queue1", stat.queueId)),
+              stat.drops);
+          ASSERT_EQ(
+              fb303::fbData->getCounter(fmt::format(
+                  "messaging.rw_queue.{}-{}.latency_us.lt_inf",
+                  "Queue1",
+                  stat.queueId)),
+              stat.latencyBuckets.back());
         }
         stats = q2.getReplicationStats();
         for (auto& stat : stats) {